@@ -3,6 +3,18 @@
 # Propagate failures properly
 set -e
 
+# --threads builds with pthreads, which needs SharedArrayBuffer and so a page
+# served cross-origin isolated, --simd builds with WebAssembly SIMD
+BUILD_JS_THREADS=OFF
+BUILD_JS_SIMD=OFF
+for arg in "$@"; do
+  case $arg in
+    --threads) BUILD_JS_THREADS=ON ;;
+    --simd) BUILD_JS_SIMD=ON ;;
+    *) echo "Unknown option $arg, expected --threads or --simd"; exit 1 ;;
+  esac
+done
+
 git submodule update --init --recursive
 
 mkdir -p build_corrade-rc
@@ -26,6 +38,8 @@ cmake ../src \
     -DBUILD_ASSIMP_SUPPORT=OFF \
     -DBUILD_DATATOOL=OFF \
     -DBUILD_PTEX_SUPPORT=OFF \
+    -DBUILD_JS_THREADS="$BUILD_JS_THREADS" \
+    -DBUILD_JS_SIMD="$BUILD_JS_SIMD" \
     -DCMAKE_BUILD_TYPE=Release \
     -DCMAKE_PREFIX_PATH="$EMSCRIPTEN" \
     -DCMAKE_TOOLCHAIN_FILE="../src/deps/corrade/toolchains/generic/Emscripten-wasm.cmake" \
@@ -37,6 +51,11 @@ cmake --build . -- -j 4
 cmake --build . --target install -- -j 4
 
 echo "Done building."
+if [ "$BUILD_JS_THREADS" = ON ]; then
+  echo "Threaded builds need SharedArrayBuffer, serve the pages with the headers"
+  echo "  Cross-Origin-Opener-Policy: same-origin"
+  echo "  Cross-Origin-Embedder-Policy: require-corp"
+fi
 echo "Run:"
 echo "python2 -m SimpleHTTPServer 8000"
 echo "Or:"
@@ -51,6 +51,9 @@ def main(display=True):
     backend_cfg.scene.id = (
         "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
     )
+    # The two eyes only differ in their position, so they are culled and
+    # sorted once and drawn in a single pass over the scene
+    backend_cfg.multi_view_rendering = True
 
     # First, let's create a stereo RGB agent
     left_rgb_sensor = habitat_sim.SensorSpec()
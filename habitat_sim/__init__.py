@@ -19,13 +19,16 @@ if not getattr(builtins, "__HSIM_SETUP__", False):
     from habitat_sim import (
         agent,
         attributes,
+        fork_server,
         geo,
         gfx,
         logging,
         nav,
         physics,
+        profiling,
         scene,
         sensor,
+        shared_memory,
         sim,
         simulator,
         utils,
@@ -39,13 +42,16 @@ if not getattr(builtins, "__HSIM_SETUP__", False):
         "nav",
         "sensors",
         "errors",
+        "fork_server",
         "geo",
         "gfx",
         "logging",
         "nav",
         "physics",
+        "profiling",
         "scene",
         "sensor",
+        "shared_memory",
         "sim",
         "simulator",
         "utils",
@@ -10,11 +10,16 @@
 modules = [
     "cuda_enabled",
     "SceneNodeType",
+    "EquirectangularCamera",
+    "FisheyeCamera",
     "GreedyFollowerCodes",
     "GreedyGeodesicFollowerImpl",
     "MultiGoalShortestPath",
+    "ObservationLayout",
     "PathFinder",
     "PinholeCamera",
+    "RayCastCamera",
+    "ReprojectionCamera",
     "SceneGraph",
     "SceneNode",
     "Sensor",
@@ -23,6 +28,10 @@ modules = [
     "ShortestPath",
     "SimulatorConfiguration",
     "ConfigurationGroup",
+    "BufferStorage",
+    "CounterRandom",
+    "SharedMemoryRing",
+    "ViewpointSettings",
 ]
 
 from habitat_sim._ext.habitat_sim_bindings import Simulator as SimulatorBackend
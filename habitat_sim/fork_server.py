@@ -0,0 +1,86 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+r"""Worker processes forked from a parent with the scenes already loaded
+
+Starting a simulator per worker loads the same navmeshes, semantic scenes and
+scene meshes in every process. A fork server loads them once in the parent
+with :py:`SimulatorBackend.preload()`, which needs no GL context, and forks
+the workers afterwards. The workers inherit the loaded data copy-on-write and
+the first simulator of each worker takes it instead of loading the files:
+
+.. code:: py
+
+    server = habitat_sim.fork_server.ForkServer([cfg.sim_cfg for cfg in cfgs])
+    workers = [server.spawn(run_worker, rank) for rank in range(8)]
+    for worker in workers:
+        worker.join()
+
+Each worker creates its own simulator and with it its own GL context. A
+process that has a GL context must not fork, :py:`ForkServer.spawn()` raises
+if the parent has one. Textures are decoded by the workers, as the format
+Basis textures get transcoded to depends on their context.
+"""
+
+import multiprocessing
+from typing import Any, Callable, Iterable
+
+from habitat_sim._ext.habitat_sim_bindings import Simulator as SimulatorBackend
+from habitat_sim._ext.habitat_sim_bindings import (
+    SimulatorConfiguration,
+    live_gl_context_count,
+)
+
+__all__ = ["ForkServer", "live_gl_context_count", "preloaded_count"]
+
+
+def preloaded_count() -> int:
+    r"""Number of preloaded navmeshes, semantic scenes and scene assets
+
+    Counts what no simulator of this process took yet, so it drops in a
+    worker once its first simulator uses the preloaded data.
+    """
+    return SimulatorBackend.preloaded_count()
+
+
+class ForkServer:
+    r"""Forks workers sharing the scenes it preloaded
+
+    :param configs: Backend configurations whose scenes are preloaded
+    """
+
+    def __init__(self, configs: Iterable[SimulatorConfiguration] = ()) -> None:
+        self._context = multiprocessing.get_context("fork")
+        for config in configs:
+            self.preload(config)
+
+    def preload(self, config: SimulatorConfiguration) -> bool:
+        r"""Preload the scene of a configuration for workers spawned later
+
+        Returns whether the navmesh or the scene meshes got preloaded.
+        """
+        return SimulatorBackend.preload(config)
+
+    def spawn(
+        self, target: Callable[..., Any], *args: Any, **kwargs: Any
+    ) -> multiprocessing.Process:
+        r"""Fork a worker running :py:`target(*args, **kwargs)`
+
+        Raises :py:`RuntimeError` if this process has a GL context.
+        """
+        if live_gl_context_count() > 0:
+            raise RuntimeError(
+                "cannot fork a process with a GL context, preload the scenes "
+                "before creating any simulator"
+            )
+        process = self._context.Process(target=target, args=args, kwargs=kwargs)
+        process.start()
+        return process
+
+    def close(self) -> None:
+        r"""Drop the preloaded scenes in this process
+
+        Workers already spawned keep their copies.
+        """
+        SimulatorBackend.clear_preloaded()
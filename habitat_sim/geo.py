@@ -2,7 +2,7 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
-from habitat_sim._ext.habitat_sim_bindings import OBB, BBox
+from habitat_sim._ext.habitat_sim_bindings import OBB, BBox, OccupancyGrid
 from habitat_sim._ext.habitat_sim_bindings.geo import (
     BACK,
     FRONT,
@@ -11,11 +11,13 @@ from habitat_sim._ext.habitat_sim_bindings.geo import (
     RIGHT,
     UP,
     compute_gravity_aligned_MOBB,
+    voxelize_mesh,
 )
 
 __all__ = [
     "BBox",
     "OBB",
+    "OccupancyGrid",
     "UP",
     "GRAVITY",
     "FRONT",
@@ -23,4 +25,5 @@ __all__ = [
     "LEFT",
     "RIGHT",
     "compute_gravity_aligned_MOBB",
+    "voxelize_mesh",
 ]
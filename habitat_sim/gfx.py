@@ -2,22 +2,161 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
+import json
+from concurrent.futures import Future
+from typing import Any, Callable, List
+
 from habitat_sim._ext.habitat_sim_bindings import (
     DEFAULT_LIGHTING_KEY,
     NO_LIGHT_KEY,
     Camera,
+    ContextPool,
+    ImageWriter,
     LightInfo,
     LightPositionModel,
     Renderer,
+    RenderExecutor as _RenderExecutor,
+    RenderProfiler,
     RenderTarget,
+    voxel_downsample,
 )
 
 __all__ = [
     "Camera",
+    "ContextPool",
+    "ImageWriter",
     "Renderer",
+    "RenderExecutor",
+    "RenderProfiler",
     "RenderTarget",
     "LightPositionModel",
     "LightInfo",
     "DEFAULT_LIGHTING_KEY",
     "NO_LIGHT_KEY",
+    "voxel_downsample",
+    "write_render_trace",
 ]
+
+
+def write_render_trace(records: List[RenderProfiler.Record], filename: str):
+    r"""Writes render pass timings in the Chrome trace event format
+
+    Every sensor gets a CPU and a GPU track. The GPU passes are placed at the
+    start of their CPU pass, only their duration is measured.
+
+    :param records: Records taken from `Renderer.profiler`, e.g. gathered with
+        `RenderProfiler.take_records()` after every step
+    :param filename: Output JSON file, to be opened in ``chrome://tracing``
+    """
+    tracks = {}
+    events = []
+    for record in records:
+        if record.sensor not in tracks:
+            tracks[record.sensor] = len(tracks)
+            for tid, suffix in ((0, "cpu"), (1, "gpu")):
+                events.append(
+                    {
+                        "name": "thread_name",
+                        "ph": "M",
+                        "pid": tracks[record.sensor],
+                        "tid": tid,
+                        "args": {"name": "{} {}".format(record.sensor, suffix)},
+                    }
+                )
+        pid = tracks[record.sensor]
+        args = {}
+        if record.pass_type == RenderProfiler.Pass.DRAW:
+            statistics = record.draw_statistics
+            args = {
+                "drawables": statistics.drawables,
+                "culled": statistics.culled,
+                "triangles": statistics.triangles,
+                "state_changes": statistics.state_changes.shader
+                + statistics.state_changes.texture
+                + statistics.state_changes.material
+                + statistics.state_changes.mesh,
+                "cull_time": statistics.cull_time,
+            }
+        # trace timestamps are in microseconds
+        name = record.pass_type.name.lower()
+        events.append(
+            {
+                "name": name,
+                "ph": "X",
+                "pid": pid,
+                "tid": 0,
+                "ts": record.start_time * 1000.0,
+                "dur": record.cpu_time * 1000.0,
+                "args": args,
+            }
+        )
+        if record.gpu_time >= 0.0:
+            events.append(
+                {
+                    "name": name,
+                    "ph": "X",
+                    "pid": pid,
+                    "tid": 1,
+                    "ts": record.start_time * 1000.0,
+                    "dur": record.gpu_time * 1000.0,
+                }
+            )
+
+    with open(filename, "w") as f:
+        json.dump({"traceEvents": events}, f)
+
+
+class RenderExecutor(_RenderExecutor):
+    r"""Runs simulators on one thread per GPU device
+
+    Each worker thread holds the `ContextPool` context of its device. Every
+    simulator configured with ``context_pool`` set has to be created, used and
+    closed by tasks of the worker of its ``gpu_device_id``:
+
+    .. code:: py
+
+        executor = RenderExecutor()
+        cfg.sim_cfg.context_pool = True
+        cfg.sim_cfg.gpu_device_id = ContextPool.instance().assign_device()
+        device = cfg.sim_cfg.gpu_device_id
+        sim = executor.run(device, habitat_sim.Simulator, cfg)
+        observations = executor.run(device, sim.step, "move_forward")
+        executor.run(device, sim.close)
+
+    Tasks of one device run in the order they were submitted, tasks of
+    different devices in parallel. Drawing and reading back observations
+    don't hold the GIL, so one process can keep several GPUs busy.
+    """
+
+    def submit(self, gpu_device: int, fn: Callable, *args, **kwargs) -> Future:
+        r"""Run ``fn(*args, **kwargs)`` on the worker of a device
+
+        :return: Future of the result of ``fn``
+        """
+        future: Future = Future()
+
+        def task():
+            if not future.set_running_or_notify_cancel():
+                return
+            try:
+                future.set_result(fn(*args, **kwargs))
+            except BaseException as e:
+                future.set_exception(e)
+
+        self._submit(gpu_device, task)
+        return future
+
+    def run(self, gpu_device: int, fn: Callable, *args, **kwargs) -> Any:
+        r"""Run ``fn(*args, **kwargs)`` on the worker of a device and wait for
+        its result"""
+        return self.submit(gpu_device, fn, *args, **kwargs).result()
+
+    def close(self):
+        r"""Run the tasks already submitted and stop the workers"""
+        self._stop()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
@@ -6,6 +6,7 @@ from habitat_sim._ext.habitat_sim_bindings import (
     NavMeshSettings,
     PathFinder,
     ShortestPath,
+    TopDownMap,
     VectorGreedyCodes,
 )
 
@@ -20,5 +21,6 @@ __all__ = [
     "PathFinder",
     "ShortestPath",
     "HitRecord",
+    "TopDownMap",
     "VectorGreedyCodes",
 ]
@@ -0,0 +1,122 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+r"""Compact packets of observations for shipping them over the network
+
+A remote simulator encodes the observations of every step, a rollout worker
+decodes them back into numpy arrays. Between keyframes only the difference
+to the previous step is sent, and depth defaults to millimeter steps:
+
+.. code:: py
+
+    # simulator server
+    encoders = habitat_sim.observation_codec.create_encoders(sim)
+    packets = encode_observations(encoders, sim.get_sensor_observations())
+    connection.send(packets)
+
+    # rollout worker
+    decoders = {}
+    observations = decode_observations(decoders, connection.recv())
+
+Packets have to be decoded in the order they were encoded. After a lost
+packet the observations of a sensor are None until its next keyframe, ask
+for one early with :py:`ObservationEncoder.request_keyframe()`.
+"""
+
+from typing import Dict, Optional
+
+import numpy as np
+
+import habitat_sim.bindings as hsim
+from habitat_sim._ext.habitat_sim_bindings import (
+    ObservationCodec,
+    ObservationDecoder,
+    ObservationEncoder,
+    ObservationEncoderConfiguration,
+)
+
+__all__ = [
+    "ObservationCodec",
+    "ObservationDecoder",
+    "ObservationEncoder",
+    "ObservationEncoderConfiguration",
+    "create_encoders",
+    "decode_observations",
+    "encode_observations",
+]
+
+
+def create_encoders(
+    sim,
+    agent_id: Optional[int] = None,
+    keyframe_interval: int = 30,
+    compression_level: int = 1,
+    depth_step: Optional[float] = 0.001,
+) -> Dict[str, ObservationEncoder]:
+    r"""An encoder for every sensor of an agent, by sensor uuid
+
+    :param sim: The :ref:`habitat_sim.Simulator` whose observations are
+        encoded
+    :param agent_id: Agent whose sensors are encoded, the default agent if
+        None
+    :param keyframe_interval: Steps from one keyframe to the next
+    :param compression_level: zlib level from 1 to 9, 0 to not compress
+    :param depth_step: Meters per quantization step of float depth
+        observations, None to encode them losslessly
+    """
+    if agent_id is None:
+        agent_id = sim.config.sim_cfg.default_agent_id
+    encoders = {}
+    for spec in sim.config.agents[agent_id].sensor_specifications:
+        config = ObservationEncoderConfiguration()
+        config.keyframe_interval = keyframe_interval
+        config.compression_level = compression_level
+        if (
+            depth_step is not None
+            and spec.sensor_type == hsim.SensorType.DEPTH
+            and spec.observation_layout == hsim.ObservationLayout.DEFAULT
+        ):
+            config.codec = ObservationCodec.QUANTIZED_DEPTH
+            config.depth_step = depth_step
+        encoders[spec.uuid] = ObservationEncoder(config)
+    return encoders
+
+
+def encode_observations(
+    encoders: Dict[str, ObservationEncoder], observations: Dict[str, np.ndarray]
+) -> Dict[str, bytes]:
+    r"""Packets of the observations that have an encoder, by sensor uuid
+
+    Raises :py:`ValueError` if an encoder can't encode its observation, e.g.
+    quantized depth of anything but float32.
+    """
+    packets = {}
+    for uuid, encoder in encoders.items():
+        packet = encoder.encode(np.asarray(observations[uuid]))
+        if packet is None:
+            raise ValueError(f"cannot encode the observation of {uuid}")
+        packets[uuid] = packet
+    return packets
+
+
+def decode_observations(
+    decoders: Dict[str, ObservationDecoder], packets: Dict[str, bytes]
+) -> Dict[str, Optional[np.ndarray]]:
+    r"""Observations of packets, by sensor uuid
+
+    :param decoders: Decoders by sensor uuid, kept from one call to the next.
+        Decoders of sensors that don't have one yet are added.
+    :param packets: Packets of :ref:`encode_observations()`
+
+    An observation is None if its packet is a delta to a frame that wasn't
+    decoded, e.g. after a lost packet.
+    """
+    observations = {}
+    for uuid, packet in packets.items():
+        decoder = decoders.get(uuid)
+        if decoder is None:
+            decoder = decoders[uuid] = ObservationDecoder()
+        buffer = decoder.decode(packet)
+        observations[uuid] = None if buffer is None else np.asarray(buffer)
+    return observations
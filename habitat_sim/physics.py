@@ -2,6 +2,69 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
-from habitat_sim._ext.habitat_sim_bindings import MotionType
+import json
+from typing import Iterable
 
-__all__ = ["MotionType"]
+from habitat_sim._ext.habitat_sim_bindings import (
+    MotionType,
+    PhysicsState,
+    StepStatistics,
+)
+
+__all__ = ["MotionType", "PhysicsState", "StepStatistics", "write_chrome_trace"]
+
+_STEP_PHASES = (
+    ("broadphase", "broadphase_time"),
+    ("narrowphase", "narrowphase_time"),
+    ("solver", "solver_time"),
+    ("integration", "integration_time"),
+    ("syncPose", "sync_pose_time"),
+)
+
+
+def write_chrome_trace(step_statistics: Iterable[StepStatistics], filename: str):
+    r"""Writes physics step timings in the Chrome trace event format
+
+    :param step_statistics: Statistics of the steps to write, e.g. collected
+        with `Simulator.get_physics_step_statistics()` after every step
+    :param filename: Output JSON file, to be opened in ``chrome://tracing``
+
+    Bullet only reports the total time of each phase, so the phases of a step
+    are laid out back to back from its start.
+    """
+    events = []
+    for stats in step_statistics:
+        # trace timestamps are in microseconds
+        timestamp = stats.start_time * 1000.0
+        events.append(
+            {
+                "name": "stepPhysics",
+                "ph": "X",
+                "pid": 0,
+                "tid": 0,
+                "ts": timestamp,
+                "dur": stats.total_time * 1000.0,
+                "args": {
+                    "active_objects": stats.active_objects,
+                    "synced_objects": stats.synced_objects,
+                    "sleeping_objects": stats.sleeping_objects,
+                    "skipped": stats.skipped,
+                },
+            }
+        )
+        for name, attribute in _STEP_PHASES:
+            duration = getattr(stats, attribute) * 1000.0
+            events.append(
+                {
+                    "name": name,
+                    "ph": "X",
+                    "pid": 0,
+                    "tid": 0,
+                    "ts": timestamp,
+                    "dur": duration,
+                }
+            )
+            timestamp += duration
+
+    with open(filename, "w") as f:
+        json.dump({"traceEvents": events}, f)
@@ -0,0 +1,33 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import contextlib
+from typing import Iterator
+
+from habitat_sim._ext.habitat_sim_bindings import Metrics, Profiler
+
+__all__ = ["Metrics", "Profiler", "trace"]
+
+
+@contextlib.contextmanager
+def trace(filename: str) -> Iterator[None]:
+    r"""Record the instrumented scopes of the simulator while in the context
+    and write them to `filename` as a Chrome trace
+
+    Open the file in chrome://tracing or https://ui.perfetto.dev. Events
+    recorded before entering are dropped.
+
+    .. code:: py
+
+        with habitat_sim.profiling.trace("trace.json"):
+            for _ in range(100):
+                sim.step("move_forward")
+    """
+    Profiler.clear()
+    Profiler.set_enabled(True)
+    try:
+        yield
+    finally:
+        Profiler.set_enabled(False)
+        Profiler.write_chrome_trace(filename)
@@ -3,8 +3,13 @@
 # LICENSE file in the root directory of this source tree.
 
 from habitat_sim._ext.habitat_sim_bindings import (
+    EquirectangularCamera,
+    FisheyeCamera,
     Observation,
+    ObservationLayout,
     PinholeCamera,
+    RayCastCamera,
+    ReprojectionCamera,
     Sensor,
     SensorSpec,
     SensorType,
@@ -12,8 +17,13 @@ from habitat_sim._ext.habitat_sim_bindings import (
 )
 
 __all__ = [
+    "EquirectangularCamera",
+    "FisheyeCamera",
     "Observation",
+    "ObservationLayout",
     "PinholeCamera",
+    "RayCastCamera",
+    "ReprojectionCamera",
     "Sensor",
     "SensorType",
     "SensorSpec",
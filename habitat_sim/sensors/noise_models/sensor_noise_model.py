@@ -39,6 +39,17 @@ class SensorNoiseModel(abc.ABC):
         """
         pass
 
+    def attach_to_sensor(self, visual_sensor) -> bool:
+        r"""Lets the noise model run as part of rendering the sensor, if it
+        supports that
+
+        :param visual_sensor: The `VisualSensor` the model is used with
+
+        :return: True if the sensor now renders noisy observations itself, so
+            `apply()` must not be called on them
+        """
+        return False
+
     def __call__(self, sensor_observation):
         r"""Alias of `apply()`
         """
@@ -0,0 +1,102 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+r"""Observations handed between processes through shared memory
+
+A simulator process creates a ring and writes observations into it with
+:py:`Simulator.write_observations()`, the cameras read back straight into the
+shared memory. A trainer process opens the ring by name and gets numpy views
+of the slots, without copying or unpickling anything:
+
+.. code:: py
+
+    # simulator process
+    ring = habitat_sim.shared_memory.create_observation_ring(sim, "/env-0")
+    sim.write_observations(ring)
+
+    # trainer process
+    ring = habitat_sim.shared_memory.SharedMemoryRing.open("/env-0")
+    with habitat_sim.shared_memory.read_observations(ring) as observations:
+        if observations is not None:
+            model(observations["rgba_camera"])
+
+Each ring has a single writer and a single reader. The views are valid only
+inside the :py:`with` block, the writer reuses the slot afterwards.
+"""
+
+import contextlib
+import json
+from typing import Dict, Iterator, Optional
+
+import numpy as np
+
+from habitat_sim._ext.habitat_sim_bindings import SharedMemoryRing
+
+__all__ = [
+    "SharedMemoryRing",
+    "create_observation_ring",
+    "parse_observations",
+    "read_observations",
+]
+
+
+def create_observation_ring(
+    sim, name: str, slot_count: int = 2, agent_id: Optional[int] = None
+) -> SharedMemoryRing:
+    r"""Create a ring with slots large enough for the cameras of an agent
+
+    :param sim: The :ref:`habitat_sim.Simulator` writing to the ring
+    :param name: Name of the shared memory, starting with a slash
+    :param slot_count: Observations the writer can be ahead of the reader
+    :param agent_id: Agent whose cameras are written, the default agent if
+        None
+
+    Raises :py:`RuntimeError` if the name is taken.
+    """
+    if agent_id is None:
+        agent_id = sim.config.sim_cfg.default_agent_id
+    ring = SharedMemoryRing.create(
+        name, slot_count, sim.get_observations_byte_size(agent_id)
+    )
+    if ring is None:
+        raise RuntimeError(f"cannot create the shared memory ring {name}")
+    return ring
+
+
+def parse_observations(data: np.ndarray, layout: str) -> Dict[str, np.ndarray]:
+    r"""Views of the observations in a slot, by sensor uuid
+
+    :param data: The uint8 slot memory
+    :param layout: The layout the writer stored with the slot
+    """
+    observations = {}
+    for entry in json.loads(layout):
+        dtype = np.dtype(entry["dtype"])
+        count = int(np.prod(entry["shape"]))
+        offset = entry["offset"]
+        observations[entry["uuid"]] = (
+            data[offset : offset + count * dtype.itemsize]
+            .view(dtype)
+            .reshape(entry["shape"])
+        )
+    return observations
+
+
+@contextlib.contextmanager
+def read_observations(
+    ring: SharedMemoryRing,
+) -> Iterator[Optional[Dict[str, np.ndarray]]]:
+    r"""Observations of the oldest slot not read yet, None if there's none
+
+    The slot is released to the writer when the context exits, copy what has
+    to outlive it.
+    """
+    data = ring.begin_read()
+    if data is None:
+        yield None
+        return
+    try:
+        yield parse_observations(data, ring.read_layout)
+    finally:
+        ring.end_read()
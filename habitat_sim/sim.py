@@ -2,7 +2,55 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
+import json
+
+from habitat_sim._ext.habitat_sim_bindings import (
+    BatchedSimulator,
+    ObservationRecorder,
+    SceneLoadStatistics,
+)
 from habitat_sim._ext.habitat_sim_bindings import Simulator as SimulatorBackend
 from habitat_sim._ext.habitat_sim_bindings import SimulatorConfiguration
 
-__all__ = ["SimulatorBackend", "SimulatorConfiguration"]
+__all__ = [
+    "BatchedSimulator",
+    "ObservationRecorder",
+    "SceneLoadStatistics",
+    "SimulatorBackend",
+    "SimulatorConfiguration",
+    "write_scene_load_trace",
+]
+
+
+def write_scene_load_trace(statistics: SceneLoadStatistics, filename: str):
+    r"""Writes scene load timings in the Chrome trace event format
+
+    :param statistics: Statistics of a load, e.g.
+        `Simulator.scene_load_statistics` right after `Simulator.reconfigure()`
+    :param filename: Output JSON file, to be opened in ``chrome://tracing``
+    """
+    # trace timestamps are in microseconds
+    events = [
+        {
+            "name": "loadScene",
+            "ph": "X",
+            "pid": 0,
+            "tid": 0,
+            "ts": statistics.start_time * 1000.0,
+            "dur": statistics.total_time * 1000.0,
+        }
+    ]
+    for event in statistics.events:
+        events.append(
+            {
+                "name": event.stage.name.lower(),
+                "ph": "X",
+                "pid": 0,
+                "tid": 0,
+                "ts": event.start_time * 1000.0,
+                "dur": event.duration * 1000.0,
+            }
+        )
+
+    with open(filename, "w") as f:
+        json.dump({"traceEvents": events}, f)
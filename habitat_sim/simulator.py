@@ -9,7 +9,6 @@ import time
 from typing import Dict, List, Optional
 
 import attr
-import magnum as mn
 import numpy as np
 
 import habitat_sim.bindings as hsim
@@ -25,6 +24,13 @@ from habitat_sim.utils.common import quat_from_angle_axis
 torch = None
 
 
+def _object_id_array(object_ids):
+    # an empty array selects all objects
+    if object_ids is None:
+        return np.empty(0, dtype=np.int32)
+    return np.asarray(object_ids, dtype=np.int32)
+
+
 @attr.s(auto_attribs=True, slots=True)
 class Configuration(object):
     r"""Specifies how to configure the simulator.
@@ -57,6 +63,9 @@ class Simulator:
     _num_total_frames: int = attr.ib(default=0, init=False)
     _default_agent: Agent = attr.ib(init=False, default=None)
     _sensors: Dict = attr.ib(factory=dict, init=False)
+    # pathfinders of the scenes the backend keeps resident, keyed by scene
+    # id and agent radius and height
+    _resident_pathfinders: Dict = attr.ib(factory=dict, init=False)
     _previous_step_time = 0.0  # track the compute time of each step
 
     def __attrs_post_init__(self):
@@ -89,10 +98,32 @@ class Simulator:
         self._sim.seed(new_seed)
         self.pathfinder.seed(new_seed)
 
+    def random_stream(self, stream: int) -> hsim.CounterRandom:
+        r"""Independent random stream of the current seed
+
+        Streams with the same seed and number give the same numbers, whichever
+        thread or process draws them, e.g. one stream per episode index.
+        """
+        return self._sim.random_stream(stream)
+
+    def write_observations(
+        self, ring: hsim.SharedMemoryRing, agent_id: Optional[int] = None
+    ) -> int:
+        r"""Draw the cameras of an agent into the next slot of `ring`, for a
+        reader in another process, see :ref:`habitat_sim.shared_memory`
+
+        Goes around the Python sensors, so noise models aren't applied.
+        Returns the sequence number of the slot, 0 if the ring is full.
+        """
+        if agent_id is None:
+            agent_id = self.config.sim_cfg.default_agent_id
+        return self._sim.write_observations(agent_id, ring)
+
     def reset(self):
         self._sim.reset()
         for i in range(len(self.agents)):
             self.reset_agent(i)
+        self.request_sensor_updates()
 
         return self.get_sensor_observations()
 
@@ -122,6 +153,30 @@ class Simulator:
         ]
 
     def _config_pathfinder(self, config: Configuration):
+        # the navmesh only depends on the scene and the default agent's body
+        if self.config is not None:
+            old_agent = self.config.agents[self.config.sim_cfg.default_agent_id]
+            new_agent = config.agents[config.sim_cfg.default_agent_id]
+            if (
+                self.config.sim_cfg.scene == config.sim_cfg.scene
+                and np.isclose(old_agent.radius, new_agent.radius)
+                and np.isclose(old_agent.height, new_agent.height)
+            ):
+                return
+
+        # scenes switched back to keep their navmesh, see max_resident_scenes
+        new_agent = config.agents[config.sim_cfg.default_agent_id]
+        resident_key = (config.sim_cfg.scene.id, new_agent.radius, new_agent.height)
+        resident_scenes = set(self._sim.get_resident_scenes())
+        self._resident_pathfinders = {
+            key: pathfinder
+            for key, pathfinder in self._resident_pathfinders.items()
+            if key[0] in resident_scenes
+        }
+        if resident_key in self._resident_pathfinders:
+            self.pathfinder = self._resident_pathfinders[resident_key]
+            return
+
         if "navmesh" in config.sim_cfg.scene.filepaths:
             navmesh_filenname = config.sim_cfg.scene.filepaths["navmesh"]
         else:
@@ -163,12 +218,30 @@ class Simulator:
             navmesh_settings.agent_height = default_agent_config.height
             self.recompute_navmesh(self.pathfinder, navmesh_settings)
 
+        if config.sim_cfg.scene.id in resident_scenes:
+            self._resident_pathfinders[resident_key] = self.pathfinder
+
     def reconfigure(self, config: Configuration):
         assert len(config.agents) > 0
 
+        # ray cast sensors are traced on the CPU and only need the geometry
+        subtypes = [
+            spec.sensor_subtype
+            for agent_cfg in config.agents
+            for spec in agent_cfg.sensor_specifications
+        ]
         config.sim_cfg.create_renderer = any(
-            map(lambda cfg: len(cfg.sensor_specifications) > 0, config.agents)
+            subtype != "raycast" for subtype in subtypes
         )
+        config.sim_cfg.cpu_scene_geometry = "raycast" in subtypes
+        if config.sim_cfg.texture_size_from_sensors:
+            config.sim_cfg.max_texture_size = hsim.max_texture_size_for_sensors(
+                [
+                    spec
+                    for agent_cfg in config.agents
+                    for spec in agent_cfg.sensor_specifications
+                ]
+            )
 
         if self.config == config:
             return
@@ -198,6 +271,14 @@ class Simulator:
 
         self.config = config
 
+    def prefetch_scene(self, config: Configuration) -> bool:
+        r"""Start loading the scene of the given configuration in the
+        background, so a later :ref:`reconfigure()` to it is faster
+
+        :return: Whether anything is being prefetched
+        """
+        return self._sim.prefetch_scene(config.sim_cfg)
+
     def get_agent(self, agent_id):
         return self.agents[agent_id]
 
@@ -230,15 +311,66 @@ class Simulator:
         return self._sim.semantic_scene
 
     def get_sensor_observations(self):
-        for _, sensor in self._sensors.items():
-            sensor.draw_observation()
+        r"""Observations of all sensors. Sensors with an `update_interval`
+        return their previous observation object, without rendering, while
+        their update is not due.
+        """
+        due = {
+            sensor_uuid: sensor.schedule_observation()
+            for sensor_uuid, sensor in self._sensors.items()
+        }
+        # meshes of a scene loaded with a mesh_upload_budget appear over the
+        # first frames
+        self._sim.upload_pending_meshes()
+        # a shared render target only holds the last sensor drawn into it
+        interleave = self.config.sim_cfg.share_render_targets
+        if not interleave:
+            drawn = dict.fromkeys(self._sensors, False)
+            sim_cfg = self.config.sim_cfg
+            if sim_cfg.multi_view_rendering and not sim_cfg.occlusion_culling:
+                # sensors that only differ in their position share a pass
+                uuids = [uuid for uuid in self._sensors if due[uuid]]
+                sensors = [self._sensors[uuid]._sensor_object for uuid in uuids]
+                drawn.update(zip(uuids, self._sim.draw_multi_view(sensors)))
+            if sim_cfg.parallel_culling:
+                # the sensors left to draw are culled at once, over threads
+                self._sim.cull_ahead(
+                    [
+                        sensor._sensor_object
+                        for uuid, sensor in self._sensors.items()
+                        if due[uuid] and not drawn[uuid]
+                    ]
+                )
+            for sensor_uuid, sensor in self._sensors.items():
+                if due[sensor_uuid] and not drawn[sensor_uuid]:
+                    sensor.draw_observation()
 
         observations = {}
         for sensor_uuid, sensor in self._sensors.items():
-            observations[sensor_uuid] = sensor.get_observation()
+            if due[sensor_uuid]:
+                if interleave:
+                    sensor.draw_observation()
+                sensor.last_observation = sensor.get_observation()
+            observations[sensor_uuid] = sensor.last_observation
 
         return observations
 
+    def request_sensor_updates(self, sensor_uuids=None):
+        r"""Render the next observation of the given sensors, or of all sensors
+        if `sensor_uuids` is None, even if their update interval would skip it
+        """
+        if sensor_uuids is None:
+            sensor_uuids = self._sensors.keys()
+        for sensor_uuid in sensor_uuids:
+            self._sensors[sensor_uuid].request_update()
+
+    def set_observation_destination(self, sensor_uuid, buffer=None):
+        r"""Read the observations of a sensor of the default agent straight
+        into `buffer`, see `Sensor.set_observation_destination`. Kept until
+        the sensors are recreated by `reconfigure`.
+        """
+        self._sensors[sensor_uuid].set_observation_destination(buffer)
+
     def last_state(self):
         return self._last_state
 
@@ -288,6 +420,9 @@ class Simulator:
     def load_object_template(self, object_template, object_template_handle):
         return self._sim.load_object_template(object_template, object_template_handle)
 
+    def prefetch_object_template(self, template_id):
+        return self._sim.prefetch_object_template(template_id)
+
     # --- physics functions ---
     def add_object(
         self,
@@ -311,6 +446,16 @@ class Simulator:
     def set_object_motion_type(self, motion_type, object_id, scene_id=0):
         return self._sim.set_object_motion_type(motion_type, object_id, scene_id)
 
+    def get_object_kinematic_collisions(self, object_id, scene_id=0):
+        return self._sim.get_object_kinematic_collisions(object_id, scene_id)
+
+    def set_object_kinematic_collisions(self, enabled, object_id, scene_id=0):
+        r"""Sets whether a kinematic object takes part in collision detection.
+        Kinematic objects without are moved purely through their scene node and
+        cost nothing during physics steps, but other objects pass through them.
+        """
+        self._sim.set_object_kinematic_collisions(enabled, object_id, scene_id)
+
     def set_transformation(self, transform, object_id, scene_id=0):
         self._sim.set_transformation(transform, object_id, scene_id)
 
@@ -344,6 +489,32 @@ class Simulator:
     def get_angular_velocity(self, object_id, scene_id=0):
         return self._sim.get_angular_velocity(object_id, scene_id)
 
+    # Batched object state as (N, 3) arrays and (N, 4) arrays of (x, y, z, w)
+    # quaternions, for the given object IDs or all objects if None
+    def get_translations(self, object_ids=None, scene_id=0):
+        return self._sim.get_translations(_object_id_array(object_ids), scene_id)
+
+    def get_rotations(self, object_ids=None, scene_id=0):
+        return self._sim.get_rotations(_object_id_array(object_ids), scene_id)
+
+    def get_linear_velocities(self, object_ids=None, scene_id=0):
+        return self._sim.get_linear_velocities(_object_id_array(object_ids), scene_id)
+
+    def get_angular_velocities(self, object_ids=None, scene_id=0):
+        return self._sim.get_angular_velocities(_object_id_array(object_ids), scene_id)
+
+    def set_translations(self, translations, object_ids=None, scene_id=0):
+        self._sim.set_translations(translations, _object_id_array(object_ids), scene_id)
+
+    def set_rotations(self, rotations, object_ids=None, scene_id=0):
+        self._sim.set_rotations(rotations, _object_id_array(object_ids), scene_id)
+
+    def set_linear_velocities(self, lin_vels, object_ids=None, scene_id=0):
+        self._sim.set_linear_velocities(lin_vels, _object_id_array(object_ids), scene_id)
+
+    def set_angular_velocities(self, ang_vels, object_ids=None, scene_id=0):
+        self._sim.set_angular_velocities(ang_vels, _object_id_array(object_ids), scene_id)
+
     def apply_force(self, force, relative_position, object_id, scene_id=0):
         self._sim.apply_force(force, relative_position, object_id, scene_id)
 
@@ -353,9 +524,145 @@ class Simulator:
     def contact_test(self, object_id, scene_id=0):
         return self._sim.contact_test(object_id, scene_id)
 
+    def contact_tests(self, object_ids=None, scene_id=0):
+        return self._sim.contact_tests(_object_id_array(object_ids), scene_id)
+
+    def cast_rays(self, origins, directions, max_distance=100.0, scene_id=0):
+        r"""Casts a batch of rays against the physics world
+
+        :return: Tuple of hit object IDs (-1 for the scene or no hit), hit
+            distances (inf for no hit), hit points and hit normals
+        """
+        return self._sim.cast_rays(origins, directions, max_distance, scene_id)
+
+    def compute_object_viewpoints(self, settings=None):
+        r"""Finds the navigable viewpoints each object of the semantic scene is
+        visible from, e.g. for ObjectNav goals
+
+        :param settings: `ViewpointSettings`, the defaults if `None`
+        :return: `ObjectViewpoints` of the objects with any viewpoint, in the
+            order of `semantic_scene.objects`
+        """
+        if settings is None:
+            settings = hsim.ViewpointSettings()
+        return self._sim.compute_object_viewpoints(settings)
+
+    def get_occupancy_grid(self, voxel_size):
+        r"""Voxelizes the collision mesh of the scene, without objects
+
+        The grid is computed on first use and cached for the scene and voxel
+        size, so repeated calls are free.
+
+        :param voxel_size: Edge length of the voxels in meters
+        :return: `geo.OccupancyGrid` with the occupied voxels in `voxels`
+        """
+        return self._sim.get_occupancy_grid(voxel_size)
+
     def step_physics(self, dt, scene_id=0):
         self._sim.step_world(dt)
 
+    def step_physics_substeps(self, num_substeps, scene_id=0):
+        r"""Steps the physics by exactly num_substeps fixed timesteps"""
+        return self._sim.step_world_substeps(num_substeps)
+
+    def set_physics_timestep(self, dt, scene_id=0):
+        self._sim.set_physics_timestep(dt, scene_id)
+
+    def get_physics_timestep(self, scene_id=0):
+        return self._sim.get_physics_timestep(scene_id)
+
+    def set_physics_max_substeps(self, max_substeps, scene_id=0):
+        self._sim.set_physics_max_substeps(max_substeps, scene_id)
+
+    def get_physics_max_substeps(self, scene_id=0):
+        return self._sim.get_physics_max_substeps(scene_id)
+
+    @staticmethod
+    def step_worlds(sims: List["Simulator"], dt):
+        r"""Steps the physics of several independent simulators concurrently"""
+        hsim.SimulatorBackend.step_worlds([sim._sim for sim in sims], dt)
+
+    def save_physics_state(self, scene_id=0):
+        return self._sim.save_physics_state(scene_id)
+
+    def restore_physics_state(self, state, scene_id=0):
+        return self._sim.restore_physics_state(state, scene_id)
+
+    def checkpoint(self):
+        r"""Snapshot agent and sensor poses, the physical world with its
+        objects and the random generators in memory, see :ref:`restore`
+        """
+        return self._sim.checkpoint()
+
+    def restore(self, checkpoint) -> bool:
+        r"""Return to a snapshot made by :ref:`checkpoint`, without loading
+        any assets, e.g. to branch a search over actions
+
+        Returns :py:`False` if the snapshot is of another scene or other
+        agents.
+        """
+        return self._sim.restore(checkpoint)
+
+    def render_agent_poses(
+        self,
+        positions: np.ndarray,
+        rotations: np.ndarray,
+        sensor_uuids: List[str],
+        agent_id: int = 0,
+        sort_poses: bool = True,
+    ) -> Dict[str, np.ndarray]:
+        r"""Render sensors of an agent from many poses back to back, without
+        a :ref:`get_sensor_observations` call per pose
+
+        :param positions: Nx3 positions of the agent
+        :param rotations: Nx4 rotations of the agent, quaternion coefficients
+            x, y, z, w
+        :param sensor_uuids: Pinhole sensors of the agent to render
+        :param agent_id: Agent to move, it goes back to its pose afterwards
+        :param sort_poses: Draw the poses in an order that keeps consecutive
+            draws close, the results stay in the order of the poses
+        :return: Dict of sensor uuids and arrays of N observations each, row
+            ``i`` seen from pose ``i``. Noise models aren't applied.
+        """
+        tensors = self._sim.render_agent_poses(
+            agent_id, positions, rotations, sensor_uuids, sort_poses
+        )
+        observations = {}
+        for uuid, tensor in tensors.items():
+            observation = np.asarray(tensor)
+            spec = self._sensors[uuid]._spec
+            # read back bottom row first, like get_sensor_observations() flips
+            if spec.observation_layout != hsim.ObservationLayout.SEMANTIC_HISTOGRAM:
+                observation = np.flip(observation, axis=1)
+            observations[uuid] = observation
+        return observations
+
+    def save_frame(self, filename: str) -> bool:
+        r"""Save the observation of the ``sim_cfg.default_camera_uuid`` sensor
+        of the default agent as an image
+
+        Only rendering and a copy happen here, :ref:`image_writer` encodes and
+        writes the file on a worker thread. The format follows the extension
+        of ``filename``. Returns :py:`False` if there is no such sensor.
+        """
+        return self._sim.save_frame(filename)
+
+    @property
+    def image_writer(self):
+        r"""The `gfx.ImageWriter` of :ref:`save_frame`, can be replaced e.g.
+        by one with more threads or another JPEG quality"""
+        return self._sim.image_writer
+
+    @image_writer.setter
+    def image_writer(self, writer):
+        self._sim.image_writer = writer
+
+    def get_physics_step_statistics(self, scene_id=0):
+        return self._sim.get_physics_step_statistics(scene_id)
+
+    def get_num_pooled_objects(self, scene_id=0):
+        return self._sim.get_num_pooled_objects(scene_id)
+
     def get_world_time(self, scene_id=0):
         return self._sim.get_world_time()
 
@@ -383,6 +690,32 @@ class Simulator:
         self._sim.set_object_light_setup(object_id, light_setup_key, scene_id)
 
 
+def create_observation_batch(sims, sensor_uuid):
+    r"""Stack the observations of a sensor of many simulators without copies
+
+    Allocates one contiguous array, a CUDA tensor for
+    `SensorSpec.gpu2gpu_transfer`, of shape `[len(sims), ...]` and makes the
+    sensor `sensor_uuid` of the default agent of `sims[i]` read its
+    observations into row `i`, see `Simulator.set_observation_destination`.
+    The rows are stored bottom-up like the sensor buffers, `batch[:, ::-1]`
+    or `batch.flip(1)` gives them upright.
+
+    :param sims: Simulators with a sensor `sensor_uuid` of the same shape and
+        type
+    :param sensor_uuid: Sensor to stack
+    :return: The batch, filled by the next `get_sensor_observations` of each
+        simulator
+    """
+    buffer = sims[0]._sensors[sensor_uuid]._buffer
+    if isinstance(buffer, np.ndarray):
+        batch = np.empty((len(sims),) + buffer.shape, dtype=buffer.dtype)
+    else:
+        batch = buffer.new_empty((len(sims),) + tuple(buffer.shape))
+    for sim, row in zip(sims, batch):
+        sim.set_observation_destination(sensor_uuid, row)
+    return batch
+
+
 class Sensor:
     r"""Wrapper around habitat_sim.Sensor
 
@@ -398,8 +731,12 @@ class Sensor:
         # store such "attached object" in _sensor_object
         self._sensor_object = self._agent._sensors.get(sensor_id)
         self._spec = self._sensor_object.specification()
+        # returned while the update interval skips rendering
+        self.last_observation = None
+        self._sensor_object.request_update()
 
-        self._sim.renderer.bind_render_target(self._sensor_object)
+        if self._sensor_object.needs_render_target:
+            self._sim.renderer.bind_render_target(self._sensor_object)
 
         if self._spec.gpu2gpu_transfer:
             assert (
@@ -411,51 +748,115 @@ class Sensor:
 
             device = torch.device("cuda", self._sim.gpu_device)
             torch.cuda.set_device(device)
+        self._buffer = self._allocate_buffer()
+
+        noise_model_kwargs = self._spec.noise_model_kwargs
+        self._noise_model = make_sensor_noise_model(
+            self._spec.noise_model,
+            {"gpu_device_id": self._sim.gpu_device, **noise_model_kwargs},
+        )
+        assert self._noise_model.is_valid_sensor_type(
+            self._spec.sensor_type
+        ), "Noise model '{}' is not valid for sensor '{}'".format(
+            self._spec.noise_model, self._spec.uuid
+        )
+        if self._noise_model.attach_to_sensor(self._sensor_object):
+            # the sensor renders noisy observations, they only need a copy
+            self._noise_model = make_sensor_noise_model("None", {})
 
+    def _allocate_buffer(self):
+        if self._spec.gpu2gpu_transfer:
+            device = torch.device("cuda", self._sim.gpu_device)
             resolution = self._spec.resolution
             if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
-                self._buffer = torch.empty(
+                return torch.empty(
                     resolution[0], resolution[1], dtype=torch.int32, device=device
                 )
             elif self._spec.sensor_type == hsim.SensorType.DEPTH:
-                self._buffer = torch.empty(
+                return torch.empty(
                     resolution[0], resolution[1], dtype=torch.float32, device=device
                 )
             else:
-                self._buffer = torch.empty(
+                return torch.empty(
                     resolution[0], resolution[1], 4, dtype=torch.uint8, device=device
                 )
+
+        layout = self._spec.observation_layout
+        if layout == hsim.ObservationLayout.SEMANTIC_HISTOGRAM:
+            return np.empty((self._spec.semantic_histogram_bins,), dtype=np.uint32)
+        elif self._spec.sensor_type == hsim.SensorType.SEMANTIC:
+            return np.empty(
+                (self._spec.resolution[0], self._spec.resolution[1]), dtype=np.uint32
+            )
+        elif self._spec.sensor_type == hsim.SensorType.DEPTH:
+            dtype = {
+                hsim.ObservationLayout.DEPTH_MILLIMETERS: np.uint16,
+                hsim.ObservationLayout.DEPTH_HALF: np.float16,
+            }.get(layout, np.float32)
+            shape = (self._spec.resolution[0], self._spec.resolution[1])
+            if layout in (
+                hsim.ObservationLayout.POINTS_CAMERA,
+                hsim.ObservationLayout.POINTS_WORLD,
+            ):
+                shape += (3,)
+            return np.empty(shape, dtype=dtype)
         else:
-            if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
-                self._buffer = np.empty(
-                    (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.uint32,
-                )
-            elif self._spec.sensor_type == hsim.SensorType.DEPTH:
-                self._buffer = np.empty(
-                    (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.float32,
-                )
-            else:
-                self._buffer = np.empty(
-                    (
-                        self._spec.resolution[0],
-                        self._spec.resolution[1],
-                        self._spec.channels,
-                    ),
-                    dtype=np.uint8,
+            channels = {
+                hsim.ObservationLayout.RGB: 3,
+                hsim.ObservationLayout.GRAYSCALE: 1,
+            }.get(layout, self._spec.channels)
+            return np.empty(
+                (self._spec.resolution[0], self._spec.resolution[1], channels),
+                dtype=np.uint8,
+            )
+
+    def set_observation_destination(self, buffer=None):
+        r"""Read observations straight into `buffer`, e.g. one row of an array
+        stacking the observations of many simulators, instead of the sensor's
+        own buffer. `None` goes back to an own buffer.
+
+        The buffer has to be contiguous and of the shape and type of the
+        sensor's own buffer, a CUDA tensor on the simulator's device for
+        `SensorSpec.gpu2gpu_transfer`. Rows are stored bottom-up, the
+        observations returned are flipped views of it.
+        """
+        if buffer is None:
+            self._buffer = self._allocate_buffer()
+            return
+
+        own = self._buffer
+        if self._spec.gpu2gpu_transfer:
+            valid = (
+                torch.is_tensor(buffer)
+                and buffer.is_contiguous()
+                and buffer.device == own.device
+                and buffer.dtype == own.dtype
+                and buffer.shape == own.shape
+            )
+        else:
+            valid = (
+                isinstance(buffer, np.ndarray)
+                and buffer.flags["C_CONTIGUOUS"]
+                and buffer.flags["WRITEABLE"]
+                and buffer.dtype == own.dtype
+                and buffer.shape == own.shape
+            )
+        if not valid:
+            raise ValueError(
+                "Expected a contiguous buffer like {} {} of sensor {}".format(
+                    tuple(own.shape), own.dtype, self._spec.uuid
                 )
+            )
+        self._buffer = buffer
 
-        noise_model_kwargs = self._spec.noise_model_kwargs
-        self._noise_model = make_sensor_noise_model(
-            self._spec.noise_model,
-            {"gpu_device_id": self._sim.gpu_device, **noise_model_kwargs},
-        )
-        assert self._noise_model.is_valid_sensor_type(
-            self._spec.sensor_type
-        ), "Noise model '{}' is not valid for sensor '{}'".format(
-            self._spec.noise_model, self._spec.uuid
-        )
+    def schedule_observation(self):
+        r"""Whether the next observation has to be rendered, see
+        `SensorSpec.update_interval`. Each call counts as one observation.
+        """
+        return self._sensor_object.schedule_observation()
+
+    def request_update(self):
+        self._sensor_object.request_update()
 
     def draw_observation(self):
         # sanity check:
@@ -488,46 +889,43 @@ class Sensor:
         agent_node = self._agent.scene_node
         agent_node.parent = scene.get_root_node()
 
-        with self._sensor_object.render_target as tgt:
-            self._sim.renderer.draw(
-                self._sensor_object, scene, self._sim.frustum_culling
-            )
+        # panoramic and distorted sensors draw intermediate views before their
+        # render target, so let the sensor do the drawing
+        self._sensor_object.draw_observation(self._sim._sim)
 
     def get_observation(self):
 
-        tgt = self._sensor_object.render_target
-
         if self._spec.gpu2gpu_transfer:
+            tgt = self._sensor_object.render_target
             with torch.cuda.device(self._buffer.device):
+                # copy on the current torch stream so that the copy is
+                # ordered with the work consuming the observation
+                stream = torch.cuda.current_stream().cuda_stream
                 if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
-                    tgt.read_frame_object_id_gpu(self._buffer.data_ptr())
+                    tgt.read_frame_object_id_gpu(self._buffer.data_ptr(), stream)
                 elif self._spec.sensor_type == hsim.SensorType.DEPTH:
-                    tgt.read_frame_depth_gpu(self._buffer.data_ptr())
+                    tgt.read_frame_depth_gpu(self._buffer.data_ptr(), stream)
                 else:
-                    tgt.read_frame_rgba_gpu(self._buffer.data_ptr())
+                    tgt.read_frame_rgba_gpu(self._buffer.data_ptr(), stream)
 
                 obs = self._buffer.flip(0)
         else:
-            size = self._sensor_object.framebuffer_size
-
-            if self._spec.sensor_type == hsim.SensorType.SEMANTIC:
-                tgt.read_frame_object_id(
-                    mn.MutableImageView2D(mn.PixelFormat.R32UI, size, self._buffer)
-                )
-            elif self._spec.sensor_type == hsim.SensorType.DEPTH:
-                tgt.read_frame_depth(
-                    mn.MutableImageView2D(mn.PixelFormat.R32F, size, self._buffer)
-                )
+            # downsampled and converted to the observation layout on the GPU
+            self._sensor_object.read_observation(self._buffer)
+            if (
+                self._spec.sensor_type == hsim.SensorType.SEMANTIC
+                and self._spec.semantic_category_ids
+            ):
+                self._sim.semantic_scene.semantic_ids_to_categories(self._buffer)
+
+            if (
+                self._spec.observation_layout
+                == hsim.ObservationLayout.SEMANTIC_HISTOGRAM
+            ):
+                # pixel counts, not an image
+                obs = self._buffer
             else:
-                tgt.read_frame_rgba(
-                    mn.MutableImageView2D(
-                        mn.PixelFormat.RGBA8_UNORM,
-                        size,
-                        self._buffer.reshape(self._spec.resolution[0], -1),
-                    )
-                )
-
-            obs = np.flip(self._buffer, axis=0)
+                obs = np.flip(self._buffer, axis=0)
 
         return self._noise_model(obs)
 
@@ -10,7 +10,7 @@ import numpy as np
 import habitat_sim
 import habitat_sim.bindings as hsim
 from habitat_sim.agent import AgentState
-from habitat_sim.utils.common import quat_from_two_vectors
+from habitat_sim.utils.common import quat_from_two_vectors, quat_to_coeffs
 from habitat_sim.utils.data.data_structures import ExtractorLRUCache
 from habitat_sim.utils.data.pose_extractor import PoseExtractor
 
@@ -132,6 +132,53 @@ class ImageExtractor:
     def __len__(self):
         return len(self.mode_to_data[self.mode])
 
+    def _get_batch(self, indices):
+        r"""Samples of many indices, rendering all poses of a scene in one
+        :ref:`Simulator.render_agent_poses` call instead of one
+        :ref:`Simulator.get_sensor_observations` call per pose
+        """
+        mymode = self.mode.lower()
+        poses = self.mode_to_data[mymode]
+        samples = {}
+        missing = []
+        for idx in indices:
+            if self.use_caching and (idx, mymode) in self.cache:
+                samples[idx] = self.cache[(idx, mymode)]
+            else:
+                missing.append(idx)
+
+        sensor_names = [self.out_name_to_sensor_name[name] for name in self.output]
+        start = 0
+        while start < len(missing):
+            # consecutive poses of the same scene are rendered together
+            fp = poses[missing[start]][3]
+            stop = start
+            while stop < len(missing) and poses[missing[stop]][3] == fp:
+                stop += 1
+            run = missing[start:stop]
+            start = stop
+
+            if fp != self.cur_fp:
+                self.sim.reconfigure(self._config_sim(fp, self.img_size))
+                self.cur_fp = fp
+
+            positions = np.array([poses[i][0] for i in run], dtype=np.float32)
+            rotations = np.array(
+                [quat_to_coeffs(poses[i][1]) for i in run], dtype=np.float32
+            )
+            obs = self.sim.render_agent_poses(positions, rotations, sensor_names)
+            for k, idx in enumerate(run):
+                sample = {
+                    out_name: obs[self.out_name_to_sensor_name[out_name]][k]
+                    for out_name in self.output
+                }
+                sample["label"] = poses[idx][2]
+                if self.use_caching:
+                    self.cache.add((idx, mymode), sample)
+                samples[idx] = sample
+
+        return [samples[idx] for idx in indices]
+
     def __getitem__(self, idx):
         if isinstance(idx, slice):
             start, stop, step = idx.start, idx.stop, idx.step
@@ -142,11 +189,13 @@ class ImageExtractor:
             if step is None:
                 step = 1
 
-            return [
-                self.__getitem__(i)
-                for i in range(start, stop, step)
-                if i < len(self.mode_to_data[self.mode])
-            ]
+            return self._get_batch(
+                [
+                    i
+                    for i in range(start, stop, step)
+                    if i < len(self.mode_to_data[self.mode])
+                ]
+            )
 
         mymode = self.mode.lower()
         if self.use_caching:
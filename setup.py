@@ -66,6 +66,18 @@ Use "HEADLESS=True pip install ." to build in headless mode with pip""",
         action="store_true",
         help="Build data tool",
     )
+    parser.add_argument(
+        "--build-benchmark",
+        dest="build_benchmark",
+        action="store_true",
+        help="Build the native benchmark of simulator steps",
+    )
+    parser.add_argument(
+        "--build-c-bindings",
+        dest="build_c_bindings",
+        action="store_true",
+        help="Build the C API shared library for embedding without Python",
+    )
     parser.add_argument(
         "--cmake-args",
         type=str,
@@ -255,6 +267,12 @@ class CMakeBuild(build_ext):
         cmake_args += [
             "-DBUILD_DATATOOL={}".format("ON" if args.build_datatool else "OFF")
         ]
+        cmake_args += [
+            "-DBUILD_BENCHMARK={}".format("ON" if args.build_benchmark else "OFF")
+        ]
+        cmake_args += [
+            "-DBUILD_C_BINDINGS={}".format("ON" if args.build_c_bindings else "OFF")
+        ]
         cmake_args += ["-DBUILD_WITH_CUDA={}".format("ON" if args.with_cuda else "OFF")]
 
         env = os.environ.copy()
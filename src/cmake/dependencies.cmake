@@ -16,6 +16,9 @@ find_package(Corrade REQUIRED Utility)
 
 # OpenMP
 find_package(OpenMP)
+
+# zlib, optional, for compressed navmeshes
+find_package(ZLIB)
 # We don't find_package(OpenGL REQUIRED) here, but let Magnum do that instead
 # as it sets up various things related to GLVND.
 
@@ -4,15 +4,15 @@
 
 #include "Agent.h"
 
-#include <Magnum/EigenIntegration/GeometryIntegration.h>
-#include <Magnum/EigenIntegration/Integration.h>
-
+#include "esp/core/MathInterop.h"
 #include "esp/scene/ObjectControls.h"
+#include "esp/sensor/EquirectangularCamera.h"
+#include "esp/sensor/FisheyeCamera.h"
 #include "esp/sensor/PinholeCamera.h"
+#include "esp/sensor/RayCastCamera.h"
+#include "esp/sensor/ReprojectionCamera.h"
 #include "esp/sensor/Sensor.h"
 
-using Magnum::EigenIntegration::cast;
-
 namespace esp {
 namespace agent {
 
@@ -27,43 +27,85 @@ Agent::Agent(scene::SceneNode& agentNode, const AgentConfiguration& cfg)
       controls_(scene::ObjectControls::create()) {
   agentNode.setType(scene::SceneNodeType::AGENT);
   for (sensor::SensorSpec::ptr spec : cfg.sensorSpecifications) {
-    // TODO: this should take type into account to create appropriate
-    // sensor
-
     auto& sensorNode = agentNode.createChild();
-    sensors_.add(
-        sensor::PinholeCamera::create(sensorNode, spec));  // transformed within
+    if (spec->sensorSubtype == "equirectangular") {
+      sensors_.add(sensor::EquirectangularCamera::create(sensorNode, spec));
+    } else if (spec->sensorSubtype == "fisheye") {
+      sensors_.add(sensor::FisheyeCamera::create(sensorNode, spec));
+    } else if (spec->sensorSubtype == "raycast") {
+      sensors_.add(sensor::RayCastCamera::create(sensorNode, spec));
+    } else if (spec->sensorSubtype == "reprojection") {
+      sensors_.add(sensor::ReprojectionCamera::create(sensorNode, spec));
+    } else {
+      sensors_.add(sensor::PinholeCamera::create(
+          sensorNode, spec));  // transformed within
+    }
   }
+  compileActions();
 }
 
 Agent::~Agent() {
-  LOG(INFO) << "Deconstructing Agent";
+  VLOG(1) << "Deconstructing Agent";
   sensors_.clear();
 }
 
-bool Agent::act(const std::string& actionName) {
-  if (hasAction(actionName)) {
-    const ActionSpec& actionSpec = *configuration_.actionSpace.at(actionName);
-    if (BodyActions.find(actionSpec.name) != BodyActions.end()) {
-      controls_->action(object(), actionSpec.name,
-                        actionSpec.actuation.at("amount"),
-                        /*applyFilter=*/true);
-    } else {
-      for (auto p : sensors_.getSensors()) {
-        controls_->action(p.second->object(), actionSpec.name,
-                          actionSpec.actuation.at("amount"),
-                          /*applyFilter=*/false);
-      }
+void Agent::compileActions() {
+  actions_.clear();
+  actionIndices_.clear();
+  for (const auto& action : configuration_.actionSpace) {
+    const ActionSpec& actionSpec = *action.second;
+    CompiledAction compiled{controls_->getMoveFunc(actionSpec.name), 0.0f,
+                            BodyActions.count(actionSpec.name) != 0, false};
+    auto amount = actionSpec.actuation.find("amount");
+    if (amount != actionSpec.actuation.end()) {
+      compiled.amount = amount->second;
+      compiled.hasAmount = true;
     }
+    actionIndices_.emplace(action.first, int(actions_.size()));
+    actions_.push_back(compiled);
+  }
+}
+
+bool Agent::act(const std::string& actionName) {
+  const int actionIndex = getActionIndex(actionName);
+  return actionIndex != -1 && act(actionIndex);
+}
+
+bool Agent::act(int actionIndex) {
+  if (actionIndex < 0 || actionIndex >= int(actions_.size())) {
+    return false;
+  }
+  const CompiledAction& action = actions_[actionIndex];
+  if (!action.hasAmount) {
+    LOG(ERROR) << "Agent::act(): action " << actionIndex
+               << " has no amount in its actuation";
+    return false;
+  }
+  if (action.moveFunc == nullptr) {
+    LOG(ERROR) << "Agent::act(): action " << actionIndex
+               << " is not known to the controls";
     return true;
+  }
+  if (action.body) {
+    controls_->action(object(), *action.moveFunc, action.amount,
+                      /*applyFilter=*/true);
   } else {
-    return false;
+    applySensorReset();
+    for (const auto& p : sensors_.getSensors()) {
+      controls_->action(p.second->object(), *action.moveFunc, action.amount,
+                        /*applyFilter=*/false);
+    }
   }
+  return true;
+}
+
+bool Agent::hasAction(const std::string& actionName) const {
+  return actionIndices_.find(actionName) != actionIndices_.end();
 }
 
-bool Agent::hasAction(const std::string& actionName) {
-  auto actionSpace = configuration_.actionSpace;
-  return !(actionSpace.find(actionName) == actionSpace.end());
+int Agent::getActionIndex(const std::string& actionName) const {
+  auto found = actionIndices_.find(actionName);
+  return found == actionIndices_.end() ? -1 : found->second;
 }
 
 void Agent::reset() {
@@ -71,28 +113,38 @@ void Agent::reset() {
 }
 
 void Agent::getState(AgentState::ptr state) const {
-  // TODO this should be done less hackishly
-  state->position = cast<vec3f>(node().absoluteTransformation().translation());
-  state->rotation = quatf(node().rotation()).coeffs();
+  // written in place, vec3f and vec4f share the layout of the Magnum types
+  core::asMagnum(state->position) =
+      node().absoluteTransformation().translation();
+  core::asMagnumQuaternion(state->rotation) = node().rotation();
   // TODO other state members when implemented
 }
 
 void Agent::setState(const AgentState& state,
                      const bool resetSensors /*= true*/) {
-  node().setTranslation(Magnum::Vector3(state.position));
-
-  const Eigen::Map<const quatf> rot(state.rotation.data());
-  CHECK_LT(std::abs(rot.norm() - 1.0),
+  const Magnum::Quaternion& rot = core::asMagnumQuaternion(state.rotation);
+  CHECK_LT(std::abs(rot.length() - 1.0),
            2.0 * Magnum::Math::TypeTraits<float>::epsilon())
       << state.rotation << " not a valid rotation";
-  node().setRotation(Magnum::Quaternion(quatf(rot)).normalized());
+  setPose(core::asMagnum(state.position), rot.normalized(), resetSensors);
+  // TODO other state members when implemented
+}
 
+void Agent::setPose(const Magnum::Vector3& position,
+                    const Magnum::Quaternion& rotation,
+                    bool resetSensors /*= true*/) {
+  node().setTranslation(position);
+  node().setRotation(rotation);
   if (resetSensors) {
-    for (auto p : sensors_.getSensors()) {
-      p.second->setTransformationFromSpec();
-    }
+    sensorResetPending_ = true;
   }
-  // TODO other state members when implemented
+}
+
+void Agent::resetSensorTransformations() const {
+  for (const auto& p : sensors_.getSensors()) {
+    p.second->setTransformationFromSpec();
+  }
+  sensorResetPending_ = false;
 }
 
 bool operator==(const ActionSpec& a, const ActionSpec& b) {
@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "esp/core/esp.h"
 #include "esp/scene/ObjectControls.h"
@@ -104,14 +105,61 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
 
   bool act(const std::string& actionName);
 
-  bool hasAction(const std::string& actionName);
+  /**
+   * @brief Perform the action at @p actionIndex in the compiled action table
+   * @return False if there's no such action
+   *
+   * A table lookup and a call, without string comparisons or allocations.
+   * Indices are those of @ref getActionIndex().
+   */
+  bool act(int actionIndex);
+
+  bool hasAction(const std::string& actionName) const;
+
+  /**
+   * @brief Index of the action named @p actionName for @ref act(int), -1 if
+   * the action space has no such action
+   *
+   * Actions are indexed in the order of the action space, i.e. by name.
+   */
+  int getActionIndex(const std::string& actionName) const;
+
+  /** @brief Number of actions in the compiled action table */
+  int getActionCount() const { return int(actions_.size()); }
+
+  /**
+   * @brief Rebuild the action table from the action space of
+   * @ref getConfig()
+   *
+   * Done on construction. Call it after changing the action space of the
+   * configuration, otherwise the agent keeps acting on the old one.
+   */
+  void compileActions();
 
   void reset();
 
   void getState(AgentState::ptr state) const;
 
+  /**
+   * @brief Move the agent to @p state
+   *
+   * With @p resetSensors the sensors go back to their specified poses
+   * relative to the agent. That happens lazily, once the sensors are next
+   * accessed through @ref getSensorSuite() or moved by an action, so setting
+   * many agent states in a row doesn't touch sensors nobody looks at.
+   */
   void setState(const AgentState& state, const bool resetSensors = true);
 
+  /**
+   * @brief Move the agent to @p position and @p rotation
+   *
+   * Like @ref setState() without the conversions, @p rotation is expected to
+   * be normalized.
+   */
+  void setPose(const Magnum::Vector3& position,
+               const Magnum::Quaternion& rotation,
+               bool resetSensors = true);
+
   void setInitialState(const AgentState& state,
                        const bool resetSensors = true) {
     initialState_ = state;
@@ -120,8 +168,14 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
 
   scene::ObjectControls::ptr getControls() { return controls_; }
 
-  const sensor::SensorSuite& getSensorSuite() const { return sensors_; }
-  sensor::SensorSuite& getSensorSuite() { return sensors_; }
+  const sensor::SensorSuite& getSensorSuite() const {
+    applySensorReset();
+    return sensors_;
+  }
+  sensor::SensorSuite& getSensorSuite() {
+    applySensorReset();
+    return sensors_;
+  }
 
   const AgentConfiguration& getConfig() const { return configuration_; }
   AgentConfiguration& getConfig() { return configuration_; }
@@ -133,10 +187,34 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
   static const std::set<std::string> BodyActions;
 
  private:
+  // An action of the action space, everything act() needs resolved
+  struct CompiledAction {
+    // nullptr if the controls have no such action
+    const scene::ObjectControls::MoveFunc* moveFunc;
+    float amount;
+    // whether the action moves the body or the sensors
+    bool body;
+    // whether the actuation has an amount at all
+    bool hasAmount;
+  };
+
+  // resets the sensor transformations if a setState() asked for it
+  void applySensorReset() const {
+    if (sensorResetPending_) {
+      resetSensorTransformations();
+    }
+  }
+  void resetSensorTransformations() const;
+
   AgentConfiguration configuration_;
   sensor::SensorSuite sensors_;
   scene::ObjectControls::ptr controls_;
   AgentState initialState_;
+  std::vector<CompiledAction> actions_;
+  // index of each action in actions_
+  std::map<std::string, int> actionIndices_;
+  // mutable, as the sensor transformations are reset on const access too
+  mutable bool sensorResetPending_ = false;
 
   ESP_SMART_POINTERS(Agent)
 };
@@ -34,7 +34,8 @@ AssetInfo AssetInfo::fromPath(const std::string& path) {
 bool operator==(const AssetInfo& a, const AssetInfo& b) {
   return a.type == b.type && a.filepath == b.filepath && a.frame == b.frame &&
          a.virtualUnitToMeters == b.virtualUnitToMeters &&
-         a.requiresLighting == b.requiresLighting;
+         a.requiresLighting == b.requiresLighting &&
+         a.semanticMeshFilepath == b.semanticMeshFilepath;
 }
 
 bool operator!=(const AssetInfo& a, const AssetInfo& b) {
@@ -35,6 +35,10 @@ struct AssetInfo {
   geo::CoordinateFrame frame;
   float virtualUnitToMeters = 1.0f;
   bool requiresLighting = false;
+  //! Instance mesh whose object IDs are put on the vertices of this general
+  //! mesh, so semantic sensors draw it instead of a scene of its own. Empty
+  //! for none
+  std::string semanticMeshFilepath;
 
   //! Populates a preset AssetInfo by matching against known filepaths
   static AssetInfo fromPath(const std::string& filepath);
@@ -27,15 +27,58 @@ PhysicsObjectAttributes::PhysicsObjectAttributes() : Configuration() {
   setCollisionMeshHandle("");
   setBoundingBoxCollisions(false);
   setJoinCollisionMeshes(true);
+  setCollisionGroup(0);
+  setCollisionMask(0);
+  setCollisionHullCache("");
   setRequiresLighting(true);
 }
 
+void PhysicsObjectAttributes::updateTypedValue(const std::string& key) {
+  loadTypedValue(key, "COM", com_) ||
+      loadTypedValue(key, "margin", margin_) ||
+      loadTypedValue(key, "mass", mass_) ||
+      loadTypedValue(key, "inertia", inertia_) ||
+      loadTypedValue(key, "scale", scale_) ||
+      loadTypedValue(key, "frictionCoefficient", frictionCoefficient_) ||
+      loadTypedValue(key, "restitutionCoefficient", restitutionCoefficient_) ||
+      loadTypedValue(key, "linearDamping", linearDamping_) ||
+      loadTypedValue(key, "angularDamping", angularDamping_) ||
+      loadTypedValue(key, "originHandle", originHandle_) ||
+      loadTypedValue(key, "renderMeshHandle", renderMeshHandle_) ||
+      loadTypedValue(key, "collisionMeshHandle", collisionMeshHandle_) ||
+      loadTypedValue(key, "objectTemplateID", objectTemplateID_) ||
+      loadTypedValue(key, "useBoundingBoxForCollision",
+                     useBoundingBoxForCollision_) ||
+      loadTypedValue(key, "joinCollisionMeshes", joinCollisionMeshes_) ||
+      loadTypedValue(key, "collisionGroup", collisionGroup_) ||
+      loadTypedValue(key, "collisionMask", collisionMask_) ||
+      loadTypedValue(key, "collisionHullCache", collisionHullCache_) ||
+      loadTypedValue(key, "requiresLighting", requiresLighting_);
+}
+
 PhysicsSceneAttributes::PhysicsSceneAttributes() : Configuration() {
   setGravity({0, -9.8, 0});
   setFrictionCoefficient(0.4);
   setRestitutionCoefficient(0.05);
   setRenderMeshHandle("");
   setCollisionMeshHandle("");
+  setCollisionBvhCacheDirectory("");
+  setMergeCollisionMeshes(false);
+  setCollisionWeldDistance(0.001);
+  setCollisionChunkSize(0.0);
+}
+
+void PhysicsSceneAttributes::updateTypedValue(const std::string& key) {
+  loadTypedValue(key, "gravity", gravity_) ||
+      loadTypedValue(key, "frictionCoefficient", frictionCoefficient_) ||
+      loadTypedValue(key, "restitutionCoefficient", restitutionCoefficient_) ||
+      loadTypedValue(key, "renderMeshHandle", renderMeshHandle_) ||
+      loadTypedValue(key, "collisionMeshHandle", collisionMeshHandle_) ||
+      loadTypedValue(key, "collisionBvhCacheDirectory",
+                     collisionBvhCacheDirectory_) ||
+      loadTypedValue(key, "mergeCollisionMeshes", mergeCollisionMeshes_) ||
+      loadTypedValue(key, "collisionWeldDistance", collisionWeldDistance_) ||
+      loadTypedValue(key, "collisionChunkSize", collisionChunkSize_);
 }
 
 PhysicsManagerAttributes::PhysicsManagerAttributes() : Configuration() {
@@ -44,5 +87,11 @@ PhysicsManagerAttributes::PhysicsManagerAttributes() : Configuration() {
   setMaxSubsteps(10);
 }
 
+void PhysicsManagerAttributes::updateTypedValue(const std::string& key) {
+  loadTypedValue(key, "simulator", simulator_) ||
+      loadTypedValue(key, "timestep", timestep_) ||
+      loadTypedValue(key, "maxSubsteps", maxSubsteps_);
+}
+
 }  // namespace assets
 }  // namespace esp
@@ -31,94 +31,133 @@ class PhysicsObjectAttributes : public esp::core::Configuration {
 
   // center of mass (COM)
   void setCOM(const Magnum::Vector3& com) { setVec3("COM", com); }
-  Magnum::Vector3 getCOM() const { return getVec3("COM"); }
+  const Magnum::Vector3& getCOM() const { return com_; }
 
   // collision shape inflation margin
   void setMargin(double margin) { setDouble("margin", margin); }
-  double getMargin() const { return getDouble("margin"); }
+  double getMargin() const { return margin_; }
 
   void setMass(double mass) { setDouble("mass", mass); }
-  double getMass() const { return getDouble("mass"); }
+  double getMass() const { return mass_; }
 
   // inertia diagonal
   void setInertia(const Magnum::Vector3& inertia) {
     setVec3("inertia", inertia);
   }
-  Magnum::Vector3 getInertia() const { return getVec3("inertia"); }
+  const Magnum::Vector3& getInertia() const { return inertia_; }
 
   void setScale(const Magnum::Vector3& scale) { setVec3("scale", scale); }
-  Magnum::Vector3 getScale() const { return getVec3("scale"); }
+  const Magnum::Vector3& getScale() const { return scale_; }
 
   void setFrictionCoefficient(double frictionCoefficient) {
     setDouble("frictionCoefficient", frictionCoefficient);
   }
-  double getFrictionCoefficient() const {
-    return getDouble("frictionCoefficient");
-  }
+  double getFrictionCoefficient() const { return frictionCoefficient_; }
 
   void setRestitutionCoefficient(double restitutionCoefficient) {
     setDouble("restitutionCoefficient", restitutionCoefficient);
   }
-  double getRestitutionCoefficient() const {
-    return getDouble("restitutionCoefficient");
-  }
+  double getRestitutionCoefficient() const { return restitutionCoefficient_; }
 
   void setLinearDamping(double linearDamping) {
     setDouble("linearDamping", linearDamping);
   }
-  double getLinearDamping() const { return getDouble("linearDamping"); }
+  double getLinearDamping() const { return linearDamping_; }
 
   void setAngularDamping(double angularDamping) {
     setDouble("angularDamping", angularDamping);
   }
-  double getAngularDamping() const { return getDouble("angularDamping"); }
+  double getAngularDamping() const { return angularDamping_; }
 
   void setOriginHandle(const std::string& originHandle) {
     setString("originHandle", originHandle);
   }
-  std::string getOriginHandle() const { return getString("originHandle"); }
+  const std::string& getOriginHandle() const { return originHandle_; }
 
   void setRenderMeshHandle(const std::string& renderMeshHandle) {
     setString("renderMeshHandle", renderMeshHandle);
   }
-  std::string getRenderMeshHandle() const {
-    return getString("renderMeshHandle");
-  }
+  const std::string& getRenderMeshHandle() const { return renderMeshHandle_; }
 
   void setCollisionMeshHandle(const std::string& collisionMeshHandle) {
     setString("collisionMeshHandle", collisionMeshHandle);
   }
-  std::string getCollisionMeshHandle() const {
-    return getString("collisionMeshHandle");
+  const std::string& getCollisionMeshHandle() const {
+    return collisionMeshHandle_;
   }
 
   void setObjectTemplateID(int objectTemplateID) {
     setInt("objectTemplateID", objectTemplateID);
   }
 
-  int getObjectTemplateID() const { return getInt("objectTemplateID"); }
+  int getObjectTemplateID() const { return objectTemplateID_; }
 
   // if true override other settings and use render mesh bounding box as
   // collision object
   void setBoundingBoxCollisions(bool useBoundingBoxForCollision) {
     setBool("useBoundingBoxForCollision", useBoundingBoxForCollision);
   }
-  bool getBoundingBoxCollisions() const {
-    return getBool("useBoundingBoxForCollision");
-  }
+  bool getBoundingBoxCollisions() const { return useBoundingBoxForCollision_; }
 
   // if true join all mesh components of an asset into a unified collision
   // object
   void setJoinCollisionMeshes(bool joinCollisionMeshes) {
     setBool("joinCollisionMeshes", joinCollisionMeshes);
   }
-  bool getJoinCollisionMeshes() const { return getBool("joinCollisionMeshes"); }
+  bool getJoinCollisionMeshes() const { return joinCollisionMeshes_; }
+
+  // broadphase collision filtering: two objects only collide if the group of
+  // each is in the mask of the other. Zero keeps Bullet's default for the
+  // motion type, e.g. props in their own group with a mask excluding it
+  // collide with the scene and other objects but not with each other.
+  void setCollisionGroup(int collisionGroup) {
+    setInt("collisionGroup", collisionGroup);
+  }
+  int getCollisionGroup() const { return collisionGroup_; }
+
+  void setCollisionMask(int collisionMask) {
+    setInt("collisionMask", collisionMask);
+  }
+  int getCollisionMask() const { return collisionMask_; }
+
+  // if not empty, file the convex collision hulls are loaded from, or stored
+  // to if it doesn't exist or was made from different meshes
+  void setCollisionHullCache(const std::string& collisionHullCache) {
+    setString("collisionHullCache", collisionHullCache);
+  }
+  const std::string& getCollisionHullCache() const {
+    return collisionHullCache_;
+  }
 
   // if true use phong illumination model instead of flat shading
   void setRequiresLighting(bool requiresLighting) {
     setBool("requiresLighting", requiresLighting);
   }
-  bool getRequiresLighting() const { return getBool("requiresLighting"); }
+  bool getRequiresLighting() const { return requiresLighting_; }
+
+ protected:
+  void updateTypedValue(const std::string& key) override;
+
+  // typed copies of the values above
+  Magnum::Vector3 com_;
+  double margin_ = 0.0;
+  double mass_ = 0.0;
+  Magnum::Vector3 inertia_;
+  Magnum::Vector3 scale_;
+  double frictionCoefficient_ = 0.0;
+  double restitutionCoefficient_ = 0.0;
+  double linearDamping_ = 0.0;
+  double angularDamping_ = 0.0;
+  std::string originHandle_;
+  std::string renderMeshHandle_;
+  std::string collisionMeshHandle_;
+  int objectTemplateID_ = 0;
+  bool useBoundingBoxForCollision_ = false;
+  bool joinCollisionMeshes_ = false;
+  int collisionGroup_ = 0;
+  int collisionMask_ = 0;
+  std::string collisionHullCache_;
+  bool requiresLighting_ = false;
 
   ESP_SMART_POINTERS(PhysicsObjectAttributes)
 
@@ -132,35 +171,69 @@ class PhysicsSceneAttributes : public esp::core::Configuration {
   void setGravity(const Magnum::Vector3& gravity) {
     setVec3("gravity", gravity);
   }
-  Magnum::Vector3 getGravity() const { return getVec3("gravity"); }
+  const Magnum::Vector3& getGravity() const { return gravity_; }
 
   void setFrictionCoefficient(double frictionCoefficient) {
     setDouble("frictionCoefficient", frictionCoefficient);
   }
-  double getFrictionCoefficient() const {
-    return getDouble("frictionCoefficient");
-  }
+  double getFrictionCoefficient() const { return frictionCoefficient_; }
 
   void setRestitutionCoefficient(double restitutionCoefficient) {
     setDouble("restitutionCoefficient", restitutionCoefficient);
   }
-  double getRestitutionCoefficient() const {
-    return getDouble("restitutionCoefficient");
-  }
+  double getRestitutionCoefficient() const { return restitutionCoefficient_; }
 
   void setRenderMeshHandle(const std::string& renderMeshHandle) {
     setString("renderMeshHandle", renderMeshHandle);
   }
-  std::string getRenderMeshHandle() const {
-    return getString("renderMeshHandle");
-  }
+  const std::string& getRenderMeshHandle() const { return renderMeshHandle_; }
 
   void setCollisionMeshHandle(const std::string& collisionMeshHandle) {
     setString("collisionMeshHandle", collisionMeshHandle);
   }
-  std::string getCollisionMeshHandle() const {
-    return getString("collisionMeshHandle");
+  const std::string& getCollisionMeshHandle() const {
+    return collisionMeshHandle_;
+  }
+
+  // if not empty, directory the BVHs of the collision meshes are loaded from,
+  // or stored to if they don't exist yet, named after a hash of the meshes
+  void setCollisionBvhCacheDirectory(const std::string& directory) {
+    setString("collisionBvhCacheDirectory", directory);
+  }
+  const std::string& getCollisionBvhCacheDirectory() const {
+    return collisionBvhCacheDirectory_;
+  }
+
+  // whether the collision meshes are merged into one, welded at the weld
+  // distance, and split into chunks of the chunk size if it is positive
+  void setMergeCollisionMeshes(bool mergeCollisionMeshes) {
+    setBool("mergeCollisionMeshes", mergeCollisionMeshes);
+  }
+  bool getMergeCollisionMeshes() const { return mergeCollisionMeshes_; }
+
+  void setCollisionWeldDistance(double collisionWeldDistance) {
+    setDouble("collisionWeldDistance", collisionWeldDistance);
+  }
+  double getCollisionWeldDistance() const { return collisionWeldDistance_; }
+
+  void setCollisionChunkSize(double collisionChunkSize) {
+    setDouble("collisionChunkSize", collisionChunkSize);
   }
+  double getCollisionChunkSize() const { return collisionChunkSize_; }
+
+ protected:
+  void updateTypedValue(const std::string& key) override;
+
+  // typed copies of the values above
+  Magnum::Vector3 gravity_;
+  double frictionCoefficient_ = 0.0;
+  double restitutionCoefficient_ = 0.0;
+  std::string renderMeshHandle_;
+  std::string collisionMeshHandle_;
+  std::string collisionBvhCacheDirectory_;
+  bool mergeCollisionMeshes_ = false;
+  double collisionWeldDistance_ = 0.0;
+  double collisionChunkSize_ = 0.0;
 
   ESP_SMART_POINTERS(PhysicsSceneAttributes)
 
@@ -174,13 +247,21 @@ class PhysicsManagerAttributes : public esp::core::Configuration {
   void setSimulator(const std::string& simulator) {
     setString("simulator", simulator);
   }
-  std::string getSimulator() const { return getString("simulator"); }
+  const std::string& getSimulator() const { return simulator_; }
 
   void setTimestep(double timestep) { setDouble("timestep", timestep); }
-  double getTimestep() const { return getDouble("timestep"); }
+  double getTimestep() const { return timestep_; }
 
   void setMaxSubsteps(int maxSubsteps) { setInt("maxSubsteps", maxSubsteps); }
-  int getMaxSubsteps() const { return getInt("maxSubsteps"); }
+  int getMaxSubsteps() const { return maxSubsteps_; }
+
+ protected:
+  void updateTypedValue(const std::string& key) override;
+
+  // typed copies of the values above
+  std::string simulator_;
+  double timestep_ = 0.0;
+  int maxSubsteps_ = 0;
 
   ESP_SMART_POINTERS(PhysicsManagerAttributes)
 };  // end PhysicsManagerAttributes
@@ -103,6 +103,64 @@ class BaseMesh {
    */
   virtual void uploadBuffersToGPU(bool){};
 
+  /**
+   * @brief Start uploading the mesh data to GPU memory over several calls
+   * to @ref continueUploadToGPU()
+   *
+   * Allocates the GPU buffers only. Until the upload is done, the mesh is
+   * empty and draws nothing. Always false for @ref BaseMesh.
+   * @return Whether the upload was started, false if the mesh has to be
+   * uploaded at once with @ref uploadBuffersToGPU()
+   */
+  virtual bool beginUploadToGPU() { return false; }
+
+  /**
+   * @brief Upload the next part, at most as many bytes as passed, of the
+   * mesh data started by @ref beginUploadToGPU()
+   * @return Number of bytes uploaded
+   */
+  virtual size_t continueUploadToGPU(size_t) { return 0; }
+
+  /**
+   * @brief Whether an upload started by @ref beginUploadToGPU() is not done
+   * yet
+   */
+  virtual bool uploadPending() const { return false; }
+
+  /**
+   * @brief Free the CPU copies of the mesh data that only the GPU upload
+   * needs
+   *
+   * What collisions, navmesh recomputation, bounds and semantic queries read
+   * stays, including @ref getCollisionMeshData(). Does nothing for meshes not
+   * uploaded yet. See the overrides for what a later
+   * @ref uploadBuffersToGPU() with @p forceReload does. Nothing is released
+   * for @ref BaseMesh.
+   * @return Number of bytes freed
+   */
+  virtual size_t releaseUploadData() { return 0; }
+
+  /** @brief Whether @ref releaseUploadData() freed the CPU copies */
+  bool uploadDataReleased() const { return uploadDataReleased_; }
+
+  /**
+   * @brief Size of the vertex data uploaded by @ref uploadBuffersToGPU(), in
+   * bytes
+   */
+  size_t gpuVertexByteSize() const { return gpuVertexByteSize_; }
+
+  /**
+   * @brief Size of the index data uploaded by @ref uploadBuffersToGPU(), in
+   * bytes
+   */
+  size_t gpuIndexByteSize() const { return gpuIndexByteSize_; }
+
+  /**
+   * @brief Size of the textures owned by the mesh and uploaded by @ref
+   * uploadBuffersToGPU(), such as PTex atlases, in bytes
+   */
+  size_t gpuTextureByteSize() const { return gpuTextureByteSize_; }
+
   /**
    * @brief Get a pointer to the compiled rendering buffer for the asset.
    *
@@ -163,6 +221,16 @@ class BaseMesh {
    */
   bool buffersOnGPU_ = false;
 
+  /** @brief Whether @ref releaseUploadData() freed the CPU copies */
+  bool uploadDataReleased_ = false;
+
+  /** @brief GPU memory used by the uploaded buffers, see @ref
+   * gpuVertexByteSize(), @ref gpuIndexByteSize(), @ref gpuTextureByteSize()
+   */
+  size_t gpuVertexByteSize_ = 0;
+  size_t gpuIndexByteSize_ = 0;
+  size_t gpuTextureByteSize_ = 0;
+
   // ==== rendering ===
   /**
    * @brief Optional storage container for mesh render data.
@@ -4,25 +4,44 @@
 
 #include "GenericInstanceMeshData.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Directory.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/PackingBatch.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/MeshTools/Interleave.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Shaders/Generic.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferTextureFormat.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "esp/core/esp.h"
 #include "esp/geo/geo.h"
 #include "esp/io/io.h"
 #include "esp/io/json.h"
 
+#include "MeshOptimization.h"
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -37,14 +56,24 @@ struct InstancePlyData {
   std::vector<vec3uc> cpu_cbo;
   std::vector<uint32_t> cpu_ibo;
   std::vector<uint16_t> objectIds;
+  // one per triangle instead of objectIds if asked for
+  std::vector<uint32_t> primitiveObjectIds;
 };
 
 Cr::Containers::Optional<InstancePlyData> parsePly(
     Mn::Trade::AbstractImporter& importer,
-    const std::string& plyFile) {
+    const std::string& plyFile,
+    bool primitiveObjectIds = false) {
   /* Open the file. On error the importer already prints a diagnostic message,
-     so no need to do that here. The importer implicitly converts per-face
-     attributes to per-vertex, so nothing extra needs to be done. */
+     so no need to do that here. By default the importer converts per-face
+     attributes to per-vertex, duplicating vertices shared by faces with
+     different IDs, so nothing extra needs to be done. Without the conversion
+     the per-face attributes are in the second level of the mesh. */
+#ifdef MAGNUM_TARGET_GLES
+  // nothing can draw them
+  primitiveObjectIds = false;
+#endif
+  importer.configuration().setValue("perFaceToPerVertex", !primitiveObjectIds);
   Cr::Containers::Optional<Mn::Trade::MeshData> meshData;
   if (!importer.openFile(plyFile) || !(meshData = importer.mesh(0)))
     return Cr::Containers::NullOpt;
@@ -80,23 +109,46 @@ Cr::Containers::Optional<InstancePlyData> parsePly(
       Cr::Containers::arrayCast<Mn::Color3ub>(
           Cr::Containers::arrayView(data.cpu_cbo)));
 
-  /* Check we actually have object IDs before copying them, and that those are
-     in a range we expect them to be */
-  if (!meshData->hasAttribute(Mn::Trade::MeshAttribute::ObjectId)) {
-    LOG(ERROR) << "File has no object IDs";
-    return Cr::Containers::NullOpt;
-  }
-  Cr::Containers::Array<Mn::UnsignedInt> objectIds =
-      meshData->objectIdsAsArray();
-  if (Mn::Math::max(objectIds) > 65535) {
-    LOG(ERROR) << "Object IDs can't fit into 16 bits";
-    return Cr::Containers::NullOpt;
+  if (primitiveObjectIds) {
+    const size_t triangleCount = data.cpu_ibo.size() / 3;
+    Cr::Containers::Optional<Mn::Trade::MeshData> faces;
+    if (meshData->hasAttribute(Mn::Trade::MeshAttribute::ObjectId)) {
+      // stored per vertex in the file, triangles take that of their first
+      const Cr::Containers::Array<Mn::UnsignedInt> vertexIds =
+          meshData->objectIdsAsArray();
+      data.primitiveObjectIds.resize(triangleCount);
+      for (size_t i = 0; i != triangleCount; ++i) {
+        data.primitiveObjectIds[i] = vertexIds[data.cpu_ibo[i * 3]];
+      }
+    } else if (importer.meshLevelCount(0) > 1 &&
+               (faces = importer.mesh(0, 1)) &&
+               faces->hasAttribute(Mn::Trade::MeshAttribute::ObjectId) &&
+               faces->vertexCount() == triangleCount) {
+      data.primitiveObjectIds.resize(triangleCount);
+      faces->objectIdsInto(data.primitiveObjectIds);
+    } else {
+      LOG(ERROR) << "File has no object IDs per triangle";
+      return Cr::Containers::NullOpt;
+    }
+  } else {
+    /* Check we actually have object IDs before copying them, and that those
+       are in a range we expect them to be */
+    if (!meshData->hasAttribute(Mn::Trade::MeshAttribute::ObjectId)) {
+      LOG(ERROR) << "File has no object IDs";
+      return Cr::Containers::NullOpt;
+    }
+    Cr::Containers::Array<Mn::UnsignedInt> objectIds =
+        meshData->objectIdsAsArray();
+    if (Mn::Math::max(objectIds) > 65535) {
+      LOG(ERROR) << "Object IDs can't fit into 16 bits";
+      return Cr::Containers::NullOpt;
+    }
+    data.objectIds.resize(meshData->vertexCount());
+    Mn::Math::castInto(Cr::Containers::arrayCast<2, Mn::UnsignedInt>(
+                           Cr::Containers::stridedArrayView(objectIds)),
+                       Cr::Containers::arrayCast<2, Mn::UnsignedShort>(
+                           Cr::Containers::stridedArrayView(data.objectIds)));
   }
-  data.objectIds.resize(meshData->vertexCount());
-  Mn::Math::castInto(Cr::Containers::arrayCast<2, Mn::UnsignedInt>(
-                         Cr::Containers::stridedArrayView(objectIds)),
-                     Cr::Containers::arrayCast<2, Mn::UnsignedShort>(
-                         Cr::Containers::stridedArrayView(data.objectIds)));
 
   // Generic Semantic PLY meshes have -Z gravity
   const quatf T_esp_scene =
@@ -108,6 +160,49 @@ Cr::Containers::Optional<InstancePlyData> parsePly(
   return data;
 }
 
+/* Layout of baked instance meshes, little endian. The header is followed by
+   one BakedMesh entry per mesh. The data of every mesh starts at its
+   dataOffset, aligned to BAKED_ALIGNMENT, and consists of the positions,
+   indices, object IDs and colors packed one after another. */
+constexpr char BAKED_MAGIC[8]{'E', 'S', 'P', 'B', 'A', 'K', 'E', 'D'};
+constexpr uint32_t BAKED_VERSION = 1;
+constexpr size_t BAKED_ALIGNMENT = 16;
+
+struct BakedHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t meshCount;
+};
+
+struct BakedMesh {
+  uint64_t dataOffset;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  Mn::Vector3 min;
+  Mn::Vector3 max;
+};
+
+static_assert(sizeof(BakedHeader) == 16, "unexpected baked header size");
+static_assert(sizeof(BakedMesh) == 40, "unexpected baked mesh entry size");
+
+size_t bakedDataSize(const BakedMesh& mesh) {
+  return mesh.vertexCount *
+             (sizeof(vec3f) + sizeof(uint16_t) + sizeof(vec3uc)) +
+         mesh.indexCount * sizeof(uint32_t);
+}
+
+size_t alignBaked(size_t offset) {
+  return (offset + BAKED_ALIGNMENT - 1) / BAKED_ALIGNMENT * BAKED_ALIGNMENT;
+}
+
+int workerCount() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
 }  // namespace
 
 std::vector<std::unique_ptr<GenericInstanceMeshData>>
@@ -121,29 +216,96 @@ GenericInstanceMeshData::fromPlySplitByObjectId(
   }
   const InstancePlyData& data = *parseResult;
 
+  const size_t indexCount = data.cpu_ibo.size();
+  constexpr size_t objectIdCount = 65536;
+  constexpr size_t notFound = ~size_t{0};
+
+  // the indices are split into one contiguous chunk per thread. First count
+  // the indices of every object in each chunk and where each object first
+  // appears.
+  const int chunkCount = workerCount();
+  const size_t chunkSize = (indexCount + chunkCount - 1) / chunkCount;
+  std::vector<std::vector<size_t>> chunkOffsets(
+      chunkCount, std::vector<size_t>(objectIdCount, 0));
+  std::vector<std::vector<size_t>> chunkFirstIndex(
+      chunkCount, std::vector<size_t>(objectIdCount, notFound));
+#pragma omp parallel for
+  for (int chunk = 0; chunk < chunkCount; ++chunk) {
+    const size_t end = std::min(indexCount, (chunk + 1) * chunkSize);
+    for (size_t i = chunk * chunkSize; i < end; ++i) {
+      const uint16_t objectId = data.objectIds[data.cpu_ibo[i]];
+      if (chunkOffsets[chunk][objectId]++ == 0) {
+        chunkFirstIndex[chunk][objectId] = i;
+      }
+    }
+  }
+
+  // the meshes are ordered by where their object first appears. Turn the
+  // counts into the offset every chunk writes its indices of an object at.
+  std::vector<std::pair<size_t, uint16_t>> objectOrder;
+  std::vector<size_t> objectIndexCounts(objectIdCount, 0);
+  for (size_t objectId = 0; objectId != objectIdCount; ++objectId) {
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+      const size_t count = chunkOffsets[chunk][objectId];
+      chunkOffsets[chunk][objectId] = objectIndexCounts[objectId];
+      objectIndexCounts[objectId] += count;
+      if (count && objectIndexCounts[objectId] == count) {
+        objectOrder.emplace_back(chunkFirstIndex[chunk][objectId], objectId);
+      }
+    }
+  }
+  std::sort(objectOrder.begin(), objectOrder.end());
+
   std::vector<GenericInstanceMeshData::uptr> splitMeshData;
-  std::unordered_map<uint16_t, PerObjectIdMeshBuilder> objectIdToObjectData;
+  std::vector<uint32_t*> objectIndices(objectIdCount, nullptr);
+  for (const auto& object : objectOrder) {
+    splitMeshData.emplace_back(GenericInstanceMeshData::create_unique());
+    std::vector<uint32_t>& ibo = splitMeshData.back()->cpu_ibo_;
+    ibo.resize(objectIndexCounts[object.second]);
+    objectIndices[object.second] = ibo.data();
+  }
+
+  // scatter the indices, still referencing the full mesh, keeping their
+  // order within every object
+#pragma omp parallel for
+  for (int chunk = 0; chunk < chunkCount; ++chunk) {
+    std::vector<size_t>& offsets = chunkOffsets[chunk];
+    const size_t end = std::min(indexCount, (chunk + 1) * chunkSize);
+    for (size_t i = chunk * chunkSize; i < end; ++i) {
+      const uint32_t globalIndex = data.cpu_ibo[i];
+      const uint16_t objectId = data.objectIds[globalIndex];
+      objectIndices[objectId][offsets[objectId]++] = globalIndex;
+    }
+  }
 
-  for (size_t i = 0; i < data.cpu_ibo.size(); ++i) {
-    const uint32_t globalIndex = data.cpu_ibo[i];
-    const uint16_t objectId = data.objectIds[globalIndex];
-    if (objectIdToObjectData.find(objectId) == objectIdToObjectData.end()) {
-      auto instanceMesh = GenericInstanceMeshData::create_unique();
-      objectIdToObjectData.emplace(
-          objectId, PerObjectIdMeshBuilder{*instanceMesh, objectId});
-      splitMeshData.emplace_back(std::move(instanceMesh));
+  // copy the vertices in the order they're first used. Object IDs are per
+  // vertex, so every vertex belongs to a single mesh and the meshes can
+  // share the lookup from global to local indices.
+  std::vector<uint32_t> localIndices(data.cpu_vbo.size(), ~uint32_t{0});
+#pragma omp parallel for schedule(dynamic)
+  for (int iMesh = 0; iMesh < splitMeshData.size(); ++iMesh) {
+    GenericInstanceMeshData& mesh = *splitMeshData[iMesh];
+    const uint16_t objectId = objectOrder[iMesh].second;
+    for (uint32_t& index : mesh.cpu_ibo_) {
+      uint32_t& localIndex = localIndices[index];
+      if (localIndex == ~uint32_t{0}) {
+        localIndex = mesh.cpu_vbo_.size();
+        mesh.cpu_vbo_.emplace_back(data.cpu_vbo[index]);
+        mesh.cpu_cbo_.emplace_back(data.cpu_cbo[index]);
+        mesh.objectIds_.emplace_back(objectId);
+      }
+      index = localIndex;
     }
-    objectIdToObjectData.at(objectId).addVertex(
-        globalIndex, data.cpu_vbo[globalIndex], data.cpu_cbo[globalIndex]);
   }
   return splitMeshData;
 }
 
 std::unique_ptr<GenericInstanceMeshData> GenericInstanceMeshData::fromPLY(
     Mn::Trade::AbstractImporter& importer,
-    const std::string& plyFile) {
+    const std::string& plyFile,
+    bool primitiveObjectIds) {
   Cr::Containers::Optional<InstancePlyData> parseResult =
-      parsePly(importer, plyFile);
+      parsePly(importer, plyFile, primitiveObjectIds);
   if (!parseResult) {
     return nullptr;
   }
@@ -153,6 +315,7 @@ std::unique_ptr<GenericInstanceMeshData> GenericInstanceMeshData::fromPLY(
   data->cpu_cbo_ = std::move(parseResult->cpu_cbo);
   data->cpu_ibo_ = std::move(parseResult->cpu_ibo);
   data->objectIds_ = std::move(parseResult->objectIds);
+  data->primitiveObjectIds_ = std::move(parseResult->primitiveObjectIds);
 
   // Construct vertices for collsion meshData
   // Store indices, facd_ids in Magnum MeshData3D format such that
@@ -163,7 +326,188 @@ std::unique_ptr<GenericInstanceMeshData> GenericInstanceMeshData::fromPLY(
   return data;
 }
 
+std::string GenericInstanceMeshData::bakedFilename(const std::string& plyFile) {
+  return io::changeExtension(plyFile, ".bake");
+}
+
+bool GenericInstanceMeshData::saveBaked(
+    const std::vector<std::unique_ptr<GenericInstanceMeshData>>& meshes,
+    const std::string& bakedFile) {
+  BakedHeader header{};
+  std::memcpy(header.magic, BAKED_MAGIC, sizeof(BAKED_MAGIC));
+  header.version = BAKED_VERSION;
+  header.meshCount = meshes.size();
+
+  std::vector<BakedMesh> entries(meshes.size());
+  size_t offset =
+      alignBaked(sizeof(BakedHeader) + entries.size() * sizeof(BakedMesh));
+  for (size_t i = 0; i < meshes.size(); ++i) {
+    const GenericInstanceMeshData& mesh = *meshes[i];
+    BakedMesh& entry = entries[i];
+    entry.dataOffset = offset;
+    entry.vertexCount = mesh.cpu_vbo_.size();
+    entry.indexCount = mesh.cpu_ibo_.size();
+    const Mn::Range3D bb{Mn::Math::minmax<Mn::Vector3>(
+        Cr::Containers::arrayCast<const Mn::Vector3>(
+            Cr::Containers::arrayView(mesh.cpu_vbo_)))};
+    entry.min = bb.min();
+    entry.max = bb.max();
+    offset = alignBaked(offset + bakedDataSize(entry));
+  }
+
+  std::ofstream file(bakedFile, std::ios::out | std::ios::binary);
+  if (!file.good()) {
+    LOG(ERROR) << "Cannot open " << bakedFile << " for writing";
+    return false;
+  }
+  const auto writeArray = [&file](const auto& data) {
+    file.write(reinterpret_cast<const char*>(data.data()),
+               data.size() * sizeof(data[0]));
+  };
+  const auto pad = [&file]() {
+    const char zeros[BAKED_ALIGNMENT]{};
+    const size_t position = file.tellp();
+    file.write(zeros, alignBaked(position) - position);
+  };
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  writeArray(entries);
+  for (const auto& mesh : meshes) {
+    pad();
+    writeArray(mesh->cpu_vbo_);
+    writeArray(mesh->cpu_ibo_);
+    writeArray(mesh->objectIds_);
+    writeArray(mesh->cpu_cbo_);
+  }
+  if (!file.good()) {
+    LOG(ERROR) << "Failed writing " << bakedFile;
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::unique_ptr<GenericInstanceMeshData>>
+GenericInstanceMeshData::fromBaked(const std::string& bakedFile,
+                                   bool splitByObjectId) {
+  if (!io::exists(bakedFile)) {
+    return {};
+  }
+  const Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      mapped = Cr::Utility::Directory::mapRead(bakedFile);
+  if (mapped.size() < sizeof(BakedHeader)) {
+    LOG(ERROR) << "Baked file " << bakedFile << " is too short";
+    return {};
+  }
+  BakedHeader header;
+  std::memcpy(&header, mapped.data(), sizeof(header));
+  if (std::memcmp(header.magic, BAKED_MAGIC, sizeof(BAKED_MAGIC)) != 0 ||
+      header.version != BAKED_VERSION) {
+    LOG(ERROR) << bakedFile << " is not a baked instance mesh of version "
+               << BAKED_VERSION;
+    return {};
+  }
+  if (mapped.size() <
+      sizeof(BakedHeader) + header.meshCount * sizeof(BakedMesh)) {
+    LOG(ERROR) << "Baked file " << bakedFile << " is truncated";
+    return {};
+  }
+  std::vector<BakedMesh> entries(header.meshCount);
+  std::memcpy(entries.data(), mapped.data() + sizeof(BakedHeader),
+              entries.size() * sizeof(BakedMesh));
+  for (const BakedMesh& entry : entries) {
+    if (entry.dataOffset + bakedDataSize(entry) > mapped.size()) {
+      LOG(ERROR) << "Baked file " << bakedFile << " is truncated";
+      return {};
+    }
+  }
+
+  // copies the data of one entry to the end of the buffers of mesh, the
+  // indices offset to follow the vertices already there
+  const auto append = [&mapped](GenericInstanceMeshData& mesh,
+                                const BakedMesh& entry) {
+    const char* data = mapped.data() + entry.dataOffset;
+    const auto readArray = [&data](auto& destination, size_t count) {
+      const size_t start = destination.size();
+      destination.resize(start + count);
+      const size_t byteSize = count * sizeof(destination[0]);
+      std::memcpy(destination.data() + start, data, byteSize);
+      data += byteSize;
+      return start;
+    };
+    const uint32_t vertexBase = readArray(mesh.cpu_vbo_, entry.vertexCount);
+    const size_t indexStart = readArray(mesh.cpu_ibo_, entry.indexCount);
+    if (vertexBase != 0) {
+      for (size_t i = indexStart; i < mesh.cpu_ibo_.size(); ++i) {
+        mesh.cpu_ibo_[i] += vertexBase;
+      }
+    }
+    readArray(mesh.objectIds_, entry.vertexCount);
+    readArray(mesh.cpu_cbo_, entry.vertexCount);
+    const Mn::Range3D bb{entry.min, entry.max};
+    mesh.BB = vertexBase == 0 ? bb : Mn::Math::join(mesh.BB, bb);
+  };
+
+  std::vector<GenericInstanceMeshData::uptr> meshes;
+  if (splitByObjectId) {
+    meshes.reserve(entries.size());
+    for (const BakedMesh& entry : entries) {
+      meshes.emplace_back(GenericInstanceMeshData::create_unique());
+      append(*meshes.back(), entry);
+    }
+  } else if (!entries.empty()) {
+    meshes.emplace_back(GenericInstanceMeshData::create_unique());
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const BakedMesh& entry : entries) {
+      vertexCount += entry.vertexCount;
+      indexCount += entry.indexCount;
+    }
+    GenericInstanceMeshData& mesh = *meshes.back();
+    mesh.cpu_vbo_.reserve(vertexCount);
+    mesh.cpu_ibo_.reserve(indexCount);
+    mesh.objectIds_.reserve(vertexCount);
+    mesh.cpu_cbo_.reserve(vertexCount);
+    for (const BakedMesh& entry : entries) {
+      append(mesh, entry);
+    }
+  }
+
+  for (auto& mesh : meshes) {
+    mesh->collisionMeshData_.primitive = Magnum::MeshPrimitive::Triangles;
+    mesh->updateCollisionMeshData();
+  }
+  return meshes;
+}
+
+void GenericInstanceMeshData::optimizeMeshData() {
+  const size_t vertexCount = cpu_vbo_.size();
+  Cr::Containers::ArrayView<Mn::UnsignedInt> indices =
+      Cr::Containers::arrayCast<Mn::UnsignedInt>(
+          Cr::Containers::arrayView(cpu_ibo_));
+  // the object IDs per triangle are in the triangle order
+  if (primitiveObjectIds_.empty()) {
+    optimizeVertexCache(indices, vertexCount);
+    optimizeOverdraw(indices,
+                     Cr::Containers::arrayCast<const Mn::Vector3>(
+                         Cr::Containers::arrayView(cpu_vbo_)));
+  }
+  const Cr::Containers::Array<Mn::UnsignedInt> remap =
+      optimizeVertexFetch(indices, vertexCount);
+  remapVertices(remap, cpu_vbo_);
+  remapVertices(remap, cpu_cbo_);
+  if (!objectIds_.empty()) {
+    remapVertices(remap, objectIds_);
+  }
+  updateCollisionMeshData();
+}
+
 void GenericInstanceMeshData::uploadBuffersToGPU(bool forceReload) {
+  if (forceReload && uploadDataReleased_) {
+    LOG(WARNING) << "GenericInstanceMeshData::uploadBuffersToGPU(): the "
+                    "vertex colors were released, keeping the uploaded "
+                    "buffers";
+    return;
+  }
   if (forceReload) {
     buffersOnGPU_ = false;
   }
@@ -171,34 +515,272 @@ void GenericInstanceMeshData::uploadBuffersToGPU(bool forceReload) {
     return;
   }
 
-  Mn::GL::Buffer vertices, indices;
-  indices.setTargetHint(Mn::GL::Buffer::TargetHint::ElementArray);
-  indices.setData(cpu_ibo_, Mn::GL::BufferUsage::StaticDraw);
-
-  vertices.setData(
-      Mn::MeshTools::interleave(cpu_vbo_, cpu_cbo_, 1, objectIds_, 2),
-      Mn::GL::BufferUsage::StaticDraw);
-
   renderingBuffer_ =
       std::make_unique<GenericInstanceMeshData::RenderingBuffer>();
   renderingBuffer_->mesh.setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
-      .setCount(cpu_ibo_.size())
+      .setCount(cpu_ibo_.size());
+  if (!primitiveObjectIds_.empty()) {
+    // never set on OpenGL ES, see parsePly()
+#ifndef MAGNUM_TARGET_GLES
+    uploadPrimitiveIdBuffersToGPU();
+#endif
+  } else if (compactLayout_) {
+    uploadCompactBuffersToGPU();
+  } else {
+    Mn::GL::Buffer vertices, indices;
+    indices.setTargetHint(Mn::GL::Buffer::TargetHint::ElementArray);
+    indices.setData(cpu_ibo_, Mn::GL::BufferUsage::StaticDraw);
+
+    vertices.setData(
+        Mn::MeshTools::interleave(cpu_vbo_, cpu_cbo_, 1, objectIds_, 2),
+        Mn::GL::BufferUsage::StaticDraw);
+
+    renderingBuffer_->mesh
+        .addVertexBuffer(
+            std::move(vertices), 0, Mn::Shaders::Generic3D::Position{},
+            Mn::Shaders::Generic3D::Color3{
+                Mn::Shaders::Generic3D::Color3::DataType::UnsignedByte,
+                Mn::Shaders::Generic3D::Color3::DataOption::Normalized},
+            1,
+            Mn::Shaders::Generic3D::ObjectId{
+                Mn::Shaders::Generic3D::ObjectId::DataType::UnsignedShort},
+            2)
+        .setIndexBuffer(std::move(indices), 0,
+                        Mn::GL::MeshIndexType::UnsignedInt);
+
+    positionTransformation_ = Mn::Matrix4{};
+    gpuVertexByteSize_ = cpu_vbo_.size() * sizeof(vec3f) +
+                         cpu_cbo_.size() * sizeof(vec3uc) +
+                         objectIds_.size() * sizeof(uint16_t);
+    gpuIndexByteSize_ = cpu_ibo_.size() * sizeof(uint32_t);
+  }
+
+  // levels of detail share the layout, and the accounting of this mesh
+  for (LevelOfDetail& level : levelsOfDetail_) {
+    level.mesh->compactLayout_ = compactLayout_;
+    level.mesh->quantizationBounds_ =
+        quantizationBounds_ ? *quantizationBounds_
+                            : Mn::Range3D{Mn::Math::minmax(
+                                  Cr::Containers::arrayCast<const Mn::Vector3>(
+                                      Cr::Containers::arrayView(cpu_vbo_)))};
+    level.mesh->uploadBuffersToGPU(forceReload);
+    gpuVertexByteSize_ += level.mesh->gpuVertexByteSize_;
+    gpuIndexByteSize_ += level.mesh->gpuIndexByteSize_;
+  }
+
+  updateCollisionMeshData();
+  buffersOnGPU_ = true;
+}
+
+size_t GenericInstanceMeshData::releaseUploadData() {
+  if (!buffersOnGPU_ || uploadDataReleased_) {
+    return 0;
+  }
+
+  // positions and indices are the collision mesh, the object IDs answer
+  // semantic queries
+  size_t byteSize = cpu_cbo_.capacity() * sizeof(vec3uc);
+  std::vector<vec3uc>{}.swap(cpu_cbo_);
+  // the levels of detail are only drawn
+  for (LevelOfDetail& level : levelsOfDetail_) {
+    GenericInstanceMeshData& mesh = *level.mesh;
+    byteSize += mesh.cpu_vbo_.capacity() * sizeof(vec3f) +
+                mesh.cpu_cbo_.capacity() * sizeof(vec3uc) +
+                mesh.cpu_ibo_.capacity() * sizeof(uint32_t) +
+                mesh.objectIds_.capacity() * sizeof(uint16_t);
+    std::vector<vec3f>{}.swap(mesh.cpu_vbo_);
+    std::vector<vec3uc>{}.swap(mesh.cpu_cbo_);
+    std::vector<uint32_t>{}.swap(mesh.cpu_ibo_);
+    std::vector<uint16_t>{}.swap(mesh.objectIds_);
+    mesh.updateCollisionMeshData();
+    mesh.uploadDataReleased_ = true;
+  }
+  uploadDataReleased_ = true;
+  return byteSize;
+}
+
+void GenericInstanceMeshData::generateLevelsOfDetail(int count) {
+  levelsOfDetail_.clear();
+  // clusters never merge vertices of different objects, which needs the
+  // object IDs per vertex
+  if (count <= 0 || cpu_ibo_.size() < 3 || !primitiveObjectIds_.empty()) {
+    return;
+  }
+  const Cr::Containers::ArrayView<const Mn::Vector3> positions =
+      Cr::Containers::arrayCast<const Mn::Vector3>(
+          Cr::Containers::arrayView(cpu_vbo_));
+  const Cr::Containers::ArrayView<const Mn::UnsignedInt> indices =
+      Cr::Containers::arrayCast<const Mn::UnsignedInt>(
+          Cr::Containers::arrayView(cpu_ibo_));
+
+  double edgeLengthSum = 0.0;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    for (size_t k = 0; k != 3; ++k) {
+      edgeLengthSum += (positions[indices[i + (k + 1) % 3]] -
+                        positions[indices[i + k]])
+                           .length();
+    }
+  }
+  float cellSize = float(edgeLengthSum / indices.size());
+  if (!(cellSize > 0.0f)) {
+    return;
+  }
+
+  size_t triangleCount = indices.size() / 3;
+  for (int i = 0; i != count; ++i) {
+    cellSize *= 2.0f;
+    VertexClusters clusters = clusterVertices(
+        indices, positions, cellSize, Cr::Containers::arrayView(objectIds_));
+    const size_t levelTriangleCount = clusters.indices.size() / 3;
+    if (levelTriangleCount == 0 || levelTriangleCount * 4 > triangleCount * 3) {
+      break;
+    }
+
+    // clusters get the average position and color of their vertices
+    std::vector<Mn::Vector3> positionSums(clusters.clusterCount);
+    std::vector<Mn::Vector3> colorSums(clusters.clusterCount);
+    std::vector<Mn::UnsignedInt> vertexCounts(clusters.clusterCount, 0);
+    auto level = GenericInstanceMeshData::create_unique();
+    level->objectIds_.resize(clusters.clusterCount);
+    for (size_t v = 0; v != positions.size(); ++v) {
+      const Mn::UnsignedInt cluster = clusters.vertexClusters[v];
+      positionSums[cluster] += positions[v];
+      colorSums[cluster] += Mn::Vector3{float(cpu_cbo_[v][0]),
+                                        float(cpu_cbo_[v][1]),
+                                        float(cpu_cbo_[v][2])};
+      level->objectIds_[cluster] = objectIds_[v];
+      ++vertexCounts[cluster];
+    }
+    level->cpu_vbo_.resize(clusters.clusterCount);
+    level->cpu_cbo_.resize(clusters.clusterCount);
+    for (size_t c = 0; c != clusters.clusterCount; ++c) {
+      const Mn::Vector3 position = positionSums[c] / float(vertexCounts[c]);
+      const Mn::Vector3 color =
+          Mn::Math::round(colorSums[c] / float(vertexCounts[c]));
+      level->cpu_vbo_[c] = vec3f{position.x(), position.y(), position.z()};
+      level->cpu_cbo_[c] = vec3uc{uint8_t(color.x()), uint8_t(color.y()),
+                                  uint8_t(color.z())};
+    }
+    level->cpu_ibo_ = std::move(clusters.indices);
+
+    // drop clusters only collapsed triangles used, in first-use order
+    const Cr::Containers::Array<Mn::UnsignedInt> remap =
+        optimizeVertexFetch(Cr::Containers::arrayCast<Mn::UnsignedInt>(
+                                Cr::Containers::arrayView(level->cpu_ibo_)),
+                            clusters.clusterCount);
+    remapVertices(remap, level->cpu_vbo_);
+    remapVertices(remap, level->cpu_cbo_);
+    remapVertices(remap, level->objectIds_);
+    const size_t usedCount =
+        *std::max_element(level->cpu_ibo_.begin(), level->cpu_ibo_.end()) + 1;
+    level->cpu_vbo_.resize(usedCount);
+    level->cpu_cbo_.resize(usedCount);
+    level->objectIds_.resize(usedCount);
+
+    level->collisionMeshData_.primitive = Magnum::MeshPrimitive::Triangles;
+    level->updateCollisionMeshData();
+    // vertices move at most by the cell diagonal
+    levelsOfDetail_.push_back({cellSize * std::sqrt(3.0f), std::move(level)});
+    triangleCount = levelTriangleCount;
+  }
+}
+
+void GenericInstanceMeshData::uploadCompactBuffersToGPU() {
+  // 16-bit positions relative to the bounds, padded to four bytes
+  struct CompactVertex {
+    Mn::Vector3s position;
+    Mn::UnsignedShort objectId;
+    Mn::Color3ub color;
+    Mn::UnsignedByte padding;
+  };
+  static_assert(sizeof(CompactVertex) == 12, "unexpected padding");
+
+  const Cr::Containers::ArrayView<const Mn::Vector3> positions =
+      Cr::Containers::arrayCast<const Mn::Vector3>(
+          Cr::Containers::arrayView(cpu_vbo_));
+  const Mn::Range3D bounds = quantizationBounds_
+                                ? *quantizationBounds_
+                                : Mn::Range3D{Mn::Math::minmax(positions)};
+  // avoid dividing by zero along the flat axes of planar meshes
+  const Mn::Vector3 halfSize =
+      Mn::Math::max(bounds.size() * 0.5f, Mn::Vector3{1.0e-6f});
+  positionTransformation_ = Mn::Matrix4::translation(bounds.center()) *
+                            Mn::Matrix4::scaling(halfSize);
+
+  Cr::Containers::Array<CompactVertex> vertexData{Cr::Containers::ValueInit,
+                                                  cpu_vbo_.size()};
+  for (size_t i = 0; i != vertexData.size(); ++i) {
+    vertexData[i].position = Mn::Math::pack<Mn::Vector3s>(
+        Mn::Math::clamp((positions[i] - bounds.center()) / halfSize, -1.0f,
+                        1.0f));
+    vertexData[i].objectId = objectIds_[i];
+    vertexData[i].color = Mn::Color3ub{cpu_cbo_[i][0], cpu_cbo_[i][1],
+                                       cpu_cbo_[i][2]};
+  }
+  Mn::GL::Buffer vertices;
+  vertices.setData(vertexData, Mn::GL::BufferUsage::StaticDraw);
+  renderingBuffer_->mesh.addVertexBuffer(
+      std::move(vertices), 0,
+      Mn::Shaders::Generic3D::Position{
+          Mn::Shaders::Generic3D::Position::Components::Three,
+          Mn::Shaders::Generic3D::Position::DataType::Short,
+          Mn::Shaders::Generic3D::Position::DataOption::Normalized},
+      Mn::Shaders::Generic3D::ObjectId{
+          Mn::Shaders::Generic3D::ObjectId::DataType::UnsignedShort},
+      Mn::Shaders::Generic3D::Color3{
+          Mn::Shaders::Generic3D::Color3::DataType::UnsignedByte,
+          Mn::Shaders::Generic3D::Color3::DataOption::Normalized},
+      1);
+  gpuVertexByteSize_ = vertexData.size() * sizeof(CompactVertex);
+
+  Mn::GL::Buffer indices;
+  indices.setTargetHint(Mn::GL::Buffer::TargetHint::ElementArray);
+  if (cpu_vbo_.size() <= 65536) {
+    Cr::Containers::Array<Mn::UnsignedShort> indexData{Cr::Containers::NoInit,
+                                                       cpu_ibo_.size()};
+    for (size_t i = 0; i != indexData.size(); ++i) {
+      indexData[i] = cpu_ibo_[i];
+    }
+    indices.setData(indexData, Mn::GL::BufferUsage::StaticDraw);
+    renderingBuffer_->mesh.setIndexBuffer(std::move(indices), 0,
+                                          Mn::GL::MeshIndexType::UnsignedShort);
+    gpuIndexByteSize_ = indexData.size() * sizeof(Mn::UnsignedShort);
+  } else {
+    indices.setData(cpu_ibo_, Mn::GL::BufferUsage::StaticDraw);
+    renderingBuffer_->mesh.setIndexBuffer(std::move(indices), 0,
+                                          Mn::GL::MeshIndexType::UnsignedInt);
+    gpuIndexByteSize_ = cpu_ibo_.size() * sizeof(uint32_t);
+  }
+}
+
+#ifndef MAGNUM_TARGET_GLES
+void GenericInstanceMeshData::uploadPrimitiveIdBuffersToGPU() {
+  Mn::GL::Buffer vertices, indices;
+  indices.setTargetHint(Mn::GL::Buffer::TargetHint::ElementArray);
+  indices.setData(cpu_ibo_, Mn::GL::BufferUsage::StaticDraw);
+  vertices.setData(Mn::MeshTools::interleave(cpu_vbo_, cpu_cbo_, 1),
+                   Mn::GL::BufferUsage::StaticDraw);
+  renderingBuffer_->mesh
       .addVertexBuffer(
           std::move(vertices), 0, Mn::Shaders::Generic3D::Position{},
           Mn::Shaders::Generic3D::Color3{
               Mn::Shaders::Generic3D::Color3::DataType::UnsignedByte,
               Mn::Shaders::Generic3D::Color3::DataOption::Normalized},
-          1,
-          Mn::Shaders::Generic3D::ObjectId{
-              Mn::Shaders::Generic3D::ObjectId::DataType::UnsignedShort},
-          2)
+          1)
       .setIndexBuffer(std::move(indices), 0,
                       Mn::GL::MeshIndexType::UnsignedInt);
 
-  updateCollisionMeshData();
+  renderingBuffer_->objectIdBuffer.setData(primitiveObjectIds_,
+                                           Mn::GL::BufferUsage::StaticDraw);
+  renderingBuffer_->objectIdTexture.setBuffer(
+      Mn::GL::BufferTextureFormat::R32UI, renderingBuffer_->objectIdBuffer);
 
-  buffersOnGPU_ = true;
+  positionTransformation_ = Mn::Matrix4{};
+  gpuVertexByteSize_ = cpu_vbo_.size() * (sizeof(vec3f) + sizeof(vec3uc) + 1) +
+                       primitiveObjectIds_.size() * sizeof(uint32_t);
+  gpuIndexByteSize_ = cpu_ibo_.size() * sizeof(uint32_t);
 }
+#endif
 
 Magnum::GL::Mesh* GenericInstanceMeshData::getMagnumGLMesh() {
   if (renderingBuffer_ == nullptr) {
@@ -214,21 +796,5 @@ void GenericInstanceMeshData::updateCollisionMeshData() {
       Cr::Containers::arrayView(cpu_ibo_));
 }
 
-void GenericInstanceMeshData::PerObjectIdMeshBuilder::addVertex(
-    uint32_t vertexId,
-    const vec3f& position,
-    const vec3uc& color) {
-  // if we haven't seen this vertex, add it to the local vertex/color buffer
-  auto result = vertexIdToVertexIndex_.emplace(vertexId, data_.cpu_vbo_.size());
-  if (result.second) {
-    data_.cpu_vbo_.emplace_back(position);
-    data_.cpu_cbo_.emplace_back(color);
-    data_.objectIds_.emplace_back(objectId_);
-  }
-
-  // update index buffers with local index of vertex/color
-  data_.cpu_ibo_.emplace_back(result.first->second);
-}
-
 }  // namespace assets
 }  // namespace esp
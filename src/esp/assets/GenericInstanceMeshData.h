@@ -6,7 +6,11 @@
 
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Buffer.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferTexture.h>
+#endif
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Matrix4.h>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -22,6 +26,11 @@ class GenericInstanceMeshData : public BaseMesh {
  public:
   struct RenderingBuffer {
     Magnum::GL::Mesh mesh;
+#ifndef MAGNUM_TARGET_GLES
+    // object IDs of the triangles, for meshes with primitive object IDs
+    Magnum::GL::Buffer objectIdBuffer;
+    Magnum::GL::BufferTexture objectIdTexture;
+#endif
   };
 
   explicit GenericInstanceMeshData(SupportedMeshType type) : BaseMesh{type} {};
@@ -43,14 +52,131 @@ class GenericInstanceMeshData : public BaseMesh {
   /**
    * @brief Load from a .ply file
    *
-   * @param plyFile .ply file to load
+   * @param plyFile             .ply file to load
+   * @param primitiveObjectIds  Keep the object IDs per triangle, see
+   *      @ref getPrimitiveObjectIdsCPU(), instead of converting them to
+   *      per-vertex ones. Ignored on OpenGL ES and WebGL, which can't draw
+   *      such meshes.
    */
   static std::unique_ptr<GenericInstanceMeshData> fromPLY(
       Magnum::Trade::AbstractImporter& importer,
-      const std::string& plyFile);
+      const std::string& plyFile,
+      bool primitiveObjectIds = false);
+
+  /**
+   * @brief Filename of the baked version of @p plyFile, see @ref saveBaked()
+   */
+  static std::string bakedFilename(const std::string& plyFile);
+
+  /**
+   * @brief Save meshes split by objectID into a baked file
+   *
+   * The baked file stores the final vertex and index buffers and the bounding
+   * box of every mesh in the layout they are kept in memory, so @ref
+   * fromBaked() only has to memory-map it and copy them out, without parsing
+   * or splitting anything.
+   * @param meshes    Meshes as returned by @ref fromPlySplitByObjectId()
+   * @param bakedFile File to write to
+   * @return Whether the file was written
+   */
+  static bool saveBaked(
+      const std::vector<std::unique_ptr<GenericInstanceMeshData>>& meshes,
+      const std::string& bakedFile);
+
+  /**
+   * @brief Load from a file written by @ref saveBaked()
+   *
+   * @param bakedFile        Baked file to load
+   * @param splitByObjectId  Whether to keep the meshes split by objectID, the
+   *                         same as @ref fromPlySplitByObjectId(), or to join
+   *                         them into one, like @ref fromPLY()
+   * @return Mesh data, empty if the file is missing or invalid
+   */
+  static std::vector<std::unique_ptr<GenericInstanceMeshData>> fromBaked(
+      const std::string& bakedFile,
+      bool splitByObjectId);
+
+  /**
+   * @brief Reorder triangles and vertices for rendering, see @ref
+   * optimizeMesh()
+   *
+   * Triangles of meshes with @ref getPrimitiveObjectIdsCPU() keep their
+   * order, only the vertices are reordered. Has to be called before @ref
+   * uploadBuffersToGPU() to have an effect.
+   */
+  void optimizeMeshData();
+
+  /**
+   * @brief Set whether to upload the mesh in a compact vertex layout
+   *
+   * Positions are quantized to 16 bits relative to the mesh bounds and
+   * stored together with the 8-bit colors and 16-bit object IDs in 12 bytes
+   * per vertex instead of 20, and meshes with at most 65536 vertices get
+   * 16-bit indices. The positions are expanded again by @ref
+   * positionTransformation(), which drawables of the mesh have to apply.
+   * CPU-side data, used for collisions and bounds, stay unquantized. Meshes
+   * with @ref getPrimitiveObjectIdsCPU() ignore it. Has to be called before
+   * @ref uploadBuffersToGPU() to have an effect.
+   */
+  void setCompactLayout(bool compact) { compactLayout_ = compact; }
+
+  /**
+   * @brief Transformation from the positions uploaded to the GPU to the mesh
+   * space
+   *
+   * Identity unless uploaded in the compact layout, see @ref
+   * setCompactLayout() and @ref gfx::GenericDrawable::setMeshTransformation().
+   */
+  const Magnum::Matrix4& positionTransformation() const {
+    return positionTransformation_;
+  }
+
+  /**
+   * @brief Generate simplified versions of the mesh for drawing it from afar
+   *
+   * Every level clusters vertices of this mesh (see @ref clusterVertices())
+   * in cells twice as large as the previous one, starting at twice the
+   * average edge length, and never merges vertices of different objects.
+   * Stops early once a level would remove less than a quarter of the
+   * triangles of the previous one. The levels are uploaded together with
+   * the mesh, in the same layout. Meshes with @ref
+   * getPrimitiveObjectIdsCPU() get none. Has to be called before @ref
+   * uploadBuffersToGPU() to have an effect.
+   * @param count Largest number of levels to generate
+   */
+  void generateLevelsOfDetail(int count);
+
+  /** @brief Number of levels generated by @ref generateLevelsOfDetail() */
+  size_t levelOfDetailCount() const { return levelsOfDetail_.size(); }
+
+  /**
+   * @brief Simplified mesh of level @p level, from the most to the least
+   * detailed
+   */
+  GenericInstanceMeshData& levelOfDetail(size_t level) {
+    return *levelsOfDetail_[level].mesh;
+  }
+
+  /**
+   * @brief Largest distance vertices moved in level @p level, in units of
+   * the mesh space
+   */
+  float levelOfDetailError(size_t level) const {
+    return levelsOfDetail_[level].error;
+  }
 
   // ==== rendering ====
   virtual void uploadBuffersToGPU(bool forceReload = false) override;
+
+  /**
+   * @brief Free the vertex colors and the CPU copies of the levels of detail
+   * once uploaded
+   *
+   * Positions, indices and object IDs stay. @ref uploadBuffersToGPU() with
+   * @p forceReload then keeps the buffers uploaded before.
+   */
+  virtual size_t releaseUploadData() override;
+
   RenderingBuffer* getRenderingBuffer() { return renderingBuffer_.get(); }
 
   virtual Magnum::GL::Mesh* getMagnumGLMesh() override;
@@ -70,21 +196,35 @@ class GenericInstanceMeshData : public BaseMesh {
     return objectIds_;
   }
 
- protected:
-  class PerObjectIdMeshBuilder {
-   public:
-    PerObjectIdMeshBuilder(GenericInstanceMeshData& data, uint16_t objectId)
-        : data_{data}, objectId_{objectId} {}
+  /**
+   * @brief Object ID of every triangle, in the order of the index buffer
+   *
+   * Only filled for meshes loaded by @ref fromPLY() with primitive object
+   * IDs, which then have no per-vertex @ref getObjectIdsBufferObjectCPU()
+   * and share vertices between objects. Uploaded to @ref
+   * RenderingBuffer::objectIdTexture and drawn by @ref
+   * gfx::PrimitiveIdDrawable.
+   */
+  const std::vector<uint32_t>& getPrimitiveObjectIdsCPU() const {
+    return primitiveObjectIds_;
+  }
 
-    void addVertex(uint32_t vertexId, const vec3f& vertex, const vec3uc& color);
+ protected:
+  void updateCollisionMeshData();
 
-   private:
-    GenericInstanceMeshData& data_;
-    uint16_t objectId_;
-    std::unordered_map<uint32_t, size_t> vertexIdToVertexIndex_;
-  };
+  /**
+   * @brief Fill @ref renderingBuffer_ with the layout described in @ref
+   * setCompactLayout()
+   */
+  void uploadCompactBuffersToGPU();
 
-  void updateCollisionMeshData();
+#ifndef MAGNUM_TARGET_GLES
+  /**
+   * @brief Fill @ref renderingBuffer_ with shared vertices and the object
+   * IDs in a buffer texture, see @ref getPrimitiveObjectIdsCPU()
+   */
+  void uploadPrimitiveIdBuffersToGPU();
+#endif
 
   // ==== rendering ====
   std::unique_ptr<RenderingBuffer> renderingBuffer_ = nullptr;
@@ -93,6 +233,19 @@ class GenericInstanceMeshData : public BaseMesh {
   std::vector<vec3uc> cpu_cbo_;
   std::vector<uint32_t> cpu_ibo_;
   std::vector<uint16_t> objectIds_;
+  std::vector<uint32_t> primitiveObjectIds_;
+  bool compactLayout_ = false;
+  Magnum::Matrix4 positionTransformation_;
+  // bounds positions get quantized to in the compact layout. Those of the
+  // full mesh for its levels of detail, which then draw with the same
+  // transformation, own bounds if not set.
+  Corrade::Containers::Optional<Magnum::Range3D> quantizationBounds_;
+
+  struct LevelOfDetail {
+    float error;
+    std::unique_ptr<GenericInstanceMeshData> mesh;
+  };
+  std::vector<LevelOfDetail> levelsOfDetail_;
 
   ESP_SMART_POINTERS(GenericInstanceMeshData)
 };
@@ -4,11 +4,16 @@
 
 #include "GltfMeshData.h"
 
+#include <algorithm>
+
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Interleave.h>
 
+#include "MeshOptimization.h"
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -16,8 +21,18 @@ namespace esp {
 namespace assets {
 
 void GltfMeshData::uploadBuffersToGPU(bool forceReload) {
+  if (forceReload && uploadDataReleased_) {
+    LOG(WARNING) << "GltfMeshData::uploadBuffersToGPU(): the mesh data was "
+                    "released, keeping the uploaded buffers";
+    return;
+  }
   if (forceReload) {
     buffersOnGPU_ = false;
+    pendingUpload_ = nullptr;
+  }
+  if (pendingUpload_) {
+    continueUploadToGPU(~size_t{});
+    return;
   }
   if (buffersOnGPU_) {
     return;
@@ -25,15 +40,118 @@ void GltfMeshData::uploadBuffersToGPU(bool forceReload) {
 
   renderingBuffer_.reset();
   renderingBuffer_ = std::make_unique<GltfMeshData::RenderingBuffer>();
-  Magnum::MeshTools::CompileFlags compileFlags{};
+  renderingBuffer_->mesh = compileMesh();
+
+  gpuVertexByteSize_ = meshData_->vertexData().size();
   if (needsNormals_ &&
       !meshData_->hasAttribute(Mn::Trade::MeshAttribute::Normal)) {
-    compileFlags |= Magnum::MeshTools::CompileFlag::GenerateSmoothNormals;
+    // generated by compileMesh()
+    gpuVertexByteSize_ += meshData_->vertexCount() * sizeof(Mn::Vector3);
+  }
+  gpuIndexByteSize_ = meshData_->indexData().size();
+  buffersOnGPU_ = true;
+}
+
+bool GltfMeshData::beginUploadToGPU() {
+  if (buffersOnGPU_ || pendingUpload_ || !meshData_ || compileFlags()) {
+    return false;
+  }
+
+  renderingBuffer_ = std::make_unique<GltfMeshData::RenderingBuffer>();
+  pendingUpload_ = std::make_unique<PendingUpload>();
+  // storage only, the data follow in continueUploadToGPU()
+  if (meshData_->isIndexed()) {
+    pendingUpload_->indices =
+        Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::ElementArray};
+    pendingUpload_->indices.setData({nullptr, meshData_->indexData().size()});
+  }
+  pendingUpload_->vertices = Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::Array};
+  pendingUpload_->vertices.setData({nullptr, meshData_->vertexData().size()});
+
+  gpuVertexByteSize_ = meshData_->vertexData().size();
+  gpuIndexByteSize_ = meshData_->indexData().size();
+  return true;
+}
+
+size_t GltfMeshData::continueUploadToGPU(size_t byteBudget) {
+  if (!pendingUpload_) {
+    return 0;
+  }
+
+  PendingUpload& pending = *pendingUpload_;
+  const Cr::Containers::ArrayView<const char> indexData =
+      meshData_->indexData();
+  const Cr::Containers::ArrayView<const char> vertexData =
+      meshData_->vertexData();
+  size_t offset = pending.uploadedBytes;
+  size_t remaining = byteBudget;
+  if (offset < indexData.size()) {
+    const size_t size = std::min(indexData.size() - offset, remaining);
+    pending.indices.setSubData(offset, indexData.slice(offset, offset + size));
+    offset += size;
+    remaining -= size;
+  }
+  if (offset >= indexData.size()) {
+    const size_t vertexOffset = offset - indexData.size();
+    const size_t size = std::min(vertexData.size() - vertexOffset, remaining);
+    if (size > 0) {
+      pending.vertices.setSubData(
+          vertexOffset, vertexData.slice(vertexOffset, vertexOffset + size));
+    }
+    offset += size;
+  }
+
+  const size_t uploaded = offset - pending.uploadedBytes;
+  pending.uploadedBytes = offset;
+  if (offset == indexData.size() + vertexData.size()) {
+    // drawables reference the mesh, so it's replaced in place; the index
+    // buffer is ignored for non-indexed meshes
+    renderingBuffer_->mesh = Mn::MeshTools::compile(
+        *meshData_, std::move(pending.indices), std::move(pending.vertices));
+    pendingUpload_ = nullptr;
+    buffersOnGPU_ = true;
+    if (releaseAfterUpload_) {
+      releaseUploadData();
+    }
   }
+  return uploaded;
+}
+
+size_t GltfMeshData::releaseUploadData() {
+  if (pendingUpload_) {
+    releaseAfterUpload_ = true;
+    return 0;
+  }
+  if (!buffersOnGPU_ || !meshData_) {
+    return 0;
+  }
+
+  size_t byteSize = meshData_->vertexData().size();
+  if (collisionMeshData_.indices.data() ==
+      static_cast<const void*>(meshData_->indexData().data())) {
+    indexData_ = meshData_->indicesAsArray();
+    collisionMeshData_.indices = indexData_;
+  } else {
+    byteSize += meshData_->indexData().size();
+  }
+  meshData_ = Cr::Containers::NullOpt;
+  releaseAfterUpload_ = false;
+  uploadDataReleased_ = true;
+  return byteSize;
+}
+
+Magnum::GL::Mesh GltfMeshData::compileMesh() const {
   // position, normals, uv, colors are bound to corresponding attributes
-  renderingBuffer_->mesh = Magnum::MeshTools::compile(*meshData_, compileFlags);
+  return Magnum::MeshTools::compile(*meshData_, compileFlags());
+}
 
-  buffersOnGPU_ = true;
+Magnum::MeshTools::CompileFlags GltfMeshData::compileFlags() const {
+  Magnum::MeshTools::CompileFlags compileFlags{};
+  if (needsNormals_ &&
+      !meshData_->hasAttribute(Mn::Trade::MeshAttribute::Normal)) {
+    compileFlags |= Magnum::MeshTools::CompileFlag::GenerateSmoothNormals;
+  }
+  return compileFlags;
 }
 
 Magnum::GL::Mesh* GltfMeshData::getMagnumGLMesh() {
@@ -45,7 +163,8 @@ Magnum::GL::Mesh* GltfMeshData::getMagnumGLMesh() {
 }
 
 void GltfMeshData::setMeshData(Magnum::Trade::AbstractImporter& importer,
-                               int meshID) {
+                               int meshID,
+                               bool optimize) {
   ASSERT(0 <= meshID && meshID < importer.meshCount());
   /* Interleave the mesh, if not already. This makes the GPU happier (better
      cache locality for vertex fetching) and is a no-op if the source data is
@@ -57,6 +176,11 @@ void GltfMeshData::setMeshData(Magnum::Trade::AbstractImporter& importer,
   else
     meshData_ = Cr::Containers::NullOpt;
 
+  // before the collision data below get extracted, so they match
+  if (meshData_ && optimize && !optimizeMesh(*meshData_)) {
+    LOG(INFO) << "Mesh " << meshID << " can't be optimized, keeping its order";
+  }
+
   collisionMeshData_.primitive = Magnum::MeshPrimitive::Triangles;
 
   /* For collision data we need positions as Vector3 in a contiguous array.
@@ -74,5 +198,41 @@ void GltfMeshData::setMeshData(Magnum::Trade::AbstractImporter& importer,
     collisionMeshData_.indices = indexData_ = meshData_->indicesAsArray();
 }
 
+void GltfMeshData::setObjectIds(
+    Cr::Containers::ArrayView<const uint16_t> objectIds) {
+  CORRADE_ASSERT(meshData_ && objectIds.size() == meshData_->vertexCount(),
+                 "GltfMeshData::setObjectIds(): expected"
+                     << (meshData_ ? meshData_->vertexCount() : 0)
+                     << "IDs but got" << objectIds.size(), );
+
+  // drop the attributes except a previous object ID and add the new one,
+  // interleaved with the rest
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributes;
+  for (Mn::UnsignedInt i = 0; i != meshData_->attributeCount(); ++i) {
+    if (meshData_->attributeName(i) != Mn::Trade::MeshAttribute::ObjectId) {
+      Cr::Containers::arrayAppend(attributes, meshData_->attributeData(i));
+    }
+  }
+  Mn::Trade::MeshData withoutObjectIds{
+      meshData_->primitive(),
+      Mn::Trade::DataFlags{},
+      meshData_->indexData(),
+      meshData_->isIndexed()
+          ? Mn::Trade::MeshIndexData{meshData_->indices()}
+          : Mn::Trade::MeshIndexData{},
+      Mn::Trade::DataFlags{},
+      meshData_->vertexData(),
+      std::move(attributes),
+      meshData_->vertexCount()};
+  meshData_ = Mn::MeshTools::interleave(
+      withoutObjectIds,
+      {Mn::Trade::MeshAttributeData{Mn::Trade::MeshAttribute::ObjectId,
+                                    objectIds}});
+
+  // the interleaved copy has indices of its own
+  if (meshData_->indexType() == Mn::MeshIndexType::UnsignedInt)
+    collisionMeshData_.indices = meshData_->mutableIndices<Mn::UnsignedInt>();
+}
+
 }  // namespace assets
 }  // namespace esp
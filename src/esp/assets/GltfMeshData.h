@@ -10,7 +10,9 @@
  */
 
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/MeshTools/Compile.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "BaseMesh.h"
@@ -51,14 +53,65 @@ class GltfMeshData : public BaseMesh {
    */
   virtual void uploadBuffersToGPU(bool forceReload = false) override;
 
+  /**
+   * @brief Allocate the GPU buffers of the mesh, to be filled by @ref
+   * continueUploadToGPU()
+   *
+   * The mesh in @ref renderingBuffer_ stays empty until the upload is done,
+   * and is compiled in place then, so drawables created in the meantime
+   * draw the finished mesh. A @ref uploadBuffersToGPU() without
+   * @p forceReload finishes the upload at once.
+   * @return False if the mesh is already uploaded or needs normals generated
+   * by @ref compileMesh(), which only a complete upload does
+   */
+  virtual bool beginUploadToGPU() override;
+
+  /**
+   * @brief Upload at most @p byteBudget bytes of the indices, then the
+   * vertices, with @ref Magnum::GL::Buffer::setSubData()
+   * @return Number of bytes uploaded
+   */
+  virtual size_t continueUploadToGPU(size_t byteBudget) override;
+
+  virtual bool uploadPending() const override {
+    return pendingUpload_ != nullptr;
+  }
+
+  /**
+   * @brief Free the @ref Magnum::Trade::MeshData once it's uploaded
+   *
+   * The collision positions and indices are kept, in copies of their own if
+   * they referenced the mesh data. A pending upload releases the data when
+   * it's done. Meshes without mesh data can't be batched by instanced or
+   * multi-draw drawables, and @ref uploadBuffersToGPU() with @p forceReload
+   * keeps the buffers uploaded before.
+   */
+  virtual size_t releaseUploadData() override;
+
   /**
    * @brief Load mesh data from a pre-parsed importer for a specific mesh
    * component. Sets the @ref collisionMeshData_ references.
    * @param importer The importer pre-loaded with asset data from file.
    * @param meshID The local identifier of a specific mesh component of the
    * asset.
+   * @param optimize Whether to reorder triangles and vertices for rendering,
+   * see @ref optimizeMesh().
    */
-  void setMeshData(Magnum::Trade::AbstractImporter& importer, int meshID);
+  void setMeshData(Magnum::Trade::AbstractImporter& importer,
+                   int meshID,
+                   bool optimize = false);
+
+  /**
+   * @brief Add a per-vertex object ID attribute to the mesh data
+   *
+   * Bound to the object ID attribute of the shaders by @ref compileMesh(), so
+   * materials drawing the mesh need @ref gfx::PhongMaterialData::
+   * perVertexObjectId set. Replaces the IDs of a previous call. Has to be
+   * followed by @ref uploadBuffersToGPU() with @p forceReload to have an
+   * effect on a mesh already uploaded.
+   * @param objectIds One ID for every vertex of the mesh data
+   */
+  void setObjectIds(Corrade::Containers::ArrayView<const uint16_t> objectIds);
 
   /**
    * @brief Returns a pointer to the compiled render data storage structure.
@@ -75,6 +128,21 @@ class GltfMeshData : public BaseMesh {
    */
   virtual Magnum::GL::Mesh* getMagnumGLMesh() override;
 
+  /**
+   * @brief Compile a new render mesh from the mesh data, independent of the
+   * one in @ref renderingBuffer_.
+   *
+   * Used for drawables that attach vertex buffers of their own to the mesh,
+   * such as @ref gfx::InstancedDrawable.
+   * @return The compiled render mesh.
+   */
+  Magnum::GL::Mesh compileMesh() const;
+
+  /**
+   * @brief Flags @ref compileMesh() compiles the mesh data with
+   */
+  Magnum::MeshTools::CompileFlags compileFlags() const;
+
  protected:
   /**
    * @brief Storage structure for compiled render data. We will use a smart
@@ -86,6 +154,18 @@ class GltfMeshData : public BaseMesh {
   bool needsNormals_ = true;
 
  private:
+  // buffers allocated by beginUploadToGPU(), moved into the mesh once all
+  // of the index and vertex data is uploaded
+  struct PendingUpload {
+    Magnum::GL::Buffer indices{Magnum::NoCreate};
+    Magnum::GL::Buffer vertices{Magnum::NoCreate};
+    // uploaded bytes, counting the indices first
+    size_t uploadedBytes = 0;
+  };
+  std::unique_ptr<PendingUpload> pendingUpload_;
+  // releaseUploadData() called while the upload was pending
+  bool releaseAfterUpload_ = false;
+
   /* Internal; can store data referenced by positions / indices if the original
      MeshData doesn't have them in desired type */
   Corrade::Containers::Array<Magnum::Vector3> positionData_;
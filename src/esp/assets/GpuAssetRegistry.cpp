@@ -0,0 +1,90 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "GpuAssetRegistry.h"
+
+#include <sstream>
+
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Renderer.h>
+
+namespace esp {
+namespace assets {
+
+GpuAssetRegistry& GpuAssetRegistry::instance() {
+  static GpuAssetRegistry registry;
+  return registry;
+}
+
+const void* GpuAssetRegistry::currentShareGroup() {
+  if (!Magnum::GL::Context::hasCurrent()) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto found = shareGroups_.find(&Magnum::GL::Context::current());
+  return found == shareGroups_.end() ? nullptr : found->second;
+}
+
+std::string GpuAssetRegistry::key(const std::string& filename,
+                                  const std::string& options) {
+  std::ostringstream out;
+  if (const void* group = instance().currentShareGroup()) {
+    out << "group " << group;
+  } else {
+    out << (Magnum::GL::Context::hasCurrent() ? &Magnum::GL::Context::current()
+                                              : nullptr);
+  }
+  out << ':' << options << ':' << filename;
+  return out.str();
+}
+
+GpuAssetData::ptr GpuAssetRegistry::find(const std::string& key) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto found = assets_.find(key);
+  if (found == assets_.end()) {
+    return nullptr;
+  }
+  return found->second.lock();
+}
+
+void GpuAssetRegistry::add(const std::string& key,
+                           const GpuAssetData::ptr& data) {
+  // other contexts of the group only see the uploads once they completed
+  if (currentShareGroup()) {
+    Magnum::GL::Renderer::finish();
+  }
+  std::lock_guard<std::mutex> lock{mutex_};
+  // drop assets freed in the meantime so the map doesn't grow unbounded
+  for (auto it = assets_.begin(); it != assets_.end();) {
+    if (it->second.expired()) {
+      it = assets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  assets_[key] = data;
+}
+
+size_t GpuAssetRegistry::size() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  size_t count = 0;
+  for (const auto& asset : assets_) {
+    count += !asset.second.expired();
+  }
+  return count;
+}
+
+void GpuAssetRegistry::setShareGroup(const Magnum::GL::Context& context,
+                                     const void* group) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  shareGroups_[&context] = group;
+}
+
+void GpuAssetRegistry::removeShareGroup(const Magnum::GL::Context& context) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  shareGroups_.erase(&context);
+}
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,116 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::assets::GpuAssetRegistry, struct @ref
+ * esp::assets::GpuAssetData
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Matrix3.h>
+
+#include "BaseMesh.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief Meshes and textures of one asset uploaded to the GPU
+ *
+ * Shared by all @ref ResourceManager instances that loaded the asset with the
+ * same configuration on the same GL context or on contexts of the same share
+ * group.
+ */
+struct GpuAssetData {
+  /** @brief Meshes of the asset, in importer order */
+  std::vector<std::shared_ptr<BaseMesh>> meshes;
+
+  /** @brief Textures of the asset, in importer order, nullptr if invalid */
+  std::vector<std::shared_ptr<Magnum::GL::Texture2D>> textures;
+
+  /** @brief Size of the image data uploaded for each of @ref textures */
+  std::vector<size_t> textureByteSizes;
+
+  /**
+   * @brief Placement of each of @ref textures on the atlas it's packed into,
+   * identity if it isn't
+   */
+  std::vector<Magnum::Matrix3> textureTransforms;
+
+  ESP_SMART_POINTERS(GpuAssetData)
+};
+
+/**
+ * @brief Process-wide registry of GPU asset data
+ *
+ * Only holds weak references, an asset is freed once the last @ref
+ * ResourceManager using it is destroyed. Keys are built with @ref key() and
+ * include the current GL context, as GL objects can't be used across
+ * contexts, or its share group if it was registered with
+ * @ref setShareGroup(). Thread-safe.
+ */
+class GpuAssetRegistry {
+ public:
+  /** @brief The registry instance */
+  static GpuAssetRegistry& instance();
+
+  /**
+   * @brief Key of an asset loaded with given options on the current context
+   * @param filename  Absolute path of the asset
+   * @param options   Loading options that change the uploaded data
+   */
+  static std::string key(const std::string& filename,
+                         const std::string& options);
+
+  /**
+   * @brief Find a registered asset
+   * @return The asset data or nullptr if it isn't registered or was freed
+   */
+  GpuAssetData::ptr find(const std::string& key);
+
+  /**
+   * @brief Register asset data under @p key
+   *
+   * Replaces any data previously registered under the same key.
+   */
+  void add(const std::string& key, const GpuAssetData::ptr& data);
+
+  /** @brief Number of registered assets that are still alive */
+  size_t size();
+
+  /**
+   * @brief Register @p context as a member of the share group @p group
+   *
+   * Assets uploaded on any context of a group are found by all of them.
+   * @p group identifies the group and has to stay unique while any of its
+   * contexts is registered. Called by @ref gfx::WindowlessContext.
+   */
+  void setShareGroup(const Magnum::GL::Context& context, const void* group);
+
+  /** @brief Unregister a context registered with @ref setShareGroup() */
+  void removeShareGroup(const Magnum::GL::Context& context);
+
+ private:
+  GpuAssetRegistry() = default;
+
+  // share group of the current context, nullptr if it's not in any
+  const void* currentShareGroup();
+
+  std::mutex mutex_;
+  std::map<std::string, std::weak_ptr<GpuAssetData>> assets_;
+  std::map<const Magnum::GL::Context*, const void*> shareGroups_;
+};
+
+}  // namespace assets
+}  // namespace esp
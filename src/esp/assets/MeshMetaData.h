@@ -84,6 +84,11 @@ struct MeshMetaData {
    * stores the relationship between components of the asset.*/
   MeshTransformNode root;
 
+  /** @brief Whether the meshes carry object IDs per vertex, drawn with
+   * materials that have @ref gfx::PhongMaterialData::perVertexObjectId set.
+   */
+  bool perVertexObjectIds = false;
+
   /** @brief Default constructor. */
   MeshMetaData(){};
 
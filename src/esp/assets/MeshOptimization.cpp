@@ -0,0 +1,380 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshOptimization.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+constexpr std::size_t NO_VERTEX = ~std::size_t{};
+
+// FIFO cache simulated with timestamps: a vertex is in the cache if fewer
+// than cacheSize vertices were added after it
+struct VertexCache {
+  VertexCache(std::size_t vertexCount, std::size_t cacheSize)
+      : timestamps(vertexCount, 0), time{cacheSize + 1}, size{cacheSize} {}
+
+  // adds the vertex if it's not in the cache, returns whether it had to
+  bool miss(Mn::UnsignedInt vertex) {
+    if (time - timestamps[vertex] <= size) {
+      return false;
+    }
+    timestamps[vertex] = time++;
+    return true;
+  }
+
+  std::vector<std::size_t> timestamps;
+  std::size_t time;
+  std::size_t size;
+};
+
+template <class T>
+void copyIndices(Cr::Containers::ArrayView<const Mn::UnsignedInt> source,
+                 const Cr::Containers::StridedArrayView1D<T>& destination) {
+  for (std::size_t i = 0; i != source.size(); ++i) {
+    destination[i] = T(source[i]);
+  }
+}
+
+}  // namespace
+
+float averageCacheMissRatio(
+    Cr::Containers::ArrayView<const Mn::UnsignedInt> indices,
+    std::size_t vertexCount,
+    std::size_t cacheSize) {
+  if (indices.size() < 3) {
+    return 0.0f;
+  }
+  VertexCache cache{vertexCount, cacheSize};
+  std::size_t misses = 0;
+  for (Mn::UnsignedInt index : indices) {
+    misses += cache.miss(index);
+  }
+  return float(misses) / float(indices.size() / 3);
+}
+
+void optimizeVertexCache(Cr::Containers::ArrayView<Mn::UnsignedInt> indices,
+                         std::size_t vertexCount,
+                         std::size_t cacheSize) {
+  const std::size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2) {
+    return;
+  }
+
+  // triangles using each vertex, packed by vertex
+  std::vector<Mn::UnsignedInt> offsets(vertexCount + 1, 0);
+  for (Mn::UnsignedInt index : indices) {
+    ++offsets[index + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<Mn::UnsignedInt> adjacency(triangleCount * 3);
+  {
+    std::vector<Mn::UnsignedInt> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i != triangleCount * 3; ++i) {
+      adjacency[fill[indices[i]]++] = i / 3;
+    }
+  }
+
+  // number of not yet emitted triangles using each vertex
+  std::vector<Mn::UnsignedInt> live(vertexCount);
+  for (std::size_t v = 0; v != vertexCount; ++v) {
+    live[v] = offsets[v + 1] - offsets[v];
+  }
+
+  VertexCache cache{vertexCount, cacheSize};
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<Mn::UnsignedInt> output;
+  output.reserve(triangleCount * 3);
+  std::vector<Mn::UnsignedInt> deadEnd;
+  std::vector<Mn::UnsignedInt> candidates;
+  std::size_t cursor = 0;
+  std::size_t fanning = indices[0];
+  while (fanning != NO_VERTEX) {
+    // emit all remaining triangles around the fanning vertex
+    candidates.clear();
+    for (Mn::UnsignedInt a = offsets[fanning]; a != offsets[fanning + 1];
+         ++a) {
+      const Mn::UnsignedInt triangle = adjacency[a];
+      if (emitted[triangle]) {
+        continue;
+      }
+      emitted[triangle] = true;
+      for (std::size_t k = 0; k != 3; ++k) {
+        const Mn::UnsignedInt v = indices[triangle * 3 + k];
+        output.push_back(v);
+        deadEnd.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        cache.miss(v);
+      }
+    }
+
+    // continue with the vertex that stays in the cache the longest while
+    // all its triangles get emitted
+    fanning = NO_VERTEX;
+    std::size_t bestPriority = 0;
+    for (Mn::UnsignedInt v : candidates) {
+      if (live[v] == 0) {
+        continue;
+      }
+      const std::size_t age = cache.time - cache.timestamps[v];
+      const std::size_t priority = age + 2 * live[v] <= cacheSize ? age : 0;
+      if (fanning == NO_VERTEX || priority > bestPriority) {
+        fanning = v;
+        bestPriority = priority;
+      }
+    }
+    // otherwise a recently used one, or the next with triangles left
+    while (fanning == NO_VERTEX && !deadEnd.empty()) {
+      const Mn::UnsignedInt v = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[v] != 0) {
+        fanning = v;
+      }
+    }
+    for (; fanning == NO_VERTEX && cursor != vertexCount; ++cursor) {
+      if (live[cursor] != 0) {
+        fanning = cursor;
+      }
+    }
+  }
+
+  std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void optimizeOverdraw(
+    Cr::Containers::ArrayView<Mn::UnsignedInt> indices,
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& positions,
+    std::size_t cacheSize) {
+  const std::size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2) {
+    return;
+  }
+
+  // split where all vertices of a triangle miss the cache, reordering there
+  // doesn't lose any hits
+  std::vector<std::size_t> clusterStarts;
+  VertexCache cache{positions.size(), cacheSize};
+  for (std::size_t t = 0; t != triangleCount; ++t) {
+    const int misses = cache.miss(indices[t * 3]) +
+                       cache.miss(indices[t * 3 + 1]) +
+                       cache.miss(indices[t * 3 + 2]);
+    if (t == 0 || misses == 3) {
+      clusterStarts.push_back(t);
+    }
+  }
+  if (clusterStarts.size() < 2) {
+    return;
+  }
+  clusterStarts.push_back(triangleCount);
+  const std::size_t clusterCount = clusterStarts.size() - 1;
+
+  // area-weighted centroid and normal of every cluster
+  std::vector<Mn::Vector3> centroids(clusterCount);
+  std::vector<Mn::Vector3> normals(clusterCount);
+  std::vector<float> areas(clusterCount, 0.0f);
+  Mn::Vector3 meshCentroid;
+  float meshArea = 0.0f;
+  for (std::size_t c = 0; c != clusterCount; ++c) {
+    Mn::Vector3 average;
+    for (std::size_t t = clusterStarts[c]; t != clusterStarts[c + 1]; ++t) {
+      const Mn::Vector3& a = positions[indices[t * 3]];
+      const Mn::Vector3& b = positions[indices[t * 3 + 1]];
+      const Mn::Vector3& d = positions[indices[t * 3 + 2]];
+      const Mn::Vector3 normal = Mn::Math::cross(b - a, d - a);
+      const float area = normal.length() * 0.5f;
+      normals[c] += normal;
+      centroids[c] += area * (a + b + d) / 3.0f;
+      average += (a + b + d) / 3.0f;
+      areas[c] += area;
+    }
+    meshCentroid += centroids[c];
+    meshArea += areas[c];
+    centroids[c] = areas[c] > 0.0f
+                       ? centroids[c] / areas[c]
+                       : average / float(clusterStarts[c + 1] -
+                                         clusterStarts[c]);
+  }
+  if (meshArea > 0.0f) {
+    meshCentroid /= meshArea;
+  }
+
+  // clusters facing away from the center first
+  std::vector<float> keys(clusterCount);
+  for (std::size_t c = 0; c != clusterCount; ++c) {
+    const float length = normals[c].length();
+    keys[c] = length > 0.0f
+                  ? Mn::Math::dot(centroids[c] - meshCentroid, normals[c]) /
+                        length
+                  : 0.0f;
+  }
+  std::vector<std::size_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&keys](std::size_t a, std::size_t b) {
+                     return keys[a] > keys[b];
+                   });
+
+  std::vector<Mn::UnsignedInt> output;
+  output.reserve(triangleCount * 3);
+  for (std::size_t c : order) {
+    output.insert(output.end(), indices.begin() + clusterStarts[c] * 3,
+                  indices.begin() + clusterStarts[c + 1] * 3);
+  }
+  std::copy(output.begin(), output.end(), indices.begin());
+}
+
+Cr::Containers::Array<Mn::UnsignedInt> optimizeVertexFetch(
+    Cr::Containers::ArrayView<Mn::UnsignedInt> indices,
+    std::size_t vertexCount) {
+  constexpr Mn::UnsignedInt unused = ~Mn::UnsignedInt{};
+  Cr::Containers::Array<Mn::UnsignedInt> remap{Cr::Containers::DirectInit,
+                                               vertexCount, unused};
+  Mn::UnsignedInt next = 0;
+  for (Mn::UnsignedInt& index : indices) {
+    if (remap[index] == unused) {
+      remap[index] = next++;
+    }
+    index = remap[index];
+  }
+  for (Mn::UnsignedInt& newIndex : remap) {
+    if (newIndex == unused) {
+      newIndex = next++;
+    }
+  }
+  return remap;
+}
+
+VertexClusters clusterVertices(
+    Cr::Containers::ArrayView<const Mn::UnsignedInt> indices,
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& positions,
+    float cellSize,
+    Cr::Containers::ArrayView<const Mn::UnsignedShort> groups) {
+  CORRADE_ASSERT(groups.empty() || groups.size() == positions.size(),
+                 "esp::assets::clusterVertices(): expected"
+                     << positions.size() << "groups but got" << groups.size(),
+                 {});
+  VertexClusters clusters;
+  clusters.vertexClusters = Cr::Containers::Array<Mn::UnsignedInt>{
+      Cr::Containers::NoInit, positions.size()};
+  if (positions.empty()) {
+    return clusters;
+  }
+
+  // cells are addressed with 16 bits per axis, next to the 16-bit group
+  const Mn::Range3D bounds{Mn::Math::minmax(positions)};
+  cellSize = Mn::Math::max(Mn::Math::max(cellSize, 1.0e-6f),
+                           bounds.size().max() / 65535.0f);
+  std::unordered_map<uint64_t, Mn::UnsignedInt> cells;
+  for (std::size_t v = 0; v != positions.size(); ++v) {
+    const Mn::Vector3ui cell{
+        Mn::Math::min(Mn::Vector3ui{(positions[v] - bounds.min()) / cellSize},
+                      Mn::Vector3ui{65535})};
+    const uint64_t key = uint64_t(cell.x()) | uint64_t(cell.y()) << 16 |
+                         uint64_t(cell.z()) << 32 |
+                         uint64_t(groups.empty() ? 0 : groups[v]) << 48;
+    clusters.vertexClusters[v] =
+        cells.emplace(key, Mn::UnsignedInt(cells.size())).first->second;
+  }
+  clusters.clusterCount = cells.size();
+
+  // triangles rotated to start at their lowest index, to find duplicates
+  // with the same winding
+  std::set<std::array<Mn::UnsignedInt, 3>> emitted;
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    std::array<Mn::UnsignedInt, 3> triangle{
+        clusters.vertexClusters[indices[i]],
+        clusters.vertexClusters[indices[i + 1]],
+        clusters.vertexClusters[indices[i + 2]]};
+    if (triangle[0] == triangle[1] || triangle[1] == triangle[2] ||
+        triangle[2] == triangle[0]) {
+      continue;
+    }
+    std::rotate(triangle.begin(),
+                std::min_element(triangle.begin(), triangle.end()),
+                triangle.end());
+    if (emitted.insert(triangle).second) {
+      clusters.indices.insert(clusters.indices.end(), triangle.begin(),
+                              triangle.end());
+    }
+  }
+  return clusters;
+}
+
+bool optimizeMesh(Mn::Trade::MeshData& mesh) {
+  if (mesh.primitive() != Mn::MeshPrimitive::Triangles || !mesh.isIndexed() ||
+      mesh.vertexCount() == 0 ||
+      !mesh.hasAttribute(Mn::Trade::MeshAttribute::Position) ||
+      !(mesh.indexDataFlags() & Mn::Trade::DataFlag::Mutable) ||
+      !(mesh.vertexDataFlags() & Mn::Trade::DataFlag::Mutable) ||
+      !Mn::MeshTools::isInterleaved(mesh)) {
+    return false;
+  }
+
+  const std::size_t vertexCount = mesh.vertexCount();
+  Cr::Containers::Array<Mn::UnsignedInt> indices = mesh.indicesAsArray();
+  const Cr::Containers::Array<Mn::Vector3> positions =
+      mesh.positions3DAsArray();
+  optimizeVertexCache(indices, vertexCount);
+  optimizeOverdraw(indices, Cr::Containers::stridedArrayView(positions));
+  const Cr::Containers::Array<Mn::UnsignedInt> remap =
+      optimizeVertexFetch(indices, vertexCount);
+
+  switch (mesh.indexType()) {
+    case Mn::MeshIndexType::UnsignedByte:
+      copyIndices<Mn::UnsignedByte>(indices,
+                                    mesh.mutableIndices<Mn::UnsignedByte>());
+      break;
+    case Mn::MeshIndexType::UnsignedShort:
+      copyIndices<Mn::UnsignedShort>(indices,
+                                     mesh.mutableIndices<Mn::UnsignedShort>());
+      break;
+    case Mn::MeshIndexType::UnsignedInt:
+      copyIndices<Mn::UnsignedInt>(indices,
+                                   mesh.mutableIndices<Mn::UnsignedInt>());
+      break;
+  }
+
+  // being interleaved, every vertex is one row of stride bytes starting at
+  // the lowest attribute offset, the last one possibly shorter
+  const std::size_t stride = mesh.attributeStride(0);
+  std::size_t base = mesh.attributeOffset(0);
+  for (Mn::UnsignedInt i = 1; i != mesh.attributeCount(); ++i) {
+    base = std::min<std::size_t>(base, mesh.attributeOffset(i));
+  }
+  const Cr::Containers::ArrayView<char> data = mesh.mutableVertexData();
+  const std::size_t rowSize =
+      std::min(stride, data.size() - base - (vertexCount - 1) * stride);
+  Cr::Containers::Array<char> original{Cr::Containers::NoInit, data.size()};
+  Cr::Utility::copy(Cr::Containers::ArrayView<const char>{data}, original);
+  for (std::size_t v = 0; v != vertexCount; ++v) {
+    std::memcpy(data.data() + base + remap[v] * stride,
+                original.data() + base + v * stride, rowSize);
+  }
+  return true;
+}
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,146 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Triangle and vertex reordering for faster rendering, see
+ * @ref esp::assets::optimizeMesh()
+ */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/Trade.h>
+
+namespace esp {
+namespace assets {
+
+/** @brief Default size of the simulated post-transform vertex cache */
+constexpr std::size_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+/**
+ * @brief Average number of vertex shader invocations per triangle
+ *
+ * Simulates a FIFO post-transform vertex cache of @p cacheSize entries.
+ * Ranges from 3 for a cache that never hits down to about 0.5 for a regular
+ * grid drawn in the ideal order.
+ */
+float averageCacheMissRatio(
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices,
+    std::size_t vertexCount,
+    std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * @brief Reorder triangles to make better use of the post-transform vertex
+ * cache
+ *
+ * Uses the Tipsify algorithm (Sander, Nehab and Barczak, 2007), which fans
+ * around the vertex most likely to still be in the cache. Runs in linear
+ * time; the set of triangles and their winding stay the same.
+ */
+void optimizeVertexCache(
+    Corrade::Containers::ArrayView<Magnum::UnsignedInt> indices,
+    std::size_t vertexCount,
+    std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * @brief Reorder clusters of triangles to reduce overdraw
+ *
+ * Splits @p indices, already ordered by @ref optimizeVertexCache(), where
+ * the cache restarts anyway and sorts the clusters so the ones facing away
+ * from the mesh center, which likely occlude the others, are drawn first.
+ * The order within a cluster is kept, so the cache efficiency barely
+ * changes.
+ */
+void optimizeOverdraw(
+    Corrade::Containers::ArrayView<Magnum::UnsignedInt> indices,
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        positions,
+    std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * @brief Renumber vertices in the order the indices first use them
+ *
+ * Makes vertex fetches walk the vertex buffer mostly linearly. Rewrites
+ * @p indices and returns the new index of every vertex, unreferenced
+ * vertices are moved to the end. Apply it to the vertex data with
+ * @ref remapVertices().
+ */
+Corrade::Containers::Array<Magnum::UnsignedInt> optimizeVertexFetch(
+    Corrade::Containers::ArrayView<Magnum::UnsignedInt> indices,
+    std::size_t vertexCount);
+
+/**
+ * @brief Move every vertex in @p data to its index in @p remap
+ */
+template <class T>
+void remapVertices(
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> remap,
+    std::vector<T>& data) {
+  std::vector<T> remapped(data.size());
+  for (std::size_t i = 0; i != data.size(); ++i) {
+    remapped[remap[i]] = data[i];
+  }
+  data = std::move(remapped);
+}
+
+/**
+ * @brief Result of @ref clusterVertices()
+ */
+struct VertexClusters {
+  /** @brief Cluster every vertex was merged into */
+  Corrade::Containers::Array<Magnum::UnsignedInt> vertexClusters;
+
+  /** @brief Number of clusters */
+  std::size_t clusterCount = 0;
+
+  /**
+   * @brief Triangles that didn't collapse, as indices of clusters
+   *
+   * Triangles with fewer than three distinct clusters and duplicates of
+   * earlier triangles are dropped.
+   */
+  std::vector<Magnum::UnsignedInt> indices;
+};
+
+/**
+ * @brief Simplify a triangle mesh by merging vertices in a uniform grid
+ * @param indices     Triangle indices
+ * @param positions   Vertex positions
+ * @param cellSize    Grid cell size. Vertices move by at most its diagonal.
+ * @param groups      Optional group of every vertex, such as an object ID.
+ *    Vertices of different groups are never merged.
+ *
+ * Vertex clustering (Rossignac and Borrel, 1993) doesn't preserve topology,
+ * which suits distant levels of detail of scanned scenes, and runs in a
+ * single pass. Attributes of the clusters are left to the caller, e.g.
+ * averaged over @ref VertexClusters::vertexClusters.
+ */
+VertexClusters clusterVertices(
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices,
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        positions,
+    float cellSize,
+    Corrade::Containers::ArrayView<const Magnum::UnsignedShort> groups = {});
+
+/**
+ * @brief Run all optimizations on an indexed triangle mesh in place
+ *
+ * Reorders the triangles with @ref optimizeVertexCache() and
+ * @ref optimizeOverdraw() and the vertices with @ref optimizeVertexFetch().
+ * The index type is kept.
+ * @return Whether the mesh was optimized. Meshes that aren't indexed
+ * triangles, aren't interleaved or have immutable data are left untouched.
+ */
+bool optimizeMesh(Magnum::Trade::MeshData& mesh);
+
+}  // namespace assets
+}  // namespace esp
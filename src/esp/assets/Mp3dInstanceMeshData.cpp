@@ -4,6 +4,8 @@
 
 #include "Mp3dInstanceMeshData.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -13,9 +15,13 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Directory.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
+#include <Magnum/Math/Color.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/Trade.h>
@@ -24,9 +30,33 @@
 #include "esp/geo/geo.h"
 #include "esp/io/io.h"
 
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
 namespace esp {
 namespace assets {
 
+namespace {
+
+// size of a vertex and a face in the body of MP3D house segmentation PLYs,
+// the fields are listed in loadMp3dPLY()
+constexpr std::size_t VERTEX_SIZE = 3 * 4 + 3 * 4 + 2 * 4 + 3;
+constexpr std::size_t FACE_SIZE = 1 + 3 * 4 + 3 * 4;
+
+// copy the field at byte offset of every record into the tightly packed
+// destination, one strided copy per field
+template <class T>
+void copyField(const Cr::Containers::StridedArrayView2D<const char>& records,
+               std::size_t offset,
+               Cr::Containers::ArrayView<T> destination) {
+  Cr::Utility::copy(
+      records.slice({0, offset}, {records.size()[0], offset + sizeof(T)}),
+      Cr::Containers::arrayCast<2, char>(
+          Cr::Containers::stridedArrayView(destination)));
+}
+
+}  // namespace
+
 bool Mp3dInstanceMeshData::loadMp3dPLY(const std::string& plyFile) {
   std::ifstream ifs(plyFile);
   if (!ifs.good()) {
@@ -76,45 +106,59 @@ bool Mp3dInstanceMeshData::loadMp3dPLY(const std::string& plyFile) {
   do {
     std::getline(ifs, line);
   } while ((line != "end_header") && !ifs.eof());
+  if (ifs.eof() || nVertex < 0 || nFace < 0) {
+    LOG(ERROR) << "Invalid ply file header";
+    return false;
+  }
 
-  cpu_cbo_.clear();
-  cpu_cbo_.reserve(nVertex);
-  cpu_vbo_.clear();
-  cpu_vbo_.reserve(nVertex);
-  cpu_ibo_.clear();
-  cpu_ibo_.reserve(nFace);
-
-  for (int i = 0; i < nVertex; ++i) {
-    vec3f position;
-    vec3f normal;
-    vec2f texCoords;
-    vec3uc rgb;
-
-    ifs.read(reinterpret_cast<char*>(position.data()), 3 * sizeof(float));
-    ifs.read(reinterpret_cast<char*>(normal.data()), 3 * sizeof(float));
-    ifs.read(reinterpret_cast<char*>(texCoords.data()), 2 * sizeof(float));
-    ifs.read(reinterpret_cast<char*>(rgb.data()), 3 * sizeof(uint8_t));
-    cpu_vbo_.emplace_back(position);
-    cpu_cbo_.emplace_back(rgb);
+  // the body is read through a memory map
+  const size_t postHeader = ifs.tellg();
+  ifs.close();
+  const Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      mmappedData = Cr::Utility::Directory::mapRead(plyFile);
+  if (mmappedData.size() <
+      postHeader + nVertex * VERTEX_SIZE + nFace * FACE_SIZE) {
+    LOG(ERROR) << "Truncated ply file body";
+    return false;
   }
 
-  for (int i = 0; i < nFace; ++i) {
-    uint8_t nIndices;
-    vec3ui indices;
-    int32_t materialId;
-    int32_t segmentId;
-    int32_t categoryId;
-
-    ifs.read(reinterpret_cast<char*>(&nIndices), sizeof(nIndices));
-    ASSERT(nIndices == 3);
-    ifs.read(reinterpret_cast<char*>(indices.data()), 3 * sizeof(int));
-    ifs.read(reinterpret_cast<char*>(&materialId), sizeof(materialId));
-    ifs.read(reinterpret_cast<char*>(&segmentId), sizeof(segmentId));
-    ifs.read(reinterpret_cast<char*>(&categoryId), sizeof(categoryId));
-    cpu_ibo_.emplace_back(indices);
-    materialIds_.emplace_back(materialId);
-    segmentIds_.emplace_back(segmentId);
-    categoryIds_.emplace_back(categoryId);
+  // position, normal, texCoords, rgb
+  const Cr::Containers::ArrayView<const char> data{mmappedData.data(),
+                                                   mmappedData.size()};
+  const Cr::Containers::StridedArrayView2D<const char> vertices{
+      data,
+      data + postHeader,
+      {std::size_t(nVertex), VERTEX_SIZE},
+      {std::ptrdiff_t(VERTEX_SIZE), 1}};
+  // nIndices, indices, materialId, segmentId, categoryId
+  const Cr::Containers::StridedArrayView2D<const char> faces{
+      data,
+      data + postHeader + nVertex * VERTEX_SIZE,
+      {std::size_t(nFace), FACE_SIZE},
+      {std::ptrdiff_t(FACE_SIZE), 1}};
+
+  cpu_vbo_.resize(nVertex);
+  cpu_cbo_.resize(nVertex);
+  copyField(vertices, 0, Cr::Containers::arrayCast<Mn::Vector3>(
+                             Cr::Containers::arrayView(cpu_vbo_)));
+  copyField(vertices, 32, Cr::Containers::arrayCast<Mn::Color3ub>(
+                              Cr::Containers::arrayView(cpu_cbo_)));
+
+  std::vector<uint8_t> nIndices(nFace);
+  cpu_ibo_.resize(nFace);
+  materialIds_.resize(nFace);
+  segmentIds_.resize(nFace);
+  categoryIds_.resize(nFace);
+  copyField(faces, 0, Cr::Containers::arrayView(nIndices));
+  copyField(faces, 1, Cr::Containers::arrayCast<Mn::Vector3ui>(
+                          Cr::Containers::arrayView(cpu_ibo_)));
+  copyField(faces, 13, Cr::Containers::arrayView(materialIds_));
+  copyField(faces, 17, Cr::Containers::arrayView(segmentIds_));
+  copyField(faces, 21, Cr::Containers::arrayView(categoryIds_));
+  if (std::any_of(nIndices.begin(), nIndices.end(),
+                  [](uint8_t n) { return n != 3; })) {
+    LOG(ERROR) << "Only triangle faces are supported";
+    return false;
   }
 
   // Construct vertices for meshData
@@ -138,6 +182,30 @@ bool Mp3dInstanceMeshData::saveSemMeshPLY(
   const int nVertex = cpu_vbo_.size();
   const int nFace = cpu_ibo_.size();
 
+  // The materialId corresponds to the segmentId from the .house file
+  std::vector<int32_t> objectIds(nFace);
+  bool segmentsFound = true;
+#pragma omp parallel for reduction(&& : segmentsFound)
+  for (int iFace = 0; iFace < nFace; ++iFace) {
+    const int32_t segmentId = materialIds_[iFace];
+    int32_t objectId = ID_UNDEFINED;
+    if (segmentId >= 0) {
+      auto found = segmentIdToObjectIdMap.find(segmentId);
+      if (found != segmentIdToObjectIdMap.end()) {
+        objectId = found->second;
+      } else {
+        segmentsFound = false;
+      }
+    }
+    objectIds[iFace] = objectId;
+  }
+  if (!segmentsFound) {
+    LOG(ERROR) << "Segment IDs missing in the segment to object ID map, not "
+                  "saving "
+               << plyFile;
+    return false;
+  }
+
   std::ofstream f(plyFile, std::ios::out | std::ios::binary);
   f << "ply" << std::endl;
   f << "format binary_little_endian 1.0" << std::endl;
@@ -153,27 +221,28 @@ bool Mp3dInstanceMeshData::saveSemMeshPLY(
   f << "property int object_id" << std::endl;
   f << "end_header" << std::endl;
 
+  // interleave into the layout given in the header and write in one go
+  constexpr std::size_t semVertexSize = 3 * sizeof(float) + 3;
+  constexpr std::size_t semFaceSize = 1 + 3 * sizeof(uint32_t) + 4;
+  Cr::Containers::Array<char> body{Cr::Containers::NoInit,
+                                   nVertex * semVertexSize +
+                                       nFace * semFaceSize};
+#pragma omp parallel for
   for (int iVertex = 0; iVertex < nVertex; ++iVertex) {
-    const vec3f& xyz = cpu_vbo_[iVertex].head<3>();
-    const vec3uc& rgb = cpu_cbo_[iVertex];
-    f.write(reinterpret_cast<const char*>(xyz.data()), 3 * sizeof(float));
-    f.write(reinterpret_cast<const char*>(rgb.data()), 3 * sizeof(uint8_t));
+    char* out = body + iVertex * semVertexSize;
+    std::memcpy(out, cpu_vbo_[iVertex].data(), 3 * sizeof(float));
+    std::memcpy(out + 3 * sizeof(float), cpu_cbo_[iVertex].data(), 3);
   }
-
-  for (int iFace = 0; iFace < cpu_ibo_.size(); ++iFace) {
-    const uint8_t nIndices = 3;
-    const vec3ui& indices = cpu_ibo_[iFace];
-    // The materialId corresponds to the segmentId from the .house file
-    const int32_t segmentId = materialIds_[iFace];
-    int32_t objectId = ID_UNDEFINED;
-    if (segmentId >= 0) {
-      objectId = segmentIdToObjectIdMap.at(segmentId);
-    }
-    f.write(reinterpret_cast<const char*>(&nIndices), sizeof(nIndices));
-    f.write(reinterpret_cast<const char*>(indices.data()),
-            3 * sizeof(uint32_t));
-    f.write(reinterpret_cast<const char*>(&objectId), sizeof(objectId));
+  char* const faces = body + nVertex * semVertexSize;
+#pragma omp parallel for
+  for (int iFace = 0; iFace < nFace; ++iFace) {
+    char* out = faces + iFace * semFaceSize;
+    out[0] = 3;
+    std::memcpy(out + 1, cpu_ibo_[iFace].data(), 3 * sizeof(uint32_t));
+    std::memcpy(out + 1 + 3 * sizeof(uint32_t), &objectIds[iFace],
+                sizeof(int32_t));
   }
+  f.write(body, body.size());
   f.close();
 
   return true;
@@ -4,7 +4,11 @@
 
 #include "PTexMeshData.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <future>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -21,6 +25,7 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 
+#include "esp/core/TaskScheduler.h"
 #include "esp/core/esp.h"
 #include "esp/gfx/PTexMeshShader.h"
 #include "esp/io/io.h"
@@ -56,6 +61,7 @@ void PTexMeshData::load(const std::string& meshFile,
   splitSize_ = json["splitSize"].GetDouble();
   tileSize_ = json["tileSize"].GetInt();
   atlasFolder_ = atlasFolder;
+  meshFile_ = meshFile;
 
   loadMeshData(meshFile);
 }
@@ -92,6 +98,13 @@ std::string PTexMeshData::atlasFolder() const {
   return atlasFolder_;
 }
 
+void PTexMeshData::setVertexPulling(bool vertexPulling) {
+  if (vertexPulling != vertexPulling_) {
+    vertexPulling_ = vertexPulling;
+    buffersOnGPU_ = false;
+  }
+}
+
 // split the original ptex mesh into sub-meshes.
 //
 // WARNING:
@@ -115,6 +128,7 @@ std::string PTexMeshData::atlasFolder() const {
 std::vector<PTexMeshData::MeshData> splitMesh(
     const PTexMeshData::MeshData& mesh,
     const float splitSize) {
+  core::TaskScheduler& scheduler = core::TaskScheduler::global();
   std::vector<uint32_t> verts;
   verts.resize(mesh.vbo.size());
 
@@ -138,13 +152,14 @@ std::vector<PTexMeshData::MeshData> splitMesh(
     boundingBox.extend(mesh.vbo[i].head<3>());
   }
 
-// calculate vertex grid position and code
-#pragma omp parallel for
-  for (size_t i = 0; i < mesh.vbo.size(); i++) {
-    const vec3f p = mesh.vbo[i].head<3>();
-    vec3f pi = (p - boundingBox.min()) / splitSize;
-    verts[i] = EncodeMorton3(pi.cast<int>());
-  }
+  // calculate vertex grid position and code
+  scheduler.parallelFor(0, mesh.vbo.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const vec3f p = mesh.vbo[i].head<3>();
+      vec3f pi = (p - boundingBox.min()) / splitSize;
+      verts[i] = EncodeMorton3(pi.cast<int>());
+    }
+  });
 
   // data structure for sorting faces
   struct SortFace {
@@ -161,17 +176,18 @@ std::vector<PTexMeshData::MeshData> splitMesh(
   std::vector<SortFace> faces;
   faces.resize(numFaces);
 
-#pragma omp parallel for
-  for (size_t i = 0; i < numFaces; i++) {
-    faces[i].originalFace = i;
-    faces[i].code = std::numeric_limits<uint32_t>::max();
-    for (int j = 0; j < 4; j++) {
-      faces[i].index[j] = mesh.ibo[i * 4 + j];
+  scheduler.parallelFor(0, numFaces, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      faces[i].originalFace = i;
+      faces[i].code = std::numeric_limits<uint32_t>::max();
+      for (int j = 0; j < 4; j++) {
+        faces[i].index[j] = mesh.ibo[i * 4 + j];
 
-      // face code is minimum of referenced vertices codes
-      faces[i].code = std::min(faces[i].code, verts[faces[i].index[j]]);
+        // face code is minimum of referenced vertices codes
+        faces[i].code = std::min(faces[i].code, verts[faces[i].index[j]]);
+      }
     }
-  }
+  });
 
   // sort faces by code
   std::sort(faces.begin(), faces.end(),
@@ -210,47 +226,48 @@ std::vector<PTexMeshData::MeshData> splitMesh(
     subMeshes.emplace_back();
   }
 
-#pragma omp parallel for
-  for (size_t i = 0; i < numChunks; i++) {
-    uint32_t chunkSize = chunkStart[i + 1] - chunkStart[i];
-
-    std::vector<uint32_t> refdVerts;
-    // it maps indices from original mesh to the new ones in the chunk
-    std::unordered_map<uint32_t, uint32_t> refdVertsMap;
-    subMeshes[i].ibo.resize(chunkSize * 4);
-
-    for (size_t j = 0; j < chunkSize; j++) {
-      size_t faceIdx = chunkStart[i] + j;
-      for (int k = 0; k < 4; k++) {
-        uint32_t vertIndex = faces[faceIdx].index[k];
-        uint32_t newIndex = 0;
-
-        auto it = refdVertsMap.find(vertIndex);
-
-        if (it == refdVertsMap.end()) {
-          // vertex not found, add
-          newIndex = refdVerts.size();
-          refdVerts.push_back(vertIndex);
-          refdVertsMap[vertIndex] = newIndex;
-        } else {
-          // found, use existing index
-          newIndex = it->second;
+  scheduler.parallelFor(0, numChunks, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      uint32_t chunkSize = chunkStart[i + 1] - chunkStart[i];
+
+      std::vector<uint32_t> refdVerts;
+      // it maps indices from original mesh to the new ones in the chunk
+      std::unordered_map<uint32_t, uint32_t> refdVertsMap;
+      subMeshes[i].ibo.resize(chunkSize * 4);
+
+      for (size_t j = 0; j < chunkSize; j++) {
+        size_t faceIdx = chunkStart[i] + j;
+        for (int k = 0; k < 4; k++) {
+          uint32_t vertIndex = faces[faceIdx].index[k];
+          uint32_t newIndex = 0;
+
+          auto it = refdVertsMap.find(vertIndex);
+
+          if (it == refdVertsMap.end()) {
+            // vertex not found, add
+            newIndex = refdVerts.size();
+            refdVerts.push_back(vertIndex);
+            refdVertsMap[vertIndex] = newIndex;
+          } else {
+            // found, use existing index
+            newIndex = it->second;
+          }
+          subMeshes[i].ibo[j * 4 + k] = newIndex;
         }
-        subMeshes[i].ibo[j * 4 + k] = newIndex;
       }
-    }
 
-    // add referenced vertices to submesh
-    subMeshes[i].vbo.resize(refdVerts.size());
-    subMeshes[i].nbo.resize(refdVerts.size());
-    for (size_t j = 0; j < refdVerts.size(); j++) {
-      uint32_t index = refdVerts[j];
-      subMeshes[i].vbo[j] = mesh.vbo[index];
-      subMeshes[i].nbo[j] = mesh.nbo[index];
-      // Careful:
-      // for Ptex mesh we never ever set the "cbo"
+      // add referenced vertices to submesh
+      subMeshes[i].vbo.resize(refdVerts.size());
+      subMeshes[i].nbo.resize(refdVerts.size());
+      for (size_t j = 0; j < refdVerts.size(); j++) {
+        uint32_t index = refdVerts[j];
+        subMeshes[i].vbo[j] = mesh.vbo[index];
+        subMeshes[i].nbo[j] = mesh.nbo[index];
+        // Careful:
+        // for Ptex mesh we never ever set the "cbo"
+      }
     }
-  }
+  });
 
   return subMeshes;
 }
@@ -440,7 +457,152 @@ void PTexMeshData::calculateAdjacency(const PTexMeshData::MeshData& mesh,
   }
 }
 
+namespace {
+// FNV-1a, over everything the cached mesh is built from
+struct ContentHash {
+  uint64_t value = 14695981039346656037ull;
+
+  void add(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i != size; ++i) {
+      value = (value ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+
+  void addFile(const std::string& filename) {
+    const auto data = Cr::Utility::Directory::mapRead(filename);
+    add(data.data(), data.size());
+  }
+};
+
+struct MeshCacheHeader {
+  int magic;
+  int version;
+  uint32_t submeshCount;
+  uint64_t contentHash;
+};
+constexpr int MESH_CACHE_MAGIC = 'P' << 24 | 'T' << 16 | 'E' << 8 | 'X';
+constexpr int MESH_CACHE_VERSION = 1;
+
+// copies the next count elements of the mapped file, false if there aren't as
+// many left
+template <class T>
+bool readArray(Cr::Containers::ArrayView<const char> data,
+               size_t& offset,
+               std::vector<T>& out) {
+  uint64_t count;
+  if (offset + sizeof(count) > data.size()) {
+    return false;
+  }
+  std::memcpy(&count, data + offset, sizeof(count));
+  offset += sizeof(count);
+  if (count > (data.size() - offset) / sizeof(T)) {
+    return false;
+  }
+  out.resize(count);
+  std::memcpy(out.data(), data + offset, count * sizeof(T));
+  offset += count * sizeof(T);
+  return true;
+}
+
+template <class T>
+void writeArray(FILE* fp, const std::vector<T>& data) {
+  const uint64_t count = data.size();
+  fwrite(&count, sizeof(count), 1, fp);
+  fwrite(data.data(), sizeof(T), count, fp);
+}
+
+// false if the file doesn't exist, is invalid or was made from a different
+// mesh
+bool loadMeshCache(const std::string& filename,
+                   uint64_t contentHash,
+                   std::vector<PTexMeshData::MeshData>& submeshes,
+                   std::vector<std::vector<uint32_t>>& adjFaces) {
+  if (!Cr::Utility::Directory::exists(filename)) {
+    return false;
+  }
+  const auto data = Cr::Utility::Directory::mapRead(filename);
+  MeshCacheHeader header;
+  bool valid = data.size() >= sizeof(header);
+  if (valid) {
+    std::memcpy(&header, data.data(), sizeof(header));
+    valid = header.magic == MESH_CACHE_MAGIC &&
+            header.version == MESH_CACHE_VERSION &&
+            header.contentHash == contentHash &&
+            header.submeshCount <= data.size() / (5 * sizeof(uint64_t));
+  }
+  std::vector<PTexMeshData::MeshData> loadedSubmeshes;
+  std::vector<std::vector<uint32_t>> loadedAdjFaces;
+  if (valid) {
+    loadedSubmeshes.resize(header.submeshCount);
+    loadedAdjFaces.resize(header.submeshCount);
+  }
+  size_t offset = sizeof(header);
+  for (uint32_t iMesh = 0; valid && iMesh != header.submeshCount; ++iMesh) {
+    PTexMeshData::MeshData& mesh = loadedSubmeshes[iMesh];
+    valid = readArray(data, offset, mesh.vbo) &&
+            readArray(data, offset, mesh.nbo) &&
+            readArray(data, offset, mesh.cbo) &&
+            readArray(data, offset, mesh.ibo) &&
+            readArray(data, offset, loadedAdjFaces[iMesh]);
+  }
+  if (!valid) {
+    LOG(WARNING) << "Ignoring invalid or outdated PTex mesh cache "
+                 << filename;
+    return false;
+  }
+  submeshes = std::move(loadedSubmeshes);
+  adjFaces = std::move(loadedAdjFaces);
+  return true;
+}
+
+void saveMeshCache(const std::string& filename,
+                   uint64_t contentHash,
+                   const std::vector<PTexMeshData::MeshData>& submeshes,
+                   const std::vector<std::vector<uint32_t>>& adjFaces) {
+  MeshCacheHeader header;
+  header.magic = MESH_CACHE_MAGIC;
+  header.version = MESH_CACHE_VERSION;
+  header.submeshCount = submeshes.size();
+  header.contentHash = contentHash;
+  if (!io::writeFileAtomically(filename, [&](FILE* fp) {
+        fwrite(&header, sizeof(header), 1, fp);
+        for (size_t iMesh = 0; iMesh != submeshes.size(); ++iMesh) {
+          writeArray(fp, submeshes[iMesh].vbo);
+          writeArray(fp, submeshes[iMesh].nbo);
+          writeArray(fp, submeshes[iMesh].cbo);
+          writeArray(fp, submeshes[iMesh].ibo);
+          writeArray(fp, adjFaces[iMesh]);
+        }
+        return true;
+      })) {
+    LOG(WARNING) << "Cannot write PTex mesh cache " << filename;
+  }
+}
+}  // namespace
+
 void PTexMeshData::loadMeshData(const std::string& meshFile) {
+  // splitting and the adjacency are deterministic for a given mesh, so their
+  // results are kept in a file next to it
+  const std::string subMeshesFilename = Corrade::Utility::Directory::join(
+      atlasFolder_, "../habitat/sorted_faces.bin");
+  const std::string cacheFile = meshFile + ".cache";
+  ContentHash hash;
+  hash.addFile(meshFile);
+  hash.add(&splitSize_, sizeof(splitSize_));
+#ifndef CORRADE_TARGET_APPLE
+  const bool hasAdjacency = true;
+#else
+  const bool hasAdjacency = false;
+#endif
+  hash.add(&hasAdjacency, sizeof(hasAdjacency));
+  if (splitSize_ > 0.0f) {
+    hash.addFile(subMeshesFilename);
+  }
+  if (loadMeshCache(cacheFile, hash.value, submeshes_, adjFaces_)) {
+    return;
+  }
+
   PTexMeshData::MeshData originalMesh;
   parsePLY(meshFile, originalMesh);
 
@@ -453,8 +615,6 @@ void PTexMeshData::loadMeshData(const std::string& meshFile) {
     // splitMesh(...)
 
     // See detailed comments in front of the splitMesh(...)
-    std::string subMeshesFilename = Corrade::Utility::Directory::join(
-        atlasFolder_, "../habitat/sorted_faces.bin");
     submeshes_ = loadSubMeshes(originalMesh, subMeshesFilename);
 
     // TODO:
@@ -464,6 +624,19 @@ void PTexMeshData::loadMeshData(const std::string& meshFile) {
   } else {
     submeshes_.emplace_back(std::move(originalMesh));
   }
+
+  adjFaces_.assign(submeshes_.size(), {});
+#ifndef CORRADE_TARGET_APPLE
+  LOG(INFO) << "Calculating mesh adjacency... ";
+
+  core::TaskScheduler& scheduler = core::TaskScheduler::global();
+  scheduler.parallelFor(0, submeshes_.size(), [&](size_t begin, size_t end) {
+    for (size_t iMesh = begin; iMesh < end; ++iMesh) {
+      calculateAdjacency(submeshes_[iMesh], adjFaces_[iMesh]);
+    }
+  });
+#endif
+  saveMeshCache(cacheFile, hash.value, submeshes_, adjFaces_);
 }
 
 void PTexMeshData::parsePLY(const std::string& filename,
@@ -785,7 +958,45 @@ void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
   if (buffersOnGPU_) {
     return;
   }
+  if (uploadDataReleased_) {
+    LOG(INFO) << "Reloading the released mesh data of " << meshFile_;
+    loadMeshData(meshFile_);
+    uploadDataReleased_ = false;
+  }
+
+  // start reading the atlases right away, so the disk is busy while the
+  // buffers are uploaded. At most one file per worker of the scheduler is
+  // in flight, which bounds the memory held by atlases waiting for upload,
+  // and the reads go at low priority so they don't hold up parallel loops
+  // of others sharing the scheduler.
+  const size_t atlasCount = submeshes_.size();
+  std::vector<std::string> atlasFiles(atlasCount);
+  for (size_t iMesh = 0; iMesh < atlasCount; ++iMesh) {
+    atlasFiles[iMesh] = Cr::Utility::Directory::join(
+        atlasFolder_, std::to_string(iMesh) + "-color-ptex.hdr");
+    CORRADE_ASSERT(io::exists(atlasFiles[iMesh]),
+                   "PTexMeshData::uploadBuffersToGPU: Cannot find the .hdr file"
+                       << atlasFiles[iMesh], );
+  }
+  core::TaskScheduler& scheduler = core::TaskScheduler::global();
+  const size_t maxAtlasReads = scheduler.threadCount();
+  std::vector<std::future<Cr::Containers::Array<char>>> atlasReads(atlasCount);
+  auto readAtlas = [&](size_t iMesh) {
+    atlasReads[iMesh] = scheduler.async(
+        [&filename = atlasFiles[iMesh]]() {
+          return Cr::Utility::Directory::read(filename);
+        },
+        core::TaskPriority::Low);
+  };
+  for (size_t iMesh = 0; iMesh < std::min(maxAtlasReads, atlasCount);
+       ++iMesh) {
+    readAtlas(iMesh);
+  }
 
+  renderingBuffers_.clear();
+  gpuVertexByteSize_ = 0;
+  gpuIndexByteSize_ = 0;
+  gpuTextureByteSize_ = 0;
   for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
     LOG(INFO) << "Loading mesh " << iMesh + 1 << "/" << submeshes_.size()
               << "... ";
@@ -798,27 +1009,30 @@ void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
                                       Magnum::GL::BufferUsage::StaticDraw);
     currentMesh->indexBuffer.setData(submeshes_[iMesh].ibo,
                                      Magnum::GL::BufferUsage::StaticDraw);
+    gpuVertexByteSize_ += submeshes_[iMesh].vbo.size() * sizeof(vec3f);
+    gpuIndexByteSize_ += submeshes_[iMesh].ibo.size() * sizeof(uint32_t);
   }
-#ifndef CORRADE_TARGET_APPLE
-  LOG(INFO) << "Calculating mesh adjacency... ";
-
-  std::vector<std::vector<uint32_t>> adjFaces(submeshes_.size());
-
-#pragma omp parallel for
-  for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
-    calculateAdjacency(submeshes_[iMesh], adjFaces[iMesh]);
-  }
-#endif
-
   for (int iMesh = 0; iMesh < submeshes_.size(); ++iMesh) {
     auto& currentMesh = renderingBuffers_[iMesh];
 
 #ifndef CORRADE_TARGET_APPLE
     currentMesh->adjFacesBufferTexture.setBuffer(
         Magnum::GL::BufferTextureFormat::R32UI, currentMesh->adjFacesBuffer);
-    currentMesh->adjFacesBuffer.setData(adjFaces[iMesh],
+    currentMesh->adjFacesBuffer.setData(adjFaces_[iMesh],
                                         Magnum::GL::BufferUsage::StaticDraw);
+    gpuTextureByteSize_ += adjFaces_[iMesh].size() * sizeof(uint32_t);
 #endif
+    if (vertexPulling_) {
+      currentMesh->vertexBufferTexture.setBuffer(
+          Magnum::GL::BufferTextureFormat::RGB32F, currentMesh->vertexBuffer);
+      currentMesh->indexBufferTexture.setBuffer(
+          Magnum::GL::BufferTextureFormat::R32UI, currentMesh->indexBuffer);
+      // no attributes, the vertex shader fetches the positions of the two
+      // triangles of every quad itself
+      currentMesh->mesh.setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
+          .setCount(submeshes_[iMesh].ibo.size() / 4 * 6);
+      continue;
+    }
     GLintptr offset = 0;
     currentMesh->mesh
         .setPrimitive(Magnum::GL::MeshPrimitive::LinesAdjacency)
@@ -833,21 +1047,16 @@ void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
                         Magnum::GL::MeshIndexType::UnsignedInt);
   }
 
-  // load atlas data and upload them to GPU
+  // upload the atlases in order as their reads finish
   LOG(INFO) << "loading atlas textures: ";
-  for (size_t iMesh = 0; iMesh < renderingBuffers_.size(); ++iMesh) {
-    const std::string hdrFile = Cr::Utility::Directory::join(
-        atlasFolder_, std::to_string(iMesh) + "-color-ptex.hdr");
+  for (size_t iMesh = 0; iMesh < atlasCount; ++iMesh) {
+    LOG(INFO) << "Loading atlas " << iMesh + 1 << "/" << atlasCount
+              << " from " << atlasFiles[iMesh] << ". ";
 
-    CORRADE_ASSERT(io::exists(hdrFile),
-                   "PTexMeshData::uploadBuffersToGPU: Cannot find the .hdr file"
-                       << hdrFile, );
-
-    LOG(INFO) << "Loading atlas " << iMesh + 1 << "/"
-              << renderingBuffers_.size() << " from " << hdrFile << ". ";
-
-    Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter> data =
-        Cr::Utility::Directory::mapRead(hdrFile);
+    Cr::Containers::Array<char> data = atlasReads[iMesh].get();
+    if (iMesh + maxAtlasReads < atlasCount) {
+      readAtlas(iMesh + maxAtlasReads);
+    }
     // divided by 6, since there are 3 channels, R, G, B, each of which takes
     // 1 half_float (2 bytes)
     const int dim = static_cast<int>(std::sqrt(data.size() / 6));  // square
@@ -872,11 +1081,35 @@ void PTexMeshData::uploadBuffersToGPU(bool forceReload) {
                      {},  // offset
                      image)
         .generateMipmap();
+    // the mip chain adds a third
+    gpuTextureByteSize_ += data.size() + data.size() / 3;
   }
 
   buffersOnGPU_ = true;
 }
 
+size_t PTexMeshData::releaseUploadData() {
+  if (!buffersOnGPU_ || uploadDataReleased_) {
+    return 0;
+  }
+
+  size_t byteSize = 0;
+  for (MeshData& submesh : submeshes_) {
+    byteSize += submesh.nbo.capacity() * sizeof(vec4f) +
+                submesh.cbo.capacity() * sizeof(vec4uc) +
+                submesh.ibo.capacity() * sizeof(uint32_t);
+    std::vector<vec4f>{}.swap(submesh.nbo);
+    std::vector<vec4uc>{}.swap(submesh.cbo);
+    std::vector<uint32_t>{}.swap(submesh.ibo);
+  }
+  for (std::vector<uint32_t>& adjFaces : adjFaces_) {
+    byteSize += adjFaces.capacity() * sizeof(uint32_t);
+    std::vector<uint32_t>{}.swap(adjFaces);
+  }
+  uploadDataReleased_ = true;
+  return byteSize;
+}
+
 PTexMeshData::RenderingBuffer* PTexMeshData::getRenderingBuffer(int submeshID) {
   CORRADE_ASSERT(submeshID >= 0 && submeshID < renderingBuffers_.size(),
                  "PTexMeshData::getRenderingBuffer: the submesh ID"
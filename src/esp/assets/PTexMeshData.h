@@ -35,6 +35,9 @@ class PTexMeshData : public BaseMesh {
     Magnum::GL::Buffer indexBuffer;
     Magnum::GL::Buffer adjFacesBuffer;
     Magnum::GL::BufferTexture adjFacesBufferTexture;
+    // views of vertexBuffer and indexBuffer for vertex pulling
+    Magnum::GL::BufferTexture vertexBufferTexture;
+    Magnum::GL::BufferTexture indexBufferTexture;
 
     RenderingBuffer()
         : adjFacesBuffer{Magnum::GL::Buffer::TargetHint::Texture} {}
@@ -62,6 +65,28 @@ class PTexMeshData : public BaseMesh {
   virtual void uploadBuffersToGPU(bool forceReload = false) override;
   virtual Magnum::GL::Mesh* getMagnumGLMesh(int submeshID) override;
 
+  /**
+   * @brief Free the normals, colors, indices and adjacency of the submeshes
+   * once uploaded
+   *
+   * The positions stay for bounds. An upload needed afterwards, e.g. with
+   * @p forceReload or after @ref setVertexPulling(), loads them again from
+   * the cache file next to the mesh.
+   */
+  virtual size_t releaseUploadData() override;
+
+  /**
+   * @brief Set whether the submeshes are uploaded for vertex pulling
+   *
+   * The meshes then have no attributes and are drawn as two triangles per
+   * quad with @ref gfx::PTexMeshShader::Flag::VertexPulling, which reads the
+   * positions from @ref RenderingBuffer::vertexBufferTexture and
+   * @ref RenderingBuffer::indexBufferTexture. Takes effect on the next
+   * @ref uploadBuffersToGPU().
+   */
+  void setVertexPulling(bool vertexPulling);
+  bool vertexPulling() const { return vertexPulling_; }
+
   float exposure() const;
   void setExposure(float val);
 
@@ -88,12 +113,19 @@ class PTexMeshData : public BaseMesh {
   float saturation_ = 1.5f;
 
   std::string atlasFolder_;
+  // file passed to load(), to load the submeshes again after
+  // releaseUploadData()
+  std::string meshFile_;
   std::vector<MeshData> submeshes_;
+  // packed adjacent face and rotation of every quad edge, see
+  // calculateAdjacency()
+  std::vector<std::vector<uint32_t>> adjFaces_;
 
   // ==== rendering ====
   // we will have to use smart pointer here since each item within the structure
   // (e.g., Magnum::GL::Mesh) does NOT have copy constructor
   std::vector<std::unique_ptr<RenderingBuffer>> renderingBuffers_;
+  bool vertexPulling_ = false;
 };
 
 }  // namespace assets
@@ -0,0 +1,163 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PrefetchedImporter.h"
+
+#include <utility>
+
+#include <Corrade/Containers/PointerStl.h>
+#include <Magnum/Trade/AbstractMaterialData.h>
+#include <Magnum/Trade/ObjectData3D.h>
+#include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/TextureData.h>
+
+#include "esp/core/esp.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+PrefetchedImporter::PrefetchedImporter()
+#ifndef MAGNUM_BUILD_STATIC
+    : manager_{std::make_unique<Manager>()}
+#else
+    // avoid using plugins that might depend on different library versions
+    : manager_{std::make_unique<Manager>("nonexistent")}
+#endif
+{
+}
+
+PrefetchedImporter::~PrefetchedImporter() = default;
+
+bool PrefetchedImporter::prefetch(const std::string& filename, bool images) {
+  importer_ = manager_->loadAndInstantiate("AnySceneImporter");
+  if (!importer_ || !importer_->openFile(filename)) {
+    LOG(ERROR) << "Cannot open file " << filename;
+    importer_ = nullptr;
+    return false;
+  }
+
+  meshes_.clear();
+  meshes_.reserve(importer_->meshCount());
+  for (Mn::UnsignedInt iMesh = 0; iMesh != importer_->meshCount(); ++iMesh) {
+    meshes_.emplace_back(importer_->mesh(iMesh));
+  }
+
+  images_.clear();
+  images_.resize(importer_->image2DCount());
+  if (!images) {
+    return true;
+  }
+  for (Mn::UnsignedInt iImage = 0; iImage != images_.size(); ++iImage) {
+    const Mn::UnsignedInt levelCount = importer_->image2DLevelCount(iImage);
+    images_[iImage].reserve(levelCount);
+    for (Mn::UnsignedInt level = 0; level != levelCount; ++level) {
+      images_[iImage].emplace_back(importer_->image2D(iImage, level));
+    }
+  }
+  return true;
+}
+
+Mn::Trade::ImporterFeatures PrefetchedImporter::doFeatures() const {
+  // opening is done by prefetch() only
+  return {};
+}
+
+bool PrefetchedImporter::doIsOpened() const {
+  return importer_ && importer_->isOpened();
+}
+
+void PrefetchedImporter::doClose() {
+  meshes_.clear();
+  images_.clear();
+  importer_ = nullptr;
+}
+
+Mn::Int PrefetchedImporter::doDefaultScene() {
+  return importer_->defaultScene();
+}
+
+Mn::UnsignedInt PrefetchedImporter::doSceneCount() const {
+  return importer_->sceneCount();
+}
+
+Cr::Containers::Optional<Mn::Trade::SceneData> PrefetchedImporter::doScene(
+    Mn::UnsignedInt id) {
+  return importer_->scene(id);
+}
+
+Mn::UnsignedInt PrefetchedImporter::doObject3DCount() const {
+  return importer_->object3DCount();
+}
+
+std::string PrefetchedImporter::doObject3DName(Mn::UnsignedInt id) {
+  return importer_->object3DName(id);
+}
+
+Cr::Containers::Pointer<Mn::Trade::ObjectData3D>
+PrefetchedImporter::doObject3D(Mn::UnsignedInt id) {
+  return importer_->object3D(id);
+}
+
+Mn::UnsignedInt PrefetchedImporter::doMeshCount() const {
+  return importer_->meshCount();
+}
+
+Mn::UnsignedInt PrefetchedImporter::doMeshLevelCount(Mn::UnsignedInt id) {
+  return importer_->meshLevelCount(id);
+}
+
+Cr::Containers::Optional<Mn::Trade::MeshData> PrefetchedImporter::doMesh(
+    Mn::UnsignedInt id,
+    Mn::UnsignedInt level) {
+  if (level == 0 && meshes_[id]) {
+    Cr::Containers::Optional<Mn::Trade::MeshData> mesh = std::move(meshes_[id]);
+    meshes_[id] = Cr::Containers::NullOpt;
+    return mesh;
+  }
+  return importer_->mesh(id, level);
+}
+
+Mn::UnsignedInt PrefetchedImporter::doMaterialCount() const {
+  return importer_->materialCount();
+}
+
+Cr::Containers::Pointer<Mn::Trade::AbstractMaterialData>
+PrefetchedImporter::doMaterial(Mn::UnsignedInt id) {
+  return importer_->material(id);
+}
+
+Mn::UnsignedInt PrefetchedImporter::doTextureCount() const {
+  return importer_->textureCount();
+}
+
+Cr::Containers::Optional<Mn::Trade::TextureData> PrefetchedImporter::doTexture(
+    Mn::UnsignedInt id) {
+  return importer_->texture(id);
+}
+
+Mn::UnsignedInt PrefetchedImporter::doImage2DCount() const {
+  return importer_->image2DCount();
+}
+
+Mn::UnsignedInt PrefetchedImporter::doImage2DLevelCount(Mn::UnsignedInt id) {
+  return importer_->image2DLevelCount(id);
+}
+
+Cr::Containers::Optional<Mn::Trade::ImageData2D> PrefetchedImporter::doImage2D(
+    Mn::UnsignedInt id,
+    Mn::UnsignedInt level) {
+  if (level < images_[id].size() && images_[id][level]) {
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+        std::move(images_[id][level]);
+    images_[id][level] = Cr::Containers::NullOpt;
+    return image;
+  }
+  return importer_->image2D(id, level);
+}
+
+}  // namespace assets
+}  // namespace esp
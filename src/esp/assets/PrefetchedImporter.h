@@ -0,0 +1,111 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::assets::PrefetchedImporter
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief Importer serving meshes and images decoded ahead of time
+ *
+ * @ref prefetch() opens a file and decodes all its meshes and image levels,
+ * and is meant to run on a worker thread, as it doesn't touch any GL state.
+ * Afterwards the importer is handed over to the thread owning the GL context
+ * and used in place of a freshly opened one, so only the GPU upload is left
+ * there. Every decoded mesh and image is handed out once; repeated requests
+ * (e.g. an image shared by several textures) and everything else are
+ * forwarded to the wrapped importer.
+ */
+class PrefetchedImporter : public Magnum::Trade::AbstractImporter {
+ public:
+  /** @brief Plugin manager type */
+  using Manager = Corrade::PluginManager::Manager<AbstractImporter>;
+
+  /**
+   * @brief Constructor
+   *
+   * Creates the plugin manager owned by this importer, configure it through
+   * @ref manager() before calling @ref prefetch().
+   */
+  explicit PrefetchedImporter();
+
+  ~PrefetchedImporter() override;
+
+  /** @brief Plugin manager the wrapped importer is instantiated from */
+  Manager& manager() { return *manager_; }
+
+  /**
+   * @brief Open @p filename and decode all meshes and images
+   * @param filename  File to open
+   * @param images    Whether to decode the images as well. If not, they're
+   *    decoded by the wrapped importer once requested, e.g. because the
+   *    Basis target format isn't known yet.
+   * @return Whether the file could be opened
+   */
+  bool prefetch(const std::string& filename, bool images = true);
+
+ private:
+  Magnum::Trade::ImporterFeatures doFeatures() const override;
+  bool doIsOpened() const override;
+  void doClose() override;
+
+  Magnum::Int doDefaultScene() override;
+  Magnum::UnsignedInt doSceneCount() const override;
+  Corrade::Containers::Optional<Magnum::Trade::SceneData> doScene(
+      Magnum::UnsignedInt id) override;
+
+  Magnum::UnsignedInt doObject3DCount() const override;
+  std::string doObject3DName(Magnum::UnsignedInt id) override;
+  Corrade::Containers::Pointer<Magnum::Trade::ObjectData3D> doObject3D(
+      Magnum::UnsignedInt id) override;
+
+  Magnum::UnsignedInt doMeshCount() const override;
+  Magnum::UnsignedInt doMeshLevelCount(Magnum::UnsignedInt id) override;
+  Corrade::Containers::Optional<Magnum::Trade::MeshData> doMesh(
+      Magnum::UnsignedInt id,
+      Magnum::UnsignedInt level) override;
+
+  Magnum::UnsignedInt doMaterialCount() const override;
+  Corrade::Containers::Pointer<Magnum::Trade::AbstractMaterialData> doMaterial(
+      Magnum::UnsignedInt id) override;
+
+  Magnum::UnsignedInt doTextureCount() const override;
+  Corrade::Containers::Optional<Magnum::Trade::TextureData> doTexture(
+      Magnum::UnsignedInt id) override;
+
+  Magnum::UnsignedInt doImage2DCount() const override;
+  Magnum::UnsignedInt doImage2DLevelCount(Magnum::UnsignedInt id) override;
+  Corrade::Containers::Optional<Magnum::Trade::ImageData2D> doImage2D(
+      Magnum::UnsignedInt id,
+      Magnum::UnsignedInt level) override;
+
+  // declared before importer_, as it has to outlive it
+  std::unique_ptr<Manager> manager_;
+  Corrade::Containers::Pointer<AbstractImporter> importer_;
+
+  // decoded meshes (first level only) and image levels, empty once handed
+  // out
+  std::vector<Corrade::Containers::Optional<Magnum::Trade::MeshData>> meshes_;
+  std::vector<
+      std::vector<Corrade::Containers::Optional<Magnum::Trade::ImageData2D>>>
+      images_;
+};
+
+}  // namespace assets
+}  // namespace esp
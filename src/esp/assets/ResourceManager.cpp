@@ -4,10 +4,20 @@
 
 #include "ResourceManager.h"
 
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/PointerStl.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/PluginManager/PluginMetadata.h>
 #include <Corrade/Utility/Assert.h>
@@ -15,11 +25,16 @@
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Range.h>
@@ -31,13 +46,19 @@
 #include <Magnum/Shaders/Flat.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/MeshObjectData3D.h>
 #include <Magnum/Trade/PhongMaterialData.h>
 #include <Magnum/Trade/SceneData.h>
 #include <Magnum/Trade/TextureData.h>
 
+#include "esp/core/Profiler.h"
 #include "esp/geo/geo.h"
 #include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/InstancedDrawable.h"
+#include "esp/gfx/MultiDrawDrawable.h"
+#include "esp/gfx/PrimitiveIdDrawable.h"
+#include "esp/gfx/PrimitiveIdShader.h"
 #include "esp/io/io.h"
 #include "esp/io/json.h"
 #include "esp/physics/PhysicsManager.h"
@@ -54,6 +75,7 @@
 #include "GenericInstanceMeshData.h"
 #include "GltfMeshData.h"
 #include "MeshData.h"
+#include "PrefetchedImporter.h"
 
 #ifdef ESP_BUILD_PTEX_SUPPORT
 #include "PTexMeshData.h"
@@ -84,6 +106,13 @@ bool ResourceManager::loadScene(
     DrawableGroup* drawables, /* = nullptr */
     const Magnum::ResourceKey& lightSetup /* = Mn::ResourceKey{NO_LIGHT_KEY} */,
     bool splitSemanticMesh /* = true */) {
+  ESP_PROFILE_SCOPE("ResourceManager::loadScene");
+  // nothing is drawn, only the geometry is imported
+  if (cpuOnly_) {
+    parent = nullptr;
+    drawables = nullptr;
+  }
+
   // we only compute absolute AABB for every mesh component when loading ptex
   // mesh, or general mesh (e.g., MP3D)
   staticDrawableInfo_.clear();
@@ -99,7 +128,26 @@ bool ResourceManager::loadScene(
     if (!io::exists(info.filepath)) {
       LOG(ERROR) << "Cannot load from file " << info.filepath;
       meshSuccess = false;
+    } else if (cpuOnly_ && (info.type == AssetType::FRL_PTEX_MESH ||
+                            info.type == AssetType::SUNCG_SCENE)) {
+      LOG(WARNING) << "Skipping " << info.filepath
+                   << ", it has no collision geometry to load without a "
+                      "renderer";
     } else {
+      // loaded for physics and navigation only, it has nothing to draw
+      if (!cpuOnly_ && cpuOnlyAssets_.count(info.filepath) > 0) {
+        cpuOnlyAssets_.erase(info.filepath);
+        if (sceneAssetCache_.count(info.filepath) > 0) {
+          evictSceneAsset(info.filepath);
+        }
+      }
+      if (resourceDict_.count(info.filepath) > 0) {
+        ++sceneAssetCacheStats_.hits;
+      } else {
+        ++sceneAssetCacheStats_.misses;
+        // assets of previous scenes can make room for this one
+        gpuMemoryEvictionAllowed_ = true;
+      }
       if (info.type == AssetType::INSTANCE_MESH) {
         meshSuccess =
             loadInstanceMeshData(info, parent, drawables, splitSemanticMesh);
@@ -113,6 +161,10 @@ bool ResourceManager::loadScene(
         // Unknown type, just load general mesh data
         meshSuccess = loadGeneralMeshData(info, parent, drawables, lightSetup);
       }
+      gpuMemoryEvictionAllowed_ = false;
+      if (meshSuccess && cpuOnly_) {
+        cpuOnlyAssets_.insert(info.filepath);
+      }
       // add a scene attributes for this filename or modify the existing one
       if (meshSuccess) {
         const bool physSceneExists =
@@ -123,6 +175,22 @@ bool ResourceManager::loadScene(
         }
         physicsSceneLibrary_.at(info.filepath)
             ->setRenderMeshHandle(info.filepath);
+
+        // mark as most recently used and in use by the current scene. SUNCG
+        // houses are a collection of object assets and aren't cached
+        auto found = sceneAssetCache_.find(info.filepath);
+        if (found != sceneAssetCache_.end()) {
+          sceneAssetLru_.splice(sceneAssetLru_.begin(), sceneAssetLru_,
+                                found->second.lruPosition);
+          found->second.inUse = true;
+        } else if (resourceDict_.count(info.filepath) > 0) {
+          sceneAssetLru_.push_front(info.filepath);
+          sceneAssetCache_.emplace(
+              info.filepath,
+              SceneAssetCacheEntry{
+                  sceneAssetLru_.begin(),
+                  assetByteSize(resourceDict_.at(info.filepath)), true});
+        }
       }
     }
   } else {
@@ -132,12 +200,16 @@ bool ResourceManager::loadScene(
   }
 
   // once a scene is loaded, we should have a GL::Context so load the primitives
-  Magnum::Trade::MeshData cube = Magnum::Primitives::cubeWireframe();
-  primitive_meshes_.push_back(
-      std::make_unique<Magnum::GL::Mesh>(Magnum::MeshTools::compile(cube)));
+  if (!cpuOnly_) {
+    Magnum::Trade::MeshData cube = Magnum::Primitives::cubeWireframe();
+    primitive_meshes_.push_back(
+        std::make_unique<Magnum::GL::Mesh>(Magnum::MeshTools::compile(cube)));
+  }
 
   // compute the absolute transformation for each static drawables
   if (meshSuccess && parent && computeAbsoluteAABBs_) {
+    ScopedLoadTimer timer{sceneLoadStatistics_,
+                          SceneLoadStatistics::Stage::AbsoluteAABBs};
     if (info.type == AssetType::FRL_PTEX_MESH) {
 #ifdef ESP_BUILD_PTEX_SUPPORT
       // retrieve the ptex mesh data
@@ -167,6 +239,12 @@ bool ResourceManager::loadScene(
     staticDrawableInfo_.clear();
   }
 
+  // after everything reading the meshes while loading
+  if (meshSuccess && releaseUploadData_ && !cpuOnly_ &&
+      resourceDict_.count(info.filepath) > 0) {
+    releaseSceneUploadData(info.filepath);
+  }
+
   return meshSuccess;
 }
 
@@ -228,11 +306,8 @@ bool ResourceManager::loadScene(
   }
 
   // load objects from sceneMetaData list...
-  for (auto objPhysPropertiesFilename :
-       physicsManagerAttributes->getStringGroup("objectLibraryPaths")) {
-    LOG(INFO) << "loading object: " << objPhysPropertiesFilename;
-    parseAndLoadPhysObjTemplate(objPhysPropertiesFilename);
-  }
+  parseAndLoadPhysObjTemplates(
+      physicsManagerAttributes->getStringGroup("objectLibraryPaths"));
   LOG(INFO) << "loaded object templates: "
             << std::to_string(physicsObjTemplateLibrary_.size());
 
@@ -262,11 +337,30 @@ bool ResourceManager::loadScene(
 
   physicsSceneLibrary_.at(info.filepath)->setRenderMeshHandle(info.filepath);
   physicsSceneLibrary_.at(info.filepath)->setCollisionMeshHandle(info.filepath);
+  physicsSceneLibrary_.at(info.filepath)
+      ->setCollisionBvhCacheDirectory(collisionCacheDirectory_);
+  if (physicsManagerAttributes->hasValue("mergeCollisionMeshes")) {
+    physicsSceneLibrary_.at(info.filepath)
+        ->setMergeCollisionMeshes(
+            physicsManagerAttributes->getBool("mergeCollisionMeshes"));
+  }
+  if (physicsManagerAttributes->hasValue("collisionWeldDistance")) {
+    physicsSceneLibrary_.at(info.filepath)
+        ->setCollisionWeldDistance(
+            physicsManagerAttributes->getDouble("collisionWeldDistance"));
+  }
+  if (physicsManagerAttributes->hasValue("collisionChunkSize")) {
+    physicsSceneLibrary_.at(info.filepath)
+        ->setCollisionChunkSize(
+            physicsManagerAttributes->getDouble("collisionChunkSize"));
+  }
 
   //! CONSTRUCT SCENE
   const std::string& filename = info.filepath;
-  // if we have a scene mesh, add it as a collision object
-  if (filename.compare(EMPTY_SCENE) != 0) {
+  // if we have a scene mesh, add it as a collision object. Without a
+  // renderer, assets without collision geometry aren't loaded at all
+  if (filename.compare(EMPTY_SCENE) != 0 &&
+      (!cpuOnly_ || resourceDict_.count(filename) > 0)) {
     const MeshMetaData& metaData = getMeshMetaData(filename);
     auto indexPair = metaData.meshIndex;
     int start = indexPair.first;
@@ -393,6 +487,38 @@ PhysicsManagerAttributes::ptr ResourceManager::loadPhysicsConfig(
     LOG(ERROR) << " Invalid value in scene config - restitution coefficient";
   }
 
+  // optional merging of the static scene collision meshes
+  if (scenePhysicsConfig.HasMember("merge scene collision meshes")) {
+    if (scenePhysicsConfig["merge scene collision meshes"].IsBool()) {
+      physicsManagerAttributes->setBool(
+          "mergeCollisionMeshes",
+          scenePhysicsConfig["merge scene collision meshes"].GetBool());
+    } else {
+      LOG(ERROR)
+          << " Invalid value in scene config - merge scene collision meshes";
+    }
+  }
+  if (scenePhysicsConfig.HasMember("scene collision weld distance")) {
+    if (scenePhysicsConfig["scene collision weld distance"].IsNumber()) {
+      physicsManagerAttributes->setDouble(
+          "collisionWeldDistance",
+          scenePhysicsConfig["scene collision weld distance"].GetDouble());
+    } else {
+      LOG(ERROR)
+          << " Invalid value in scene config - scene collision weld distance";
+    }
+  }
+  if (scenePhysicsConfig.HasMember("scene collision chunk size")) {
+    if (scenePhysicsConfig["scene collision chunk size"].IsNumber()) {
+      physicsManagerAttributes->setDouble(
+          "collisionChunkSize",
+          scenePhysicsConfig["scene collision chunk size"].GetDouble());
+    } else {
+      LOG(ERROR)
+          << " Invalid value in scene config - scene collision chunk size";
+    }
+  }
+
   // load gravity
   if (scenePhysicsConfig.HasMember("gravity")) {
     if (scenePhysicsConfig["gravity"].IsArray()) {
@@ -453,17 +579,19 @@ void ResourceManager::addObjectToDrawables(int objTemplateLibID,
     const std::string& objPhysConfigFilename =
         physicsObjTmpltLibByID_.at(objTemplateLibID);
 
-    if (parent != nullptr and drawables != nullptr) {
-      //! Add mesh to rendering stack
+    // Meta data and collision mesh
+    PhysicsObjectAttributes::ptr physicsObjectAttributes =
+        physicsObjTemplateLibrary_.at(objPhysConfigFilename);
+    const std::string& filename =
+        physicsObjectAttributes->getRenderMeshHandle();
 
-      // Meta data and collision mesh
-      PhysicsObjectAttributes::ptr physicsObjectAttributes =
-          physicsObjTemplateLibrary_.at(objPhysConfigFilename);
+    // objects loaded without a renderer have nothing to draw
+    if (parent != nullptr and drawables != nullptr && !cpuOnly_ &&
+        cpuOnlyAssets_.count(filename) == 0) {
+      //! Add mesh to rendering stack
       std::vector<CollisionMeshData> meshGroup = collisionMeshGroups_.at(
           physicsObjectAttributes->getCollisionMeshHandle());
 
-      const std::string& filename =
-          physicsObjectAttributes->getRenderMeshHandle();
       const LoadedAssetData& loadedAssetData = resourceDict_.at(filename);
       if (!isLightSetupCompatible(loadedAssetData, lightSetup)) {
         LOG(WARNING)
@@ -479,8 +607,11 @@ void ResourceManager::addObjectToDrawables(int objTemplateLibID,
       Magnum::Vector3 objectScaling = physicsObjectAttributes->getScale();
       scalingNode.setScaling(objectScaling);
 
+      precompileShaders(loadedAssetData.meshMetaData, lightSetup,
+                        instancedObjectDrawing_);
       addComponent(loadedAssetData.meshMetaData, scalingNode, lightSetup,
-                   drawables, loadedAssetData.meshMetaData.root);
+                   drawables, loadedAssetData.meshMetaData.root,
+                   instancedObjectDrawing_);
     }  // should always be specified, otherwise won't do anything
   }    // else objTemplateID does not exist - shouldn't happen
 }  // addObjectToDrawables
@@ -500,6 +631,36 @@ int ResourceManager::loadObjectTemplate(
   CHECK(physicsObjTemplateLibrary_.count(objectTemplateHandle) == 0);
   CHECK(objectTemplate->hasValue("renderMeshHandle"));
 
+  // add object template ID to physicObjectAttribute
+  int objectTemplateID = physicsObjTemplateLibrary_.size();
+  objectTemplate->setObjectTemplateID(objectTemplateID);
+
+  // cache metaData
+  physicsObjTemplateLibrary_.emplace(objectTemplateHandle, objectTemplate);
+  physicsObjTmpltLibByID_.emplace(objectTemplateID, objectTemplateHandle);
+
+  // the meshes are loaded when the first object is created
+  if (lazyObjectTemplates_) {
+    return objectTemplateID;
+  }
+  if (!loadObjectTemplateAssets(objectTemplateID)) {
+    physicsObjTemplateLibrary_.erase(objectTemplateHandle);
+    physicsObjTmpltLibByID_.erase(objectTemplateID);
+    return ID_UNDEFINED;
+  }
+  return objectTemplateID;
+}
+
+bool ResourceManager::loadObjectTemplateAssets(int objectTemplateID) {
+  const std::string& objectTemplateHandle =
+      physicsObjTmpltLibByID_.at(objectTemplateID);
+  PhysicsObjectAttributes::ptr objectTemplate =
+      physicsObjTemplateLibrary_.at(objectTemplateHandle);
+  if (collisionMeshGroups_.count(objectTemplate->getCollisionMeshHandle()) >
+      0) {
+    return true;
+  }
+
   // load/check_for render and collision mesh metadata
   //! Get render mesh names
   std::string renderMeshFilename = objectTemplate->getRenderMeshHandle();
@@ -541,7 +702,7 @@ int ResourceManager::loadObjectTemplate(
     // both loads or having no mesh will cancel the load.
     LOG(ERROR) << "Failed to load a physical object: no meshes...: "
                << objectTemplateHandle;
-    return ID_UNDEFINED;
+    return false;
   }
 
   // handle one missing mesh
@@ -550,15 +711,7 @@ int ResourceManager::loadObjectTemplate(
   if (!collisionMeshSuccess)
     objectTemplate->setCollisionMeshHandle(renderMeshFilename);
 
-  // add object template ID to physicObjectAttribute
-  int objectTemplateID = physicsObjTemplateLibrary_.size();
-  objectTemplate->setObjectTemplateID(objectTemplateID);
-
-  // cache metaData, collision mesh Group
-  physicsObjTemplateLibrary_.emplace(objectTemplateHandle, objectTemplate);
-
-  physicsObjTmpltLibByID_.emplace(objectTemplateID, objectTemplateHandle);
-
+  // cache collision mesh Group
   const MeshMetaData& meshMetaData =
       getMeshMetaData(objectTemplate->getCollisionMeshHandle());
 
@@ -575,190 +728,337 @@ int ResourceManager::loadObjectTemplate(
   collisionMeshGroups_.emplace(objectTemplate->getCollisionMeshHandle(),
                                meshGroup);
 
-  return objectTemplateID;
+  return true;
 }
 
-// load object from config filename
-int ResourceManager::parseAndLoadPhysObjTemplate(
-    const std::string& objPhysConfigFilename) {
-  // check for duplicate load
-  const bool objTemplateExists =
-      physicsObjTemplateLibrary_.count(objPhysConfigFilename) > 0;
-  if (objTemplateExists) {
-    return physicsObjTemplateLibrary_[objPhysConfigFilename]
-        ->getObjectTemplateID();
-  }
-
-  // 1. parse the config file
-  io::JsonDocument objPhysicsConfig;
-  if (io::exists(objPhysConfigFilename)) {
-    try {
-      objPhysicsConfig = io::parseJsonFile(objPhysConfigFilename);
-    } catch (...) {
-      LOG(ERROR) << "Failed to parse JSON: " << objPhysConfigFilename
-                 << ". Aborting loadObject.";
-      return ID_UNDEFINED;
+namespace {
+
+/**
+ * @brief SAX handler filling a @ref PhysicsObjectAttributes straight from the
+ * tokens of an object config, without building a document first
+ *
+ * Only the top-level members are read, everything nested in members it
+ * doesn't know is skipped.
+ */
+class PhysObjConfigHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          PhysObjConfigHandler> {
+ public:
+  PhysObjConfigHandler(PhysicsObjectAttributes& attributes,
+                       const std::string& configFilename)
+      : attributes_(attributes),
+        configFilename_(configFilename),
+        configDirectory_(
+            configFilename.substr(0, configFilename.find_last_of("/"))) {}
+
+  bool Null() { return value(Value::Other); }
+  bool Bool(bool b) {
+    Value v{Value::Bool};
+    v.boolean = b;
+    return value(v);
+  }
+  bool Int(int i) { return number(i, true); }
+  bool Uint(unsigned u) {
+    return number(u, u <= unsigned(std::numeric_limits<int>::max()));
+  }
+  bool Int64(int64_t i) { return number(double(i), false); }
+  bool Uint64(uint64_t u) { return number(double(u), false); }
+  bool Double(double d) { return number(d, false); }
+  bool String(const char* str, rapidjson::SizeType length, bool) {
+    Value v{Value::String};
+    v.string = str;
+    v.length = length;
+    return value(v);
+  }
+  bool Key(const char* str, rapidjson::SizeType length, bool) {
+    if (depth_ == 1) {
+      key_.assign(str, length);
     }
-  } else {
-    LOG(ERROR) << "File " << objPhysConfigFilename
-               << " does not exist. Aborting loadObject.";
-    return ID_UNDEFINED;
+    return true;
   }
-
-  // 2. construct a physicsObjectMetaData
-  auto physicsObjectAttributes = PhysicsObjectAttributes::create();
-
-  // NOTE: these paths should be relative to the properties file
-  std::string propertiesFileDirectory =
-      objPhysConfigFilename.substr(0, objPhysConfigFilename.find_last_of("/"));
-
-  // 3. load physical properties to override defaults (set in
-  // PhysicsObjectMetaData.h) load the mass
-  if (objPhysicsConfig.HasMember("mass")) {
-    if (objPhysicsConfig["mass"].IsNumber()) {
-      physicsObjectAttributes->setMass(objPhysicsConfig["mass"].GetDouble());
+  bool StartObject() {
+    if (depth_ == 1 || depth_ == 2) {
+      value(Value::Other);
     }
+    ++depth_;
+    return true;
   }
-
-  // optional set bounding box as collision object
-  if (objPhysicsConfig.HasMember("use bounding box for collision")) {
-    if (objPhysicsConfig["use bounding box for collision"].IsBool()) {
-      physicsObjectAttributes->setBoundingBoxCollisions(
-          objPhysicsConfig["use bounding box for collision"].GetBool());
-    }
+  bool EndObject(rapidjson::SizeType) {
+    --depth_;
+    return true;
   }
-
-  // load the center of mass (in the local frame of the object)
-  // if COM is provided, use it for mesh shift
-  if (objPhysicsConfig.HasMember("COM")) {
-    if (objPhysicsConfig["COM"].IsArray()) {
-      Magnum::Vector3 COM;
-      for (rapidjson::SizeType i = 0; i < objPhysicsConfig["COM"].Size(); i++) {
-        if (!objPhysicsConfig["COM"][i].IsNumber()) {
-          // invalid config
-          LOG(ERROR) << " Invalid value in object physics config - COM array";
-          break;
-        } else {
-          COM[i] = objPhysicsConfig["COM"][i].GetDouble();
-        }
+  bool StartArray() {
+    if (depth_ == 1) {
+      if (key_ == "COM" || key_ == "scale" || key_ == "inertia") {
+        vector_ = Magnum::Vector3{};
+        vectorIndex_ = 0;
+        inVector_ = true;
+        vectorValid_ = true;
+      } else {
+        value(Value::Other);
       }
-      physicsObjectAttributes->setCOM(COM);
-      // set a flag which we can find later so we don't override the desired COM
-      // with BB center.
-      physicsObjectAttributes->setBool("COM_provided", true);
+    } else if (depth_ == 2) {
+      value(Value::Other);
     }
+    ++depth_;
+    return true;
   }
-
-  // scaling
-  if (objPhysicsConfig.HasMember("scale")) {
-    if (objPhysicsConfig["scale"].IsArray()) {
-      Magnum::Vector3 scale;
-      for (rapidjson::SizeType i = 0; i < objPhysicsConfig["scale"].Size();
-           i++) {
-        if (!objPhysicsConfig["scale"][i].IsNumber()) {
-          // invalid config
-          LOG(ERROR) << " Invalid value in object physics config - scale array";
-          break;
-        } else {
-          scale[i] = objPhysicsConfig["scale"][i].GetDouble();
-        }
-      }
-      physicsObjectAttributes->setScale(scale);
+  bool EndArray(rapidjson::SizeType) {
+    if (--depth_ == 1 && inVector_) {
+      inVector_ = false;
+      endVector();
     }
+    return true;
   }
 
-  // load the inertia diagonal
-  if (objPhysicsConfig.HasMember("inertia")) {
-    if (objPhysicsConfig["inertia"].IsArray()) {
-      Magnum::Vector3 inertia;
-      for (rapidjson::SizeType i = 0; i < objPhysicsConfig["inertia"].Size();
-           i++) {
-        if (!objPhysicsConfig["inertia"][i].IsNumber()) {
-          // invalid config
-          LOG(ERROR)
-              << " Invalid value in object physics config - inertia array";
-          break;
-        } else {
-          inertia[i] = objPhysicsConfig["inertia"][i].GetDouble();
-        }
-      }
-      physicsObjectAttributes->setInertia(inertia);
+ private:
+  struct Value {
+    enum Type { Bool, Number, String, Other } type;
+    bool boolean = false;
+    double number = 0.0;
+    bool isInt = false;
+    const char* string = nullptr;
+    rapidjson::SizeType length = 0;
+
+    /*implicit*/ Value(Type type) : type{type} {}
+  };
+
+  bool number(double n, bool isInt) {
+    Value v{Value::Number};
+    v.number = n;
+    v.isInt = isInt;
+    return value(v);
+  }
+
+  bool value(const Value& v);
+  void endVector();
+
+  PhysicsObjectAttributes& attributes_;
+  const std::string& configFilename_;
+  // NOTE: mesh paths are relative to the properties file
+  std::string configDirectory_;
+  int depth_ = 0;
+  std::string key_;
+  Magnum::Vector3 vector_;
+  int vectorIndex_ = 0;
+  bool inVector_ = false;
+  bool vectorValid_ = true;
+};
+
+bool PhysObjConfigHandler::value(const Value& v) {
+  if (depth_ == 2 && inVector_) {
+    // elements of a vector, the first invalid one ends it
+    if (!vectorValid_) {
+      return true;
+    }
+    if (v.type != Value::Number) {
+      LOG(ERROR) << " Invalid value in object physics config - " << key_
+                 << " array";
+      vectorValid_ = false;
+    } else if (vectorIndex_ < 3) {
+      vector_[vectorIndex_++] = v.number;
     }
+    return true;
+  }
+  if (depth_ != 1) {
+    return true;
   }
 
-  // load the friction coefficient
-  if (objPhysicsConfig.HasMember("friction coefficient")) {
-    if (objPhysicsConfig["friction coefficient"].IsNumber()) {
-      physicsObjectAttributes->setFrictionCoefficient(
-          objPhysicsConfig["friction coefficient"].GetDouble());
+  const bool isNumber = v.type == Value::Number;
+  const bool isBool = v.type == Value::Bool;
+  if (key_ == "mass") {
+    if (isNumber) {
+      attributes_.setMass(v.number);
+    }
+  } else if (key_ == "use bounding box for collision") {
+    // optional set bounding box as collision object
+    if (isBool) {
+      attributes_.setBoundingBoxCollisions(v.boolean);
+    }
+  } else if (key_ == "friction coefficient") {
+    if (isNumber) {
+      attributes_.setFrictionCoefficient(v.number);
     } else {
       LOG(ERROR)
           << " Invalid value in object physics config - friction coefficient";
     }
-  }
-
-  // load the restitution coefficient
-  if (objPhysicsConfig.HasMember("restitution coefficient")) {
-    if (objPhysicsConfig["restitution coefficient"].IsNumber()) {
-      physicsObjectAttributes->setRestitutionCoefficient(
-          objPhysicsConfig["restitution coefficient"].GetDouble());
+  } else if (key_ == "restitution coefficient") {
+    if (isNumber) {
+      attributes_.setRestitutionCoefficient(v.number);
     } else {
       LOG(ERROR) << " Invalid value in object physics config - restitution "
                     "coefficient";
     }
-  }
-
-  //! Get collision configuration options if specified
-  if (objPhysicsConfig.HasMember("join collision meshes")) {
-    if (objPhysicsConfig["join collision meshes"].IsBool()) {
-      physicsObjectAttributes->setJoinCollisionMeshes(
-          objPhysicsConfig["join collision meshes"].GetBool());
+  } else if (key_ == "join collision meshes") {
+    //! Get collision configuration options if specified
+    if (isBool) {
+      attributes_.setJoinCollisionMeshes(v.boolean);
     } else {
       LOG(ERROR)
           << " Invalid value in object physics config - join collision meshes";
     }
-  }
-
-  // if object will be flat or phong shaded
-  if (objPhysicsConfig.HasMember("requires lighting")) {
-    if (objPhysicsConfig["requires lighting"].IsBool()) {
-      physicsObjectAttributes->setRequiresLighting(
-          objPhysicsConfig["requires lighting"].GetBool());
+  } else if (key_ == "collision group") {
+    // optional broadphase collision filtering
+    if (isNumber && v.isInt) {
+      attributes_.setCollisionGroup(int(v.number));
+    } else {
+      LOG(ERROR) << " Invalid value in object physics config - collision group";
+    }
+  } else if (key_ == "collision mask") {
+    if (isNumber && v.isInt) {
+      attributes_.setCollisionMask(int(v.number));
+    } else {
+      LOG(ERROR) << " Invalid value in object physics config - collision mask";
+    }
+  } else if (key_ == "use collision hull cache") {
+    // optionally cache the collision hulls next to the config file
+    if (isBool) {
+      if (v.boolean) {
+        attributes_.setCollisionHullCache(
+            Cr::Utility::Directory::splitExtension(configFilename_).first +
+            ".hulls");
+      }
+    } else {
+      LOG(ERROR) << " Invalid value in object physics config - use collision "
+                    "hull cache";
+    }
+  } else if (key_ == "requires lighting") {
+    // if object will be flat or phong shaded
+    if (isBool) {
+      attributes_.setRequiresLighting(v.boolean);
     } else {
       LOG(ERROR)
           << " Invalid value in object physics config - requires lighting";
     }
-  }
-
-  // 4. parse render and collision mesh filepaths
-  std::string renderMeshFilename = "";
-  std::string collisionMeshFilename = "";
-
-  if (objPhysicsConfig.HasMember("render mesh")) {
-    if (objPhysicsConfig["render mesh"].IsString()) {
-      renderMeshFilename = Cr::Utility::Directory::join(
-          propertiesFileDirectory, objPhysicsConfig["render mesh"].GetString());
+  } else if (key_ == "render mesh") {
+    if (v.type == Value::String) {
+      attributes_.setRenderMeshHandle(Cr::Utility::Directory::join(
+          configDirectory_, std::string{v.string, v.length}));
     } else {
       LOG(ERROR) << " Invalid value in object physics config - render mesh";
     }
-  }
-  if (objPhysicsConfig.HasMember("collision mesh")) {
-    if (objPhysicsConfig["collision mesh"].IsString()) {
-      collisionMeshFilename = Cr::Utility::Directory::join(
-          propertiesFileDirectory,
-          objPhysicsConfig["collision mesh"].GetString());
+  } else if (key_ == "collision mesh") {
+    if (v.type == Value::String) {
+      attributes_.setCollisionMeshHandle(Cr::Utility::Directory::join(
+          configDirectory_, std::string{v.string, v.length}));
     } else {
       LOG(ERROR) << " Invalid value in object physics config - collision mesh";
     }
   }
+  return true;
+}
+
+void PhysObjConfigHandler::endVector() {
+  if (key_ == "COM") {
+    // if COM is provided, use it for mesh shift. Set a flag which we can find
+    // later so we don't override the desired COM with BB center.
+    attributes_.setCOM(vector_);
+    attributes_.setBool("COM_provided", true);
+  } else if (key_ == "scale") {
+    attributes_.setScale(vector_);
+  } else if (key_ == "inertia") {
+    // the inertia diagonal
+    attributes_.setInertia(vector_);
+  }
+}
+
+}  // namespace
+
+PhysicsObjectAttributes::ptr ResourceManager::parsePhysObjTemplate(
+    const std::string& objPhysConfigFilename) {
+  if (!io::exists(objPhysConfigFilename)) {
+    LOG(ERROR) << "File " << objPhysConfigFilename
+               << " does not exist. Aborting loadObject.";
+    return nullptr;
+  }
+  std::string json = Cr::Utility::Directory::readString(objPhysConfigFilename);
+
+  // the defaults are set in PhysicsObjectAttributes, the config overrides
+  // them. Strings are parsed in place, only the mesh paths are copied
+  auto physicsObjectAttributes = PhysicsObjectAttributes::create();
+  PhysObjConfigHandler handler{*physicsObjectAttributes, objPhysConfigFilename};
+  rapidjson::InsituStringStream stream{&json[0]};
+  rapidjson::Reader reader;
+  if (!reader.Parse<rapidjson::kParseInsituFlag>(stream, handler)) {
+    LOG(ERROR) << "Failed to parse JSON: " << objPhysConfigFilename
+               << ", error code " << reader.GetParseErrorCode() << " at "
+               << reader.GetErrorOffset() << ". Aborting loadObject.";
+    return nullptr;
+  }
+  return physicsObjectAttributes;
+}
+
+bool ResourceManager::prefetchObjectTemplate(int objectTemplateID) {
+  PhysicsObjectAttributes::ptr objectTemplate =
+      getPhysicsObjectAttributes(objectTemplateID);
+  if (collisionMeshGroups_.count(objectTemplate->getCollisionMeshHandle()) >
+      0) {
+    return false;
+  }
+  bool prefetching = false;
+  for (const std::string& filename :
+       {objectTemplate->getRenderMeshHandle(),
+        objectTemplate->getCollisionMeshHandle()}) {
+    if (!filename.empty()) {
+      prefetching |=
+          prefetchScene(assets::AssetInfo{AssetType::UNKNOWN, filename});
+    }
+  }
+  return prefetching;
+}
 
-  physicsObjectAttributes->setRenderMeshHandle(renderMeshFilename);
-  physicsObjectAttributes->setCollisionMeshHandle(collisionMeshFilename);
+// load object from config filename
+int ResourceManager::parseAndLoadPhysObjTemplate(
+    const std::string& objPhysConfigFilename) {
+  // check for duplicate load
+  const bool objTemplateExists =
+      physicsObjTemplateLibrary_.count(objPhysConfigFilename) > 0;
+  if (objTemplateExists) {
+    return physicsObjTemplateLibrary_[objPhysConfigFilename]
+        ->getObjectTemplateID();
+  }
 
-  // 5. load the parsed file into the library
+  PhysicsObjectAttributes::ptr physicsObjectAttributes =
+      parsePhysObjTemplate(objPhysConfigFilename);
+  if (!physicsObjectAttributes) {
+    return ID_UNDEFINED;
+  }
   return loadObjectTemplate(physicsObjectAttributes, objPhysConfigFilename);
 }
 
+std::vector<int> ResourceManager::parseAndLoadPhysObjTemplates(
+    const std::vector<std::string>& objPhysConfigFilenames) {
+  // parsing touches nothing but the attributes it creates, so the files are
+  // parsed in parallel and only the mesh loads, which may use GL, are serial
+  std::vector<PhysicsObjectAttributes::ptr> parsed(
+      objPhysConfigFilenames.size());
+  std::vector<char> isNew(objPhysConfigFilenames.size());
+  for (size_t i = 0; i < objPhysConfigFilenames.size(); ++i) {
+    isNew[i] = physicsObjTemplateLibrary_.count(objPhysConfigFilenames[i]) == 0;
+  }
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < int(objPhysConfigFilenames.size()); ++i) {
+    if (isNew[i]) {
+      parsed[i] = parsePhysObjTemplate(objPhysConfigFilenames[i]);
+    }
+  }
+
+  std::vector<int> objectTemplateIDs(objPhysConfigFilenames.size());
+  for (size_t i = 0; i < objPhysConfigFilenames.size(); ++i) {
+    const std::string& filename = objPhysConfigFilenames[i];
+    // also catches files listed twice
+    if (physicsObjTemplateLibrary_.count(filename) > 0) {
+      objectTemplateIDs[i] =
+          physicsObjTemplateLibrary_.at(filename)->getObjectTemplateID();
+    } else if (parsed[i]) {
+      objectTemplateIDs[i] = loadObjectTemplate(parsed[i], filename);
+    } else {
+      objectTemplateIDs[i] = ID_UNDEFINED;
+    }
+  }
+  return objectTemplateIDs;
+}
+
 const std::vector<assets::CollisionMeshData>& ResourceManager::getCollisionMesh(
     const int objectTemplateID) {
   std::string configFile = getObjectConfig(objectTemplateID);
@@ -792,6 +1092,47 @@ std::string ResourceManager::getObjectConfig(const int objectTemplateID) {
   return physicsObjTmpltLibByID_.at(objectTemplateID);
 }
 
+namespace {
+// Bounds of count positions, stored as consecutive xyz floats, after
+// transformation. Plain scalar reductions let the loop vectorize, meshes with
+// many vertices are split across threads as well.
+Mn::Range3D transformedBounds(const Mn::Matrix4& transformation,
+                              const float* positions,
+                              size_t count) {
+  if (!count) {
+    return {};
+  }
+  const Mn::Vector3 c0 = transformation[0].xyz();
+  const Mn::Vector3 c1 = transformation[1].xyz();
+  const Mn::Vector3 c2 = transformation[2].xyz();
+  const Mn::Vector3 t = transformation[3].xyz();
+  float minX = std::numeric_limits<float>::infinity();
+  float minY = minX;
+  float minZ = minX;
+  float maxX = -minX;
+  float maxY = -minX;
+  float maxZ = -minX;
+  const long n = count;
+#pragma omp parallel for simd if (n > 65536) \
+    reduction(min : minX, minY, minZ) reduction(max : maxX, maxY, maxZ)
+  for (long i = 0; i < n; ++i) {
+    const float x = positions[3 * i];
+    const float y = positions[3 * i + 1];
+    const float z = positions[3 * i + 2];
+    const float tx = c0.x() * x + c1.x() * y + c2.x() * z + t.x();
+    const float ty = c0.y() * x + c1.y() * y + c2.y() * z + t.y();
+    const float tz = c0.z() * x + c1.z() * y + c2.z() * z + t.z();
+    minX = std::min(minX, tx);
+    minY = std::min(minY, ty);
+    minZ = std::min(minZ, tz);
+    maxX = std::max(maxX, tx);
+    maxY = std::max(maxY, ty);
+    maxZ = std::max(maxZ, tz);
+  }
+  return {{minX, minY, minZ}, {maxX, maxY, maxZ}};
+}
+}  // namespace
+
 Magnum::Range3D ResourceManager::computeMeshBB(BaseMesh* meshDataGL) {
   CollisionMeshData& meshData = meshDataGL->getCollisionMeshData();
   return Magnum::Range3D{
@@ -811,16 +1152,14 @@ void ResourceManager::computePTexMeshAbsoluteAABBs(BaseMesh& baseMesh) {
   const std::vector<PTexMeshData::MeshData>& submeshes = ptexMeshData.meshes();
 
   for (uint32_t iEntry = 0; iEntry < absTransforms.size(); ++iEntry) {
-    // convert std::vector<vec3f> to std::vector<Mn::Vector3>
     const PTexMeshData::MeshData& submesh =
         submeshes[staticDrawableInfo_[iEntry].meshID];
-    std::vector<Mn::Vector3> pos{submesh.vbo.begin(), submesh.vbo.end()};
-
-    // transform the vertex positions to the world space
-    Mn::MeshTools::transformPointsInPlace(absTransforms[iEntry], pos);
 
     scene::SceneNode& node = staticDrawableInfo_[iEntry].node;
-    node.setAbsoluteAABB(Mn::Range3D{Mn::Math::minmax<Mn::Vector3>(pos)});
+    node.setAbsoluteAABB(transformedBounds(
+        absTransforms[iEntry],
+        reinterpret_cast<const float*>(submesh.vbo.data()),
+        submesh.vbo.size()));
   }
 }
 #endif
@@ -837,25 +1176,39 @@ void ResourceManager::computeGeneralMeshAbsoluteAABBs() {
 
     Corrade::Containers::Optional<Magnum::Trade::MeshData>& meshData =
         meshes_[meshID]->getMeshData();
-    CORRADE_ASSERT(meshData,
+    CORRADE_ASSERT(meshData || meshes_[meshID]->uploadDataReleased(),
                    "ResourceManager::computeGeneralMeshAbsoluteAABBs: the "
                    "empty mesh data", );
 
     // a vector to store the min, max pos for the aabb of every position array
     std::vector<Mn::Vector3> bbPos;
 
+    // released mesh data leaves the positions of the collision mesh, which
+    // are those of the first position array
+    if (!meshData) {
+      const CollisionMeshData& collision =
+          meshes_[meshID]->getCollisionMeshData();
+      const Mn::Range3D bb = transformedBounds(
+          absTransforms[iEntry],
+          reinterpret_cast<const float*>(collision.positions.data()),
+          collision.positions.size());
+      bbPos.push_back(bb.min());
+      bbPos.push_back(bb.max());
+    }
+
     // transform the vertex positions to the world space, compute the aabb for
     // each position array
-    for (uint32_t jArray = 0;
-         jArray < meshData->attributeCount(Mn::Trade::MeshAttribute::Position);
-         ++jArray) {
-      Cr::Containers::Array<Mn::Vector3> pos =
+    const uint32_t arrayCount =
+        meshData ? meshData->attributeCount(Mn::Trade::MeshAttribute::Position)
+                 : 0;
+    for (uint32_t jArray = 0; jArray < arrayCount; ++jArray) {
+      const Cr::Containers::Array<Mn::Vector3> pos =
           meshData->positions3DAsArray(jArray);
-      Mn::MeshTools::transformPointsInPlace(absTransforms[iEntry], pos);
-
-      std::pair<Mn::Vector3, Mn::Vector3> bb = Mn::Math::minmax(pos);
-      bbPos.push_back(std::move(bb.first));
-      bbPos.push_back(std::move(bb.second));
+      const Mn::Range3D bb = transformedBounds(
+          absTransforms[iEntry], reinterpret_cast<const float*>(pos.data()),
+          pos.size());
+      bbPos.push_back(bb.min());
+      bbPos.push_back(bb.max());
     }
 
     // locate the scene node which contains the current drawable
@@ -878,19 +1231,15 @@ void ResourceManager::computeInstanceMeshAbsoluteAABBs() {
   for (size_t iEntry = 0; iEntry < absTransforms.size(); ++iEntry) {
     const uint32_t meshID = staticDrawableInfo_[iEntry].meshID;
 
-    // convert std::vector<vec3f> to std::vector<Mn::Vector3>
     const std::vector<vec3f>& vertexPositions =
         dynamic_cast<GenericInstanceMeshData&>(*meshes_[meshID])
             .getVertexBufferObjectCPU();
-    std::vector<Mn::Vector3> transformedPositions{vertexPositions.begin(),
-                                                  vertexPositions.end()};
-
-    Mn::MeshTools::transformPointsInPlace(absTransforms[iEntry],
-                                          transformedPositions);
 
     scene::SceneNode& node = staticDrawableInfo_[iEntry].node;
-    node.setAbsoluteAABB(
-        Mn::Range3D{Mn::Math::minmax<Mn::Vector3>(transformedPositions)});
+    node.setAbsoluteAABB(transformedBounds(
+        absTransforms[iEntry],
+        reinterpret_cast<const float*>(vertexPositions.data()),
+        vertexPositions.size()));
   }  // iEntry
 }
 
@@ -941,6 +1290,7 @@ void ResourceManager::translateMesh(BaseMesh* meshDataGL,
 bool ResourceManager::loadPTexMeshData(const AssetInfo& info,
                                        scene::SceneNode* parent,
                                        DrawableGroup* drawables) {
+  ESP_PROFILE_SCOPE("ResourceManager::loadPTexMeshData");
 #ifdef ESP_BUILD_PTEX_SUPPORT
   // if this is a new file, load it and add it to the dictionary
   const std::string& filename = info.filepath;
@@ -951,7 +1301,11 @@ bool ResourceManager::loadPTexMeshData(const AssetInfo& info,
     meshes_.emplace_back(std::make_unique<PTexMeshData>());
     int index = meshes_.size() - 1;
     auto* pTexMeshData = dynamic_cast<PTexMeshData*>(meshes_[index].get());
-    pTexMeshData->load(filename, atlasDir);
+    {
+      ScopedLoadTimer timer{sceneLoadStatistics_,
+                            SceneLoadStatistics::Stage::ImporterOpen};
+      pTexMeshData->load(filename, atlasDir);
+    }
 
     // update the dictionary
     auto inserted =
@@ -976,7 +1330,12 @@ bool ResourceManager::loadPTexMeshData(const AssetInfo& info,
     for (int iMesh = start; iMesh <= end; ++iMesh) {
       auto* pTexMeshData = dynamic_cast<PTexMeshData*>(meshes_[iMesh].get());
 
-      pTexMeshData->uploadBuffersToGPU(false);
+      pTexMeshData->setVertexPulling(ptexVertexPulling_);
+      {
+        ScopedLoadTimer timer{sceneLoadStatistics_,
+                              SceneLoadStatistics::Stage::GpuUpload};
+        pTexMeshData->uploadBuffersToGPU(false);
+      }
 
       for (int jSubmesh = 0; jSubmesh < pTexMeshData->getSize(); ++jSubmesh) {
         scene::SceneNode& node = parent->createChild();
@@ -1008,6 +1367,7 @@ bool ResourceManager::loadInstanceMeshData(
     scene::SceneNode* parent,
     DrawableGroup* drawables,
     bool splitSemanticMesh /* = true */) {
+  ESP_PROFILE_SCOPE("ResourceManager::loadInstanceMeshData");
   if (info.type != AssetType::INSTANCE_MESH) {
     LOG(ERROR) << "loadInstanceMeshData only works with INSTANCE_MESH type!";
     return false;
@@ -1027,16 +1387,71 @@ bool ResourceManager::loadInstanceMeshData(
   // if this is a new file, load it and add it to the dictionary, create
   // shaders and add it to the shaderPrograms_
   const std::string& filename = info.filepath;
+  // object IDs per triangle need a shader without a per-vertex attribute for
+  // them, split meshes have one object each anyway
+  bool primitiveObjectIds = false;
+#ifndef MAGNUM_TARGET_GLES
+  primitiveObjectIds = primitiveObjectIds_ && !splitSemanticMesh &&
+                       !cpuOnly_ && gfx::PrimitiveIdShader::isSupported();
+#endif
+  // meshes already uploaded to this context by another instance are reused
+  const std::string gpuKey = GpuAssetRegistry::key(
+      filename,
+      Cr::Utility::formatString(
+          "split={} optimized={} compact={} lods={} primitive ids={}",
+          splitSemanticMesh, optimizeMeshes_, compactMeshLayout_,
+          meshLodLevels_, primitiveObjectIds));
+  if (resourceDict_.count(filename) == 0 && !cpuOnly_) {
+    if (GpuAssetData::ptr gpuData = GpuAssetRegistry::instance().find(gpuKey)) {
+      int meshStart = meshes_.size();
+      int meshEnd = meshStart + gpuData->meshes.size() - 1;
+      MeshMetaData meshMetaData{meshStart, meshEnd};
+      meshMetaData.root.children.resize(gpuData->meshes.size());
+      for (int meshIDLocal = 0; meshIDLocal < gpuData->meshes.size();
+           ++meshIDLocal) {
+        meshMetaData.root.children[meshIDLocal].meshIDLocal = meshIDLocal;
+      }
+      meshes_.insert(meshes_.end(), gpuData->meshes.begin(),
+                     gpuData->meshes.end());
+      gpuAssets_[filename] = std::move(gpuData);
+      resourceDict_.emplace(filename,
+                            LoadedAssetData{info, std::move(meshMetaData)});
+    }
+  }
   if (resourceDict_.count(filename) == 0) {
+    // prefer the baked version written by datatool, which needs no parsing
     std::vector<GenericInstanceMeshData::uptr> instanceMeshes;
-    if (splitSemanticMesh) {
-      instanceMeshes =
-          GenericInstanceMeshData::fromPlySplitByObjectId(*importer, filename);
-    } else {
-      GenericInstanceMeshData::uptr meshData =
-          GenericInstanceMeshData::fromPLY(*importer, filename);
-      if (meshData)
-        instanceMeshes.emplace_back(std::move(meshData));
+    {
+      ScopedLoadTimer timer{sceneLoadStatistics_,
+                            SceneLoadStatistics::Stage::ImporterOpen};
+      // baked files only have object IDs per vertex
+      if (primitiveObjectIds) {
+        GenericInstanceMeshData::uptr meshData =
+            GenericInstanceMeshData::fromPLY(*importer, filename, true);
+        if (meshData) {
+          instanceMeshes.emplace_back(std::move(meshData));
+        } else {
+          LOG(WARNING) << "Cannot read object IDs per triangle from "
+                       << filename << ", falling back to per-vertex IDs";
+        }
+      } else {
+        instanceMeshes = GenericInstanceMeshData::fromBaked(
+            GenericInstanceMeshData::bakedFilename(filename),
+            splitSemanticMesh);
+      }
+      if (!instanceMeshes.empty()) {
+        if (!primitiveObjectIds) {
+          LOG(INFO) << "Loaded baked instance mesh for " << filename;
+        }
+      } else if (splitSemanticMesh) {
+        instanceMeshes = GenericInstanceMeshData::fromPlySplitByObjectId(
+            *importer, filename);
+      } else {
+        GenericInstanceMeshData::uptr meshData =
+            GenericInstanceMeshData::fromPLY(*importer, filename);
+        if (meshData)
+          instanceMeshes.emplace_back(std::move(meshData));
+      }
     }
 
     if (instanceMeshes.empty()) {
@@ -1051,12 +1466,38 @@ bool ResourceManager::loadInstanceMeshData(
 
     for (int meshIDLocal = 0; meshIDLocal < instanceMeshes.size();
          ++meshIDLocal) {
-      instanceMeshes[meshIDLocal]->uploadBuffersToGPU(false);
+      // collisions and navmeshes only need the parsed geometry
+      if (cpuOnly_) {
+        meshes_.emplace_back(std::move(instanceMeshes[meshIDLocal]));
+        meshMetaData.root.children[meshIDLocal].meshIDLocal = meshIDLocal;
+        continue;
+      }
+      {
+        ScopedLoadTimer timer{sceneLoadStatistics_,
+                              SceneLoadStatistics::Stage::Meshes};
+        if (optimizeMeshes_) {
+          instanceMeshes[meshIDLocal]->optimizeMeshData();
+        }
+        instanceMeshes[meshIDLocal]->generateLevelsOfDetail(meshLodLevels_);
+        instanceMeshes[meshIDLocal]->setCompactLayout(compactMeshLayout_);
+      }
+      {
+        ScopedLoadTimer timer{sceneLoadStatistics_,
+                              SceneLoadStatistics::Stage::GpuUpload};
+        instanceMeshes[meshIDLocal]->uploadBuffersToGPU(false);
+      }
       meshes_.emplace_back(std::move(instanceMeshes[meshIDLocal]));
 
       meshMetaData.root.children[meshIDLocal].meshIDLocal = meshIDLocal;
     }
 
+    if (!cpuOnly_) {
+      GpuAssetData::ptr gpuData = GpuAssetData::create();
+      gpuData->meshes.assign(meshes_.begin() + meshStart, meshes_.end());
+      GpuAssetRegistry::instance().add(gpuKey, gpuData);
+      gpuAssets_[filename] = std::move(gpuData);
+    }
+
     // update the dictionary
     resourceDict_.emplace(filename,
                           LoadedAssetData{info, std::move(meshMetaData)});
@@ -1070,9 +1511,35 @@ bool ResourceManager::loadInstanceMeshData(
 
     for (uint32_t iMesh = start; iMesh <= end; ++iMesh) {
       scene::SceneNode& node = parent->createChild();
-      node.addFeature<gfx::GenericDrawable>(
+      GenericInstanceMeshData& instanceMesh =
+          static_cast<GenericInstanceMeshData&>(*meshes_[iMesh]);
+#ifndef MAGNUM_TARGET_GLES
+      if (!instanceMesh.getPrimitiveObjectIdsCPU().empty()) {
+        node.addFeature<gfx::PrimitiveIdDrawable>(
+            *instanceMesh.getMagnumGLMesh(),
+            instanceMesh.getRenderingBuffer()->objectIdTexture, shaderManager_,
+            drawables);
+        if (computeAbsoluteAABBs_) {
+          staticDrawableInfo_.emplace_back(StaticDrawableInfo{node, iMesh});
+        }
+        continue;
+      }
+#endif
+      auto& drawable = node.addFeature<gfx::GenericDrawable>(
           *meshes_[iMesh]->getMagnumGLMesh(), shaderManager_, NO_LIGHT_KEY,
           PER_VERTEX_OBJECT_ID_MATERIAL_KEY, drawables);
+      // expands positions of meshes uploaded in the compact layout
+      drawable.setMeshTransformation(instanceMesh.positionTransformation());
+      for (size_t level = 0; level != instanceMesh.levelOfDetailCount();
+           ++level) {
+        drawable.addLevelOfDetail(
+            *instanceMesh.levelOfDetail(level).getMagnumGLMesh(),
+            instanceMesh.levelOfDetailError(level));
+      }
+      // the camera picks levels of detail by the distance of the bounds
+      if (instanceMesh.levelOfDetailCount() != 0) {
+        node.setMeshBB(computeMeshBB(&instanceMesh));
+      }
 
       if (computeAbsoluteAABBs_) {
         staticDrawableInfo_.emplace_back(StaticDrawableInfo{node, iMesh});
@@ -1083,31 +1550,22 @@ bool ResourceManager::loadInstanceMeshData(
   return true;
 }
 
-bool ResourceManager::loadGeneralMeshData(
-    const AssetInfo& info,
-    scene::SceneNode* parent /* = nullptr */,
-    DrawableGroup* drawables /* = nullptr */,
-    const Mn::ResourceKey& lightSetup) {
-  const std::string& filename = info.filepath;
-  const bool fileIsLoaded = resourceDict_.count(filename) > 0;
-  const bool drawData = parent != nullptr && drawables != nullptr;
-
-#ifndef MAGNUM_BUILD_STATIC
-  Magnum::PluginManager::Manager<Importer> manager;
-#else
-  // avoid using plugins that might depend on different library versions
-  Magnum::PluginManager::Manager<Importer> manager{"nonexistent"};
-#endif
-
-  std::unique_ptr<Importer> importer =
-      manager.loadAndInstantiate("AnySceneImporter");
-
-  // Preferred plugins, Basis target GPU format
+namespace {
+
+/**
+ * @brief Set preferred importer plugins and the GPU format Basis textures get
+ * transcoded to, based on the current GL context
+ *
+ * Without a current context only the preferred plugins are set, the format
+ * has to be set by calling this again once there is one.
+ */
+void configureImporterManager(
+    Mn::PluginManager::Manager<Mn::Trade::AbstractImporter>& manager) {
   manager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
 #ifdef ESP_BUILD_ASSIMP_SUPPORT
   manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
 #endif
-  {
+  if (Mn::GL::Context::hasCurrent()) {
     Cr::PluginManager::PluginMetadata* const metadata =
         manager.metadata("BasisImporter");
     Mn::GL::Context& context = Mn::GL::Context::current();
@@ -1180,38 +1638,366 @@ bool ResourceManager::loadGeneralMeshData(
     }
 #endif
   }
+}
 
-  // Optional File loading
-  if (!fileIsLoaded) {
-    if (!importer->openFile(filename)) {
-      LOG(ERROR) << "Cannot open file " << filename;
-      return false;
+/**
+ * @brief Scene assets parsed by @ref ResourceManager::preloadScene(), shared
+ * by all resource managers of the process
+ */
+struct PreloadedScenes {
+  static PreloadedScenes& instance() {
+    static PreloadedScenes scenes;
+    return scenes;
+  }
+
+  std::mutex mutex;
+  std::map<std::string, std::unique_ptr<PrefetchedImporter>> importers;
+};
+
+// GPU format of a texture made from image, optionally compressed by the
+// driver
+Mn::GL::TextureFormat textureStorageFormat(const Mn::Trade::ImageData2D& image,
+                                           bool compress) {
+  if (image.isCompressed()) {
+    return Mn::GL::textureFormat(image.compressedFormat());
+  } else if (compress && image.format() == Mn::PixelFormat::RGBA8Unorm) {
+    return Mn::GL::TextureFormat::CompressedRGBAS3tcDxt1;
+  } else if (compress && image.format() == Mn::PixelFormat::RGB8Unorm) {
+    return Mn::GL::TextureFormat::CompressedRGBS3tcDxt1;
+  }
+  return Mn::GL::textureFormat(image.format());
+}
+
+#ifndef MAGNUM_TARGET_GLES
+// FNV-1a of the image contents and the format they are compressed to
+uint64_t hashTextureImage(const Mn::Trade::ImageData2D& image,
+                          Mn::GL::TextureFormat format) {
+  uint64_t hash = 14695981039346656037ull;
+  const auto add = [&hash](const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i != size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
     }
-    // if this is a new file, load it and add it to the dictionary
-    LoadedAssetData loadedAssetData{info};
-    loadTextures(*importer, loadedAssetData);
-    loadMaterials(*importer, loadedAssetData);
-    loadMeshes(*importer, loadedAssetData);
-    auto inserted = resourceDict_.emplace(filename, std::move(loadedAssetData));
-    MeshMetaData& meshMetaData = inserted.first->second.meshMetaData;
+  };
+  const Mn::UnsignedInt formats[]{Mn::UnsignedInt(image.format()),
+                                  Mn::UnsignedInt(format)};
+  add(formats, sizeof(formats));
+  add(image.size().data(), sizeof(Mn::Vector2i));
+  add(image.data().data(), image.data().size());
+  return hash;
+}
 
-    // Register magnum mesh
-    if (importer->defaultScene() != -1) {
-      Corrade::Containers::Optional<Magnum::Trade::SceneData> sceneData =
-          importer->scene(importer->defaultScene());
-      if (!sceneData) {
-        LOG(ERROR) << "Cannot load scene, exiting";
-        return false;
-      }
-      for (unsigned int sceneDataID : sceneData->children3D()) {
-        loadMeshHierarchy(*importer, meshMetaData.root, sceneDataID);
-      }
-    } else if (importer->meshCount() && meshes_[meshMetaData.meshIndex.first]) {
-      // no default scene --- standalone OBJ/PLY files, for example
-      // take a wild guess and load the first mesh with the first material
-      // addMeshToDrawables(metaData, *parent, drawables, ID_UNDEFINED, 0, 0);
-      loadMeshHierarchy(*importer, meshMetaData.root, 0);
-    } else {
+struct TextureCacheHeader {
+  int magic;
+  int version;
+  uint64_t contentHash;
+  Mn::UnsignedInt format;
+  Mn::UnsignedInt levelCount;
+};
+constexpr int TEXTURE_CACHE_MAGIC = 'T' << 24 | 'E' << 16 | 'X' << 8 | 'C';
+constexpr int TEXTURE_CACHE_VERSION = 1;
+
+struct TextureCacheLevel {
+  Mn::Vector2i size;
+  uint64_t dataSize;
+};
+
+// false if the file doesn't exist, is invalid or was made from a different
+// image. The texture is only touched if the file is valid.
+bool loadCompressedTexture(const std::string& filename,
+                           uint64_t contentHash,
+                           Mn::GL::TextureFormat format,
+                           Mn::GL::Texture2D& texture,
+                           size_t& byteSize) {
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (!fp) {
+    return false;
+  }
+  TextureCacheHeader header;
+  bool valid = fread(&header, sizeof(header), 1, fp) == 1 &&
+               header.magic == TEXTURE_CACHE_MAGIC &&
+               header.version == TEXTURE_CACHE_VERSION &&
+               header.contentHash == contentHash &&
+               header.format == Mn::UnsignedInt(format) &&
+               header.levelCount != 0;
+  std::vector<TextureCacheLevel> levels(valid ? header.levelCount : 0);
+  std::vector<Cr::Containers::Array<char>> data(levels.size());
+  for (std::size_t i = 0; valid && i != levels.size(); ++i) {
+    valid = fread(&levels[i], sizeof(TextureCacheLevel), 1, fp) == 1;
+    if (!valid) {
+      break;
+    }
+    data[i] = Cr::Containers::Array<char>{Cr::Containers::NoInit,
+                                          std::size_t(levels[i].dataSize)};
+    valid = fread(data[i].data(), 1, data[i].size(), fp) == data[i].size();
+  }
+  fclose(fp);
+  if (!valid) {
+    LOG(WARNING) << "Ignoring invalid or outdated texture cache " << filename;
+    return false;
+  }
+
+  texture.setStorage(levels.size(), format, levels[0].size);
+  byteSize = 0;
+  for (std::size_t i = 0; i != levels.size(); ++i) {
+    texture.setCompressedSubImage(
+        i, {},
+        Mn::CompressedImageView2D{
+            Mn::GL::CompressedPixelFormat(Mn::UnsignedInt(format)),
+            levels[i].size, data[i]});
+    byteSize += data[i].size();
+  }
+  return true;
+}
+
+// Read all levels back from the driver and save them. Returns the
+// compressed size of all levels, also if the file couldn't be written.
+size_t saveCompressedTexture(const std::string& filename,
+                             uint64_t contentHash,
+                             Mn::GL::Texture2D& texture) {
+  const Mn::Vector2i size = texture.imageSize(0);
+  const Mn::UnsignedInt levelCount = Mn::Math::log2(size.max()) + 1;
+  std::vector<Mn::CompressedImage2D> images;
+  images.reserve(levelCount);
+  size_t byteSize = 0;
+  for (Mn::UnsignedInt level = 0; level != levelCount; ++level) {
+    images.push_back(texture.compressedImage(level, Mn::CompressedImage2D{}));
+    byteSize += images.back().data().size();
+  }
+
+  TextureCacheHeader header;
+  header.magic = TEXTURE_CACHE_MAGIC;
+  header.version = TEXTURE_CACHE_VERSION;
+  header.contentHash = contentHash;
+  header.format = Mn::UnsignedInt(texture.imageFormat(0));
+  header.levelCount = levelCount;
+  if (!io::writeFileAtomically(filename, [&](FILE* fp) {
+        fwrite(&header, sizeof(header), 1, fp);
+        for (const Mn::CompressedImage2D& image : images) {
+          const TextureCacheLevel level{image.size(), image.data().size()};
+          fwrite(&level, sizeof(level), 1, fp);
+          fwrite(image.data().data(), 1, image.data().size(), fp);
+        }
+        return true;
+      })) {
+    LOG(WARNING) << "Cannot write texture cache " << filename;
+  }
+  return byteSize;
+}
+#endif
+
+// formats with one byte per channel, which can be averaged directly
+bool isDownscalable(Mn::PixelFormat format) {
+  switch (format) {
+    case Mn::PixelFormat::R8Unorm:
+    case Mn::PixelFormat::RG8Unorm:
+    case Mn::PixelFormat::RGB8Unorm:
+    case Mn::PixelFormat::RGBA8Unorm:
+    case Mn::PixelFormat::R8Srgb:
+    case Mn::PixelFormat::RG8Srgb:
+    case Mn::PixelFormat::RGB8Srgb:
+    case Mn::PixelFormat::RGBA8Srgb:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// halve the image size, averaging 2x2 blocks of pixels
+Mn::Trade::ImageData2D downscaleImage(const Mn::Trade::ImageData2D& image) {
+  const Mn::Vector2i size = Mn::Math::max(image.size() / 2, Mn::Vector2i{1});
+  const std::size_t pixelSize = image.pixelSize();
+  Cr::Containers::Array<char> data{Cr::Containers::NoInit,
+                                   std::size_t(size.product()) * pixelSize};
+  const Cr::Containers::StridedArrayView3D<const char> pixels = image.pixels();
+  for (Mn::Int y = 0; y != size.y(); ++y) {
+    // odd sizes leave out the last row or column
+    const std::size_t y0 = 2 * y;
+    const std::size_t y1 = Mn::Math::min(2 * y + 1, image.size().y() - 1);
+    for (Mn::Int x = 0; x != size.x(); ++x) {
+      const std::size_t x0 = 2 * x;
+      const std::size_t x1 = Mn::Math::min(2 * x + 1, image.size().x() - 1);
+      for (std::size_t c = 0; c != pixelSize; ++c) {
+        const unsigned sum = Mn::UnsignedByte(pixels[y0][x0][c]) +
+                             Mn::UnsignedByte(pixels[y0][x1][c]) +
+                             Mn::UnsignedByte(pixels[y1][x0][c]) +
+                             Mn::UnsignedByte(pixels[y1][x1][c]);
+        data[(y * size.x() + x) * pixelSize + c] = char((sum + 2) / 4);
+      }
+    }
+  }
+  // tightly packed rows
+  return Mn::Trade::ImageData2D{Mn::PixelStorage{}.setAlignment(1),
+                                image.format(), size, std::move(data)};
+}
+
+// the textures getPhongShadedMaterialData() or, without lighting,
+// getFlatShadedMaterialData() take from material
+std::vector<Mn::UnsignedInt> materialTextures(
+    const Mn::Trade::PhongMaterialData& material,
+    bool lighting) {
+  using Flag = Mn::Trade::PhongMaterialData::Flag;
+  std::vector<Mn::UnsignedInt> textures;
+  if (!lighting) {
+    if (material.flags() & Flag::AmbientTexture) {
+      textures.push_back(material.ambientTexture());
+    } else if (material.flags() & Flag::DiffuseTexture) {
+      textures.push_back(material.diffuseTexture());
+    }
+    return textures;
+  }
+  if (material.flags() & Flag::AmbientTexture) {
+    textures.push_back(material.ambientTexture());
+  }
+  if (material.flags() & Flag::DiffuseTexture) {
+    textures.push_back(material.diffuseTexture());
+  }
+  if (material.flags() & Flag::SpecularTexture) {
+    textures.push_back(material.specularTexture());
+  }
+  if (material.flags() & Flag::NormalTexture) {
+    textures.push_back(material.normalTexture());
+  }
+  return textures;
+}
+
+// materials on atlas tiles with equal keys differ only in the tile
+std::string textureTileKey(const gfx::PhongMaterialData& material) {
+  std::string key;
+  for (const Mn::GL::Texture2D* texture :
+       {material.ambientTexture, material.diffuseTexture,
+        material.specularTexture, material.normalTexture}) {
+    key += Cr::Utility::formatString(
+        "{}:", static_cast<unsigned long long>(
+                   reinterpret_cast<std::uintptr_t>(texture)));
+  }
+  for (const Mn::Color4& color : {material.ambientColor, material.diffuseColor,
+                                  material.specularColor}) {
+    key += Cr::Utility::formatString("{:.9}/{:.9}/{:.9}/{:.9}:", color.r(),
+                                     color.g(), color.b(), color.a());
+  }
+  const Mn::Vector2 scaling = material.textureMatrix.scaling();
+  key += Cr::Utility::formatString("{:.9}:{:.9}/{:.9}", material.shininess,
+                                   scaling.x(), scaling.y());
+  return key;
+}
+
+}  // namespace
+
+bool ResourceManager::loadGeneralMeshData(
+    const AssetInfo& info,
+    scene::SceneNode* parent /* = nullptr */,
+    DrawableGroup* drawables /* = nullptr */,
+    const Mn::ResourceKey& lightSetup) {
+  ESP_PROFILE_SCOPE("ResourceManager::loadGeneralMeshData");
+  const std::string& filename = info.filepath;
+  const bool fileIsLoaded = resourceDict_.count(filename) > 0;
+  const bool drawData = parent != nullptr && drawables != nullptr;
+
+  // Optional File loading
+  // a plugin manager has to outlive the importers instantiated from it
+  Cr::Containers::Optional<Mn::PluginManager::Manager<Importer>> manager;
+  std::unique_ptr<Importer> importer;
+  if (!fileIsLoaded) {
+    // meshes and images are already decoded if prefetchScene() was called
+    importer = takePrefetchedScene(filename);
+  }
+  if (!fileIsLoaded && !importer) {
+#ifndef MAGNUM_BUILD_STATIC
+    manager.emplace();
+#else
+    // avoid using plugins that might depend on different library versions
+    manager.emplace("nonexistent");
+#endif
+    configureImporterManager(*manager);
+    importer = manager->loadAndInstantiate("AnySceneImporter");
+    ScopedLoadTimer timer{sceneLoadStatistics_,
+                          SceneLoadStatistics::Stage::ImporterOpen};
+    if (!importer->openFile(filename)) {
+      LOG(ERROR) << "Cannot open file " << filename;
+      return false;
+    }
+  }
+  if (!fileIsLoaded) {
+    // if this is a new file, load it and add it to the dictionary
+    LoadedAssetData loadedAssetData{info};
+    // reuse meshes and textures another instance already uploaded to this
+    // context, only materials and the hierarchy are read from the importer
+    const std::string gpuKey = GpuAssetRegistry::key(
+        filename,
+        Cr::Utility::formatString(
+            "lighting={} compressed={} max size={} optimized={} semantic={} "
+            "atlases={}",
+            info.requiresLighting, compressTextures_, maxTextureSize_,
+            optimizeMeshes_, info.semanticMeshFilepath, textureAtlases_));
+    GpuAssetData::ptr gpuData =
+        cpuOnly_ ? nullptr : GpuAssetRegistry::instance().find(gpuKey);
+    const bool meshesReused = gpuData != nullptr;
+    // without a renderer the meshes are only needed for collisions
+    std::vector<AtlasCandidate> atlasCandidates;
+    if (!cpuOnly_) {
+      ScopedLoadTimer timer{sceneLoadStatistics_,
+                            SceneLoadStatistics::Stage::Textures};
+      loadTextures(*importer, loadedAssetData, gpuData.get(),
+                   textureAtlases_ ? &atlasCandidates : nullptr);
+    }
+    // times its meshes and their upload separately
+    loadMeshes(*importer, loadedAssetData, gpuData.get());
+    // the tiles depend on the texture coordinates of the meshes and the
+    // materials on the tiles
+    if (!atlasCandidates.empty()) {
+      ScopedLoadTimer timer{sceneLoadStatistics_,
+                            SceneLoadStatistics::Stage::Textures};
+      packTextureAtlases(*importer, loadedAssetData, atlasCandidates);
+    }
+    if (!cpuOnly_) {
+      ScopedLoadTimer timer{sceneLoadStatistics_,
+                            SceneLoadStatistics::Stage::Materials};
+      loadMaterials(*importer, loadedAssetData);
+    }
+    if (!gpuData && !cpuOnly_) {
+      const MeshMetaData& metaData = loadedAssetData.meshMetaData;
+      gpuData = GpuAssetData::create();
+      gpuData->meshes.assign(meshes_.begin() + metaData.meshIndex.first,
+                             meshes_.begin() + metaData.meshIndex.second + 1);
+      gpuData->textures.assign(
+          textures_.begin() + metaData.textureIndex.first,
+          textures_.begin() + metaData.textureIndex.second + 1);
+      gpuData->textureByteSizes.assign(
+          textureByteSizes_.begin() + metaData.textureIndex.first,
+          textureByteSizes_.begin() + metaData.textureIndex.second + 1);
+      gpuData->textureTransforms.assign(
+          textureTransforms_.begin() + metaData.textureIndex.first,
+          textureTransforms_.begin() + metaData.textureIndex.second + 1);
+      GpuAssetRegistry::instance().add(gpuKey, gpuData);
+    }
+    if (gpuData) {
+      gpuAssets_[filename] = std::move(gpuData);
+    } else {
+      cpuOnlyAssets_.insert(filename);
+    }
+    auto inserted = resourceDict_.emplace(filename, std::move(loadedAssetData));
+    MeshMetaData& meshMetaData = inserted.first->second.meshMetaData;
+
+    // Register magnum mesh
+    ScopedLoadTimer timer{sceneLoadStatistics_,
+                          SceneLoadStatistics::Stage::MeshHierarchy};
+    if (importer->defaultScene() != -1) {
+      Corrade::Containers::Optional<Magnum::Trade::SceneData> sceneData =
+          importer->scene(importer->defaultScene());
+      if (!sceneData) {
+        LOG(ERROR) << "Cannot load scene, exiting";
+        return false;
+      }
+      for (unsigned int sceneDataID : sceneData->children3D()) {
+        loadMeshHierarchy(*importer, meshMetaData.root, sceneDataID);
+      }
+    } else if (importer->meshCount() && meshes_[meshMetaData.meshIndex.first]) {
+      // no default scene --- standalone OBJ/PLY files, for example
+      // take a wild guess and load the first mesh with the first material
+      // addMeshToDrawables(metaData, *parent, drawables, ID_UNDEFINED, 0, 0);
+      loadMeshHierarchy(*importer, meshMetaData.root, 0);
+    } else {
       LOG(ERROR) << "No default scene available and no meshes found, exiting";
       return false;
     }
@@ -1221,6 +2007,15 @@ bool ResourceManager::loadGeneralMeshData(
         Magnum::Quaternion(transform).toMatrix(), Magnum::Vector3());
     meshMetaData.root.transformFromLocalToParent =
         R * meshMetaData.root.transformFromLocalToParent;
+
+    // in world space, so after the frame rotation
+    if (!info.semanticMeshFilepath.empty() && !cpuOnly_ &&
+        !transferSemanticIds(info.semanticMeshFilepath, meshMetaData,
+                             meshesReused)) {
+      LOG(WARNING) << "Cannot put the object IDs of "
+                   << info.semanticMeshFilepath << " on " << filename
+                   << ", semantic sensors will see no objects";
+    }
   } else if (resourceDict_[filename].assetInfo != info) {
     // Right now, we only allow for an asset to be loaded with one
     // configuration, since generated mesh data may be invalid for a new
@@ -1259,10 +2054,154 @@ bool ResourceManager::loadGeneralMeshData(
     }
   }  // forceReload
 
+  precompileShaders(meshMetaData, lightSetup,
+                    multiDrawStaticMeshes_ && computeAbsoluteAABBs_);
   addComponent(meshMetaData, newNode, lightSetup, drawables, meshMetaData.root);
   return true;
 }
 
+bool ResourceManager::transferSemanticIds(const std::string& semanticFilename,
+                                          MeshMetaData& metaData,
+                                          bool meshesLoaded) {
+  ESP_PROFILE_SCOPE("ResourceManager::transferSemanticIds");
+  if (!meshesLoaded) {
+    ScopedLoadTimer timer{sceneLoadStatistics_,
+                          SceneLoadStatistics::Stage::Meshes};
+    // the instance mesh is only needed on the CPU and only until the IDs are
+    // transferred
+    GenericInstanceMeshData::uptr semanticMesh;
+    std::vector<GenericInstanceMeshData::uptr> baked =
+        GenericInstanceMeshData::fromBaked(
+            GenericInstanceMeshData::bakedFilename(semanticFilename), false);
+    if (!baked.empty()) {
+      semanticMesh = std::move(baked.front());
+    } else {
+#ifndef MAGNUM_BUILD_STATIC
+      Mn::PluginManager::Manager<Importer> manager;
+#else
+      // avoid using plugins that might depend on different library versions
+      Mn::PluginManager::Manager<Importer> manager{"nonexistent"};
+#endif
+      Cr::Containers::Pointer<Importer> importer =
+          manager.loadAndInstantiate("StanfordImporter");
+      if (importer) {
+        semanticMesh =
+            GenericInstanceMeshData::fromPLY(*importer, semanticFilename);
+      }
+    }
+    if (!semanticMesh || semanticMesh->getVertexBufferObjectCPU().empty()) {
+      return false;
+    }
+    const std::vector<vec3f>& positions =
+        semanticMesh->getVertexBufferObjectCPU();
+    const std::vector<uint16_t>& objectIds =
+        semanticMesh->getObjectIdsBufferObjectCPU();
+    const std::vector<uint32_t>& indices =
+        semanticMesh->getIndexBufferObjectCPU();
+
+    // grid cells of the average edge length, so the closest vertex is almost
+    // always in one of the 27 cells around a point
+    double edgeLengths = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+      edgeLengths += (positions[indices[i]] - positions[indices[i + 1]]).norm();
+      edgeLengths +=
+          (positions[indices[i + 1]] - positions[indices[i + 2]]).norm();
+      edgeLengths += (positions[indices[i + 2]] - positions[indices[i]]).norm();
+    }
+    const float cellSize =
+        indices.empty() ? 0.1f
+                        : std::max(float(edgeLengths / indices.size()), 1e-4f);
+    const auto cellOf = [cellSize](const Mn::Vector3& point) {
+      return Mn::Vector3i{Mn::Math::floor(point / cellSize)};
+    };
+    // 21 bits per coordinate, enough for scenes of kilometers
+    const auto cellKey = [](const Mn::Vector3i& cell) {
+      return (uint64_t(cell.x() & 0x1fffff) << 42) |
+             (uint64_t(cell.y() & 0x1fffff) << 21) |
+             uint64_t(cell.z() & 0x1fffff);
+    };
+    std::unordered_map<uint64_t, std::vector<uint32_t>> grid;
+    for (uint32_t i = 0; i < positions.size(); ++i) {
+      grid[cellKey(cellOf(Mn::Vector3{positions[i]}))].push_back(i);
+    }
+    const auto closestObjectId = [&](const Mn::Vector3& point) {
+      const Mn::Vector3i cell = cellOf(point);
+      float closest = std::numeric_limits<float>::max();
+      uint16_t objectId = 0;
+      for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+          for (int z = -1; z <= 1; ++z) {
+            auto found = grid.find(cellKey(cell + Mn::Vector3i{x, y, z}));
+            if (found == grid.end()) {
+              continue;
+            }
+            for (uint32_t i : found->second) {
+              const float distance = (Mn::Vector3{positions[i]} - point).dot();
+              if (distance < closest) {
+                closest = distance;
+                objectId = objectIds[i];
+              }
+            }
+          }
+        }
+      }
+      return objectId;
+    };
+
+    // meshes referenced by several nodes get the IDs of the first
+    std::vector<bool> transferred(
+        metaData.meshIndex.second - metaData.meshIndex.first + 1, false);
+    std::function<void(const MeshTransformNode&, const Mn::Matrix4&)>
+        transfer = [&](const MeshTransformNode& node,
+                       const Mn::Matrix4& parentTransformation) {
+          const Mn::Matrix4 transformation =
+              parentTransformation * node.transformFromLocalToParent;
+          auto* meshData =
+              node.meshIDLocal == ID_UNDEFINED ||
+                      transferred[node.meshIDLocal]
+                  ? nullptr
+                  : dynamic_cast<GltfMeshData*>(
+                        meshes_[metaData.meshIndex.first + node.meshIDLocal]
+                            .get());
+          if (meshData && meshData->getMeshData()) {
+            transferred[node.meshIDLocal] = true;
+            const Cr::Containers::Array<Mn::Vector3> vertices =
+                meshData->getMeshData()->positions3DAsArray();
+            Cr::Containers::Array<uint16_t> vertexIds{
+                Cr::Containers::NoInit, vertices.size()};
+            for (size_t i = 0; i < vertices.size(); ++i) {
+              vertexIds[i] =
+                  closestObjectId(transformation.transformPoint(vertices[i]));
+            }
+            meshData->setObjectIds(vertexIds);
+            ScopedLoadTimer uploadTimer{sceneLoadStatistics_,
+                                        SceneLoadStatistics::Stage::GpuUpload};
+            meshData->uploadBuffersToGPU(true);
+          }
+          for (const MeshTransformNode& child : node.children) {
+            transfer(child, transformation);
+          }
+        };
+    transfer(metaData.root, Mn::Matrix4{});
+  }
+
+  // the uniform ID gets added to the per-vertex one, drawables of these
+  // materials set it to 0
+  if (metaData.materialIndex.second != ID_UNDEFINED) {
+    for (int iMaterial = metaData.materialIndex.first;
+         iMaterial <= metaData.materialIndex.second; ++iMaterial) {
+      Mn::Resource<gfx::MaterialData, gfx::PhongMaterialData> material =
+          shaderManager_.get<gfx::MaterialData, gfx::PhongMaterialData>(
+              std::to_string(iMaterial));
+      if (material) {
+        material->perVertexObjectId = true;
+      }
+    }
+  }
+  metaData.perVertexObjectIds = true;
+  return true;
+}
+
 int ResourceManager::loadNavMeshVisualization(esp::nav::PathFinder& pathFinder,
                                               scene::SceneNode* parent,
                                               DrawableGroup* drawables) {
@@ -1326,6 +2265,9 @@ void ResourceManager::loadMaterials(Importer& importer,
   int materialStart = nextMaterialID_;
   int materialEnd = materialStart + importer.materialCount() - 1;
   loadedAssetData.meshMetaData.setMaterialIndices(materialStart, materialEnd);
+  // keys of the first material on an atlas tile for each combination of
+  // everything else
+  std::unordered_map<std::string, std::string> tileMaterialKeys;
 
   for (int iMaterial = 0; iMaterial < importer.materialCount(); ++iMaterial) {
     int currentMaterialID = nextMaterialID_++;
@@ -1355,8 +2297,65 @@ void ResourceManager::loadMaterials(Importer& importer,
     }
     // for now, just use unique ID for material key. This may change if we
     // expose materials to user for post-load modification
-    shaderManager_.set(std::to_string(currentMaterialID),
-                       finalMaterial.release());
+    const std::string materialKey = std::to_string(currentMaterialID);
+    const auto& phongMaterial =
+        static_cast<const gfx::PhongMaterialData&>(*finalMaterial);
+    if (phongMaterial.textureTile) {
+      batchMaterialKeys_[materialKey] =
+          tileMaterialKeys.emplace(textureTileKey(phongMaterial), materialKey)
+              .first->second;
+    }
+    shaderManager_.set(materialKey, finalMaterial.release());
+  }
+}
+
+void ResourceManager::precompileShaders(const MeshMetaData& metaData,
+                                        const Mn::ResourceKey& lightSetup,
+                                        bool batched) {
+  ScopedLoadTimer timer{sceneLoadStatistics_,
+                        SceneLoadStatistics::Stage::Shaders};
+  const Mn::UnsignedInt lightCount =
+      shaderManager_.get<gfx::LightSetup>(lightSetup)->size();
+
+  // meshes without a material are drawn with the default one
+  std::vector<std::string> materialKeys{DEFAULT_MATERIAL_KEY};
+  if (metaData.materialIndex.second != ID_UNDEFINED) {
+    for (int iMaterial = metaData.materialIndex.first;
+         iMaterial <= metaData.materialIndex.second; ++iMaterial) {
+      materialKeys.push_back(std::to_string(iMaterial));
+    }
+  }
+
+  for (const std::string& materialKey : materialKeys) {
+    Mn::Resource<gfx::MaterialData, gfx::PhongMaterialData> material =
+        shaderManager_.get<gfx::MaterialData, gfx::PhongMaterialData>(
+            materialKey);
+    if (!material) {
+      continue;
+    }
+    const Mn::Shaders::Phong::Flags flags =
+        gfx::GenericDrawable::materialShaderFlags(*material);
+    // meshes that can't be batched fall back to generic drawables, so batched
+    // assets need both variants
+    std::vector<Mn::Shaders::Phong::Flags> variants{flags};
+    if (batched) {
+      variants.push_back(
+          flags | gfx::InstancedDrawable::instancingShaderFlags(*material));
+    }
+    for (Mn::Shaders::Phong::Flags variant : variants) {
+      const Mn::ResourceKey key =
+          gfx::GenericDrawable::getShaderKey(lightCount, variant);
+      if (std::any_of(
+              precompiledShaders_.begin(), precompiledShaders_.end(),
+              [&key](const Mn::Resource<Mn::GL::AbstractShaderProgram,
+                                        gfx::PhongShader>& shader) {
+                return shader.key() == key;
+              })) {
+        continue;
+      }
+      precompiledShaders_.push_back(
+          gfx::GenericDrawable::getShader(shaderManager_, lightCount, variant));
+    }
   }
 }
 
@@ -1374,12 +2373,16 @@ gfx::PhongMaterialData::uptr ResourceManager::getFlatShadedMaterialData(
   if (material.flags() & Mn::Trade::PhongMaterialData::Flag::AmbientTexture) {
     finalMaterial->ambientTexture =
         textures_[textureBaseIndex + material.ambientTexture()].get();
+    setTextureTile(*finalMaterial,
+                   textureBaseIndex + material.ambientTexture());
   } else if (material.flags() &
              Mn::Trade::PhongMaterialData::Flag::DiffuseTexture) {
     // if we want to force flat shading, but we don't have ambient texture,
     // check for diffuse texture and use that instead
     finalMaterial->ambientTexture =
         textures_[textureBaseIndex + material.diffuseTexture()].get();
+    setTextureTile(*finalMaterial,
+                   textureBaseIndex + material.diffuseTexture());
   } else {
     finalMaterial->ambientColor = material.ambientColor();
   }
@@ -1424,25 +2427,73 @@ gfx::PhongMaterialData::uptr ResourceManager::getPhongShadedMaterialData(
     finalMaterial->normalTexture =
         textures_[textureBaseIndex + material.normalTexture()].get();
   }
+
+  // only materials with a single texture get one on an atlas tile
+  const std::vector<Mn::UnsignedInt> textures =
+      materialTextures(material, true);
+  if (!textures.empty()) {
+    setTextureTile(*finalMaterial, textureBaseIndex + textures.front());
+  }
   return finalMaterial;
 }
 
+void ResourceManager::setTextureTile(gfx::PhongMaterialData& material,
+                                     int textureID) {
+  const Mn::Matrix3& tile = textureTransforms_[textureID];
+  if (tile == Mn::Matrix3{}) {
+    return;
+  }
+  material.textureMatrix = tile * material.textureMatrix;
+  material.textureTile = true;
+  material.textureTileOffset = tile.translation() / tile.scaling();
+}
+
 void ResourceManager::loadMeshes(Importer& importer,
-                                 LoadedAssetData& loadedAssetData) {
+                                 LoadedAssetData& loadedAssetData,
+                                 const GpuAssetData* sharedData) {
   int meshStart = meshes_.size();
   int meshEnd = meshStart + importer.meshCount() - 1;
   loadedAssetData.meshMetaData.setMeshIndices(meshStart, meshEnd);
 
+  if (sharedData) {
+    CHECK_EQ(sharedData->meshes.size(), importer.meshCount());
+    meshes_.insert(meshes_.end(), sharedData->meshes.begin(),
+                   sharedData->meshes.end());
+    return;
+  }
+
   for (int iMesh = 0; iMesh < importer.meshCount(); ++iMesh) {
+    Cr::Containers::Optional<ScopedLoadTimer> timer{
+        Cr::Containers::InPlaceInit, sceneLoadStatistics_,
+        SceneLoadStatistics::Stage::Meshes};
     // don't need normals if we aren't using lighting
     auto gltfMeshData = std::make_unique<GltfMeshData>(
         loadedAssetData.assetInfo.requiresLighting);
-    gltfMeshData->setMeshData(importer, iMesh);
+    gltfMeshData->setMeshData(importer, iMesh, optimizeMeshes_);
 
     // compute the mesh bounding box
     gltfMeshData->BB = computeMeshBB(gltfMeshData.get());
 
-    gltfMeshData->uploadBuffersToGPU(false);
+    if (cpuOnly_) {
+      meshes_.emplace_back(std::move(gltfMeshData));
+      continue;
+    }
+
+    // geometry can't be reduced, just make room for it if possible
+    const Cr::Containers::Optional<Mn::Trade::MeshData>& meshData =
+        gltfMeshData->getMeshData();
+    if (meshData && !reserveGpuMemory(meshData->vertexData().size() +
+                                      meshData->indexData().size())) {
+      LOG(WARNING) << "Mesh " << iMesh << " of "
+                   << loadedAssetData.assetInfo.filepath
+                   << " exceeds the GPU memory budget";
+    }
+    timer.emplace(sceneLoadStatistics_, SceneLoadStatistics::Stage::GpuUpload);
+    if (incrementalMeshUpload_ && gltfMeshData->beginUploadToGPU()) {
+      pendingMeshUploads_.push_back(meshes_.size());
+    } else {
+      gltfMeshData->uploadBuffersToGPU(false);
+    }
     meshes_.emplace_back(std::move(gltfMeshData));
   }
 }
@@ -1482,14 +2533,32 @@ void ResourceManager::loadMeshHierarchy(Importer& importer,
   }
 }
 
-void ResourceManager::loadTextures(Importer& importer,
-                                   LoadedAssetData& loadedAssetData) {
+void ResourceManager::loadTextures(
+    Importer& importer,
+    LoadedAssetData& loadedAssetData,
+    const GpuAssetData* sharedData,
+    std::vector<AtlasCandidate>* atlasCandidates) {
   int textureStart = textures_.size();
   int textureEnd = textureStart + importer.textureCount() - 1;
   loadedAssetData.meshMetaData.setTextureIndices(textureStart, textureEnd);
 
+  if (sharedData) {
+    CHECK_EQ(sharedData->textures.size(), importer.textureCount());
+    textures_.insert(textures_.end(), sharedData->textures.begin(),
+                     sharedData->textures.end());
+    textureByteSizes_.insert(textureByteSizes_.end(),
+                             sharedData->textureByteSizes.begin(),
+                             sharedData->textureByteSizes.end());
+    textureTransforms_.insert(textureTransforms_.end(),
+                              sharedData->textureTransforms.begin(),
+                              sharedData->textureTransforms.end());
+    return;
+  }
+
   for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
     textures_.emplace_back(std::make_shared<Magnum::GL::Texture2D>());
+    textureByteSizes_.emplace_back(0);
+    textureTransforms_.emplace_back();
     auto& currentTexture = textures_.back();
 
     auto textureData = importer.texture(iTexture);
@@ -1510,48 +2579,115 @@ void ResourceManager::loadTextures(Importer& importer,
     // Load all mip levels
     const std::uint32_t levelCount =
         importer.image2DLevelCount(textureData->image());
-    bool generateMipmap = false;
-    for (std::uint32_t level = 0; level != levelCount; ++level) {
-      // TODO:
-      // it seems we have a way to just load the image once in this case,
-      // as long as the image2DName include the full path to the image
-      Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
-          importer.image2D(textureData->image(), level);
+    // TODO:
+    // it seems we have a way to just load the image once in this case,
+    // as long as the image2DName include the full path to the image
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+        importer.image2D(textureData->image(), 0);
+    if (!image) {
+      LOG(ERROR) << "Cannot load texture image, skipping";
+      currentTexture = nullptr;
+      continue;
+    }
+
+    // drop the largest mip levels, or downscale the image if there are none,
+    // until the texture is within the size limit and fits into the GPU
+    // memory budget. The remaining levels add at most a third.
+    std::uint32_t baseLevel = 0;
+    bool downscaled = false;
+    Mn::Vector2i size = image->size();
+    for (size_t byteSize = image->data().size() + image->data().size() / 3;
+         (maxTextureSize_ != 0 && size.max() > maxTextureSize_) ||
+         !reserveGpuMemory(byteSize);
+         byteSize /= 4) {
+      if (baseLevel + 1 < levelCount) {
+        ++baseLevel;
+      } else if (levelCount == 1 && !image->isCompressed() &&
+                 isDownscalable(image->format()) && size.min() > 1) {
+        image = downscaleImage(*image);
+        downscaled = true;
+      } else {
+        LOG(WARNING) << "Texture " << iTexture << " of "
+                     << loadedAssetData.assetInfo.filepath
+                     << " can't be reduced further, exceeding the size limit "
+                        "or the GPU memory budget";
+        break;
+      }
+      size = Mn::Math::max(size / 2, Mn::Vector2i{1});
+    }
+    if (baseLevel != 0) {
+      image = importer.image2D(textureData->image(), baseLevel);
       if (!image) {
         LOG(ERROR) << "Cannot load texture image, skipping";
         currentTexture = nullptr;
-        break;
+        continue;
       }
+    }
+    if (baseLevel != 0 || downscaled) {
+      LOG(INFO) << "Texture " << iTexture << " of "
+                << loadedAssetData.assetInfo.filepath << " reduced to "
+                << image->size().x() << "x" << image->size().y()
+                << " to stay within the size limit and GPU memory budget";
+    }
 
-      Mn::GL::TextureFormat format;
-      if (image->isCompressed()) {
-        format = Mn::GL::textureFormat(image->compressedFormat());
-      } else if (compressTextures_ &&
-                 image->format() == Mn::PixelFormat::RGBA8Unorm) {
-        format = Mn::GL::TextureFormat::CompressedRGBAS3tcDxt1;
-      } else if (compressTextures_ &&
-                 image->format() == Mn::PixelFormat::RGB8Unorm) {
-        format = Mn::GL::TextureFormat::CompressedRGBS3tcDxt1;
-      } else {
-        format = Mn::GL::textureFormat(image->format());
+#ifndef MAGNUM_TARGET_GLES
+    // textures compressed by the driver are read back once and cached on
+    // disk, later loads upload the compressed levels directly
+    std::string cacheFilename;
+    uint64_t cacheHash = 0;
+    if (!textureCacheDirectory_.empty() && levelCount == 1 &&
+        !image->isCompressed() &&
+        textureStorageFormat(*image, compressTextures_) !=
+            textureStorageFormat(*image, false)) {
+      const Mn::GL::TextureFormat format =
+          textureStorageFormat(*image, compressTextures_);
+      cacheHash = hashTextureImage(*image, format);
+      cacheFilename = Cr::Utility::Directory::join(
+          textureCacheDirectory_,
+          Cr::Utility::formatString("{:.16x}.texcache", cacheHash));
+      size_t byteSize = 0;
+      if (loadCompressedTexture(cacheFilename, cacheHash, format, texture,
+                                byteSize)) {
+        textureByteSizes_.back() = byteSize;
+        continue;
       }
+    }
+#endif
+
+    bool generateMipmap = false;
+    for (std::uint32_t level = baseLevel; level != levelCount; ++level) {
+      if (level != baseLevel) {
+        image = importer.image2D(textureData->image(), level);
+        if (!image) {
+          LOG(ERROR) << "Cannot load texture image, skipping";
+          currentTexture = nullptr;
+          break;
+        }
+      }
+
+      const Mn::GL::TextureFormat format =
+          textureStorageFormat(*image, compressTextures_);
 
       // For the very first level, allocate the texture
-      if (level == 0) {
+      const std::uint32_t textureLevel = level - baseLevel;
+      if (textureLevel == 0) {
         // If there is just one level and the image is not compressed, we'll
         // generate mips ourselves
         if (levelCount == 1 && !image->isCompressed()) {
           texture.setStorage(Mn::Math::log2(image->size().max()) + 1, format,
                              image->size());
           generateMipmap = true;
+          // the generated levels add a third
+          textureByteSizes_.back() += image->data().size() / 3;
         } else
-          texture.setStorage(levelCount, format, image->size());
+          texture.setStorage(levelCount - baseLevel, format, image->size());
       }
 
       if (image->isCompressed())
-        texture.setCompressedSubImage(level, {}, *image);
+        texture.setCompressedSubImage(textureLevel, {}, *image);
       else
-        texture.setSubImage(level, {}, *image);
+        texture.setSubImage(textureLevel, {}, *image);
+      textureByteSizes_.back() += image->data().size();
     }
 
     // Mip level loading failed, fail the whole texture
@@ -1561,6 +2697,199 @@ void ResourceManager::loadTextures(Importer& importer,
     // Generate a mipmap if requested
     if (generateMipmap)
       texture.generateMipmap();
+
+    // the atlas generates the mip levels of its tiles, which only line up
+    // with the texels of the coarser levels for power-of-two sizes
+    const Mn::Vector2i imageSize = image->size();
+    const Mn::GL::TextureFormat format = textureStorageFormat(*image, false);
+    if (atlasCandidates && generateMipmap &&
+        format == textureStorageFormat(*image, compressTextures_) &&
+        (imageSize.x() & (imageSize.x() - 1)) == 0 &&
+        (imageSize.y() & (imageSize.y() - 1)) == 0) {
+      atlasCandidates->push_back({textureStart + iTexture, imageSize, format,
+                                  textureData->magnificationFilter(),
+                                  textureData->minificationFilter(),
+                                  textureData->mipmapFilter()});
+    }
+
+#ifndef MAGNUM_TARGET_GLES
+    if (!cacheFilename.empty()) {
+      const size_t byteSize =
+          saveCompressedTexture(cacheFilename, cacheHash, texture);
+      if (byteSize != 0) {
+        textureByteSizes_.back() = byteSize;
+      }
+    }
+#endif
+  }
+}
+
+void ResourceManager::packTextureAtlases(
+    Importer& importer,
+    const LoadedAssetData& loadedAssetData,
+    const std::vector<AtlasCandidate>& candidates) {
+  const MeshMetaData& metaData = loadedAssetData.meshMetaData;
+
+  // a tile can't repeat, so its meshes have to keep the texture coordinates
+  // within [0, 1]
+  const Mn::Float epsilon = 1.0e-3f;
+  std::vector<bool> meshInUnitRange(importer.meshCount(), false);
+  for (Mn::UnsignedInt iMesh = 0; iMesh < importer.meshCount(); ++iMesh) {
+    const std::shared_ptr<BaseMesh>& mesh =
+        meshes_[metaData.meshIndex.first + iMesh];
+    if (!mesh || !mesh->getMeshData() ||
+        !mesh->getMeshData()->hasAttribute(
+            Mn::Trade::MeshAttribute::TextureCoordinates)) {
+      continue;
+    }
+    const Cr::Containers::Array<Mn::Vector2> textureCoordinates =
+        mesh->getMeshData()->textureCoordinates2DAsArray();
+    meshInUnitRange[iMesh] = std::all_of(
+        textureCoordinates.begin(), textureCoordinates.end(),
+        [epsilon](const Mn::Vector2& coordinates) {
+          return coordinates.min() >= -epsilon &&
+                 coordinates.max() <= 1.0f + epsilon;
+        });
+  }
+  std::vector<bool> materialInUnitRange(importer.materialCount(), true);
+  for (Mn::UnsignedInt iObject = 0; iObject < importer.object3DCount();
+       ++iObject) {
+    std::unique_ptr<Mn::Trade::ObjectData3D> objectData =
+        importer.object3D(iObject);
+    if (!objectData ||
+        objectData->instanceType() != Mn::Trade::ObjectInstanceType3D::Mesh ||
+        objectData->instance() == ID_UNDEFINED) {
+      continue;
+    }
+    const Mn::Int material =
+        static_cast<Mn::Trade::MeshObjectData3D&>(*objectData).material();
+    const Mn::Int mesh = objectData->instance();
+    if (material != ID_UNDEFINED &&
+        std::size_t(material) < materialInUnitRange.size() &&
+        (std::size_t(mesh) >= meshInUnitRange.size() ||
+         !meshInUnitRange[mesh])) {
+      materialInUnitRange[material] = false;
+    }
+  }
+
+  // the material matrix has to stay the same for all textures of a
+  // material, so only materials with one texture can have it on a tile
+  std::vector<bool> packable(importer.textureCount(), true);
+  for (Mn::UnsignedInt iMaterial = 0; iMaterial < importer.materialCount();
+       ++iMaterial) {
+    std::unique_ptr<Mn::Trade::AbstractMaterialData> materialData =
+        importer.material(iMaterial);
+    if (!materialData ||
+        materialData->type() != Mn::Trade::MaterialType::Phong) {
+      continue;
+    }
+    const auto& material =
+        static_cast<Mn::Trade::PhongMaterialData&>(*materialData);
+    const bool lighting = loadedAssetData.assetInfo.requiresLighting;
+    const std::vector<Mn::UnsignedInt> textures =
+        materialTextures(material, lighting);
+    const bool tileable =
+        materialInUnitRange[iMaterial] &&
+        (!lighting || material.textureMatrix() == Mn::Matrix3{}) &&
+        std::all_of(textures.begin(), textures.end(),
+                    [&textures](Mn::UnsignedInt texture) {
+                      return texture == textures.front();
+                    });
+    for (const Mn::UnsignedInt texture : textures) {
+      if (!tileable && texture < packable.size()) {
+        packable[texture] = false;
+      }
+    }
+  }
+
+  // textures sharing an atlas need the same size, format and sampling
+  std::map<std::string, std::vector<const AtlasCandidate*>> groups;
+  for (const AtlasCandidate& candidate : candidates) {
+    if (!packable[candidate.textureID - metaData.textureIndex.first]) {
+      continue;
+    }
+    groups[Cr::Utility::formatString(
+               "{}x{}:{}:{}:{}:{}", candidate.size.x(), candidate.size.y(),
+               Mn::UnsignedInt(candidate.format),
+               Mn::UnsignedInt(candidate.magnificationFilter),
+               Mn::UnsignedInt(candidate.minificationFilter),
+               Mn::UnsignedInt(candidate.mipmapFilter))]
+        .push_back(&candidate);
+  }
+
+  const Mn::Vector2i maxSize = Mn::GL::Texture2D::maxSize();
+  for (const auto& group : groups) {
+    const std::vector<const AtlasCandidate*>& members = group.second;
+    const AtlasCandidate& first = *members.front();
+    const Mn::Vector2i tileSize = first.size;
+    const Mn::Vector2i maxTiles = maxSize / tileSize;
+    const std::size_t capacity = maxTiles.product();
+    if (capacity < 2) {
+      continue;
+    }
+    for (std::size_t begin = 0; begin + 1 < members.size();
+         begin += capacity) {
+      // as square as the size limit allows
+      const int count = std::min(members.size() - begin, capacity);
+      int columns = std::min(int(std::ceil(std::sqrt(float(count)))),
+                             maxTiles.x());
+      if ((count + columns - 1) / columns > maxTiles.y()) {
+        columns = (count + maxTiles.y() - 1) / maxTiles.y();
+      }
+      const int rows = (count + columns - 1) / columns;
+      const Mn::Vector2i atlasSize = tileSize * Mn::Vector2i{columns, rows};
+
+      // coarser levels than the tile size would blend neighboring tiles
+      auto atlas = std::make_shared<Mn::GL::Texture2D>();
+      atlas->setMagnificationFilter(first.magnificationFilter)
+          .setMinificationFilter(first.minificationFilter, first.mipmapFilter)
+          .setWrapping(Mn::SamplerWrapping::ClampToEdge)
+          .setStorage(Mn::Math::log2(tileSize.min()) + 1, first.format,
+                      atlasSize);
+      bool copied = true;
+      for (int i = 0; i != count && copied; ++i) {
+        Mn::GL::Framebuffer framebuffer{{{}, tileSize}};
+        framebuffer
+            .attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
+                           *textures_[members[begin + i]->textureID], 0)
+            .mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+        copied = framebuffer.checkStatus(Mn::GL::FramebufferTarget::Read) ==
+                 Mn::GL::Framebuffer::Status::Complete;
+        if (copied) {
+          framebuffer.copySubImage(
+              {{}, tileSize}, *atlas, 0,
+              tileSize * Mn::Vector2i{i % columns, i / columns});
+        }
+      }
+      if (!copied) {
+        LOG(WARNING) << "Textures of " << loadedAssetData.assetInfo.filepath
+                     << " can't be read from a framebuffer, not packing them "
+                        "into an atlas";
+        break;
+      }
+      atlas->generateMipmap();
+
+      // UVs 0 and 1 are at the centers of the border texels of the tile,
+      // so filtering the base level doesn't reach the neighbors
+      const Mn::Vector2 scaling = (Mn::Vector2{tileSize} - Mn::Vector2{1.0f}) /
+                                  Mn::Vector2{atlasSize};
+      std::size_t byteSize = 0;
+      for (int i = 0; i != count; ++i) {
+        const int textureID = members[begin + i]->textureID;
+        const Mn::Vector2i offset =
+            tileSize * Mn::Vector2i{i % columns, i / columns};
+        textures_[textureID] = atlas;
+        textureTransforms_[textureID] =
+            Mn::Matrix3::translation((Mn::Vector2{offset} + Mn::Vector2{0.5f}) /
+                                     Mn::Vector2{atlasSize}) *
+            Mn::Matrix3::scaling(scaling);
+        byteSize += textureByteSizes_[textureID];
+        textureByteSizes_[textureID] = 0;
+      }
+      // accounted to the first tile, empty tiles included
+      textureByteSizes_[members[begin]->textureID] =
+          byteSize / count * columns * rows;
+    }
   }
 }
 
@@ -1571,7 +2900,8 @@ void ResourceManager::addComponent(const MeshMetaData& metaData,
                                    scene::SceneNode& parent,
                                    const Mn::ResourceKey& lightSetup,
                                    DrawableGroup* drawables,
-                                   const MeshTransformNode& meshTransformNode) {
+                                   const MeshTransformNode& meshTransformNode,
+                                   bool instanced /* = false */) {
   // Add the object to the scene and set its transformation
   scene::SceneNode& node = parent.createChild();
   node.MagnumObject::setTransformation(
@@ -1584,7 +2914,7 @@ void ResourceManager::addComponent(const MeshMetaData& metaData,
     const int materialIDLocal = meshTransformNode.materialIDLocal;
     addMeshToDrawables(metaData, node, lightSetup, drawables,
                        meshTransformNode.componentID, meshIDLocal,
-                       materialIDLocal);
+                       materialIDLocal, instanced);
 
     // compute the bounding box for the mesh we are adding
     const int meshID = metaData.meshIndex.first + meshIDLocal;
@@ -1594,7 +2924,7 @@ void ResourceManager::addComponent(const MeshMetaData& metaData,
 
   // Recursively add children
   for (auto& child : meshTransformNode.children) {
-    addComponent(metaData, node, lightSetup, drawables, child);
+    addComponent(metaData, node, lightSetup, drawables, child, instanced);
   }
 }
 
@@ -1604,28 +2934,169 @@ void ResourceManager::addMeshToDrawables(const MeshMetaData& metaData,
                                          DrawableGroup* drawables,
                                          int objectID,
                                          int meshIDLocal,
-                                         int materialIDLocal) {
+                                         int materialIDLocal,
+                                         bool instanced /* = false */) {
   const int meshStart = metaData.meshIndex.first;
   const uint32_t meshID = meshStart + meshIDLocal;
   Magnum::GL::Mesh& mesh = *meshes_[meshID]->getMagnumGLMesh();
 
-  Mn::ResourceKey materialKey;
+  std::string materialKey;
   if (materialIDLocal == ID_UNDEFINED ||
       metaData.materialIndex.second == ID_UNDEFINED) {
-    materialKey = DEFAULT_MATERIAL_KEY;
+    materialKey = metaData.perVertexObjectIds
+                      ? PER_VERTEX_OBJECT_ID_MATERIAL_KEY
+                      : DEFAULT_MATERIAL_KEY;
   } else {
     materialKey =
         std::to_string(metaData.materialIndex.first + materialIDLocal);
   }
 
-  createGenericDrawable(mesh, node, lightSetup, materialKey, drawables,
-                        objectID);
+  bool batched = false;
+  if (instanced) {
+    batched = addInstanceToDrawables(meshID, node, lightSetup, materialKey,
+                                     drawables);
+  } else if (multiDrawStaticMeshes_ && computeAbsoluteAABBs_) {
+    // the parts of the static scene get the absolute AABBs the batch culls
+    // them with
+    batched = addMultiDrawPartToDrawables(meshID, node, lightSetup,
+                                          materialKey, drawables);
+  }
+  if (!batched) {
+    createGenericDrawable(mesh, node, lightSetup, materialKey, drawables,
+                          objectID);
+  }
 
   if (computeAbsoluteAABBs_) {
     staticDrawableInfo_.emplace_back(StaticDrawableInfo{node, meshID});
   }
 }
 
+GltfMeshData* ResourceManager::batchableMeshData(
+    int meshID,
+    const Mn::ResourceKey& lightSetup,
+    const std::string& materialKey,
+    DrawableGroup* drawables) {
+  auto gltfMeshData = dynamic_cast<GltfMeshData*>(meshes_[meshID].get());
+  if (drawables == nullptr || gltfMeshData == nullptr ||
+      !gltfMeshData->getMeshData()) {
+    return nullptr;
+  }
+
+  // per-vertex object IDs use the same shader attribute as per-instance ones
+  Mn::Resource<gfx::MaterialData, gfx::PhongMaterialData> material =
+      shaderManager_.get<gfx::MaterialData, gfx::PhongMaterialData>(
+          materialKey);
+  if (!material || material->perVertexObjectId) {
+    return nullptr;
+  }
+
+  // lights relative to the object can't be placed for each instance
+  Mn::Resource<gfx::LightSetup> lights =
+      shaderManager_.get<gfx::LightSetup>(lightSetup);
+  if (!lights) {
+    return nullptr;
+  }
+  for (const gfx::LightInfo& light : *lights) {
+    if (light.model == gfx::LightPositionModel::OBJECT) {
+      return nullptr;
+    }
+  }
+  return gltfMeshData;
+}
+
+scene::SceneNode& ResourceManager::batchParent(scene::SceneNode& node) {
+  scene::SceneNode* root = &node;
+  while (root->parent() != nullptr && !root->parent()->isScene()) {
+    root = static_cast<scene::SceneNode*>(root->parent());
+  }
+  return *root;
+}
+
+bool ResourceManager::addInstanceToDrawables(int meshID,
+                                             scene::SceneNode& node,
+                                             const Mn::ResourceKey& lightSetup,
+                                             const std::string& materialKey,
+                                             DrawableGroup* drawables) {
+  GltfMeshData* gltfMeshData =
+      batchableMeshData(meshID, lightSetup, materialKey, drawables);
+  if (gltfMeshData == nullptr) {
+    return false;
+  }
+
+  Mn::Vector2 textureOffset;
+  const std::string batchMaterial =
+      batchMaterialKey(materialKey, textureOffset);
+  const std::string batchKey = Cr::Utility::formatString(
+      "{}:{}:{}", meshID, batchMaterial, lightSetup.hexString());
+  gfx::InstancedDrawable* batch = drawables->getInstancedDrawable(batchKey);
+  if (batch == nullptr) {
+    batchParent(node).createChild().addFeature<gfx::InstancedDrawable>(
+        std::make_unique<Mn::GL::Mesh>(gltfMeshData->compileMesh()),
+        shaderManager_, lightSetup, Mn::ResourceKey{batchMaterial}, batchKey,
+        drawables);
+    batch = drawables->getInstancedDrawable(batchKey);
+  }
+  batch->addInstance(node, textureOffset);
+  return true;
+}
+
+bool ResourceManager::addMultiDrawPartToDrawables(
+    int meshID,
+    scene::SceneNode& node,
+    const Mn::ResourceKey& lightSetup,
+    const std::string& materialKey,
+    DrawableGroup* drawables) {
+  if (!gfx::MultiDrawDrawable::isSupported()) {
+    return false;
+  }
+  GltfMeshData* gltfMeshData =
+      batchableMeshData(meshID, lightSetup, materialKey, drawables);
+  if (gltfMeshData == nullptr) {
+    return false;
+  }
+  const Mn::Trade::MeshData& meshData = *gltfMeshData->getMeshData();
+  if (!meshData.isIndexed() ||
+      meshData.primitive() != Mn::MeshPrimitive::Triangles) {
+    return false;
+  }
+
+  // meshes generating normals on compile can't share a batch with ones that
+  // have them, so the flags are part of the key
+  const Mn::MeshTools::CompileFlags compileFlags =
+      gltfMeshData->compileFlags();
+  Mn::Vector2 textureOffset;
+  const std::string batchMaterial =
+      batchMaterialKey(materialKey, textureOffset);
+  const std::string batchKey = Cr::Utility::formatString(
+      "multidraw:{}:{}:{}:{}", gfx::MultiDrawDrawable::layoutKey(meshData),
+      Mn::MeshTools::CompileFlags::UnderlyingType(compileFlags), batchMaterial,
+      lightSetup.hexString());
+  auto batch = dynamic_cast<gfx::MultiDrawDrawable*>(
+      drawables->getInstancedDrawable(batchKey));
+  if (batch == nullptr) {
+    batchParent(node).createChild().addFeature<gfx::MultiDrawDrawable>(
+        compileFlags, shaderManager_, lightSetup,
+        Mn::ResourceKey{batchMaterial}, batchKey, drawables);
+    batch = dynamic_cast<gfx::MultiDrawDrawable*>(
+        drawables->getInstancedDrawable(batchKey));
+  }
+  batch->addPart(node, meshData, textureOffset);
+  return true;
+}
+
+std::string ResourceManager::batchMaterialKey(const std::string& materialKey,
+                                              Mn::Vector2& textureOffset) {
+  auto found = batchMaterialKeys_.find(materialKey);
+  if (found == batchMaterialKeys_.end()) {
+    return materialKey;
+  }
+  Mn::Resource<gfx::MaterialData, gfx::PhongMaterialData> material =
+      shaderManager_.get<gfx::MaterialData, gfx::PhongMaterialData>(
+          materialKey);
+  textureOffset = material->textureTileOffset;
+  return found->second;
+}
+
 void ResourceManager::addPrimitiveToDrawables(int primitiveID,
                                               scene::SceneNode& node,
                                               DrawableGroup* drawables) {
@@ -1768,10 +3239,10 @@ bool ResourceManager::isLightSetupCompatible(
          loadedAssetData.assetInfo.requiresLighting;
 }
 
-//! recursively join all sub-components of a mesh into a single unified
-//! MeshData.
+//! recursively collect all sub-components of a mesh with their
+//! transformations to world space
 void ResourceManager::joinHeirarchy(
-    MeshData& mesh,
+    std::vector<std::pair<CollisionMeshData*, Magnum::Matrix4>>& components,
     const MeshMetaData& metaData,
     const MeshTransformNode& node,
     const Magnum::Matrix4& transformFromParentToWorld) {
@@ -1779,36 +3250,463 @@ void ResourceManager::joinHeirarchy(
       transformFromParentToWorld * node.transformFromLocalToParent;
 
   if (node.meshIDLocal != ID_UNDEFINED) {
-    CollisionMeshData& meshData =
-        meshes_[node.meshIDLocal + metaData.meshIndex.first]
-            ->getCollisionMeshData();
-    int lastIndex = mesh.vbo.size();
-    for (auto& pos : meshData.positions) {
-      mesh.vbo.push_back(Magnum::EigenIntegration::cast<vec3f>(
-          transformFromLocalToWorld.transformPoint(pos)));
-    }
-    for (auto& index : meshData.indices) {
-      mesh.ibo.push_back(index + lastIndex);
-    }
+    components.emplace_back(
+        &meshes_[node.meshIDLocal + metaData.meshIndex.first]
+             ->getCollisionMeshData(),
+        transformFromLocalToWorld);
   }
 
   for (auto& child : node.children) {
-    joinHeirarchy(mesh, metaData, child, transformFromLocalToWorld);
+    joinHeirarchy(components, metaData, child, transformFromLocalToWorld);
   }
 }
 
-std::unique_ptr<MeshData> ResourceManager::createJoinedCollisionMesh(
+void ResourceManager::collectHeirarchyMeshes(
+    std::vector<BaseMesh*>& meshes,
+    const MeshMetaData& metaData,
+    const MeshTransformNode& node) {
+  if (node.meshIDLocal != ID_UNDEFINED) {
+    meshes.push_back(
+        meshes_[node.meshIDLocal + metaData.meshIndex.first].get());
+  }
+  for (auto& child : node.children) {
+    collectHeirarchyMeshes(meshes, metaData, child);
+  }
+}
+
+const MeshData& ResourceManager::getJoinedCollisionMesh(
     const std::string& filename) {
-  std::unique_ptr<MeshData> mesh = std::make_unique<MeshData>();
+  auto found = joinedCollisionMeshes_.find(filename);
+  if (found != joinedCollisionMeshes_.end()) {
+    return *found->second;
+  }
 
   CHECK(resourceDict_.count(filename) > 0);
 
   const MeshMetaData& metaData = getMeshMetaData(filename);
 
+  std::vector<std::pair<CollisionMeshData*, Magnum::Matrix4>> components;
   Magnum::Matrix4 identity;
-  joinHeirarchy(*mesh, metaData, metaData.root, identity);
+  joinHeirarchy(components, metaData, metaData.root, identity);
+
+  MeshData::uptr mesh = MeshData::create_unique();
+  size_t vertexCount = 0;
+  size_t indexCount = 0;
+  for (const auto& component : components) {
+    vertexCount += component.first->positions.size();
+    indexCount += component.first->indices.size();
+  }
+  mesh->vbo.resize(vertexCount);
+  mesh->ibo.resize(indexCount);
+
+  // plain loops over floats so they vectorize, large components are split
+  // across threads as well
+  size_t vertexOffset = 0;
+  size_t indexOffset = 0;
+  for (const auto& component : components) {
+    const CollisionMeshData& meshData = *component.first;
+    const Mn::Matrix4& transformation = component.second;
+    const Mn::Vector3 c0 = transformation[0].xyz();
+    const Mn::Vector3 c1 = transformation[1].xyz();
+    const Mn::Vector3 c2 = transformation[2].xyz();
+    const Mn::Vector3 t = transformation[3].xyz();
+    const float* in =
+        reinterpret_cast<const float*>(meshData.positions.data());
+    float* out = reinterpret_cast<float*>(mesh->vbo.data() + vertexOffset);
+    const long positionCount = meshData.positions.size();
+#pragma omp parallel for simd if (positionCount > 65536)
+    for (long i = 0; i < positionCount; ++i) {
+      const float x = in[3 * i];
+      const float y = in[3 * i + 1];
+      const float z = in[3 * i + 2];
+      out[3 * i] = c0.x() * x + c1.x() * y + c2.x() * z + t.x();
+      out[3 * i + 1] = c0.y() * x + c1.y() * y + c2.y() * z + t.y();
+      out[3 * i + 2] = c0.z() * x + c1.z() * y + c2.z() * z + t.z();
+    }
+
+    const uint32_t* inIndices = meshData.indices.data();
+    uint32_t* outIndices = mesh->ibo.data() + indexOffset;
+    const uint32_t base = vertexOffset;
+    const long componentIndexCount = meshData.indices.size();
+#pragma omp parallel for simd if (componentIndexCount > 65536)
+    for (long i = 0; i < componentIndexCount; ++i) {
+      outIndices[i] = inIndices[i] + base;
+    }
+
+    vertexOffset += meshData.positions.size();
+    indexOffset += meshData.indices.size();
+  }
+
+  return *joinedCollisionMeshes_.emplace(filename, std::move(mesh))
+              .first->second;
+}
 
-  return mesh;
+std::unique_ptr<MeshData> ResourceManager::createJoinedCollisionMesh(
+    const std::string& filename) {
+  return std::make_unique<MeshData>(getJoinedCollisionMesh(filename));
+}
+
+const geo::OccupancyGrid& ResourceManager::getOccupancyGrid(
+    const std::string& filename,
+    float voxelSize) {
+  geo::OccupancyGrid::uptr& grid = occupancyGrids_[filename][voxelSize];
+  if (!grid) {
+    const MeshData& mesh = getJoinedCollisionMesh(filename);
+    grid = geo::OccupancyGrid::create_unique(
+        geo::voxelizeMesh(mesh.vbo, mesh.ibo, voxelSize));
+  }
+  return *grid;
+}
+
+const geo::MeshRayCaster& ResourceManager::getMeshRayCaster(
+    const std::string& filename) {
+  geo::MeshRayCaster::uptr& caster = meshRayCasters_[filename];
+  if (caster) {
+    return *caster;
+  }
+
+  const MeshData& mesh = getJoinedCollisionMesh(filename);
+  const MeshMetaData& metaData = getMeshMetaData(filename);
+  std::vector<BaseMesh*> meshes;
+  collectHeirarchyMeshes(meshes, metaData, metaData.root);
+
+  // the joined triangles are in the order of the components, see
+  // getJoinedCollisionMesh()
+  std::vector<uint32_t> objectIds;
+  objectIds.reserve(mesh.ibo.size() / 3);
+  bool anyObjectIds = false;
+  for (BaseMesh* component : meshes) {
+    auto* instance = dynamic_cast<const GenericInstanceMeshData*>(component);
+    const Cr::Containers::ArrayView<const Mn::UnsignedInt> indices =
+        component->getCollisionMeshData().indices;
+    const size_t triangleCount = indices.size() / 3;
+    if (instance && !instance->getPrimitiveObjectIdsCPU().empty()) {
+      const std::vector<uint32_t>& ids = instance->getPrimitiveObjectIdsCPU();
+      objectIds.insert(objectIds.end(), ids.begin(), ids.end());
+      anyObjectIds = true;
+    } else if (instance && !instance->getObjectIdsBufferObjectCPU().empty()) {
+      // all vertices of a triangle belong to the same object
+      const std::vector<uint16_t>& ids =
+          instance->getObjectIdsBufferObjectCPU();
+      for (size_t i = 0; i < triangleCount; ++i) {
+        objectIds.push_back(ids[indices[3 * i]]);
+      }
+      anyObjectIds = true;
+    } else {
+      objectIds.resize(objectIds.size() + triangleCount, 0);
+    }
+  }
+  if (!anyObjectIds) {
+    objectIds.clear();
+  }
+  caster = geo::MeshRayCaster::create_unique(mesh.vbo, mesh.ibo,
+                                             std::move(objectIds));
+  return *caster;
+}
+
+ResourceManager::SceneAssetCacheStats ResourceManager::sceneAssetCacheStats()
+    const {
+  SceneAssetCacheStats stats = sceneAssetCacheStats_;
+  stats.entries = sceneAssetCache_.size();
+  stats.byteSize = 0;
+  for (const auto& entry : sceneAssetCache_) {
+    stats.byteSize += entry.second.byteSize;
+  }
+  return stats;
+}
+
+void ResourceManager::trimSceneAssetCache() {
+  size_t byteSize = sceneAssetCacheStats().byteSize;
+  // walk from the least recently used end
+  for (auto it = sceneAssetLru_.end(); it != sceneAssetLru_.begin() &&
+                                       sceneAssetCacheBudget_ != 0 &&
+                                       byteSize > sceneAssetCacheBudget_;) {
+    --it;
+    const SceneAssetCacheEntry& entry = sceneAssetCache_.at(*it);
+    if (entry.inUse) {
+      continue;
+    }
+    byteSize -= entry.byteSize;
+    // evictSceneAsset() erases the LRU entry, continue from the next one
+    const std::string filename = *it;
+    it = std::next(it);
+    evictSceneAsset(filename);
+  }
+
+  for (auto& entry : sceneAssetCache_) {
+    entry.second.inUse = false;
+  }
+}
+
+void ResourceManager::touchSceneAsset(const std::string& filepath) {
+  auto found = sceneAssetCache_.find(filepath);
+  if (found != sceneAssetCache_.end()) {
+    sceneAssetLru_.splice(sceneAssetLru_.begin(), sceneAssetLru_,
+                          found->second.lruPosition);
+  }
+}
+
+bool ResourceManager::prefetchScene(const AssetInfo& info) {
+  const std::string& filename = info.filepath;
+  if (info.type != AssetType::MP3D_MESH && info.type != AssetType::UNKNOWN) {
+    LOG(WARNING) << "Cannot prefetch " << filename
+                 << ", only general mesh assets can be prefetched";
+    return false;
+  }
+  if (resourceDict_.count(filename) > 0 ||
+      prefetchedScenes_.count(filename) > 0) {
+    return false;
+  }
+  if (!io::exists(filename)) {
+    LOG(ERROR) << "Cannot prefetch from file " << filename;
+    return false;
+  }
+
+  // the plugin manager is configured here, as the Basis format depends on the
+  // GL context, which the worker thread doesn't have
+  auto importer = std::make_unique<PrefetchedImporter>();
+  configureImporterManager(importer->manager());
+  LOG(INFO) << "Prefetching scene asset " << filename;
+  prefetchedScenes_.emplace(
+      filename,
+      std::async(std::launch::async,
+                 [filename](std::unique_ptr<PrefetchedImporter> importer)
+                     -> std::unique_ptr<Importer> {
+                   if (!importer->prefetch(filename)) {
+                     return nullptr;
+                   }
+                   return std::move(importer);
+                 },
+                 std::move(importer)));
+  return true;
+}
+
+bool ResourceManager::preloadScene(const AssetInfo& info) {
+  const std::string& filename = info.filepath;
+  if (info.type != AssetType::MP3D_MESH && info.type != AssetType::UNKNOWN) {
+    LOG(WARNING) << "Cannot preload " << filename
+                 << ", only general mesh assets can be preloaded";
+    return false;
+  }
+  PreloadedScenes& scenes = PreloadedScenes::instance();
+  {
+    std::lock_guard<std::mutex> lock{scenes.mutex};
+    if (scenes.importers.count(filename) > 0) {
+      return true;
+    }
+  }
+  if (!io::exists(filename)) {
+    LOG(ERROR) << "Cannot preload from file " << filename;
+    return false;
+  }
+
+  // images are left to the wrapped importer, as the format Basis textures get
+  // transcoded to depends on the GL context of the process using them
+  auto importer = std::make_unique<PrefetchedImporter>();
+  configureImporterManager(importer->manager());
+  LOG(INFO) << "Preloading scene asset " << filename;
+  if (!importer->prefetch(filename, false)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock{scenes.mutex};
+  scenes.importers.emplace(filename, std::move(importer));
+  return true;
+}
+
+size_t ResourceManager::preloadedSceneCount() {
+  PreloadedScenes& scenes = PreloadedScenes::instance();
+  std::lock_guard<std::mutex> lock{scenes.mutex};
+  return scenes.importers.size();
+}
+
+void ResourceManager::clearPreloadedScenes() {
+  PreloadedScenes& scenes = PreloadedScenes::instance();
+  std::lock_guard<std::mutex> lock{scenes.mutex};
+  scenes.importers.clear();
+}
+
+std::unique_ptr<ResourceManager::Importer>
+ResourceManager::takePrefetchedScene(const std::string& filename) {
+  auto found = prefetchedScenes_.find(filename);
+  if (found != prefetchedScenes_.end()) {
+    std::unique_ptr<Importer> importer = found->second.get();
+    prefetchedScenes_.erase(found);
+    return importer;
+  }
+
+  // the decoded meshes are handed out once, so the first resource manager of
+  // the process takes the preloaded importer
+  PreloadedScenes& scenes = PreloadedScenes::instance();
+  std::unique_ptr<PrefetchedImporter> importer;
+  {
+    std::lock_guard<std::mutex> lock{scenes.mutex};
+    auto preloaded = scenes.importers.find(filename);
+    if (preloaded == scenes.importers.end()) {
+      return nullptr;
+    }
+    importer = std::move(preloaded->second);
+    scenes.importers.erase(preloaded);
+  }
+  // preloaded without a GL context, pick the Basis format now
+  configureImporterManager(importer->manager());
+  return importer;
+}
+
+size_t ResourceManager::uploadPendingMeshes(size_t byteBudget) {
+  ESP_PROFILE_SCOPE("ResourceManager::uploadPendingMeshes");
+  size_t uploaded = 0;
+  while (!pendingMeshUploads_.empty() && uploaded < byteBudget) {
+    // evicted meshes take their pending upload with them
+    const std::shared_ptr<BaseMesh>& mesh =
+        meshes_[pendingMeshUploads_.front()];
+    if (mesh) {
+      uploaded += mesh->continueUploadToGPU(byteBudget - uploaded);
+    }
+    if (!mesh || !mesh->uploadPending()) {
+      pendingMeshUploads_.pop_front();
+    }
+  }
+  return uploaded;
+}
+
+void ResourceManager::releaseSceneUploadData(const std::string& filename) {
+  const MeshMetaData& metaData = resourceDict_.at(filename).meshMetaData;
+  if (metaData.meshIndex.first == ID_UNDEFINED) {
+    return;
+  }
+  // batches compile the glTF meshes again when objects are added
+  const bool keepGltf = instancedObjectDrawing_ || multiDrawStaticMeshes_;
+  size_t byteSize = 0;
+  for (int i = metaData.meshIndex.first; i <= metaData.meshIndex.second;
+       ++i) {
+    if (!meshes_[i] ||
+        (keepGltf && dynamic_cast<GltfMeshData*>(meshes_[i].get()))) {
+      continue;
+    }
+    byteSize += meshes_[i]->releaseUploadData();
+  }
+  if (byteSize > 0) {
+    LOG(INFO) << "Released " << byteSize << " bytes of mesh data of "
+              << filename << " after upload";
+  }
+}
+
+size_t ResourceManager::assetByteSize(const LoadedAssetData& loadedAssetData) {
+  const MeshMetaData& metaData = loadedAssetData.meshMetaData;
+  size_t byteSize = 0;
+  if (metaData.meshIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.meshIndex.first; i <= metaData.meshIndex.second;
+         ++i) {
+      if (!meshes_[i]) {
+        continue;
+      }
+      const CollisionMeshData& data = meshes_[i]->getCollisionMeshData();
+      // a CPU copy and the GPU buffers
+      byteSize += 2 * (data.positions.size() * sizeof(Magnum::Vector3) +
+                       data.indices.size() * sizeof(Magnum::UnsignedInt));
+    }
+  }
+  if (metaData.textureIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.textureIndex.first; i <= metaData.textureIndex.second;
+         ++i) {
+      byteSize += textureByteSizes_[i];
+    }
+  }
+  return byteSize;
+}
+
+ResourceManager::GpuMemoryUsage ResourceManager::gpuMemoryUsage() const {
+  GpuMemoryUsage usage;
+  for (const auto& mesh : meshes_) {
+    if (mesh) {
+      usage.vertexBytes += mesh->gpuVertexByteSize();
+      usage.indexBytes += mesh->gpuIndexByteSize();
+      usage.textureBytes += mesh->gpuTextureByteSize();
+    }
+  }
+  for (const size_t byteSize : textureByteSizes_) {
+    usage.textureBytes += byteSize;
+  }
+  return usage;
+}
+
+ResourceManager::GpuMemoryUsage ResourceManager::gpuMemoryUsage(
+    const std::string& filename) const {
+  GpuMemoryUsage usage;
+  auto found = resourceDict_.find(filename);
+  if (found == resourceDict_.end()) {
+    return usage;
+  }
+  const MeshMetaData& metaData = found->second.meshMetaData;
+  if (metaData.meshIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.meshIndex.first; i <= metaData.meshIndex.second;
+         ++i) {
+      if (meshes_[i]) {
+        usage.vertexBytes += meshes_[i]->gpuVertexByteSize();
+        usage.indexBytes += meshes_[i]->gpuIndexByteSize();
+        usage.textureBytes += meshes_[i]->gpuTextureByteSize();
+      }
+    }
+  }
+  if (metaData.textureIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.textureIndex.first; i <= metaData.textureIndex.second;
+         ++i) {
+      usage.textureBytes += textureByteSizes_[i];
+    }
+  }
+  return usage;
+}
+
+bool ResourceManager::reserveGpuMemory(size_t bytes) {
+  if (gpuMemoryBudget_ == 0) {
+    return true;
+  }
+  size_t used = gpuMemoryUsage().totalBytes();
+  // walk from the least recently used end, skipping assets of the current
+  // scene
+  for (auto it = sceneAssetLru_.end();
+       gpuMemoryEvictionAllowed_ && it != sceneAssetLru_.begin() &&
+       used + bytes > gpuMemoryBudget_;) {
+    --it;
+    if (sceneAssetCache_.at(*it).inUse) {
+      continue;
+    }
+    const std::string filename = *it;
+    it = std::next(it);
+    used -= std::min(used, gpuMemoryUsage(filename).totalBytes());
+    evictSceneAsset(filename);
+  }
+  return used + bytes <= gpuMemoryBudget_;
+}
+
+void ResourceManager::evictSceneAsset(const std::string& filename) {
+  LOG(INFO) << "Evicting scene asset " << filename;
+  const MeshMetaData& metaData = resourceDict_.at(filename).meshMetaData;
+  // the slots stay so that the indices of other assets remain valid
+  if (metaData.meshIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.meshIndex.first; i <= metaData.meshIndex.second;
+         ++i) {
+      meshes_[i] = nullptr;
+    }
+  }
+  if (metaData.textureIndex.first != ID_UNDEFINED) {
+    for (int i = metaData.textureIndex.first; i <= metaData.textureIndex.second;
+         ++i) {
+      textures_[i] = nullptr;
+      textureByteSizes_[i] = 0;
+    }
+  }
+  resourceDict_.erase(filename);
+  collisionMeshGroups_.erase(filename);
+  joinedCollisionMeshes_.erase(filename);
+  occupancyGrids_.erase(filename);
+  meshRayCasters_.erase(filename);
+  gpuAssets_.erase(filename);
+
+  auto found = sceneAssetCache_.find(filename);
+  sceneAssetLru_.erase(found->second.lruPosition);
+  sceneAssetCache_.erase(found);
+  ++sceneAssetCacheStats_.evictions;
 }
 
 }  // namespace assets
@@ -9,9 +9,14 @@
  * esp::assets::ResourceManager::ShaderType
  */
 
+#include <deque>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -19,6 +24,7 @@
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Transform.h>
+#include <Magnum/Sampler.h>
 #include <Magnum/SceneGraph/MatrixTransformation3D.h>
 
 #include "Asset.h"
@@ -26,12 +32,17 @@
 #include "BaseMesh.h"
 #include "CollisionMeshData.h"
 #include "GltfMeshData.h"
+#include "GpuAssetRegistry.h"
 #include "MeshData.h"
 #include "MeshMetaData.h"
+#include "SceneLoadStatistics.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "esp/gfx/MaterialData.h"
+#include "esp/gfx/PhongShader.h"
 #include "esp/gfx/ShaderManager.h"
 #include "esp/gfx/configure.h"
+#include "esp/geo/MeshRayCaster.h"
+#include "esp/geo/OccupancyGrid.h"
 #include "esp/scene/SceneNode.h"
 
 // forward declarations
@@ -97,6 +108,416 @@ class ResourceManager {
    */
   inline void compressTextures(bool newVal) { compressTextures_ = newVal; };
 
+  /**
+   * @brief Set whether assets are loaded for physics and navigation only
+   *
+   * Meshes are only imported to the CPU for collisions and navmesh
+   * recomputation, their textures and materials are skipped and nothing is
+   * uploaded or drawn, so loading needs no GL context. Scene assets loaded
+   * this way are loaded again once it's disabled, objects stay without
+   * render data. PTex meshes and SUNCG houses have no collision geometry
+   * and are skipped.
+   * @param newVal New CPU-only setting.
+   */
+  inline void cpuOnly(bool newVal) { cpuOnly_ = newVal; }
+
+  /** @brief Whether assets are loaded for physics and navigation only */
+  bool isCpuOnly() const { return cpuOnly_; }
+
+  /**
+   * @brief Set the maximum width and height of loaded textures
+   *
+   * Larger textures get their largest mip levels dropped, or are downscaled
+   * and get a new mip chain generated if they have none, so no more than
+   * needed for the sensor resolution is loaded. 0, the default, means no
+   * limit. Only affects assets loaded afterwards.
+   * @param size New texture size limit in pixels.
+   */
+  inline void setMaxTextureSize(int size) { maxTextureSize_ = size; }
+
+  /**
+   * @brief Set whether textures of an asset are packed into atlases
+   *
+   * Uncompressed textures without mip levels of their own that have the
+   * same power-of-two size, format and filtering become tiles of a grid
+   * atlas no larger than the GL texture size limit, with a mip chain down to
+   * the tile size generated. Materials get their texture matrix placed on
+   * the tile, so drawables of different materials in one atlas no longer
+   * rebind textures, and @ref instancedObjectDrawing() and
+   * @ref multiDrawStaticMeshes() batch materials that only differ in their
+   * tile together, passing the tile per instance. Only textures of materials
+   * with a single texture, without a texture transformation, whose meshes
+   * keep their texture coordinates within [0, 1] are packed, as the
+   * texture can't repeat on a tile. Sampling keeps half a texel from the
+   * tile border, so the coarsest mip levels may blend in the neighboring
+   * tiles slightly. Only affects assets loaded afterwards.
+   * @param newVal New atlas setting.
+   */
+  inline void textureAtlases(bool newVal) { textureAtlases_ = newVal; }
+
+  /**
+   * @brief Set whether loaded meshes get their triangles and vertices
+   * reordered for rendering
+   *
+   * Runs @ref optimizeMesh() on every glTF and instance mesh before it's
+   * uploaded, which reduces vertex shader invocations, overdraw and vertex
+   * fetches on large scanned meshes at the cost of longer loading. Only
+   * affects assets loaded afterwards.
+   * @param newVal New mesh optimization setting.
+   */
+  inline void optimizeMeshes(bool newVal) { optimizeMeshes_ = newVal; }
+
+  /**
+   * @brief Set whether object templates are registered without loading
+   * their meshes
+   *
+   * If enabled, @ref loadObjectTemplate() and everything parsing object
+   * configs only add the template to the @ref physicsObjTemplateLibrary_, and
+   * the render and collision meshes are loaded by @ref
+   * loadObjectTemplateAssets() when the first object is created from it, or
+   * in the background after @ref prefetchObjectTemplate(). A template whose
+   * meshes fail to load is then still registered, but can't create objects.
+   * Only affects templates registered afterwards.
+   * @param newVal New lazy loading setting.
+   */
+  inline void lazyObjectTemplates(bool newVal) {
+    lazyObjectTemplates_ = newVal;
+  }
+
+  /**
+   * @brief Set whether instance meshes are uploaded with quantized positions
+   * and 16-bit indices where possible
+   *
+   * See @ref GenericInstanceMeshData::setCompactLayout(). Only affects
+   * assets loaded afterwards.
+   * @param newVal New compact layout setting.
+   */
+  inline void compactMeshLayout(bool newVal) { compactMeshLayout_ = newVal; }
+
+  /**
+   * @brief Set whether instance meshes keep their object IDs per triangle
+   *
+   * Instance meshes loaded as a single mesh, not split by object ID, are then
+   * read with @ref GenericInstanceMeshData::fromPLY() with primitive object
+   * IDs and drawn by @ref gfx::PrimitiveIdDrawable. Their vertices aren't
+   * duplicated where objects meet and the IDs aren't limited to 16 bits.
+   * Needs OpenGL 4.1, ignored otherwise. Such meshes have no levels of
+   * detail, no compact layout and no baked version. Only affects assets
+   * loaded afterwards.
+   * @param newVal New primitive object ID setting.
+   */
+  inline void primitiveObjectIds(bool newVal) { primitiveObjectIds_ = newVal; }
+
+  /**
+   * @brief Set whether PTex meshes are drawn with vertex pulling instead of
+   * a geometry shader
+   *
+   * See @ref PTexMeshData::setVertexPulling(). Applies to PTex meshes
+   * instanced afterwards, uploading them again if needed.
+   * @param newVal New vertex pulling setting.
+   */
+  inline void ptexVertexPulling(bool newVal) { ptexVertexPulling_ = newVal; }
+
+  /**
+   * @brief Set how many simplified levels of detail are generated for every
+   * instance submesh
+   *
+   * See @ref GenericInstanceMeshData::generateLevelsOfDetail(). Drawables of
+   * the submeshes get the levels added, @ref gfx::RenderCamera picks one by
+   * projected size. 0, the default, generates none. Only affects assets
+   * loaded afterwards.
+   * @param levels Largest number of levels per submesh.
+   */
+  inline void setMeshLodLevels(int levels) { meshLodLevels_ = levels; }
+
+  /** @brief Maximum width and height of loaded textures, 0 if unlimited */
+  inline int maxTextureSize() const { return maxTextureSize_; }
+
+  /**
+   * @brief Set the directory textures compressed on load are cached in
+   *
+   * With @ref compressTextures enabled, the driver compresses every texture
+   * without mip levels of its own on each load. If a directory is set, the
+   * compressed mip chain is read back once and saved there, named after a
+   * hash of the image contents, and later loads upload it directly. Empty,
+   * the default, disables the cache. Desktop GL only.
+   * @param directory Cache directory, created if it doesn't exist.
+   */
+  inline void setTextureCacheDirectory(const std::string& directory) {
+    textureCacheDirectory_ = directory;
+  }
+
+  /** @brief Directory compressed textures are cached in, empty if none */
+  inline const std::string& textureCacheDirectory() const {
+    return textureCacheDirectory_;
+  }
+
+  /**
+   * @brief Set the directory the collision BVHs of physical scenes are cached
+   * in
+   *
+   * Building the BVH of a large static scene mesh takes a good part of a
+   * physics scene load. If a directory is set, the BVH of each collision
+   * mesh is saved there once, named after a hash of its triangles, and later
+   * loads read it back in place. Empty, the default, disables the cache.
+   * Only affects scenes loaded afterwards.
+   * @param directory Cache directory, created if it doesn't exist.
+   */
+  inline void setCollisionCacheDirectory(const std::string& directory) {
+    collisionCacheDirectory_ = directory;
+  }
+
+  /** @brief Directory collision BVHs are cached in, empty if none */
+  inline const std::string& collisionCacheDirectory() const {
+    return collisionCacheDirectory_;
+  }
+
+  /**
+   * @brief Set whether copies of an object template added with @ref
+   * addObjectToDrawables should share one instanced draw call.
+   *
+   * Instanced copies are not frustum culled individually and are not
+   * affected by @ref gfx::setLightSetupForSubTree.
+   * @param newVal New instanced drawing setting.
+   */
+  inline void instancedObjectDrawing(bool newVal) {
+    instancedObjectDrawing_ = newVal;
+  };
+
+  /**
+   * @brief Set whether the meshes of static scenes should be packed into
+   * shared buffers and drawn by one multi-draw call per material.
+   *
+   * The parts of a @ref gfx::MultiDrawDrawable are frustum culled by the
+   * batch itself, but not by occlusion culling or potentially visible sets,
+   * and are not affected by @ref gfx::setLightSetupForSubTree. Needs
+   * @ref gfx::MultiDrawDrawable::isSupported(), otherwise ignored.
+   * @param newVal New multi-draw setting.
+   */
+  inline void multiDrawStaticMeshes(bool newVal) {
+    multiDrawStaticMeshes_ = newVal;
+  };
+
+  /**
+   * @brief Statistics of the scene asset cache, see
+   * @ref setSceneAssetCacheBudget()
+   */
+  struct SceneAssetCacheStats {
+    //! Scene loads that found the asset already loaded
+    size_t hits = 0;
+    //! Scene loads that had to parse and upload the asset
+    size_t misses = 0;
+    //! Assets evicted to stay within the budget
+    size_t evictions = 0;
+    //! Scene assets currently loaded
+    size_t entries = 0;
+    //! Estimated CPU and GPU memory used by the loaded scene assets in bytes
+    size_t byteSize = 0;
+  };
+
+  /**
+   * @brief Set the memory budget of the scene asset cache
+   *
+   * Assets loaded with @ref loadScene() stay loaded after switching to
+   * another scene, so switching back doesn't parse and upload them again.
+   * Once their estimated CPU and GPU memory exceeds @p bytes, @ref
+   * trimSceneAssetCache() evicts the least recently used ones. 0, the
+   * default, means no limit.
+   */
+  void setSceneAssetCacheBudget(size_t bytes) {
+    sceneAssetCacheBudget_ = bytes;
+  }
+
+  /** @brief Memory budget of the scene asset cache in bytes, 0 if unlimited */
+  size_t sceneAssetCacheBudget() const { return sceneAssetCacheBudget_; }
+
+  /** @brief Statistics of the scene asset cache */
+  SceneAssetCacheStats sceneAssetCacheStats() const;
+
+  /**
+   * @brief Time spent in the stages of @ref loadScene() since the last
+   * @ref resetSceneLoadStatistics()
+   *
+   * Mutable so callers can add the stages they run around the load, the
+   * simulator adds the semantic annotations and the navmesh.
+   */
+  SceneLoadStatistics& sceneLoadStatistics() { return sceneLoadStatistics_; }
+  const SceneLoadStatistics& sceneLoadStatistics() const {
+    return sceneLoadStatistics_;
+  }
+
+  /** @brief Clear @ref sceneLoadStatistics() and start a new load */
+  void resetSceneLoadStatistics() {
+    sceneLoadStatistics_ = {};
+    sceneLoadStatistics_.startTime = SceneLoadStatistics::now();
+  }
+
+  /**
+   * @brief Evict least recently used scene assets until the cache is within
+   * its budget
+   *
+   * Assets passed to @ref loadScene() since the previous call are in use by
+   * the current scene and are never evicted. Drawables created for evicted
+   * assets must not be drawn anymore. Needs the GL context to be current.
+   */
+  void trimSceneAssetCache();
+
+  /**
+   * @brief Whether the scene asset at @p filepath is loaded
+   *
+   * False once it was evicted by @ref trimSceneAssetCache() or for the GPU
+   * memory budget, after which drawables created for it must not be drawn.
+   */
+  bool isSceneAssetLoaded(const std::string& filepath) const {
+    return resourceDict_.count(filepath) > 0;
+  }
+
+  /**
+   * @brief Mark a cached scene asset as most recently used
+   *
+   * For scenes that are drawn again without going through @ref loadScene(),
+   * so their assets are evicted last. Does nothing for assets that aren't
+   * cached.
+   */
+  void touchSceneAsset(const std::string& filepath);
+
+  /**
+   * @brief GPU memory used by loaded assets, see @ref gpuMemoryUsage()
+   */
+  struct GpuMemoryUsage {
+    //! Vertex buffers in bytes
+    size_t vertexBytes = 0;
+    //! Index buffers in bytes
+    size_t indexBytes = 0;
+    //! Textures in bytes, including mip levels
+    size_t textureBytes = 0;
+
+    //! All of the above in bytes
+    size_t totalBytes() const {
+      return vertexBytes + indexBytes + textureBytes;
+    }
+  };
+
+  /**
+   * @brief GPU memory used by all assets loaded by this instance
+   *
+   * Assets shared with other instances through @ref GpuAssetRegistry are
+   * counted by each of them.
+   */
+  GpuMemoryUsage gpuMemoryUsage() const;
+
+  /**
+   * @brief GPU memory used by the asset loaded from @p filename
+   *
+   * All zero if the asset isn't loaded.
+   */
+  GpuMemoryUsage gpuMemoryUsage(const std::string& filename) const;
+
+  /**
+   * @brief Set the GPU memory budget of loaded assets
+   *
+   * When loading a scene asset would exceed @p bytes, scene assets not used
+   * by the current scene (see @ref trimSceneAssetCache()) are evicted first,
+   * least recently used first. If that isn't enough, the largest mip levels
+   * of the textures being loaded are dropped, or textures without mip levels
+   * are downscaled, instead of running out of memory. Geometry is never
+   * reduced. 0, the default, means no limit.
+   */
+  void setGpuMemoryBudget(size_t bytes) { gpuMemoryBudget_ = bytes; }
+
+  /** @brief GPU memory budget of loaded assets in bytes, 0 if unlimited */
+  size_t gpuMemoryBudget() const { return gpuMemoryBudget_; }
+
+  /**
+   * @brief Set whether glTF meshes are uploaded over several frames
+   *
+   * If enabled, @ref loadScene() only allocates the GPU buffers of general
+   * meshes, and the data is uploaded by @ref uploadPendingMeshes() calls
+   * between frames, so that loading a large scene doesn't stall the
+   * rendering of other scenes on the same context. Meshes draw nothing
+   * until they are complete. Meshes that get their normals generated, PTex
+   * and instance meshes are still uploaded at once. Only affects assets
+   * loaded afterwards.
+   * @param newVal New incremental upload setting.
+   */
+  inline void incrementalMeshUpload(bool newVal) {
+    incrementalMeshUpload_ = newVal;
+  }
+
+  /**
+   * @brief Upload the next @p byteBudget bytes of the meshes left pending by
+   * @ref loadScene(), in load order
+   * @return Number of bytes uploaded
+   *
+   * See @ref incrementalMeshUpload(). Each mesh becomes visible with the
+   * call uploading its last bytes. Meshes evicted before that are skipped.
+   */
+  size_t uploadPendingMeshes(size_t byteBudget);
+
+  /**
+   * @brief Set whether scene meshes free their CPU copies once uploaded
+   *
+   * If enabled, @ref loadScene() ends with @ref BaseMesh::releaseUploadData()
+   * on every mesh of the scene asset, so only the data collisions, navmesh
+   * recomputation, bounds and semantic queries need stays in host memory.
+   * glTF meshes keep their data with @ref instancedObjectDrawing() or
+   * @ref multiDrawStaticMeshes(), which compile them again for their
+   * batches. Only affects assets loaded afterwards.
+   * @param newVal New release setting.
+   */
+  inline void releaseUploadData(bool newVal) { releaseUploadData_ = newVal; }
+
+  /** @brief Whether meshes are left for @ref uploadPendingMeshes() */
+  bool hasPendingMeshUploads() const { return !pendingMeshUploads_.empty(); }
+
+  /**
+   * @brief Start loading a scene asset in the background
+   *
+   * Parses the meshes and decodes the textures of the asset on a worker
+   * thread, so a later @ref loadScene() with the same @p info only has to
+   * upload them to the GPU. If the worker is still busy at that point, @ref
+   * loadScene() waits for it. Only assets loaded through the general mesh
+   * importer (@ref AssetType::MP3D_MESH and @ref AssetType::UNKNOWN) can be
+   * prefetched. Needs the GL context to be current, to pick the GPU format
+   * Basis textures get transcoded to.
+   * @return Whether the asset is being prefetched, false if it can't be
+   * prefetched or is already loaded
+   */
+  bool prefetchScene(const AssetInfo& info);
+
+  /**
+   * @brief Parse the meshes of a scene asset for all resource managers of
+   * the process
+   *
+   * Unlike @ref prefetchScene(), parses on the calling thread, doesn't need a
+   * GL context and keeps the result in a process-wide registry, so it can be
+   * done once in a parent process and inherited by the workers it forks. The
+   * first @ref loadScene() of @p info in each process takes the parsed meshes
+   * instead of opening the file again. Textures are decoded by that process,
+   * the GPU format Basis textures get transcoded to depends on its context.
+   * Only general mesh assets can be preloaded, like with @ref
+   * prefetchScene().
+   * @return Whether the asset is preloaded
+   */
+  static bool preloadScene(const AssetInfo& info);
+
+  /**
+   * @brief Number of assets preloaded by @ref preloadScene() and not yet
+   * taken by a @ref loadScene() of this process
+   */
+  static size_t preloadedSceneCount();
+
+  /** @brief Drop all assets preloaded by @ref preloadScene() */
+  static void clearPreloadedScenes();
+
+  /**
+   * @brief Whether the asset at @p filepath is prefetched and not yet
+   * consumed by @ref loadScene()
+   */
+  bool isScenePrefetched(const std::string& filepath) const {
+    return prefetchedScenes_.count(filepath) > 0;
+  }
+
   /**
    * @brief Load a scene mesh and add it to the specified @ref DrawableGroup as
    * a child of the specified @ref scene::SceneNode.
@@ -241,6 +662,35 @@ class ResourceManager {
    */
   int parseAndLoadPhysObjTemplate(const std::string& objPhysConfigFilename);
 
+  /**
+   * @brief Parse a physics object template config file into a new
+   * @ref PhysicsObjectAttributes object without loading its meshes
+   *
+   * Streams the file through a SAX parser straight into the attributes, no
+   * JSON document is built. Touches no state of the resource manager, so it
+   * can run on any thread.
+   * @param objPhysConfigFilename The configuration file to parse.
+   * @return The attributes, nullptr if the file doesn't exist or isn't valid
+   * JSON.
+   */
+  static PhysicsObjectAttributes::ptr parsePhysObjTemplate(
+      const std::string& objPhysConfigFilename);
+
+  /**
+   * @brief Like @ref parseAndLoadPhysObjTemplate() for many config files
+   *
+   * The files are parsed in parallel, then their meshes are loaded and the
+   * templates added to the @ref physicsObjTemplateLibrary_ in the order of
+   * @p objPhysConfigFilenames, so they get the same IDs as if loaded one by
+   * one.
+   * @param objPhysConfigFilenames The configuration files to parse and load,
+   * e.g. from @ref getObjectConfigPaths().
+   * @return The index in the @ref physicsObjTemplateLibrary_ of each file,
+   * @ref ID_UNDEFINED for the files that failed to load.
+   */
+  std::vector<int> parseAndLoadPhysObjTemplates(
+      const std::vector<std::string>& objPhysConfigFilenames);
+
   /**
    * @brief Add a @ref PhysicsObjectAttributes object to the @ref
    * physicsObjTemplateLibrary_.
@@ -255,6 +705,30 @@ class ResourceManager {
   int loadObjectTemplate(PhysicsObjectAttributes::ptr objectTemplate,
                          const std::string objectTemplateHandle);
 
+  /**
+   * @brief Load the render and collision meshes of an object template if
+   * they aren't yet, see @ref lazyObjectTemplates()
+   *
+   * Waits for a prefetch started by @ref prefetchObjectTemplate().
+   * @param objectTemplateID The index of the template in the @ref
+   * physicsObjTemplateLibrary_.
+   * @return Whether the meshes are loaded, false if neither mesh could be
+   * loaded.
+   */
+  bool loadObjectTemplateAssets(int objectTemplateID);
+
+  /**
+   * @brief Start loading the meshes of an object template in the background
+   *
+   * Like @ref prefetchScene() for the render and collision mesh, so a later
+   * @ref loadObjectTemplateAssets() only has to upload them.
+   * @param objectTemplateID The index of the template in the @ref
+   * physicsObjTemplateLibrary_.
+   * @return Whether any mesh is being prefetched, false if they are loaded
+   * already or can't be prefetched.
+   */
+  bool prefetchObjectTemplate(int objectTemplateID);
+
   //======== Accessor functions ========
   /**
    * @brief Getter for all @ref assets::CollisionMeshData associated with the
@@ -375,6 +849,45 @@ class ResourceManager {
   std::unique_ptr<MeshData> createJoinedCollisionMesh(
       const std::string& filename);
 
+  /**
+   * @brief The unified @ref MeshData of a loaded asset's collision meshes,
+   * without copying it.
+   *
+   * Joined on first use and kept until the asset is evicted, so repeated
+   * navmesh recomputations don't transform the same meshes again. See
+   * @ref createJoinedCollisionMesh.
+   * @param filename The identifying string key for the asset. See @ref
+   * resourceDict_ and @ref meshes_.
+   * @return The unified @ref MeshData object for the asset.
+   */
+  const MeshData& getJoinedCollisionMesh(const std::string& filename);
+
+  /**
+   * @brief Occupancy of a loaded asset's joined collision mesh in voxels of
+   * @p voxelSize.
+   *
+   * Voxelized on first use for each voxel size and kept until the asset is
+   * evicted. See @ref geo::voxelizeMesh and @ref getJoinedCollisionMesh.
+   * @param filename The identifying string key for the asset. See @ref
+   * resourceDict_ and @ref meshes_.
+   * @param voxelSize Edge length of the voxels in meters.
+   * @return The sparse @ref geo::OccupancyGrid of the asset.
+   */
+  const geo::OccupancyGrid& getOccupancyGrid(const std::string& filename,
+                                             float voxelSize);
+
+  /**
+   * @brief Ray caster over a loaded asset's joined collision mesh.
+   *
+   * Built on first use and kept until the asset is evicted. Triangles of
+   * instance meshes report their object ID, all others 0. See
+   * @ref getJoinedCollisionMesh.
+   * @param filename The identifying string key for the asset. See @ref
+   * resourceDict_ and @ref meshes_.
+   * @return The @ref geo::MeshRayCaster of the asset.
+   */
+  const geo::MeshRayCaster& getMeshRayCaster(const std::string& filename);
+
   /**
    * @brief Create a new drawable primitive attached to the desired @ref
    * scene::SceneNode.
@@ -454,12 +967,26 @@ class ResourceManager {
    * identifying its mesh, material, transformation, and children.
    * @param lightSetup The @ref LightSetup key that will be used
    * for the added component.
+   * @param instanced Whether the meshes may be appended to a @ref
+   * gfx::InstancedDrawable shared with other copies of the asset.
    */
   void addComponent(const MeshMetaData& metaData,
                     scene::SceneNode& parent,
                     const Magnum::ResourceKey& lightSetup,
                     DrawableGroup* drawables,
-                    const MeshTransformNode& meshTransformNode);
+                    const MeshTransformNode& meshTransformNode,
+                    bool instanced = false);
+
+  /**
+   * @brief A loaded texture @ref packTextureAtlases() can make a tile of
+   */
+  struct AtlasCandidate {
+    int textureID;
+    Magnum::Vector2i size;
+    Magnum::GL::TextureFormat format;
+    Magnum::SamplerFilter magnificationFilter, minificationFilter;
+    Magnum::SamplerMipmap mipmapFilter;
+  };
 
   /**
    * @brief Load textures from importer into assets, and update metaData for an
@@ -467,8 +994,36 @@ class ResourceManager {
    *
    * @param importer The importer already loaded with information for the asset.
    * @param loadedAssetData The asset's @ref LoadedAssetData object.
+   * @param sharedData If not nullptr, the textures are taken from this data
+   * uploaded by another @ref ResourceManager instead of being loaded.
+   * @param atlasCandidates If not nullptr, the loaded textures that can be
+   * packed into atlases are appended to it.
+   */
+  void loadTextures(Importer& importer,
+                    LoadedAssetData& loadedAssetData,
+                    const GpuAssetData* sharedData = nullptr,
+                    std::vector<AtlasCandidate>* atlasCandidates = nullptr);
+
+  /**
+   * @brief Pack the textures of an asset into atlases, see
+   * @ref textureAtlases()
+   *
+   * Replaces the packed textures in @ref textures_ by their atlas and sets
+   * their @ref textureTransforms_. Has to run after @ref loadMeshes(), which
+   * the texture coordinates are checked on, and before @ref loadMaterials().
+   * @param importer The importer already loaded with information for the asset.
+   * @param loadedAssetData The asset's @ref LoadedAssetData object.
+   * @param candidates The textures @ref loadTextures() found packable.
    */
-  void loadTextures(Importer& importer, LoadedAssetData& loadedAssetData);
+  void packTextureAtlases(Importer& importer,
+                          const LoadedAssetData& loadedAssetData,
+                          const std::vector<AtlasCandidate>& candidates);
+
+  /**
+   * @brief Place the textures of @p material on the atlas tile of the
+   * texture @p textureID, if it's packed into one
+   */
+  void setTextureTile(gfx::PhongMaterialData& material, int textureID);
 
   /**
    * @brief Load meshes from importer into assets.
@@ -477,8 +1032,12 @@ class ResourceManager {
    * asset to link meshes to that asset.
    * @param importer The importer already loaded with information for the asset.
    * @param loadedAssetData The asset's @ref LoadedAssetData object.
+   * @param sharedData If not nullptr, the meshes are taken from this data
+   * uploaded by another @ref ResourceManager instead of being loaded.
    */
-  void loadMeshes(Importer& importer, LoadedAssetData& loadedAssetData);
+  void loadMeshes(Importer& importer,
+                  LoadedAssetData& loadedAssetData,
+                  const GpuAssetData* sharedData = nullptr);
 
   /**
    * @brief Recursively parse the mesh component transformation heirarchy for
@@ -496,20 +1055,34 @@ class ResourceManager {
                          int componentID);
 
   /**
-   * @brief Recursively build a unified @ref MeshData from loaded assets via a
-   * tree of @ref MeshTransformNode.
+   * @brief Recursively collect the collision meshes of a loaded asset via a
+   * tree of @ref MeshTransformNode, to be joined into a unified @ref MeshData.
    *
-   * @param mesh The @ref MeshData being constructed.
+   * @param components The collision meshes of the heirarchy and their
+   * transformations to world space, gathered so far.
    * @param metaData The @ref MeshMetaData for the object heirarchy being
    * joined.
    * @param node The current @ref MeshTransformNode in the recursion.
    * @param transformFromParentToWorld The cumulative transformation up to but
    * not including the current @ref MeshTransformNode.
    */
-  void joinHeirarchy(MeshData& mesh,
-                     const MeshMetaData& metaData,
-                     const MeshTransformNode& node,
-                     const Magnum::Matrix4& transformFromParentToWorld);
+  void joinHeirarchy(
+      std::vector<std::pair<CollisionMeshData*, Magnum::Matrix4>>& components,
+      const MeshMetaData& metaData,
+      const MeshTransformNode& node,
+      const Magnum::Matrix4& transformFromParentToWorld);
+
+  /**
+   * @brief Collect the meshes of an asset in the order @ref joinHeirarchy
+   * visits them.
+   *
+   * @param meshes The meshes, in the order of the joined components.
+   * @param metaData The @ref MeshMetaData object for the asset.
+   * @param node The current @ref MeshTransformNode in the recursion.
+   */
+  void collectHeirarchyMeshes(std::vector<BaseMesh*>& meshes,
+                              const MeshMetaData& metaData,
+                              const MeshTransformNode& node);
 
   /**
    * @brief Load materials from importer into assets, and update metaData for an
@@ -520,6 +1093,23 @@ class ResourceManager {
    */
   void loadMaterials(Importer& importer, LoadedAssetData& loadedAssetData);
 
+  /**
+   * @brief Compile the Phong shader variants the materials of an asset need
+   * before its drawables are created
+   *
+   * Drawables otherwise compile a variant the first time one needs it,
+   * which for a new light count is while drawing a frame. The variants stay
+   * compiled for later loads, see @ref precompiledShaders_.
+   *
+   * @param metaData The asset's mesh meta data, with its material indices.
+   * @param lightSetup The light setup the drawables will be created with.
+   * @param batched Whether the drawables may be instanced or multi-draw
+   * batches, which need the instanced variants as well.
+   */
+  void precompileShaders(const MeshMetaData& metaData,
+                         const Magnum::ResourceKey& lightSetup,
+                         bool batched);
+
   /**
    * @brief Get a @ref PhongMaterialData for use with flat shading
    *
@@ -593,6 +1183,27 @@ class ResourceManager {
                            const Magnum::ResourceKey& lightSetup =
                                Magnum::ResourceKey{NO_LIGHT_KEY});
 
+  /**
+   * @brief Put the object IDs of an instance mesh on the vertices of a
+   * loaded general mesh
+   *
+   * Every vertex gets the ID of the closest instance mesh vertex in world
+   * space, looked up in a uniform grid, or 0 if there is none nearby. The
+   * meshes are uploaded again with the IDs and the materials of the asset
+   * draw them, so semantic sensors can render the asset in the scene graph
+   * of the color sensors.
+   * @param semanticFilename The instance mesh (e.g. a `_semantic.ply`) to
+   * take the IDs from.
+   * @param metaData The @ref MeshMetaData of the general mesh, with its
+   * hierarchy loaded.
+   * @param meshesLoaded Whether the meshes already have the IDs, reused from
+   * another instance, and only the materials need to be set up.
+   * @return Whether the IDs were transferred.
+   */
+  bool transferSemanticIds(const std::string& semanticFilename,
+                           MeshMetaData& metaData,
+                           bool meshesLoaded);
+
   /**
    * @brief Load a SUNCG mesh into assets from a file. !Deprecated! TODO:
    * remove?
@@ -706,6 +1317,34 @@ class ResourceManager {
    */
   std::vector<std::shared_ptr<Magnum::GL::Texture2D>> textures_;
 
+  /**
+   * @brief Size of the image data uploaded for each of @ref textures_, in
+   * bytes
+   */
+  std::vector<size_t> textureByteSizes_;
+
+  /**
+   * @brief Placement of each of @ref textures_ on the atlas it's packed into,
+   * identity if it isn't, see @ref textureAtlases()
+   */
+  std::vector<Magnum::Matrix3> textureTransforms_;
+
+  /**
+   * @brief Keys of the materials batches draw materials on atlas tiles with,
+   * see @ref batchMaterialKey()
+   */
+  std::unordered_map<std::string, std::string> batchMaterialKeys_;
+
+  /**
+   * @brief GPU data of the loaded assets, registered in @ref
+   * GpuAssetRegistry so other instances on the same GL context can reuse it
+   * instead of uploading another copy. Keeps the data alive until the asset
+   * is evicted or this instance is destroyed.
+   *
+   * Maps absolute path keys to the data.
+   */
+  std::map<std::string, GpuAssetData::ptr> gpuAssets_;
+
   /**
    * @brief The next available unique ID for loaded materials
    */
@@ -771,6 +1410,24 @@ class ResourceManager {
    */
   std::map<std::string, std::vector<CollisionMeshData>> collisionMeshGroups_;
 
+  /**
+   * @brief Joined collision meshes of loaded assets, see @ref
+   * getJoinedCollisionMesh.
+   */
+  std::map<std::string, MeshData::uptr> joinedCollisionMeshes_;
+
+  /**
+   * @brief Occupancy grids of loaded assets by voxel size, see @ref
+   * getOccupancyGrid.
+   */
+  std::map<std::string, std::map<float, geo::OccupancyGrid::uptr>>
+      occupancyGrids_;
+
+  /**
+   * @brief Ray casters of loaded assets, see @ref getMeshRayCaster.
+   */
+  std::map<std::string, geo::MeshRayCaster::uptr> meshRayCasters_;
+
   /**
    * @brief Maps object template ID to object template file names
    *
@@ -799,6 +1456,10 @@ class ResourceManager {
    * the asset via the @ref MeshMetaData.
    * @param materialIDLocal The index of the material within the material group
    * linked to the asset via the @ref MeshMetaData.
+   * @param instanced Whether the mesh may be appended to a @ref
+   * gfx::InstancedDrawable instead, see @ref addInstanceToDrawables.
+   * Static scene meshes may be appended to a @ref gfx::MultiDrawDrawable
+   * otherwise, see @ref multiDrawStaticMeshes.
    */
   void addMeshToDrawables(const MeshMetaData& metaData,
                           scene::SceneNode& node,
@@ -806,7 +1467,82 @@ class ResourceManager {
                           DrawableGroup* drawables,
                           int objectID,
                           int meshIDLocal,
-                          int materialIDLocal);
+                          int materialIDLocal,
+                          bool instanced = false);
+
+  /**
+   * @brief Draw a mesh as one more instance of the @ref
+   * gfx::InstancedDrawable in drawables sharing its mesh, material and light
+   * setup, creating the instanced drawable if needed.
+   *
+   * Only glTF meshes without per-vertex object IDs, lit without @ref
+   * gfx::LightPositionModel::OBJECT lights, can be batched.
+   * @param meshID The index of the mesh in @ref meshes_.
+   * @param node The @ref scene::SceneNode at which the instance is drawn.
+   * @param lightSetup The @ref LightSetup key that will be used
+   * for the mesh.
+   * @param materialKey The @ref MaterialData key that will be used for the
+   * mesh.
+   * @param drawables The @ref DrawableGroup with which the instance will be
+   * rendered.
+   * @return Whether the mesh was added to an instanced drawable. If not, the
+   * caller should create a regular drawable for it.
+   */
+  bool addInstanceToDrawables(int meshID,
+                              scene::SceneNode& node,
+                              const Magnum::ResourceKey& lightSetup,
+                              const std::string& materialKey,
+                              DrawableGroup* drawables);
+
+  /**
+   * @brief Draw a static mesh as one more part of the @ref
+   * gfx::MultiDrawDrawable in drawables sharing its vertex layout, material
+   * and light setup, creating the batch if needed.
+   *
+   * The same meshes as in @ref addInstanceToDrawables can be batched, if
+   * they are indexed triangles.
+   * @param meshID The index of the mesh in @ref meshes_.
+   * @param node The @ref scene::SceneNode at which the part is drawn.
+   * @param lightSetup The @ref LightSetup key that will be used
+   * for the mesh.
+   * @param materialKey The @ref MaterialData key that will be used for the
+   * mesh.
+   * @param drawables The @ref DrawableGroup with which the part will be
+   * rendered.
+   * @return Whether the mesh was added to a batch. If not, the caller should
+   * create a regular drawable for it.
+   */
+  bool addMultiDrawPartToDrawables(int meshID,
+                                   scene::SceneNode& node,
+                                   const Magnum::ResourceKey& lightSetup,
+                                   const std::string& materialKey,
+                                   DrawableGroup* drawables);
+
+  /**
+   * @brief Key of the material a batch draws @p materialKey with
+   *
+   * Materials that only differ in their atlas tile share the key of the
+   * first of them, @p textureOffset is set to the tile of @p materialKey
+   * then. Otherwise it's @p materialKey itself.
+   */
+  std::string batchMaterialKey(const std::string& materialKey,
+                               Magnum::Vector2& textureOffset);
+
+  /**
+   * @brief The glTF mesh data of @p meshID if it can be drawn by a batch
+   * with the given material and light setup, nullptr otherwise
+   */
+  GltfMeshData* batchableMeshData(int meshID,
+                                  const Magnum::ResourceKey& lightSetup,
+                                  const std::string& materialKey,
+                                  DrawableGroup* drawables);
+
+  /**
+   * @brief Scene node directly under the scene root above @p node, which
+   * batches are attached to so removing the node that created them doesn't
+   * remove the other parts
+   */
+  scene::SceneNode& batchParent(scene::SceneNode& node);
 
   /**
    * @brief Create a @ref gfx::Drawable for the specified mesh, node,
@@ -842,6 +1578,181 @@ class ResourceManager {
    * @brief Flag to denote the desire to compress textures. TODO: unused?
    */
   bool compressTextures_ = false;
+
+  /**
+   * @brief Flag to load only the CPU geometry of assets, see @ref cpuOnly
+   */
+  bool cpuOnly_ = false;
+
+  /**
+   * @brief Scene assets loaded while @ref cpuOnly_ was set, without render
+   * data
+   */
+  std::set<std::string> cpuOnlyAssets_;
+
+  /**
+   * @brief Flag to reorder loaded meshes for rendering, see @ref
+   * optimizeMeshes
+   */
+  bool optimizeMeshes_ = false;
+
+  /**
+   * @brief Whether object template meshes are loaded on first use, see @ref
+   * lazyObjectTemplates
+   */
+  bool lazyObjectTemplates_ = false;
+
+  /**
+   * @brief Flag to upload instance meshes in a compact layout, see @ref
+   * compactMeshLayout
+   */
+  bool compactMeshLayout_ = false;
+
+  /**
+   * @brief Flag to keep the object IDs of instance meshes per triangle, see
+   * @ref primitiveObjectIds
+   */
+  bool primitiveObjectIds_ = false;
+
+  /**
+   * @brief Flag to draw PTex meshes without a geometry shader, see @ref
+   * ptexVertexPulling
+   */
+  bool ptexVertexPulling_ = false;
+
+  /**
+   * @brief Number of levels of detail generated per instance submesh, see
+   * @ref setMeshLodLevels
+   */
+  int meshLodLevels_ = 0;
+
+  /**
+   * @brief Maximum width and height of loaded textures, see @ref
+   * setMaxTextureSize
+   */
+  int maxTextureSize_ = 0;
+
+  /**
+   * @brief Whether textures are packed into atlases, see @ref
+   * textureAtlases
+   */
+  bool textureAtlases_ = false;
+
+  /**
+   * @brief Directory compressed textures are cached in, see @ref
+   * setTextureCacheDirectory
+   */
+  std::string textureCacheDirectory_;
+
+  /**
+   * @brief Directory collision BVHs are cached in, see @ref
+   * setCollisionCacheDirectory
+   */
+  std::string collisionCacheDirectory_;
+
+  /**
+   * @brief Flag to denote the desire to draw copies of object templates with
+   * instancing, see @ref instancedObjectDrawing.
+   */
+  bool instancedObjectDrawing_ = false;
+
+  /**
+   * @brief Flag to denote the desire to pack static scene meshes into
+   * multi-draw batches, see @ref multiDrawStaticMeshes.
+   */
+  bool multiDrawStaticMeshes_ = false;
+
+  /**
+   * @brief References keeping the shaders compiled by
+   * @ref precompileShaders() alive, the shaders are reference counted
+   */
+  std::vector<
+      Magnum::Resource<Magnum::GL::AbstractShaderProgram, gfx::PhongShader>>
+      precompiledShaders_;
+
+  // ======== Scene asset cache ========
+
+  /**
+   * @brief Estimated CPU and GPU memory used by an asset in bytes
+   */
+  size_t assetByteSize(const LoadedAssetData& loadedAssetData);
+
+  /**
+   * @brief Unload a scene asset, releasing its meshes and textures
+   */
+  void evictSceneAsset(const std::string& filename);
+
+  struct SceneAssetCacheEntry {
+    std::list<std::string>::iterator lruPosition;
+    size_t byteSize;
+    // used by the current scene, see trimSceneAssetCache()
+    bool inUse;
+  };
+
+  /**
+   * @brief Filenames of loaded scene assets, most recently used first
+   */
+  std::list<std::string> sceneAssetLru_;
+
+  std::map<std::string, SceneAssetCacheEntry> sceneAssetCache_;
+  size_t sceneAssetCacheBudget_ = 0;
+  SceneAssetCacheStats sceneAssetCacheStats_;
+
+  // ======== GPU memory budget ========
+
+  /**
+   * @brief Whether @p bytes more GPU memory fit into the budget
+   *
+   * While a scene asset is loaded, unused scene assets are evicted to make
+   * room. Always true without a budget.
+   */
+  bool reserveGpuMemory(size_t bytes);
+
+  size_t gpuMemoryBudget_ = 0;
+
+  bool incrementalMeshUpload_ = false;
+
+  bool releaseUploadData_ = false;
+
+  /**
+   * @brief Release the CPU copies of the meshes of the scene asset loaded from
+   * @p filename, see @ref releaseUploadData(bool)
+   */
+  void releaseSceneUploadData(const std::string& filename);
+
+  /**
+   * @brief Indices into @ref meshes_ of the meshes with an upload started
+   * by @ref loadScene(), see @ref uploadPendingMeshes()
+   */
+  std::deque<int> pendingMeshUploads_;
+
+  /**
+   * @brief Whether @ref reserveGpuMemory() may evict scene assets, only while
+   * @ref loadScene() loads an asset missing in the cache
+   */
+  bool gpuMemoryEvictionAllowed_ = false;
+
+  /** @brief Stage timings of scene loads, see @ref sceneLoadStatistics() */
+  SceneLoadStatistics sceneLoadStatistics_;
+
+  // ======== Scene prefetching ========
+
+  /**
+   * @brief Take the importer prefetched for @p filename, see @ref
+   * prefetchScene()
+   *
+   * Waits for the worker if it's not done yet. Falls back to an importer
+   * preloaded by @ref preloadScene().
+   * @return The opened importer, nullptr if @p filename wasn't prefetched or
+   * failed to open
+   */
+  std::unique_ptr<Importer> takePrefetchedScene(const std::string& filename);
+
+  /**
+   * @brief Pending or finished prefetches, keyed by filename
+   */
+  std::map<std::string, std::future<std::unique_ptr<Importer>>>
+      prefetchedScenes_;
 };
 
 }  // namespace assets
@@ -0,0 +1,118 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Struct @ref esp::assets::SceneLoadStatistics, class
+ * @ref esp::assets::ScopedLoadTimer
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace esp {
+namespace assets {
+
+/**
+@brief Time spent in each stage of the last scene load, for profiling
+
+Filled by @ref ResourceManager::loadScene() and, for the semantic annotations
+and the navmesh, by @ref sim::Simulator::reconfigure(). Times are in
+milliseconds on a steady clock with an arbitrary epoch. GPU uploads are
+measured on the CPU, so they include the time the driver takes to accept the
+data, not necessarily the transfer itself.
+*/
+struct SceneLoadStatistics {
+  /** @brief Load stage */
+  enum class Stage : uint8_t {
+    /** Opening and parsing asset files */
+    ImporterOpen,
+    /** Decoding and uploading textures */
+    Textures,
+    /** Reading and processing meshes */
+    Meshes,
+    /** Reading the transformation hierarchy */
+    MeshHierarchy,
+    /** Reading materials */
+    Materials,
+    /** Uploading mesh buffers */
+    GpuUpload,
+    /** Computing world-space bounding boxes of static drawables */
+    AbsoluteAABBs,
+    /** Loading the semantic annotations */
+    SemanticScene,
+    /** Loading the navmesh */
+    NavMesh,
+    /** Compiling the shaders the materials need */
+    Shaders,
+  };
+
+  /** @brief One timed interval of a stage */
+  struct Event {
+    Stage stage;
+    double startTime;
+    double duration;
+  };
+
+  /** @brief Start of the load */
+  double startTime = 0.0;
+  /** @brief Duration of the whole load */
+  double totalTime = 0.0;
+  /**
+   * @brief Every timed interval in the order they ended
+   *
+   * Stages don't nest, so the intervals don't overlap and a stage can appear
+   * many times, e.g. once per mesh.
+   */
+  std::vector<Event> events;
+
+  /** @brief Summed duration of a stage */
+  double stageTime(Stage stage) const {
+    double time = 0.0;
+    for (const Event& event : events) {
+      if (event.stage == stage) {
+        time += event.duration;
+      }
+    }
+    return time;
+  }
+
+  /** @brief Current time of the clock the statistics use */
+  static double now() {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+};
+
+/**
+@brief Records the time until it goes out of scope as an event of a
+@ref SceneLoadStatistics stage
+*/
+class ScopedLoadTimer {
+ public:
+  ScopedLoadTimer(SceneLoadStatistics& statistics,
+                  SceneLoadStatistics::Stage stage)
+      : statistics_(statistics),
+        stage_(stage),
+        startTime_(SceneLoadStatistics::now()) {}
+
+  ~ScopedLoadTimer() {
+    statistics_.events.push_back(
+        {stage_, startTime_, SceneLoadStatistics::now() - startTime_});
+  }
+
+  ScopedLoadTimer(const ScopedLoadTimer&) = delete;
+  ScopedLoadTimer& operator=(const ScopedLoadTimer&) = delete;
+
+ private:
+  SceneLoadStatistics& statistics_;
+  SceneLoadStatistics::Stage stage_;
+  double startTime_;
+};
+
+}  // namespace assets
+}  // namespace esp
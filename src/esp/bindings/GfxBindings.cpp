@@ -4,17 +4,31 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <algorithm>
+#include <limits>
+
+#include <Corrade/Containers/ArrayView.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 
 #include <Magnum/Python.h>
 #include <Magnum/SceneGraph/Python.h>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/ContextPool.h"
+#include "esp/gfx/DepthUnprojection.h"
+#ifdef ESP_BUILD_WITH_CUDA
+#include "esp/gfx/DeviceBuffer.h"
+#endif
+#include "esp/gfx/ImageWriter.h"
 #include "esp/gfx/LightSetup.h"
 #include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderExecutor.h"
 #include "esp/gfx/Renderer.h"
+#include "esp/gfx/WindowlessContext.h"
 #include "esp/scene/SemanticScene.h"
 
 namespace py = pybind11;
@@ -34,8 +48,43 @@ esp::scene::SceneNode* nodeGetter(T& self) {
 namespace esp {
 namespace gfx {
 
+namespace {
+// the array is copied by ImageWriter::write(), wrapping it is enough. Its
+// rows start at the top, like the observations of the Python API
+bool writeArray(ImageWriter& self,
+                const std::string& filename,
+                const py::array& image,
+                core::DataType dataType) {
+  core::Buffer::ptr buffer = core::Buffer::wrap(
+      const_cast<uint8_t*>(static_cast<const uint8_t*>(image.data())),
+      std::vector<size_t>(image.shape(), image.shape() + image.ndim()),
+      dataType);
+  py::gil_scoped_release release;
+  return self.write(filename, *buffer, true);
+}
+}  // namespace
+
 void initGfxBindings(py::module& m) {
   // ==== RenderCamera ====
+  py::class_<RenderCamera::StateChanges>(m, "StateChanges")
+      .def_readonly("shader", &RenderCamera::StateChanges::shader)
+      .def_readonly("texture", &RenderCamera::StateChanges::texture)
+      .def_readonly("material", &RenderCamera::StateChanges::material)
+      .def_readonly("mesh", &RenderCamera::StateChanges::mesh);
+
+  py::class_<RenderCamera::DrawStatistics>(m, "DrawStatistics")
+      .def_readonly("drawables", &RenderCamera::DrawStatistics::drawables)
+      .def_readonly("culled", &RenderCamera::DrawStatistics::culled)
+      .def_readonly("triangles", &RenderCamera::DrawStatistics::triangles)
+      .def_readonly("cull_time", &RenderCamera::DrawStatistics::cullTime)
+      .def_readonly("occluded", &RenderCamera::DrawStatistics::occluded)
+      .def_readonly("not_potentially_visible",
+                    &RenderCamera::DrawStatistics::notPotentiallyVisible)
+      .def_readonly("state_changes",
+                    &RenderCamera::DrawStatistics::stateChanges)
+      .def_readonly("state_changes_saved",
+                    &RenderCamera::DrawStatistics::stateChangesSaved);
+
   py::class_<RenderCamera, Magnum::SceneGraph::PyFeature<RenderCamera>,
              Magnum::SceneGraph::Camera3D,
              Magnum::SceneGraph::PyFeatureHolder<RenderCamera>>(
@@ -51,7 +100,118 @@ void initGfxBindings(py::module& m) {
       .def_property_readonly("node", nodeGetter<RenderCamera>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<RenderCamera>,
-                             "Alias to node");
+                             "Alias to node")
+      .def_property("state_sorting", &RenderCamera::isStateSortingEnabled,
+                    &RenderCamera::setStateSortingEnabled,
+                    R"(Sort drawables by shader, texture, material and mesh
+                    before drawing them)")
+      .def_property_readonly(
+          "draw_statistics", &RenderCamera::drawStatistics,
+          R"(Drawables drawn and GL state changes issued and saved by state
+          sorting in the last draw of a scene)")
+      .def("reset_draw_statistics", &RenderCamera::resetDrawStatistics);
+
+  // ==== RenderProfiler ====
+  py::class_<RenderProfiler> renderProfiler(m, "RenderProfiler");
+  py::enum_<RenderProfiler::Pass>(renderProfiler, "Pass")
+      .value("DRAW", RenderProfiler::Pass::Draw)
+      .value("READBACK", RenderProfiler::Pass::Readback);
+  py::class_<RenderProfiler::Record>(renderProfiler, "Record")
+      .def_readonly("sensor", &RenderProfiler::Record::sensor)
+      .def_readonly("pass_type", &RenderProfiler::Record::pass)
+      .def_readonly("start_time", &RenderProfiler::Record::startTime)
+      .def_readonly("cpu_time", &RenderProfiler::Record::cpuTime)
+      .def_readonly("gpu_time", &RenderProfiler::Record::gpuTime)
+      .def_readonly("draw_statistics",
+                    &RenderProfiler::Record::drawStatistics);
+  renderProfiler
+      .def_property_readonly("gpu_timing_supported",
+                             &RenderProfiler::isGpuTimingSupported)
+      .def("take_records", &RenderProfiler::takeRecords,
+           R"(Take the records of the passes whose GPU time is known, or of
+           all ended passes if wait is set)",
+           "wait"_a = false);
+
+  // ==== ContextPool ====
+  py::class_<ContextPool> contextPool(m, "ContextPool");
+  py::enum_<ContextPool::Assignment>(contextPool, "Assignment")
+      .value("ROUND_ROBIN", ContextPool::Assignment::RoundRobin)
+      .value("LEAST_LOADED", ContextPool::Assignment::LeastLoaded);
+  contextPool
+      .def_static("instance", &ContextPool::instance,
+                  py::return_value_policy::reference)
+      .def_property("devices", &ContextPool::devices,
+                    &ContextPool::setDevices,
+                    R"(CUDA IDs of the devices simulators are assigned to, all
+                    available devices unless restricted)")
+      .def("assign_device", &ContextPool::assignDevice,
+           R"(Pick a device for a new simulator using the pool, to be set as
+           its gpu_device_id)",
+           "assignment"_a = ContextPool::Assignment::LeastLoaded)
+      .def("load", &ContextPool::load, "gpu_device"_a);
+
+  // ==== RenderExecutor ====
+  py::class_<RenderExecutor, RenderExecutor::ptr>(m, "RenderExecutor")
+      .def(py::init(&RenderExecutor::create<const std::vector<int>&>),
+           "gpu_devices"_a = std::vector<int>{},
+           py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("devices", &RenderExecutor::devices)
+      .def(
+          "_submit",
+          [](RenderExecutor& self, int gpuDevice, py::function task) {
+            // the worker owns the callable only while holding the GIL
+            auto* owned = new py::function{std::move(task)};
+            self.submit(gpuDevice, [owned]() {
+              py::gil_scoped_acquire gil;
+              std::unique_ptr<py::function> callable{owned};
+              (*callable)();
+            });
+          },
+          R"(Queue a callable on the worker of a device. Exceptions escaping
+          it are lost, use submit() instead.)",
+          "gpu_device"_a, "task"_a)
+      .def("_stop", &RenderExecutor::stop,
+           py::call_guard<py::gil_scoped_release>());
+
+  // ==== ImageWriter ====
+  py::class_<ImageWriter, ImageWriter::ptr>(
+      m, "ImageWriter",
+      R"(Encodes and saves images on worker threads. The format follows the
+      file extension; writing blocks while max_queued_images are waiting)")
+      .def(py::init(&ImageWriter::create<size_t, size_t, float>),
+           "thread_count"_a = 1, "max_queued_images"_a = 16,
+           "jpeg_quality"_a = 0.95f)
+      .def_property_readonly("thread_count", &ImageWriter::threadCount)
+      .def_property_readonly("max_queued_images",
+                             &ImageWriter::maxQueuedImages)
+      .def_property("jpeg_quality", &ImageWriter::jpegQuality,
+                    &ImageWriter::setJpegQuality)
+      .def(
+          "write",
+          [](ImageWriter& self, const std::string& filename,
+             const py::array_t<uint8_t, py::array::c_style |
+                                            py::array::forcecast>& image) {
+            return writeArray(self, filename, image,
+                              core::DataType::DT_UINT8);
+          },
+          R"(Queue an (H, W) or (H, W, C) observation, top row first, with 1,
+          3 or 4 channels. Returns False if it isn't an image)",
+          "filename"_a, "image"_a)
+      .def(
+          "write",
+          [](ImageWriter& self, const std::string& filename,
+             const py::array_t<float, py::array::c_style |
+                                          py::array::forcecast>& image) {
+            return writeArray(self, filename, image, core::DataType::DT_FLOAT);
+          },
+          R"(Queue an (H, W) float observation, e.g. depth, into a .hdr file)",
+          "filename"_a, "image"_a)
+      .def("flush", &ImageWriter::flush,
+           R"(Wait until everything queued is written)",
+           py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("pending_images", &ImageWriter::pendingImages)
+      .def_property_readonly("written_images", &ImageWriter::writtenImages)
+      .def_property_readonly("failed_images", &ImageWriter::failedImages);
 
   // ==== Renderer ====
   py::class_<Renderer, Renderer::ptr>(m, "Renderer")
@@ -60,15 +220,77 @@ void initGfxBindings(py::module& m) {
            py::overload_cast<sensor::VisualSensor&, scene::SceneGraph&, bool>(
                &Renderer::draw),
            R"(Draw given scene using the visual sensor)", "visualSensor"_a,
-           "scene"_a, "frustumCulling"_a = true)
+           "scene"_a, "frustumCulling"_a = true,
+           py::call_guard<py::gil_scoped_release>())
       .def("draw",
            py::overload_cast<RenderCamera&, scene::SceneGraph&, bool>(
                &Renderer::draw),
            R"(Draw given scene using the camera)", "camera"_a, "scene"_a,
-           "frustumCulling"_a = true)
-      .def("bind_render_target", &Renderer::bindRenderTarget);
+           "frustumCulling"_a = true, py::call_guard<py::gil_scoped_release>())
+      .def("bind_render_target", &Renderer::bindRenderTarget)
+      .def_property("render_target_sharing", &Renderer::renderTargetSharing,
+                    &Renderer::setRenderTargetSharing,
+                    R"(Whether sensors of the same framebuffer size and depth
+                    unprojection share a pooled render target)")
+      .def_property_readonly("render_target_pool_size",
+                             &Renderer::renderTargetPoolSize)
+      .def("release_unused_render_targets",
+           &Renderer::releaseUnusedRenderTargets,
+           R"(Drop the pooled render targets no sensor is bound to)")
+      .def_property("occlusion_culling", &Renderer::occlusionCulling,
+                    &Renderer::setOcclusionCulling,
+                    R"(Whether sensors skip drawables hidden behind what they
+                    saw in their previous frame)")
+      .def_property("profiling", &Renderer::profiling,
+                    &Renderer::setProfiling,
+                    R"(Whether the draw and readback passes of each sensor
+                    are timed on the CPU and the GPU)")
+      .def_property_readonly("profiler", &Renderer::profiler,
+                             py::return_value_policy::reference_internal,
+                             R"(The RenderProfiler recording the passes, None
+                             unless profiling is enabled)")
+      .def("create_batch_render_target", &Renderer::createBatchRenderTarget,
+           R"(Create a render target holding num_tiles tiles of the sensor's
+           resolution)",
+           "sensor"_a, "num_tiles"_a)
+      .def(
+          "draw_batch",
+          [](Renderer& self, RenderTarget& target,
+             std::vector<sensor::VisualSensor*> sensors,
+             std::vector<scene::SceneGraph*> scenes, bool frustumCulling) {
+            if (sensors.size() != scenes.size())
+              throw py::value_error{
+                  "sensors and scenes must have the same length"};
+            std::vector<Renderer::BatchEntry> entries;
+            entries.reserve(sensors.size());
+            for (size_t i = 0; i < sensors.size(); ++i)
+              entries.push_back({sensors[i], scenes[i]});
+            self.drawBatch(target, entries, frustumCulling);
+          },
+          R"(Draw scenes[i] seen from sensors[i] into tile i of target)",
+          "target"_a, "sensors"_a, "scenes"_a, "frustumCulling"_a = true)
+      .def_static("batch_tile_viewport", &Renderer::batchTileViewport,
+                  "target"_a, "tile_size"_a, "index"_a);
+
+  py::class_<RenderTarget> renderTarget(m, "RenderTarget");
+
+  py::enum_<RenderTarget::FrameType>(renderTarget, "FrameType")
+      .value("RGBA", RenderTarget::FrameType::Rgba)
+      .value("DEPTH", RenderTarget::FrameType::Depth)
+      .value("OBJECT_ID", RenderTarget::FrameType::ObjectId);
 
-  py::class_<RenderTarget>(m, "RenderTarget")
+  py::class_<RenderTarget::OutputFormat>(renderTarget, "OutputFormat")
+      .def(py::init())
+      .def_readwrite("supersampling",
+                     &RenderTarget::OutputFormat::supersampling,
+                     R"(How many times the framebuffer is larger than the
+                     read results, color is averaged when downsampling)")
+      .def_readwrite("grayscale", &RenderTarget::OutputFormat::grayscale,
+                     R"(Convert color to 8-bit luminance)")
+      .def_readwrite("depth_scale", &RenderTarget::OutputFormat::depthScale,
+                     R"(Multiplier of the unprojected depth)");
+
+  renderTarget
       .def("__enter__",
            [](RenderTarget& self) {
              self.renderEnter();
@@ -82,34 +304,91 @@ void initGfxBindings(py::module& m) {
       .def("read_frame_depth", &RenderTarget::readFrameDepth)
       .def("read_frame_object_id", &RenderTarget::readFrameObjectId)
       .def("blit_rgba_to_default", &RenderTarget::blitRgbaToDefault)
+      .def("queue_read_frame",
+           py::overload_cast<RenderTarget::FrameType>(
+               &RenderTarget::queueReadFrame),
+           R"(Queue an asynchronous read of the current frame)", "type"_a)
+      .def("queue_read_frame",
+           py::overload_cast<RenderTarget::FrameType, Magnum::PixelFormat>(
+               &RenderTarget::queueReadFrame),
+           R"(Queue an asynchronous read converted to the given format)",
+           "type"_a, "format"_a)
+      .def("read_queued_frame", &RenderTarget::readQueuedFrame,
+           R"(Retrieve the oldest queued read, returns whether it was ready)",
+           "type"_a, "img"_a, "wait"_a = true)
+      .def("queued_frame_count", &RenderTarget::queuedFrameCount, "type"_a)
+      .def_property("readback_buffer_count",
+                    &RenderTarget::readbackBufferCount,
+                    &RenderTarget::setReadbackBufferCount)
+      .def_property("viewport", &RenderTarget::viewport,
+                    &RenderTarget::setViewport,
+                    R"(Rectangle that draws and reads are restricted to)")
+      .def_property_readonly("framebuffer_size",
+                             &RenderTarget::framebufferSize)
+      .def_property("output_format", &RenderTarget::outputFormat,
+                    &RenderTarget::setOutputFormat,
+                    R"(GPU processing of the results before they are read)")
+      .def_property_readonly("output_viewport", &RenderTarget::outputViewport)
 #ifdef ESP_BUILD_WITH_CUDA
-      .def("read_frame_rgba_gpu",
-           [](RenderTarget& self, size_t devPtr) {
-             /*
-              * Python has no concept of a pointer, so PyTorch thus exposes the
-              pointer to CUDA memory as a simple size_t
-              * Thus we need to take in the pointer as a size_t and then
-              reinterpret_cast it to the correct type.
-              *
-              * What PyTorch does internally is similar to
-              * ::code
-                   uint8_t* tmp = new uint8_t[5];
-                   size_t ptr = reinterpret_cast<size_t>(tmp);
-              *
-              * so reinterpret_cast<uint8_t*> simply undoes the
-              reinterpret_cast<size_t>
-              */
-
-             self.readFrameRgbaGPU(reinterpret_cast<uint8_t*>(devPtr));
-           })
-      .def("read_frame_depth_gpu",
-           [](RenderTarget& self, size_t devPtr) {
-             self.readFrameDepthGPU(reinterpret_cast<float*>(devPtr));
-           })
-      .def("read_frame_object_id_gpu",
-           [](RenderTarget& self, size_t devPtr) {
-             self.readFrameObjectIdGPU(reinterpret_cast<int32_t*>(devPtr));
-           })
+      .def(
+          "read_frame_rgba_gpu",
+          [](RenderTarget& self, size_t devPtr, size_t stream) {
+            /*
+             * Python has no concept of a pointer, so PyTorch thus exposes the
+             pointer to CUDA memory as a simple size_t
+             * Thus we need to take in the pointer as a size_t and then
+             reinterpret_cast it to the correct type.
+             *
+             * What PyTorch does internally is similar to
+             * ::code
+                  uint8_t* tmp = new uint8_t[5];
+                  size_t ptr = reinterpret_cast<size_t>(tmp);
+             *
+             * so reinterpret_cast<uint8_t*> simply undoes the
+             reinterpret_cast<size_t>. The same holds for the stream, e.g.
+             torch.cuda.current_stream().cuda_stream
+             */
+
+            self.readFrameRgbaGPU(reinterpret_cast<uint8_t*>(devPtr),
+                                  reinterpret_cast<cudaStream_t>(stream));
+          },
+          "dev_ptr"_a, "stream"_a = 0)
+      .def(
+          "read_frame_depth_gpu",
+          [](RenderTarget& self, size_t devPtr, size_t stream) {
+            self.readFrameDepthGPU(reinterpret_cast<float*>(devPtr),
+                                   reinterpret_cast<cudaStream_t>(stream));
+          },
+          "dev_ptr"_a, "stream"_a = 0)
+      .def(
+          "read_frame_object_id_gpu",
+          [](RenderTarget& self, size_t devPtr, size_t stream) {
+            self.readFrameObjectIdGPU(reinterpret_cast<int32_t*>(devPtr),
+                                      reinterpret_cast<cudaStream_t>(stream));
+          },
+          "dev_ptr"_a, "stream"_a = 0)
+      .def(
+          "read_frames_gpu",
+          [](RenderTarget& self, size_t rgbaDevPtr, size_t depthDevPtr,
+             size_t objectIdDevPtr, size_t stream) {
+            self.readFramesGPU(reinterpret_cast<uint8_t*>(rgbaDevPtr),
+                               reinterpret_cast<float*>(depthDevPtr),
+                               reinterpret_cast<int32_t*>(objectIdDevPtr),
+                               reinterpret_cast<cudaStream_t>(stream));
+          },
+          R"(Read any of the rendering results into CUDA memory with one map
+          of the interop resources. Results with a zero pointer are skipped.)",
+          "rgba_dev_ptr"_a = 0, "depth_dev_ptr"_a = 0,
+          "object_id_dev_ptr"_a = 0, "stream"_a = 0)
+      .def(
+          "read_frame_to_device",
+          [](RenderTarget& self, RenderTarget::FrameType type, size_t stream) {
+            return self.readFrameToDevice(
+                type, reinterpret_cast<cudaStream_t>(stream));
+          },
+          R"(Read a rendering result into a pooled DeviceBuffer, which can be
+          handed to other frameworks through DLPack.)",
+          "type"_a, "stream"_a = 0)
 #endif
       .def("render_enter", &RenderTarget::renderEnter)
       .def("render_exit", &RenderTarget::renderExit);
@@ -121,18 +400,60 @@ void initGfxBindings(py::module& m) {
 
   py::class_<LightInfo>(m, "LightInfo")
       .def(py::init())
-      .def(py::init<Magnum::Vector3, Magnum::Color4, LightPositionModel>(),
+      .def(py::init<Magnum::Vector3, Magnum::Color4, LightPositionModel,
+                    Magnum::Float>(),
            "position"_a, "color"_a = Magnum::Color4{1},
-           "model"_a = LightPositionModel::GLOBAL)
+           "model"_a = LightPositionModel::GLOBAL,
+           "range"_a = std::numeric_limits<Magnum::Float>::infinity())
       .def_readwrite("position", &LightInfo::position)
       .def_readwrite("color", &LightInfo::color)
       .def_readwrite("model", &LightInfo::model)
+      .def_readwrite(
+          "range", &LightInfo::range,
+          R"(Distance beyond which the light doesn't reach. Objects whose mesh
+          bounds are farther away are drawn without it. Infinite by default)")
       .def(py::self == py::self)
       .def(py::self != py::self);
 
   m.attr("DEFAULT_LIGHTING_KEY") =
       assets::ResourceManager::DEFAULT_LIGHTING_KEY;
   m.attr("NO_LIGHT_KEY") = assets::ResourceManager::NO_LIGHT_KEY;
+
+  m.def("live_gl_context_count", &WindowlessContext::liveCount,
+        R"(Number of GL contexts alive in this process. Forking while it's
+        non-zero leaves the children with a context they can't use.)");
+
+  m.def(
+      "voxel_downsample",
+      [](const py::array_t<float, py::array::c_style | py::array::forcecast>&
+             points,
+         float voxelSize) {
+        // (N, 3) or an (H, W, 3) point observation
+        if (points.ndim() < 2 || points.shape(points.ndim() - 1) != 3) {
+          throw py::value_error{"expected an (..., 3) array of points"};
+        }
+        if (voxelSize <= 0.0f) {
+          throw py::value_error{"expected a positive voxel size"};
+        }
+        std::vector<Magnum::Vector3> result;
+        {
+          py::gil_scoped_release release;
+          result = voxelDownsample(
+              {reinterpret_cast<const Magnum::Vector3*>(points.data()),
+               std::size_t(points.size() / 3)},
+              voxelSize);
+        }
+        py::array_t<float> downsampled({result.size(), std::size_t{3}});
+        if (!result.empty()) {
+          std::copy_n(result[0].data(), result.size() * 3,
+                      downsampled.mutable_data());
+        }
+        return downsampled;
+      },
+      R"(Average the points inside each occupied cubic voxel of the given
+      size, skipping NaN points. Returns an (M, 3) array in the order the
+      voxels were first hit.)",
+      "points"_a, "voxel_size"_a);
 }
 
 }  // namespace gfx
@@ -27,6 +27,31 @@ void initPhysicsBindings(py::module& m) {
       .def_readwrite("ang_vel_is_local", &VelocityControl::angVelIsLocal)
       .def("integrate_transform", &VelocityControl::integrateTransform, "dt"_a,
            "object_transform"_a);
+
+  // ==== struct object PhysicsState ====
+  // opaque, only meant to be handed back to restore_physics_state()
+  py::class_<PhysicsState>(m, "PhysicsState")
+      .def(py::init<>())
+      .def_readonly("world_time", &PhysicsState::worldTime)
+      .def_property_readonly(
+          "num_objects",
+          [](const PhysicsState& self) { return self.objects.size(); });
+
+  // ==== struct object StepStatistics ====
+  py::class_<StepStatistics>(m, "StepStatistics")
+      .def(py::init<>())
+      .def_readonly("active_objects", &StepStatistics::activeObjects)
+      .def_readonly("synced_objects", &StepStatistics::syncedObjects)
+      .def_readonly("sleeping_objects", &StepStatistics::sleepingObjects)
+      .def_readonly("skipped", &StepStatistics::skipped)
+      .def_readonly("substeps", &StepStatistics::subSteps)
+      .def_readonly("start_time", &StepStatistics::startTime)
+      .def_readonly("total_time", &StepStatistics::totalTime)
+      .def_readonly("broadphase_time", &StepStatistics::broadphaseTime)
+      .def_readonly("narrowphase_time", &StepStatistics::narrowphaseTime)
+      .def_readonly("solver_time", &StepStatistics::solverTime)
+      .def_readonly("integration_time", &StepStatistics::integrationTime)
+      .def_readonly("sync_pose_time", &StepStatistics::syncPoseTime);
 }
 
 }  // namespace physics
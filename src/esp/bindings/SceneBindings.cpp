@@ -4,6 +4,8 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <pybind11/numpy.h>
+
 #include <Magnum/Magnum.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 
@@ -225,6 +227,81 @@ void initSceneBindings(py::module& m) {
                              "The semantic category of the object.");
 
   // ==== SemanticScene ====
+  // copies into numpy arrays, for fast filtering
+  auto toArray = [](const std::vector<int>& values) {
+    return py::array_t<int>(values.size(), values.data());
+  };
+  py::class_<SemanticCategoryIndex>(m, "SemanticCategoryIndex")
+      .def_readonly("names", &SemanticCategoryIndex::names,
+                    "Category names, the position is the dense category ID")
+      .def_readonly("ids", &SemanticCategoryIndex::ids,
+                    "Dense ID of each category name")
+      .def_property_readonly(
+          "object_category_ids",
+          [toArray](const SemanticCategoryIndex& self) {
+            return toArray(self.objectCategoryIds);
+          },
+          "Dense category ID of each object, -1 if it has no category")
+      .def_property_readonly(
+          "object_indices",
+          [toArray](const SemanticCategoryIndex& self) {
+            return toArray(self.objectIndices);
+          },
+          "Object indices ordered by category")
+      .def_property_readonly(
+          "offsets",
+          [toArray](const SemanticCategoryIndex& self) {
+            return toArray(self.offsets);
+          },
+          R"(
+        Start of each category in `object_indices`, with the total count at
+        the end
+      )");
+
+  auto viewToArray = [](Corrade::Containers::ArrayView<const int> values) {
+    return py::array_t<int>(values.size(), values.data());
+  };
+  py::class_<SemanticHierarchy>(m, "SemanticHierarchy")
+      .def_property_readonly(
+          "object_regions",
+          [viewToArray](const SemanticHierarchy& self) {
+            return viewToArray(self.objectRegions());
+          },
+          "Index into `SemanticScene.regions` of the region of each object")
+      .def_property_readonly(
+          "region_levels",
+          [viewToArray](const SemanticHierarchy& self) {
+            return viewToArray(self.regionLevels());
+          },
+          "Index into `SemanticScene.levels` of the level of each region")
+      .def(
+          "region_objects",
+          [viewToArray](const SemanticHierarchy& self, int region) {
+            if (region < 0 || size_t(region) >= self.regionCount()) {
+              throw py::index_error();
+            }
+            return viewToArray(self.regionObjects(region));
+          },
+          "Indices of the objects of a region", "region"_a)
+      .def(
+          "level_regions",
+          [viewToArray](const SemanticHierarchy& self, int level) {
+            if (level < 0 || size_t(level) >= self.levelCount()) {
+              throw py::index_error();
+            }
+            return viewToArray(self.levelRegions(level));
+          },
+          "Indices of the regions of a level", "level"_a)
+      .def(
+          "level_objects",
+          [viewToArray](const SemanticHierarchy& self, int level) {
+            if (level < 0 || size_t(level) >= self.levelCount()) {
+              throw py::index_error();
+            }
+            return viewToArray(self.levelObjects(level));
+          },
+          "Indices of the objects of a level", "level"_a);
+
   py::class_<SemanticScene, SemanticScene::ptr>(m, "SemanticScene")
       .def(py::init(&SemanticScene::create<>))
       .def_static(
@@ -253,7 +330,81 @@ void initSceneBindings(py::module& m) {
       .def_property_readonly("semantic_index_map",
                              &SemanticScene::getSemanticIndexMap)
       .def("semantic_index_to_object_index",
-           &SemanticScene::semanticIndexToObjectIndex);
+           &SemanticScene::semanticIndexToObjectIndex)
+      .def_property_readonly("hierarchy", &SemanticScene::hierarchy,
+                             py::return_value_policy::reference_internal,
+                             "Flat, index-based copy of the scene")
+      .def("category_index", &SemanticScene::categoryIndex,
+           py::return_value_policy::reference_internal, R"(
+        Objects grouped by category under the mapping. Only the default
+        mapping is indexed on load, see `build_category_index()`.
+      )",
+           "mapping"_a = "")
+      .def("objects_of_category", &SemanticScene::objectsOfCategory,
+           "Indices into `objects` of the objects of the category", "name"_a,
+           "mapping"_a = "")
+      .def(
+          "semantic_ids_to_categories",
+          [](const SemanticScene& self,
+             py::array_t<uint32_t, py::array::c_style> ids,
+             const std::string& mapping) {
+            self.semanticIdsToCategories(
+                {ids.mutable_data(), std::size_t(ids.size())}, mapping);
+          },
+          R"(
+        Replaces semantic IDs, e.g. a semantic sensor observation, in place
+        with their category index under the mapping. Needs a contiguous
+        uint32 array.
+      )",
+          "ids"_a.noconvert(), "mapping"_a = "")
+      .def("build_category_index", &SemanticScene::buildCategoryIndex,
+           "Groups the objects by category under the mapping",
+           "mapping"_a = "")
+      .def("objects_containing",
+           py::overload_cast<const vec3f&>(&SemanticScene::objectsContaining,
+                                           py::const_),
+           R"(
+        Indices into `objects` of the objects whose bounding box contains the
+        point.
+      )",
+           "point"_a)
+      .def("objects_containing",
+           py::overload_cast<const std::vector<vec3f>&>(
+               &SemanticScene::objectsContaining, py::const_),
+           R"(
+        Indices of the objects containing each of the points.
+      )",
+           "points"_a)
+      .def("objects_within_radius",
+           py::overload_cast<const vec3f&, float>(
+               &SemanticScene::objectsWithinRadius, py::const_),
+           R"(
+        Indices into `objects` of the objects whose bounding box is within
+        radius of the point.
+      )",
+           "point"_a, "radius"_a)
+      .def("objects_within_radius",
+           py::overload_cast<const std::vector<vec3f>&, float>(
+               &SemanticScene::objectsWithinRadius, py::const_),
+           R"(
+        Indices of the objects within radius of each of the points.
+      )",
+           "points"_a, "radius"_a)
+      .def("regions_containing",
+           py::overload_cast<const vec3f&>(&SemanticScene::regionsContaining,
+                                           py::const_),
+           R"(
+        Indices into `regions` of the regions whose bounding box contains the
+        point.
+      )",
+           "point"_a)
+      .def("regions_containing",
+           py::overload_cast<const std::vector<vec3f>&>(
+               &SemanticScene::regionsContaining, py::const_),
+           R"(
+        Indices of the regions containing each of the points.
+      )",
+           "points"_a);
 
   // ==== ObjectControls ====
   py::class_<ObjectControls, ObjectControls::ptr>(m, "ObjectControls")
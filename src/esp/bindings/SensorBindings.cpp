@@ -10,8 +10,15 @@
 #include <Magnum/Python.h>
 #include <Magnum/SceneGraph/Python.h>
 
+#include "esp/sensor/EquirectangularCamera.h"
+#include "esp/sensor/FisheyeCamera.h"
+#include "esp/sensor/ObservationCodec.h"
 #include "esp/sensor/PinholeCamera.h"
+#include "esp/sensor/RayCastCamera.h"
+#include "esp/sensor/ReprojectionCamera.h"
+#include "esp/sensor/RedwoodNoiseModelCPU.h"
 #ifdef ESP_BUILD_WITH_CUDA
+#include "esp/gfx/DeviceBuffer.h"
 #include "esp/sensor/RedwoodNoiseModel.h"
 #endif
 #include "esp/sensor/Sensor.h"
@@ -29,14 +36,213 @@ esp::scene::SceneNode* nodeGetter(T& self) {
     throw py::value_error{"feature not valid"};
   return &self.node();
 };
+
+#ifdef ESP_BUILD_WITH_CUDA
+/* The subset of the DLPack ABI (dlpack.h, v0.2) needed to hand a tensor to
+   consumers such as torch.utils.dlpack.from_dlpack(). Only the layout
+   matters, so it is declared here instead of depending on the header. */
+struct DLContext {
+  int deviceType;
+  int deviceId;
+};
+
+struct DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void* data;
+  DLContext ctx;
+  int ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byteOffset;
+};
+
+struct DLManagedTensor {
+  DLTensor dlTensor;
+  void* managerCtx;
+  void (*deleter)(DLManagedTensor* self);
+};
+
+constexpr int DLDeviceTypeGPU = 2;
+enum DLDataTypeCode : uint8_t { DLInt = 0, DLUInt = 1, DLFloat = 2 };
+
+// name of an unconsumed DLPack capsule, consumers rename it on ingestion
+constexpr const char* DLTensorCapsuleName = "dltensor";
+
+DLDataType dlDataType(esp::core::DataType dataType) {
+  const uint8_t bits = esp::core::getDataTypeByteSize(dataType) * 8;
+  switch (dataType) {
+    case esp::core::DataType::DT_INT8:
+    case esp::core::DataType::DT_INT16:
+    case esp::core::DataType::DT_INT32:
+    case esp::core::DataType::DT_INT64:
+      return {DLInt, bits, 1};
+    case esp::core::DataType::DT_UINT8:
+    case esp::core::DataType::DT_UINT16:
+    case esp::core::DataType::DT_UINT32:
+    case esp::core::DataType::DT_UINT64:
+      return {DLUInt, bits, 1};
+    case esp::core::DataType::DT_FLOAT16:
+    case esp::core::DataType::DT_FLOAT:
+    case esp::core::DataType::DT_DOUBLE:
+      return {DLFloat, bits, 1};
+    default:
+      throw py::type_error{"DeviceBuffer has no data type"};
+  }
+}
+
+// keeps the buffer, and with it the pool slot, alive until the consumer
+// releases the tensor
+struct DLManagerContext {
+  esp::gfx::DeviceBuffer::ptr buffer;
+  std::vector<int64_t> shape;
+  DLManagedTensor tensor;
+};
+
+py::capsule toDLPack(const esp::gfx::DeviceBuffer::ptr& buffer) {
+  auto context = new DLManagerContext{buffer, {}, {}};
+  context->shape.assign(buffer->shape().begin(), buffer->shape().end());
+
+  DLManagedTensor& tensor = context->tensor;
+  tensor.dlTensor.data = buffer->data();
+  tensor.dlTensor.ctx = {DLDeviceTypeGPU, buffer->deviceId()};
+  tensor.dlTensor.ndim = context->shape.size();
+  tensor.dlTensor.dtype = dlDataType(buffer->dataType());
+  tensor.dlTensor.shape = context->shape.data();
+  // compact row-major
+  tensor.dlTensor.strides = nullptr;
+  tensor.dlTensor.byteOffset = 0;
+  tensor.managerCtx = context;
+  tensor.deleter = [](DLManagedTensor* self) {
+    delete static_cast<DLManagerContext*>(self->managerCtx);
+  };
+
+  return py::capsule{&tensor, DLTensorCapsuleName, [](PyObject* capsule) {
+                       // only delete the tensor if nobody consumed it
+                       if (PyCapsule_IsValid(capsule, DLTensorCapsuleName)) {
+                         auto tensor = static_cast<DLManagedTensor*>(
+                             PyCapsule_GetPointer(capsule,
+                                                  DLTensorCapsuleName));
+                         tensor->deleter(tensor);
+                       }
+                     }};
+}
+#endif
 }  // namespace
 
 namespace esp {
 namespace sensor {
 
 void initSensorBindings(py::module& m) {
+#ifdef ESP_BUILD_WITH_CUDA
+  // ==== DeviceBuffer ====
+  py::class_<gfx::DeviceBuffer, gfx::DeviceBuffer::ptr>(m, "DeviceBuffer")
+      .def_property_readonly("shape", &gfx::DeviceBuffer::shape)
+      .def_property_readonly("device_id", &gfx::DeviceBuffer::deviceId)
+      .def_property_readonly(
+          "data_ptr",
+          [](gfx::DeviceBuffer& self) {
+            return reinterpret_cast<size_t>(self.data());
+          })
+      .def("to_dlpack", &toDLPack,
+           R"(Export as a DLPack capsule, e.g. for
+           torch.utils.dlpack.from_dlpack(). The memory stays valid as long as
+           the consumer uses it and is not reused by the render target pool
+           meanwhile.)")
+      .def(
+          "__dlpack__",
+          [](const gfx::DeviceBuffer::ptr& self, py::object) {
+            return toDLPack(self);
+          },
+          "stream"_a = py::none())
+      .def("__dlpack_device__", [](gfx::DeviceBuffer& self) {
+        return py::make_tuple(DLDeviceTypeGPU, self.deviceId());
+      });
+#endif
+
   // ==== Observation ====
-  py::class_<Observation, Observation::ptr>(m, "Observation");
+  py::class_<Observation, Observation::ptr>(m, "Observation")
+      .def(py::init(&Observation::create<>))
+      .def_readonly("buffer", &Observation::buffer,
+                    R"(Observation in CPU memory, np.asarray() gives a view
+                    without a copy)")
+#ifdef ESP_BUILD_WITH_CUDA
+      .def_readonly("device_buffer", &Observation::deviceBuffer,
+                    R"(Observation in CUDA memory, for sensors with
+                    gpu2gpu_transfer enabled)")
+#endif
+      ;
+
+  // ==== ObservationEncoder ====
+  py::enum_<ObservationCodec>(m, "ObservationCodec")
+      .value("LOSSLESS", ObservationCodec::Lossless)
+      .value("QUANTIZED_DEPTH", ObservationCodec::QuantizedDepth);
+
+  py::class_<ObservationEncoderConfiguration>(
+      m, "ObservationEncoderConfiguration")
+      .def(py::init<>())
+      .def_readwrite("codec", &ObservationEncoderConfiguration::codec)
+      .def_readwrite("keyframe_interval",
+                     &ObservationEncoderConfiguration::keyframeInterval,
+                     R"(Frames from one keyframe to the next, the ones in
+                     between are encoded as deltas)")
+      .def_readwrite("compression_level",
+                     &ObservationEncoderConfiguration::compressionLevel,
+                     R"(zlib level from 1 to 9, 0 to not compress)")
+      .def_readwrite("depth_step", &ObservationEncoderConfiguration::depthStep,
+                     R"(Meters per step of QUANTIZED_DEPTH)");
+
+  py::class_<ObservationEncoder, ObservationEncoder::ptr>(m,
+                                                         "ObservationEncoder")
+      .def(py::init(&ObservationEncoder::create<>))
+      .def(py::init(&ObservationEncoder::create<
+                    const ObservationEncoderConfiguration&>),
+           "configuration"_a)
+      .def_property_readonly("configuration",
+                             &ObservationEncoder::configuration)
+      .def("encode", &encodeArray, "observation"_a,
+           R"(Encode an observation array into a packet, None if it can't
+           be encoded with this codec)")
+      .def(
+          "encode",
+          [](ObservationEncoder& self,
+             const Observation& observation) -> py::object {
+            std::vector<uint8_t> packet;
+            {
+              py::gil_scoped_release release;
+              packet = self.encode(observation);
+            }
+            if (packet.empty())
+              return py::none();
+            return py::bytes(reinterpret_cast<const char*>(packet.data()),
+                             packet.size());
+          },
+          "observation"_a)
+      .def("request_keyframe", &ObservationEncoder::requestKeyframe,
+           R"(Encode the next observation whole, e.g. for a receiver that
+           lost a packet)")
+      .def_property_readonly("sequence", &ObservationEncoder::sequence);
+
+  py::class_<ObservationDecoder, ObservationDecoder::ptr>(m,
+                                                         "ObservationDecoder")
+      .def(py::init(&ObservationDecoder::create<>))
+      .def(
+          "decode",
+          [](ObservationDecoder& self, const py::buffer& packet) {
+            const py::buffer_info info = packet.request();
+            py::gil_scoped_release release;
+            return self.decode(static_cast<const uint8_t*>(info.ptr),
+                               info.size * info.itemsize);
+          },
+          "packet"_a,
+          R"(Decode a packet into a Buffer, None if it's malformed or a
+          delta to a frame that wasn't decoded)")
+      .def("reset", &ObservationDecoder::reset);
 
   // TODO fill out other SensorTypes
   // ==== enum SensorType ====
@@ -46,6 +252,21 @@ void initSensorBindings(py::module& m) {
       .value("DEPTH", SensorType::DEPTH)
       .value("SEMANTIC", SensorType::SEMANTIC);
 
+  py::enum_<ObservationLayout>(m, "ObservationLayout")
+      .value("DEFAULT", ObservationLayout::DEFAULT)
+      .value("RGB", ObservationLayout::RGB)
+      .value("GRAYSCALE", ObservationLayout::GRAYSCALE)
+      .value("DEPTH_MILLIMETERS", ObservationLayout::DEPTH_MILLIMETERS)
+      .value("DEPTH_HALF", ObservationLayout::DEPTH_HALF)
+      .value("POINTS_CAMERA", ObservationLayout::POINTS_CAMERA)
+      .value("POINTS_WORLD", ObservationLayout::POINTS_WORLD)
+      .value("SEMANTIC_HISTOGRAM", ObservationLayout::SEMANTIC_HISTOGRAM);
+
+  py::enum_<ReadbackMode>(m, "ReadbackMode")
+      .value("SYNCHRONOUS", ReadbackMode::Synchronous)
+      .value("FENCED", ReadbackMode::Fenced)
+      .value("PREVIOUS_FRAME", ReadbackMode::PreviousFrame);
+
   // ==== SensorSpec ====
   py::class_<SensorSpec, SensorSpec::ptr>(m, "SensorSpec", py::dynamic_attr())
       .def(py::init(&SensorSpec::create<>))
@@ -59,6 +280,31 @@ void initSensorBindings(py::module& m) {
       .def_readwrite("channels", &SensorSpec::channels)
       .def_readwrite("encoding", &SensorSpec::encoding)
       .def_readwrite("gpu2gpu_transfer", &SensorSpec::gpu2gpuTransfer)
+      .def_readwrite("semantic_category_ids", &SensorSpec::semanticCategoryIds)
+      .def_readwrite("update_interval", &SensorSpec::updateInterval,
+                     R"(Render every update_interval-th observation and return
+                     the previous one in between. 0 renders only when
+                     requested with Sensor.request_update())")
+      .def_readwrite("supersampling", &SensorSpec::supersampling,
+                     R"(Render at resolution * supersampling and downsample to
+                     resolution on the GPU, averaging color)")
+      .def_readwrite("minimal_attachments", &SensorSpec::minimalAttachments,
+                     R"(Allocate only the attachment the sensor type reads.
+                     Depth sensors then draw depth only, without shading)")
+      .def_readwrite("msaa_samples", &SensorSpec::msaaSamples,
+                     R"(Samples per pixel of multisampled rendering for color
+                     sensors, 0 or 1 for none)")
+      .def_readwrite("observation_layout", &SensorSpec::observationLayout,
+                     R"(Pixel layout of the observations, converted on the GPU
+                     before readback)")
+      .def_readwrite("semantic_histogram_bins",
+                     &SensorSpec::semanticHistogramBins,
+                     R"(Number of object IDs, from 0, whose pixels a
+                     SEMANTIC_HISTOGRAM observation counts)")
+      .def_readwrite("pinned_observations", &SensorSpec::pinnedObservations,
+                     R"(Read observations back into page-locked memory, so
+                     torch.Tensor.cuda(non_blocking=True) and other CUDA copies
+                     of them are asynchronous DMA transfers)")
       .def_readwrite("observation_space", &SensorSpec::observationSpace)
       .def_readwrite("noise_model", &SensorSpec::noiseModel)
       .def_property(
@@ -90,6 +336,12 @@ void initSensorBindings(py::module& m) {
       .def("set_transformation_from_spec", &Sensor::setTransformationFromSpec)
       .def("is_visual_sensor", &Sensor::isVisualSensor)
       .def("get_observation", &Sensor::getObservation)
+      .def("request_update", &Sensor::requestUpdate,
+           R"(Render the next observation even if the update interval would
+           skip it)")
+      .def("schedule_observation", &Sensor::scheduleObservation,
+           R"(Advance the update schedule by one observation and return
+           whether it has to be rendered)")
       .def_property_readonly("node", nodeGetter<Sensor>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<Sensor>, "Alias to node");
@@ -99,7 +351,50 @@ void initSensorBindings(py::module& m) {
              Magnum::SceneGraph::PyFeatureHolder<VisualSensor>>(m,
                                                                 "VisualSensor")
       .def_property_readonly("framebuffer_size", &VisualSensor::framebufferSize)
-      .def_property_readonly("render_target", &VisualSensor::renderTarget);
+      .def_property_readonly("output_size", &VisualSensor::outputSize,
+                             R"(Size of the observations, [W, H])")
+      .def_property_readonly("render_target", &VisualSensor::renderTarget)
+      .def_property_readonly(
+          "needs_render_target", &VisualSensor::needsRenderTarget,
+          R"(Whether the sensor draws through a render target, false for ray
+          cast sensors)")
+      .def_property_readonly(
+          "shares_render_target", &VisualSensor::sharesRenderTarget,
+          R"(Whether the render target is shared with other sensors)")
+      .def_property("readback_mode", &VisualSensor::readbackMode,
+                    &VisualSensor::setReadbackMode,
+                    R"(How rendering results are read back to the CPU)")
+      .def_property(
+          "observation_buffer_pooling",
+          &VisualSensor::observationBufferPooling,
+          [](VisualSensor& self, bool enabled) {
+            self.setObservationBufferPooling(enabled);
+          },
+          R"(Give every observation its own buffer, reused only once nothing
+          references it anymore. Otherwise the next observation overwrites the
+          previous one)")
+      .def("set_observation_buffer_pooling",
+           &VisualSensor::setObservationBufferPooling, "enabled"_a,
+           "capacity"_a = 2, "storage"_a = core::BufferStorage::Aligned,
+           py::return_value_policy::reference)
+      .def_property_readonly("observation_buffer_pool",
+                             &VisualSensor::observationBufferPool)
+      .def(
+          "set_depth_noise_model",
+          [](VisualSensor& self,
+             const Eigen::Ref<const Eigen::RowMatrixXf>& model,
+             float noiseMultiplier) {
+            // the reference may be strided, copy row by row
+            std::vector<float> data(model.size());
+            Eigen::Map<Eigen::RowMatrixXf>(data.data(), model.rows(),
+                                           model.cols()) = model;
+            self.setDepthNoiseModel(std::move(data), noiseMultiplier);
+          },
+          "model"_a, "noise_multiplier"_a = 1.0f,
+          R"(Apply the Redwood depth noise model while rendering, so a single
+          readback returns noisy depth. Pass an empty model to disable)")
+      .def_property_readonly("has_depth_noise_model",
+                             &VisualSensor::hasDepthNoiseModel);
 
   // ==== PinholeCamera (subclass of Sensor) ====
   py::class_<PinholeCamera, Magnum::SceneGraph::PyFeature<PinholeCamera>,
@@ -107,7 +402,104 @@ void initSensorBindings(py::module& m) {
       m, "PinholeCamera")
       // initialized, attached to pinholeCameraNode, status: "valid"
       .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
-                          const SensorSpec::ptr&>());
+                          const SensorSpec::ptr&>())
+      .def(
+          "read_observation",
+          [](PinholeCamera& self, py::array buffer) {
+            ObservationSpace space;
+            self.getObservationSpace(space);
+            size_t size = core::getDataTypeByteSize(space.dataType);
+            for (size_t extent : space.shape) {
+              size *= extent;
+            }
+            if (!(buffer.flags() & py::array::c_style) ||
+                size_t(buffer.nbytes()) != size) {
+              throw py::value_error(
+                  "Expected a contiguous array of the observation size");
+            }
+            self.readObservation(
+                {static_cast<uint8_t*>(buffer.mutable_data()), size},
+                self.renderTarget(), ReadbackMode::Synchronous);
+          },
+          "buffer"_a,
+          R"(Read the last drawn observation into a contiguous array of the
+          observation's shape and type, in the observation layout)")
+      .def("draw_observation", &PinholeCamera::drawObservation, "sim"_a,
+           R"(Draw an observation into the render target using the
+           simulator's renderer)");
+
+  // ==== EquirectangularCamera (subclass of PinholeCamera) ====
+  py::class_<EquirectangularCamera,
+             Magnum::SceneGraph::PyFeature<EquirectangularCamera>,
+             PinholeCamera,
+             Magnum::SceneGraph::PyFeatureHolder<EquirectangularCamera>>(
+      m, "EquirectangularCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const SensorSpec::ptr&>())
+      .def_property_readonly("cube_map_size",
+                             &EquirectangularCamera::cubeMapSize,
+                             R"(Edge length of the cube map faces, in pixels)");
+
+  // ==== FisheyeCamera (subclass of PinholeCamera) ====
+  py::class_<FisheyeCamera, Magnum::SceneGraph::PyFeature<FisheyeCamera>,
+             PinholeCamera, Magnum::SceneGraph::PyFeatureHolder<FisheyeCamera>>(
+      m, "FisheyeCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const SensorSpec::ptr&>())
+      .def_property_readonly("source_size", &FisheyeCamera::sourceSize,
+                             R"(Size of the intermediate pinhole view)")
+      .def_property_readonly(
+          "source_hfov", &FisheyeCamera::sourceHfov,
+          R"(Horizontal field of view of the intermediate view, in degrees)");
+
+  // ==== RayCastCamera (subclass of PinholeCamera) ====
+  py::class_<RayCastCamera, Magnum::SceneGraph::PyFeature<RayCastCamera>,
+             PinholeCamera, Magnum::SceneGraph::PyFeatureHolder<RayCastCamera>>(
+      m, "RayCastCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const SensorSpec::ptr&>())
+      .def(
+          "read_observation",
+          [](RayCastCamera& self, py::array buffer) {
+            ObservationSpace space;
+            self.getObservationSpace(space);
+            size_t size = core::getDataTypeByteSize(space.dataType);
+            for (size_t extent : space.shape) {
+              size *= extent;
+            }
+            if (!(buffer.flags() & py::array::c_style) ||
+                size_t(buffer.nbytes()) != size) {
+              throw py::value_error(
+                  "Expected a contiguous array of the observation size");
+            }
+            self.readObservation(
+                {static_cast<uint8_t*>(buffer.mutable_data()), size});
+          },
+          "buffer"_a,
+          R"(Copy the last traced observation into a contiguous array of the
+          observation's shape and type)")
+      .def("draw_observation", &RayCastCamera::drawObservation, "sim"_a,
+           R"(Trace an observation of the simulator's active scene on the
+           CPU)");
+
+  // ==== ReprojectionCamera (subclass of PinholeCamera) ====
+  py::class_<ReprojectionCamera,
+             Magnum::SceneGraph::PyFeature<ReprojectionCamera>, PinholeCamera,
+             Magnum::SceneGraph::PyFeatureHolder<ReprojectionCamera>>(
+      m, "ReprojectionCamera")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const SensorSpec::ptr&>())
+      .def_property_readonly(
+          "reprojection_coverage", &ReprojectionCamera::reprojectionCoverage,
+          R"(Fraction of the pixels of the last observation that came from
+          the keyframe, 1 if it was rendered)")
+      .def_property_readonly(
+          "last_observation_reprojected",
+          &ReprojectionCamera::lastObservationReprojected)
+      .def_property_readonly("rendered_frame_count",
+                             &ReprojectionCamera::renderedFrameCount)
+      .def_property_readonly("reprojected_frame_count",
+                             &ReprojectionCamera::reprojectedFrameCount);
 
   // ==== SensorSuite ====
   py::class_<SensorSuite, SensorSuite::ptr>(m, "SensorSuite")
@@ -115,6 +507,14 @@ void initSensorBindings(py::module& m) {
       .def("add", &SensorSuite::add)
       .def("get", &SensorSuite::get, R"(get the sensor by id)");
 
+  py::class_<RedwoodNoiseModelCPUImpl, RedwoodNoiseModelCPUImpl::uptr>(
+      m, "RedwoodNoiseModelCPUImpl")
+      .def(py::init(&RedwoodNoiseModelCPUImpl::create_unique<
+                    const Eigen::Ref<const Eigen::RowMatrixXf>&, float>))
+      .def("simulate_from_cpu", &RedwoodNoiseModelCPUImpl::simulateFromCPU,
+           py::call_guard<py::gil_scoped_release>())
+      .def("seed", &RedwoodNoiseModelCPUImpl::seed, "new_seed"_a);
+
 #ifdef ESP_BUILD_WITH_CUDA
   py::class_<RedwoodNoiseModelGPUImpl, RedwoodNoiseModelGPUImpl::uptr>(
       m, "RedwoodNoiseModelGPUImpl")
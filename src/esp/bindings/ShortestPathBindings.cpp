@@ -4,8 +4,11 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <algorithm>
+
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include <Magnum/Math/Vector3.h>
@@ -13,6 +16,7 @@
 #include "esp/core/esp.h"
 #include "esp/nav/GreedyFollower.h"
 #include "esp/nav/PathFinder.h"
+#include "esp/nav/TopDownMap.h"
 #include "esp/scene/ObjectControls.h"
 
 namespace py = pybind11;
@@ -22,6 +26,43 @@ using py::literals::operator""_a;
 namespace esp {
 namespace nav {
 
+namespace {
+
+using PointArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+Corrade::Containers::ArrayView<const vec3f> pointView(
+    const PointArray& points) {
+  if (points.ndim() != 2 || points.shape(1) != 3) {
+    throw py::value_error{"expected an (N, 3) array of points"};
+  }
+  return {reinterpret_cast<const vec3f*>(points.data()),
+          std::size_t(points.shape(0))};
+}
+
+template <void (PathFinder::*step)(Corrade::Containers::ArrayView<const vec3f>,
+                                   Corrade::Containers::ArrayView<const vec3f>,
+                                   Corrade::Containers::ArrayView<vec3f>)>
+py::array_t<float> trySteps(PathFinder& self,
+                            const PointArray& starts,
+                            const PointArray& ends) {
+  const auto startView = pointView(starts);
+  const auto endView = pointView(ends);
+  if (startView.size() != endView.size()) {
+    throw py::value_error{"expected as many ends as starts"};
+  }
+  py::array_t<float> results({startView.size(), std::size_t{3}});
+  {
+    py::gil_scoped_release release;
+    (self.*step)(startView, endView,
+                 {reinterpret_cast<vec3f*>(results.mutable_data()),
+                  startView.size()});
+  }
+  return results;
+}
+
+}  // namespace
+
 void initShortestPathBindings(py::module& m) {
   py::class_<HitRecord>(m, "HitRecord")
       .def(py::init())
@@ -29,6 +70,20 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite("hit_normal", &HitRecord::hitNormal)
       .def_readwrite("hit_dist", &HitRecord::hitDist);
 
+  py::class_<PathCacheStatistics>(m, "PathCacheStatistics")
+      .def_readonly("hits", &PathCacheStatistics::hits)
+      .def_readonly("misses", &PathCacheStatistics::misses)
+      .def_readonly("size", &PathCacheStatistics::size)
+      .def_readonly("capacity", &PathCacheStatistics::capacity)
+      .def_property_readonly("hit_rate", &PathCacheStatistics::hitRate);
+
+  py::class_<RandomPointConstraints>(m, "RandomPointConstraints")
+      .def(py::init<>())
+      .def_readwrite("min_island_radius",
+                     &RandomPointConstraints::minIslandRadius)
+      .def_readwrite("min_height", &RandomPointConstraints::minHeight)
+      .def_readwrite("max_height", &RandomPointConstraints::maxHeight);
+
   py::class_<ShortestPath, ShortestPath::ptr>(m, "ShortestPath")
       .def(py::init(&ShortestPath::create<>))
       .def_readwrite("requested_start", &ShortestPath::requestedStart)
@@ -46,6 +101,12 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite("geodesic_distance",
                      &MultiGoalShortestPath::geodesicDistance);
 
+  py::class_<GeodesicDistanceField, GeodesicDistanceField::ptr>(
+      m, "GeodesicDistanceField")
+      .def(py::init(&GeodesicDistanceField::create<>))
+      .def_property("goals", &GeodesicDistanceField::getGoals,
+                    &GeodesicDistanceField::setGoals);
+
   py::class_<NavMeshSettings, NavMeshSettings::ptr>(m, "NavMeshSettings")
       .def(py::init(&NavMeshSettings::create<>))
       .def_readwrite("cell_size", &NavMeshSettings::cellSize)
@@ -67,6 +128,7 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite("filter_ledge_spans", &NavMeshSettings::filterLedgeSpans)
       .def_readwrite("filter_walkable_low_height_spans",
                      &NavMeshSettings::filterWalkableLowHeightSpans)
+      .def_readwrite("tile_size", &NavMeshSettings::tileSize)
       .def("set_defaults", &NavMeshSettings::setDefaults);
 
   py::class_<PathFinder, PathFinder::ptr>(m, "PathFinder")
@@ -76,24 +138,151 @@ void initShortestPathBindings(py::module& m) {
       .def("get_topdown_view", &PathFinder::getTopDownView,
            R"(Returns the topdown view of the PathFinder's navmesh.)",
            "pixelsPerMeter"_a, "height"_a)
-      .def("get_random_navigable_point", &PathFinder::getRandomNavigablePoint)
+      .def("get_random_navigable_point", &PathFinder::getRandomNavigablePoint,
+           "min_island_radius"_a = 0.0f)
+      .def(
+          "get_random_navigable_points",
+          [](const PathFinder& self, std::size_t count, uint32_t seed,
+             const RandomPointConstraints& constraints) {
+            std::vector<vec3f> points;
+            {
+              py::gil_scoped_release release;
+              points = self.getRandomNavigablePoints(count, seed, constraints);
+            }
+            py::array_t<float> results({count, std::size_t{3}});
+            float* out = results.mutable_data();
+            for (const vec3f& pt : points) {
+              out = std::copy_n(pt.data(), 3, out);
+            }
+            return results;
+          },
+          "count"_a, "seed"_a,
+          "constraints"_a = RandomPointConstraints{})
+      // the queries don't touch Python objects, so let other threads run
       .def("find_path", py::overload_cast<ShortestPath&>(&PathFinder::findPath),
-           "path"_a)
+           "path"_a, py::call_guard<py::gil_scoped_release>())
       .def("find_path",
            py::overload_cast<MultiGoalShortestPath&>(&PathFinder::findPath),
-           "path"_a)
+           "path"_a, py::call_guard<py::gil_scoped_release>())
+      .def(
+          "find_paths",
+          [](PathFinder& self, const std::vector<ShortestPath::ptr>& paths) {
+            // the list holds Python-owned objects, so work on a copy with the
+            // GIL released and write the results back afterwards
+            std::vector<ShortestPath> batch(paths.size());
+            for (size_t i = 0; i < paths.size(); ++i) {
+              batch[i].requestedStart = paths[i]->requestedStart;
+              batch[i].requestedEnd = paths[i]->requestedEnd;
+            }
+            size_t found;
+            {
+              py::gil_scoped_release release;
+              found = self.findPaths(batch);
+            }
+            for (size_t i = 0; i < paths.size(); ++i) {
+              paths[i]->points = std::move(batch[i].points);
+              paths[i]->geodesicDistance = batch[i].geodesicDistance;
+            }
+            return found;
+          },
+          R"(Find many shortest paths at once, spread across worker threads.
+          Populates points and geodesic_distance of every path and returns
+          the number of paths that exist.)",
+          "paths"_a)
+      .def(
+          "find_geodesic_distances",
+          [](PathFinder& self,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 starts,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 ends) {
+            if (starts.ndim() != 2 || starts.shape(1) != 3 ||
+                ends.ndim() != 2 || ends.shape(1) != 3 ||
+                starts.shape(0) != ends.shape(0)) {
+              throw py::value_error{
+                  "expected starts and ends of the same (N, 3) shape"};
+            }
+            const size_t count = starts.shape(0);
+            py::array_t<float> distances(count);
+            {
+              py::gil_scoped_release release;
+              self.findGeodesicDistances(
+                  {reinterpret_cast<const vec3f*>(starts.data()), count},
+                  {reinterpret_cast<const vec3f*>(ends.data()), count},
+                  {distances.mutable_data(), count});
+            }
+            return distances;
+          },
+          R"(Geodesic distances between each row of starts and ends, both
+          (N, 3) arrays, spread across worker threads. inf where no path
+          exists.)",
+          "starts"_a, "ends"_a)
+      .def("geodesic_distance", &PathFinder::geodesicDistance, "field"_a,
+           "point"_a, py::call_guard<py::gil_scoped_release>(),
+           R"(Geodesic distance from point to the closest goal of field. The
+          field is built on first use, later calls are lookups only.)")
+      .def(
+          "distance_matrix",
+          [](PathFinder& self,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 points) {
+            if (points.ndim() != 2 || points.shape(1) != 3) {
+              throw py::value_error{"expected points of (K, 3) shape"};
+            }
+            const size_t count = points.shape(0);
+            py::array_t<float> distances({count, count});
+            {
+              py::gil_scoped_release release;
+              self.distanceMatrix(
+                  {reinterpret_cast<const vec3f*>(points.data()), count},
+                  {distances.mutable_data(), count * count});
+            }
+            return distances;
+          },
+          R"(Geodesic distances between all pairs of a (K, 3) array of
+          points as a (K, K) array, row i holding the distances from point i.
+          inf where either point isn't navigable or no path exists.)",
+          "points"_a)
       .def("try_step", &PathFinder::tryStep<Magnum::Vector3>, "start"_a,
-           "end"_a)
-      .def("try_step", &PathFinder::tryStep<vec3f>, "start"_a, "end"_a)
+           "end"_a, py::call_guard<py::gil_scoped_release>())
+      .def("try_step", &PathFinder::tryStep<vec3f>, "start"_a, "end"_a,
+           py::call_guard<py::gil_scoped_release>())
       .def("try_step_no_sliding",
-           &PathFinder::tryStepNoSliding<Magnum::Vector3>, "start"_a, "end"_a)
+           &PathFinder::tryStepNoSliding<Magnum::Vector3>, "start"_a, "end"_a,
+           py::call_guard<py::gil_scoped_release>())
       .def("try_step_no_sliding", &PathFinder::tryStepNoSliding<vec3f>,
-           "start"_a, "end"_a)
+           "start"_a, "end"_a, py::call_guard<py::gil_scoped_release>())
       .def("snap_point", &PathFinder::snapPoint<Magnum::Vector3>)
       .def("snap_point", &PathFinder::snapPoint<vec3f>)
+      .def("try_steps", &trySteps<&PathFinder::trySteps>, "starts"_a,
+           "ends"_a,
+           R"(Batched try_step() for rows of starts and ends, both (N, 3)
+          arrays, spread across worker threads. Returns an (N, 3) array.)")
+      .def("try_steps_no_sliding", &trySteps<&PathFinder::tryStepsNoSliding>,
+           "starts"_a, "ends"_a,
+           R"(Batched try_step_no_sliding(), see try_steps().)")
+      .def(
+          "snap_points",
+          [](PathFinder& self, const PointArray& points) {
+            const auto pointsView = pointView(points);
+            py::array_t<float> results({pointsView.size(), std::size_t{3}});
+            {
+              py::gil_scoped_release release;
+              self.snapPoints(
+                  pointsView,
+                  {reinterpret_cast<vec3f*>(results.mutable_data()),
+                   pointsView.size()});
+            }
+            return results;
+          },
+          R"(Batched snap_point() for an (N, 3) array of points.)",
+          "points"_a)
       .def("island_radius", &PathFinder::islandRadius, "pt"_a)
       .def_property_readonly("is_loaded", &PathFinder::isLoaded)
-      .def("load_nav_mesh", &PathFinder::loadNavMesh)
+      .def("load_nav_mesh", &PathFinder::loadNavMesh, "path"_a,
+           "map_file"_a = true)
+      .def("save_nav_mesh", &PathFinder::saveNavMesh, "path"_a,
+           "compress"_a = false)
       .def("distance_to_closest_obstacle",
            &PathFinder::distanceToClosestObstacle,
            R"(Returns the distance to the closest obstacle.)", "pt"_a,
@@ -103,9 +292,78 @@ void initShortestPathBindings(py::module& m) {
            R"(Returns the hit_pos, hit_normal and hit_dist of the surface point
           on the closest obstacle.)",
            "pt"_a, "max_search_radius"_a = 2.0)
+      .def("set_obstacle_distance_field",
+           &PathFinder::setObstacleDistanceField,
+           R"(Answer distance_to_closest_obstacle() and
+          closest_obstacle_surface_point() from a grid of precomputed
+          distances with cell_size spacing, built on first use and saved with
+          the navmesh. A cell_size of 0 disables it.)",
+           "cell_size"_a, "max_search_radius"_a = 2.0)
+      .def("set_path_cache", &PathFinder::setPathCache,
+           R"(Cache up to capacity find_path() results, keyed by the snapped
+          polygons and the endpoints rounded to quantization. 0 disables it.)",
+           "capacity"_a, "quantization"_a = 1.0e-3f)
+      .def_property_readonly("path_cache_statistics",
+                             &PathFinder::pathCacheStatistics)
+      .def_property_readonly("obstacle_distance_field_cell_size",
+                             &PathFinder::obstacleDistanceFieldCellSize)
+      .def("set_hierarchical_pathfinding",
+           &PathFinder::setHierarchicalPathfinding,
+           R"(Search paths with endpoints at least min_distance apart on a
+          graph of cluster_size clusters of navmesh polygons first, then only
+          in the clusters it picks. Faster for long paths, which may come out
+          slightly longer. A cluster_size of 0 disables it.)",
+           "cluster_size"_a, "min_distance"_a = 10.0f)
+      .def_property_readonly("hierarchical_pathfinding_cluster_size",
+                             &PathFinder::hierarchicalPathfindingClusterSize)
       .def("is_navigable", &PathFinder::isNavigable,
            R"(Checks to see if the agent can stand at the specified point.)",
-           "pt"_a, "max_y_delta"_a = 0.5);
+           "pt"_a, "max_y_delta"_a = 0.5)
+      .def(
+          "are_navigable",
+          [](const PathFinder& self, const PointArray& points,
+             float maxYDelta) {
+            const auto pointsView = pointView(points);
+            py::array_t<bool> results(pointsView.size());
+            {
+              py::gil_scoped_release release;
+              self.areNavigable(pointsView,
+                                {results.mutable_data(), pointsView.size()},
+                                maxYDelta);
+            }
+            return results;
+          },
+          R"(Batched is_navigable() for an (N, 3) array of points.)",
+          "points"_a, "max_y_delta"_a = 0.5);
+
+  py::class_<TopDownMap, TopDownMap::ptr>(m, "TopDownMap", R"(
+      Top-down navigability map of a navmesh slice that accumulates the
+      pixels an agent has seen, rows along z and columns along x starting at
+      the lower bounds of the navmesh)")
+      .def(py::init(&TopDownMap::create<PathFinder&, float, float>),
+           "pathfinder"_a, "pixels_per_meter"_a, "height"_a)
+      .def_property_readonly("pixels_per_meter", &TopDownMap::pixelsPerMeter)
+      .def_property_readonly("navigable", &TopDownMap::navigable,
+                             R"(Navigability of each pixel)")
+      .def_property_readonly(
+          "visible", &TopDownMap::visible,
+          R"(Pixels seen since the construction or the last reset, the
+          complement of the fog of war)")
+      .def("to_grid", &TopDownMap::toGrid, "point"_a,
+           R"(Row and column of the pixel containing the point)")
+      .def(
+          "update_visibility",
+          [](TopDownMap& self, const vec3f& position, const vec4f& rotation,
+             float hfov, float maxDistance) {
+            return self.updateVisibility(
+                position, Eigen::Map<const quatf>(rotation.data()), hfov,
+                maxDistance);
+          },
+          "position"_a, "rotation"_a, "hfov"_a, "max_distance"_a,
+          R"(Mark the pixels visible from an agent at position with the
+          rotation given as (x, y, z, w) coefficients and the horizontal field
+          of view in degrees, returning how many weren't visible before)")
+      .def("reset_visibility", &TopDownMap::resetVisibility);
 
   // this enum is used by GreedyGeodesicFollowerImpl so it needs to be defined
   // before it
@@ -4,6 +4,9 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <vector>
+
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
@@ -11,10 +14,17 @@
 #include <Magnum/Python.h>
 #include <Magnum/SceneGraph/Python.h>
 
+#include <pybind11/numpy.h>
+
+#include "esp/core/SharedMemoryRing.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/Renderer.h"
+#include "esp/physics/PhysicsManager.h"
 #include "esp/scene/SemanticScene.h"
+#include "esp/sim/BatchedSimulator.h"
+#include "esp/sim/ObservationRecorder.h"
 #include "esp/sim/Simulator.h"
+#include "esp/sim/SimulatorCheckpoint.h"
 
 namespace py = pybind11;
 using py::literals::operator""_a;
@@ -22,6 +32,156 @@ using py::literals::operator""_a;
 namespace esp {
 namespace sim {
 
+namespace {
+using IdArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+using FloatArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+Corrade::Containers::ArrayView<const int> idView(const IdArray& ids) {
+  if (ids.ndim() != 1) {
+    throw py::value_error{"expected a 1D array of object IDs"};
+  }
+  return {ids.data(), std::size_t(ids.shape(0))};
+}
+
+// Wraps a contiguous numpy array without copying, for the duration of a call
+core::Buffer::ptr wrapArray(const py::array& array) {
+  if (!(array.flags() & py::array::c_style)) {
+    throw py::value_error{"expected a contiguous array"};
+  }
+  core::DataType dataType = core::DataType::DT_NONE;
+  if (py::isinstance<py::array_t<uint8_t>>(array)) {
+    dataType = core::DataType::DT_UINT8;
+  } else if (py::isinstance<py::array_t<int8_t>>(array)) {
+    dataType = core::DataType::DT_INT8;
+  } else if (py::isinstance<py::array_t<uint16_t>>(array)) {
+    dataType = core::DataType::DT_UINT16;
+  } else if (py::isinstance<py::array_t<int16_t>>(array)) {
+    dataType = core::DataType::DT_INT16;
+  } else if (py::isinstance<py::array_t<uint32_t>>(array)) {
+    dataType = core::DataType::DT_UINT32;
+  } else if (py::isinstance<py::array_t<int32_t>>(array)) {
+    dataType = core::DataType::DT_INT32;
+  } else if (py::isinstance<py::array_t<uint64_t>>(array)) {
+    dataType = core::DataType::DT_UINT64;
+  } else if (py::isinstance<py::array_t<int64_t>>(array)) {
+    dataType = core::DataType::DT_INT64;
+  } else if (py::isinstance<py::array_t<float>>(array)) {
+    dataType = core::DataType::DT_FLOAT;
+  } else if (py::isinstance<py::array_t<double>>(array)) {
+    dataType = core::DataType::DT_DOUBLE;
+  } else {
+    throw py::type_error{"unsupported array data type"};
+  }
+  return core::Buffer::wrap(
+      const_cast<uint8_t*>(static_cast<const uint8_t*>(array.data())),
+      std::vector<size_t>(array.shape(), array.shape() + array.ndim()),
+      dataType);
+}
+
+// Fills an (N, components) array of all or the selected objects
+template <class T,
+          void (Simulator::*get)(Corrade::Containers::ArrayView<const int>,
+                                 Corrade::Containers::ArrayView<T>,
+                                 int)>
+py::array_t<float> getBatched(Simulator& self,
+                              const IdArray& ids,
+                              int sceneID) {
+  const auto idsView = idView(ids);
+  const std::size_t count = idsView.empty()
+                                ? self.getExistingObjectIDs(sceneID).size()
+                                : idsView.size();
+  py::array_t<float> values({count, sizeof(T) / sizeof(float)});
+  (self.*get)(idsView, {reinterpret_cast<T*>(values.mutable_data()), count},
+              sceneID);
+  return values;
+}
+
+template <class T,
+          void (Simulator::*set)(Corrade::Containers::ArrayView<const int>,
+                                 Corrade::Containers::ArrayView<const T>,
+                                 int)>
+void setBatched(Simulator& self,
+                const FloatArray& values,
+                const IdArray& ids,
+                int sceneID) {
+  const auto idsView = idView(ids);
+  if (values.ndim() != 2 ||
+      std::size_t(values.shape(1)) != sizeof(T) / sizeof(float)) {
+    throw py::value_error{"expected an (N, " +
+                          std::to_string(sizeof(T) / sizeof(float)) +
+                          ") array"};
+  }
+  const std::size_t count = values.shape(0);
+  const std::size_t expected = idsView.empty()
+                                   ? self.getExistingObjectIDs(sceneID).size()
+                                   : idsView.size();
+  if (count != expected) {
+    throw py::value_error{"expected one value per object"};
+  }
+  (self.*set)(idsView, {reinterpret_cast<const T*>(values.data()), count},
+              sceneID);
+}
+
+Corrade::Containers::ArrayView<const Magnum::Vector3> rayView(
+    const FloatArray& rays) {
+  if (rays.ndim() != 2 || rays.shape(1) != 3) {
+    throw py::value_error{"expected an (N, 3) array of rays"};
+  }
+  return {reinterpret_cast<const Magnum::Vector3*>(rays.data()),
+          std::size_t(rays.shape(0))};
+}
+
+// Returns (object_ids, distances, points, normals) of the closest hits
+py::tuple castRays(Simulator& self,
+                   const FloatArray& origins,
+                   const FloatArray& directions,
+                   float maxDistance,
+                   int sceneID) {
+  const auto originsView = rayView(origins);
+  const auto directionsView = rayView(directions);
+  if (originsView.size() != directionsView.size()) {
+    throw py::value_error{"expected as many origins as directions"};
+  }
+  const std::size_t count = originsView.size();
+  std::vector<physics::RayHit> hits(count);
+  {
+    py::gil_scoped_release release;
+    self.castRays(originsView, directionsView, maxDistance, hits, sceneID);
+  }
+
+  py::array_t<int> objectIDs(count);
+  py::array_t<float> distances(count);
+  py::array_t<float> points({count, std::size_t{3}});
+  py::array_t<float> normals({count, std::size_t{3}});
+  auto objectIDsData = objectIDs.mutable_unchecked<1>();
+  auto distancesData = distances.mutable_unchecked<1>();
+  auto pointsData = points.mutable_unchecked<2>();
+  auto normalsData = normals.mutable_unchecked<2>();
+  for (std::size_t i = 0; i < count; ++i) {
+    objectIDsData(i) = hits[i].objectID;
+    distancesData(i) = hits[i].distance;
+    for (std::size_t j = 0; j < 3; ++j) {
+      pointsData(i, j) = hits[i].point[j];
+      normalsData(i, j) = hits[i].normal[j];
+    }
+  }
+  return py::make_tuple(objectIDs, distances, points, normals);
+}
+
+py::array_t<bool> contactTests(Simulator& self,
+                               const IdArray& ids,
+                               int sceneID) {
+  const auto idsView = idView(ids);
+  const std::size_t count = idsView.empty()
+                                ? self.getExistingObjectIDs(sceneID).size()
+                                : idsView.size();
+  py::array_t<bool> results(count);
+  self.contactTests(idsView, {results.mutable_data(), count}, sceneID);
+  return results;
+}
+}  // namespace
+
 void initSimBindings(py::module& m) {
   // ==== SimulatorConfiguration ====
   py::class_<SimulatorConfiguration, SimulatorConfiguration::ptr>(
@@ -33,12 +193,92 @@ void initSimBindings(py::module& m) {
       .def_readwrite("default_camera_uuid",
                      &SimulatorConfiguration::defaultCameraUuid)
       .def_readwrite("gpu_device_id", &SimulatorConfiguration::gpuDeviceId)
+      .def_readwrite("context_pool", &SimulatorConfiguration::contextPool)
+      .def_readwrite("share_context", &SimulatorConfiguration::shareContext)
+      .def_readwrite("gpu_local_affinity",
+                     &SimulatorConfiguration::gpuLocalAffinity,
+                     R"(Pin the threads to the CPUs next to gpu_device_id and
+                     allocate their memory on its NUMA node)")
       .def_readwrite("compress_textures",
                      &SimulatorConfiguration::compressTextures)
+      .def_readwrite("optimize_meshes", &SimulatorConfiguration::optimizeMeshes)
+      .def_readwrite("lazy_object_templates",
+                     &SimulatorConfiguration::lazyObjectTemplates)
+      .def_readwrite("compact_mesh_layout",
+                     &SimulatorConfiguration::compactMeshLayout)
+      .def_readwrite("primitive_object_ids",
+                     &SimulatorConfiguration::primitiveObjectIds)
+      .def_readwrite("ptex_vertex_pulling",
+                     &SimulatorConfiguration::ptexVertexPulling)
+      .def_readwrite("mesh_lod_levels", &SimulatorConfiguration::meshLodLevels)
+      .def_readwrite("mesh_lod_pixel_error",
+                     &SimulatorConfiguration::meshLodPixelError)
+      .def_readwrite("max_texture_size",
+                     &SimulatorConfiguration::maxTextureSize)
+      .def_readwrite("texture_size_from_sensors",
+                     &SimulatorConfiguration::textureSizeFromSensors)
+      .def_readwrite("texture_cache_directory",
+                     &SimulatorConfiguration::textureCacheDirectory)
+      .def_readwrite(
+          "collision_cache_directory",
+          &SimulatorConfiguration::collisionCacheDirectory,
+          R"(Directory the collision BVHs of static scene meshes are saved to
+          and loaded from on later loads, empty to always build them)")
+      .def_readwrite(
+          "texture_atlases", &SimulatorConfiguration::textureAtlases,
+          R"(Pack equally sized textures of an asset into atlases, so that
+          materials differing only in their texture share bindings and
+          instanced or multi-draw batches)")
+      .def_readwrite("shader_cache_directory",
+                     &SimulatorConfiguration::shaderCacheDirectory)
       .def_readwrite("allow_sliding", &SimulatorConfiguration::allowSliding)
       .def_readwrite("create_renderer", &SimulatorConfiguration::createRenderer)
+      .def_readwrite("cpu_scene_geometry",
+                     &SimulatorConfiguration::cpuSceneGeometry,
+                     R"(Load the scene geometry on the CPU without a renderer
+                     or physics, for ray cast sensors)")
       .def_readwrite("frustum_culling", &SimulatorConfiguration::frustumCulling)
+      .def_readwrite("occlusion_culling",
+                     &SimulatorConfiguration::occlusionCulling)
+      .def_readwrite("potentially_visible_sets",
+                     &SimulatorConfiguration::potentiallyVisibleSets)
+      .def_readwrite("instanced_object_drawing",
+                     &SimulatorConfiguration::instancedObjectDrawing)
+      .def_readwrite("multi_draw_static_meshes",
+                     &SimulatorConfiguration::multiDrawStaticMeshes)
+      .def_readwrite("semantic_ids_on_render_mesh",
+                     &SimulatorConfiguration::semanticIdsOnRenderMesh)
+      .def_readwrite("share_render_targets",
+                     &SimulatorConfiguration::shareRenderTargets)
+      .def_readwrite(
+          "multi_view_rendering", &SimulatorConfiguration::multiViewRendering,
+          R"(Draw pinhole sensors that only differ in their position, e.g.
+          stereo pairs, with one pass over the drawables)")
+      .def_readwrite(
+          "parallel_culling", &SimulatorConfiguration::parallelCulling,
+          R"(Frustum cull for all sensors of a step at once, distributed over
+          threads, before any of them is drawn)")
+      .def_readwrite("scene_asset_cache_budget",
+                     &SimulatorConfiguration::sceneAssetCacheBudget)
+      .def_readwrite("gpu_memory_budget",
+                     &SimulatorConfiguration::gpuMemoryBudget)
+      .def_readwrite(
+          "mesh_upload_budget", &SimulatorConfiguration::meshUploadBudget,
+          R"(Bytes of scene mesh data uploaded per frame, 0 to upload meshes
+          while the scene loads. Meshes are invisible until complete)")
+      .def_readwrite(
+          "release_mesh_upload_data",
+          &SimulatorConfiguration::releaseMeshUploadData,
+          R"(Free the CPU copies of scene mesh data that only the GPU upload
+          needs, keeping what collisions, navmesh recomputation and semantic
+          queries read)")
+      .def_readwrite("max_resident_scenes",
+                     &SimulatorConfiguration::maxResidentScenes)
       .def_readwrite("enable_physics", &SimulatorConfiguration::enablePhysics)
+      .def_readwrite(
+          "object_pooling", &SimulatorConfiguration::objectPooling,
+          R"(Keep removed objects out of simulation and reuse them for the next
+          object added from their template, instead of building them again)")
       .def_readwrite("physics_config_file",
                      &SimulatorConfiguration::physicsConfigFile)
       .def_readwrite("scene_light_setup",
@@ -46,6 +286,171 @@ void initSimBindings(py::module& m) {
       .def(py::self == py::self)
       .def(py::self != py::self);
 
+  m.def("max_texture_size_for_sensors", &maxTextureSizeForSensors,
+        "sensor_specs"_a);
+
+  // ==== SceneAssetCacheStats ====
+  py::class_<assets::ResourceManager::SceneAssetCacheStats>(
+      m, "SceneAssetCacheStats")
+      .def_readonly("hits",
+                    &assets::ResourceManager::SceneAssetCacheStats::hits)
+      .def_readonly("misses",
+                    &assets::ResourceManager::SceneAssetCacheStats::misses)
+      .def_readonly("evictions",
+                    &assets::ResourceManager::SceneAssetCacheStats::evictions)
+      .def_readonly("entries",
+                    &assets::ResourceManager::SceneAssetCacheStats::entries)
+      .def_readonly("byte_size",
+                    &assets::ResourceManager::SceneAssetCacheStats::byteSize);
+
+  // ==== ObservationCacheStats ====
+  py::class_<ObservationCache::Stats>(m, "ObservationCacheStats")
+      .def_readonly("hits", &ObservationCache::Stats::hits)
+      .def_readonly("misses", &ObservationCache::Stats::misses)
+      .def_readonly("evictions", &ObservationCache::Stats::evictions)
+      .def_readonly("entries", &ObservationCache::Stats::entries)
+      .def_readonly("byte_size", &ObservationCache::Stats::byteSize)
+      .def_property_readonly("hit_rate", &ObservationCache::Stats::hitRate);
+
+  // ==== SceneLoadStatistics ====
+  py::class_<assets::SceneLoadStatistics> sceneLoadStatistics(
+      m, "SceneLoadStatistics");
+  py::enum_<assets::SceneLoadStatistics::Stage>(sceneLoadStatistics, "Stage")
+      .value("IMPORTER_OPEN",
+             assets::SceneLoadStatistics::Stage::ImporterOpen)
+      .value("TEXTURES", assets::SceneLoadStatistics::Stage::Textures)
+      .value("MESHES", assets::SceneLoadStatistics::Stage::Meshes)
+      .value("MESH_HIERARCHY",
+             assets::SceneLoadStatistics::Stage::MeshHierarchy)
+      .value("MATERIALS", assets::SceneLoadStatistics::Stage::Materials)
+      .value("GPU_UPLOAD", assets::SceneLoadStatistics::Stage::GpuUpload)
+      .value("ABSOLUTE_AABBS",
+             assets::SceneLoadStatistics::Stage::AbsoluteAABBs)
+      .value("SEMANTIC_SCENE",
+             assets::SceneLoadStatistics::Stage::SemanticScene)
+      .value("NAVMESH", assets::SceneLoadStatistics::Stage::NavMesh)
+      .value("SHADERS", assets::SceneLoadStatistics::Stage::Shaders);
+  py::class_<assets::SceneLoadStatistics::Event>(sceneLoadStatistics, "Event")
+      .def_readonly("stage", &assets::SceneLoadStatistics::Event::stage)
+      .def_readonly("start_time",
+                    &assets::SceneLoadStatistics::Event::startTime)
+      .def_readonly("duration", &assets::SceneLoadStatistics::Event::duration);
+  sceneLoadStatistics
+      .def_readonly("start_time", &assets::SceneLoadStatistics::startTime)
+      .def_readonly("total_time", &assets::SceneLoadStatistics::totalTime)
+      .def_readonly("events", &assets::SceneLoadStatistics::events)
+      .def("stage_time", &assets::SceneLoadStatistics::stageTime, "stage"_a);
+
+  // ==== GpuMemoryUsage ====
+  py::class_<assets::ResourceManager::GpuMemoryUsage>(m, "GpuMemoryUsage")
+      .def_readonly("vertex_bytes",
+                    &assets::ResourceManager::GpuMemoryUsage::vertexBytes)
+      .def_readonly("index_bytes",
+                    &assets::ResourceManager::GpuMemoryUsage::indexBytes)
+      .def_readonly("texture_bytes",
+                    &assets::ResourceManager::GpuMemoryUsage::textureBytes)
+      .def_property_readonly(
+          "total_bytes", &assets::ResourceManager::GpuMemoryUsage::totalBytes);
+
+  // ==== AgentObservations ====
+  py::class_<AgentObservations, AgentObservations::ptr>(m, "AgentObservations")
+      .def_readonly("sensor_uuids", &AgentObservations::sensorUuids)
+      .def("__len__",
+           [](const AgentObservations& self) {
+             return self.observations.size();
+           })
+      .def(
+          "__getitem__",
+          [](AgentObservations& self, size_t index) -> sensor::Observation& {
+            if (index >= self.observations.size()) {
+              throw py::index_error{};
+            }
+            return self.observations[index];
+          },
+          py::return_value_policy::reference_internal);
+
+  // ==== BatchObservations ====
+  py::class_<BatchObservations, BatchObservations::ptr> batchObservations(
+      m, "BatchObservations");
+  py::class_<BatchObservations::Tensor>(batchObservations, "Tensor")
+      .def_readonly("buffer", &BatchObservations::Tensor::buffer,
+                    R"(Observations stacked along the first dimension)")
+      .def_readonly("sensors", &BatchObservations::Tensor::sensors,
+                    R"(Agent id and sensor uuid of each row)");
+  batchObservations.def_readonly("tensors", &BatchObservations::tensors);
+
+  // ==== ViewpointSettings, ObjectViewpoints ====
+  py::class_<ViewpointSettings, ViewpointSettings::ptr>(m, "ViewpointSettings")
+      .def(py::init(&ViewpointSettings::create<>))
+      .def_readwrite("spacing", &ViewpointSettings::spacing,
+                     R"(Spacing of the candidate grid, in meters)")
+      .def_readwrite("max_distance", &ViewpointSettings::maxDistance,
+                     R"(Greatest horizontal distance from the object's OBB)")
+      .def_readwrite("max_y_delta", &ViewpointSettings::maxYDelta,
+                     R"(Greatest height difference between the navmesh and
+                     the bottom of the object)")
+      .def_readwrite("sensor_height", &ViewpointSettings::sensorHeight,
+                     R"(Height above the navmesh the rays start at)")
+      .def_readwrite("min_visible_fraction",
+                     &ViewpointSettings::minVisibleFraction,
+                     R"(Fraction of the rays that have to reach the object)");
+  py::class_<ObjectViewpoints, ObjectViewpoints::ptr>(m, "ObjectViewpoints")
+      .def_readonly("object_index", &ObjectViewpoints::objectIndex,
+                    R"(Index into SemanticScene.objects)")
+      .def_readonly("viewpoints", &ObjectViewpoints::viewpoints)
+      .def_readonly("visible_fractions", &ObjectViewpoints::visibleFractions);
+
+  // ==== SimulatorCheckpoint ====
+  py::class_<SimulatorCheckpoint, SimulatorCheckpoint::ptr>(
+      m, "SimulatorCheckpoint",
+      R"(In-memory snapshot made by Simulator.checkpoint())")
+      .def_readonly("scene_id", &SimulatorCheckpoint::sceneId)
+      .def_property_readonly("world_time",
+                             [](const SimulatorCheckpoint& self) {
+                               return self.physics.worldTime;
+                             })
+      .def("__copy__",
+           [](const SimulatorCheckpoint& self) {
+             return SimulatorCheckpoint{self};
+           })
+      .def("__deepcopy__", [](const SimulatorCheckpoint& self,
+                              py::dict) { return SimulatorCheckpoint{self}; });
+
+  // ==== Trajectory ====
+  py::class_<Trajectory, Trajectory::ptr>(m, "Trajectory")
+      .def(py::init(&Trajectory::create<>))
+      .def_readonly("action_names", &Trajectory::actionNames)
+      .def("__len__",
+           [](const Trajectory& self) { return self.frames.size(); })
+      .def(
+          "frame_actions",
+          [](const Trajectory& self, size_t index) {
+            if (index >= self.frames.size()) {
+              throw py::index_error{};
+            }
+            std::vector<std::pair<int, std::string>> actions;
+            for (const Trajectory::Action& action :
+                 self.frames[index].actions) {
+              actions.emplace_back(action.agentId,
+                                   self.actionNames[action.name]);
+            }
+            return actions;
+          },
+          R"(Agent id and action name pairs taken in a frame)", "index"_a)
+      .def("save", &Trajectory::save, "filename"_a)
+      .def_static(
+          "load",
+          [](const std::string& filename) {
+            Corrade::Containers::Optional<Trajectory> trajectory =
+                Trajectory::load(filename);
+            if (!trajectory) {
+              throw py::value_error{"Trajectory.load(): cannot read " +
+                                    filename};
+            }
+            return std::move(*trajectory);
+          },
+          "filename"_a);
+
   // ==== Simulator ====
   py::class_<Simulator, Simulator::ptr>(m, "Simulator")
       .def(py::init(&Simulator::create<const SimulatorConfiguration&>))
@@ -58,13 +463,241 @@ void initSimBindings(py::module& m) {
            pybind11::return_value_policy::reference)
       .def_property_readonly("semantic_scene", &Simulator::getSemanticScene)
       .def_property_readonly("renderer", &Simulator::getRenderer)
+      .def("save_frame", &Simulator::saveFrame,
+           R"(Save the observation of the default camera as an image, encoded
+           and written by image_writer in the background)",
+           "filename"_a)
+      .def_property("image_writer", &Simulator::getImageWriter,
+                    &Simulator::setImageWriter)
       .def("seed", &Simulator::seed, "new_seed"_a)
+      .def("random_stream", &Simulator::randomStream, "stream"_a,
+           R"(Independent random stream of the current seed, e.g. one per
+           episode or per worker, see CounterRandom.split())")
       .def("reconfigure", &Simulator::reconfigure, "configuration"_a)
+      .def("prefetch_scene", &Simulator::prefetchScene, "configuration"_a,
+           R"(Start loading the navmesh and parsing the scene of the given
+           configuration on worker threads, so a later reconfigure() to it
+           only has to upload to the GPU.)")
+      .def_static("preload", &Simulator::preload, "configuration"_a,
+                  R"(Load the navmesh, semantic scene and scene meshes of the
+           given configuration for all simulators of this process, without
+           a GL context. Meant to be called before forking workers, which
+           then inherit them, see habitat_sim.fork_server.)")
+      .def_static("clear_preloaded", &Simulator::clearPreloaded,
+                  R"(Drop everything loaded by preload())")
+      .def_static("preloaded_count", &Simulator::preloadedCount,
+                  R"(Number of navmeshes, semantic scenes and scene assets
+           loaded by preload() and not taken by a simulator of this process
+           yet)")
+      .def("get_resident_scenes", &Simulator::getResidentScenes,
+           R"(IDs of the scenes kept loaded, most recently active first)")
+      .def("set_active_scene", &Simulator::setActiveScene,
+           R"(Switch to a resident scene without loading or resetting
+           anything)",
+           "scene_id"_a)
       .def("reset", &Simulator::reset)
+      .def("step",
+           py::overload_cast<int, const std::string&, double>(
+               &Simulator::step),
+           R"(Act, step physics and observe in one call. The returned
+           observations are indexed by sensor and overwritten by the next step
+           of the same agent)",
+           "agent_id"_a, "action"_a, "dt"_a = 1.0 / 60.0,
+           py::return_value_policy::reference_internal,
+           py::call_guard<py::gil_scoped_release>())
+      .def("step",
+           py::overload_cast<const std::vector<std::pair<int, std::string>>&,
+                             double>(&Simulator::step),
+           R"(Act for many agents, step physics once and observe all of them.
+           Returns one tensor per sensor type, overwritten by the next batched
+           step)",
+           "actions"_a, "dt"_a = 1.0 / 60.0,
+           py::return_value_policy::reference_internal,
+           py::call_guard<py::gil_scoped_release>())
+      .def("step_agents", &Simulator::stepAgents,
+           R"(Act for many agents and step physics once, without observing)",
+           "actions"_a, "dt"_a = 1.0 / 60.0,
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "get_agent_states",
+          [](Simulator& self, const std::vector<int>& agentIds) {
+            py::array_t<float> positions({agentIds.size(), size_t(3)});
+            py::array_t<float> rotations({agentIds.size(), size_t(4)});
+            bool found;
+            {
+              py::gil_scoped_release release;
+              found = self.getAgentStates(
+                  agentIds,
+                  {positions.mutable_data(), size_t(positions.size())},
+                  {rotations.mutable_data(), size_t(rotations.size())});
+            }
+            if (!found) {
+              throw py::index_error{"get_agent_states(): no such agent"};
+            }
+            return py::make_tuple(positions, rotations);
+          },
+          "agent_ids"_a,
+          R"(Positions as an Nx3 and rotations as an Nx4 array of quaternion
+          coefficients x, y, z, w of the agents, in one call)")
+      .def(
+          "set_agent_states",
+          [](Simulator& self, const std::vector<int>& agentIds,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 positions,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 rotations,
+             bool resetSensors) {
+            if (positions.size() != ssize_t(3 * agentIds.size()) ||
+                rotations.size() != ssize_t(4 * agentIds.size())) {
+              throw py::value_error{
+                  "set_agent_states(): expected Nx3 positions and Nx4 "
+                  "rotations for N agents"};
+            }
+            py::gil_scoped_release release;
+            return self.setAgentStates(
+                agentIds, {positions.data(), size_t(positions.size())},
+                {rotations.data(), size_t(rotations.size())}, resetSensors);
+          },
+          "agent_ids"_a, "positions"_a, "rotations"_a,
+          "reset_sensors"_a = true,
+          R"(Move the agents to Nx3 positions and Nx4 rotations in one call.
+          Returns False if an agent doesn't exist or its rotation isn't
+          normalized, those are skipped. Sensors are reset lazily, once they
+          are next used.)")
+      .def(
+          "render_agent_poses",
+          [](Simulator& self, int agentId,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 positions,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 rotations,
+             const std::vector<std::string>& sensorUuids, bool sortPoses) {
+            const size_t count = positions.size() / 3;
+            if (positions.size() != ssize_t(3 * count) ||
+                rotations.size() != ssize_t(4 * count)) {
+              throw py::value_error{
+                  "render_agent_poses(): expected Nx3 positions and Nx4 "
+                  "rotations for N poses"};
+            }
+            agent::Agent::ptr ag = self.getAgent(agentId);
+            if (ag == nullptr) {
+              throw py::value_error{"render_agent_poses(): no such agent"};
+            }
+            std::map<std::string, core::Buffer::ptr> tensors;
+            std::vector<Corrade::Containers::ArrayView<uint8_t>> outputs;
+            for (const std::string& uuid : sensorUuids) {
+              sensor::Sensor::ptr sensor = ag->getSensorSuite().get(uuid);
+              sensor::ObservationSpace space;
+              if (sensor == nullptr || !sensor->getObservationSpace(space) ||
+                  tensors.count(uuid)) {
+                throw py::value_error{
+                    "render_agent_poses(): no sensor or a duplicate " + uuid};
+              }
+              std::vector<size_t> shape{count};
+              shape.insert(shape.end(), space.shape.begin(),
+                           space.shape.end());
+              core::Buffer::ptr& tensor = tensors[uuid];
+              tensor = core::Buffer::create(shape, space.dataType);
+              outputs.push_back(tensor->data);
+            }
+            bool rendered;
+            {
+              py::gil_scoped_release release;
+              rendered = self.renderAgentPoses(
+                  agentId, {positions.data(), size_t(positions.size())},
+                  {rotations.data(), size_t(rotations.size())}, sensorUuids,
+                  outputs, sortPoses);
+            }
+            if (!rendered) {
+              throw py::value_error{
+                  "render_agent_poses(): can't render the sensors, see the "
+                  "log"};
+            }
+            return tensors;
+          },
+          "agent_id"_a, "positions"_a, "rotations"_a, "sensor_uuids"_a,
+          "sort_poses"_a = true,
+          R"(Render pinhole sensors of an agent from Nx3 positions and Nx4
+          rotations of the agent, back to back. Returns a dict of sensor uuids
+          and buffers of N observations each, row i seen from pose i; the
+          agent is moved back afterwards)")
+      .def("draw_multi_view", &Simulator::drawMultiView, "sensors"_a,
+           R"(Draw the sensors that can share a pass over the drawables,
+           returns whether each was drawn. The others have to be drawn on
+           their own)",
+           py::call_guard<py::gil_scoped_release>())
+      .def("cull_ahead", &Simulator::cullAhead, "sensors"_a,
+           R"(Frustum cull for the next draw of each sensor, distributed over
+           threads)",
+           py::call_guard<py::gil_scoped_release>())
+      .def("upload_pending_meshes", &Simulator::uploadPendingMeshes,
+           R"(Upload the next mesh_upload_budget bytes of the scene meshes,
+           everything left if it's 0. Returns the number of bytes uploaded)")
+      .def_property_readonly("has_pending_mesh_uploads",
+                             &Simulator::hasPendingMeshUploads)
+      .def("get_observations_byte_size", &Simulator::getObservationsByteSize,
+           "agent_id"_a,
+           R"(Bytes a SharedMemoryRing slot needs for write_observations())")
+      .def("write_observations", &Simulator::writeObservations, "agent_id"_a,
+           "ring"_a,
+           R"(Draw the cameras of an agent straight into the next slot of a
+           SharedMemoryRing, for a reader in another process. Returns the slot
+           sequence number, 0 if the ring is full.)",
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "get_agent_observations",
+          [](Simulator& self, int agentId) {
+            std::map<std::string, sensor::Observation> observations;
+            {
+              py::gil_scoped_release release;
+              self.getAgentObservations(agentId, observations);
+            }
+            return observations;
+          },
+          R"(Render and read back the observations of all sensors of an
+          agent, keyed by sensor uuid)",
+          "agent_id"_a)
       .def_property_readonly("gpu_device", &Simulator::gpuDevice)
       .def_property("frustum_culling", &Simulator::isFrustumCullingEnabled,
                     &Simulator::setFrustumCullingEnabled,
                     R"(Enable or disable the frustum culling)")
+      .def_property_readonly("scene_asset_cache_stats",
+                             &Simulator::getSceneAssetCacheStats)
+      .def_property_readonly("gpu_memory_usage", &Simulator::getGpuMemoryUsage)
+      .def_property_readonly("scene_load_statistics",
+                             &Simulator::getSceneLoadStatistics)
+      .def_property("pipelined_stepping", &Simulator::isPipelinedStepping,
+                    &Simulator::setPipelinedStepping,
+                    R"(Make step() return the previous step's observations so
+                    rendering overlaps the CPU work of the next step)")
+      .def("start_recording", &Simulator::startRecording,
+           R"(Record the actions and poses of every step)")
+      .def("stop_recording", &Simulator::stopRecording)
+      .def_property_readonly("is_recording", &Simulator::isRecording)
+      .def("record_frame", &Simulator::recordFrame, "actions"_a)
+      .def("set_replay_frame", &Simulator::setReplayFrame,
+           R"(Put the world in a recorded frame without stepping physics)",
+           "trajectory"_a, "index"_a)
+      .def("set_observation_cache", &Simulator::setObservationCache,
+           R"(Cache the observations of get_agent_observations() by quantized
+           sensor pose and scene state, up to max_byte_size bytes)",
+           "max_byte_size"_a, "position_resolution"_a = 0.001f,
+           "rotation_resolution"_a = 0.001f)
+      .def_property_readonly("observation_cache_stats",
+                             &Simulator::getObservationCacheStats)
+      .def("invalidate_observation_cache",
+           &Simulator::invalidateObservationCache)
+      .def("set_replay_observation_cache_capacity",
+           &Simulator::setReplayObservationCacheCapacity, "capacity"_a)
+      .def(
+          "get_replay_observations",
+          [](Simulator& self, int agentId) {
+            py::gil_scoped_release release;
+            return self.getReplayObservations(agentId);
+          },
+          R"(Observations of an agent in the replayed frame, served from the
+          replay observation cache if enabled)",
+          "agent_id"_a)
       /* --- Physics functions --- */
       .def("add_object", &Simulator::addObject, "object_lib_index"_a,
            "attachment_node"_a, "light_setup_key"_a, "scene_id"_a = 0)
@@ -75,15 +708,51 @@ void initSimBindings(py::module& m) {
       .def("load_object_configs", &Simulator::loadObjectConfigs, "path"_a)
       .def("load_object_template", &Simulator::loadObjectTemplate,
            "object_template"_a, "object_template_handle"_a)
+      .def("prefetch_object_template", &Simulator::prefetchObjectTemplate,
+           "template_id"_a)
       .def("remove_object", &Simulator::removeObject, "object_id"_a,
            "delete_object_node"_a, "delete_visual_node"_a, "sceneID"_a = 0)
       .def("get_object_motion_type", &Simulator::getObjectMotionType,
            "object_id"_a, "sceneID"_a = 0)
       .def("set_object_motion_type", &Simulator::setObjectMotionType,
            "motion_type"_a, "object_id"_a, "sceneID"_a = 0)
+      .def("get_object_kinematic_collisions",
+           &Simulator::getObjectKinematicCollisions, "object_id"_a,
+           "sceneID"_a = 0)
+      .def("set_object_kinematic_collisions",
+           &Simulator::setObjectKinematicCollisions, "enabled"_a,
+           "object_id"_a, "sceneID"_a = 0)
       .def("get_existing_object_ids", &Simulator::getExistingObjectIDs,
            "sceneID"_a = 0)
-      .def("step_world", &Simulator::stepWorld, "dt"_a = 1.0 / 60.0)
+      .def("step_world", &Simulator::stepWorld, "dt"_a = 1.0 / 60.0,
+           py::call_guard<py::gil_scoped_release>())
+      .def("step_world_substeps", &Simulator::stepWorldSubSteps,
+           "num_substeps"_a, py::call_guard<py::gil_scoped_release>())
+      .def("set_physics_timestep", &Simulator::setPhysicsTimestep, "dt"_a,
+           "sceneID"_a = 0)
+      .def("get_physics_timestep", &Simulator::getPhysicsTimestep,
+           "sceneID"_a = 0)
+      .def("set_physics_max_substeps", &Simulator::setPhysicsMaxSubSteps,
+           "max_substeps"_a, "sceneID"_a = 0)
+      .def("get_physics_max_substeps", &Simulator::getPhysicsMaxSubSteps,
+           "sceneID"_a = 0)
+      .def_static("step_worlds", &Simulator::stepWorlds, "simulators"_a,
+                  "dt"_a = 1.0 / 60.0,
+                  py::call_guard<py::gil_scoped_release>())
+      .def("save_physics_state", &Simulator::savePhysicsState,
+           "sceneID"_a = 0)
+      .def("restore_physics_state", &Simulator::restorePhysicsState,
+           "state"_a, "sceneID"_a = 0)
+      .def("checkpoint", &Simulator::checkpoint,
+           R"(Snapshot agent and sensor poses, the physical world with its
+           objects and the random generators in memory)")
+      .def("restore", &Simulator::restore, "checkpoint"_a,
+           R"(Return to a snapshot made by checkpoint(), without loading any
+           assets)")
+      .def("get_physics_step_statistics", &Simulator::getPhysicsStepStatistics,
+           "sceneID"_a = 0)
+      .def("get_num_pooled_objects", &Simulator::getNumPooledObjects,
+           "sceneID"_a = 0)
       .def("get_world_time", &Simulator::getWorldTime)
       .def("get_gravity", &Simulator::getGravity, "sceneID"_a = 0)
       .def("set_gravity", &Simulator::setGravity, "gravity"_a, "sceneID"_a = 0)
@@ -99,6 +768,33 @@ void initSimBindings(py::module& m) {
            "sceneID"_a = 0)
       .def("get_rotation", &Simulator::getRotation, "object_id"_a,
            "sceneID"_a = 0)
+      // batched versions of the above, taking and returning (N, 3) arrays
+      // and (N, 4) arrays of quaternions as (x, y, z, w). An empty ID array
+      // selects all objects in the order of get_existing_object_ids().
+      .def("get_translations",
+           &getBatched<Magnum::Vector3, &Simulator::getTranslations>,
+           "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("get_rotations",
+           &getBatched<Magnum::Quaternion, &Simulator::getRotations>,
+           "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("get_linear_velocities",
+           &getBatched<Magnum::Vector3, &Simulator::getLinearVelocities>,
+           "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("get_angular_velocities",
+           &getBatched<Magnum::Vector3, &Simulator::getAngularVelocities>,
+           "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("set_translations",
+           &setBatched<Magnum::Vector3, &Simulator::setTranslations>,
+           "translations"_a, "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("set_rotations",
+           &setBatched<Magnum::Quaternion, &Simulator::setRotations>,
+           "rotations"_a, "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("set_linear_velocities",
+           &setBatched<Magnum::Vector3, &Simulator::setLinearVelocities>,
+           "lin_vels"_a, "object_ids"_a = IdArray{}, "sceneID"_a = 0)
+      .def("set_angular_velocities",
+           &setBatched<Magnum::Vector3, &Simulator::setAngularVelocities>,
+           "ang_vels"_a, "object_ids"_a = IdArray{}, "sceneID"_a = 0)
       .def("get_object_velocity_control", &Simulator::getObjectVelocityControl,
            "object_id"_a, "sceneID"_a = 0)
       .def("set_linear_velocity", &Simulator::setLinearVelocity, "linVel"_a,
@@ -115,14 +811,111 @@ void initSimBindings(py::module& m) {
            "sceneID"_a = 0)
       .def("contact_test", &Simulator::contactTest, "object_id"_a,
            "sceneID"_a = 0)
+      // batched queries, an empty ID array selects all objects. Rays that
+      // hit nothing have an infinite distance, rays that hit the scene or a
+      // non-object collision shape report an object ID of -1.
+      .def("contact_tests", &contactTests, "object_ids"_a = IdArray{},
+           "sceneID"_a = 0)
+      .def("cast_rays", &castRays, "origins"_a, "directions"_a,
+           "max_distance"_a = 100.0f, "sceneID"_a = 0)
+      .def("compute_object_viewpoints", &Simulator::computeObjectViewpoints,
+           "settings"_a = ViewpointSettings{},
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Navmesh points each object of the semantic scene is visible
+           from, for objects with any)")
+      .def("get_occupancy_grid", &Simulator::getOccupancyGrid,
+           "voxel_size"_a, py::return_value_policy::reference_internal,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Occupancy of the scene collision mesh, voxelized on first use
+           and cached)")
       .def("recompute_navmesh", &Simulator::recomputeNavMesh, "pathfinder"_a,
-           "navmesh_settings"_a, "include_static_objects"_a)
+           "navmesh_settings"_a, "include_static_objects"_a,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_light_setup", &Simulator::getLightSetup,
            "key"_a = assets::ResourceManager::DEFAULT_LIGHTING_KEY)
       .def("set_light_setup", &Simulator::setLightSetup, "light_setup"_a,
            "key"_a = assets::ResourceManager::DEFAULT_LIGHTING_KEY)
       .def("set_object_light_setup", &Simulator::setObjectLightSetup,
            "object_id"_a, "light_setup_key"_a, "scene_id"_a = 0);
+
+  py::class_<BatchedSimulator, BatchedSimulator::ptr>(
+      m, "BatchedSimulator",
+      R"(Simulators stepped in lockstep on worker threads and drawn through
+      one shared context, with the observations of their default agents
+      stacked into one tensor per sensor type)")
+      .def(py::init(&BatchedSimulator::create<
+                    const std::vector<SimulatorConfiguration>&>),
+           "configurations"_a)
+      .def("__len__", &BatchedSimulator::size)
+      .def("simulator", &BatchedSimulator::simulator, "index"_a,
+           R"(Simulator at given index, to add agents and objects through)")
+      .def("reconfigure", &BatchedSimulator::reconfigure, "index"_a,
+           "configuration"_a)
+      .def("step", &BatchedSimulator::step,
+           R"(Act for the default agent of every simulator, step physics and
+           observe. Row i of a tensor belongs to the simulator index and
+           sensor uuid in its sensors[i]; overwritten by the next step)",
+           "actions"_a, "dt"_a = 1.0 / 60.0,
+           py::return_value_policy::reference_internal,
+           py::call_guard<py::gil_scoped_release>())
+      .def("get_observations", &BatchedSimulator::getObservations,
+           R"(Observe all simulators without acting, see step())",
+           py::return_value_policy::reference_internal,
+           py::call_guard<py::gil_scoped_release>());
+
+  py::class_<ObservationRecorder, ObservationRecorder::ptr>(
+      m, "ObservationRecorder",
+      R"(Records sensor streams of episodes on a writer thread. RGB(A)
+      sensors go to <directory>/<episode>/<uuid>.y4m video streams, ready for
+      a hardware encoder, everything else losslessly to <uuid>.npy arrays)")
+      .def(py::init(&ObservationRecorder::create<const std::string&, int,
+                                                 size_t, bool>),
+           "directory"_a, "fps"_a = 30, "max_queued_frames"_a = 64,
+           "drop_when_full"_a = false)
+      .def_property_readonly("directory", &ObservationRecorder::directory)
+      .def_property_readonly("is_recording",
+                             &ObservationRecorder::isRecording)
+      .def("begin_episode", &ObservationRecorder::beginEpisode, "name"_a,
+           py::call_guard<py::gil_scoped_release>())
+      .def("end_episode", &ObservationRecorder::endEpisode,
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "record",
+          [](ObservationRecorder& self,
+             const std::map<std::string, py::array>& observations) {
+            std::vector<std::pair<std::string, core::Buffer::ptr>> buffers;
+            for (const auto& observation : observations) {
+              buffers.emplace_back(observation.first,
+                                   wrapArray(observation.second));
+            }
+            py::gil_scoped_release release;
+            size_t count = 0;
+            for (const auto& buffer : buffers) {
+              count += self.record(buffer.first, *buffer.second, true);
+            }
+            return count;
+          },
+          "observations"_a,
+          R"(Queue a frame of every sensor in a dict of uuids and arrays, as
+          returned by Simulator.get_sensor_observations(). Returns the number
+          of frames queued)")
+      .def(
+          "record",
+          [](ObservationRecorder& self, const AgentObservations& observations) {
+            return self.record(observations);
+          },
+          "observations"_a, py::call_guard<py::gil_scoped_release>())
+      .def("flush", &ObservationRecorder::flush,
+           R"(Wait until everything queued is written)",
+           py::call_guard<py::gil_scoped_release>())
+      .def("close", &ObservationRecorder::close,
+           py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("queued_frames",
+                             &ObservationRecorder::queuedFrames)
+      .def_property_readonly("written_frames",
+                             &ObservationRecorder::writtenFrames)
+      .def_property_readonly("dropped_frames",
+                             &ObservationRecorder::droppedFrames);
 }
 
 }  // namespace sim
@@ -69,6 +69,12 @@ void initAttributesBindings(py::module& m) {
            "join_collision_meshes"_a)
       .def("get_join_collision_meshes",
            &PhysicsObjectAttributes::getJoinCollisionMeshes)
+      .def("set_collision_group", &PhysicsObjectAttributes::setCollisionGroup,
+           "collision_group"_a)
+      .def("get_collision_group", &PhysicsObjectAttributes::getCollisionGroup)
+      .def("set_collision_mask", &PhysicsObjectAttributes::setCollisionMask,
+           "collision_mask"_a)
+      .def("get_collision_mask", &PhysicsObjectAttributes::getCollisionMask)
       .def("set_requires_lighting",
            &PhysicsObjectAttributes::setRequiresLighting, "requires_lighting"_a)
       .def("get_requires_lighting",
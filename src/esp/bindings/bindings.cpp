@@ -4,7 +4,15 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <pybind11/numpy.h>
+
+#include "esp/core/Buffer.h"
 #include "esp/core/Configuration.h"
+#include "esp/core/Metrics.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/SharedMemoryRing.h"
+#include "esp/core/logging.h"
+#include "esp/core/random.h"
 
 namespace py = pybind11;
 using py::literals::operator""_a;
@@ -20,7 +28,78 @@ void initEspBindings(py::module& m) {
 
 namespace core {
 
+namespace {
+std::string bufferFormat(DataType dataType) {
+  switch (dataType) {
+    case DataType::DT_INT8:
+      return py::format_descriptor<int8_t>::format();
+    case DataType::DT_UINT8:
+      return py::format_descriptor<uint8_t>::format();
+    case DataType::DT_INT16:
+      return py::format_descriptor<int16_t>::format();
+    case DataType::DT_UINT16:
+      return py::format_descriptor<uint16_t>::format();
+    case DataType::DT_INT32:
+      return py::format_descriptor<int32_t>::format();
+    case DataType::DT_UINT32:
+      return py::format_descriptor<uint32_t>::format();
+    case DataType::DT_INT64:
+      return py::format_descriptor<int64_t>::format();
+    case DataType::DT_UINT64:
+      return py::format_descriptor<uint64_t>::format();
+    case DataType::DT_FLOAT:
+      return py::format_descriptor<float>::format();
+    case DataType::DT_DOUBLE:
+      return py::format_descriptor<double>::format();
+    case DataType::DT_FLOAT16:
+      // struct module code of half precision, understood by numpy
+      return "e";
+    default:
+      throw py::type_error{"Buffer has no data type"};
+  }
+}
+}  // namespace
+
 void initCoreBindings(py::module& m) {
+  py::enum_<BufferStorage>(m, "BufferStorage")
+      .value("ALIGNED", BufferStorage::Aligned)
+      .value("PINNED", BufferStorage::Pinned);
+
+  // exposed through the buffer protocol, np.asarray(buffer) is a view that
+  // keeps the buffer alive
+  py::class_<Buffer, Buffer::ptr>(m, "Buffer", py::buffer_protocol())
+      .def_buffer([](Buffer& self) {
+        const ssize_t itemSize = getDataTypeByteSize(self.dataType);
+        std::vector<ssize_t> shape(self.shape.begin(), self.shape.end());
+        // compact row-major
+        std::vector<ssize_t> strides(shape.size());
+        ssize_t stride = itemSize;
+        for (size_t i = shape.size(); i-- > 0;) {
+          strides[i] = stride;
+          stride *= shape[i];
+        }
+        return py::buffer_info{self.data.data(),
+                               itemSize,
+                               bufferFormat(self.dataType),
+                               ssize_t(shape.size()),
+                               shape,
+                               strides};
+      })
+      .def_property_readonly("shape",
+                             [](Buffer& self) { return self.shape; })
+      .def_readonly("storage", &Buffer::storage)
+      .def_static("pooled_bytes", &Buffer::pooledBytes,
+                  R"(Bytes of freed buffer memory kept for reuse)")
+      .def_static("release_pooled_memory", &Buffer::releasePooledMemory);
+
+  py::class_<BufferPool, BufferPool::ptr>(m, "BufferPool")
+      .def("acquire", &BufferPool::acquire)
+      .def("clear", &BufferPool::clear)
+      .def_property_readonly("size", &BufferPool::size)
+      .def_property_readonly("allocation_count", &BufferPool::allocationCount,
+                             R"(Number of buffers allocated since
+                             construction, constant in steady state)");
+
   py::class_<Configuration, Configuration::ptr>(m, "ConfigurationGroup")
       .def(py::init(&Configuration::create<>))
       .def("get_bool", &Configuration::getBool)
@@ -38,6 +117,106 @@ void initCoreBindings(py::module& m) {
       .def("get_string_group", &Configuration::getStringGroup)
       .def("has_value", &Configuration::hasValue)
       .def("remove_value", &Configuration::removeValue);
+
+  py::class_<Profiler>(m, "Profiler")
+      .def_property_readonly_static(
+          "max_events_per_thread",
+          [](py::object) { return Profiler::MaxEventsPerThread; })
+      .def_static("is_enabled", &Profiler::isEnabled)
+      .def_static("set_enabled", &Profiler::setEnabled, "enabled"_a)
+      .def_static("clear", &Profiler::clear)
+      .def_static("dropped_event_count", &Profiler::droppedEventCount)
+      .def_static("chrome_trace", &Profiler::chromeTrace,
+                  R"(Recorded events as a Chrome trace, JSON loadable by
+                  chrome://tracing and Perfetto)")
+      .def_static("write_chrome_trace", &Profiler::writeChromeTrace,
+                  "filename"_a, py::call_guard<py::gil_scoped_release>());
+
+  py::class_<Metrics>(m, "Metrics")
+      .def_static("snapshot", &Metrics::snapshot, "reset"_a = false,
+                  R"(Values of all counters and histograms by name, reset
+                  afterwards if reset is True, except counters of levels)")
+      .def_static("reset", &Metrics::reset);
+
+  py::class_<CounterRandom>(m, "CounterRandom")
+      .def(py::init<uint64_t, uint64_t>(), "seed"_a, "stream"_a = 0)
+      .def("split", &CounterRandom::split, "stream"_a)
+      .def_property_readonly("position", &CounterRandom::position)
+      .def("uniform_uint", &CounterRandom::uniform_uint)
+      .def("uniform_float_01", &CounterRandom::uniform_float_01)
+      .def("uniform_float", &CounterRandom::uniform_float, "a"_a, "b"_a)
+      .def("normal_float_01", &CounterRandom::normal_float_01)
+      .def(
+          "uniform_floats",
+          [](CounterRandom& self, std::size_t count) {
+            py::array_t<float> out(count);
+            self.fill_uniform_float_01(out.mutable_data(), count);
+            return out;
+          },
+          "count"_a, R"(Array of count floats distributed uniformly in [0, 1))")
+      .def(
+          "normal_floats",
+          [](CounterRandom& self, std::size_t count) {
+            py::array_t<float> out(count);
+            self.fill_normal_float_01(out.mutable_data(), count);
+            return out;
+          },
+          "count"_a, R"(Array of count floats distributed normally)");
+
+  py::class_<SharedMemoryRing, SharedMemoryRing::ptr>(m, "SharedMemoryRing")
+      .def_static("create", &SharedMemoryRing::create, "name"_a,
+                  "slot_count"_a, "slot_byte_size"_a,
+                  R"(Create a ring in shared memory, None if the name is
+                  taken. The name is removed once the ring is destroyed.)")
+      .def_static("open", &SharedMemoryRing::open, "name"_a,
+                  R"(Map a ring created by another process, None if there's
+                  none)")
+      .def_property_readonly_static(
+          "layout_capacity",
+          [](py::object) { return SharedMemoryRing::LayoutCapacity; })
+      .def_property_readonly("name", &SharedMemoryRing::name)
+      .def_property_readonly("is_owner", &SharedMemoryRing::isOwner)
+      .def_property_readonly("slot_count", &SharedMemoryRing::slotCount)
+      .def_property_readonly("slot_byte_size", &SharedMemoryRing::slotByteSize)
+      .def_property_readonly("pending_count", &SharedMemoryRing::pendingCount)
+      .def(
+          "begin_write",
+          [](SharedMemoryRing::ptr self) -> py::object {
+            Corrade::Containers::ArrayView<uint8_t> slot = self->beginWrite();
+            if (slot.empty()) {
+              return py::none();
+            }
+            // a view of the shared memory, keeping the ring mapped
+            return py::array_t<uint8_t>({slot.size()}, {1}, slot.data(),
+                                        py::cast(self));
+          },
+          R"(Writable uint8 array of the next slot, None if the ring is
+          full. Hand it to the reader with end_write())")
+      .def("end_write", &SharedMemoryRing::endWrite, "byte_size"_a,
+           "layout"_a = "")
+      .def(
+          "begin_read",
+          [](SharedMemoryRing::ptr self) -> py::object {
+            Corrade::Containers::ArrayView<const uint8_t> slot =
+                self->beginRead();
+            if (slot.data() == nullptr) {
+              return py::none();
+            }
+            py::array_t<uint8_t> data({slot.size()}, {1}, slot.data(),
+                                      py::cast(self));
+            // the writer owns the memory until end_read()
+            data.attr("setflags")("write"_a = false);
+            return std::move(data);
+          },
+          R"(Read-only uint8 array of the oldest slot not read yet, None if
+          there's none. Valid until end_read())")
+      .def_property_readonly("read_sequence", &SharedMemoryRing::readSequence)
+      .def_property_readonly("read_layout", &SharedMemoryRing::readLayout)
+      .def("end_read", &SharedMemoryRing::endRead);
+
+  m.def("set_log_verbosity", &setLogVerbosity, "module_pattern"_a, "level"_a,
+        R"(Show VLOG() messages up to level in the source files matching
+        module_pattern, glob-style basenames without extension)");
 }
 
 }  // namespace core
@@ -4,10 +4,14 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <pybind11/numpy.h>
+
 #include "esp/geo/OBB.h"
+#include "esp/geo/OccupancyGrid.h"
 #include "esp/geo/geo.h"
 
 namespace py = pybind11;
+using py::literals::operator""_a;
 
 namespace esp {
 namespace geo {
@@ -42,6 +46,29 @@ void initGeoBindings(py::module& m) {
       });
 
   geo.def("compute_gravity_aligned_MOBB", &geo::computeGravityAlignedMOBB);
+
+  // ==== OccupancyGrid ====
+  py::class_<OccupancyGrid, OccupancyGrid::ptr>(m, "OccupancyGrid")
+      .def_readonly("origin", &OccupancyGrid::origin)
+      .def_readonly("voxel_size", &OccupancyGrid::voxelSize)
+      .def_readonly("dimensions", &OccupancyGrid::dimensions)
+      .def_readonly("voxels", &OccupancyGrid::voxels,
+                    "Occupied voxels as an Nx3 array of x, y, z coordinates")
+      .def("is_occupied", &OccupancyGrid::isOccupied, "voxel"_a)
+      .def("to_voxel", &OccupancyGrid::toVoxel, "point"_a)
+      .def(
+          "to_dense",
+          [](const OccupancyGrid& self) {
+            const std::vector<uint8_t> dense = self.toDense();
+            return py::array_t<uint8_t>(
+                {self.dimensions.z(), self.dimensions.y(),
+                 self.dimensions.x()},
+                dense.data());
+          },
+          "The occupancy as a dense uint8 array indexed by [z, y, x]");
+
+  geo.def("voxelize_mesh", &voxelizeMesh, "vertices"_a, "indices"_a,
+          "voxel_size"_a, py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace geo
@@ -0,0 +1,541 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "habitat_sim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/agent/Agent.h"
+#include "esp/nav/PathFinder.h"
+#include "esp/sensor/VisualSensor.h"
+#include "esp/sim/Simulator.h"
+
+namespace Mn = Magnum;
+
+struct hsim_simulator {
+  std::unique_ptr<esp::sim::Simulator> simulator;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+hsim_status fail(hsim_status status, const char* function, const char* what) {
+  lastError = std::string{function} + "(): " + what;
+  return status;
+}
+
+// exceptions and the simulator's own types don't cross the C boundary, every
+// entry point runs its body through this
+template <typename F>
+hsim_status guarded(const char* function, F&& body) {
+  lastError.clear();
+  try {
+    return body();
+  } catch (const std::exception& e) {
+    return fail(HSIM_ERROR_FAILED, function, e.what());
+  } catch (...) {
+    return fail(HSIM_ERROR_FAILED, function, "unknown exception");
+  }
+}
+
+// whether a versioned struct is at least as large as in the first version
+template <typename T>
+bool hasSize(const T* config, size_t firstVersionSize) {
+  return config != nullptr && config->struct_size >= firstVersionSize;
+}
+
+// element i of an array of versioned structs, strided by the size the
+// caller's header has
+template <typename T>
+const T& element(const T* array, size_t i) {
+  return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(array) +
+                                     i * array->struct_size);
+}
+
+// null for an ID out of range, Simulator::getAgent() would exit
+esp::agent::Agent* findAgent(hsim_simulator* simulator, int agentId) {
+  if (agentId < 0 || agentId >= simulator->simulator->getNumAgents()) {
+    return nullptr;
+  }
+  return simulator->simulator->getAgent(agentId).get();
+}
+
+esp::nav::PathFinder* pathFinder(hsim_simulator* simulator) {
+  if (simulator == nullptr) {
+    return nullptr;
+  }
+  esp::nav::PathFinder* pathFinder =
+      simulator->simulator->getPathFinder().get();
+  return pathFinder && pathFinder->isLoaded() ? pathFinder : nullptr;
+}
+
+}  // namespace
+
+extern "C" {
+
+int hsim_api_version(void) {
+  return HSIM_API_VERSION;
+}
+
+const char* hsim_last_error(void) {
+  return lastError.c_str();
+}
+
+void hsim_simulator_config_init(hsim_simulator_config* config) {
+  const esp::sim::SimulatorConfiguration defaults;
+  *config = {};
+  config->struct_size = sizeof(hsim_simulator_config);
+  config->gpu_device_id = defaults.gpuDeviceId;
+  config->enable_physics = defaults.enablePhysics;
+  config->allow_sliding = defaults.allowSliding;
+  config->frustum_culling = defaults.frustumCulling;
+}
+
+void hsim_agent_config_init(hsim_agent_config* config) {
+  const esp::agent::AgentConfiguration defaults;
+  *config = {};
+  config->struct_size = sizeof(hsim_agent_config);
+  config->height = defaults.height;
+  config->radius = defaults.radius;
+}
+
+void hsim_sensor_config_init(hsim_sensor_config* config) {
+  const esp::sensor::SensorSpec defaults;
+  *config = {};
+  config->struct_size = sizeof(hsim_sensor_config);
+  config->uuid = "rgba_camera";
+  config->type = HSIM_SENSOR_COLOR;
+  config->width = defaults.resolution[1];
+  config->height = defaults.resolution[0];
+  config->hfov = 90.0f;
+  for (int i = 0; i != 3; ++i) {
+    config->position[i] = defaults.position[i];
+    config->orientation[i] = defaults.orientation[i];
+  }
+}
+
+void hsim_action_config_init(hsim_action_config* config) {
+  *config = {};
+  config->struct_size = sizeof(hsim_action_config);
+}
+
+hsim_status hsim_simulator_create(const hsim_simulator_config* config,
+                                  hsim_simulator** simulator) {
+  return guarded("hsim_simulator_create", [&]() {
+    if (!hasSize(config, sizeof(hsim_simulator_config)) ||
+        simulator == nullptr || config->scene_id == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_create",
+                  "expected a configuration with a scene and an output");
+    }
+    esp::sim::SimulatorConfiguration cfg;
+    cfg.scene.id = config->scene_id;
+    cfg.gpuDeviceId = config->gpu_device_id;
+    cfg.enablePhysics = config->enable_physics != 0;
+    if (config->physics_config_file != nullptr) {
+      cfg.physicsConfigFile = config->physics_config_file;
+    }
+    cfg.allowSliding = config->allow_sliding != 0;
+    cfg.frustumCulling = config->frustum_culling != 0;
+    auto created = std::make_unique<hsim_simulator>();
+    created->simulator = std::make_unique<esp::sim::Simulator>(cfg);
+    *simulator = created.release();
+    return HSIM_OK;
+  });
+}
+
+void hsim_simulator_destroy(hsim_simulator* simulator) {
+  try {
+    delete simulator;
+  } catch (...) {
+  }
+}
+
+hsim_status hsim_simulator_reset(hsim_simulator* simulator) {
+  return guarded("hsim_simulator_reset", [&]() {
+    if (simulator == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_reset",
+                  "null simulator");
+    }
+    simulator->simulator->reset();
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_simulator_seed(hsim_simulator* simulator, uint32_t seed) {
+  return guarded("hsim_simulator_seed", [&]() {
+    if (simulator == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_seed",
+                  "null simulator");
+    }
+    simulator->simulator->seed(seed);
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_simulator_step_world(hsim_simulator* simulator,
+                                      double dt,
+                                      double* world_time) {
+  return guarded("hsim_simulator_step_world", [&]() {
+    if (simulator == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_step_world",
+                  "null simulator");
+    }
+    const double time = simulator->simulator->stepWorld(dt);
+    if (world_time != nullptr) {
+      *world_time = time;
+    }
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_simulator_add_agent(hsim_simulator* simulator,
+                                     const hsim_agent_config* config,
+                                     int* agent_id) {
+  return guarded("hsim_simulator_add_agent", [&]() {
+    if (simulator == nullptr || !hasSize(config, sizeof(hsim_agent_config)) ||
+        (config->sensor_count && config->sensors == nullptr) ||
+        (config->action_count && config->actions == nullptr)) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_add_agent",
+                  "expected a simulator and a configuration");
+    }
+    esp::agent::AgentConfiguration agentConfig;
+    agentConfig.height = config->height;
+    agentConfig.radius = config->radius;
+    agentConfig.sensorSpecifications.clear();
+    for (size_t i = 0; i != config->sensor_count; ++i) {
+      const hsim_sensor_config& sensor = element(config->sensors, i);
+      if (!hasSize(&sensor, sizeof(hsim_sensor_config)) ||
+          sensor.uuid == nullptr || sensor.width <= 0 || sensor.height <= 0) {
+        return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_add_agent",
+                    "expected sensors with a uuid and a resolution");
+      }
+      auto spec = esp::sensor::SensorSpec::create();
+      spec->uuid = sensor.uuid;
+      switch (sensor.type) {
+        case HSIM_SENSOR_COLOR:
+          spec->sensorType = esp::sensor::SensorType::COLOR;
+          spec->channels = 4;
+          break;
+        case HSIM_SENSOR_DEPTH:
+          spec->sensorType = esp::sensor::SensorType::DEPTH;
+          spec->channels = 1;
+          break;
+        case HSIM_SENSOR_SEMANTIC:
+          spec->sensorType = esp::sensor::SensorType::SEMANTIC;
+          spec->channels = 1;
+          break;
+        default:
+          return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_add_agent",
+                      "unknown sensor type");
+      }
+      spec->resolution = {sensor.height, sensor.width};
+      spec->parameters["hfov"] = std::to_string(sensor.hfov);
+      spec->position = {sensor.position[0], sensor.position[1],
+                        sensor.position[2]};
+      spec->orientation = {sensor.orientation[0], sensor.orientation[1],
+                           sensor.orientation[2]};
+      agentConfig.sensorSpecifications.push_back(std::move(spec));
+    }
+    if (config->action_count) {
+      agentConfig.actionSpace.clear();
+    }
+    for (size_t i = 0; i != config->action_count; ++i) {
+      const hsim_action_config& action = element(config->actions, i);
+      if (!hasSize(&action, sizeof(hsim_action_config)) ||
+          action.name == nullptr || action.control == nullptr) {
+        return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_simulator_add_agent",
+                    "expected actions with a name and a control");
+      }
+      agentConfig.actionSpace[action.name] = esp::agent::ActionSpec::create(
+          action.control, esp::agent::ActuationMap{{"amount", action.amount}});
+    }
+
+    simulator->simulator->addAgent(agentConfig);
+    if (agent_id != nullptr) {
+      *agent_id = simulator->simulator->getNumAgents() - 1;
+    }
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_agent_act(hsim_simulator* simulator,
+                           int agent_id,
+                           const char* action) {
+  return guarded("hsim_agent_act", [&]() {
+    if (simulator == nullptr || action == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_agent_act",
+                  "expected a simulator and an action");
+    }
+    esp::agent::Agent* agent = findAgent(simulator, agent_id);
+    if (agent == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_agent_act", "no such agent");
+    }
+    const int index = agent->getActionIndex(action);
+    if (index == -1) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_agent_act", "no such action");
+    }
+    if (!agent->act(index)) {
+      return fail(HSIM_ERROR_FAILED, "hsim_agent_act",
+                  "the action has no amount");
+    }
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_agent_get_state(hsim_simulator* simulator,
+                                 int agent_id,
+                                 float* position,
+                                 float* rotation) {
+  return guarded("hsim_agent_get_state", [&]() {
+    if (simulator == nullptr || position == nullptr || rotation == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_agent_get_state",
+                  "expected a simulator and outputs");
+    }
+    esp::agent::Agent* agent = findAgent(simulator, agent_id);
+    if (agent == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_agent_get_state",
+                  "no such agent");
+    }
+    Mn::Vector3::from(position) =
+        agent->node().absoluteTransformation().translation();
+    Mn::Quaternion::from(rotation) = agent->node().rotation();
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_agent_set_state(hsim_simulator* simulator,
+                                 int agent_id,
+                                 const float* position,
+                                 const float* rotation) {
+  return guarded("hsim_agent_set_state", [&]() {
+    if (simulator == nullptr || position == nullptr || rotation == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_agent_set_state",
+                  "expected a simulator, a position and a rotation");
+    }
+    esp::agent::Agent* agent = findAgent(simulator, agent_id);
+    if (agent == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_agent_set_state",
+                  "no such agent");
+    }
+    // checked here, Agent::setState() would abort the process
+    const Mn::Quaternion& q = Mn::Quaternion::from(rotation);
+    if (std::abs(q.length() - 1.0f) > 1.0e-3f) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_agent_set_state",
+                  "the rotation is not normalized");
+    }
+    agent->setPose(Mn::Vector3::from(position), q.normalized());
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_sensor_get_info(hsim_simulator* simulator,
+                                 int agent_id,
+                                 const char* sensor_uuid,
+                                 hsim_observation_info* info) {
+  return guarded("hsim_sensor_get_info", [&]() {
+    if (simulator == nullptr || sensor_uuid == nullptr ||
+        !hasSize(info, sizeof(hsim_observation_info))) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_sensor_get_info",
+                  "expected a simulator, a sensor and an output");
+    }
+    esp::agent::Agent* agent = findAgent(simulator, agent_id);
+    esp::sensor::Sensor::ptr sensor =
+        agent ? agent->getSensorSuite().get(sensor_uuid) : nullptr;
+    esp::sensor::ObservationSpace space;
+    if (sensor == nullptr || !sensor->getObservationSpace(space) ||
+        space.shape.size() > 3) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_sensor_get_info",
+                  "no such agent or sensor with a tensor observation");
+    }
+    info->data_type = hsim_data_type(space.dataType);
+    info->dimensions = space.shape.size();
+    info->byte_size = esp::core::getDataTypeByteSize(space.dataType);
+    for (size_t i = 0; i != 3; ++i) {
+      info->shape[i] = i < space.shape.size() ? space.shape[i] : 1;
+      info->byte_size *= info->shape[i];
+    }
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_sensor_get_observation(hsim_simulator* simulator,
+                                        int agent_id,
+                                        const char* sensor_uuid,
+                                        void* data,
+                                        size_t size) {
+  return guarded("hsim_sensor_get_observation", [&]() {
+    if (simulator == nullptr || sensor_uuid == nullptr || data == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_sensor_get_observation",
+                  "expected a simulator, a sensor and an output");
+    }
+    esp::sim::Simulator& sim = *simulator->simulator;
+    esp::agent::Agent* agent = findAgent(simulator, agent_id);
+    esp::sensor::Sensor::ptr sensor =
+        agent ? agent->getSensorSuite().get(sensor_uuid) : nullptr;
+    esp::sensor::ObservationSpace space;
+    if (sensor == nullptr || !sensor->getObservationSpace(space)) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_sensor_get_observation",
+                  "no such agent or sensor");
+    }
+    size_t byteSize = esp::core::getDataTypeByteSize(space.dataType);
+    for (size_t extent : space.shape) {
+      byteSize *= extent;
+    }
+    if (size < byteSize) {
+      return fail(HSIM_ERROR_BUFFER_TOO_SMALL, "hsim_sensor_get_observation",
+                  "the output is smaller than the observation");
+    }
+
+    // visual sensors read straight into the caller's memory
+    auto* visual = sensor->isVisualSensor()
+                       ? static_cast<esp::sensor::VisualSensor*>(sensor.get())
+                       : nullptr;
+    if (visual != nullptr) {
+      visual->setObservationDestination(esp::core::Buffer::wrap(
+          static_cast<uint8_t*>(data), space.shape, space.dataType));
+    }
+    esp::sensor::Observation observation;
+    const bool observed =
+        sim.getAgentObservation(agent_id, sensor_uuid, observation);
+    if (visual != nullptr) {
+      visual->setObservationDestination(nullptr);
+    }
+    if (!observed || observation.buffer == nullptr) {
+      return fail(HSIM_ERROR_FAILED, "hsim_sensor_get_observation",
+                  "the sensor has no observation in host memory");
+    }
+    if (observation.buffer->data.data() != data) {
+      std::memcpy(data, observation.buffer->data.data(),
+                  std::min(byteSize, observation.buffer->data.size()));
+    }
+    return HSIM_OK;
+  });
+}
+
+int hsim_pathfinder_is_loaded(hsim_simulator* simulator) {
+  lastError.clear();
+  return pathFinder(simulator) != nullptr;
+}
+
+hsim_status hsim_pathfinder_load(hsim_simulator* simulator, const char* path) {
+  return guarded("hsim_pathfinder_load", [&]() {
+    if (simulator == nullptr || path == nullptr) {
+      return fail(HSIM_ERROR_INVALID_ARGUMENT, "hsim_pathfinder_load",
+                  "expected a simulator and a path");
+    }
+    if (!simulator->simulator->loadNavMesh(path)) {
+      return fail(HSIM_ERROR_FAILED, "hsim_pathfinder_load",
+                  "can't load the navmesh");
+    }
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_pathfinder_random_navigable_point(hsim_simulator* simulator,
+                                                   float* point) {
+  return guarded("hsim_pathfinder_random_navigable_point", [&]() {
+    esp::nav::PathFinder* finder = pathFinder(simulator);
+    if (finder == nullptr || point == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND,
+                  "hsim_pathfinder_random_navigable_point",
+                  "expected a navmesh and an output");
+    }
+    Eigen::Map<esp::vec3f>{point} = finder->getRandomNavigablePoint();
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_pathfinder_snap_point(hsim_simulator* simulator,
+                                       const float* point,
+                                       float* result) {
+  return guarded("hsim_pathfinder_snap_point", [&]() {
+    esp::nav::PathFinder* finder = pathFinder(simulator);
+    if (finder == nullptr || point == nullptr || result == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_pathfinder_snap_point",
+                  "expected a navmesh, a point and an output");
+    }
+    Mn::Vector3::from(result) = finder->snapPoint(Mn::Vector3::from(point));
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_pathfinder_try_step(hsim_simulator* simulator,
+                                     const float* start,
+                                     const float* end,
+                                     float* result) {
+  return guarded("hsim_pathfinder_try_step", [&]() {
+    esp::nav::PathFinder* finder = pathFinder(simulator);
+    if (finder == nullptr || start == nullptr || end == nullptr ||
+        result == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_pathfinder_try_step",
+                  "expected a navmesh, two points and an output");
+    }
+    Mn::Vector3::from(result) =
+        finder->tryStep(Mn::Vector3::from(start), Mn::Vector3::from(end));
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_pathfinder_is_navigable(hsim_simulator* simulator,
+                                         const float* point,
+                                         int* navigable) {
+  return guarded("hsim_pathfinder_is_navigable", [&]() {
+    esp::nav::PathFinder* finder = pathFinder(simulator);
+    if (finder == nullptr || point == nullptr || navigable == nullptr) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_pathfinder_is_navigable",
+                  "expected a navmesh, a point and an output");
+    }
+    *navigable =
+        finder->isNavigable(Eigen::Map<const esp::vec3f>{point}) ? 1 : 0;
+    return HSIM_OK;
+  });
+}
+
+hsim_status hsim_pathfinder_find_path(hsim_simulator* simulator,
+                                      const float* start,
+                                      const float* end,
+                                      float* distance,
+                                      float* points,
+                                      size_t max_points,
+                                      size_t* point_count) {
+  return guarded("hsim_pathfinder_find_path", [&]() {
+    esp::nav::PathFinder* finder = pathFinder(simulator);
+    if (finder == nullptr || start == nullptr || end == nullptr ||
+        distance == nullptr || (max_points && points == nullptr)) {
+      return fail(HSIM_ERROR_NOT_FOUND, "hsim_pathfinder_find_path",
+                  "expected a navmesh, two points and outputs");
+    }
+    esp::nav::ShortestPath path;
+    path.requestedStart = Eigen::Map<const esp::vec3f>{start};
+    path.requestedEnd = Eigen::Map<const esp::vec3f>{end};
+    if (!finder->findPath(path)) {
+      path.points.clear();
+      path.geodesicDistance = std::numeric_limits<float>::infinity();
+    }
+    *distance = path.geodesicDistance;
+    if (point_count != nullptr) {
+      *point_count = path.points.size();
+    }
+    if (path.points.size() > max_points) {
+      return fail(HSIM_ERROR_BUFFER_TOO_SMALL, "hsim_pathfinder_find_path",
+                  "the path has more points than fit the output");
+    }
+    for (size_t i = 0; i != path.points.size(); ++i) {
+      std::memcpy(points + 3 * i, path.points[i].data(), 3 * sizeof(float));
+    }
+    return HSIM_OK;
+  });
+}
+
+}  // extern "C"
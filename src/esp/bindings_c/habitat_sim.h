@@ -0,0 +1,331 @@
+/* Copyright (c) Facebook, Inc. and its affiliates.
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HABITAT_SIM_H_
+#define HABITAT_SIM_H_
+
+/** @file
+ * @brief C API of the simulator
+ *
+ * A plain C interface over the simulator, its agents, the navmesh path
+ * finder and sensor readback, for embedding the simulator in native
+ * programs without Python. Built as the `habitat_sim_c` shared library when
+ * `BUILD_C_BINDINGS` is enabled.
+ *
+ * The ABI is kept stable: types are opaque handles, configuration structs
+ * start with their size and are only ever extended at the end, so that a
+ * program built against an older header keeps working with a newer
+ * library. Fill them with the matching `*_init()` function before setting
+ * any field.
+ *
+ * Functions return @ref HSIM_OK on success and an error status otherwise,
+ * with @ref hsim_last_error() describing the failure. Output buffers are
+ * owned by the caller and only written to. A simulator is not thread-safe,
+ * but separate simulators can be driven from separate threads.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(HSIM_BUILDING_C_BINDINGS)
+#define HSIM_API __declspec(dllexport)
+#else
+#define HSIM_API __declspec(dllimport)
+#endif
+#else
+#define HSIM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Version of the API, bumped whenever something is added */
+#define HSIM_API_VERSION 1
+
+/** @brief Status of a call */
+typedef enum hsim_status {
+  HSIM_OK = 0,
+  /** A null handle, a malformed configuration or an unknown name */
+  HSIM_ERROR_INVALID_ARGUMENT = 1,
+  /** No agent, sensor or navmesh of that ID */
+  HSIM_ERROR_NOT_FOUND = 2,
+  /** The output buffer is smaller than the data written into it */
+  HSIM_ERROR_BUFFER_TOO_SMALL = 3,
+  /** The simulator failed, e.g. a scene that can't be loaded */
+  HSIM_ERROR_FAILED = 4
+} hsim_status;
+
+/** @brief Element type of an observation, like the core data types */
+typedef enum hsim_data_type {
+  HSIM_DATA_TYPE_NONE = 0,
+  HSIM_DATA_TYPE_INT8 = 1,
+  HSIM_DATA_TYPE_UINT8 = 2,
+  HSIM_DATA_TYPE_INT16 = 3,
+  HSIM_DATA_TYPE_UINT16 = 4,
+  HSIM_DATA_TYPE_INT32 = 5,
+  HSIM_DATA_TYPE_UINT32 = 6,
+  HSIM_DATA_TYPE_INT64 = 7,
+  HSIM_DATA_TYPE_UINT64 = 8,
+  HSIM_DATA_TYPE_FLOAT = 9,
+  HSIM_DATA_TYPE_DOUBLE = 10,
+  HSIM_DATA_TYPE_FLOAT16 = 11
+} hsim_data_type;
+
+/** @brief Type of a sensor */
+typedef enum hsim_sensor_type {
+  HSIM_SENSOR_COLOR = 1,
+  HSIM_SENSOR_DEPTH = 2,
+  HSIM_SENSOR_SEMANTIC = 4
+} hsim_sensor_type;
+
+/** @brief A simulator */
+typedef struct hsim_simulator hsim_simulator;
+
+/** @brief Configuration of a simulator */
+typedef struct hsim_simulator_config {
+  /** Size of the struct, set by @ref hsim_simulator_config_init() */
+  size_t struct_size;
+  /** Scene file to load */
+  const char* scene_id;
+  /** GPU to render on */
+  int gpu_device_id;
+  /** Whether to simulate physics, non-zero for yes */
+  int enable_physics;
+  /** Physics configuration, used with @ref enable_physics */
+  const char* physics_config_file;
+  /** Whether agents slide along obstacles, non-zero for yes */
+  int allow_sliding;
+  /** Whether to skip drawables outside the view, non-zero for yes */
+  int frustum_culling;
+} hsim_simulator_config;
+
+/** @brief A sensor of an agent, see @ref hsim_sensor_config_init() */
+typedef struct hsim_sensor_config {
+  /** Size of the struct, set by @ref hsim_sensor_config_init() */
+  size_t struct_size;
+  /** Unique name of the sensor within its agent */
+  const char* uuid;
+  hsim_sensor_type type;
+  /** Width and height of the observations in pixels */
+  int width;
+  int height;
+  /** Horizontal field of view in degrees */
+  float hfov;
+  /** Position relative to the agent */
+  float position[3];
+  /** Orientation relative to the agent, Euler angles in radians */
+  float orientation[3];
+} hsim_sensor_config;
+
+/** @brief An action of an agent, see @ref hsim_action_config_init() */
+typedef struct hsim_action_config {
+  /** Size of the struct, set by @ref hsim_action_config_init() */
+  size_t struct_size;
+  /** Name passed to @ref hsim_agent_act() */
+  const char* name;
+  /**
+   * Control the action performs, one of `moveForward`, `moveBackward`,
+   * `moveLeft`, `moveRight`, `moveUp`, `moveDown`, `turnLeft`,
+   * `turnRight`, `lookUp` and `lookDown`
+   */
+  const char* control;
+  /** Distance in meters or angle in degrees */
+  float amount;
+} hsim_action_config;
+
+/** @brief Configuration of an agent, see @ref hsim_agent_config_init() */
+typedef struct hsim_agent_config {
+  /** Size of the struct, set by @ref hsim_agent_config_init() */
+  size_t struct_size;
+  float height;
+  float radius;
+  const hsim_sensor_config* sensors;
+  size_t sensor_count;
+  /**
+   * Actions of the agent. If there are none, the agent gets the default
+   * `moveForward`, `turnLeft`, `turnRight`, `lookUp` and `lookDown`
+   * actions named after their controls.
+   */
+  const hsim_action_config* actions;
+  size_t action_count;
+} hsim_agent_config;
+
+/** @brief Shape and type of the observations of a sensor */
+typedef struct hsim_observation_info {
+  /** Size of the struct, the caller sets it to `sizeof` */
+  size_t struct_size;
+  hsim_data_type data_type;
+  /** Height, width and channels, unused trailing dimensions are 1 */
+  size_t shape[3];
+  /** Number of used dimensions of @ref shape */
+  size_t dimensions;
+  /** Bytes of one observation */
+  size_t byte_size;
+} hsim_observation_info;
+
+/** @brief Value of @ref HSIM_API_VERSION the library was built with */
+HSIM_API int hsim_api_version(void);
+
+/**
+ * @brief Description of the last failure on the calling thread
+ *
+ * Valid until the next call on the same thread. Empty if the last call
+ * succeeded.
+ */
+HSIM_API const char* hsim_last_error(void);
+
+/** @brief Fill @p config with the defaults */
+HSIM_API void hsim_simulator_config_init(hsim_simulator_config* config);
+
+/** @brief Fill @p config with the defaults, no sensors and default actions */
+HSIM_API void hsim_agent_config_init(hsim_agent_config* config);
+
+/** @brief Fill @p config with the defaults, an 84x84 color sensor */
+HSIM_API void hsim_sensor_config_init(hsim_sensor_config* config);
+
+/** @brief Fill @p config with the defaults */
+HSIM_API void hsim_action_config_init(hsim_action_config* config);
+
+/** @brief Create a simulator and load its scene into @p simulator */
+HSIM_API hsim_status hsim_simulator_create(const hsim_simulator_config* config,
+                                           hsim_simulator** simulator);
+
+/** @brief Destroy a simulator, null is ignored */
+HSIM_API void hsim_simulator_destroy(hsim_simulator* simulator);
+
+/** @brief Reset the agents to their initial states */
+HSIM_API hsim_status hsim_simulator_reset(hsim_simulator* simulator);
+
+/** @brief Seed the random generators of the simulator */
+HSIM_API hsim_status hsim_simulator_seed(hsim_simulator* simulator,
+                                         uint32_t seed);
+
+/**
+ * @brief Step physics by @p dt seconds
+ * @param[out] world_time Simulated time after the step, can be null
+ */
+HSIM_API hsim_status hsim_simulator_step_world(hsim_simulator* simulator,
+                                               double dt,
+                                               double* world_time);
+
+/** @brief Add an agent, its ID goes to @p agent_id */
+HSIM_API hsim_status hsim_simulator_add_agent(hsim_simulator* simulator,
+                                              const hsim_agent_config* config,
+                                              int* agent_id);
+
+/**
+ * @brief Perform the action @p action of an agent
+ *
+ * Body moves are filtered by the navmesh, if any.
+ */
+HSIM_API hsim_status hsim_agent_act(hsim_simulator* simulator,
+                                    int agent_id,
+                                    const char* action);
+
+/**
+ * @brief Pose of an agent
+ * @param[out] position Three floats
+ * @param[out] rotation Four floats, quaternion coefficients x, y, z, w
+ */
+HSIM_API hsim_status hsim_agent_get_state(hsim_simulator* simulator,
+                                          int agent_id,
+                                          float* position,
+                                          float* rotation);
+
+/**
+ * @brief Move an agent
+ * @param position Three floats
+ * @param rotation Four floats, a normalized quaternion x, y, z, w
+ */
+HSIM_API hsim_status hsim_agent_set_state(hsim_simulator* simulator,
+                                          int agent_id,
+                                          const float* position,
+                                          const float* rotation);
+
+/** @brief Shape and type of the observations of a sensor */
+HSIM_API hsim_status hsim_sensor_get_info(hsim_simulator* simulator,
+                                          int agent_id,
+                                          const char* sensor_uuid,
+                                          hsim_observation_info* info);
+
+/**
+ * @brief Render a sensor and read its observation into @p data
+ * @param data Caller-owned memory of @p size bytes, at least the
+ *    `byte_size` of @ref hsim_sensor_get_info()
+ *
+ * The sensor reads straight into @p data, rows bottom row first like
+ * OpenGL images.
+ */
+HSIM_API hsim_status hsim_sensor_get_observation(hsim_simulator* simulator,
+                                                 int agent_id,
+                                                 const char* sensor_uuid,
+                                                 void* data,
+                                                 size_t size);
+
+/** @brief Whether the simulator has a navmesh, non-zero for yes */
+HSIM_API int hsim_pathfinder_is_loaded(hsim_simulator* simulator);
+
+/** @brief Load the navmesh at @p path */
+HSIM_API hsim_status hsim_pathfinder_load(hsim_simulator* simulator,
+                                          const char* path);
+
+/**
+ * @brief A random navigable point
+ * @param[out] point Three floats
+ */
+HSIM_API hsim_status
+hsim_pathfinder_random_navigable_point(hsim_simulator* simulator,
+                                       float* point);
+
+/**
+ * @brief Closest navigable point to @p point
+ * @param[out] result Three floats, NaN if there is none
+ */
+HSIM_API hsim_status hsim_pathfinder_snap_point(hsim_simulator* simulator,
+                                                const float* point,
+                                                float* result);
+
+/**
+ * @brief Where a step from @p start towards @p end ends on the navmesh
+ * @param[out] result Three floats
+ */
+HSIM_API hsim_status hsim_pathfinder_try_step(hsim_simulator* simulator,
+                                              const float* start,
+                                              const float* end,
+                                              float* result);
+
+/**
+ * @brief Whether @p point is navigable
+ * @param[out] navigable Non-zero for yes
+ */
+HSIM_API hsim_status hsim_pathfinder_is_navigable(hsim_simulator* simulator,
+                                                  const float* point,
+                                                  int* navigable);
+
+/**
+ * @brief Shortest path between two points
+ * @param[out] distance    Geodesic distance, infinity if there is no path
+ * @param[out] points      Three floats per point of the path, can be null
+ * @param      max_points  Points that fit into @p points
+ * @param[out] point_count Points of the path, can be null
+ *
+ * Fails with @ref HSIM_ERROR_BUFFER_TOO_SMALL if there are more than
+ * @p max_points points, which still sets @p distance and @p point_count.
+ */
+HSIM_API hsim_status hsim_pathfinder_find_path(hsim_simulator* simulator,
+                                               const float* start,
+                                               const float* end,
+                                               float* distance,
+                                               float* points,
+                                               size_t max_points,
+                                               size_t* point_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
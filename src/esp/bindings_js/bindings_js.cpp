@@ -170,7 +170,9 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .property("defaultAgentId", &SimulatorConfiguration::defaultAgentId)
       .property("defaultCameraUuid", &SimulatorConfiguration::defaultCameraUuid)
       .property("gpuDeviceId", &SimulatorConfiguration::gpuDeviceId)
-      .property("compressTextures", &SimulatorConfiguration::compressTextures);
+      .property("compressTextures", &SimulatorConfiguration::compressTextures)
+      .property("maxResidentScenes",
+                &SimulatorConfiguration::maxResidentScenes);
 
   em::class_<AgentState>("AgentState")
       .smart_ptr_constructor("AgentState", &AgentState::create<>)
@@ -191,7 +193,8 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .function("getState", &Agent::getState)
       .function("setState", &Agent::setState)
       .function("hasAction", &Agent::hasAction)
-      .function("act", &Agent::act);
+      .function("act",
+                em::select_overload<bool(const std::string&)>(&Agent::act));
 
   em::class_<Observation>("Observation")
       .smart_ptr_constructor("Observation", &Observation::create<>)
@@ -222,6 +225,7 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .function("getSemanticScene", &Simulator::getSemanticScene)
       .function("seed", &Simulator::seed)
       .function("reconfigure", &Simulator::reconfigure)
+      .function("prefetchScene", &Simulator::prefetchScene)
       .function("reset", &Simulator::reset)
       .function("getAgentObservations", &Simulator::getAgentObservations)
       .function("getAgentObservation", &Simulator::getAgentObservation)
@@ -231,6 +235,7 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .function("getAgentObservationSpace", &Simulator_getAgentObservationSpace)
       .function("getAgent", &Simulator::getAgent)
       .function("getPathFinder", &Simulator::getPathFinder)
+      .function("loadNavMesh", &Simulator::loadNavMesh)
       .function("addAgent",
                 em::select_overload<Agent::ptr(const AgentConfiguration&)>(
                     &Simulator::addAgent))
@@ -9,19 +9,17 @@ import VRDemo from "./modules/vr_demo";
 import ViewerDemo from "./modules/viewer_demo";
 import { defaultScene } from "./modules/defaults";
 import "./bindings.css";
+import { streamScene } from "./modules/scene_stream";
 import {
   checkWebAssemblySupport,
   checkWebgl2Support,
-  getInfoSemanticUrl,
+  getFileName,
+  getSceneFileUrls,
   buildConfigFromURLParameters
 } from "./modules/utils";
 
 function preload(url) {
-  let file = url;
-  if (url.indexOf("http") === 0) {
-    const splits = url.split("/");
-    file = splits[splits.length - 1];
-  }
+  const file = getFileName(url);
   FS.createPreloadedFile("/", file, url, true, false);
   return file;
 }
@@ -31,16 +29,15 @@ Module.preRun.push(() => {
   config.scene = defaultScene;
   buildConfigFromURLParameters(config);
   window.config = config;
-  const scene = config.scene;
-  Module.scene = preload(scene);
-  const fileNoExtension = scene.substr(0, scene.lastIndexOf("."));
-
-  preload(fileNoExtension + ".navmesh");
-  if (config.semantic === "mp3d") {
-    preload(fileNoExtension + ".house");
-    preload(fileNoExtension + "_semantic.ply");
-  } else if (config.semantic === "replica") {
-    preload(getInfoSemanticUrl(config.scene));
+  const urls = getSceneFileUrls(config);
+  const navigationFiles = urls.navigation.map(preload);
+  if (config.stream) {
+    // start on the navmesh alone, the meshes are downloaded afterwards
+    Module.scene = "NONE";
+    Module.navmesh = navigationFiles[0];
+    Module.streamedUrls = urls.meshes;
+  } else {
+    [Module.scene] = urls.meshes.map(preload);
   }
 });
 
@@ -61,6 +58,9 @@ Module.onRuntimeInitialized = () => {
   }
 
   demo.display();
+  if (Module.streamedUrls) {
+    streamScene(demo, Module.streamedUrls);
+  }
 };
 
 function checkSupport() {
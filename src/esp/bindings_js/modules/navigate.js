@@ -35,27 +35,7 @@ class NavigateTask {
         this.semanticShape.get(0)
       );
       this.semanticObservation = new Module.Observation();
-      this.semanticScene = this.sim.sim.getSemanticScene();
-      this.semanticObjects = this.semanticScene.objects;
-
-      if (window.config.category) {
-        const scopeWidth = this.components.scope.offsetWidth;
-        const scopeHeight = this.components.scope.offsetHeight;
-        const scopeInsetX = (this.components.canvas.width - scopeWidth) / 2;
-        const scopeInsetY = (this.components.canvas.height - scopeHeight) / 2;
-        const objectSearchRect = {
-          left: scopeInsetX,
-          top: scopeInsetY,
-          right: scopeInsetX + scopeWidth,
-          bottom: scopeInsetY + scopeHeight
-        };
-        this.objectSensor = new ObjectSensor(
-          objectSearchRect,
-          this.semanticShape,
-          this.semanticScene,
-          window.config.category
-        );
-      }
+      this.updateSemanticScene();
 
       components.canvas.onmousedown = e => {
         this.handleMouseDown(e);
@@ -85,6 +65,37 @@ class NavigateTask {
     this.setStatus(this.semanticObjects.get(objectId).category.getName(""));
   }
 
+  /**
+   * Pick up the semantic scene of the current scene, after the simulator
+   * switched to another one.
+   */
+  updateSemanticScene() {
+    if (!this.semanticsEnabled) {
+      return;
+    }
+    this.semanticScene = this.sim.sim.getSemanticScene();
+    this.semanticObjects = this.semanticScene.objects;
+
+    if (window.config.category) {
+      const scopeWidth = this.components.scope.offsetWidth;
+      const scopeHeight = this.components.scope.offsetHeight;
+      const scopeInsetX = (this.components.canvas.width - scopeWidth) / 2;
+      const scopeInsetY = (this.components.canvas.height - scopeHeight) / 2;
+      const objectSearchRect = {
+        left: scopeInsetX,
+        top: scopeInsetY,
+        right: scopeInsetX + scopeWidth,
+        bottom: scopeInsetY + scopeHeight
+      };
+      this.objectSensor = new ObjectSensor(
+        objectSearchRect,
+        this.semanticShape,
+        this.semanticScene,
+        window.config.category
+      );
+    }
+  }
+
   /**
    * Initialize the task. Should be called once.
    */
@@ -0,0 +1,80 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+/* global FS */
+import { getFileName } from "./utils";
+
+/**
+ * Download a file into the Emscripten filesystem, reporting progress.
+ * @param {string} url - URL of the file
+ * @param {function} onProgress - called with the bytes received so far and
+ * the total, which is 0 if the server doesn't send a length
+ * @returns {Promise<string>} name of the written file
+ */
+export async function fetchToFS(url, onProgress = () => {}) {
+  const response = await fetch(url);
+  if (!response.ok) {
+    throw new Error("Cannot download " + url + ": " + response.status);
+  }
+  const total = parseInt(response.headers.get("Content-Length")) || 0;
+  const reader = response.body.getReader();
+  const chunks = [];
+  let received = 0;
+  for (;;) {
+    const { done, value } = await reader.read();
+    if (done) {
+      break;
+    }
+    chunks.push(value);
+    received += value.length;
+    onProgress(received, total);
+  }
+
+  const data = new Uint8Array(received);
+  let offset = 0;
+  for (const chunk of chunks) {
+    data.set(chunk, offset);
+    offset += chunk.length;
+  }
+  const file = getFileName(url);
+  FS.writeFile(file, data);
+  return file;
+}
+
+/**
+ * Download the scene meshes while the demo runs on the navmesh alone, then
+ * switch to the scene keeping the agent where it is.
+ * @param {WebDemo} demo - demo started with an empty scene
+ * @param {Array<string>} urls - scene mesh first, then the semantic mesh
+ */
+export async function streamScene(demo, urls) {
+  const received = urls.map(() => 0);
+  const totals = urls.map(() => 0);
+  const onProgress = index => (bytes, total) => {
+    received[index] = bytes;
+    totals[index] = total;
+    const sum = (a, b) => a + b;
+    const receivedBytes = received.reduce(sum, 0);
+    const totalBytes = totals.reduce(sum, 0);
+    if (totalBytes > 0) {
+      const percent = Math.floor((100 * receivedBytes) / totalBytes);
+      demo.task.setWarningStatus("Loading scene " + percent + "%");
+    } else {
+      const megabytes = (receivedBytes / (1024 * 1024)).toFixed(1);
+      demo.task.setWarningStatus("Loading scene " + megabytes + " MB");
+    }
+  };
+
+  try {
+    const files = await Promise.all(
+      urls.map((url, index) => fetchToFS(url, onProgress(index)))
+    );
+    demo.simenv.reconfigureScene(files[0]);
+    demo.task.updateSemanticScene();
+    demo.task.setStatus("Ready");
+    demo.task.render();
+  } catch (error) {
+    demo.task.setErrorStatus(error.message);
+  }
+}
@@ -20,6 +20,7 @@ class SimEnv {
    * @param {number} agentId - default agent id
    */
   constructor(config, episode = {}, agentId = 0) {
+    this.config = config;
     this.sim = new Module.Simulator(config);
     this.episode = episode;
     this.initialAgentState = null;
@@ -41,6 +42,30 @@ class SimEnv {
     }
   }
 
+  /**
+   * Load the navmesh before the scene, so agents added afterwards can
+   * navigate while the scene is streamed in.
+   * @param {string} navmesh - navmesh file in the filesystem
+   * @returns {boolean} whether the navmesh was loaded
+   */
+  loadNavMesh(navmesh) {
+    return this.sim.loadNavMesh(navmesh);
+  }
+
+  /**
+   * Switch to another scene, keeping the agent where it is. Needs
+   * maxResidentScenes of at least 2 so the agent comes along.
+   * @param {string} sceneId - scene file in the filesystem
+   */
+  reconfigureScene(sceneId) {
+    const state = this.getAgentState();
+    const sceneConfig = this.config.scene;
+    sceneConfig.id = sceneId;
+    this.config.scene = sceneConfig;
+    this.sim.reconfigure(this.config);
+    this.sim.getAgent(this.selectedAgentId).setState(state, true);
+  }
+
   changeAgent(agentId) {
     this.selectedAgentId = agentId;
   }
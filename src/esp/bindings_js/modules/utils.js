@@ -92,6 +92,39 @@ export function getInfoSemanticUrl(mainUrl) {
   return splits.join("/") + infoSemanticPath;
 }
 
+/**
+ * Name of the file a URL is downloaded to in the Emscripten filesystem.
+ * @param {string} url - URL of the file
+ */
+export function getFileName(url) {
+  if (url.indexOf("http") === 0) {
+    const splits = url.split("/");
+    return splits[splits.length - 1];
+  }
+  return url;
+}
+
+/**
+ * URLs of the files a scene loads, split into the small ones navigation
+ * needs and the meshes, which can be streamed in after the first frame.
+ * @param {Object} config - configuration with the scene URL and semantics
+ */
+export function getSceneFileUrls(config) {
+  const scene = config.scene;
+  const fileNoExtension = scene.substr(0, scene.lastIndexOf("."));
+  const urls = {
+    navigation: [fileNoExtension + ".navmesh"],
+    meshes: [scene]
+  };
+  if (config.semantic === "mp3d") {
+    urls.navigation.push(fileNoExtension + ".house");
+    urls.meshes.push(fileNoExtension + "_semantic.ply");
+  } else if (config.semantic === "replica") {
+    urls.navigation.push(getInfoSemanticUrl(config.scene));
+  }
+  return urls;
+}
+
 export function buildConfigFromURLParameters(config = {}) {
   for (let arg of window.location.search.substr(1).split("&")) {
     let [key, value] = arg.split("=");
@@ -27,7 +27,15 @@ class WebDemo {
     this.sceneConfig.id = Module.scene;
     this.config = new Module.SimulatorConfiguration();
     this.config.scene = this.sceneConfig;
+    if (Module.navmesh) {
+      // streamed scenes start out empty, keep it resident so the agent moves
+      // over to the scene once it is downloaded
+      this.config.maxResidentScenes = 2;
+    }
     this.simenv = new SimEnv(this.config, episode, 0);
+    if (Module.navmesh) {
+      this.simenv.loadNavMesh(Module.navmesh);
+    }
 
     agentConfig = this.updateAgentConfigWithSensors({ ...agentConfig });
 
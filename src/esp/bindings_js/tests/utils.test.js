@@ -5,6 +5,8 @@
 import {
   throttle,
   getInfoSemanticUrl,
+  getFileName,
+  getSceneFileUrls,
   buildConfigFromURLParameters
 } from "../modules/utils";
 
@@ -62,3 +64,27 @@ test("configuration should be built from url parameters", () => {
   expect(config.d).toEqual("true");
   expect(config.e).toEqual("1");
 });
+
+test("downloaded files should be named after the url", () => {
+  expect(getFileName("https://some_path.com/x/mesh.glb")).toEqual("mesh.glb");
+  expect(getFileName("mesh.glb")).toEqual("mesh.glb");
+});
+
+test("scene files should be split into navigation and meshes", () => {
+  const urls = getSceneFileUrls({
+    scene: "https://some_path.com/x/house.glb",
+    semantic: "mp3d"
+  });
+  expect(urls.navigation).toEqual([
+    "https://some_path.com/x/house.navmesh",
+    "https://some_path.com/x/house.house"
+  ]);
+  expect(urls.meshes).toEqual([
+    "https://some_path.com/x/house.glb",
+    "https://some_path.com/x/house_semantic.ply"
+  ]);
+  expect(getSceneFileUrls({ scene: "mesh.ply" })).toEqual({
+    navigation: ["mesh.navmesh"],
+    meshes: ["mesh.ply"]
+  });
+});
@@ -4,9 +4,128 @@
 
 #include "Buffer.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#include <Corrade/Utility/Assert.h>
+
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include "Metrics.h"
+#include "esp/core/logging.h"
+
 namespace esp {
 namespace core {
 
+constexpr size_t Buffer::Alignment;
+constexpr size_t Buffer::MaxPooledBytes;
+
+namespace {
+
+// Bytes actually allocated for @p byteSize, rounded up to a quarter of the
+// power of two below it, so at most a fifth is wasted
+size_t sizeClass(size_t byteSize) {
+  if (byteSize <= Buffer::Alignment) {
+    return Buffer::Alignment;
+  }
+  size_t power = Buffer::Alignment;
+  while (power * 2 < byteSize) {
+    power *= 2;
+  }
+  const size_t step = power / 4;
+  return (byteSize + step - 1) / step * step;
+}
+
+struct MemoryPool {
+  std::mutex mutex;
+  // freed blocks by size class, aligned and pinned ones separate
+  std::unordered_map<size_t, std::vector<void*>> blocks[2];
+  size_t pooledBytes = 0;
+};
+
+MemoryPool& memoryPool() {
+  // never destroyed, buffers may still be freed during static destruction
+  static MemoryPool* pool = new MemoryPool;
+  return *pool;
+}
+
+// Changes @p storage to Aligned if pinned memory isn't available
+void* systemAllocate(size_t size, BufferStorage& storage) {
+  if (storage == BufferStorage::Pinned) {
+#ifdef ESP_BUILD_WITH_CUDA
+    void* memory = nullptr;
+    // portable, so it's pinned for every device
+    if (cudaHostAlloc(&memory, size, cudaHostAllocPortable) == cudaSuccess) {
+      return memory;
+    }
+    // clear the error, the CUDA runtime would report it on the next call
+    cudaGetLastError();
+#endif
+    static bool warned = false;
+    if (!warned) {
+      LOG(WARNING) << "Buffer: pinned memory not available, using pageable "
+                      "memory instead";
+      warned = true;
+    }
+    storage = BufferStorage::Aligned;
+  }
+  void* memory = nullptr;
+  if (posix_memalign(&memory, Buffer::Alignment, size) != 0) {
+    throw std::bad_alloc{};
+  }
+  return memory;
+}
+
+void systemFree(void* memory, BufferStorage storage) {
+#ifdef ESP_BUILD_WITH_CUDA
+  if (storage == BufferStorage::Pinned) {
+    cudaFreeHost(memory);
+    return;
+  }
+#else
+  static_cast<void>(storage);
+#endif
+  std::free(memory);
+}
+
+void* allocateBlock(size_t classSize, BufferStorage& storage) {
+  MemoryPool& pool = memoryPool();
+  {
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    auto found = pool.blocks[int(storage)].find(classSize);
+    if (found != pool.blocks[int(storage)].end() && !found->second.empty()) {
+      void* memory = found->second.back();
+      found->second.pop_back();
+      pool.pooledBytes -= classSize;
+      return memory;
+    }
+  }
+  return systemAllocate(classSize, storage);
+}
+
+template <BufferStorage storage>
+void freeBlock(uint8_t* data, size_t byteSize) {
+  const size_t classSize = sizeClass(byteSize);
+  MemoryPool& pool = memoryPool();
+  {
+    std::lock_guard<std::mutex> lock{pool.mutex};
+    if (pool.pooledBytes + classSize <= Buffer::MaxPooledBytes) {
+      pool.blocks[int(storage)][classSize].push_back(data);
+      pool.pooledBytes += classSize;
+      return;
+    }
+  }
+  systemFree(data, storage);
+}
+
+}  // namespace
+
 size_t getDataTypeByteSize(DataType dt) {
   switch (dt) {
     case DataType::DT_INT8:
@@ -14,6 +133,7 @@ size_t getDataTypeByteSize(DataType dt) {
       return 1;
     case DataType::DT_INT16:
     case DataType::DT_UINT16:
+    case DataType::DT_FLOAT16:
       return 2;
     case DataType::DT_INT32:
     case DataType::DT_UINT32:
@@ -43,11 +163,32 @@ void Buffer::alloc() {
   }
   if (size != this->totalSize) {
     this->totalSize = size;
+    const size_t byteSize = size * getDataTypeByteSize(dataType);
+    void* memory = allocateBlock(sizeClass(byteSize), this->storage);
     this->data = Corrade::Containers::Array<uint8_t>{
-        size * getDataTypeByteSize(dataType)};
+        static_cast<uint8_t*>(memory), byteSize,
+        this->storage == BufferStorage::Pinned
+            ? freeBlock<BufferStorage::Pinned>
+            : freeBlock<BufferStorage::Aligned>};
   }
 }
 
+Buffer::ptr Buffer::wrap(uint8_t* data,
+                         const std::vector<size_t>& shape,
+                         DataType dataType) {
+  auto buffer = Buffer::create();
+  buffer->shape = shape;
+  buffer->dataType = dataType;
+  buffer->totalSize = 1;
+  for (size_t extent : shape) {
+    buffer->totalSize *= extent;
+  }
+  buffer->data = Corrade::Containers::Array<uint8_t>{
+      data, buffer->totalSize * getDataTypeByteSize(dataType),
+      [](uint8_t*, size_t) {}};
+  return buffer;
+}
+
 void Buffer::dealloc() {
   if (this->data != nullptr) {
     this->data = Corrade::Containers::Array<uint8_t>{};
@@ -55,5 +196,74 @@ void Buffer::dealloc() {
   }
 }
 
+size_t Buffer::pooledBytes() {
+  MemoryPool& pool = memoryPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  return pool.pooledBytes;
+}
+
+void Buffer::releasePooledMemory() {
+  MemoryPool& pool = memoryPool();
+  std::lock_guard<std::mutex> lock{pool.mutex};
+  for (BufferStorage storage :
+       {BufferStorage::Aligned, BufferStorage::Pinned}) {
+    for (auto& blocks : pool.blocks[int(storage)]) {
+      for (void* memory : blocks.second) {
+        systemFree(memory, storage);
+      }
+    }
+    pool.blocks[int(storage)].clear();
+  }
+  pool.pooledBytes = 0;
+}
+
+BufferPool::BufferPool(const std::vector<size_t>& shape,
+                       DataType dataType,
+                       size_t capacity /* = 0 */,
+                       BufferStorage storage /* = BufferStorage::Aligned */)
+    : shape_{shape}, dataType_{dataType}, storage_{storage} {
+  buffers_.reserve(capacity);
+  for (size_t i = 0; i < capacity; ++i) {
+    buffers_.emplace_back(Buffer::create(shape_, dataType_, storage_));
+  }
+  allocationCount_ = capacity;
+}
+
+Buffer::ptr BufferPool::acquire() {
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    const size_t index = (next_ + i) % buffers_.size();
+    if (buffers_[index].use_count() == 1) {
+      next_ = (index + 1) % buffers_.size();
+      return buffers_[index];
+    }
+  }
+  // everything is in use, grow the ring
+  buffers_.emplace_back(Buffer::create(shape_, dataType_, storage_));
+  ++allocationCount_;
+  static Metrics::Counter& allocations =
+      Metrics::counter("core.buffer_allocations");
+  allocations.add();
+  next_ = 0;
+  return buffers_.back();
+}
+
+void BufferPool::release(Buffer::ptr& buffer) {
+  CORRADE_ASSERT(
+      !buffer || std::find(buffers_.begin(), buffers_.end(), buffer) !=
+                     buffers_.end(),
+      "BufferPool::release(): buffer does not belong to this pool", );
+  buffer = nullptr;
+}
+
+void BufferPool::clear() {
+  buffers_.erase(
+      std::remove_if(buffers_.begin(), buffers_.end(),
+                     [](const Buffer::ptr& buffer) {
+                       return buffer.use_count() == 1;
+                     }),
+      buffers_.end());
+  next_ = 0;
+}
+
 }  // namespace core
 }  // namespace esp
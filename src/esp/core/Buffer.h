@@ -5,6 +5,8 @@
 #pragma once
 #include <Corrade/Containers/Array.h>
 
+#include <vector>
+
 #include "esp/core/esp.h"
 
 namespace esp {
@@ -23,19 +25,77 @@ enum class DataType {
   DT_UINT64 = 8,
   DT_FLOAT = 9,
   DT_DOUBLE = 10,
+  // IEEE 754 half precision, stored as its 16 bits
+  DT_FLOAT16 = 11,
+};
+
+// Size of a single element of given data type in bytes, 0 for DT_NONE
+size_t getDataTypeByteSize(DataType dt);
+
+/** @brief Kind of memory backing a @ref Buffer */
+enum class BufferStorage {
+  /** Pageable host memory */
+  Aligned,
+  /**
+   * Page-locked host memory, which CUDA copies to and from the device by
+   * DMA without a staging copy. Needs a CUDA build and device, otherwise
+   * the buffer gets @ref BufferStorage::Aligned memory instead.
+   */
+  Pinned,
 };
 
+/**
+ * @brief Dense array of elements of one data type
+ *
+ * The data is aligned to @ref Alignment bytes and not initialized on
+ * allocation, use @ref clear() to zero it. Memory comes from a process-wide
+ * pool of size classes, a quarter of a power of two apart, so buffers
+ * allocated over and over, e.g. with every observation or batch, reuse the
+ * memory of those freed before instead of going to the heap. That matters
+ * most for @ref BufferStorage::Pinned memory, which is expensive to
+ * page-lock.
+ */
 class Buffer {
  public:
+  /** @brief Alignment of @ref data in bytes */
+  static constexpr size_t Alignment = 64;
+
+  /**
+   * @brief Most bytes of freed memory the pool keeps for reuse
+   *
+   * Memory freed beyond this goes back to the system.
+   */
+  static constexpr size_t MaxPooledBytes = size_t{256} << 20;
+
   explicit Buffer() {}
-  explicit Buffer(const std::vector<size_t> shape, const DataType dataType) {
+  explicit Buffer(const std::vector<size_t> shape,
+                  const DataType dataType,
+                  BufferStorage storage = BufferStorage::Aligned) {
     this->shape = shape;
     this->dataType = dataType;
+    this->storage = storage;
     alloc();
   }
   void clear();
   virtual ~Buffer() { dealloc(); }
 
+  /**
+   * @brief Buffer on memory owned by somebody else
+   *
+   * Nothing is allocated or freed. @p data has to hold @p shape elements of
+   * @p dataType and outlive the buffer, e.g. one row of a tensor stacking
+   * the observations of many simulators.
+   */
+  static std::shared_ptr<Buffer> wrap(uint8_t* data,
+                                      const std::vector<size_t>& shape,
+                                      DataType dataType);
+
+  /** @brief Bytes of freed memory kept in the pool */
+  static size_t pooledBytes();
+
+  /** @brief Return the freed memory kept in the pool to the system */
+  static void releasePooledMemory();
+
  protected:
   void alloc();
   void dealloc();
@@ -45,9 +105,76 @@ class Buffer {
   size_t totalSize = 0;
   DataType dataType = DataType::DT_UINT8;
   std::vector<size_t> shape;
+  // the memory actually allocated, Aligned if pinning failed
+  BufferStorage storage = BufferStorage::Aligned;
 
   ESP_SMART_POINTERS(Buffer)
 };
 
+/**
+ * @brief Ring of preallocated buffers of one shape and type
+ *
+ * Hands out buffers that are not referenced outside of the pool, so data a
+ * consumer still holds on to (e.g. a numpy view of an observation) is never
+ * overwritten. Buffers go back to the pool once the last outside reference
+ * is dropped, either implicitly or through @ref release(). A new buffer is
+ * only allocated when all of them are still in use, so in steady state
+ * @ref acquire() does not touch the heap; @ref allocationCount() tracks this.
+ */
+class BufferPool {
+ public:
+  /**
+   * @brief Constructor
+   * @param shape     Shape of the buffers
+   * @param dataType  Element type of the buffers
+   * @param capacity  Number of buffers to allocate upfront
+   * @param storage   Memory of the buffers
+   */
+  explicit BufferPool(const std::vector<size_t>& shape,
+                      DataType dataType,
+                      size_t capacity = 0,
+                      BufferStorage storage = BufferStorage::Aligned);
+
+  /**
+   * @brief Buffer not referenced by anybody but the pool
+   *
+   * Buffers are handed out round-robin. The contents are whatever was last
+   * written into the buffer.
+   */
+  Buffer::ptr acquire();
+
+  /**
+   * @brief Give @p buffer back to the pool
+   *
+   * Resets @p buffer. The buffer is reusable once no other references to it
+   * are left.
+   */
+  void release(Buffer::ptr& buffer);
+
+  /** @brief Number of buffers in the pool */
+  size_t size() const { return buffers_.size(); }
+
+  /** @brief Number of buffers allocated since construction */
+  size_t allocationCount() const { return allocationCount_; }
+
+  /** @brief Release all buffers not in use */
+  void clear();
+
+  const std::vector<size_t>& shape() const { return shape_; }
+  DataType dataType() const { return dataType_; }
+  BufferStorage storage() const { return storage_; }
+
+ protected:
+  std::vector<size_t> shape_;
+  DataType dataType_;
+  BufferStorage storage_;
+  std::vector<Buffer::ptr> buffers_;
+  // where the round-robin search for a free buffer starts
+  size_t next_ = 0;
+  size_t allocationCount_ = 0;
+
+  ESP_SMART_POINTERS(BufferPool)
+};
+
 }  // namespace core
 }  // namespace esp
@@ -14,11 +14,23 @@
 namespace esp {
 namespace core {
 
+/**
+ * @brief String-keyed storage of values, converted on access
+ *
+ * Derived classes can keep a typed copy of values that are read often, so a
+ * read is a field load instead of a lookup and a string conversion. The
+ * string storage stays the source of truth: every write through the generic
+ * interface calls @ref updateTypedValue(), which refreshes the matching copy.
+ */
 class Configuration {
  public:
+  virtual ~Configuration() = default;
+
   template <typename T>
   bool set(const std::string& key, const T& value) {
-    return cfg.setValue(key, value);
+    const bool result = cfg.setValue(key, value);
+    updateTypedValue(key);
+    return result;
   }
   bool setBool(const std::string& key, bool value) { return set(key, value); }
   bool setFloat(const std::string& key, float value) { return set(key, value); }
@@ -65,9 +77,36 @@ class Configuration {
 
   bool hasValue(const std::string& key) const { return cfg.hasValue(key); }
 
-  bool removeValue(const std::string& key) { return cfg.removeValue(key); }
+  bool removeValue(const std::string& key) {
+    const bool result = cfg.removeValue(key);
+    updateTypedValue(key);
+    return result;
+  }
 
  protected:
+  /**
+   * @brief Reload the typed copy of @p key, if the class keeps one
+   *
+   * Called after every write and removal. Implementations usually chain
+   * @ref loadTypedValue() for each of their copies.
+   */
+  virtual void updateTypedValue(const std::string&) {}
+
+  /**
+   * @brief If @p key is @p name, reload @p value from the string storage
+   *
+   * A removed value reloads as a default-constructed one.
+   * @return Whether @p key matched, to stop a chain of calls early
+   */
+  template <typename T>
+  bool loadTypedValue(const std::string& key, const char* name, T& value) {
+    if (key != name) {
+      return false;
+    }
+    value = cfg.hasValue(key) ? cfg.value<T>(key) : T{};
+    return true;
+  }
+
   Corrade::Utility::ConfigurationGroup cfg;
 
   ESP_SMART_POINTERS(Configuration)
@@ -0,0 +1,84 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Views between the Eigen types of @ref esp.h and Magnum math types
+ *
+ * The vectors and quaternions of both libraries are plain arrays of floats
+ * in the same order, quaternions being x, y, z, w like the rotation of
+ * @ref agent::AgentState. The views below reinterpret one as the other
+ * instead of converting through a temporary like
+ * @cpp Magnum::EigenIntegration::cast() @ce does.
+ */
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace core {
+
+static_assert(sizeof(vec3f) == sizeof(Magnum::Vector3),
+              "vec3f and Magnum::Vector3 are expected to share a layout");
+static_assert(sizeof(vec4f) == sizeof(Magnum::Quaternion),
+              "vec4f and Magnum::Quaternion are expected to share a layout");
+static_assert(sizeof(quatf) == sizeof(Magnum::Quaternion),
+              "quatf and Magnum::Quaternion are expected to share a layout");
+
+/** @brief @p v as a Magnum vector */
+inline Magnum::Vector3& asMagnum(vec3f& v) {
+  return Magnum::Vector3::from(v.data());
+}
+
+/** @overload */
+inline const Magnum::Vector3& asMagnum(const vec3f& v) {
+  return Magnum::Vector3::from(v.data());
+}
+
+/** @brief @p q as a Magnum quaternion */
+inline Magnum::Quaternion& asMagnum(quatf& q) {
+  return Magnum::Quaternion::from(q.coeffs().data());
+}
+
+/** @overload */
+inline const Magnum::Quaternion& asMagnum(const quatf& q) {
+  return Magnum::Quaternion::from(q.coeffs().data());
+}
+
+/** @brief Quaternion coefficients x, y, z, w as a Magnum quaternion */
+inline Magnum::Quaternion& asMagnumQuaternion(vec4f& coeffs) {
+  return Magnum::Quaternion::from(coeffs.data());
+}
+
+/** @overload */
+inline const Magnum::Quaternion& asMagnumQuaternion(const vec4f& coeffs) {
+  return Magnum::Quaternion::from(coeffs.data());
+}
+
+/** @brief @p v as an Eigen vector */
+inline Eigen::Map<vec3f> asEigen(Magnum::Vector3& v) {
+  return Eigen::Map<vec3f>{v.data()};
+}
+
+/** @overload */
+inline Eigen::Map<const vec3f> asEigen(const Magnum::Vector3& v) {
+  return Eigen::Map<const vec3f>{v.data()};
+}
+
+/** @brief @p q as an Eigen quaternion */
+inline Eigen::Map<quatf> asEigen(Magnum::Quaternion& q) {
+  return Eigen::Map<quatf>{q.data()};
+}
+
+/** @overload */
+inline Eigen::Map<const quatf> asEigen(const Magnum::Quaternion& q) {
+  return Eigen::Map<const quatf>{q.data()};
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,135 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace esp {
+namespace core {
+
+namespace {
+
+constexpr double SumScale = 1.0e6;
+
+struct Registry {
+  std::mutex mutex;
+  // map nodes never move, so references handed out stay valid
+  std::map<std::string, Metrics::Counter> counters;
+  std::map<std::string, Metrics::Histogram> histograms;
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+}  // namespace
+
+constexpr std::size_t Metrics::Histogram::BucketCount;
+
+void Metrics::Histogram::record(double value) {
+  std::size_t bucket = 0;
+  if (value >= 1.0) {
+    int exponent;
+    // value = mantissa * 2^exponent with mantissa in [0.5, 1)
+    std::frexp(value, &exponent);
+    bucket = std::min(std::size_t(exponent), BucketCount - 1);
+  } else if (!(value > 0.0)) {
+    value = 0.0;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(std::llround(value * SumScale), std::memory_order_relaxed);
+}
+
+double Metrics::Histogram::sum() const {
+  return sum_.load(std::memory_order_relaxed) / SumScale;
+}
+
+double Metrics::Histogram::percentile(double fraction) const {
+  int64_t total = 0;
+  std::array<int64_t, BucketCount> counts;
+  for (std::size_t i = 0; i != BucketCount; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+  const double rank = fraction * total;
+  int64_t seen = 0;
+  for (std::size_t i = 0; i != BucketCount; ++i) {
+    seen += counts[i];
+    if (seen >= rank && counts[i] != 0) {
+      return std::ldexp(1.0, int(i));
+    }
+  }
+  return std::ldexp(1.0, int(BucketCount - 1));
+}
+
+Metrics::Counter& Metrics::counter(const std::string& name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  return r.counters[name];
+}
+
+Metrics::Histogram& Metrics::histogram(const std::string& name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  return r.histograms[name];
+}
+
+std::map<std::string, double> Metrics::snapshot(bool reset /* = false */) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  std::map<std::string, double> values;
+  for (auto& counter : r.counters) {
+    Counter& c = counter.second;
+    values[counter.first] =
+        reset && !c.level_.load(std::memory_order_relaxed)
+            ? c.value_.exchange(0, std::memory_order_relaxed)
+            : c.value();
+  }
+  for (auto& histogram : r.histograms) {
+    Histogram& h = histogram.second;
+    if (h.count() == 0) {
+      continue;
+    }
+    values[histogram.first + ".count"] = h.count();
+    values[histogram.first + ".sum"] = h.sum();
+    values[histogram.first + ".p50"] = h.percentile(0.5);
+    values[histogram.first + ".p90"] = h.percentile(0.9);
+    values[histogram.first + ".p99"] = h.percentile(0.99);
+    if (reset) {
+      h.count_.store(0, std::memory_order_relaxed);
+      h.sum_.store(0, std::memory_order_relaxed);
+      for (std::atomic<int64_t>& bucket : h.buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+  return values;
+}
+
+void Metrics::reset() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock{r.mutex};
+  for (auto& counter : r.counters) {
+    counter.second.value_.store(0, std::memory_order_relaxed);
+  }
+  for (auto& histogram : r.histograms) {
+    Histogram& h = histogram.second;
+    h.count_.store(0, std::memory_order_relaxed);
+    h.sum_.store(0, std::memory_order_relaxed);
+    for (std::atomic<int64_t>& bucket : h.buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace esp
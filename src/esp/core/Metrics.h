@@ -0,0 +1,134 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::core::Metrics
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace esp {
+namespace core {
+
+/**
+@brief Process-wide registry of counters and histograms
+
+Subsystems look their metrics up by name once, usually into a function-local
+static, and update them with relaxed atomics afterwards, so updating costs
+about as much as an uncontended atomic add and threads never lock:
+
+@code{.cpp}
+static core::Metrics::Counter& drawn =
+    core::Metrics::counter("render.drawables_drawn");
+drawn.add(statistics.drawables);
+@endcode
+
+@ref snapshot() reads all of them at once, e.g. per step or per episode, and
+optionally resets them, so consecutive snapshots hold the deltas in between.
+Names are dot-separated, the subsystem first.
+*/
+class Metrics {
+ public:
+  /** @brief Sum, or with @ref set() the last value, of an integer quantity */
+  class Counter {
+   public:
+    /** @brief Add @p value */
+    void add(int64_t value = 1) {
+      value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /** @brief Replace the value, for quantities that are a current level */
+    void set(int64_t value) {
+      value_.store(value, std::memory_order_relaxed);
+      level_.store(true, std::memory_order_relaxed);
+    }
+
+    /** @brief Current value */
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+   private:
+    friend Metrics;
+    std::atomic<int64_t> value_{0};
+    std::atomic<bool> level_{false};
+  };
+
+  /**
+   * @brief Distribution of a non-negative quantity
+   *
+   * Values are counted in power-of-two buckets, bucket @f$ i @f$ holding
+   * values in @f$ [2^{i-1}, 2^i) @f$ and bucket 0 those below one, so
+   * percentiles are exact to a factor of two. Record times in units where
+   * the interesting values are above one, such as microseconds.
+   */
+  class Histogram {
+   public:
+    /** @brief Number of buckets */
+    static constexpr std::size_t BucketCount = 48;
+
+    /** @brief Record @p value, negative values count as zero */
+    void record(double value);
+
+    /** @brief Number of recorded values */
+    int64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    /** @brief Sum of the recorded values */
+    double sum() const;
+
+    /**
+     * @brief Upper bound of the bucket holding the @p fraction percentile
+     *
+     * Zero if nothing was recorded.
+     */
+    double percentile(double fraction) const;
+
+   private:
+    friend Metrics;
+    std::atomic<int64_t> count_{0};
+    // fixed point, in millionths of the unit, as atomic doubles can't add
+    std::atomic<int64_t> sum_{0};
+    std::array<std::atomic<int64_t>, BucketCount> buckets_{};
+  };
+
+  /**
+   * @brief Counter named @p name, created on first use
+   *
+   * The reference stays valid for the lifetime of the process.
+   */
+  static Counter& counter(const std::string& name);
+
+  /**
+   * @brief Histogram named @p name, created on first use
+   *
+   * The reference stays valid for the lifetime of the process.
+   */
+  static Histogram& histogram(const std::string& name);
+
+  /**
+   * @brief Values of all metrics
+   * @param reset   Reset the counters and histograms read, except counters
+   *      last changed with @ref Counter::set()
+   *
+   * Counters appear under their name. Histograms appear as
+   * @cpp "<name>.count" @ce, @cpp "<name>.sum" @ce, @cpp "<name>.p50" @ce,
+   * @cpp "<name>.p90" @ce and @cpp "<name>.p99" @ce, and only once something
+   * was recorded. Updates racing with the snapshot land in either this one
+   * or the next.
+   */
+  static std::map<std::string, double> snapshot(bool reset = false);
+
+  /** @brief Reset all counters and histograms to zero */
+  static void reset();
+
+ private:
+  Metrics() = delete;
+};
+
+}  // namespace core
+}  // namespace esp
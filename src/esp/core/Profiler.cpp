@@ -0,0 +1,228 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/core/logging.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace core {
+
+namespace {
+
+struct ScopeEvent {
+  const char* name;
+  double startTime;
+  double duration;
+};
+
+struct TrackEvent {
+  std::string track;
+  std::string name;
+  double startTime;
+  double duration;
+};
+
+// Events of one thread. The mutex is only ever contended by the export.
+struct ThreadBuffer {
+  std::mutex mutex;
+  std::vector<ScopeEvent> events;
+};
+
+struct State {
+  std::mutex mutex;
+  // buffers of threads that exited stay, their events are still exported
+  std::vector<std::shared_ptr<ThreadBuffer>> threads;
+  std::vector<TrackEvent> trackEvents;
+  std::atomic<std::size_t> droppedEventCount{0};
+};
+
+State& state() {
+  static State state;
+  return state;
+}
+
+ThreadBuffer& threadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto buffer = std::make_shared<ThreadBuffer>();
+    State& s = state();
+    std::lock_guard<std::mutex> lock{s.mutex};
+    s.threads.push_back(buffer);
+    return buffer;
+  }();
+  return *buffer;
+}
+
+void appendEscaped(std::string& out, const std::string& string) {
+  for (char c : string) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+}
+
+// A complete event, times relative to the start of the trace in
+// microseconds as the format wants them
+void appendEvent(std::string& out,
+                 const std::string& name,
+                 std::size_t tid,
+                 double startTime,
+                 double duration) {
+  char times[96];
+  std::snprintf(times, sizeof(times),
+                "\",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,\"ts\":%.3f,"
+                "\"dur\":%.3f},\n",
+                tid, startTime * 1000.0, duration * 1000.0);
+  out += "{\"name\":\"";
+  appendEscaped(out, name);
+  out += times;
+}
+
+void appendThreadName(std::string& out,
+                      const std::string& name,
+                      std::size_t tid) {
+  out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+  out += std::to_string(tid);
+  out += ",\"args\":{\"name\":\"";
+  appendEscaped(out, name);
+  out += "\"}},\n";
+}
+
+}  // namespace
+
+std::atomic<bool> Profiler::enabled_{false};
+
+void Profiler::setEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+double Profiler::now() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Profiler::record(const char* name, double startTime) {
+  const double duration = now() - startTime;
+  ThreadBuffer& buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock{buffer.mutex};
+  if (buffer.events.size() >= MaxEventsPerThread) {
+    state().droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events.push_back({name, startTime, duration});
+}
+
+void Profiler::addEvent(const std::string& track,
+                        const std::string& name,
+                        double startTime,
+                        double duration) {
+  if (!isEnabled()) {
+    return;
+  }
+  State& s = state();
+  std::lock_guard<std::mutex> lock{s.mutex};
+  if (s.trackEvents.size() >= MaxEventsPerThread) {
+    s.droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  s.trackEvents.push_back({track, name, startTime, duration});
+}
+
+void Profiler::clear() {
+  State& s = state();
+  std::lock_guard<std::mutex> lock{s.mutex};
+  for (const auto& thread : s.threads) {
+    std::lock_guard<std::mutex> threadLock{thread->mutex};
+    thread->events.clear();
+  }
+  s.trackEvents.clear();
+  s.droppedEventCount = 0;
+}
+
+std::size_t Profiler::droppedEventCount() {
+  return state().droppedEventCount.load(std::memory_order_relaxed);
+}
+
+std::string Profiler::chromeTrace() {
+  State& s = state();
+  std::lock_guard<std::mutex> lock{s.mutex};
+
+  // copies, so threads can go on recording while the JSON is built
+  std::vector<std::vector<ScopeEvent>> threadEvents;
+  for (const auto& thread : s.threads) {
+    std::lock_guard<std::mutex> threadLock{thread->mutex};
+    threadEvents.push_back(thread->events);
+  }
+
+  double origin = std::numeric_limits<double>::infinity();
+  for (const auto& events : threadEvents) {
+    for (const ScopeEvent& event : events) {
+      origin = std::min(origin, event.startTime);
+    }
+  }
+  for (const TrackEvent& event : s.trackEvents) {
+    origin = std::min(origin, event.startTime);
+  }
+
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  for (std::size_t i = 0; i != threadEvents.size(); ++i) {
+    if (threadEvents[i].empty()) {
+      continue;
+    }
+    appendThreadName(out, "thread " + std::to_string(i), i);
+    for (const ScopeEvent& event : threadEvents[i]) {
+      appendEvent(out, event.name, i, event.startTime - origin,
+                  event.duration);
+    }
+  }
+  // named tracks come after all threads
+  std::vector<std::string> tracks;
+  for (const TrackEvent& event : s.trackEvents) {
+    auto found = std::find(tracks.begin(), tracks.end(), event.track);
+    const std::size_t tid = threadEvents.size() + (found - tracks.begin());
+    if (found == tracks.end()) {
+      tracks.push_back(event.track);
+      appendThreadName(out, event.track, tid);
+    }
+    appendEvent(out, event.name, tid, event.startTime - origin,
+                event.duration);
+  }
+  // the format allows no trailing comma
+  if (out.back() == '\n' && out[out.size() - 2] == ',') {
+    out.erase(out.size() - 2, 1);
+  }
+  out += "]}\n";
+  return out;
+}
+
+bool Profiler::writeChromeTrace(const std::string& filename) {
+  if (!Cr::Utility::Directory::writeString(filename, chromeTrace())) {
+    LOG(ERROR) << "Profiler::writeChromeTrace(): cannot write " << filename;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,148 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::core::Profiler, @ref esp::core::ProfileScope, macro
+ * @ref ESP_PROFILE_SCOPE()
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace esp {
+namespace core {
+
+/**
+@brief Process-wide recorder of timed scopes, exported as a Chrome trace
+
+Scopes are marked with @ref ESP_PROFILE_SCOPE(). While the profiler is
+disabled, the default, a scope costs a relaxed atomic load and a branch.
+Enabled, every thread appends the scopes it finished to a buffer of its own,
+so threads don't contend with each other; only @ref chromeTrace() and
+@ref clear() lock the buffers of all threads. Every thread keeps at most
+@ref MaxEventsPerThread events, later ones are counted in
+@ref droppedEventCount() instead.
+
+The trace is the JSON Trace Event Format read by @cb{.sh} chrome://tracing @ce
+and Perfetto, with a track per thread showing how the scopes nest. Events
+recorded with @ref addEvent() on other tracks, such as the GPU times of
+@ref esp::gfx::RenderProfiler, appear next to them.
+*/
+class Profiler {
+ public:
+  /** @brief Number of events kept per thread at most */
+  static constexpr std::size_t MaxEventsPerThread = 1 << 20;
+
+  /** @brief Whether scopes are recorded */
+  static bool isEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Enable or disable recording
+   *
+   * Events recorded so far are kept, see @ref clear(). Scopes already entered
+   * when enabling aren't recorded.
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * @brief Current time in milliseconds
+   *
+   * The clock of @ref esp::assets::SceneLoadStatistics::now().
+   */
+  static double now();
+
+  /**
+   * @brief Record a scope of the calling thread
+   * @param name      Name of the scope, has to stay alive until the events
+   *      are cleared, usually a string literal
+   * @param startTime Start of the scope, see @ref now()
+   *
+   * The scope ends now. Called by @ref ProfileScope.
+   */
+  static void record(const char* name, double startTime);
+
+  /**
+   * @brief Record an event on a named track
+   * @param track     Track of the event, e.g. @cpp "GPU" @ce
+   * @param name      Name of the event, copied
+   * @param startTime Start of the event, see @ref now()
+   * @param duration  Duration in milliseconds
+   *
+   * For times measured elsewhere than in a scope of the calling thread. Does
+   * nothing if the profiler is disabled.
+   */
+  static void addEvent(const std::string& track,
+                       const std::string& name,
+                       double startTime,
+                       double duration);
+
+  /** @brief Drop all recorded events */
+  static void clear();
+
+  /** @brief Events dropped because a thread had too many */
+  static std::size_t droppedEventCount();
+
+  /** @brief Recorded events in the Chrome Trace Event Format */
+  static std::string chromeTrace();
+
+  /**
+   * @brief Write @ref chromeTrace() to @p filename
+   * @return Whether the file was written
+   */
+  static bool writeChromeTrace(const std::string& filename);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+/**
+@brief Records the time until it goes out of scope, see @ref ESP_PROFILE_SCOPE()
+*/
+class ProfileScope {
+ public:
+  /**
+   * @brief Constructor
+   * @param name  Name of the scope, has to stay alive until the events are
+   *      cleared, usually a string literal
+   */
+  explicit ProfileScope(const char* name)
+      : name_{name},
+        startTime_{Profiler::isEnabled() ? Profiler::now() : -1.0} {}
+
+  ~ProfileScope() {
+    if (startTime_ >= 0.0) {
+      Profiler::record(name_, startTime_);
+    }
+  }
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  const char* name_;
+  double startTime_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#define ESP_PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define ESP_PROFILE_SCOPE_CONCAT(a, b) ESP_PROFILE_SCOPE_CONCAT_(a, b)
+
+/**
+@brief Profile the rest of the enclosing scope as @p name
+
+A string literal, shown in the trace of @ref esp::core::Profiler. Names of
+functions are like @cpp "Simulator::step" @ce.
+*/
+#define ESP_PROFILE_SCOPE(name)                       \
+  ::esp::core::ProfileScope ESP_PROFILE_SCOPE_CONCAT( \
+      espProfileScope, __LINE__) {                    \
+    name                                              \
+  }
@@ -0,0 +1,254 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Corrade/Utility/Assert.h>
+
+#include "esp/core/logging.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace core {
+
+namespace {
+
+constexpr uint32_t Magic = 0x52534d48;  // "HMSR"
+constexpr uint32_t Version = 1;
+constexpr std::size_t Alignment = 64;
+
+std::size_t alignUp(std::size_t size) {
+  return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+}  // namespace
+
+// Both counters only ever grow, slot i of the ring holds the sequences
+// i + 1, i + 1 + slotCount, ... The writer owns `written`, the reader owns
+// `read`, each stores its own with release and loads the other's with
+// acquire, so the slot contents are ordered by these two alone.
+struct SharedMemoryRing::Header {
+  // stored last with release and loaded first with acquire, which orders
+  // the rest of the header
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint64_t slotCount;
+  uint64_t slotByteSize;
+  uint64_t slotStride;
+  alignas(Alignment) std::atomic<uint64_t> written;
+  alignas(Alignment) std::atomic<uint64_t> read;
+};
+
+struct SharedMemoryRing::Slot {
+  std::atomic<uint64_t> sequence;
+  uint64_t byteSize;
+  uint64_t layoutSize;
+  char layout[LayoutCapacity];
+
+  uint8_t* data() {
+    return reinterpret_cast<uint8_t*>(this) + alignUp(sizeof(Slot));
+  }
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "SharedMemoryRing needs lock-free 32- and 64-bit atomics to "
+              "work across processes");
+
+SharedMemoryRing::ptr SharedMemoryRing::create(const std::string& name,
+                                               std::size_t slotCount,
+                                               std::size_t slotByteSize) {
+  CORRADE_ASSERT(slotCount > 0,
+                 "SharedMemoryRing::create(): expected at least one slot",
+                 nullptr);
+  const std::size_t slotStride = alignUp(sizeof(Slot)) + alignUp(slotByteSize);
+  const std::size_t size = alignUp(sizeof(Header)) + slotCount * slotStride;
+
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    LOG(ERROR) << "SharedMemoryRing::create(): cannot create " << name << ": "
+               << std::strerror(errno);
+    return nullptr;
+  }
+  void* memory = MAP_FAILED;
+  if (ftruncate(fd, size) == 0) {
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  const int error = errno;
+  close(fd);
+  if (memory == MAP_FAILED) {
+    LOG(ERROR) << "SharedMemoryRing::create(): cannot map " << size
+               << " bytes of " << name << ": " << std::strerror(error);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+
+  // the pages come zeroed, so all slot sequences start at zero already
+  Header* header = new (memory) Header;
+  header->slotCount = slotCount;
+  header->slotByteSize = slotByteSize;
+  header->slotStride = slotStride;
+  header->written.store(0, std::memory_order_relaxed);
+  header->read.store(0, std::memory_order_relaxed);
+  header->version = Version;
+  // last, so a racing open() doesn't see a half-initialized header
+  header->magic.store(Magic, std::memory_order_release);
+
+  return ptr(new SharedMemoryRing{name, true, memory, size});
+}
+
+SharedMemoryRing::ptr SharedMemoryRing::open(const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    LOG(ERROR) << "SharedMemoryRing::open(): cannot open " << name << ": "
+               << std::strerror(errno);
+    return nullptr;
+  }
+  struct stat status;
+  void* memory = MAP_FAILED;
+  std::size_t size = 0;
+  if (fstat(fd, &status) == 0 &&
+      std::size_t(status.st_size) >= alignUp(sizeof(Header))) {
+    size = status.st_size;
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (memory == MAP_FAILED) {
+    LOG(ERROR) << "SharedMemoryRing::open(): cannot map " << name;
+    return nullptr;
+  }
+
+  const Header* header = static_cast<const Header*>(memory);
+  // the slot layout comes from the peer, so it has to fit the mapping
+  const std::size_t slotsSize = size - alignUp(sizeof(Header));
+  if (header->magic.load(std::memory_order_acquire) != Magic ||
+      header->version != Version || header->slotCount == 0 ||
+      header->slotByteSize > header->slotStride ||
+      header->slotStride - header->slotByteSize < alignUp(sizeof(Slot)) ||
+      header->slotCount > slotsSize / header->slotStride) {
+    LOG(ERROR) << "SharedMemoryRing::open(): " << name
+               << " is not a ring of this version";
+    munmap(memory, size);
+    return nullptr;
+  }
+  return ptr(new SharedMemoryRing{name, false, memory, size});
+}
+
+SharedMemoryRing::SharedMemoryRing(std::string name,
+                                   bool owner,
+                                   void* memory,
+                                   std::size_t mappedSize)
+    : name_{std::move(name)},
+      owner_{owner},
+      memory_{memory},
+      mappedSize_{mappedSize},
+      header_{static_cast<Header*>(memory)} {}
+
+SharedMemoryRing::~SharedMemoryRing() {
+  munmap(memory_, mappedSize_);
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+std::size_t SharedMemoryRing::slotCount() const {
+  return header_->slotCount;
+}
+
+std::size_t SharedMemoryRing::slotByteSize() const {
+  return header_->slotByteSize;
+}
+
+std::size_t SharedMemoryRing::pendingCount() const {
+  return header_->written.load(std::memory_order_acquire) -
+         header_->read.load(std::memory_order_acquire);
+}
+
+SharedMemoryRing::Slot& SharedMemoryRing::slot(uint64_t index) const {
+  return *reinterpret_cast<Slot*>(
+      static_cast<uint8_t*>(memory_) + alignUp(sizeof(Header)) +
+      (index % header_->slotCount) * header_->slotStride);
+}
+
+Cr::Containers::ArrayView<uint8_t> SharedMemoryRing::beginWrite() {
+  const uint64_t written = header_->written.load(std::memory_order_relaxed);
+  if (written - header_->read.load(std::memory_order_acquire) >=
+      header_->slotCount) {
+    return nullptr;
+  }
+  return {slot(written).data(), std::size_t(header_->slotByteSize)};
+}
+
+uint64_t SharedMemoryRing::endWrite(std::size_t byteSize,
+                                    const std::string& layout) {
+  CORRADE_ASSERT(byteSize <= header_->slotByteSize,
+                 "SharedMemoryRing::endWrite(): wrote" << byteSize
+                     << "bytes to a slot of" << header_->slotByteSize,
+                 0);
+  CORRADE_ASSERT(layout.size() <= LayoutCapacity,
+                 "SharedMemoryRing::endWrite(): layout of" << layout.size()
+                     << "bytes exceeds" << LayoutCapacity,
+                 0);
+  const uint64_t written = header_->written.load(std::memory_order_relaxed);
+  CORRADE_ASSERT(written - header_->read.load(std::memory_order_acquire) <
+                     header_->slotCount,
+                 "SharedMemoryRing::endWrite(): the ring is full", 0);
+  Slot& s = slot(written);
+  s.byteSize = byteSize;
+  s.layoutSize = layout.size();
+  std::memcpy(s.layout, layout.data(), layout.size());
+  s.sequence.store(written + 1, std::memory_order_relaxed);
+  header_->written.store(written + 1, std::memory_order_release);
+  return written + 1;
+}
+
+Cr::Containers::ArrayView<const uint8_t> SharedMemoryRing::beginRead() {
+  const uint64_t read = header_->read.load(std::memory_order_relaxed);
+  if (read == header_->written.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  // sizes in the slot are written by the peer, keep them in the slot
+  Slot& s = slot(read);
+  return {s.data(),
+          std::size_t(std::min(s.byteSize, header_->slotByteSize))};
+}
+
+uint64_t SharedMemoryRing::readSequence() const {
+  const uint64_t read = header_->read.load(std::memory_order_relaxed);
+  if (read == header_->written.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  return slot(read).sequence.load(std::memory_order_relaxed);
+}
+
+std::string SharedMemoryRing::readLayout() const {
+  const uint64_t read = header_->read.load(std::memory_order_relaxed);
+  if (read == header_->written.load(std::memory_order_acquire)) {
+    return {};
+  }
+  const Slot& s = slot(read);
+  return {s.layout,
+          std::size_t(std::min(s.layoutSize, uint64_t(LayoutCapacity)))};
+}
+
+void SharedMemoryRing::endRead() {
+  const uint64_t read = header_->read.load(std::memory_order_relaxed);
+  CORRADE_ASSERT(read != header_->written.load(std::memory_order_acquire),
+                 "SharedMemoryRing::endRead(): no slot to release", );
+  header_->read.store(read + 1, std::memory_order_release);
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,138 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::core::SharedMemoryRing
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <Corrade/Containers/ArrayView.h>
+
+namespace esp {
+namespace core {
+
+/**
+@brief Ring of fixed-size slots in POSIX shared memory, for handing frames
+from one process to another without serialization or copies
+
+One process creates the ring with @ref create(), under a name like
+@cpp "/habitat-env-3" @ce, and writes slots; another one maps it with
+@ref open() and reads them in the order they were written. Exactly one
+writer and one reader: the handoff is lock-free, through a count of slots
+written and a count of slots read in the shared header, and every slot
+carries the sequence number it was written with. The writer doesn't
+overwrite a slot until the reader released it, so the reader can use the
+slot memory in place between @ref beginRead() and @ref endRead().
+
+Every slot also carries a short layout string, e.g. a JSON description of
+the data, so a reader can interpret every slot without knowing how the
+writer is configured; see @ref sim::Simulator::writeObservations().
+*/
+class SharedMemoryRing {
+ public:
+  typedef std::shared_ptr<SharedMemoryRing> ptr;
+
+  /** @brief Bytes of the layout string a slot holds at most */
+  static constexpr std::size_t LayoutCapacity = 4096;
+
+  /**
+   * @brief Create a ring
+   * @param name          Name of the shared memory object, starting with a
+   *      slash
+   * @param slotCount     Number of slots, at least one
+   * @param slotByteSize  Capacity of a slot in bytes
+   * @return The ring, nullptr if the shared memory can't be created, e.g.
+   *      because the name is taken
+   *
+   * The name is removed again once the returned ring is destroyed. Rings
+   * opened by then stay mapped.
+   */
+  static ptr create(const std::string& name,
+                    std::size_t slotCount,
+                    std::size_t slotByteSize);
+
+  /**
+   * @brief Map a ring created by another process
+   * @return The ring, nullptr if the name doesn't exist or isn't a ring
+   */
+  static ptr open(const std::string& name);
+
+  ~SharedMemoryRing();
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+  /** @brief Name of the shared memory object */
+  const std::string& name() const { return name_; }
+
+  /** @brief Whether this process created the ring */
+  bool isOwner() const { return owner_; }
+
+  /** @brief Number of slots */
+  std::size_t slotCount() const;
+
+  /** @brief Capacity of a slot in bytes */
+  std::size_t slotByteSize() const;
+
+  /** @brief Number of slots written and not yet released by the reader */
+  std::size_t pendingCount() const;
+
+  /**
+   * @brief Memory of the next slot to write
+   * @return The whole slot, empty if all slots wait for the reader
+   *
+   * Call @ref endWrite() to hand the slot to the reader.
+   */
+  Corrade::Containers::ArrayView<uint8_t> beginWrite();
+
+  /**
+   * @brief Hand the slot from @ref beginWrite() to the reader
+   * @param byteSize  Bytes of the slot written
+   * @param layout    Layout of the data, at most @ref LayoutCapacity bytes
+   * @return Sequence number of the slot, counting from one
+   */
+  uint64_t endWrite(std::size_t byteSize, const std::string& layout = {});
+
+  /**
+   * @brief Memory of the oldest slot not read yet
+   * @return The bytes written to the slot, empty if there's none
+   *
+   * The memory stays valid until @ref endRead().
+   */
+  Corrade::Containers::ArrayView<const uint8_t> beginRead();
+
+  /** @brief Sequence number of the slot from @ref beginRead() */
+  uint64_t readSequence() const;
+
+  /** @brief Layout of the slot from @ref beginRead() */
+  std::string readLayout() const;
+
+  /** @brief Release the slot from @ref beginRead() to the writer */
+  void endRead();
+
+ private:
+  struct Header;
+  struct Slot;
+
+  SharedMemoryRing(std::string name,
+                   bool owner,
+                   void* memory,
+                   std::size_t mappedSize);
+
+  Slot& slot(uint64_t index) const;
+
+  std::string name_;
+  bool owner_;
+  void* memory_;
+  std::size_t mappedSize_;
+  Header* header_;
+};
+
+}  // namespace core
+}  // namespace esp
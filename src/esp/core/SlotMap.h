@@ -0,0 +1,171 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "esp/core/logging.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Map from small non-negative integer IDs to values, stored densely
+ *
+ * The values live contiguously in a vector of (ID, value) pairs sorted by ID,
+ * so iterating them is a linear walk through memory in the same order as an
+ * @cpp std::map @ce. Each ID indexes a slot holding the position of its value
+ * in that vector, which makes lookups constant time. Insertion and removal
+ * shift the values after the affected position, linear in the number of
+ * values, which suits containers looked up and iterated far more often than
+ * they change.
+ *
+ * Each slot counts the values removed from it in its @ref generation(), so
+ * that an (ID, generation) pair identifies a value even when its ID gets
+ * reused, see @ref contains(int, std::uint32_t) const.
+ *
+ * The IDs of the pairs must not be modified through the iterators.
+ */
+template <class T>
+class SlotMap {
+ public:
+  typedef std::pair<int, T> value_type;
+  typedef typename std::vector<value_type>::iterator iterator;
+  typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+  /** @brief Number of values */
+  std::size_t size() const { return values_.size(); }
+
+  /** @brief Whether there are no values */
+  bool empty() const { return values_.empty(); }
+
+  /** @brief Number of values with given ID, 0 or 1 */
+  std::size_t count(int id) const { return contains(id) ? 1 : 0; }
+
+  /** @brief Whether there is a value with given ID */
+  bool contains(int id) const {
+    return id >= 0 && std::size_t(id) < slots_.size() &&
+           slots_[id].index != NoIndex;
+  }
+
+  /**
+   * @brief Whether there is a value with given ID that was inserted while the
+   * slot had given generation
+   */
+  bool contains(int id, std::uint32_t generation) const {
+    return contains(id) && slots_[id].generation == generation;
+  }
+
+  /**
+   * @brief Generation of the slot of given ID
+   *
+   * Starts at 0 and is incremented every time a value with this ID is erased.
+   */
+  std::uint32_t generation(int id) const {
+    return id >= 0 && std::size_t(id) < slots_.size() ? slots_[id].generation
+                                                      : 0;
+  }
+
+  /** @brief Value of given ID, which has to exist */
+  T& at(int id) {
+    CHECK(contains(id));
+    return values_[slots_[id].index].second;
+  }
+
+  /** @overload */
+  const T& at(int id) const {
+    CHECK(contains(id));
+    return values_[slots_[id].index].second;
+  }
+
+  /** @brief Value of given ID, or @ref end() if there's none */
+  iterator find(int id) {
+    return contains(id) ? values_.begin() + slots_[id].index : values_.end();
+  }
+
+  /** @overload */
+  const_iterator find(int id) const {
+    return contains(id) ? values_.begin() + slots_[id].index : values_.end();
+  }
+
+  /**
+   * @brief Insert a value under given non-negative ID
+   * @return The value and whether it got inserted, false if the ID already
+   * had one
+   */
+  std::pair<iterator, bool> emplace(int id, T value) {
+    CHECK_GE(id, 0);
+    if (contains(id)) {
+      return {values_.begin() + slots_[id].index, false};
+    }
+    if (std::size_t(id) >= slots_.size()) {
+      slots_.resize(id + 1);
+    }
+    // IDs are mostly handed out in increasing order, so this is usually an
+    // append
+    std::size_t index = values_.size();
+    while (index > 0 && values_[index - 1].first > id) {
+      --index;
+    }
+    values_.emplace(values_.begin() + index, id, std::move(value));
+    reindex(index);
+    return {values_.begin() + index, true};
+  }
+
+  /** @brief Remove the value of given ID, returns how many got removed */
+  std::size_t erase(int id) {
+    if (!contains(id)) {
+      return 0;
+    }
+    const std::size_t index = slots_[id].index;
+    slots_[id].index = NoIndex;
+    ++slots_[id].generation;
+    values_.erase(values_.begin() + index);
+    reindex(index);
+    return 1;
+  }
+
+  /**
+   * @brief Remove all values
+   *
+   * Generations of the slots with a value are incremented like in
+   * @ref erase().
+   */
+  void clear() {
+    for (const value_type& value : values_) {
+      slots_[value.first].index = NoIndex;
+      ++slots_[value.first].generation;
+    }
+    values_.clear();
+  }
+
+  iterator begin() { return values_.begin(); }
+  const_iterator begin() const { return values_.begin(); }
+  iterator end() { return values_.end(); }
+  const_iterator end() const { return values_.end(); }
+
+ private:
+  static constexpr std::size_t NoIndex = ~std::size_t{};
+
+  struct Slot {
+    std::size_t index = NoIndex;
+    std::uint32_t generation = 0;
+  };
+
+  // points the slots of the values from index on to their new position
+  void reindex(std::size_t index) {
+    for (; index != values_.size(); ++index) {
+      slots_[values_[index].first].index = index;
+    }
+  }
+
+  std::vector<value_type> values_;
+  std::vector<Slot> slots_;
+};
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,448 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <string>
+
+#include "esp/core/Topology.h"
+#include "esp/core/logging.h"
+
+namespace esp {
+namespace core {
+
+struct TaskScheduler::Task {
+  std::function<void()> function;
+  TaskGroup* group;
+};
+
+// Chase-Lev deque, in the formulation of Le, Pop, Cohen and Zappa Nardelli,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+// Only the owning worker pushes to and pops from the bottom, anyone steals
+// from the top. Arrays outgrown are kept until the deque is destroyed since
+// a thief may still be reading from them.
+class TaskScheduler::Deque {
+ public:
+  Deque() { array_.store(grow(nullptr, 0, 0), std::memory_order_relaxed); }
+
+  void push(Task* task) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const int64_t top = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (bottom - top > int64_t(array->mask)) {
+      array = grow(array, top, bottom);
+      array_.store(array, std::memory_order_release);
+    }
+    array->at(bottom).store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  Task* pop() {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      // empty
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Task* task = array->at(bottom).load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // the last one, race the thieves for it
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  Task* steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    Array* array = array_.load(std::memory_order_acquire);
+    Task* task = array->at(top).load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      // lost to the owner or another thief
+      return nullptr;
+    }
+    return task;
+  }
+
+ private:
+  struct Array {
+    explicit Array(size_t capacity)
+        : mask{capacity - 1}, slots{new std::atomic<Task*>[capacity]} {}
+
+    std::atomic<Task*>& at(int64_t index) { return slots[index & mask]; }
+
+    const size_t mask;
+    std::unique_ptr<std::atomic<Task*>[]> slots;
+  };
+
+  // only called by the owner
+  Array* grow(Array* array, int64_t top, int64_t bottom) {
+    arrays_.emplace_back(new Array{array ? 2 * (array->mask + 1) : 64});
+    Array* grown = arrays_.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+      grown->at(i).store(array->at(i).load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+    }
+    return grown;
+  }
+
+  std::atomic<int64_t> top_{0};
+  std::atomic<int64_t> bottom_{0};
+  std::atomic<Array*> array_{nullptr};
+  std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+struct TaskScheduler::Worker {
+  // one per priority
+  Deque deques[3];
+  // other workers to steal from, those of the same NUMA node first
+  std::vector<size_t> victims;
+  size_t sameNodeVictims = 0;
+  // CPUs the worker pins itself to, empty for none
+  std::vector<int> cpus;
+  std::minstd_rand random;
+  std::thread thread;
+};
+
+namespace {
+
+constexpr size_t PriorityCount = 3;
+
+// tries to find work before a worker goes to sleep
+constexpr int SpinCount = 64;
+
+thread_local const TaskScheduler* currentScheduler = nullptr;
+thread_local int currentIndex = -1;
+
+std::mutex globalMutex;
+TaskSchedulerConfiguration globalConfiguration;
+std::unique_ptr<TaskScheduler> globalScheduler;
+
+}  // namespace
+
+TaskGroup::~TaskGroup() {
+  wait();
+}
+
+void TaskGroup::wait() {
+  while (pending_.load() != 0) {
+    TaskScheduler::Task* task =
+        scheduler_->take(scheduler_->currentWorker());
+    if (task) {
+      scheduler_->execute(task);
+      continue;
+    }
+    // nothing to help with, the remaining tasks run elsewhere
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait_for(lock, std::chrono::milliseconds(1),
+                   [this]() { return pending_.load() == 0; });
+  }
+  // the last finished() may still be notifying, don't let the group be
+  // destroyed under it
+  std::lock_guard<std::mutex> lock{mutex_};
+}
+
+void TaskGroup::finished() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (pending_.fetch_sub(1) == 1) {
+    done_.notify_all();
+  }
+}
+
+TaskScheduler& TaskScheduler::global() {
+  std::lock_guard<std::mutex> lock{globalMutex};
+  if (!globalScheduler) {
+    TaskSchedulerConfiguration configuration = globalConfiguration;
+    if (const char* threads = std::getenv("HABITAT_SIM_TASK_THREADS")) {
+      configuration.threadCount = std::strtoul(threads, nullptr, 10);
+    }
+    globalScheduler = std::make_unique<TaskScheduler>(configuration);
+  }
+  return *globalScheduler;
+}
+
+bool TaskScheduler::setGlobalConfiguration(
+    const TaskSchedulerConfiguration& configuration) {
+  std::lock_guard<std::mutex> lock{globalMutex};
+  if (globalScheduler) {
+    return false;
+  }
+  globalConfiguration = configuration;
+  return true;
+}
+
+TaskScheduler::TaskScheduler(const TaskSchedulerConfiguration& configuration)
+    : configuration_{configuration}, injected_(PriorityCount) {
+  size_t threadCount = configuration_.threadCount;
+  if (threadCount == 0) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::vector<std::vector<int>> nodes;
+  if (configuration_.numaAware) {
+    nodes = numaNodeCpus();
+    if (nodes.size() < 2) {
+      nodes.clear();
+    }
+  }
+
+  // the NUMA node and CPUs of every worker, workers spread over the nodes
+  // round-robin unless pinned explicitly
+  std::vector<int> workerNodes(threadCount, 0);
+  workers_.reserve(threadCount);
+  for (size_t i = 0; i != threadCount; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i != threadCount; ++i) {
+    if (!configuration_.cpuAffinity.empty()) {
+      const int cpu =
+          configuration_.cpuAffinity[i % configuration_.cpuAffinity.size()];
+      workers_[i]->cpus = {cpu};
+      for (size_t node = 0; node != nodes.size(); ++node) {
+        if (std::find(nodes[node].begin(), nodes[node].end(), cpu) !=
+            nodes[node].end()) {
+          workerNodes[i] = int(node);
+        }
+      }
+    } else if (!nodes.empty()) {
+      workerNodes[i] = int(i % nodes.size());
+      workers_[i]->cpus = nodes[workerNodes[i]];
+    }
+  }
+
+  for (size_t i = 0; i != threadCount; ++i) {
+    Worker& worker = *workers_[i];
+    worker.random.seed(uint32_t(i + 1));
+    for (size_t j = 0; j != threadCount; ++j) {
+      if (j != i && workerNodes[j] == workerNodes[i]) {
+        worker.victims.push_back(j);
+      }
+    }
+    worker.sameNodeVictims = worker.victims.size();
+    for (size_t j = 0; j != threadCount; ++j) {
+      if (workerNodes[j] != workerNodes[i]) {
+        worker.victims.push_back(j);
+      }
+    }
+  }
+
+  // started only once all deques exist, as workers steal from each other
+  for (size_t i = 0; i != threadCount; ++i) {
+    workers_[i]->thread = std::thread{[this, i]() { run(i); }};
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock{sleepMutex_};
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+int TaskScheduler::currentWorker() const {
+  return currentScheduler == this ? currentIndex : -1;
+}
+
+void TaskScheduler::submit(std::function<void()> task,
+                           TaskPriority priority,
+                           TaskGroup* group) {
+  if (group) {
+    group->scheduler_ = this;
+    group->pending_.fetch_add(1);
+  }
+  unfinishedTasks_.fetch_add(1);
+  // counted before it's visible, so a thief never sees it negative
+  queuedTasks_.fetch_add(1);
+
+  Task* queued = new Task{std::move(task), group};
+  const size_t p = size_t(priority);
+  const int index = currentWorker();
+  if (index >= 0) {
+    workers_[index]->deques[p].push(queued);
+  } else {
+    std::lock_guard<std::mutex> lock{injectedMutex_};
+    injected_[p].push_back(queued);
+    injectedCount_.fetch_add(1);
+  }
+
+  // pairs with the increment of sleepingWorkers_ under sleepMutex_ before a
+  // worker checks queuedTasks_ one last time, either the worker sees the
+  // task or this sees the worker
+  if (sleepingWorkers_.load() != 0) {
+    std::lock_guard<std::mutex> lock{sleepMutex_};
+    wake_.notify_one();
+  }
+}
+
+TaskScheduler::Task* TaskScheduler::take(int index) {
+  Worker* worker = index >= 0 ? workers_[index].get() : nullptr;
+  for (size_t p = 0; p != PriorityCount; ++p) {
+    Task* task = nullptr;
+    if (worker) {
+      task = worker->deques[p].pop();
+    }
+    if (!task && injectedCount_.load() != 0) {
+      std::lock_guard<std::mutex> lock{injectedMutex_};
+      if (!injected_[p].empty()) {
+        task = injected_[p].front();
+        injected_[p].pop_front();
+        injectedCount_.fetch_sub(1);
+      }
+    }
+    if (!task && worker) {
+      // same node first, each group from a random start so the thieves
+      // don't all hammer the same victim
+      const size_t groups[][2]{
+          {0, worker->sameNodeVictims},
+          {worker->sameNodeVictims, worker->victims.size()}};
+      for (size_t g = 0; g != 2 && !task; ++g) {
+        const size_t count = groups[g][1] - groups[g][0];
+        if (!count) {
+          continue;
+        }
+        const size_t start = worker->random() % count;
+        for (size_t i = 0; i != count && !task; ++i) {
+          const size_t victim =
+              worker->victims[groups[g][0] + (start + i) % count];
+          task = workers_[victim]->deques[p].steal();
+        }
+      }
+    } else if (!task) {
+      for (size_t victim = 0; victim != workers_.size() && !task; ++victim) {
+        task = workers_[victim]->deques[p].steal();
+      }
+    }
+    if (task) {
+      queuedTasks_.fetch_sub(1);
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void TaskScheduler::execute(Task* task) {
+  std::unique_ptr<Task> owned{task};
+  try {
+    owned->function();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "TaskScheduler: a task threw " << e.what();
+  } catch (...) {
+    LOG(ERROR) << "TaskScheduler: a task threw";
+  }
+  TaskGroup* group = owned->group;
+  // the function may hold the last reference to what the group waits for
+  owned.reset();
+  if (group) {
+    group->finished();
+  }
+  if (unfinishedTasks_.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock{sleepMutex_};
+    idle_.notify_all();
+  }
+}
+
+void TaskScheduler::run(size_t index) {
+  currentScheduler = this;
+  currentIndex = int(index);
+  const std::vector<int>& cpus = workers_[index]->cpus;
+  if (!cpus.empty() && !pinCurrentThread(cpus)) {
+    LOG(WARNING) << "TaskScheduler: can't pin worker " << index
+                 << " to its CPUs";
+  }
+  int spins = 0;
+  while (true) {
+    if (Task* task = take(int(index))) {
+      execute(task);
+      spins = 0;
+      continue;
+    }
+    if (++spins < SpinCount) {
+      std::this_thread::yield();
+      continue;
+    }
+    spins = 0;
+
+    std::unique_lock<std::mutex> lock{sleepMutex_};
+    sleepingWorkers_.fetch_add(1);
+    wake_.wait(lock, [this]() {
+      return queuedTasks_.load() != 0 || stopping_.load();
+    });
+    sleepingWorkers_.fetch_sub(1);
+    // everything queued runs before the workers stop
+    if (stopping_.load() && queuedTasks_.load() == 0) {
+      break;
+    }
+  }
+}
+
+void TaskScheduler::parallelFor(
+    size_t begin,
+    size_t end,
+    const std::function<void(size_t, size_t)>& body,
+    size_t grain) {
+  if (end <= begin) {
+    return;
+  }
+  const size_t count = end - begin;
+  if (grain == 0) {
+    grain = std::max<size_t>(1, count / (4 * threadCount()));
+  }
+  const size_t chunks = (count + grain - 1) / grain;
+  if (chunks == 1) {
+    body(begin, end);
+    return;
+  }
+
+  // chunks are claimed one by one, by the caller and by as many helper
+  // tasks as there are workers, so a slow chunk doesn't hold up the others
+  std::atomic<size_t> next{0};
+  auto work = [&]() {
+    for (size_t chunk; (chunk = next.fetch_add(1)) < chunks;) {
+      const size_t chunkBegin = begin + chunk * grain;
+      body(chunkBegin, std::min(chunkBegin + grain, end));
+    }
+  };
+  // declared last so it waits for the helpers before the above is gone
+  TaskGroup group;
+  const size_t helpers = std::min(chunks - 1, threadCount());
+  for (size_t i = 0; i != helpers; ++i) {
+    // high as the caller is blocked on them
+    submit(work, TaskPriority::High, &group);
+  }
+  work();
+  group.wait();
+}
+
+void TaskScheduler::waitIdle() {
+  std::unique_lock<std::mutex> lock{sleepMutex_};
+  idle_.wait(lock, [this]() { return unfinishedTasks_.load() == 0; });
+}
+
+}  // namespace core
+}  // namespace esp
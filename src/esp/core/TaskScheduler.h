@@ -0,0 +1,232 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::core::TaskScheduler, @ref esp::core::TaskGroup
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/** @brief Order in which queued tasks are picked, high first */
+enum class TaskPriority { High = 0, Normal = 1, Low = 2 };
+
+/** @brief Configuration of a @ref TaskScheduler */
+struct TaskSchedulerConfiguration {
+  /** @brief Worker threads, 0 for one per hardware thread */
+  size_t threadCount = 0;
+
+  /**
+   * @brief CPU each worker is pinned to, worker @cpp i @ce to
+   *    @cpp cpuAffinity[i % cpuAffinity.size()] @ce
+   *
+   * Empty to leave the workers unpinned, or to pin them to their NUMA node
+   * with @ref numaAware. Only honored on Linux.
+   */
+  std::vector<int> cpuAffinity;
+
+  /**
+   * @brief Spread the workers over the NUMA nodes, pin each to the CPUs of
+   *    its node and steal from workers of the same node first
+   *
+   * The nodes are read from `/sys/devices/system/node`, on systems without
+   * it or with a single node this does nothing.
+   */
+  bool numaAware = false;
+};
+
+class TaskScheduler;
+
+/**
+@brief Tasks to wait for together
+
+Counts the tasks submitted with it that didn't finish yet. A group has to
+outlive its tasks, which @ref wait() ensures.
+*/
+class TaskGroup {
+ public:
+  TaskGroup() = default;
+
+  /** @brief Waits for the tasks */
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /** @brief Tasks submitted with the group that didn't finish */
+  size_t pendingTasks() const { return pending_.load(); }
+
+  /**
+   * @brief Wait until all tasks of the group finished
+   *
+   * The calling thread runs queued tasks in the meantime, of this group or
+   * any other, so waiting from inside a task doesn't starve the workers.
+   */
+  void wait();
+
+ private:
+  friend TaskScheduler;
+
+  void finished();
+
+  std::atomic<size_t> pending_{0};
+  TaskScheduler* scheduler_ = nullptr;
+  std::mutex mutex_;
+  std::condition_variable done_;
+};
+
+/**
+@brief Work-stealing scheduler of short tasks over a pool of worker threads
+
+Every worker has a deque per @ref TaskPriority. Tasks submitted from a
+worker go to the back of its own deques without locks, the worker takes
+them from the back again, newest first, and idle workers steal from the
+front of the others, oldest first, also without locks. Tasks submitted from
+other threads go to a shared queue that workers check before stealing.
+Idle workers spin briefly and then sleep until something is submitted.
+
+Meant to be the one pool of a process, see @ref global(), so that
+subsystems running work in the background or in parallel don't each spawn
+a thread per core and oversubscribe the machine when several simulators
+share a process.
+*/
+class TaskScheduler {
+ public:
+  typedef std::shared_ptr<TaskScheduler> ptr;
+
+  /**
+   * @brief The process-wide scheduler
+   *
+   * Created on first use with the configuration of
+   * @ref setGlobalConfiguration(), or with one worker per hardware thread
+   * if there is none. The thread count can be overridden with the
+   * `HABITAT_SIM_TASK_THREADS` environment variable.
+   */
+  static TaskScheduler& global();
+
+  /**
+   * @brief Configure the process-wide scheduler
+   * @return False if @ref global() was already created, in which case the
+   *    configuration is ignored
+   */
+  static bool setGlobalConfiguration(
+      const TaskSchedulerConfiguration& configuration);
+
+  explicit TaskScheduler(
+      const TaskSchedulerConfiguration& configuration = {});
+
+  /** @brief Runs everything queued and stops the workers */
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  /** @brief Number of worker threads */
+  size_t threadCount() const { return workers_.size(); }
+
+  /**
+   * @brief Index of the worker of this scheduler the caller runs on, -1 if
+   *    it's a thread of its own
+   */
+  int currentWorker() const;
+
+  /**
+   * @brief Queue @p task
+   * @param task     Task to run
+   * @param priority Priority among the tasks queued
+   * @param group    Group to count the task in, or null
+   */
+  void submit(std::function<void()> task,
+              TaskPriority priority = TaskPriority::Normal,
+              TaskGroup* group = nullptr);
+
+  /**
+   * @brief Queue @p function and get its result through a future
+   *
+   * For tasks whose result is needed later, like a file read while
+   * something else is being done.
+   */
+  template <class F>
+  std::future<typename std::result_of<F()>::type> async(
+      F&& function,
+      TaskPriority priority = TaskPriority::Normal) {
+    typedef typename std::result_of<F()>::type Result;
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<F>(function));
+    std::future<Result> result = task->get_future();
+    submit([task]() { (*task)(); }, priority);
+    return result;
+  }
+
+  /**
+   * @brief Run @p body over the range from @p begin to @p end
+   * @param begin Start of the range
+   * @param end   End of the range, exclusive
+   * @param body  Called with sub-ranges, each between a @p begin and an
+   *    @p end, from any thread and in no particular order
+   * @param grain Elements of a sub-range at least, 0 to divide the range
+   *    into a few sub-ranges per worker
+   *
+   * The calling thread takes part and returns once the whole range is
+   * done. Can be called from inside a task.
+   */
+  void parallelFor(size_t begin,
+                   size_t end,
+                   const std::function<void(size_t, size_t)>& body,
+                   size_t grain = 0);
+
+  /**
+   * @brief Wait until everything queued so far and its follow-ups ran
+   *
+   * Not to be called from inside a task, which would wait for itself.
+   */
+  void waitIdle();
+
+ private:
+  friend TaskGroup;
+
+  struct Task;
+  class Deque;
+  struct Worker;
+
+  void run(size_t index);
+  // a task for the worker index, or for an outside thread if index is -1
+  Task* take(int index);
+  void execute(Task* task);
+
+  const TaskSchedulerConfiguration configuration_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // tasks submitted from threads that aren't workers, by priority
+  std::mutex injectedMutex_;
+  std::vector<std::deque<Task*>> injected_;
+  // read without the lock to skip injected_ when it's empty
+  std::atomic<size_t> injectedCount_{0};
+
+  // queued tasks not taken yet, and tasks not finished yet
+  std::atomic<size_t> queuedTasks_{0};
+  std::atomic<size_t> unfinishedTasks_{0};
+  std::atomic<size_t> sleepingWorkers_{0};
+  std::atomic<bool> stopping_{false};
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+};
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,149 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Topology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace esp {
+namespace core {
+
+namespace {
+
+// first line of a sysfs file, empty if there is none
+std::string readLine(const std::string& filename) {
+  std::ifstream file{filename};
+  std::string line;
+  if (file) {
+    std::getline(file, line);
+  }
+  return line;
+}
+
+}  // namespace
+
+std::vector<int> parseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::istringstream in{list};
+  std::string range;
+  while (std::getline(in, range, ',')) {
+    const size_t dash = range.find('-');
+    try {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::exception&) {
+      // an empty list or something unexpected
+    }
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int>> numaNodeCpus() {
+  std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+  for (int node = 0;; ++node) {
+    std::ifstream file{"/sys/devices/system/node/node" + std::to_string(node) +
+                       "/cpulist"};
+    std::string list;
+    if (!file || !std::getline(file, list)) {
+      break;
+    }
+    nodes.push_back(parseCpuList(list));
+  }
+#endif
+  return nodes;
+}
+
+DeviceLocality deviceLocality(const std::string& sysfsDevice) {
+  DeviceLocality locality;
+  const std::string node = readLine(sysfsDevice + "/numa_node");
+  if (!node.empty()) {
+    try {
+      // -1 on single-node systems
+      locality.numaNode = std::max(-1, std::stoi(node));
+    } catch (const std::exception&) {
+    }
+  }
+  locality.cpus = parseCpuList(readLine(sysfsDevice + "/local_cpulist"));
+  // older kernels only have the CPUs of the node
+  if (locality.cpus.empty() && locality.numaNode >= 0) {
+    const std::vector<std::vector<int>> nodes = numaNodeCpus();
+    if (locality.numaNode < int(nodes.size())) {
+      locality.cpus = nodes[locality.numaNode];
+    }
+  }
+  return locality;
+}
+
+DeviceLocality pciDeviceLocality(const std::string& busId) {
+  std::string lowercase = busId;
+  std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return deviceLocality("/sys/bus/pci/devices/" + lowercase);
+}
+
+DeviceLocality drmDeviceLocality(const std::string& deviceFile) {
+  const size_t slash = deviceFile.rfind('/');
+  const std::string name =
+      slash == std::string::npos ? deviceFile : deviceFile.substr(slash + 1);
+  if (name.empty()) {
+    return {};
+  }
+  return deviceLocality("/sys/class/drm/" + name + "/device");
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return CPU_COUNT(&set) != 0 &&
+         pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpus);
+  return false;
+#endif
+}
+
+bool preferMemoryNode(int node) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  // <numaif.h> is part of libnuma, the policy value is the kernel's
+  constexpr int MpolPreferred = 1;
+  constexpr int MaxNodes = 1024;
+  constexpr int BitsPerWord = 8 * sizeof(unsigned long);
+  if (node < 0 || node >= MaxNodes) {
+    return false;
+  }
+  unsigned long mask[MaxNodes / BitsPerWord]{};
+  mask[node / BitsPerWord] = 1ul << (node % BitsPerWord);
+  // the kernel reads one bit less than it's told
+  return syscall(SYS_set_mempolicy, MpolPreferred, mask,
+                 (unsigned long)(MaxNodes + 1)) == 0;
+#else
+  static_cast<void>(node);
+  return false;
+#endif
+}
+
+}  // namespace core
+}  // namespace esp
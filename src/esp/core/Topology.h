@@ -0,0 +1,79 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Struct @ref esp::core::DeviceLocality, functions
+ *    @ref esp::core::deviceLocality(), @ref esp::core::pinCurrentThread(),
+ *    @ref esp::core::preferMemoryNode()
+ *
+ * CPU and NUMA topology as the Linux kernel reports it in `/sys`, read
+ * without libnuma. Everything returns empty or fails gracefully on other
+ * systems.
+ */
+
+#include <string>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/** @brief CPUs of a list like `0-3,8-11`, the format of sysfs */
+std::vector<int> parseCpuList(const std::string& list);
+
+/** @brief CPUs of each NUMA node, empty if unknown */
+std::vector<std::vector<int>> numaNodeCpus();
+
+/** @brief Where a device is attached */
+struct DeviceLocality {
+  /** @brief NUMA node the device is attached to, -1 if unknown */
+  int numaNode = -1;
+
+  /** @brief CPUs of the socket the device is attached to, empty if unknown */
+  std::vector<int> cpus;
+};
+
+/**
+ * @brief Locality of a device given its sysfs directory
+ * @param sysfsDevice Directory like `/sys/bus/pci/devices/0000:3b:00.0` or
+ *    `/sys/class/drm/card0/device`
+ */
+DeviceLocality deviceLocality(const std::string& sysfsDevice);
+
+/**
+ * @brief Locality of a PCI device
+ * @param busId Domain, bus, device and function like `0000:3B:00.0`, in
+ *    either case
+ */
+DeviceLocality pciDeviceLocality(const std::string& busId);
+
+/**
+ * @brief Locality of a DRM device
+ * @param deviceFile Device file like `/dev/dri/card0` or
+ *    `/dev/dri/renderD128`
+ */
+DeviceLocality drmDeviceLocality(const std::string& deviceFile);
+
+/**
+ * @brief Restrict the calling thread to @p cpus
+ * @return False if the thread can't be pinned or @p cpus is empty
+ *
+ * Threads started by the calling thread afterwards inherit the affinity.
+ */
+bool pinCurrentThread(const std::vector<int>& cpus);
+
+/**
+ * @brief Allocate the memory of the calling thread from NUMA node @p node
+ *    where possible
+ * @return False if the policy can't be set
+ *
+ * Pages are placed on @p node when they're first touched, falling back to
+ * other nodes once it's full. Threads started by the calling thread
+ * afterwards inherit the policy.
+ */
+bool preferMemoryNode(int node);
+
+}  // namespace core
+}  // namespace esp
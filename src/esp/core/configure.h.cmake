@@ -15,3 +15,7 @@
 #cmakedefine ESP_BUILD_WITH_CUDA
 
 #cmakedefine ESP_BUILD_WITH_BULLET
+
+#cmakedefine ESP_BUILD_WITH_ZLIB
+
+#define ESP_MIN_LOG_LEVEL ${ESP_MIN_LOG_LEVEL}
@@ -0,0 +1,20 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "logging.h"
+
+namespace esp {
+namespace core {
+
+void setLogVerbosity(const std::string& modulePattern, int level) {
+#if defined(ESP_BUILD_GLOG_SHIM)
+  static_cast<void>(modulePattern);
+  static_cast<void>(level);
+#else
+  google::SetVLOGLevel(modulePattern.c_str(), level);
+#endif
+}
+
+}  // namespace core
+}  // namespace esp
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "esp/core/configure.h"
 
 #if defined(ESP_BUILD_GLOG_SHIM)
@@ -30,9 +32,8 @@ class LogMessageVoidify {
   Corrade::Utility::Error {}
 #define GLOG_FATAL \
   Corrade::Utility::Fatal {}
-#define LOG(severity) GLOG_##severity
-#define LOG_IF(severity, condition) \
-  !(condition) ? (void)0 : LogMessageVoidify() & LOG(severity)
+#define ESP_LOG_VOIDIFY LogMessageVoidify()
+#define ESP_LOG_STREAM(severity) GLOG_##severity
 
 #define VLOG_LEVEL 0
 
@@ -56,7 +57,73 @@ class LogMessageVoidify {
 // stl_logging.h needs to be before logging.h because template magic.
 #include <glog/logging.h>
 #include <glog/stl_logging.h>
+
+#define ESP_LOG_VOIDIFY google::LogMessageVoidify()
+#define ESP_LOG_STREAM(severity) COMPACT_GOOGLE_LOG_##severity.stream()
+#undef LOG
+#undef LOG_IF
+#endif
+
+/*
+ * Levels below ESP_MIN_LOG_LEVEL, set with the CMake option of the same name
+ * (0 INFO, 1 WARNING, 2 ERROR), compile to a branch that is never taken, so
+ * neither the message nor its arguments are evaluated. FATAL is never
+ * stripped. Levels that are kept expand to the plain glog stream.
+ */
+#ifndef ESP_MIN_LOG_LEVEL
+#define ESP_MIN_LOG_LEVEL 0
+#endif
+
+#define ESP_LOG_ON_INFO (ESP_MIN_LOG_LEVEL <= 0)
+#define ESP_LOG_ON_WARNING (ESP_MIN_LOG_LEVEL <= 1)
+#define ESP_LOG_ON_ERROR (ESP_MIN_LOG_LEVEL <= 2)
+#define ESP_LOG_ON_FATAL 1
+
+#define ESP_LOG_STRIPPED(severity) \
+  true ? (void)0 : ESP_LOG_VOIDIFY & ESP_LOG_STREAM(severity)
+
+#if ESP_MIN_LOG_LEVEL > 0
+#define ESP_LOG_INFO ESP_LOG_STRIPPED(INFO)
+#else
+#define ESP_LOG_INFO ESP_LOG_STREAM(INFO)
 #endif
+#if ESP_MIN_LOG_LEVEL > 1
+#define ESP_LOG_WARNING ESP_LOG_STRIPPED(WARNING)
+#else
+#define ESP_LOG_WARNING ESP_LOG_STREAM(WARNING)
+#endif
+#if ESP_MIN_LOG_LEVEL > 2
+#define ESP_LOG_ERROR ESP_LOG_STRIPPED(ERROR)
+#else
+#define ESP_LOG_ERROR ESP_LOG_STREAM(ERROR)
+#endif
+#define ESP_LOG_FATAL ESP_LOG_STREAM(FATAL)
+
+#define LOG(severity) ESP_LOG_##severity
+// the condition isn't evaluated for stripped levels either, VLOG() and
+// CHECK() are built on this
+#define LOG_IF(severity, condition)         \
+  !(ESP_LOG_ON_##severity && (condition)) \
+      ? (void)0                           \
+      : ESP_LOG_VOIDIFY & ESP_LOG_STREAM(severity)
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Set the verbosity of @cpp VLOG() @ce in the source files matching
+ * @p modulePattern
+ * @param modulePattern Basename of the files without extension, may contain
+ *      @cpp * @ce and @cpp ? @ce wildcards, e.g. @cpp "Sensor" @ce
+ * @param level         Messages of @cpp VLOG(level) @ce and below are shown
+ *
+ * The runtime equivalent of glog's @cb{.sh} --vmodule @ce. Has no effect
+ * with the glog shim, which has no verbose logging.
+ */
+void setLogVerbosity(const std::string& modulePattern, int level);
+
+}  // namespace core
+}  // namespace esp
 
 #define ASSERT(x, ...)                                              \
   do {                                                              \
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <random>
 
 namespace esp {
@@ -54,5 +58,164 @@ class Random {
   std::normal_distribution<float> normal_float_01_;
 };
 
+/**
+ * @brief Counter-based generator for parallel and reproducible sampling
+ *
+ * Philox4x32-10: the n-th block of four outputs is a keyed bijection of n,
+ * the key being the seed and the counter holding the stream index next to
+ * the position. Any seed and stream give an independent sequence without
+ * any state shared between them, so work split by thread, episode or image
+ * row gets the same numbers however it is scheduled. @ref split() derives
+ * nested streams, e.g. per thread from a per-episode stream. Construction
+ * is free, the bulk fills compute the blocks in a loop the compiler can
+ * vectorize.
+ */
+class CounterRandom {
+ public:
+  explicit CounterRandom(uint64_t seed, uint64_t stream = 0)
+      : key_{uint32_t(seed), uint32_t(seed >> 32)},
+        stream_{uint32_t(stream), uint32_t(stream >> 32)} {}
+
+  //! Return the generator of sub-stream @p stream, independent of this one
+  //! and of other sub-streams
+  CounterRandom split(uint64_t stream) const {
+    // a different key than the outputs of this stream use, so the child seed
+    // isn't one of those outputs
+    uint32_t seed[4];
+    block(key_[0] ^ 0x5be0cd19u, key_[1] ^ 0x1f83d9abu, uint32_t(stream),
+          uint32_t(stream >> 32), stream_[0], stream_[1], seed);
+    return CounterRandom{uint64_t{seed[1]} << 32 | seed[0], seed[2]};
+  }
+
+  //! Number of 32-bit outputs generated so far
+  uint64_t position() const { return position_; }
+
+  //! Return randomly sampled uint32_t distributed uniformly in [0,
+  //! std::numeric_limits<uint32_t>::max()]
+  uint32_t uniform_uint() {
+    if ((position_ & 3) == 0) {
+      const uint64_t n = position_ >> 2;
+      block(key_[0], key_[1], uint32_t(n), uint32_t(n >> 32), stream_[0],
+            stream_[1], buffer_);
+    }
+    return buffer_[position_++ & 3];
+  }
+
+  //! Return randomly sampled float distributed uniformly in [0, 1)
+  float uniform_float_01() { return toFloat01(uniform_uint()); }
+
+  //! Return randomly sampled float distributed uniformly in [a, b)
+  float uniform_float(float a, float b) {
+    return uniform_float_01() * (b - a) + a;
+  }
+
+  //! Return randomly sampled float distributed normally (mean=0, std=1)
+  float normal_float_01() {
+    const float u = uniform_float_01();
+    return boxMuller(u, uniform_float_01());
+  }
+
+  //! Fill @p out with uint32_t distributed uniformly, the same values as
+  //! @p count calls to @ref uniform_uint()
+  void fill_uniform_uint(uint32_t* out, size_t count) {
+    size_t i = 0;
+    // finish the current block first
+    for (; i < count && (position_ & 3); ++i) {
+      out[i] = uniform_uint();
+    }
+    const size_t blocks = (count - i) / 4;
+    const uint64_t first = position_ >> 2;
+    uint32_t* const blockOut = out + i;
+#pragma omp simd
+    for (size_t j = 0; j < blocks; ++j) {
+      const uint64_t n = first + j;
+      block(key_[0], key_[1], uint32_t(n), uint32_t(n >> 32), stream_[0],
+            stream_[1], blockOut + 4 * j);
+    }
+    position_ += 4 * blocks;
+    for (i += 4 * blocks; i < count; ++i) {
+      out[i] = uniform_uint();
+    }
+  }
+
+  //! Fill @p out with floats distributed uniformly in [0, 1)
+  void fill_uniform_float_01(float* out, size_t count) {
+    // in chunks that stay in the L1 cache
+    constexpr size_t chunkSize = 256;
+    uint32_t bits[chunkSize];
+    for (size_t offset = 0; offset < count; offset += chunkSize) {
+      const size_t size = std::min(chunkSize, count - offset);
+      fill_uniform_uint(bits, size);
+#pragma omp simd
+      for (size_t i = 0; i < size; ++i) {
+        out[offset + i] = toFloat01(bits[i]);
+      }
+    }
+  }
+
+  //! Fill @p out with floats distributed normally (mean=0, std=1), using the
+  //! Box-Muller transform on pairs of uniform samples
+  void fill_normal_float_01(float* out, size_t count) {
+    fill_uniform_float_01(out, count);
+    const size_t pairs = count / 2;
+#pragma omp simd
+    for (size_t i = 0; i < pairs; ++i) {
+      const float r = std::sqrt(-2.0f * std::log(1.0f - out[2 * i]));
+      const float theta = 6.2831853f * out[2 * i + 1];
+      out[2 * i] = r * std::cos(theta);
+      out[2 * i + 1] = r * std::sin(theta);
+    }
+    if (count % 2) {
+      out[count - 1] = boxMuller(out[count - 1], uniform_float_01());
+    }
+  }
+
+  /**
+   * @brief The Philox4x32-10 block of a key and a counter
+   *
+   * Writes four uniformly distributed words to @p out.
+   */
+  static void block(uint32_t k0,
+                    uint32_t k1,
+                    uint32_t c0,
+                    uint32_t c1,
+                    uint32_t c2,
+                    uint32_t c3,
+                    uint32_t* out) {
+    for (int round = 0; round != 10; ++round) {
+      const uint64_t p0 = uint64_t{0xd2511f53u} * c0;
+      const uint64_t p1 = uint64_t{0xcd9e8d57u} * c2;
+      const uint32_t hi0 = uint32_t(p0 >> 32);
+      const uint32_t hi1 = uint32_t(p1 >> 32);
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = uint32_t(p1);
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = uint32_t(p0);
+      k0 += 0x9e3779b9u;
+      k1 += 0xbb67ae85u;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+ protected:
+  static float toFloat01(uint32_t bits) {
+    // the top 24 bits, all a float has below one
+    return float(bits >> 8) * (1.0f / 16777216.0f);
+  }
+
+  static float boxMuller(float u, float v) {
+    // 1 - u is in (0, 1], which keeps the logarithm finite
+    return std::sqrt(-2.0f * std::log(1.0f - u)) * std::cos(6.2831853f * v);
+  }
+
+  uint32_t key_[2];
+  uint32_t stream_[2];
+  uint64_t position_ = 0;
+  uint32_t buffer_[4];
+};
+
 }  // namespace core
 }  // namespace esp
@@ -0,0 +1,72 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BVH.h"
+
+#include <algorithm>
+
+namespace esp {
+namespace geo {
+
+namespace {
+// boxes per leaf, small enough that leaves are tested in a few cache lines
+constexpr uint32_t kLeafSize = 4;
+}  // namespace
+
+BVH::BVH(const std::vector<box3f>& boxes) {
+  for (uint32_t i = 0; i < boxes.size(); ++i) {
+    if (!boxes[i].isEmpty()) {
+      items_.push_back(i);
+    }
+  }
+  if (items_.empty()) {
+    return;
+  }
+  // a median split halves every subtree, 2 * n nodes are always enough
+  nodes_.reserve(2 * items_.size());
+  build(boxes, 0, items_.size());
+
+  itemBoxes_.reserve(items_.size());
+  for (uint32_t item : items_) {
+    itemBoxes_.push_back(boxes[item]);
+  }
+}
+
+uint32_t BVH::build(const std::vector<box3f>& boxes,
+                    uint32_t begin,
+                    uint32_t end) {
+  const uint32_t nodeIndex = nodes_.size();
+  nodes_.push_back({});
+  box3f box;
+  box3f centers;
+  for (uint32_t i = begin; i != end; ++i) {
+    box.extend(boxes[items_[i]]);
+    centers.extend(boxes[items_[i]].center());
+  }
+  nodes_[nodeIndex].box = box;
+
+  if (end - begin <= kLeafSize) {
+    nodes_[nodeIndex].first = begin;
+    nodes_[nodeIndex].count = end - begin;
+    return nodeIndex;
+  }
+
+  // split at the median along the axis the centers spread the most
+  int axis;
+  centers.sizes().maxCoeff(&axis);
+  const uint32_t middle = begin + (end - begin) / 2;
+  std::nth_element(items_.begin() + begin, items_.begin() + middle,
+                   items_.begin() + end, [&](uint32_t a, uint32_t b) {
+                     return boxes[a].center()[axis] < boxes[b].center()[axis];
+                   });
+
+  build(boxes, begin, middle);
+  const uint32_t right = build(boxes, middle, end);
+  nodes_[nodeIndex].first = right;
+  nodes_[nodeIndex].count = 0;
+  return nodeIndex;
+}
+
+}  // namespace geo
+}  // namespace esp
@@ -0,0 +1,92 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+//! Bounding volume hierarchy over axis aligned boxes, each identified by its
+//! index in the vector the hierarchy was built from. Queries visit the boxes
+//! that may satisfy them, the caller refines with the exact shape.
+class BVH {
+ public:
+  explicit BVH() = default;
+  //! Build over the given boxes, empty boxes are never visited
+  explicit BVH(const std::vector<box3f>& boxes);
+
+  //! Number of indexed boxes
+  size_t size() const { return items_.size(); }
+
+  //! Call visit(index) for every box containing p
+  template <typename Visitor>
+  void visitContaining(const vec3f& p, Visitor&& visit) const {
+    visit_([&p](const box3f& box) { return box.contains(p); }, visit);
+  }
+
+  //! Call visit(index) for every box within radius of p
+  template <typename Visitor>
+  void visitWithinRadius(const vec3f& p, float radius, Visitor&& visit) const {
+    const float radiusSquared = radius * radius;
+    visit_(
+        [&p, radiusSquared](const box3f& box) {
+          return box.squaredExteriorDistance(p) <= radiusSquared;
+        },
+        visit);
+  }
+
+ protected:
+  struct Node {
+    box3f box;
+    // leaves own items_[first, first + count), inner nodes have count == 0,
+    // their left child right after them and the right child at first
+    uint32_t first;
+    uint32_t count;
+  };
+
+  uint32_t build(const std::vector<box3f>& boxes,
+                 uint32_t begin,
+                 uint32_t end);
+
+  template <typename Overlaps, typename Visitor>
+  void visit_(const Overlaps& overlaps, Visitor& visit) const {
+    if (nodes_.empty()) {
+      return;
+    }
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      const Node& node = nodes_[stack[--top]];
+      if (!overlaps(node.box)) {
+        continue;
+      }
+      if (node.count > 0) {
+        for (uint32_t i = node.first; i != node.first + node.count; ++i) {
+          if (overlaps(itemBoxes_[i])) {
+            visit(items_[i]);
+          }
+        }
+      } else {
+        stack[top++] = node.first;
+        stack[top++] = uint32_t(&node - nodes_.data()) + 1;
+      }
+    }
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> items_;
+  // boxes in the order of items_, so leaves test them without indirection
+  std::vector<box3f> itemBoxes_;
+
+  ESP_SMART_POINTERS(BVH)
+};
+
+}  // namespace geo
+}  // namespace esp
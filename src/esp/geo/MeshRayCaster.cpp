@@ -0,0 +1,226 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshRayCaster.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <Corrade/Utility/Assert.h>
+
+namespace esp {
+namespace geo {
+
+// static constexpr members require redundant definitions until C++17
+constexpr uint32_t MeshRayCaster::NoHit;
+constexpr int MeshRayCaster::PackSize;
+
+namespace {
+
+constexpr float Inf = std::numeric_limits<float>::infinity();
+
+// distance at which the ray enters the box, infinity if it misses it within
+// [minDistance, maxDistance]. Axis-parallel rays get NaN for slabs they lie
+// on, which the min/max argument order ignores.
+float boxEntry(const box3f& box,
+               const vec3f& origin,
+               const vec3f& inverseDirection,
+               float minDistance,
+               float maxDistance) {
+  float enter = minDistance;
+  float leave = maxDistance;
+  for (int a = 0; a < 3; ++a) {
+    const float t0 = (box.min()[a] - origin[a]) * inverseDirection[a];
+    const float t1 = (box.max()[a] - origin[a]) * inverseDirection[a];
+    enter = std::max(enter, std::min(t0, t1));
+    leave = std::min(leave, std::max(t0, t1));
+  }
+  return enter <= leave ? enter : Inf;
+}
+
+}  // namespace
+
+MeshRayCaster::MeshRayCaster(const std::vector<vec3f>& vertices,
+                             const std::vector<uint32_t>& indices,
+                             std::vector<uint32_t> objectIds)
+    : objectIds_{std::move(objectIds)}, triangleCount_{indices.size() / 3} {
+  CORRADE_ASSERT(objectIds_.empty() || objectIds_.size() == triangleCount_,
+                 "MeshRayCaster: expected" << triangleCount_
+                                           << "object IDs but got"
+                                           << objectIds_.size(), );
+  if (triangleCount_ == 0) {
+    return;
+  }
+
+  const long n = triangleCount_;
+  std::vector<box3f> boxes(n);
+  std::vector<vec3f> centroids(n);
+  std::vector<uint32_t> order(n);
+#pragma omp parallel for if (n > 65536)
+  for (long i = 0; i < n; ++i) {
+    box3f& box = boxes[i];
+    for (int k = 0; k < 3; ++k) {
+      box.extend(vertices[indices[3 * i + k]]);
+    }
+    centroids[i] = box.center();
+    order[i] = i;
+  }
+
+  nodes_.reserve(2 * (n / PackSize + 1));
+  packs_.reserve(n / PackSize + 1);
+  build(vertices, indices, boxes, centroids, order, 0, n);
+}
+
+uint32_t MeshRayCaster::build(const std::vector<vec3f>& vertices,
+                              const std::vector<uint32_t>& indices,
+                              const std::vector<box3f>& boxes,
+                              const std::vector<vec3f>& centroids,
+                              std::vector<uint32_t>& order,
+                              uint32_t begin,
+                              uint32_t end) {
+  const uint32_t index = nodes_.size();
+  nodes_.emplace_back();
+  box3f box;
+  box3f centroidBox;
+  for (uint32_t i = begin; i != end; ++i) {
+    box.extend(boxes[order[i]]);
+    centroidBox.extend(centroids[order[i]]);
+  }
+
+  if (end - begin <= uint32_t(PackSize)) {
+    TrianglePack pack{};
+    for (uint32_t i = begin; i != end; ++i) {
+      const uint32_t triangle = order[i];
+      const vec3f& v0 = vertices[indices[3 * triangle]];
+      const vec3f e1 = vertices[indices[3 * triangle + 1]] - v0;
+      const vec3f e2 = vertices[indices[3 * triangle + 2]] - v0;
+      for (int a = 0; a < 3; ++a) {
+        pack.v0[a][i - begin] = v0[a];
+        pack.e1[a][i - begin] = e1[a];
+        pack.e2[a][i - begin] = e2[a];
+      }
+      pack.triangle[i - begin] = triangle;
+    }
+    nodes_[index] = {box, uint32_t(packs_.size()), 1};
+    packs_.push_back(pack);
+    return index;
+  }
+
+  // median split of the centroids along the longest axis
+  int axis;
+  centroidBox.sizes().maxCoeff(&axis);
+  const uint32_t middle = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + middle,
+                   order.begin() + end,
+                   [&centroids, axis](uint32_t a, uint32_t b) {
+                     return centroids[a][axis] < centroids[b][axis];
+                   });
+  build(vertices, indices, boxes, centroids, order, begin, middle);
+  const uint32_t right =
+      build(vertices, indices, boxes, centroids, order, middle, end);
+  nodes_[index] = {box, right, 0};
+  return index;
+}
+
+MeshRayCaster::Hit MeshRayCaster::castRay(const vec3f& origin,
+                                          const vec3f& direction,
+                                          float minDistance,
+                                          float maxDistance) const {
+  Hit hit{maxDistance, NoHit};
+  if (nodes_.empty()) {
+    return hit;
+  }
+  const vec3f inverseDirection = direction.cwiseInverse();
+  const float ox = origin.x(), oy = origin.y(), oz = origin.z();
+  const float dx = direction.x(), dy = direction.y(), dz = direction.z();
+
+  // nodes to visit with their entry distance, so the ones behind a closer
+  // hit are skipped
+  struct Entry {
+    uint32_t node;
+    float distance;
+  };
+  Entry stack[64];
+  int top = 0;
+  const float rootEntry = boxEntry(nodes_[0].box, origin, inverseDirection,
+                                   minDistance, maxDistance);
+  if (rootEntry == Inf) {
+    return hit;
+  }
+  stack[top++] = {0, rootEntry};
+  while (top > 0) {
+    const Entry entry = stack[--top];
+    if (entry.distance >= hit.distance) {
+      continue;
+    }
+    const Node& node = nodes_[entry.node];
+
+    if (node.count == 0) {
+      const uint32_t left = entry.node + 1;
+      const uint32_t right = node.first;
+      const float leftEntry = boxEntry(nodes_[left].box, origin,
+                                       inverseDirection, minDistance,
+                                       hit.distance);
+      const float rightEntry = boxEntry(nodes_[right].box, origin,
+                                        inverseDirection, minDistance,
+                                        hit.distance);
+      // the nearer child is popped first
+      const bool leftFirst = leftEntry <= rightEntry;
+      const Entry first{leftFirst ? left : right,
+                        leftFirst ? leftEntry : rightEntry};
+      const Entry second{leftFirst ? right : left,
+                         leftFirst ? rightEntry : leftEntry};
+      if (second.distance != Inf) {
+        stack[top++] = second;
+      }
+      if (first.distance != Inf) {
+        stack[top++] = first;
+      }
+      continue;
+    }
+
+    for (uint32_t p = node.first; p != node.first + node.count; ++p) {
+      const TrianglePack& pack = packs_[p];
+      const float closest = hit.distance;
+      float distances[PackSize];
+      // Moeller-Trumbore for all four triangles, without branches. Zero
+      // determinants give NaN barycentrics, which fail the comparisons.
+#pragma omp simd
+      for (int i = 0; i < PackSize; ++i) {
+        const float e1x = pack.e1[0][i], e1y = pack.e1[1][i],
+                    e1z = pack.e1[2][i];
+        const float e2x = pack.e2[0][i], e2y = pack.e2[1][i],
+                    e2z = pack.e2[2][i];
+        const float px = dy * e2z - dz * e2y;
+        const float py = dz * e2x - dx * e2z;
+        const float pz = dx * e2y - dy * e2x;
+        const float determinant = e1x * px + e1y * py + e1z * pz;
+        const float inverse = 1.0f / determinant;
+        const float sx = ox - pack.v0[0][i];
+        const float sy = oy - pack.v0[1][i];
+        const float sz = oz - pack.v0[2][i];
+        const float u = (sx * px + sy * py + sz * pz) * inverse;
+        const float qx = sy * e1z - sz * e1y;
+        const float qy = sz * e1x - sx * e1z;
+        const float qz = sx * e1y - sy * e1x;
+        const float v = (dx * qx + dy * qy + dz * qz) * inverse;
+        const float t = (e2x * qx + e2y * qy + e2z * qz) * inverse;
+        const bool valid = (determinant != 0.0f) & (u >= 0.0f) & (v >= 0.0f) &
+                           (u + v <= 1.0f) & (t >= minDistance) &
+                           (t < closest);
+        distances[i] = valid ? t : Inf;
+      }
+      for (int i = 0; i < PackSize; ++i) {
+        if (distances[i] < hit.distance) {
+          hit.distance = distances[i];
+          hit.triangle = pack.triangle[i];
+        }
+      }
+    }
+  }
+  return hit;
+}
+
+}  // namespace geo
+}  // namespace esp
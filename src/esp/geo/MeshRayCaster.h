@@ -0,0 +1,104 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+//! Closest hit ray queries against a triangle mesh, for tracing observations
+//! on the CPU. The triangles are kept in a bounding volume hierarchy whose
+//! leaves hold packs of four in a structure-of-arrays layout, intersected
+//! with one vectorized loop. Queries are const and can run from many threads.
+class MeshRayCaster {
+ public:
+  //! Triangle of a ray that hit nothing
+  static constexpr uint32_t NoHit = 0xffffffffu;
+
+  //! Triangles per leaf
+  static constexpr int PackSize = 4;
+
+  struct Hit {
+    //! Distance along the ray in units of its direction's length
+    float distance;
+    //! Index of the triangle hit, @ref NoHit if none
+    uint32_t triangle;
+  };
+
+  explicit MeshRayCaster() = default;
+
+  /**
+   * @brief Build the hierarchy over a triangle mesh
+   * @param vertices    Vertex positions
+   * @param indices     Three vertex indices per triangle
+   * @param objectIds   Optional ID of each triangle, see @ref objectId()
+   */
+  explicit MeshRayCaster(const std::vector<vec3f>& vertices,
+                         const std::vector<uint32_t>& indices,
+                         std::vector<uint32_t> objectIds = {});
+
+  //! Number of triangles
+  size_t triangleCount() const { return triangleCount_; }
+
+  /**
+   * @brief Closest triangle hit by a ray
+   * @param origin        Ray origin
+   * @param direction     Ray direction, not necessarily normalized
+   * @param minDistance   Hits closer than this are ignored
+   * @param maxDistance   Hits farther than this are ignored
+   *
+   * Both sides of the triangles are hit.
+   */
+  Hit castRay(const vec3f& origin,
+              const vec3f& direction,
+              float minDistance,
+              float maxDistance) const;
+
+  //! ID of @p triangle passed to the constructor, 0 without IDs or for
+  //! @ref NoHit
+  uint32_t objectId(uint32_t triangle) const {
+    return triangle < objectIds_.size() ? objectIds_[triangle] : 0;
+  }
+
+ protected:
+  struct Node {
+    box3f box;
+    // leaves own packs_[first, first + count), inner nodes have count == 0,
+    // their left child right after them and the right child at first
+    uint32_t first;
+    uint32_t count;
+  };
+
+  // the first vertex and the two edges from it of four triangles, the
+  // unused lanes of the last pack have zero edges and never hit
+  struct TrianglePack {
+    float v0[3][PackSize];
+    float e1[3][PackSize];
+    float e2[3][PackSize];
+    uint32_t triangle[PackSize];
+  };
+
+  uint32_t build(const std::vector<vec3f>& vertices,
+                 const std::vector<uint32_t>& indices,
+                 const std::vector<box3f>& boxes,
+                 const std::vector<vec3f>& centroids,
+                 std::vector<uint32_t>& order,
+                 uint32_t begin,
+                 uint32_t end);
+
+  std::vector<Node> nodes_;
+  std::vector<TrianglePack> packs_;
+  std::vector<uint32_t> objectIds_;
+  size_t triangleCount_ = 0;
+
+  ESP_SMART_POINTERS(MeshRayCaster)
+};
+
+}  // namespace geo
+}  // namespace esp
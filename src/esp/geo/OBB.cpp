@@ -4,6 +4,8 @@
 
 #include "OBB.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "esp/geo/geo.h"
@@ -15,7 +17,7 @@ OBB::OBB() {
   center_.setZero();
   halfExtents_.setZero();
   rotation_.setIdentity();
-  box3f box;
+  aabb_ = box3f{center_, center_};
 }
 
 OBB::OBB(const vec3f& center, const vec3f& dimensions, const quatf& rotation)
@@ -30,16 +32,6 @@ static const vec3f kCorners[8] = {
     vec3f(-1, -1, -1), vec3f(-1, -1, +1), vec3f(-1, +1, -1), vec3f(-1, +1, +1),
     vec3f(+1, -1, -1), vec3f(+1, -1, +1), vec3f(+1, +1, -1), vec3f(+1, +1, +1)};
 
-box3f OBB::toAABB() const {
-  box3f bbox;
-  for (int i = 0; i < 8; i++) {
-    const vec3f worldPoint =
-        center_ + (rotation_ * kCorners[i].cwiseProduct(halfExtents_));
-    bbox.extend(worldPoint);
-  }
-  return bbox;
-}
-
 void OBB::recomputeTransforms() {
   ASSERT(center_.allFinite());
   ASSERT(halfExtents_.allFinite());
@@ -58,6 +50,12 @@ void OBB::recomputeTransforms() {
     worldToLocal_.linear().row(i) = R.col(i) * (1.0f / halfExtents_[i]);
   }
   worldToLocal_.translation() = -worldToLocal_.linear() * center_;
+
+  aabb_.setEmpty();
+  for (int i = 0; i < 8; i++) {
+    aabb_.extend(center_ +
+                 (rotation_ * kCorners[i].cwiseProduct(halfExtents_)));
+  }
 }
 
 bool OBB::contains(const vec3f& p, float eps /* = 1e-6f */) const {
@@ -96,6 +94,115 @@ OBB& OBB::rotate(const quatf& q) {
   return *this;
 }
 
+namespace {
+// bounds of all points, to skip boxes none of them can touch
+box3f pointBounds(const SoAPoints& points) {
+  box3f bounds;
+  for (size_t i = 0; i < points.size(); ++i) {
+    bounds.extend(vec3f{points.x[i], points.y[i], points.z[i]});
+  }
+  return bounds;
+}
+}  // namespace
+
+// The kernels below work on plain float arrays, so that the inner loops over
+// points vectorize with whatever SIMD the target has
+std::vector<uint8_t> batchContains(const std::vector<OBB>& boxes,
+                                   const SoAPoints& points,
+                                   float epsilon /* = 1e-6f */) {
+  const size_t n = points.size();
+  std::vector<uint8_t> result(boxes.size() * n, 0);
+  const box3f bounds = pointBounds(points);
+  const float bound = 1.0f + epsilon;
+  const float* x = points.x.data();
+  const float* y = points.y.data();
+  const float* z = points.z.data();
+
+#pragma omp parallel for schedule(dynamic) if (boxes.size() * n > 65536)
+  for (int j = 0; j < int(boxes.size()); ++j) {
+    if (!boxes[j].toAABB().intersects(bounds)) {
+      continue;
+    }
+    const Transform& t = boxes[j].worldToLocal();
+    const mat3f m = t.linear();
+    const vec3f o = t.translation();
+    uint8_t* out = result.data() + j * n;
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+      const float lx = m(0, 0) * x[i] + m(0, 1) * y[i] + m(0, 2) * z[i] + o[0];
+      const float ly = m(1, 0) * x[i] + m(1, 1) * y[i] + m(1, 2) * z[i] + o[1];
+      const float lz = m(2, 0) * x[i] + m(2, 1) * y[i] + m(2, 2) * z[i] + o[2];
+      // no short-circuiting, so the loop stays branch-free
+      out[i] = (std::abs(lx) <= bound) & (std::abs(ly) <= bound) &
+               (std::abs(lz) <= bound);
+    }
+  }
+  return result;
+}
+
+std::vector<float> batchDistance(const std::vector<OBB>& boxes,
+                                 const SoAPoints& points) {
+  const size_t n = points.size();
+  std::vector<float> result(boxes.size() * n);
+  const float* x = points.x.data();
+  const float* y = points.y.data();
+  const float* z = points.z.data();
+
+#pragma omp parallel for schedule(dynamic) if (boxes.size() * n > 65536)
+  for (int j = 0; j < int(boxes.size()); ++j) {
+    // in the rotated but unscaled box frame the distance is the length of
+    // the part of |d| sticking out of the half extents
+    const mat3f r = boxes[j].rotation().matrix();
+    const vec3f c = boxes[j].center();
+    const vec3f h = boxes[j].halfExtents();
+    float* out = result.data() + j * n;
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+      const float dx = x[i] - c[0], dy = y[i] - c[1], dz = z[i] - c[2];
+      const float ex = std::max(
+          std::abs(r(0, 0) * dx + r(1, 0) * dy + r(2, 0) * dz) - h[0], 0.0f);
+      const float ey = std::max(
+          std::abs(r(0, 1) * dx + r(1, 1) * dy + r(2, 1) * dz) - h[1], 0.0f);
+      const float ez = std::max(
+          std::abs(r(0, 2) * dx + r(1, 2) * dy + r(2, 2) * dz) - h[2], 0.0f);
+      out[i] = std::sqrt(ex * ex + ey * ey + ez * ez);
+    }
+  }
+  return result;
+}
+
+SoAPoints batchClosestPoint(const OBB& box, const SoAPoints& points) {
+  const size_t n = points.size();
+  SoAPoints result;
+  result.x.resize(n);
+  result.y.resize(n);
+  result.z.resize(n);
+  const mat3f r = box.rotation().matrix();
+  const vec3f c = box.center();
+  const vec3f h = box.halfExtents();
+  const float* x = points.x.data();
+  const float* y = points.y.data();
+  const float* z = points.z.data();
+  float* outX = result.x.data();
+  float* outY = result.y.data();
+  float* outZ = result.z.data();
+
+#pragma omp parallel for simd if (n > 65536)
+  for (size_t i = 0; i < n; ++i) {
+    const float dx = x[i] - c[0], dy = y[i] - c[1], dz = z[i] - c[2];
+    const float u = clamp(r(0, 0) * dx + r(1, 0) * dy + r(2, 0) * dz, -h[0],
+                          h[0]);
+    const float v = clamp(r(0, 1) * dx + r(1, 1) * dy + r(2, 1) * dz, -h[1],
+                          h[1]);
+    const float w = clamp(r(0, 2) * dx + r(1, 2) * dy + r(2, 2) * dz, -h[2],
+                          h[2]);
+    outX[i] = c[0] + r(0, 0) * u + r(0, 1) * v + r(0, 2) * w;
+    outY[i] = c[1] + r(1, 0) * u + r(1, 1) * v + r(1, 2) * w;
+    outZ[i] = c[2] + r(2, 0) * u + r(2, 1) * v + r(2, 2) * w;
+  }
+  return result;
+}
+
 // https://geidav.wordpress.com/tag/minimum-obb/
 OBB computeGravityAlignedMOBB(const vec3f& gravity,
                               const std::vector<vec3f>& points) {
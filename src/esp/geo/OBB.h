@@ -38,7 +38,7 @@ class OBB {
   const Transform& localToWorld() const { return localToWorld_; }
 
   //! Returns an axis aligned bounding box bounding this OBB
-  box3f toAABB() const;
+  const box3f& toAABB() const { return aabb_; }
 
   //! Returns distance to p from closest point on OBB surface
   //! (0 if point p is inside box)
@@ -61,6 +61,9 @@ class OBB {
   vec3f halfExtents_;
   quatf rotation_;
   Transform localToWorld_, worldToLocal_;
+  // kept up to date with the transforms, the batched queries reject whole
+  // boxes with it
+  box3f aabb_;
   ESP_SMART_POINTERS(OBB)
 };
 
@@ -69,6 +72,35 @@ inline std::ostream& operator<<(std::ostream& os, const OBB& obb) {
             << ",r:" << obb.rotation().coeffs() << "}";
 }
 
+//! Points in structure-of-arrays layout, for the batched OBB queries
+struct SoAPoints {
+  std::vector<float> x, y, z;
+
+  size_t size() const { return x.size(); }
+
+  void push_back(const vec3f& p) {
+    x.push_back(p[0]);
+    y.push_back(p[1]);
+    z.push_back(p[2]);
+  }
+};
+
+//! For each box and each point, whether the box contains the point within
+//! threshold distance epsilon, the same as @ref OBB::contains(). Box-major,
+//! the result for box j and point i is at j * points.size() + i.
+std::vector<uint8_t> batchContains(const std::vector<OBB>& boxes,
+                                   const SoAPoints& points,
+                                   float epsilon = 1e-6f);
+
+//! For each box and each point, the distance from the box surface, 0 inside,
+//! the same as @ref OBB::distance(). Box-major like @ref batchContains().
+std::vector<float> batchDistance(const std::vector<OBB>& boxes,
+                                 const SoAPoints& points);
+
+//! Closest point within the box to each point, the same as
+//! @ref OBB::closestPoint()
+SoAPoints batchClosestPoint(const OBB& box, const SoAPoints& points);
+
 // compute a minimum area OBB containing given points, and constrained to
 // have -Z axis along given gravity orientation
 OBB computeGravityAlignedMOBB(const vec3f& gravity,
@@ -0,0 +1,187 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "OccupancyGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Corrade/Utility/Assert.h>
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+// linear index in the Z, Y, X order of OccupancyGrid::voxels
+uint64_t voxelKey(const vec3i& dimensions, int x, int y, int z) {
+  return (uint64_t(z) * dimensions.y() + y) * dimensions.x() + x;
+}
+
+// A separating axis of a triangle and the unit voxels, which overlap along
+// it if the projection d of the voxel center is in [lower, upper]
+struct Axis {
+  vec3f direction;
+  float lower;
+  float upper;
+};
+
+}  // namespace
+
+bool OccupancyGrid::isOccupied(const vec3i& voxel) const {
+  if ((voxel.array() < 0).any() ||
+      (voxel.array() >= dimensions.array()).any()) {
+    return false;
+  }
+  const uint64_t key = voxelKey(dimensions, voxel.x(), voxel.y(), voxel.z());
+  long first = 0;
+  long count = voxels.rows();
+  while (count > 0) {
+    const long step = count / 2;
+    const long i = first + step;
+    if (voxelKey(dimensions, voxels(i, 0), voxels(i, 1), voxels(i, 2)) <
+        key) {
+      first = i + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first < voxels.rows() && voxels.row(first) == voxel.transpose();
+}
+
+vec3i OccupancyGrid::toVoxel(const vec3f& point) const {
+  return ((point - origin) / voxelSize).array().floor().cast<int>().matrix();
+}
+
+std::vector<uint8_t> OccupancyGrid::toDense() const {
+  std::vector<uint8_t> dense(
+      size_t(dimensions.x()) * dimensions.y() * dimensions.z(), 0);
+  for (long i = 0; i < voxels.rows(); ++i) {
+    dense[voxelKey(dimensions, voxels(i, 0), voxels(i, 1), voxels(i, 2))] = 1;
+  }
+  return dense;
+}
+
+OccupancyGrid voxelizeMesh(const std::vector<vec3f>& vertices,
+                           const std::vector<uint32_t>& indices,
+                           float voxelSize) {
+  CORRADE_ASSERT(voxelSize > 0.0f,
+                 "geo::voxelizeMesh(): expected a positive voxel size", {});
+  OccupancyGrid grid;
+  grid.voxelSize = voxelSize;
+  const long triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return grid;
+  }
+
+  box3f bounds;
+  for (long i = 0; i < triangleCount * 3; ++i) {
+    bounds.extend(vertices[indices[i]]);
+  }
+  grid.origin = bounds.min();
+  grid.dimensions =
+      (bounds.sizes() / voxelSize).array().floor().cast<int>() + 1;
+  const vec3i dimensions = grid.dimensions;
+  const vec3f origin = grid.origin;
+  const float scale = 1.0f / voxelSize;
+
+  std::vector<uint64_t> keys;
+#pragma omp parallel
+  {
+    std::vector<uint64_t> threadKeys;
+    std::vector<uint8_t> row;
+#pragma omp for schedule(dynamic, 1024) nowait
+    for (long t = 0; t < triangleCount; ++t) {
+      // in voxel units, so that the voxels are unit cubes at integer corners
+      vec3f v[3];
+      for (int k = 0; k < 3; ++k) {
+        v[k] = (vertices[indices[3 * t + k]] - origin) * scale;
+      }
+      vec3i lo, hi;
+      for (int a = 0; a < 3; ++a) {
+        const float low = std::min({v[0][a], v[1][a], v[2][a]});
+        const float high = std::max({v[0][a], v[1][a], v[2][a]});
+        lo[a] = std::max(int(std::floor(low)), 0);
+        hi[a] = std::min(int(std::floor(high)), dimensions[a] - 1);
+      }
+      // the common case of triangles smaller than a voxel
+      if (lo == hi) {
+        threadKeys.push_back(voxelKey(dimensions, lo.x(), lo.y(), lo.z()));
+        continue;
+      }
+
+      // the box normals are covered by iterating the triangle bounds only,
+      // what's left is the triangle normal and the nine edge cross products
+      const vec3f edges[3] = {v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+      Axis axes[10];
+      axes[0].direction = edges[0].cross(edges[1]);
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          axes[1 + 3 * i + j].direction = vec3f::Unit(i).cross(edges[j]);
+        }
+      }
+      for (Axis& axis : axes) {
+        const float p0 = axis.direction.dot(v[0]);
+        const float p1 = axis.direction.dot(v[1]);
+        const float p2 = axis.direction.dot(v[2]);
+        const float radius = 0.5f * axis.direction.cwiseAbs().sum();
+        axis.lower = std::min({p0, p1, p2}) - radius;
+        axis.upper = std::max({p0, p1, p2}) + radius;
+      }
+
+      const int n = hi.x() - lo.x() + 1;
+      row.resize(n);
+      for (int z = lo.z(); z <= hi.z(); ++z) {
+        for (int y = lo.y(); y <= hi.y(); ++y) {
+          std::fill(row.begin(), row.end(), 1);
+          uint8_t* overlaps = row.data();
+          for (const Axis& axis : axes) {
+            const vec3f& a = axis.direction;
+            const float d0 = a.x() * (lo.x() + 0.5f) + a.y() * (y + 0.5f) +
+                             a.z() * (z + 0.5f);
+            const float dx = a.x();
+            const float lower = axis.lower;
+            const float upper = axis.upper;
+            // no short-circuiting, so the loop stays branch-free
+#pragma omp simd
+            for (int i = 0; i < n; ++i) {
+              const float d = d0 + dx * i;
+              overlaps[i] &= (d >= lower) & (d <= upper);
+            }
+          }
+          for (int i = 0; i < n; ++i) {
+            if (overlaps[i]) {
+              threadKeys.push_back(voxelKey(dimensions, lo.x() + i, y, z));
+            }
+          }
+        }
+      }
+    }
+
+    // neighboring triangles share most of their voxels
+    std::sort(threadKeys.begin(), threadKeys.end());
+    threadKeys.erase(std::unique(threadKeys.begin(), threadKeys.end()),
+                     threadKeys.end());
+#pragma omp critical
+    keys.insert(keys.end(), threadKeys.begin(), threadKeys.end());
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  const long voxelCount = keys.size();
+  grid.voxels.resize(voxelCount, 3);
+  const uint64_t sizeX = dimensions.x();
+  const uint64_t sizeY = dimensions.y();
+#pragma omp parallel for if (voxelCount > 65536)
+  for (long i = 0; i < voxelCount; ++i) {
+    grid.voxels(i, 0) = int(keys[i] % sizeX);
+    grid.voxels(i, 1) = int(keys[i] / sizeX % sizeY);
+    grid.voxels(i, 2) = int(keys[i] / (sizeX * sizeY));
+  }
+  return grid;
+}
+
+}  // namespace geo
+}  // namespace esp
@@ -0,0 +1,55 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace geo {
+
+//! Sparse 3D occupancy of a mesh in cubic voxels. Voxel (x, y, z) spans
+//! origin + [x, x + 1) * voxelSize along X and likewise along Y and Z.
+struct OccupancyGrid {
+  //! Integer coordinates of voxels, one per row
+  typedef Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> Voxels;
+
+  //! World position of the lower corner of voxel (0, 0, 0)
+  vec3f origin = vec3f::Zero();
+  float voxelSize = 0.0f;
+  //! Number of voxels along each axis, covering the mesh bounds
+  vec3i dimensions = vec3i::Zero();
+  //! The voxels intersected by a triangle, sorted by Z, then Y, then X
+  Voxels voxels;
+
+  //! Whether @p voxel is occupied, false outside of the grid
+  bool isOccupied(const vec3i& voxel) const;
+
+  //! Coordinates of the voxel containing @p point, may be outside the grid
+  vec3i toVoxel(const vec3f& point) const;
+
+  //! The occupancy as a dense, X-fastest array of
+  //! dimensions.x() * dimensions.y() * dimensions.z() values
+  std::vector<uint8_t> toDense() const;
+
+  ESP_SMART_POINTERS(OccupancyGrid)
+};
+
+/**
+ * @brief Voxels of @p voxelSize intersected by the triangles of a mesh
+ *
+ * A voxel is occupied if a triangle overlaps it, tested exactly with the
+ * separating axes of the triangle and the box. Triangles are distributed
+ * over threads and each tests its candidate voxels a row at a time, with the
+ * loop over a row vectorized.
+ */
+OccupancyGrid voxelizeMesh(const std::vector<vec3f>& vertices,
+                           const std::vector<uint32_t>& indices,
+                           float voxelSize);
+
+}  // namespace geo
+}  // namespace esp
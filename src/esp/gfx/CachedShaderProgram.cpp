@@ -0,0 +1,175 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "CachedShaderProgram.h"
+
+#include <cstdio>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Shader.h>
+
+#include "esp/core/esp.h"
+#include "esp/io/io.h"
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+std::string& cacheDirectoryStorage() {
+  static std::string directory;
+  return directory;
+}
+
+#ifndef MAGNUM_TARGET_GLES
+struct ProgramCacheHeader {
+  int magic;
+  int version;
+  uint64_t key;
+  Mn::UnsignedInt format;
+  Mn::UnsignedInt size;
+};
+constexpr int PROGRAM_CACHE_MAGIC = 'P' << 24 | 'R' << 16 | 'O' << 8 | 'G';
+constexpr int PROGRAM_CACHE_VERSION = 1;
+
+// FNV-1a of the driver strings and the type and sources of every shader
+uint64_t hashProgram(
+    std::initializer_list<Cr::Containers::Reference<Mn::GL::Shader>>
+        shaders) {
+  uint64_t hash = 14695981039346656037ull;
+  const auto add = [&hash](const std::string& string) {
+    // the terminating zero separates consecutive strings
+    for (std::size_t i = 0; i != string.size() + 1; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(string.c_str()[i])) *
+             1099511628211ull;
+    }
+  };
+  Mn::GL::Context& context = Mn::GL::Context::current();
+  add(context.vendorString());
+  add(context.rendererString());
+  add(context.versionString());
+  for (Mn::GL::Shader& shader : shaders) {
+    add(std::to_string(Mn::UnsignedInt(shader.type())));
+    for (const std::string& source : shader.sources()) {
+      add(source);
+    }
+  }
+  return hash;
+}
+
+// false if the file doesn't exist, is invalid or the driver rejects the
+// binary. The program is left unlinked then.
+bool loadProgramBinary(const std::string& filename,
+                       uint64_t key,
+                       Mn::GL::AbstractShaderProgram& program) {
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (!fp) {
+    return false;
+  }
+  ProgramCacheHeader header;
+  bool valid = fread(&header, sizeof(header), 1, fp) == 1 &&
+               header.magic == PROGRAM_CACHE_MAGIC &&
+               header.version == PROGRAM_CACHE_VERSION &&
+               header.key == key && header.size != 0;
+  Cr::Containers::Array<char> data{Cr::Containers::NoInit,
+                                   valid ? std::size_t(header.size) : 0};
+  valid = valid && fread(data.data(), 1, data.size(), fp) == data.size();
+  fclose(fp);
+  if (valid) {
+    glProgramBinary(program.id(), header.format, data.data(), data.size());
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program.id(), GL_LINK_STATUS, &linked);
+    valid = linked == GL_TRUE;
+  }
+  if (!valid) {
+    LOG(WARNING) << "Ignoring invalid or outdated shader cache " << filename;
+  }
+  return valid;
+}
+
+void saveProgramBinary(const std::string& filename,
+                       uint64_t key,
+                       Mn::GL::AbstractShaderProgram& program) {
+  GLint size = 0;
+  glGetProgramiv(program.id(), GL_PROGRAM_BINARY_LENGTH, &size);
+  if (size <= 0) {
+    return;
+  }
+  Cr::Containers::Array<char> data{Cr::Containers::NoInit, std::size_t(size)};
+  GLenum format = 0;
+  glGetProgramBinary(program.id(), size, &size, &format, data.data());
+
+  ProgramCacheHeader header;
+  header.magic = PROGRAM_CACHE_MAGIC;
+  header.version = PROGRAM_CACHE_VERSION;
+  header.key = key;
+  header.format = format;
+  header.size = size;
+  if (!io::writeFileAtomically(filename, [&](FILE* fp) {
+        fwrite(&header, sizeof(header), 1, fp);
+        fwrite(data.data(), 1, size, fp);
+        return true;
+      })) {
+    LOG(WARNING) << "Cannot write shader cache " << filename;
+  }
+}
+#endif
+
+}  // namespace
+
+void CachedShaderProgram::setCacheDirectory(const std::string& directory) {
+  cacheDirectoryStorage() = directory;
+}
+
+const std::string& CachedShaderProgram::cacheDirectory() {
+  return cacheDirectoryStorage();
+}
+
+bool CachedShaderProgram::compileAndLink(
+    std::initializer_list<Cr::Containers::Reference<Mn::GL::Shader>>
+        shaders) {
+#ifndef MAGNUM_TARGET_GLES
+  std::string filename;
+  uint64_t key = 0;
+  if (!cacheDirectory().empty() &&
+      Mn::GL::Context::current()
+          .isExtensionSupported<
+              Mn::GL::Extensions::ARB::get_program_binary>()) {
+    key = hashProgram(shaders);
+    filename = Cr::Utility::Directory::join(
+        cacheDirectory(), Cr::Utility::formatString("{:.16x}.glprog", key));
+    if (loadProgramBinary(filename, key, *this)) {
+      return true;
+    }
+    setRetrievableBinary(true);
+  }
+#endif
+
+  if (!Mn::GL::Shader::compile(shaders)) {
+    return false;
+  }
+  attachShaders(shaders);
+  if (!link()) {
+    return false;
+  }
+
+#ifndef MAGNUM_TARGET_GLES
+  if (!filename.empty()) {
+    saveProgramBinary(filename, key, *this);
+  }
+#endif
+  return true;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,59 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <initializer_list>
+#include <string>
+
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/GL.h>
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Shader program linked through an on-disk cache of program binaries
+ *
+ * Compiling and linking the shaders is a large part of the startup of every
+ * simulator process. With a cache directory set, see
+ * @ref setCacheDirectory(), @ref compileAndLink() saves the linked program
+ * binary and later processes load it instead of compiling. Binaries are
+ * keyed by the sources of the shaders and the vendor, renderer and version
+ * strings of the driver, so a driver or GPU change, or an edit of a shader,
+ * compiles anew. A binary the driver rejects is compiled and saved again.
+ *
+ * Needs desktop GL 4.1 or ARB_get_program_binary, shaders are always
+ * compiled otherwise.
+ */
+class CachedShaderProgram : public Magnum::GL::AbstractShaderProgram {
+ public:
+  /**
+   * @brief Set the directory program binaries are cached in
+   *
+   * Applies to all programs linked afterwards in this process. Empty, the
+   * default, disables the cache.
+   */
+  static void setCacheDirectory(const std::string& directory);
+
+  /** @brief Directory program binaries are cached in */
+  static const std::string& cacheDirectory();
+
+ protected:
+  /**
+   * @brief Compile @p shaders, attach them and link
+   * @return Whether the program was linked or loaded from the cache
+   *
+   * Shaders are only compiled if there is no valid binary of them in the
+   * cache. Use in place of @ref Magnum::GL::Shader::compile(),
+   * @ref attachShaders() and @ref link().
+   */
+  bool compileAndLink(
+      std::initializer_list<Corrade::Containers::Reference<Magnum::GL::Shader>>
+          shaders);
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,123 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ContextPool.h"
+
+#include <Corrade/Utility/Assert.h>
+
+namespace esp {
+namespace gfx {
+
+ContextPool& ContextPool::instance() {
+  static ContextPool pool;
+  return pool;
+}
+
+const std::vector<int>& ContextPool::devicesLocked() const {
+  if (!devicesQueried_) {
+    devices_ = WindowlessContext::availableDevices();
+    devicesQueried_ = true;
+  }
+  return devices_;
+}
+
+std::vector<int> ContextPool::devices() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return devicesLocked();
+}
+
+void ContextPool::setDevices(const std::vector<int>& devices) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  devices_ = devices;
+  devicesQueried_ = !devices.empty();
+  nextDevice_ = 0;
+}
+
+int ContextPool::loadLocked(int gpuDevice) const {
+  auto found = contexts_.find(gpuDevice);
+  if (found == contexts_.end()) {
+    return 0;
+  }
+  int load = found->second.context.use_count() +
+             found->second.pendingAssignments;
+  for (const auto& shared : found->second.sharedContexts) {
+    load += shared.use_count();
+  }
+  return load;
+}
+
+int ContextPool::load(int gpuDevice) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return loadLocked(gpuDevice);
+}
+
+int ContextPool::assignDevice(
+    Assignment assignment /* = Assignment::LeastLoaded */) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  const std::vector<int>& devices = devicesLocked();
+  CORRADE_ASSERT(!devices.empty(),
+                 "ContextPool::assignDevice(): no GPU devices available", 0);
+
+  int device = devices[nextDevice_ % devices.size()];
+  if (assignment == Assignment::LeastLoaded) {
+    // ties go round-robin, so an idle pool still uses every device
+    int leastLoad = loadLocked(device);
+    for (std::size_t i = 1; i != devices.size(); ++i) {
+      const int candidate = devices[(nextDevice_ + i) % devices.size()];
+      const int load = loadLocked(candidate);
+      if (load < leastLoad) {
+        device = candidate;
+        leastLoad = load;
+      }
+    }
+  }
+  ++nextDevice_;
+  ++contexts_[device].pendingAssignments;
+  return device;
+}
+
+WindowlessContext::ptr ContextPool::acquire(int gpuDevice) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Device& entry = contexts_[gpuDevice];
+  if (entry.pendingAssignments > 0) {
+    --entry.pendingAssignments;
+  }
+  WindowlessContext::ptr context = entry.context.lock();
+  if (context) {
+    context->makeCurrent();
+  } else {
+    // made current by the constructor
+    context = WindowlessContext::create(gpuDevice);
+    entry.context = context;
+  }
+  return context;
+}
+
+WindowlessContext::ptr ContextPool::createShared(int gpuDevice) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Device& entry = contexts_[gpuDevice];
+  if (entry.pendingAssignments > 0) {
+    --entry.pendingAssignments;
+  }
+  WindowlessContext::ptr shareWith;
+  for (auto it = entry.sharedContexts.begin();
+       it != entry.sharedContexts.end();) {
+    WindowlessContext::ptr live = it->lock();
+    if (!live) {
+      it = entry.sharedContexts.erase(it);
+    } else {
+      if (!shareWith) {
+        shareWith = std::move(live);
+      }
+      ++it;
+    }
+  }
+  WindowlessContext::ptr context =
+      WindowlessContext::create(gpuDevice, true, shareWith.get());
+  entry.sharedContexts.push_back(context);
+  return context;
+}
+
+}  // namespace gfx
+}  // namespace esp
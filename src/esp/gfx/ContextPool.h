@@ -0,0 +1,123 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "esp/core/esp.h"
+#include "esp/gfx/WindowlessContext.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Process-wide pool of GL contexts, one per GPU device
+ *
+ * Lets a single process render on all visible GPUs. Every simulator using a
+ * device through @ref acquire() shares the one context of that device
+ * instead of creating its own. @ref assignDevice() spreads simulators over
+ * the devices.
+ *
+ * A context can be current in only one thread at a time, so everything using
+ * the context of a device has to run in the same thread. @ref RenderExecutor
+ * provides such a thread per device. Simulators on separate threads instead
+ * each get their own context through @ref createShared(), sharing the
+ * uploaded meshes and textures with the other shared contexts of the device.
+ *
+ * Thread-safe.
+ */
+class ContextPool {
+ public:
+  /** @brief How @ref assignDevice() picks a device */
+  enum class Assignment : uint8_t {
+    /** Each device in turn */
+    RoundRobin,
+    /** The device whose context has the fewest users */
+    LeastLoaded,
+  };
+
+  /** @brief The pool of this process */
+  static ContextPool& instance();
+
+  ContextPool(const ContextPool&) = delete;
+  ContextPool& operator=(const ContextPool&) = delete;
+
+  /**
+   * @brief CUDA IDs of the devices of the pool
+   *
+   * All devices of @ref WindowlessContext::availableDevices() unless
+   * restricted with @ref setDevices().
+   */
+  std::vector<int> devices() const;
+
+  /**
+   * @brief Restrict the devices @ref assignDevice() picks from
+   *
+   * Empty uses all available devices. Contexts already created are kept.
+   */
+  void setDevices(const std::vector<int>& devices);
+
+  /**
+   * @brief Pick a device for a new user of the pool
+   *
+   * The pick counts toward the load of the device until the next
+   * @ref acquire() or @ref createShared() of it, so several simulators
+   * assigned in a row before any of them is created are still spread over
+   * the devices.
+   */
+  int assignDevice(Assignment assignment = Assignment::LeastLoaded);
+
+  /**
+   * @brief Context of @p gpuDevice, created if nothing holds it
+   *
+   * The context is current in the calling thread afterwards and destroyed
+   * once the last returned pointer is released.
+   */
+  WindowlessContext::ptr acquire(int gpuDevice);
+
+  /**
+   * @brief New context on @p gpuDevice, shared with the other contexts this
+   *    returned for the device
+   *
+   * See @ref WindowlessContext::isShared(). The context is current in the
+   * calling thread afterwards, and is for the calling thread alone.
+   */
+  WindowlessContext::ptr createShared(int gpuDevice);
+
+  /**
+   * @brief Load of @p gpuDevice
+   *
+   * Number of holders of its context and of the shared contexts on it plus
+   * the assignments not acquired yet.
+   */
+  int load(int gpuDevice) const;
+
+ private:
+  ContextPool() = default;
+
+  struct Device {
+    std::weak_ptr<WindowlessContext> context;
+    // any live one is joined by a new shared context
+    std::vector<std::weak_ptr<WindowlessContext>> sharedContexts;
+    int pendingAssignments = 0;
+  };
+
+  // expects mutex_ to be locked
+  const std::vector<int>& devicesLocked() const;
+  int loadLocked(int gpuDevice) const;
+
+  mutable std::mutex mutex_;
+  // queried on first use, EGL may not be loaded before
+  mutable std::vector<int> devices_;
+  mutable bool devicesQueried_ = false;
+  std::size_t nextDevice_ = 0;
+  std::map<int, Device> contexts_;
+};
+
+}  // namespace gfx
+}  // namespace esp
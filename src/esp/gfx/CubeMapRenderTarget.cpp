@@ -0,0 +1,148 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Color.h>
+
+#include "CubeMapRenderTarget.h"
+#include "magnum.h"
+
+#include "esp/gfx/EquirectangularShader.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+constexpr int FaceCount = 6;
+
+const Mn::GL::Framebuffer::ColorAttachment RgbaBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{0};
+const Mn::GL::Framebuffer::ColorAttachment ObjectIdBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{1};
+
+const Mn::GL::CubeMapCoordinate Faces[FaceCount]{
+    Mn::GL::CubeMapCoordinate::PositiveX, Mn::GL::CubeMapCoordinate::NegativeX,
+    Mn::GL::CubeMapCoordinate::PositiveY, Mn::GL::CubeMapCoordinate::NegativeY,
+    Mn::GL::CubeMapCoordinate::PositiveZ, Mn::GL::CubeMapCoordinate::NegativeZ};
+}  // namespace
+
+struct CubeMapRenderTarget::Impl {
+  Impl(int size, EquirectangularShader* equirectangularShader)
+      : size_{size}, equirectangularShader_{equirectangularShader} {
+    CORRADE_INTERNAL_ASSERT(equirectangularShader_ != nullptr);
+    const Mn::Vector2i faceSize{size};
+
+    // color is filtered when resampled, the other results aren't
+    color_.setMinificationFilter(Mn::GL::SamplerFilter::Linear)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Linear)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::RGBA8, faceSize);
+    objectId_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::R32UI, faceSize);
+    depth_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, faceSize);
+
+    for (int face = 0; face != FaceCount; ++face) {
+      Mn::GL::Framebuffer framebuffer{{{}, faceSize}};
+      framebuffer.attachCubeMapTexture(RgbaBuffer, color_, Faces[face], 0)
+          .attachCubeMapTexture(ObjectIdBuffer, objectId_, Faces[face], 0)
+          .attachCubeMapTexture(Mn::GL::Framebuffer::BufferAttachment::Depth,
+                                depth_, Faces[face], 0)
+          .mapForDraw({{0, RgbaBuffer}, {1, ObjectIdBuffer}});
+      CORRADE_INTERNAL_ASSERT(
+          framebuffer.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+          Mn::GL::Framebuffer::Status::Complete);
+      faces_[face] = std::move(framebuffer);
+    }
+
+    mesh_.setCount(3);
+  }
+
+  int size() const { return size_; }
+
+  void renderEnter() {
+    for (Mn::GL::Framebuffer& framebuffer : faces_) {
+      framebuffer.clearDepth(1.0);
+      framebuffer.clearColor(0, Mn::Color4{0, 0, 0, 1});
+      framebuffer.clearColor(1, Mn::Vector4ui{});
+    }
+  }
+
+  void renderExit() {}
+
+  void bindFace(int face) {
+    CORRADE_ASSERT(face >= 0 && face < FaceCount,
+                   "CubeMapRenderTarget::bindFace(): face index"
+                       << face << "out of range", );
+    faces_[face].bind();
+  }
+
+  void drawEquirectangular(const Mn::Vector2& depthUnprojection,
+                           const Mn::Vector2i& viewportSize) {
+    // every fragment writes its depth, including the cleared value where
+    // nothing was drawn, so it mustn't be tested against the cleared buffer
+    Mn::GL::Renderer::setDepthFunction(
+        Mn::GL::Renderer::DepthFunction::Always);
+    (*equirectangularShader_)
+        .bindColorTexture(color_)
+        .bindObjectIdTexture(objectId_)
+        .bindDepthTexture(depth_)
+        .setDepthUnprojection(depthUnprojection)
+        .setViewportSize(viewportSize)
+        .draw(mesh_);
+    Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Less);
+  }
+
+ private:
+  int size_;
+  EquirectangularShader* equirectangularShader_;
+  Mn::GL::CubeMapTexture color_;
+  Mn::GL::CubeMapTexture objectId_;
+  Mn::GL::CubeMapTexture depth_;
+  Mn::GL::Framebuffer faces_[FaceCount]{
+      Mn::GL::Framebuffer{Mn::NoCreate}, Mn::GL::Framebuffer{Mn::NoCreate},
+      Mn::GL::Framebuffer{Mn::NoCreate}, Mn::GL::Framebuffer{Mn::NoCreate},
+      Mn::GL::Framebuffer{Mn::NoCreate}, Mn::GL::Framebuffer{Mn::NoCreate}};
+  Mn::GL::Mesh mesh_;
+};
+
+CubeMapRenderTarget::CubeMapRenderTarget(
+    int size,
+    EquirectangularShader* equirectangularShader)
+    : pimpl_(spimpl::make_unique_impl<Impl>(size, equirectangularShader)) {}
+
+int CubeMapRenderTarget::size() const {
+  return pimpl_->size();
+}
+
+void CubeMapRenderTarget::renderEnter() {
+  pimpl_->renderEnter();
+}
+
+void CubeMapRenderTarget::renderExit() {
+  pimpl_->renderExit();
+}
+
+void CubeMapRenderTarget::bindFace(int face) {
+  pimpl_->bindFace(face);
+}
+
+void CubeMapRenderTarget::drawEquirectangular(
+    const Mn::Vector2& depthUnprojection,
+    const Mn::Vector2i& viewportSize) {
+  pimpl_->drawEquirectangular(depthUnprojection, viewportSize);
+}
+
+}  // namespace gfx
+}  // namespace esp
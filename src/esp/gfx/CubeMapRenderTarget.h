@@ -0,0 +1,77 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/Magnum.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+class EquirectangularShader;
+
+/**
+ * Holds the color, depth and object ID cube maps of a panoramic view, with a
+ * framebuffer for each face, and resamples them into other render targets.
+ *
+ * Faces are drawn with @ref RenderCamera::drawCubeMap(), see @ref
+ * Renderer::drawCubeMap().
+ */
+class CubeMapRenderTarget {
+ public:
+  /**
+   * @brief Constructor
+   * @param size                   Edge length of the square faces, in
+   *                               pixels
+   * @param equirectangularShader  Shader used by @ref drawEquirectangular(),
+   *                               must outlive this instance
+   */
+  CubeMapRenderTarget(int size, EquirectangularShader* equirectangularShader);
+
+  /** @brief Edge length of the faces */
+  int size() const;
+
+  /**
+   * @brief Called before the faces are drawn
+   * Clears all faces
+   */
+  void renderEnter();
+
+  /**
+   * @brief Called after the faces are drawn
+   */
+  void renderExit();
+
+  /**
+   * @brief Bind the framebuffer of a face, in the order of the GL cube map
+   * face targets (+X, -X, +Y, -Y, +Z, -Z)
+   */
+  void bindFace(int face);
+
+  /**
+   * @brief Resample the cube maps into the currently bound framebuffer as an
+   * equirectangular panorama
+   * @param depthUnprojection  Depth unprojection parameters of the faces, also
+   *                           used to write the depth of the panorama
+   * @param viewportSize       Size of the viewport the panorama covers
+   *
+   * Writes color to the first and object IDs to the second color output,
+   * like the drawables do, and depth as the distance along the view ray. See
+   * @ref EquirectangularShader.
+   */
+  void drawEquirectangular(const Magnum::Vector2& depthUnprojection,
+                           const Magnum::Vector2i& viewportSize);
+
+  // @brief Delete copy Constructor
+  CubeMapRenderTarget(const CubeMapRenderTarget&) = delete;
+  // @brief Delete copy operator
+  CubeMapRenderTarget& operator=(const CubeMapRenderTarget&) = delete;
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(CubeMapRenderTarget)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,173 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "CullingBVH.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <Magnum/Math/Functions.h>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+FrustumTestResult testRangeFrustum(const Mn::Range3D& range,
+                                   const Mn::Frustum& frustum,
+                                   int& frustumPlaneIndex) {
+  // both are doubled, which is compensated for by doubling the plane distance
+  const Mn::Vector3 center = range.min() + range.max();
+  const Mn::Vector3 extent = range.max() - range.min();
+
+  bool inside = true;
+  for (int iPlane = 0; iPlane < 6; ++iPlane) {
+    const int index = (iPlane + frustumPlaneIndex) % 6;
+    const Mn::Vector4& plane = frustum[index];
+
+    const Mn::Vector3 absPlaneNormal = Mn::Math::abs(plane.xyz());
+
+    const float d = Mn::Math::dot(center, plane.xyz());
+    const float r = Mn::Math::dot(extent, absPlaneNormal);
+    if (d + r < -2.0f * plane.w()) {
+      frustumPlaneIndex = index;
+      return FrustumTestResult::Outside;
+    }
+    if (d - r < -2.0f * plane.w()) {
+      inside = false;
+    }
+  }
+
+  return inside ? FrustumTestResult::Inside : FrustumTestResult::Intersecting;
+}
+
+void CullingBVH::build(const std::vector<Mn::Range3D>& boxes) {
+  clear();
+  if (boxes.empty()) {
+    return;
+  }
+
+  std::vector<Mn::Vector3> centers;
+  centers.reserve(boxes.size());
+  for (const Mn::Range3D& box : boxes) {
+    centers.push_back(box.center());
+  }
+
+  indices_.resize(boxes.size());
+  std::iota(indices_.begin(), indices_.end(), 0);
+  // a binary tree with at most LEAF_SIZE boxes per leaf
+  nodes_.reserve(2 * (boxes.size() / LEAF_SIZE + 1));
+  nodes_.emplace_back();
+  buildRecursive(0, boxes, centers, 0, boxes.size());
+
+  for (Node& node : nodes_) {
+    if (node.count == 0) {
+      continue;
+    }
+    BoxPack pack{};
+    for (int i = 0; i < node.count; ++i) {
+      const Mn::Range3D& box = boxes[indices_[node.first + i]];
+      for (int a = 0; a < 3; ++a) {
+        pack.center[a][i] = box.min()[a] + box.max()[a];
+        pack.extent[a][i] = box.max()[a] - box.min()[a];
+      }
+    }
+    node.pack = packs_.size();
+    packs_.push_back(pack);
+  }
+}
+
+void CullingBVH::clear() {
+  nodes_.clear();
+  indices_.clear();
+  packs_.clear();
+}
+
+uint32_t CullingBVH::cullPack(const Node& node,
+                              const Mn::Frustum& frustum,
+                              int& planeIndex) const {
+  const BoxPack& pack = packs_[node.pack];
+  const uint32_t all = (1u << node.count) - 1;
+  uint32_t outside = 0;
+  for (int iPlane = 0; iPlane < 6; ++iPlane) {
+    const int index = (iPlane + planeIndex) % 6;
+    const Mn::Vector4& plane = frustum[index];
+    const float nx = plane.x(), ny = plane.y(), nz = plane.z();
+    const float ax = Mn::Math::abs(nx), ay = Mn::Math::abs(ny),
+                az = Mn::Math::abs(nz);
+    const float w = -2.0f * plane.w();
+    bool planeOutside[LEAF_SIZE];
+#pragma omp simd
+    for (int i = 0; i < LEAF_SIZE; ++i) {
+      const float d = pack.center[0][i] * nx + pack.center[1][i] * ny +
+                      pack.center[2][i] * nz;
+      const float r = pack.extent[0][i] * ax + pack.extent[1][i] * ay +
+                      pack.extent[2][i] * az;
+      planeOutside[i] = d + r < w;
+    }
+    uint32_t culled = 0;
+    for (int i = 0; i < LEAF_SIZE; ++i) {
+      culled |= uint32_t(planeOutside[i]) << i;
+    }
+    culled &= all & ~outside;
+    if (culled && outside == 0) {
+      planeIndex = index;
+    }
+    outside |= culled;
+    if (outside == all) {
+      break;
+    }
+  }
+  return all & ~outside;
+}
+
+void CullingBVH::buildRecursive(int nodeIndex,
+                                const std::vector<Mn::Range3D>& boxes,
+                                const std::vector<Mn::Vector3>& centers,
+                                int begin,
+                                int end) {
+  Mn::Range3D box = boxes[indices_[begin]];
+  Mn::Range3D centerBounds{centers[indices_[begin]], centers[indices_[begin]]};
+  for (int i = begin + 1; i < end; ++i) {
+    box = Mn::Math::join(box, boxes[indices_[i]]);
+    const Mn::Vector3& center = centers[indices_[i]];
+    centerBounds = {Mn::Math::min(centerBounds.min(), center),
+                    Mn::Math::max(centerBounds.max(), center)};
+  }
+  nodes_[nodeIndex].box = box;
+
+  if (end - begin <= LEAF_SIZE) {
+    nodes_[nodeIndex].first = begin;
+    nodes_[nodeIndex].count = end - begin;
+    return;
+  }
+
+  // median split along the longest axis of the box centers
+  const Mn::Vector3 size = centerBounds.size();
+  int axis = 0;
+  if (size[1] > size[axis]) {
+    axis = 1;
+  }
+  if (size[2] > size[axis]) {
+    axis = 2;
+  }
+  const int middle = begin + (end - begin) / 2;
+  std::nth_element(indices_.begin() + begin, indices_.begin() + middle,
+                   indices_.begin() + end, [&](int a, int b) {
+                     return centers[a][axis] < centers[b][axis];
+                   });
+
+  // children are stored next to each other, nodes_ may reallocate here so
+  // don't keep references across the recursion
+  const int left = nodes_.size();
+  nodes_.emplace_back();
+  nodes_.emplace_back();
+  nodes_[nodeIndex].first = left;
+  nodes_[nodeIndex].count = 0;
+  buildRecursive(left, boxes, centers, begin, middle);
+  buildRecursive(left + 1, boxes, centers, middle, end);
+}
+
+}  // namespace gfx
+}  // namespace esp
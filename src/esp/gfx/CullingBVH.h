@@ -0,0 +1,252 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Result of testing an axis-aligned box against a frustum
+ */
+enum class FrustumTestResult {
+  /** @brief The box is completely outside of the frustum */
+  Outside = 0,
+  /** @brief The box intersects at least one of the frustum planes */
+  Intersecting = 1,
+  /** @brief The box is completely inside of the frustum */
+  Inside = 2,
+};
+
+/**
+ * @brief Test an axis-aligned box against a frustum
+ *
+ * @param range             The axis-aligned bounding box
+ * @param frustum           The frustum
+ * @param[in, out] frustumPlaneIndex  The plane tested first. If the box is
+ *                          outside, it is set to the plane that culled it so
+ *                          the next frame can start there (temporal coherence)
+ */
+FrustumTestResult testRangeFrustum(const Magnum::Range3D& range,
+                                   const Magnum::Frustum& frustum,
+                                   int& frustumPlaneIndex);
+
+/**
+ * @brief Bounding volume hierarchy over static world-space boxes, used for
+ * hierarchical frustum culling
+ *
+ * Built top-down by median split along the longest axis of the box centers.
+ * Subtrees outside the frustum are skipped, subtrees completely inside are
+ * accepted without testing their leaves, and every node remembers the plane
+ * that culled it last time. The boxes of a leaf are stored as a pack of
+ * @ref LEAF_SIZE centers and extents in a structure-of-arrays layout, so a
+ * leaf straddling the frustum tests all of them against a plane in one
+ * vectorized loop, and stops as soon as every box is outside.
+ */
+class CullingBVH {
+ public:
+  /**
+   * @brief Build the hierarchy
+   * @param boxes World-space boxes. The index of a box in this list is what
+   *              @ref cull() reports for it
+   */
+  void build(const std::vector<Magnum::Range3D>& boxes);
+
+  /**
+   * @brief Remove all boxes
+   */
+  void clear();
+
+  /**
+   * @brief Number of boxes in the hierarchy
+   */
+  size_t size() const { return indices_.size(); }
+
+  /**
+   * @brief Call @p visible with the index of every box that is not
+   * completely outside the frustum
+   */
+  template <typename Callable>
+  void cull(const Magnum::Frustum& frustum, Callable&& visible);
+
+  /**
+   * @brief Like @ref cull(const Magnum::Frustum&, Callable&&), but keeping
+   * the planes that culled the nodes last time in @p planeIndices
+   *
+   * Doesn't modify the hierarchy, so several threads can cull it at the same
+   * time, each with its own @p planeIndices. These are resized to the
+   * hierarchy and should be kept for the next cull of the same view.
+   */
+  template <typename Callable>
+  void cull(const Magnum::Frustum& frustum,
+            Callable&& visible,
+            std::vector<int>& planeIndices) const;
+
+  /**
+   * @brief Maximum number of boxes stored in a leaf
+   *
+   * One AVX register of floats, two SSE or NEON ones.
+   */
+  static constexpr int LEAF_SIZE = 8;
+
+ protected:
+  struct Node {
+    Magnum::Range3D box;
+    // for a leaf, the range [first, first + count) in indices_; for an inner
+    // node first is the index of the left child, the right one follows it
+    int first = 0;
+    int count = 0;
+    int frustumPlaneIndex = 0;
+    // for a leaf, the index of its boxes in packs_ and the plane that culled
+    // some of them first last time
+    int pack = 0;
+    int packPlaneIndex = 0;
+  };
+
+  // centers and extents of the boxes of a leaf, both doubled as in
+  // testRangeFrustum(). Unused lanes are zero and their result is ignored.
+  struct BoxPack {
+    float center[3][LEAF_SIZE];
+    float extent[3][LEAF_SIZE];
+  };
+
+  // bit i is set if box i of the leaf's pack is not outside the frustum
+  uint32_t cullPack(const Node& node,
+                    const Magnum::Frustum& frustum,
+                    int& planeIndex) const;
+
+  // planeIndex(node, pack) is the coherence index of the node's box, or of
+  // the boxes of its pack
+  template <typename Callable, typename PlaneIndex>
+  void cullNodes(const Magnum::Frustum& frustum,
+                 Callable& visible,
+                 PlaneIndex&& planeIndex) const;
+
+  void buildRecursive(int nodeIndex,
+                      const std::vector<Magnum::Range3D>& boxes,
+                      const std::vector<Magnum::Vector3>& centers,
+                      int begin,
+                      int end);
+
+  template <typename Callable>
+  void acceptSubtree(const Node& node, Callable& visible) const;
+
+  std::vector<Node> nodes_;
+  // box indices, reordered so that each leaf references a contiguous range
+  std::vector<int> indices_;
+  // the boxes of each leaf, in the order of indices_
+  std::vector<BoxPack> packs_;
+
+  ESP_SMART_POINTERS(CullingBVH)
+};
+
+class DrawableGroup;
+
+/**
+ * @brief Frustum culling results of one view, computed ahead of its draw
+ *
+ * Filled by @ref Renderer::cullAhead() and consumed by the view's next draw.
+ * Every sensor has its own instance, so the planes that culled the nodes of
+ * the shared hierarchies stay coherent for each view.
+ */
+struct CullingResults {
+  struct Group {
+    DrawableGroup* group = nullptr;
+    //! @ref DrawableGroup::cullingDataVersion() the results are for
+    std::size_t cullingDataVersion = 0;
+    //! indices of the boxes inside the frustum, see @ref CullingBVH::cull()
+    std::vector<int> visible;
+    std::vector<int> planeIndices;
+  };
+
+  //! one for each drawable group of the view's scene graph
+  std::vector<Group> groups;
+  //! projection and camera matrix of the view that was culled
+  Magnum::Matrix4 viewProjection;
+  //! whether the results are for the next draw
+  bool pending = false;
+
+  ESP_SMART_POINTERS(CullingResults)
+};
+
+template <typename Callable>
+void CullingBVH::cull(const Magnum::Frustum& frustum, Callable&& visible) {
+  cullNodes(frustum, visible, [this](int node, bool pack) -> int& {
+    return pack ? nodes_[node].packPlaneIndex
+                : nodes_[node].frustumPlaneIndex;
+  });
+}
+
+template <typename Callable>
+void CullingBVH::cull(const Magnum::Frustum& frustum,
+                      Callable&& visible,
+                      std::vector<int>& planeIndices) const {
+  planeIndices.resize(2 * nodes_.size());
+  cullNodes(frustum, visible, [&planeIndices](int node, bool pack) -> int& {
+    return planeIndices[2 * node + pack];
+  });
+}
+
+template <typename Callable, typename PlaneIndex>
+void CullingBVH::cullNodes(const Magnum::Frustum& frustum,
+                           Callable& visible,
+                           PlaneIndex&& planeIndex) const {
+  if (nodes_.empty()) {
+    return;
+  }
+  std::vector<int> stack{0};
+  while (!stack.empty()) {
+    const int nodeIndex = stack.back();
+    const Node& node = nodes_[nodeIndex];
+    stack.pop_back();
+
+    const FrustumTestResult result =
+        testRangeFrustum(node.box, frustum, planeIndex(nodeIndex, false));
+    if (result == FrustumTestResult::Outside) {
+      continue;
+    }
+    if (result == FrustumTestResult::Inside) {
+      acceptSubtree(node, visible);
+      continue;
+    }
+    if (node.count > 0) {
+      // leaf straddling the frustum, test its boxes all at once
+      const uint32_t mask =
+          cullPack(node, frustum, planeIndex(nodeIndex, true));
+      for (int i = 0; i < node.count; ++i) {
+        if (mask & (1u << i)) {
+          visible(indices_[node.first + i]);
+        }
+      }
+      continue;
+    }
+    stack.push_back(node.first + 1);
+    stack.push_back(node.first);
+  }
+}
+
+template <typename Callable>
+void CullingBVH::acceptSubtree(const Node& node, Callable& visible) const {
+  if (node.count > 0) {
+    for (int i = node.first; i < node.first + node.count; ++i) {
+      visible(indices_[i]);
+    }
+    return;
+  }
+  acceptSubtree(nodes_[node.first], visible);
+  acceptSubtree(nodes_[node.first + 1], visible);
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -4,6 +4,10 @@
 
 #include "DepthUnprojection.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Utility/Resource.h>
@@ -12,6 +16,21 @@
 #include <Magnum/GL/Version.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Math/Vector3.h>
+
+/* x86-64 always has SSE2, AVX is picked at runtime. 32-bit ARM NEON doesn't
+   have a division. */
+#if defined(CORRADE_TARGET_X86) && (defined(__SSE2__) || defined(_M_X64))
+#include <immintrin.h>
+#define ESP_UNPROJECT_DEPTH_SSE2
+#if defined(__GNUC__)
+#define ESP_UNPROJECT_DEPTH_AVX
+#endif
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define ESP_UNPROJECT_DEPTH_NEON
+#endif
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -24,7 +43,7 @@ namespace esp {
 namespace gfx {
 
 namespace {
-enum { DepthTextureUnit = 1 };
+enum { DepthTextureUnit = 1, NoiseModelTextureUnit = 2 };
 }
 
 DepthShader::DepthShader(Flags flags) : flags_{flags} {
@@ -51,19 +70,39 @@ DepthShader::DepthShader(Flags flags) : flags_{flags} {
   if (flags & Flag::NoFarPlanePatching)
     frag.addSource("#define NO_FAR_PLANE_PATCHING\n");
 
-  vert.addSource(rs.get("depth.vert"));
-  frag.addSource(rs.get("depth.frag"));
+  if (flags & Flag::RedwoodNoise) {
+    CORRADE_INTERNAL_ASSERT(flags & Flag::UnprojectExistingDepth);
+    frag.addSource("#define REDWOOD_NOISE\n");
+  }
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(Mn::GL::Shader::compile({vert, frag}));
+  if (flags & Flag::UnprojectToPoints) {
+    CORRADE_INTERNAL_ASSERT(flags & Flag::UnprojectExistingDepth);
+    frag.addSource("#define POINTS\n");
+  }
 
-  attachShaders({vert, frag});
+  vert.addSource(rs.get("depth.vert"));
+  frag.addSource(rs.get("depth.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
 
   if (flags & Flag::UnprojectExistingDepth) {
     projectionMatrixOrDepthUnprojectionUniform_ =
         uniformLocation("depthUnprojection");
     setUniform(uniformLocation("depthTexture"), DepthTextureUnit);
+    if (flags & Flag::RedwoodNoise) {
+      noiseMultiplierUniform_ = uniformLocation("noiseMultiplier");
+      noiseSeedUniform_ = uniformLocation("noiseSeed");
+      setUniform(uniformLocation("noiseModel"), NoiseModelTextureUnit);
+    }
+    if (flags & Flag::UnprojectToPoints) {
+      pointUnprojectionUniform_ = uniformLocation("pointUnprojection");
+      pointViewportUniform_ = uniformLocation("pointViewport");
+      pointTransformationUniform_ = uniformLocation("pointTransformation");
+      setUniform(pointTransformationUniform_, Mn::Matrix4{});
+    } else {
+      depthScaleUniform_ = uniformLocation("depthScale");
+      setUniform(depthScaleUniform_, 1.0f);
+    }
   } else {
     transformationMatrixUniform_ = uniformLocation("transformationMatrix");
     projectionMatrixOrDepthUnprojectionUniform_ =
@@ -78,6 +117,36 @@ DepthShader& DepthShader::setDepthUnprojection(
   return *this;
 }
 
+DepthShader& DepthShader::setDepthScale(float scale) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::UnprojectExistingDepth);
+  if (!(flags_ & Flag::UnprojectToPoints)) {
+    setUniform(depthScaleUniform_, scale);
+  }
+  return *this;
+}
+
+DepthShader& DepthShader::setPointUnprojection(
+    const Mn::Vector2& unprojection) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::UnprojectToPoints);
+  setUniform(pointUnprojectionUniform_, unprojection);
+  return *this;
+}
+
+DepthShader& DepthShader::setPointViewport(const Mn::Range2Di& viewport) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::UnprojectToPoints);
+  setUniform(pointViewportUniform_,
+             Mn::Vector4{Mn::Vector2{viewport.min()},
+                         Mn::Vector2{viewport.size()}});
+  return *this;
+}
+
+DepthShader& DepthShader::setPointTransformation(
+    const Mn::Matrix4& transformation) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::UnprojectToPoints);
+  setUniform(pointTransformationUniform_, transformation);
+  return *this;
+}
+
 DepthShader& DepthShader::setTransformationMatrix(const Mn::Matrix4& matrix) {
   CORRADE_INTERNAL_ASSERT(!(flags_ & Flag::UnprojectExistingDepth));
   setUniform(transformationMatrixUniform_, matrix);
@@ -99,32 +168,179 @@ DepthShader& DepthShader::bindDepthTexture(Mn::GL::Texture2D& texture) {
   return *this;
 }
 
+DepthShader& DepthShader::bindNoiseModelTexture(Mn::GL::Texture2D& texture) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::RedwoodNoise);
+  texture.bind(NoiseModelTextureUnit);
+  return *this;
+}
+
+DepthShader& DepthShader::setNoiseMultiplier(float multiplier) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::RedwoodNoise);
+  setUniform(noiseMultiplierUniform_, multiplier);
+  return *this;
+}
+
+DepthShader& DepthShader::setNoiseSeed(Mn::UnsignedInt seed) {
+  CORRADE_INTERNAL_ASSERT(flags_ & Flag::RedwoodNoise);
+  setUniform(noiseSeedUniform_, seed);
+  return *this;
+}
+
 Mn::Vector2 calculateDepthUnprojection(const Mn::Matrix4& projectionMatrix) {
   return Mn::Vector2{(projectionMatrix[2][2] - 1.0f), projectionMatrix[3][2]} *
          0.5f;
 }
 
-/* Clang doesn't have target_clones yet: https://reviews.llvm.org/D51650 */
-#if defined(CORRADE_TARGET_X86) && defined(__GNUC__) && __GNUC__ >= 6
-__attribute__((target_clones("default", "sse4.2", "avx2")))
+namespace {
+/* Unprojects and zeroes pixels on the far plane in a single pass. The
+   comparison is against the unprojected far plane as in the scalar code, so
+   all variants are bit-exact. We can afford using == there as 1.0f has an
+   exact representation, the depth was cleared to exactly this value and the
+   calculation is done exactly the same way in both cases. */
+void unprojectDepthScalar(float a, float b, float farDepth, float* depth,
+                          std::size_t count) {
+  for (std::size_t i = 0; i != count; ++i) {
+    const float d = b / (depth[i] + a);
+    depth[i] = d == farDepth ? 0.0f : d;
+  }
+}
+
+#ifdef ESP_UNPROJECT_DEPTH_AVX
+__attribute__((target("avx"))) void unprojectDepthAvx(float a,
+                                                      float b,
+                                                      float farDepth,
+                                                      float* depth,
+                                                      std::size_t count) {
+  const __m256 va = _mm256_set1_ps(a);
+  const __m256 vb = _mm256_set1_ps(b);
+  const __m256 vfar = _mm256_set1_ps(farDepth);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 d =
+        _mm256_div_ps(vb, _mm256_add_ps(_mm256_loadu_ps(depth + i), va));
+    _mm256_storeu_ps(
+        depth + i, _mm256_andnot_ps(_mm256_cmp_ps(d, vfar, _CMP_EQ_OQ), d));
+  }
+  unprojectDepthScalar(a, b, farDepth, depth + i, count - i);
+}
+#endif
+
+#ifdef ESP_UNPROJECT_DEPTH_SSE2
+void unprojectDepthSse2(float a,
+                        float b,
+                        float farDepth,
+                        float* depth,
+                        std::size_t count) {
+  const __m128 va = _mm_set1_ps(a);
+  const __m128 vb = _mm_set1_ps(b);
+  const __m128 vfar = _mm_set1_ps(farDepth);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 d = _mm_div_ps(vb, _mm_add_ps(_mm_loadu_ps(depth + i), va));
+    _mm_storeu_ps(depth + i, _mm_andnot_ps(_mm_cmpeq_ps(d, vfar), d));
+  }
+  unprojectDepthScalar(a, b, farDepth, depth + i, count - i);
+}
+#endif
+
+#ifdef ESP_UNPROJECT_DEPTH_NEON
+void unprojectDepthNeon(float a,
+                        float b,
+                        float farDepth,
+                        float* depth,
+                        std::size_t count) {
+  const float32x4_t va = vdupq_n_f32(a);
+  const float32x4_t vb = vdupq_n_f32(b);
+  const float32x4_t vfar = vdupq_n_f32(farDepth);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t d = vdivq_f32(vb, vaddq_f32(vld1q_f32(depth + i), va));
+    vst1q_f32(depth + i,
+              vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(d),
+                                              vceqq_f32(d, vfar))));
+  }
+  unprojectDepthScalar(a, b, farDepth, depth + i, count - i);
+}
 #endif
+
+typedef void (*UnprojectDepthKernel)(float, float, float, float*, std::size_t);
+
+UnprojectDepthKernel unprojectDepthKernel() {
+#ifdef ESP_UNPROJECT_DEPTH_AVX
+  if (__builtin_cpu_supports("avx"))
+    return unprojectDepthAvx;
+#endif
+#if defined(ESP_UNPROJECT_DEPTH_SSE2)
+  return unprojectDepthSse2;
+#elif defined(ESP_UNPROJECT_DEPTH_NEON)
+  return unprojectDepthNeon;
+#else
+  return unprojectDepthScalar;
+#endif
+}
+
+/* Large frames are split into blocks of rows for the threads, block
+   boundaries don't matter as every pixel is independent */
+constexpr std::size_t UnprojectDepthBlockSize = 16384;
+}  // namespace
+
 void unprojectDepth(const Mn::Vector2& unprojection,
                     Cr::Containers::ArrayView<Mn::Float> depth) {
-  for (Mn::Float& d : depth) {
-    d = unprojection[1] / (d + unprojection[0]);
+  static const UnprojectDepthKernel kernel = unprojectDepthKernel();
+  const float a = unprojection[0];
+  const float b = unprojection[1];
+  const float farDepth = b / (1.0f + a);
+
+  const std::ptrdiff_t blockCount =
+      (depth.size() + UnprojectDepthBlockSize - 1) / UnprojectDepthBlockSize;
+#pragma omp parallel for schedule(static) if (blockCount > 4)
+  for (std::ptrdiff_t block = 0; block < blockCount; ++block) {
+    const std::size_t begin = block * UnprojectDepthBlockSize;
+    kernel(a, b, farDepth, depth.data() + begin,
+           std::min(UnprojectDepthBlockSize, depth.size() - begin));
+  }
+}
+
+namespace {
+struct VoxelHash {
+  std::size_t operator()(const Mn::Vector3i& voxel) const {
+    // the usual large primes of spatial hashing
+    return std::size_t(voxel.x()) * 73856093u ^
+           std::size_t(voxel.y()) * 19349663u ^
+           std::size_t(voxel.z()) * 83492791u;
+  }
+};
+}  // namespace
+
+std::vector<Mn::Vector3> voxelDownsample(
+    Cr::Containers::ArrayView<const Mn::Vector3> points,
+    float voxelSize) {
+  CORRADE_ASSERT(voxelSize > 0.0f,
+                 "gfx::voxelDownsample(): expected a positive voxel size", {});
+
+  // sums and counts per voxel, indexed in the order of the first hit
+  std::unordered_map<Mn::Vector3i, std::size_t, VoxelHash> index;
+  std::vector<Mn::Vector3> sums;
+  std::vector<Mn::Float> counts;
+  for (const Mn::Vector3& point : points) {
+    if (std::isnan(point.x()) || std::isnan(point.y()) ||
+        std::isnan(point.z()))
+      continue;
+    const Mn::Vector3i voxel{Mn::Math::floor(point / voxelSize)};
+    auto inserted = index.emplace(voxel, sums.size());
+    if (inserted.second) {
+      sums.push_back(point);
+      counts.push_back(1.0f);
+    } else {
+      sums[inserted.first->second] += point;
+      counts[inserted.first->second] += 1.0f;
+    }
   }
 
-  /* Change pixels on the far plane to be 0. Done in a separate loop to allow
-     the optimizer to vectorize the above better.  */
-  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
-  for (Mn::Float& d : depth) {
-    /* We can afford using == for comparison as 1.0f has an exact
-       representation, the depth was cleared to exactly this value and the
-       calculation is done exactly the same way in both cases -- thus the
-       result should be bit-exact. */
-    if (d == farDepth)
-      d = 0.0f;
+  for (std::size_t i = 0; i != sums.size(); ++i) {
+    sums[i] /= counts[i];
   }
+  return sums;
 }
 
 }  // namespace gfx
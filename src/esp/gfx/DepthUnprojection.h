@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include <Corrade/Containers/EnumSet.h>
-#include <Magnum/GL/AbstractShaderProgram.h>
+
+#include "esp/gfx/CachedShaderProgram.h"
 
 namespace esp {
 namespace gfx {
@@ -17,7 +20,7 @@ Outputs depth values without projection applied. Can also unproject existing
 depth buffer if @ref Flag::UnprojectExistingDepth is enabled.
 @see @ref calculateDepthUnprojection(), @ref unprojectDepth()
 */
-class DepthShader : public Magnum::GL::AbstractShaderProgram {
+class DepthShader : public CachedShaderProgram {
  public:
   /** @brief Flag */
   enum class Flag {
@@ -36,7 +39,24 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
      * set to). This might have some performance penalty and can be turned off
      * with this flag.
      */
-    NoFarPlanePatching = 1 << 1
+    NoFarPlanePatching = 1 << 1,
+
+    /**
+     * Apply the Redwood depth noise model while unprojecting, the same model
+     * as @ref sensor::RedwoodNoiseModelCPUImpl. Expects that
+     * @ref Flag::UnprojectExistingDepth is set and a model is bound with
+     * @ref bindNoiseModelTexture().
+     */
+    RedwoodNoise = 1 << 2,
+
+    /**
+     * Output the unprojected depth as XYZ points instead, set up with
+     * @ref setPointUnprojection(), @ref setPointViewport() and
+     * @ref setPointTransformation(). Pixels without depth give NaN points.
+     * Expects that @ref Flag::UnprojectExistingDepth is set, the depth scale
+     * doesn't apply.
+     */
+    UnprojectToPoints = 1 << 3
   };
 
   /** @brief Flags */
@@ -59,6 +79,16 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
    */
   DepthShader& setDepthUnprojection(const Magnum::Vector2& depthUnprojection);
 
+  /**
+   * @brief Set the multiplier of the unprojected depth
+   * @return Reference to self (for method chaining)
+   *
+   * Applied after the noise, if any. Default is @cpp 1.0f @ce, giving the
+   * depth in the units of the projection. Expects that
+   * @ref Flag::UnprojectExistingDepth is set.
+   */
+  DepthShader& setDepthScale(float scale);
+
   /**
    * @brief Set projection matrix for unprojection
    * @return Reference to self (for method chaining)
@@ -73,6 +103,57 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
    */
   DepthShader& bindDepthTexture(Magnum::GL::Texture2D& texture);
 
+  /**
+   * @brief Bind the Redwood distortion model
+   * @return Reference to self (for method chaining)
+   *
+   * A @ref Magnum::GL::TextureFormat::R32F texture of 400x80 texels, the
+   * model in row-major order. Expects that @ref Flag::RedwoodNoise is set.
+   */
+  DepthShader& bindNoiseModelTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Set the multiplier for the Gaussian noise of the Redwood model
+   * @return Reference to self (for method chaining)
+   *
+   * Expects that @ref Flag::RedwoodNoise is set.
+   */
+  DepthShader& setNoiseMultiplier(float multiplier);
+
+  /**
+   * @brief Set the seed of the Redwood noise, should change every frame
+   * @return Reference to self (for method chaining)
+   *
+   * Expects that @ref Flag::RedwoodNoise is set.
+   */
+  DepthShader& setNoiseSeed(Magnum::UnsignedInt seed);
+
+  /**
+   * @brief Set the camera-space X and Y of a point at unit depth in the
+   * corner of the viewport
+   * @return Reference to self (for method chaining)
+   *
+   * The inverses of the first two diagonal elements of a symmetric
+   * perspective projection. Expects that @ref Flag::UnprojectToPoints is set.
+   */
+  DepthShader& setPointUnprojection(const Magnum::Vector2& unprojection);
+
+  /**
+   * @brief Set the viewport the projection covers
+   * @return Reference to self (for method chaining)
+   *
+   * Expects that @ref Flag::UnprojectToPoints is set.
+   */
+  DepthShader& setPointViewport(const Magnum::Range2Di& viewport);
+
+  /**
+   * @brief Set the transformation applied to the camera-space points
+   * @return Reference to self (for method chaining)
+   *
+   * Default is an identity. Expects that @ref Flag::UnprojectToPoints is set.
+   */
+  DepthShader& setPointTransformation(const Magnum::Matrix4& transformation);
+
   /**
    * @brief The flags passed to the Constructor
    */
@@ -81,6 +162,10 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
  private:
   const Flags flags_;
   int transformationMatrixUniform_, projectionMatrixOrDepthUnprojectionUniform_;
+  int depthScaleUniform_ = -1;
+  int noiseMultiplierUniform_ = -1, noiseSeedUniform_ = -1;
+  int pointUnprojectionUniform_ = -1, pointViewportUniform_ = -1,
+      pointTransformationUniform_ = -1;
 };
 
 CORRADE_ENUMSET_OPERATORS(DepthShader::Flags)
@@ -145,10 +230,26 @@ Magnum::Vector2 calculateDepthUnprojection(
 See @ref calculateDepthUnprojection() for the full algorithm explanation.
 Additionally to applying that calculation, if the input depth is at the far
 plane (of value @cpp 1.0f @ce), it's set to @cpp 0.0f @ce on output as
-consumers expect zeros for things that are too far.
+consumers expect zeros for things that are too far. Uses SSE2, AVX or NEON
+where available and splits large frames across OpenMP threads.
 */
 void unprojectDepth(const Magnum::Vector2& unprojection,
                     Corrade::Containers::ArrayView<Magnum::Float> depth);
 
+/**
+@brief Reduce a point cloud to one point per occupied voxel
+@param[in] points    Points, e.g. read with
+    @ref sensor::ObservationLayout::POINTS_WORLD. NaN points are skipped.
+@param[in] voxelSize Edge length of the cubic voxels, expected to be positive
+
+Each output point is the average of the input points inside one voxel of a
+grid aligned with the origin, in the order the voxels were first hit. The
+output size depends on the contents, which is why this runs on the CPU
+instead of as part of the sensor readback.
+*/
+std::vector<Magnum::Vector3> voxelDownsample(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> points,
+    float voxelSize);
+
 }  // namespace gfx
 }  // namespace esp
@@ -0,0 +1,31 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DeviceBuffer.h"
+
+#include <cuda_runtime.h>
+#include "helper_cuda.h"
+
+namespace esp {
+namespace gfx {
+
+DeviceBuffer::DeviceBuffer(const std::vector<size_t>& shape,
+                           core::DataType dataType)
+    : shape_{shape}, dataType_{dataType} {
+  byteSize_ = core::getDataTypeByteSize(dataType);
+  for (size_t extent : shape_) {
+    byteSize_ *= extent;
+  }
+  checkCudaErrors(cudaGetDevice(&deviceId_));
+  checkCudaErrors(cudaMalloc(&data_, byteSize_));
+}
+
+DeviceBuffer::~DeviceBuffer() {
+  if (data_ != nullptr) {
+    checkCudaErrors(cudaFree(data_));
+  }
+}
+
+}  // namespace gfx
+}  // namespace esp
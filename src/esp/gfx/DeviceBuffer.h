@@ -0,0 +1,65 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Dense array in CUDA device memory, the device-side counterpart of
+ * @ref core::Buffer
+ *
+ * Allocated on the current CUDA device and freed on destruction. Rendering
+ * results are read into these through @ref RenderTarget::readFrameToDevice(),
+ * which recycles them from a pool as long as nobody else holds a reference.
+ */
+class DeviceBuffer {
+ public:
+  /**
+   * @brief Constructor
+   * @param shape     Row-major shape of the array
+   * @param dataType  Type of the elements
+   */
+  explicit DeviceBuffer(const std::vector<size_t>& shape,
+                        core::DataType dataType);
+  ~DeviceBuffer();
+
+  // @brief Delete copy Constructor
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  // @brief Delete copy operator
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+
+  /** @brief Device pointer to the first element */
+  void* data() const { return data_; }
+
+  /** @brief Size of the array in bytes */
+  size_t byteSize() const { return byteSize_; }
+
+  /** @brief Row-major shape of the array */
+  const std::vector<size_t>& shape() const { return shape_; }
+
+  /** @brief Type of the elements */
+  core::DataType dataType() const { return dataType_; }
+
+  /** @brief CUDA device the memory is allocated on */
+  int deviceId() const { return deviceId_; }
+
+ protected:
+  void* data_ = nullptr;
+  size_t byteSize_ = 0;
+  std::vector<size_t> shape_;
+  core::DataType dataType_;
+  int deviceId_ = 0;
+
+  ESP_SMART_POINTERS(DeviceBuffer)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -5,6 +5,7 @@
 #include "Drawable.h"
 
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Mesh.h>
 
 #include "esp/scene/SceneNode.h"
 
@@ -14,7 +15,49 @@ namespace gfx {
 Drawable::Drawable(scene::SceneNode& node,
                    Magnum::GL::Mesh& mesh,
                    DrawableGroup* group /* = nullptr */)
-    : Magnum::SceneGraph::Drawable3D{node, group}, node_(node), mesh_(mesh) {}
+    : Magnum::SceneGraph::Drawable3D{node, group},
+      node_(node),
+      mesh_(mesh),
+      activeMesh_(&mesh) {
+  setCachedTransformations(Magnum::SceneGraph::CachedTransformation::Absolute);
+  // make sure the cache is filled before the first draw
+  node.setDirty();
+  if (group) {
+    group->markCullingDataDirty();
+  }
+}
+
+Drawable::~Drawable() {
+  // the group may hold a reference to this drawable in its culling data
+  auto group =
+      dynamic_cast<DrawableGroup*>(Magnum::SceneGraph::Drawable3D::drawables());
+  if (group) {
+    group->markCullingDataDirty();
+  }
+  // drop it from the flattened feature lists of SceneGraph
+  scene::SceneNode::invalidateStructure();
+}
+
+void Drawable::addLevelOfDetail(Magnum::GL::Mesh& mesh, float error) {
+  CORRADE_ASSERT(error > 0.0f && (levelsOfDetail_.empty() ||
+                                  error > levelsOfDetail_.back().error),
+                 "Drawable::addLevelOfDetail(): levels have to be added with "
+                 "increasing positive error", );
+  levelsOfDetail_.push_back({&mesh, error});
+}
+
+void Drawable::selectLevelOfDetail(float pixelsPerUnit, float maxPixelError) {
+  activeMesh_ = &mesh_;
+  if (maxPixelError <= 0.0f) {
+    return;
+  }
+  for (const LevelOfDetail& level : levelsOfDetail_) {
+    if (level.error * pixelsPerUnit > maxPixelError) {
+      break;
+    }
+    activeMesh_ = level.mesh;
+  }
+}
 
 DrawableGroup* Drawable::drawables() {
   CORRADE_ASSERT(
@@ -24,5 +67,22 @@ DrawableGroup* Drawable::drawables() {
       Magnum::SceneGraph::Drawable3D::drawables());
 }
 
+std::size_t Drawable::drawnTriangleCount() {
+  const Magnum::GL::Mesh& mesh = *activeMesh_;
+  std::size_t triangles = 0;
+  switch (mesh.primitive()) {
+    case Magnum::GL::MeshPrimitive::Triangles:
+      triangles = mesh.count() / 3;
+      break;
+    case Magnum::GL::MeshPrimitive::TriangleStrip:
+    case Magnum::GL::MeshPrimitive::TriangleFan:
+      triangles = mesh.count() > 2 ? mesh.count() - 2 : 0;
+      break;
+    default:
+      break;
+  }
+  return triangles * mesh.instanceCount();
+}
+
 }  // namespace gfx
 }  // namespace esp
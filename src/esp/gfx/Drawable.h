@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include <Magnum/Shaders/Shaders.h>
+
 #include "esp/core/esp.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "magnum.h"
@@ -14,6 +18,23 @@ class SceneNode;
 }
 namespace gfx {
 
+class RenderCamera;
+struct MaterialData;
+
+/**
+ * @brief GL state bound by a drawable
+ *
+ * @ref RenderCamera::draw(DrawableGroup&, bool) sorts drawables by it, in the
+ * order of the members, so consecutive drawables share as much state as
+ * possible. Members a drawable doesn't use are nullptr.
+ */
+struct DrawStateKey {
+  Magnum::GL::AbstractShaderProgram* shader = nullptr;
+  Magnum::GL::Texture2D* texture = nullptr;
+  MaterialData* material = nullptr;
+  Magnum::GL::Mesh* mesh = nullptr;
+};
+
 /**
  * @brief Drawable for use with @ref DrawableGroup.
  *
@@ -32,7 +53,7 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   Drawable(scene::SceneNode& node,
            Magnum::GL::Mesh& mesh,
            DrawableGroup* group = nullptr);
-  virtual ~Drawable() {}
+  virtual ~Drawable();
 
   virtual scene::SceneNode& getSceneNode() { return node_; }
 
@@ -46,7 +67,115 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
 
   virtual void setLightSetup(const Magnum::ResourceKey& lightSetup){};
 
+  /**
+   * @brief Absolute transformation of the node as of the last time the node
+   * was cleaned
+   *
+   * Kept up to date by @ref DrawableGroup::prepareForDraw(), which only
+   * recomputes it for nodes that moved.
+   */
+  const Magnum::Matrix4& absoluteTransformation() const {
+    return absoluteTransformation_;
+  }
+
+  /**
+   * @brief GL state this drawable binds when drawn
+   *
+   * The default implementation only reports the mesh.
+   */
+  virtual DrawStateKey drawStateKey() {
+    return {nullptr, nullptr, nullptr, activeMesh_};
+  }
+
+  /**
+   * @brief Add a simplified mesh to draw instead when far enough away
+   *
+   * @param mesh   Simplified mesh, has to outlive the drawable
+   * @param error  Largest distance the simplified surface deviates from the
+   *               full one, in units of the node's local space. Levels have
+   *               to be added with increasing error.
+   *
+   * See @ref selectLevelOfDetail().
+   */
+  void addLevelOfDetail(Magnum::GL::Mesh& mesh, float error);
+
+  /** @brief Number of levels of detail besides the full mesh */
+  std::size_t levelOfDetailCount() const { return levelsOfDetail_.size(); }
+
+  /**
+   * @brief Choose the mesh drawn next
+   *
+   * @param pixelsPerUnit  How many pixels one unit of the node's local space
+   *                       covers on screen, at the closest point of the mesh
+   * @param maxPixelError  Largest error allowed on screen, in pixels. 0
+   *                       always selects the full mesh.
+   *
+   * Selects the least detailed level whose error projects to at most
+   * @p maxPixelError pixels. Called by @ref RenderCamera::draw(DrawableGroup&,
+   * bool).
+   */
+  void selectLevelOfDetail(float pixelsPerUnit, float maxPixelError);
+
+  /** @brief Mesh currently drawn, see @ref selectLevelOfDetail() */
+  Magnum::GL::Mesh& activeMesh() { return *activeMesh_; }
+
+  /**
+   * @brief Number of triangles the last draw submitted
+   *
+   * The default implementation counts the triangles of @ref activeMesh()
+   * times its instance count, other primitives count as zero.
+   */
+  virtual std::size_t drawnTriangleCount();
+
  protected:
+  friend class RenderCamera;
+
+  /**
+   * @brief Draw the object, knowing which state the previous drawable bound
+   *
+   * @param transformationMatrix  Transformation relative to camera.
+   * @param camera                Camera to draw from.
+   * @param previous              @ref drawStateKey() of the drawable drawn
+   *                              right before this one in the same pass,
+   *                              empty for the first one
+   *
+   * Lets derived drawables skip setting state that is already bound. The
+   * default implementation calls @ref draw().
+   */
+  virtual void drawSorted(const Magnum::Matrix4& transformationMatrix,
+                          Magnum::SceneGraph::Camera3D& camera,
+                          const DrawStateKey& previous) {
+    static_cast<void>(previous);
+    draw(transformationMatrix, camera);
+  }
+
+  /**
+   * @brief Draw only the depth of the object
+   *
+   * @param transformationMatrix  Transformation relative to camera.
+   * @param camera                Camera to draw from.
+   * @param shader                Shader writing no color, bound instead of
+   *                              the drawable's own one
+   *
+   * Called instead of @ref drawSorted() while the camera has a @ref
+   * RenderCamera::depthOnlyShader(), with color writes masked. The default
+   * implementation calls @ref draw() for drawables whose meshes the shader
+   * can't draw.
+   */
+  virtual void drawDepthOnly(const Magnum::Matrix4& transformationMatrix,
+                             Magnum::SceneGraph::Camera3D& camera,
+                             Magnum::Shaders::Flat3D& shader) {
+    static_cast<void>(shader);
+    draw(transformationMatrix, camera);
+  }
+
+  /**
+   * @brief Cache the absolute transformation when the node is cleaned
+   */
+  void clean(const Magnum::Matrix4& absoluteTransformationMatrix) override {
+    absoluteTransformation_ = absoluteTransformationMatrix;
+  }
+
   /**
    * @brief Draw the object using given camera
    *
@@ -59,8 +188,17 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
                     Magnum::SceneGraph::Camera3D& camera) = 0;
 
+  struct LevelOfDetail {
+    Magnum::GL::Mesh* mesh;
+    float error;
+  };
+
   scene::SceneNode& node_;
   Magnum::GL::Mesh& mesh_;
+  Magnum::Matrix4 absoluteTransformation_;
+  // simplified meshes by increasing error, and the one currently chosen
+  std::vector<LevelOfDetail> levelsOfDetail_;
+  Magnum::GL::Mesh* activeMesh_;
 };
 
 }  // namespace gfx
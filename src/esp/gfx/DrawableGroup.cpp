@@ -0,0 +1,72 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DrawableGroup.h"
+
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/InstancedDrawable.h"
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+bool DrawableGroup::prepareForDraw(const RenderCamera&) {
+  for (size_t i = 0; i < size(); ++i) {
+    auto& node = static_cast<scene::SceneNode&>((*this)[i].object());
+    // cleaning a node also cleans its dirty ancestors and calls
+    // Drawable::clean() on all of its drawables
+    if (node.isDirty()) {
+      node.setClean();
+    }
+  }
+  return true;
+}
+
+void DrawableGroup::updateCullingData() {
+  // the size check catches drawables added through FeatureGroup::add()
+  if (!cullingDataDirty_ &&
+      boundedDrawables_.size() + unboundedDrawables_.size() == size()) {
+    return;
+  }
+
+  boundedDrawables_.clear();
+  unboundedDrawables_.clear();
+  std::vector<Mn::Range3D> boxes;
+  for (size_t i = 0; i < size(); ++i) {
+    auto drawable = dynamic_cast<Drawable*>(&(*this)[i]);
+    CORRADE_ASSERT(drawable,
+                   "DrawableGroup::updateCullingData(): DrawableGroup must "
+                   "only contain esp::gfx::Drawable", );
+    scene::SceneNode& node = drawable->getSceneNode();
+    Corrade::Containers::Optional<Mn::Range3D> aabb = node.getAbsoluteAABB();
+    if (aabb) {
+      boxes.push_back(*aabb);
+      boundedDrawables_.emplace_back(*drawable);
+    } else {
+      unboundedDrawables_.emplace_back(*drawable);
+    }
+  }
+  cullingBVH_.build(boxes);
+  cullingDataDirty_ = false;
+  ++cullingDataVersion_;
+}
+
+InstancedDrawable* DrawableGroup::getInstancedDrawable(
+    const std::string& batchKey) {
+  auto found = instancedDrawables_.find(batchKey);
+  return found == instancedDrawables_.end() ? nullptr : found->second;
+}
+
+void DrawableGroup::registerInstancedDrawable(InstancedDrawable& drawable) {
+  instancedDrawables_[drawable.batchKey()] = &drawable;
+}
+
+void DrawableGroup::unregisterInstancedDrawable(const std::string& batchKey) {
+  instancedDrawables_.erase(batchKey);
+}
+
+}  // namespace gfx
+}  // namespace esp
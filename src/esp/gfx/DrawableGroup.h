@@ -4,13 +4,22 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/FeatureGroup.h>
 
 #include "esp/core/esp.h"
+#include "esp/gfx/CullingBVH.h"
 
 namespace esp {
 namespace gfx {
 
+class Drawable;
+class InstancedDrawable;
 class RenderCamera;
 
 /**
@@ -23,9 +32,91 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
   /**
    * @brief Prepare to draw group with given @ref RenderCamera
    *
+   * Refreshes the cached absolute transformation of every drawable whose node
+   * is dirty, i.e. was moved (or had an ancestor moved) since the last draw.
+   * Nodes that never move, such as static scene geometry, are only
+   * computed once. Called from @ref RenderCamera::draw(DrawableGroup&, bool).
+   *
    * @return Whether the @ref DrawableGroup is in a valid state to be drawn
    */
-  virtual bool prepareForDraw(const RenderCamera&) { return true; }
+  virtual bool prepareForDraw(const RenderCamera&);
+
+  /**
+   * @brief Mark the cached culling data as out of date
+   *
+   * Called by @ref Drawable when it is added to or removed from the group.
+   * The data is rebuilt by the next @ref updateCullingData().
+   */
+  void markCullingDataDirty() { cullingDataDirty_ = true; }
+
+  /**
+   * @brief Rebuild the culling data if drawables were added or removed
+   *
+   * Drawables whose node has an absolute AABB (static geometry) are put into
+   * the @ref cullingBVH(), the others are listed in @ref
+   * unboundedDrawables() and are never culled.
+   */
+  void updateCullingData();
+
+  /**
+   * @brief Hierarchy over the absolute AABBs of @ref boundedDrawables()
+   */
+  CullingBVH& cullingBVH() { return cullingBVH_; }
+
+  /**
+   * @brief Drawables in @ref cullingBVH(), indexed by the BVH box index
+   */
+  const std::vector<std::reference_wrapper<Drawable>>&
+  boundedDrawables() const {
+    return boundedDrawables_;
+  }
+
+  /**
+   * @brief Incremented whenever @ref updateCullingData() rebuilds, which
+   * changes the indices of @ref boundedDrawables()
+   */
+  std::size_t cullingDataVersion() const { return cullingDataVersion_; }
+
+  /**
+   * @brief Drawables without an absolute AABB
+   */
+  const std::vector<std::reference_wrapper<Drawable>>&
+  unboundedDrawables() const {
+    return unboundedDrawables_;
+  }
+
+  /**
+   * @brief Instanced drawable registered under @p batchKey, or nullptr
+   *
+   * Used by @ref esp::assets::ResourceManager to append new copies of an
+   * object template to an existing batch instead of creating a drawable for
+   * each of them.
+   */
+  InstancedDrawable* getInstancedDrawable(const std::string& batchKey);
+
+  /**
+   * @brief Register an instanced drawable under its batch key
+   *
+   * Called by @ref InstancedDrawable when it is added to the group.
+   */
+  void registerInstancedDrawable(InstancedDrawable& drawable);
+
+  /**
+   * @brief Unregister the instanced drawable with given batch key
+   *
+   * Called by @ref InstancedDrawable when it is destroyed.
+   */
+  void unregisterInstancedDrawable(const std::string& batchKey);
+
+ protected:
+  bool cullingDataDirty_ = true;
+  std::size_t cullingDataVersion_ = 0;
+  CullingBVH cullingBVH_;
+  std::vector<std::reference_wrapper<Drawable>>
+      boundedDrawables_;
+  std::vector<std::reference_wrapper<Drawable>>
+      unboundedDrawables_;
+  std::map<std::string, InstancedDrawable*> instancedDrawables_;
 
   ESP_SMART_POINTERS(DrawableGroup)
 };
@@ -0,0 +1,91 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "EquirectangularShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Vector2.h>
+
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(ShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+enum {
+  ColorTextureUnit = 0,
+  ObjectIdTextureUnit = 1,
+  DepthTextureUnit = 2,
+};
+}
+
+EquirectangularShader::EquirectangularShader() {
+  if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"default-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL410;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  // the same full-screen triangle as the resolve pass
+  vert.addSource(rs.get("resolve.vert"));
+  frag.addSource(rs.get("equirectangular.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
+
+  depthUnprojectionUniform_ = uniformLocation("depthUnprojection");
+  viewportSizeUniform_ = uniformLocation("viewportSize");
+  setUniform(uniformLocation("colorTexture"), ColorTextureUnit);
+  setUniform(uniformLocation("objectIdTexture"), ObjectIdTextureUnit);
+  setUniform(uniformLocation("depthTexture"), DepthTextureUnit);
+}
+
+EquirectangularShader& EquirectangularShader::bindColorTexture(
+    Mn::GL::CubeMapTexture& texture) {
+  texture.bind(ColorTextureUnit);
+  return *this;
+}
+
+EquirectangularShader& EquirectangularShader::bindObjectIdTexture(
+    Mn::GL::CubeMapTexture& texture) {
+  texture.bind(ObjectIdTextureUnit);
+  return *this;
+}
+
+EquirectangularShader& EquirectangularShader::bindDepthTexture(
+    Mn::GL::CubeMapTexture& texture) {
+  texture.bind(DepthTextureUnit);
+  return *this;
+}
+
+EquirectangularShader& EquirectangularShader::setDepthUnprojection(
+    const Mn::Vector2& depthUnprojection) {
+  setUniform(depthUnprojectionUniform_, depthUnprojection);
+  return *this;
+}
+
+EquirectangularShader& EquirectangularShader::setViewportSize(
+    const Mn::Vector2i& size) {
+  setUniform(viewportSizeUniform_, Mn::Vector2{size});
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,71 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/Magnum.h>
+
+#include "esp/gfx/CachedShaderProgram.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Cube map to equirectangular resampling shader
+
+Renders a full-screen triangle, each fragment sampling the cube maps bound
+with @ref bindColorTexture(), @ref bindObjectIdTexture() and
+@ref bindDepthTexture() in the direction of its longitude and latitude. Color
+goes to output @cpp 0 @ce, the object ID to output @cpp 1 @ce. The cube map
+depth, which is along the face axes, is converted to the distance along the
+ray and written back as a depth buffer value with the same
+@ref setDepthUnprojection() parameters. Used by @ref CubeMapRenderTarget.
+*/
+class EquirectangularShader : public CachedShaderProgram {
+ public:
+  /** @brief Constructor */
+  explicit EquirectangularShader();
+
+  /**
+   * @brief Bind the color cube map
+   * @return Reference to self (for method chaining)
+   */
+  EquirectangularShader& bindColorTexture(Magnum::GL::CubeMapTexture& texture);
+
+  /**
+   * @brief Bind the object ID cube map
+   * @return Reference to self (for method chaining)
+   */
+  EquirectangularShader& bindObjectIdTexture(
+      Magnum::GL::CubeMapTexture& texture);
+
+  /**
+   * @brief Bind the depth cube map
+   * @return Reference to self (for method chaining)
+   */
+  EquirectangularShader& bindDepthTexture(Magnum::GL::CubeMapTexture& texture);
+
+  /**
+   * @brief Set the depth unprojection parameters of the cube map faces
+   * @return Reference to self (for method chaining)
+   *
+   * See @ref calculateDepthUnprojection().
+   */
+  EquirectangularShader& setDepthUnprojection(
+      const Magnum::Vector2& depthUnprojection);
+
+  /**
+   * @brief Set the size of the viewport the panorama covers
+   * @return Reference to self (for method chaining)
+   */
+  EquirectangularShader& setViewportSize(const Magnum::Vector2i& size);
+
+ private:
+  int depthUnprojectionUniform_;
+  int viewportSizeUniform_;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -4,8 +4,14 @@
 
 #include "GenericDrawable.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Shaders/Flat.h>
 
 #include "esp/scene/SceneNode.h"
 
@@ -26,45 +32,80 @@ GenericDrawable::GenericDrawable(scene::SceneNode& node,
           shaderManager.get<MaterialData, PhongMaterialData>(materialData)},
       objectId_(objectId) {
   // update the shader early here to to avoid doing it during the render loop
-  updateShader();
+  updateShader(lightSetup_->size());
 }
 
 void GenericDrawable::setLightSetup(const Magnum::ResourceKey& resourceKey) {
   lightSetup_ = shaderManager_.get<LightSetup>(resourceKey);
 
   // update the shader early here to to avoid doing it during the render loop
+  updateShader(lightSetup_->size());
+}
+
+DrawStateKey GenericDrawable::drawStateKey() {
+  // the shader may change with the light setup
   updateShader();
+  return {&*shader_,
+          materialData_->diffuseTexture ? materialData_->diffuseTexture
+                                        : materialData_->ambientTexture,
+          &*materialData_, activeMesh_};
 }
 
 void GenericDrawable::draw(const Magnum::Matrix4& transformationMatrix,
                            Magnum::SceneGraph::Camera3D& camera) {
-  updateShader();
+  drawSorted(transformationMatrix, camera, DrawStateKey{});
+}
 
-  const Magnum::Matrix4 cameraMatrix = camera.cameraMatrix();
+void GenericDrawable::drawSorted(const Magnum::Matrix4& transformationMatrix,
+                                 Magnum::SceneGraph::Camera3D& camera,
+                                 const DrawStateKey& previous) {
+  setDrawState(transformationMatrix, camera, previous);
+  shader_->draw(*activeMesh_);
+}
 
-  std::vector<Magnum::Vector3> lightPositions;
-  lightPositions.reserve(lightSetup_->size());
-  std::vector<Magnum::Color4> lightColors;
-  lightColors.reserve(lightSetup_->size());
+void GenericDrawable::setDrawState(const Magnum::Matrix4& transformationMatrix,
+                                   Magnum::SceneGraph::Camera3D& camera,
+                                   const DrawStateKey& previous) {
+  const LightSetup& lights =
+      cullLights(transformationMatrix, camera.cameraMatrix());
+  updateShader(lights.size());
 
-  for (Magnum::UnsignedInt i = 0; i < lightSetup_->size(); ++i) {
-    lightPositions.emplace_back(getLightPositionRelativeToCamera(
-        (*lightSetup_)[i], transformationMatrix, cameraMatrix));
+  // the lights and the projection are only uploaded when they differ from
+  // what the shader has, usually once per frame
+  (*shader_)
+      .setLights(lights, transformationMatrix, camera.cameraMatrix())
+      .setProjectionMatrixCached(camera.projectionMatrix())
+      .setObjectId(
+          shader_->flags() & Magnum::Shaders::Phong::Flag::InstancedObjectId
+              ? 0
+              : node_.getId())
+      .setTransformationMatrix(transformationMatrix * meshTransformation_)
+      .setNormalMatrix(transformationMatrix.rotationScaling());
 
-    lightColors.emplace_back((*lightSetup_)[i].color);
+  // uniforms and texture bindings stay in place between draws, so they only
+  // need to be set when drawn after a different shader or material
+  if (previous.shader != &*shader_ || previous.material != &*materialData_) {
+    setMaterialState();
   }
+}
 
+void GenericDrawable::drawDepthOnly(
+    const Magnum::Matrix4& transformationMatrix,
+    Magnum::SceneGraph::Camera3D& camera,
+    Magnum::Shaders::Flat3D& shader) {
+  shader
+      .setTransformationProjectionMatrix(
+          camera.projectionMatrix() * transformationMatrix *
+          meshTransformation_)
+      .draw(*activeMesh_);
+}
+
+void GenericDrawable::setMaterialState() {
   (*shader_)
       .setAmbientColor(materialData_->ambientColor)
       .setDiffuseColor(materialData_->diffuseColor)
       .setSpecularColor(materialData_->specularColor)
-      .setShininess(materialData_->shininess)
-      .setObjectId(materialData_->perVertexObjectId ? 0 : node_.getId())
-      .setLightPositions(lightPositions)
-      .setLightColors(lightColors)
-      .setTransformationMatrix(transformationMatrix)
-      .setProjectionMatrix(camera.projectionMatrix())
-      .setNormalMatrix(transformationMatrix.rotationScaling());
+      .setShininess(materialData_->shininess);
 
   if (materialData_->textureMatrix != Magnum::Matrix3{})
     shader_->setTextureMatrix(materialData_->textureMatrix);
@@ -77,52 +118,117 @@ void GenericDrawable::draw(const Magnum::Matrix4& transformationMatrix,
     shader_->bindSpecularTexture(*(materialData_->specularTexture));
   if (materialData_->normalTexture)
     shader_->bindNormalTexture(*(materialData_->normalTexture));
+}
 
-  shader_->draw(mesh_);
+Magnum::Shaders::Phong::Flags GenericDrawable::shaderFlags() const {
+  return materialShaderFlags(*materialData_);
 }
 
-void GenericDrawable::updateShader() {
-  Magnum::UnsignedInt lightCount = lightSetup_->size();
+Magnum::Shaders::Phong::Flags GenericDrawable::materialShaderFlags(
+    const PhongMaterialData& material) {
   Magnum::Shaders::Phong::Flags flags = Magnum::Shaders::Phong::Flag::ObjectId;
 
-  if (materialData_->textureMatrix != Magnum::Matrix3{})
+  if (material.textureMatrix != Magnum::Matrix3{})
     flags |= Magnum::Shaders::Phong::Flag::TextureTransformation;
-  if (materialData_->ambientTexture)
+  if (material.ambientTexture)
     flags |= Magnum::Shaders::Phong::Flag::AmbientTexture;
-  if (materialData_->diffuseTexture)
+  if (material.diffuseTexture)
     flags |= Magnum::Shaders::Phong::Flag::DiffuseTexture;
-  if (materialData_->specularTexture)
+  if (material.specularTexture)
     flags |= Magnum::Shaders::Phong::Flag::SpecularTexture;
-  if (materialData_->normalTexture)
+  if (material.normalTexture)
     flags |= Magnum::Shaders::Phong::Flag::NormalTexture;
-  if (materialData_->perVertexObjectId)
+  if (material.perVertexObjectId)
     flags |= Magnum::Shaders::Phong::Flag::InstancedObjectId;
 
+  return flags;
+}
+
+const LightSetup& GenericDrawable::cullLights(
+    const Magnum::Matrix4& transformationMatrix,
+    const Magnum::Matrix4& cameraMatrix) {
+  const LightSetup& lights = *lightSetup_;
+  const Magnum::Range3D& bounds = node_.getMeshBB();
+  if (bounds.size().isZero() ||
+      std::none_of(lights.begin(), lights.end(), [](const LightInfo& light) {
+        return light.range != std::numeric_limits<Magnum::Float>::infinity();
+      })) {
+    return lights;
+  }
+
+  // the mesh bounds relative to the camera, where the lights are placed
+  const Magnum::Vector3 corners[]{
+      bounds.backBottomLeft(),  bounds.backBottomRight(),
+      bounds.backTopLeft(),     bounds.backTopRight(),
+      bounds.frontBottomLeft(), bounds.frontBottomRight(),
+      bounds.frontTopLeft(),    bounds.frontTopRight()};
+  Magnum::Vector3 min{std::numeric_limits<Magnum::Float>::infinity()};
+  Magnum::Vector3 max{-std::numeric_limits<Magnum::Float>::infinity()};
+  for (const Magnum::Vector3& corner : corners) {
+    const Magnum::Vector3 point = transformationMatrix.transformPoint(corner);
+    min = Magnum::Math::min(min, point);
+    max = Magnum::Math::max(max, point);
+  }
+
+  drawLights_.clear();
+  for (const LightInfo& light : lights) {
+    const Magnum::Vector3 position = getLightPositionRelativeToCamera(
+        light, transformationMatrix, cameraMatrix);
+    const Magnum::Vector3 nearest = Magnum::Math::clamp(position, min, max);
+    if ((nearest - position).dot() <= light.range * light.range) {
+      drawLights_.push_back(light);
+    }
+  }
+
+  Magnum::UnsignedInt count = drawLights_.empty() ? 0 : 1;
+  while (count < drawLights_.size()) {
+    count *= 2;
+  }
+  drawLights_.resize(
+      Magnum::Math::min(count, Magnum::UnsignedInt(lights.size())),
+      LightInfo{{}, Magnum::Color4{0.0f}, LightPositionModel::CAMERA});
+  return drawLights_;
+}
+
+void GenericDrawable::updateShader() {
+  updateShader(shader_ ? shader_->lightCount() : lightSetup_->size());
+}
+
+void GenericDrawable::updateShader(Magnum::UnsignedInt lightCount) {
+  Magnum::Shaders::Phong::Flags flags = shaderFlags();
+
   if (!shader_ || shader_->lightCount() != lightCount ||
       shader_->flags() != flags) {
     // if the number of lights or flags have changed, we need to fetch a
     // compatible shader
-    shader_ =
-        shaderManager_
-            .get<Magnum::GL::AbstractShaderProgram, Magnum::Shaders::Phong>(
-                getShaderKey(lightCount, flags));
-
-    // if no shader with desired number of lights and flags exists, create one
-    if (!shader_) {
-      shaderManager_.set<Magnum::GL::AbstractShaderProgram>(
-          shader_.key(), new Magnum::Shaders::Phong{flags, lightCount},
-          Magnum::ResourceDataState::Final,
-          Magnum::ResourcePolicy::ReferenceCounted);
-    }
+    shader_ = getShader(shaderManager_, lightCount, flags);
 
     CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
                             shader_->flags() == flags);
   }
 }
 
+Magnum::Resource<Magnum::GL::AbstractShaderProgram, PhongShader>
+GenericDrawable::getShader(ShaderManager& shaderManager,
+                           Magnum::UnsignedInt lightCount,
+                           Magnum::Shaders::Phong::Flags flags) {
+  Magnum::Resource<Magnum::GL::AbstractShaderProgram, PhongShader> shader =
+      shaderManager.get<Magnum::GL::AbstractShaderProgram, PhongShader>(
+          getShaderKey(lightCount, flags));
+
+  // if no shader with desired number of lights and flags exists, create one
+  if (!shader) {
+    shaderManager.set<Magnum::GL::AbstractShaderProgram>(
+        shader.key(), new PhongShader{flags, lightCount},
+        Magnum::ResourceDataState::Final,
+        Magnum::ResourcePolicy::ReferenceCounted);
+  }
+  return shader;
+}
+
 Magnum::ResourceKey GenericDrawable::getShaderKey(
     Magnum::UnsignedInt lightCount,
-    Magnum::Shaders::Phong::Flags flags) const {
+    Magnum::Shaders::Phong::Flags flags) {
   return Corrade::Utility::formatString(
       SHADER_KEY_TEMPLATE, lightCount,
       static_cast<Magnum::Shaders::Phong::Flags::UnderlyingType>(flags));
@@ -7,6 +7,7 @@
 #include <Magnum/Shaders/Phong.h>
 
 #include "esp/gfx/Drawable.h"
+#include "esp/gfx/PhongShader.h"
 #include "esp/gfx/ShaderManager.h"
 
 namespace esp {
@@ -27,27 +28,127 @@ class GenericDrawable : public Drawable {
 
   void setLightSetup(const Magnum::ResourceKey& lightSetup) override;
 
+  DrawStateKey drawStateKey() override;
+
+  /**
+   * @brief Set a transformation applied to the mesh vertices before the node
+   * transformation
+   *
+   * Used to expand positions quantized relative to the mesh bounds, see
+   * @ref esp::assets::GenericInstanceMeshData::setCompactLayout(). Normals
+   * and lights aren't affected. Identity by default.
+   */
+  void setMeshTransformation(const Magnum::Matrix4& transformation) {
+    meshTransformation_ = transformation;
+  }
+
   static constexpr const char* SHADER_KEY_TEMPLATE = "Phong-lights={}-flags={}";
 
+  /**
+   * @brief Phong shader flags needed to draw a mesh with @p material
+   *
+   * Drawables may add flags of their own, e.g. @ref InstancedDrawable.
+   */
+  static Magnum::Shaders::Phong::Flags materialShaderFlags(
+      const PhongMaterialData& material);
+
+  /**
+   * @brief Shader with @p lightCount lights and @p flags, compiled and added
+   * to @p shaderManager if it isn't there yet
+   *
+   * The shader is reference counted, it is freed once the last resource
+   * referencing it goes away.
+   */
+  static Magnum::Resource<Magnum::GL::AbstractShaderProgram, PhongShader>
+  getShader(ShaderManager& shaderManager,
+            Magnum::UnsignedInt lightCount,
+            Magnum::Shaders::Phong::Flags flags);
+
+  /**
+   * @brief Key of the shader with @p lightCount lights and @p flags in the
+   * shader manager
+   */
+  static Magnum::ResourceKey getShaderKey(Magnum::UnsignedInt lightCount,
+                                          Magnum::Shaders::Phong::Flags flags);
+
  protected:
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
                     Magnum::SceneGraph::Camera3D& camera) override;
 
+  /**
+   * @brief Draw, skipping the material uniforms and textures if the
+   * previous drawable used the same shader and material
+   */
+  void drawSorted(const Magnum::Matrix4& transformationMatrix,
+                  Magnum::SceneGraph::Camera3D& camera,
+                  const DrawStateKey& previous) override;
+
+  /**
+   * @brief Draw the mesh with the depth-only shader, without uniforms or
+   * textures of the material
+   */
+  void drawDepthOnly(const Magnum::Matrix4& transformationMatrix,
+                     Magnum::SceneGraph::Camera3D& camera,
+                     Magnum::Shaders::Flat3D& shader) override;
+
+  /**
+   * @brief Set the uniforms of the next draw and, unless the previous
+   * drawable made the same bindings, the material state
+   */
+  void setDrawState(const Magnum::Matrix4& transformationMatrix,
+                    Magnum::SceneGraph::Camera3D& camera,
+                    const DrawStateKey& previous);
+
+  /**
+   * @brief The lights of the light setup that reach the mesh bounds
+   *
+   * Lights with a @ref LightInfo::range that doesn't reach the bounds of the
+   * node's mesh, placed relative to the camera by @p transformationMatrix,
+   * are left out, @p cameraMatrix places the lights. The
+   * rest is padded with black lights to the next power of two, or to the
+   * size of the light setup if that's less, so drawables shading different
+   * numbers of lights share a few shader variants. If no light has a range
+   * or the node has no mesh bounds, the light setup is returned as is.
+   */
+  const LightSetup& cullLights(const Magnum::Matrix4& transformationMatrix,
+                               const Magnum::Matrix4& cameraMatrix);
+
+  /**
+   * @brief Switch to a shader with @p lightCount lights and the flags of
+   * the material, if the current one differs
+   */
+  void updateShader(Magnum::UnsignedInt lightCount);
+
+  /**
+   * @brief Switch to a shader with the flags of the material, keeping the
+   * light count of the current shader or, without one, that of the light
+   * setup
+   */
   void updateShader();
 
-  Magnum::ResourceKey getShaderKey(Magnum::UnsignedInt lightCount,
-                                   Magnum::Shaders::Phong::Flags flags) const;
+  /**
+   * @brief Set the material uniforms and bind the material textures
+   */
+  virtual void setMaterialState();
+
+  /**
+   * @brief Phong shader flags needed to draw the mesh with the current
+   * material
+   */
+  virtual Magnum::Shaders::Phong::Flags shaderFlags() const;
 
   Magnum::GL::Texture2D* texture_;
   int objectId_;
   Magnum::Color4 color_;
+  Magnum::Matrix4 meshTransformation_;
 
   // shader parameters
   ShaderManager& shaderManager_;
-  Magnum::Resource<Magnum::GL::AbstractShaderProgram, Magnum::Shaders::Phong>
-      shader_;
+  Magnum::Resource<Magnum::GL::AbstractShaderProgram, PhongShader> shader_;
   Magnum::Resource<MaterialData, PhongMaterialData> materialData_;
   Magnum::Resource<LightSetup> lightSetup_;
+  // the lights of the last draw, if some were culled, see cullLights()
+  LightSetup drawLights_;
 };
 
 }  // namespace gfx
@@ -0,0 +1,227 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Configuration.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+// converter plugin of a file, by name so that JPEG quality can be set on the
+// plugin itself instead of through AnyImageConverter
+std::string converterPlugin(const std::string& filename) {
+  const std::string extension = Cr::Utility::String::lowercase(
+      Cr::Utility::Directory::splitExtension(filename).second);
+  if (extension == ".png") {
+    return "PngImageConverter";
+  }
+  if (extension == ".jpg" || extension == ".jpeg") {
+    return "JpegImageConverter";
+  }
+  if (extension == ".tga") {
+    return "TgaImageConverter";
+  }
+  if (extension == ".bmp") {
+    return "BmpImageConverter";
+  }
+  if (extension == ".hdr") {
+    return "HdrImageConverter";
+  }
+  return "AnyImageConverter";
+}
+
+}  // namespace
+
+ImageWriter::ImageWriter(size_t threadCount,
+                         size_t maxQueuedImages,
+                         float jpegQuality)
+    : maxQueuedImages_{std::max(maxQueuedImages, size_t{1})},
+      jpegQuality_{jpegQuality} {
+  const size_t count = std::max(threadCount, size_t{1});
+  threads_.reserve(count);
+  for (size_t i = 0; i != count; ++i) {
+    threads_.emplace_back([this]() { run(); });
+  }
+}
+
+ImageWriter::~ImageWriter() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+float ImageWriter::jpegQuality() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return jpegQuality_;
+}
+
+void ImageWriter::setJpegQuality(float quality) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  jpegQuality_ = quality;
+}
+
+void ImageWriter::write(const std::string& filename,
+                        const Mn::ImageView2D& image) {
+  const size_t rowSize = image.pixelSize() * image.size().x();
+  Task task{filename, image.format(), image.size(),
+            Cr::Containers::Array<char>{Cr::Containers::NoInit,
+                                        rowSize * image.size().y()}};
+  const Cr::Containers::StridedArrayView3D<const char> pixels =
+      image.pixels();
+  for (int y = 0; y != image.size().y(); ++y) {
+    std::memcpy(task.data + y * rowSize, pixels[y].data(), rowSize);
+  }
+  push(std::move(task));
+}
+
+bool ImageWriter::write(const std::string& filename,
+                        const core::Buffer& observation,
+                        bool topRowFirst /* = false */) {
+  const std::vector<size_t>& shape = observation.shape;
+  const size_t channels = shape.size() == 3 ? shape[2] : 1;
+  if (shape.size() != 2 && shape.size() != 3) {
+    return false;
+  }
+  Mn::PixelFormat format;
+  if (observation.dataType == core::DataType::DT_UINT8 && channels == 1) {
+    format = Mn::PixelFormat::R8Unorm;
+  } else if (observation.dataType == core::DataType::DT_UINT8 &&
+             channels == 3) {
+    format = Mn::PixelFormat::RGB8Unorm;
+  } else if (observation.dataType == core::DataType::DT_UINT8 &&
+             channels == 4) {
+    format = Mn::PixelFormat::RGBA8Unorm;
+  } else if (observation.dataType == core::DataType::DT_FLOAT &&
+             channels == 1) {
+    format = Mn::PixelFormat::R32F;
+  } else {
+    return false;
+  }
+
+  const Mn::Vector2i size{int(shape[1]), int(shape[0])};
+  const size_t rowSize = Mn::pixelSize(format) * size.x();
+  CORRADE_ASSERT(observation.data.size() == rowSize * size.y(),
+                 "ImageWriter::write(): observation doesn't match its shape",
+                 false);
+  Task task{filename, format, size,
+            Cr::Containers::Array<char>{Cr::Containers::NoInit,
+                                        rowSize * size.y()}};
+  // Magnum images start at the bottom
+  const char* data = reinterpret_cast<const char*>(observation.data.data());
+  for (int y = 0; y != size.y(); ++y) {
+    const int row = topRowFirst ? size.y() - 1 - y : y;
+    std::memcpy(task.data + y * rowSize, data + row * rowSize, rowSize);
+  }
+  push(std::move(task));
+  return true;
+}
+
+void ImageWriter::push(Task&& task) {
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    written_.wait(lock,
+                  [this]() { return tasks_.size() < maxQueuedImages_; });
+    tasks_.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+void ImageWriter::flush() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  written_.wait(lock,
+                [this]() { return tasks_.empty() && busyThreads_ == 0; });
+}
+
+size_t ImageWriter::pendingImages() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return tasks_.size() + busyThreads_;
+}
+
+size_t ImageWriter::writtenImages() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return writtenImages_;
+}
+
+size_t ImageWriter::failedImages() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return failedImages_;
+}
+
+void ImageWriter::run() {
+  // plugin managers aren't thread-safe, every worker has its own
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter> manager;
+  std::map<std::string,
+           Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter>>
+      converters;
+  for (;;) {
+    Task task;
+    float jpegQuality;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      wake_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      // whatever was queued before stopping is still written
+      if (tasks_.empty()) {
+        break;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      jpegQuality = jpegQuality_;
+      ++busyThreads_;
+    }
+    written_.notify_all();
+
+    const std::string plugin = converterPlugin(task.filename);
+    auto found = converters.find(plugin);
+    if (found == converters.end()) {
+      found =
+          converters.emplace(plugin, manager.loadAndInstantiate(plugin)).first;
+    }
+    bool written = false;
+    if (Mn::Trade::AbstractImageConverter* converter = found->second.get()) {
+      if (plugin == "JpegImageConverter") {
+        converter->configuration().setValue("jpegQuality", jpegQuality);
+      }
+      written = converter->exportToFile(
+          Mn::ImageView2D{Mn::PixelStorage{}.setAlignment(1), task.format,
+                          task.size, task.data},
+          task.filename);
+    }
+    if (!written) {
+      LOG(ERROR) << "ImageWriter: can't write " << task.filename;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      --busyThreads_;
+      ++(written ? writtenImages_ : failedImages_);
+    }
+    written_.notify_all();
+  }
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,141 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::gfx::ImageWriter
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/PixelFormat.h>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Encodes and saves images on a pool of worker threads
+ *
+ * @ref write() copies the image and queues it, a worker encodes it and
+ * writes the file. The file format follows the extension of the filename,
+ * `.png`, `.jpg`/`.jpeg`, `.tga`, `.bmp` or `.hdr` for float images. Once
+ * @ref maxQueuedImages() are waiting, @ref write() blocks until a worker
+ * takes one, which bounds the memory of a writer that can't keep up and
+ * slows the caller down to its pace instead.
+ */
+class ImageWriter {
+ public:
+  /**
+   * @brief Constructor
+   * @param threadCount     Worker threads, at least one
+   * @param maxQueuedImages Images waiting for a worker at most
+   * @param jpegQuality     Quality of JPEG files, between 0 and 1
+   */
+  explicit ImageWriter(size_t threadCount = 1,
+                       size_t maxQueuedImages = 16,
+                       float jpegQuality = 0.95f);
+
+  /** @brief Writes everything queued and stops the workers */
+  ~ImageWriter();
+
+  ImageWriter(const ImageWriter&) = delete;
+  ImageWriter& operator=(const ImageWriter&) = delete;
+
+  /** @brief Number of worker threads */
+  size_t threadCount() const { return threads_.size(); }
+
+  /** @brief Images waiting for a worker at most */
+  size_t maxQueuedImages() const { return maxQueuedImages_; }
+
+  /** @brief Quality of JPEG files */
+  float jpegQuality() const;
+
+  /**
+   * @brief Set the quality of JPEG files
+   *
+   * Applies to images a worker takes from now on.
+   */
+  void setJpegQuality(float quality);
+
+  /**
+   * @brief Queue @p image to be saved as @p filename
+   *
+   * Copies the pixels, @p image can be reused right after. Blocks while
+   * @ref maxQueuedImages() are waiting.
+   */
+  void write(const std::string& filename, const Magnum::ImageView2D& image);
+
+  /**
+   * @brief Queue an observation to be saved as @p filename
+   * @param filename    File to save to
+   * @param observation Observation to save
+   * @param topRowFirst Whether the rows start at the top, like the arrays
+   *    of the Python API, instead of at the bottom like observations read
+   *    back by the sensors
+   * @return Whether the observation is an image, false otherwise
+   *
+   * Takes @ref core::DataType::DT_UINT8 observations of 1, 3 or 4 channels
+   * and single-channel @ref core::DataType::DT_FLOAT ones, e.g. depth, the
+   * latter only into `.hdr` files.
+   */
+  bool write(const std::string& filename,
+             const core::Buffer& observation,
+             bool topRowFirst = false);
+
+  /** @brief Wait until everything queued is written */
+  void flush();
+
+  /** @brief Images queued or being written */
+  size_t pendingImages() const;
+
+  /** @brief Images written since construction */
+  size_t writtenImages() const;
+
+  /** @brief Images that failed to encode or write since construction */
+  size_t failedImages() const;
+
+ private:
+  struct Task {
+    std::string filename;
+    Magnum::PixelFormat format;
+    Magnum::Vector2i size;
+    // tightly packed rows, bottom-up
+    Corrade::Containers::Array<char> data;
+  };
+
+  void push(Task&& task);
+  void run();
+
+  const size_t maxQueuedImages_;
+  float jpegQuality_;
+
+  mutable std::mutex mutex_;
+  // wakes the workers once there is a task or they have to stop
+  std::condition_variable wake_;
+  // wakes waiting writers once there is room or everything is written
+  std::condition_variable written_;
+  std::deque<Task> tasks_;
+  size_t busyThreads_ = 0;
+  size_t writtenImages_ = 0;
+  size_t failedImages_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+
+  ESP_SMART_POINTERS(ImageWriter)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,155 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "InstancedDrawable.h"
+
+#include <algorithm>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Math/Matrix3.h>
+
+#include "esp/scene/SceneNode.h"
+
+namespace esp {
+namespace gfx {
+
+InstancedDrawable::InstancedDrawable(scene::SceneNode& node,
+                                     std::unique_ptr<Magnum::GL::Mesh> mesh,
+                                     ShaderManager& shaderManager,
+                                     const Magnum::ResourceKey& lightSetup,
+                                     const Magnum::ResourceKey& materialData,
+                                     const std::string& batchKey,
+                                     DrawableGroup* group /* = nullptr */)
+    : GenericDrawable{node,         *mesh, shaderManager, lightSetup,
+                      materialData, group},
+      instancedMesh_{std::move(mesh)},
+      batchKey_{batchKey} {
+  instancedMesh_->setInstanceCount(0).addVertexBufferInstanced(
+      instanceBuffer_, 1, 0, Magnum::Shaders::Phong::TransformationMatrix{},
+      Magnum::Shaders::Phong::NormalMatrix{},
+      Magnum::Shaders::Phong::ObjectId{},
+      Magnum::Shaders::Phong::TextureOffset{});
+
+  // the base constructor could not see the instanced flags yet
+  updateShader();
+
+  if (group) {
+    group->registerInstancedDrawable(*this);
+  }
+}
+
+InstancedDrawable::~InstancedDrawable() {
+  for (Instance* instance : instances_) {
+    instance->batch_ = nullptr;
+  }
+  auto group =
+      dynamic_cast<DrawableGroup*>(Magnum::SceneGraph::Drawable3D::drawables());
+  if (group) {
+    group->unregisterInstancedDrawable(batchKey_);
+  }
+}
+
+void InstancedDrawable::addInstance(
+    scene::SceneNode& node,
+    const Magnum::Vector2& textureOffset /* = {} */) {
+  node.addFeature<Instance>(*this, textureOffset);
+}
+
+Magnum::Shaders::Phong::Flags InstancedDrawable::shaderFlags() const {
+  return GenericDrawable::shaderFlags() |
+         instancingShaderFlags(*materialData_);
+}
+
+void InstancedDrawable::setMaterialState() {
+  GenericDrawable::setMaterialState();
+  // the shader adds the offset of each instance before the matrix
+  if (materialData_->textureTile) {
+    shader_->setTextureMatrix(
+        Magnum::Matrix3::scaling(materialData_->textureMatrix.scaling()));
+  }
+}
+
+void InstancedDrawable::drawSorted(const Magnum::Matrix4& transformationMatrix,
+                                   Magnum::SceneGraph::Camera3D& camera,
+                                   const DrawStateKey& previous) {
+  updateInstanceBuffer();
+  if (instances_.empty()) {
+    return;
+  }
+  GenericDrawable::drawSorted(transformationMatrix, camera, previous);
+}
+
+void InstancedDrawable::drawDepthOnly(
+    const Magnum::Matrix4& transformationMatrix,
+    Magnum::SceneGraph::Camera3D& camera,
+    Magnum::Shaders::Flat3D&) {
+  draw(transformationMatrix, camera);
+}
+
+void InstancedDrawable::removeInstance(Instance& instance) {
+  instances_.erase(std::remove(instances_.begin(), instances_.end(), &instance),
+                   instances_.end());
+  instanceBufferDirty_ = true;
+}
+
+void InstancedDrawable::updateInstanceBuffer() {
+  for (Instance* instance : instances_) {
+    scene::SceneNode& node = instance->getSceneNode();
+    if (node.isDirty()) {
+      // calls Instance::clean(), which flags the buffer dirty
+      node.setClean();
+    }
+  }
+  if (!instanceBufferDirty_) {
+    return;
+  }
+
+  // the shader composes the batch node transformation passed to draw() with
+  // the per-instance one, so store instances relative to the batch node
+  const Magnum::Matrix4 batchInverse = absoluteTransformation_.inverted();
+  instanceData_.clear();
+  instanceData_.reserve(instances_.size());
+  for (Instance* instance : instances_) {
+    const Magnum::Matrix4 transformation =
+        batchInverse * instance->absoluteTransformation();
+    instanceData_.push_back(
+        {transformation, transformation.rotationScaling(),
+         static_cast<Magnum::UnsignedInt>(instance->getSceneNode().getId()),
+         instance->textureOffset_});
+  }
+  instanceBuffer_.setData(instanceData_, Magnum::GL::BufferUsage::DynamicDraw);
+  instancedMesh_->setInstanceCount(instanceData_.size());
+  instanceBufferDirty_ = false;
+}
+
+InstancedDrawable::Instance::Instance(scene::SceneNode& node,
+                                      InstancedDrawable& batch,
+                                      const Magnum::Vector2& textureOffset)
+    : Magnum::SceneGraph::AbstractFeature3D{node},
+      node_{node},
+      batch_{&batch},
+      textureOffset_{textureOffset} {
+  setCachedTransformations(Magnum::SceneGraph::CachedTransformation::Absolute);
+  // make sure the cache is filled before the first draw
+  node.setDirty();
+  batch_->instances_.push_back(this);
+  batch_->instanceBufferDirty_ = true;
+}
+
+InstancedDrawable::Instance::~Instance() {
+  if (batch_) {
+    batch_->removeInstance(*this);
+  }
+}
+
+void InstancedDrawable::Instance::clean(
+    const Magnum::Matrix4& absoluteTransformationMatrix) {
+  absoluteTransformation_ = absoluteTransformationMatrix;
+  if (batch_) {
+    batch_->instanceBufferDirty_ = true;
+  }
+}
+
+}  // namespace gfx
+}  // namespace esp
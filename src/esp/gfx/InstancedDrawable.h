@@ -0,0 +1,177 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/SceneGraph/AbstractFeature.h>
+
+#include "esp/gfx/GenericDrawable.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Draws many copies of one mesh and material with a single instanced
+ * draw call
+ *
+ * The drawable itself is attached to a batch node directly under the scene
+ * root, every copy only gets a lightweight feature on its own node (see @ref
+ * addInstance()). Per-instance transformations, object IDs and texture
+ * offsets are streamed to the GPU in one buffer, which is only re-uploaded
+ * when an instance moved or was added or removed.
+ *
+ * Instances are not frustum culled individually and lights with @ref
+ * LightPositionModel::OBJECT are positioned relative to the batch node, so
+ * @ref esp::assets::ResourceManager only batches meshes where this makes no
+ * difference.
+ */
+class InstancedDrawable : public GenericDrawable {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param node          Batch node, must not be moved relative to the scene
+   *                      root
+   * @param mesh          Mesh used only by this drawable, the per-instance
+   *                      buffer gets attached to it
+   * @param shaderManager Shader manager to fetch shaders and materials from
+   * @param lightSetup    Light setup key
+   * @param materialData  Material key
+   * @param batchKey      Key under which the drawable is registered in
+   *                      @p group, see @ref DrawableGroup::getInstancedDrawable()
+   * @param group         Drawable group this drawable will be added to
+   */
+  explicit InstancedDrawable(scene::SceneNode& node,
+                             std::unique_ptr<Magnum::GL::Mesh> mesh,
+                             ShaderManager& shaderManager,
+                             const Magnum::ResourceKey& lightSetup,
+                             const Magnum::ResourceKey& materialData,
+                             const std::string& batchKey,
+                             DrawableGroup* group = nullptr);
+
+  ~InstancedDrawable() override;
+
+  /**
+   * @brief Draw one more copy of the mesh at the location of @p node
+   *
+   * The instance is removed again when @p node is destroyed. If the material
+   * has a @ref PhongMaterialData::textureTile, @p textureOffset is the
+   * @ref PhongMaterialData::textureTileOffset of the instance's material.
+   */
+  void addInstance(scene::SceneNode& node,
+                   const Magnum::Vector2& textureOffset = {});
+
+  /** @brief Number of instances */
+  size_t instanceCount() const { return instances_.size(); }
+
+  /** @brief Key under which the drawable is registered in its group */
+  const std::string& batchKey() const { return batchKey_; }
+
+  /**
+   * @brief Phong shader flags the drawable adds to those of @p material
+   */
+  static Magnum::Shaders::Phong::Flags instancingShaderFlags(
+      const PhongMaterialData& material) {
+    Magnum::Shaders::Phong::Flags flags =
+        Magnum::Shaders::Phong::Flag::InstancedTransformation |
+        Magnum::Shaders::Phong::Flag::InstancedObjectId;
+    if (material.textureTile)
+      flags |= Magnum::Shaders::Phong::Flag::InstancedTextureOffset;
+    return flags;
+  }
+
+ protected:
+  class Instance;
+
+  /**
+   * @brief Per-instance attributes, laid out as expected by
+   * @ref Magnum::Shaders::Phong
+   */
+  struct InstanceData {
+    Magnum::Matrix4 transformation;
+    Magnum::Matrix3x3 normalMatrix;
+    Magnum::UnsignedInt objectId;
+    Magnum::Vector2 textureOffset;
+  };
+
+  Magnum::Shaders::Phong::Flags shaderFlags() const override;
+
+  /**
+   * @brief Set the material state, with the tile translation left to the
+   * per-instance texture offsets
+   */
+  void setMaterialState() override;
+
+  void drawSorted(const Magnum::Matrix4& transformationMatrix,
+                  Magnum::SceneGraph::Camera3D& camera,
+                  const DrawStateKey& previous) override;
+
+  /**
+   * @brief Draw with the own shader, the depth-only one can't place the
+   * instances
+   */
+  void drawDepthOnly(const Magnum::Matrix4& transformationMatrix,
+                     Magnum::SceneGraph::Camera3D& camera,
+                     Magnum::Shaders::Flat3D& shader) override;
+
+  /**
+   * @brief Forget @p instance, called when its node is destroyed
+   */
+  virtual void removeInstance(Instance& instance);
+
+  /**
+   * @brief Clean moved instance nodes and re-upload the instance buffer if
+   * anything changed
+   */
+  void updateInstanceBuffer();
+
+  std::unique_ptr<Magnum::GL::Mesh> instancedMesh_;
+  Magnum::GL::Buffer instanceBuffer_;
+  std::vector<Instance*> instances_;
+  std::vector<InstanceData> instanceData_;
+  bool instanceBufferDirty_ = true;
+  std::string batchKey_;
+
+  friend class Instance;
+};
+
+/**
+ * @brief Feature marking a node as one instance of an @ref InstancedDrawable
+ *
+ * Caches the absolute transformation of its node the same way @ref Drawable
+ * does, so only moved instances are recomputed.
+ */
+class InstancedDrawable::Instance
+    : public Magnum::SceneGraph::AbstractFeature3D {
+ public:
+  Instance(scene::SceneNode& node,
+           InstancedDrawable& batch,
+           const Magnum::Vector2& textureOffset);
+  ~Instance() override;
+
+  scene::SceneNode& getSceneNode() { return node_; }
+
+  const Magnum::Matrix4& absoluteTransformation() const {
+    return absoluteTransformation_;
+  }
+
+ protected:
+  void clean(const Magnum::Matrix4& absoluteTransformationMatrix) override;
+
+  scene::SceneNode& node_;
+  // nullptr once the batch is destroyed before the instance node
+  InstancedDrawable* batch_;
+  Magnum::Matrix4 absoluteTransformation_;
+  Magnum::Vector2 textureOffset_;
+
+  friend class InstancedDrawable;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -8,7 +8,8 @@ namespace esp {
 namespace gfx {
 
 bool operator==(const LightInfo& a, const LightInfo& b) {
-  return a.position == b.position && a.color == b.color && a.model == b.model;
+  return a.position == b.position && a.color == b.color &&
+         a.model == b.model && a.range == b.range;
 }
 
 bool operator!=(const LightInfo& a, const LightInfo& b) {
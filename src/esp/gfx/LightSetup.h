@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include <Magnum/Magnum.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/Matrix4.h>
@@ -28,6 +30,15 @@ struct LightInfo {
   Magnum::Vector3 position;
   Magnum::Color4 color{1};
   LightPositionModel model = LightPositionModel::GLOBAL;
+  /**
+   * @brief Distance beyond which the light doesn't reach
+   *
+   * Drawables whose mesh bounds are farther than this from the light are
+   * drawn without it, so each object only pays for the lights near it, see
+   * @ref GenericDrawable. The shading isn't attenuated up to the range.
+   * Infinite by default.
+   */
+  Magnum::Float range = std::numeric_limits<Magnum::Float>::infinity();
 };
 
 bool operator==(const LightInfo& a, const LightInfo& b);
@@ -25,6 +25,12 @@ struct PhongMaterialData : public MaterialData {
   Magnum::GL::Texture2D *ambientTexture = nullptr, *diffuseTexture = nullptr,
                         *specularTexture = nullptr, *normalTexture = nullptr;
   bool perVertexObjectId = false;
+  // textureMatrix places the texture on a tile of an atlas. Batches draw
+  // materials differing only in the tile with the scaling part of
+  // textureMatrix and textureTileOffset per instance, the translation in
+  // multiples of the scaling, see assets::ResourceManager::textureAtlases()
+  bool textureTile = false;
+  Magnum::Vector2 textureTileOffset;
 
   ESP_SMART_POINTERS(PhongMaterialData)
 };
@@ -0,0 +1,188 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MultiDrawDrawable.h"
+
+#include <algorithm>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/MeshView.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/MeshTools/Concatenate.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "esp/gfx/CullingBVH.h"
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+
+bool MultiDrawDrawable::isSupported() {
+#ifndef MAGNUM_TARGET_GLES
+  return Mn::GL::Context::current()
+      .isExtensionSupported<Mn::GL::Extensions::ARB::base_instance>();
+#else
+  return false;
+#endif
+}
+
+MultiDrawDrawable::MultiDrawDrawable(scene::SceneNode& node,
+                                     Mn::MeshTools::CompileFlags compileFlags,
+                                     ShaderManager& shaderManager,
+                                     const Mn::ResourceKey& lightSetup,
+                                     const Mn::ResourceKey& materialData,
+                                     const std::string& batchKey,
+                                     DrawableGroup* group /* = nullptr */)
+    : InstancedDrawable{node,
+                        std::make_unique<Mn::GL::Mesh>(),
+                        shaderManager,
+                        lightSetup,
+                        materialData,
+                        batchKey,
+                        group},
+      compileFlags_{compileFlags} {
+  CORRADE_ASSERT(isSupported(),
+                 "MultiDrawDrawable: base instances are not supported", );
+}
+
+std::string MultiDrawDrawable::layoutKey(const Mn::Trade::MeshData& mesh) {
+  std::string key = Cr::Utility::formatString(
+      "{}:{}", Mn::UnsignedInt(mesh.primitive()), int(mesh.isIndexed()));
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+    key += Cr::Utility::formatString(":{}/{}",
+                                     Mn::UnsignedShort(mesh.attributeName(i)),
+                                     Mn::UnsignedInt(mesh.attributeFormat(i)));
+  }
+  return key;
+}
+
+void MultiDrawDrawable::addPart(
+    scene::SceneNode& node,
+    const Mn::Trade::MeshData& mesh,
+    const Mn::Vector2& textureOffset /* = {} */) {
+  CORRADE_ASSERT(mesh.isIndexed() &&
+                     mesh.primitive() == Mn::MeshPrimitive::Triangles,
+                 "MultiDrawDrawable::addPart(): the mesh has to be indexed "
+                 "triangles", );
+  CORRADE_ASSERT(parts_.empty() ||
+                     layoutKey(*parts_.front().mesh) == layoutKey(mesh),
+                 "MultiDrawDrawable::addPart(): the vertex layout differs "
+                 "from the other parts", );
+  addInstance(node, textureOffset);
+  parts_.push_back({&mesh, 0, 0, 0});
+  meshesDirty_ = true;
+}
+
+void MultiDrawDrawable::removeInstance(Instance& instance) {
+  auto found = std::find(instances_.begin(), instances_.end(), &instance);
+  if (found != instances_.end()) {
+    parts_.erase(parts_.begin() + (found - instances_.begin()));
+    meshesDirty_ = true;
+  }
+  InstancedDrawable::removeInstance(instance);
+}
+
+std::size_t MultiDrawDrawable::drawnTriangleCount() {
+  std::size_t triangles = 0;
+  for (const DrawCommand& command : commands_) {
+    triangles += command.count / 3;
+  }
+  return triangles;
+}
+
+void MultiDrawDrawable::packMeshes() {
+  meshesDirty_ = false;
+  if (parts_.empty()) {
+    return;
+  }
+
+  std::vector<Cr::Containers::Reference<const Mn::Trade::MeshData>> meshes;
+  meshes.reserve(parts_.size());
+  Mn::UnsignedInt firstIndex = 0;
+  for (Part& part : parts_) {
+    meshes.emplace_back(*part.mesh);
+    // concatenate() keeps the order of the indices and offsets them by the
+    // vertices before, so no base vertex is needed
+    part.firstIndex = firstIndex;
+    part.indexCount = part.mesh->indexCount();
+    firstIndex += part.indexCount;
+  }
+  *instancedMesh_ =
+      Mn::MeshTools::compile(Mn::MeshTools::concatenate(meshes), compileFlags_);
+  instancedMesh_->addVertexBufferInstanced(
+      instanceBuffer_, 1, 0, Mn::Shaders::Phong::TransformationMatrix{},
+      Mn::Shaders::Phong::NormalMatrix{}, Mn::Shaders::Phong::ObjectId{},
+      Mn::Shaders::Phong::TextureOffset{});
+}
+
+void MultiDrawDrawable::drawSorted(const Mn::Matrix4& transformationMatrix,
+                                   Mn::SceneGraph::Camera3D& camera,
+                                   const DrawStateKey& previous) {
+  updateInstanceBuffer();
+  if (meshesDirty_) {
+    packMeshes();
+  }
+
+  // the cull stage, one command for every part in the frustum
+  const Mn::Frustum frustum = Mn::Frustum::fromMatrix(
+      camera.projectionMatrix() * camera.cameraMatrix());
+  commands_.clear();
+  for (std::size_t i = 0; i != parts_.size(); ++i) {
+    Part& part = parts_[i];
+    const Cr::Containers::Optional<Mn::Range3D> aabb =
+        instances_[i]->getSceneNode().getAbsoluteAABB();
+    if (aabb && testRangeFrustum(*aabb, frustum, part.frustumPlaneIndex) ==
+                    FrustumTestResult::Outside) {
+      continue;
+    }
+    commands_.push_back(
+        {part.indexCount, 1, part.firstIndex, 0, Mn::UnsignedInt(i)});
+  }
+  if (commands_.empty()) {
+    return;
+  }
+
+  setDrawState(transformationMatrix, camera, previous);
+
+#ifndef MAGNUM_TARGET_GLES
+  // Magnum doesn't wrap indirect draws, issue the call on the mesh's vertex
+  // array directly. Without vertex array objects the mesh has no id.
+  Mn::GL::Context& context = Mn::GL::Context::current();
+  if (instancedMesh_->id() &&
+      context.isExtensionSupported<
+          Mn::GL::Extensions::ARB::multi_draw_indirect>()) {
+    commandBuffer_.setData(commands_, Mn::GL::BufferUsage::StreamDraw);
+    context.resetState(Mn::GL::Context::State::EnterExternal);
+    glUseProgram(shader_->id());
+    glBindVertexArray(instancedMesh_->id());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer_.id());
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                commands_.size(), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+    context.resetState(Mn::GL::Context::State::ExitExternal);
+    return;
+  }
+
+  for (const DrawCommand& command : commands_) {
+    Mn::GL::MeshView view{*instancedMesh_};
+    view.setCount(command.count)
+        .setIndexRange(command.firstIndex)
+        .setInstanceCount(1)
+        .setBaseInstance(command.baseInstance);
+    shader_->draw(view);
+  }
+#endif
+}
+
+}  // namespace gfx
+}  // namespace esp
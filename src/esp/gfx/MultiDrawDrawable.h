@@ -0,0 +1,135 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/MeshTools/Compile.h>
+#include <Magnum/Trade/Trade.h>
+
+#include "esp/gfx/InstancedDrawable.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Draws many static meshes of one material and vertex layout with a
+ * single multi-draw-indirect call
+ *
+ * The meshes of the parts, see @ref addPart(), are packed into one vertex
+ * and one index buffer when the batch is next drawn after parts were added
+ * or removed. Each part is an instance of the packed mesh whose
+ * transformation and object ID are taken from the per-instance buffer of
+ * @ref InstancedDrawable at its base instance, so one indirect command per
+ * part draws it in place.
+ *
+ * Before each draw, the parts whose node has an absolute AABB are culled
+ * against the frustum of the camera and only the visible ones are written
+ * to the command buffer. The batch node itself has no bounds, so the parts
+ * aren't subject to occlusion culling or potentially visible sets. Where
+ * multi-draw-indirect isn't supported, the same commands are issued one by
+ * one.
+ */
+class MultiDrawDrawable : public InstancedDrawable {
+ public:
+  /**
+   * @brief Whether the GL context can draw the batches
+   *
+   * Needs base instances, desktop GL 4.2 or ARB_base_instance.
+   */
+  static bool isSupported();
+
+  /**
+   * @brief Constructor
+   *
+   * @param node          Batch node, must not be moved relative to the scene
+   *                      root
+   * @param compileFlags  Flags the packed mesh is compiled with, the same
+   *                      for all parts
+   * @param shaderManager Shader manager to fetch shaders and materials from
+   * @param lightSetup    Light setup key
+   * @param materialData  Material key
+   * @param batchKey      Key under which the drawable is registered in
+   *                      @p group, see
+   *                      @ref DrawableGroup::getInstancedDrawable()
+   * @param group         Drawable group this drawable will be added to
+   */
+  explicit MultiDrawDrawable(scene::SceneNode& node,
+                             Magnum::MeshTools::CompileFlags compileFlags,
+                             ShaderManager& shaderManager,
+                             const Magnum::ResourceKey& lightSetup,
+                             const Magnum::ResourceKey& materialData,
+                             const std::string& batchKey,
+                             DrawableGroup* group = nullptr);
+
+  /**
+   * @brief Draw @p mesh at the location of @p node
+   *
+   * @p mesh has to be indexed triangles with the same attributes as the
+   * other parts and has to stay alive as long as the part. The part is
+   * removed again when @p node is destroyed. @p textureOffset is as in
+   * @ref addInstance().
+   */
+  void addPart(scene::SceneNode& node,
+               const Magnum::Trade::MeshData& mesh,
+               const Magnum::Vector2& textureOffset = {});
+
+  /** @brief Number of parts */
+  size_t partCount() const { return parts_.size(); }
+
+  /**
+   * @brief Key of the vertex layout of @p mesh
+   *
+   * Meshes can be parts of the same batch only if their keys are equal.
+   */
+  static std::string layoutKey(const Magnum::Trade::MeshData& mesh);
+
+  /**
+   * @brief Number of triangles of the parts the last draw didn't cull
+   */
+  std::size_t drawnTriangleCount() override;
+
+ protected:
+  struct Part {
+    const Magnum::Trade::MeshData* mesh;
+    Magnum::UnsignedInt firstIndex;
+    Magnum::UnsignedInt indexCount;
+    // frustum plane that culled the part last, see testRangeFrustum()
+    int frustumPlaneIndex;
+  };
+
+  // laid out as expected by glMultiDrawElementsIndirect()
+  struct DrawCommand {
+    Magnum::UnsignedInt count;
+    Magnum::UnsignedInt instanceCount;
+    Magnum::UnsignedInt firstIndex;
+    Magnum::UnsignedInt baseVertex;
+    Magnum::UnsignedInt baseInstance;
+  };
+
+  void drawSorted(const Magnum::Matrix4& transformationMatrix,
+                  Magnum::SceneGraph::Camera3D& camera,
+                  const DrawStateKey& previous) override;
+
+  void removeInstance(Instance& instance) override;
+
+  /**
+   * @brief Pack the meshes of the parts into the instanced mesh
+   */
+  void packMeshes();
+
+  Magnum::MeshTools::CompileFlags compileFlags_;
+  // in the order of instances_, so each part's base instance is its index
+  std::vector<Part> parts_;
+  bool meshesDirty_ = true;
+  std::vector<DrawCommand> commands_;
+  Magnum::GL::Buffer commandBuffer_;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,75 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObjectIdHistogramShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/Version.h>
+
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(ShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+enum { ObjectIdTextureUnit = 0 };
+}
+
+ObjectIdHistogramShader::ObjectIdHistogramShader() {
+  if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"default-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL410;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  vert.addSource(rs.get("object-id-histogram.vert"));
+  frag.addSource(rs.get("object-id-histogram.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
+
+  viewportOriginUniform_ = uniformLocation("viewportOrigin");
+  outputWidthUniform_ = uniformLocation("outputWidth");
+  supersamplingUniform_ = uniformLocation("supersampling");
+  binCountUniform_ = uniformLocation("binCount");
+  setUniform(uniformLocation("objectIdTexture"), ObjectIdTextureUnit);
+}
+
+ObjectIdHistogramShader& ObjectIdHistogramShader::bindObjectIdTexture(
+    Mn::GL::Texture2D& texture) {
+  texture.bind(ObjectIdTextureUnit);
+  return *this;
+}
+
+ObjectIdHistogramShader& ObjectIdHistogramShader::setViewport(
+    const Mn::Range2Di& viewport,
+    int supersampling) {
+  setUniform(viewportOriginUniform_, viewport.min());
+  setUniform(outputWidthUniform_, viewport.sizeX() / supersampling);
+  setUniform(supersamplingUniform_, supersampling);
+  return *this;
+}
+
+ObjectIdHistogramShader& ObjectIdHistogramShader::setBinCount(int count) {
+  setUniform(binCountUniform_, count);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
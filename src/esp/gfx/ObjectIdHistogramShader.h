@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/Math/Range.h>
+
+#include "esp/gfx/CachedShaderProgram.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Object ID histogram shader
+
+Draws one point per output pixel of the object ID texture bound with
+@ref bindObjectIdTexture(), placed in the pixel of a 1-pixel-high framebuffer
+that is the bin of its ID. With additive blending into a float attachment,
+each pixel of the framebuffer ends up with the number of output pixels
+showing that ID. IDs at or past @ref setBinCount() aren't counted. Used by
+@ref RenderTarget to read object IDs as a histogram, see
+@ref RenderTarget::OutputFormat::objectIdHistogramBins.
+*/
+class ObjectIdHistogramShader : public CachedShaderProgram {
+ public:
+  /** @brief Constructor */
+  explicit ObjectIdHistogramShader();
+
+  /**
+   * @brief Bind the full-resolution object ID texture
+   * @return Reference to self (for method chaining)
+   */
+  ObjectIdHistogramShader& bindObjectIdTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Set the rectangle of the texture to count and how many times
+   * larger it is than the output
+   * @return Reference to self (for method chaining)
+   *
+   * Draw as many points as there are output pixels, one for each. Of each
+   * @p supersampling x @p supersampling block of texels, the one a nearest
+   * downsampling picks is counted.
+   */
+  ObjectIdHistogramShader& setViewport(const Magnum::Range2Di& viewport,
+                                       int supersampling);
+
+  /**
+   * @brief Set the number of bins, the width of the framebuffer drawn into
+   * @return Reference to self (for method chaining)
+   */
+  ObjectIdHistogramShader& setBinCount(int count);
+
+ private:
+  int viewportOriginUniform_, outputWidthUniform_, supersamplingUniform_,
+      binCountUniform_;
+};
+
+}  // namespace gfx
+}  // namespace esp
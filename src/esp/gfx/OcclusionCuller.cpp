@@ -0,0 +1,266 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "OcclusionCuller.h"
+
+#include <unordered_map>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/SampleQuery.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Shaders/Flat.h>
+
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/DrawableGroup.h"
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+// the cube [-1, 1]^3, face culling is off while querying so the winding
+// doesn't matter
+const Mn::Vector3 BoxVertices[]{
+    {-1.0f, -1.0f, -1.0f}, {1.0f, -1.0f, -1.0f}, {-1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, -1.0f},   {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f},
+    {-1.0f, 1.0f, 1.0f},   {1.0f, 1.0f, 1.0f}};
+const Mn::UnsignedByte BoxIndices[]{
+    0, 1, 3, 0, 3, 2,  // -Z
+    4, 6, 7, 4, 7, 5,  // +Z
+    0, 2, 6, 0, 6, 4,  // -X
+    1, 5, 7, 1, 7, 3,  // +X
+    0, 4, 5, 0, 5, 1,  // -Y
+    2, 3, 7, 2, 7, 6   // +Y
+};
+
+// boxes that reach in front of the near plane would be clipped to their far
+// faces, which can be hidden by geometry in front of the drawable itself
+bool reachesNearPlane(const Mn::Range3D& box,
+                      const Mn::Matrix4& viewProjection) {
+  for (int i = 0; i != 8; ++i) {
+    const Mn::Vector3 corner{i & 1 ? box.max().x() : box.min().x(),
+                             i & 2 ? box.max().y() : box.min().y(),
+                             i & 4 ? box.max().z() : box.min().z()};
+    const Mn::Vector4 clip = viewProjection * Mn::Vector4{corner, 1.0f};
+    if (clip.w() <= 0.0f || clip.z() < -clip.w()) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+struct OcclusionCuller::Impl {
+  struct Entry {
+    Mn::GL::SampleQuery query{Mn::NoCreate};
+    // last frame the drawable passed the frustum test in
+    std::size_t frame = 0;
+    bool occluded = false;
+    bool pending = false;
+  };
+
+  struct GroupState {
+    std::size_t cullingDataVersion = 0;
+    std::size_t frame = 0;
+    std::vector<Entry> entries;
+    // entries with a query in flight
+    std::vector<int> pending;
+  };
+
+  void beginFrame(DrawableGroup& drawables) {
+    group_ = &drawables;
+    state_ = &groups_[&drawables];
+    GroupState& state = *state_;
+    const std::size_t count = drawables.boundedDrawables().size();
+    if (state.cullingDataVersion != drawables.cullingDataVersion() ||
+        state.entries.size() != count) {
+      state = GroupState{};
+      state.cullingDataVersion = drawables.cullingDataVersion();
+      state.entries.resize(count);
+    }
+    ++state.frame;
+
+    // results that aren't there yet keep the previous visibility
+    auto stillPending = state.pending.begin();
+    for (int index : state.pending) {
+      Entry& entry = state.entries[index];
+      if (entry.query.resultAvailable()) {
+        entry.occluded = !entry.query.result<bool>();
+        entry.pending = false;
+      } else {
+        *stillPending++ = index;
+      }
+    }
+    state.pending.erase(stillPending, state.pending.end());
+  }
+
+  bool wasOccluded(int index) const {
+    const Entry& entry = state_->entries[index];
+    return entry.occluded && entry.frame + 1 == state_->frame;
+  }
+
+  // calls query(index, box) for every box in indices that doesn't reach the
+  // near plane, with GL state set up for drawing it without writing anything
+  template <typename Callable>
+  void drawBoxes(const std::vector<int>& indices,
+                 const Mn::Matrix4& viewProjection,
+                 bool colorWrites,
+                 Callable&& query) {
+    if (indices.empty()) {
+      return;
+    }
+    initBox();
+    Mn::GL::Renderer::setColorMask(false, false, false, false);
+    Mn::GL::Renderer::setDepthMask(false);
+    Mn::GL::Renderer::setDepthFunction(
+        Mn::GL::Renderer::DepthFunction::LessOrEqual);
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::FaceCulling);
+
+    const auto& bounded = group_->boundedDrawables();
+    for (int index : indices) {
+      Drawable& drawable = bounded[index];
+      // grown a bit so boxes of flat drawables don't vanish edge-on
+      const Mn::Range3D aabb = *drawable.getSceneNode().getAbsoluteAABB();
+      const Mn::Range3D box =
+          aabb.padded(Mn::Vector3{aabb.size().max() * 1.0e-3f + 1.0e-4f});
+      if (reachesNearPlane(box, viewProjection)) {
+        query(index, nullptr);
+        continue;
+      }
+      boxShader_.setTransformationProjectionMatrix(
+          viewProjection * Mn::Matrix4::translation(box.center()) *
+          Mn::Matrix4::scaling(box.size() * 0.5f));
+      query(index, &box);
+    }
+
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+    Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Less);
+    Mn::GL::Renderer::setDepthMask(true);
+    Mn::GL::Renderer::setColorMask(colorWrites, colorWrites, colorWrites,
+                                   colorWrites);
+  }
+
+  std::vector<int> testOccluded(const std::vector<int>& indices,
+                                const Mn::Matrix4& viewProjection,
+                                bool colorWrites) {
+    // issue all queries first so waiting for the first result waits for all
+    std::vector<int> queried;
+    std::vector<int> visible;
+    drawBoxes(indices, viewProjection, colorWrites,
+              [&](int index, const Mn::Range3D* box) {
+                Entry& entry = state_->entries[index];
+                entry.frame = state_->frame;
+                if (!box) {
+                  visible.push_back(index);
+                  return;
+                }
+                drawQuery(entry);
+                queried.push_back(index);
+              });
+    for (int index : queried) {
+      Entry& entry = state_->entries[index];
+      entry.pending = false;
+      if (entry.query.result<bool>()) {
+        visible.push_back(index);
+      }
+    }
+    for (int index : indices) {
+      state_->entries[index].occluded = true;
+    }
+    for (int index : visible) {
+      state_->entries[index].occluded = false;
+    }
+    return visible;
+  }
+
+  void queryDrawn(const std::vector<int>& indices,
+                  const Mn::Matrix4& viewProjection,
+                  bool colorWrites) {
+    drawBoxes(indices, viewProjection, colorWrites,
+              [&](int index, const Mn::Range3D* box) {
+                Entry& entry = state_->entries[index];
+                entry.frame = state_->frame;
+                entry.occluded = false;
+                // a query still in flight reports for this frame instead
+                if (!box || entry.pending) {
+                  return;
+                }
+                drawQuery(entry);
+                state_->pending.push_back(index);
+              });
+  }
+
+  void drawQuery(Entry& entry) {
+    if (!entry.query.id()) {
+      entry.query = Mn::GL::SampleQuery{
+          Mn::GL::SampleQuery::Target::AnySamplesPassed};
+    }
+    entry.query.begin();
+    boxShader_.draw(box_);
+    entry.query.end();
+    entry.pending = true;
+  }
+
+  void initBox() {
+    if (box_.id()) {
+      return;
+    }
+    boxVertices_ = Mn::GL::Buffer{};
+    boxVertices_.setData(BoxVertices);
+    boxIndices_ = Mn::GL::Buffer{};
+    boxIndices_.setData(BoxIndices);
+    box_ = Mn::GL::Mesh{};
+    box_.setCount(Cr::Containers::arraySize(BoxIndices))
+        .addVertexBuffer(boxVertices_, 0, Mn::Shaders::Flat3D::Position{})
+        .setIndexBuffer(boxIndices_, 0,
+                        Mn::GL::MeshIndexType::UnsignedByte);
+    boxShader_ = Mn::Shaders::Flat3D{};
+  }
+
+  // the state of every group drawn from this view, dropped only with the
+  // culler
+  std::unordered_map<const DrawableGroup*, GroupState> groups_;
+  DrawableGroup* group_ = nullptr;
+  GroupState* state_ = nullptr;
+
+  Mn::GL::Buffer boxVertices_{Mn::NoCreate};
+  Mn::GL::Buffer boxIndices_{Mn::NoCreate};
+  Mn::GL::Mesh box_{Mn::NoCreate};
+  Mn::Shaders::Flat3D boxShader_{Mn::NoCreate};
+};
+
+OcclusionCuller::OcclusionCuller()
+    : pimpl_(spimpl::make_unique_impl<Impl>()) {}
+
+void OcclusionCuller::beginFrame(DrawableGroup& drawables) {
+  pimpl_->beginFrame(drawables);
+}
+
+bool OcclusionCuller::wasOccluded(int index) const {
+  return pimpl_->wasOccluded(index);
+}
+
+std::vector<int> OcclusionCuller::testOccluded(const std::vector<int>& indices,
+                                               const Mn::Matrix4& projection,
+                                               const Mn::Matrix4& camera,
+                                               bool colorWrites) {
+  return pimpl_->testOccluded(indices, projection * camera, colorWrites);
+}
+
+void OcclusionCuller::queryDrawn(const std::vector<int>& indices,
+                                 const Mn::Matrix4& projection,
+                                 const Mn::Matrix4& camera,
+                                 bool colorWrites) {
+  pimpl_->queryDrawn(indices, projection * camera, colorWrites);
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,83 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include <Magnum/Magnum.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+class DrawableGroup;
+
+/**
+ * @brief Occlusion culling of static drawables with GL occlusion queries
+ *
+ * Keeps the visibility of every bounded drawable of a @ref DrawableGroup, see
+ * @ref DrawableGroup::boundedDrawables(), as seen by one view in its last
+ * frame. @ref RenderCamera::draw(DrawableGroup&, bool) draws what was
+ * visible, then tests the absolute AABBs of what was occluded against the
+ * depth buffer with @ref testOccluded() and draws the boxes that pass, so
+ * the images are the same as without culling. The boxes of everything drawn
+ * are queried again with @ref queryDrawn() for the next frame, whose results
+ * are collected without waiting by @ref beginFrame().
+ *
+ * Views see different occluders, so every sensor has its own instance.
+ */
+class OcclusionCuller {
+ public:
+  OcclusionCuller();
+
+  /**
+   * @brief Start a frame of @p drawables
+   *
+   * Collects the query results that are available. State of a group whose
+   * culling data was rebuilt is dropped.
+   */
+  void beginFrame(DrawableGroup& drawables);
+
+  /**
+   * @brief Whether the bounded drawable @p index was occluded in the last
+   * frame it passed the frustum test in, if that frame was the previous one
+   *
+   * Drawables that reenter the frustum are treated as visible.
+   */
+  bool wasOccluded(int index) const;
+
+  /**
+   * @brief Test the boxes of @p indices against the current depth buffer
+   * @param indices      Bounded drawables occluded in the last frame
+   * @param projection   Projection matrix of the view
+   * @param camera       Camera matrix of the view
+   * @param colorWrites  Whether color writes get enabled again after the
+   *                     test
+   * @return The drawables whose box has a visible sample
+   *
+   * Waits for the query results.
+   */
+  std::vector<int> testOccluded(const std::vector<int>& indices,
+                                const Magnum::Matrix4& projection,
+                                const Magnum::Matrix4& camera,
+                                bool colorWrites);
+
+  /**
+   * @brief Query the boxes of the drawn bounded drawables for the next frame
+   *
+   * Call after the whole frame is drawn, the results are read by the next
+   * @ref beginFrame().
+   */
+  void queryDrawn(const std::vector<int>& indices,
+                  const Magnum::Matrix4& projection,
+                  const Magnum::Matrix4& camera,
+                  bool colorWrites);
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(OcclusionCuller)
+};
+
+}  // namespace gfx
+}  // namespace esp
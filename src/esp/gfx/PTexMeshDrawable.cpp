@@ -12,6 +12,7 @@ namespace gfx {
 
 // static constexpr arrays require redundant definitions until C++17
 constexpr char PTexMeshDrawable::SHADER_KEY[];
+constexpr char PTexMeshDrawable::VERTEX_PULLING_SHADER_KEY[];
 
 PTexMeshDrawable::PTexMeshDrawable(scene::SceneNode& node,
                                    assets::PTexMeshData& ptexMeshData,
@@ -24,23 +25,40 @@ PTexMeshDrawable::PTexMeshDrawable(scene::SceneNode& node,
       adjFacesBufferTexture_(
           ptexMeshData.getRenderingBuffer(submeshID)->adjFacesBufferTexture),
 #endif
+      vertexBufferTexture_(
+          ptexMeshData.getRenderingBuffer(submeshID)->vertexBufferTexture),
+      indexBufferTexture_(
+          ptexMeshData.getRenderingBuffer(submeshID)->indexBufferTexture),
       tileSize_(ptexMeshData.tileSize()),
       exposure_(ptexMeshData.exposure()),
       gamma_(ptexMeshData.gamma()),
       saturation_(ptexMeshData.saturation()) {
+  // the mesh is set up for one of the two shader variants on upload
+  const bool vertexPulling = ptexMeshData.vertexPulling();
   auto shaderResource =
       shaderManager.get<Magnum::GL::AbstractShaderProgram, PTexMeshShader>(
-          SHADER_KEY);
+          vertexPulling ? VERTEX_PULLING_SHADER_KEY : SHADER_KEY);
 
   if (!shaderResource) {
-    shaderManager.set<Magnum::GL::AbstractShaderProgram>(shaderResource.key(),
-                                                         new PTexMeshShader{});
+    shaderManager.set<Magnum::GL::AbstractShaderProgram>(
+        shaderResource.key(),
+        new PTexMeshShader{vertexPulling ? PTexMeshShader::Flag::VertexPulling
+                                         : PTexMeshShader::Flags{}});
   }
   shader_ = &(*shaderResource);
 }
 
+DrawStateKey PTexMeshDrawable::drawStateKey() {
+  return {shader_, &atlasTexture_, nullptr, &mesh_};
+}
+
 void PTexMeshDrawable::draw(const Magnum::Matrix4& transformationMatrix,
                             Magnum::SceneGraph::Camera3D& camera) {
+  if (shader_->flags() & PTexMeshShader::Flag::VertexPulling) {
+    (*shader_)
+        .bindVertexBufferTexture(vertexBufferTexture_)
+        .bindIndexBufferTexture(indexBufferTexture_);
+  }
   (*shader_)
       .setExposure(exposure_)
       .setGamma(gamma_)
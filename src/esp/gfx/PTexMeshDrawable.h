@@ -24,6 +24,10 @@ class PTexMeshDrawable : public Drawable {
                             DrawableGroup* group = nullptr);
 
   static constexpr char SHADER_KEY[] = "PTexMeshShader";
+  static constexpr char VERTEX_PULLING_SHADER_KEY[] =
+      "PTexMeshShader-vertex-pulling";
+
+  DrawStateKey drawStateKey() override;
 
  protected:
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
@@ -33,6 +37,8 @@ class PTexMeshDrawable : public Drawable {
 #ifndef CORRADE_TARGET_APPLE
   Magnum::GL::BufferTexture& adjFacesBufferTexture_;
 #endif
+  Magnum::GL::BufferTexture& vertexBufferTexture_;
+  Magnum::GL::BufferTexture& indexBufferTexture_;
   uint32_t tileSize_;
   float exposure_;
   float gamma_;
@@ -34,10 +34,12 @@ enum TextureBindingPointIndex : uint8_t {
 #ifndef CORRADE_TARGET_APPLE
   adjFaces = 1,
 #endif
+  vertices = 2,
+  indices = 3,
 };
 }  // namespace
 
-PTexMeshShader::PTexMeshShader() {
+PTexMeshShader::PTexMeshShader(Flags flags) : flags_{flags} {
   MAGNUM_ASSERT_GL_VERSION_SUPPORTED(Mn::GL::Version::GL410);
 
   if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
@@ -51,18 +53,24 @@ PTexMeshShader::PTexMeshShader() {
   Mn::GL::Shader geom{Mn::GL::Version::GL410, Mn::GL::Shader::Type::Geometry};
   Mn::GL::Shader frag{Mn::GL::Version::GL410, Mn::GL::Shader::Type::Fragment};
 
-  vert.addSource(rs.get("ptex-default-gl410.vert"));
-  geom.addSource(rs.get("ptex-default-gl410.geom"));
+  const bool vertexPulling = flags & Flag::VertexPulling;
 #ifdef CORRADE_TARGET_APPLE
   frag.addSource("#define CORRADE_TARGET_APPLE\n");
 #endif
+  if (vertexPulling) {
+    vert.addSource(rs.get("ptex-vertex-pulling-gl410.vert"));
+    frag.addSource("#define VERTEX_PULLING\n");
+  } else {
+    vert.addSource(rs.get("ptex-default-gl410.vert"));
+    geom.addSource(rs.get("ptex-default-gl410.geom"));
+  }
   frag.addSource(rs.get("ptex-default-gl410.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(Mn::GL::Shader::compile({vert, geom, frag}));
-
-  attachShaders({vert, geom, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  if (vertexPulling) {
+    CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
+  } else {
+    CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, geom, frag}));
+  }
 
   // set texture binding points in the shader;
   // see ptex fragment shader code for details
@@ -71,6 +79,12 @@ PTexMeshShader::PTexMeshShader() {
   setUniform(uniformLocation("meshAdjFaces"),
              TextureBindingPointIndex::adjFaces);
 #endif
+  if (vertexPulling) {
+    setUniform(uniformLocation("meshVertices"),
+               TextureBindingPointIndex::vertices);
+    setUniform(uniformLocation("meshIndices"),
+               TextureBindingPointIndex::indices);
+  }
 
   // cache the uniform locations
   MVPMatrixUniform_ = uniformLocation("MVP");
@@ -97,6 +111,18 @@ PTexMeshShader& PTexMeshShader::bindAdjFacesBufferTexture(
   return *this;
 }
 
+PTexMeshShader& PTexMeshShader::bindVertexBufferTexture(
+    Mn::GL::BufferTexture& texture) {
+  texture.bind(TextureBindingPointIndex::vertices);
+  return *this;
+}
+
+PTexMeshShader& PTexMeshShader::bindIndexBufferTexture(
+    Mn::GL::BufferTexture& texture) {
+  texture.bind(TextureBindingPointIndex::indices);
+  return *this;
+}
+
 PTexMeshShader& PTexMeshShader::setMVPMatrix(const Mn::Matrix4& matrix) {
   setUniform(MVPMatrixUniform_, matrix);
   return *this;
@@ -7,10 +7,11 @@
 #include <memory>
 #include <vector>
 
-#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Corrade/Containers/EnumSet.h>
 #include <Magnum/Math/Matrix4.h>
 
 #include "esp/assets/PTexMeshData.h"
+#include "esp/gfx/CachedShaderProgram.h"
 
 namespace esp {
 
@@ -21,15 +22,43 @@ class PTexMeshData;
 
 namespace gfx {
 
-class PTexMeshShader : public Magnum::GL::AbstractShaderProgram {
+class PTexMeshShader : public CachedShaderProgram {
  public:
   //! @brief vertex positions
   typedef Magnum::GL::Attribute<0, Magnum::Vector3> Position;
 
+  /**
+   * @brief Flag
+   *
+   * @see @ref Flags, @ref flags()
+   */
+  enum class Flag : uint8_t {
+    /**
+     * Draw the quads as two triangles each, fetching positions from
+     * @ref bindVertexBufferTexture() and @ref bindIndexBufferTexture()
+     * in the vertex shader, instead of expanding lines with adjacency in a
+     * geometry shader. Looks the same, but avoids the geometry shader, which
+     * is slow on some GPUs at high resolutions. The mesh drawn needs no
+     * attributes and six vertices per quad, see
+     * @ref assets::PTexMeshData::setVertexPulling().
+     */
+    VertexPulling = 1 << 0,
+  };
+
+  /**
+   * @brief Flags
+   *
+   * @see @ref flags()
+   */
+  typedef Corrade::Containers::EnumSet<Flag> Flags;
+
   /**
    * @brief Constructor
    */
-  explicit PTexMeshShader();
+  explicit PTexMeshShader(Flags flags = {});
+
+  /** @brief Flags */
+  Flags flags() const { return flags_; }
 
   // ======== texture binding ========
   /**
@@ -42,6 +71,20 @@ class PTexMeshShader : public Magnum::GL::AbstractShaderProgram {
    *  @return Reference to self (for method chaining)
    */
   PTexMeshShader& bindAdjFacesBufferTexture(Magnum::GL::BufferTexture& texture);
+  /**
+   *  @brief Bind the buffer texture containing the vertex positions
+   *
+   *  Only used with @ref Flag::VertexPulling.
+   *  @return Reference to self (for method chaining)
+   */
+  PTexMeshShader& bindVertexBufferTexture(Magnum::GL::BufferTexture& texture);
+  /**
+   *  @brief Bind the buffer texture containing the quad indices
+   *
+   *  Only used with @ref Flag::VertexPulling.
+   *  @return Reference to self (for method chaining)
+   */
+  PTexMeshShader& bindIndexBufferTexture(Magnum::GL::BufferTexture& texture);
 
   // ======== set uniforms ===========
   /**
@@ -72,6 +115,8 @@ class PTexMeshShader : public Magnum::GL::AbstractShaderProgram {
                                       uint32_t tileSize);
 
  protected:
+  Flags flags_;
+
   // it hurts the performance to call glGetUniformLocation() every frame due to
   // string operations.
   // therefore, cache the locations in the constructor
@@ -83,5 +128,7 @@ class PTexMeshShader : public Magnum::GL::AbstractShaderProgram {
   int widthInTilesUniform_;
 };
 
+CORRADE_ENUMSET_OPERATORS(PTexMeshShader::Flags)
+
 }  // namespace gfx
 }  // namespace esp
@@ -0,0 +1,51 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PhongShader.h"
+
+#include <utility>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+PhongShader::PhongShader(Flags flags, Mn::UnsignedInt lightCount)
+    : Mn::Shaders::Phong{flags, lightCount} {}
+
+PhongShader& PhongShader::setLights(const LightSetup& lightSetup,
+                                    const Mn::Matrix4& transformationMatrix,
+                                    const Mn::Matrix4& cameraMatrix) {
+  nextLightPositions_.clear();
+  nextLightColors_.clear();
+  for (const LightInfo& light : lightSetup) {
+    nextLightPositions_.push_back(getLightPositionRelativeToCamera(
+        light, transformationMatrix, cameraMatrix));
+    nextLightColors_.push_back(light.color);
+  }
+
+  if (nextLightPositions_ != lightPositions_) {
+    setLightPositions(nextLightPositions_);
+    std::swap(lightPositions_, nextLightPositions_);
+  }
+  if (nextLightColors_ != lightColors_) {
+    setLightColors(nextLightColors_);
+    std::swap(lightColors_, nextLightColors_);
+  }
+  return *this;
+}
+
+PhongShader& PhongShader::setProjectionMatrixCached(
+    const Mn::Matrix4& matrix) {
+  if (matrix != projectionMatrix_) {
+    setProjectionMatrix(matrix);
+    projectionMatrix_ = matrix;
+  }
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
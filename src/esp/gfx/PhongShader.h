@@ -0,0 +1,62 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Shaders/Phong.h>
+
+#include "esp/gfx/LightSetup.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Phong shader that skips uploading uniforms which didn't change
+ *
+ * Uniforms stay in the program between draws, and the lights and the
+ * projection are the same for all drawables of a frame unless lights are
+ * placed relative to the drawn object. The shader remembers what it last
+ * uploaded for them, so drawing many objects with one shader uploads the
+ * lights and the projection once per frame and only the transformations for
+ * every draw.
+ */
+class PhongShader : public Magnum::Shaders::Phong {
+ public:
+  explicit PhongShader(Flags flags, Magnum::UnsignedInt lightCount);
+
+  /**
+   * @brief Set the light positions and colors for drawing an object
+   *
+   * @param lightSetup            Lights, one for each light of the shader
+   * @param transformationMatrix  Object position relative to the camera
+   * @param cameraMatrix          World position relative to the camera
+   *
+   * Only uploads the positions and colors if they differ from the ones
+   * uploaded last.
+   */
+  PhongShader& setLights(const LightSetup& lightSetup,
+                         const Magnum::Matrix4& transformationMatrix,
+                         const Magnum::Matrix4& cameraMatrix);
+
+  /**
+   * @brief Set the projection matrix, unless it's uploaded already
+   */
+  PhongShader& setProjectionMatrixCached(const Magnum::Matrix4& matrix);
+
+ private:
+  // what is in the program, empty and zero before the first upload
+  std::vector<Magnum::Vector3> lightPositions_;
+  std::vector<Magnum::Color4> lightColors_;
+  Magnum::Matrix4 projectionMatrix_{Magnum::Math::ZeroInit};
+  // scratch space for the values of the next draw
+  std::vector<Magnum::Vector3> nextLightPositions_;
+  std::vector<Magnum::Color4> nextLightColors_;
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,356 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PotentiallyVisibleSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <tuple>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/gfx/DepthUnprojection.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/OcclusionCuller.h"
+#include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderTarget.h"
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+constexpr char PVS_MAGIC[8]{'E', 'S', 'P', 'P', 'V', 'S', 'E', 'T'};
+constexpr uint32_t PVS_VERSION = 1;
+
+struct PvsHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t drawableCount;
+  uint32_t cellCount;
+  float cellSize;
+  float cellHeight;
+  float minEyeHeight;
+  float maxEyeHeight;
+};
+
+struct PvsCell {
+  Mn::Vector3i coordinates;
+  float minHeight;
+  float maxHeight;
+  // followed by this many drawable indices
+  uint32_t visibleCount;
+};
+
+static_assert(sizeof(PvsHeader) == 36, "unexpected PVS header size");
+static_assert(sizeof(PvsCell) == 24, "unexpected PVS cell size");
+
+// how much the eye may be outside of the eye heights of a cell, e.g. for a
+// sensor a bit off the sampled heights
+constexpr float EyeHeightTolerance = 0.25f;
+
+bool lessColumn(const std::pair<Mn::Vector2i, int>& a,
+                const std::pair<Mn::Vector2i, int>& b) {
+  return std::make_pair(a.first.x(), a.first.y()) <
+         std::make_pair(b.first.x(), b.first.y());
+}
+
+// directions and up vectors of six 90 degree views covering all directions
+const Mn::Vector3 FaceDirections[6][2]{
+    {Mn::Vector3::xAxis(), Mn::Vector3::yAxis()},
+    {-Mn::Vector3::xAxis(), Mn::Vector3::yAxis()},
+    {Mn::Vector3::yAxis(), Mn::Vector3::zAxis()},
+    {-Mn::Vector3::yAxis(), Mn::Vector3::zAxis()},
+    {Mn::Vector3::zAxis(), Mn::Vector3::yAxis()},
+    {-Mn::Vector3::zAxis(), Mn::Vector3::yAxis()}};
+}  // namespace
+
+Mn::Vector3i PotentiallyVisibleSet::cellCoordinates(
+    const Mn::Vector3& point) const {
+  return {int(std::floor(point.x() / settings_.cellSize)),
+          int(std::floor(point.y() / settings_.cellHeight)),
+          int(std::floor(point.z() / settings_.cellSize))};
+}
+
+PotentiallyVisibleSet PotentiallyVisibleSet::compute(
+    DrawableGroup& drawables,
+    RenderCamera& camera,
+    const std::vector<Mn::Vector3>& points,
+    const Settings& settings) {
+  CORRADE_ASSERT(settings.cellSize > 0.0f && settings.cellHeight > 0.0f &&
+                     settings.eyeHeightCount > 0 && settings.faceSize > 0,
+                 "PotentiallyVisibleSet::compute(): invalid settings", {});
+
+  PotentiallyVisibleSet pvs;
+  pvs.settings_ = settings;
+  drawables.updateCullingData();
+  const auto& bounded = drawables.boundedDrawables();
+  for (Drawable& drawable : bounded) {
+    pvs.boxes_.push_back(*drawable.getSceneNode().getAbsoluteAABB());
+  }
+
+  const Mn::Vector2i size{settings.faceSize};
+  camera.setProjectionMatrix(size.x(), size.y(), 0.01f, 1000.0f, 90.0f);
+  camera.setOcclusionCuller(nullptr).setPotentiallyVisibleSet(nullptr);
+  const Mn::Matrix4 projection = camera.projectionMatrix();
+  RenderTarget target{size, calculateDepthUnprojection(projection), nullptr,
+                      {}};
+  OcclusionCuller culler;
+
+  std::map<std::tuple<int, int, int>, Cell> cells;
+  std::vector<int> candidates;
+  for (const Mn::Vector3& point : points) {
+    const Mn::Vector3i coordinates = pvs.cellCoordinates(point);
+    Cell& cell =
+        cells
+            .emplace(std::make_tuple(coordinates.x(), coordinates.y(),
+                                     coordinates.z()),
+                     Cell{coordinates, point.y(), point.y(),
+                          std::vector<bool>(bounded.size())})
+            .first->second;
+    cell.minHeight = std::min(cell.minHeight, point.y());
+    cell.maxHeight = std::max(cell.maxHeight, point.y());
+
+    for (int i = 0; i != settings.eyeHeightCount; ++i) {
+      const float height =
+          settings.eyeHeightCount == 1
+              ? settings.minEyeHeight
+              : Mn::Math::lerp(settings.minEyeHeight, settings.maxEyeHeight,
+                               float(i) / (settings.eyeHeightCount - 1));
+      const Mn::Vector3 eye = point + Mn::Vector3::yAxis(height);
+      for (const auto& face : FaceDirections) {
+        camera.node().setTransformation(
+            Mn::Matrix4::lookAt(eye, eye + face[0], face[1]));
+        target.renderEnter();
+        camera.draw(drawables, true);
+
+        const Mn::Matrix4 cameraMatrix = camera.cameraMatrix();
+        candidates.clear();
+        drawables.cullingBVH().cull(
+            Mn::Frustum::fromMatrix(projection * cameraMatrix),
+            [&](int index) { candidates.push_back(index); });
+        culler.beginFrame(drawables);
+        for (int index : culler.testOccluded(candidates, projection,
+                                             cameraMatrix, true)) {
+          cell.visible[index] = true;
+        }
+        target.renderExit();
+      }
+    }
+  }
+
+  // views between the samples may see what the neighbors see
+  for (auto& entry : cells) {
+    Cell cell = entry.second;
+    const Mn::Vector3i center = cell.coordinates;
+    const int d = settings.dilation;
+    for (int x = center.x() - d; x <= center.x() + d; ++x) {
+      for (int y = center.y() - d; y <= center.y() + d; ++y) {
+        for (int z = center.z() - d; z <= center.z() + d; ++z) {
+          auto found = cells.find(std::make_tuple(x, y, z));
+          if (found == cells.end()) {
+            continue;
+          }
+          const std::vector<bool>& neighbor = found->second.visible;
+          for (std::size_t i = 0; i != neighbor.size(); ++i) {
+            if (neighbor[i]) {
+              cell.visible[i] = true;
+            }
+          }
+        }
+      }
+    }
+    pvs.cells_.push_back(std::move(cell));
+  }
+  pvs.index();
+  return pvs;
+}
+
+void PotentiallyVisibleSet::index() {
+  columns_.clear();
+  for (int i = 0; i != int(cells_.size()); ++i) {
+    const Mn::Vector3i& coordinates = cells_[i].coordinates;
+    columns_.emplace_back(Mn::Vector2i{coordinates.x(), coordinates.z()}, i);
+  }
+  std::sort(columns_.begin(), columns_.end(), lessColumn);
+  checkedDrawables_ = nullptr;
+}
+
+bool PotentiallyVisibleSet::save(const std::string& filename) const {
+  PvsHeader header{};
+  std::memcpy(header.magic, PVS_MAGIC, sizeof(PVS_MAGIC));
+  header.version = PVS_VERSION;
+  header.drawableCount = boxes_.size();
+  header.cellCount = cells_.size();
+  header.cellSize = settings_.cellSize;
+  header.cellHeight = settings_.cellHeight;
+  header.minEyeHeight = settings_.minEyeHeight;
+  header.maxEyeHeight = settings_.maxEyeHeight;
+
+  std::ofstream file(filename, std::ios::out | std::ios::binary);
+  if (!file.good()) {
+    LOG(ERROR) << "Cannot open " << filename << " for writing";
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(boxes_.data()),
+             boxes_.size() * sizeof(Mn::Range3D));
+  std::vector<uint32_t> indices;
+  for (const Cell& cell : cells_) {
+    indices.clear();
+    for (std::size_t i = 0; i != cell.visible.size(); ++i) {
+      if (cell.visible[i]) {
+        indices.push_back(i);
+      }
+    }
+    const PvsCell entry{cell.coordinates, cell.minHeight, cell.maxHeight,
+                        uint32_t(indices.size())};
+    file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    file.write(reinterpret_cast<const char*>(indices.data()),
+               indices.size() * sizeof(uint32_t));
+  }
+  if (!file.good()) {
+    LOG(ERROR) << "Failed writing " << filename;
+    return false;
+  }
+  return true;
+}
+
+bool PotentiallyVisibleSet::load(const std::string& filename) {
+  *this = PotentiallyVisibleSet{};
+  const Cr::Containers::Array<const char, Cr::Utility::Directory::MapDeleter>
+      mapped = Cr::Utility::Directory::mapRead(filename);
+  PvsHeader header;
+  if (mapped.size() < sizeof(PvsHeader)) {
+    LOG(ERROR) << "PVS file " << filename << " is too short";
+    return false;
+  }
+  std::memcpy(&header, mapped.data(), sizeof(header));
+  if (std::memcmp(header.magic, PVS_MAGIC, sizeof(PVS_MAGIC)) != 0 ||
+      header.version != PVS_VERSION) {
+    LOG(ERROR) << filename << " is not a PVS file of version " << PVS_VERSION;
+    return false;
+  }
+
+  const char* data = mapped.data() + sizeof(PvsHeader);
+  const char* const end = mapped.data() + mapped.size();
+  const auto read = [&](void* destination, std::size_t size) {
+    if (std::size_t(end - data) < size) {
+      return false;
+    }
+    std::memcpy(destination, data, size);
+    data += size;
+    return true;
+  };
+
+  PotentiallyVisibleSet pvs;
+  pvs.settings_.cellSize = header.cellSize;
+  pvs.settings_.cellHeight = header.cellHeight;
+  pvs.settings_.minEyeHeight = header.minEyeHeight;
+  pvs.settings_.maxEyeHeight = header.maxEyeHeight;
+  pvs.boxes_.resize(header.drawableCount);
+  bool complete =
+      read(pvs.boxes_.data(), pvs.boxes_.size() * sizeof(Mn::Range3D));
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; complete && i != header.cellCount; ++i) {
+    PvsCell entry;
+    complete = read(&entry, sizeof(entry));
+    if (!complete) {
+      break;
+    }
+    indices.resize(entry.visibleCount);
+    complete = read(indices.data(), indices.size() * sizeof(uint32_t));
+    Cell cell{entry.coordinates, entry.minHeight, entry.maxHeight,
+              std::vector<bool>(header.drawableCount)};
+    for (uint32_t index : indices) {
+      if (index >= header.drawableCount) {
+        LOG(ERROR) << "PVS file " << filename << " has an invalid index";
+        return false;
+      }
+      cell.visible[index] = true;
+    }
+    pvs.cells_.push_back(std::move(cell));
+  }
+  if (!complete) {
+    LOG(ERROR) << "PVS file " << filename << " is truncated";
+    return false;
+  }
+  pvs.index();
+  *this = std::move(pvs);
+  return true;
+}
+
+bool PotentiallyVisibleSet::matches(const DrawableGroup& drawables) const {
+  const auto& bounded = drawables.boundedDrawables();
+  if (bounded.size() < boxes_.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i != boxes_.size(); ++i) {
+    const Mn::Range3D& box = boxes_[i];
+    const Mn::Range3D current =
+        *bounded[i].get().getSceneNode().getAbsoluteAABB();
+    const float tolerance = 1.0e-4f * (box.size().max() + 1.0f);
+    if (!((current.min() - box.min()).abs() <= Mn::Vector3{tolerance})
+             .all() ||
+        !((current.max() - box.max()).abs() <= Mn::Vector3{tolerance})
+             .all()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const std::vector<bool>* PotentiallyVisibleSet::visibleDrawables(
+    const DrawableGroup& drawables,
+    const Mn::Vector3& eye) {
+  if (checkedDrawables_ != &drawables ||
+      checkedVersion_ != drawables.cullingDataVersion()) {
+    checkedDrawables_ = &drawables;
+    checkedVersion_ = drawables.cullingDataVersion();
+    checkedMatch_ = matches(drawables);
+    if (!checkedMatch_) {
+      LOG(WARNING) << "PotentiallyVisibleSet: the drawables don't match the "
+                      "ones the set was computed for, not using it";
+    }
+  }
+  if (!checkedMatch_) {
+    return nullptr;
+  }
+
+  const Mn::Vector3i coordinates = cellCoordinates(eye);
+  const std::pair<Mn::Vector2i, int> column{
+      Mn::Vector2i{coordinates.x(), coordinates.z()}, 0};
+  auto range = std::equal_range(columns_.begin(), columns_.end(), column,
+                                lessColumn);
+  const Cell* found = nullptr;
+  for (auto it = range.first; it != range.second; ++it) {
+    const Cell& cell = cells_[it->second];
+    if (eye.y() < cell.minHeight + settings_.minEyeHeight -
+                      EyeHeightTolerance ||
+        eye.y() > cell.maxHeight + settings_.maxEyeHeight +
+                      EyeHeightTolerance) {
+      continue;
+    }
+    // floors closer than the eye heights, can't tell which one the eye is on
+    if (found) {
+      return nullptr;
+    }
+    found = &cell;
+  }
+  return found ? &found->visible : nullptr;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,133 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+class DrawableGroup;
+class RenderCamera;
+
+/**
+ * @brief Drawables visible from the cells of a navmesh, precomputed offline
+ *
+ * Agents only move on the navmesh, so what their sensors can see only
+ * depends on where on the navmesh they are. The navmesh is divided into
+ * cells of @ref Settings::cellSize times @ref Settings::cellHeight and each
+ * cell lists the bounded drawables of a @ref DrawableGroup, see
+ * @ref DrawableGroup::boundedDrawables(), that are visible from views at
+ * @ref Settings::minEyeHeight to @ref Settings::maxEyeHeight above the
+ * navmesh points sampled in it. @ref RenderCamera::draw(DrawableGroup&, bool)
+ * skips the others before frustum culling, see
+ * @ref RenderCamera::setPotentiallyVisibleSet().
+ *
+ * Computed by @ref compute(), e.g. by the @cb{.sh} datatool compute_pvs @ce
+ * task. The visibility is sampled at the points, cells are grown by their
+ * neighbors' sets to cover views in between, see @ref Settings::dilation.
+ */
+class PotentiallyVisibleSet {
+ public:
+  /** @brief Parameters of @ref compute() */
+  struct Settings {
+    /** @brief Horizontal size of the cells */
+    float cellSize = 2.0f;
+    /** @brief Vertical size of the cells, separates the floors */
+    float cellHeight = 1.0f;
+    /** @brief Lowest eye height above the navmesh */
+    float minEyeHeight = 1.0f;
+    /** @brief Highest eye height above the navmesh */
+    float maxEyeHeight = 1.75f;
+    /** @brief Eye heights sampled between the two, at least 1 */
+    int eyeHeightCount = 2;
+    /** @brief Size of the cube map faces rendered from each view */
+    int faceSize = 128;
+    /** @brief Cells whose sets are merged into each cell, in every direction */
+    int dilation = 1;
+  };
+
+  /**
+   * @brief Compute the visible drawables of the cells around @p points
+   * @param drawables  Drawable group to compute the visibility of
+   * @param camera     Camera of the scene graph of @p drawables, its
+   *                   projection and transformation are overwritten
+   * @param points     Points on the navmesh, each cell is computed from the
+   *                   ones in it
+   * @param settings   Parameters
+   *
+   * Renders a cube map from every eye position and tests the absolute AABBs
+   * of the drawables against its depth with occlusion queries, see
+   * @ref OcclusionCuller. Needs a GL context.
+   */
+  static PotentiallyVisibleSet compute(
+      DrawableGroup& drawables,
+      RenderCamera& camera,
+      const std::vector<Magnum::Vector3>& points,
+      const Settings& settings);
+
+  /**
+   * @brief Load from a file written by @ref save()
+   * @return Whether the file was read. An empty set is left otherwise.
+   */
+  bool load(const std::string& filename);
+
+  /** @brief Save to a file */
+  bool save(const std::string& filename) const;
+
+  /** @brief Number of cells */
+  std::size_t cellCount() const { return cells_.size(); }
+
+  /** @brief Number of drawables the set was computed for */
+  std::size_t drawableCount() const { return boxes_.size(); }
+
+  /**
+   * @brief Drawables potentially visible from @p eye, if the set applies
+   * @return One flag for each of the first @ref drawableCount() bounded
+   *    drawables of @p drawables, or nullptr if the set doesn't cover @p eye
+   *    or wasn't computed for @p drawables
+   *
+   * The set applies while the first @ref drawableCount() bounded drawables
+   * have the boxes it was computed with, drawables added to the group later
+   * aren't covered by it. @p eye is covered by the one cell under it whose
+   * eye heights it is at.
+   */
+  const std::vector<bool>* visibleDrawables(const DrawableGroup& drawables,
+                                            const Magnum::Vector3& eye);
+
+ private:
+  struct Cell {
+    Magnum::Vector3i coordinates;
+    float minHeight;
+    float maxHeight;
+    std::vector<bool> visible;
+  };
+
+  Magnum::Vector3i cellCoordinates(const Magnum::Vector3& point) const;
+  bool matches(const DrawableGroup& drawables) const;
+  void index();
+
+  Settings settings_;
+  std::vector<Magnum::Range3D> boxes_;
+  std::vector<Cell> cells_;
+  // cells by their horizontal coordinates, for the lookup of a position
+  std::vector<std::pair<Magnum::Vector2i, int>> columns_;
+
+  // group and culling data version the boxes were last checked against
+  const DrawableGroup* checkedDrawables_ = nullptr;
+  std::size_t checkedVersion_ = 0;
+  bool checkedMatch_ = false;
+
+  ESP_SMART_POINTERS(PotentiallyVisibleSet)
+};
+
+}  // namespace gfx
+}  // namespace esp
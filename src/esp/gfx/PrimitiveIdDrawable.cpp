@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PrimitiveIdDrawable.h"
+
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferTexture.h>
+#include <Magnum/Shaders/Flat.h>
+
+#include "esp/gfx/PrimitiveIdShader.h"
+
+namespace esp {
+namespace gfx {
+
+// static constexpr arrays require redundant definitions until C++17
+constexpr char PrimitiveIdDrawable::SHADER_KEY[];
+
+PrimitiveIdDrawable::PrimitiveIdDrawable(scene::SceneNode& node,
+                                         Magnum::GL::Mesh& mesh,
+                                         Magnum::GL::BufferTexture& objectIds,
+                                         ShaderManager& shaderManager,
+                                         DrawableGroup* group /* = nullptr */)
+    : Drawable{node, mesh, group}, objectIds_(objectIds) {
+  auto shaderResource =
+      shaderManager.get<Magnum::GL::AbstractShaderProgram, PrimitiveIdShader>(
+          SHADER_KEY);
+  if (!shaderResource) {
+    shaderManager.set<Magnum::GL::AbstractShaderProgram>(
+        shaderResource.key(), new PrimitiveIdShader{});
+  }
+  shader_ = &(*shaderResource);
+}
+
+DrawStateKey PrimitiveIdDrawable::drawStateKey() {
+  return {shader_, nullptr, nullptr, &mesh_};
+}
+
+void PrimitiveIdDrawable::draw(const Magnum::Matrix4& transformationMatrix,
+                               Magnum::SceneGraph::Camera3D& camera) {
+  (*shader_)
+      .bindObjectIdTexture(objectIds_)
+      .setTransformationProjectionMatrix(camera.projectionMatrix() *
+                                         transformationMatrix)
+      .draw(mesh_);
+}
+
+void PrimitiveIdDrawable::drawDepthOnly(
+    const Magnum::Matrix4& transformationMatrix,
+    Magnum::SceneGraph::Camera3D& camera,
+    Magnum::Shaders::Flat3D& shader) {
+  shader
+      .setTransformationProjectionMatrix(camera.projectionMatrix() *
+                                         transformationMatrix)
+      .draw(mesh_);
+}
+
+}  // namespace gfx
+}  // namespace esp
+#endif
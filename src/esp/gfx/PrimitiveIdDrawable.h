@@ -0,0 +1,61 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/GL/GL.h>
+
+#include "Drawable.h"
+#include "esp/gfx/ShaderManager.h"
+
+#ifndef MAGNUM_TARGET_GLES
+namespace esp {
+namespace gfx {
+
+class PrimitiveIdShader;
+
+/**
+ * @brief Drawable of a mesh whose object IDs are per triangle
+ *
+ * Draws with @ref PrimitiveIdShader, taking the IDs from a buffer texture
+ * instead of a vertex attribute, see @ref
+ * assets::GenericInstanceMeshData::fromPLY().
+ */
+class PrimitiveIdDrawable : public Drawable {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param node          Node which will be made drawable
+   * @param mesh          Mesh with positions and colors
+   * @param objectIds     R32UI buffer texture, one ID per triangle of
+   *                      @p mesh, has to outlive the drawable
+   * @param shaderManager Shader manager the shader is shared in
+   * @param group         Drawable group this drawable will be added to
+   */
+  explicit PrimitiveIdDrawable(scene::SceneNode& node,
+                               Magnum::GL::Mesh& mesh,
+                               Magnum::GL::BufferTexture& objectIds,
+                               ShaderManager& shaderManager,
+                               DrawableGroup* group = nullptr);
+
+  static constexpr char SHADER_KEY[] = "PrimitiveIdShader";
+
+  DrawStateKey drawStateKey() override;
+
+ protected:
+  void draw(const Magnum::Matrix4& transformationMatrix,
+            Magnum::SceneGraph::Camera3D& camera) override;
+
+  void drawDepthOnly(const Magnum::Matrix4& transformationMatrix,
+                     Magnum::SceneGraph::Camera3D& camera,
+                     Magnum::Shaders::Flat3D& shader) override;
+
+  Magnum::GL::BufferTexture& objectIds_;
+  PrimitiveIdShader* shader_ = nullptr;
+};
+
+}  // namespace gfx
+}  // namespace esp
+#endif
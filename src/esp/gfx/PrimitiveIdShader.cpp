@@ -0,0 +1,71 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PrimitiveIdShader.h"
+
+#ifndef MAGNUM_TARGET_GLES
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/BufferTexture.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(ShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+enum { ObjectIdTextureUnit = 0 };
+}
+
+bool PrimitiveIdShader::isSupported() {
+  return Mn::GL::Context::current().isVersionSupported(Mn::GL::Version::GL410);
+}
+
+PrimitiveIdShader::PrimitiveIdShader() {
+  MAGNUM_ASSERT_GL_VERSION_SUPPORTED(Mn::GL::Version::GL410);
+
+  if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"default-shaders"};
+
+  Mn::GL::Shader vert{Mn::GL::Version::GL410, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{Mn::GL::Version::GL410, Mn::GL::Shader::Type::Fragment};
+  vert.addSource(rs.get("primitive-id.vert"));
+  frag.addSource(rs.get("primitive-id.frag"));
+
+  // the mesh has the generic layout, without the object ID attribute
+  bindAttributeLocation(Position::Location, "position");
+  bindAttributeLocation(Color3::Location, "color");
+  CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
+
+  setUniform(uniformLocation("primitiveObjectIds"), ObjectIdTextureUnit);
+  transformationProjectionMatrixUniform_ =
+      uniformLocation("transformationProjectionMatrix");
+}
+
+PrimitiveIdShader& PrimitiveIdShader::setTransformationProjectionMatrix(
+    const Mn::Matrix4& matrix) {
+  setUniform(transformationProjectionMatrixUniform_, matrix);
+  return *this;
+}
+
+PrimitiveIdShader& PrimitiveIdShader::bindObjectIdTexture(
+    Mn::GL::BufferTexture& texture) {
+  texture.bind(ObjectIdTextureUnit);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
+#endif
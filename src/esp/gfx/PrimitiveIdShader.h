@@ -0,0 +1,67 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Shaders/Generic.h>
+
+#include "esp/gfx/CachedShaderProgram.h"
+
+#ifndef MAGNUM_TARGET_GLES
+namespace esp {
+namespace gfx {
+
+/**
+@brief Vertex color shader taking object IDs per triangle
+
+Outputs the interpolated vertex color to output @cpp 0 @ce and, to output
+@cpp 1 @ce, the object ID the @ref bindObjectIdTexture() texture holds for
+@glsl gl_PrimitiveID @ce, so meshes need no vertex attribute for the IDs
+and no duplicated vertices where objects meet. Unlit, like instance meshes
+drawn without lights.
+*/
+class PrimitiveIdShader : public CachedShaderProgram {
+ public:
+  /** @brief Vertex positions */
+  typedef Magnum::Shaders::Generic3D::Position Position;
+
+  /** @brief Vertex colors */
+  typedef Magnum::Shaders::Generic3D::Color3 Color3;
+
+  /**
+   * @brief Whether the GL context can run the shader
+   *
+   * Needs OpenGL 4.1, for buffer textures and @glsl gl_PrimitiveID @ce in
+   * the fragment shader. The class isn't built for OpenGL ES and WebGL.
+   */
+  static bool isSupported();
+
+  /** @brief Constructor */
+  explicit PrimitiveIdShader();
+
+  /**
+   * @brief Set the transformation and projection matrix
+   * @return Reference to self (for method chaining)
+   */
+  PrimitiveIdShader& setTransformationProjectionMatrix(
+      const Magnum::Matrix4& matrix);
+
+  /**
+   * @brief Bind the object ID buffer texture
+   * @return Reference to self (for method chaining)
+   *
+   * Expected to be @ref Magnum::GL::BufferTextureFormat::R32UI, one texel
+   * per triangle of the drawn mesh, in the order of its index buffer.
+   */
+  PrimitiveIdShader& bindObjectIdTexture(Magnum::GL::BufferTexture& texture);
+
+ private:
+  int transformationProjectionMatrixUniform_;
+};
+
+}  // namespace gfx
+}  // namespace esp
+#endif
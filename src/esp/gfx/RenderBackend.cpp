@@ -0,0 +1,25 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RenderBackend.h"
+
+namespace esp {
+namespace gfx {
+
+bool isRenderBackendAvailable(RenderBackend backend) {
+  return backend == RenderBackend::OpenGL;
+}
+
+const char* renderBackendName(RenderBackend backend) {
+  switch (backend) {
+    case RenderBackend::OpenGL:
+      return "OpenGL";
+    case RenderBackend::Vulkan:
+      return "Vulkan";
+  }
+  return "unknown";
+}
+
+}  // namespace gfx
+}  // namespace esp
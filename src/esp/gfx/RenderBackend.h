@@ -0,0 +1,35 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Enum @ref esp::gfx::RenderBackend
+ */
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Graphics API a @ref Renderer and its @ref RenderTarget "render
+ * targets" are implemented on
+ *
+ * The render targets go through @ref RenderTargetBackend, so another API
+ * only needs an implementation of it and a case in the factory of
+ * @ref RenderTarget. The drawables and shaders are still written against
+ * OpenGL, so only @ref RenderBackend::OpenGL is implemented so far.
+ */
+enum class RenderBackend {
+  OpenGL = 0,
+  Vulkan = 1,
+};
+
+/** @brief Whether @p backend is implemented in this build */
+bool isRenderBackendAvailable(RenderBackend backend);
+
+/** @brief Name of @p backend, for messages */
+const char* renderBackendName(RenderBackend backend);
+
+}  // namespace gfx
+}  // namespace esp
@@ -4,6 +4,20 @@
 
 #include "RenderCamera.h"
 
+#include "esp/gfx/CullingBVH.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/OcclusionCuller.h"
+#include "esp/gfx/PotentiallyVisibleSet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <tuple>
+
+#include <Corrade/Utility/Assert.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
@@ -28,24 +42,253 @@ namespace gfx {
 Cr::Containers::Optional<int> rangeFrustum(const Mn::Range3D& range,
                                            const Mn::Frustum& frustum,
                                            int frustumPlaneIndex = 0) {
-  const Mn::Vector3 center = range.min() + range.max();
-  const Mn::Vector3 extent = range.max() - range.min();
+  if (testRangeFrustum(range, frustum, frustumPlaneIndex) ==
+      FrustumTestResult::Outside) {
+    return Cr::Containers::Optional<int>{frustumPlaneIndex};
+  }
+  return Cr::Containers::NullOpt;
+}
 
-  for (int iPlane = 0; iPlane < 6; ++iPlane) {
-    int index = (iPlane + frustumPlaneIndex) % 6;
-    const Mn::Vector4& plane = frustum[index];
+namespace {
 
-    const Mn::Vector3 absPlaneNormal = Mn::Math::abs(plane.xyz());
+struct RenderQueueEntry {
+  Drawable* drawable;
+  Mn::Matrix4 transformation;
+  DrawStateKey key;
+};
 
-    const float d = Mn::Math::dot(center, plane.xyz());
-    const float r = Mn::Math::dot(extent, absPlaneNormal);
-    if (d + r < -2.0 * plane.w())
-      return Cr::Containers::Optional<int>{index};
+// scale of the node's local space divided by the distance of the closest
+// point of its mesh bounds to the camera, infinite inside the bounds
+float projectedScale(const scene::SceneNode& node,
+                     const Mn::Matrix4& transformation) {
+  const Mn::Range3D& bounds = node.getMeshBB();
+  const float scale = transformation.scaling().max();
+  const float distance =
+      transformation.transformPoint(bounds.center()).length() -
+      bounds.size().length() * 0.5f * scale;
+  return distance > 0.0f ? scale / distance
+                         : std::numeric_limits<float>::infinity();
+}
+
+// pointers of unrelated objects can only be ordered through integers
+std::tuple<std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uintptr_t>
+stateKeyRank(const DrawStateKey& key) {
+  return std::make_tuple(reinterpret_cast<std::uintptr_t>(key.shader),
+                         reinterpret_cast<std::uintptr_t>(key.texture),
+                         reinterpret_cast<std::uintptr_t>(key.material),
+                         reinterpret_cast<std::uintptr_t>(key.mesh));
+}
+
+RenderCamera::StateChanges countStateChanges(
+    const std::vector<RenderQueueEntry>& queue) {
+  RenderCamera::StateChanges changes;
+  DrawStateKey previous;
+  for (const RenderQueueEntry& entry : queue) {
+    const DrawStateKey& key = entry.key;
+    changes.shader += key.shader != previous.shader;
+    changes.texture += key.texture != previous.texture;
+    changes.material += key.material != previous.material;
+    changes.mesh += key.mesh != previous.mesh;
+    previous = key;
   }
+  return changes;
+}
 
-  return Cr::Containers::NullOpt;
+void addStateChanges(RenderCamera::StateChanges& changes,
+                     const RenderCamera::StateChanges& other) {
+  changes.shader += other.shader;
+  changes.texture += other.texture;
+  changes.material += other.material;
+  changes.mesh += other.mesh;
+}
+
+// milliseconds of a monotonic clock, for DrawStatistics::cullTime
+double now() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// pixels one unit at unit distance in front of the camera covers
+float projectedPixelsPerUnit(RenderCamera& camera) {
+  return camera.projectionMatrix()[1][1] * camera.viewport().y() * 0.5f;
+}
+
+void selectLevelOfDetail(Drawable& drawable,
+                         const Mn::Matrix4& transformation,
+                         float pixelsPerUnit,
+                         float pixelError) {
+  if (drawable.levelOfDetailCount() == 0) {
+    return;
+  }
+  drawable.selectLevelOfDetail(
+      pixelError > 0.0f
+          ? pixelsPerUnit *
+                projectedScale(drawable.getSceneNode(), transformation)
+          : 0.0f,
+      pixelError);
+}
+
+// optionally sorts the queue by state, records the statistics and draws it
+uint32_t drawQueue(std::vector<RenderQueueEntry>& queue,
+                   RenderCamera& camera,
+                   bool stateSorting,
+                   RenderCamera::DrawStatistics& statistics) {
+  const RenderCamera::StateChanges unsortedChanges = countStateChanges(queue);
+  RenderCamera::StateChanges& changes = statistics.stateChanges;
+  if (stateSorting) {
+    std::sort(queue.begin(), queue.end(),
+              [](const RenderQueueEntry& a, const RenderQueueEntry& b) {
+                return stateKeyRank(a.key) < stateKeyRank(b.key);
+              });
+    const RenderCamera::StateChanges sortedChanges = countStateChanges(queue);
+    RenderCamera::StateChanges& saved = statistics.stateChangesSaved;
+    saved.shader += unsortedChanges.shader - sortedChanges.shader;
+    saved.texture += unsortedChanges.texture - sortedChanges.texture;
+    saved.material += unsortedChanges.material - sortedChanges.material;
+    saved.mesh += unsortedChanges.mesh - sortedChanges.mesh;
+    addStateChanges(changes, sortedChanges);
+  } else {
+    addStateChanges(changes, unsortedChanges);
+  }
+  statistics.drawables += queue.size();
+
+  if (Mn::Shaders::Flat3D* shader = camera.depthOnlyShader()) {
+    for (RenderQueueEntry& entry : queue) {
+      entry.drawable->drawDepthOnly(entry.transformation, camera, *shader);
+      statistics.triangles += entry.drawable->drawnTriangleCount();
+    }
+    return queue.size();
+  }
+
+  DrawStateKey previous;
+  for (RenderQueueEntry& entry : queue) {
+    entry.drawable->drawSorted(entry.transformation, camera, previous);
+    statistics.triangles += entry.drawable->drawnTriangleCount();
+    previous = entry.key;
+  }
+  return queue.size();
+}
+
+// whether the potentially visible set excludes the bounded drawable index,
+// drawables added after the set was computed are never excluded
+bool notPotentiallyVisible(const std::vector<bool>* visible, int index) {
+  return visible && std::size_t(index) < visible->size() && !(*visible)[index];
+}
+
+// draws what was visible last frame, then what of the rest the depth
+// buffer doesn't hide
+uint32_t drawOcclusionCulled(RenderCamera& renderCamera,
+                             OcclusionCuller& culler,
+                             DrawableGroup& drawables,
+                             const std::vector<bool>* potentiallyVisible,
+                             bool frustumCulling,
+                             const std::vector<int>* visible,
+                             bool stateSorting,
+                             const std::function<void(Drawable&)>& addDrawable,
+                             std::vector<RenderQueueEntry>& queue,
+                             RenderCamera::DrawStatistics& statistics) {
+  const double cullStart = now();
+  culler.beginFrame(drawables);
+  const Mn::Matrix4 projection = renderCamera.projectionMatrix();
+  const Mn::Matrix4 camera = renderCamera.cameraMatrix();
+  const bool colorWrites = renderCamera.depthOnlyShader() == nullptr;
+
+  // bounded drawables in the frustum, split by their visibility last frame
+  std::vector<int> drawn;
+  std::vector<int> occluded;
+  auto sortDrawable = [&](int index) {
+    if (notPotentiallyVisible(potentiallyVisible, index)) {
+      ++statistics.notPotentiallyVisible;
+      return;
+    }
+    (culler.wasOccluded(index) ? occluded : drawn).push_back(index);
+  };
+  const auto& bounded = drawables.boundedDrawables();
+  if (visible) {
+    for (int index : *visible) {
+      sortDrawable(index);
+    }
+  } else if (frustumCulling) {
+    const Mn::Frustum frustum = Mn::Frustum::fromMatrix(projection * camera);
+    drawables.cullingBVH().cull(frustum, sortDrawable);
+  } else {
+    for (int i = 0; i != int(bounded.size()); ++i) {
+      sortDrawable(i);
+    }
+  }
+
+  for (int index : drawn) {
+    addDrawable(bounded[index]);
+  }
+  for (Drawable& drawable : drawables.unboundedDrawables()) {
+    addDrawable(drawable);
+  }
+  statistics.cullTime += now() - cullStart;
+  uint32_t count = drawQueue(queue, renderCamera, stateSorting, statistics);
+
+  // the depth of everything visible last frame hides most of what was
+  // occluded, draw the rest
+  const std::vector<int> revealed =
+      culler.testOccluded(occluded, projection, camera, colorWrites);
+  statistics.occluded += occluded.size() - revealed.size();
+  queue.clear();
+  for (int index : revealed) {
+    addDrawable(bounded[index]);
+  }
+  count += drawQueue(queue, renderCamera, stateSorting, statistics);
+
+  drawn.insert(drawn.end(), revealed.begin(), revealed.end());
+  culler.queryDrawn(drawn, projection, camera, colorWrites);
+  return count;
+}
+
+constexpr int CubeMapFaceCount = 6;
+
+// rotation of the camera looking along cube map face, in the order of the GL
+// face targets (+X, -X, +Y, -Y, +Z, -Z). The up vectors follow the GL cube
+// map convention, so the faces can be sampled with view-space directions.
+Mn::Matrix4 cubeMapFaceRotation(int face) {
+  const Mn::Vector3 faces[CubeMapFaceCount][2]{
+      {Mn::Vector3::xAxis(), -Mn::Vector3::yAxis()},
+      {-Mn::Vector3::xAxis(), -Mn::Vector3::yAxis()},
+      {Mn::Vector3::yAxis(), Mn::Vector3::zAxis()},
+      {-Mn::Vector3::yAxis(), -Mn::Vector3::zAxis()},
+      {Mn::Vector3::zAxis(), -Mn::Vector3::yAxis()},
+      {-Mn::Vector3::zAxis(), -Mn::Vector3::yAxis()}};
+  return Mn::Matrix4::lookAt({}, faces[face][0], faces[face][1]);
+}
+
+// the frustum of the first view with its planes pushed out until they
+// contain the corners of the frustums of all the others, and with that the
+// frustums themselves. Tight for views looking in similar directions.
+Mn::Frustum enclosingFrustum(const std::vector<Mn::Matrix4>& viewProjections) {
+  const Mn::Frustum first = Mn::Frustum::fromMatrix(viewProjections[0]);
+  Mn::Vector4 planes[6];
+  for (int i = 0; i != 6; ++i) {
+    planes[i] = first[i];
+  }
+  for (std::size_t view = 1; view < viewProjections.size(); ++view) {
+    const Mn::Matrix4 inverse = viewProjections[view].inverted();
+    for (int corner = 0; corner != 8; ++corner) {
+      const Mn::Vector4 ndc{corner & 1 ? 1.0f : -1.0f,
+                            corner & 2 ? 1.0f : -1.0f,
+                            corner & 4 ? 1.0f : -1.0f, 1.0f};
+      const Mn::Vector4 point = inverse * ndc;
+      const Mn::Vector3 position = point.xyz() / point.w();
+      for (Mn::Vector4& plane : planes) {
+        plane.w() = std::max(plane.w(), -Mn::Math::dot(plane.xyz(), position));
+      }
+    }
+  }
+  return {planes[0], planes[1], planes[2], planes[3], planes[4], planes[5]};
 }
 
+}  // namespace
+
+// static constexpr members require redundant definitions until C++17
+constexpr int RenderCamera::MaxViewCount;
+
 RenderCamera::RenderCamera(scene::SceneNode& node) : MagnumCamera{node} {
   node.setType(scene::SceneNodeType::CAMERA);
   setAspectRatioPolicy(Mn::SceneGraph::AspectRatioPolicy::NotPreserved);
@@ -128,5 +371,310 @@ uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables,
   return drawableTransforms.size();
 }
 
+uint32_t RenderCamera::draw(DrawableGroup& drawables, bool frustumCulling) {
+  return drawCulled(drawables, frustumCulling, nullptr);
+}
+
+uint32_t RenderCamera::draw(DrawableGroup& drawables,
+                            const std::vector<int>& visible) {
+  return drawCulled(drawables, true, &visible);
+}
+
+uint32_t RenderCamera::drawCulled(DrawableGroup& drawables,
+                                  bool frustumCulling,
+                                  const std::vector<int>* visible) {
+  const double cullStart = now();
+  drawables.prepareForDraw(*this);
+  drawables.updateCullingData();
+
+  // render queue of the visible drawables, with transformations relative to
+  // the camera computed from the cached absolute ones
+  std::vector<RenderQueueEntry> queue;
+  queue.reserve(drawables.size());
+  const Mn::Matrix4 camera = cameraMatrix();
+  const float pixelsPerUnit = projectedPixelsPerUnit(*this);
+  auto addDrawable = [&](Drawable& drawable) {
+    const Mn::Matrix4 transformation =
+        camera * drawable.absoluteTransformation();
+    selectLevelOfDetail(drawable, transformation, pixelsPerUnit,
+                        lodPixelError_);
+    queue.push_back({&drawable, transformation, drawable.drawStateKey()});
+  };
+
+  const std::vector<bool>* potentiallyVisible =
+      potentiallyVisibleSet_ ? potentiallyVisibleSet_->visibleDrawables(
+                                   drawables, node().absoluteTranslation())
+                             : nullptr;
+  const auto& bounded = drawables.boundedDrawables();
+  if (occlusionCuller_) {
+    drawStatistics_.cullTime += now() - cullStart;
+    const uint32_t drawn = drawOcclusionCulled(
+        *this, *occlusionCuller_, drawables, potentiallyVisible,
+        frustumCulling, visible, stateSorting_, addDrawable, queue,
+        drawStatistics_);
+    drawStatistics_.culled += int(drawables.size() - drawn);
+    return drawn;
+  }
+  auto addBounded = [&](int index) {
+    if (notPotentiallyVisible(potentiallyVisible, index)) {
+      ++drawStatistics_.notPotentiallyVisible;
+      return;
+    }
+    addDrawable(bounded[index]);
+  };
+  if (visible) {
+    for (int index : *visible) {
+      addBounded(index);
+    }
+  } else if (frustumCulling) {
+    // camera frustum relative to world origin
+    const Mn::Frustum frustum =
+        Mn::Frustum::fromMatrix(projectionMatrix() * camera);
+    drawables.cullingBVH().cull(frustum, addBounded);
+  } else {
+    for (int i = 0; i != int(bounded.size()); ++i) {
+      addBounded(i);
+    }
+  }
+  // drawables without an absolute AABB are never culled
+  for (Drawable& drawable : drawables.unboundedDrawables()) {
+    addDrawable(drawable);
+  }
+  drawStatistics_.cullTime += now() - cullStart;
+  drawStatistics_.culled += int(drawables.size() - queue.size());
+
+  return drawQueue(queue, *this, stateSorting_, drawStatistics_);
+}
+
+
+uint32_t RenderCamera::drawCubeMap(DrawableGroup& drawables,
+                                   bool frustumCulling,
+                                   const std::function<void(int)>& bindFace) {
+  const double cullStart = now();
+  drawables.prepareForDraw(*this);
+  drawables.updateCullingData();
+
+  scene::SceneNode& node = object();
+  const Mn::Matrix4 baseTransformation = node.transformation();
+  const Mn::Matrix4 camera = cameraMatrix();
+  const float pixelsPerUnit = projectedPixelsPerUnit(*this);
+
+  // visible drawables, each with a bit set for every face it may appear in.
+  // The level of detail only depends on the distance, so it is selected once
+  // for all faces.
+  std::vector<std::pair<Drawable*, int>> candidates;
+  candidates.reserve(drawables.size());
+  const int allFaces = (1 << CubeMapFaceCount) - 1;
+  auto addDrawable = [&](Drawable& drawable, int faces) {
+    selectLevelOfDetail(drawable, camera * drawable.absoluteTransformation(),
+                        pixelsPerUnit, lodPixelError_);
+    candidates.emplace_back(&drawable, faces);
+  };
+
+  const auto& bounded = drawables.boundedDrawables();
+  if (frustumCulling) {
+    Mn::Frustum faceFrustums[CubeMapFaceCount];
+    for (int face = 0; face != CubeMapFaceCount; ++face) {
+      faceFrustums[face] = Mn::Frustum::fromMatrix(
+          projectionMatrix() * cubeMapFaceRotation(face).invertedRigid() *
+          camera);
+    }
+    // the faces together see a cube around the eye, reaching the far plane
+    // in the direction of each face, cull the hierarchy against it once and
+    // only test the boxes that pass against the single faces
+    const Mn::Matrix4 eye = camera.inverted();
+    const Mn::Matrix4 projection = projectionMatrix();
+    const float farDistance = projection[3][2] / (projection[2][2] + 1.0f);
+    Mn::Vector4 planes[CubeMapFaceCount];
+    for (int i = 0; i != 3; ++i) {
+      const Mn::Vector3 axis = eye[i].xyz().normalized();
+      const float center = Mn::Math::dot(axis, eye.translation());
+      planes[2 * i] = {axis, farDistance - center};
+      planes[2 * i + 1] = {-axis, farDistance + center};
+    }
+    const Mn::Frustum cube{planes[0], planes[1], planes[2],
+                           planes[3], planes[4], planes[5]};
+    drawables.cullingBVH().cull(cube, [&](int index) {
+      Drawable& drawable = bounded[index];
+      const Mn::Range3D aabb = *drawable.getSceneNode().getAbsoluteAABB();
+      int faces = 0;
+      for (int face = 0; face != CubeMapFaceCount; ++face) {
+        int plane = 0;
+        if (testRangeFrustum(aabb, faceFrustums[face], plane) !=
+            FrustumTestResult::Outside) {
+          faces |= 1 << face;
+        }
+      }
+      if (faces) {
+        addDrawable(drawable, faces);
+      }
+    });
+  } else {
+    for (Drawable& drawable : bounded) {
+      addDrawable(drawable, allFaces);
+    }
+  }
+  // drawables without an absolute AABB are never culled
+  for (Drawable& drawable : drawables.unboundedDrawables()) {
+    addDrawable(drawable, allFaces);
+  }
+
+  drawStatistics_.cullTime += now() - cullStart;
+
+  uint32_t drawn = 0;
+  std::vector<RenderQueueEntry> queue;
+  queue.reserve(candidates.size());
+  for (int face = 0; face != CubeMapFaceCount; ++face) {
+    // drawables fetch the camera matrix themselves, e.g. for lights, so the
+    // node has to actually look along the face
+    node.setTransformation(baseTransformation * cubeMapFaceRotation(face));
+    const Mn::Matrix4 faceCamera = cameraMatrix();
+    queue.clear();
+    for (const std::pair<Drawable*, int>& candidate : candidates) {
+      if (candidate.second & (1 << face)) {
+        Drawable& drawable = *candidate.first;
+        queue.push_back({&drawable,
+                         faceCamera * drawable.absoluteTransformation(),
+                         drawable.drawStateKey()});
+      }
+    }
+    bindFace(face);
+    drawn += drawQueue(queue, *this, stateSorting_, drawStatistics_);
+  }
+  node.setTransformation(baseTransformation);
+  drawStatistics_.culled += int(CubeMapFaceCount * drawables.size() - drawn);
+  return drawn;
+}
+
+uint32_t RenderCamera::drawMultiView(
+    DrawableGroup& drawables,
+    const std::vector<Mn::Matrix4>& viewTransformations,
+    bool frustumCulling,
+    const std::function<void(int)>& bindView) {
+  const int viewCount = viewTransformations.size();
+  CORRADE_ASSERT(viewCount > 0 && viewCount <= MaxViewCount,
+                 "RenderCamera::drawMultiView(): expected 1 to"
+                     << MaxViewCount << "views but got" << viewCount,
+                 0);
+  const double cullStart = now();
+  scene::SceneNode& node = object();
+  const Mn::Matrix4 baseTransformation = node.transformation();
+  std::vector<Mn::Matrix4> cameras(viewCount);
+  for (int view = 0; view != viewCount; ++view) {
+    node.setTransformation(viewTransformations[view]);
+    cameras[view] = cameraMatrix();
+  }
+  node.setTransformation(viewTransformations[0]);
+  drawables.prepareForDraw(*this);
+  drawables.updateCullingData();
+  const float pixelsPerUnit = projectedPixelsPerUnit(*this);
+
+  // visible drawables, each with a bit set for every view it may appear in
+  struct Candidate {
+    Drawable* drawable;
+    DrawStateKey key;
+    uint32_t views;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(drawables.size());
+  const uint32_t allViews = 0xffffffffu >> (MaxViewCount - viewCount);
+  auto addDrawable = [&](Drawable& drawable, uint32_t views) {
+    selectLevelOfDetail(drawable,
+                        cameras[0] * drawable.absoluteTransformation(),
+                        pixelsPerUnit, lodPixelError_);
+    candidates.push_back({&drawable, drawable.drawStateKey(), views});
+  };
+
+  std::vector<const std::vector<bool>*> potentiallyVisible;
+  if (potentiallyVisibleSet_) {
+    for (const Mn::Matrix4& camera : cameras) {
+      potentiallyVisible.push_back(potentiallyVisibleSet_->visibleDrawables(
+          drawables, camera.inverted().translation()));
+    }
+  }
+  auto excluded = [&](int index) {
+    if (potentiallyVisible.empty() ||
+        std::any_of(potentiallyVisible.begin(), potentiallyVisible.end(),
+                    [&](const std::vector<bool>* visible) {
+                      return !notPotentiallyVisible(visible, index);
+                    })) {
+      return false;
+    }
+    ++drawStatistics_.notPotentiallyVisible;
+    return true;
+  };
+
+  const auto& bounded = drawables.boundedDrawables();
+  if (frustumCulling) {
+    std::vector<Mn::Matrix4> viewProjections;
+    std::vector<Mn::Frustum> viewFrustums;
+    for (const Mn::Matrix4& camera : cameras) {
+      viewProjections.push_back(projectionMatrix() * camera);
+      viewFrustums.push_back(Mn::Frustum::fromMatrix(viewProjections.back()));
+    }
+    drawables.cullingBVH().cull(
+        enclosingFrustum(viewProjections), [&](int index) {
+          if (excluded(index)) {
+            return;
+          }
+          Drawable& drawable = bounded[index];
+          const Mn::Range3D aabb = *drawable.getSceneNode().getAbsoluteAABB();
+          uint32_t views = 0;
+          for (int view = 0; view != viewCount; ++view) {
+            int plane = 0;
+            if (testRangeFrustum(aabb, viewFrustums[view], plane) !=
+                FrustumTestResult::Outside) {
+              views |= 1u << view;
+            }
+          }
+          if (views) {
+            addDrawable(drawable, views);
+          }
+        });
+  } else {
+    for (int i = 0; i != int(bounded.size()); ++i) {
+      if (!excluded(i)) {
+        addDrawable(bounded[i], allViews);
+      }
+    }
+  }
+  // drawables without an absolute AABB are never culled
+  for (Drawable& drawable : drawables.unboundedDrawables()) {
+    addDrawable(drawable, allViews);
+  }
+  // sorted once, the views take their drawables in this order
+  if (stateSorting_) {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) {
+                return stateKeyRank(a.key) < stateKeyRank(b.key);
+              });
+  }
+
+  drawStatistics_.cullTime += now() - cullStart;
+
+  uint32_t drawn = 0;
+  std::vector<RenderQueueEntry> queue;
+  queue.reserve(candidates.size());
+  for (int view = 0; view != viewCount; ++view) {
+    // drawables fetch the camera matrix themselves, e.g. for lights, so the
+    // node has to actually be at the view
+    node.setTransformation(viewTransformations[view]);
+    queue.clear();
+    for (const Candidate& candidate : candidates) {
+      if (candidate.views & (1u << view)) {
+        queue.push_back(
+            {candidate.drawable,
+             cameras[view] * candidate.drawable->absoluteTransformation(),
+             candidate.key});
+      }
+    }
+    bindView(view);
+    drawn += drawQueue(queue, *this, false, drawStatistics_);
+  }
+  node.setTransformation(baseTransformation);
+  drawStatistics_.culled += int(viewCount * drawables.size() - drawn);
+  return drawn;
+}
+
 }  // namespace gfx
 }  // namespace esp
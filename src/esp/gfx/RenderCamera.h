@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
+#include <Magnum/Shaders/Shaders.h>
+
 #include "magnum.h"
 
 #include "esp/core/esp.h"
@@ -12,8 +17,72 @@
 namespace esp {
 namespace gfx {
 
+class DrawableGroup;
+class OcclusionCuller;
+class PotentiallyVisibleSet;
+
 class RenderCamera : public MagnumCamera {
  public:
+  /**
+   * @brief Number of GL state changes, by kind
+   *
+   * A change is counted whenever a drawable binds a different shader,
+   * texture, material or mesh than the drawable drawn before it, see @ref
+   * DrawStateKey.
+   */
+  struct StateChanges {
+    int shader = 0;
+    int texture = 0;
+    int material = 0;
+    int mesh = 0;
+  };
+
+  /**
+   * @brief Statistics of @ref draw(DrawableGroup&, bool) since the last @ref
+   * resetDrawStatistics()
+   */
+  struct DrawStatistics {
+    /** @brief Number of drawables drawn */
+    int drawables = 0;
+    /**
+     * @brief Number of drawables of the groups that weren't drawn, for any
+     * of the culling methods
+     *
+     * For cube maps, counted once per face.
+     */
+    int culled = 0;
+    /**
+     * @brief Number of triangles submitted, see
+     * @ref Drawable::drawnTriangleCount()
+     */
+    std::size_t triangles = 0;
+    /**
+     * @brief CPU time in milliseconds spent preparing the groups and
+     * culling, before the drawables are drawn
+     *
+     * With occlusion culling, only the frustum and potentially visible set
+     * pass is counted, the occlusion tests are interleaved with the draws.
+     */
+    double cullTime = 0.0;
+    /**
+     * @brief Number of drawables in the frustum skipped by occlusion
+     * culling, see @ref setOcclusionCuller()
+     */
+    int occluded = 0;
+    /**
+     * @brief Number of drawables excluded by the potentially visible set,
+     * see @ref setPotentiallyVisibleSet()
+     */
+    int notPotentiallyVisible = 0;
+    /** @brief State changes issued */
+    StateChanges stateChanges;
+    /**
+     * @brief State changes avoided by state sorting, compared to drawing in
+     * scene graph order
+     */
+    StateChanges stateChangesSaved;
+  };
+
   RenderCamera(scene::SceneNode& node);
   RenderCamera(scene::SceneNode& node,
                const vec3f& eye,
@@ -48,6 +117,192 @@ class RenderCamera : public MagnumCamera {
    * @return the number of drawables that are drawn
    */
   uint32_t draw(MagnumDrawableGroup& drawables, bool frustumCulling = false);
+
+  /**
+   * @brief Overload function to render the drawables
+   *
+   * Uses the absolute transformations cached in the group, which are only
+   * recomputed for drawables that moved, see @ref
+   * DrawableGroup::prepareForDraw(). With frustum culling enabled, static
+   * drawables are culled hierarchically using the persistent @ref
+   * DrawableGroup::cullingBVH() instead of testing each of them.
+   * @param drawables, a drawable group containing all the drawables
+   * @param frustumCulling, whether do frustum culling or not, default: false
+   * @return the number of drawables that are drawn
+   */
+  uint32_t draw(DrawableGroup& drawables, bool frustumCulling = false);
+
+  /**
+   * @brief Render the drawables, with the static ones already frustum culled
+   *
+   * Like @ref draw(DrawableGroup&, bool) with frustum culling, but only the
+   * drawables of @p visible, indices into @ref
+   * DrawableGroup::boundedDrawables() for the camera's current view, are
+   * considered instead of culling the hierarchy, see
+   * @ref Renderer::cullAhead(). The potentially visible set and the
+   * occlusion culler apply as before. The time spent culling ahead isn't
+   * part of @ref DrawStatistics::cullTime.
+   * @param drawables, a drawable group containing all the drawables
+   * @param visible, the static drawables inside the camera's frustum
+   * @return the number of drawables that are drawn
+   */
+  uint32_t draw(DrawableGroup& drawables, const std::vector<int>& visible);
+
+  /**
+   * @brief Render the drawables into the six faces of a cube map
+   *
+   * Draws from the camera's position once for each face, in the order of the
+   * GL cube map face targets (+X, -X, +Y, -Y, +Z, -Z), looking along the axes
+   * of the camera's own space. The projection should be a square 90 degree
+   * one, see @ref setProjectionMatrix(). The static drawables are culled
+   * against the hierarchy once for all faces and each face only draws the
+   * ones in its own frustum. @p bindFace is called with the face index
+   * before the face is drawn and has to bind its framebuffer. The camera's
+   * transformation is restored afterwards. Counts towards
+   * @ref drawStatistics() like @ref draw(DrawableGroup&, bool).
+   * @param drawables, a drawable group containing all the drawables
+   * @param frustumCulling, whether do frustum culling or not
+   * @param bindFace, binds the framebuffer of the given face
+   * @return the number of drawables that are drawn, summed over the faces
+   */
+  uint32_t drawCubeMap(DrawableGroup& drawables,
+                       bool frustumCulling,
+                       const std::function<void(int)>& bindFace);
+
+  /** @brief Largest number of views of @ref drawMultiView() */
+  static constexpr int MaxViewCount = 32;
+
+  /**
+   * @brief Render the drawables from several nearby views with the camera's
+   * projection, e.g. the eyes of a stereo pair
+   *
+   * @p viewTransformations are the transformations of the camera's node for
+   * each view. The static drawables are culled against the hierarchy once,
+   * with a frustum enclosing the frustums of all views, and each view only
+   * draws the ones in its own frustum. The visible drawables are sorted by
+   * state and get their level of detail once, for the first view, so every
+   * view submits the same sorted queue. A drawable is only excluded by the
+   * potentially visible set if it is for all views. @p bindView is called
+   * with the view index before the view is drawn and has to bind its
+   * framebuffer. The camera's transformation is restored afterwards. Doesn't
+   * use the occlusion culler. Counts towards @ref drawStatistics() like
+   * @ref draw(DrawableGroup&, bool).
+   * @param drawables, a drawable group containing all the drawables
+   * @param viewTransformations, the camera transformation of each view, at
+   *        most @ref MaxViewCount
+   * @param frustumCulling, whether do frustum culling or not
+   * @param bindView, binds the framebuffer of the given view
+   * @return the number of drawables that are drawn, summed over the views
+   */
+  uint32_t drawMultiView(
+      DrawableGroup& drawables,
+      const std::vector<Magnum::Matrix4>& viewTransformations,
+      bool frustumCulling,
+      const std::function<void(int)>& bindView);
+
+  /**
+   * @brief Whether @ref draw(DrawableGroup&, bool) sorts the visible
+   * drawables by their @ref DrawStateKey before drawing them
+   *
+   * Enabled by default.
+   */
+  bool isStateSortingEnabled() const { return stateSorting_; }
+
+  /**
+   * @brief Enable or disable state sorting
+   */
+  RenderCamera& setStateSortingEnabled(bool enabled) {
+    stateSorting_ = enabled;
+    return *this;
+  }
+
+  /**
+   * @brief Largest screen-space error of simplified meshes, in pixels
+   *
+   * @ref draw(DrawableGroup&, bool) draws the least detailed level of every
+   * drawable whose error projects to at most this many pixels, see @ref
+   * Drawable::selectLevelOfDetail(). 0, the default, always draws the full
+   * meshes.
+   */
+  float levelOfDetailPixelError() const { return lodPixelError_; }
+
+  /**
+   * @brief Set the largest screen-space error of simplified meshes
+   */
+  RenderCamera& setLevelOfDetailPixelError(float pixels) {
+    lodPixelError_ = pixels;
+    return *this;
+  }
+
+  /**
+   * @brief Shader the drawables draw only their depth with, nullptr for none
+   *
+   * While set, @ref draw(DrawableGroup&, bool) and @ref drawCubeMap() draw
+   * through @ref Drawable::drawDepthOnly(). The caller masks color writes.
+   */
+  Magnum::Shaders::Flat3D* depthOnlyShader() const { return depthOnlyShader_; }
+
+  /**
+   * @brief Set the depth-only shader
+   */
+  RenderCamera& setDepthOnlyShader(Magnum::Shaders::Flat3D* shader) {
+    depthOnlyShader_ = shader;
+    return *this;
+  }
+
+  /**
+   * @brief Occlusion culler used by @ref draw(DrawableGroup&, bool), nullptr
+   * for none
+   */
+  OcclusionCuller* occlusionCuller() const { return occlusionCuller_; }
+
+  /**
+   * @brief Set the occlusion culler
+   *
+   * While set, @ref draw(DrawableGroup&, bool) skips drawables with an
+   * absolute AABB whose box is hidden behind what is drawn, see
+   * @ref OcclusionCuller. The culler keeps the visibility of the previous
+   * frame, so it has to be the same one for every frame of a view.
+   * @ref drawCubeMap() doesn't use it.
+   */
+  RenderCamera& setOcclusionCuller(OcclusionCuller* culler) {
+    occlusionCuller_ = culler;
+    return *this;
+  }
+
+  /**
+   * @brief Potentially visible set used by @ref draw(DrawableGroup&, bool),
+   * nullptr for none
+   */
+  PotentiallyVisibleSet* potentiallyVisibleSet() const {
+    return potentiallyVisibleSet_;
+  }
+
+  /**
+   * @brief Set the potentially visible set
+   *
+   * While set, @ref draw(DrawableGroup&, bool) skips the bounded drawables
+   * the set excludes for the camera's position before the frustum and
+   * occlusion tests, with or without frustum culling. Positions the set
+   * doesn't cover draw everything, see
+   * @ref PotentiallyVisibleSet::visibleDrawables(). @ref drawCubeMap()
+   * doesn't use it.
+   */
+  RenderCamera& setPotentiallyVisibleSet(PotentiallyVisibleSet* set) {
+    potentiallyVisibleSet_ = set;
+    return *this;
+  }
+
+  /**
+   * @brief Statistics accumulated by @ref draw(DrawableGroup&, bool)
+   */
+  const DrawStatistics& drawStatistics() const { return drawStatistics_; }
+
+  /**
+   * @brief Reset @ref drawStatistics()
+   */
+  void resetDrawStatistics() { drawStatistics_ = DrawStatistics{}; }
+
   /**
    * @brief performs the frustum culling
    * @param drawableTransforms, a vector of pairs of Drawable3D object and its
@@ -63,6 +318,19 @@ class RenderCamera : public MagnumCamera {
                         Magnum::Matrix4>>& drawableTransforms);
 
  protected:
+  // draw(DrawableGroup&, bool), with the culled static drawables in visible
+  // unless it's nullptr
+  uint32_t drawCulled(DrawableGroup& drawables,
+                      bool frustumCulling,
+                      const std::vector<int>* visible);
+
+  bool stateSorting_ = true;
+  float lodPixelError_ = 0.0f;
+  Magnum::Shaders::Flat3D* depthOnlyShader_ = nullptr;
+  OcclusionCuller* occlusionCuller_ = nullptr;
+  PotentiallyVisibleSet* potentiallyVisibleSet_ = nullptr;
+  DrawStatistics drawStatistics_;
+
   ESP_SMART_POINTERS(RenderCamera)
 };
 
@@ -0,0 +1,115 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RenderExecutor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <Corrade/Utility/Assert.h>
+
+#include "esp/gfx/ContextPool.h"
+
+namespace esp {
+namespace gfx {
+
+struct RenderExecutor::Worker {
+  explicit Worker(int gpuDevice) : gpuDevice{gpuDevice} {
+    std::promise<void> started;
+    std::future<void> ready = started.get_future();
+    thread = std::thread{[this, &started]() { run(started); }};
+    ready.get();
+  }
+
+  ~Worker() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+  }
+
+  void run(std::promise<void>& started) {
+    // created and destroyed in this thread, it's current here only
+    WindowlessContext::ptr context =
+        ContextPool::instance().acquire(gpuDevice);
+    started.set_value();
+    for (;;) {
+      std::packaged_task<void()> task;
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+        if (tasks.empty()) {
+          break;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  const int gpuDevice;
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::packaged_task<void()>> tasks;
+  bool stopping = false;
+};
+
+RenderExecutor::RenderExecutor(const std::vector<int>& gpuDevices) {
+  const std::vector<int> devices =
+      gpuDevices.empty() ? ContextPool::instance().devices() : gpuDevices;
+  for (int device : devices) {
+    workers_.emplace_back(std::make_unique<Worker>(device));
+  }
+}
+
+RenderExecutor::~RenderExecutor() {
+  stop();
+}
+
+void RenderExecutor::stop() {
+  workers_.clear();
+}
+
+std::vector<int> RenderExecutor::devices() const {
+  std::vector<int> devices;
+  for (const auto& worker : workers_) {
+    devices.push_back(worker->gpuDevice);
+  }
+  return devices;
+}
+
+RenderExecutor::Worker* RenderExecutor::worker(int gpuDevice) {
+  for (auto& worker : workers_) {
+    if (worker->gpuDevice == gpuDevice) {
+      return worker.get();
+    }
+  }
+  return nullptr;
+}
+
+std::future<void> RenderExecutor::submit(int gpuDevice,
+                                         std::function<void()> task) {
+  Worker* target = worker(gpuDevice);
+  CORRADE_ASSERT(target,
+                 "RenderExecutor::submit(): no worker for GPU device"
+                     << gpuDevice,
+                 {});
+  std::packaged_task<void()> packaged{std::move(task)};
+  std::future<void> done = packaged.get_future();
+  {
+    std::lock_guard<std::mutex> lock{target->mutex};
+    target->tasks.push_back(std::move(packaged));
+  }
+  target->wake.notify_one();
+  return done;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,71 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Runs GL work on one thread per GPU device
+ *
+ * Every worker thread holds the @ref ContextPool context of its device,
+ * current for all tasks submitted to the device. Simulators using the pool
+ * of a device have to be created, used and closed through its tasks. Tasks
+ * of one device run one after another in submission order, tasks of
+ * different devices in parallel.
+ */
+class RenderExecutor {
+ public:
+  /**
+   * @brief Constructor
+   * @param gpuDevices  CUDA IDs of the devices to start a worker for, all
+   *    devices of @ref ContextPool::devices() if empty
+   *
+   * Waits until the context of every worker is created.
+   */
+  explicit RenderExecutor(const std::vector<int>& gpuDevices = {});
+
+  /** @brief Calls @ref stop() */
+  ~RenderExecutor();
+
+  RenderExecutor(const RenderExecutor&) = delete;
+  RenderExecutor& operator=(const RenderExecutor&) = delete;
+
+  /** @brief CUDA IDs of the devices with a worker */
+  std::vector<int> devices() const;
+
+  /**
+   * @brief Run @p task on the worker of @p gpuDevice
+   *
+   * The future rethrows an exception of the task.
+   */
+  std::future<void> submit(int gpuDevice, std::function<void()> task);
+
+  /**
+   * @brief Run the tasks already submitted and stop the workers
+   *
+   * The contexts of the workers are released, nothing can be submitted
+   * afterwards.
+   */
+  void stop();
+
+ private:
+  struct Worker;
+  Worker* worker(int gpuDevice);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  ESP_SMART_POINTERS(RenderExecutor)
+};
+
+}  // namespace gfx
+}  // namespace esp
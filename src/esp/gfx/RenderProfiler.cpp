@@ -0,0 +1,150 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RenderProfiler.h"
+
+#include <chrono>
+#include <iterator>
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/TimeQuery.h>
+
+#include "esp/core/Profiler.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+// same clock as assets::SceneLoadStatistics::now()
+double now() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+#ifndef MAGNUM_TARGET_GLES
+struct RenderProfiler::Query {
+  Mn::GL::TimeQuery query{Mn::GL::TimeQuery::Target::TimeElapsed};
+};
+#else
+struct RenderProfiler::Query {};
+#endif
+
+RenderProfiler::ScopedPass::ScopedPass(RenderProfiler* profiler,
+                                       const std::string& sensor,
+                                       Pass pass)
+    : profiler_{profiler} {
+  if (profiler_) {
+    profiler_->begin(sensor, pass);
+  }
+}
+
+RenderProfiler::ScopedPass::~ScopedPass() {
+  if (profiler_) {
+    profiler_->end();
+  }
+}
+
+void RenderProfiler::ScopedPass::setDrawStatistics(
+    const RenderCamera::DrawStatistics& statistics) {
+  if (profiler_) {
+    profiler_->setDrawStatistics(statistics);
+  }
+}
+
+RenderProfiler::RenderProfiler() {
+#ifndef MAGNUM_TARGET_GLES
+  gpuTimingSupported_ =
+      Mn::GL::Context::current()
+          .isExtensionSupported<Mn::GL::Extensions::ARB::timer_query>();
+#endif
+}
+
+RenderProfiler::~RenderProfiler() = default;
+
+void RenderProfiler::begin(const std::string& sensor, Pass pass) {
+  CORRADE_ASSERT(!inPass_, "RenderProfiler::begin(): passes can't nest", );
+  inPass_ = true;
+  current_.record = Record{sensor, pass, now(), 0.0, -1.0, {}};
+  current_.query = nullptr;
+  if (gpuTimingSupported_) {
+    if (freeQueries_.empty()) {
+      current_.query = std::make_unique<Query>();
+    } else {
+      current_.query = std::move(freeQueries_.back());
+      freeQueries_.pop_back();
+    }
+#ifndef MAGNUM_TARGET_GLES
+    current_.query->query.begin();
+#endif
+  }
+}
+
+void RenderProfiler::setDrawStatistics(
+    const RenderCamera::DrawStatistics& statistics) {
+  CORRADE_ASSERT(inPass_,
+                 "RenderProfiler::setDrawStatistics(): no pass in progress", );
+  current_.record.drawStatistics = statistics;
+}
+
+void RenderProfiler::end() {
+  CORRADE_ASSERT(inPass_, "RenderProfiler::end(): no pass in progress", );
+  inPass_ = false;
+#ifndef MAGNUM_TARGET_GLES
+  if (current_.query) {
+    current_.query->query.end();
+  }
+#endif
+  current_.record.cpuTime = now() - current_.record.startTime;
+  pending_.push_back(std::move(current_));
+  current_ = Pending{};
+  // results of earlier passes may have arrived meanwhile
+  collect(false);
+}
+
+void RenderProfiler::collect(bool wait) {
+  // queries finish in the order they were issued, so the first one that
+  // isn't available yet ends the scan
+  while (!pending_.empty()) {
+    Pending& pending = pending_.front();
+#ifndef MAGNUM_TARGET_GLES
+    if (pending.query) {
+      if (!wait && !pending.query->query.resultAvailable()) {
+        break;
+      }
+      pending.record.gpuTime =
+          pending.query->query.result<Mn::UnsignedLong>() / 1.0e6;
+      freeQueries_.push_back(std::move(pending.query));
+      // the GPU start isn't known, the pass is shown starting on the CPU
+      core::Profiler::addEvent(
+          "GPU",
+          pending.record.sensor +
+              (pending.record.pass == Pass::Draw ? " draw" : " readback"),
+          pending.record.startTime, pending.record.gpuTime);
+    }
+#endif
+    finished_.push_back(std::move(pending.record));
+    pending_.pop_front();
+  }
+  while (finished_.size() > MaxRecords) {
+    finished_.pop_front();
+  }
+}
+
+std::vector<RenderProfiler::Record> RenderProfiler::takeRecords(
+    bool wait /* = false */) {
+  collect(wait);
+  std::vector<Record> records{std::make_move_iterator(finished_.begin()),
+                              std::make_move_iterator(finished_.end())};
+  finished_.clear();
+  return records;
+}
+
+}  // namespace gfx
+}  // namespace esp
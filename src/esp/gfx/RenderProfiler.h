@@ -0,0 +1,146 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Magnum/GL/GL.h>
+
+#include "esp/core/esp.h"
+#include "esp/gfx/RenderCamera.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Records CPU and GPU times and statistics of the passes of each sensor
+ *
+ * Every pass, see @ref Pass, is timed on the CPU and, where timer queries are
+ * supported, on the GPU with a @cpp GL_TIME_ELAPSED @ce query. The query
+ * results are only read once the GPU made them available, so nothing waits
+ * for the GPU and a pass is returned by @ref takeRecords() a frame or two
+ * after it was submitted. Passes must not nest.
+ *
+ * Enabled through @ref Renderer::setProfiling(), which draws every sensor in
+ * a @ref Pass::Draw pass. Readbacks are recorded by the code reading the
+ * observations, see @ref ScopedPass. While @ref esp::core::Profiler is
+ * enabled, GPU times are also added to its trace on a "GPU" track.
+ */
+class RenderProfiler {
+ public:
+  /** @brief Pass of a sensor */
+  enum class Pass : uint8_t {
+    /** Culling and drawing the scene graph */
+    Draw,
+    /** Reading the observation back from the render target */
+    Readback,
+  };
+
+  /** @brief One recorded pass */
+  struct Record {
+    /** @brief UUID of the sensor */
+    std::string sensor;
+    /** @brief Pass */
+    Pass pass;
+    /**
+     * @brief Start of the pass on the CPU, in milliseconds of the same
+     * clock as @ref esp::assets::SceneLoadStatistics::now()
+     */
+    double startTime;
+    /** @brief CPU time of the pass in milliseconds */
+    double cpuTime;
+    /**
+     * @brief GPU time of the pass in milliseconds, negative if timer queries
+     * aren't supported
+     */
+    double gpuTime;
+    /**
+     * @brief Statistics of the drawn scene graph, only for
+     * @ref Pass::Draw, including the CPU time of culling
+     */
+    RenderCamera::DrawStatistics drawStatistics;
+  };
+
+  /**
+   * @brief Times a pass until it goes out of scope
+   *
+   * Does nothing if @p profiler is @cpp nullptr @ce, so it can wrap a pass
+   * unconditionally with @ref Renderer::profiler().
+   */
+  class ScopedPass {
+   public:
+    ScopedPass(RenderProfiler* profiler,
+               const std::string& sensor,
+               Pass pass);
+    ~ScopedPass();
+
+    ScopedPass(const ScopedPass&) = delete;
+    ScopedPass& operator=(const ScopedPass&) = delete;
+
+    /** @brief Set the statistics recorded with the pass */
+    void setDrawStatistics(const RenderCamera::DrawStatistics& statistics);
+
+   private:
+    RenderProfiler* profiler_;
+  };
+
+  /** @brief Constructor. Needs a GL context. */
+  RenderProfiler();
+  ~RenderProfiler();
+
+  /** @brief Whether GPU times are recorded */
+  bool isGpuTimingSupported() const { return gpuTimingSupported_; }
+
+  /**
+   * @brief Begin a pass of @p sensor
+   *
+   * Prefer @ref ScopedPass.
+   */
+  void begin(const std::string& sensor, Pass pass);
+
+  /** @brief Set the statistics of the current pass */
+  void setDrawStatistics(const RenderCamera::DrawStatistics& statistics);
+
+  /** @brief End the current pass */
+  void end();
+
+  /**
+   * @brief Take the records of the passes whose GPU time is known
+   * @param wait  Wait for the GPU times of all passes ended so far instead
+   *    of returning only those already available
+   *
+   * In the order the passes ended. The records are removed from the
+   * profiler, only the most recent @ref MaxRecords are kept if this isn't
+   * called.
+   */
+  std::vector<Record> takeRecords(bool wait = false);
+
+  /** @brief Number of finished records kept at most */
+  static constexpr std::size_t MaxRecords = 4096;
+
+ private:
+  struct Query;
+  struct Pending {
+    Record record;
+    std::unique_ptr<Query> query;
+  };
+
+  void collect(bool wait);
+
+  bool gpuTimingSupported_ = false;
+  bool inPass_ = false;
+  Pending current_;
+  std::deque<Pending> pending_;
+  std::vector<std::unique_ptr<Query>> freeQueries_;
+  std::deque<Record> finished_;
+
+  ESP_SMART_POINTERS(RenderProfiler)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -6,6 +6,7 @@
 #include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGL.h>
 #include <Magnum/GL/PixelFormat.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
@@ -16,14 +17,21 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 
+#include <cstring>
+#include <random>
+
 #include "RenderTarget.h"
 #include "magnum.h"
 
 #include "esp/gfx/DepthUnprojection.h"
+#include "esp/gfx/ObjectIdHistogramShader.h"
+#include "esp/gfx/RenderTargetBackend.h"
+#include "esp/gfx/ResolveShader.h"
 
 #ifdef ESP_BUILD_WITH_CUDA
 #include <cuda_gl_interop.h>
 #include <cuda_runtime.h>
+#include "esp/gfx/DeviceBuffer.h"
 #include "helper_cuda.h"
 #endif
 
@@ -39,41 +47,164 @@ const Mn::GL::Framebuffer::ColorAttachment ObjectIdBuffer =
     Mn::GL::Framebuffer::ColorAttachment{1};
 const Mn::GL::Framebuffer::ColorAttachment UnprojectedDepthBuffer =
     Mn::GL::Framebuffer::ColorAttachment{0};
+const Mn::GL::Framebuffer::ColorAttachment UnprojectedPointsBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{0};
+// attachments of the framebuffer holding the results at the output size
+const Mn::GL::Framebuffer::ColorAttachment OutputColorBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{0};
+const Mn::GL::Framebuffer::ColorAttachment OutputObjectIdBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{1};
+const Mn::GL::Framebuffer::ColorAttachment OutputDepthBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{2};
+const Mn::GL::Framebuffer::ColorAttachment OutputPointsBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{3};
+const Mn::GL::Framebuffer::ColorAttachment HistogramBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{0};
 
-struct RenderTarget::Impl {
-  Impl(const Mn::Vector2i& size,
-       const Mn::Vector2& depthUnprojection,
-       DepthShader* depthShader)
-      : colorBuffer_{},
-        objectIdBuffer_{},
+namespace {
+constexpr int NumFrameTypes = 3;
+
+// Redwood distortion model as a texture, 80 cells of 5 depth bins per row
+const Mn::Vector2i NoiseModelSize{400, 80};
+
+// pixel buffer object receiving one asynchronous read, plus the fence that
+// signals its completion
+struct ReadbackSlot {
+  Mn::GL::BufferImage2D image{Mn::NoCreate};
+  GLsync fence = nullptr;
+};
+
+// ring of pending asynchronous reads for a single frame type
+struct ReadbackQueue {
+  std::vector<ReadbackSlot> slots;
+  size_t first = 0;
+  size_t count = 0;
+};
+}  // namespace
+
+class GLRenderTarget final : public RenderTargetBackend {
+ public:
+  GLRenderTarget(const Mn::Vector2i& size,
+                 const Mn::Vector2& depthUnprojection,
+                 DepthShader* depthShader,
+                 Flags flags,
+                 int samples)
+      : size_{size},
+        flags_{flags},
+        samples_{samples > 1 ? samples : 0},
+        colorBuffer_{Mn::NoCreate},
+        objectIdBuffer_{Mn::NoCreate},
         depthRenderTexture_{},
         framebuffer_{Mn::NoCreate},
         depthUnprojection_{depthUnprojection},
         depthShader_{depthShader},
         unprojectedDepth_{Mn::NoCreate},
         depthUnprojectionMesh_{Mn::NoCreate},
-        depthUnprojectionFrameBuffer_{Mn::NoCreate} {
+        depthUnprojectionFrameBuffer_{Mn::NoCreate},
+        outputColor_{Mn::NoCreate},
+        outputObjectId_{Mn::NoCreate},
+        outputDepth_{Mn::NoCreate},
+        outputFramebuffer_{Mn::NoCreate},
+        resolveSource_{Mn::NoCreate},
+        resolveSourceFramebuffer_{Mn::NoCreate},
+        resolveMesh_{Mn::NoCreate} {
     if (depthShader_) {
       CORRADE_INTERNAL_ASSERT(depthShader_->flags() &
                               DepthShader::Flag::UnprojectExistingDepth);
     }
 
-    colorBuffer_.setStorage(Mn::GL::RenderbufferFormat::SRGB8Alpha8, size);
-    objectIdBuffer_.setStorage(Mn::GL::RenderbufferFormat::R32UI, size);
     depthRenderTexture_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
         .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, size);
 
     framebuffer_ = Mn::GL::Framebuffer{{{}, size}};
-    framebuffer_.attachRenderbuffer(RgbaBuffer, colorBuffer_)
-        .attachRenderbuffer(ObjectIdBuffer, objectIdBuffer_)
-        .attachTexture(Mn::GL::Framebuffer::BufferAttachment::Depth,
-                       depthRenderTexture_, 0)
-        .mapForDraw({{0, RgbaBuffer}, {1, ObjectIdBuffer}});
+    framebuffer_.attachTexture(Mn::GL::Framebuffer::BufferAttachment::Depth,
+                               depthRenderTexture_, 0);
+    if (flags_ & Flag::RgbaAttachment) {
+      colorBuffer_ = Mn::GL::Renderbuffer{};
+      colorBuffer_.setStorage(Mn::GL::RenderbufferFormat::SRGB8Alpha8, size);
+      framebuffer_.attachRenderbuffer(RgbaBuffer, colorBuffer_);
+    }
+    if (flags_ & Flag::ObjectIdAttachment) {
+      objectIdBuffer_ = Mn::GL::Renderbuffer{};
+      objectIdBuffer_.setStorage(Mn::GL::RenderbufferFormat::R32UI, size);
+      framebuffer_.attachRenderbuffer(ObjectIdBuffer, objectIdBuffer_);
+    }
+    mapForDraw(framebuffer_);
     CORRADE_INTERNAL_ASSERT(
         framebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
         Mn::GL::Framebuffer::Status::Complete);
+
+    if (samples_) {
+      initMultisampling();
+    }
+
+    setReadbackBufferCount(2);
+  }
+
+  RenderBackend backend() const override { return RenderBackend::OpenGL; }
+
+  bool hasAttachment(FrameType type) const {
+    switch (type) {
+      case FrameType::Rgba:
+        return bool(flags_ & Flag::RgbaAttachment);
+      case FrameType::ObjectId:
+        return bool(flags_ & Flag::ObjectIdAttachment);
+      case FrameType::Depth:
+        return true;
+    }
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+  }
+
+  // outputs of the drawables go to the attachments that exist
+  void mapForDraw(Mn::GL::Framebuffer& framebuffer) {
+    using DrawAttachment = Mn::GL::Framebuffer::DrawAttachment;
+    framebuffer.mapForDraw(
+        {{0, flags_ & Flag::RgbaAttachment ? DrawAttachment{RgbaBuffer}
+                                           : DrawAttachment::None},
+         {1, flags_ & Flag::ObjectIdAttachment
+                 ? DrawAttachment{ObjectIdBuffer}
+                 : DrawAttachment::None}});
+  }
+
+  void initMultisampling() {
+    multisampleDepth_ = Mn::GL::Renderbuffer{};
+    multisampleDepth_.setStorageMultisample(
+        samples_, Mn::GL::RenderbufferFormat::DepthComponent32F, size_);
+    multisampleFramebuffer_ = Mn::GL::Framebuffer{{{}, size_}};
+    multisampleFramebuffer_.attachRenderbuffer(
+        Mn::GL::Framebuffer::BufferAttachment::Depth, multisampleDepth_);
+    if (flags_ & Flag::RgbaAttachment) {
+      multisampleColor_ = Mn::GL::Renderbuffer{};
+      multisampleColor_.setStorageMultisample(
+          samples_, Mn::GL::RenderbufferFormat::SRGB8Alpha8, size_);
+      multisampleFramebuffer_.attachRenderbuffer(RgbaBuffer,
+                                                 multisampleColor_);
+    }
+    if (flags_ & Flag::ObjectIdAttachment) {
+      multisampleObjectId_ = Mn::GL::Renderbuffer{};
+      multisampleObjectId_.setStorageMultisample(
+          samples_, Mn::GL::RenderbufferFormat::R32UI, size_);
+      multisampleFramebuffer_.attachRenderbuffer(ObjectIdBuffer,
+                                                 multisampleObjectId_);
+    }
+    mapForDraw(multisampleFramebuffer_);
+    CORRADE_INTERNAL_ASSERT(
+        multisampleFramebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+        Mn::GL::Framebuffer::Status::Complete);
+  }
+
+  // blits one attachment of the multisampled framebuffer into the regular
+  // one, which averages color and picks a sample of the rest
+  void resolve(Mn::GL::Framebuffer::ColorAttachment attachment) {
+    multisampleFramebuffer_.mapForRead(attachment);
+    framebuffer_.mapForDraw({{0, attachment}});
+    const Mn::Range2Di viewport = framebuffer_.viewport();
+    Mn::GL::AbstractFramebuffer::blit(multisampleFramebuffer_, framebuffer_,
+                                      viewport, viewport,
+                                      Mn::GL::FramebufferBlit::Color,
+                                      Mn::GL::FramebufferBlitFilter::Nearest);
   }
 
   void initDepthUnprojector() {
@@ -96,27 +227,396 @@ struct RenderTarget::Impl {
     }
   }
 
+  // unprojects the depth of the current viewport into XYZ points
+  void unprojectPointsGPU() {
+    if (pointFramebuffer_.id() == 0) {
+      points_ = Mn::GL::Renderbuffer{};
+      // three-component float formats aren't renderable, read as RGB32F
+      points_.setStorage(Mn::GL::RenderbufferFormat::RGBA32F, size_);
+      pointFramebuffer_ = Mn::GL::Framebuffer{{{}, size_}};
+      pointFramebuffer_.attachRenderbuffer(UnprojectedPointsBuffer, points_)
+          .mapForDraw({{0, UnprojectedPointsBuffer}});
+      CORRADE_INTERNAL_ASSERT(
+          pointFramebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+          Mn::GL::Framebuffer::Status::Complete);
+    }
+    // its own instance too, with the noise applied if there is a model
+    const DepthShader::Flags flags =
+        depthShader_->flags() | DepthShader::Flag::UnprojectToPoints |
+        (noiseShader_ ? DepthShader::Flags{DepthShader::Flag::RedwoodNoise}
+                      : DepthShader::Flags{});
+    if (!pointShader_ || pointShader_->flags() != flags) {
+      pointShader_ = std::make_unique<DepthShader>(flags);
+    }
+
+    pointFramebuffer_.bind();
+    if (noiseShader_) {
+      (*pointShader_)
+          .bindNoiseModelTexture(noiseModel_)
+          .setNoiseMultiplier(noiseMultiplier_)
+          .setNoiseSeed(noiseSeed_++);
+    }
+    (*pointShader_)
+        .bindDepthTexture(depthRenderTexture_)
+        .setDepthUnprojection(depthUnprojection_)
+        .setPointUnprojection(outputFormat_.pointUnprojection)
+        .setPointViewport(framebuffer_.viewport())
+        .setPointTransformation(outputFormat_.pointTransformation)
+        .draw(depthUnprojectionMesh_);
+  }
+
   void unprojectDepthGPU() {
     CORRADE_INTERNAL_ASSERT(depthShader_ != nullptr);
     initDepthUnprojector();
+    if (outputFormat_.points) {
+      unprojectPointsGPU();
+      return;
+    }
 
     depthUnprojectionFrameBuffer_.bind();
+    if (noiseShader_) {
+      (*noiseShader_)
+          .bindDepthTexture(depthRenderTexture_)
+          .bindNoiseModelTexture(noiseModel_)
+          .setNoiseMultiplier(noiseMultiplier_)
+          .setNoiseSeed(noiseSeed_++)
+          .setDepthUnprojection(depthUnprojection_)
+          .setDepthScale(outputFormat_.depthScale)
+          .draw(depthUnprojectionMesh_);
+      return;
+    }
     (*depthShader_)
         .bindDepthTexture(depthRenderTexture_)
         .setDepthUnprojection(depthUnprojection_)
+        .setDepthScale(outputFormat_.depthScale)
         .draw(depthUnprojectionMesh_);
   }
 
-  void renderEnter() {
-    framebuffer_.clearDepth(1.0);
-    framebuffer_.clearColor(0, Mn::Color4{0, 0, 0, 1});
-    framebuffer_.clearColor(1, Mn::Vector4ui{});
-    framebuffer_.bind();
+  void setOutputFormat(const OutputFormat& format) override {
+    CORRADE_ASSERT(format.supersampling > 0 &&
+                       size_ % format.supersampling == Mn::Vector2i{0},
+                   "RenderTarget::setOutputFormat(): framebuffer size"
+                       << size_ << "is not a multiple of supersampling"
+                       << format.supersampling, );
+    CORRADE_ASSERT(depthShader_ != nullptr || format.depthScale == 1.0f,
+                   "RenderTarget::setOutputFormat(): scaling depth requires "
+                   "a DepthShader", );
+    CORRADE_ASSERT(depthShader_ != nullptr || !format.points,
+                   "RenderTarget::setOutputFormat(): reading points requires "
+                   "a DepthShader", );
+    CORRADE_ASSERT(format.objectIdHistogramBins >= 0,
+                   "RenderTarget::setOutputFormat(): expected a non-negative "
+                   "histogram bin count", );
+    outputFormat_ = format;
+  }
+
+  const OutputFormat& outputFormat() const override { return outputFormat_; }
+
+  Mn::Range2Di outputViewport() const override {
+    const Mn::Range2Di viewport = framebuffer_.viewport();
+    return {viewport.min() / outputFormat_.supersampling,
+            viewport.max() / outputFormat_.supersampling};
+  }
+
+  Mn::Range2Di readRange(FrameType type) const override {
+    if (type == FrameType::ObjectId && outputFormat_.objectIdHistogramBins) {
+      return {{}, {outputFormat_.objectIdHistogramBins, 1}};
+    }
+    return outputViewport();
+  }
+
+  // whether a result has to go through the output buffers to be read in the
+  // output format
+  bool needsResolve(FrameType type) const {
+    return outputFormat_.supersampling != 1 ||
+           (type == FrameType::Rgba && outputFormat_.grayscale);
+  }
+
+  void initOutputBuffers() {
+    const Mn::Vector2i outputSize = size_ / outputFormat_.supersampling;
+    if (outputFramebuffer_.id() != 0 && outputSize_ == outputSize &&
+        outputGrayscale_ == outputFormat_.grayscale &&
+        outputHasPoints_ == outputFormat_.points) {
+      return;
+    }
+    outputSize_ = outputSize;
+    outputGrayscale_ = outputFormat_.grayscale;
+    outputHasPoints_ = outputFormat_.points;
+
+    outputColor_ = Mn::GL::Renderbuffer{};
+    outputColor_.setStorage(outputGrayscale_
+                                ? Mn::GL::RenderbufferFormat::R8
+                                : Mn::GL::RenderbufferFormat::RGBA8,
+                            outputSize);
+    outputObjectId_ = Mn::GL::Renderbuffer{};
+    outputObjectId_.setStorage(Mn::GL::RenderbufferFormat::R32UI, outputSize);
+    outputDepth_ = Mn::GL::Renderbuffer{};
+    outputFramebuffer_ = Mn::GL::Framebuffer{{{}, outputSize}};
+    outputFramebuffer_.attachRenderbuffer(OutputColorBuffer, outputColor_)
+        .attachRenderbuffer(OutputObjectIdBuffer, outputObjectId_);
+    if (depthShader_) {
+      outputDepth_.setStorage(Mn::GL::RenderbufferFormat::R32F, outputSize);
+      outputFramebuffer_.attachRenderbuffer(OutputDepthBuffer, outputDepth_);
+      if (outputHasPoints_) {
+        outputPoints_ = Mn::GL::Renderbuffer{};
+        outputPoints_.setStorage(Mn::GL::RenderbufferFormat::RGBA32F,
+                                 outputSize);
+        outputFramebuffer_.attachRenderbuffer(OutputPointsBuffer,
+                                              outputPoints_);
+      }
+    } else {
+      outputDepth_.setStorage(Mn::GL::RenderbufferFormat::DepthComponent32F,
+                              outputSize);
+      outputFramebuffer_.attachRenderbuffer(
+          Mn::GL::Framebuffer::BufferAttachment::Depth, outputDepth_);
+    }
+    CORRADE_INTERNAL_ASSERT(
+        outputFramebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+        Mn::GL::Framebuffer::Status::Complete);
+
+    resolveShader_ = std::make_unique<ResolveShader>(
+        outputGrayscale_ ? ResolveShader::Flag::Grayscale
+                         : ResolveShader::Flags{});
+  }
+
+  // downsamples or converts the color of the current viewport into the
+  // output color buffer
+  void resolveColor() {
+    // renderbuffers can't be sampled, copy the color into a texture first
+    if (resolveSource_.id() == 0) {
+      resolveSource_ = Mn::GL::Texture2D{};
+      resolveSource_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, Mn::GL::TextureFormat::RGBA8, size_);
+      resolveSourceFramebuffer_ = Mn::GL::Framebuffer{{{}, size_}};
+      resolveSourceFramebuffer_.attachTexture(RgbaBuffer, resolveSource_, 0);
+      resolveMesh_ = Mn::GL::Mesh{};
+      resolveMesh_.setCount(3);
+    }
+    const Mn::Range2Di viewport = framebuffer_.viewport();
+    framebuffer_.mapForRead(RgbaBuffer);
+    Mn::GL::AbstractFramebuffer::blit(
+        framebuffer_, resolveSourceFramebuffer_, viewport, viewport,
+        Mn::GL::FramebufferBlit::Color, Mn::GL::FramebufferBlitFilter::Nearest);
+
+    outputFramebuffer_.mapForDraw(OutputColorBuffer)
+        .setViewport(outputViewport())
+        .bind();
+    // the output framebuffer has a depth attachment without a DepthShader
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+    (*resolveShader_)
+        .bindColorTexture(resolveSource_)
+        .setSupersampling(outputFormat_.supersampling)
+        .draw(resolveMesh_);
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
+  }
+
+  // counts the object IDs of the current viewport into the histogram
+  // framebuffer, see OutputFormat::objectIdHistogramBins
+  void histogramObjectIds() {
+    const int bins = outputFormat_.objectIdHistogramBins;
+    if (histogramFramebuffer_.id() == 0 || histogramBins_ != bins) {
+      histogramBins_ = bins;
+      histogram_ = Mn::GL::Renderbuffer{};
+      histogram_.setStorage(Mn::GL::RenderbufferFormat::R32F, {bins, 1});
+      histogramFramebuffer_ = Mn::GL::Framebuffer{{{}, {bins, 1}}};
+      histogramFramebuffer_.attachRenderbuffer(HistogramBuffer, histogram_)
+          .mapForDraw({{0, HistogramBuffer}});
+      CORRADE_INTERNAL_ASSERT(
+          histogramFramebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+          Mn::GL::Framebuffer::Status::Complete);
+    }
+    // renderbuffers can't be sampled, copy the IDs into a texture first
+    if (histogramSource_.id() == 0) {
+      histogramSource_ = Mn::GL::Texture2D{};
+      histogramSource_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, Mn::GL::TextureFormat::R32UI, size_);
+      histogramSourceFramebuffer_ = Mn::GL::Framebuffer{{{}, size_}};
+      histogramSourceFramebuffer_.attachTexture(ObjectIdBuffer,
+                                                histogramSource_, 0);
+      histogramSourceFramebuffer_.mapForDraw({{0, ObjectIdBuffer}});
+      histogramMesh_ = Mn::GL::Mesh{Mn::GL::MeshPrimitive::Points};
+      histogramShader_ = std::make_unique<ObjectIdHistogramShader>();
+    }
+    const Mn::Range2Di viewport = framebuffer_.viewport();
+    framebuffer_.mapForRead(ObjectIdBuffer);
+    Mn::GL::AbstractFramebuffer::blit(
+        framebuffer_, histogramSourceFramebuffer_, viewport, viewport,
+        Mn::GL::FramebufferBlit::Color, Mn::GL::FramebufferBlitFilter::Nearest);
+
+    histogramFramebuffer_.clearColor(0, Mn::Color4{0.0f}).bind();
+    histogramMesh_.setCount(outputViewport().size().product());
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
+    Mn::GL::Renderer::setBlendFunction(Mn::GL::Renderer::BlendFunction::One,
+                                       Mn::GL::Renderer::BlendFunction::One);
+    (*histogramShader_)
+        .bindObjectIdTexture(histogramSource_)
+        .setViewport(viewport, outputFormat_.supersampling)
+        .setBinCount(bins)
+        .draw(histogramMesh_);
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::Blending);
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
+    histogramFramebuffer_.mapForRead(HistogramBuffer);
   }
 
-  void renderExit() {}
+  // prepares a result for reading in the output format and returns the
+  // framebuffer to read it from, with the read attachment mapped
+  Mn::GL::Framebuffer& prepareRead(FrameType type) {
+    CORRADE_ASSERT(hasAttachment(type),
+                   "RenderTarget: the target was created without an "
+                   "attachment for frame type"
+                       << int(type),
+                   framebuffer_);
+    Mn::GL::Framebuffer* source = &framebuffer_;
+    switch (type) {
+      case FrameType::Rgba:
+        framebuffer_.mapForRead(RgbaBuffer);
+        break;
+      case FrameType::ObjectId:
+        // counted at the output resolution directly, no resolve needed
+        if (outputFormat_.objectIdHistogramBins) {
+          histogramObjectIds();
+          return histogramFramebuffer_;
+        }
+        framebuffer_.mapForRead(ObjectIdBuffer);
+        break;
+      case FrameType::Depth:
+        if (depthShader_) {
+          unprojectDepthGPU();
+          if (outputFormat_.points) {
+            pointFramebuffer_.mapForRead(UnprojectedPointsBuffer);
+            source = &pointFramebuffer_;
+          } else {
+            depthUnprojectionFrameBuffer_.mapForRead(UnprojectedDepthBuffer);
+            source = &depthUnprojectionFrameBuffer_;
+          }
+        }
+        break;
+    }
+    if (!needsResolve(type)) {
+      return *source;
+    }
 
-  void blitRgbaToDefault() {
+    initOutputBuffers();
+    const Mn::Range2Di viewport = framebuffer_.viewport();
+    const Mn::Range2Di output = outputViewport();
+    switch (type) {
+      case FrameType::Rgba:
+        resolveColor();
+        outputFramebuffer_.mapForRead(OutputColorBuffer);
+        break;
+      case FrameType::ObjectId:
+        outputFramebuffer_.mapForDraw(OutputObjectIdBuffer);
+        Mn::GL::AbstractFramebuffer::blit(
+            framebuffer_, outputFramebuffer_, viewport, output,
+            Mn::GL::FramebufferBlit::Color,
+            Mn::GL::FramebufferBlitFilter::Nearest);
+        outputFramebuffer_.mapForRead(OutputObjectIdBuffer);
+        break;
+      case FrameType::Depth:
+        // averaging would invent depths between foreground and background
+        if (outputFormat_.points) {
+          outputFramebuffer_.mapForDraw(OutputPointsBuffer);
+          Mn::GL::AbstractFramebuffer::blit(
+              pointFramebuffer_, outputFramebuffer_, viewport, output,
+              Mn::GL::FramebufferBlit::Color,
+              Mn::GL::FramebufferBlitFilter::Nearest);
+          outputFramebuffer_.mapForRead(OutputPointsBuffer);
+        } else if (depthShader_) {
+          outputFramebuffer_.mapForDraw(OutputDepthBuffer);
+          Mn::GL::AbstractFramebuffer::blit(
+              depthUnprojectionFrameBuffer_, outputFramebuffer_, viewport,
+              output, Mn::GL::FramebufferBlit::Color,
+              Mn::GL::FramebufferBlitFilter::Nearest);
+          outputFramebuffer_.mapForRead(OutputDepthBuffer);
+        } else {
+          Mn::GL::AbstractFramebuffer::blit(
+              framebuffer_, outputFramebuffer_, viewport, output,
+              Mn::GL::FramebufferBlit::Depth,
+              Mn::GL::FramebufferBlitFilter::Nearest);
+        }
+        break;
+    }
+    return outputFramebuffer_;
+  }
+
+  void setDepthNoiseModel(Cr::Containers::ArrayView<const float> model,
+                          float noiseMultiplier) override {
+    if (model.empty()) {
+      noiseShader_ = nullptr;
+      noiseModel_ = Mn::GL::Texture2D{Mn::NoCreate};
+      return;
+    }
+    CORRADE_ASSERT(depthShader_ != nullptr,
+                   "RenderTarget::setDepthNoiseModel(): depth noise requires "
+                   "a DepthShader", );
+    CORRADE_ASSERT(model.size() == std::size_t(NoiseModelSize.product()),
+                   "RenderTarget::setDepthNoiseModel(): expected an 80x400 "
+                   "model", );
+    // its own instance, the shader of depthShader_ is shared by all targets
+    if (!noiseShader_) {
+      noiseShader_ = std::make_unique<DepthShader>(
+          depthShader_->flags() | DepthShader::Flag::RedwoodNoise);
+      noiseSeed_ = std::random_device{}();
+    }
+    noiseModel_ = Mn::GL::Texture2D{};
+    noiseModel_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::R32F, NoiseModelSize)
+        .setSubImage(0, {},
+                     Mn::ImageView2D{Mn::PixelFormat::R32F, NoiseModelSize,
+                                     model});
+    noiseMultiplier_ = noiseMultiplier;
+  }
+
+  bool hasDepthNoiseModel() const override {
+    return noiseShader_ != nullptr;
+  }
+
+  void renderEnter() override {
+    Mn::GL::Framebuffer& target =
+        samples_ ? multisampleFramebuffer_ : framebuffer_;
+    target.clearDepth(1.0);
+    if (flags_ & Flag::RgbaAttachment) {
+      target.clearColor(0, Mn::Color4{0, 0, 0, 1});
+    }
+    if (flags_ & Flag::ObjectIdAttachment) {
+      target.clearColor(1, Mn::Vector4ui{});
+    }
+    target.bind();
+  }
+
+  void bind() override {
+    (samples_ ? multisampleFramebuffer_ : framebuffer_).bind();
+  }
+
+  void renderExit() override {
+    if (!samples_) {
+      return;
+    }
+    if (flags_ & Flag::RgbaAttachment) {
+      resolve(RgbaBuffer);
+    }
+    if (flags_ & Flag::ObjectIdAttachment) {
+      resolve(ObjectIdBuffer);
+    }
+    const Mn::Range2Di viewport = framebuffer_.viewport();
+    Mn::GL::AbstractFramebuffer::blit(multisampleFramebuffer_, framebuffer_,
+                                      viewport, viewport,
+                                      Mn::GL::FramebufferBlit::Depth,
+                                      Mn::GL::FramebufferBlitFilter::Nearest);
+    mapForDraw(framebuffer_);
+  }
+
+  void blitRgbaToDefault() override {
+    CORRADE_ASSERT(flags_ & Flag::RgbaAttachment,
+                   "RenderTarget::blitRgbaToDefault(): the target has no "
+                   "color attachment", );
     framebuffer_.mapForRead(RgbaBuffer);
     ASSERT(framebuffer_.viewport() == Mn::GL::defaultFramebuffer.viewport());
 
@@ -126,99 +626,278 @@ struct RenderTarget::Impl {
         Mn::GL::FramebufferBlitFilter::Nearest);
   }
 
-  void readFrameRgba(const Mn::MutableImageView2D& view) {
-    framebuffer_.mapForRead(RgbaBuffer).read(framebuffer_.viewport(), view);
+  void readFrameRgba(const Mn::MutableImageView2D& view) override {
+    prepareRead(FrameType::Rgba).read(outputViewport(), view);
   }
 
-  void readFrameDepth(const Mn::MutableImageView2D& view) {
+  void readFrameDepth(const Mn::MutableImageView2D& view) override {
+    Mn::GL::Framebuffer& source = prepareRead(FrameType::Depth);
     if (depthShader_) {
-      unprojectDepthGPU();
-      depthUnprojectionFrameBuffer_.mapForRead(UnprojectedDepthBuffer)
-          .read(framebuffer_.viewport(), view);
+      source.read(outputViewport(), view);
     } else {
       Mn::MutableImageView2D depthBufferView{
           Mn::GL::PixelFormat::DepthComponent, Mn::GL::PixelType::Float,
           view.size(), view.data()};
-      framebuffer_.read(framebuffer_.viewport(), depthBufferView);
+      source.read(outputViewport(), depthBufferView);
       unprojectDepth(depthUnprojection_,
                      Cr::Containers::arrayCast<Mn::Float>(view.data()));
     }
   }
 
-  void readFrameObjectId(const Mn::MutableImageView2D& view) {
-    framebuffer_.mapForRead(ObjectIdBuffer).read(framebuffer_.viewport(), view);
+  void readFrameObjectId(const Mn::MutableImageView2D& view) override {
+    prepareRead(FrameType::ObjectId)
+        .read(readRange(FrameType::ObjectId), view);
   }
 
-  Mn::Vector2i framebufferSize() const {
-    return framebuffer_.viewport().size();
+  Mn::Vector2i framebufferSize() const { return size_; }
+
+  void queueReadFrame(FrameType type, Mn::PixelFormat pixelFormat) override {
+    ReadbackQueue& queue = readbackQueues_[int(type)];
+    if (queue.count == queue.slots.size()) {
+      // ring is full, recycle the oldest read
+      releaseSlot(queue.slots[queue.first]);
+      queue.first = (queue.first + 1) % queue.slots.size();
+      --queue.count;
+    }
+    ReadbackSlot& slot =
+        queue.slots[(queue.first + queue.count) % queue.slots.size()];
+
+    Mn::GL::Framebuffer& source = prepareRead(type);
+    Mn::GL::PixelFormat format = Mn::GL::pixelFormat(pixelFormat);
+    Mn::GL::PixelType pixelType = Mn::GL::pixelType(pixelFormat);
+    if (type == FrameType::Depth && !depthShader_) {
+      // unprojected on the CPU once the read is retrieved
+      format = Mn::GL::PixelFormat::DepthComponent;
+      pixelType = Mn::GL::PixelType::Float;
+    }
+
+    if (slot.image.buffer().id() == 0 || slot.image.format() != format ||
+        slot.image.type() != pixelType) {
+      // rows of one- and two-byte formats are packed the same way as the
+      // views they are retrieved into
+      slot.image = Mn::GL::BufferImage2D{Mn::PixelStorage{}.setAlignment(1),
+                                         format, pixelType};
+    }
+    source.read(readRange(type), slot.image, Mn::GL::BufferUsage::StreamRead);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++queue.count;
+  }
+
+  bool readQueuedFrame(FrameType type,
+                       const Mn::MutableImageView2D& view,
+                       bool wait) override {
+    ReadbackQueue& queue = readbackQueues_[int(type)];
+    if (queue.count == 0) {
+      return false;
+    }
+    ReadbackSlot& slot = queue.slots[queue.first];
+
+    const GLenum status = glClientWaitSync(
+        slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+      return false;
+    }
+    CORRADE_INTERNAL_ASSERT(status != GL_WAIT_FAILED);
+    CORRADE_ASSERT(view.size() == slot.image.size(),
+                   "RenderTarget::readQueuedFrame(): expected a view of size"
+                       << slot.image.size() << "but got" << view.size(),
+                   false);
+
+    Cr::Containers::ArrayView<char> data = slot.image.buffer().map(
+        0, view.data().size(), Mn::GL::Buffer::MapFlag::Read);
+    CORRADE_INTERNAL_ASSERT(data);
+    std::memcpy(view.data(), data.data(), data.size());
+    slot.image.buffer().unmap();
+
+    if (type == FrameType::Depth && !depthShader_) {
+      unprojectDepth(depthUnprojection_,
+                     Cr::Containers::arrayCast<Mn::Float>(view.data()));
+    }
+
+    releaseSlot(slot);
+    queue.first = (queue.first + 1) % queue.slots.size();
+    --queue.count;
+    return true;
+  }
+
+  int queuedFrameCount(FrameType type) const override {
+    return readbackQueues_[int(type)].count;
   }
 
+  int readbackBufferCount() const override {
+    return readbackQueues_[0].slots.size();
+  }
+
+  void setReadbackBufferCount(int count) override {
+    CORRADE_ASSERT(count > 0,
+                   "RenderTarget::setReadbackBufferCount(): count must be "
+                   "positive", );
+    for (ReadbackQueue& queue : readbackQueues_) {
+      for (ReadbackSlot& slot : queue.slots) {
+        releaseSlot(slot);
+      }
+      queue.slots = std::vector<ReadbackSlot>(count);
+      queue.first = 0;
+      queue.count = 0;
+    }
+  }
+
+  static void releaseSlot(ReadbackSlot& slot) {
+    if (slot.fence) {
+      glDeleteSync(slot.fence);
+      slot.fence = nullptr;
+    }
+  }
+
+  void setViewport(const Mn::Range2Di& viewport) override {
+    CORRADE_ASSERT((viewport.min() >= Mn::Vector2i{0}).all() &&
+                       (viewport.max() <= size_).all(),
+                   "RenderTarget::setViewport(): viewport out of bounds", );
+    // updates the GL viewport as well if the framebuffer is currently bound
+    framebuffer_.setViewport(viewport);
+    if (samples_) {
+      multisampleFramebuffer_.setViewport(viewport);
+    }
+  }
+
+  Mn::Range2Di viewport() const override { return framebuffer_.viewport(); }
+
 #ifdef ESP_BUILD_WITH_CUDA
-  void readFrameRgbaGPU(uint8_t* devPtr) {
+  void readFramesGPU(uint8_t* rgbaDevPtr,
+                     float* depthDevPtr,
+                     int32_t* objectIdDevPtr,
+                     cudaStream_t stream) override {
     // TODO: Consider implementing the GPU read functions with EGLImage
     // See discussion here:
     // https://github.com/facebookresearch/habitat-sim/pull/114#discussion_r312718502
 
-    if (colorBufferCugl_ == nullptr)
-      checkCudaErrors(cudaGraphicsGLRegisterImage(
-          &colorBufferCugl_, colorBuffer_.id(), GL_RENDERBUFFER,
-          cudaGraphicsRegisterFlagsReadOnly));
+    CORRADE_ASSERT(outputFormat_.supersampling == 1 &&
+                       !outputFormat_.grayscale &&
+                       outputFormat_.depthScale == 1.0f &&
+                       !outputFormat_.points &&
+                       !outputFormat_.objectIdHistogramBins,
+                   "RenderTarget::readFramesGPU(): GPU reads support only "
+                   "the default output format", );
+    CORRADE_ASSERT((rgbaDevPtr == nullptr || hasAttachment(FrameType::Rgba)) &&
+                       (objectIdDevPtr == nullptr ||
+                        hasAttachment(FrameType::ObjectId)),
+                   "RenderTarget::readFramesGPU(): the target has no "
+                   "attachment for a requested frame", );
 
-    checkCudaErrors(cudaGraphicsMapResources(1, &colorBufferCugl_, 0));
+    // GL has to finish writing the unprojected depth before it gets mapped
+    if (depthDevPtr != nullptr)
+      unprojectDepthGPU();
 
-    cudaArray* array = nullptr;
-    checkCudaErrors(
-        cudaGraphicsSubResourceGetMappedArray(&array, colorBufferCugl_, 0, 0));
-    const int widthInBytes = framebufferSize().x() * 4 * sizeof(uint8_t);
-    checkCudaErrors(cudaMemcpy2DFromArray(devPtr, widthInBytes, array, 0, 0,
-                                          widthInBytes, framebufferSize().y(),
-                                          cudaMemcpyDeviceToDevice));
+    cudaGraphicsResource_t resources[NumFrameTypes];
+    void* devPtrs[NumFrameTypes];
+    size_t pixelSizes[NumFrameTypes];
+    int count = 0;
+    auto addResource = [&](cudaGraphicsResource_t resource, void* devPtr,
+                           size_t pixelSize) {
+      resources[count] = resource;
+      devPtrs[count] = devPtr;
+      pixelSizes[count] = pixelSize;
+      ++count;
+    };
+    if (rgbaDevPtr != nullptr)
+      addResource(registeredResource(colorBufferCugl_, colorBuffer_.id()),
+                  rgbaDevPtr, 4 * sizeof(uint8_t));
+    if (depthDevPtr != nullptr)
+      addResource(registeredResource(depthBufferCugl_, unprojectedDepth_.id()),
+                  depthDevPtr, 1 * sizeof(float));
+    if (objectIdDevPtr != nullptr)
+      addResource(
+          registeredResource(objecIdBufferCugl_, objectIdBuffer_.id()),
+          objectIdDevPtr, 1 * sizeof(int32_t));
+    if (count == 0)
+      return;
 
-    checkCudaErrors(cudaGraphicsUnmapResources(1, &colorBufferCugl_, 0));
+    // map, copy and unmap are all ordered on the stream, so the host doesn't
+    // wait for the copies to finish
+    checkCudaErrors(cudaGraphicsMapResources(count, resources, stream));
+    for (int i = 0; i < count; ++i) {
+      cudaArray* array = nullptr;
+      checkCudaErrors(
+          cudaGraphicsSubResourceGetMappedArray(&array, resources[i], 0, 0));
+      const size_t widthInBytes = framebufferSize().x() * pixelSizes[i];
+      checkCudaErrors(cudaMemcpy2DFromArrayAsync(
+          devPtrs[i], widthInBytes, array, 0, 0, widthInBytes,
+          framebufferSize().y(), cudaMemcpyDeviceToDevice, stream));
+    }
+    checkCudaErrors(cudaGraphicsUnmapResources(count, resources, stream));
   }
 
-  void readFrameDepthGPU(float* devPtr) {
-    unprojectDepthGPU();
-
-    if (depthBufferCugl_ == nullptr)
-      checkCudaErrors(cudaGraphicsGLRegisterImage(
-          &depthBufferCugl_, unprojectedDepth_.id(), GL_RENDERBUFFER,
-          cudaGraphicsRegisterFlagsReadOnly));
-
-    checkCudaErrors(cudaGraphicsMapResources(1, &depthBufferCugl_, 0));
+  std::shared_ptr<DeviceBuffer> readFrameToDevice(
+      FrameType type,
+      cudaStream_t stream) override {
+    const int typeIndex = static_cast<int>(type);
+    std::vector<std::shared_ptr<DeviceBuffer>>& pool =
+        deviceBufferPools_[typeIndex];
+    if (pool.empty()) {
+      pool.resize(RenderTarget::DeviceBufferPoolSize);
+    }
+    std::shared_ptr<DeviceBuffer>& buffer =
+        pool[deviceBufferPoolNext_[typeIndex]];
+    deviceBufferPoolNext_[typeIndex] =
+        (deviceBufferPoolNext_[typeIndex] + 1) %
+        RenderTarget::DeviceBufferPoolSize;
 
-    cudaArray* array = nullptr;
-    checkCudaErrors(
-        cudaGraphicsSubResourceGetMappedArray(&array, depthBufferCugl_, 0, 0));
-    const int widthInBytes = framebufferSize().x() * 1 * sizeof(float);
-    checkCudaErrors(cudaMemcpy2DFromArray(devPtr, widthInBytes, array, 0, 0,
-                                          widthInBytes, framebufferSize().y(),
-                                          cudaMemcpyDeviceToDevice));
+    // a frame handed out earlier is still in use, leave it to its holder
+    if (buffer == nullptr || buffer.use_count() > 1) {
+      const size_t width = framebufferSize().x();
+      const size_t height = framebufferSize().y();
+      switch (type) {
+        case FrameType::Rgba:
+          buffer = DeviceBuffer::create(std::vector<size_t>{height, width, 4},
+                                        core::DataType::DT_UINT8);
+          break;
+        case FrameType::Depth:
+          buffer = DeviceBuffer::create(std::vector<size_t>{height, width},
+                                        core::DataType::DT_FLOAT);
+          break;
+        case FrameType::ObjectId:
+          buffer = DeviceBuffer::create(std::vector<size_t>{height, width},
+                                        core::DataType::DT_INT32);
+          break;
+      }
+    }
 
-    checkCudaErrors(cudaGraphicsUnmapResources(1, &depthBufferCugl_, 0));
+    switch (type) {
+      case FrameType::Rgba:
+        readFramesGPU(static_cast<uint8_t*>(buffer->data()), nullptr, nullptr,
+                      stream);
+        break;
+      case FrameType::Depth:
+        readFramesGPU(nullptr, static_cast<float*>(buffer->data()), nullptr,
+                      stream);
+        break;
+      case FrameType::ObjectId:
+        readFramesGPU(nullptr, nullptr, static_cast<int32_t*>(buffer->data()),
+                      stream);
+        break;
+    }
+    return buffer;
   }
 
-  void readFrameObjectIdGPU(int32_t* devPtr) {
-    if (objecIdBufferCugl_ == nullptr)
+  // register a renderbuffer with CUDA once, the registration is then kept for
+  // the lifetime of the target and only mapped for each read
+  static cudaGraphicsResource_t registeredResource(
+      cudaGraphicsResource_t& resource,
+      GLuint renderbuffer) {
+    if (resource == nullptr)
       checkCudaErrors(cudaGraphicsGLRegisterImage(
-          &objecIdBufferCugl_, objectIdBuffer_.id(), GL_RENDERBUFFER,
+          &resource, renderbuffer, GL_RENDERBUFFER,
           cudaGraphicsRegisterFlagsReadOnly));
-
-    checkCudaErrors(cudaGraphicsMapResources(1, &objecIdBufferCugl_, 0));
-
-    cudaArray* array = nullptr;
-    checkCudaErrors(cudaGraphicsSubResourceGetMappedArray(
-        &array, objecIdBufferCugl_, 0, 0));
-    const int widthInBytes = framebufferSize().x() * 1 * sizeof(int32_t);
-    checkCudaErrors(cudaMemcpy2DFromArray(devPtr, widthInBytes, array, 0, 0,
-                                          widthInBytes, framebufferSize().y(),
-                                          cudaMemcpyDeviceToDevice));
-
-    checkCudaErrors(cudaGraphicsUnmapResources(1, &objecIdBufferCugl_, 0));
+    return resource;
   }
 #endif
 
-  ~Impl() {
+  ~GLRenderTarget() override {
+    for (ReadbackQueue& queue : readbackQueues_) {
+      for (ReadbackSlot& slot : queue.slots) {
+        releaseSlot(slot);
+      }
+    }
 #ifdef ESP_BUILD_WITH_CUDA
     if (colorBufferCugl_ != nullptr)
       checkCudaErrors(cudaGraphicsUnregisterResource(colorBufferCugl_));
@@ -230,70 +909,276 @@ struct RenderTarget::Impl {
   }
 
  private:
+  Mn::Vector2i size_;
+  Flags flags_;
+  int samples_;
   Mn::GL::Renderbuffer colorBuffer_;
   Mn::GL::Renderbuffer objectIdBuffer_;
   Mn::GL::Texture2D depthRenderTexture_;
   Mn::GL::Framebuffer framebuffer_;
+  // drawn into instead of framebuffer_ with multisampling, see renderExit()
+  Mn::GL::Renderbuffer multisampleColor_{Mn::NoCreate};
+  Mn::GL::Renderbuffer multisampleObjectId_{Mn::NoCreate};
+  Mn::GL::Renderbuffer multisampleDepth_{Mn::NoCreate};
+  Mn::GL::Framebuffer multisampleFramebuffer_{Mn::NoCreate};
 
   Mn::Vector2 depthUnprojection_;
   DepthShader* depthShader_;
+  // variant of depthShader_ applying the Redwood noise while unprojecting
+  std::unique_ptr<DepthShader> noiseShader_;
+  Mn::GL::Texture2D noiseModel_{Mn::NoCreate};
+  float noiseMultiplier_ = 1.0f;
+  Mn::UnsignedInt noiseSeed_ = 0;
   Mn::GL::Renderbuffer unprojectedDepth_;
   Mn::GL::Mesh depthUnprojectionMesh_;
   Mn::GL::Framebuffer depthUnprojectionFrameBuffer_;
+  // depth unprojected to points, see OutputFormat::points
+  std::unique_ptr<DepthShader> pointShader_;
+  Mn::GL::Renderbuffer points_{Mn::NoCreate};
+  Mn::GL::Framebuffer pointFramebuffer_{Mn::NoCreate};
+
+  // results at the output size, see setOutputFormat()
+  OutputFormat outputFormat_;
+  Mn::Vector2i outputSize_;
+  bool outputGrayscale_ = false;
+  bool outputHasPoints_ = false;
+  Mn::GL::Renderbuffer outputColor_;
+  Mn::GL::Renderbuffer outputObjectId_;
+  Mn::GL::Renderbuffer outputDepth_;
+  Mn::GL::Renderbuffer outputPoints_{Mn::NoCreate};
+  Mn::GL::Framebuffer outputFramebuffer_;
+  // color copied out of the renderbuffer for the resolve shader to sample
+  Mn::GL::Texture2D resolveSource_;
+  Mn::GL::Framebuffer resolveSourceFramebuffer_;
+  Mn::GL::Mesh resolveMesh_;
+  std::unique_ptr<ResolveShader> resolveShader_;
+  // object IDs counted per bin, see OutputFormat::objectIdHistogramBins
+  int histogramBins_ = 0;
+  Mn::GL::Renderbuffer histogram_{Mn::NoCreate};
+  Mn::GL::Framebuffer histogramFramebuffer_{Mn::NoCreate};
+  Mn::GL::Texture2D histogramSource_{Mn::NoCreate};
+  Mn::GL::Framebuffer histogramSourceFramebuffer_{Mn::NoCreate};
+  Mn::GL::Mesh histogramMesh_{Mn::NoCreate};
+  std::unique_ptr<ObjectIdHistogramShader> histogramShader_;
+
+  ReadbackQueue readbackQueues_[NumFrameTypes];
 
 #ifdef ESP_BUILD_WITH_CUDA
+  std::vector<std::shared_ptr<DeviceBuffer>>
+      deviceBufferPools_[NumFrameTypes];
+  size_t deviceBufferPoolNext_[NumFrameTypes] = {};
   cudaGraphicsResource_t colorBufferCugl_ = nullptr;
   cudaGraphicsResource_t objecIdBufferCugl_ = nullptr;
   cudaGraphicsResource_t depthBufferCugl_ = nullptr;
 #endif
-};  // namespace gfx
+};
+
+struct RenderTarget::Impl {
+  Mn::Vector2i size;
+  Mn::Vector2 depthUnprojection;
+  DepthShader* depthShader;
+  Flags flags;
+  int samples;
+  std::unique_ptr<RenderTargetBackend> backend;
+};
+
+namespace {
+// the only place that knows the implementations of RenderTargetBackend
+std::unique_ptr<RenderTargetBackend> createRenderTargetBackend(
+    RenderBackend backend,
+    const Mn::Vector2i& size,
+    const Mn::Vector2& depthUnprojection,
+    DepthShader* depthShader,
+    RenderTarget::Flags flags,
+    int samples) {
+  CORRADE_ASSERT(isRenderBackendAvailable(backend),
+                 "RenderTarget: the" << renderBackendName(backend)
+                                     << "backend is not implemented",
+                 nullptr);
+  switch (backend) {
+    case RenderBackend::OpenGL:
+      return std::make_unique<GLRenderTarget>(size, depthUnprojection,
+                                              depthShader, flags, samples);
+    case RenderBackend::Vulkan:
+      break;
+  }
+  CORRADE_ASSERT_UNREACHABLE();
+  return nullptr;
+}
+}  // namespace
+
+#ifdef ESP_BUILD_WITH_CUDA
+// static constexpr members require redundant definitions until C++17
+constexpr int RenderTarget::DeviceBufferPoolSize;
+#endif
 
 RenderTarget::RenderTarget(const Mn::Vector2i& size,
                            const Mn::Vector2& depthUnprojection,
                            DepthShader* depthShader)
-    : pimpl_(spimpl::make_unique_impl<Impl>(size,
-                                            depthUnprojection,
-                                            depthShader)) {}
+    : RenderTarget{size, depthUnprojection, depthShader,
+                   Flag::RgbaAttachment | Flag::ObjectIdAttachment} {}
+
+RenderTarget::RenderTarget(const Mn::Vector2i& size,
+                           const Mn::Vector2& depthUnprojection,
+                           DepthShader* depthShader,
+                           Flags flags,
+                           int samples,
+                           RenderBackend backend)
+    : pimpl_(spimpl::make_unique_impl<Impl>(Impl{
+          size, depthUnprojection, depthShader, flags,
+          samples > 1 ? samples : 0,
+          createRenderTargetBackend(backend, size, depthUnprojection,
+                                    depthShader, flags, samples)})) {}
 
 void RenderTarget::renderEnter() {
-  pimpl_->renderEnter();
+  pimpl_->backend->renderEnter();
+}
+
+void RenderTarget::bind() {
+  pimpl_->backend->bind();
 }
 
 void RenderTarget::renderExit() {
-  pimpl_->renderExit();
+  pimpl_->backend->renderExit();
+}
+
+RenderTarget::Flags RenderTarget::flags() const {
+  return pimpl_->flags;
+}
+
+int RenderTarget::samples() const {
+  return pimpl_->samples;
+}
+
+RenderBackend RenderTarget::backend() const {
+  return pimpl_->backend->backend();
 }
 
 void RenderTarget::readFrameRgba(const Mn::MutableImageView2D& view) {
-  pimpl_->readFrameRgba(view);
+  pimpl_->backend->readFrameRgba(view);
 }
 
 void RenderTarget::readFrameDepth(const Mn::MutableImageView2D& view) {
-  pimpl_->readFrameDepth(view);
+  pimpl_->backend->readFrameDepth(view);
 }
 
 void RenderTarget::readFrameObjectId(const Mn::MutableImageView2D& view) {
-  pimpl_->readFrameObjectId(view);
+  pimpl_->backend->readFrameObjectId(view);
+}
+
+void RenderTarget::queueReadFrame(FrameType type) {
+  Mn::PixelFormat format = Mn::PixelFormat::RGBA8Unorm;
+  if (type == FrameType::Depth) {
+    format = Mn::PixelFormat::R32F;
+  } else if (type == FrameType::ObjectId) {
+    format = pimpl_->backend->outputFormat().objectIdHistogramBins
+                 ? Mn::PixelFormat::R32F
+                 : Mn::PixelFormat::R32UI;
+  } else if (pimpl_->backend->outputFormat().grayscale) {
+    format = Mn::PixelFormat::R8Unorm;
+  }
+  pimpl_->backend->queueReadFrame(type, format);
+}
+
+void RenderTarget::queueReadFrame(FrameType type, Mn::PixelFormat format) {
+  pimpl_->backend->queueReadFrame(type, format);
+}
+
+bool RenderTarget::readQueuedFrame(FrameType type,
+                                   const Mn::MutableImageView2D& view,
+                                   bool wait) {
+  return pimpl_->backend->readQueuedFrame(type, view, wait);
+}
+
+int RenderTarget::queuedFrameCount(FrameType type) const {
+  return pimpl_->backend->queuedFrameCount(type);
+}
+
+int RenderTarget::readbackBufferCount() const {
+  return pimpl_->backend->readbackBufferCount();
+}
+
+void RenderTarget::setReadbackBufferCount(int count) {
+  pimpl_->backend->setReadbackBufferCount(count);
+}
+
+void RenderTarget::setDepthNoiseModel(
+    Cr::Containers::ArrayView<const float> model,
+    float noiseMultiplier) {
+  pimpl_->backend->setDepthNoiseModel(model, noiseMultiplier);
+}
+
+bool RenderTarget::hasDepthNoiseModel() const {
+  return pimpl_->backend->hasDepthNoiseModel();
+}
+
+void RenderTarget::setOutputFormat(const OutputFormat& format) {
+  pimpl_->backend->setOutputFormat(format);
+}
+
+const RenderTarget::OutputFormat& RenderTarget::outputFormat() const {
+  return pimpl_->backend->outputFormat();
+}
+
+Mn::Range2Di RenderTarget::outputViewport() const {
+  return pimpl_->backend->outputViewport();
+}
+
+Mn::Vector2i RenderTarget::outputSize(FrameType type) const {
+  return pimpl_->backend->readRange(type).size();
 }
 
 void RenderTarget::blitRgbaToDefault() {
-  pimpl_->blitRgbaToDefault();
+  pimpl_->backend->blitRgbaToDefault();
 }
 
 Mn::Vector2i RenderTarget::framebufferSize() const {
-  return pimpl_->framebufferSize();
+  return pimpl_->size;
+}
+
+Mn::Vector2 RenderTarget::depthUnprojection() const {
+  return pimpl_->depthUnprojection;
+}
+
+RenderTarget::uptr RenderTarget::createCompatible() const {
+  return RenderTarget::create_unique(
+      pimpl_->size, pimpl_->depthUnprojection, pimpl_->depthShader,
+      pimpl_->flags, pimpl_->samples, pimpl_->backend->backend());
+}
+
+void RenderTarget::setViewport(const Mn::Range2Di& viewport) {
+  pimpl_->backend->setViewport(viewport);
+}
+
+Mn::Range2Di RenderTarget::viewport() const {
+  return pimpl_->backend->viewport();
 }
 
 #ifdef ESP_BUILD_WITH_CUDA
-void RenderTarget::readFrameRgbaGPU(uint8_t* devPtr) {
-  pimpl_->readFrameRgbaGPU(devPtr);
+void RenderTarget::readFrameRgbaGPU(uint8_t* devPtr, cudaStream_t stream) {
+  pimpl_->backend->readFramesGPU(devPtr, nullptr, nullptr, stream);
+}
+
+void RenderTarget::readFrameDepthGPU(float* devPtr, cudaStream_t stream) {
+  pimpl_->backend->readFramesGPU(nullptr, devPtr, nullptr, stream);
+}
+
+void RenderTarget::readFrameObjectIdGPU(int32_t* devPtr, cudaStream_t stream) {
+  pimpl_->backend->readFramesGPU(nullptr, nullptr, devPtr, stream);
 }
 
-void RenderTarget::readFrameDepthGPU(float* devPtr) {
-  pimpl_->readFrameDepthGPU(devPtr);
+void RenderTarget::readFramesGPU(uint8_t* rgbaDevPtr,
+                                 float* depthDevPtr,
+                                 int32_t* objectIdDevPtr,
+                                 cudaStream_t stream) {
+  pimpl_->backend->readFramesGPU(rgbaDevPtr, depthDevPtr, objectIdDevPtr,
+                                 stream);
 }
 
-void RenderTarget::readFrameObjectIdGPU(int32_t* devPtr) {
-  pimpl_->readFrameObjectIdGPU(devPtr);
+std::shared_ptr<DeviceBuffer> RenderTarget::readFrameToDevice(
+    FrameType type,
+    cudaStream_t stream) {
+  return pimpl_->backend->readFrameToDevice(type, stream);
 }
 #endif
 
@@ -4,15 +4,28 @@
 
 #pragma once
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/EnumSet.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
 
 #include "esp/core/esp.h"
 
 #include "esp/gfx/DepthUnprojection.h"
+#include "esp/gfx/RenderBackend.h"
+
+#ifdef ESP_BUILD_WITH_CUDA
+// same declaration as in cuda_runtime_api.h, so that users of this header
+// don't need the CUDA include path
+typedef struct CUstream_st* cudaStream_t;
+#endif
 
 namespace esp {
 namespace gfx {
 
+class DeviceBuffer;
+
 /**
  * Holds a framebuffer and encapsulates the logic of retrieving rendering
  * results of various types (RGB, Depth, ObjectID) from the framebuffer.
@@ -22,6 +35,103 @@ namespace gfx {
  */
 class RenderTarget {
  public:
+  /**
+   * @brief Kind of rendering result, used by the asynchronous read functions
+   */
+  enum class FrameType {
+    /** @brief RGBA color, read as @ref Magnum::PixelFormat::RGBA8Unorm */
+    Rgba = 0,
+    /** @brief Unprojected depth, read as @ref Magnum::PixelFormat::R32F */
+    Depth = 1,
+    /** @brief Object ID, read as @ref Magnum::PixelFormat::R32UI */
+    ObjectId = 2,
+  };
+
+  /**
+   * @brief Attachment besides the depth, which is always present
+   */
+  enum class Flag {
+    /** Color, read with @ref readFrameRgba() */
+    RgbaAttachment = 1 << 0,
+    /** Object IDs, read with @ref readFrameObjectId() */
+    ObjectIdAttachment = 1 << 1,
+  };
+
+  /** @brief Attachments */
+  typedef Corrade::Containers::EnumSet<Flag> Flags;
+
+  /**
+   * @brief Processing of the rendering results before they are read back
+   *
+   * Done on the GPU, so only the processed pixels are transferred. See
+   * @ref setOutputFormat().
+   */
+  struct OutputFormat {
+    /**
+     * @brief How many times the framebuffer is larger than the read results
+     * in each dimension
+     *
+     * Color is averaged over the pixels each result pixel covers, depth and
+     * object IDs take the value of one of them. Has to divide the framebuffer
+     * size and the viewport.
+     */
+    int supersampling = 1;
+
+    /**
+     * @brief Whether color is converted to 8-bit luminance
+     *
+     * Read it with @ref Magnum::PixelFormat::R8Unorm views.
+     */
+    bool grayscale = false;
+
+    /**
+     * @brief Multiplier of the unprojected depth
+     *
+     * Read through a normalized format, e.g. a scale of
+     * @cpp 1000.0f/65535.0f @ce with @ref Magnum::PixelFormat::R16Unorm views
+     * gives depth in integer millimeters, saturating at 65.535 m. Requires a
+     * valid DepthShader unless @cpp 1.0f @ce.
+     */
+    float depthScale = 1.0f;
+
+    /**
+     * @brief Whether depth is read as XYZ points instead
+     *
+     * Read them with @ref Magnum::PixelFormat::RGB32F views. Pixels without
+     * depth are NaN. Requires a valid DepthShader, @ref depthScale doesn't
+     * apply.
+     */
+    bool points = false;
+
+    /**
+     * @brief Camera-space X and Y of a point at unit depth in the corner of
+     * the viewport
+     *
+     * The inverses of the first two diagonal elements of the perspective
+     * projection the depth was rendered with.
+     */
+    Magnum::Vector2 pointUnprojection{1.0f};
+
+    /**
+     * @brief Transformation of the camera-space points, e.g. the absolute
+     * transformation of the camera for points in the world frame
+     */
+    Magnum::Matrix4 pointTransformation;
+
+    /**
+     * @brief Whether object IDs are read as a histogram with this many bins
+     * instead, 0 for none
+     *
+     * Bin @f$ i @f$ counts the output pixels of ID @f$ i @f$, IDs past the
+     * last bin aren't counted. Read it with 1-pixel-high
+     * @ref Magnum::PixelFormat::R32F views as wide as the bin count, see
+     * @ref outputSize(). Counts are exact up to @f$ 2^{24} @f$ pixels. At
+     * most the maximum renderbuffer size, which is at least 16384 on
+     * desktop GL.
+     */
+    int objectIdHistogramBins = 0;
+  };
+
   /**
    * @brief Constructor
    * @param size               The size of the underlying framebuffers in WxH
@@ -31,11 +141,35 @@ class RenderTarget {
    *                           Unprojects the depth on the CPU if nullptr.
    *                           Must be not nullptr to use @ref
    *                           readFrameDepthGPU()
+   *
+   * Has all attachments and no multisampling.
    */
   RenderTarget(const Magnum::Vector2i& size,
                const Magnum::Vector2& depthUnprojection,
                DepthShader* depthShader);
 
+  /**
+   * @brief Construct with a choice of attachments and multisampling
+   * @param size               The size of the underlying framebuffers in WxH
+   * @param depthUnprojection  Depth unprojection parameters
+   * @param depthShader        A DepthShader used to unproject depth on the
+   *                           GPU, see above
+   * @param flags              Attachments to allocate besides the depth
+   * @param samples            Samples per pixel, 0 or 1 for none
+   * @param backend            Graphics API to implement the target on, has
+   *                           to be @ref isRenderBackendAvailable()
+   *
+   * With multisampling, draws go into multisampled attachments that
+   * @ref renderExit() resolves. Color is averaged over the samples, depth
+   * and object IDs take one of them.
+   */
+  RenderTarget(const Magnum::Vector2i& size,
+               const Magnum::Vector2& depthUnprojection,
+               DepthShader* depthShader,
+               Flags flags,
+               int samples = 0,
+               RenderBackend backend = RenderBackend::OpenGL);
+
   /**
    * @brief Constructor
    * @param size               The size of the underlying framebuffers in WxH
@@ -48,7 +182,7 @@ class RenderTarget {
                const Magnum::Vector2& depthUnprojection)
       : RenderTarget{size, depthUnprojection, nullptr} {};
 
-  ~RenderTarget() { LOG(INFO) << "Deconstructing RenderTarget"; }
+  ~RenderTarget() { VLOG(1) << "Deconstructing RenderTarget"; }
 
   /**
    * @brief Called before any draw calls that target this RenderTarget
@@ -56,21 +190,99 @@ class RenderTarget {
    */
   void renderEnter();
 
+  /**
+   * @brief Bind the framebuffer again without clearing it
+   *
+   * For draws continuing after @ref renderEnter() once another target was
+   * bound in between, see @ref Renderer::drawMultiView().
+   */
+  void bind();
+
   /**
    * @brief Called after any draw calls that target this RenderTarget
+   *
+   * Resolves the multisampled attachments, if any.
    */
   void renderExit();
 
+  /** @brief Attachments besides the depth */
+  Flags flags() const;
+
+  /** @brief Samples per pixel, 0 without multisampling */
+  int samples() const;
+
+  /** @brief Graphics API the target is implemented on */
+  RenderBackend backend() const;
+
   /**
    * @brief The size of the framebuffer in WxH
    */
   Magnum::Vector2i framebufferSize() const;
 
+  /**
+   * @brief Depth unprojection parameters passed to the constructor
+   */
+  Magnum::Vector2 depthUnprojection() const;
+
+  /**
+   * @brief Create an empty target with the same size, depth unprojection,
+   * DepthShader, attachments, multisampling and backend
+   *
+   * None of the rendering results, the output format, the depth noise model
+   * or queued reads are carried over.
+   */
+  RenderTarget::uptr createCompatible() const;
+
+  /**
+   * @brief Restrict subsequent draws and reads to a sub-rectangle of the
+   * framebuffer.
+   *
+   * Used to render several views into tiles of one large framebuffer, see
+   * @ref Renderer::drawBatch(). The read functions read the current viewport
+   * only, so the passed views must have the size of the viewport. Defaults to
+   * the whole framebuffer.
+   */
+  void setViewport(const Magnum::Range2Di& viewport);
+
+  /**
+   * @brief The rectangle that draws and reads are currently restricted to
+   */
+  Magnum::Range2Di viewport() const;
+
+  /**
+   * @brief Set the processing of subsequent reads
+   *
+   * Results are read in the @ref outputViewport(), the viewport scaled down
+   * by @ref OutputFormat::supersampling. Applies to the synchronous and the
+   * queued reads, not to the reads into CUDA memory, which support only the
+   * default format.
+   */
+  void setOutputFormat(const OutputFormat& format);
+
+  /** @brief The processing of reads, see @ref setOutputFormat() */
+  const OutputFormat& outputFormat() const;
+
+  /**
+   * @brief The rectangle reads return, the @ref viewport() scaled down by
+   * @ref OutputFormat::supersampling
+   */
+  Magnum::Range2Di outputViewport() const;
+
+  /**
+   * @brief The size of the views reads of @p type expect
+   *
+   * The size of the @ref outputViewport(), except for object IDs read as a
+   * histogram, see @ref OutputFormat::objectIdHistogramBins.
+   */
+  Magnum::Vector2i outputSize(FrameType type) const;
+
   /**
    * @brief Retrieve the RGBA rendering results.
    *
    * @param[in, out] view Preallocated memory that will be populated with the
-   * result.  The result will be read as the pixel format of this view.
+   * result.  The result will be read as the pixel format of this view, e.g.
+   * @ref Magnum::PixelFormat::RGB8Unorm drops the alpha channel during the
+   * transfer.
    */
   void readFrameRgba(const Magnum::MutableImageView2D& view);
 
@@ -79,7 +291,9 @@ class RenderTarget {
    *
    * @param[in, out] view Preallocated memory that will be populated with the
    * result.  The PixelFormat of the image must only specify the R channel,
-   * generally @ref Magnum::PixelFormat::R32F
+   * generally @ref Magnum::PixelFormat::R32F. With a DepthShader, the depth
+   * can also be converted to @ref Magnum::PixelFormat::R16F or, see
+   * @ref OutputFormat::depthScale, to a normalized format
    */
   void readFrameDepth(const Magnum::MutableImageView2D& view);
 
@@ -95,6 +309,79 @@ class RenderTarget {
    */
   void readFrameObjectId(const Magnum::MutableImageView2D& view);
 
+  /**
+   * @brief Queue an asynchronous read of the current frame
+   *
+   * The pixels of the current viewport are copied into a pixel buffer object
+   * without waiting for rendering to finish. Retrieve them later with @ref
+   * readQueuedFrame(), ideally after the next frame has been submitted so the
+   * copy overlaps with drawing. Each @ref FrameType has its own ring of @ref
+   * readbackBufferCount() buffers; queueing into a full ring discards the
+   * oldest read.
+   */
+  void queueReadFrame(FrameType type);
+
+  /**
+   * @brief Queue an asynchronous read of the current frame in a given format
+   *
+   * Like @ref queueReadFrame(FrameType), with the conversions the synchronous
+   * reads do for views of @p format. A view of @p format retrieves it.
+   */
+  void queueReadFrame(FrameType type, Magnum::PixelFormat format);
+
+  /**
+   * @brief Retrieve the oldest queued read of the given type
+   *
+   * @param[in] type      Type of the queued read
+   * @param[in, out] view Preallocated memory of the same size as the output
+   *                      viewport the read was queued with and of the pixel
+   *                      format listed in @ref FrameType, or R8Unorm color
+   *                      with @ref OutputFormat::grayscale, or the one passed
+   *                      to @ref queueReadFrame(FrameType, Magnum::PixelFormat)
+   * @param[in] wait      Whether to block until the GPU has finished the read.
+   *                      If false and the read is not done, nothing is
+   *                      retrieved
+   * @return Whether a result was written into @p view
+   */
+  bool readQueuedFrame(FrameType type,
+                       const Magnum::MutableImageView2D& view,
+                       bool wait = true);
+
+  /**
+   * @brief Number of queued reads of the given type not yet retrieved
+   */
+  int queuedFrameCount(FrameType type) const;
+
+  /**
+   * @brief Number of pixel buffer objects per @ref FrameType, 2 by default
+   *
+   * Use 2 for double- and 3 for triple-buffered readback. Changing the count
+   * discards all queued reads.
+   */
+  int readbackBufferCount() const;
+
+  /** @brief Set the number of pixel buffer objects per @ref FrameType */
+  void setReadbackBufferCount(int count);
+
+  /**
+   * @brief Apply the Redwood depth noise model while unprojecting depth
+   * @param model            The distortion model, 80 rows of 80 cells with 5
+   *                         depth bins each, as used by
+   *                         @ref sensor::RedwoodNoiseModelCPUImpl. An empty
+   *                         view disables the noise
+   * @param noiseMultiplier  Multiplier for the Gaussian random-variables
+   *
+   * The noise is computed in the same pass that unprojects depth, so every
+   * depth read, whether synchronous, queued or into CUDA memory, returns
+   * noisy depth without any extra copy or buffer. The noise differs every
+   * read. Requires the rendering target to have a valid DepthShader.
+   */
+  void setDepthNoiseModel(Corrade::Containers::ArrayView<const float> model,
+                          float noiseMultiplier);
+
+  /** @brief Whether depth noise is applied, see @ref setDepthNoiseModel() */
+  bool hasDepthNoiseModel() const;
+
   /**
    * @brief Blits the rgba buffer from internal FBO to default frame buffer
    * which in case of EmscriptenApplication will be a canvas element.
@@ -112,10 +399,15 @@ class RenderTarget {
    * caller is responsible for allocating memory and ensuring that the OpenGL
    * context and the devPtr are on the same CUDA device.
    *
+   * The copy is ordered on @p stream and may not have finished when this
+   * function returns. Work queued on @p stream afterwards sees the result.
+   *
    * @param[in, out] devPtr CUDA memory pointer that points to a contiguous
    * memory region of at least W*H*sizeof(uint8_t) bytes.
+   * @param[in] stream CUDA stream to issue the copy on, the default stream by
+   * default
    */
-  void readFrameRgbaGPU(uint8_t* devPtr);
+  void readFrameRgbaGPU(uint8_t* devPtr, cudaStream_t stream = nullptr);
 
   /**
    * @brief Reads the depth rendering result directly into CUDA memory.  See
@@ -125,8 +417,9 @@ class RenderTarget {
    *
    * @param[in, out] devPtr CUDA memory pointer that points to a contiguous
    * memory region of at least W*H*sizeof(float) bytes.
+   * @param[in] stream CUDA stream to issue the copy on
    */
-  void readFrameDepthGPU(float* devPtr);
+  void readFrameDepthGPU(float* devPtr, cudaStream_t stream = nullptr);
 
   /**
    * @brief Reads the ObjectID rendering result directly into CUDA memory.  See
@@ -134,12 +427,57 @@ class RenderTarget {
    *
    * @param[in, out] devPtr CUDA memory pointer that points to a contiguous
    * memory region of at least W*H*sizeof(int32_t) bytes.
+   * @param[in] stream CUDA stream to issue the copy on
    */
-  void readFrameObjectIdGPU(int32_t* devPtr);
+  void readFrameObjectIdGPU(int32_t* devPtr, cudaStream_t stream = nullptr);
+
+  /**
+   * @brief Reads any of the rendering results directly into CUDA memory with
+   * a single map and unmap of the interop resources. See @ref
+   * readFrameRgbaGPU()
+   *
+   * Results whose pointer is nullptr are not read.
+   *
+   * @param[in, out] rgbaDevPtr See @ref readFrameRgbaGPU()
+   * @param[in, out] depthDevPtr See @ref readFrameDepthGPU()
+   * @param[in, out] objectIdDevPtr See @ref readFrameObjectIdGPU()
+   * @param[in] stream CUDA stream to issue the copies on
+   */
+  void readFramesGPU(uint8_t* rgbaDevPtr,
+                     float* depthDevPtr,
+                     int32_t* objectIdDevPtr,
+                     cudaStream_t stream = nullptr);
+
+  /**
+   * @brief Number of device buffers per frame type in the pool used by
+   * @ref readFrameToDevice()
+   */
+  static constexpr int DeviceBufferPoolSize = 2;
+
+  /**
+   * @brief Reads a rendering result into a device buffer owned by the target
+   *
+   * Buffers are taken from a double-buffered pool per frame type in turn, so
+   * a consumer can still work on one frame while the next one is being read.
+   * A buffer that is still referenced when its turn comes is left to its
+   * holder and replaced by a new one, so a frame that was handed out is never
+   * overwritten. Like the other GPU reads, the copy is ordered on @p stream.
+   *
+   * @param[in] type    Which rendering result to read
+   * @param[in] stream  CUDA stream to issue the copy on
+   * @return Buffer of shape (H, W, 4) @ref core::DataType::DT_UINT8 for
+   * @ref FrameType::Rgba, (H, W) @ref core::DataType::DT_FLOAT for @ref
+   * FrameType::Depth and (H, W) @ref core::DataType::DT_INT32 for @ref
+   * FrameType::ObjectId
+   */
+  std::shared_ptr<DeviceBuffer> readFrameToDevice(FrameType type,
+                                                  cudaStream_t stream = nullptr);
 #endif
 
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(RenderTarget)
 };
 
+CORRADE_ENUMSET_OPERATORS(RenderTarget::Flags)
+
 }  // namespace gfx
 }  // namespace esp
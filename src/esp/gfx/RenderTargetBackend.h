@@ -0,0 +1,126 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::gfx::RenderTargetBackend
+ */
+
+#include <memory>
+
+#include "esp/gfx/RenderBackend.h"
+#include "esp/gfx/RenderTarget.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Implementation of a @ref RenderTarget on one graphics API
+ *
+ * A @ref RenderTarget keeps its size, depth unprojection, attachments and
+ * multisampling, and forwards everything else to its backend, which owns the
+ * framebuffers and does the draws' setup and the reads. The OpenGL one is in
+ * RenderTarget.cpp. Functions are called with the context of the backend
+ * current and are expected to check their arguments like the corresponding
+ * functions of @ref RenderTarget document.
+ */
+class RenderTargetBackend {
+ public:
+  typedef RenderTarget::FrameType FrameType;
+  typedef RenderTarget::Flag Flag;
+  typedef RenderTarget::Flags Flags;
+  typedef RenderTarget::OutputFormat OutputFormat;
+
+  virtual ~RenderTargetBackend() = default;
+
+  /** @brief Graphics API of the backend */
+  virtual RenderBackend backend() const = 0;
+
+  /** @brief See @ref RenderTarget::renderEnter() */
+  virtual void renderEnter() = 0;
+
+  /** @brief See @ref RenderTarget::bind() */
+  virtual void bind() = 0;
+
+  /** @brief See @ref RenderTarget::renderExit() */
+  virtual void renderExit() = 0;
+
+  /** @brief See @ref RenderTarget::blitRgbaToDefault() */
+  virtual void blitRgbaToDefault() = 0;
+
+  /** @brief See @ref RenderTarget::setViewport() */
+  virtual void setViewport(const Magnum::Range2Di& viewport) = 0;
+
+  /** @brief See @ref RenderTarget::viewport() */
+  virtual Magnum::Range2Di viewport() const = 0;
+
+  /** @brief See @ref RenderTarget::setOutputFormat() */
+  virtual void setOutputFormat(const OutputFormat& format) = 0;
+
+  /** @brief See @ref RenderTarget::outputFormat() */
+  virtual const OutputFormat& outputFormat() const = 0;
+
+  /** @brief See @ref RenderTarget::outputViewport() */
+  virtual Magnum::Range2Di outputViewport() const = 0;
+
+  /**
+   * @brief Rectangle reads of @p type return, its size is
+   *    @ref RenderTarget::outputSize()
+   */
+  virtual Magnum::Range2Di readRange(FrameType type) const = 0;
+
+  /** @brief See @ref RenderTarget::readFrameRgba() */
+  virtual void readFrameRgba(const Magnum::MutableImageView2D& view) = 0;
+
+  /** @brief See @ref RenderTarget::readFrameDepth() */
+  virtual void readFrameDepth(const Magnum::MutableImageView2D& view) = 0;
+
+  /** @brief See @ref RenderTarget::readFrameObjectId() */
+  virtual void readFrameObjectId(const Magnum::MutableImageView2D& view) = 0;
+
+  /**
+   * @brief See
+   *    @ref RenderTarget::queueReadFrame(FrameType, Magnum::PixelFormat)
+   */
+  virtual void queueReadFrame(FrameType type, Magnum::PixelFormat format) = 0;
+
+  /** @brief See @ref RenderTarget::readQueuedFrame() */
+  virtual bool readQueuedFrame(FrameType type,
+                               const Magnum::MutableImageView2D& view,
+                               bool wait) = 0;
+
+  /** @brief See @ref RenderTarget::queuedFrameCount() */
+  virtual int queuedFrameCount(FrameType type) const = 0;
+
+  /** @brief See @ref RenderTarget::readbackBufferCount() */
+  virtual int readbackBufferCount() const = 0;
+
+  /** @brief See @ref RenderTarget::setReadbackBufferCount() */
+  virtual void setReadbackBufferCount(int count) = 0;
+
+  /** @brief See @ref RenderTarget::setDepthNoiseModel() */
+  virtual void setDepthNoiseModel(
+      Corrade::Containers::ArrayView<const float> model,
+      float noiseMultiplier) = 0;
+
+  /** @brief See @ref RenderTarget::hasDepthNoiseModel() */
+  virtual bool hasDepthNoiseModel() const = 0;
+
+#ifdef ESP_BUILD_WITH_CUDA
+  /** @brief See @ref RenderTarget::readFramesGPU() */
+  virtual void readFramesGPU(uint8_t* rgbaDevPtr,
+                             float* depthDevPtr,
+                             int32_t* objectIdDevPtr,
+                             cudaStream_t stream) = 0;
+
+  /** @brief See @ref RenderTarget::readFrameToDevice() */
+  virtual std::shared_ptr<DeviceBuffer> readFrameToDevice(
+      FrameType type,
+      cudaStream_t stream) = 0;
+#endif
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -4,6 +4,11 @@
 
 #include "Renderer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
@@ -16,8 +21,13 @@
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Shaders/Flat.h>
 
+#include "esp/core/Metrics.h"
+#include "esp/core/Profiler.h"
 #include "esp/gfx/DepthUnprojection.h"
+#include "esp/gfx/EquirectangularShader.h"
+#include "esp/gfx/WarpShader.h"
 #include "esp/gfx/magnum.h"
 
 namespace Mn = Magnum;
@@ -26,32 +36,243 @@ namespace esp {
 namespace gfx {
 
 struct Renderer::Impl {
-  Impl() {
+  explicit Impl(RenderBackend backend) : backend_{backend} {
+    CORRADE_ASSERT(isRenderBackendAvailable(backend),
+                   "Renderer: the" << renderBackendName(backend)
+                                   << "backend is not implemented", );
     Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
     Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+#ifndef MAGNUM_TARGET_GLES
+    // panoramas filter across the cube map face edges, always the case on ES
+    Mn::GL::Renderer::enable(
+        Mn::GL::Renderer::Feature::SeamlessCubeMapTexture);
+#endif
   }
   ~Impl() { LOG(INFO) << "Deconstructing Renderer"; }
 
   void draw(RenderCamera& camera,
             scene::SceneGraph& sceneGraph,
-            bool frustumCulling) {
+            bool frustumCulling,
+            const CullingResults* culled = nullptr) {
+    camera.resetDrawStatistics();
+    int index = 0;
     for (auto& it : sceneGraph.getDrawableGroups()) {
-      // TODO: remove || true
-      if (it.second.prepareForDraw(camera) || true) {
+      // RenderCamera::draw() prepares the group (transformation caching,
+      // culling data) itself
+      const CullingResults::Group* group =
+          culled && index < int(culled->groups.size())
+              ? &culled->groups[index]
+              : nullptr;
+      ++index;
+      if (frustumCulling && group && group->group == &it.second &&
+          group->cullingDataVersion == it.second.cullingDataVersion()) {
+        camera.draw(it.second, group->visible);
+      } else {
         camera.draw(it.second, frustumCulling);
       }
     }
   }
 
+  void cullAhead(const std::vector<BatchEntry>& entries) {
+    ESP_PROFILE_SCOPE("Renderer::cullAhead");
+    // the frustums and the culling data are computed on this thread, the
+    // scene graph's camera and the groups aren't thread safe
+    std::vector<CullingResults*> targets;
+    std::vector<Mn::Frustum> frustums;
+    for (const BatchEntry& entry : entries) {
+      // other subtypes draw intermediate views of their own
+      if (entry.sensor->specification()->sensorSubtype != "pinhole") {
+        continue;
+      }
+      scene::SceneGraph& sceneGraph = *entry.sceneGraph;
+      sceneGraph.setDefaultRenderCamera(*entry.sensor);
+      RenderCamera& camera = sceneGraph.getDefaultRenderCamera();
+      CullingResults& culled = entry.sensor->cullingResults();
+      culled.viewProjection = camera.projectionMatrix() * camera.cameraMatrix();
+      frustums.push_back(Mn::Frustum::fromMatrix(culled.viewProjection));
+      culled.groups.resize(sceneGraph.getDrawableGroups().size());
+      int index = 0;
+      for (auto& it : sceneGraph.getDrawableGroups()) {
+        it.second.updateCullingData();
+        CullingResults::Group& group = culled.groups[index++];
+        group.group = &it.second;
+        group.cullingDataVersion = it.second.cullingDataVersion();
+      }
+      culled.pending = true;
+      targets.push_back(&culled);
+    }
+
+    // every sensor culls the shared hierarchies with planes of its own
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < int(targets.size()); ++i) {
+      for (CullingResults::Group& group : targets[i]->groups) {
+        group.visible.clear();
+        group.group->cullingBVH().cull(
+            frustums[i], [&group](int box) { group.visible.push_back(box); },
+            group.planeIndices);
+      }
+    }
+  }
+
   void draw(sensor::VisualSensor& visualSensor,
             scene::SceneGraph& sceneGraph,
             bool frustumCulling) {
+    ESP_PROFILE_SCOPE("Renderer::draw");
     ASSERT(visualSensor.isVisualSensor());
 
     // set the modelview matrix, projection matrix of the render camera;
     sceneGraph.setDefaultRenderCamera(visualSensor);
+    RenderCamera& camera = sceneGraph.getDefaultRenderCamera();
+    // the scene graph's camera draws for every sensor, the visibility of
+    // the previous frame is the sensor's own
+    camera.setOcclusionCuller(
+        occlusionCulling_ ? &visualSensor.occlusionCuller() : nullptr);
+    RenderProfiler::ScopedPass pass{profiler_.get(),
+                                    visualSensor.specification()->uuid,
+                                    RenderProfiler::Pass::Draw};
+
+    // the results of cullAhead() are only good for one draw, of the view
+    // that was culled
+    CullingResults* culled = &visualSensor.cullingResults();
+    const Mn::Matrix4 viewProjection =
+        camera.projectionMatrix() * camera.cameraMatrix();
+    const bool culledAhead =
+        culled->pending && culled->viewProjection == viewProjection;
+    culled->pending = false;
+    if (!culledAhead) {
+      culled = nullptr;
+    }
+
+    if (!visualSensor.drawsDepthOnly()) {
+      draw(camera, sceneGraph, frustumCulling, culled);
+    } else {
+      // no fragment shading and no color bandwidth, drawables that the
+      // trivial shader can't draw still write only depth
+      camera.setDepthOnlyShader(getDepthOnlyShader());
+      Mn::GL::Renderer::setColorMask(false, false, false, false);
+      draw(camera, sceneGraph, frustumCulling, culled);
+      Mn::GL::Renderer::setColorMask(true, true, true, true);
+      camera.setDepthOnlyShader(nullptr);
+    }
+    camera.setOcclusionCuller(nullptr);
+    pass.setDrawStatistics(camera.drawStatistics());
+    recordMetrics(camera.drawStatistics());
+  }
+
+  void drawCubeMap(sensor::VisualSensor& visualSensor,
+                   scene::SceneGraph& sceneGraph,
+                   CubeMapRenderTarget& target,
+                   bool frustumCulling) {
+    ESP_PROFILE_SCOPE("Renderer::drawCubeMap");
+    ASSERT(visualSensor.isVisualSensor());
+
+    sceneGraph.setDefaultRenderCamera(visualSensor);
+    RenderCamera& camera = sceneGraph.getDefaultRenderCamera();
+    camera.resetDrawStatistics();
+    RenderProfiler::ScopedPass pass{profiler_.get(),
+                                    visualSensor.specification()->uuid,
+                                    RenderProfiler::Pass::Draw};
+
+    target.renderEnter();
+    for (auto& it : sceneGraph.getDrawableGroups()) {
+      camera.drawCubeMap(it.second, frustumCulling,
+                         [&](int face) { target.bindFace(face); });
+    }
+    target.renderExit();
+    pass.setDrawStatistics(camera.drawStatistics());
+    recordMetrics(camera.drawStatistics());
+  }
+
+  void drawMultiView(const std::vector<BatchEntry>& entries,
+                     bool frustumCulling) {
+    ESP_PROFILE_SCOPE("Renderer::drawMultiView");
+    if (entries.empty()) {
+      return;
+    }
+    sensor::VisualSensor& first = *entries[0].sensor;
+    scene::SceneGraph& sceneGraph = *entries[0].sceneGraph;
+    sceneGraph.setDefaultRenderCamera(first);
+    RenderCamera& camera = sceneGraph.getDefaultRenderCamera();
+    std::vector<Mn::Matrix4> viewTransformations;
+    for (const BatchEntry& entry : entries) {
+      CORRADE_ASSERT(canDrawMultiView(entries[0], entry),
+                     "Renderer::drawMultiView(): the sensors can't be drawn "
+                     "together", );
+      entry.sensor->setTransformationMatrix(camera);
+      viewTransformations.push_back(camera.node().transformation());
+    }
+    camera.resetDrawStatistics();
+    RenderProfiler::ScopedPass pass{profiler_.get(),
+                                    first.specification()->uuid,
+                                    RenderProfiler::Pass::Draw};
+
+    for (const BatchEntry& entry : entries) {
+      entry.sensor->renderTarget().renderEnter();
+    }
+    const bool depthOnly = first.drawsDepthOnly();
+    if (depthOnly) {
+      camera.setDepthOnlyShader(getDepthOnlyShader());
+      Mn::GL::Renderer::setColorMask(false, false, false, false);
+    }
+    for (auto& it : sceneGraph.getDrawableGroups()) {
+      camera.drawMultiView(it.second, viewTransformations, frustumCulling,
+                           [&](int view) {
+                             entries[view].sensor->renderTarget().bind();
+                           });
+    }
+    if (depthOnly) {
+      Mn::GL::Renderer::setColorMask(true, true, true, true);
+      camera.setDepthOnlyShader(nullptr);
+    }
+    for (const BatchEntry& entry : entries) {
+      entry.sensor->renderTarget().renderExit();
+    }
+    pass.setDrawStatistics(camera.drawStatistics());
+    recordMetrics(camera.drawStatistics());
+  }
+
+  // whether b can be drawn in a multi-view pass with a, see
+  // groupEntriesForMultiView()
+  static bool canDrawMultiView(const BatchEntry& a, const BatchEntry& b) {
+    const sensor::SensorSpec& specA = *a.sensor->specification();
+    const sensor::SensorSpec& specB = *b.sensor->specification();
+    // other subtypes draw intermediate views of their own
+    return a.sceneGraph == b.sceneGraph && specA.sensorSubtype == "pinhole" &&
+           specB.sensorSubtype == "pinhole" &&
+           a.sensor->framebufferSize() == b.sensor->framebufferSize() &&
+           specA.parameters == specB.parameters &&
+           a.sensor->drawsDepthOnly() == b.sensor->drawsDepthOnly() &&
+           a.sensor->hasRenderTarget() && b.sensor->hasRenderTarget() &&
+           !a.sensor->sharesRenderTarget() && !b.sensor->sharesRenderTarget();
+  }
+
+  static void recordMetrics(const RenderCamera::DrawStatistics& statistics) {
+    static core::Metrics::Counter& drawn =
+        core::Metrics::counter("render.drawables_drawn");
+    static core::Metrics::Counter& culled =
+        core::Metrics::counter("render.drawables_culled");
+    static core::Metrics::Counter& passes =
+        core::Metrics::counter("render.passes");
+    drawn.add(statistics.drawables);
+    culled.add(statistics.culled);
+    passes.add();
+  }
+
+  CubeMapRenderTarget::uptr createCubeMapRenderTarget(int size) {
+    CORRADE_ASSERT(size > 0,
+                   "Renderer::createCubeMapRenderTarget(): face size has to "
+                   "be positive",
+                   nullptr);
+    return CubeMapRenderTarget::create_unique(size,
+                                              getEquirectangularShader());
+  }
 
-    draw(sceneGraph.getDefaultRenderCamera(), sceneGraph, frustumCulling);
+  WarpRenderTarget::uptr createWarpRenderTarget(
+      const Mn::Vector2i& size,
+      const Mn::Vector2i& lookupSize,
+      Corrade::Containers::ArrayView<const Mn::Vector2> lookup) {
+    return WarpRenderTarget::create_unique(size, lookupSize, lookup,
+                                           getWarpShader());
   }
 
   void bindRenderTarget(sensor::VisualSensor& sensor) {
@@ -61,20 +282,150 @@ struct Renderer::Impl {
           "Sensor does not have a depthUnprojection matrix");
     }
 
+    const Mn::Vector2i size = sensor.framebufferSize();
+    const RenderTarget::Flags flags = sensor.renderTargetFlags();
+    const int samples = sensor.renderTargetSamples();
+    if (!renderTargetSharing_ || !sensor.canShareRenderTarget()) {
+      sensor.bindRenderTarget(
+          RenderTarget::create_unique(size, *depthUnprojection,
+                                      getDepthShader(), flags, samples,
+                                      backend_));
+      return;
+    }
+
+    RenderTarget::ptr& target = renderTargetPool_[std::make_tuple(
+        size.x(), size.y(), depthUnprojection->x(), depthUnprojection->y(),
+        int(flags), samples)];
+    if (!target) {
+      target = RenderTarget::create(size, *depthUnprojection,
+                                    getDepthShader(), flags, samples,
+                                    backend_);
+    }
+    sensor.bindRenderTarget(target, true);
+  }
+
+  void releaseUnusedRenderTargets() {
+    for (auto it = renderTargetPool_.begin();
+         it != renderTargetPool_.end();) {
+      if (it->second.use_count() == 1) {
+        it = renderTargetPool_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  RenderTarget::uptr createBatchRenderTarget(sensor::VisualSensor& sensor,
+                                             int numTiles) {
+    CORRADE_ASSERT(numTiles > 0,
+                   "Renderer::createBatchRenderTarget(): at least one tile "
+                   "is required",
+                   nullptr);
+    auto depthUnprojection = sensor.depthUnprojection();
+    if (!depthUnprojection) {
+      throw std::runtime_error(
+          "Sensor does not have a depthUnprojection matrix");
+    }
+
+    const int tilesPerRow =
+        static_cast<int>(std::ceil(std::sqrt(static_cast<float>(numTiles))));
+    const int rows = (numTiles + tilesPerRow - 1) / tilesPerRow;
+    const Mn::Vector2i size =
+        sensor.framebufferSize() * Mn::Vector2i{tilesPerRow, rows};
+
+    return RenderTarget::create_unique(size, *depthUnprojection,
+                                       getDepthShader(),
+                                       sensor.renderTargetFlags(),
+                                       sensor.renderTargetSamples(), backend_);
+  }
+
+  void drawBatch(RenderTarget& target,
+                 const std::vector<BatchEntry>& entries,
+                 bool frustumCulling) {
+    ESP_PROFILE_SCOPE("Renderer::drawBatch");
+    if (entries.empty()) {
+      return;
+    }
+    const Mn::Vector2i tileSize = entries[0].sensor->framebufferSize();
+
+    target.renderEnter();
+    for (int i = 0; i < entries.size(); ++i) {
+      const BatchEntry& entry = entries[i];
+      CORRADE_ASSERT(entry.sensor->framebufferSize() == tileSize,
+                     "Renderer::drawBatch(): all sensors in a batch must have "
+                     "the same resolution", );
+      target.setViewport(batchTileViewport(target, tileSize, i));
+      draw(*entry.sensor, *entry.sceneGraph, frustumCulling);
+    }
+    target.renderExit();
+    target.setViewport({{}, target.framebufferSize()});
+  }
+
+  static Mn::Range2Di batchTileViewport(const RenderTarget& target,
+                                        const Mn::Vector2i& tileSize,
+                                        int index) {
+    const Mn::Vector2i grid = target.framebufferSize() / tileSize;
+    CORRADE_ASSERT(index >= 0 && index < grid.product(),
+                   "Renderer::batchTileViewport(): tile index" << index
+                       << "out of range for a grid of" << grid.product()
+                       << "tiles",
+                   {});
+    const Mn::Vector2i origin =
+        tileSize * Mn::Vector2i{index % grid.x(), index / grid.x()};
+    return Mn::Range2Di::fromSize(origin, tileSize);
+  }
+
+  const RenderBackend backend_;
+  bool renderTargetSharing_ = false;
+  bool occlusionCulling_ = false;
+  RenderProfiler::uptr profiler_;
+  // shared render targets by framebuffer size, depth unprojection,
+  // attachments and samples
+  std::map<std::tuple<int, int, float, float, int, int>, RenderTarget::ptr>
+      renderTargetPool_;
+
+ private:
+  DepthShader* getDepthShader() {
     if (!depthShader_) {
       depthShader_ = std::make_unique<DepthShader>(
           DepthShader::Flag::UnprojectExistingDepth);
     }
+    return depthShader_.get();
+  }
 
-    sensor.bindRenderTarget(RenderTarget::create_unique(
-        sensor.framebufferSize(), *depthUnprojection, depthShader_.get()));
+  Mn::Shaders::Flat3D* getDepthOnlyShader() {
+    if (!depthOnlyShader_) {
+      depthOnlyShader_ = std::make_unique<Mn::Shaders::Flat3D>();
+    }
+    return depthOnlyShader_.get();
+  }
+
+  EquirectangularShader* getEquirectangularShader() {
+    if (!equirectangularShader_) {
+      equirectangularShader_ = std::make_unique<EquirectangularShader>();
+    }
+    return equirectangularShader_.get();
+  }
+
+  WarpShader* getWarpShader() {
+    if (!warpShader_) {
+      warpShader_ = std::make_unique<WarpShader>();
+    }
+    return warpShader_.get();
   }
 
- private:
   std::unique_ptr<DepthShader> depthShader_ = nullptr;
+  std::unique_ptr<Mn::Shaders::Flat3D> depthOnlyShader_ = nullptr;
+  std::unique_ptr<EquirectangularShader> equirectangularShader_ = nullptr;
+  std::unique_ptr<WarpShader> warpShader_ = nullptr;
 };
 
-Renderer::Renderer() : pimpl_(spimpl::make_unique_impl<Impl>()) {}
+Renderer::Renderer(RenderBackend backend)
+    : pimpl_(spimpl::make_unique_impl<Impl>(backend)) {}
+
+RenderBackend Renderer::backend() const {
+  return pimpl_->backend_;
+}
 
 void Renderer::draw(RenderCamera& camera,
                     scene::SceneGraph& sceneGraph,
@@ -88,9 +439,158 @@ void Renderer::draw(sensor::VisualSensor& visualSensor,
   pimpl_->draw(visualSensor, sceneGraph, frustumCulling);
 }
 
+void Renderer::drawCubeMap(sensor::VisualSensor& visualSensor,
+                           scene::SceneGraph& sceneGraph,
+                           CubeMapRenderTarget& target,
+                           bool frustumCulling) {
+  pimpl_->drawCubeMap(visualSensor, sceneGraph, target, frustumCulling);
+}
+
+void Renderer::drawMultiView(const std::vector<BatchEntry>& entries,
+                             bool frustumCulling) {
+  pimpl_->drawMultiView(entries, frustumCulling);
+}
+
+void Renderer::cullAhead(const std::vector<BatchEntry>& entries) {
+  pimpl_->cullAhead(entries);
+}
+
+CubeMapRenderTarget::uptr Renderer::createCubeMapRenderTarget(int size) {
+  return pimpl_->createCubeMapRenderTarget(size);
+}
+
+WarpRenderTarget::uptr Renderer::createWarpRenderTarget(
+    const Mn::Vector2i& size,
+    const Mn::Vector2i& lookupSize,
+    Corrade::Containers::ArrayView<const Mn::Vector2> lookup) {
+  return pimpl_->createWarpRenderTarget(size, lookupSize, lookup);
+}
+
 void Renderer::bindRenderTarget(sensor::VisualSensor& sensor) {
   pimpl_->bindRenderTarget(sensor);
 }
 
+bool Renderer::renderTargetSharing() const {
+  return pimpl_->renderTargetSharing_;
+}
+
+void Renderer::setRenderTargetSharing(bool enabled) {
+  pimpl_->renderTargetSharing_ = enabled;
+}
+
+bool Renderer::occlusionCulling() const {
+  return pimpl_->occlusionCulling_;
+}
+
+void Renderer::setOcclusionCulling(bool enabled) {
+  pimpl_->occlusionCulling_ = enabled;
+}
+
+bool Renderer::profiling() const {
+  return pimpl_->profiler_ != nullptr;
+}
+
+void Renderer::setProfiling(bool enabled) {
+  if (!enabled) {
+    pimpl_->profiler_ = nullptr;
+  } else if (!pimpl_->profiler_) {
+    pimpl_->profiler_ = RenderProfiler::create_unique();
+  }
+}
+
+RenderProfiler* Renderer::profiler() {
+  return pimpl_->profiler_.get();
+}
+
+std::size_t Renderer::renderTargetPoolSize() const {
+  return pimpl_->renderTargetPool_.size();
+}
+
+void Renderer::releaseUnusedRenderTargets() {
+  pimpl_->releaseUnusedRenderTargets();
+}
+
+RenderTarget::uptr Renderer::createBatchRenderTarget(
+    sensor::VisualSensor& sensor,
+    int numTiles) {
+  return pimpl_->createBatchRenderTarget(sensor, numTiles);
+}
+
+void Renderer::drawBatch(RenderTarget& target,
+                         const std::vector<BatchEntry>& entries,
+                         bool frustumCulling) {
+  pimpl_->drawBatch(target, entries, frustumCulling);
+}
+
+namespace {
+bool sharesView(const Renderer::BatchEntry& a, const Renderer::BatchEntry& b) {
+  if (a.sceneGraph != b.sceneGraph ||
+      a.sensor->framebufferSize() != b.sensor->framebufferSize() ||
+      a.sensor->node().absoluteTransformationMatrix() !=
+          b.sensor->node().absoluteTransformationMatrix()) {
+    return false;
+  }
+  const sensor::SensorSpec& specA = *a.sensor->specification();
+  const sensor::SensorSpec& specB = *b.sensor->specification();
+  // the targets of the group get read from the first member's, which has
+  // only the attachments and samples it needs itself. Reprojection sensors
+  // decide on their own whether to draw at all
+  return specA.sensorSubtype == specB.sensorSubtype &&
+         specA.sensorSubtype != "reprojection" &&
+         specA.parameters == specB.parameters && !specA.minimalAttachments &&
+         !specB.minimalAttachments && specA.msaaSamples == specB.msaaSamples;
+}
+}  // namespace
+
+std::vector<std::vector<Renderer::BatchEntry>> Renderer::groupEntriesByView(
+    const std::vector<BatchEntry>& entries) {
+  std::vector<std::vector<BatchEntry>> groups;
+  for (const BatchEntry& entry : entries) {
+    const sensor::SensorType type = entry.sensor->specification()->sensorType;
+    auto group = std::find_if(
+        groups.begin(), groups.end(),
+        [&](const std::vector<BatchEntry>& candidate) {
+          return sharesView(candidate.front(), entry) &&
+                 std::none_of(candidate.begin(), candidate.end(),
+                              [&](const BatchEntry& member) {
+                                return member.sensor->specification()
+                                           ->sensorType == type;
+                              });
+        });
+    if (group == groups.end()) {
+      groups.push_back({entry});
+    } else {
+      group->push_back(entry);
+    }
+  }
+  return groups;
+}
+
+std::vector<std::vector<Renderer::BatchEntry>>
+Renderer::groupEntriesForMultiView(const std::vector<BatchEntry>& entries) {
+  std::vector<std::vector<BatchEntry>> groups;
+  for (const BatchEntry& entry : entries) {
+    auto group = std::find_if(
+        groups.begin(), groups.end(),
+        [&](const std::vector<BatchEntry>& candidate) {
+          return candidate.size() <
+                     std::size_t(RenderCamera::MaxViewCount) &&
+                 Impl::canDrawMultiView(candidate.front(), entry);
+        });
+    if (group == groups.end()) {
+      groups.push_back({entry});
+    } else {
+      group->push_back(entry);
+    }
+  }
+  return groups;
+}
+
+Mn::Range2Di Renderer::batchTileViewport(const RenderTarget& target,
+                                         const Mn::Vector2i& tileSize,
+                                         int index) {
+  return Impl::batchTileViewport(target, tileSize, index);
+}
+
 }  // namespace gfx
 }  // namespace esp
@@ -5,7 +5,12 @@
 #pragma once
 
 #include "esp/core/esp.h"
+#include "esp/gfx/CubeMapRenderTarget.h"
+#include "esp/gfx/RenderBackend.h"
 #include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderProfiler.h"
+#include "esp/gfx/RenderTarget.h"
+#include "esp/gfx/WarpRenderTarget.h"
 #include "esp/scene/SceneGraph.h"
 #include "esp/sensor/VisualSensor.h"
 
@@ -14,7 +19,27 @@ namespace gfx {
 
 class Renderer {
  public:
-  Renderer();
+  /**
+   * @brief A single view of a batched draw: a scene graph and the visual
+   * sensor it is rendered from. See @ref drawBatch()
+   */
+  struct BatchEntry {
+    sensor::VisualSensor* sensor;
+    scene::SceneGraph* sceneGraph;
+  };
+
+  /**
+   * @brief Constructor
+   * @param backend Graphics API to render with, has to be
+   *    @ref isRenderBackendAvailable()
+   *
+   * Render targets the renderer creates are implemented on the same
+   * backend, see @ref RenderTargetBackend.
+   */
+  explicit Renderer(RenderBackend backend = RenderBackend::OpenGL);
+
+  /** @brief Graphics API the renderer renders with */
+  RenderBackend backend() const;
 
   // draw the scene graph with the camera specified by user
   void draw(RenderCamera& camera,
@@ -26,11 +51,195 @@ class Renderer {
             scene::SceneGraph& sceneGraph,
             bool frustumCulling = true);
 
+  /**
+   * @brief Draw the scene graph into the faces of a cube map, from the
+   * position of the visual sensor
+   *
+   * The faces look along the axes of the sensor's space, using the
+   * projection the sensor sets, which should be a square 90 degree one. The
+   * static drawables are culled once for all faces, see @ref
+   * RenderCamera::drawCubeMap().
+   */
+  void drawCubeMap(sensor::VisualSensor& visualSensor,
+                   scene::SceneGraph& sceneGraph,
+                   CubeMapRenderTarget& target,
+                   bool frustumCulling = true);
+
+  /**
+   * @brief Draw several sensors seeing the same scene graph from nearby
+   * views in one pass over the drawables, e.g. the eyes of a stereo pair
+   *
+   * The entries have to be able to draw together, see
+   * @ref groupEntriesForMultiView(). Each is drawn into its own
+   * @ref RenderTarget, with the drawables culled against a frustum
+   * enclosing all views and sorted only once, see
+   * @ref RenderCamera::drawMultiView(). Doesn't use occlusion culling. The
+   * draw is profiled as a single pass of the first sensor.
+   */
+  void drawMultiView(const std::vector<BatchEntry>& entries,
+                     bool frustumCulling = true);
+
+  /**
+   * @brief Frustum cull the static drawables for the next draw of each
+   * sensor, with the sensors distributed over threads
+   *
+   * The hierarchies of the scene graphs' drawable groups are culled against
+   * the frustum of every pinhole sensor in parallel, see
+   * @ref RenderCamera::draw(DrawableGroup&, const std::vector<int>&). The
+   * next @ref draw(sensor::VisualSensor&, scene::SceneGraph&, bool) of the
+   * sensor with frustum culling only submits the results, unless the
+   * sensor's view changed in between. The results are kept in
+   * @ref sensor::VisualSensor::cullingResults().
+   */
+  void cullAhead(const std::vector<BatchEntry>& entries);
+
+  /**
+   * @brief Create a @ref CubeMapRenderTarget with faces of @p size pixels
+   */
+  CubeMapRenderTarget::uptr createCubeMapRenderTarget(int size);
+
+  /**
+   * @brief Create a @ref WarpRenderTarget rendering at @p size and warping
+   * through @p lookup into @p lookupSize pixels
+   */
+  WarpRenderTarget::uptr createWarpRenderTarget(
+      const Magnum::Vector2i& size,
+      const Magnum::Vector2i& lookupSize,
+      Corrade::Containers::ArrayView<const Magnum::Vector2> lookup);
+
   /**
    * @brief Binds a @ref RenderTarget to the sensor
+   *
+   * With @ref setRenderTargetSharing() enabled, sensors that
+   * @ref sensor::VisualSensor::canShareRenderTarget() borrow a target from a
+   * pool, otherwise each sensor gets its own.
    */
   void bindRenderTarget(sensor::VisualSensor& sensor);
 
+  /**
+   * @brief Whether sensors of the same framebuffer size and depth
+   * unprojection share a @ref RenderTarget
+   *
+   * Shared targets only hold the results of a sensor until the next one
+   * draws, so every sensor has to be read back before the next is drawn.
+   * Pooled targets outlive the sensors, rebinding after a reconfiguration
+   * reuses them instead of creating new GL objects. Affects only later
+   * @ref bindRenderTarget() calls. Default is @cpp false @ce.
+   */
+  bool renderTargetSharing() const;
+
+  /**
+   * @brief Enable or disable sharing of render targets
+   *
+   * See @ref renderTargetSharing().
+   */
+  void setRenderTargetSharing(bool enabled);
+
+  /**
+   * @brief Number of render targets in the pool, see
+   * @ref setRenderTargetSharing()
+   */
+  std::size_t renderTargetPoolSize() const;
+
+  /**
+   * @brief Drop the pooled render targets no sensor is bound to anymore
+   */
+  void releaseUnusedRenderTargets();
+
+  /**
+   * @brief Whether sensors are drawn with occlusion culling
+   *
+   * Drawables hidden behind what was visible to the sensor in its previous
+   * frame are skipped, see @ref gfx::OcclusionCuller. Pays off in scenes
+   * where walls hide most of the geometry. Default is @cpp false @ce.
+   */
+  bool occlusionCulling() const;
+
+  /**
+   * @brief Enable or disable occlusion culling
+   */
+  void setOcclusionCulling(bool enabled);
+
+  /**
+   * @brief Whether the passes of each sensor are timed, see
+   * @ref RenderProfiler
+   *
+   * Default is @cpp false @ce.
+   */
+  bool profiling() const;
+
+  /**
+   * @brief Enable or disable profiling
+   *
+   * Enabling starts with no records, disabling drops the records not taken.
+   */
+  void setProfiling(bool enabled);
+
+  /**
+   * @brief Profiler recording the passes, @cpp nullptr @ce unless
+   * @ref profiling() is enabled
+   */
+  RenderProfiler* profiler();
+
+  /**
+   * @brief Create a @ref RenderTarget large enough to hold @p numTiles tiles,
+   * each the size of @p sensor's framebuffer
+   *
+   * Tiles are laid out row-major in a roughly square grid, see @ref
+   * batchTileViewport(). Depth is unprojected with @p sensor's parameters, so
+   * every sensor drawn into the target must share its projection.
+   */
+  RenderTarget::uptr createBatchRenderTarget(sensor::VisualSensor& sensor,
+                                             int numTiles);
+
+  /**
+   * @brief Draw several scene graphs, each seen from its own visual sensor,
+   * into the tiles of a single @ref RenderTarget
+   *
+   * Entry @p i is drawn into tile @p i. All sensors must have the same
+   * resolution. The target is cleared once for the whole batch; after the
+   * call its viewport is reset to the full framebuffer. Use @ref
+   * RenderTarget::setViewport() with @ref batchTileViewport() to read back a
+   * single tile.
+   */
+  void drawBatch(RenderTarget& target,
+                 const std::vector<BatchEntry>& entries,
+                 bool frustumCulling = true);
+
+  /**
+   * @brief Partition entries into groups that can be produced by a single
+   * draw
+   *
+   * Entries are grouped when they draw the same scene graph with sensors
+   * of distinct @ref sensor::SensorType that have the same absolute
+   * transformation, resolution and projection. Drawing the first sensor of a
+   * group fills the color, depth and object ID attachments of its @ref
+   * RenderTarget with the results of every sensor in the group. Order of
+   * entries is preserved within and across groups.
+   */
+  static std::vector<std::vector<BatchEntry>> groupEntriesByView(
+      const std::vector<BatchEntry>& entries);
+
+  /**
+   * @brief Partition entries into groups that can be drawn by a single
+   * @ref drawMultiView()
+   *
+   * Entries are grouped when they draw the same scene graph with pinhole
+   * sensors of the same resolution and projection parameters that draw
+   * depth only or not alike, each into a render target of its own. Groups
+   * have at most @ref RenderCamera::MaxViewCount entries. Order of entries
+   * is preserved within and across groups.
+   */
+  static std::vector<std::vector<BatchEntry>> groupEntriesForMultiView(
+      const std::vector<BatchEntry>& entries);
+
+  /**
+   * @brief The viewport of tile @p index in a batch @ref RenderTarget
+   */
+  static Magnum::Range2Di batchTileViewport(const RenderTarget& target,
+                                            const Magnum::Vector2i& tileSize,
+                                            int index);
+
   // draw the scene graph with the default camera in scene graph
   // user needs to set the default camera so that it has correct
   // modelview matrix, projection matrix to render the scene
@@ -0,0 +1,66 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ResolveShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/Version.h>
+
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(ShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+enum { ColorTextureUnit = 0 };
+}
+
+ResolveShader::ResolveShader(Flags flags) : flags_{flags} {
+  if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"default-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL410;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  if (flags & Flag::Grayscale)
+    frag.addSource("#define GRAYSCALE\n");
+
+  vert.addSource(rs.get("resolve.vert"));
+  frag.addSource(rs.get("resolve.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
+
+  supersamplingUniform_ = uniformLocation("supersampling");
+  setUniform(uniformLocation("colorTexture"), ColorTextureUnit);
+  setUniform(supersamplingUniform_, 1);
+}
+
+ResolveShader& ResolveShader::bindColorTexture(Mn::GL::Texture2D& texture) {
+  texture.bind(ColorTextureUnit);
+  return *this;
+}
+
+ResolveShader& ResolveShader::setSupersampling(int factor) {
+  setUniform(supersamplingUniform_, factor);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
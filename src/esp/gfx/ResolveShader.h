@@ -0,0 +1,67 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Corrade/Containers/EnumSet.h>
+
+#include "esp/gfx/CachedShaderProgram.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Color downsampling and conversion shader
+
+Renders a full-screen triangle, each fragment the average of the
+@ref setSupersampling() x @ref setSupersampling() texels it covers in the
+texture bound with @ref bindColorTexture(). Used by @ref RenderTarget to
+process color results before they are read back, see
+@ref RenderTarget::setOutputFormat().
+*/
+class ResolveShader : public CachedShaderProgram {
+ public:
+  /** @brief Flag */
+  enum class Flag {
+    /**
+     * Output the luminance of the color in the red channel instead of the
+     * color itself, for rendering into single-channel buffers
+     */
+    Grayscale = 1 << 0
+  };
+
+  /** @brief Flags */
+  typedef Corrade::Containers::EnumSet<Flag> Flags;
+
+  /** @brief Constructor */
+  explicit ResolveShader(Flags flags = {});
+
+  /**
+   * @brief Bind the full-resolution color texture
+   * @return Reference to self (for method chaining)
+   */
+  ResolveShader& bindColorTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Set how many times larger the color texture is than the output
+   * @return Reference to self (for method chaining)
+   *
+   * Default is @cpp 1 @ce.
+   */
+  ResolveShader& setSupersampling(int factor);
+
+  /**
+   * @brief The flags passed to the Constructor
+   */
+  Flags flags() const { return flags_; }
+
+ private:
+  const Flags flags_;
+  int supersamplingUniform_;
+};
+
+CORRADE_ENUMSET_OPERATORS(ResolveShader::Flags)
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,148 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/PixelFormat.h>
+
+#include "WarpRenderTarget.h"
+#include "magnum.h"
+
+#include "esp/gfx/WarpShader.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+const Mn::GL::Framebuffer::ColorAttachment RgbaBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{0};
+const Mn::GL::Framebuffer::ColorAttachment ObjectIdBuffer =
+    Mn::GL::Framebuffer::ColorAttachment{1};
+}  // namespace
+
+struct WarpRenderTarget::Impl {
+  Impl(const Mn::Vector2i& size,
+       const Mn::Vector2i& lookupSize,
+       Corrade::Containers::ArrayView<const Mn::Vector2> lookup,
+       WarpShader* warpShader)
+      : size_{size},
+        lookupSize_{lookupSize},
+        framebuffer_{{{}, size}},
+        warpShader_{warpShader} {
+    CORRADE_INTERNAL_ASSERT(warpShader_ != nullptr);
+    CORRADE_ASSERT(lookup.size() == std::size_t(lookupSize.product()),
+                   "WarpRenderTarget: expected" << lookupSize.product()
+                       << "lookup entries but got" << lookup.size(), );
+
+    // color is filtered when warped, the other results aren't
+    color_.setMinificationFilter(Mn::GL::SamplerFilter::Linear)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Linear)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::RGBA8, size);
+    objectId_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::R32UI, size);
+    depth_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, size);
+    lookup_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::RG32F, lookupSize)
+        .setSubImage(0, {},
+                     Mn::ImageView2D{Mn::PixelFormat::RG32F, lookupSize,
+                                     lookup});
+
+    framebuffer_.attachTexture(RgbaBuffer, color_, 0)
+        .attachTexture(ObjectIdBuffer, objectId_, 0)
+        .attachTexture(Mn::GL::Framebuffer::BufferAttachment::Depth, depth_,
+                       0)
+        .mapForDraw({{0, RgbaBuffer}, {1, ObjectIdBuffer}});
+    CORRADE_INTERNAL_ASSERT(
+        framebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
+        Mn::GL::Framebuffer::Status::Complete);
+
+    mesh_.setCount(3);
+  }
+
+  Mn::Vector2i framebufferSize() const { return size_; }
+
+  Mn::Vector2i lookupSize() const { return lookupSize_; }
+
+  void renderEnter() {
+    framebuffer_.clearDepth(1.0);
+    framebuffer_.clearColor(0, Mn::Color4{0, 0, 0, 1});
+    framebuffer_.clearColor(1, Mn::Vector4ui{});
+    framebuffer_.bind();
+  }
+
+  void renderExit() {}
+
+  void drawWarp() {
+    // every fragment writes its depth, including the cleared value for the
+    // empty pixels, so it mustn't be tested against the cleared buffer
+    Mn::GL::Renderer::setDepthFunction(
+        Mn::GL::Renderer::DepthFunction::Always);
+    (*warpShader_)
+        .bindLookupTexture(lookup_)
+        .bindColorTexture(color_)
+        .bindObjectIdTexture(objectId_)
+        .bindDepthTexture(depth_)
+        .draw(mesh_);
+    Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Less);
+  }
+
+ private:
+  Mn::Vector2i size_;
+  Mn::Vector2i lookupSize_;
+  Mn::GL::Texture2D color_;
+  Mn::GL::Texture2D objectId_;
+  Mn::GL::Texture2D depth_;
+  Mn::GL::Texture2D lookup_;
+  Mn::GL::Framebuffer framebuffer_;
+  WarpShader* warpShader_;
+  Mn::GL::Mesh mesh_;
+};
+
+WarpRenderTarget::WarpRenderTarget(
+    const Mn::Vector2i& size,
+    const Mn::Vector2i& lookupSize,
+    Corrade::Containers::ArrayView<const Mn::Vector2> lookup,
+    WarpShader* warpShader)
+    : pimpl_(spimpl::make_unique_impl<Impl>(size,
+                                            lookupSize,
+                                            lookup,
+                                            warpShader)) {}
+
+Mn::Vector2i WarpRenderTarget::framebufferSize() const {
+  return pimpl_->framebufferSize();
+}
+
+Mn::Vector2i WarpRenderTarget::lookupSize() const {
+  return pimpl_->lookupSize();
+}
+
+void WarpRenderTarget::renderEnter() {
+  pimpl_->renderEnter();
+}
+
+void WarpRenderTarget::renderExit() {
+  pimpl_->renderExit();
+}
+
+void WarpRenderTarget::drawWarp() {
+  pimpl_->drawWarp();
+}
+
+}  // namespace gfx
+}  // namespace esp
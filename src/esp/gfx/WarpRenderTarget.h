@@ -0,0 +1,77 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+class WarpShader;
+
+/**
+ * Holds an intermediate color, depth and object ID rendering together with a
+ * lookup table, and warps the rendering into other render targets, e.g. to
+ * apply a lens distortion model to a pinhole view.
+ */
+class WarpRenderTarget {
+ public:
+  /**
+   * @brief Constructor
+   * @param size          Size of the intermediate rendering
+   * @param lookupSize    Size of the warped result, in pixels
+   * @param lookup        Normalized coordinates into the intermediate
+   *                      rendering for each warped pixel, row-major with the
+   *                      bottom row first, negative for pixels left empty
+   * @param warpShader    Shader used by @ref drawWarp(), must outlive this
+   *                      instance
+   */
+  WarpRenderTarget(const Magnum::Vector2i& size,
+                   const Magnum::Vector2i& lookupSize,
+                   Corrade::Containers::ArrayView<const Magnum::Vector2> lookup,
+                   WarpShader* warpShader);
+
+  /** @brief Size of the intermediate rendering */
+  Magnum::Vector2i framebufferSize() const;
+
+  /** @brief Size of the warped result */
+  Magnum::Vector2i lookupSize() const;
+
+  /**
+   * @brief Called before any draw calls that target the intermediate
+   * rendering
+   * Clears the framebuffer and binds it
+   */
+  void renderEnter();
+
+  /**
+   * @brief Called after any draw calls that target the intermediate
+   * rendering
+   */
+  void renderExit();
+
+  /**
+   * @brief Warp the intermediate rendering into the currently bound
+   * framebuffer
+   *
+   * The bound viewport has to be @ref lookupSize(). Writes color to the
+   * first and object IDs to the second color output, like the drawables do,
+   * and depth unchanged. See @ref WarpShader.
+   */
+  void drawWarp();
+
+  // @brief Delete copy Constructor
+  WarpRenderTarget(const WarpRenderTarget&) = delete;
+  // @brief Delete copy operator
+  WarpRenderTarget& operator=(const WarpRenderTarget&) = delete;
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(WarpRenderTarget)
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,80 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "WarpShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/Version.h>
+
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(ShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+enum {
+  LookupTextureUnit = 0,
+  ColorTextureUnit = 1,
+  ObjectIdTextureUnit = 2,
+  DepthTextureUnit = 3,
+};
+}
+
+WarpShader::WarpShader() {
+  if (!Corrade::Utility::Resource::hasGroup("default-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"default-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL410;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  // the same full-screen triangle as the resolve pass
+  vert.addSource(rs.get("resolve.vert"));
+  frag.addSource(rs.get("warp.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(compileAndLink({vert, frag}));
+
+  setUniform(uniformLocation("lookupTexture"), LookupTextureUnit);
+  setUniform(uniformLocation("colorTexture"), ColorTextureUnit);
+  setUniform(uniformLocation("objectIdTexture"), ObjectIdTextureUnit);
+  setUniform(uniformLocation("depthTexture"), DepthTextureUnit);
+}
+
+WarpShader& WarpShader::bindLookupTexture(Mn::GL::Texture2D& texture) {
+  texture.bind(LookupTextureUnit);
+  return *this;
+}
+
+WarpShader& WarpShader::bindColorTexture(Mn::GL::Texture2D& texture) {
+  texture.bind(ColorTextureUnit);
+  return *this;
+}
+
+WarpShader& WarpShader::bindObjectIdTexture(Mn::GL::Texture2D& texture) {
+  texture.bind(ObjectIdTextureUnit);
+  return *this;
+}
+
+WarpShader& WarpShader::bindDepthTexture(Mn::GL::Texture2D& texture) {
+  texture.bind(DepthTextureUnit);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
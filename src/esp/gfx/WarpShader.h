@@ -0,0 +1,58 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Magnum/GL/GL.h>
+
+#include "esp/gfx/CachedShaderProgram.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Lookup-table image warping shader
+
+Renders a full-screen triangle, each fragment sampling the textures bound
+with @ref bindColorTexture(), @ref bindObjectIdTexture() and
+@ref bindDepthTexture() at the coordinates stored for it in the
+@ref bindLookupTexture() texture. Negative coordinates produce the cleared
+values. Color goes to output @cpp 0 @ce, the object ID to output @cpp 1 @ce
+and depth is written unchanged. Used by @ref WarpRenderTarget.
+*/
+class WarpShader : public CachedShaderProgram {
+ public:
+  /** @brief Constructor */
+  explicit WarpShader();
+
+  /**
+   * @brief Bind the lookup texture
+   * @return Reference to self (for method chaining)
+   *
+   * Expected to be @ref Magnum::GL::TextureFormat::RG32F, one texel per
+   * fragment, holding the normalized source texture coordinates.
+   */
+  WarpShader& bindLookupTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Bind the source color texture
+   * @return Reference to self (for method chaining)
+   */
+  WarpShader& bindColorTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Bind the source object ID texture
+   * @return Reference to self (for method chaining)
+   */
+  WarpShader& bindObjectIdTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Bind the source depth texture
+   * @return Reference to self (for method chaining)
+   */
+  WarpShader& bindDepthTexture(Magnum::GL::Texture2D& texture);
+};
+
+}  // namespace gfx
+}  // namespace esp
@@ -26,8 +26,23 @@
 #include <Magnum/Platform/WindowlessWglApplication.h>
 #endif
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Context.h>
 #include <Magnum/Platform/GLContext.h>
 
+#include "esp/assets/GpuAssetRegistry.h"
+
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+namespace Cr = Corrade;
 namespace Mn = Magnum;
 
 // Based on code from:
@@ -41,6 +56,17 @@ namespace gfx {
 
 namespace {
 
+// vertex array objects can't be shared, Magnum binds the attributes of a
+// mesh on every draw without them
+const char* SharedContextArgs[]{"", "--magnum-disable-extensions",
+                                "GL_ARB_vertex_array_object"};
+
+int contextArgCount(bool shared) {
+  return shared ? int(Cr::Containers::arraySize(SharedContextArgs)) : 1;
+}
+
+struct ShareGroup {};
+
 struct ESPContext {
   virtual void makeCurrent() = 0;
   virtual bool isValid() = 0;
@@ -70,10 +96,67 @@ bool isNvidiaGpuReadable(int device) {
   return true;
 }
 
+std::vector<int> availableEGLDevices() {
+  CHECK(gladLoadEGL()) << "Failed to load EGL";
+  EGLDeviceEXT eglDevices[MAX_DEVICES];
+  EGLint numDevices = 0;
+  eglQueryDevicesEXT(MAX_DEVICES, eglDevices, &numDevices);
+  CHECK_EGL_ERROR();
+
+  // same selection as the ESPEGLContext constructor
+  std::vector<int> devices;
+  for (int eglDevId = 0; eglDevId < numDevices; ++eglDevId) {
+    EGLAttrib cudaDevNumber;
+    if (eglQueryDeviceAttribEXT(eglDevices[eglDevId], EGL_CUDA_DEVICE_NV,
+                                &cudaDevNumber) == EGL_FALSE ||
+        !isNvidiaGpuReadable(eglDevId)) {
+      continue;
+    }
+    devices.push_back(cudaDevNumber);
+  }
+  return devices;
+}
+
+// through EGL_EXT_device_drm, which not every driver has
+core::DeviceLocality eglDeviceLocality(int device) {
+  CHECK(gladLoadEGL()) << "Failed to load EGL";
+  EGLDeviceEXT eglDevices[MAX_DEVICES];
+  EGLint numDevices = 0;
+  eglQueryDevicesEXT(MAX_DEVICES, eglDevices, &numDevices);
+  CHECK_EGL_ERROR();
+
+  for (int eglDevId = 0; eglDevId < numDevices; ++eglDevId) {
+    EGLAttrib cudaDevNumber;
+    if (eglQueryDeviceAttribEXT(eglDevices[eglDevId], EGL_CUDA_DEVICE_NV,
+                                &cudaDevNumber) == EGL_FALSE ||
+        cudaDevNumber != device) {
+      continue;
+    }
+    const char* drmFile =
+        eglQueryDeviceStringEXT(eglDevices[eglDevId], EGL_DRM_DEVICE_FILE_EXT);
+    // clear the error of an unsupported query
+    eglGetError();
+    if (drmFile) {
+      return core::drmDeviceLocality(drmFile);
+    }
+    break;
+  }
+  return {};
+}
+
+// eglTerminate() invalidates every context of the display, which is the same
+// for all contexts on a device
+std::mutex eglDisplayMutex;
+std::map<EGLDisplay, int> eglDisplayReferences;
+
 struct ESPEGLContext : ESPContext {
-  explicit ESPEGLContext(int device)
-      : magnumGlContext_{Mn::NoCreate}, gpuDevice_{device} {
+  ESPEGLContext(int device, bool shared, ESPEGLContext* shareWith)
+      : magnumGlContext_{Mn::NoCreate, contextArgCount(shared),
+                         SharedContextArgs},
+        gpuDevice_{device} {
     CHECK(gladLoadEGL()) << "Failed to load EGL";
+    CHECK(!shareWith || shareWith->gpuDevice_ == device)
+        << "[EGL] Shared contexts have to be on the same device";
 
     static const EGLint configAttribs[] = {EGL_SURFACE_TYPE,
                                            EGL_PBUFFER_BIT,
@@ -131,6 +214,10 @@ struct ESPEGLContext : ESPContext {
       LOG(ERROR) << "[EGL] Failed to initialize.";
     }
     CHECK_EGL_ERROR();
+    {
+      std::lock_guard<std::mutex> lock{eglDisplayMutex};
+      ++eglDisplayReferences[display_];
+    }
 
     LOG(INFO) << "[EGL] Version: " << eglQueryString(display_, EGL_VERSION);
     LOG(INFO) << "[EGL] Vendor: " << eglQueryString(display_, EGL_VENDOR);
@@ -153,7 +240,9 @@ struct ESPEGLContext : ESPContext {
     CHECK_EGL_ERROR();
 
     // 4. Create a context
-    context_ = eglCreateContext(display_, eglConfig, EGL_NO_CONTEXT, NULL);
+    context_ = eglCreateContext(
+        display_, eglConfig, shareWith ? shareWith->context_ : EGL_NO_CONTEXT,
+        NULL);
     CHECK_EGL_ERROR();
 
     // 5. Make context current and create Magnum context
@@ -171,6 +260,9 @@ struct ESPEGLContext : ESPContext {
       LOG(ERROR) << "[EGL] Failed to make EGL context current";
     }
     CHECK_EGL_ERROR();
+    if (isValid_) {
+      Mn::GL::Context::makeCurrent(&magnumGlContext_);
+    }
   };
 
   bool isValid() { return isValid_; };
@@ -179,7 +271,11 @@ struct ESPEGLContext : ESPContext {
 
   ~ESPEGLContext() {
     eglDestroyContext(display_, context_);
-    eglTerminate(display_);
+    std::lock_guard<std::mutex> lock{eglDisplayMutex};
+    if (--eglDisplayReferences[display_] == 0) {
+      eglDisplayReferences.erase(display_);
+      eglTerminate(display_);
+    }
   }
 
  private:
@@ -195,9 +291,12 @@ struct ESPEGLContext : ESPContext {
 #else  // ESP_BUILD_EGL_SUPPORT not defined
 
 struct ESPGLXContext : ESPContext {
-  ESPGLXContext()
-      : glxCtx_{Mn::Platform::WindowlessGlxContext::Configuration()},
-        magnumGlContext_{Mn::NoCreate} {
+  ESPGLXContext(bool shared, ESPGLXContext* shareWith)
+      : glxCtx_{Mn::Platform::WindowlessGlxContext::Configuration{}
+                    .setSharedContext(
+                        shareWith ? shareWith->glxCtx_.glContext() : nullptr)},
+        magnumGlContext_{Mn::NoCreate, contextArgCount(shared),
+                         SharedContextArgs} {
     CHECK(glxCtx_.isCreated())
         << "[GLX] Failed to created headless glX context";
 
@@ -208,7 +307,12 @@ struct ESPGLXContext : ESPContext {
     isValid_ = true;
   };
 
-  void makeCurrent() { glxCtx_.makeCurrent(); };
+  void makeCurrent() {
+    glxCtx_.makeCurrent();
+    if (isValid_) {
+      Mn::GL::Context::makeCurrent(&magnumGlContext_);
+    }
+  };
   bool isValid() { return isValid_; };
   int gpuDevice() const { return 0; }
 
@@ -225,9 +329,13 @@ struct ESPGLXContext : ESPContext {
 };  // namespace
 
 struct WindowlessContext::Impl {
-  explicit Impl(int device) {
+  Impl(int device, bool shared, Impl* shareWith) : shared_{shared} {
 #ifdef ESP_BUILD_EGL_SUPPORT
-    glContext_ = ESPEGLContext::create_unique(device);
+    glContext_ = ESPEGLContext::create_unique(
+        device, shared,
+        shareWith ? static_cast<ESPEGLContext*>(
+                        shareWith->glContext_.get())
+                  : nullptr);
 #else
     CHECK_EQ(device, 0)
         << "glX context does not support multiple GPUs. Please compile with "
@@ -236,45 +344,97 @@ struct WindowlessContext::Impl {
         << "DISPLAY not detected. For headless systems, compile with "
            "--headless for EGL support";
 
-    glContext_ = ESPGLXContext::create_unique();
+    glContext_ = ESPGLXContext::create_unique(
+        shared, shareWith ? static_cast<ESPGLXContext*>(
+                                shareWith->glContext_.get())
+                          : nullptr);
 #endif
 
     makeCurrent();
+    if (shared_) {
+      shareGroup_ = shareWith ? shareWith->shareGroup_
+                              : std::make_shared<ShareGroup>();
+      magnumContext_ = &Mn::GL::Context::current();
+      assets::GpuAssetRegistry::instance().setShareGroup(*magnumContext_,
+                                                         shareGroup_.get());
+    }
   }
 
-  ~Impl() { LOG(INFO) << "Deconstructing GL context"; }
+  ~Impl() {
+    LOG(INFO) << "Deconstructing GL context";
+    if (magnumContext_) {
+      assets::GpuAssetRegistry::instance().removeShareGroup(*magnumContext_);
+    }
+  }
 
   void makeCurrent() { glContext_->makeCurrent(); }
 
   int gpuDevice() const { return glContext_->gpuDevice(); }
 
+  bool isShared() const { return shared_; }
+
   ESPContext::uptr glContext_ = nullptr;
+  bool shared_;
+  // identifies the group while any of its contexts is alive
+  std::shared_ptr<ShareGroup> shareGroup_;
+  Mn::GL::Context* magnumContext_ = nullptr;
 };
 
 #else  // not defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_APPLE)
 
 struct WindowlessContext::Impl {
-  explicit Impl(int) : glContext_({}), magnumGlContext_(Mn::NoCreate) {
+  Impl(int, bool shared, Impl*)
+      : glContext_({}), magnumGlContext_(Mn::NoCreate) {
+    CHECK(!shared) << "Shared contexts are only supported with EGL and GLX";
     glContext_.makeCurrent();
-    if (!magnumGlContext_.tryCreate()) {
+    isValid_ = magnumGlContext_.tryCreate();
+    if (!isValid_) {
       LOG(ERROR) << "Failed to create GL context";
     }
   }
 
   ~Impl() { LOG(INFO) << "Deconstructing GL context"; }
 
-  void makeCurrent() { glContext_.makeCurrent(); }
+  void makeCurrent() {
+    glContext_.makeCurrent();
+    if (isValid_) {
+      Mn::GL::Context::makeCurrent(&magnumGlContext_);
+    }
+  }
 
   int gpuDevice() const { return 0; }
 
+  bool isShared() const { return false; }
+
   Mn::Platform::WindowlessGLContext glContext_;
   Mn::Platform::GLContext magnumGlContext_;
+  bool isValid_ = false;
 };
 
 #endif
 
-WindowlessContext::WindowlessContext(int device /* = 0 */)
-    : pimpl_(spimpl::make_unique_impl<Impl>(device)) {}
+namespace {
+std::atomic<int> liveContextCount{0};
+}  // namespace
+
+WindowlessContext::WindowlessContext(
+    int device /* = 0 */,
+    bool shared /* = false */,
+    WindowlessContext* shareWith /* = nullptr */)
+    : pimpl_(spimpl::make_unique_impl<Impl>(
+          device,
+          shared,
+          shareWith ? shareWith->pimpl_.get() : nullptr)) {
+  CORRADE_ASSERT(!shareWith || (shared && shareWith->isShared()),
+                 "WindowlessContext: shareWith has to be a shared context and "
+                 "the new one shared as well", );
+  ++liveContextCount;
+}
+
+WindowlessContext::~WindowlessContext() {
+  LOG(INFO) << "Deconstructing WindowlessContext";
+  --liveContextCount;
+}
 
 void WindowlessContext::makeCurrent() {
   pimpl_->makeCurrent();
@@ -284,5 +444,39 @@ int WindowlessContext::gpuDevice() const {
   return pimpl_->gpuDevice();
 }
 
+bool WindowlessContext::isShared() const {
+  return pimpl_->isShared();
+}
+
+std::vector<int> WindowlessContext::availableDevices() {
+#if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_APPLE) && \
+    defined(ESP_BUILD_EGL_SUPPORT)
+  return availableEGLDevices();
+#else
+  return {0};
+#endif
+}
+
+core::DeviceLocality WindowlessContext::deviceLocality(int gpuDevice) {
+  core::DeviceLocality locality;
+#if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_APPLE) && \
+    defined(ESP_BUILD_EGL_SUPPORT)
+  locality = eglDeviceLocality(gpuDevice);
+#endif
+#ifdef ESP_BUILD_WITH_CUDA
+  char busId[32];
+  if (locality.cpus.empty() &&
+      cudaDeviceGetPCIBusId(busId, sizeof(busId), gpuDevice) == cudaSuccess) {
+    locality = core::pciDeviceLocality(busId);
+  }
+#endif
+  static_cast<void>(gpuDevice);
+  return locality;
+}
+
+int WindowlessContext::liveCount() {
+  return liveContextCount;
+}
+
 }  // namespace gfx
 }  // namespace esp
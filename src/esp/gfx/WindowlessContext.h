@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <vector>
+
+#include "esp/core/Topology.h"
 #include "esp/core/esp.h"
 
 namespace esp {
@@ -11,14 +14,71 @@ namespace gfx {
 
 class WindowlessContext {
  public:
-  explicit WindowlessContext(int gpuDevice = 0);
+  /**
+   * @brief Constructor
+   * @param gpuDevice   CUDA ID of the device to create the context on
+   * @param shared      Create the context in a share group, see
+   *    @ref isShared()
+   * @param shareWith   Shared context whose group to join, @cpp nullptr @ce
+   *    to start a new group. Has to be on @p gpuDevice.
+   *
+   * The context is current in the calling thread afterwards.
+   */
+  explicit WindowlessContext(int gpuDevice = 0,
+                             bool shared = false,
+                             WindowlessContext* shareWith = nullptr);
 
-  ~WindowlessContext() { LOG(INFO) << "Deconstructing WindowlessContext"; }
+  ~WindowlessContext();
 
+  /**
+   * @brief Make the context current in the calling thread
+   *
+   * Also makes its Magnum context current, so a thread can switch between
+   * several contexts. A context can be current in only one thread at a time.
+   */
   void makeCurrent();
 
   int gpuDevice() const;
 
+  /**
+   * @brief Whether the context is in a share group
+   *
+   * Buffers, textures and shader programs created on any context of the
+   * group can be used on all of them, so each thread can submit commands to
+   * its own context while the meshes and textures are uploaded once, see
+   * @ref esp::assets::GpuAssetRegistry. Vertex array objects can't be
+   * shared, so shared contexts bind the vertex attributes on every draw
+   * instead. Only supported with EGL and GLX.
+   */
+  bool isShared() const;
+
+  /**
+   * @brief CUDA IDs of the devices a context can be created on
+   *
+   * With EGL, the NVIDIA devices the process can read, otherwise only the
+   * default device 0.
+   */
+  static std::vector<int> availableDevices();
+
+  /**
+   * @brief CPUs and NUMA node the device of CUDA ID @p gpuDevice is
+   *    attached to
+   *
+   * Found through the DRM device file of its EGL device, or through its PCI
+   * bus ID when built with CUDA. Empty if unknown, which is always the case
+   * without EGL or CUDA. Doesn't create a context, so threads can be pinned
+   * next to the device before the driver starts its own.
+   */
+  static core::DeviceLocality deviceLocality(int gpuDevice);
+
+  /**
+   * @brief Number of contexts currently alive in this process
+   *
+   * A process must not fork while it has any, as the children would inherit
+   * driver state that isn't safe to use from two processes.
+   */
+  static int liveCount();
+
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(WindowlessContext)
 };
 
@@ -2,6 +2,8 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
@@ -37,11 +39,13 @@ struct DepthUnprojectionTest : Mn::GL::OpenGLTester {
   explicit DepthUnprojectionTest();
 
   void testCpu();
+  void testCpuLarge();
   void testGpuDirect();
   void testGpuUnprojectExisting();
 
   void benchmarkBaseline();
   void benchmarkCpu();
+  void benchmarkCpuTwoPass();
   void benchmarkGpuDirect();
   void benchmarkGpuUnprojectExisting();
 };
@@ -125,6 +129,23 @@ unprojectDepthNoBranch(const Mn::Vector2& unprojection,
   }
 }
 
+/* The previous implementation, relying on the compiler to vectorize */
+#ifdef FMV_SUPPORTED
+__attribute__((target_clones("default", "sse4.2", "avx2")))
+#endif
+CORRADE_NEVER_INLINE void
+unprojectDepthTwoPass(const Mn::Vector2& unprojection,
+                      Cr::Containers::ArrayView<Mn::Float> depth) {
+  for (float& d : depth) {
+    d = unprojection[1] / (d + unprojection[0]);
+  }
+  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
+  for (float& d : depth) {
+    if (d == farDepth)
+      d = 0.0f;
+  }
+}
+
 const struct {
   const char* name;
   void (*unprojectorFull)(const Mn::Matrix4&, Cr::Containers::ArrayView<float>);
@@ -143,12 +164,16 @@ DepthUnprojectionTest::DepthUnprojectionTest() {
        &DepthUnprojectionTest::testGpuUnprojectExisting},
       Cr::Containers::arraySize(TestData));
 
+  addTests({&DepthUnprojectionTest::testCpuLarge});
+
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkBaseline}, 50,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkCpu}, 50,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
+  addBenchmarks({&DepthUnprojectionTest::benchmarkCpuTwoPass}, 50);
+
   addBenchmarks({&DepthUnprojectionTest::benchmarkGpuDirect}, 50,
                 BenchmarkType::GpuTime);
 
@@ -174,6 +199,26 @@ void DepthUnprojectionTest::testCpu() {
                        Cr::TestSuite::Compare::around(data.depth * 0.0002f));
 }
 
+void DepthUnprojectionTest::testCpuLarge() {
+  const Mn::Vector2 unprojection = calculateDepthUnprojection(
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.01f, 100.0f));
+
+  /* Several threaded blocks and a size that isn't a multiple of the vector
+     width, with the far plane scattered over the vector lanes */
+  Cr::Containers::Array<float> depth{Cr::Containers::NoInit, 100003};
+  for (std::size_t i = 0; i != depth.size(); ++i)
+    depth[i] = i % 7 == 0 ? 1.0f : float(i % 10000) / float(10000);
+  Cr::Containers::Array<float> expected{Cr::Containers::NoInit, depth.size()};
+  std::copy(depth.begin(), depth.end(), expected.begin());
+
+  unprojectDepth(unprojection, depth);
+  unprojectDepthTwoPass(unprojection, expected);
+  for (std::size_t i = 0; i != depth.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(depth[i], expected[i]);
+  }
+}
+
 void DepthUnprojectionTest::testGpuDirect() {
   auto&& data = TestData[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -306,6 +351,21 @@ void DepthUnprojectionTest::benchmarkCpu() {
                      Cr::TestSuite::Compare::Greater);
 }
 
+void DepthUnprojectionTest::benchmarkCpuTwoPass() {
+  Mn::Vector2 unprojection = calculateDepthUnprojection(
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.001f, 100.0f));
+
+  Cr::Containers::Array<float> depth{Cr::Containers::NoInit,
+                                     std::size_t(BenchmarkSize.product())};
+  for (std::size_t i = 0; i != depth.size(); ++i)
+    depth[i] = float(i % 10000) / float(10000);
+
+  CORRADE_BENCHMARK(1) { unprojectDepthTwoPass(unprojection, depth); }
+
+  CORRADE_COMPARE_AS(Mn::Math::max<float>(depth), 9.0f,
+                     Cr::TestSuite::Compare::Greater);
+}
+
 void DepthUnprojectionTest::benchmarkGpuDirect() {
   Mn::GL::Texture2D output{};
   output.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
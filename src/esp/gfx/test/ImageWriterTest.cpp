@@ -0,0 +1,119 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "esp/gfx/ImageWriter.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+namespace test {
+namespace {
+
+struct ImageWriterTest : Cr::TestSuite::Tester {
+  explicit ImageWriterTest();
+
+  void observation();
+  void unsupportedObservation();
+  void backPressure();
+};
+
+ImageWriterTest::ImageWriterTest() {
+  addTests({&ImageWriterTest::observation,
+            &ImageWriterTest::unsupportedObservation,
+            &ImageWriterTest::backPressure});
+}
+
+void ImageWriterTest::observation() {
+  const std::string filename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "habitat_sim_image_writer.png");
+  // a red row on top of a blue one, in both row orders
+  auto rgba = core::Buffer::create(std::vector<size_t>{2, 1, 4},
+                                   core::DataType::DT_UINT8);
+  const uint8_t pixels[]{255, 0, 0, 255, 0, 0, 255, 255};
+  std::copy(std::begin(pixels), std::end(pixels), rgba->data.begin());
+  const std::string flippedFilename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "habitat_sim_image_writer_flipped.png");
+  const uint8_t flippedPixels[]{0, 0, 255, 255, 255, 0, 0, 255};
+  auto flipped = core::Buffer::create(std::vector<size_t>{2, 1, 4},
+                                      core::DataType::DT_UINT8);
+  std::copy(std::begin(flippedPixels), std::end(flippedPixels),
+            flipped->data.begin());
+  {
+    ImageWriter writer{2};
+    CORRADE_VERIFY(writer.write(filename, *rgba, true));
+    CORRADE_VERIFY(writer.write(flippedFilename, *flipped));
+    writer.flush();
+    CORRADE_COMPARE(writer.pendingImages(), 0);
+    CORRADE_COMPARE(writer.writtenImages(), 2);
+    CORRADE_COMPARE(writer.failedImages(), 0);
+  }
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("AnyImageImporter");
+  CORRADE_VERIFY(importer);
+  for (const std::string& written : {filename, flippedFilename}) {
+    CORRADE_ITERATION(written);
+    CORRADE_VERIFY(importer->openFile(written));
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+        importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Mn::Vector2i{1, 2}));
+    CORRADE_COMPARE(image->format(), Mn::PixelFormat::RGBA8Unorm);
+    // Magnum images start at the bottom
+    const auto imported = image->pixels<Mn::Color4ub>();
+    CORRADE_COMPARE(imported[0][0], (Mn::Color4ub{0, 0, 255, 255}));
+    CORRADE_COMPARE(imported[1][0], (Mn::Color4ub{255, 0, 0, 255}));
+  }
+}
+
+void ImageWriterTest::unsupportedObservation() {
+  ImageWriter writer;
+  auto semantic = core::Buffer::create(std::vector<size_t>{2, 2},
+                                       core::DataType::DT_UINT32);
+  CORRADE_VERIFY(!writer.write("semantic.png", *semantic));
+  CORRADE_COMPARE(writer.pendingImages(), 0);
+}
+
+void ImageWriterTest::backPressure() {
+  // a single slot, writes wait for the worker instead of queueing more
+  ImageWriter writer{1, 1};
+  auto depth =
+      core::Buffer::create(std::vector<size_t>{8, 8}, core::DataType::DT_FLOAT);
+  depth->clear();
+  for (int i = 0; i != 8; ++i) {
+    CORRADE_VERIFY(writer.write(
+        Cr::Utility::Directory::join(
+            Cr::Utility::Directory::tmp(),
+            "habitat_sim_image_writer_" + std::to_string(i) + ".hdr"),
+        *depth));
+    CORRADE_VERIFY(writer.pendingImages() <= 2);
+  }
+  writer.flush();
+  CORRADE_COMPARE(writer.writtenImages(), 8);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace gfx
+}  // namespace esp
+
+CORRADE_TEST_MAIN(esp::gfx::test::ImageWriterTest)
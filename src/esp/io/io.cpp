@@ -3,9 +3,23 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "io.h"
+#include <cstdlib>
 #include <fstream>
 #include <set>
 
+#include <Corrade/Utility/Directory.h>
+
+#ifdef _WIN32
+#include <process.h>
+#include <sstream>
+#include <thread>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Cr = Corrade;
+
 namespace esp {
 namespace io {
 
@@ -84,6 +98,72 @@ std::string removeExtension(const std::string& filename) {
   return changeExtension(filename, "");
 }
 
+#ifndef _WIN32
+namespace {
+
+// permissions of a new file. The umask can only be read by setting it, so
+// it's read once.
+mode_t newFileMode() {
+  static const mode_t mode = [] {
+    const mode_t mask = umask(0);
+    umask(mask);
+    return 0666 & ~mask;
+  }();
+  return mode;
+}
+
+}  // namespace
+#endif
+
+bool writeFileAtomically(const std::string& filename,
+                         const std::function<bool(std::FILE*)>& write) {
+  const std::string directory = Cr::Utility::Directory::path(filename);
+  if (!directory.empty() && !Cr::Utility::Directory::mkpath(directory)) {
+    return false;
+  }
+
+#ifdef _WIN32
+  // no mkstemp() there, unique per process and thread is enough
+  std::ostringstream tmp;
+  tmp << filename << ".tmp." << _getpid() << "." << std::this_thread::get_id();
+  const std::string tmpFilename = tmp.str();
+  std::FILE* fp = std::fopen(tmpFilename.c_str(), "wb");
+#else
+  std::string tmpFilename = filename + ".XXXXXX";
+  const int fd = mkstemp(&tmpFilename[0]);
+  std::FILE* fp = nullptr;
+  if (fd != -1) {
+    // mkstemp() makes the file readable only by its owner, give it the
+    // permissions of the file it replaces or of a new one instead
+    struct stat status;
+    fchmod(fd, stat(filename.c_str(), &status) == 0 ? status.st_mode & 0777
+                                                     : newFileMode());
+    fp = fdopen(fd, "wb");
+    if (!fp) {
+      close(fd);
+      std::remove(tmpFilename.c_str());
+    }
+  }
+#endif
+  if (!fp) {
+    return false;
+  }
+
+  bool written = write(fp) && !std::ferror(fp);
+  written = std::fclose(fp) == 0 && written;
+#ifdef _WIN32
+  // rename() doesn't replace existing files there
+  if (written) {
+    std::remove(filename.c_str());
+  }
+#endif
+  if (!written || std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+  return true;
+}
+
 /* The following implementation requires the support of C++17
 
 // #include <filesystem>
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstdio>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -18,6 +20,23 @@ std::string removeExtension(const std::string& file);
 
 std::string changeExtension(const std::string& file, const std::string& ext);
 
+/**
+ * @brief Write a file through a temporary one moved over it once complete
+ * @param filename File to write, its directory is created if needed
+ * @param write    Writes the contents to the temporary file, returns false
+ *    to leave @p filename alone
+ * @return Whether @p filename was replaced
+ *
+ * The temporary file gets a name of its own next to @p filename, so
+ * processes writing the same file at the same time don't clobber each
+ * other and readers see either the previous file or a complete new one,
+ * never a partial one. Processes with the previous file mapped keep reading
+ * it. The file keeps the permissions of the one it replaces, a new file gets
+ * the default ones under the process umask.
+ */
+bool writeFileAtomically(const std::string& filename,
+                         const std::function<bool(std::FILE*)>& write);
+
 /** @brief Tokenize input string by any delimiter char in delimiterCharList.
  *
  * @param delimiterCharList string containing all delimiter chars
@@ -1,14 +1,50 @@
 #include "esp/nav/GreedyFollower.h"
 
-#include <Magnum/EigenIntegration/GeometryIntegration.h>
-#include <Magnum/EigenIntegration/Integration.h>
-
 #include "Sophus/sophus/so3.hpp"
+#include "esp/core/MathInterop.h"
 #include "esp/geo/geo.h"
 
 namespace esp {
 
-using Magnum::EigenIntegration::cast;
+void nav::GreedyGeodesicFollowerImpl::checkNavMeshVersion() {
+  if (navMeshVersion_ != pathfinder_->navMeshVersion()) {
+    navMeshVersion_ = pathfinder_->navMeshVersion();
+    lastPathValid_ = false;
+    lastForwardValid_ = false;
+  }
+}
+
+const nav::ShortestPath& nav::GreedyGeodesicFollowerImpl::planFrom(
+    const vec3f& start,
+    const vec3f& end) {
+  checkNavMeshVersion();
+  if (!lastPathValid_ || lastPath_.requestedStart != start ||
+      lastPath_.requestedEnd != end) {
+    lastPath_.requestedStart = start;
+    lastPath_.requestedEnd = end;
+    pathfinder_->findPath(lastPath_);
+    lastPathValid_ = true;
+  }
+  return lastPath_;
+}
+
+vec3f nav::GreedyGeodesicFollowerImpl::simulateForward(const State& state) {
+  checkNavMeshVersion();
+  if (lastForwardValid_ &&
+      std::get<0>(lastForwardStart_) == std::get<0>(state) &&
+      std::get<1>(lastForwardStart_).coeffs() == std::get<1>(state).coeffs())
+    return lastForwardEnd_;
+
+  dummyNode_.setTranslation(core::asMagnum(std::get<0>(state)));
+  dummyNode_.setRotation(core::asMagnum(std::get<1>(state)));
+  moveForward_(&dummyNode_);
+
+  lastForwardStart_ = state;
+  lastForwardEnd_ =
+      core::asEigen(dummyNode_.absoluteTransformation().translation());
+  lastForwardValid_ = true;
+  return lastForwardEnd_;
+}
 
 // There are some cases were we can't perfectly align along the shortest path
 // and the agent will get stuck, so we need to check that forward will actually
@@ -16,35 +52,29 @@ using Magnum::EigenIntegration::cast;
 // directions + forward will make progress, if neither do, return an error
 nav::GreedyGeodesicFollowerImpl::CODES
 nav::GreedyGeodesicFollowerImpl::checkForward(const State& state) {
-  dummyNode_.setTranslation(Magnum::Vector3{std::get<0>(state)});
-  dummyNode_.setRotation(Magnum::Quaternion{std::get<1>(state)});
-
-  moveForward_(&dummyNode_);
-  float dist_travelled = (Magnum::Vector3{std::get<0>(state)} -
-                          dummyNode_.absoluteTransformation().translation())
-                             .length();
+  float dist_travelled = (std::get<0>(state) - simulateForward(state)).norm();
 
   const float minTravel = 1e-1 * forwardAmount_;
 
   if (dist_travelled < minTravel) {
-    dummyNode_.setTranslation(Magnum::Vector3{std::get<0>(state)});
-    dummyNode_.setRotation(Magnum::Quaternion{std::get<1>(state)});
+    dummyNode_.setTranslation(core::asMagnum(std::get<0>(state)));
+    dummyNode_.setRotation(core::asMagnum(std::get<1>(state)));
 
     turnLeft_(&dummyNode_);
     moveForward_(&dummyNode_);
-    dist_travelled = (Magnum::Vector3{std::get<0>(state)} -
+    dist_travelled = (core::asMagnum(std::get<0>(state)) -
                       dummyNode_.absoluteTransformation().translation())
                          .length();
     if (dist_travelled > minTravel) {
       return CODES::LEFT;
     }
 
-    dummyNode_.setTranslation(Magnum::Vector3{std::get<0>(state)});
-    dummyNode_.setRotation(Magnum::Quaternion{std::get<1>(state)});
+    dummyNode_.setTranslation(core::asMagnum(std::get<0>(state)));
+    dummyNode_.setRotation(core::asMagnum(std::get<1>(state)));
 
     turnRight_(&dummyNode_);
     moveForward_(&dummyNode_);
-    dist_travelled = (Magnum::Vector3{std::get<0>(state)} -
+    dist_travelled = (core::asMagnum(std::get<0>(state)) -
                       dummyNode_.absoluteTransformation().translation())
                          .length();
     if (dist_travelled > minTravel) {
@@ -90,24 +120,23 @@ nav::GreedyGeodesicFollowerImpl::calcStepAlong(
   if (alpha <= turnAmount_ + 1e-3)
     return CODES::FORWARD;
 
-  dummyNode_.setTranslation(Magnum::Vector3{std::get<0>(state)});
-  dummyNode_.setRotation(Magnum::Quaternion{std::get<1>(state)});
-  moveForward_(&dummyNode_);
-  const float newGeoDist = this->geoDist(
-      cast<vec3f>(dummyNode_.absoluteTransformation().translation()),
-      path.requestedEnd);
+  // Both distances come from the distance field of the goal, so they are
+  // consistent with each other and don't need a path search
+  const float geoDist = this->geoDist(std::get<0>(state), path.requestedEnd);
+  const float newGeoDist =
+      this->geoDist(simulateForward(state), path.requestedEnd);
   // There are some edge cases where the gradient doesn't line up with what
   // makes progress the fastest, so we will always try forward.  This also helps
   // reduce the amount of jittering in the path for small turn angles
-  if ((path.geodesicDistance - newGeoDist) > 0.95 * forwardAmount_) {
+  if ((geoDist - newGeoDist) > 0.95 * forwardAmount_) {
     return CODES::FORWARD;
   }
 
-  dummyNode_.setTranslation(Magnum::Vector3{std::get<0>(state)});
-  dummyNode_.setRotation(Magnum::Quaternion{std::get<1>(state)});
+  dummyNode_.setTranslation(core::asMagnum(std::get<0>(state)));
+  dummyNode_.setRotation(core::asMagnum(std::get<1>(state)));
   turnLeft_(&dummyNode_);
 
-  if (gradDir.angularDistance(cast<quatf>(dummyNode_.rotation())) < alpha)
+  if (gradDir.angularDistance(core::asEigen(dummyNode_.rotation())) < alpha)
     return CODES::LEFT;
   else
     return CODES::RIGHT;
@@ -117,10 +146,7 @@ nav::GreedyGeodesicFollowerImpl::CODES
 nav::GreedyGeodesicFollowerImpl::nextActionAlong(
     const std::tuple<vec3f, quatf>& start,
     const vec3f& end) {
-  nav::ShortestPath path;
-  path.requestedStart = std::get<0>(start);
-  path.requestedEnd = end;
-  pathfinder_->findPath(path);
+  const nav::ShortestPath& path = planFrom(std::get<0>(start), end);
 
   CODES action = calcStepAlong(start, path);
   if (action == CODES::FORWARD)
@@ -137,28 +163,26 @@ nav::GreedyGeodesicFollowerImpl::findPath(
   std::vector<CODES> actions;
 
   std::tuple<vec3f, quatf> state = startState;
-  nav::ShortestPath path;
-  path.requestedStart = std::get<0>(state);
-  path.requestedEnd = end;
-  pathfinder_->findPath(path);
+  planFrom(std::get<0>(state), end);
 
   do {
+    const nav::ShortestPath& path = lastPath_;
     CODES nextAction = calcStepAlong(state, path);
     if (nextAction == CODES::FORWARD)
       nextAction = checkForward(state);
 
     actions.push_back(nextAction);
 
-    dummyNode_.setTranslation(Magnum::Vector3{std::get<0>(state)});
-    dummyNode_.setRotation(Magnum::Quaternion{std::get<1>(state)});
+    dummyNode_.setTranslation(core::asMagnum(std::get<0>(state)));
+    dummyNode_.setRotation(core::asMagnum(std::get<1>(state)));
 
     switch (nextAction) {
       case CODES::FORWARD:
         moveForward_(&dummyNode_);
 
-        path.requestedStart =
-            cast<vec3f>(dummyNode_.absoluteTransformation().translation());
-        pathfinder_->findPath(path);
+        planFrom(
+            core::asEigen(dummyNode_.absoluteTransformation().translation()),
+            end);
         break;
 
       case CODES::LEFT:
@@ -173,9 +197,9 @@ nav::GreedyGeodesicFollowerImpl::findPath(
         break;
     }
 
-    state = std::make_tuple(
-        cast<vec3f>(dummyNode_.absoluteTransformation().translation()),
-        cast<quatf>(dummyNode_.rotation()));
+    std::get<0>(state) =
+        core::asEigen(dummyNode_.absoluteTransformation().translation());
+    std::get<1>(state) = core::asEigen(dummyNode_.rotation());
 
   } while ((actions.back() != CODES::STOP && actions.back() != CODES::ERROR) &&
            actions.size() < maxActions);
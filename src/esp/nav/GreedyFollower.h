@@ -102,14 +102,35 @@ class GreedyGeodesicFollowerImpl {
   scene::SceneGraph dummyScene_;
   scene::SceneNode dummyNode_{dummyScene_.getRootNode()};
 
+  // Distance field to the current goal, so candidate moves are evaluated with
+  // a lookup instead of a path search each
+  GeodesicDistanceField goalField_;
+
+  // Last planned path, reused as long as the agent only turns in place
+  ShortestPath lastPath_;
+  bool lastPathValid_ = false;
+
+  // Last forward move simulated on dummyNode_ and where it ended up
+  State lastForwardStart_;
+  vec3f lastForwardEnd_;
+  bool lastForwardValid_ = false;
+
+  // navmesh the two above were computed on, see PathFinder::navMeshVersion()
+  uint64_t navMeshVersion_ = 0;
+
+  // drops the cached path and move if the navmesh changed
+  void checkNavMeshVersion();
+
   CODES calcStepAlong(const State& start, const ShortestPath& path);
 
-  inline float geoDist(const vec3f& start, const vec3f& end) {
-    ShortestPath path;
-    path.requestedStart = start;
-    path.requestedEnd = end;
-    pathfinder_->findPath(path);
-    return path.geodesicDistance;
+  const ShortestPath& planFrom(const vec3f& start, const vec3f& end);
+
+  vec3f simulateForward(const State& state);
+
+  inline float geoDist(const vec3f& pt, const vec3f& end) {
+    if (goalField_.getGoals().size() != 1 || goalField_.getGoals()[0] != end)
+      goalField_.setGoals({end});
+    return pathfinder_->geodesicDistance(goalField_, pt);
   }
 
   CODES checkForward(const State& state);
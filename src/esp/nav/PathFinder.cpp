@@ -3,7 +3,15 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PathFinder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <map>
+#include <memory>
 #include <numeric>
+#include <queue>
 #include <stack>
 #include <unordered_map>
 
@@ -14,15 +22,38 @@
 #include <Magnum/EigenIntegration/Integration.h>
 
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/configure.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <cstdio>
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <limits>
 
+#ifdef CORRADE_TARGET_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "esp/assets/MeshData.h"
+#include "esp/core/Metrics.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/configure.h"
 #include "esp/core/esp.h"
+#include "esp/core/random.h"
+#include "esp/io/io.h"
 
+#ifdef ESP_BUILD_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include "DetourCommon.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshBuilder.h"
 #include "DetourNavMeshQuery.h"
@@ -61,6 +92,131 @@ const std::vector<vec3f>& MultiGoalShortestPath::getRequestedEnds() const {
   return pimpl_->requestedEnds;
 }
 
+bool operator==(const NavMeshSettings& a, const NavMeshSettings& b) {
+  return a.cellSize == b.cellSize && a.cellHeight == b.cellHeight &&
+         a.agentHeight == b.agentHeight && a.agentRadius == b.agentRadius &&
+         a.agentMaxClimb == b.agentMaxClimb &&
+         a.agentMaxSlope == b.agentMaxSlope &&
+         a.regionMinSize == b.regionMinSize &&
+         a.regionMergeSize == b.regionMergeSize &&
+         a.edgeMaxLen == b.edgeMaxLen && a.edgeMaxError == b.edgeMaxError &&
+         a.vertsPerPoly == b.vertsPerPoly &&
+         a.detailSampleDist == b.detailSampleDist &&
+         a.detailSampleMaxError == b.detailSampleMaxError &&
+         a.filterLowHangingObstacles == b.filterLowHangingObstacles &&
+         a.filterLedgeSpans == b.filterLedgeSpans &&
+         a.filterWalkableLowHeightSpans == b.filterWalkableLowHeightSpans &&
+         a.tileSize == b.tileSize;
+}
+
+bool operator!=(const NavMeshSettings& a, const NavMeshSettings& b) {
+  return !(a == b);
+}
+
+namespace impl {
+
+// Polygons are convex, so every pair of vertices of a polygon is connected by
+// a straight line on the navmesh. Shortest paths along these lines are an
+// upper bound of the geodesic distance, exact when the shortest path only
+// bends at polygon vertices. Built once per navmesh and shared by all
+// distance fields and distance matrices.
+struct VertexGraph {
+  // vertices merged by position, with the straight lines to the others
+  std::vector<vec3f> vertices;
+  std::vector<std::vector<std::pair<uint32_t, float>>> edges;
+
+  // range in polyVertices for each walkable polygon
+  struct PolyRange {
+    uint32_t first;
+    uint32_t count;
+  };
+  std::unordered_map<dtPolyRef, PolyRange> polys;
+  std::vector<uint32_t> polyVertices;
+
+  // Dijkstra from points in their polygons, fills distances with the
+  // distance of every vertex to the closest of them. Sources not on a
+  // polygon of the graph are ignored.
+  void sweep(const std::vector<std::pair<dtPolyRef, vec3f>>& sources,
+             std::vector<float>& distances) const {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    distances.assign(vertices.size(), inf);
+    using Entry = std::pair<float, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (const auto& source : sources) {
+      auto found = polys.find(source.first);
+      if (found == polys.end())
+        continue;
+      for (uint32_t i = 0; i < found->second.count; ++i) {
+        const uint32_t id = polyVertices[found->second.first + i];
+        const float dist = (vertices[id] - source.second).norm();
+        if (dist < distances[id]) {
+          distances[id] = dist;
+          queue.emplace(dist, id);
+        }
+      }
+    }
+
+    while (!queue.empty()) {
+      const Entry top = queue.top();
+      queue.pop();
+      if (top.first > distances[top.second])
+        continue;
+
+      for (const auto& edge : edges[top.second]) {
+        const float dist = top.first + edge.second;
+        if (dist < distances[edge.first]) {
+          distances[edge.first] = dist;
+          queue.emplace(dist, edge.first);
+        }
+      }
+    }
+  }
+
+  // distance of pt in the polygon ref to the sources of a sweep() through
+  // the vertices of the polygon, inf if it's not in the graph
+  float distance(const std::vector<float>& distances,
+                 dtPolyRef ref,
+                 const vec3f& pt) const {
+    float dist = std::numeric_limits<float>::infinity();
+    auto found = polys.find(ref);
+    if (found == polys.end())
+      return dist;
+    for (uint32_t i = 0; i < found->second.count; ++i) {
+      const uint32_t id = polyVertices[found->second.first + i];
+      dist = std::min(dist, (vertices[id] - pt).norm() + distances[id]);
+    }
+    return dist;
+  }
+};
+
+}  // namespace impl
+
+struct GeodesicDistanceField::Impl {
+  std::vector<vec3f> goals;
+
+  // PathFinder::navMeshVersion() the field was built for, 0 if not built yet
+  uint64_t navMeshVersion = 0;
+
+  // distance of the vertices of the graph to the closest goal
+  std::shared_ptr<const impl::VertexGraph> graph;
+  std::vector<float> vertexDistances;
+
+  // goals lying inside a polygon, reached in a straight line from there
+  std::unordered_multimap<dtPolyRef, vec3f> polyGoals;
+};
+
+GeodesicDistanceField::GeodesicDistanceField()
+    : pimpl_{spimpl::make_unique_impl<Impl>()} {};
+
+void GeodesicDistanceField::setGoals(const std::vector<vec3f>& newGoals) {
+  *pimpl_ = Impl{};
+  pimpl_->goals = newGoals;
+}
+
+const std::vector<vec3f>& GeodesicDistanceField::getGoals() const {
+  return pimpl_->goals;
+}
+
 namespace {
 template <typename T>
 std::tuple<dtStatus, dtPolyRef, vec3f> projectToPoly(
@@ -92,15 +248,33 @@ namespace impl {
 // are connected This gives O(1) lookup for if a path between two polygons
 // exists or not
 // Takes O(npolys) to construct
+//
+// Island IDs are stored in a flat array indexed by the tile and polygon index
+// decoded from a dtPolyRef, so lookups don't need any hashing. Polygons are
+// additionally kept sorted by the radius of their island, which makes the
+// walkable polygons of all islands above some radius a prefix of that list.
+constexpr uint32_t NO_ISLAND = ~uint32_t{};
+
 class IslandSystem {
  public:
-  IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter) {
+  IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter)
+      : navMesh_{navMesh} {
+    // Offsets of each tile in the flat per-polygon arrays
+    tileFirstPoly_.resize(navMesh->getMaxTiles() + 1, 0);
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      tileFirstPoly_[iTile + 1] =
+          tileFirstPoly_[iTile] +
+          (tile && tile->header ? tile->header->polyCount : 0);
+    }
+    polyToIsland_.assign(tileFirstPoly_.back(), NO_ISLAND);
+
     std::vector<vec3f> islandVerts;
 
     // Iterate over all tiles
     for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
       const dtMeshTile* tile = navMesh->getTile(iTile);
-      if (!tile)
+      if (!tile || !tile->header)
         continue;
 
       // Iterate over all polygons in a tile
@@ -111,7 +285,7 @@ class IslandSystem {
         // If the polygon ref is valid, and we haven't seen it yet,
         // start connected component analysis from this polygon
         if (navMesh->isValidPolyRef(startRef) &&
-            (polyToIsland_.find(startRef) == polyToIsland_.end())) {
+            islandId(startRef) == NO_ISLAND) {
           uint32_t newIslandId = islandRadius_.size();
           expandFrom(navMesh, filter, newIslandId, startRef, islandVerts);
 
@@ -132,40 +306,138 @@ class IslandSystem {
         }
       }
     }
+
+    buildSamplingOrder(filter);
+  }
+
+  inline uint32_t islandId(dtPolyRef ref) const {
+    unsigned int salt, iTile, iPoly;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    if (iTile + 1 >= tileFirstPoly_.size())
+      return NO_ISLAND;
+    const uint32_t index = tileFirstPoly_[iTile] + iPoly;
+    if (index >= tileFirstPoly_[iTile + 1] ||
+        navMesh_->getTile(iTile)->salt != salt)
+      return NO_ISLAND;
+    return polyToIsland_[index];
   }
 
   inline bool hasConnection(dtPolyRef startRef, dtPolyRef endRef) const {
     // If both polygons are on the same island, there must be a path between
     // them
-    auto itStart = polyToIsland_.find(startRef);
-    if (itStart == polyToIsland_.end())
-      return false;
-
-    auto itEnd = polyToIsland_.find(endRef);
-    if (itEnd == polyToIsland_.end())
-      return false;
-
-    return itStart->second == itEnd->second;
+    const uint32_t startIsland = islandId(startRef);
+    return startIsland != NO_ISLAND && startIsland == islandId(endRef);
   }
 
   inline float islandRadius(dtPolyRef ref) const {
-    auto itRef = polyToIsland_.find(ref);
-    if (itRef == polyToIsland_.end())
+    const uint32_t island = islandId(ref);
+    if (island == NO_ISLAND)
       return 0.0;
 
-    return islandRadius_[itRef->second];
+    return islandRadius_[island];
+  }
+
+  /**
+   * Pick a polygon on any island with at least @p minRadius, with probability
+   * proportional to its area. @p u is uniform in [0, 1). Returns 0 if there's
+   * no such island.
+   */
+  dtPolyRef samplePoly(float minRadius, float u) const {
+    const size_t end = sampleCount(minRadius);
+    if (end == 0 || sampleCumulativeArea_[end - 1] <= 0.0f)
+      return 0;
+
+    const float target = u * sampleCumulativeArea_[end - 1];
+    const size_t i = std::min<size_t>(
+        std::upper_bound(sampleCumulativeArea_.begin(),
+                         sampleCumulativeArea_.begin() + end, target) -
+            sampleCumulativeArea_.begin(),
+        end - 1);
+    return sampleRefs_[i];
+  }
+
+  /**
+   * Number of walkable polygons on islands with at least @p minRadius, they
+   * come first in the sampling order
+   */
+  size_t sampleCount(float minRadius) const {
+    // sampleRadius_ is sorted in descending order
+    return std::upper_bound(sampleRadius_.begin(), sampleRadius_.end(),
+                            minRadius, std::greater<float>{}) -
+           sampleRadius_.begin();
+  }
+
+  /** @p i-th polygon in the sampling order */
+  dtPolyRef sampleRef(size_t i) const { return sampleRefs_[i]; }
+
+  /** xz area of the @p i-th polygon in the sampling order */
+  float sampleArea(size_t i) const {
+    return sampleCumulativeArea_[i] - (i ? sampleCumulativeArea_[i - 1] : 0.0f);
   }
 
  private:
-  std::unordered_map<dtPolyRef, uint32_t> polyToIsland_;
+  const dtNavMesh* navMesh_;
+  std::vector<uint32_t> tileFirstPoly_;
+  std::vector<uint32_t> polyToIsland_;
   std::vector<float> islandRadius_;
 
+  // walkable polygons by descending island radius, with the cumulative xz
+  // area, as Detour weights random points
+  std::vector<dtPolyRef> sampleRefs_;
+  std::vector<float> sampleRadius_;
+  std::vector<float> sampleCumulativeArea_;
+
+  void buildSamplingOrder(const dtQueryFilter* filter) {
+    struct Sample {
+      dtPolyRef ref;
+      float radius;
+      float area;
+    };
+    std::vector<Sample> samples;
+    for (int iTile = 0; iTile < navMesh_->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh_->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+
+      for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+        const dtPoly* poly = &tile->polys[jPoly];
+        const dtPolyRef ref = navMesh_->encodePolyId(iTile, tile->salt, jPoly);
+        const uint32_t island = islandId(ref);
+        if (island == NO_ISLAND ||
+            poly->getType() != DT_POLYTYPE_GROUND ||
+            !filter->passFilter(ref, tile, poly))
+          continue;
+
+        float area = 0.0f;
+        const float* va = &tile->verts[poly->verts[0] * 3];
+        for (int iVert = 2; iVert < poly->vertCount; ++iVert) {
+          const float* vb = &tile->verts[poly->verts[iVert - 1] * 3];
+          const float* vc = &tile->verts[poly->verts[iVert] * 3];
+          area += dtTriArea2D(va, vb, vc);
+        }
+        samples.push_back({ref, islandRadius_[island], std::max(area, 0.0f)});
+      }
+    }
+
+    std::stable_sort(samples.begin(), samples.end(),
+                     [](const Sample& a, const Sample& b) {
+                       return a.radius > b.radius;
+                     });
+    float cumulativeArea = 0.0f;
+    for (const Sample& sample : samples) {
+      cumulativeArea += sample.area;
+      sampleRefs_.push_back(sample.ref);
+      sampleRadius_.push_back(sample.radius);
+      sampleCumulativeArea_.push_back(cumulativeArea);
+    }
+  }
+
   void expandFrom(const dtNavMesh* navMesh,
                   const dtQueryFilter* filter,
                   const uint32_t newIslandId,
                   const dtPolyRef& startRef,
                   std::vector<vec3f>& islandVerts) {
-    polyToIsland_.emplace(startRef, newIslandId);
+    setIslandId(startRef, newIslandId);
     islandVerts.clear();
 
     // Force std::stack to be implemented via an std::vector as linked
@@ -192,7 +464,7 @@ class IslandSystem {
            iLink = tile->links[iLink].next) {
         dtPolyRef neighbourRef = tile->links[iLink].ref;
         // If we've already visited this poly, skip it!
-        if (polyToIsland_.find(neighbourRef) != polyToIsland_.end())
+        if (islandId(neighbourRef) != NO_ISLAND)
           continue;
 
         const dtMeshTile* neighbourTile = 0;
@@ -204,11 +476,702 @@ class IslandSystem {
         if (!filter->passFilter(neighbourRef, neighbourTile, neighbourPoly))
           continue;
 
-        polyToIsland_.emplace(neighbourRef, newIslandId);
+        setIslandId(neighbourRef, newIslandId);
         stack.push(neighbourRef);
       }
     }
   }
+
+  void setIslandId(dtPolyRef ref, uint32_t island) {
+    unsigned int salt, iTile, iPoly;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    polyToIsland_[tileFirstPoly_[iTile] + iPoly] = island;
+  }
+};
+
+// Tile grid of a navmesh built in tiles, see PathFinder::Impl::buildTiled()
+struct TileLayout {
+  // layouts of variants sharing the voxelization pass the largest border of
+  // them as minBorderSize, so their tiles cover the same cells
+  TileLayout(const NavMeshSettings& bs,
+             const rcConfig& globalCfg,
+             int minBorderSize = 0)
+      : settings{bs}, globalCfg{globalCfg}, tileCfg{globalCfg} {
+    const int tileSize = bs.tileSize;
+    tileCountX = (globalCfg.width + tileSize - 1) / tileSize;
+    tileCountY = (globalCfg.height + tileSize - 1) / tileSize;
+
+    // The config of each tile extends past the tile by a border, so that
+    // neighbouring tiles agree on the shared edges
+    tileCfg.tileSize = tileSize;
+    tileCfg.borderSize = std::max(tileCfg.walkableRadius + 3, minBorderSize);
+    tileCfg.width = tileSize + tileCfg.borderSize * 2;
+    tileCfg.height = tileSize + tileCfg.borderSize * 2;
+    tileWorldSize = tileSize * tileCfg.cs;
+    borderWorldSize = tileCfg.borderSize * tileCfg.cs;
+  }
+
+  int tileCount() const { return tileCountX * tileCountY; }
+
+  // Range of tiles whose cells or border overlap [min, max] along X or Z
+  std::pair<int, int> tileRange(float min, float max, int axis) const {
+    const int count = axis == 0 ? tileCountX : tileCountY;
+    const float orig = globalCfg.bmin[axis];
+    const int first = std::max(
+        0, int(std::floor((min - orig - borderWorldSize) / tileWorldSize)));
+    const int last = std::min(
+        count - 1,
+        int(std::floor((max - orig + borderWorldSize) / tileWorldSize)));
+    return std::make_pair(first, last);
+  }
+
+  // Config of tile @p x, @p y including its border
+  rcConfig configForTile(int x, int y) const {
+    rcConfig cfg = tileCfg;
+    cfg.bmin[0] = globalCfg.bmin[0] + x * tileWorldSize - borderWorldSize;
+    cfg.bmin[2] = globalCfg.bmin[2] + y * tileWorldSize - borderWorldSize;
+    cfg.bmax[0] = globalCfg.bmin[0] + (x + 1) * tileWorldSize + borderWorldSize;
+    cfg.bmax[2] = globalCfg.bmin[2] + (y + 1) * tileWorldSize + borderWorldSize;
+    return cfg;
+  }
+
+  NavMeshSettings settings;
+  rcConfig globalCfg;
+  rcConfig tileCfg;
+  int tileCountX;
+  int tileCountY;
+  float tileWorldSize;
+  float borderWorldSize;
+};
+
+// Distances to the closest obstacle sampled on a regular grid of nodes over
+// the xz plane of the navmesh bounds. Floors above each other pass through the
+// same node, so each node keeps one sample per navmesh layer at its position.
+struct ObstacleDistanceField {
+  // Detour results at a node, plain floats so the samples can be written out
+  // as they are
+  struct Sample {
+    float height;
+    float distance;
+    float hitPos[3];
+    float hitNormal[3];
+  };
+
+  // Samples further away vertically than this don't belong to the layer of
+  // a point, same as the vertical extent projectToPoly() searches in
+  static constexpr float MAX_HEIGHT_DELTA = 4.0f;
+
+  float cellSize;
+  float maxSearchRadius;
+  float originX;
+  float originZ;
+  int sizeX;
+  int sizeZ;
+  // samples of node x + z * sizeX are in [nodeFirstSample[node],
+  // nodeFirstSample[node + 1])
+  std::vector<uint32_t> nodeFirstSample;
+  std::vector<Sample> samples;
+
+  // Sample of the node closest to @p height, nullptr if there's none
+  const Sample* sampleAt(int x, int z, float height) const {
+    if (x < 0 || z < 0 || x >= sizeX || z >= sizeZ)
+      return nullptr;
+    const int node = x + z * sizeX;
+    const Sample* closest = nullptr;
+    float closestDelta = MAX_HEIGHT_DELTA;
+    for (uint32_t i = nodeFirstSample[node]; i != nodeFirstSample[node + 1];
+         ++i) {
+      const float delta = std::abs(samples[i].height - height);
+      if (delta <= closestDelta) {
+        closest = &samples[i];
+        closestDelta = delta;
+      }
+    }
+    return closest;
+  }
+
+  // Bilinear interpolation of the distance between the four nodes around
+  // @p pt, the hit position and normal are the ones of the closest node.
+  // NullOpt if the field can't answer the query.
+  Cr::Containers::Optional<HitRecord> lookup(const vec3f& pt,
+                                             float radius) const {
+    if (radius > maxSearchRadius)
+      return Cr::Containers::NullOpt;
+
+    const float fx = (pt[0] - originX) / cellSize;
+    const float fz = (pt[2] - originZ) / cellSize;
+    const int x0 = int(std::floor(fx));
+    const int z0 = int(std::floor(fz));
+    const float tx = fx - x0;
+    const float tz = fz - z0;
+
+    float distance = 0.0f;
+    float weightSum = 0.0f;
+    float closestWeight = 0.0f;
+    const Sample* closest = nullptr;
+    for (int dz = 0; dz != 2; ++dz) {
+      for (int dx = 0; dx != 2; ++dx) {
+        const Sample* sample = sampleAt(x0 + dx, z0 + dz, pt[1]);
+        if (!sample)
+          continue;
+        // nodes off the navmesh are left out and the rest reweighted
+        const float weight = (dx ? tx : 1.0f - tx) * (dz ? tz : 1.0f - tz);
+        distance += weight * sample->distance;
+        weightSum += weight;
+        if (!closest || weight > closestWeight) {
+          closest = sample;
+          closestWeight = weight;
+        }
+      }
+    }
+    if (weightSum <= 0.0f)
+      return Cr::Containers::NullOpt;
+
+    return HitRecord{vec3f{Eigen::Map<const vec3f>(closest->hitPos)},
+                     vec3f{Eigen::Map<const vec3f>(closest->hitNormal)},
+                     std::min(distance / weightSum, radius)};
+  }
+
+  struct FileHeader {
+    int magic;
+    int version;
+    float cellSize;
+    float maxSearchRadius;
+    float originX;
+    float originZ;
+    int sizeX;
+    int sizeZ;
+    uint32_t sampleCount;
+  };
+  static constexpr int FILE_MAGIC = 'O' << 24 | 'D' << 16 | 'F' << 8 | 'L';
+  static constexpr int FILE_VERSION = 1;
+
+  void write(FILE* fp) const {
+    FileHeader header;
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.cellSize = cellSize;
+    header.maxSearchRadius = maxSearchRadius;
+    header.originX = originX;
+    header.originZ = originZ;
+    header.sizeX = sizeX;
+    header.sizeZ = sizeZ;
+    header.sampleCount = samples.size();
+    fwrite(&header, sizeof(FileHeader), 1, fp);
+    fwrite(nodeFirstSample.data(), sizeof(uint32_t), nodeFirstSample.size(),
+           fp);
+    fwrite(samples.data(), sizeof(Sample), samples.size(), fp);
+  }
+
+  // NullOpt if @p fp doesn't continue with a field
+  static Cr::Containers::Optional<ObstacleDistanceField> read(FILE* fp) {
+    FileHeader header;
+    if (fread(&header, sizeof(FileHeader), 1, fp) != 1 ||
+        header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+        header.sizeX <= 0 || header.sizeZ <= 0)
+      return Cr::Containers::NullOpt;
+
+    ObstacleDistanceField field;
+    field.cellSize = header.cellSize;
+    field.maxSearchRadius = header.maxSearchRadius;
+    field.originX = header.originX;
+    field.originZ = header.originZ;
+    field.sizeX = header.sizeX;
+    field.sizeZ = header.sizeZ;
+    field.nodeFirstSample.resize(std::size_t(header.sizeX) * header.sizeZ + 1);
+    field.samples.resize(header.sampleCount);
+    if (fread(field.nodeFirstSample.data(), sizeof(uint32_t),
+              field.nodeFirstSample.size(),
+              fp) != field.nodeFirstSample.size() ||
+        fread(field.samples.data(), sizeof(Sample), field.samples.size(),
+              fp) != field.samples.size() ||
+        field.nodeFirstSample.back() != header.sampleCount)
+      return Cr::Containers::NullOpt;
+    return field;
+  }
+};
+
+// Private, copy-on-write mapping of a whole file. Detour writes links and
+// flags into the tile data in place, so only the pages touched by that get
+// copied and the rest stays shared with every process mapping the same file.
+class MappedFile {
+ public:
+  // nullptr if the file can't be mapped, e.g. on platforms without mmap()
+  static std::unique_ptr<MappedFile> map(const std::string& path) {
+#ifdef CORRADE_TARGET_UNIX
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+      return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      return nullptr;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the descriptor
+    close(fd);
+    if (data == MAP_FAILED)
+      return nullptr;
+    return std::unique_ptr<MappedFile>{new MappedFile{
+        static_cast<unsigned char*>(data), std::size_t(st.st_size)}};
+#else
+    static_cast<void>(path);
+    return nullptr;
+#endif
+  }
+
+  ~MappedFile() {
+#ifdef CORRADE_TARGET_UNIX
+    munmap(data_, size_);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  unsigned char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  MappedFile(unsigned char* data, std::size_t size)
+      : data_{data}, size_{size} {}
+
+  unsigned char* data_;
+  std::size_t size_;
+};
+
+// Size-bounded LRU cache of single-goal findPath() results, keyed by the
+// polygons the endpoints snap to and the endpoints themselves, quantized to
+// a grid. Shared by all querying threads.
+class PathCache {
+ public:
+  struct Key {
+    dtPolyRef startRef;
+    dtPolyRef endRef;
+    int32_t start[3];
+    int32_t end[3];
+
+    bool operator==(const Key& other) const {
+      return startRef == other.startRef && endRef == other.endRef &&
+             std::equal(start, start + 3, other.start) &&
+             std::equal(end, end + 3, other.end);
+    }
+  };
+
+  bool enabled() const { return capacity_ != 0; }
+
+  // Resizing drops all entries and statistics
+  void configure(std::size_t capacity, float quantization) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    capacity_ = capacity;
+    quantization_ = quantization;
+    entries_.clear();
+    index_.clear();
+    hits_ = misses_ = 0;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    entries_.clear();
+    index_.clear();
+  }
+
+  Key key(dtPolyRef startRef,
+          const vec3f& start,
+          dtPolyRef endRef,
+          const vec3f& end) const {
+    Key key;
+    key.startRef = startRef;
+    key.endRef = endRef;
+    for (int i = 0; i < 3; ++i) {
+      key.start[i] = quantize(start[i]);
+      key.end[i] = quantize(end[i]);
+    }
+    return key;
+  }
+
+  bool find(const Key& key,
+            float& geodesicDistance,
+            std::vector<vec3f>& points) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    const auto found = index_.find(key);
+    if (found == index_.end()) {
+      ++misses_;
+      return false;
+    }
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    geodesicDistance = found->second->geodesicDistance;
+    points = found->second->points;
+    return true;
+  }
+
+  void insert(const Key& key,
+              float geodesicDistance,
+              const std::vector<vec3f>& points) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // another thread may have found the same path in the meantime
+    if (!capacity_ || index_.count(key))
+      return;
+    entries_.push_front(Entry{key, geodesicDistance, points});
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+  }
+
+  PathCacheStatistics statistics() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return {hits_, misses_, entries_.size(), capacity_};
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    float geodesicDistance;
+    std::vector<vec3f> points;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      std::size_t hash = std::hash<dtPolyRef>{}(key.startRef);
+      auto combine = [&hash](std::size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      };
+      combine(std::hash<dtPolyRef>{}(key.endRef));
+      for (int i = 0; i < 3; ++i) {
+        combine(std::hash<int32_t>{}(key.start[i]));
+        combine(std::hash<int32_t>{}(key.end[i]));
+      }
+      return hash;
+    }
+  };
+
+  // A quantization of 0 keys on the exact bits of the coordinate
+  int32_t quantize(float value) const {
+    if (quantization_ > 0.0f)
+      return int32_t(std::lround(value / quantization_));
+    int32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  mutable std::mutex mutex_;
+  std::size_t capacity_ = 0;
+  float quantization_ = 0.0f;
+  std::list<Entry> entries_;  // most recently used first
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+};
+
+// Two-level abstraction of the navmesh for long paths, after HPA* (Botea,
+// Muller and Schaeffer, 2004). Polygons are grouped into clusters by the
+// cube of clusterSize their centroid falls into; every link between polygons
+// of different clusters is a portal at the midpoint of the shared edge. The
+// portals of a cluster are connected by the length of the shortest path of
+// edge midpoints between them through the cluster, as findNearestEnd()
+// measures it. A search over the portals picks the clusters a path goes
+// through, which are then searched in detail one at a time.
+constexpr uint32_t NO_CLUSTER = ~uint32_t{};
+
+class ClusterGraph {
+ public:
+  struct Portal {
+    vec3f pos;
+    // polygons on either side of the edge and their clusters
+    dtPolyRef refs[2];
+    uint32_t clusters[2];
+  };
+
+  // the portal and the cluster a path passes through before reaching it
+  using Waypoint = std::pair<uint32_t, uint32_t>;
+
+  ClusterGraph(const dtNavMesh* navMesh,
+               const dtQueryFilter* filter,
+               float clusterSize)
+      : navMesh_{navMesh} {
+    tileFirstPoly_.resize(navMesh->getMaxTiles() + 1, 0);
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      tileFirstPoly_[iTile + 1] =
+          tileFirstPoly_[iTile] +
+          (tile && tile->header ? tile->header->polyCount : 0);
+    }
+    polyCluster_.assign(tileFirstPoly_.back(), NO_CLUSTER);
+
+    // clusters by the cube their polygon centroids are in
+    std::map<std::tuple<int, int, int>, uint32_t> cells;
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+      for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+        const dtPoly* poly = &tile->polys[jPoly];
+        const dtPolyRef ref = navMesh->encodePolyId(iTile, tile->salt, jPoly);
+        if (poly->vertCount == 0 || !filter->passFilter(ref, tile, poly))
+          continue;
+        vec3f centroid = vec3f::Zero();
+        for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+          centroid +=
+              Eigen::Map<const vec3f>(&tile->verts[poly->verts[iVert] * 3]);
+        }
+        centroid /= (poly->vertCount * clusterSize);
+        const auto cell = std::make_tuple(int(std::floor(centroid[0])),
+                                          int(std::floor(centroid[1])),
+                                          int(std::floor(centroid[2])));
+        polyCluster_[tileFirstPoly_[iTile] + jPoly] =
+            cells.emplace(cell, cells.size()).first->second;
+      }
+    }
+
+    // a portal for every pair of linked polygons in different clusters,
+    // created from the side with the smaller reference
+    std::vector<std::vector<uint32_t>> clusterPortals(cells.size());
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+      for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+        const dtPoly* poly = &tile->polys[jPoly];
+        const dtPolyRef ref = navMesh->encodePolyId(iTile, tile->salt, jPoly);
+        const uint32_t cluster = clusterId(ref);
+        if (cluster == NO_CLUSTER)
+          continue;
+        for (unsigned int iLink = poly->firstLink; iLink != DT_NULL_LINK;
+             iLink = tile->links[iLink].next) {
+          const dtLink& link = tile->links[iLink];
+          const uint32_t neighbourCluster = clusterId(link.ref);
+          if (link.ref < ref || neighbourCluster == NO_CLUSTER ||
+              neighbourCluster == cluster)
+            continue;
+          const Eigen::Map<const vec3f> a{
+              &tile->verts[poly->verts[link.edge] * 3]};
+          const Eigen::Map<const vec3f> b{
+              &tile->verts[poly->verts[(link.edge + 1) % poly->vertCount] *
+                           3]};
+          const uint32_t portal = portals_.size();
+          portals_.push_back(
+              {0.5f * (a + b), {ref, link.ref}, {cluster, neighbourCluster}});
+          linkPortals_.emplace(std::make_pair(ref, link.ref), portal);
+          linkPortals_.emplace(std::make_pair(link.ref, ref), portal);
+          clusterPortals[cluster].push_back(portal);
+          clusterPortals[neighbourCluster].push_back(portal);
+        }
+      }
+    }
+
+    // edges to the portals reachable from each side of every portal
+    firstEdge_.reserve(portals_.size() + 1);
+    firstEdge_.push_back(0);
+    std::vector<std::pair<uint32_t, float>> costs;
+    for (uint32_t i = 0; i != portals_.size(); ++i) {
+      for (int side = 0; side != 2; ++side) {
+        portalCosts(portals_[i].refs[side], portals_[i].pos, costs);
+        for (const auto& cost : costs) {
+          if (cost.first != i) {
+            edges_.push_back(
+                {cost.first, portals_[i].clusters[side], cost.second});
+          }
+        }
+      }
+      firstEdge_.push_back(edges_.size());
+    }
+  }
+
+  std::size_t portalCount() const { return portals_.size(); }
+
+  const Portal& portal(uint32_t i) const { return portals_[i]; }
+
+  uint32_t clusterId(dtPolyRef ref) const {
+    unsigned int salt, iTile, iPoly;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    if (iTile + 1 >= tileFirstPoly_.size())
+      return NO_CLUSTER;
+    const uint32_t index = tileFirstPoly_[iTile] + iPoly;
+    if (index >= tileFirstPoly_[iTile + 1] ||
+        navMesh_->getTile(iTile)->salt != salt)
+      return NO_CLUSTER;
+    return polyCluster_[index];
+  }
+
+  /**
+   * Portals a path from @p start in @p startRef to @p end in @p endRef
+   * passes through, in order, false if the endpoints are in the same cluster
+   * or the portals don't connect them. A* with the straight-line distance to
+   * the end as heuristic.
+   */
+  bool findWaypoints(dtPolyRef startRef,
+                     const vec3f& start,
+                     dtPolyRef endRef,
+                     const vec3f& end,
+                     std::vector<Waypoint>& waypoints) const {
+    waypoints.clear();
+    const uint32_t startCluster = clusterId(startRef);
+    const uint32_t endCluster = clusterId(endRef);
+    if (startCluster == NO_CLUSTER || endCluster == NO_CLUSTER ||
+        startCluster == endCluster)
+      return false;
+
+    std::vector<std::pair<uint32_t, float>> startCosts;
+    std::vector<std::pair<uint32_t, float>> endCostList;
+    portalCosts(startRef, start, startCosts);
+    portalCosts(endRef, end, endCostList);
+    const std::unordered_map<uint32_t, float> endCosts{endCostList.begin(),
+                                                       endCostList.end()};
+
+    constexpr uint32_t GOAL = ~uint32_t{};
+    struct Node {
+      float cost;
+      Waypoint previous;
+      bool closed;
+    };
+    std::unordered_map<uint32_t, Node> nodes;
+    Node goal{std::numeric_limits<float>::infinity(), {GOAL, GOAL}, false};
+    using Entry = std::pair<float, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    const auto relax = [&](uint32_t portal, float cost, Waypoint previous) {
+      auto inserted = nodes.emplace(portal, Node{cost, previous, false});
+      Node& node = inserted.first->second;
+      if (!inserted.second) {
+        if (node.closed || node.cost <= cost)
+          return;
+        node = Node{cost, previous, false};
+      }
+      open.emplace(cost + (portals_[portal].pos - end).norm(), portal);
+    };
+    for (const auto& cost : startCosts) {
+      relax(cost.first, cost.second, {GOAL, startCluster});
+    }
+
+    while (!open.empty()) {
+      const uint32_t portal = open.top().second;
+      open.pop();
+      if (portal == GOAL)
+        break;
+      Node& node = nodes[portal];
+      if (node.closed)
+        continue;
+      node.closed = true;
+      const float cost = node.cost;
+
+      auto endCost = endCosts.find(portal);
+      if (endCost != endCosts.end() && cost + endCost->second < goal.cost) {
+        goal = Node{cost + endCost->second, {portal, endCluster}, false};
+        open.emplace(goal.cost, GOAL);
+      }
+      for (uint32_t iEdge = firstEdge_[portal];
+           iEdge != firstEdge_[portal + 1]; ++iEdge) {
+        const Edge& edge = edges_[iEdge];
+        relax(edge.portal, cost + edge.cost, {portal, edge.cluster});
+      }
+    }
+    if (goal.previous.first == GOAL)
+      return false;
+
+    // walk back from the goal, remembering the cluster before every portal
+    for (uint32_t portal = goal.previous.first; portal != GOAL;) {
+      const Waypoint& previous = nodes[portal].previous;
+      waypoints.emplace_back(portal, previous.second);
+      portal = previous.first;
+    }
+    std::reverse(waypoints.begin(), waypoints.end());
+    return true;
+  }
+
+ private:
+  struct Edge {
+    uint32_t portal;
+    // cluster the edge runs through
+    uint32_t cluster;
+    float cost;
+  };
+
+  /**
+   * Dijkstra from @p pos in @p ref over the edge midpoints of the polygons of
+   * its cluster, fills @p costs with every portal of the cluster reached and
+   * its cost
+   */
+  void portalCosts(dtPolyRef ref,
+                   const vec3f& pos,
+                   std::vector<std::pair<uint32_t, float>>& costs) const {
+    costs.clear();
+    const uint32_t cluster = clusterId(ref);
+    struct Node {
+      float cost;
+      vec3f pos;
+      bool closed;
+    };
+    std::unordered_map<dtPolyRef, Node> nodes;
+    std::unordered_map<uint32_t, float> reached;
+    using Entry = std::pair<float, dtPolyRef>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    nodes.emplace(ref, Node{0.0f, pos, false});
+    open.emplace(0.0f, ref);
+
+    while (!open.empty()) {
+      const dtPolyRef current = open.top().second;
+      open.pop();
+      Node& node = nodes[current];
+      if (node.closed)
+        continue;
+      node.closed = true;
+      const vec3f nodePos = node.pos;
+      const float cost = node.cost;
+
+      const dtMeshTile* tile = 0;
+      const dtPoly* poly = 0;
+      navMesh_->getTileAndPolyByRefUnsafe(current, &tile, &poly);
+      for (unsigned int iLink = poly->firstLink; iLink != DT_NULL_LINK;
+           iLink = tile->links[iLink].next) {
+        const dtLink& link = tile->links[iLink];
+        const uint32_t neighbourCluster = clusterId(link.ref);
+        if (neighbourCluster == NO_CLUSTER)
+          continue;
+        if (neighbourCluster != cluster) {
+          auto portal = linkPortals_.find(std::make_pair(current, link.ref));
+          if (portal == linkPortals_.end())
+            continue;
+          const float portalCost =
+              cost + (portals_[portal->second].pos - nodePos).norm();
+          auto inserted = reached.emplace(portal->second, portalCost);
+          if (!inserted.second && portalCost < inserted.first->second)
+            inserted.first->second = portalCost;
+          continue;
+        }
+
+        const Eigen::Map<const vec3f> a{
+            &tile->verts[poly->verts[link.edge] * 3]};
+        const Eigen::Map<const vec3f> b{
+            &tile->verts[poly->verts[(link.edge + 1) % poly->vertCount] * 3]};
+        const vec3f neighbourPos = 0.5f * (a + b);
+        const float neighbourCost = cost + (neighbourPos - nodePos).norm();
+        auto inserted =
+            nodes.emplace(link.ref, Node{neighbourCost, neighbourPos, false});
+        Node& neighbour = inserted.first->second;
+        if (!inserted.second) {
+          if (neighbour.closed || neighbour.cost <= neighbourCost)
+            continue;
+          neighbour = Node{neighbourCost, neighbourPos, false};
+        }
+        open.emplace(neighbourCost, link.ref);
+      }
+    }
+    costs.assign(reached.begin(), reached.end());
+  }
+
+  const dtNavMesh* navMesh_;
+  // cluster of every walkable polygon, indexed like in IslandSystem
+  std::vector<uint32_t> tileFirstPoly_;
+  std::vector<uint32_t> polyCluster_;
+  std::vector<Portal> portals_;
+  // portal of the link between two polygons, in either direction
+  std::map<std::pair<dtPolyRef, dtPolyRef>, uint32_t> linkPortals_;
+  // edges of the i-th portal are firstEdge_[i] to firstEdge_[i + 1]
+  std::vector<uint32_t> firstEdge_;
+  std::vector<Edge> edges_;
 };
 }  // namespace impl
 
@@ -225,25 +1188,60 @@ struct PathFinder::Impl {
              const float* bmax);
   bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
 
-  vec3f getRandomNavigablePoint();
+  /**
+   * @brief Build the navmesh of @p variants[i] into @p impls[i], sharing the
+   * voxelization between variants where possible
+   *
+   * @return Whether each variant was built
+   */
+  static std::vector<bool> buildVariants(
+      const std::vector<NavMeshSettings>& variants,
+      const std::vector<Impl*>& impls,
+      const esp::assets::MeshData& mesh);
+
+  bool rebuildTiles(const NavMeshSettings& bs,
+                    const esp::assets::MeshData& mesh,
+                    const std::vector<std::pair<vec3f, vec3f>>& regions);
+
+  vec3f getRandomNavigablePoint(float minIslandRadius);
+  std::vector<vec3f> getRandomNavigablePoints(
+      size_t count,
+      uint32_t seed,
+      const RandomPointConstraints& constraints) const;
 
   bool findPath(ShortestPath& path);
   bool findPath(MultiGoalShortestPath& path);
 
+  size_t findPaths(std::vector<ShortestPath>& paths);
+  void findGeodesicDistances(Cr::Containers::ArrayView<const vec3f> starts,
+                             Cr::Containers::ArrayView<const vec3f> ends,
+                             Cr::Containers::ArrayView<float> distances);
+
   template <typename T>
   T tryStep(const T& start, const T& end, bool allowSliding);
+  void trySteps(Cr::Containers::ArrayView<const vec3f> starts,
+                Cr::Containers::ArrayView<const vec3f> ends,
+                Cr::Containers::ArrayView<vec3f> results,
+                bool allowSliding);
 
   template <typename T>
   T snapPoint(const T& pt);
+  void snapPoints(Cr::Containers::ArrayView<const vec3f> points,
+                  Cr::Containers::ArrayView<vec3f> results);
 
-  bool loadNavMesh(const std::string& path);
+  bool loadNavMesh(const std::string& path, bool mapFile);
 
-  bool saveNavMesh(const std::string& path);
+  bool saveNavMesh(const std::string& path, bool compress);
 
   bool isLoaded() const { return navMesh_ != nullptr; };
 
+  uint64_t navMeshVersion() const { return navMeshVersion_; }
+
   void seed(uint32_t newSeed);
 
+  const core::Random& randomState() const { return random_; }
+  void setRandomState(const core::Random& state) { random_ = state; }
+
   float islandRadius(const vec3f& pt) const;
 
   float distanceToClosestObstacle(const vec3f& pt,
@@ -252,7 +1250,25 @@ struct PathFinder::Impl {
       const vec3f& pt,
       const float maxSearchRadius = 2.0) const;
 
+  void setObstacleDistanceField(float cellSize, float maxSearchRadius);
+
+  void setPathCache(std::size_t capacity, float quantization) {
+    pathCache_.configure(capacity, quantization);
+  }
+  PathCacheStatistics pathCacheStatistics() const {
+    return pathCache_.statistics();
+  }
+  float obstacleDistanceFieldCellSize() const {
+    return obstacleFieldCellSize_;
+  }
+
+  void setHierarchicalPathfinding(float clusterSize, float minDistance);
+  float hierarchicalPathfindingClusterSize() const { return clusterSize_; }
+
   bool isNavigable(const vec3f& pt, const float maxYDelta = 0.5) const;
+  void areNavigable(Cr::Containers::ArrayView<const vec3f> points,
+                    Cr::Containers::ArrayView<bool> results,
+                    const float maxYDelta) const;
 
   std::pair<vec3f, vec3f> bounds() const { return bounds_; };
 
@@ -262,6 +1278,11 @@ struct PathFinder::Impl {
 
   const assets::MeshData::ptr getNavMeshData();
 
+  float geodesicDistance(GeodesicDistanceField& field, const vec3f& pt);
+
+  void distanceMatrix(Cr::Containers::ArrayView<const vec3f> points,
+                      Cr::Containers::ArrayView<float> distances);
+
  private:
   struct NavMeshDeleter {
     void operator()(dtNavMesh* mesh) { dtFreeNavMesh(mesh); }
@@ -270,33 +1291,245 @@ struct PathFinder::Impl {
     void operator()(dtNavMeshQuery* query) { dtFreeNavMeshQuery(query); }
   };
 
+  using NavQueryPtr = std::unique_ptr<dtNavMeshQuery, NavQueryDeleter>;
+
+  /**
+   * @brief Navmesh query borrowed from the pool for the duration of one
+   * request
+   *
+   * Detour queries keep scratch state (node pool, open list) even in const
+   * functions, so every concurrent request needs its own. The query goes back
+   * to the pool on destruction. Converts to false if no query could be
+   * created, e.g. when no navmesh is loaded.
+   */
+  class PooledQuery {
+   public:
+    explicit PooledQuery(const Impl& impl);
+    ~PooledQuery();
+
+    PooledQuery(const PooledQuery&) = delete;
+    PooledQuery& operator=(const PooledQuery&) = delete;
+
+    explicit operator bool() const { return query_ != nullptr; }
+    dtNavMeshQuery* get() const { return query_.get(); }
+    dtNavMeshQuery* operator->() const { return query_.get(); }
+
+   private:
+    const Impl& impl_;
+    NavQueryPtr query_;
+  };
+
+  // file the tiles of navMesh_ point into if it was loaded with mapFile,
+  // declared first so it's unmapped only after the navmesh is freed
+  std::unique_ptr<impl::MappedFile> mappedFile_;
   std::unique_ptr<dtNavMesh, NavMeshDeleter> navMesh_ = nullptr;
-  std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> navQuery_ = nullptr;
+  // queries not currently in use, grows to the number of threads querying at
+  // once. The filter is only read by the queries, so they share filter_.
+  mutable std::vector<NavQueryPtr> queryPool_;
+  mutable std::mutex queryPoolMutex_;
   std::unique_ptr<dtQueryFilter> filter_ = nullptr;
   std::unique_ptr<impl::IslandSystem> islandSystem_ = nullptr;
+  // portals for long paths, rebuilt with the island system if the cluster
+  // size isn't 0
+  std::unique_ptr<impl::ClusterGraph> clusterGraph_ = nullptr;
+  float clusterSize_ = 0.0f;
+  float hierarchicalMinDistance_ = 0.0f;
+  // cleared with the query pool
+  impl::PathCache pathCache_;
+  // set if the navmesh was built in tiles, for rebuildTiles()
+  Cr::Containers::Optional<impl::TileLayout> tileLayout_;
 
   //! Holds triangulated geom/topo. Generated when queried. Reset with
-  //! navQuery_.
+  //! the query pool.
   assets::MeshData::ptr meshData_ = nullptr;
 
+  // getTopDownView() results by (pixelsPerMeter, height), reset with the query
+  // pool
+  std::map<std::pair<float, float>,
+           Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>
+      topDownViewCache_;
+
+  // obstacle distance field settings, disabled if the cell size is 0. The
+  // field itself is built on first use and reset with the query pool, it's
+  // swapped atomically so the queries can read it without taking the mutex.
+  float obstacleFieldCellSize_ = 0.0f;
+  float obstacleFieldRadius_ = 2.0f;
+  mutable std::shared_ptr<const impl::ObstacleDistanceField> obstacleField_;
+  mutable std::mutex obstacleFieldMutex_;
+
+  // the vertex graph of geodesic distance fields and distance matrices,
+  // built on first use and reset with the query pool like the obstacle field
+  mutable std::shared_ptr<const impl::VertexGraph> vertexGraph_;
+  mutable std::mutex vertexGraphMutex_;
+
   std::pair<vec3f, vec3f> bounds_;
 
+  // changed with every navmesh, see PathFinder::navMeshVersion()
+  uint64_t navMeshVersion_ = 0;
+
+  // per instance instead of the global rand() so that pathfinders on
+  // different threads don't share state
+  core::Random random_;
+
   void removeZeroAreaPolys();
   bool initNavQuery();
 
+  // The obstacle distance field, built if enabled and not there yet.
+  // nullptr if disabled.
+  std::shared_ptr<const impl::ObstacleDistanceField> obstacleDistanceField()
+      const;
+  impl::ObstacleDistanceField buildObstacleDistanceField() const;
+
+  // The vertex graph, built if not there yet
+  std::shared_ptr<const impl::VertexGraph> vertexGraph() const;
+  impl::VertexGraph buildVertexGraph() const;
+
+  /**
+   * @brief Build a navmesh of @ref NavMeshSettings::tileSize tiles, in
+   * parallel
+   *
+   * @param globalCfg Config covering the whole mesh
+   */
+  bool buildTiled(const NavMeshSettings& bs,
+                  const rcConfig& globalCfg,
+                  const float* verts,
+                  const int nverts,
+                  const int* tris,
+                  const int ntris);
+
+  /** @brief Detour data of one tile, empty if nothing is walkable there */
+  struct TileData {
+    int index = 0;
+    unsigned char* data = nullptr;
+    int size = 0;
+    int vertCount = 0;
+    int polyCount = 0;
+  };
+
+  /**
+   * @brief Build the tiles @p tileIndices of each of @p layouts in parallel
+   *
+   * The layouts have to share the tile grid, the border and
+   * sameVoxelization(), each tile is then rasterized once for all of them.
+   * @p tiles gets the tiles of each layout. On failure, all data built so
+   * far is freed.
+   */
+  static bool buildTiles(const std::vector<const impl::TileLayout*>& layouts,
+                         const float* verts,
+                         const int nverts,
+                         const int* tris,
+                         const int ntris,
+                         const std::vector<int>& tileIndices,
+                         std::vector<std::vector<TileData>>& tiles);
+
+  /** @brief Detour params of a navmesh of @p layout, false if it can't be */
+  static bool tiledNavMeshParams(const impl::TileLayout& layout,
+                                 dtNavMeshParams& params);
+
+  /**
+   * @brief Replace the navmesh with @p tiles of @p layout
+   *
+   * Takes ownership of the tile data, also on failure.
+   */
+  bool loadTiles(const impl::TileLayout& layout, std::vector<TileData>& tiles);
+
+  /**
+   * @brief Replace the navmesh with the single tile @p navData
+   *
+   * Takes ownership of the data, also on failure.
+   */
+  bool loadSingleTile(unsigned char* navData, int navDataSize);
+
+  void buildDistanceField(GeodesicDistanceField::Impl& field,
+                          dtNavMeshQuery* query) const;
+
+  bool findPath(ShortestPath& path, dtNavMeshQuery* query);
+  bool findPath(MultiGoalShortestPath& path, dtNavMeshQuery* query);
+
+  template <typename T>
+  T tryStep(const T& start,
+            const T& end,
+            bool allowSliding,
+            dtNavMeshQuery* query);
+  template <typename T>
+  T snapPoint(const T& pt, dtNavMeshQuery* query);
+  bool isNavigable(const vec3f& pt,
+                   const float maxYDelta,
+                   dtNavMeshQuery* query) const;
+
   Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-  findPathInternal(const vec3f& start,
+  findPathInternal(dtNavMeshQuery* query,
+                   const vec3f& start,
                    dtPolyRef startRef,
                    const vec3f& pathStart,
                    const vec3f& end,
                    dtPolyRef endRef,
                    const vec3f& pathEnd);
 
-  bool findPathSetup(MultiGoalShortestPath& path,
+  /**
+   * @brief Path through the portals of @ref clusterGraph_
+   *
+   * Searches the polygons between consecutive portals with Detour and
+   * straightens the joined corridor, so the result is the shortest path among
+   * those passing the chosen clusters. Fails if the endpoints are in the same
+   * cluster or a part of the path isn't found.
+   */
+  Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+  findPathHierarchical(dtNavMeshQuery* query,
+                       const vec3f& start,
+                       dtPolyRef startRef,
+                       const vec3f& pathStart,
+                       const vec3f& end,
+                       dtPolyRef endRef,
+                       const vec3f& pathEnd);
+
+  /**
+   * @brief Dijkstra over the navmesh polygons from @p startRef until the
+   * polygon of any end of @p path is reached
+   *
+   * Polygons are entered at the midpoint of the shared edge, the resulting
+   * cost is only used to pick the end searched for first.
+   *
+   * @return Index of the reached end in @p path, -1 if none is reachable
+   */
+  int findNearestEnd(const MultiGoalShortestPath& path,
+                     dtPolyRef startRef,
+                     const vec3f& pathStart) const;
+
+  bool findPathSetup(dtNavMeshQuery* query,
+                     MultiGoalShortestPath& path,
                      dtPolyRef& startRef,
                      vec3f& pathStart);
 };
 
+PathFinder::Impl::PooledQuery::PooledQuery(const Impl& impl) : impl_{impl} {
+  {
+    std::lock_guard<std::mutex> lock{impl_.queryPoolMutex_};
+    if (!impl_.queryPool_.empty()) {
+      query_ = std::move(impl_.queryPool_.back());
+      impl_.queryPool_.pop_back();
+      return;
+    }
+  }
+
+  if (!impl_.navMesh_) {
+    return;
+  }
+  query_.reset(dtAllocNavMeshQuery());
+  if (!query_ || dtStatusFailed(query_->init(impl_.navMesh_.get(), 2048))) {
+    LOG(ERROR) << "Could not init Detour navmesh query";
+    query_ = nullptr;
+  }
+}
+
+PathFinder::Impl::PooledQuery::~PooledQuery() {
+  // drop queries created for a navmesh that got replaced in the meantime
+  if (query_ && query_->getAttachedNavMesh() == impl_.navMesh_.get()) {
+    std::lock_guard<std::mutex> lock{impl_.queryPoolMutex_};
+    impl_.queryPool_.emplace_back(std::move(query_));
+  }
+}
+
 namespace {
 struct Workspace {
   rcHeightfield* solid = 0;
@@ -309,10 +1542,20 @@ struct Workspace {
   ~Workspace() {
     rcFreeHeightField(solid);
     delete[] triareas;
+    resetPolyMesh();
+  }
+
+  // frees everything built from the heightfield, to build the next variant
+  // from it
+  void resetPolyMesh() {
     rcFreeCompactHeightfield(chf);
     rcFreeContourSet(cset);
     rcFreePolyMesh(pmesh);
     rcFreePolyMeshDetail(dmesh);
+    chf = 0;
+    cset = 0;
+    pmesh = 0;
+    dmesh = 0;
   }
 };
 
@@ -332,16 +1575,11 @@ PathFinder::Impl::Impl() {
   filter_->setExcludeFlags(0);
 }
 
-bool PathFinder::Impl::build(const NavMeshSettings& bs,
-                             const float* verts,
-                             const int nverts,
-                             const int* tris,
-                             const int ntris,
-                             const float* bmin,
-                             const float* bmax) {
-  Workspace ws;
-  rcContext ctx;
-
+namespace {
+//! Step 1 of the Recast pipeline, config for the whole [bmin, bmax] box
+rcConfig makeConfig(const NavMeshSettings& bs,
+                    const float* bmin,
+                    const float* bmax) {
   //
   // Step 1. Initialize build config.
   //
@@ -372,9 +1610,19 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   rcVcopy(cfg.bmin, bmin);
   rcVcopy(cfg.bmax, bmax);
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-  LOG(INFO) << "Building navmesh with " << cfg.width << "x" << cfg.height
-            << " cells";
 
+  return cfg;
+}
+
+//! Step 2 of the Recast pipeline, voxelizes the cells covered by @p cfg into
+//! ws.solid
+bool rasterize(rcContext& ctx,
+               const rcConfig& cfg,
+               const float* verts,
+               const int nverts,
+               const int* tris,
+               const int ntris,
+               Workspace& ws) {
   //
   // Step 2. Rasterize input polygon soup.
   //
@@ -411,7 +1659,47 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     LOG(ERROR) << "Could not rasterize triangles.";
     return false;
   }
+  return true;
+}
+
+// Voxelization only depends on these, variants that agree on them can share
+// the heightfield and differ in everything else
+bool sameVoxelization(const NavMeshSettings& a,
+                      const rcConfig& aCfg,
+                      const NavMeshSettings& b,
+                      const rcConfig& bCfg) {
+  return aCfg.cs == bCfg.cs && aCfg.ch == bCfg.ch &&
+         aCfg.walkableSlopeAngle == bCfg.walkableSlopeAngle &&
+         aCfg.walkableClimb == bCfg.walkableClimb && a.tileSize == b.tileSize;
+}
 
+// The filters of step 3 only change span areas, so saving the areas after
+// rasterization allows undoing the filters of one variant before the next
+std::vector<unsigned char> spanAreas(const rcHeightfield& hf) {
+  std::vector<unsigned char> areas;
+  for (int i = 0; i < hf.width * hf.height; ++i) {
+    for (const rcSpan* s = hf.spans[i]; s; s = s->next) {
+      areas.push_back(s->area);
+    }
+  }
+  return areas;
+}
+
+void restoreSpanAreas(rcHeightfield& hf,
+                      const std::vector<unsigned char>& areas) {
+  std::size_t index = 0;
+  for (int i = 0; i < hf.width * hf.height; ++i) {
+    for (rcSpan* s = hf.spans[i]; s; s = s->next) {
+      s->area = areas[index++];
+    }
+  }
+}
+
+//! Steps 3 to 7 of the Recast pipeline on the heightfield in ws.solid
+bool buildPolyMesh(rcContext& ctx,
+                   const NavMeshSettings& bs,
+                   const rcConfig& cfg,
+                   Workspace& ws) {
   //
   // Step 3. Filter walkables surfaces.
   //
@@ -497,7 +1785,7 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     return false;
   }
   // Partition the walkable surface into simple regions without holes.
-  if (!rcBuildRegions(&ctx, *ws.chf, 0, cfg.minRegionArea,
+  if (!rcBuildRegions(&ctx, *ws.chf, cfg.borderSize, cfg.minRegionArea,
                       cfg.mergeRegionArea)) {
     LOG(ERROR) << "Could not build watershed regions";
     return false;
@@ -557,6 +1845,106 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     return false;
   }
 
+  return true;
+}
+
+//! Steps 2 to 7 of the Recast pipeline for the cells covered by @p cfg
+bool buildPolyMesh(rcContext& ctx,
+                   const NavMeshSettings& bs,
+                   const rcConfig& cfg,
+                   const float* verts,
+                   const int nverts,
+                   const int* tris,
+                   const int ntris,
+                   Workspace& ws) {
+  return rasterize(ctx, cfg, verts, nverts, tris, ntris, ws) &&
+         buildPolyMesh(ctx, bs, cfg, ws);
+}
+
+//! Step 8 of the Recast pipeline, Detour data of tile @p tileX, @p tileY
+bool createNavMeshData(const NavMeshSettings& bs,
+                       const rcConfig& cfg,
+                       Workspace& ws,
+                       const int tileX,
+                       const int tileY,
+                       unsigned char*& navData,
+                       int& navDataSize) {
+  // Update poly flags from areas.
+  for (int i = 0; i < ws.pmesh->npolys; ++i) {
+    if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
+      ws.pmesh->areas[i] = POLYAREA_GROUND;
+    }
+    if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK;
+    } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
+    }
+  }
+
+  dtNavMeshCreateParams params;
+  memset(&params, 0, sizeof(params));
+  params.verts = ws.pmesh->verts;
+  params.vertCount = ws.pmesh->nverts;
+  params.polys = ws.pmesh->polys;
+  params.polyAreas = ws.pmesh->areas;
+  params.polyFlags = ws.pmesh->flags;
+  params.polyCount = ws.pmesh->npolys;
+  params.nvp = ws.pmesh->nvp;
+  params.detailMeshes = ws.dmesh->meshes;
+  params.detailVerts = ws.dmesh->verts;
+  params.detailVertsCount = ws.dmesh->nverts;
+  params.detailTris = ws.dmesh->tris;
+  params.detailTriCount = ws.dmesh->ntris;
+  // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
+  // params.offMeshConRad = geom->getOffMeshConnectionRads();
+  // params.offMeshConDir = geom->getOffMeshConnectionDirs();
+  // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
+  // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
+  // params.offMeshConUserID = geom->getOffMeshConnectionId();
+  // params.offMeshConCount = geom->getOffMeshConnectionCount();
+  params.walkableHeight = bs.agentHeight;
+  params.walkableRadius = bs.agentRadius;
+  params.walkableClimb = bs.agentMaxClimb;
+  params.tileX = tileX;
+  params.tileY = tileY;
+  params.tileLayer = 0;
+  rcVcopy(params.bmin, ws.pmesh->bmin);
+  rcVcopy(params.bmax, ws.pmesh->bmax);
+  params.cs = cfg.cs;
+  params.ch = cfg.ch;
+  params.buildBvTree = true;
+
+  if (!dtCreateNavMeshData(&params, &navData, &navDataSize)) {
+    LOG(ERROR) << "Could not build Detour navmesh";
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+bool PathFinder::Impl::build(const NavMeshSettings& bs,
+                             const float* verts,
+                             const int nverts,
+                             const int* tris,
+                             const int ntris,
+                             const float* bmin,
+                             const float* bmax) {
+  rcConfig cfg = makeConfig(bs, bmin, bmax);
+
+  if (bs.tileSize > 0) {
+    return buildTiled(bs, cfg, verts, nverts, tris, ntris);
+  }
+  tileLayout_ = Cr::Containers::NullOpt;
+
+  LOG(INFO) << "Building navmesh with " << cfg.width << "x" << cfg.height
+            << " cells";
+
+  Workspace ws;
+  rcContext ctx;
+  if (!buildPolyMesh(ctx, bs, cfg, verts, nverts, tris, ntris, ws)) {
+    return false;
+  }
+
   // At this point the navigation mesh data is ready, you can access it from
   // ws.pmesh. See duDebugDrawPolyMesh or dtCreateNavMeshData as examples how to
   // access the data.
@@ -570,95 +1958,362 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   if (cfg.maxVertsPerPoly <= DT_VERTS_PER_POLYGON) {
     unsigned char* navData = 0;
     int navDataSize = 0;
+    if (!createNavMeshData(bs, cfg, ws, 0, 0, navData, navDataSize) ||
+        !loadSingleTile(navData, navDataSize)) {
+      return false;
+    }
+  }
+
+  // Added as we also need to remove these on navmesh recomputation
+  removeZeroAreaPolys();
+
+  LOG(INFO) << "Created navmesh with " << ws.pmesh->nverts << " vertices "
+            << ws.pmesh->npolys << " polygons";
+
+  return true;
+}
+
+bool PathFinder::Impl::loadSingleTile(unsigned char* navData,
+                                      int navDataSize) {
+  navMesh_.reset(dtAllocNavMesh());
+  mappedFile_ = nullptr;
+  if (!navMesh_) {
+    dtFree(navData);
+    LOG(ERROR) << "Could not allocate Detour navmesh";
+    return false;
+  }
 
-    // Update poly flags from areas.
-    for (int i = 0; i < ws.pmesh->npolys; ++i) {
-      if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
-        ws.pmesh->areas[i] = POLYAREA_GROUND;
+  dtStatus status;
+  status = navMesh_->init(navData, navDataSize, DT_TILE_FREE_DATA);
+  if (dtStatusFailed(status)) {
+    dtFree(navData);
+    LOG(ERROR) << "Could not init Detour navmesh";
+    return false;
+  }
+  return initNavQuery();
+}
+
+bool PathFinder::Impl::buildTiles(
+    const std::vector<const impl::TileLayout*>& layouts,
+    const float* verts,
+    const int nverts,
+    const int* tris,
+    const int ntris,
+    const std::vector<int>& tileIndices,
+    std::vector<std::vector<TileData>>& tiles) {
+  // Only rasterize the triangles overlapping a tile and its border
+  const impl::TileLayout& layout = *layouts.front();
+  std::vector<int> tileSlots(layout.tileCount(), -1);
+  for (size_t i = 0; i < tileIndices.size(); ++i) {
+    tileSlots[tileIndices[i]] = i;
+  }
+  std::vector<std::vector<int>> tileTris(tileIndices.size());
+  for (int iTri = 0; iTri < ntris; ++iTri) {
+    float triMin[2] = {std::numeric_limits<float>::max(),
+                       std::numeric_limits<float>::max()};
+    float triMax[2] = {-std::numeric_limits<float>::max(),
+                       -std::numeric_limits<float>::max()};
+    for (int iVert = 0; iVert < 3; ++iVert) {
+      const float* v = &verts[tris[iTri * 3 + iVert] * 3];
+      triMin[0] = std::min(triMin[0], v[0]);
+      triMin[1] = std::min(triMin[1], v[2]);
+      triMax[0] = std::max(triMax[0], v[0]);
+      triMax[1] = std::max(triMax[1], v[2]);
+    }
+    const std::pair<int, int> rangeX =
+        layout.tileRange(triMin[0], triMax[0], 0);
+    const std::pair<int, int> rangeY =
+        layout.tileRange(triMin[1], triMax[1], 2);
+    for (int y = rangeY.first; y <= rangeY.second; ++y) {
+      for (int x = rangeX.first; x <= rangeX.second; ++x) {
+        const int slot = tileSlots[y * layout.tileCountX + x];
+        if (slot != -1) {
+          tileTris[slot].push_back(iTri);
+        }
       }
-      if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK;
-      } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
+    }
+  }
+
+  // Tiles are independent, build them in parallel
+  const int tileCount = tileIndices.size();
+  tiles.assign(layouts.size(), std::vector<TileData>(tileCount));
+  bool success = true;
+#pragma omp parallel for schedule(dynamic) reduction(&& : success)
+  for (int i = 0; i < tileCount; ++i) {
+    for (std::vector<TileData>& variantTiles : tiles) {
+      variantTiles[i].index = tileIndices[i];
+    }
+    if (tileTris[i].empty()) {
+      continue;
+    }
+    const int x = tileIndices[i] % layout.tileCountX;
+    const int y = tileIndices[i] / layout.tileCountX;
+
+    std::vector<int> indices;
+    indices.reserve(tileTris[i].size() * 3);
+    for (const int iTri : tileTris[i]) {
+      indices.insert(indices.end(), &tris[iTri * 3], &tris[iTri * 3 + 3]);
+    }
+
+    Workspace ws;
+    rcContext ctx;
+    if (!rasterize(ctx, layout.configForTile(x, y), verts, nverts,
+                   indices.data(), int(tileTris[i].size()), ws)) {
+      success = false;
+      continue;
+    }
+    std::vector<unsigned char> areas;
+    if (layouts.size() > 1) {
+      areas = spanAreas(*ws.solid);
+    }
+
+    for (size_t v = 0; v < layouts.size(); ++v) {
+      if (v > 0) {
+        ws.resetPolyMesh();
+        restoreSpanAreas(*ws.solid, areas);
+      }
+      const rcConfig cfg = layouts[v]->configForTile(x, y);
+      TileData& tile = tiles[v][i];
+      if (!buildPolyMesh(ctx, layouts[v]->settings, cfg, ws)) {
+        success = false;
+        break;
       }
+      // nothing walkable in this tile
+      if (ws.pmesh->npolys == 0) {
+        continue;
+      }
+      if (!createNavMeshData(layouts[v]->settings, cfg, ws, x, y, tile.data,
+                             tile.size)) {
+        success = false;
+        break;
+      }
+      tile.vertCount = ws.pmesh->nverts;
+      tile.polyCount = ws.pmesh->npolys;
     }
+  }
 
-    dtNavMeshCreateParams params;
-    memset(&params, 0, sizeof(params));
-    params.verts = ws.pmesh->verts;
-    params.vertCount = ws.pmesh->nverts;
-    params.polys = ws.pmesh->polys;
-    params.polyAreas = ws.pmesh->areas;
-    params.polyFlags = ws.pmesh->flags;
-    params.polyCount = ws.pmesh->npolys;
-    params.nvp = ws.pmesh->nvp;
-    params.detailMeshes = ws.dmesh->meshes;
-    params.detailVerts = ws.dmesh->verts;
-    params.detailVertsCount = ws.dmesh->nverts;
-    params.detailTris = ws.dmesh->tris;
-    params.detailTriCount = ws.dmesh->ntris;
-    // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
-    // params.offMeshConRad = geom->getOffMeshConnectionRads();
-    // params.offMeshConDir = geom->getOffMeshConnectionDirs();
-    // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
-    // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
-    // params.offMeshConUserID = geom->getOffMeshConnectionId();
-    // params.offMeshConCount = geom->getOffMeshConnectionCount();
-    params.walkableHeight = bs.agentHeight;
-    params.walkableRadius = bs.agentRadius;
-    params.walkableClimb = bs.agentMaxClimb;
-    rcVcopy(params.bmin, ws.pmesh->bmin);
-    rcVcopy(params.bmax, ws.pmesh->bmax);
-    params.cs = cfg.cs;
-    params.ch = cfg.ch;
-    params.buildBvTree = true;
-
-    if (!dtCreateNavMeshData(&params, &navData, &navDataSize)) {
-      LOG(ERROR) << "Could not build Detour navmesh";
-      return false;
+  if (!success) {
+    for (std::vector<TileData>& variantTiles : tiles) {
+      for (TileData& tile : variantTiles) {
+        dtFree(tile.data);
+      }
     }
+    tiles.clear();
+  }
+  return success;
+}
 
-    navMesh_.reset(dtAllocNavMesh());
-    if (!navMesh_) {
-      dtFree(navData);
-      LOG(ERROR) << "Could not allocate Detour navmesh";
-      return false;
+bool PathFinder::Impl::tiledNavMeshParams(const impl::TileLayout& layout,
+                                          dtNavMeshParams& params) {
+  if (layout.globalCfg.maxVertsPerPoly > DT_VERTS_PER_POLYGON) {
+    LOG(ERROR) << "Tiled navmesh builds support at most "
+               << DT_VERTS_PER_POLYGON << " vertices per polygon";
+    return false;
+  }
+
+  // Detour polygon refs have 22 bits for the tile and polygon index
+  const int tileCount = layout.tileCount();
+  const int tileBits =
+      std::min(int(dtIlog2(dtNextPow2(static_cast<unsigned int>(tileCount)))),
+               14);
+  memset(&params, 0, sizeof(params));
+  rcVcopy(params.orig, layout.globalCfg.bmin);
+  params.tileWidth = layout.tileWorldSize;
+  params.tileHeight = layout.tileWorldSize;
+  params.maxTiles = 1 << tileBits;
+  params.maxPolys = 1 << (22 - tileBits);
+  if (tileCount > params.maxTiles) {
+    LOG(ERROR) << "Too many navmesh tiles, increase the tile size";
+    return false;
+  }
+  return true;
+}
+
+bool PathFinder::Impl::buildTiled(const NavMeshSettings& bs,
+                                  const rcConfig& globalCfg,
+                                  const float* verts,
+                                  const int nverts,
+                                  const int* tris,
+                                  const int ntris) {
+  impl::TileLayout layout{bs, globalCfg};
+  dtNavMeshParams navMeshParams;
+  if (!tiledNavMeshParams(layout, navMeshParams)) {
+    return false;
+  }
+  const int tileCount = layout.tileCount();
+  LOG(INFO) << "Building navmesh with " << globalCfg.width << "x"
+            << globalCfg.height << " cells in " << layout.tileCountX << "x"
+            << layout.tileCountY << " tiles";
+
+  std::vector<int> tileIndices(tileCount);
+  std::iota(tileIndices.begin(), tileIndices.end(), 0);
+  std::vector<std::vector<TileData>> tiles;
+  if (!buildTiles({&layout}, verts, nverts, tris, ntris, tileIndices, tiles)) {
+    return false;
+  }
+  return loadTiles(layout, tiles.front());
+}
+
+bool PathFinder::Impl::loadTiles(const impl::TileLayout& layout,
+                                 std::vector<TileData>& tiles) {
+  dtNavMeshParams navMeshParams;
+  std::unique_ptr<dtNavMesh, NavMeshDeleter> navMesh{dtAllocNavMesh()};
+  if (!tiledNavMeshParams(layout, navMeshParams) || !navMesh ||
+      dtStatusFailed(navMesh->init(&navMeshParams))) {
+    LOG(ERROR) << "Could not init Detour navmesh";
+    for (TileData& tile : tiles) {
+      dtFree(tile.data);
     }
+    return false;
+  }
 
-    dtStatus status;
-    status = navMesh_->init(navData, navDataSize, DT_TILE_FREE_DATA);
-    if (dtStatusFailed(status)) {
-      dtFree(navData);
-      LOG(ERROR) << "Could not init Detour navmesh";
-      return false;
+  // adding tiles isn't thread-safe, so it's done only after all are built
+  int vertCount = 0;
+  int polyCount = 0;
+  bool success = true;
+  for (TileData& tile : tiles) {
+    if (!tile.data) {
+      continue;
     }
-    if (!initNavQuery()) {
-      return false;
+    if (success &&
+        dtStatusFailed(navMesh->addTile(tile.data, tile.size,
+                                        DT_TILE_FREE_DATA, 0, nullptr))) {
+      LOG(ERROR) << "Could not add tile to Detour navmesh";
+      success = false;
+    }
+    // the navmesh owns the data from here on
+    if (!success) {
+      dtFree(tile.data);
+      continue;
     }
+    vertCount += tile.vertCount;
+    polyCount += tile.polyCount;
+  }
+  if (!success) {
+    return false;
+  }
+
+  navMesh_ = std::move(navMesh);
+  mappedFile_ = nullptr;
+  tileLayout_ = layout;
+  if (!initNavQuery()) {
+    return false;
   }
 
   // Added as we also need to remove these on navmesh recomputation
   removeZeroAreaPolys();
 
-  LOG(INFO) << "Created navmesh with " << ws.pmesh->nverts << " vertices "
-            << ws.pmesh->npolys << " polygons";
+  LOG(INFO) << "Created navmesh with " << vertCount << " vertices "
+            << polyCount << " polygons";
 
   return true;
 }
 
+bool PathFinder::Impl::rebuildTiles(
+    const NavMeshSettings& bs,
+    const esp::assets::MeshData& mesh,
+    const std::vector<std::pair<vec3f, vec3f>>& regions) {
+  if (!navMesh_ || !tileLayout_ || tileLayout_->settings != bs) {
+    return false;
+  }
+
+  const float mf = std::numeric_limits<float>::max();
+  vec3f bmin(mf, mf, mf);
+  vec3f bmax(-mf, -mf, -mf);
+  for (const vec3f& p : mesh.vbo) {
+    bmin = bmin.cwiseMin(p);
+    bmax = bmax.cwiseMax(p);
+  }
+  // different bounds shift the whole tile grid
+  const rcConfig cfg = makeConfig(bs, bmin.data(), bmax.data());
+  if (memcmp(&cfg, &tileLayout_->globalCfg, sizeof(rcConfig)) != 0) {
+    return false;
+  }
+
+  const impl::TileLayout& layout = *tileLayout_;
+  std::vector<char> selected(layout.tileCount(), false);
+  for (const std::pair<vec3f, vec3f>& region : regions) {
+    const std::pair<int, int> rangeX =
+        layout.tileRange(region.first[0], region.second[0], 0);
+    const std::pair<int, int> rangeY =
+        layout.tileRange(region.first[2], region.second[2], 2);
+    for (int y = rangeY.first; y <= rangeY.second; ++y) {
+      for (int x = rangeX.first; x <= rangeX.second; ++x) {
+        selected[y * layout.tileCountX + x] = true;
+      }
+    }
+  }
+  std::vector<int> tileIndices;
+  for (int i = 0; i < layout.tileCount(); ++i) {
+    if (selected[i]) {
+      tileIndices.push_back(i);
+    }
+  }
+  if (tileIndices.empty()) {
+    return true;
+  }
+  LOG(INFO) << "Rebuilding " << tileIndices.size() << " of "
+            << layout.tileCount() << " navmesh tiles";
+
+  std::vector<int> indices(mesh.ibo.begin(), mesh.ibo.end());
+  std::vector<std::vector<TileData>> variantTiles;
+  if (!buildTiles({&layout}, mesh.vbo[0].data(), mesh.vbo.size(),
+                  indices.data(), indices.size() / 3, tileIndices,
+                  variantTiles)) {
+    return false;
+  }
+  std::vector<TileData>& tiles = variantTiles.front();
+
+  bool success = true;
+  for (TileData& tile : tiles) {
+    const int x = tile.index % layout.tileCountX;
+    const int y = tile.index / layout.tileCountX;
+    const dtTileRef oldRef = navMesh_->getTileRefAt(x, y, 0);
+    if (oldRef) {
+      navMesh_->removeTile(oldRef, nullptr, nullptr);
+    }
+    if (tile.data &&
+        dtStatusFailed(navMesh_->addTile(tile.data, tile.size,
+                                         DT_TILE_FREE_DATA, 0, nullptr))) {
+      LOG(ERROR) << "Could not add tile to Detour navmesh";
+      dtFree(tile.data);
+      success = false;
+    }
+  }
+
+  removeZeroAreaPolys();
+  // polygon refs changed, so the islands and cached data have to be redone
+  return initNavQuery() && success;
+}
+
 bool PathFinder::Impl::initNavQuery() {
+  // unique across all pathfinders, so a cache can't mistake a navmesh of
+  // another instance for the one it was filled from
+  static std::atomic<uint64_t> lastNavMeshVersion{0};
+  navMeshVersion_ = ++lastNavMeshVersion;
+
   // if we are reinitializing the NavQuery, then also reset the MeshData
   meshData_.reset();
-
-  navQuery_.reset(dtAllocNavMeshQuery());
-  dtStatus status = navQuery_->init(navMesh_.get(), 2048);
-  if (dtStatusFailed(status)) {
-    LOG(ERROR) << "Could not init Detour navmesh query";
+  topDownViewCache_.clear();
+  pathCache_.clear();
+  std::atomic_store(&obstacleField_, {});
+  std::atomic_store(&vertexGraph_, {});
+
+  {
+    std::lock_guard<std::mutex> lock{queryPoolMutex_};
+    queryPool_.clear();
+  }
+  // create the first query right away to catch a broken navmesh early
+  if (!PooledQuery{*this}) {
     return false;
   }
 
   islandSystem_ =
       std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+  clusterGraph_ = clusterSize_ > 0.0f
+                      ? std::make_unique<impl::ClusterGraph>(
+                            navMesh_.get(), filter_.get(), clusterSize_)
+                      : nullptr;
 
   return true;
 }
@@ -688,9 +2343,123 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   return success;
 }
 
+std::vector<bool> PathFinder::Impl::buildVariants(
+    const std::vector<NavMeshSettings>& variants,
+    const std::vector<Impl*>& impls,
+    const esp::assets::MeshData& mesh) {
+  std::vector<bool> built(variants.size(), false);
+  const float mf = std::numeric_limits<float>::max();
+  vec3f bmin(mf, mf, mf);
+  vec3f bmax(-mf, -mf, -mf);
+  for (const vec3f& p : mesh.vbo) {
+    bmin = bmin.cwiseMin(p);
+    bmax = bmax.cwiseMax(p);
+  }
+  const std::vector<int> indices(mesh.ibo.begin(), mesh.ibo.end());
+  const float* verts = mesh.vbo[0].data();
+  const int nverts = mesh.vbo.size();
+  const int ntris = indices.size() / 3;
+
+  std::vector<rcConfig> cfgs;
+  for (const NavMeshSettings& bs : variants) {
+    cfgs.push_back(makeConfig(bs, bmin.data(), bmax.data()));
+  }
+
+  std::vector<bool> grouped(variants.size(), false);
+  for (size_t first = 0; first < variants.size(); ++first) {
+    if (grouped[first]) {
+      continue;
+    }
+    std::vector<size_t> group;
+    for (size_t i = first; i < variants.size(); ++i) {
+      if (!grouped[i] && sameVoxelization(variants[first], cfgs[first],
+                                          variants[i], cfgs[i])) {
+        grouped[i] = true;
+        group.push_back(i);
+      }
+    }
+    LOG(INFO) << "Building " << group.size() << " navmesh variants from one "
+              << "voxelization of " << cfgs[first].width << "x"
+              << cfgs[first].height << " cells";
+
+    if (variants[first].tileSize > 0) {
+      // all tiles of the group need the border of the largest agent
+      int borderSize = 0;
+      for (size_t i : group) {
+        borderSize = std::max(borderSize, cfgs[i].walkableRadius + 3);
+      }
+      std::vector<impl::TileLayout> layouts;
+      std::vector<size_t> layoutVariants;
+      for (size_t i : group) {
+        impl::TileLayout layout{variants[i], cfgs[i], borderSize};
+        dtNavMeshParams params;
+        if (tiledNavMeshParams(layout, params)) {
+          layouts.push_back(layout);
+          layoutVariants.push_back(i);
+        }
+      }
+      if (layouts.empty()) {
+        continue;
+      }
+      std::vector<const impl::TileLayout*> layoutPointers;
+      for (const impl::TileLayout& layout : layouts) {
+        layoutPointers.push_back(&layout);
+      }
+
+      std::vector<int> tileIndices(layouts.front().tileCount());
+      std::iota(tileIndices.begin(), tileIndices.end(), 0);
+      std::vector<std::vector<TileData>> tiles;
+      if (!buildTiles(layoutPointers, verts, nverts, indices.data(), ntris,
+                      tileIndices, tiles)) {
+        continue;
+      }
+      for (size_t v = 0; v < layouts.size(); ++v) {
+        const size_t i = layoutVariants[v];
+        built[i] = impls[i]->loadTiles(layouts[v], tiles[v]);
+      }
+      continue;
+    }
+
+    Workspace ws;
+    rcContext ctx;
+    if (!rasterize(ctx, cfgs[first], verts, nverts, indices.data(), ntris,
+                   ws)) {
+      continue;
+    }
+    const std::vector<unsigned char> areas = spanAreas(*ws.solid);
+    for (size_t i : group) {
+      ws.resetPolyMesh();
+      restoreSpanAreas(*ws.solid, areas);
+      Impl& impl = *impls[i];
+      impl.tileLayout_ = Cr::Containers::NullOpt;
+      if (!buildPolyMesh(ctx, variants[i], cfgs[i], ws)) {
+        continue;
+      }
+      // same as build(), Detour can't take more vertices per polygon
+      if (cfgs[i].maxVertsPerPoly <= DT_VERTS_PER_POLYGON) {
+        unsigned char* navData = 0;
+        int navDataSize = 0;
+        if (!createNavMeshData(variants[i], cfgs[i], ws, 0, 0, navData,
+                               navDataSize) ||
+            !impl.loadSingleTile(navData, navDataSize)) {
+          continue;
+        }
+      }
+      impl.removeZeroAreaPolys();
+      LOG(INFO) << "Created navmesh with " << ws.pmesh->nverts
+                << " vertices " << ws.pmesh->npolys << " polygons";
+      built[i] = true;
+    }
+  }
+  return built;
+}
+
 namespace {
 const int NAVMESHSET_MAGIC = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';  //'MSET';
 const int NAVMESHSET_VERSION = 1;
+// same as above, but each tile header is followed by the compressed size and
+// the tile data is compressed with zlib
+const int NAVMESHSET_VERSION_COMPRESSED = 2;
 
 struct NavMeshSetHeader {
   int magic;
@@ -757,7 +2526,7 @@ void PathFinder::Impl::removeZeroAreaPolys() {
   for (int iTile = 0; iTile < navMesh_->getMaxTiles(); ++iTile) {
     const dtMeshTile* tile =
         const_cast<const dtNavMesh*>(navMesh_.get())->getTile(iTile);
-    if (!tile)
+    if (!tile || !tile->header)
       continue;
 
     // Iterate over all polygons in a tile
@@ -778,7 +2547,32 @@ void PathFinder::Impl::removeZeroAreaPolys() {
   }
 }
 
-bool PathFinder::Impl::loadNavMesh(const std::string& path) {
+namespace {
+// Reads @p dataSize bytes of tile data, stored in @p storedSize bytes if
+// compressed or 0 if not
+bool readTileData(FILE* fp,
+                  unsigned char* data,
+                  int dataSize,
+                  int storedSize) {
+  if (!storedSize) {
+    memset(data, 0, dataSize);
+    return fread(data, dataSize, 1, fp) == 1;
+  }
+
+#ifdef ESP_BUILD_WITH_ZLIB
+  std::vector<unsigned char> stored(storedSize);
+  if (fread(stored.data(), storedSize, 1, fp) != 1)
+    return false;
+  uLongf size = dataSize;
+  return uncompress(data, &size, stored.data(), storedSize) == Z_OK &&
+         size == uLongf(dataSize);
+#else
+  return false;
+#endif
+}
+}  // namespace
+
+bool PathFinder::Impl::loadNavMesh(const std::string& path, bool mapFile) {
   FILE* fp = fopen(path.c_str(), "rb");
   if (!fp)
     return false;
@@ -794,14 +2588,31 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     fclose(fp);
     return false;
   }
-  if (header.version != NAVMESHSET_VERSION) {
+  if (header.version != NAVMESHSET_VERSION &&
+      header.version != NAVMESHSET_VERSION_COMPRESSED) {
+    fclose(fp);
+    return false;
+  }
+  const bool compressed = header.version == NAVMESHSET_VERSION_COMPRESSED;
+#ifndef ESP_BUILD_WITH_ZLIB
+  if (compressed) {
+    LOG(ERROR) << "PathFinder::loadNavMesh(): " << path
+               << " is compressed, but zlib support is not compiled in";
     fclose(fp);
     return false;
   }
+#endif
+
+  // Uncompressed tiles are used right from the file mapping instead of a
+  // copy, falling back to reading them if mapping fails
+  std::unique_ptr<impl::MappedFile> mappedFile;
+  if (mapFile && !compressed) {
+    mappedFile = impl::MappedFile::map(path);
+  }
 
   vec3f bmin, bmax;
 
-  dtNavMesh* mesh = dtAllocNavMesh();
+  std::unique_ptr<dtNavMesh, NavMeshDeleter> mesh{dtAllocNavMesh()};
   if (!mesh) {
     fclose(fp);
     return false;
@@ -816,6 +2627,10 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
   for (int i = 0; i < header.numTiles; ++i) {
     NavMeshTileHeader tileHeader;
     readLen = fread(&tileHeader, sizeof(tileHeader), 1, fp);
+    int storedSize = 0;
+    if (readLen == 1 && compressed) {
+      readLen = fread(&storedSize, sizeof(storedSize), 1, fp);
+    }
     if (readLen != 1) {
       fclose(fp);
       return false;
@@ -824,20 +2639,38 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     if (!tileHeader.tileRef || !tileHeader.dataSize)
       break;
 
-    unsigned char* data = static_cast<unsigned char*>(
-        dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM));
-    if (!data)
-      break;
-    memset(data, 0, tileHeader.dataSize);
-    readLen = fread(data, tileHeader.dataSize, 1, fp);
-    if (readLen != 1) {
-      dtFree(data);
+    // Detour needs the tile data four-byte aligned, which it always is in
+    // files written by saveNavMesh()
+    unsigned char* data = nullptr;
+    int flags = DT_TILE_FREE_DATA;
+    const long offset = ftell(fp);
+    if (mappedFile && offset % 4 == 0 &&
+        std::size_t(offset) + tileHeader.dataSize <= mappedFile->size()) {
+      data = mappedFile->data() + offset;
+      flags = 0;
+      if (fseek(fp, tileHeader.dataSize, SEEK_CUR) != 0) {
+        fclose(fp);
+        return false;
+      }
+    } else {
+      data = static_cast<unsigned char*>(
+          dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM));
+      if (!data)
+        break;
+      if (!readTileData(fp, data, tileHeader.dataSize, storedSize)) {
+        dtFree(data);
+        fclose(fp);
+        return false;
+      }
+    }
+
+    if (dtStatusFailed(mesh->addTile(data, tileHeader.dataSize, flags,
+                                     tileHeader.tileRef, 0))) {
+      if (flags & DT_TILE_FREE_DATA)
+        dtFree(data);
       fclose(fp);
       return false;
     }
-
-    mesh->addTile(data, tileHeader.dataSize, DT_TILE_FREE_DATA,
-                  tileHeader.tileRef, 0);
     const dtMeshTile* tile = mesh->getTileByRef(tileHeader.tileRef);
     if (i == 0) {
       bmin = vec3f(tile->header->bmin);
@@ -848,81 +2681,278 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     }
   }
 
+  // Optional obstacle distance field saved after the tiles, older files and
+  // readers don't know about it
+  Cr::Containers::Optional<impl::ObstacleDistanceField> obstacleField =
+      impl::ObstacleDistanceField::read(fp);
+
   fclose(fp);
 
-  navMesh_.reset(mesh);
+  navMesh_ = std::move(mesh);
+  mappedFile_ = std::move(mappedFile);
+  tileLayout_ = Cr::Containers::NullOpt;
   bounds_ = std::make_pair(bmin, bmax);
 
   removeZeroAreaPolys();
 
-  return initNavQuery();
+  if (!initNavQuery())
+    return false;
+
+  if (obstacleField) {
+    obstacleFieldCellSize_ = obstacleField->cellSize;
+    obstacleFieldRadius_ = obstacleField->maxSearchRadius;
+    std::atomic_store(&obstacleField_,
+                      std::shared_ptr<const impl::ObstacleDistanceField>{
+                          std::make_shared<impl::ObstacleDistanceField>(
+                              std::move(*obstacleField))});
+  }
+  return true;
 }
 
-bool PathFinder::Impl::saveNavMesh(const std::string& path) {
+bool PathFinder::Impl::saveNavMesh(const std::string& path, bool compress) {
   const dtNavMesh* navMesh = navMesh_.get();
   if (!navMesh)
     return false;
-
-  FILE* fp = fopen(path.c_str(), "wb");
-  if (!fp)
+#ifndef ESP_BUILD_WITH_ZLIB
+  if (compress) {
+    LOG(ERROR) << "PathFinder::saveNavMesh(): zlib support is not compiled in";
     return false;
-
-  // Store header.
-  NavMeshSetHeader header;
-  header.magic = NAVMESHSET_MAGIC;
-  header.version = NAVMESHSET_VERSION;
-  header.numTiles = 0;
-  for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
-    const dtMeshTile* tile = navMesh->getTile(i);
-    if (!tile || !tile->header || !tile->dataSize)
-      continue;
-    header.numTiles++;
   }
-  memcpy(&header.params, navMesh->getParams(), sizeof(dtNavMeshParams));
-  fwrite(&header, sizeof(NavMeshSetHeader), 1, fp);
+#endif
+
+  return io::writeFileAtomically(path, [&](FILE* fp) {
+    // Store header.
+    NavMeshSetHeader header;
+    header.magic = NAVMESHSET_MAGIC;
+    header.version =
+        compress ? NAVMESHSET_VERSION_COMPRESSED : NAVMESHSET_VERSION;
+    header.numTiles = 0;
+    for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
+      const dtMeshTile* tile = navMesh->getTile(i);
+      if (!tile || !tile->header || !tile->dataSize)
+        continue;
+      header.numTiles++;
+    }
+    memcpy(&header.params, navMesh->getParams(), sizeof(dtNavMeshParams));
+    fwrite(&header, sizeof(NavMeshSetHeader), 1, fp);
 
-  // Store tiles.
-  for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
-    const dtMeshTile* tile = navMesh->getTile(i);
-    if (!tile || !tile->header || !tile->dataSize)
-      continue;
+    // Store tiles.
+    for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
+      const dtMeshTile* tile = navMesh->getTile(i);
+      if (!tile || !tile->header || !tile->dataSize)
+        continue;
 
-    NavMeshTileHeader tileHeader;
-    tileHeader.tileRef = navMesh->getTileRef(tile);
-    tileHeader.dataSize = tile->dataSize;
-    fwrite(&tileHeader, sizeof(tileHeader), 1, fp);
+      NavMeshTileHeader tileHeader;
+      tileHeader.tileRef = navMesh->getTileRef(tile);
+      tileHeader.dataSize = tile->dataSize;
+      fwrite(&tileHeader, sizeof(tileHeader), 1, fp);
+
+#ifdef ESP_BUILD_WITH_ZLIB
+      if (compress) {
+        std::vector<unsigned char> stored(compressBound(tile->dataSize));
+        uLongf storedSize = stored.size();
+        if (compress2(stored.data(), &storedSize, tile->data, tile->dataSize,
+                      Z_BEST_COMPRESSION) != Z_OK) {
+          return false;
+        }
+        const int size = storedSize;
+        fwrite(&size, sizeof(size), 1, fp);
+        fwrite(stored.data(), storedSize, 1, fp);
+        continue;
+      }
+#endif
+      fwrite(tile->data, tile->dataSize, 1, fp);
+    }
 
-    fwrite(tile->data, tile->dataSize, 1, fp);
-  }
+    if (const auto obstacleField = obstacleDistanceField())
+      obstacleField->write(fp);
+    return true;
+  });
+}
 
-  fclose(fp);
+void PathFinder::Impl::seed(uint32_t newSeed) {
+  random_.seed(newSeed);
+}
 
-  return true;
+namespace {
+// dtNavMeshQuery::findRandomPoint() takes a plain function pointer, so the
+// generator of the calling pathfinder is passed through this
+thread_local core::Random* currentRandom = nullptr;
+
+// Returns a random number [0..1)
+float frand() {
+  return currentRandom->uniform_float_01();
 }
 
-void PathFinder::Impl::seed(uint32_t newSeed) {
-  // TODO: this should be using core::Random instead, but passing function
-  // to navQuery_->findRandomPoint needs to be figured out first
-  srand(newSeed);
+int workerCount() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
 }
 
-// Returns a random number [0..1]
-static float frand() {
-  return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+// Uniform point on the polygon plane, weighted by the xz area like Detour
+// does
+vec3f randomPointInPoly(const dtMeshTile* tile,
+                        const dtPoly* poly,
+                        float s,
+                        float t) {
+  float verts[3 * DT_VERTS_PER_POLYGON];
+  float areas[DT_VERTS_PER_POLYGON];
+  for (int j = 0; j < poly->vertCount; ++j) {
+    dtVcopy(&verts[j * 3], &tile->verts[poly->verts[j] * 3]);
+  }
+  vec3f pt;
+  dtRandomPointInConvexPoly(verts, poly->vertCount, areas, s, t, pt.data());
+  return pt;
 }
 
-vec3f PathFinder::Impl::getRandomNavigablePoint() {
+// Lowest and highest detail mesh vertex of a polygon
+std::pair<float, float> polyHeightRange(const dtNavMesh& navMesh,
+                                        dtPolyRef ref) {
+  const dtMeshTile* tile = nullptr;
+  const dtPoly* poly = nullptr;
+  navMesh.getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+  const unsigned int iPoly = navMesh.decodePolyIdPoly(ref);
+
+  std::pair<float, float> range{std::numeric_limits<float>::infinity(),
+                                -std::numeric_limits<float>::infinity()};
+  const auto extend = [&range](const float* v) {
+    range.first = std::min(range.first, v[1]);
+    range.second = std::max(range.second, v[1]);
+  };
+  for (int j = 0; j < poly->vertCount; ++j) {
+    extend(&tile->verts[poly->verts[j] * 3]);
+  }
+  const dtPolyDetail& detail = tile->detailMeshes[iPoly];
+  for (int j = 0; j < detail.vertCount; ++j) {
+    extend(&tile->detailVerts[(detail.vertBase + j) * 3]);
+  }
+  return range;
+}
+}  // namespace
+
+vec3f PathFinder::Impl::getRandomNavigablePoint(float minIslandRadius) {
   dtPolyRef ref;
   constexpr float inf = std::numeric_limits<float>::infinity();
   vec3f pt(inf, inf, inf);
+  const PooledQuery query{*this};
+  if (!query) {
+    LOG(ERROR) << "Failed to getRandomNavigablePoint";
+    return pt;
+  }
+
+  // Pick an area-weighted polygon out of the islands large enough directly
+  // instead of retrying random points on the whole navmesh
+  if (minIslandRadius > 0) {
+    ref =
+        islandSystem_->samplePoly(minIslandRadius, random_.uniform_float_01());
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    if (ref == 0 ||
+        dtStatusFailed(navMesh_->getTileAndPolyByRef(ref, &tile, &poly))) {
+      LOG(ERROR) << "Failed to getRandomNavigablePoint: no island with radius "
+                 << minIslandRadius;
+      return pt;
+    }
+
+    const float s = random_.uniform_float_01();
+    const float t = random_.uniform_float_01();
+    pt = randomPointInPoly(tile, poly, s, t);
+    // Lift the point from the polygon plane onto the detail mesh
+    query->closestPointOnPoly(ref, pt.data(), pt.data(), nullptr);
+    return pt;
+  }
+
+  currentRandom = &random_;
   dtStatus status =
-      navQuery_->findRandomPoint(filter_.get(), frand, &ref, pt.data());
+      query->findRandomPoint(filter_.get(), frand, &ref, pt.data());
+  currentRandom = nullptr;
   if (!dtStatusSucceed(status)) {
     LOG(ERROR) << "Failed to getRandomNavigablePoint";
   }
   return pt;
 }
 
+std::vector<vec3f> PathFinder::Impl::getRandomNavigablePoints(
+    size_t count,
+    uint32_t seed,
+    const RandomPointConstraints& constraints) const {
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  std::vector<vec3f> points(count, vec3f(inf, inf, inf));
+  if (!navMesh_ || !islandSystem_ || count == 0) {
+    return points;
+  }
+
+  // Cumulative area of the polygons that can contain a point in the height
+  // band, built once for the whole batch
+  const bool heightBand =
+      constraints.minHeight > -inf || constraints.maxHeight < inf;
+  std::vector<dtPolyRef> refs;
+  std::vector<float> cumulativeArea;
+  float totalArea = 0.0f;
+  const size_t polyCount =
+      islandSystem_->sampleCount(constraints.minIslandRadius);
+  for (size_t i = 0; i < polyCount; ++i) {
+    const float area = islandSystem_->sampleArea(i);
+    const dtPolyRef ref = islandSystem_->sampleRef(i);
+    if (area <= 0.0f)
+      continue;
+    if (heightBand) {
+      const std::pair<float, float> range = polyHeightRange(*navMesh_, ref);
+      if (range.second < constraints.minHeight ||
+          range.first > constraints.maxHeight)
+        continue;
+    }
+    totalArea += area;
+    refs.push_back(ref);
+    cumulativeArea.push_back(totalArea);
+  }
+  if (refs.empty()) {
+    LOG(ERROR) << "Failed to getRandomNavigablePoints: no polygon satisfies "
+                  "the constraints";
+    return points;
+  }
+
+  // Polygons only partially inside the height band need rejection, give up
+  // on a point after this many tries
+  constexpr int maxAttempts = 64;
+  const int pointCount = count;
+#pragma omp parallel num_threads(workerCount())
+  {
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 256)
+    for (int i = 0; i < pointCount; ++i) {
+      if (!query)
+        continue;
+      // One stream per point instead of per worker, so the output doesn't
+      // depend on the thread count or on how the points are scheduled
+      core::CounterRandom random{seed, uint64_t(i)};
+      for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        const float target = random.uniform_float_01() * totalArea;
+        const size_t j = std::min<size_t>(
+            std::upper_bound(cumulativeArea.begin(), cumulativeArea.end(),
+                             target) -
+                cumulativeArea.begin(),
+            refs.size() - 1);
+        const dtMeshTile* tile = nullptr;
+        const dtPoly* poly = nullptr;
+        navMesh_->getTileAndPolyByRefUnsafe(refs[j], &tile, &poly);
+        const float s = random.uniform_float_01();
+        const float t = random.uniform_float_01();
+        vec3f pt = randomPointInPoly(tile, poly, s, t);
+        query->closestPointOnPoly(refs[j], pt.data(), pt.data(), nullptr);
+        if (pt[1] >= constraints.minHeight && pt[1] <= constraints.maxHeight) {
+          points[i] = pt;
+          break;
+        }
+      }
+    }
+  }
+  return points;
+}
+
 namespace {
 float pathLength(const std::vector<vec3f>& points) {
   CORRADE_INTERNAL_ASSERT(points.size() > 0);
@@ -939,19 +2969,56 @@ float pathLength(const std::vector<vec3f>& points) {
 }  // namespace
 
 bool PathFinder::Impl::findPath(ShortestPath& path) {
+  const PooledQuery query{*this};
+  if (!query) {
+    path.geodesicDistance = std::numeric_limits<float>::infinity();
+    path.points.clear();
+    return false;
+  }
+  return findPath(path, query.get());
+}
+
+bool PathFinder::Impl::findPath(ShortestPath& path, dtNavMeshQuery* query) {
+  ESP_PROFILE_SCOPE("PathFinder::findPath");
   MultiGoalShortestPath tmp;
   tmp.requestedStart = path.requestedStart;
   tmp.setRequestedEnds({path.requestedEnd});
 
-  bool status = findPath(tmp);
+  Cr::Containers::Optional<impl::PathCache::Key> cacheKey;
+  if (pathCache_.enabled()) {
+    dtStatus startStatus, endStatus;
+    dtPolyRef startRef, endRef;
+    vec3f pathEnd;
+    std::tie(startStatus, startRef, std::ignore) =
+        projectToPoly(path.requestedStart, query, filter_.get());
+    std::tie(endStatus, endRef, pathEnd) =
+        projectToPoly(path.requestedEnd, query, filter_.get());
+    if (startStatus == DT_SUCCESS && startRef != 0 &&
+        endStatus == DT_SUCCESS && endRef != 0) {
+      cacheKey = pathCache_.key(startRef, path.requestedStart, endRef,
+                                path.requestedEnd);
+      if (pathCache_.find(*cacheKey, path.geodesicDistance, path.points)) {
+        return path.geodesicDistance < std::numeric_limits<float>::infinity();
+      }
+      // the end is projected already
+      tmp.pimpl_->endRefs.push_back(endRef);
+      tmp.pimpl_->pathEnds.push_back(pathEnd);
+    }
+  }
+
+  bool status = findPath(tmp, query);
 
   path.geodesicDistance = tmp.geodesicDistance;
   path.points = std::move(tmp.points);
+  if (cacheKey) {
+    pathCache_.insert(*cacheKey, path.geodesicDistance, path.points);
+  }
   return status;
 }
 
 Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-PathFinder::Impl::findPathInternal(const vec3f& start,
+PathFinder::Impl::findPathInternal(dtNavMeshQuery* query,
+                                   const vec3f& start,
                                    dtPolyRef startRef,
                                    const vec3f& pathStart,
                                    const vec3f& end,
@@ -967,22 +3034,37 @@ PathFinder::Impl::findPathInternal(const vec3f& start,
     return Cr::Containers::NullOpt;
   }
 
+  // long paths go through the cluster graph, falling back to a search of the
+  // whole navmesh if that fails
+  if (clusterGraph_ &&
+      (pathEnd - pathStart).norm() >= hierarchicalMinDistance_) {
+    auto result = findPathHierarchical(query, start, startRef, pathStart, end,
+                                       endRef, pathEnd);
+    if (result) {
+      return result;
+    }
+  }
+
   static const int MAX_POLYS = 256;
   dtPolyRef polys[MAX_POLYS];
 
   int numPolys = 0;
   dtStatus status =
-      navQuery_->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
-                          filter_.get(), polys, &numPolys, MAX_POLYS);
+      query->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
+                      filter_.get(), polys, &numPolys, MAX_POLYS);
+  // the node pool holds the nodes the A* search expanded
+  static core::Metrics::Histogram& expandedNodes =
+      core::Metrics::histogram("nav.astar_expanded_nodes");
+  expandedNodes.record(query->getNodePool()->getNodeCount());
   if (status != DT_SUCCESS || numPolys == 0) {
     return Cr::Containers::NullOpt;
   }
 
   int numPoints = 0;
   std::vector<vec3f> points(MAX_POLYS);
-  status = navQuery_->findStraightPath(start.data(), end.data(), polys,
-                                       numPolys, points[0].data(), 0, 0,
-                                       &numPoints, MAX_POLYS);
+  status = query->findStraightPath(start.data(), end.data(), polys, numPolys,
+                                   points[0].data(), 0, 0, &numPoints,
+                                   MAX_POLYS);
   if (status != DT_SUCCESS || numPoints == 0) {
     return Corrade::Containers::NullOpt;
   }
@@ -994,7 +3076,160 @@ PathFinder::Impl::findPathInternal(const vec3f& start,
   return std::make_tuple(length, std::move(points));
 }
 
-bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
+Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+PathFinder::Impl::findPathHierarchical(dtNavMeshQuery* query,
+                                       const vec3f& start,
+                                       dtPolyRef startRef,
+                                       const vec3f& pathStart,
+                                       const vec3f& end,
+                                       dtPolyRef endRef,
+                                       const vec3f& pathEnd) {
+  std::vector<impl::ClusterGraph::Waypoint> waypoints;
+  if (!clusterGraph_->findWaypoints(startRef, pathStart, endRef, pathEnd,
+                                    waypoints)) {
+    return Cr::Containers::NullOpt;
+  }
+
+  // each part ends on the near side of a portal, the next one starts on the
+  // far side. Loops where a part doubles back over the previous one are cut
+  // out of the corridor.
+  static const int MAX_POLYS = 256;
+  dtPolyRef polys[MAX_POLYS];
+  std::vector<dtPolyRef> corridor;
+  std::unordered_map<dtPolyRef, size_t> corridorIndex;
+  dtPolyRef fromRef = startRef;
+  vec3f fromPos = pathStart;
+  for (size_t i = 0; i <= waypoints.size(); ++i) {
+    dtPolyRef toRef = endRef;
+    dtPolyRef nextRef = 0;
+    vec3f toPos = pathEnd;
+    if (i != waypoints.size()) {
+      const impl::ClusterGraph::Portal& portal =
+          clusterGraph_->portal(waypoints[i].first);
+      const int side = portal.clusters[0] == waypoints[i].second ? 0 : 1;
+      toRef = portal.refs[side];
+      nextRef = portal.refs[1 - side];
+      toPos = portal.pos;
+    }
+
+    int numPolys = 0;
+    const dtStatus status =
+        query->findPath(fromRef, toRef, fromPos.data(), toPos.data(),
+                        filter_.get(), polys, &numPolys, MAX_POLYS);
+    if (status != DT_SUCCESS || numPolys == 0 || polys[numPolys - 1] != toRef)
+      return Cr::Containers::NullOpt;
+
+    for (int j = 0; j < numPolys; ++j) {
+      auto found = corridorIndex.find(polys[j]);
+      if (found != corridorIndex.end()) {
+        for (size_t k = found->second + 1; k < corridor.size(); ++k) {
+          corridorIndex.erase(corridor[k]);
+        }
+        corridor.resize(found->second + 1);
+        continue;
+      }
+      corridorIndex.emplace(polys[j], corridor.size());
+      corridor.push_back(polys[j]);
+    }
+    fromRef = nextRef;
+    fromPos = toPos;
+  }
+
+  int numPoints = 0;
+  const int maxPoints = corridor.size() + 2;
+  std::vector<vec3f> points(maxPoints);
+  const dtStatus status = query->findStraightPath(
+      start.data(), end.data(), corridor.data(), corridor.size(),
+      points[0].data(), 0, 0, &numPoints, maxPoints);
+  if (status != DT_SUCCESS || numPoints == 0) {
+    return Cr::Containers::NullOpt;
+  }
+  points.resize(numPoints);
+
+  static core::Metrics::Counter& hierarchicalPaths =
+      core::Metrics::counter("nav.hierarchical_paths");
+  hierarchicalPaths.add();
+  const float length = pathLength(points);
+  return std::make_tuple(length, std::move(points));
+}
+
+int PathFinder::Impl::findNearestEnd(const MultiGoalShortestPath& path,
+                                     dtPolyRef startRef,
+                                     const vec3f& pathStart) const {
+  // the first end is enough for polygons containing several
+  std::unordered_map<dtPolyRef, int> endPolys;
+  for (size_t i = 0; i < path.pimpl_->endRefs.size(); ++i) {
+    if (islandSystem_->hasConnection(startRef, path.pimpl_->endRefs[i])) {
+      endPolys.emplace(path.pimpl_->endRefs[i], i);
+    }
+  }
+  if (endPolys.empty()) {
+    return -1;
+  }
+
+  struct Node {
+    float cost;
+    vec3f pos;
+    bool closed;
+  };
+  std::unordered_map<dtPolyRef, Node> nodes;
+  using Entry = std::pair<float, dtPolyRef>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  nodes.emplace(startRef, Node{0.0f, pathStart, false});
+  open.emplace(0.0f, startRef);
+
+  while (!open.empty()) {
+    const dtPolyRef ref = open.top().second;
+    open.pop();
+    Node& node = nodes[ref];
+    if (node.closed)
+      continue;
+    node.closed = true;
+
+    auto end = endPolys.find(ref);
+    if (end != endPolys.end()) {
+      return end->second;
+    }
+
+    const dtMeshTile* tile = 0;
+    const dtPoly* poly = 0;
+    navMesh_->getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+    const vec3f pos = node.pos;
+    const float cost = node.cost;
+    for (unsigned int iLink = poly->firstLink; iLink != DT_NULL_LINK;
+         iLink = tile->links[iLink].next) {
+      const dtLink& link = tile->links[iLink];
+      const dtMeshTile* neighbourTile = 0;
+      const dtPoly* neighbourPoly = 0;
+      navMesh_->getTileAndPolyByRefUnsafe(link.ref, &neighbourTile,
+                                          &neighbourPoly);
+      if (!filter_->passFilter(link.ref, neighbourTile, neighbourPoly))
+        continue;
+
+      const Eigen::Map<const vec3f> a{
+          &tile->verts[poly->verts[link.edge] * 3]};
+      const Eigen::Map<const vec3f> b{
+          &tile->verts[poly->verts[(link.edge + 1) % poly->vertCount] * 3]};
+      const vec3f neighbourPos = 0.5f * (a + b);
+      const float neighbourCost = cost + (neighbourPos - pos).norm();
+
+      auto inserted =
+          nodes.emplace(link.ref, Node{neighbourCost, neighbourPos, false});
+      Node& neighbour = inserted.first->second;
+      if (!inserted.second) {
+        if (neighbour.closed || neighbour.cost <= neighbourCost)
+          continue;
+        neighbour = Node{neighbourCost, neighbourPos, false};
+      }
+      open.emplace(neighbourCost, link.ref);
+    }
+  }
+
+  return -1;
+}
+
+bool PathFinder::Impl::findPathSetup(dtNavMeshQuery* query,
+                                     MultiGoalShortestPath& path,
                                      dtPolyRef& startRef,
                                      vec3f& pathStart) {
   path.geodesicDistance = std::numeric_limits<float>::infinity();
@@ -1003,7 +3238,7 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
   // find nearest polys and path
   dtStatus status;
   std::tie(status, startRef, pathStart) =
-      projectToPoly(path.requestedStart, navQuery_.get(), filter_.get());
+      projectToPoly(path.requestedStart, query, filter_.get());
 
   if (status != DT_SUCCESS || startRef == 0) {
     return false;
@@ -1016,7 +3251,7 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
     dtPolyRef endRef;
     vec3f pathEnd;
     std::tie(status, endRef, pathEnd) =
-        projectToPoly(rqEnd, navQuery_.get(), filter_.get());
+        projectToPoly(rqEnd, query, filter_.get());
 
     if (status != DT_SUCCESS || endRef == 0) {
       return false;
@@ -1030,9 +3265,21 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
 }
 
 bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
+  const PooledQuery query{*this};
+  if (!query) {
+    path.geodesicDistance = std::numeric_limits<float>::infinity();
+    path.points.clear();
+    return false;
+  }
+  return findPath(path, query.get());
+}
+
+bool PathFinder::Impl::findPath(MultiGoalShortestPath& path,
+                                dtNavMeshQuery* query) {
+  ESP_PROFILE_SCOPE("PathFinder::findPath(multi-goal)");
   dtPolyRef startRef;
   vec3f pathStart;
-  if (!findPathSetup(path, startRef, pathStart))
+  if (!findPathSetup(query, path, startRef, pathStart))
     return false;
 
   if (path.pimpl_->requestedEnds.size() > 1) {
@@ -1043,7 +3290,7 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
     ShortestPath prevPath;
     prevPath.requestedStart = path.requestedStart;
     prevPath.requestedEnd = path.pimpl_->prevRequestedStart;
-    findPath(prevPath);
+    findPath(prevPath, query);
     const float movedAmount = prevPath.geodesicDistance;
 
     for (int i = 0; i < path.pimpl_->requestedEnds.size(); ++i) {
@@ -1055,6 +3302,29 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
     path.pimpl_->prevRequestedStart = path.requestedStart;
   }
 
+  // Ordering by the straight line distance alone does a full path search for
+  // each end that is close by but behind a wall. With many ends, a single
+  // search from the start finds the end that's actually near first, so the
+  // bound below rules out most other ends right away.
+  int nearest = -1;
+  if (path.pimpl_->requestedEnds.size() > 1) {
+    nearest = findNearestEnd(path, startRef, pathStart);
+    if (nearest == -1) {
+      return false;
+    }
+
+    const Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+        findResult = findPathInternal(
+            query, path.requestedStart, startRef, pathStart,
+            path.pimpl_->requestedEnds[nearest], path.pimpl_->endRefs[nearest],
+            path.pimpl_->pathEnds[nearest]);
+    if (findResult) {
+      path.pimpl_->minTheoreticalDist[nearest] = std::get<0>(*findResult);
+      path.geodesicDistance = std::get<0>(*findResult);
+      path.points = std::get<1>(*findResult);
+    }
+  }
+
   // Explore possible goal points by their minimum theoretical distance.
   std::vector<size_t> ordering(path.pimpl_->requestedEnds.size());
   std::iota(ordering.begin(), ordering.end(), 0);
@@ -1065,12 +3335,13 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
             });
 
   for (size_t i : ordering) {
-    if (path.pimpl_->minTheoreticalDist[i] > path.geodesicDistance)
+    if (int(i) == nearest ||
+        path.pimpl_->minTheoreticalDist[i] > path.geodesicDistance)
       continue;
 
     const Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
         findResult =
-            findPathInternal(path.requestedStart, startRef, pathStart,
+            findPathInternal(query, path.requestedStart, startRef, pathStart,
                              path.pimpl_->requestedEnds[i],
                              path.pimpl_->endRefs[i], path.pimpl_->pathEnds[i]);
 
@@ -1084,8 +3355,93 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
   return path.geodesicDistance < std::numeric_limits<float>::infinity();
 }
 
+size_t PathFinder::Impl::findPaths(std::vector<ShortestPath>& paths) {
+  ESP_PROFILE_SCOPE("PathFinder::findPaths");
+  for (ShortestPath& path : paths) {
+    path.geodesicDistance = std::numeric_limits<float>::infinity();
+    path.points.clear();
+  }
+
+  size_t found = 0;
+  const int pathCount = paths.size();
+#pragma omp parallel num_threads(workerCount()) reduction(+ : found)
+  {
+    // one query per worker for the whole batch
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < pathCount; ++i) {
+      if (query && findPath(paths[i], query.get())) {
+        ++found;
+      }
+    }
+  }
+  return found;
+}
+
+void PathFinder::Impl::findGeodesicDistances(
+    Cr::Containers::ArrayView<const vec3f> starts,
+    Cr::Containers::ArrayView<const vec3f> ends,
+    Cr::Containers::ArrayView<float> distances) {
+  CORRADE_ASSERT(starts.size() == ends.size() &&
+                     starts.size() == distances.size(),
+                 "PathFinder::findGeodesicDistances(): expected as many ends "
+                 "and distances as starts", );
+
+  const int pathCount = starts.size();
+#pragma omp parallel num_threads(workerCount())
+  {
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < pathCount; ++i) {
+      ShortestPath path;
+      path.requestedStart = starts[i];
+      path.requestedEnd = ends[i];
+      path.geodesicDistance = std::numeric_limits<float>::infinity();
+      if (query) {
+        findPath(path, query.get());
+      }
+      distances[i] = path.geodesicDistance;
+    }
+  }
+}
+
 template <typename T>
 T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
+  const PooledQuery query{*this};
+  if (!query) {
+    return start;
+  }
+  return tryStep(start, end, allowSliding, query.get());
+}
+
+void PathFinder::Impl::trySteps(Cr::Containers::ArrayView<const vec3f> starts,
+                                Cr::Containers::ArrayView<const vec3f> ends,
+                                Cr::Containers::ArrayView<vec3f> results,
+                                bool allowSliding) {
+  CORRADE_ASSERT(starts.size() == ends.size() &&
+                     starts.size() == results.size(),
+                 "PathFinder::trySteps(): expected as many ends and results "
+                 "as starts", );
+
+  const int stepCount = starts.size();
+#pragma omp parallel num_threads(workerCount())
+  {
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < stepCount; ++i) {
+      results[i] = query ? tryStep(starts[i], ends[i], allowSliding,
+                                   query.get())
+                         : starts[i];
+    }
+  }
+}
+
+template <typename T>
+T PathFinder::Impl::tryStep(const T& start,
+                            const T& end,
+                            bool allowSliding,
+                            dtNavMeshQuery* query) {
+  ESP_PROFILE_SCOPE("PathFinder::tryStep");
   static const int MAX_POLYS = 256;
   dtPolyRef polys[MAX_POLYS];
 
@@ -1093,9 +3449,9 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
   dtPolyRef startRef, endRef;
   vec3f pathStart;
   std::tie(startStatus, startRef, pathStart) =
-      projectToPoly(start, navQuery_.get(), filter_.get());
+      projectToPoly(start, query, filter_.get());
   std::tie(endStatus, endRef, std::ignore) =
-      projectToPoly(end, navQuery_.get(), filter_.get());
+      projectToPoly(end, query, filter_.get());
 
   if (dtStatusFailed(startStatus) || dtStatusFailed(endStatus)) {
     return start;
@@ -1107,9 +3463,9 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
 
   vec3f endPoint;
   int numPolys;
-  navQuery_->moveAlongSurface(startRef, pathStart.data(), end.data(),
-                              filter_.get(), endPoint.data(), polys, &numPolys,
-                              MAX_POLYS, allowSliding);
+  query->moveAlongSurface(startRef, pathStart.data(), end.data(),
+                          filter_.get(), endPoint.data(), polys, &numPolys,
+                          MAX_POLYS, allowSliding);
   // If there isn't any possible path between start and end, just return
   // start, that is cleanest
   if (numPolys == 0) {
@@ -1124,7 +3480,7 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
   // surface at the endPoint and set its height to that.
   // Note, this will never fail as endPoint is always within in the poly
   // polys[numPolys - 1]
-  navQuery_->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
+  query->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
 
   // Hack to deal with infinitely thin walls in recast allowing you to
   // transition between two different connected components
@@ -1132,7 +3488,7 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
   // is in the same connected component as the startRef according to
   // findNearestPoly
   std::tie(std::ignore, endRef, std::ignore) =
-      projectToPoly(endPoint, navQuery_.get(), filter_.get());
+      projectToPoly(endPoint, query, filter_.get());
   if (!this->islandSystem_->hasConnection(startRef, endRef)) {
     // There isn't a connection!  This happens when endPoint is on an edge
     // shared between two different connected components (aka infinitely thin
@@ -1161,10 +3517,39 @@ T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
 
 template <typename T>
 T PathFinder::Impl::snapPoint(const T& pt) {
+  const PooledQuery query{*this};
+  if (!query) {
+    return {NAN, NAN, NAN};
+  }
+  return snapPoint(pt, query.get());
+}
+
+void PathFinder::Impl::snapPoints(
+    Cr::Containers::ArrayView<const vec3f> points,
+    Cr::Containers::ArrayView<vec3f> results) {
+  CORRADE_ASSERT(points.size() == results.size(),
+                 "PathFinder::snapPoints(): expected as many results as "
+                 "points", );
+
+  const int pointCount = points.size();
+#pragma omp parallel num_threads(workerCount())
+  {
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < pointCount; ++i) {
+      results[i] =
+          query ? snapPoint(points[i], query.get()) : vec3f{NAN, NAN, NAN};
+    }
+  }
+}
+
+template <typename T>
+T PathFinder::Impl::snapPoint(const T& pt, dtNavMeshQuery* query) {
+  ESP_PROFILE_SCOPE("PathFinder::snapPoint");
   dtStatus status;
   vec3f projectedPt;
   std::tie(status, std::ignore, projectedPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+      projectToPoly(pt, query, filter_.get());
 
   if (dtStatusSucceed(status)) {
     return T{projectedPt};
@@ -1174,10 +3559,16 @@ T PathFinder::Impl::snapPoint(const T& pt) {
 }
 
 float PathFinder::Impl::islandRadius(const vec3f& pt) const {
+  ESP_PROFILE_SCOPE("PathFinder::islandRadius");
+  const PooledQuery query{*this};
+  if (!query) {
+    return 0.0;
+  }
+
   dtPolyRef ptRef;
   dtStatus status;
   std::tie(status, ptRef, std::ignore) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+      projectToPoly(pt, query.get(), filter_.get());
   if (status != DT_SUCCESS || ptRef == 0) {
     return 0.0;
   } else {
@@ -1194,31 +3585,192 @@ float PathFinder::Impl::distanceToClosestObstacle(
 HitRecord PathFinder::Impl::closestObstacleSurfacePoint(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
+  ESP_PROFILE_SCOPE("PathFinder::closestObstacleSurfacePoint");
+  if (const auto obstacleField = obstacleDistanceField()) {
+    if (const Cr::Containers::Optional<HitRecord> hit =
+            obstacleField->lookup(pt, maxSearchRadius))
+      return *hit;
+  }
+
+  const PooledQuery query{*this};
+  if (!query) {
+    return {vec3f(0, 0, 0), vec3f(0, 0, 0),
+            std::numeric_limits<float>::infinity()};
+  }
+
   dtPolyRef ptRef;
   dtStatus status;
   vec3f polyPt;
   std::tie(status, ptRef, polyPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+      projectToPoly(pt, query.get(), filter_.get());
   if (status != DT_SUCCESS || ptRef == 0) {
     return {vec3f(0, 0, 0), vec3f(0, 0, 0),
             std::numeric_limits<float>::infinity()};
   } else {
     vec3f hitPos, hitNormal;
     float hitDist;
-    navQuery_->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
-                                  filter_.get(), &hitDist, hitPos.data(),
-                                  hitNormal.data());
+    query->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
+                              filter_.get(), &hitDist, hitPos.data(),
+                              hitNormal.data());
     return {hitPos, hitNormal, hitDist};
   }
 }
 
+void PathFinder::Impl::setHierarchicalPathfinding(float clusterSize,
+                                                  float minDistance) {
+  clusterSize_ = std::max(clusterSize, 0.0f);
+  hierarchicalMinDistance_ = minDistance;
+  // paths found before may differ
+  pathCache_.clear();
+  clusterGraph_ = clusterSize_ > 0.0f && navMesh_
+                      ? std::make_unique<impl::ClusterGraph>(
+                            navMesh_.get(), filter_.get(), clusterSize_)
+                      : nullptr;
+}
+
+void PathFinder::Impl::setObstacleDistanceField(float cellSize,
+                                                float maxSearchRadius) {
+  obstacleFieldCellSize_ = std::max(cellSize, 0.0f);
+  obstacleFieldRadius_ = maxSearchRadius;
+  std::atomic_store(&obstacleField_, {});
+}
+
+std::shared_ptr<const impl::ObstacleDistanceField>
+PathFinder::Impl::obstacleDistanceField() const {
+  if (obstacleFieldCellSize_ <= 0.0f || !navMesh_)
+    return nullptr;
+
+  std::shared_ptr<const impl::ObstacleDistanceField> field =
+      std::atomic_load(&obstacleField_);
+  if (field)
+    return field;
+
+  std::lock_guard<std::mutex> lock{obstacleFieldMutex_};
+  // another thread may have built it while we waited
+  field = std::atomic_load(&obstacleField_);
+  if (!field) {
+    field = std::make_shared<impl::ObstacleDistanceField>(
+        buildObstacleDistanceField());
+    std::atomic_store(&obstacleField_, field);
+  }
+  return field;
+}
+
+impl::ObstacleDistanceField PathFinder::Impl::buildObstacleDistanceField()
+    const {
+  impl::ObstacleDistanceField field;
+  field.cellSize = obstacleFieldCellSize_;
+  field.maxSearchRadius = obstacleFieldRadius_;
+  field.originX = bounds_.first[0];
+  field.originZ = bounds_.first[2];
+  field.sizeX =
+      int(std::ceil((bounds_.second[0] - bounds_.first[0]) / field.cellSize)) +
+      1;
+  field.sizeZ =
+      int(std::ceil((bounds_.second[2] - bounds_.first[2]) / field.cellSize)) +
+      1;
+
+  // a thin column through the whole navmesh height at each node
+  const float centerY = 0.5f * (bounds_.first[1] + bounds_.second[1]);
+  const float halfExtents[3] = {
+      1e-3f, 0.5f * (bounds_.second[1] - bounds_.first[1]) + 1.0f, 1e-3f};
+
+  const int nodeCount = field.sizeX * field.sizeZ;
+  std::vector<std::vector<impl::ObstacleDistanceField::Sample>> nodeSamples(
+      nodeCount);
+#pragma omp parallel num_threads(workerCount())
+  {
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 64)
+    for (int node = 0; node < nodeCount; ++node) {
+      if (!query)
+        continue;
+
+      static const int MAX_POLYS = 32;
+      dtPolyRef polys[MAX_POLYS];
+      int polyCount = 0;
+      const float x = field.originX + (node % field.sizeX) * field.cellSize;
+      const float z = field.originZ + (node / field.sizeX) * field.cellSize;
+      const float center[3] = {x, centerY, z};
+      query->queryPolygons(center, halfExtents, filter_.get(), polys,
+                           &polyCount, MAX_POLYS);
+
+      std::vector<impl::ObstacleDistanceField::Sample>& samples =
+          nodeSamples[node];
+      for (int i = 0; i < polyCount; ++i) {
+        const dtMeshTile* tile = nullptr;
+        const dtPoly* poly = nullptr;
+        navMesh_->getTileAndPolyByRefUnsafe(polys[i], &tile, &poly);
+        float verts[3 * DT_VERTS_PER_POLYGON];
+        for (int j = 0; j < poly->vertCount; ++j) {
+          dtVcopy(&verts[j * 3], &tile->verts[poly->verts[j] * 3]);
+        }
+        float pos[3] = {x, centerY, z};
+        if (!dtPointInPolygon(pos, verts, poly->vertCount) ||
+            dtStatusFailed(query->getPolyHeight(polys[i], pos, &pos[1])))
+          continue;
+
+        // polygons meeting at the node give the same layer several times
+        if (std::any_of(samples.begin(), samples.end(),
+                        [&](const impl::ObstacleDistanceField::Sample& s) {
+                          return std::abs(s.height - pos[1]) < 1e-2f;
+                        }))
+          continue;
+
+        impl::ObstacleDistanceField::Sample sample{};
+        sample.height = pos[1];
+        query->findDistanceToWall(polys[i], pos, field.maxSearchRadius,
+                                  filter_.get(), &sample.distance,
+                                  sample.hitPos, sample.hitNormal);
+        samples.push_back(sample);
+      }
+    }
+  }
+
+  field.nodeFirstSample.reserve(nodeCount + 1);
+  field.nodeFirstSample.push_back(0);
+  for (const auto& samples : nodeSamples) {
+    field.samples.insert(field.samples.end(), samples.begin(), samples.end());
+    field.nodeFirstSample.push_back(field.samples.size());
+  }
+  return field;
+}
+
 bool PathFinder::Impl::isNavigable(const vec3f& pt,
                                    const float maxYDelta /*= 0.5*/) const {
+  const PooledQuery query{*this};
+  if (!query) {
+    return false;
+  }
+  return isNavigable(pt, maxYDelta, query.get());
+}
+
+void PathFinder::Impl::areNavigable(
+    Cr::Containers::ArrayView<const vec3f> points,
+    Cr::Containers::ArrayView<bool> results,
+    const float maxYDelta) const {
+  CORRADE_ASSERT(points.size() == results.size(),
+                 "PathFinder::areNavigable(): expected as many results as "
+                 "points", );
+
+  const int pointCount = points.size();
+#pragma omp parallel num_threads(workerCount())
+  {
+    const PooledQuery query{*this};
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < pointCount; ++i) {
+      results[i] = query && isNavigable(points[i], maxYDelta, query.get());
+    }
+  }
+}
+
+bool PathFinder::Impl::isNavigable(const vec3f& pt,
+                                   const float maxYDelta,
+                                   dtNavMeshQuery* query) const {
   dtPolyRef ptRef;
   dtStatus status;
   vec3f polyPt;
-  std::tie(status, ptRef, polyPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
+  std::tie(status, ptRef, polyPt) = projectToPoly(pt, query, filter_.get());
 
   if (status != DT_SUCCESS || ptRef == 0)
     return false;
@@ -1231,11 +3783,186 @@ bool PathFinder::Impl::isNavigable(const vec3f& pt,
   return true;
 }
 
+std::shared_ptr<const impl::VertexGraph> PathFinder::Impl::vertexGraph()
+    const {
+  std::shared_ptr<const impl::VertexGraph> graph =
+      std::atomic_load(&vertexGraph_);
+  if (graph)
+    return graph;
+
+  std::lock_guard<std::mutex> lock{vertexGraphMutex_};
+  // another thread may have built it while we waited
+  graph = std::atomic_load(&vertexGraph_);
+  if (!graph) {
+    graph = std::make_shared<impl::VertexGraph>(buildVertexGraph());
+    std::atomic_store(&vertexGraph_, graph);
+  }
+  return graph;
+}
+
+impl::VertexGraph PathFinder::Impl::buildVertexGraph() const {
+  impl::VertexGraph graph;
+  // Vertices shared between polygons of different tiles are duplicated in
+  // each tile, merge them by position.
+  std::map<std::tuple<float, float, float>, uint32_t> vertexIds;
+  const dtNavMesh* navMesh = navMesh_.get();
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(iTile, tile->salt, jPoly);
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+          !filter_->passFilter(ref, tile, poly))
+        continue;
+
+      const uint32_t first = graph.polyVertices.size();
+      for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+        const float* v = &tile->verts[poly->verts[iVert] * 3];
+        auto inserted = vertexIds.emplace(std::make_tuple(v[0], v[1], v[2]),
+                                          graph.vertices.size());
+        if (inserted.second) {
+          graph.vertices.emplace_back(v[0], v[1], v[2]);
+          graph.edges.emplace_back();
+        }
+        const uint32_t id = inserted.first->second;
+        for (uint32_t i = first; i < graph.polyVertices.size(); ++i) {
+          const uint32_t other = graph.polyVertices[i];
+          const float length =
+              (graph.vertices[id] - graph.vertices[other]).norm();
+          graph.edges[id].emplace_back(other, length);
+          graph.edges[other].emplace_back(id, length);
+        }
+        graph.polyVertices.push_back(id);
+      }
+      graph.polys.emplace(
+          ref, impl::VertexGraph::PolyRange{
+                   first, uint32_t(graph.polyVertices.size() - first)});
+    }
+  }
+  return graph;
+}
+
+void PathFinder::Impl::buildDistanceField(GeodesicDistanceField::Impl& field,
+                                          dtNavMeshQuery* query) const {
+  field.navMeshVersion = navMeshVersion_;
+  field.graph = vertexGraph();
+  field.polyGoals.clear();
+
+  // Seed with the straight line distance from each goal to the vertices of
+  // its polygon, goals off the navmesh are ignored
+  std::vector<std::pair<dtPolyRef, vec3f>> sources;
+  for (const vec3f& goal : field.goals) {
+    dtStatus status;
+    dtPolyRef goalRef;
+    vec3f goalPt;
+    std::tie(status, goalRef, goalPt) =
+        projectToPoly(goal, query, filter_.get());
+    if (status != DT_SUCCESS || !field.graph->polys.count(goalRef))
+      continue;
+
+    field.polyGoals.emplace(goalRef, goalPt);
+    sources.emplace_back(goalRef, goalPt);
+  }
+  field.graph->sweep(sources, field.vertexDistances);
+}
+
+float PathFinder::Impl::geodesicDistance(GeodesicDistanceField& field,
+                                         const vec3f& pt) {
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  const PooledQuery query{*this};
+  if (!query) {
+    return inf;
+  }
+
+  GeodesicDistanceField::Impl& impl = *field.pimpl_;
+  if (impl.navMeshVersion != navMeshVersion_) {
+    buildDistanceField(impl, query.get());
+  }
+
+  dtStatus status;
+  dtPolyRef ref;
+  vec3f polyPt;
+  std::tie(status, ref, polyPt) = projectToPoly(pt, query.get(), filter_.get());
+  if (status != DT_SUCCESS) {
+    return inf;
+  }
+
+  float dist = impl.graph->distance(impl.vertexDistances, ref, polyPt);
+  auto goals = impl.polyGoals.equal_range(ref);
+  for (auto it = goals.first; it != goals.second; ++it) {
+    dist = std::min(dist, (it->second - polyPt).norm());
+  }
+  return dist;
+}
+
+void PathFinder::Impl::distanceMatrix(
+    Cr::Containers::ArrayView<const vec3f> points,
+    Cr::Containers::ArrayView<float> distances) {
+  const int pointCount = points.size();
+  CORRADE_ASSERT(distances.size() == points.size() * points.size(),
+                 "PathFinder::distanceMatrix(): expected"
+                     << points.size() * points.size() << "distances but got"
+                     << distances.size(), );
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  std::fill(distances.begin(), distances.end(), inf);
+
+  std::vector<std::pair<dtPolyRef, vec3f>> snapped(pointCount);
+  {
+    const PooledQuery query{*this};
+    if (!query) {
+      return;
+    }
+    for (int i = 0; i < pointCount; ++i) {
+      dtStatus status;
+      std::tie(status, snapped[i].first, snapped[i].second) =
+          projectToPoly(points[i], query.get(), filter_.get());
+      if (status != DT_SUCCESS) {
+        snapped[i].first = 0;
+      }
+    }
+  }
+
+  const std::shared_ptr<const impl::VertexGraph> graph = vertexGraph();
+#pragma omp parallel num_threads(workerCount())
+  {
+    std::vector<float> vertexDistances;
+#pragma omp for schedule(dynamic, 1)
+    for (int i = 0; i < pointCount; ++i) {
+      if (!snapped[i].first || !graph->polys.count(snapped[i].first)) {
+        continue;
+      }
+      graph->sweep({snapped[i]}, vertexDistances);
+      float* row = distances.data() + std::size_t(i) * pointCount;
+      for (int j = 0; j < pointCount; ++j) {
+        if (!snapped[j].first) {
+          continue;
+        }
+        row[j] = graph->distance(vertexDistances, snapped[j].first,
+                                 snapped[j].second);
+        // in the same polygon the straight line is on the navmesh
+        if (snapped[j].first == snapped[i].first) {
+          row[j] = std::min(row[j],
+                            (snapped[j].second - snapped[i].second).norm());
+        }
+      }
+    }
+  }
+}
+
 typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXb;
 
 Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
 PathFinder::Impl::getTopDownView(const float pixelsPerMeter,
                                  const float height) {
+  const std::pair<float, float> key{pixelsPerMeter, height};
+  const auto cached = topDownViewCache_.find(key);
+  if (cached != topDownViewCache_.end()) {
+    return cached->second;
+  }
+
   std::pair<vec3f, vec3f> mapBounds = bounds();
   vec3f bound1 = mapBounds.first;
   vec3f bound2 = mapBounds.second;
@@ -1246,20 +3973,93 @@ PathFinder::Impl::getTopDownView(const float pixelsPerMeter,
   int zResolution = zspan / pixelsPerMeter;
   float startx = fmin(bound1[0], bound2[0]);
   float startz = fmin(bound1[2], bound2[2]);
-  MatrixXb topdownMap(zResolution, xResolution);
+  MatrixXb topdownMap = MatrixXb::Constant(zResolution, xResolution, false);
+
+  // A pixel is navigable if the detail mesh passes below or above it within
+  // the same tolerance isNavigable() uses. Collect the detail triangles
+  // within that height range and bin them by the rows they cover, so the
+  // rows can be scanned in parallel.
+  constexpr float maxYDelta = 0.5;
+  std::vector<Triangle> triangles;
+  std::vector<std::vector<uint32_t>> rowTriangles(zResolution);
+  const dtNavMesh* navMesh = navMesh_.get();
+  for (int iTile = 0; navMesh && iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(iTile, tile->salt, jPoly);
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+          !filter_->passFilter(ref, tile, poly))
+        continue;
+
+      for (Triangle& tri : getPolygonTriangles(poly, tile)) {
+        const float minY = std::min({tri.v[0][1], tri.v[1][1], tri.v[2][1]});
+        const float maxY = std::max({tri.v[0][1], tri.v[1][1], tri.v[2][1]});
+        if (minY > height + maxYDelta || maxY < height - maxYDelta)
+          continue;
+
+        const float minZ = std::min({tri.v[0][2], tri.v[1][2], tri.v[2][2]});
+        const float maxZ = std::max({tri.v[0][2], tri.v[1][2], tri.v[2][2]});
+        const int firstRow =
+            std::max(0, int(std::ceil((minZ - startz) / pixelsPerMeter)));
+        const int lastRow = std::min(
+            zResolution - 1, int(std::floor((maxZ - startz) / pixelsPerMeter)));
+        if (firstRow > lastRow)
+          continue;
+
+        for (int h = firstRow; h <= lastRow; ++h) {
+          rowTriangles[h].push_back(triangles.size());
+        }
+        triangles.emplace_back(std::move(tri));
+      }
+    }
+  }
+
+#pragma omp parallel for schedule(dynamic, 8) num_threads(workerCount())
+  for (int h = 0; h < zResolution; ++h) {
+    const float z = startz + h * pixelsPerMeter;
+    for (const uint32_t t : rowTriangles[h]) {
+      const Triangle& tri = triangles[t];
+
+      // The x range the triangle covers along this row
+      float minX = std::numeric_limits<float>::infinity();
+      float maxX = -minX;
+      for (int e = 0; e < 3; ++e) {
+        const vec3f& a = tri.v[e];
+        const vec3f& b = tri.v[(e + 1) % 3];
+        if (std::min(a[2], b[2]) > z || std::max(a[2], b[2]) < z)
+          continue;
+        if (a[2] == b[2]) {
+          minX = std::min({minX, a[0], b[0]});
+          maxX = std::max({maxX, a[0], b[0]});
+        } else {
+          const float x = a[0] + (z - a[2]) / (b[2] - a[2]) * (b[0] - a[0]);
+          minX = std::min(minX, x);
+          maxX = std::max(maxX, x);
+        }
+      }
+      const int firstCol =
+          std::max(0, int(std::ceil((minX - startx) / pixelsPerMeter)));
+      const int lastCol = std::min(
+          xResolution - 1, int(std::floor((maxX - startx) / pixelsPerMeter)));
 
-  float curz = startz;
-  float curx = startx;
-  for (int h = 0; h < zResolution; h++) {
-    for (int w = 0; w < xResolution; w++) {
-      vec3f point = vec3f(curx, height, curz);
-      topdownMap(h, w) = isNavigable(point, 0.5);
-      curx = curx + pixelsPerMeter;
+      for (int w = firstCol; w <= lastCol; ++w) {
+        if (topdownMap(h, w))
+          continue;
+        const float pt[3] = {startx + w * pixelsPerMeter, height, z};
+        float y;
+        if (dtClosestHeightPointTriangle(pt, tri.v[0].data(), tri.v[1].data(),
+                                         tri.v[2].data(), y) &&
+            std::abs(y - height) <= maxYDelta)
+          topdownMap(h, w) = true;
+      }
     }
-    curz = curz + pixelsPerMeter;
-    curx = startx;
   }
 
+  topDownViewCache_.emplace(key, topdownMap);
   return topdownMap;
 }
 
@@ -1273,7 +4073,7 @@ const assets::MeshData::ptr PathFinder::Impl::getNavMeshData() {
     for (int iTile = 0; iTile < navMesh_->getMaxTiles(); ++iTile) {
       const dtMeshTile* tile =
           const_cast<const dtNavMesh*>(navMesh_.get())->getTile(iTile);
-      if (!tile)
+      if (!tile || !tile->header)
         continue;
 
       // Iterate over all polygons in a tile
@@ -1317,8 +4117,40 @@ bool PathFinder::build(const NavMeshSettings& bs,
   return pimpl_->build(bs, mesh);
 }
 
-vec3f PathFinder::getRandomNavigablePoint() {
-  return pimpl_->getRandomNavigablePoint();
+std::vector<PathFinder::ptr> PathFinder::buildVariants(
+    const std::vector<NavMeshSettings>& variants,
+    const esp::assets::MeshData& mesh) {
+  std::vector<PathFinder::ptr> pathFinders;
+  std::vector<Impl*> impls;
+  for (size_t i = 0; i < variants.size(); ++i) {
+    pathFinders.push_back(PathFinder::create());
+    impls.push_back(pathFinders.back()->pimpl_.get());
+  }
+  const std::vector<bool> built = Impl::buildVariants(variants, impls, mesh);
+  for (size_t i = 0; i < variants.size(); ++i) {
+    if (!built[i]) {
+      pathFinders[i] = nullptr;
+    }
+  }
+  return pathFinders;
+}
+
+bool PathFinder::rebuildTiles(
+    const NavMeshSettings& bs,
+    const esp::assets::MeshData& mesh,
+    const std::vector<std::pair<vec3f, vec3f>>& regions) {
+  return pimpl_->rebuildTiles(bs, mesh, regions);
+}
+
+vec3f PathFinder::getRandomNavigablePoint(float minIslandRadius) {
+  return pimpl_->getRandomNavigablePoint(minIslandRadius);
+}
+
+std::vector<vec3f> PathFinder::getRandomNavigablePoints(
+    size_t count,
+    uint32_t seed,
+    const RandomPointConstraints& constraints) const {
+  return pimpl_->getRandomNavigablePoints(count, seed, constraints);
 }
 
 bool PathFinder::findPath(ShortestPath& path) {
@@ -1329,6 +4161,27 @@ bool PathFinder::findPath(MultiGoalShortestPath& path) {
   return pimpl_->findPath(path);
 }
 
+size_t PathFinder::findPaths(std::vector<ShortestPath>& paths) {
+  return pimpl_->findPaths(paths);
+}
+
+void PathFinder::findGeodesicDistances(
+    Cr::Containers::ArrayView<const vec3f> starts,
+    Cr::Containers::ArrayView<const vec3f> ends,
+    Cr::Containers::ArrayView<float> distances) {
+  pimpl_->findGeodesicDistances(starts, ends, distances);
+}
+
+float PathFinder::geodesicDistance(GeodesicDistanceField& field,
+                                   const vec3f& pt) {
+  return pimpl_->geodesicDistance(field, pt);
+}
+
+void PathFinder::distanceMatrix(Cr::Containers::ArrayView<const vec3f> points,
+                                Cr::Containers::ArrayView<float> distances) {
+  pimpl_->distanceMatrix(points, distances);
+}
+
 template vec3f PathFinder::tryStep<vec3f>(const vec3f&, const vec3f&);
 template Mn::Vector3 PathFinder::tryStep<Mn::Vector3>(const Mn::Vector3&,
                                                       const Mn::Vector3&);
@@ -1348,6 +4201,19 @@ T PathFinder::tryStepNoSliding(const T& start, const T& end) {
   return pimpl_->tryStep(start, end, /*allowSliding=*/false);
 }
 
+void PathFinder::trySteps(Cr::Containers::ArrayView<const vec3f> starts,
+                          Cr::Containers::ArrayView<const vec3f> ends,
+                          Cr::Containers::ArrayView<vec3f> results) {
+  pimpl_->trySteps(starts, ends, results, /*allowSliding=*/true);
+}
+
+void PathFinder::tryStepsNoSliding(
+    Cr::Containers::ArrayView<const vec3f> starts,
+    Cr::Containers::ArrayView<const vec3f> ends,
+    Cr::Containers::ArrayView<vec3f> results) {
+  pimpl_->trySteps(starts, ends, results, /*allowSliding=*/false);
+}
+
 template vec3f PathFinder::snapPoint<vec3f>(const vec3f& pt);
 template Mn::Vector3 PathFinder::snapPoint<Mn::Vector3>(const Mn::Vector3& pt);
 
@@ -1356,22 +4222,39 @@ T PathFinder::snapPoint(const T& pt) {
   return pimpl_->snapPoint(pt);
 }
 
-bool PathFinder::loadNavMesh(const std::string& path) {
-  return pimpl_->loadNavMesh(path);
+void PathFinder::snapPoints(Cr::Containers::ArrayView<const vec3f> points,
+                            Cr::Containers::ArrayView<vec3f> results) {
+  pimpl_->snapPoints(points, results);
+}
+
+bool PathFinder::loadNavMesh(const std::string& path, bool mapFile) {
+  return pimpl_->loadNavMesh(path, mapFile);
 }
 
-bool PathFinder::saveNavMesh(const std::string& path) {
-  return pimpl_->saveNavMesh(path);
+bool PathFinder::saveNavMesh(const std::string& path, bool compress) {
+  return pimpl_->saveNavMesh(path, compress);
 }
 
 bool PathFinder::isLoaded() const {
   return pimpl_->isLoaded();
 }
 
+uint64_t PathFinder::navMeshVersion() const {
+  return pimpl_->navMeshVersion();
+}
+
 void PathFinder::seed(uint32_t newSeed) {
   return pimpl_->seed(newSeed);
 }
 
+core::Random PathFinder::randomState() const {
+  return pimpl_->randomState();
+}
+
+void PathFinder::setRandomState(const core::Random& state) {
+  pimpl_->setRandomState(state);
+}
+
 float PathFinder::islandRadius(const vec3f& pt) const {
   return pimpl_->islandRadius(pt);
 }
@@ -1387,10 +4270,42 @@ HitRecord PathFinder::closestObstacleSurfacePoint(
   return pimpl_->closestObstacleSurfacePoint(pt, maxSearchRadius);
 }
 
+void PathFinder::setPathCache(std::size_t capacity, float quantization) {
+  pimpl_->setPathCache(capacity, quantization);
+}
+
+PathCacheStatistics PathFinder::pathCacheStatistics() const {
+  return pimpl_->pathCacheStatistics();
+}
+
+void PathFinder::setObstacleDistanceField(float cellSize,
+                                          float maxSearchRadius) {
+  pimpl_->setObstacleDistanceField(cellSize, maxSearchRadius);
+}
+
+float PathFinder::obstacleDistanceFieldCellSize() const {
+  return pimpl_->obstacleDistanceFieldCellSize();
+}
+
+void PathFinder::setHierarchicalPathfinding(float clusterSize,
+                                            float minDistance) {
+  pimpl_->setHierarchicalPathfinding(clusterSize, minDistance);
+}
+
+float PathFinder::hierarchicalPathfindingClusterSize() const {
+  return pimpl_->hierarchicalPathfindingClusterSize();
+}
+
 bool PathFinder::isNavigable(const vec3f& pt, const float maxYDelta) const {
   return pimpl_->isNavigable(pt);
 }
 
+void PathFinder::areNavigable(Cr::Containers::ArrayView<const vec3f> points,
+                              Cr::Containers::ArrayView<bool> results,
+                              const float maxYDelta) const {
+  pimpl_->areNavigable(points, results, maxYDelta);
+}
+
 std::pair<vec3f, vec3f> PathFinder::bounds() const {
   return pimpl_->bounds();
 }
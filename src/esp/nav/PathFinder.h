@@ -4,10 +4,15 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "esp/core/esp.h"
+#include "esp/core/random.h"
 
 namespace esp {
 // forward declaration
@@ -99,6 +104,73 @@ struct MultiGoalShortestPath {
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(MultiGoalShortestPath);
 };
 
+/**
+ * @brief Geodesic distance field to a fixed set of goals. Used in conjunction
+ * with @ref PathFinder.geodesicDistance
+ *
+ * Meant for episodes where the goals don't change but the distance to them is
+ * needed at every step. Instead of a path search per query, a single Dijkstra
+ * from the goals over the navmesh polygon vertices is run the first time the
+ * field is used. After that each query only snaps the point to its polygon and
+ * takes the minimum over the polygon vertices, so it costs about as much as
+ * @ref PathFinder.snapPoint.
+ *
+ * The result is an upper bound of the distance @ref PathFinder.findPath
+ * returns, exact when the shortest path only bends at vertices of polygons it
+ * passes through, and usually within a few centimeters otherwise.
+ */
+struct GeodesicDistanceField {
+  GeodesicDistanceField();
+
+  /**
+   * @brief Set the goals the distance is measured to, clears the field
+   */
+  void setGoals(const std::vector<vec3f>& newGoals);
+
+  const std::vector<vec3f>& getGoals() const;
+
+  friend class PathFinder;
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(GeodesicDistanceField);
+};
+
+/**
+ * @brief Statistics of the path cache of a @ref PathFinder
+ *
+ * @see @ref PathFinder::setPathCache()
+ */
+struct PathCacheStatistics {
+  /** @brief Queries answered from the cache */
+  std::size_t hits;
+  /** @brief Queries that had to search for the path */
+  std::size_t misses;
+  /** @brief Paths currently cached */
+  std::size_t size;
+  /** @brief Maximum number of cached paths */
+  std::size_t capacity;
+
+  /** @brief Fraction of queries answered from the cache */
+  float hitRate() const {
+    return hits + misses ? float(hits) / (hits + misses) : 0.0f;
+  }
+};
+
+/**
+ * @brief Constraints on the points drawn by
+ * @ref PathFinder::getRandomNavigablePoints()
+ */
+struct RandomPointConstraints {
+  /**
+   * @brief Only draw from islands whose @ref PathFinder::islandRadius() is at
+   * least this large
+   */
+  float minIslandRadius = 0.0f;
+  /** @brief Lowest allowed y coordinate of a point */
+  float minHeight = -std::numeric_limits<float>::infinity();
+  /** @brief Highest allowed y coordinate of a point */
+  float maxHeight = std::numeric_limits<float>::infinity();
+};
+
 struct NavMeshSettings {
   //! Cell size in world units
   float cellSize;
@@ -132,6 +204,13 @@ struct NavMeshSettings {
   bool filterLowHangingObstacles;
   bool filterLedgeSpans;
   bool filterWalkableLowHeightSpans;
+  /**
+   * @brief Tile size in cells, 0 to build the navmesh as a single tile
+   *
+   * Tiles are voxelized and built in parallel, which is a lot faster for
+   * large scenes. Multiples of 32 between 64 and 512 work well.
+   */
+  int tileSize;
 
   void setDefaults() {
     cellSize = 0.05f;
@@ -150,14 +229,36 @@ struct NavMeshSettings {
     filterLowHangingObstacles = true;
     filterLedgeSpans = true;
     filterWalkableLowHeightSpans = true;
+    tileSize = 0;
   }
 
   ESP_SMART_POINTERS(NavMeshSettings)
 };
 
+/**
+ * @brief Compare the settings used when building a navmesh
+ *
+ * @ref NavMeshSettings::navMeshBMin and @ref NavMeshSettings::navMeshBMax are
+ * not used by @ref PathFinder::build() and thus ignored.
+ */
+bool operator==(const NavMeshSettings& a, const NavMeshSettings& b);
+bool operator!=(const NavMeshSettings& a, const NavMeshSettings& b);
+
 /** Loads and/or builds a navigation mesh and then performs path
  * finding and collision queries on that navmesh
  *
+ * Once a navmesh is loaded, @ref findPath(), @ref findPaths(), @ref
+ * findGeodesicDistances(), @ref tryStep(), @ref tryStepNoSliding(), @ref
+ * trySteps(), @ref tryStepsNoSliding(), @ref snapPoint(), @ref snapPoints(),
+ * @ref islandRadius(), @ref isNavigable(), @ref areNavigable(), @ref
+ * distanceToClosestObstacle() and @ref closestObstacleSurfacePoint() can be
+ * called from several threads at once, so workers can share one navmesh
+ * instead of loading a copy each. Every call borrows a navmesh query from a
+ * pool that grows to the number of threads querying concurrently. Loading,
+ * building, @ref seed(), @ref getRandomNavigablePoint() and @ref
+ * getNavMeshData() must not run concurrently with anything else on the same
+ * instance. The same @ref MultiGoalShortestPath must not be passed to
+ * concurrent calls, as it caches per-query state.
  */
 class PathFinder {
  public:
@@ -176,16 +277,85 @@ class PathFinder {
              const float* bmax);
   bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
 
+  /**
+   * @brief Build navmeshes of several agent sizes from the same mesh
+   *
+   * Same as calling @ref build() with each of @p variants on a pathfinder
+   * of its own, but the mesh is voxelized only once for all variants with
+   * the same @ref NavMeshSettings::cellSize, @ref NavMeshSettings::cellHeight,
+   * @ref NavMeshSettings::agentMaxSlope, @ref NavMeshSettings::agentMaxClimb
+   * (in cells) and @ref NavMeshSettings::tileSize. Only the span filters,
+   * erosion, regions, contours and polygons, which depend on the agent
+   * height and radius, are redone per variant.
+   *
+   * Tiled variants sharing the voxelization all get the tile border of the
+   * largest radius among them, which can change polygons along the tile
+   * edges slightly compared to @ref build().
+   *
+   * @return One pathfinder per variant in the same order, nullptr where the
+   * build failed
+   */
+  static std::vector<PathFinder::ptr> buildVariants(
+      const std::vector<NavMeshSettings>& variants,
+      const esp::assets::MeshData& mesh);
+
+  /**
+   * @brief Rebuild only the navmesh tiles overlapping @p regions
+   *
+   * Much faster than @ref build() after a few objects were added to or
+   * removed from @p mesh, pass the bounding boxes of the changed objects,
+   * before and after the change. Only works if the navmesh was built by
+   * @ref build() with @ref NavMeshSettings::tileSize set, the same @p bs and
+   * a mesh with the same bounds, as the tile grid has to stay the same.
+   *
+   * @param bs       Same settings as the navmesh was built with
+   * @param mesh     The whole mesh, including the changes
+   * @param regions  Axis-aligned boxes as (min, max) pairs
+   * @return Whether the tiles were rebuilt. If false, nothing was changed
+   * when the navmesh can't be updated in place and @ref build() has to be
+   * used instead.
+   */
+  bool rebuildTiles(const NavMeshSettings& bs,
+                    const esp::assets::MeshData& mesh,
+                    const std::vector<std::pair<vec3f, vec3f>>& regions);
+
   /**
    * @brief Returns a random navigable point
    *
+   * @param[in] minIslandRadius If positive, the point is drawn uniformly by
+   * area from islands whose @ref islandRadius() is at least this large.
+   * Qualifying polygons are precomputed when the navmesh is loaded, so this
+   * costs the same as an unconstrained sample.
+   *
    * @return A random navigable point.
    *
    * @note This method can fail.  If it does,
    * the returned point will be arbitrary and may not be navigable. Use @ref
-   * isNavigable to check if the point is navigable.
+   * isNavigable to check if the point is navigable. If no island is large
+   * enough, all components of the returned point are infinite.
+   */
+  vec3f getRandomNavigablePoint(float minIslandRadius = 0.0f);
+
+  /**
+   * @brief Returns @p count random navigable points, uniform by area
+   *
+   * Unlike @ref getRandomNavigablePoint(), the area table of the polygons
+   * satisfying @p constraints is built once for the whole batch and the
+   * points are drawn in parallel. Each point has its own generator derived
+   * from @p seed and its index, so the output only depends on @p seed and
+   * not on the thread count or the state set by @ref seed().
+   *
+   * @param[in] count       Number of points
+   * @param[in] seed        Random seed
+   * @param[in] constraints Island and height band the points are drawn from
+   *
+   * @return The points. Points that couldn't be placed, e.g. because no
+   * polygon satisfies the constraints, have all components infinite.
    */
-  vec3f getRandomNavigablePoint();
+  std::vector<vec3f> getRandomNavigablePoints(
+      std::size_t count,
+      uint32_t seed,
+      const RandomPointConstraints& constraints = {}) const;
 
   /**
    * @brief Finds the shortest path between two points on the navigation mesh
@@ -214,6 +384,66 @@ class PathFinder {
    */
   bool findPath(MultiGoalShortestPath& path);
 
+  /**
+   * @brief Finds the shortest paths for a batch of @ref ShortestPath
+   *
+   * Same as calling @ref findPath(ShortestPath&) on each of @p paths, but the
+   * queries are spread across the OpenMP worker threads, each with its own
+   * navmesh query. Meant for many queries at once, e.g. when generating
+   * episodes.
+   *
+   * @param[inout] paths The paths to find, their @ref ShortestPath.points and
+   * @ref ShortestPath.geodesicDistance fields are populated
+   *
+   * @return Number of @p paths that exist
+   */
+  size_t findPaths(std::vector<ShortestPath>& paths);
+
+  /**
+   * @brief Geodesic distances between pairs of points
+   *
+   * Like @ref findPaths(), but only the distances are kept, written into a
+   * preallocated contiguous array.
+   *
+   * @param[in] starts The starting points
+   * @param[in] ends The end points, same count as @p starts
+   * @param[out] distances The geodesic distance between each pair, inf if no
+   * path exists. Same count as @p starts
+   */
+  void findGeodesicDistances(Corrade::Containers::ArrayView<const vec3f> starts,
+                             Corrade::Containers::ArrayView<const vec3f> ends,
+                             Corrade::Containers::ArrayView<float> distances);
+
+  /**
+   * @brief Geodesic distance from @p pt to the closest goal of @p field
+   *
+   * Builds @p field on the first call and whenever the loaded navmesh
+   * changed, later calls are lookups only. Once built, the field can be
+   * queried from several threads at once.
+   *
+   * @return The distance, inf if @p pt isn't on the navmesh or no goal is
+   * reachable from it
+   */
+  float geodesicDistance(GeodesicDistanceField& field, const vec3f& pt);
+
+  /**
+   * @brief Geodesic distances between all pairs of @p points
+   *
+   * Meant for planning over a set of goals, e.g. the order to visit them
+   * in. Each point is snapped once, then one Dijkstra per point is run over
+   * the same polygon vertex graph as @ref GeodesicDistanceField, spread
+   * across the OpenMP worker threads. The distances are the same upper bound
+   * of the @ref findPath() distance as @ref geodesicDistance() returns, and
+   * symmetric up to floating point rounding.
+   *
+   * @param[in] points The points, K of them
+   * @param[out] distances Row-major K by K matrix, the distance from point i to
+   * point j at i*K + j. 0 on the diagonal of points on the navmesh, inf if
+   * either point isn't on the navmesh or they aren't connected
+   */
+  void distanceMatrix(Corrade::Containers::ArrayView<const vec3f> points,
+                      Corrade::Containers::ArrayView<float> distances);
+
   /**
    * @brief Attempts to move from @ref start to @ref end and returns the
    * navigable point closest to @ref end that is feasibly reachable from @ref
@@ -233,6 +463,30 @@ class PathFinder {
   template <typename T>
   T tryStepNoSliding(const T& start, const T& end);
 
+  /**
+   * @brief Batched @ref tryStep()
+   *
+   * Steps are spread across the OpenMP worker threads, each with its own
+   * navmesh query, so vectorized environments can move all their agents with
+   * a single call.
+   *
+   * @param[in] starts The starting locations
+   * @param[in] ends The desired end locations, same count as @p starts
+   * @param[out] results The found end locations, same count as @p starts
+   */
+  void trySteps(Corrade::Containers::ArrayView<const vec3f> starts,
+                Corrade::Containers::ArrayView<const vec3f> ends,
+                Corrade::Containers::ArrayView<vec3f> results);
+
+  /**
+   * @brief Batched @ref tryStepNoSliding()
+   *
+   * See @ref trySteps() for details.
+   */
+  void tryStepsNoSliding(Corrade::Containers::ArrayView<const vec3f> starts,
+                         Corrade::Containers::ArrayView<const vec3f> ends,
+                         Corrade::Containers::ArrayView<vec3f> results);
+
   /**
    * @brief Snaps a point to the navigation mesh
    *
@@ -244,39 +498,76 @@ class PathFinder {
   template <typename T>
   T snapPoint(const T& pt);
 
+  /**
+   * @brief Batched @ref snapPoint()
+   *
+   * @param[in] points The points to snap to the navigation mesh
+   * @param[out] results The snapped points, same count as @p points
+   */
+  void snapPoints(Corrade::Containers::ArrayView<const vec3f> points,
+                  Corrade::Containers::ArrayView<vec3f> results);
+
   /**
    * @brief Loads a navigation meshed saved by @ref saveNavMesh
    *
    * @param[in] path The saved navigation mesh file, generally has extension
    * ``.navmesh``
+   * @param[in] mapFile Use the tiles of an uncompressed file right from a
+   * private memory mapping of it instead of reading them into memory, where
+   * supported. The pages Detour doesn't write to are then shared between all
+   * processes loading the same file. The file must not be modified in place
+   * while loaded, @ref saveNavMesh() replaces files instead.
    *
    * @return Whether or not the navmesh was successfully loaded
    */
-  bool loadNavMesh(const std::string& path);
+  bool loadNavMesh(const std::string& path, bool mapFile = true);
 
   /**
    * @brief Saves a navigation mesh to later be loaded by @ref loadNavMesh
    *
    * @param[in] path The name of the file, generally has extension ``.navmesh``
+   * @param[in] compress Compress the tile data with zlib. Saves disk space,
+   * but compressed files can't be memory mapped. Fails if habitat-sim was
+   * built without zlib.
    *
    * @return Whether or not the navmesh was successfully saved
    */
-  bool saveNavMesh(const std::string& path);
+  bool saveNavMesh(const std::string& path, bool compress = false);
 
   /**
    * @return If a navigation mesh is current loaded or not
    */
   bool isLoaded() const;
 
+  /**
+   * @brief Identifies the navmesh currently loaded
+   *
+   * Changes whenever a navmesh is loaded, built or partially rebuilt with
+   * @ref rebuildTiles(), and is never the same for two different navmeshes,
+   * even of different instances. Meant for invalidating data derived from
+   * the navmesh. 0 if nothing was loaded yet.
+   */
+  uint64_t navMeshVersion() const;
+
   /**
    * @brief Seed the pathfinder.  Useful for @ref getRandomNavigablePoint
    *
    * @param[in] newSeed The random seed
    *
-   * @note This just seeds the global c @ref rand function.
+   * @note The generator is owned by this instance and doesn't affect the
+   * global C @ref rand function.
    */
   void seed(uint32_t newSeed);
 
+  /**
+   * @brief State of the generator used by @ref getRandomNavigablePoint, to
+   * continue from the same point later with @ref setRandomState()
+   */
+  core::Random randomState() const;
+
+  /** @brief Restore a generator state from @ref randomState() */
+  void setRandomState(const core::Random& state);
+
   /**
    * @brief returns the size of the connected component @ ref pt belongs to.
    *
@@ -306,6 +597,86 @@ class PathFinder {
       const vec3f& pt,
       const float maxSearchRadius = 2.0) const;
 
+  /**
+   * @brief Answer obstacle distance queries from a precomputed field
+   *
+   * Instead of searching the navmesh on every call, @ref
+   * distanceToClosestObstacle() and @ref closestObstacleSurfacePoint()
+   * interpolate bilinearly between distances sampled on a grid over the x-z
+   * plane of the navmesh bounds, with a separate sample for each floor above
+   * the same grid node. The returned hit position and normal are the ones of
+   * the nearest grid node. Queries with a search radius larger than
+   * @p maxSearchRadius, or points with no grid node around them, still
+   * search the navmesh.
+   *
+   * The field is built on the first query after this call or after a navmesh
+   * is loaded or built, and is saved along with the navmesh by @ref
+   * saveNavMesh(). Loading a navmesh saved with a field enables it with the
+   * saved settings. Must not be called concurrently with queries.
+   *
+   * @param[in] cellSize Grid spacing in meters, 0 disables the field
+   * @param[in] maxSearchRadius Search radius the distances are sampled with
+   */
+  void setObstacleDistanceField(float cellSize, float maxSearchRadius = 2.0f);
+
+  /**
+   * @brief Cache the results of @ref findPath(ShortestPath&)
+   *
+   * Also used by @ref findPaths() and @ref findGeodesicDistances(). Paths are
+   * cached by the navmesh polygons their endpoints snap to and the endpoints
+   * themselves, rounded to multiples of @p quantization, and the least
+   * recently used ones are dropped once there are more than @p capacity. A
+   * query whose endpoints fall in the same quantization cells as those of a
+   * cached one gets exactly the cached result, while endpoints closer than
+   * @p quantization on either side of a cell boundary don't share one. The
+   * cache is cleared whenever the navmesh changes. Must not be called
+   * concurrently with queries.
+   *
+   * @param[in] capacity Maximum number of cached paths, 0 disables the cache
+   * @param[in] quantization Grid the endpoints are rounded to, 0 to only reuse
+   * results for bit-exact endpoints
+   */
+  void setPathCache(std::size_t capacity, float quantization = 1.0e-3f);
+
+  /**
+   * @brief Hits and misses since the last @ref setPathCache() call
+   */
+  PathCacheStatistics pathCacheStatistics() const;
+
+  /**
+   * @brief Grid spacing of the obstacle distance field, 0 if disabled
+   *
+   * @see @ref setObstacleDistanceField()
+   */
+  float obstacleDistanceFieldCellSize() const;
+
+  /**
+   * @brief Search long paths hierarchically
+   *
+   * Groups the navmesh polygons into clusters by the cube of @p clusterSize
+   * meters their centroid is in, and connects the clusters at their shared
+   * polygon edges by a graph built once for every loaded or built navmesh.
+   * Paths whose endpoints, snapped to the navmesh, are at least
+   * @p minDistance apart are first searched on that graph, and only the
+   * polygons of the clusters it picks are searched in detail, which makes
+   * the search cost grow with the length of the path instead of the size of
+   * the navmesh. The result may be longer than the exact shortest path when
+   * another sequence of clusters leads to a shorter one. Paths the graph
+   * doesn't find are searched without it. Clears the path cache. Must not be
+   * called concurrently with queries.
+   *
+   * @param[in] clusterSize Cluster size in meters, 0 disables the hierarchy
+   * @param[in] minDistance Straight-line distance from which it is used
+   */
+  void setHierarchicalPathfinding(float clusterSize, float minDistance = 10.0f);
+
+  /**
+   * @brief Cluster size of hierarchical pathfinding, 0 if disabled
+   *
+   * @see @ref setHierarchicalPathfinding()
+   */
+  float hierarchicalPathfindingClusterSize() const;
+
   /**
    * @brief Query whether or not a given location is navigable
    *
@@ -321,11 +692,37 @@ class PathFinder {
    */
   bool isNavigable(const vec3f& pt, const float maxYDelta = 0.5) const;
 
+  /**
+   * @brief Batched @ref isNavigable()
+   *
+   * @param[in] points The locations to check
+   * @param[out] results Whether each of @p points is navigable, same count
+   * as @p points
+   * @param[in] maxYDelta The maximum y displacement
+   */
+  void areNavigable(Corrade::Containers::ArrayView<const vec3f> points,
+                    Corrade::Containers::ArrayView<bool> results,
+                    const float maxYDelta = 0.5) const;
+
   /**
    * @return The axis aligned bounding box containing the navigation mesh.
    */
   std::pair<vec3f, vec3f> bounds() const;
 
+  /**
+   * @brief Rasterize the navmesh into a top-down occupancy grid
+   *
+   * @param[in] pixelsPerMeter Pixel spacing in meters
+   * @param[in] height Height of the slice, a pixel is navigable if the navmesh
+   * surface is within 0.5 of it, like with @ref isNavigable()
+   *
+   * @return Navigability of each pixel, rows along z and columns along x
+   * starting at the lower @ref bounds()
+   *
+   * The navmesh triangles are scanned directly into the grid, one row per
+   * worker thread at a time. The result is cached for each @p pixelsPerMeter
+   * and @p height until the navmesh is loaded or rebuilt.
+   */
   Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> getTopDownView(
       const float pixelsPerMeter,
       const float height);
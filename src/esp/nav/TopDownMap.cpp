@@ -0,0 +1,103 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TopDownMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace esp {
+namespace nav {
+
+TopDownMap::TopDownMap(PathFinder& pathFinder,
+                       float pixelsPerMeter,
+                       float height)
+    : pixelsPerMeter_{pixelsPerMeter},
+      navigable_{pathFinder.getTopDownView(pixelsPerMeter, height)} {
+  const std::pair<vec3f, vec3f> bounds = pathFinder.bounds();
+  startX_ = std::fmin(bounds.first[0], bounds.second[0]);
+  startZ_ = std::fmin(bounds.first[2], bounds.second[2]);
+  visible_ = MatrixXb::Constant(navigable_.rows(), navigable_.cols(), false);
+}
+
+vec2i TopDownMap::toGrid(const vec3f& point) const {
+  // pixels are sampled at their center, see PathFinder::getTopDownView()
+  return {int(std::floor((point[2] - startZ_) / pixelsPerMeter_ + 0.5f)),
+          int(std::floor((point[0] - startX_) / pixelsPerMeter_ + 0.5f))};
+}
+
+int TopDownMap::updateVisibility(const vec3f& position,
+                                 const quatf& rotation,
+                                 float hfov,
+                                 float maxDistance) {
+  const int rows = navigable_.rows();
+  const int cols = navigable_.cols();
+  // in pixels, with pixel (h, w) covering [w, w + 1) x [h, h + 1)
+  const float originX = (position[0] - startX_) / pixelsPerMeter_ + 0.5f;
+  const float originZ = (position[2] - startZ_) / pixelsPerMeter_ + 0.5f;
+  const int originW = int(std::floor(originX));
+  const int originH = int(std::floor(originZ));
+  if (originH < 0 || originH >= rows || originW < 0 || originW >= cols) {
+    return 0;
+  }
+
+  int newlyVisible = !visible_(originH, originW);
+  visible_(originH, originW) = true;
+
+  const vec3f forward = rotation * vec3f{0.0f, 0.0f, -1.0f};
+  const float heading = std::atan2(forward[2], forward[0]);
+  const float fov = hfov * float(M_PI) / 180.0f;
+  const float range = maxDistance / pixelsPerMeter_;
+  // neighboring rays are at most a pixel apart at the far end
+  const int rayCount = std::max(2, int(std::ceil(fov * range)) + 1);
+  constexpr float inf = std::numeric_limits<float>::infinity();
+
+  for (int r = 0; r < rayCount; ++r) {
+    const float angle = heading - 0.5f * fov + fov * r / (rayCount - 1);
+    const float dx = std::cos(angle);
+    const float dz = std::sin(angle);
+
+    // traverse every pixel the ray passes through, so it can't slip through
+    // the diagonal gap between two obstacle pixels
+    int w = originW;
+    int h = originH;
+    const int stepW = dx > 0.0f ? 1 : -1;
+    const int stepH = dz > 0.0f ? 1 : -1;
+    const float deltaX = dx != 0.0f ? 1.0f / std::abs(dx) : inf;
+    const float deltaZ = dz != 0.0f ? 1.0f / std::abs(dz) : inf;
+    float nextX = dx > 0.0f ? (w + 1 - originX) * deltaX
+                            : (originX - w) * deltaX;
+    float nextZ = dz > 0.0f ? (h + 1 - originZ) * deltaZ
+                            : (originZ - h) * deltaZ;
+    while (true) {
+      float t;
+      if (nextX < nextZ) {
+        t = nextX;
+        nextX += deltaX;
+        w += stepW;
+      } else {
+        t = nextZ;
+        nextZ += deltaZ;
+        h += stepH;
+      }
+      if (t > range || h < 0 || h >= rows || w < 0 || w >= cols) {
+        break;
+      }
+      newlyVisible += !visible_(h, w);
+      visible_(h, w) = true;
+      if (!navigable_(h, w)) {
+        break;
+      }
+    }
+  }
+  return newlyVisible;
+}
+
+void TopDownMap::resetVisibility() {
+  visible_.setConstant(false);
+}
+
+}  // namespace nav
+}  // namespace esp
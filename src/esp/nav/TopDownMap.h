@@ -0,0 +1,94 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::nav::TopDownMap
+ */
+
+#include "esp/core/esp.h"
+#include "esp/nav/PathFinder.h"
+
+namespace esp {
+namespace nav {
+
+/**
+@brief Top-down navigability map with an accumulated fog of war
+
+The navigability is rasterized once by @ref PathFinder::getTopDownView(),
+with rows along z and columns along x starting at the lower
+@ref PathFinder::bounds(). @ref updateVisibility() then marks the pixels an
+agent sees from its pose, marching one ray per pixel of arc from the agent
+through the navigable pixels until each ray hits an obstacle, so metrics and
+exploration rewards don't have to cast the view cone of every step
+themselves.
+*/
+class TopDownMap {
+ public:
+  typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXb;
+
+  /**
+   * @brief Constructor
+   * @param[in] pathFinder      Loaded pathfinder to rasterize the navmesh of
+   * @param[in] pixelsPerMeter  Pixel spacing in meters, see
+   *                            @ref PathFinder::getTopDownView()
+   * @param[in] height          Height of the slice
+   *
+   * Nothing is visible initially.
+   */
+  TopDownMap(PathFinder& pathFinder, float pixelsPerMeter, float height);
+
+  /** @brief Pixel spacing in meters */
+  float pixelsPerMeter() const { return pixelsPerMeter_; }
+
+  /** @brief Navigability of each pixel */
+  const MatrixXb& navigable() const { return navigable_; }
+
+  /**
+   * @brief Pixels seen by any @ref updateVisibility() since the construction
+   * or the last @ref resetVisibility()
+   */
+  const MatrixXb& visible() const { return visible_; }
+
+  /**
+   * @brief The pixel containing the x and z of @p point, as a row and a
+   * column
+   *
+   * May be outside of the map.
+   */
+  vec2i toGrid(const vec3f& point) const;
+
+  /**
+   * @brief Mark the pixels visible from an agent pose
+   * @param[in] position     Position of the agent
+   * @param[in] rotation     Rotation of the agent, which looks down -Z
+   * @param[in] hfov         Horizontal field of view in degrees
+   * @param[in] maxDistance  How far the agent sees, in meters
+   * @return Number of pixels that weren't visible before
+   *
+   * A ray stops at the first non-navigable pixel, which is marked as well,
+   * so walls bounding the seen area are visible too. The pixel of the agent
+   * itself is always marked.
+   */
+  int updateVisibility(const vec3f& position,
+                       const quatf& rotation,
+                       float hfov,
+                       float maxDistance);
+
+  /** @brief Clear the fog of war, for example at the start of an episode */
+  void resetVisibility();
+
+ private:
+  float pixelsPerMeter_;
+  // x and z of the pixel at row 0 and column 0
+  float startX_, startZ_;
+  MatrixXb navigable_;
+  MatrixXb visible_;
+
+  ESP_SMART_POINTERS(TopDownMap)
+};
+
+}  // namespace nav
+}  // namespace esp
@@ -0,0 +1,267 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Directory.h>
+
+#include <esp/nav/PathFinder.h>
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+
+using esp::nav::PathFinder;
+
+namespace {
+
+constexpr const char* NavMeshes[]{"skokloster-castle", "van-gogh-room",
+                                  "apartment_1"};
+
+enum class Query {
+  FindPath,
+  TryStep,
+  TryStepNoSliding,
+  SnapPoint,
+  IslandRadius,
+  RandomNavigablePoint,
+  DistanceToClosestObstacle,
+};
+
+constexpr struct {
+  const char* name;
+  Query query;
+} QueryData[]{{"findPath", Query::FindPath},
+              {"tryStep", Query::TryStep},
+              {"tryStepNoSliding", Query::TryStepNoSliding},
+              {"snapPoint", Query::SnapPoint},
+              {"islandRadius", Query::IslandRadius},
+              {"getRandomNavigablePoint", Query::RandomNavigablePoint},
+              {"distanceToClosestObstacle",
+               Query::DistanceToClosestObstacle}};
+
+constexpr std::size_t QueryCount = Cr::Containers::arraySize(QueryData);
+
+constexpr int MultiGoalCounts[]{1, 10, 100, 1000};
+
+constexpr int ThreadCounts[]{1, 2, 4, 8};
+
+// points queried by every test, the same for every run of the benchmark
+constexpr int PointCount = 10000;
+
+/*
+ * Benchmarks of the queries of PathFinder. Latency tests time every call
+ * separately and print percentiles, which the benchmark statistics of the
+ * test suite lack; the benchmarks report the mean of batches of calls.
+ */
+struct PathFinderBenchmark : Cr::TestSuite::Tester {
+  explicit PathFinderBenchmark();
+
+  void latency();
+
+  void benchmarkQuery();
+  void benchmarkMultiGoal();
+  void benchmarkThreadScaling();
+
+  // navmesh of the instance together with random points on it, loaded
+  // once for all test cases
+  struct NavMesh {
+    PathFinder::ptr pathFinder;
+    std::vector<esp::vec3f> starts, ends;
+  };
+  NavMesh* navMesh(const char* name);
+
+  float query(NavMesh& navMesh, Query query, int i);
+
+  std::map<std::string, NavMesh> navMeshes_;
+  // accumulates the query results so they aren't optimized away
+  float sink_ = 0.0f;
+};
+
+PathFinderBenchmark::PathFinderBenchmark() {
+  addInstancedTests({&PathFinderBenchmark::latency},
+                    Cr::Containers::arraySize(NavMeshes) * QueryCount);
+
+  addInstancedBenchmarks({&PathFinderBenchmark::benchmarkQuery}, 10,
+                         Cr::Containers::arraySize(NavMeshes) * QueryCount);
+  addInstancedBenchmarks({&PathFinderBenchmark::benchmarkMultiGoal}, 10,
+                         Cr::Containers::arraySize(MultiGoalCounts));
+  addInstancedBenchmarks({&PathFinderBenchmark::benchmarkThreadScaling}, 5,
+                         Cr::Containers::arraySize(ThreadCounts));
+}
+
+PathFinderBenchmark::NavMesh* PathFinderBenchmark::navMesh(const char* name) {
+  auto found = navMeshes_.find(name);
+  if (found != navMeshes_.end()) {
+    return &found->second;
+  }
+
+  const std::string filename =
+      Cr::Utility::Directory::join(SCENE_DATASETS, "habitat-test-scenes/" +
+                                                       std::string{name} +
+                                                       ".navmesh");
+  NavMesh navMesh;
+  navMesh.pathFinder = PathFinder::create();
+  if (!Cr::Utility::Directory::exists(filename) ||
+      !navMesh.pathFinder->loadNavMesh(filename)) {
+    return nullptr;
+  }
+  navMesh.pathFinder->seed(0);
+  for (int i = 0; i != PointCount; ++i) {
+    navMesh.starts.push_back(navMesh.pathFinder->getRandomNavigablePoint());
+    navMesh.ends.push_back(navMesh.pathFinder->getRandomNavigablePoint());
+  }
+  return &navMeshes_.emplace(name, std::move(navMesh)).first->second;
+}
+
+// returns a number depending on the result, see sink_
+float PathFinderBenchmark::query(NavMesh& navMesh, Query query, int i) {
+  PathFinder& pathFinder = *navMesh.pathFinder;
+  const esp::vec3f& start = navMesh.starts[i % PointCount];
+  const esp::vec3f& end = navMesh.ends[i % PointCount];
+  // a short step towards the end, as an agent takes it
+  const esp::vec3f step = start + (end - start).normalized() * 0.25f;
+  switch (query) {
+    case Query::FindPath: {
+      esp::nav::ShortestPath path;
+      path.requestedStart = start;
+      path.requestedEnd = end;
+      pathFinder.findPath(path);
+      return path.geodesicDistance;
+    }
+    case Query::TryStep:
+      return pathFinder.tryStep(start, step)[0];
+    case Query::TryStepNoSliding:
+      return pathFinder.tryStepNoSliding(start, step)[0];
+    case Query::SnapPoint: {
+      // off the navmesh, above the point
+      const esp::vec3f above = end + esp::vec3f{0.0f, 0.5f, 0.0f};
+      return pathFinder.snapPoint(above)[0];
+    }
+    case Query::IslandRadius:
+      return pathFinder.islandRadius(start);
+    case Query::RandomNavigablePoint:
+      return pathFinder.getRandomNavigablePoint()[0];
+    case Query::DistanceToClosestObstacle:
+      return pathFinder.distanceToClosestObstacle(start);
+  }
+  CORRADE_ASSERT_UNREACHABLE();
+}
+
+void PathFinderBenchmark::latency() {
+  const char* name = NavMeshes[testCaseInstanceId() / QueryCount];
+  auto&& data = QueryData[testCaseInstanceId() % QueryCount];
+  setTestCaseDescription(std::string{data.name} + ", " + name);
+
+  NavMesh* navMesh = this->navMesh(name);
+  if (!navMesh) {
+    CORRADE_SKIP("Navmesh" << name << "not found");
+  }
+
+  std::vector<double> times;
+  times.reserve(PointCount);
+  for (int i = 0; i != PointCount; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    sink_ += query(*navMesh, data.query, i);
+    times.push_back(std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+  std::sort(times.begin(), times.end());
+  const auto percentile = [&times](double fraction) {
+    return times[std::min(times.size() - 1,
+                          std::size_t(fraction * times.size()))];
+  };
+  Cr::Utility::Debug{} << "   " << data.name << "on" << name
+                       << "latency in us: p50" << percentile(0.5) << "p90"
+                       << percentile(0.9) << "p99" << percentile(0.99)
+                       << "max" << times.back();
+  CORRADE_COMPARE(times.size(), std::size_t(PointCount));
+}
+
+void PathFinderBenchmark::benchmarkQuery() {
+  const char* name = NavMeshes[testCaseInstanceId() / QueryCount];
+  auto&& data = QueryData[testCaseInstanceId() % QueryCount];
+  setTestCaseDescription(std::string{data.name} + ", " + name);
+
+  NavMesh* navMesh = this->navMesh(name);
+  if (!navMesh) {
+    CORRADE_SKIP("Navmesh" << name << "not found");
+  }
+
+  constexpr int batchSize = 100;
+  int i = 0;
+  CORRADE_BENCHMARK(batchSize) {
+    sink_ += query(*navMesh, data.query, i++);
+  }
+  CORRADE_COMPARE(i, batchSize);
+}
+
+void PathFinderBenchmark::benchmarkMultiGoal() {
+  const int goalCount = MultiGoalCounts[testCaseInstanceId()];
+  setTestCaseDescription(std::to_string(goalCount) + " goals");
+
+  NavMesh* navMesh = this->navMesh(NavMeshes[0]);
+  if (!navMesh) {
+    CORRADE_SKIP("Navmesh" << NavMeshes[0] << "not found");
+  }
+
+  // a new start every call, as for an agent moving towards the goals
+  esp::nav::MultiGoalShortestPath path;
+  path.setRequestedEnds(std::vector<esp::vec3f>(
+      navMesh->ends.begin(), navMesh->ends.begin() + goalCount));
+  int i = 0;
+  bool status = false;
+  CORRADE_BENCHMARK(10) {
+    path.requestedStart = navMesh->starts[i++ % PointCount];
+    status |= navMesh->pathFinder->findPath(path);
+  }
+  CORRADE_VERIFY(status);
+}
+
+void PathFinderBenchmark::benchmarkThreadScaling() {
+  const int threadCount = ThreadCounts[testCaseInstanceId()];
+  setTestCaseDescription(std::to_string(threadCount) + " threads");
+
+  NavMesh* navMesh = this->navMesh(NavMeshes[0]);
+  if (!navMesh) {
+    CORRADE_SKIP("Navmesh" << NavMeshes[0] << "not found");
+  }
+
+  // the same work split among the threads, so the time per iteration falls
+  // with the thread count as long as queries scale
+  constexpr int batchQueryCount = 2048;
+  std::vector<float> sums(threadCount);
+  CORRADE_BENCHMARK(1) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t != threadCount; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = t; i < batchQueryCount; i += threadCount) {
+          sums[t] += query(*navMesh, Query::FindPath, i) +
+                     query(*navMesh, Query::TryStep, i) +
+                     query(*navMesh, Query::DistanceToClosestObstacle, i);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+  for (float sum : sums) {
+    sink_ += sum;
+  }
+  CORRADE_COMPARE(sums.size(), std::size_t(threadCount));
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(PathFinderBenchmark)
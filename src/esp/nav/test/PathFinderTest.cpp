@@ -1,8 +1,17 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 
+#include <esp/assets/MeshData.h>
 #include <esp/nav/PathFinder.h>
+#include <esp/nav/TopDownMap.h>
 
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/EigenIntegration/Integration.h>
@@ -10,6 +19,7 @@
 #include <Magnum/Math/Vector3.h>
 
 #include "configure.h"
+#include "esp/core/configure.h"
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -32,18 +42,49 @@ struct PathFinderTest : Cr::TestSuite::Tester {
   void bounds();
   void tryStepNoSliding();
   void multiGoalPath();
+  void multiGoalPathManyEnds();
 
   void benchmarkSingleGoal();
   void benchmarkMultiGoal();
 
   void testCaching();
+
+  void batchedPaths();
+  void batchedSteps();
+  void concurrentQueries();
+  void geodesicDistanceField();
+  void distanceMatrix();
+  void randomPointOnLargeIsland();
+  void bulkRandomPoints();
+  void obstacleDistanceField();
+  void topDownView();
+  void topDownMap();
+  void saveLoadNavMesh();
+  void navMeshVariants();
+  void pathCache();
+  void hierarchicalPaths();
+  void benchmarkBatchedDistances();
 };
 
 PathFinderTest::PathFinderTest() {
   addTests({&PathFinderTest::bounds, &PathFinderTest::tryStepNoSliding,
-            &PathFinderTest::multiGoalPath, &PathFinderTest::testCaching});
+            &PathFinderTest::multiGoalPath,
+            &PathFinderTest::multiGoalPathManyEnds,
+            &PathFinderTest::testCaching,
+            &PathFinderTest::batchedPaths, &PathFinderTest::batchedSteps,
+            &PathFinderTest::concurrentQueries,
+            &PathFinderTest::geodesicDistanceField,
+            &PathFinderTest::distanceMatrix,
+            &PathFinderTest::randomPointOnLargeIsland,
+            &PathFinderTest::bulkRandomPoints,
+            &PathFinderTest::obstacleDistanceField,
+            &PathFinderTest::topDownView, &PathFinderTest::topDownMap,
+            &PathFinderTest::saveLoadNavMesh,
+            &PathFinderTest::navMeshVariants, &PathFinderTest::pathCache,
+            &PathFinderTest::hierarchicalPaths});
 
   addBenchmarks({&PathFinderTest::benchmarkSingleGoal}, 1000);
+  addBenchmarks({&PathFinderTest::benchmarkBatchedDistances}, 10);
   addInstancedBenchmarks({&PathFinderTest::benchmarkMultiGoal}, 100,
                          Cr::Containers::arraySize(MultiGoalBenchMarkData));
 }
@@ -124,6 +165,40 @@ void PathFinderTest::multiGoalPath() {
   }
 }
 
+void PathFinderTest::multiGoalPathManyEnds() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> ends;
+  for (int i = 0; i < 250; ++i) {
+    ends.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  for (int j = 0; j < 20; ++j) {
+    CORRADE_ITERATION(j);
+    esp::nav::MultiGoalShortestPath multiPath;
+    multiPath.requestedStart = pathFinder.getRandomNavigablePoint();
+    multiPath.setRequestedEnds(ends);
+    const bool found = pathFinder.findPath(multiPath);
+
+    esp::nav::ShortestPath path;
+    path.requestedStart = multiPath.requestedStart;
+    float trueMinDist = std::numeric_limits<float>::infinity();
+    for (const esp::vec3f& end : ends) {
+      path.requestedEnd = end;
+      if (pathFinder.findPath(path)) {
+        trueMinDist = std::min(trueMinDist, path.geodesicDistance);
+      }
+    }
+
+    CORRADE_COMPARE(found,
+                    trueMinDist != std::numeric_limits<float>::infinity());
+    CORRADE_COMPARE(multiPath.geodesicDistance, trueMinDist);
+  }
+}
+
 void PathFinderTest::testCaching() {
   esp::nav::PathFinder pathFinder;
   pathFinder.loadNavMesh(skokloster);
@@ -198,6 +273,616 @@ void PathFinderTest::benchmarkMultiGoal() {
   CORRADE_VERIFY(status);
 }
 
+void PathFinderTest::batchedPaths() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> starts, ends;
+  std::vector<esp::nav::ShortestPath> paths(1000);
+  for (esp::nav::ShortestPath& path : paths) {
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+    path.requestedEnd = pathFinder.getRandomNavigablePoint();
+    starts.push_back(path.requestedStart);
+    ends.push_back(path.requestedEnd);
+  }
+  // one start off the navmesh, which has no path
+  paths.back().requestedStart = starts.back() = esp::vec3f{1e3f, 1e3f, 1e3f};
+
+  const size_t found = pathFinder.findPaths(paths);
+  std::vector<float> distances(paths.size());
+  pathFinder.findGeodesicDistances(starts, ends, distances);
+
+  size_t expectedFound = 0;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    CORRADE_ITERATION(i);
+    esp::nav::ShortestPath path;
+    path.requestedStart = starts[i];
+    path.requestedEnd = ends[i];
+    if (pathFinder.findPath(path)) {
+      ++expectedFound;
+    }
+    CORRADE_COMPARE(paths[i].geodesicDistance, path.geodesicDistance);
+    CORRADE_COMPARE(paths[i].points.size(), path.points.size());
+    CORRADE_COMPARE(distances[i], path.geodesicDistance);
+  }
+  CORRADE_COMPARE(found, expectedFound);
+  CORRADE_COMPARE(distances.back(), std::numeric_limits<float>::infinity());
+}
+
+void PathFinderTest::batchedSteps() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> starts, ends;
+  for (int i = 0; i < 1000; ++i) {
+    starts.push_back(pathFinder.getRandomNavigablePoint());
+    // short steps like an agent would take, some off the navmesh
+    ends.push_back(starts.back() +
+                   esp::vec3f{0.25f * (i % 5), 0.0f, -0.25f * (i % 3)});
+  }
+  // one point nowhere near the navmesh, which can't be snapped
+  starts.back() = ends.back() = esp::vec3f{1e3f, 1e3f, 1e3f};
+
+  std::vector<esp::vec3f> steps(starts.size());
+  std::vector<esp::vec3f> stepsNoSliding(starts.size());
+  std::vector<esp::vec3f> snapped(starts.size());
+  Cr::Containers::Array<bool> navigable{Cr::Containers::ValueInit,
+                                        starts.size()};
+  pathFinder.trySteps(starts, ends, steps);
+  pathFinder.tryStepsNoSliding(starts, ends, stepsNoSliding);
+  pathFinder.snapPoints(ends, snapped);
+  pathFinder.areNavigable(ends, navigable);
+
+  for (size_t i = 0; i < starts.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(steps[i] == pathFinder.tryStep(starts[i], ends[i]));
+    CORRADE_VERIFY(stepsNoSliding[i] ==
+                   pathFinder.tryStepNoSliding(starts[i], ends[i]));
+    const esp::vec3f expectedSnapped = pathFinder.snapPoint(ends[i]);
+    CORRADE_VERIFY(snapped[i] == expectedSnapped ||
+                   (std::isnan(snapped[i][0]) &&
+                    std::isnan(expectedSnapped[0])));
+    CORRADE_COMPARE(navigable[i], pathFinder.isNavigable(ends[i]));
+  }
+  CORRADE_VERIFY(!navigable.back());
+}
+
+void PathFinderTest::concurrentQueries() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  constexpr int threadCount = 4;
+  constexpr int queryCount = 250;
+  std::vector<esp::vec3f> starts, ends;
+  for (int i = 0; i < threadCount * queryCount; ++i) {
+    starts.push_back(pathFinder.getRandomNavigablePoint());
+    ends.push_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  struct Result {
+    float geodesicDistance;
+    esp::vec3f step;
+    esp::vec3f snapped;
+    bool navigable;
+    float obstacleDistance;
+  };
+  auto query = [&](int i) {
+    esp::nav::ShortestPath path;
+    path.requestedStart = starts[i];
+    path.requestedEnd = ends[i];
+    pathFinder.findPath(path);
+    return Result{path.geodesicDistance,
+                  pathFinder.tryStep(starts[i], ends[i]),
+                  pathFinder.snapPoint(ends[i]),
+                  pathFinder.isNavigable(ends[i]),
+                  pathFinder.distanceToClosestObstacle(starts[i])};
+  };
+
+  std::vector<Result> results(starts.size());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = t * queryCount; i < (t + 1) * queryCount; ++i) {
+        results[i] = query(i);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    CORRADE_ITERATION(i);
+    const Result expected = query(i);
+    CORRADE_COMPARE(results[i].geodesicDistance, expected.geodesicDistance);
+    CORRADE_VERIFY(results[i].step == expected.step);
+    CORRADE_VERIFY(results[i].snapped == expected.snapped);
+    CORRADE_COMPARE(results[i].navigable, expected.navigable);
+    CORRADE_COMPARE(results[i].obstacleDistance, expected.obstacleDistance);
+  }
+}
+
+void PathFinderTest::geodesicDistanceField() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> goals;
+  for (int i = 0; i < 3; ++i) {
+    goals.push_back(pathFinder.getRandomNavigablePoint());
+  }
+  esp::nav::GeodesicDistanceField field;
+  field.setGoals(goals);
+
+  CORRADE_COMPARE(pathFinder.geodesicDistance(field, goals[0]), 0.0f);
+  CORRADE_COMPARE(
+      pathFinder.geodesicDistance(field, esp::vec3f{1e3f, 1e3f, 1e3f}),
+      std::numeric_limits<float>::infinity());
+
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    esp::nav::MultiGoalShortestPath path;
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+    path.setRequestedEnds(goals);
+    const bool found = pathFinder.findPath(path);
+
+    const float dist = pathFinder.geodesicDistance(field, path.requestedStart);
+    if (!found) {
+      continue;
+    }
+    // an upper bound, close to the exact distance
+    CORRADE_COMPARE_AS(dist, path.geodesicDistance - 1e-3f,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(dist, path.geodesicDistance * 1.1f + 0.1f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+}
+
+void PathFinderTest::distanceMatrix() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < 15; ++i) {
+    points.push_back(pathFinder.getRandomNavigablePoint());
+  }
+  points.emplace_back(1e3f, 1e3f, 1e3f);
+  const std::size_t count = points.size();
+
+  std::vector<float> distances(count * count);
+  pathFinder.distanceMatrix(points, distances);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    for (std::size_t j = 0; j < count; ++j) {
+      CORRADE_ITERATION(i * count + j);
+      const float dist = distances[i * count + j];
+      if (i == count - 1 || j == count - 1) {
+        CORRADE_COMPARE(dist, std::numeric_limits<float>::infinity());
+        continue;
+      }
+      if (i == j) {
+        CORRADE_COMPARE(dist, 0.0f);
+        continue;
+      }
+
+      esp::nav::ShortestPath path;
+      path.requestedStart = points[i];
+      path.requestedEnd = points[j];
+      if (!pathFinder.findPath(path)) {
+        CORRADE_COMPARE(dist, std::numeric_limits<float>::infinity());
+        continue;
+      }
+      // the same bounds as of the geodesic distance field
+      CORRADE_COMPARE_AS(dist, path.geodesicDistance - 1e-3f,
+                         Cr::TestSuite::Compare::GreaterOrEqual);
+      CORRADE_COMPARE_AS(dist, path.geodesicDistance * 1.1f + 0.1f,
+                         Cr::TestSuite::Compare::LessOrEqual);
+    }
+  }
+}
+
+void PathFinderTest::randomPointOnLargeIsland() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  float maxRadius = 0.0f;
+  for (int i = 0; i < 100; ++i) {
+    maxRadius = std::max(
+        maxRadius,
+        pathFinder.islandRadius(pathFinder.getRandomNavigablePoint()));
+  }
+  CORRADE_VERIFY(maxRadius > 0.0f);
+
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    const esp::vec3f pt = pathFinder.getRandomNavigablePoint(maxRadius);
+    CORRADE_VERIFY(pathFinder.isNavigable(pt));
+    CORRADE_COMPARE_AS(pathFinder.islandRadius(pt), maxRadius,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+  }
+
+  // no island is this large
+  const esp::vec3f pt = pathFinder.getRandomNavigablePoint(1.0e6f);
+  CORRADE_VERIFY(!std::isfinite(pt[0]));
+}
+
+void PathFinderTest::bulkRandomPoints() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  esp::nav::RandomPointConstraints constraints;
+  constraints.minHeight = -1.0f;
+  constraints.maxHeight = 1.0f;
+  const std::vector<esp::vec3f> points =
+      pathFinder.getRandomNavigablePoints(1000, 7, constraints);
+  CORRADE_COMPARE(points.size(), 1000);
+  for (size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(pathFinder.isNavigable(points[i]));
+    CORRADE_COMPARE_AS(points[i][1], constraints.minHeight,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(points[i][1], constraints.maxHeight,
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+
+  // every point has its own generator, so a shorter batch is a prefix and
+  // the result doesn't depend on how the points were split between threads
+  const std::vector<esp::vec3f> prefix =
+      pathFinder.getRandomNavigablePoints(100, 7, constraints);
+  for (size_t i = 0; i < prefix.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(Mn::Vector3{prefix[i]}, Mn::Vector3{points[i]});
+  }
+  CORRADE_VERIFY(pathFinder.getRandomNavigablePoints(100, 8, constraints) !=
+                 prefix);
+
+  // empty height band
+  constraints.minHeight = 100.0f;
+  constraints.maxHeight = 101.0f;
+  for (const esp::vec3f& pt :
+       pathFinder.getRandomNavigablePoints(10, 7, constraints)) {
+    CORRADE_VERIFY(!std::isfinite(pt[0]));
+  }
+}
+
+void PathFinderTest::obstacleDistanceField() {
+  esp::nav::PathFinder exact;
+  exact.loadNavMesh(skokloster);
+  CORRADE_VERIFY(exact.isLoaded());
+  exact.seed(0);
+
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_COMPARE(pathFinder.obstacleDistanceFieldCellSize(), 0.0f);
+  constexpr float cellSize = 0.05f;
+  pathFinder.setObstacleDistanceField(cellSize, 2.0f);
+  CORRADE_COMPARE(pathFinder.obstacleDistanceFieldCellSize(), cellSize);
+
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < 200; ++i) {
+    points.push_back(exact.getRandomNavigablePoint());
+  }
+
+  // the distance changes by at most the distance moved, so interpolating
+  // between nodes is off by at most the diagonal of a cell
+  std::vector<float> distances;
+  for (size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    const float distance = pathFinder.distanceToClosestObstacle(points[i]);
+    CORRADE_COMPARE_AS(std::abs(distance -
+                                exact.distanceToClosestObstacle(points[i])),
+                       1.5f * cellSize, Cr::TestSuite::Compare::LessOrEqual);
+    CORRADE_COMPARE_AS(distance, 2.0f, Cr::TestSuite::Compare::LessOrEqual);
+    // a smaller radius clamps the sampled distance
+    CORRADE_COMPARE_AS(pathFinder.distanceToClosestObstacle(points[i], 0.1f),
+                       0.1f, Cr::TestSuite::Compare::LessOrEqual);
+    // a larger one than the field was built with searches the navmesh
+    CORRADE_COMPARE(pathFinder.distanceToClosestObstacle(points[i], 3.0f),
+                    exact.distanceToClosestObstacle(points[i], 3.0f));
+    distances.push_back(distance);
+  }
+
+  // the field is saved with the navmesh and used right away when loaded
+  const std::string filename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "PathFinderTestObstacleField.navmesh");
+  CORRADE_VERIFY(pathFinder.saveNavMesh(filename));
+  esp::nav::PathFinder loaded;
+  CORRADE_VERIFY(loaded.loadNavMesh(filename));
+  CORRADE_COMPARE(loaded.obstacleDistanceFieldCellSize(), cellSize);
+  for (size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(loaded.distanceToClosestObstacle(points[i]), distances[i]);
+  }
+  Cr::Utility::Directory::rm(filename);
+}
+
+void PathFinderTest::topDownView() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  constexpr float pixelsPerMeter = 0.1f;
+  const float height = pathFinder.getRandomNavigablePoint()[1];
+  const auto topDown = pathFinder.getTopDownView(pixelsPerMeter, height);
+  const esp::vec3f start = pathFinder.bounds().first;
+
+  // the rasterized pixels match sampling each of them with isNavigable()
+  // except for a few exactly along the polygon edges
+  int navigable = 0;
+  int mismatched = 0;
+  for (int h = 0; h < topDown.rows(); ++h) {
+    for (int w = 0; w < topDown.cols(); ++w) {
+      const esp::vec3f pt{start[0] + w * pixelsPerMeter, height,
+                          start[2] + h * pixelsPerMeter};
+      const bool expected = pathFinder.isNavigable(pt, 0.5f);
+      navigable += expected;
+      mismatched += expected != topDown(h, w);
+    }
+  }
+  CORRADE_VERIFY(navigable > 0);
+  CORRADE_COMPARE_AS(mismatched, navigable / 100,
+                     Cr::TestSuite::Compare::LessOrEqual);
+
+  // cached
+  CORRADE_VERIFY(pathFinder.getTopDownView(pixelsPerMeter, height) == topDown);
+}
+
+void PathFinderTest::topDownMap() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  constexpr float pixelsPerMeter = 0.1f;
+  const esp::vec3f position = pathFinder.getRandomNavigablePoint();
+  esp::nav::TopDownMap map{pathFinder, pixelsPerMeter, position[1]};
+  CORRADE_VERIFY(map.navigable() ==
+                 pathFinder.getTopDownView(pixelsPerMeter, position[1]));
+  CORRADE_COMPARE(map.visible().count(), 0);
+
+  // looking down -Z sees only pixels in front of the agent, within range
+  const int seen =
+      map.updateVisibility(position, esp::quatf::Identity(), 90.0f, 3.0f);
+  CORRADE_VERIFY(seen > 0);
+  CORRADE_COMPARE(map.visible().count(), seen);
+  const esp::vec2i origin = map.toGrid(position);
+  CORRADE_VERIFY(map.visible()(origin[0], origin[1]));
+  for (int h = 0; h < map.visible().rows(); ++h) {
+    for (int w = 0; w < map.visible().cols(); ++w) {
+      if (!map.visible()(h, w))
+        continue;
+      CORRADE_ITERATION(h << w);
+      CORRADE_COMPARE_AS(h, origin[0] + 1,
+                         Cr::TestSuite::Compare::LessOrEqual);
+      CORRADE_COMPARE_AS(
+          (esp::vec2i{h, w} - origin).cast<float>().norm() * pixelsPerMeter,
+          3.0f + 2.0f * pixelsPerMeter, Cr::TestSuite::Compare::LessOrEqual);
+    }
+  }
+
+  // the same view adds nothing, turning around does
+  CORRADE_COMPARE(
+      map.updateVisibility(position, esp::quatf::Identity(), 90.0f, 3.0f), 0);
+  const esp::quatf behind{Eigen::AngleAxisf{float(M_PI), esp::vec3f::UnitY()}};
+  CORRADE_VERIFY(map.updateVisibility(position, behind, 90.0f, 3.0f) > 0);
+
+  map.resetVisibility();
+  CORRADE_COMPARE(map.visible().count(), 0);
+}
+
+void PathFinderTest::saveLoadNavMesh() {
+  esp::nav::PathFinder mapped;
+  CORRADE_VERIFY(mapped.loadNavMesh(skokloster));
+  esp::nav::PathFinder read;
+  CORRADE_VERIFY(read.loadNavMesh(skokloster, /*mapFile=*/false));
+  read.seed(0);
+
+  std::vector<esp::vec3f> starts, ends;
+  for (int i = 0; i < 100; ++i) {
+    starts.push_back(read.getRandomNavigablePoint());
+    ends.push_back(read.getRandomNavigablePoint());
+  }
+  std::vector<float> expected(starts.size());
+  read.findGeodesicDistances(starts, ends, expected);
+
+  auto verify = [&](esp::nav::PathFinder& pathFinder) {
+    std::vector<float> distances(starts.size());
+    pathFinder.findGeodesicDistances(starts, ends, distances);
+    for (size_t i = 0; i < distances.size(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(distances[i], expected[i]);
+    }
+  };
+  verify(mapped);
+
+  const std::string filename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "PathFinderTestSaveLoad.navmesh");
+  // saving over the file a pathfinder has mapped replaces it, so that
+  // pathfinder keeps working
+  CORRADE_VERIFY(mapped.saveNavMesh(filename));
+  esp::nav::PathFinder saved;
+  CORRADE_VERIFY(saved.loadNavMesh(filename));
+  CORRADE_VERIFY(saved.saveNavMesh(filename));
+  verify(saved);
+
+#ifdef ESP_BUILD_WITH_ZLIB
+  const std::string compressedFilename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "PathFinderTestCompressed.navmesh");
+  CORRADE_VERIFY(saved.saveNavMesh(compressedFilename, /*compress=*/true));
+  CORRADE_COMPARE_AS(Cr::Utility::Directory::read(compressedFilename).size(),
+                     Cr::Utility::Directory::read(filename).size(),
+                     Cr::TestSuite::Compare::Less);
+  esp::nav::PathFinder compressed;
+  CORRADE_VERIFY(compressed.loadNavMesh(compressedFilename));
+  verify(compressed);
+  Cr::Utility::Directory::rm(compressedFilename);
+#else
+  CORRADE_VERIFY(!saved.saveNavMesh(filename, /*compress=*/true));
+#endif
+  Cr::Utility::Directory::rm(filename);
+}
+
+void PathFinderTest::navMeshVariants() {
+  // the triangles of an existing navmesh are the walkable surface to build
+  // from
+  esp::nav::PathFinder source;
+  source.loadNavMesh(skokloster);
+  CORRADE_VERIFY(source.isLoaded());
+  const std::shared_ptr<esp::assets::MeshData> mesh = source.getNavMeshData();
+  CORRADE_VERIFY(mesh);
+
+  std::vector<esp::nav::NavMeshSettings> variants;
+  for (int tileSize : {0, 64}) {
+    for (float radius : {0.1f, 0.2f, 0.3f}) {
+      esp::nav::NavMeshSettings settings;
+      settings.setDefaults();
+      settings.agentRadius = radius;
+      settings.agentHeight = 1.0f + radius;
+      settings.tileSize = tileSize;
+      variants.push_back(settings);
+    }
+  }
+
+  const std::vector<esp::nav::PathFinder::ptr> pathFinders =
+      esp::nav::PathFinder::buildVariants(variants, *mesh);
+  CORRADE_COMPARE(pathFinders.size(), variants.size());
+  for (std::size_t i = 0; i < variants.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(pathFinders[i]);
+    CORRADE_VERIFY(pathFinders[i]->isLoaded());
+
+    // single tile variants and the tiled one with the largest radius are
+    // the same as built alone
+    if (variants[i].tileSize && variants[i].agentRadius < 0.3f) {
+      continue;
+    }
+    esp::nav::PathFinder expected;
+    CORRADE_VERIFY(expected.build(variants[i], *mesh));
+    CORRADE_COMPARE(pathFinders[i]->getNavMeshData()->vbo.size(),
+                    expected.getNavMeshData()->vbo.size());
+    CORRADE_COMPARE(pathFinders[i]->getNavMeshData()->ibo,
+                    expected.getNavMeshData()->ibo);
+  }
+
+  // a larger agent fits in fewer places
+  CORRADE_COMPARE_AS(pathFinders[2]->getNavMeshData()->ibo.size(),
+                     pathFinders[0]->getNavMeshData()->ibo.size(),
+                     Cr::TestSuite::Compare::LessOrEqual);
+}
+
+void PathFinderTest::pathCache() {
+  esp::nav::PathFinder uncached;
+  uncached.loadNavMesh(skokloster);
+  CORRADE_VERIFY(uncached.isLoaded());
+  uncached.seed(0);
+
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  pathFinder.setPathCache(8);
+  CORRADE_COMPARE(pathFinder.pathCacheStatistics().capacity, 8);
+
+  std::vector<esp::nav::ShortestPath> paths(10);
+  for (esp::nav::ShortestPath& path : paths) {
+    path.requestedStart = uncached.getRandomNavigablePoint();
+    path.requestedEnd = uncached.getRandomNavigablePoint();
+  }
+
+  // the last eight pairs are repeated, the first two get evicted by them
+  for (int round = 0; round != 3; ++round) {
+    for (size_t i = round ? 2 : 0; i < paths.size(); ++i) {
+      CORRADE_ITERATION(round << ": " << i);
+      esp::nav::ShortestPath expected = paths[i];
+      const bool expectedFound = uncached.findPath(expected);
+      esp::nav::ShortestPath path = paths[i];
+      CORRADE_COMPARE(pathFinder.findPath(path), expectedFound);
+      CORRADE_COMPARE(path.geodesicDistance, expected.geodesicDistance);
+      CORRADE_VERIFY(path.points == expected.points);
+    }
+  }
+  esp::nav::PathCacheStatistics statistics = pathFinder.pathCacheStatistics();
+  CORRADE_COMPARE(statistics.misses, 10);
+  CORRADE_COMPARE(statistics.hits, 16);
+  CORRADE_COMPARE(statistics.size, 8);
+
+  // an evicted pair is searched again
+  pathFinder.findPath(paths[0]);
+  CORRADE_COMPARE(pathFinder.pathCacheStatistics().misses, 11);
+
+  // a new navmesh empties the cache but keeps the statistics
+  pathFinder.loadNavMesh(skokloster);
+  statistics = pathFinder.pathCacheStatistics();
+  CORRADE_COMPARE(statistics.size, 0);
+  CORRADE_COMPARE(statistics.misses, 11);
+}
+
+void PathFinderTest::hierarchicalPaths() {
+  esp::nav::PathFinder exact;
+  exact.loadNavMesh(skokloster);
+  CORRADE_VERIFY(exact.isLoaded());
+  exact.seed(0);
+
+  esp::nav::PathFinder pathFinder;
+  pathFinder.setHierarchicalPathfinding(2.0f, 0.0f);
+  CORRADE_COMPARE(pathFinder.hierarchicalPathfindingClusterSize(), 2.0f);
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    esp::nav::ShortestPath expected;
+    expected.requestedStart = exact.getRandomNavigablePoint();
+    expected.requestedEnd = exact.getRandomNavigablePoint();
+    esp::nav::ShortestPath path = expected;
+    if (!exact.findPath(expected)) {
+      continue;
+    }
+    CORRADE_VERIFY(pathFinder.findPath(path));
+    CORRADE_VERIFY(path.points.front().isApprox(expected.points.front()));
+    CORRADE_VERIFY(path.points.back().isApprox(expected.points.back()));
+    // the corridors differ, and neither search is exactly optimal
+    CORRADE_COMPARE_AS(path.geodesicDistance,
+                       expected.geodesicDistance * 0.9f - 0.1f,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(path.geodesicDistance,
+                       expected.geodesicDistance * 1.25f + 0.5f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+
+  pathFinder.setHierarchicalPathfinding(0.0f);
+  CORRADE_COMPARE(pathFinder.hierarchicalPathfindingClusterSize(), 0.0f);
+}
+
+void PathFinderTest::benchmarkBatchedDistances() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  std::vector<esp::vec3f> starts, ends;
+  for (int i = 0; i < 10000; ++i) {
+    starts.emplace_back(pathFinder.getRandomNavigablePoint());
+    ends.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+  std::vector<float> distances(starts.size());
+
+  CORRADE_BENCHMARK(1) {
+    pathFinder.findGeodesicDistances(starts, ends, distances);
+  };
+  CORRADE_VERIFY(!distances.empty());
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(PathFinderTest)
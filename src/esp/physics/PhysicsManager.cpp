@@ -3,7 +3,16 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PhysicsManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <typeinfo>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+
 #include "esp/assets/CollisionMeshData.h"
+#include "esp/core/Metrics.h"
+#include "esp/core/Profiler.h"
 
 #include <Magnum/Math/Range.h>
 
@@ -66,11 +75,26 @@ int PhysicsManager::addObject(const int objectLibIndex,
   //! Test Mesh primitive is valid
   assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
       resourceManager_.getPhysicsObjectAttributes(objectLibIndex);
+  // templates registered lazily get their meshes on first use
+  if (!resourceManager_.loadObjectTemplateAssets(objectLibIndex)) {
+    LOG(ERROR) << "Cannot load the meshes of object template "
+               << objectLibIndex;
+    return ID_UNDEFINED;
+  }
   const std::vector<assets::CollisionMeshData>& meshGroup =
       resourceManager_.getCollisionMesh(objectLibIndex);
 
   //! Make rigid object and add it to existingObjects
   int nextObjectID_ = allocateObjectID();
+  if (attachmentNode == nullptr &&
+      addPooledObject(nextObjectID_, objectLibIndex)) {
+    RigidObject& object = *existingObjects_.at(nextObjectID_);
+    resourceManager_.addObjectToDrawables(objectLibIndex, object.visualNode_,
+                                          drawables, lightSetup);
+    object.node().computeCumulativeBB();
+    poolableObjects_.emplace(nextObjectID_, objectLibIndex);
+    return nextObjectID_;
+  }
   scene::SceneNode* objectNode = attachmentNode;
   if (attachmentNode == nullptr) {
     objectNode = &staticSceneObject_->node().createChild();
@@ -110,6 +134,9 @@ int PhysicsManager::addObject(const int objectLibIndex,
   // finalize rigid object creation
   existingObjects_.at(nextObjectID_)->finalizeObject();
 
+  if (attachmentNode == nullptr) {
+    poolableObjects_.emplace(nextObjectID_, objectLibIndex);
+  }
   return nextObjectID_;
 }
 
@@ -128,9 +155,30 @@ void PhysicsManager::removeObject(const int physObjectID,
                                   bool deleteObjectNode,
                                   bool deleteVisualNode) {
   assertIDValidity(physObjectID);
+  const auto poolable = poolableObjects_.find(physObjectID);
+  if (objectPooling_ && deleteObjectNode &&
+      poolable != poolableObjects_.end()) {
+    const int objectLibIndex = poolable->second;
+    poolableObjects_.erase(physObjectID);
+    RigidObject::uptr object = std::move(existingObjects_.at(physObjectID));
+    existingObjects_.erase(physObjectID);
+    deallocateObjectID(physObjectID);
+    // the drawables and the bounding box are all below the visual node, they
+    // get added again on reuse
+    scene::SceneNode& visualNode = *object->visualNode_;
+    while (visualNode.children().first()) {
+      delete visualNode.children().first();
+    }
+    object->BBNode_ = nullptr;
+    object->setPooled(true);
+    objectPool_[objectLibIndex].push_back(std::move(object));
+    return;
+  }
+
   scene::SceneNode* objectNode = &existingObjects_.at(physObjectID)->node();
   scene::SceneNode* visualNode = existingObjects_.at(physObjectID)->visualNode_;
   existingObjects_.erase(physObjectID);
+  poolableObjects_.erase(physObjectID);
   deallocateObjectID(physObjectID);
   if (deleteObjectNode) {
     delete objectNode;
@@ -139,6 +187,44 @@ void PhysicsManager::removeObject(const int physObjectID,
   }
 }
 
+void PhysicsManager::setObjectPooling(bool enabled) {
+  objectPooling_ = enabled;
+  if (!enabled) {
+    clearObjectPool();
+  }
+}
+
+int PhysicsManager::getNumPooledObjects() const {
+  int count = 0;
+  for (const auto& pool : objectPool_) {
+    count += pool.second.size();
+  }
+  return count;
+}
+
+void PhysicsManager::clearObjectPool() {
+  for (auto& pool : objectPool_) {
+    for (RigidObject::uptr& object : pool.second) {
+      scene::SceneNode* objectNode = &object->node();
+      object.reset();
+      delete objectNode;
+    }
+  }
+  objectPool_.clear();
+}
+
+bool PhysicsManager::addPooledObject(int newObjectID, int objectLibIndex) {
+  const auto found = objectPool_.find(objectLibIndex);
+  if (found == objectPool_.end() || found->second.empty()) {
+    return false;
+  }
+  RigidObject::uptr object = std::move(found->second.back());
+  found->second.pop_back();
+  object->setPooled(false);
+  existingObjects_.emplace(newObjectID, std::move(object));
+  return true;
+}
+
 bool PhysicsManager::setObjectMotionType(const int physObjectID,
                                          MotionType mt) {
   assertIDValidity(physObjectID);
@@ -150,6 +236,18 @@ MotionType PhysicsManager::getObjectMotionType(const int physObjectID) const {
   return existingObjects_.at(physObjectID)->getMotionType();
 }
 
+void PhysicsManager::setObjectKinematicCollisions(const int physObjectID,
+                                                  bool enabled) {
+  assertIDValidity(physObjectID);
+  existingObjects_.at(physObjectID)->setKinematicCollisions(enabled);
+}
+
+bool PhysicsManager::getObjectKinematicCollisions(
+    const int physObjectID) const {
+  assertIDValidity(physObjectID);
+  return existingObjects_.at(physObjectID)->getKinematicCollisions();
+}
+
 int PhysicsManager::allocateObjectID() {
   if (!recycledObjectIDs_.empty()) {
     int recycledID = recycledObjectIDs_.back();
@@ -199,6 +297,7 @@ Magnum::Vector3 PhysicsManager::getGravity() const {
 }
 
 void PhysicsManager::stepPhysics(double dt) {
+  ESP_PROFILE_SCOPE("PhysicsManager::stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -213,20 +312,232 @@ void PhysicsManager::stepPhysics(double dt) {
 
   // handle in-between step times? Ideally dt is a multiple of
   // sceneMetaData_.timestep
-  double targetTime = worldTime_ + dt;
-  while (worldTime_ < targetTime) {
+  const double targetTime = worldTime_ + dt;
+  int numSubSteps = 0;
+  for (double time = worldTime_; time < targetTime; time += fixedTimeStep_) {
+    ++numSubSteps;
+  }
+  stepPhysicsSubSteps(numSubSteps);
+}
+
+void PhysicsManager::stepPhysicsSubSteps(int numSubSteps) {
+  // We don't step uninitialized physics sim...
+  if (!initialized_) {
+    return;
+  }
+
+  stepStatistics_ = {};
+  stepStatistics_.startTime = profilerTime();
+  if (numSubSteps > 0) {
     // per fixed-step operations can be added here
 
     // kinematic velocity control intergration
-    for (auto& object : existingObjects_) {
-      VelocityControl::ptr velControl = object.second->getVelocityControl();
-      if (velControl->controllingAngVel || velControl->controllingLinVel) {
-        scene::SceneNode& objectSceneNode = object.second->node();
-        objectSceneNode.setTransformation(velControl->integrateTransform(
-            fixedTimeStep_, objectSceneNode.transformation()));
+    integrateVelocityControls(fixedTimeStep_, numSubSteps, false);
+    worldTime_ += numSubSteps * fixedTimeStep_;
+    stepStatistics_.subSteps = numSubSteps;
+
+    // nothing is simulated actively without a physics engine, only velocity
+    // controlled objects move
+    stepStatistics_.syncedObjects = velControlBatch_.objectIDs.size();
+  }
+  stepStatistics_.totalTime = profilerTime() - stepStatistics_.startTime;
+  recordStepMetrics();
+}
+
+void PhysicsManager::recordStepMetrics() const {
+  static core::Metrics::Counter& steps =
+      core::Metrics::counter("physics.steps");
+  static core::Metrics::Counter& activeObjects =
+      core::Metrics::counter("physics.active_objects");
+  static core::Metrics::Histogram& stepTime =
+      core::Metrics::histogram("physics.step_us");
+  steps.add();
+  activeObjects.set(stepStatistics_.activeObjects);
+  stepTime.record(stepStatistics_.totalTime * 1000.0);
+}
+
+void PhysicsManager::integrateVelocityControls(double dt,
+                                               int numSteps,
+                                               bool kinematicOnly) {
+  VelocityControlBatch& batch = velControlBatch_;
+  batch.objectIDs.clear();
+  batch.nodes.clear();
+  batch.controls.clear();
+  batch.transforms.clear();
+
+  for (auto& object : existingObjects_) {
+    if (kinematicOnly &&
+        object.second->getMotionType() != MotionType::KINEMATIC) {
+      continue;
+    }
+    const VelocityControl::ptr& velControl =
+        object.second->getVelocityControl();
+    if (!velControl->controllingAngVel && !velControl->controllingLinVel) {
+      continue;
+    }
+    batch.objectIDs.push_back(object.first);
+
+    scene::SceneNode& objectSceneNode = object.second->node();
+    if (typeid(*velControl) != typeid(VelocityControl)) {
+      // custom integration, can't be batched
+      Magnum::Matrix4 transform = objectSceneNode.transformation();
+      for (int i = 0; i < numSteps; ++i) {
+        transform = velControl->integrateTransform(dt, transform);
       }
+      objectSceneNode.setTransformation(transform);
+      continue;
+    }
+    batch.nodes.push_back(&objectSceneNode);
+    batch.controls.push_back(*velControl);
+    batch.transforms.push_back(objectSceneNode.transformation());
+  }
+
+  for (int i = 0; i < numSteps; ++i) {
+    VelocityControl::integrateTransforms(dt, batch.controls, batch.transforms);
+  }
+  for (std::size_t i = 0; i != batch.nodes.size(); ++i) {
+    batch.nodes[i]->setTransformation(batch.transforms[i]);
+  }
+}
+
+double PhysicsManager::profilerTime() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+PhysicsState PhysicsManager::saveState() const {
+  PhysicsState state;
+  state.worldTime = worldTime_;
+  state.objects.reserve(existingObjects_.size());
+  // existingObjects_ is iterated by ID, so the objects end up sorted by ID
+  for (const auto& object : existingObjects_) {
+    RigidObject& rigidObject = *object.second;
+    const auto poolable = poolableObjects_.find(object.first);
+    state.objects.push_back(
+        {object.first, rigidObject.getMotionType(), rigidObject.isActive(),
+         rigidObject.node().transformationMatrix(),
+         rigidObject.getLinearVelocity(), rigidObject.getAngularVelocity(),
+         poolable != poolableObjects_.end() ? poolable->second
+                                            : ID_UNDEFINED,
+         existingObjects_.generation(object.first)});
+  }
+  state.nextObjectID = nextObjectID_;
+  state.recycledObjectIDs = recycledObjectIDs_;
+  return state;
+}
+
+bool PhysicsManager::restoreState(const PhysicsState& state) {
+  if (state.objects.size() != existingObjects_.size()) {
+    return false;
+  }
+  {
+    auto object = existingObjects_.begin();
+    for (const PhysicsState::ObjectState& objectState : state.objects) {
+      if (object->first != objectState.objectID ||
+          !matchesObjectState(objectState)) {
+        return false;
+      }
+      ++object;
+    }
+  }
+
+  auto object = existingObjects_.begin();
+  for (const PhysicsState::ObjectState& objectState : state.objects) {
+    RigidObject& rigidObject = *(object++)->second;
+    // the motion type first, static objects can't be moved
+    if (rigidObject.getMotionType() != objectState.motionType) {
+      rigidObject.setMotionType(objectState.motionType);
+    }
+    rigidObject.setTransformation(objectState.transformation);
+    rigidObject.setLinearVelocity(objectState.linearVelocity);
+    rigidObject.setAngularVelocity(objectState.angularVelocity);
+    if (objectState.active) {
+      rigidObject.setActive();
+    } else {
+      rigidObject.setSleeping();
+    }
+  }
+  worldTime_ = state.worldTime;
+  return true;
+}
+
+bool PhysicsManager::restoreState(const PhysicsState& state,
+                                  DrawableGroup* drawables) {
+  // only objects made from a template without an attachment node can be
+  // added again
+  std::vector<const PhysicsState::ObjectState*> removed;
+  std::vector<int> added;
+  for (const PhysicsState::ObjectState& objectState : state.objects) {
+    if (!matchesObjectState(objectState)) {
+      if (objectState.templateIndex == ID_UNDEFINED) {
+        return false;
+      }
+      // an object that took over the ID is replaced by the old one
+      if (existingObjects_.contains(objectState.objectID)) {
+        added.push_back(objectState.objectID);
+      }
+      removed.push_back(&objectState);
+    }
+  }
+
+  for (const auto& object : existingObjects_) {
+    const auto found = std::lower_bound(
+        state.objects.begin(), state.objects.end(), object.first,
+        [](const PhysicsState::ObjectState& objectState, int id) {
+          return objectState.objectID < id;
+        });
+    if (found == state.objects.end() || found->objectID != object.first) {
+      added.push_back(object.first);
+    }
+  }
+  for (int id : added) {
+    removeObject(id);
+  }
+  for (const PhysicsState::ObjectState* objectState : removed) {
+    // the next allocated ID is the old one
+    recycledObjectIDs_.push_back(objectState->objectID);
+    if (addObject(objectState->templateIndex, drawables) == ID_UNDEFINED) {
+      LOG(ERROR) << "PhysicsManager::restoreState(): cannot add object "
+                 << objectState->objectID << " again";
+      return false;
+    }
+  }
+  nextObjectID_ = state.nextObjectID;
+  recycledObjectIDs_ = state.recycledObjectIDs;
+  return restoreState(state);
+}
+
+bool PhysicsManager::matchesObjectState(
+    const PhysicsState::ObjectState& objectState) const {
+  if (!existingObjects_.contains(objectState.objectID)) {
+    return false;
+  }
+  const auto poolable = poolableObjects_.find(objectState.objectID);
+  const int templateIndex =
+      poolable != poolableObjects_.end() ? poolable->second : ID_UNDEFINED;
+  if (templateIndex != objectState.templateIndex) {
+    return false;
+  }
+  // objects made from a template are added again under their ID by
+  // restoreState(const PhysicsState&, DrawableGroup*), which doesn't keep the
+  // generation, and are interchangeable with any other object of the
+  // template. Others can't be added again, so a new generation means a
+  // different object.
+  return templateIndex != ID_UNDEFINED ||
+         existingObjects_.generation(objectState.objectID) ==
+             objectState.generation;
+}
+
+void PhysicsManager::stepWorlds(const std::vector<PhysicsManager*>& worlds,
+                                double dt) {
+  const int worldCount = worlds.size();
+  // Worlds differ a lot in cost, so hand them out one by one
+#pragma omp parallel for schedule(dynamic, 1)
+  for (int i = 0; i < worldCount; ++i) {
+    if (worlds[i]) {
+      worlds[i]->stepPhysics(dt);
     }
-    worldTime_ += fixedTimeStep_;
   }
 }
 
@@ -398,6 +709,121 @@ Magnum::Vector3 PhysicsManager::getAngularVelocity(
   return existingObjects_.at(physObjectID)->getAngularVelocity();
 }
 
+namespace {
+// Calls f(i, object) for the i-th of physObjectIDs, or for all objects in ID
+// order if empty, with one lookup per object
+template <class F>
+void forEachObject(const core::SlotMap<RigidObject::uptr>& objects,
+                   Corrade::Containers::ArrayView<const int> physObjectIDs,
+                   std::size_t valueCount,
+                   F f) {
+  if (physObjectIDs.empty()) {
+    CHECK_EQ(valueCount, objects.size());
+    std::size_t i = 0;
+    for (const auto& object : objects) {
+      f(i++, *object.second);
+    }
+    return;
+  }
+
+  CHECK_EQ(valueCount, physObjectIDs.size());
+  for (std::size_t i = 0; i != physObjectIDs.size(); ++i) {
+    const auto found = objects.find(physObjectIDs[i]);
+    CHECK(found != objects.end());
+    f(i, *found->second);
+  }
+}
+}  // namespace
+
+void PhysicsManager::contactTests(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<bool> results) {
+  forEachObject(existingObjects_, physObjectIDs, results.size(),
+                [&](std::size_t i, RigidObject&) { results[i] = false; });
+}
+
+void PhysicsManager::castRays(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    float,
+    Corrade::Containers::ArrayView<RayHit> hits) {
+  CHECK_EQ(origins.size(), directions.size());
+  CHECK_EQ(origins.size(), hits.size());
+  std::fill(hits.begin(), hits.end(), RayHit{});
+}
+
+void PhysicsManager::getTranslations(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> translations) const {
+  forEachObject(existingObjects_, physObjectIDs, translations.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  translations[i] = object.node().translation();
+                });
+}
+
+void PhysicsManager::getRotations(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<Magnum::Quaternion> rotations) const {
+  forEachObject(existingObjects_, physObjectIDs, rotations.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  rotations[i] = object.node().rotation();
+                });
+}
+
+void PhysicsManager::getLinearVelocities(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> linVels) const {
+  forEachObject(existingObjects_, physObjectIDs, linVels.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  linVels[i] = object.getLinearVelocity();
+                });
+}
+
+void PhysicsManager::getAngularVelocities(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> angVels) const {
+  forEachObject(existingObjects_, physObjectIDs, angVels.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  angVels[i] = object.getAngularVelocity();
+                });
+}
+
+void PhysicsManager::setTranslations(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> translations) {
+  forEachObject(existingObjects_, physObjectIDs, translations.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  object.setTranslation(translations[i]);
+                });
+}
+
+void PhysicsManager::setRotations(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Quaternion> rotations) {
+  forEachObject(existingObjects_, physObjectIDs, rotations.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  object.setRotation(rotations[i]);
+                });
+}
+
+void PhysicsManager::setLinearVelocities(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> linVels) {
+  forEachObject(existingObjects_, physObjectIDs, linVels.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  object.setLinearVelocity(linVels[i]);
+                });
+}
+
+void PhysicsManager::setAngularVelocities(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> angVels) {
+  forEachObject(existingObjects_, physObjectIDs, angVels.size(),
+                [&](std::size_t i, RigidObject& object) {
+                  object.setAngularVelocity(angVels[i]);
+                });
+}
+
 VelocityControl::ptr PhysicsManager::getVelocityControl(
     const int physObjectID) {
   assertIDValidity(physObjectID);
@@ -512,7 +938,7 @@ void PhysicsManager::setObjectBBDraw(int physObjectID,
     existingObjects_.at(physObjectID)->BBNode_->MagnumObject::setScaling(scale);
     existingObjects_.at(physObjectID)
         ->BBNode_->MagnumObject::setTranslation(
-            existingObjects_[physObjectID]
+            existingObjects_.at(physObjectID)
                 ->visualNode_->getCumulativeBB()
                 .center());
     resourceManager_.addPrimitiveToDrawables(
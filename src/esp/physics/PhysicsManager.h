@@ -9,11 +9,14 @@
  * esp::physics::PhysicsManager::PhysicsSimulationLibrary
  */
 
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <Corrade/Containers/ArrayView.h>
+
 /* Bullet Physics Integration */
 
 #include "RigidObject.h"
@@ -24,6 +27,7 @@
 #include "esp/assets/MeshData.h"
 #include "esp/assets/MeshMetaData.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/SlotMap.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "esp/scene/SceneNode.h"
 
@@ -32,6 +36,102 @@ namespace esp {
 //! core physics simulation namespace
 namespace physics {
 
+/**
+@brief Snapshot of the simulated state of all objects in a physical world
+
+Made by @ref PhysicsManager::saveState() and applied with @ref
+PhysicsManager::restoreState(). Objects are sorted by ID and stored as plain
+data, so copying a snapshot is a single allocation and a memcpy.
+*/
+struct PhysicsState {
+  /** @brief State of one object */
+  struct ObjectState {
+    /** @brief The object ID in @ref PhysicsManager::existingObjects_ */
+    int objectID;
+    /** @brief The object's @ref MotionType */
+    MotionType motionType;
+    /** @brief Whether the object was being actively simulated */
+    bool active;
+    /** @brief Transformation of the object's node relative to its parent */
+    Magnum::Matrix4 transformation;
+    /** @brief Linear velocity */
+    Magnum::Vector3 linearVelocity;
+    /** @brief Angular velocity */
+    Magnum::Vector3 angularVelocity;
+    /**
+     * @brief Index of the template the object was made from, @ref
+     * ID_UNDEFINED for objects added to an attachment node
+     */
+    int templateIndex;
+    /**
+     * @brief The @ref PhysicsManager::getObjectGeneration() of the object
+     * ID, to tell the object apart from later ones getting the same ID
+     */
+    uint32_t generation;
+  };
+
+  /** @brief The world time the snapshot was taken at */
+  double worldTime = 0.0;
+  /** @brief The objects, sorted by ID */
+  std::vector<ObjectState> objects;
+  /**
+   * @brief Object ID allocation at the time of the snapshot, so objects
+   * added after restoring it get the same IDs again
+   */
+  int nextObjectID = 0;
+  std::vector<int> recycledObjectIDs;
+};
+
+/**
+@brief Closest hit of a ray cast with @ref PhysicsManager::castRays()
+*/
+struct RayHit {
+  /** @brief Distance along the ray, infinite if nothing was hit */
+  float distance = std::numeric_limits<float>::infinity();
+  /** @brief Hit point in world space */
+  Magnum::Vector3 point;
+  /** @brief Surface normal at the hit point in world space */
+  Magnum::Vector3 normal;
+  /** @brief ID of the hit object, @ref ID_UNDEFINED for the scene or a miss */
+  int objectID = ID_UNDEFINED;
+};
+
+/**
+@brief Object counts and timings of the last @ref PhysicsManager::stepPhysics()
+call, for profiling
+
+Static objects are not counted. Times are in milliseconds and summed over all
+substeps of the step. The phase breakdown comes from Bullet's built-in
+profiler and stays zero if it is compiled out or no physics engine is used.
+*/
+struct StepStatistics {
+  /** @brief Number of objects simulated actively after the step */
+  int activeObjects = 0;
+  /** @brief Number of objects whose node pose was updated by the step */
+  int syncedObjects = 0;
+  /** @brief Number of objects asleep after the step */
+  int sleepingObjects = 0;
+  /** @brief Whether the step was skipped as every object was asleep */
+  bool skipped = false;
+  /** @brief Number of fixed substeps simulated */
+  int subSteps = 0;
+
+  /** @brief Start of the step on a steady clock with an arbitrary epoch */
+  double startTime = 0.0;
+  /** @brief Duration of the whole step */
+  double totalTime = 0.0;
+  /** @brief Time spent updating bounding boxes and finding overlapping pairs */
+  double broadphaseTime = 0.0;
+  /** @brief Time spent computing contacts of overlapping pairs */
+  double narrowphaseTime = 0.0;
+  /** @brief Time spent solving contacts and constraints */
+  double solverTime = 0.0;
+  /** @brief Time spent integrating velocities and transformations */
+  double integrationTime = 0.0;
+  /** @brief Time spent syncing simulated poses back to the nodes */
+  double syncPoseTime = 0.0;
+};
+
 // TODO: repurpose to manage multiple physical worlds. Currently represents
 // exactly one world.
 
@@ -185,6 +285,31 @@ class PhysicsManager {
                             bool deleteObjectNode = true,
                             bool deleteVisualNode = true);
 
+  /** @brief Keep removed objects for reuse instead of destroying them. An
+   * object added without an attachment node and removed together with its
+   * node goes to a pool of its template, out of simulation and without
+   * drawables. The next @ref addObject of the template takes it from there,
+   * which only adds the drawables again and resets the object with @ref
+   * RigidObject::setPooled, instead of building its scene node and physics
+   * structures from scratch. Disabling it destroys the pooled objects.
+   * @param enabled Whether removed objects are pooled.
+   */
+  void setObjectPooling(bool enabled);
+
+  /** @brief Whether removed objects are pooled, see @ref setObjectPooling.
+   */
+  bool isObjectPooling() const { return objectPooling_; }
+
+  /** @brief Get the number of removed objects waiting for reuse, see @ref
+   * setObjectPooling.
+   */
+  int getNumPooledObjects() const;
+
+  /** @brief Destroy all pooled objects and their scene nodes, see @ref
+   * setObjectPooling.
+   */
+  void clearObjectPool();
+
   /** @brief Get the number of objects mapped in @ref
    * PhysicsManager::existingObjects_.
    *  @return The size of @ref PhysicsManager::existingObjects_.
@@ -197,12 +322,35 @@ class PhysicsManager {
    */
   std::vector<int> getExistingObjectIDs() const {
     std::vector<int> v;
+    v.reserve(existingObjects_.size());
     for (auto& bro : existingObjects_) {
       v.push_back(bro.first);
     }
     return v;
   };
 
+  /** @brief Get the generation of an object ID, incremented every time an
+   * object with this ID is removed. Together with the ID it keeps referring to
+   * the same object after the ID got recycled by a newer one, see @ref
+   * isObjectGenerationValid.
+   * @param  physObjectID The object ID.
+   * @return The generation, 0 for IDs that were never removed.
+   */
+  uint32_t getObjectGeneration(const int physObjectID) const {
+    return existingObjects_.generation(physObjectID);
+  }
+
+  /** @brief Check whether an object ID still refers to the object that had it
+   * with given generation, in constant time.
+   * @param  physObjectID The object ID.
+   * @param  generation The @ref getObjectGeneration of the object.
+   * @return True if the object exists and wasn't replaced, false otherwise.
+   */
+  bool isObjectGenerationValid(const int physObjectID,
+                               uint32_t generation) const {
+    return existingObjects_.contains(physObjectID, generation);
+  }
+
   /** @brief Set the @ref MotionType of an object, allowing or disallowing its
    * manipulation by dynamic processes or kinematic control.
    * @param  physObjectID The object ID and key identifying the object in @ref
@@ -219,6 +367,23 @@ class PhysicsManager {
    */
   MotionType getObjectMotionType(const int physObjectID) const;
 
+  /** @brief Set whether an object takes part in collision detection while it
+   * is @ref MotionType::KINEMATIC. See @ref
+   * RigidObject::setKinematicCollisions.
+   * @param  physObjectID The object ID and key identifying the object in @ref
+   * PhysicsManager::existingObjects_.
+   * @param  enabled Whether kinematic collisions are enabled.
+   */
+  void setObjectKinematicCollisions(const int physObjectID, bool enabled);
+
+  /** @brief Get whether an object collides while it is @ref
+   * MotionType::KINEMATIC. See @ref RigidObject::getKinematicCollisions.
+   * @param  physObjectID The object ID and key identifying the object in @ref
+   * PhysicsManager::existingObjects_.
+   * @return Whether kinematic collisions are enabled.
+   */
+  bool getObjectKinematicCollisions(const int physObjectID) const;
+
   //============ Simulator functions =============
 
   /** @brief Step the physical world forward in time. Time may only advance in
@@ -227,6 +392,75 @@ class PhysicsManager {
    */
   virtual void stepPhysics(double dt = 0.0);
 
+  /** @brief Step the physical world forward by exactly @p numSubSteps
+   * increments of @ref fixedTimeStep_. Unlike @ref stepPhysics, the cost and
+   * result of a call don't depend on time left over from earlier calls or on
+   * @ref maxSubSteps_, so stepping is exactly reproducible.
+   * @param numSubSteps The number of fixed steps to take.
+   */
+  virtual void stepPhysicsSubSteps(int numSubSteps);
+
+  /**
+   * @brief Step several physical worlds forward in time concurrently
+   *
+   * Calls @ref stepPhysics() on each of @p worlds, distributing them over a
+   * pool of worker threads that pick up the next world as soon as they're
+   * done with one, so a few expensive worlds don't hold the others back.
+   * The worlds have to be fully independent, i.e. not share any scene
+   * graph, objects, or physics manager, and nothing else may access them
+   * until this function returns. Null entries are skipped.
+   * @param worlds The worlds to step.
+   * @param dt The desired amount of time to advance each world.
+   */
+  static void stepWorlds(const std::vector<PhysicsManager*>& worlds,
+                         double dt = 0.0);
+
+  /**
+   * @brief Capture the transformation, velocities, @ref MotionType and
+   * activation of every object along with the world time.
+   *
+   * Restoring the snapshot with @ref restoreState() is much cheaper than
+   * removing and re-adding the objects, so snapshots can be kept around to
+   * reset an episode or branch off a simulation several times.
+   * @return The snapshot.
+   */
+  PhysicsState saveState() const;
+
+  /**
+   * @brief Return the world to a snapshot made by @ref saveState().
+   *
+   * The objects have to be the same as when the snapshot was taken, objects
+   * added or removed since are not recreated. Accumulated forces, velocity
+   * controls and any time left over from a step shorter than @ref
+   * fixedTimeStep_ are not part of the snapshot.
+   * Objects are matched by ID and by the template they were made from, and
+   * objects without a template also by their @ref getObjectGeneration(), so
+   * the state of a removed object is never applied to another object that
+   * recycled its ID.
+   * @param state The snapshot.
+   * @return false and nothing changed if the objects differ from the ones of
+   * the snapshot, true otherwise.
+   */
+  bool restoreState(const PhysicsState& state);
+
+  /**
+   * @brief Return the world and its set of objects to a snapshot made by
+   * @ref saveState().
+   *
+   * Like @ref restoreState(const PhysicsState&), but objects added since the
+   * snapshot are removed and objects removed since are added again from
+   * their templates, under their old IDs. Objects that recycled the ID of
+   * an object of the snapshot since are replaced by it. Together with
+   * pooling, see @ref setObjectPooling, this needs no asset loading, so a
+   * search can branch off a snapshot many times.
+   * @param state The snapshot.
+   * @param drawables Drawables the objects added again are rendered with.
+   * @return false if an object that has to be added again was added to an
+   * attachment node, in which case nothing changed, or can't be created
+   * anymore; true otherwise.
+   */
+  bool restoreState(const PhysicsState& state, DrawableGroup* drawables);
+
   // =========== Global Setter functions ===========
 
   /** @brief Set the @ref fixedTimeStep_ of the physical world. See @ref
@@ -235,6 +469,13 @@ class PhysicsManager {
    */
   virtual void setTimestep(double dt);
 
+  /** @brief Set the @ref maxSubSteps_ of the physical world. See @ref
+   * stepPhysics.
+   * @param maxSubSteps The maximum number of fixed steps per @ref
+   * stepPhysics call, time beyond them is dropped.
+   */
+  void setMaxSubSteps(int maxSubSteps) { maxSubSteps_ = maxSubSteps; }
+
   /** @brief Set the gravity of the physical world if the world is dyanmic and
    * therefore has a notion of force. By default does nothing since the world is
    * kinematic. Exact implementations of gravity will depend on the specific
@@ -252,6 +493,12 @@ class PhysicsManager {
    */
   virtual double getTimestep() const { return fixedTimeStep_; };
 
+  /** @brief Get the @ref maxSubSteps_ of the physical world. See @ref
+   * setMaxSubSteps.
+   * @return The maximum number of fixed steps per @ref stepPhysics call.
+   */
+  int getMaxSubSteps() const { return maxSubSteps_; }
+
   /** @brief Get the current @ref worldTime_ of the physical world. See @ref
    * stepPhysics.
    * @return The amount of time, @ref worldTime_, by which the physical world
@@ -259,6 +506,12 @@ class PhysicsManager {
    */
   virtual double getWorldTime() const { return worldTime_; };
 
+  /** @brief Get the object counts and timings of the last @ref stepPhysics
+   * call.
+   * @return The @ref StepStatistics of the last step.
+   */
+  const StepStatistics& getStepStatistics() const { return stepStatistics_; }
+
   /** @brief Get the current gravity in the physical world. By default returns
    * [0,0,0] since their is no notion of force in a kinematic world.
    * @return The current gravity vector in the physical world.
@@ -736,6 +989,78 @@ class PhysicsManager {
    */
   Magnum::Vector3 getAngularVelocity(const int physObjectID) const;
 
+  // =========== Batched object state ===========
+
+  /**
+   * @brief Get the translations of several objects in one pass. See @ref
+   * getTranslation.
+   * @param physObjectIDs The object IDs, or empty for all objects in the order
+   * of @ref getExistingObjectIDs.
+   * @param[out] translations One translation per object.
+   */
+  void getTranslations(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> translations) const;
+
+  /**
+   * @brief Get the orientations of several objects in one pass. See @ref
+   * getRotation and @ref getTranslations.
+   */
+  void getRotations(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<Magnum::Quaternion> rotations) const;
+
+  /**
+   * @brief Get the linear velocities of several objects in one pass. See @ref
+   * getLinearVelocity and @ref getTranslations.
+   */
+  void getLinearVelocities(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> linVels) const;
+
+  /**
+   * @brief Get the angular velocities of several objects in one pass. See
+   * @ref getAngularVelocity and @ref getTranslations.
+   */
+  void getAngularVelocities(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> angVels) const;
+
+  /**
+   * @brief Set the translations of several objects in one pass. See @ref
+   * setTranslation.
+   * @param physObjectIDs The object IDs, or empty for all objects in the order
+   * of @ref getExistingObjectIDs.
+   * @param translations One translation per object.
+   */
+  void setTranslations(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> translations);
+
+  /**
+   * @brief Set the orientations of several objects in one pass. See @ref
+   * setRotation and @ref setTranslations.
+   */
+  void setRotations(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Quaternion> rotations);
+
+  /**
+   * @brief Set the linear velocities of several objects in one pass. See
+   * @ref setLinearVelocity and @ref setTranslations.
+   */
+  void setLinearVelocities(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> linVels);
+
+  /**
+   * @brief Set the angular velocities of several objects in one pass. See
+   * @ref setAngularVelocity and @ref setTranslations.
+   */
+  void setAngularVelocities(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> angVels);
+
   /**@brief Retrieves a shared pointer to the VelocityControl struct for this
    * object.
    */
@@ -794,6 +1119,37 @@ class PhysicsManager {
     return false;
   };
 
+  /**
+   * @brief Check several objects for contacts at once, after a single
+   * collision detection pass. See @ref contactTest.
+   *
+   * Not implemented for default @ref PhysicsManager, all results are false.
+   * See @ref BulletPhysicsManager.
+   * @param physObjectIDs The object IDs, or empty for all objects in the order
+   * of @ref getExistingObjectIDs.
+   * @param[out] results Whether each object is in contact with any other
+   * collision enabled objects.
+   */
+  virtual void contactTests(
+      Corrade::Containers::ArrayView<const int> physObjectIDs,
+      Corrade::Containers::ArrayView<bool> results);
+
+  /**
+   * @brief Find the closest collision geometry hit by each of several rays.
+   *
+   * Not implemented for default @ref PhysicsManager, nothing is hit. See @ref
+   * BulletPhysicsManager.
+   * @param origins Start points of the rays in world space.
+   * @param directions Directions of the rays, don't need to be normalized.
+   * @param maxDistance Length of the rays.
+   * @param[out] hits The closest hit of each ray.
+   */
+  virtual void castRays(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      float maxDistance,
+      Corrade::Containers::ArrayView<RayHit> hits);
+
   /** @brief Return the library implementation type for the simulator currently
    * in use. Use to check for a particular implementation.
    * @return The implementation type of this simulator.
@@ -820,7 +1176,7 @@ class PhysicsManager {
    * @param physObjectID The object ID to validate.
    */
   virtual void assertIDValidity(const int physObjectID) const {
-    CHECK(existingObjects_.count(physObjectID) > 0);
+    CHECK(existingObjects_.contains(physObjectID));
   };
 
   /** @brief Check if a particular mesh can be used as a collision mesh for a
@@ -832,6 +1188,13 @@ class PhysicsManager {
    */
   virtual bool isMeshPrimitiveValid(const assets::CollisionMeshData& meshData);
 
+  /** @brief Whether the object with the ID of a @ref PhysicsState object is
+   * still the one the state was saved from. See @ref restoreState().
+   * @param objectState The state of the object in a snapshot.
+   * @return true if it is, false if the ID is unused or holds another object.
+   */
+  bool matchesObjectState(const PhysicsState::ObjectState& objectState) const;
+
   /** @brief Acquire a new ObjectID by recycling the ID of an object removed
    * with @ref removeObject or by incrementing @ref nextObjectID_. See @ref
    * addObject.
@@ -886,6 +1249,15 @@ class PhysicsManager {
       assets::PhysicsObjectAttributes::ptr physicsObjectAttributes,
       scene::SceneNode* objectNode);
 
+  /** @brief Take an object of a template out of the pool, reset it and add it
+   * to existingObjects_ map keyed with newObjectID. See @ref
+   * setObjectPooling.
+   * @param newObjectID valid object ID for the object
+   * @param objectLibIndex The index of the object's template.
+   * @return whether the pool had an object of the template
+   */
+  virtual bool addPooledObject(int newObjectID, int objectLibIndex);
+
   /** @brief A pointer to a @ref esp::assets::ResourceManager which holds assets
    * that can be accessed by this @ref PhysicsManager*/
   assets::ResourceManager& resourceManager_;
@@ -915,9 +1287,21 @@ class PhysicsManager {
   //! ==== Rigid object memory management ====
 
   /** @brief Maps object IDs to all existing physical object instances in the
-   * world.
+   * world. Stored densely and iterated in order of their IDs, see
+   * @ref core::SlotMap.
    */
-  std::map<int, physics::RigidObject::uptr> existingObjects_;
+  core::SlotMap<physics::RigidObject::uptr> existingObjects_;
+
+  /** @brief Template indices of the existing objects whose scene node was
+   * created by @ref addObject, which are the ones that can be pooled. */
+  core::SlotMap<int> poolableObjects_;
+
+  /** @brief Removed objects waiting for reuse by template index, see @ref
+   * setObjectPooling. */
+  std::map<int, std::vector<physics::RigidObject::uptr>> objectPool_;
+
+  /** @brief Whether removed objects are pooled. */
+  bool objectPooling_ = false;
 
   /** @brief A counter of unique object ID's allocated thus far. Used to
    * allocate new IDs when  @ref recycledObjectIDs_ is empty without needing to
@@ -950,6 +1334,45 @@ class PhysicsManager {
    * simulated with @ref stepPhysics up to this point. */
   double worldTime_ = 0.0;
 
+  /** @brief Current time of the clock used for @ref StepStatistics, in
+   * milliseconds. */
+  static double profilerTime();
+
+  /** @brief Object counts and timings of the last @ref stepPhysics call. */
+  StepStatistics stepStatistics_;
+
+  /** @brief Add @ref stepStatistics_ to the @ref esp::core::Metrics, called
+   * at the end of every step. */
+  void recordStepMetrics() const;
+
+  /**
+   * @brief Integrate the @ref VelocityControl of all velocity controlled
+   * objects over @p numSteps steps of @p dt and set their node
+   * transformations.
+   *
+   * Controls and transforms are gathered into @ref velControlBatch_ and
+   * integrated together with @ref VelocityControl::integrateTransforms(),
+   * node transformations are only set once at the end. Controls overriding
+   * @ref VelocityControl::integrateTransform() are integrated one by one.
+   * The IDs of all moved objects are left in @ref velControlBatch_.
+   * @param dt The discrete timestep over which to integrate.
+   * @param numSteps The number of steps to integrate.
+   * @param kinematicOnly Whether to skip objects with a @ref MotionType other
+   * than @ref MotionType::KINEMATIC.
+   */
+  void integrateVelocityControls(double dt,
+                                 int numSteps,
+                                 bool kinematicOnly);
+
+  /** @brief Contiguous scratch storage of @ref integrateVelocityControls,
+   * kept across steps to avoid reallocating. */
+  struct VelocityControlBatch {
+    std::vector<int> objectIDs;
+    std::vector<scene::SceneNode*> nodes;
+    std::vector<VelocityControl> controls;
+    std::vector<Magnum::Matrix4> transforms;
+  } velControlBatch_;
+
   ESP_SMART_POINTERS(PhysicsManager)
 };
 
@@ -63,6 +63,17 @@ bool RigidObject::initializeObjectFinalize(
   return true;
 }
 
+void RigidObject::setPooled(bool pooled) {
+  if (pooled) {
+    return;
+  }
+  resetTransformation();
+  velControl_ = VelocityControl::create();
+  attributes_ = core::Configuration{};
+  setKinematicCollisions(true);
+  setMotionType(MotionType::KINEMATIC);
+}
+
 bool RigidObject::isActive() {
   // NOTE: no active objects without a physics engine... (kinematics don't
   // count)
@@ -234,26 +245,30 @@ Magnum::Matrix3 RigidObject::getInertiaMatrix() {
 
 //////////////////
 // VelocityControl
-Magnum::Matrix4 VelocityControl::integrateTransform(
+namespace {
+// explicit Euler integration shared by the virtual and the batched interface
+inline Magnum::Matrix4 integrateVelocity(
+    const VelocityControl& control,
     const float dt,
     const Magnum::Matrix4& objectTransform) {
   // linear first
   Magnum::Vector3 newTranslation = objectTransform.translation();
-  if (controllingLinVel) {
-    if (linVelIsLocal) {
-      newTranslation += objectTransform.rotation() *
-                        (linVel * dt);  // avoid local scaling of the velocity
+  if (control.controllingLinVel) {
+    if (control.linVelIsLocal) {
+      newTranslation +=
+          objectTransform.rotation() *
+          (control.linVel * dt);  // avoid local scaling of the velocity
     } else {
-      newTranslation += linVel * dt;
+      newTranslation += control.linVel * dt;
     }
   }
 
   Magnum::Matrix3 newRotationScaling = objectTransform.rotationScaling();
   // then angular
-  if (controllingAngVel) {
-    Magnum::Vector3 globalAngVel = angVel;
-    if (angVelIsLocal) {
-      globalAngVel = objectTransform.rotation() * angVel;
+  if (control.controllingAngVel) {
+    Magnum::Vector3 globalAngVel = control.angVel;
+    if (control.angVelIsLocal) {
+      globalAngVel = objectTransform.rotation() * control.angVel;
     }
     Magnum::Quaternion q = Magnum::Quaternion::rotation(
         Magnum::Rad{(globalAngVel * dt).length()}, globalAngVel.normalized());
@@ -261,6 +276,24 @@ Magnum::Matrix4 VelocityControl::integrateTransform(
   }
   return Magnum::Matrix4::from(newRotationScaling, newTranslation);
 }
+}  // namespace
+
+Magnum::Matrix4 VelocityControl::integrateTransform(
+    const float dt,
+    const Magnum::Matrix4& objectTransform) {
+  return integrateVelocity(*this, dt, objectTransform);
+}
+
+void VelocityControl::integrateTransforms(
+    const float dt,
+    Corrade::Containers::ArrayView<const VelocityControl> controls,
+    Corrade::Containers::ArrayView<Magnum::Matrix4> objectTransforms) {
+  CHECK_EQ(controls.size(), objectTransforms.size());
+  for (std::size_t i = 0; i != controls.size(); ++i) {
+    objectTransforms[i] =
+        integrateVelocity(controls[i], dt, objectTransforms[i]);
+  }
+}
 
 }  // namespace physics
 }  // namespace esp
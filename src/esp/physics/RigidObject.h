@@ -10,6 +10,7 @@
  * @ref VelocityControl
  */
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Reference.h>
 #include "esp/assets/Asset.h"
@@ -129,6 +130,24 @@ struct VelocityControl {
       const float dt,
       const Magnum::Matrix4& objectTransform);
 
+  /**
+   * @brief Apply constant control velocities to many object transforms at
+   * once.
+   *
+   * Same as the default @ref integrateTransform() of each of @p controls
+   * applied to the corresponding item of @p objectTransforms, but without a
+   * virtual call per object. Overrides of @ref integrateTransform() in
+   * derived structs are not used.
+   * @param dt The discrete timestep over which to integrate.
+   * @param controls The velocity controls to apply.
+   * @param objectTransforms Object transforms updated in place, same size as
+   * @p controls.
+   */
+  static void integrateTransforms(
+      const float dt,
+      Corrade::Containers::ArrayView<const VelocityControl> controls,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> objectTransforms);
+
   ESP_SMART_POINTERS(VelocityControl)
 };
 
@@ -204,6 +223,19 @@ class RigidObject : public Magnum::SceneGraph::AbstractFeature3D {
    */
   virtual void finalizeObject() {}
 
+  /**
+   * @brief Take the object out of simulation while it waits in the object
+   * pool of its @ref PhysicsManager, or put it back for reuse.
+   *
+   * A pooled object isn't simulated and doesn't collide. Putting it back
+   * resets its transformation, velocities, velocity control, @ref attributes_
+   * and motion type and, in derived dynamics implementations, its physical
+   * parameters to those of @ref getInitializationAttributes(), as if it was
+   * newly created.
+   * @param pooled Whether the object goes into the pool.
+   */
+  virtual void setPooled(bool pooled);
+
   /**
    * @brief Check whether object is being actively simulated, or sleeping.
    * Kinematic objects are always active, but derived dynamics implementations
@@ -219,6 +251,13 @@ class RigidObject : public Magnum::SceneGraph::AbstractFeature3D {
    */
   virtual void setActive(){};
 
+  /**
+   * @brief Put the object to sleep, the opposite of @ref setActive().
+   * Kinematic objects are always active, but derived dynamics implementations
+   * may not be.
+   */
+  virtual void setSleeping(){};
+
   /**
    * @brief Set the @ref MotionType of the object. If the object is @ref
    * ObjectType::SCENE it can only be @ref MotionType::STATIC. If the object is
@@ -236,6 +275,26 @@ class RigidObject : public Magnum::SceneGraph::AbstractFeature3D {
    */
   MotionType getMotionType() { return objectMotionType_; };
 
+  /**
+   * @brief Set whether the object takes part in collision detection while it
+   * is @ref MotionType::KINEMATIC. Without, the object is moved purely through
+   * its scene node, never slowing down simulation steps, but other objects
+   * pass through it and ray casts miss it. Its own contact tests still work.
+   * Has no effect without a physics simulator, where kinematic objects never
+   * collide. Enabled by default.
+   * @param enabled Whether kinematic collisions are enabled.
+   */
+  virtual void setKinematicCollisions(bool enabled) {
+    kinematicCollisions_ = enabled;
+  };
+
+  /**
+   * @brief Whether the object collides while it is @ref MotionType::KINEMATIC.
+   * See @ref setKinematicCollisions.
+   * @return Whether kinematic collisions are enabled.
+   */
+  bool getKinematicCollisions() const { return kinematicCollisions_; };
+
   /**
    * @brief Shift the object's local origin by translating all children of this
    * object's SceneNode.
@@ -597,6 +656,10 @@ class RigidObject : public Magnum::SceneGraph::AbstractFeature3D {
    * be performed on this object. */
   MotionType objectMotionType_;
 
+  /** @brief Whether the object collides while it is @ref
+   * MotionType::KINEMATIC. See @ref setKinematicCollisions. */
+  bool kinematicCollisions_ = true;
+
   /** @brief The @ref RigidObjectType of the object. Identifies what role the
    * object plays in the phyiscal world. A value of @ref RigidObjectType::NONE
    * identifies the object as uninitialized.*/
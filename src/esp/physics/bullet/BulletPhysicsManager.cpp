@@ -6,16 +6,64 @@
 //#include "BulletCollision/Gimpact/btGImpactShape.h"
 
 #include "BulletPhysicsManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <LinearMath/btQuickprof.h>
+
 #include "BulletRigidObject.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Profiler.h"
 
 namespace esp {
 namespace physics {
 
+namespace {
+#ifndef BT_NO_PROFILE
+bool nameContains(const char* name, const char* part) {
+  return std::strstr(name, part) != nullptr;
+}
+
+// Adds the times of the profile zones below the current parent of the
+// iterator to the phases of the breakdown they belong to. Zones not belonging
+// to any phase are descended into.
+void accumulateProfile(CProfileIterator& iterator, StepStatistics& stats) {
+  int index = 0;
+  for (iterator.First(); !iterator.Is_Done(); iterator.Next(), ++index) {
+    const char* name = iterator.Get_Current_Name();
+    const double time = iterator.Get_Current_Total_Time();
+    if (nameContains(name, "updateAabbs") ||
+        nameContains(name, "calculateOverlappingPairs")) {
+      stats.broadphaseTime += time;
+    } else if (nameContains(name, "dispatchAllCollisionPairs")) {
+      stats.narrowphaseTime += time;
+    } else if (nameContains(name, "solveConstraints")) {
+      stats.solverTime += time;
+    } else if (nameContains(name, "predictUnconstraintMotion") ||
+               nameContains(name, "integrateTransforms")) {
+      stats.integrationTime += time;
+    } else if (nameContains(name, "synchronizeMotionStates")) {
+      stats.syncPoseTime += time;
+    } else {
+      iterator.Enter_Child(index);
+      accumulateProfile(iterator, stats);
+      // going back up rewinds to the first child
+      iterator.Enter_Parent();
+      for (int i = 0; i != index; ++i) {
+        iterator.Next();
+      }
+    }
+  }
+}
+#endif
+}  // namespace
+
 BulletPhysicsManager::~BulletPhysicsManager() {
   LOG(INFO) << "Deconstructing BulletPhysicsManager";
 
   existingObjects_.clear();
+  objectPool_.clear();
   staticSceneObject_.reset(nullptr);
 }
 
@@ -29,11 +77,6 @@ bool BulletPhysicsManager::initPhysicsFinalize(
   bWorld_ = std::make_shared<btMultiBodyDynamicsWorld>(
       &bDispatcher_, &bBroadphase_, &bSolver_, &bCollisionConfig_);
 
-  debugDrawer_.setMode(
-      Magnum::BulletIntegration::DebugDraw::Mode::DrawWireframe |
-      Magnum::BulletIntegration::DebugDraw::Mode::DrawConstraints);
-  bWorld_->setDebugDrawer(&debugDrawer_);
-
   // currently GLB meshes are y-up
   bWorld_->setGravity(btVector3(physicsManagerAttributes->getVec3("gravity")));
 
@@ -61,15 +104,27 @@ bool BulletPhysicsManager::makeAndAddRigidObject(
     const std::vector<assets::CollisionMeshData>& meshGroup,
     assets::PhysicsObjectAttributes::ptr physicsObjectAttributes,
     scene::SceneNode* objectNode) {
-  auto ptr = physics::BulletRigidObject::create_unique(objectNode, bWorld_);
+  auto ptr = physics::BulletRigidObject::create_unique(objectNode, bWorld_,
+                                                       &collisionShapeCache_);
   bool objSuccess = ptr->initializeObject(resourceManager_,
                                           physicsObjectAttributes, meshGroup);
   if (objSuccess) {
+    ptr->setObjectID(newObjectID);
     existingObjects_.emplace(newObjectID, std::move(ptr));
   }
   return objSuccess;
 }
 
+bool BulletPhysicsManager::addPooledObject(int newObjectID,
+                                           int objectLibIndex) {
+  if (!PhysicsManager::addPooledObject(newObjectID, objectLibIndex)) {
+    return false;
+  }
+  static_cast<BulletRigidObject*>(existingObjects_.at(newObjectID).get())
+      ->setObjectID(newObjectID);
+  return true;
+}
+
 //! Check if mesh primitive is compatible with physics
 bool BulletPhysicsManager::isMeshPrimitiveValid(
     const assets::CollisionMeshData& meshData) {
@@ -107,10 +162,8 @@ bool BulletPhysicsManager::isMeshPrimitiveValid(
 void BulletPhysicsManager::setGravity(const Magnum::Vector3& gravity) {
   bWorld_->setGravity(btVector3(gravity));
   // After gravity change, need to reactive all bullet objects
-  for (std::map<int, physics::RigidObject::uptr>::iterator it =
-           existingObjects_.begin();
-       it != existingObjects_.end(); ++it) {
-    it->second->setActive();
+  for (auto& object : existingObjects_) {
+    object.second->setActive();
   }
 }
 
@@ -119,6 +172,7 @@ Magnum::Vector3 BulletPhysicsManager::getGravity() const {
 }
 
 void BulletPhysicsManager::stepPhysics(double dt) {
+  ESP_PROFILE_SCOPE("BulletPhysicsManager::stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -126,19 +180,90 @@ void BulletPhysicsManager::stepPhysics(double dt) {
   if (dt <= 0) {
     dt = fixedTimeStep_;
   }
+  const double startTime = profilerTime();
+  const bool anyActive = applyVelocityControl(dt);
+
+  // ==== Physics stepforward ======
+  stepStatistics_ = {};
+  stepStatistics_.startTime = startTime;
+  if (!anyActive) {
+    // Bullet neither moves nor collides sleeping bodies, so a step with all of
+    // them asleep only advances time. Keep the remainder that wasn't a whole
+    // fixed step, as stepSimulation() would.
+    skippedTime_ += dt;
+    const int numSubSteps = static_cast<int>(skippedTime_ / fixedTimeStep_);
+    skippedTime_ -= numSubSteps * fixedTimeStep_;
+    worldTime_ += numSubSteps * fixedTimeStep_;
+    stepStatistics_.skipped = true;
+  } else {
+    // NOTE: worldTime_ will always be a multiple of sceneMetaData_.timestep
+    int numSubStepsTaken =
+        bWorld_->stepSimulation(dt, maxSubSteps_, fixedTimeStep_);
+    worldTime_ += numSubStepsTaken * fixedTimeStep_;
+    // substeps beyond maxSubSteps_ are dropped
+    stepStatistics_.subSteps = std::min(numSubStepsTaken, maxSubSteps_);
+#ifndef BT_NO_PROFILE
+    // stepSimulation() resets the profiler of this thread, so it only holds
+    // zones of this step
+    CProfileIterator* profile = CProfileManager::Get_Iterator();
+    accumulateProfile(*profile, stepStatistics_);
+    CProfileManager::Release_Iterator(profile);
+#endif
+  }
+
+  countStepObjects();
+  stepStatistics_.totalTime = profilerTime() - startTime;
+  recordStepMetrics();
+}
+
+void BulletPhysicsManager::stepPhysicsSubSteps(int numSubSteps) {
+  // We don't step uninitialized physics sim...
+  if (!initialized_ || numSubSteps <= 0) {
+    return;
+  }
+  const double startTime = profilerTime();
+  const bool anyActive = applyVelocityControl(numSubSteps * fixedTimeStep_);
+
+  stepStatistics_ = {};
+  stepStatistics_.startTime = startTime;
+  if (!anyActive) {
+    stepStatistics_.skipped = true;
+  } else {
+    // A variable step of exactly fixedTimeStep_ each, which also discards
+    // any time Bullet accumulated from earlier calls, so the result only
+    // depends on the state and numSubSteps
+    for (int i = 0; i != numSubSteps; ++i) {
+      bWorld_->stepSimulation(fixedTimeStep_, 0, fixedTimeStep_);
+#ifndef BT_NO_PROFILE
+      // the profiler is reset by every stepSimulation() call
+      CProfileIterator* profile = CProfileManager::Get_Iterator();
+      accumulateProfile(*profile, stepStatistics_);
+      CProfileManager::Release_Iterator(profile);
+#endif
+    }
+    stepStatistics_.subSteps = numSubSteps;
+  }
+  worldTime_ += numSubSteps * fixedTimeStep_;
+  skippedTime_ = 0.0;
+
+  countStepObjects();
+  stepStatistics_.totalTime = profilerTime() - startTime;
+  recordStepMetrics();
+}
+
+bool BulletPhysicsManager::applyVelocityControl(double dt) {
+  // kinematic velocity control intergration, moved bodies have to be woken
+  // up to get their new pose picked up by Bullet
+  integrateVelocityControls(dt, 1, true);
+  for (const int objectID : velControlBatch_.objectIDs) {
+    existingObjects_.at(objectID)->setActive();
+  }
 
   // set specified control velocities
+  bool anyActive = false;
   for (auto& objectItr : existingObjects_) {
-    VelocityControl::ptr velControl = objectItr.second->getVelocityControl();
-    if (objectItr.second->getMotionType() == MotionType::KINEMATIC) {
-      // kinematic velocity control intergration
-      if (velControl->controllingAngVel || velControl->controllingLinVel) {
-        scene::SceneNode& objectSceneNode = objectItr.second->node();
-        objectSceneNode.setTransformation(velControl->integrateTransform(
-            dt, objectSceneNode.transformation()));
-        objectItr.second->setActive();
-      }
-    } else if (objectItr.second->getMotionType() == MotionType::DYNAMIC) {
+    if (objectItr.second->getMotionType() == MotionType::DYNAMIC) {
+      VelocityControl::ptr velControl = objectItr.second->getVelocityControl();
       if (velControl->controllingLinVel) {
         if (velControl->linVelIsLocal) {
           setLinearVelocity(objectItr.first,
@@ -159,13 +284,31 @@ void BulletPhysicsManager::stepPhysics(double dt) {
         }
       }
     }
+    // static objects have no rigid body in the world
+    anyActive = anyActive ||
+                (objectItr.second->getMotionType() != MotionType::STATIC &&
+                 objectItr.second->isActive());
   }
+  return anyActive;
+}
 
-  // ==== Physics stepforward ======
-  // NOTE: worldTime_ will always be a multiple of sceneMetaData_.timestep
-  int numSubStepsTaken =
-      bWorld_->stepSimulation(dt, maxSubSteps_, fixedTimeStep_);
-  worldTime_ += numSubStepsTaken * fixedTimeStep_;
+void BulletPhysicsManager::countStepObjects() {
+  // Bullet only calls the motion state of awake dynamic bodies, so only
+  // those get their node pose synced
+  for (auto& objectItr : existingObjects_) {
+    const MotionType motionType = objectItr.second->getMotionType();
+    if (motionType == MotionType::STATIC) {
+      continue;
+    }
+    if (!objectItr.second->isActive()) {
+      ++stepStatistics_.sleepingObjects;
+      continue;
+    }
+    ++stepStatistics_.activeObjects;
+    if (motionType == MotionType::DYNAMIC) {
+      ++stepStatistics_.syncedObjects;
+    }
+  }
 }
 
 void BulletPhysicsManager::setMargin(const int physObjectID,
@@ -214,7 +357,17 @@ const Magnum::Range3D BulletPhysicsManager::getSceneCollisionShapeAabb() const {
 }
 
 void BulletPhysicsManager::debugDraw(const Magnum::Matrix4& projTrans) const {
-  debugDrawer_.setTransformationProjectionMatrix(projTrans);
+  if (!debugDrawer_) {
+    debugDrawer_.emplace();
+    debugDrawer_->setMode(
+        Magnum::BulletIntegration::DebugDraw::Mode::DrawWireframe |
+        Magnum::BulletIntegration::DebugDraw::Mode::DrawConstraints);
+  }
+  // the world is recreated by every initPhysics()
+  if (bWorld_->getDebugDrawer() != &*debugDrawer_) {
+    bWorld_->setDebugDrawer(&*debugDrawer_);
+  }
+  debugDrawer_->setTransformationProjectionMatrix(projTrans);
   bWorld_->debugDrawWorld();
 }
 
@@ -226,5 +379,58 @@ bool BulletPhysicsManager::contactTest(const int physObjectID) {
       ->contactTest();
 }
 
+void BulletPhysicsManager::contactTests(
+    Corrade::Containers::ArrayView<const int> physObjectIDs,
+    Corrade::Containers::ArrayView<bool> results) {
+  // one collision detection pass for the whole batch
+  bWorld_->getCollisionWorld()->performDiscreteCollisionDetection();
+  SimulationContactResultCallback src;
+  const auto test = [&](const RigidObject::uptr& object) {
+    return static_cast<BulletRigidObject*>(object.get())->contactTest(src);
+  };
+
+  if (physObjectIDs.empty()) {
+    CHECK_EQ(results.size(), existingObjects_.size());
+    std::size_t i = 0;
+    for (const auto& object : existingObjects_) {
+      results[i++] = test(object.second);
+    }
+    return;
+  }
+  CHECK_EQ(results.size(), physObjectIDs.size());
+  for (std::size_t i = 0; i != physObjectIDs.size(); ++i) {
+    const auto found = existingObjects_.find(physObjectIDs[i]);
+    CHECK(found != existingObjects_.end());
+    results[i] = test(found->second);
+  }
+}
+
+void BulletPhysicsManager::castRays(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    float maxDistance,
+    Corrade::Containers::ArrayView<RayHit> hits) {
+  CHECK_EQ(origins.size(), directions.size());
+  CHECK_EQ(origins.size(), hits.size());
+  // the broadphase tree has to be up to date with moved objects
+  bWorld_->updateAabbs();
+  const btCollisionWorld* collisionWorld = bWorld_->getCollisionWorld();
+  for (std::size_t i = 0; i != origins.size(); ++i) {
+    hits[i] = RayHit{};
+    const Magnum::Vector3 direction = directions[i].normalized();
+    const btVector3 from{origins[i]};
+    const btVector3 to{origins[i] + direction * maxDistance};
+    btCollisionWorld::ClosestRayResultCallback callback{from, to};
+    collisionWorld->rayTest(from, to, callback);
+    if (!callback.hasHit()) {
+      continue;
+    }
+    hits[i].distance = callback.m_closestHitFraction * maxDistance;
+    hits[i].point = Magnum::Vector3{callback.m_hitPointWorld};
+    hits[i].normal = Magnum::Vector3{callback.m_hitNormalWorld};
+    hits[i].objectID = callback.m_collisionObject->getUserIndex();
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
@@ -9,6 +9,7 @@
  */
 
 /* Bullet Physics Integration */
+#include <Corrade/Containers/Optional.h>
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
 #include <Magnum/BulletIntegration/MotionState.h>
@@ -57,11 +58,20 @@ class BulletPhysicsManager : public PhysicsManager {
 
   /** @brief Step the physical world forward in time. Time may only advance in
    * increments of @ref fixedTimeStep_. See @ref
-   * btMultiBodyDynamicsWorld::stepSimulation.
+   * btMultiBodyDynamicsWorld::stepSimulation. If every object is asleep the
+   * simulation isn't stepped and only time advances, see @ref
+   * getStepStatistics.
    * @param dt The desired amount of time to advance the physical world.
    */
   void stepPhysics(double dt) override;
 
+  /** @brief Step the physical world forward by exactly @p numSubSteps
+   * increments of @ref fixedTimeStep_, independently of any time left over
+   * from earlier @ref stepPhysics calls.
+   * @param numSubSteps The number of fixed steps to take.
+   */
+  void stepPhysicsSubSteps(int numSubSteps) override;
+
   /** @brief Set the gravity of the physical world.
    * @param gravity The desired gravity force of the physical world.
    */
@@ -144,6 +154,14 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   const Magnum::Range3D getSceneCollisionShapeAabb() const;
 
+  /**
+   * @brief Number of distinct object collision shapes built so far. Instances
+   * of the same template at the same scale share one.
+   */
+  std::size_t getCollisionShapeCacheSize() const {
+    return collisionShapeCache_.size();
+  }
+
   /** @brief Render the debugging visualizations provided by @ref
    * Magnum::BulletIntegration::DebugDraw. This draws wireframes for all
    * collision objects.
@@ -163,6 +181,31 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   bool contactTest(const int physObjectID) override;
 
+  /**
+   * @brief Check several objects for contacts after a single collision
+   * detection pass. See @ref contactTest.
+   * @param physObjectIDs The object IDs, or empty for all objects in the order
+   * of @ref getExistingObjectIDs.
+   * @param[out] results Whether each object is in contact with any other
+   * collision enabled objects.
+   */
+  void contactTests(Corrade::Containers::ArrayView<const int> physObjectIDs,
+                    Corrade::Containers::ArrayView<bool> results) override;
+
+  /**
+   * @brief Find the closest collision geometry hit by each ray. See @ref
+   * btCollisionWorld::rayTest.
+   * @param origins Start points of the rays in world space.
+   * @param directions Directions of the rays, don't need to be normalized.
+   * @param maxDistance Length of the rays.
+   * @param[out] hits The closest hit of each ray.
+   */
+  void castRays(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      float maxDistance,
+      Corrade::Containers::ArrayView<RayHit> hits) override;
+
  protected:
   //============ Initialization =============
   /**
@@ -205,16 +248,45 @@ class BulletPhysicsManager : public PhysicsManager {
       assets::PhysicsObjectAttributes::ptr physicsObjectAttributes,
       scene::SceneNode* objectNode) override;
 
+  /** @brief Take a pooled object like @ref PhysicsManager::addPooledObject
+   * and update the ID its Bullet collision objects report.
+   * @param newObjectID valid object ID for the object
+   * @param objectLibIndex The index of the object's template.
+   * @return whether the pool had an object of the template
+   */
+  bool addPooledObject(int newObjectID, int objectLibIndex) override;
+
   btDbvtBroadphase bBroadphase_;
   btDefaultCollisionConfiguration bCollisionConfig_;
 
   btMultiBodyConstraintSolver bSolver_;
   btCollisionDispatcher bDispatcher_{&bCollisionConfig_};
 
+  /** @brief Convex hulls shared by all instances of an object template, has
+   * to outlive the objects in @ref existingObjects_. */
+  BulletCollisionShapeCache collisionShapeCache_;
+
   /** @brief A pointer to the Bullet world. See @ref btMultiBodyDynamicsWorld.*/
   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld_;
 
-  mutable Magnum::BulletIntegration::DebugDraw debugDrawer_;
+  /** @brief Created on the first @ref debugDraw(), it needs a GL context
+   * and physics may run without one. */
+  mutable Corrade::Containers::Optional<Magnum::BulletIntegration::DebugDraw>
+      debugDrawer_;
+
+  /** @brief Apply the velocity controls of all objects, integrating the
+   * kinematic ones over @p dt.
+   * @return Whether any object is awake afterwards.
+   */
+  bool applyVelocityControl(double dt);
+
+  /** @brief Count the active, synced and sleeping objects for @ref
+   * stepStatistics_ after a step. */
+  void countStepObjects();
+
+  /** @brief Time passed in skipped steps that didn't add up to a whole @ref
+   * fixedTimeStep_ yet. See @ref stepPhysics. */
+  double skippedTime_ = 0.0;
 
  private:
   /** @brief Check if a particular mesh can be used as a collision mesh for
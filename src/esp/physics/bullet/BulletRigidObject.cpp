@@ -2,6 +2,15 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <tuple>
+
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
 
@@ -11,6 +20,9 @@
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletRigidObject.h"
+#include "LinearMath/btConvexHullComputer.h"
+#include "esp/assets/MeshOptimization.h"
+#include "esp/io/io.h"
 
 //!  A Few considerations in construction
 //!  Bullet Mesh conversion adapted from:
@@ -28,12 +40,287 @@
 namespace esp {
 namespace physics {
 
+namespace {
+// FNV-1a, over everything the hulls are built from
+struct ContentHash {
+  uint64_t value = 14695981039346656037ull;
+
+  void add(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i != size; ++i) {
+      value = (value ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+
+  void add(const assets::MeshTransformNode& node) {
+    add(node.transformFromLocalToParent.data(), sizeof(Magnum::Matrix4));
+    add(&node.meshIDLocal, sizeof(node.meshIDLocal));
+    for (const auto& child : node.children) {
+      add(child);
+    }
+  }
+};
+
+uint64_t hashCollisionMeshes(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& root,
+    bool join) {
+  ContentHash hash;
+  hash.add(&join, sizeof(join));
+  for (const auto& mesh : meshGroup) {
+    hash.add(mesh.positions.data(),
+             mesh.positions.size() * sizeof(Magnum::Vector3));
+  }
+  hash.add(root);
+  return hash.value;
+}
+
+// appends the triangles of the meshes of node and its children in world
+// space
+void gatherSceneMeshes(const Magnum::Matrix4& transformFromParentToWorld,
+                       const std::vector<assets::CollisionMeshData>& meshGroup,
+                       const assets::MeshTransformNode& node,
+                       std::vector<Magnum::Vector3>& positions,
+                       std::vector<Magnum::UnsignedInt>& indices) {
+  const Magnum::Matrix4 transformFromLocalToWorld =
+      transformFromParentToWorld * node.transformFromLocalToParent;
+  if (node.meshIDLocal != ID_UNDEFINED) {
+    const assets::CollisionMeshData& mesh = meshGroup[node.meshIDLocal];
+    const auto offset = Magnum::UnsignedInt(positions.size());
+    for (const Magnum::Vector3& position : mesh.positions) {
+      positions.push_back(transformFromLocalToWorld.transformPoint(position));
+    }
+    for (Magnum::UnsignedInt index : mesh.indices) {
+      indices.push_back(offset + index);
+    }
+  }
+  for (const auto& child : node.children) {
+    gatherSceneMeshes(transformFromLocalToWorld, meshGroup, child, positions,
+                      indices);
+  }
+}
+
+struct HullCacheHeader {
+  int magic;
+  int version;
+  int scalarSize;
+  uint32_t hullCount;
+  uint64_t contentHash;
+};
+constexpr int HULL_CACHE_MAGIC = 'H' << 24 | 'U' << 16 | 'L' << 8 | 'L';
+constexpr int HULL_CACHE_VERSION = 1;
+
+// false if the file doesn't exist, is invalid or was made from different
+// meshes
+bool loadCollisionHulls(const std::string& filename,
+                        uint64_t contentHash,
+                        BulletCollisionShapes& shapes) {
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (!fp) {
+    return false;
+  }
+  // the counts in the file are checked against its size before anything is
+  // allocated, so a corrupted file can't ask for more than it holds
+  std::fseek(fp, 0, SEEK_END);
+  const long fileSize = std::ftell(fp);
+  std::rewind(fp);
+  const auto remaining = [&]() {
+    return std::size_t(std::max(0L, fileSize - std::ftell(fp)));
+  };
+  constexpr std::size_t hullHeaderSize =
+      16 * sizeof(btScalar) + sizeof(uint32_t);
+
+  HullCacheHeader header;
+  bool valid = fread(&header, sizeof(header), 1, fp) == 1 &&
+               header.magic == HULL_CACHE_MAGIC &&
+               header.version == HULL_CACHE_VERSION &&
+               header.scalarSize == sizeof(btScalar) &&
+               header.contentHash == contentHash &&
+               header.hullCount <= remaining() / hullHeaderSize;
+  BulletCollisionShapes loaded;
+  for (uint32_t i = 0; valid && i != header.hullCount; ++i) {
+    btScalar transform[16];
+    uint32_t pointCount;
+    valid = fread(transform, sizeof(transform), 1, fp) == 1 &&
+            fread(&pointCount, sizeof(pointCount), 1, fp) == 1 &&
+            pointCount <= remaining() / (3 * sizeof(btScalar));
+    if (!valid) {
+      break;
+    }
+    std::vector<btScalar> points(std::size_t(pointCount) * 3);
+    valid = fread(points.data(), sizeof(btScalar), points.size(), fp) ==
+            points.size();
+    if (!valid) {
+      break;
+    }
+    loaded.convexShapes.emplace_back(std::make_shared<btConvexHullShape>(
+        points.data(), pointCount, 3 * sizeof(btScalar)));
+    loaded.convexShapes.back()->setMargin(0.0);
+    loaded.convexShapes.back()->recalcLocalAabb();
+    loaded.transforms.emplace_back();
+    loaded.transforms.back().setFromOpenGLMatrix(transform);
+  }
+  fclose(fp);
+  if (!valid) {
+    LOG(WARNING) << "Ignoring invalid or outdated collision hull cache "
+                 << filename;
+    return false;
+  }
+  shapes = std::move(loaded);
+  return true;
+}
+
+void saveCollisionHulls(const std::string& filename,
+                        uint64_t contentHash,
+                        const BulletCollisionShapes& shapes) {
+  HullCacheHeader header;
+  header.magic = HULL_CACHE_MAGIC;
+  header.version = HULL_CACHE_VERSION;
+  header.scalarSize = sizeof(btScalar);
+  header.hullCount = shapes.convexShapes.size();
+  header.contentHash = contentHash;
+  if (!io::writeFileAtomically(filename, [&](FILE* fp) {
+        fwrite(&header, sizeof(header), 1, fp);
+        for (std::size_t i = 0; i != shapes.convexShapes.size(); ++i) {
+          btScalar transform[16];
+          shapes.transforms[i].getOpenGLMatrix(transform);
+          const btConvexHullShape& hull = *shapes.convexShapes[i];
+          const uint32_t pointCount = hull.getNumPoints();
+          fwrite(transform, sizeof(transform), 1, fp);
+          fwrite(&pointCount, sizeof(pointCount), 1, fp);
+          for (uint32_t j = 0; j != pointCount; ++j) {
+            fwrite(hull.getUnscaledPoints()[j].m_floats, sizeof(btScalar), 3,
+                   fp);
+          }
+        }
+        return true;
+      })) {
+    LOG(WARNING) << "Cannot write collision hull cache " << filename;
+  }
+}
+
+uint64_t hashSceneMesh(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> positions,
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices,
+    const btVector3& scaling) {
+  ContentHash hash;
+  hash.add(positions.data(), positions.size() * sizeof(Magnum::Vector3));
+  hash.add(indices.data(), indices.size() * sizeof(Magnum::UnsignedInt));
+  hash.add(scaling.m_floats, 3 * sizeof(btScalar));
+  return hash.value;
+}
+
+struct BvhCacheHeader {
+  int magic;
+  int version;
+  int scalarSize;
+  uint32_t byteSize;
+  uint64_t contentHash;
+};
+constexpr int BVH_CACHE_MAGIC = 'Q' << 24 | 'B' << 16 | 'V' << 8 | 'H';
+constexpr int BVH_CACHE_VERSION = 1;
+
+Corrade::Containers::Array<char> allocateBvhBuffer(std::size_t size) {
+  // btQuantizedBvh wants its in-place data 16-byte aligned
+  return Corrade::Containers::Array<char>{
+      static_cast<char*>(btAlignedAlloc(size, 16)), size,
+      [](char* data, std::size_t) { btAlignedFree(data); }};
+}
+
+// nullptr if the file doesn't exist, is invalid or was made from a different
+// mesh, otherwise the BVH deserialized in place into buffer
+btOptimizedBvh* loadSceneBvh(const std::string& filename,
+                             uint64_t contentHash,
+                             Corrade::Containers::Array<char>& buffer) {
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (!fp) {
+    return nullptr;
+  }
+  BvhCacheHeader header;
+  bool valid = fread(&header, sizeof(header), 1, fp) == 1 &&
+               header.magic == BVH_CACHE_MAGIC &&
+               header.version == BVH_CACHE_VERSION &&
+               header.scalarSize == sizeof(btScalar) &&
+               header.contentHash == contentHash;
+  // don't allocate more than a corrupted file holds
+  if (valid) {
+    const long offset = std::ftell(fp);
+    std::fseek(fp, 0, SEEK_END);
+    valid = std::ftell(fp) - offset == long(header.byteSize) &&
+            std::fseek(fp, offset, SEEK_SET) == 0;
+  }
+  Corrade::Containers::Array<char> loaded;
+  if (valid) {
+    loaded = allocateBvhBuffer(header.byteSize);
+    valid = fread(loaded.data(), 1, loaded.size(), fp) == loaded.size();
+  }
+  fclose(fp);
+  btOptimizedBvh* bvh =
+      valid ? btOptimizedBvh::deSerializeInPlace(loaded.data(), loaded.size(),
+                                                 false)
+            : nullptr;
+  if (!bvh) {
+    LOG(WARNING) << "Ignoring invalid or outdated collision BVH cache "
+                 << filename;
+    return nullptr;
+  }
+  buffer = std::move(loaded);
+  return bvh;
+}
+
+void saveSceneBvh(const std::string& filename,
+                  uint64_t contentHash,
+                  const btOptimizedBvh& bvh) {
+  const std::size_t byteSize = bvh.calculateSerializeBufferSize();
+  Corrade::Containers::Array<char> buffer = allocateBvhBuffer(byteSize);
+  if (!bvh.serializeInPlace(buffer.data(), byteSize, false)) {
+    LOG(WARNING) << "Cannot serialize collision BVH " << filename;
+    return;
+  }
+
+  BvhCacheHeader header;
+  header.magic = BVH_CACHE_MAGIC;
+  header.version = BVH_CACHE_VERSION;
+  header.scalarSize = sizeof(btScalar);
+  header.byteSize = byteSize;
+  header.contentHash = contentHash;
+  if (!io::writeFileAtomically(filename, [&](FILE* fp) {
+        fwrite(&header, sizeof(header), 1, fp);
+        fwrite(buffer.data(), 1, buffer.size(), fp);
+        return true;
+      })) {
+    LOG(WARNING) << "Cannot write collision BVH cache " << filename;
+  }
+}
+
+// Replace the points of each hull with just its vertices. The hulls describe
+// the same shape, but support queries on them get a lot cheaper.
+void reduceToHullVertices(BulletCollisionShapes& shapes) {
+  for (auto& shape : shapes.convexShapes) {
+    btConvexHullComputer computer;
+    computer.compute(&shape->getUnscaledPoints()->x(), sizeof(btVector3),
+                     shape->getNumPoints(), 0.0, 0.0);
+    if (computer.vertices.size() == 0) {
+      continue;  // degenerate, keep as is
+    }
+    auto reduced = std::make_shared<btConvexHullShape>(
+        &computer.vertices[0].x(), computer.vertices.size(),
+        sizeof(btVector3));
+    reduced->setMargin(shape->getMargin());
+    reduced->recalcLocalAabb();
+    shape = std::move(reduced);
+  }
+}
+}  // namespace
+
 BulletRigidObject::BulletRigidObject(
     scene::SceneNode* rigidBodyNode,
-    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld)
+    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+    BulletCollisionShapeCache* collisionShapeCache)
     : RigidObject{rigidBodyNode},
       MotionState(*rigidBodyNode),
-      bWorld_(bWorld) {}
+      bWorld_(bWorld),
+      collisionShapeCache_(collisionShapeCache) {}
 
 bool BulletRigidObject::initializeSceneFinalize(
     const assets::ResourceManager& resMgr,
@@ -42,7 +329,17 @@ bool BulletRigidObject::initializeSceneFinalize(
   const assets::MeshMetaData& metaData =
       resMgr.getMeshMetaData(physicsSceneAttributes->getCollisionMeshHandle());
 
-  constructBulletSceneFromMeshes(Magnum::Matrix4{}, meshGroup, metaData.root);
+  if (physicsSceneAttributes->getMergeCollisionMeshes()) {
+    constructMergedBulletScene(
+        meshGroup, metaData.root,
+        physicsSceneAttributes->getCollisionWeldDistance(),
+        physicsSceneAttributes->getCollisionChunkSize(),
+        physicsSceneAttributes->getCollisionBvhCacheDirectory());
+  } else {
+    constructBulletSceneFromMeshes(
+        Magnum::Matrix4{}, meshGroup, metaData.root,
+        physicsSceneAttributes->getCollisionBvhCacheDirectory());
+  }
   for (auto& object : bSceneCollisionObjects_) {
     object->setFriction(physicsSceneAttributes->getFrictionCoefficient());
     object->setRestitution(physicsSceneAttributes->getRestitutionCoefficient());
@@ -75,26 +372,71 @@ bool BulletRigidObject::initializeObjectFinalize(
   //! Iterate through all mesh components for one object
   //! The components are combined into a convex compound shape
   bObjectShape_ = std::make_unique<btCompoundShape>();
+  Magnum::Vector3 objectScaling = physicsObjectAttributes->getScale();
 
   if (!usingBBCollisionShape_) {
-    constructBulletCompoundFromMeshes(Magnum::Matrix4{}, meshGroup,
-                                      metaData.root, joinCollisionMeshes);
-
-    // add the final object after joining meshes
-    if (joinCollisionMeshes) {
-      bObjectConvexShapes_.back()->setMargin(0.0);
-      bObjectConvexShapes_.back()->recalcLocalAabb();
-      bObjectShape_->addChildShape(btTransform::getIdentity(),
-                                   bObjectConvexShapes_.back().get());
+    // The hulls only depend on the mesh, joining and scale, so they're built
+    // once and shared by all instances of a template
+    const BulletCollisionShapeKey key{
+        physicsObjectAttributes->getCollisionMeshHandle(), joinCollisionMeshes,
+        objectScaling.x(), objectScaling.y(), objectScaling.z()};
+    auto cached = collisionShapeCache_ ? collisionShapeCache_->find(key)
+                                       : BulletCollisionShapeCache::iterator{};
+    BulletCollisionShapes built;
+    if (!collisionShapeCache_ || cached == collisionShapeCache_->end()) {
+      // the unscaled hulls can be stored on disk, so they're built only once
+      // per asset and not on every run
+      const std::string hullCacheFile =
+          physicsObjectAttributes->getCollisionHullCache();
+      const uint64_t contentHash =
+          hullCacheFile.empty() ? 0
+                                : hashCollisionMeshes(meshGroup, metaData.root,
+                                                      joinCollisionMeshes);
+      if (hullCacheFile.empty() ||
+          !loadCollisionHulls(hullCacheFile, contentHash, built)) {
+        constructBulletCompoundFromMeshes(Magnum::Matrix4{}, meshGroup,
+                                          metaData.root, joinCollisionMeshes,
+                                          built);
+
+        // add the final object after joining meshes
+        if (joinCollisionMeshes && !built.convexShapes.empty()) {
+          built.convexShapes.back()->setMargin(0.0);
+          built.convexShapes.back()->recalcLocalAabb();
+          built.transforms.push_back(btTransform::getIdentity());
+        }
+
+        if (!hullCacheFile.empty()) {
+          reduceToHullVertices(built);
+          saveCollisionHulls(hullCacheFile, contentHash, built);
+        }
+      }
+
+      // apply the scale to the hulls directly, as btCompoundShape would
+      // otherwise scale the shared children again for every instance
+      for (std::size_t i = 0; i != built.convexShapes.size(); ++i) {
+        built.convexShapes[i]->setLocalScaling(btVector3{objectScaling});
+        built.transforms[i].setOrigin(built.transforms[i].getOrigin() *
+                                      btVector3{objectScaling});
+      }
+      if (collisionShapeCache_) {
+        cached = collisionShapeCache_->emplace(key, std::move(built)).first;
+      }
+    }
+    const BulletCollisionShapes& shapes =
+        collisionShapeCache_ ? cached->second : built;
+
+    bObjectConvexShapes_ = shapes.convexShapes;
+    for (std::size_t i = 0; i != shapes.convexShapes.size(); ++i) {
+      bObjectShape_->addChildShape(shapes.transforms[i],
+                                   shapes.convexShapes[i].get());
     }
+  } else {
+    bObjectShape_->setLocalScaling(btVector3{objectScaling});
   }
 
   //! Set properties
   bObjectShape_->setMargin(margin);
 
-  Magnum::Vector3 objectScaling = physicsObjectAttributes->getScale();
-  bObjectShape_->setLocalScaling(btVector3{objectScaling});
-
   btVector3 bInertia = btVector3(physicsObjectAttributes->getInertia());
 
   if (!usingBBCollisionShape_) {
@@ -102,8 +444,8 @@ bool BulletRigidObject::initializeObjectFinalize(
       // allow bullet to compute the inertia tensor if we don't have one
       bObjectShape_->calculateLocalInertia(physicsObjectAttributes->getMass(),
                                            bInertia);  // overrides bInertia
-      LOG(INFO) << "Automatic object inertia computed: " << bInertia.x() << " "
-                << bInertia.y() << " " << bInertia.z();
+      VLOG(1) << "Automatic object inertia computed: " << bInertia.x() << " "
+              << bInertia.y() << " " << bInertia.z();
     }
   }
 
@@ -120,7 +462,9 @@ bool BulletRigidObject::initializeObjectFinalize(
   //! Create rigid body
   bObjectRigidBody_ = std::make_unique<btRigidBody>(info);
   //! Add to world
-  bWorld_->addRigidBody(bObjectRigidBody_.get());
+  collisionGroup_ = physicsObjectAttributes->getCollisionGroup();
+  collisionMask_ = physicsObjectAttributes->getCollisionMask();
+  addRigidBodyToWorld();
   //! Sync render pose with physics
   syncPose();
   return true;
@@ -130,63 +474,206 @@ void BulletRigidObject::finalizeObject() {
   if (isUsingBBCollisionShape()) {
     setCollisionFromBB();
   }
+  initialInertia_ = getInertiaVector();
+}
+
+void BulletRigidObject::setPooled(bool pooled) {
+  if (rigidObjectType_ != RigidObjectType::OBJECT) {
+    return;
+  }
+  if (pooled) {
+    // kinematic without collisions is out of the world entirely
+    setMotionType(MotionType::KINEMATIC);
+    setKinematicCollisions(false);
+    return;
+  }
+
+  const assets::PhysicsObjectAttributes& attributes =
+      *initializationAttributes_;
+  bObjectRigidBody_->setMassProps(attributes.getMass(),
+                                  btVector3{initialInertia_});
+  bObjectRigidBody_->setFriction(attributes.getFrictionCoefficient());
+  bObjectRigidBody_->setRestitution(attributes.getRestitutionCoefficient());
+  bObjectRigidBody_->setDamping(attributes.getLinearDamping(),
+                                attributes.getAngularDamping());
+  // setting the margin unshares the hulls, so only if it was changed
+  if (bObjectShape_->getMargin() != attributes.getMargin()) {
+    setMargin(attributes.getMargin());
+  }
+  bObjectRigidBody_->clearForces();
+  collisionGroup_ = attributes.getCollisionGroup();
+  collisionMask_ = attributes.getCollisionMask();
+
+  // back into the world as a kinematic object, then dynamic like a new one
+  RigidObject::setPooled(false);
+  setMotionType(MotionType::DYNAMIC);
+  setLinearVelocity(Magnum::Vector3{});
+  setAngularVelocity(Magnum::Vector3{});
+}
+void BulletRigidObject::addSceneMeshShape(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> positions,
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices,
+    const Magnum::Matrix4& transformation,
+    const std::string& bvhCacheDirectory) {
+
+  // SCENE: create a concave static mesh
+  btIndexedMesh bulletMesh;
+
+  //! Configure Bullet Mesh
+  //! This part is very likely to cause segfault, if done incorrectly
+  bulletMesh.m_numTriangles = indices.size() / 3;
+  bulletMesh.m_triangleIndexBase =
+      reinterpret_cast<const unsigned char*>(indices.data());
+  bulletMesh.m_triangleIndexStride = 3 * sizeof(Magnum::UnsignedInt);
+  bulletMesh.m_numVertices = positions.size();
+  bulletMesh.m_vertexBase =
+      reinterpret_cast<const unsigned char*>(positions.data());
+  bulletMesh.m_vertexStride = sizeof(Magnum::Vector3);
+  bulletMesh.m_indexType = PHY_INTEGER;
+  bulletMesh.m_vertexType = PHY_FLOAT;
+  std::unique_ptr<btTriangleIndexVertexArray> indexedVertexArray =
+      std::make_unique<btTriangleIndexVertexArray>();
+  indexedVertexArray->addIndexedMesh(bulletMesh, PHY_INTEGER);  // exact shape
+
+  //! Embed 3D mesh into bullet shape
+  //! btBvhTriangleMeshShape is the most generic/slow choice
+  //! which allows concavity if the object is static
+  std::unique_ptr<btBvhTriangleMeshShape> meshShape =
+      std::make_unique<btBvhTriangleMeshShape>(indexedVertexArray.get(),
+                                               true, false);
+  meshShape->setMargin(0.0);
+  // scale is a property of the shape, the BVH is built for it
+  const btVector3 scaling{transformation.scaling()};
+  std::string bvhCacheFilename;
+  uint64_t bvhHash = 0;
+  btOptimizedBvh* cachedBvh = nullptr;
+  if (!bvhCacheDirectory.empty()) {
+    bvhHash = hashSceneMesh(positions, indices, scaling);
+    bvhCacheFilename = Corrade::Utility::Directory::join(
+        bvhCacheDirectory,
+        Corrade::Utility::formatString("{:.16x}.bvhcache", bvhHash));
+    Corrade::Containers::Array<char> buffer;
+    cachedBvh = loadSceneBvh(bvhCacheFilename, bvhHash, buffer);
+    if (cachedBvh) {
+      bSceneBvhBuffers_.emplace_back(std::move(buffer));
+    }
+  }
+  if (cachedBvh) {
+    meshShape->setOptimizedBvh(cachedBvh, scaling);
+  } else {
+    // scaling first, so the BVH is only built once
+    meshShape->btTriangleMeshShape::setLocalScaling(scaling);
+    meshShape->buildOptimizedBvh();
+    if (!bvhCacheFilename.empty()) {
+      saveSceneBvh(bvhCacheFilename, bvhHash, *meshShape->getOptimizedBvh());
+    }
+  }
+  std::unique_ptr<btCollisionObject> sceneCollisionObject =
+      std::make_unique<btCollisionObject>();
+  sceneCollisionObject->setCollisionShape(meshShape.get());
+  // rotation|translation are properties of the object
+  sceneCollisionObject->setWorldTransform(
+      btTransform{btMatrix3x3{transformation.rotation()},
+                  btVector3{transformation.translation()}});
+
+  bSceneArrays_.emplace_back(std::move(indexedVertexArray));
+  bSceneShapes_.emplace_back(std::move(meshShape));
+  bSceneCollisionObjects_.emplace_back(std::move(sceneCollisionObject));
 }
+
 void BulletRigidObject::constructBulletSceneFromMeshes(
     const Magnum::Matrix4& transformFromParentToWorld,
     const std::vector<assets::CollisionMeshData>& meshGroup,
-    const assets::MeshTransformNode& node) {
+    const assets::MeshTransformNode& node,
+    const std::string& bvhCacheDirectory) {
   Magnum::Matrix4 transformFromLocalToWorld =
       transformFromParentToWorld * node.transformFromLocalToParent;
   if (node.meshIDLocal != ID_UNDEFINED) {
     const assets::CollisionMeshData& mesh = meshGroup[node.meshIDLocal];
-
-    // SCENE: create a concave static mesh
-    btIndexedMesh bulletMesh;
-
-    Corrade::Containers::ArrayView<Magnum::Vector3> v_data = mesh.positions;
-    Corrade::Containers::ArrayView<Magnum::UnsignedInt> ui_data = mesh.indices;
-
-    //! Configure Bullet Mesh
-    //! This part is very likely to cause segfault, if done incorrectly
-    bulletMesh.m_numTriangles = ui_data.size() / 3;
-    bulletMesh.m_triangleIndexBase =
-        reinterpret_cast<const unsigned char*>(ui_data.data());
-    bulletMesh.m_triangleIndexStride = 3 * sizeof(Magnum::UnsignedInt);
-    bulletMesh.m_numVertices = v_data.size();
-    bulletMesh.m_vertexBase =
-        reinterpret_cast<const unsigned char*>(v_data.data());
-    bulletMesh.m_vertexStride = sizeof(Magnum::Vector3);
-    bulletMesh.m_indexType = PHY_INTEGER;
-    bulletMesh.m_vertexType = PHY_FLOAT;
-    std::unique_ptr<btTriangleIndexVertexArray> indexedVertexArray =
-        std::make_unique<btTriangleIndexVertexArray>();
-    indexedVertexArray->addIndexedMesh(bulletMesh, PHY_INTEGER);  // exact shape
-
-    //! Embed 3D mesh into bullet shape
-    //! btBvhTriangleMeshShape is the most generic/slow choice
-    //! which allows concavity if the object is static
-    std::unique_ptr<btBvhTriangleMeshShape> meshShape =
-        std::make_unique<btBvhTriangleMeshShape>(indexedVertexArray.get(),
-                                                 true);
-    meshShape->setMargin(0.0);
-    meshShape->setLocalScaling(
-        btVector3{transformFromLocalToWorld
-                      .scaling()});  // scale is a property of the shape
-    std::unique_ptr<btCollisionObject> sceneCollisionObject =
-        std::make_unique<btCollisionObject>();
-    sceneCollisionObject->setCollisionShape(meshShape.get());
-    // rotation|translation are properties of the object
-    sceneCollisionObject->setWorldTransform(
-        btTransform{btMatrix3x3{transformFromLocalToWorld.rotation()},
-                    btVector3{transformFromLocalToWorld.translation()}});
-
-    bSceneArrays_.emplace_back(std::move(indexedVertexArray));
-    bSceneShapes_.emplace_back(std::move(meshShape));
-    bSceneCollisionObjects_.emplace_back(std::move(sceneCollisionObject));
+    addSceneMeshShape(mesh.positions, mesh.indices, transformFromLocalToWorld,
+                      bvhCacheDirectory);
   }
 
   for (auto& child : node.children) {
-    constructBulletSceneFromMeshes(transformFromLocalToWorld, meshGroup, child);
+    constructBulletSceneFromMeshes(transformFromLocalToWorld, meshGroup, child,
+                                   bvhCacheDirectory);
+  }
+}
+
+void BulletRigidObject::constructMergedBulletScene(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& root,
+    float weldDistance,
+    float chunkSize,
+    const std::string& bvhCacheDirectory) {
+  std::vector<Magnum::Vector3> positions;
+  std::vector<Magnum::UnsignedInt> indices;
+  gatherSceneMeshes(Magnum::Matrix4{}, meshGroup, root, positions, indices);
+  const std::size_t triangleCount = indices.size() / 3;
+
+  if (weldDistance > 0.0f) {
+    assets::VertexClusters clusters = assets::clusterVertices(
+        Corrade::Containers::arrayView(indices.data(), indices.size()),
+        Corrade::Containers::arrayView(positions.data(), positions.size()),
+        weldDistance);
+    // a welded vertex is the average of the vertices merged into it
+    bSceneMergedPositions_.assign(clusters.clusterCount, Magnum::Vector3{});
+    std::vector<Magnum::UnsignedInt> mergedCounts(clusters.clusterCount, 0);
+    for (std::size_t i = 0; i != positions.size(); ++i) {
+      const Magnum::UnsignedInt cluster = clusters.vertexClusters[i];
+      bSceneMergedPositions_[cluster] += positions[i];
+      ++mergedCounts[cluster];
+    }
+    for (std::size_t i = 0; i != clusters.clusterCount; ++i) {
+      if (mergedCounts[i]) {
+        bSceneMergedPositions_[i] /= Magnum::Float(mergedCounts[i]);
+      }
+    }
+    indices = std::move(clusters.indices);
+  } else {
+    bSceneMergedPositions_ = std::move(positions);
+  }
+
+  // the chunks share the vertices, all of them have to be filled before the
+  // shapes reference them
+  bSceneMergedIndices_.clear();
+  if (chunkSize > 0.0f) {
+    std::map<std::tuple<int, int, int>, std::size_t> chunks;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+      const Magnum::Vector3 centroid =
+          (bSceneMergedPositions_[indices[i]] +
+           bSceneMergedPositions_[indices[i + 1]] +
+           bSceneMergedPositions_[indices[i + 2]]) /
+          (3.0f * chunkSize);
+      const auto cell = std::make_tuple(int(std::floor(centroid.x())),
+                                        int(std::floor(centroid.y())),
+                                        int(std::floor(centroid.z())));
+      auto inserted = chunks.emplace(cell, bSceneMergedIndices_.size());
+      if (inserted.second) {
+        bSceneMergedIndices_.emplace_back();
+      }
+      std::vector<Magnum::UnsignedInt>& chunk =
+          bSceneMergedIndices_[inserted.first->second];
+      chunk.insert(chunk.end(), indices.begin() + i, indices.begin() + i + 3);
+    }
+  } else if (!indices.empty()) {
+    bSceneMergedIndices_.emplace_back(std::move(indices));
+  }
+
+  std::size_t mergedTriangleCount = 0;
+  for (const auto& chunk : bSceneMergedIndices_) {
+    mergedTriangleCount += chunk.size() / 3;
+  }
+  LOG(INFO) << "Merged " << triangleCount << " scene collision triangles into "
+            << mergedTriangleCount << " in " << bSceneMergedIndices_.size()
+            << " meshes";
+
+  for (const auto& chunk : bSceneMergedIndices_) {
+    addSceneMeshShape(
+        Corrade::Containers::arrayView(bSceneMergedPositions_.data(),
+                                       bSceneMergedPositions_.size()),
+        Corrade::Containers::arrayView(chunk.data(), chunk.size()),
+        Magnum::Matrix4{}, bvhCacheDirectory);
   }
 }
 
@@ -196,7 +683,8 @@ void BulletRigidObject::constructBulletCompoundFromMeshes(
     const Magnum::Matrix4& transformFromParentToWorld,
     const std::vector<assets::CollisionMeshData>& meshGroup,
     const assets::MeshTransformNode& node,
-    bool join) {
+    bool join,
+    BulletCollisionShapes& shapes) {
   Magnum::Matrix4 transformFromLocalToWorld =
       transformFromParentToWorld * node.transformFromLocalToParent;
   if (node.meshIDLocal != ID_UNDEFINED) {
@@ -207,32 +695,30 @@ void BulletRigidObject::constructBulletCompoundFromMeshes(
     if (join) {
       // add all points to a single convex instead of compounding (more
       // stable)
-      if (bObjectConvexShapes_.empty()) {
+      if (shapes.convexShapes.empty()) {
         // create the convex if it does not exist
-        bObjectConvexShapes_.emplace_back(
-            std::make_unique<btConvexHullShape>());
+        shapes.convexShapes.emplace_back(std::make_shared<btConvexHullShape>());
       }
 
       // add points
       for (auto& v : mesh.positions) {
-        bObjectConvexShapes_.back()->addPoint(
+        shapes.convexShapes.back()->addPoint(
             btVector3(transformFromLocalToWorld.transformPoint(v)), false);
       }
     } else {
-      bObjectConvexShapes_.emplace_back(std::make_unique<btConvexHullShape>(
+      shapes.convexShapes.emplace_back(std::make_shared<btConvexHullShape>(
           static_cast<const btScalar*>(mesh.positions.data()->data()),
           mesh.positions.size(), sizeof(Magnum::Vector3)));
-      bObjectConvexShapes_.back()->setMargin(0.0);
-      bObjectConvexShapes_.back()->recalcLocalAabb();
+      shapes.convexShapes.back()->setMargin(0.0);
+      shapes.convexShapes.back()->recalcLocalAabb();
       //! Add to compound shape stucture
-      bObjectShape_->addChildShape(btTransform{transformFromLocalToWorld},
-                                   bObjectConvexShapes_.back().get());
+      shapes.transforms.emplace_back(transformFromLocalToWorld);
     }
   }
 
   for (auto& child : node.children) {
     constructBulletCompoundFromMeshes(transformFromLocalToWorld, meshGroup,
-                                      child, join);
+                                      child, join, shapes);
   }
 }
 
@@ -255,16 +741,15 @@ void BulletRigidObject::setCollisionFromBB() {
     bObjectShape_->calculateLocalInertia(getMass(),
                                          bInertia);  // overrides bInertia
 
-    LOG(INFO) << "Automatic BB object inertia computed: " << bInertia.x() << " "
-              << bInertia.y() << " " << bInertia.z();
+    VLOG(1) << "Automatic BB object inertia computed: " << bInertia.x() << " "
+            << bInertia.y() << " " << bInertia.z();
 
     setInertiaVector(Magnum::Vector3(bInertia));
   }
 }
 
 BulletRigidObject::~BulletRigidObject() {
-  if (rigidObjectType_ == RigidObjectType::OBJECT &&
-      objectMotionType_ != MotionType::STATIC) {
+  if (isRigidBodyInWorld()) {
     // remove rigid body from the world
     bWorld_->removeRigidBody(bObjectRigidBody_.get());
   } else if (rigidObjectType_ == RigidObjectType::SCENE ||
@@ -281,7 +766,8 @@ bool BulletRigidObject::isActive() {
   if (rigidObjectType_ == RigidObjectType::SCENE) {
     return false;
   } else if (rigidObjectType_ == RigidObjectType::OBJECT) {
-    return bObjectRigidBody_->isActive();
+    // bodies outside of the world are never simulated
+    return isRigidBodyInWorld() && bObjectRigidBody_->isActive();
   } else {
     return false;
   }
@@ -293,6 +779,54 @@ void BulletRigidObject::setActive() {
   }
 }
 
+void BulletRigidObject::setSleeping() {
+  if (rigidObjectType_ == RigidObjectType::OBJECT &&
+      objectMotionType_ == MotionType::DYNAMIC) {
+    bObjectRigidBody_->setActivationState(ISLAND_SLEEPING);
+  }
+}
+
+void BulletRigidObject::setKinematicCollisions(bool enabled) {
+  if (enabled == kinematicCollisions_) {
+    return;
+  }
+  const bool wasInWorld = isRigidBodyInWorld();
+  kinematicCollisions_ = enabled;
+  if (wasInWorld && !isRigidBodyInWorld()) {
+    bWorld_->removeRigidBody(bObjectRigidBody_.get());
+  } else if (!wasInWorld && isRigidBodyInWorld()) {
+    syncPose();
+    addRigidBodyToWorld();
+  }
+}
+
+std::pair<int, int> BulletRigidObject::collisionFilter() const {
+  // zero keeps Bullet's default for the motion type
+  const bool isDynamic = objectMotionType_ == MotionType::DYNAMIC;
+  const int group = collisionGroup_
+                        ? collisionGroup_
+                        : isDynamic ? int(btBroadphaseProxy::DefaultFilter)
+                                    : int(btBroadphaseProxy::StaticFilter);
+  const int mask =
+      collisionMask_
+          ? collisionMask_
+          : isDynamic ? int(btBroadphaseProxy::AllFilter)
+                      : int(btBroadphaseProxy::AllFilter ^
+                            btBroadphaseProxy::StaticFilter);
+  return {group, mask};
+}
+
+void BulletRigidObject::addRigidBodyToWorld() {
+  const std::pair<int, int> filter = collisionFilter();
+  bWorld_->addRigidBody(bObjectRigidBody_.get(), filter.first, filter.second);
+}
+
+bool BulletRigidObject::isRigidBodyInWorld() const {
+  return rigidObjectType_ == RigidObjectType::OBJECT &&
+         (objectMotionType_ == MotionType::DYNAMIC ||
+          (objectMotionType_ == MotionType::KINEMATIC && kinematicCollisions_));
+}
+
 bool BulletRigidObject::setMotionType(MotionType mt) {
   if (mt == objectMotionType_) {
     return true;  // no work
@@ -302,11 +836,14 @@ bool BulletRigidObject::setMotionType(MotionType mt) {
   if (objectMotionType_ == MotionType::STATIC) {
     bWorld_->removeCollisionObject(bSceneCollisionObjects_.back().get());
     bSceneCollisionObjects_.clear();
-  } else {
+  } else if (isRigidBodyInWorld()) {
     bWorld_->removeRigidBody(bObjectRigidBody_.get());
   }
 
   if (rigidObjectType_ == RigidObjectType::OBJECT) {
+    // the pose isn't synced while the body is outside of the world
+    bObjectRigidBody_->setWorldTransform(
+        btTransform(node().transformationMatrix()));
     if (mt == MotionType::KINEMATIC) {
       bObjectRigidBody_->setCollisionFlags(
           bObjectRigidBody_->getCollisionFlags() |
@@ -315,7 +852,9 @@ bool BulletRigidObject::setMotionType(MotionType mt) {
           bObjectRigidBody_->getCollisionFlags() &
           ~btCollisionObject::CF_STATIC_OBJECT);
       objectMotionType_ = MotionType::KINEMATIC;
-      bWorld_->addRigidBody(bObjectRigidBody_.get());
+      if (kinematicCollisions_) {
+        addRigidBodyToWorld();
+      }
       return true;
     } else if (mt == MotionType::STATIC) {
       bObjectRigidBody_->setCollisionFlags(
@@ -330,12 +869,15 @@ bool BulletRigidObject::setMotionType(MotionType mt) {
       std::unique_ptr<btCollisionObject> sceneCollisionObject =
           std::make_unique<btCollisionObject>();
       sceneCollisionObject->setCollisionShape(bObjectShape_.get());
+      sceneCollisionObject->setUserIndex(objectID_);
       sceneCollisionObject->setWorldTransform(
           bObjectRigidBody_->getWorldTransform());
       bWorld_->addCollisionObject(
           sceneCollisionObject.get(),
-          2,       // collisionFilterGroup (2 == StaticFilter)
-          1 + 2);  // collisionFilterMask (1 == DefaultFilter, 2==StaticFilter)
+          // collisionFilterGroup (2 == StaticFilter)
+          collisionGroup_ ? collisionGroup_ : 2,
+          // collisionFilterMask (1 == DefaultFilter, 2==StaticFilter)
+          collisionMask_ ? collisionMask_ : 1 + 2);
       bSceneCollisionObjects_.emplace_back(std::move(sceneCollisionObject));
       return true;
     } else if (mt == MotionType::DYNAMIC) {
@@ -346,7 +888,7 @@ bool BulletRigidObject::setMotionType(MotionType mt) {
           bObjectRigidBody_->getCollisionFlags() &
           ~btCollisionObject::CF_KINEMATIC_OBJECT);
       objectMotionType_ = MotionType::DYNAMIC;
-      bWorld_->addRigidBody(bObjectRigidBody_.get());
+      addRigidBodyToWorld();
       setActive();
       return true;
     }
@@ -438,8 +980,8 @@ void BulletRigidObject::syncPose() {
     //! You shouldn't need to set scene transforms manually
     //! Scenes are loaded as is
     return;
-  } else if (rigidObjectType_ == RigidObjectType::OBJECT) {
-    //! For syncing objects
+  } else if (isRigidBodyInWorld()) {
+    //! For syncing objects, others are synced when they enter the world
     bObjectRigidBody_->setWorldTransform(
         btTransform(node().transformationMatrix()));
   }
@@ -449,6 +991,7 @@ void BulletRigidObject::setMargin(const double margin) {
   if (rigidObjectType_ == RigidObjectType::SCENE) {
     return;
   } else {
+    makeConvexShapesUnique();
     for (std::size_t i = 0; i < bObjectConvexShapes_.size(); i++) {
       bObjectConvexShapes_[i]->setMargin(margin);
     }
@@ -456,6 +999,31 @@ void BulletRigidObject::setMargin(const double margin) {
   }
 }
 
+void BulletRigidObject::makeConvexShapesUnique() {
+  for (auto& shape : bObjectConvexShapes_) {
+    if (shape.use_count() == 1) {
+      continue;
+    }
+    auto copy = std::make_shared<btConvexHullShape>(
+        static_cast<const btScalar*>(shape->getUnscaledPoints()->m_floats),
+        shape->getNumPoints(), sizeof(btVector3));
+    copy->setLocalScaling(shape->getLocalScaling());
+    copy->setMargin(shape->getMargin());
+
+    // children can't be replaced in place, so re-add it with the same
+    // transformation
+    for (int i = 0; i < bObjectShape_->getNumChildShapes(); ++i) {
+      if (bObjectShape_->getChildShape(i) == shape.get()) {
+        const btTransform transform = bObjectShape_->getChildTransform(i);
+        bObjectShape_->removeChildShapeByIndex(i);
+        bObjectShape_->addChildShape(transform, copy.get());
+        break;
+      }
+    }
+    shape = std::move(copy);
+  }
+}
+
 void BulletRigidObject::setMass(const double mass) {
   if (rigidObjectType_ == RigidObjectType::SCENE)
     return;
@@ -629,8 +1197,38 @@ double BulletRigidObject::getAngularDamping() {
 
 bool BulletRigidObject::contactTest() {
   SimulationContactResultCallback src;
-  bWorld_->getCollisionWorld()->contactTest(bObjectRigidBody_.get(), src);
-  return src.bCollision;
+  return contactTest(src);
+}
+
+bool BulletRigidObject::contactTest(
+    SimulationContactResultCallback& callback) {
+  callback.bCollision = false;
+  if (collisionGroup_ || collisionMask_) {
+    // only report contacts the broadphase doesn't filter out
+    const std::pair<int, int> filter = collisionFilter();
+    callback.m_collisionFilterGroup = filter.first;
+    callback.m_collisionFilterMask = filter.second;
+  } else {
+    callback.m_collisionFilterGroup = btBroadphaseProxy::DefaultFilter;
+    callback.m_collisionFilterMask = btBroadphaseProxy::AllFilter;
+  }
+  if (!isRigidBodyInWorld()) {
+    // the pose of bodies outside of the world isn't synced on every change
+    bObjectRigidBody_->setWorldTransform(
+        btTransform(node().transformationMatrix()));
+  }
+  bWorld_->getCollisionWorld()->contactTest(bObjectRigidBody_.get(), callback);
+  return callback.bCollision;
+}
+
+void BulletRigidObject::setObjectID(int objectID) {
+  objectID_ = objectID;
+  if (bObjectRigidBody_) {
+    bObjectRigidBody_->setUserIndex(objectID);
+  }
+  for (auto& object : bSceneCollisionObjects_) {
+    object->setUserIndex(objectID);
+  }
 }
 
 const Magnum::Range3D BulletRigidObject::getCollisionShapeAabb() const {
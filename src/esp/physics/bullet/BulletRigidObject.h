@@ -8,6 +8,14 @@
  * @brief Struct SimulationContactResultCallback, class @ref
  * esp::physics::BulletRigidObject
  */
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
 #include <Magnum/BulletIntegration/MotionState.h>
 #include <btBulletDynamicsCommon.h>
 
@@ -61,6 +69,31 @@ struct SimulationContactResultCallback
   }
 };
 
+/**
+@brief Convex collision shapes built for an object template
+
+Built once per collision mesh, joining mode and scale, and shared by every
+@ref BulletRigidObject instantiated from it. Each instance only creates its
+own @ref btCompoundShape referencing the hulls.
+*/
+struct BulletCollisionShapes {
+  //! Convex hulls, with the object scale already applied
+  std::vector<std::shared_ptr<btConvexHullShape>> convexShapes;
+  //! Transformation of each hull in the compound, scaled as well
+  std::vector<btTransform> transforms;
+};
+
+/**
+@brief Key of @ref BulletCollisionShapeCache: collision mesh handle, whether
+the meshes are joined and the object scale
+*/
+using BulletCollisionShapeKey =
+    std::tuple<std::string, bool, float, float, float>;
+
+/** @brief Collision shapes shared by instances of the same object template */
+using BulletCollisionShapeCache =
+    std::map<BulletCollisionShapeKey, BulletCollisionShapes>;
+
 /**
 @brief An individual rigid object instance implementing an interface with Bullet
 physics to enable @ref MotionType::DYNAMIC objects.
@@ -79,9 +112,14 @@ class BulletRigidObject : public RigidObject,
    * @brief Constructor for a @ref BulletRigidObject.
    * @param rigidBodyNode The @ref scene::SceneNode this feature will be
    * attached to.
+   * @param bWorld The world the object is simulated in.
+   * @param collisionShapeCache If not null, convex hulls of objects are taken
+   * from and added to this cache instead of being built for every instance.
+   * Has to outlive the object.
    */
   BulletRigidObject(scene::SceneNode* rigidBodyNode,
-                    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld);
+                    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+                    BulletCollisionShapeCache* collisionShapeCache = nullptr);
 
   /**
    * @brief Destructor cleans up simulation structures for the object.
@@ -94,10 +132,19 @@ class BulletRigidObject : public RigidObject,
   virtual void finalizeObject() override;
 
   /**
-   * @brief Recursively construct a @ref btCompoundShape for collision from
-   * loaded mesh assets. A @ref btConvexHullShape is constructed for each
-   * sub-component, transformed to object-local space and added to the compound
-   * in a flat manner for efficiency.
+   * @brief Take the object out of the Bullet world for the object pool, or
+   * put it back as a @ref MotionType::DYNAMIC object with the mass, inertia,
+   * friction, restitution, damping, margin and collision filter of its
+   * template.
+   * @param pooled Whether the object goes into the pool.
+   */
+  void setPooled(bool pooled) override;
+
+  /**
+   * @brief Recursively construct the shapes of a @ref btCompoundShape for
+   * collision from loaded mesh assets. A @ref btConvexHullShape is constructed
+   * for each sub-component, transformed to object-local space and collected in
+   * a flat manner for efficiency.
    * @param transformFromParentToWorld The cumulative parent-to-world
    * transformation matrix constructed by composition down the @ref
    * MeshTransformNode tree to the current node.
@@ -105,12 +152,15 @@ class BulletRigidObject : public RigidObject,
    * @param node The current @ref MeshTransformNode in the recursion.
    * @param join Whether or not to join sub-meshes into a single con convex
    * shape, rather than creating individual convexes under the compound.
+   * @param[out] shapes The convex shapes and their transformations in the
+   * compound.
    */
-  void constructBulletCompoundFromMeshes(
+  static void constructBulletCompoundFromMeshes(
       const Magnum::Matrix4& transformFromParentToWorld,
       const std::vector<assets::CollisionMeshData>& meshGroup,
       const assets::MeshTransformNode& node,
-      bool join);
+      bool join,
+      BulletCollisionShapes& shapes);
 
   /**
    * @brief Recursively construct the static collision mesh objects from
@@ -120,11 +170,36 @@ class BulletRigidObject : public RigidObject,
    * MeshTransformNode tree to the current node.
    * @param meshGroup Access structure for collision mesh data.
    * @param node The current @ref MeshTransformNode in the recursion.
+   * @param bvhCacheDirectory If not empty, the quantized BVH of each mesh is
+   * loaded from this directory in place, or built and saved there, named
+   * after a hash of the triangles and their scaling. See @ref
+   * btOptimizedBvh::serializeInPlace.
    */
   void constructBulletSceneFromMeshes(
       const Magnum::Matrix4& transformFromParentToWorld,
       const std::vector<assets::CollisionMeshData>& meshGroup,
-      const assets::MeshTransformNode& node);
+      const assets::MeshTransformNode& node,
+      const std::string& bvhCacheDirectory = {});
+
+  /**
+   * @brief Construct the static collision mesh objects from all meshes of
+   * imported assets merged into one.
+   * @param meshGroup Access structure for collision mesh data.
+   * @param root The root @ref MeshTransformNode of the meshes.
+   * @param weldDistance Vertices closer than about this distance are welded
+   * with @ref assets::clusterVertices(), which also drops the triangles
+   * collapsing or duplicated in the process. Not welded if not positive.
+   * @param chunkSize If positive, the merged triangles are split into one
+   * mesh per cube of this size their centroids fall into, so that each BVH
+   * stays small. One mesh otherwise.
+   * @param bvhCacheDirectory See @ref constructBulletSceneFromMeshes().
+   */
+  void constructMergedBulletScene(
+      const std::vector<assets::CollisionMeshData>& meshGroup,
+      const assets::MeshTransformNode& root,
+      float weldDistance,
+      float chunkSize,
+      const std::string& bvhCacheDirectory = {});
 
   /**
    * @brief Check whether object is being actively simulated, or sleeping.
@@ -139,6 +214,12 @@ class BulletRigidObject : public RigidObject,
    */
   void setActive() override;
 
+  /**
+   * @brief Put a @ref MotionType::DYNAMIC object to sleep, it stays so until
+   * something wakes it up. See @ref btCollisionObject::setActivationState.
+   */
+  void setSleeping() override;
+
   /**
    * @brief Set the @ref MotionType of the object. If the object is @ref
    * ObjectType::SCENE it can only be @ref MotionType::STATIC. If the object is
@@ -150,6 +231,15 @@ class BulletRigidObject : public RigidObject,
    */
   virtual bool setMotionType(MotionType mt) override;
 
+  /**
+   * @brief Set whether the object takes part in collision detection while it
+   * is @ref MotionType::KINEMATIC. Without, its rigid body is taken out of
+   * the Bullet world and its pose only synced to it for its own contact
+   * tests.
+   * @param enabled Whether kinematic collisions are enabled.
+   */
+  void setKinematicCollisions(bool enabled) override;
+
   /**
    * @brief Shift the object's local origin by translating all children of this
    * @ref BulletRigidObject and all components of its @ref bObjectShape_.
@@ -400,6 +490,22 @@ class BulletRigidObject : public RigidObject,
    */
   bool contactTest();
 
+  /**
+   * @brief Discrete collision check reusing a result callback, see @ref
+   * contactTest().
+   * @param callback Callback to collect the results in, reset first.
+   */
+  bool contactTest(SimulationContactResultCallback& callback);
+
+  /**
+   * @brief Set the object ID reported when a ray hits this object. Stored as
+   * the user index of its Bullet collision objects, see
+   * @ref btCollisionObject::setUserIndex.
+   * @param objectID The object ID and key identifying the object in @ref
+   * PhysicsManager::existingObjects_.
+   */
+  void setObjectID(int objectID);
+
   /**
    * @brief Query the Aabb from bullet physics for the root compound shape of
    * the rigid body in its local space. See @ref btCompoundShape::getAabb.
@@ -447,20 +553,53 @@ class BulletRigidObject : public RigidObject,
    * updates. See @ref btRigidBody::setWorldTransform. */
   void syncPose() override;
 
+  /** @brief Whether the rigid body is part of the Bullet world, which is the
+   * case for dynamic objects and kinematic objects with collisions. */
+  bool isRigidBodyInWorld() const;
+
+  /** @brief Broadphase collision group and mask of the rigid body, from its
+   * template or Bullet's defaults for the motion type. See @ref
+   * assets::PhysicsObjectAttributes::setCollisionGroup. */
+  std::pair<int, int> collisionFilter() const;
+
+  /** @brief Add the rigid body to the Bullet world with its @ref
+   * collisionFilter. */
+  void addRigidBodyToWorld();
+
   //! If true, the object's bounding box will be used for collision once
   //! computed
   bool usingBBCollisionShape_ = false;
 
  private:
+  /**
+   * @brief Add a concave static mesh to the scene, with its BVH loaded from
+   * or saved to @p bvhCacheDirectory if not empty. The data has to outlive
+   * this object.
+   */
+  void addSceneMeshShape(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> positions,
+      Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices,
+      const Magnum::Matrix4& transformation,
+      const std::string& bvhCacheDirectory);
+
   /** @brief A pointer to the Bullet world to which this object belongs. See
    * @ref btMultiBodyDynamicsWorld.*/
   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld_;
 
   // === Physical scene ===
 
+  //! Scene data: merged vertices and the indices of every chunk, if the
+  //! collision meshes are merged, referenced by @ref bSceneArrays_
+  std::vector<Magnum::Vector3> bSceneMergedPositions_;
+  std::vector<std::vector<Magnum::UnsignedInt>> bSceneMergedIndices_;
+
   //! Scene data: Bullet triangular mesh vertices
   std::vector<std::unique_ptr<btTriangleIndexVertexArray>> bSceneArrays_;
 
+  //! Scene data: BVHs loaded from the cache, deserialized in place, so they
+  //! have to outlive @ref bSceneShapes_
+  std::vector<Corrade::Containers::Array<char>> bSceneBvhBuffers_;
+
   //! Scene data: Bullet triangular mesh shape
   std::vector<std::unique_ptr<btBvhTriangleMeshShape>> bSceneShapes_;
 
@@ -471,8 +610,28 @@ class BulletRigidObject : public RigidObject,
 
   // === Physical object ===
 
-  //! Object data: Composite convex collision shape
-  std::vector<std::unique_ptr<btConvexHullShape>> bObjectConvexShapes_;
+  /**
+   * @brief Replace convex shapes shared with other instances by copies, so
+   * they can be modified.
+   */
+  void makeConvexShapesUnique();
+
+  //! ID reported by ray casts, see @ref setObjectID()
+  int objectID_ = ID_UNDEFINED;
+
+  //! Inertia after @ref finalizeObject(), restored by @ref setPooled()
+  Magnum::Vector3 initialInertia_;
+
+  //! Broadphase collision group and mask, zero for Bullet's defaults
+  int collisionGroup_ = 0;
+  int collisionMask_ = 0;
+
+  //! Shapes shared between instances of the same template, may be null
+  BulletCollisionShapeCache* collisionShapeCache_;
+
+  //! Object data: Composite convex collision shape, possibly shared with
+  //! other instances through @ref collisionShapeCache_
+  std::vector<std::shared_ptr<btConvexHullShape>> bObjectConvexShapes_;
 
   //! list of @ref btCollisionShape for storing arbitrary collision shapes
   //! referenced within the @ref bObjectShape_.
@@ -0,0 +1,314 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/assets/ResourceManager.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/physics/PhysicsManager.h"
+#include "esp/physics/bullet/BulletPhysicsManager.h"
+#include "esp/scene/SceneManager.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::assets::PhysicsObjectAttributes;
+using esp::assets::ResourceManager;
+using esp::physics::MotionType;
+using esp::physics::PhysicsManager;
+
+namespace {
+
+enum class Workload {
+  // convex hulls only
+  Convex,
+  // every other object collides as its bounding box
+  Mixed,
+  // nine in ten objects are kinematic and moved every step
+  Kinematic,
+  // the objects don't collide with each other, only with the ground
+  CollisionGroups,
+  // every object has its own scale and so its own hulls, instead of all of
+  // them sharing the ones of their template
+  UniqueShapes,
+};
+
+constexpr struct {
+  const char* name;
+  Workload workload;
+} WorkloadData[]{{"convex", Workload::Convex},
+                 {"mixed primitive and convex", Workload::Mixed},
+                 {"kinematic-heavy", Workload::Kinematic},
+                 {"collision groups", Workload::CollisionGroups},
+                 {"unique shapes", Workload::UniqueShapes}};
+
+constexpr std::size_t WorkloadCount = Cr::Containers::arraySize(WorkloadData);
+
+constexpr int ObjectCounts[]{10, 100, 1000};
+
+constexpr std::size_t ObjectCountCount =
+    Cr::Containers::arraySize(ObjectCounts);
+
+constexpr struct {
+  const char* name;
+  bool pooling;
+} ChurnData[]{{"without pooling", false}, {"with pooling", true}};
+
+// steps timed by the latency test, at the default fixed timestep
+constexpr int StepCount = 200;
+
+/*
+ * Benchmarks of BulletPhysicsManager. Objects are dropped in a grid above a
+ * ground plane, so the first steps are free fall and the later ones resting
+ * contacts. The latency test times every step separately and prints
+ * percentiles together with the time per object, which shows how stepping
+ * scales with the object count; the benchmarks report the mean of batches.
+ */
+struct PhysicsBenchmark : Cr::TestSuite::Tester {
+  explicit PhysicsBenchmark();
+
+  void latency();
+
+  void benchmarkStep();
+  void benchmarkContactTests();
+  void benchmarkChurn();
+
+  // everything a simulated scene needs, the physics manager destroyed first
+  struct World {
+    ResourceManager resourceManager;
+    esp::scene::SceneManager sceneManager;
+    PhysicsManager::ptr physicsManager;
+    int sceneID = 0;
+    std::vector<int> dynamicIds, kinematicIds;
+    // templates the objects are created from
+    std::vector<std::string> templates;
+  };
+  std::unique_ptr<World> makeWorld(Workload workload, int objectCount);
+
+  // adds the objectIndex-th object of the grid and returns its ID
+  int addObject(World& world, Workload workload, int objectIndex);
+
+  // moves the kinematic objects and steps the world once
+  void step(World& world);
+
+  esp::gfx::WindowlessContext::uptr context_;
+  esp::gfx::Renderer::ptr renderer_;
+  int stepIndex_ = 0;
+};
+
+PhysicsBenchmark::PhysicsBenchmark() {
+  addInstancedTests({&PhysicsBenchmark::latency},
+                    WorkloadCount * ObjectCountCount);
+
+  addInstancedBenchmarks({&PhysicsBenchmark::benchmarkStep}, 10,
+                         WorkloadCount * ObjectCountCount);
+  addInstancedBenchmarks({&PhysicsBenchmark::benchmarkContactTests}, 10,
+                         ObjectCountCount);
+  addInstancedBenchmarks({&PhysicsBenchmark::benchmarkChurn}, 10,
+                         Cr::Containers::arraySize(ChurnData));
+
+  context_ = esp::gfx::WindowlessContext::create_unique(0);
+  renderer_ = esp::gfx::Renderer::create();
+}
+
+std::unique_ptr<PhysicsBenchmark::World> PhysicsBenchmark::makeWorld(
+    Workload workload,
+    int objectCount) {
+  const std::string sceneFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "scenes/plane.glb");
+  const std::string physicsConfigFile = Cr::Utility::Directory::join(
+      SCENE_DATASETS, "../default.phys_scene_config.json");
+  if (!Cr::Utility::Directory::exists(sceneFile)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<World> world{new World};
+  world->sceneID = world->sceneManager.initSceneGraph();
+  auto& sceneGraph = world->sceneManager.getSceneGraph(world->sceneID);
+  world->resourceManager.loadScene(
+      esp::assets::AssetInfo::fromPath(sceneFile), world->physicsManager,
+      &sceneGraph.getRootNode().createChild(), &sceneGraph.getDrawables(),
+      physicsConfigFile);
+  if (!world->physicsManager ||
+      world->physicsManager->getPhysicsSimulationLibrary() !=
+          PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    return nullptr;
+  }
+
+  const std::string hullFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/nested_box.glb");
+  const std::string sphereFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/sphere.glb");
+  const auto addTemplate = [&](const std::string& handle,
+                               const std::string& file, bool boundingBox) {
+    PhysicsObjectAttributes::ptr attributes = PhysicsObjectAttributes::create();
+    attributes->setRenderMeshHandle(file);
+    attributes->setCollisionMeshHandle(file);
+    attributes->setJoinCollisionMeshes(true);
+    attributes->setBoundingBoxCollisions(boundingBox);
+    attributes->setScale({0.1f, 0.1f, 0.1f});
+    if (workload == Workload::CollisionGroups) {
+      // in a group of their own, excluded from their mask
+      attributes->setCollisionGroup(4);
+      attributes->setCollisionMask(1 | 2);
+    }
+    world->resourceManager.loadObjectTemplate(attributes, handle);
+    world->templates.push_back(handle);
+  };
+  addTemplate("hull", hullFile, false);
+  if (workload == Workload::Mixed) {
+    addTemplate("box", sphereFile, true);
+  }
+
+  for (int i = 0; i != objectCount; ++i) {
+    const int id = addObject(*world, workload, i);
+    if (workload == Workload::Kinematic && i % 10 != 0) {
+      world->physicsManager->setObjectMotionType(id, MotionType::KINEMATIC);
+      world->kinematicIds.push_back(id);
+    } else {
+      world->dynamicIds.push_back(id);
+    }
+  }
+  return world;
+}
+
+int PhysicsBenchmark::addObject(World& world,
+                                Workload workload,
+                                int objectIndex) {
+  const std::string& handle =
+      world.templates[objectIndex % world.templates.size()];
+  if (workload == Workload::UniqueShapes) {
+    const float scale = 0.1f + objectIndex * 0.00001f;
+    world.resourceManager.getPhysicsObjectAttributes(handle)->setScale(
+        {scale, scale, scale});
+  }
+  const int id = world.physicsManager->addObject(
+      handle, &world.sceneManager.getSceneGraph(world.sceneID).getDrawables());
+  // 10x10 columns, 0.3 m apart, stacked in layers of 0.3 m
+  const int column = objectIndex % 100;
+  world.physicsManager->setTranslation(
+      id, {(column % 10 - 4.5f) * 0.3f, 0.5f + (objectIndex / 100) * 0.3f,
+           (column / 10 - 4.5f) * 0.3f});
+  return id;
+}
+
+void PhysicsBenchmark::step(World& world) {
+  // the kinematic objects sway sideways
+  const Mn::Vector3 offset =
+      Mn::Vector3::xAxis(stepIndex_++ % 2 ? 0.01f : -0.01f);
+  for (int id : world.kinematicIds) {
+    world.physicsManager->setTranslation(
+        id, world.physicsManager->getTranslation(id) + offset);
+  }
+  world.physicsManager->stepPhysics();
+}
+
+void PhysicsBenchmark::latency() {
+  auto&& data = WorkloadData[testCaseInstanceId() / ObjectCountCount];
+  const int objectCount = ObjectCounts[testCaseInstanceId() % ObjectCountCount];
+  setTestCaseDescription(std::string{data.name} + ", " +
+                         std::to_string(objectCount) + " objects");
+
+  std::unique_ptr<World> world = makeWorld(data.workload, objectCount);
+  if (!world) {
+    CORRADE_SKIP("Test assets or Bullet not available");
+  }
+
+  std::vector<double> times;
+  times.reserve(StepCount);
+  for (int i = 0; i != StepCount; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    step(*world);
+    times.push_back(std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+  std::sort(times.begin(), times.end());
+  const auto percentile = [&times](double fraction) {
+    return times[std::min(times.size() - 1,
+                          std::size_t(fraction * times.size()))];
+  };
+  Cr::Utility::Debug{} << "   " << data.name << "with" << objectCount
+                       << "objects, step latency in us: p50"
+                       << percentile(0.5) << "p90" << percentile(0.9) << "p99"
+                       << percentile(0.99) << "max" << times.back()
+                       << "| p50 per object" << percentile(0.5) / objectCount;
+  CORRADE_COMPARE(world->physicsManager->getNumRigidObjects(), objectCount);
+}
+
+void PhysicsBenchmark::benchmarkStep() {
+  auto&& data = WorkloadData[testCaseInstanceId() / ObjectCountCount];
+  const int objectCount = ObjectCounts[testCaseInstanceId() % ObjectCountCount];
+  setTestCaseDescription(std::string{data.name} + ", " +
+                         std::to_string(objectCount) + " objects");
+
+  std::unique_ptr<World> world = makeWorld(data.workload, objectCount);
+  if (!world) {
+    CORRADE_SKIP("Test assets or Bullet not available");
+  }
+
+  const double worldTime = world->physicsManager->getWorldTime();
+  CORRADE_BENCHMARK(10) { step(*world); }
+  CORRADE_VERIFY(world->physicsManager->getWorldTime() > worldTime);
+}
+
+void PhysicsBenchmark::benchmarkContactTests() {
+  const int objectCount = ObjectCounts[testCaseInstanceId()];
+  setTestCaseDescription(std::to_string(objectCount) + " objects");
+
+  std::unique_ptr<World> world = makeWorld(Workload::Convex, objectCount);
+  if (!world) {
+    CORRADE_SKIP("Test assets or Bullet not available");
+  }
+  // let the objects come to rest on the ground and each other
+  for (int i = 0; i != StepCount; ++i) {
+    world->physicsManager->stepPhysics();
+  }
+
+  // a single collision detection pass for all objects
+  Cr::Containers::Array<bool> results{Cr::Containers::ValueInit,
+                                      std::size_t(objectCount)};
+  CORRADE_BENCHMARK(10) {
+    world->physicsManager->contactTests(nullptr, results);
+  }
+  CORRADE_VERIFY(std::count(results.begin(), results.end(), true) > 0);
+}
+
+void PhysicsBenchmark::benchmarkChurn() {
+  auto&& data = ChurnData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  std::unique_ptr<World> world = makeWorld(Workload::Convex, 100);
+  if (!world) {
+    CORRADE_SKIP("Test assets or Bullet not available");
+  }
+  world->physicsManager->setObjectPooling(data.pooling);
+
+  // replace the oldest object with a new one, stepping in between
+  int objectIndex = 100;
+  CORRADE_BENCHMARK(10) {
+    world->physicsManager->removeObject(world->dynamicIds.front());
+    world->dynamicIds.erase(world->dynamicIds.begin());
+    world->dynamicIds.push_back(
+        addObject(*world, Workload::Convex, objectIndex++ % 100));
+    world->physicsManager->stepPhysics();
+  }
+  CORRADE_COMPARE(world->physicsManager->getNumRigidObjects(), 100);
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(PhysicsBenchmark)
@@ -6,10 +6,15 @@
 #include "SemanticScene.h"
 
 #include <algorithm>
-#include <fstream>
+#include <cstdlib>
+#include <cstring>
 #include <map>
-#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
 
 #include "esp/io/io.h"
 
@@ -82,6 +87,75 @@ std::string Mp3dRegionCategory::name(const std::string& mapping) const {
   return kRegionCategoryMap.at(labelCode_);
 }
 
+namespace {
+// Elements of one kind in a single allocation, handed out as shared_ptrs
+// that all share ownership of the block
+template <typename T>
+class Arena {
+ public:
+  explicit Arena(size_t capacity)
+      : block_{std::make_shared<std::vector<T>>()} {
+    block_->reserve(capacity);
+  }
+
+  template <typename... Args>
+  std::shared_ptr<T> create(Args&&... args) {
+    // growing would move the elements already handed out
+    CHECK(block_->size() < block_->capacity());
+    block_->emplace_back(std::forward<Args>(args)...);
+    return std::shared_ptr<T>(block_, &block_->back());
+  }
+
+ private:
+  std::shared_ptr<std::vector<T>> block_;
+};
+
+// whitespace separated token of a line, pointing into the mapped file
+struct Token {
+  const char* data;
+  size_t size;
+
+  std::string str() const { return {data, size}; }
+};
+
+void tokenize(const char* begin, const char* end, std::vector<Token>& tokens) {
+  tokens.clear();
+  while (begin != end) {
+    while (begin != end && (*begin == ' ' || *begin == '\t')) {
+      ++begin;
+    }
+    const char* tokenEnd = begin;
+    while (tokenEnd != end && *tokenEnd != ' ' && *tokenEnd != '\t') {
+      ++tokenEnd;
+    }
+    if (tokenEnd != begin) {
+      tokens.push_back({begin, size_t(tokenEnd - begin)});
+    }
+    begin = tokenEnd;
+  }
+}
+
+// the mapped file isn't null-terminated, so numbers are parsed from a copy
+template <typename T, typename Parse>
+T parseNumber(const Token& token, Parse parse) {
+  char buffer[64];
+  const size_t size = std::min(token.size, sizeof(buffer) - 1);
+  std::memcpy(buffer, token.data, size);
+  buffer[size] = '\0';
+  return T(parse(buffer));
+}
+
+int toInt(const Token& token) {
+  return parseNumber<int>(
+      token, [](const char* s) { return std::strtol(s, nullptr, 10); });
+}
+
+float toFloat(const Token& token) {
+  return parseNumber<float>(
+      token, [](const char* s) { return std::strtof(s, nullptr); });
+}
+}  // namespace
+
 bool SemanticScene::loadMp3dHouse(
     const std::string& houseFilename,
     SemanticScene& scene,
@@ -94,22 +168,20 @@ bool SemanticScene::loadMp3dHouse(
 
   const bool hasWorldRotation = !rotation.isApprox(quatf::Identity());
 
-  auto getVec3f = [&](const std::vector<std::string>& tokens, int offset) {
-    const float x = std::stof(tokens[offset]);
-    const float y = std::stof(tokens[offset + 1]);
-    const float z = std::stof(tokens[offset + 2]);
-    vec3f p = vec3f(x, y, z);
+  auto getVec3f = [&](const std::vector<Token>& tokens, int offset) {
+    vec3f p = vec3f(toFloat(tokens[offset]), toFloat(tokens[offset + 1]),
+                    toFloat(tokens[offset + 2]));
     if (hasWorldRotation) {
       p = rotation * p;
     }
     return p;
   };
 
-  auto getBBox = [&](const std::vector<std::string>& tokens, int offset) {
+  auto getBBox = [&](const std::vector<Token>& tokens, int offset) {
     return box3f(getVec3f(tokens, offset), getVec3f(tokens, offset + 3));
   };
 
-  auto getOBB = [&](const std::vector<std::string>& tokens, int offset) {
+  auto getOBB = [&](const std::vector<Token>& tokens, int offset) {
     const vec3f center = getVec3f(tokens, offset);
     mat3f rotation;
     rotation.col(0) << getVec3f(tokens, offset + 3);
@@ -119,12 +191,59 @@ bool SemanticScene::loadMp3dHouse(
     return geo::OBB(center, 2 * radius, quatf(rotation));
   };
 
-  // open stream and determine house format version
-  std::ifstream ifs = std::ifstream(houseFilename);
-  std::string header;
-  std::getline(ifs, header);
-  if (header != "ASCII 1.1") {
-    LOG(ERROR) << "Unsupported House format header " << header;
+  const auto data = Corrade::Utility::Directory::mapRead(houseFilename);
+  const char* const dataEnd = data.data() + data.size();
+
+  // One pass over the file splits it into lines and keeps those of the
+  // records we read, most of the file are vertices, surfaces and images that
+  // are skipped without tokenizing. Knowing the counts up front lets all
+  // records of a kind go into one arena.
+  using Line = std::pair<const char*, const char*>;
+  std::vector<Line> houses, levels, regions, categories, objects, segments;
+  Line header{dataEnd, dataEnd};
+  for (const char* begin = data.data(); begin < dataEnd;) {
+    const char* end = static_cast<const char*>(
+        std::memchr(begin, '\n', dataEnd - begin));
+    if (end == nullptr) {
+      end = dataEnd;
+    }
+    const char* lineEnd = end;
+    if (lineEnd != begin && lineEnd[-1] == '\r') {
+      --lineEnd;
+    }
+    if (header.first == dataEnd) {
+      header = {begin, lineEnd};
+    } else if (lineEnd != begin) {
+      switch (*begin) {
+        case 'H':  // house
+          houses.emplace_back(begin, lineEnd);
+          break;
+        case 'L':  // level
+          levels.emplace_back(begin, lineEnd);
+          break;
+        case 'R':  // region
+          regions.emplace_back(begin, lineEnd);
+          break;
+        case 'C':  // category
+          categories.emplace_back(begin, lineEnd);
+          break;
+        case 'O':  // object
+          objects.emplace_back(begin, lineEnd);
+          break;
+        case 'E':  // segment
+          segments.emplace_back(begin, lineEnd);
+          break;
+        default:  // P portal or panorama, S surface, V vertex, I image
+          break;
+      }
+    }
+    begin = end + 1;
+  }
+
+  // determine house format version
+  if (std::string(header.first, header.second) != "ASCII 1.1") {
+    LOG(ERROR) << "Unsupported House format header "
+               << std::string(header.first, header.second);
     return false;
   }
 
@@ -133,132 +252,137 @@ bool SemanticScene::loadMp3dHouse(
   scene.regions_.clear();
   scene.objects_.clear();
 
-  std::string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
-      continue;
+  std::vector<Token> tokens;
+  // tokenizes a line, false if it has fewer tokens than the record needs
+  auto tokenizeRecord = [&](const Line& line, size_t minTokens) {
+    tokenize(line.first, line.second, tokens);
+    if (tokens.size() < minTokens) {
+      LOG(ERROR) << "Malformed House record "
+                 << std::string(line.first, line.second);
+      return false;
     }
-    const std::vector<std::string> tokens = io::tokenize(line, " ", 0, true);
-    switch (line[0]) {
-      case 'H': {  // house
-        // H name label #images #panoramas #vertices #surfaces #segments
-        //   #objects #categories #regions #portals #levels  0 0 0 0 0
-        //   xlo ylo zlo xhi yhi zhi  0 0 0 0 0
-        scene.name_ = tokens[1];
-        scene.label_ = tokens[2];
-        scene.elementCounts_["images"] = std::stoi(tokens[3]);
-        scene.elementCounts_["panoramas"] = std::stoi(tokens[4]);
-        scene.elementCounts_["vertices"] = std::stoi(tokens[5]);
-        scene.elementCounts_["surfaces"] = std::stoi(tokens[6]);
-        scene.elementCounts_["segments"] = std::stoi(tokens[7]);
-        scene.elementCounts_["objects"] = std::stoi(tokens[8]);
-        scene.elementCounts_["categories"] = std::stoi(tokens[9]);
-        scene.elementCounts_["regions"] = std::stoi(tokens[10]);
-        scene.elementCounts_["portals"] = std::stoi(tokens[11]);
-        scene.elementCounts_["levels"] = std::stoi(tokens[12]);
-        scene.bbox_ = getBBox(tokens, 18);
-        break;
-      }
-      case 'L': {  // level
-        // L level_index #regions label  px py pz  xlo ylo zlo xhi yhi zhi  0 0
-        //   0 0 0
-        scene.levels_.emplace_back(SemanticLevel::create());
-        auto& level = scene.levels_.back();
-        level->index_ = std::stoi(tokens[1]);
-        // NOTE tokens[2] is number of regions in level which we don't need
-        level->labelCode_ = tokens[3];
-        level->position_ = getVec3f(tokens, 4);
-        level->bbox_ = getBBox(tokens, 7);
-        break;
-      }
-      case 'R': {  // region
-        // R region_index level_index 0 0 label  px py pz  xlo ylo zlo xhi yhi
-        //   zhi height  0 0 0 0
-        scene.regions_.emplace_back(SemanticRegion::create());
-        auto& region = scene.regions_.back();
-        region->index_ = std::stoi(tokens[1]);
-        region->parentIndex_ = std::stoi(tokens[2]);
-        region->category_ = std::make_shared<Mp3dRegionCategory>(tokens[5][0]);
-        region->position_ = getVec3f(tokens, 6);
-        region->bbox_ = getBBox(tokens, 9);
-        if (region->parentIndex_ >= 0) {
-          region->level_ = scene.levels_[region->parentIndex_];
-          region->level_->regions_.push_back(region);
-        }
-        break;
-      }
-      case 'P': {  // portal or panorama
-        // P portal_index region0_index region1_index label  xlo ylo zlo xhi
-        //   yhi zhi  0 0 0 0
-        // P name  panorama_index region_index 0  px py pz  0 0 0 0 0
-        break;
-      }
-      case 'S': {  // surface
-        // S surface_index region_index 0 label px py pz  nx ny nz  xlo ylo
-        // zlo
-        //   xhi yhi zhi  0 0 0 0 0
-        break;
-      }
-      case 'V': {  // vertex
-        // V vertex_index surface_index label  px py pz  nx ny nz  0 0 0
-        break;
-      }
-      case 'I': {  // image
-        // I image_index panorama_index  name camera_index yaw_index e00 e01
-        //   e02 e03 e10 e11 e12 e13 e20 e21 e22 e23 e30 e31 e32 e33  i00 i01
-        //   i02  i10 i11 i12 i20 i21 i22  width height  px py pz  0 0 0 0 0
-        break;
-      }
-      case 'C': {  // category
-        // C category_index category_mapping_index category_mapping_name
-        //   mpcat40_index mpcat40_name 0 0 0 0 0
-        scene.categories_.emplace_back(std::make_shared<Mp3dObjectCategory>());
-        auto& category =
-            static_cast<Mp3dObjectCategory&>(*scene.categories_.back());
-        category.index_ = std::stoi(tokens[1]);
-        category.categoryMappingIndex_ = std::stoi(tokens[2]);
-        std::string catName = tokens[3];
-        std::replace(catName.begin(), catName.end(), '#', ' ');
-        category.categoryMappingName_ = catName;
-        category.mpcat40Index_ = std::stoi(tokens[4]);
-        category.mpcat40Name_ = tokens[5];
-        break;
-      }
-      case 'O': {  // object
-        // O object_index region_index category_index px py pz  a0x a0y a0z
-        //   a1x a1y a1z  r0 r1 r2 0 0 0 0 0 0 0 0
-        scene.objects_.emplace_back(SemanticObject::create());
-        auto& object = scene.objects_.back();
-        object->index_ = std::stoi(tokens[1]);
-        object->parentIndex_ = std::stoi(tokens[2]);
-        int categoryIndex = std::stoi(tokens[3]);
-        if (categoryIndex < 0) {  // no category
-          object->category_ = std::make_shared<Mp3dObjectCategory>();
-        } else {
-          object->category_ = scene.categories_[categoryIndex];
-        }
-        object->obb_ = getOBB(tokens, 4);
-        if (object->parentIndex_ >= 0) {
-          object->region_ = scene.regions_[object->parentIndex_];
-          object->region_->objects_.push_back(object);
-        }
-        break;
-      }
-      case 'E': {  // segment
-        // E segment_index object_index id area px py pz xlo ylo zlo xhi yhi
-        // zhi 0 0 0 0 0
-        const int objectIndex = std::stoi(tokens[2]);
-        const int segmentId = std::stoi(tokens[3]);
-        // NOTE: segmentId = regionIndex * 1000000 + segmentId
-        scene.segmentToObjectIndex_[segmentId] = objectIndex;
-        break;
-      }
-      default: {
-        break;
-      }
+    return true;
+  };
+
+  for (const Line& line : houses) {
+    // H name label #images #panoramas #vertices #surfaces #segments
+    //   #objects #categories #regions #portals #levels  0 0 0 0 0
+    //   xlo ylo zlo xhi yhi zhi  0 0 0 0 0
+    if (!tokenizeRecord(line, 24)) {
+      return false;
+    }
+    scene.name_ = tokens[1].str();
+    scene.label_ = tokens[2].str();
+    scene.elementCounts_["images"] = toInt(tokens[3]);
+    scene.elementCounts_["panoramas"] = toInt(tokens[4]);
+    scene.elementCounts_["vertices"] = toInt(tokens[5]);
+    scene.elementCounts_["surfaces"] = toInt(tokens[6]);
+    scene.elementCounts_["segments"] = toInt(tokens[7]);
+    scene.elementCounts_["objects"] = toInt(tokens[8]);
+    scene.elementCounts_["categories"] = toInt(tokens[9]);
+    scene.elementCounts_["regions"] = toInt(tokens[10]);
+    scene.elementCounts_["portals"] = toInt(tokens[11]);
+    scene.elementCounts_["levels"] = toInt(tokens[12]);
+    scene.bbox_ = getBBox(tokens, 18);
+  }
+
+  Arena<SemanticLevel> levelArena{levels.size()};
+  scene.levels_.reserve(levels.size());
+  for (const Line& line : levels) {
+    // L level_index #regions label  px py pz  xlo ylo zlo xhi yhi zhi  0 0
+    //   0 0 0
+    if (!tokenizeRecord(line, 13)) {
+      return false;
+    }
+    scene.levels_.emplace_back(levelArena.create());
+    auto& level = scene.levels_.back();
+    level->index_ = toInt(tokens[1]);
+    // NOTE tokens[2] is number of regions in level which we don't need
+    level->labelCode_ = tokens[3].str();
+    level->position_ = getVec3f(tokens, 4);
+    level->bbox_ = getBBox(tokens, 7);
+  }
+
+  Arena<SemanticRegion> regionArena{regions.size()};
+  Arena<Mp3dRegionCategory> regionCategoryArena{regions.size()};
+  scene.regions_.reserve(regions.size());
+  for (const Line& line : regions) {
+    // R region_index level_index 0 0 label  px py pz  xlo ylo zlo xhi yhi
+    //   zhi height  0 0 0 0
+    if (!tokenizeRecord(line, 15)) {
+      return false;
+    }
+    scene.regions_.emplace_back(regionArena.create());
+    auto& region = scene.regions_.back();
+    region->index_ = toInt(tokens[1]);
+    region->parentIndex_ = toInt(tokens[2]);
+    region->category_ = regionCategoryArena.create(tokens[5].data[0]);
+    region->position_ = getVec3f(tokens, 6);
+    region->bbox_ = getBBox(tokens, 9);
+    if (region->parentIndex_ >= 0) {
+      region->level_ = scene.levels_[region->parentIndex_];
+      region->level_->regions_.push_back(region);
+    }
+  }
+
+  // one extra category for each object without one
+  Arena<Mp3dObjectCategory> categoryArena{categories.size() + objects.size()};
+  scene.categories_.reserve(categories.size());
+  for (const Line& line : categories) {
+    // C category_index category_mapping_index category_mapping_name
+    //   mpcat40_index mpcat40_name 0 0 0 0 0
+    if (!tokenizeRecord(line, 6)) {
+      return false;
+    }
+    auto category = categoryArena.create();
+    category->index_ = toInt(tokens[1]);
+    category->categoryMappingIndex_ = toInt(tokens[2]);
+    std::string catName = tokens[3].str();
+    std::replace(catName.begin(), catName.end(), '#', ' ');
+    category->categoryMappingName_ = catName;
+    category->mpcat40Index_ = toInt(tokens[4]);
+    category->mpcat40Name_ = tokens[5].str();
+    scene.categories_.emplace_back(std::move(category));
+  }
+
+  Arena<SemanticObject> objectArena{objects.size()};
+  scene.objects_.reserve(objects.size());
+  for (const Line& line : objects) {
+    // O object_index region_index category_index px py pz  a0x a0y a0z
+    //   a1x a1y a1z  r0 r1 r2 0 0 0 0 0 0 0 0
+    if (!tokenizeRecord(line, 16)) {
+      return false;
+    }
+    scene.objects_.emplace_back(objectArena.create());
+    auto& object = scene.objects_.back();
+    object->index_ = toInt(tokens[1]);
+    object->parentIndex_ = toInt(tokens[2]);
+    int categoryIndex = toInt(tokens[3]);
+    if (categoryIndex < 0) {  // no category
+      object->category_ = categoryArena.create();
+    } else {
+      object->category_ = scene.categories_[categoryIndex];
+    }
+    object->obb_ = getOBB(tokens, 4);
+    if (object->parentIndex_ >= 0) {
+      object->region_ = scene.regions_[object->parentIndex_];
+      object->region_->objects_.push_back(object);
+    }
+  }
+
+  for (const Line& line : segments) {
+    // E segment_index object_index id area px py pz xlo ylo zlo xhi yhi
+    // zhi 0 0 0 0 0
+    if (!tokenizeRecord(line, 4)) {
+      return false;
     }
+    const int objectIndex = toInt(tokens[2]);
+    const int segmentId = toInt(tokens[3]);
+    // NOTE: segmentId = regionIndex * 1000000 + segmentId
+    scene.segmentToObjectIndex_[segmentId] = objectIndex;
   }
 
+  scene.buildIndices();
   return true;
 }
 
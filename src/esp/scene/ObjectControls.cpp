@@ -4,16 +4,44 @@
 
 #include "ObjectControls.h"
 
-#include <Magnum/EigenIntegration/Integration.h>
+#include <Corrade/Containers/ArrayViewStl.h>
 
 #include "SceneNode.h"
+#include "esp/core/MathInterop.h"
 #include "esp/core/esp.h"
 
-using Magnum::EigenIntegration::cast;
-
 namespace esp {
 namespace scene {
 
+void FilteredMoveBatch::add(SceneNode& object,
+                            const vec3f& start,
+                            const vec3f& end) {
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    if (objects_[i] == &object) {
+      ends_[i] = end;
+      return;
+    }
+  }
+  objects_.push_back(&object);
+  starts_.push_back(start);
+  ends_.push_back(end);
+}
+
+void FilteredMoveBatch::apply(const FilterFunc& filter) {
+  if (objects_.empty()) {
+    return;
+  }
+  results_.resize(objects_.size());
+  filter(starts_, ends_, results_);
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    objects_[i]->translate(core::asMagnum(results_[i]) -
+                           core::asMagnum(ends_[i]));
+  }
+  objects_.clear();
+  starts_.clear();
+  ends_.clear();
+}
+
 SceneNode& moveRight(SceneNode& object, float distance) {
   // TODO: this assumes no scale is applied
   object.translateLocal(object.transformation().right() * distance);
@@ -83,23 +111,19 @@ ObjectControls& ObjectControls::setMoveFilterFunction(
   return *this;
 }
 
+const ObjectControls::MoveFunc* ObjectControls::getMoveFunc(
+    const std::string& actName) const {
+  auto found = moveFuncMap_.find(actName);
+  return found == moveFuncMap_.end() ? nullptr : &found->second;
+}
+
 ObjectControls& ObjectControls::action(SceneNode& object,
                                        const std::string& actName,
                                        float distance,
                                        bool applyFilter /* = true */) {
-  if (moveFuncMap_.count(actName)) {
-    if (applyFilter) {
-      // TODO: use magnum math for the filter func as well?
-      const auto startPosition =
-          cast<vec3f>(object.absoluteTransformation().translation());
-      moveFuncMap_[actName](object, distance);
-      const auto endPos =
-          cast<vec3f>(object.absoluteTransformation().translation());
-      const vec3f filteredEndPosition = moveFilterFunc_(startPosition, endPos);
-      object.translate(Magnum::Vector3(vec3f(filteredEndPosition - endPos)));
-    } else {
-      moveFuncMap_[actName](object, distance);
-    }
+  const MoveFunc* moveFunc = getMoveFunc(actName);
+  if (moveFunc != nullptr) {
+    action(object, *moveFunc, distance, applyFilter);
   } else {
     LOG(ERROR) << "Tried to perform unknown action with name " << actName;
   }
@@ -107,5 +131,31 @@ ObjectControls& ObjectControls::action(SceneNode& object,
   return *this;
 }
 
+ObjectControls& ObjectControls::action(SceneNode& object,
+                                       const MoveFunc& moveFunc,
+                                       float distance,
+                                       bool applyFilter /* = true */) {
+  if (applyFilter) {
+    // TODO: use magnum math for the filter func as well?
+    // copied, the view would follow the object
+    const vec3f startPosition =
+        core::asEigen(object.absoluteTransformation().translation());
+    moveFunc(object, distance);
+    const vec3f endPos =
+        core::asEigen(object.absoluteTransformation().translation());
+    if (filterBatch_ != nullptr) {
+      filterBatch_->add(object, startPosition, endPos);
+      return *this;
+    }
+    const vec3f filteredEndPosition = moveFilterFunc_(startPosition, endPos);
+    object.translate(core::asMagnum(filteredEndPosition) -
+                     core::asMagnum(endPos));
+  } else {
+    moveFunc(object, distance);
+  }
+
+  return *this;
+}
+
 }  // namespace scene
 }  // namespace esp
@@ -7,6 +7,9 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
 
 #include "esp/core/esp.h"
 
@@ -16,6 +19,51 @@ namespace scene {
 // forward declaration
 class SceneNode;
 
+/**
+ * @brief Filtered moves of many objects, collected to be filtered at once
+ *
+ * Set on the @ref ObjectControls of several agents with
+ * @ref ObjectControls::setFilterBatch(), the moves of all their actions are
+ * applied unfiltered and recorded here, then @ref apply() filters all of
+ * them in one call, such as @ref nav::PathFinder::trySteps(), and corrects
+ * the objects. The storage is reused, so steady-state batches don't
+ * allocate.
+ */
+class FilteredMoveBatch {
+ public:
+  typedef std::function<void(Corrade::Containers::ArrayView<const vec3f>,
+                             Corrade::Containers::ArrayView<const vec3f>,
+                             Corrade::Containers::ArrayView<vec3f>)>
+      FilterFunc;
+
+  /**
+   * @brief Record a move of @p object from @p start to @p end
+   *
+   * A second move of the same object in one batch extends the first, the
+   * filter then sees both as one move.
+   */
+  void add(SceneNode& object, const vec3f& start, const vec3f& end);
+
+  /**
+   * @brief Filter all recorded moves and clear the batch
+   * @param filter  Gets the start and end positions and fills the filtered
+   *      end positions
+   *
+   * The objects are expected to not have moved since their move was
+   * recorded.
+   */
+  void apply(const FilterFunc& filter);
+
+  /** @brief Number of recorded moves */
+  size_t size() const { return objects_.size(); }
+
+ private:
+  std::vector<SceneNode*> objects_;
+  std::vector<vec3f> starts_;
+  std::vector<vec3f> ends_;
+  std::vector<vec3f> results_;
+};
+
 class ObjectControls {
  public:
   ObjectControls();
@@ -35,6 +83,34 @@ class ObjectControls {
     return action(object, actName, distance, applyFilter);
   }
 
+  /**
+   * @brief Function of the action named @p actName, nullptr if there's none
+   *
+   * The pointer stays valid for the lifetime of the controls, so callers can
+   * resolve actions once and run them repeatedly with the overload below.
+   */
+  const MoveFunc* getMoveFunc(const std::string& actName) const;
+
+  /**
+   * @brief Run a resolved action on @p object, without looking its name up
+   * @param moveFunc  Function from @ref getMoveFunc()
+   */
+  ObjectControls& action(SceneNode& object,
+                         const MoveFunc& moveFunc,
+                         float distance,
+                         bool applyFilter = true);
+
+  /**
+   * @brief Record filtered moves in @p batch instead of filtering each one
+   *
+   * Until reset with @cpp nullptr @ce, actions with the filter applied move
+   * unfiltered and leave the filtering to @ref FilteredMoveBatch::apply().
+   */
+  ObjectControls& setFilterBatch(FilteredMoveBatch* batch) {
+    filterBatch_ = batch;
+    return *this;
+  }
+
   inline const std::map<std::string, MoveFunc>& getMoveFuncMap() const {
     return moveFuncMap_;
   }
@@ -44,6 +120,7 @@ class ObjectControls {
     return end;
   };
   std::map<std::string, MoveFunc> moveFuncMap_;
+  FilteredMoveBatch* filterBatch_ = nullptr;
 
   ESP_SMART_POINTERS(ObjectControls)
 };
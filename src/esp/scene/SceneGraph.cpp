@@ -35,6 +35,40 @@ bool SceneGraph::isRootNode(SceneNode& node) {
   return (parent->parent() == nullptr ? true : false);
 }
 
+const std::vector<SceneNode*>& SceneGraph::preOrderNodes() {
+  updateFlattened();
+  return preOrderNodes_;
+}
+
+const std::vector<int>& SceneGraph::preOrderParents() {
+  updateFlattened();
+  return preOrderParents_;
+}
+
+void SceneGraph::updateFlattened() {
+  const uint64_t generation = SceneNode::structureGeneration();
+  if (flattenedGeneration_ == generation) {
+    return;
+  }
+
+  preOrderNodes_.clear();
+  preOrderParents_.clear();
+  // children are pushed last to first so they're popped in order
+  std::vector<std::pair<SceneNode*, int>> stack{{&rootNode_, -1}};
+  while (!stack.empty()) {
+    const std::pair<SceneNode*, int> top = stack.back();
+    stack.pop_back();
+    const int index = preOrderNodes_.size();
+    preOrderNodes_.push_back(top.first);
+    preOrderParents_.push_back(top.second);
+    for (MagnumObject* child = top.first->children().last(); child != nullptr;
+         child = child->previousSibling()) {
+      stack.emplace_back(static_cast<SceneNode*>(child), index);
+    }
+  }
+  flattenedGeneration_ = generation;
+}
+
 gfx::DrawableGroup* SceneGraph::getDrawableGroup(const std::string& id) {
   auto it = drawableGroups_.find(id);
   return it == drawableGroups_.end() ? nullptr : &it->second;
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <memory>
+#include <typeindex>
 #include <unordered_map>
+#include <vector>
 
 #include "esp/core/esp.h"
 #include "esp/gfx/magnum.h"
@@ -46,6 +49,57 @@ class SceneGraph {
    */
   static bool isRootNode(SceneNode& node);
 
+  // Flattened traversal
+
+  /**
+   * @brief All nodes under the root node in pre-order, root node first
+   *
+   * Children are visited in the order they were added. Rebuilt lazily the
+   * first time it's asked for after a node was created or destroyed or a
+   * feature was added, see @ref SceneNode::structureGeneration(). The
+   * pointers are valid until the next hierarchy change.
+   */
+  const std::vector<SceneNode*>& preOrderNodes();
+
+  /**
+   * @brief Index in @ref preOrderNodes() of the parent of each node, -1 for
+   * the root node
+   *
+   * A parent always comes before its children, so iterating backwards
+   * visits each child before its parent.
+   */
+  const std::vector<int>& preOrderParents();
+
+  /**
+   * @brief Features of the given type on all nodes, in pre-order of their
+   * nodes
+   *
+   * Collected with one @cpp dynamic_cast @ce per feature when the list is
+   * first asked for after a hierarchy change, instead of on every traversal.
+   */
+  template <class Feature>
+  const std::vector<Feature*>& features() {
+    std::unique_ptr<FeatureListBase>& list =
+        featureLists_[std::type_index{typeid(Feature)}];
+    if (!list) {
+      list = std::make_unique<FeatureList<Feature>>();
+    }
+    auto& typed = static_cast<FeatureList<Feature>&>(*list);
+    const std::vector<SceneNode*>& nodes = preOrderNodes();
+    if (typed.generation != flattenedGeneration_) {
+      typed.features.clear();
+      for (SceneNode* node : nodes) {
+        for (auto& abstractFeature : node->features()) {
+          if (auto* feature = dynamic_cast<Feature*>(&abstractFeature)) {
+            typed.features.push_back(feature);
+          }
+        }
+      }
+      typed.generation = flattenedGeneration_;
+    }
+    return typed.features;
+  }
+
   // Drawable group management
   // TODO: move this to separate class
 
@@ -89,7 +143,7 @@ class SceneGraph {
                  << " already exists!";
       return nullptr;
     }
-    LOG(INFO) << "Created DrawableGroup: " << inserted.first->first;
+    VLOG(1) << "Created DrawableGroup: " << inserted.first->first;
     return &inserted.first->second;
   }
 
@@ -134,6 +188,27 @@ class SceneGraph {
   // drawable groups for this scene graph
   // This is a mapping from (groupID -> group of drawables).
   DrawableGroups drawableGroups_;
+
+  // ==== Flattened traversal ====
+  struct FeatureListBase {
+    virtual ~FeatureListBase() = default;
+    // flattenedGeneration_ the list was collected at, 0 before that
+    uint64_t generation = 0;
+  };
+  template <class Feature>
+  struct FeatureList : FeatureListBase {
+    std::vector<Feature*> features;
+  };
+
+  // rebuilds preOrderNodes_ and preOrderParents_ if the hierarchy changed
+  void updateFlattened();
+
+  // SceneNode::structureGeneration() the arrays were built at, 0 before that
+  uint64_t flattenedGeneration_ = 0;
+  std::vector<SceneNode*> preOrderNodes_;
+  std::vector<int> preOrderParents_;
+  std::unordered_map<std::type_index, std::unique_ptr<FeatureListBase>>
+      featureLists_;
 };
 }  // namespace scene
 }  // namespace esp
@@ -15,14 +15,21 @@ int SceneManager::initSceneGraph() {
 }
 
 SceneGraph& SceneManager::getSceneGraph(int sceneID) {
-  ASSERT(sceneID >= 0 && sceneID < sceneGraphs_.size());
+  ASSERT(sceneID >= 0 && sceneID < sceneGraphs_.size() &&
+         sceneGraphs_[sceneID] != nullptr);
   return (*(sceneGraphs_[sceneID].get()));
 }
 
 const SceneGraph& SceneManager::getSceneGraph(int sceneID) const {
-  ASSERT(sceneID >= 0 && sceneID < sceneGraphs_.size());
+  ASSERT(sceneID >= 0 && sceneID < sceneGraphs_.size() &&
+         sceneGraphs_[sceneID] != nullptr);
   return (*(sceneGraphs_[sceneID].get()));
 }
 
+void SceneManager::deleteSceneGraph(int sceneID) {
+  ASSERT(sceneID >= 0 && sceneID < sceneGraphs_.size());
+  sceneGraphs_[sceneID] = nullptr;
+}
+
 }  // namespace scene
 }  // namespace esp
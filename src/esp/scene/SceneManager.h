@@ -30,6 +30,10 @@ class SceneManager {
   SceneGraph& getSceneGraph(int sceneID);
   const SceneGraph& getSceneGraph(int sceneID) const;
 
+  // destroys the scene graph with all its nodes and drawables. The ID is not
+  // reused, getSceneGraph() must not be called with it anymore
+  void deleteSceneGraph(int sceneID);
+
  protected:
   // Each item within is a base node, parent of all in that scene, for easy
   // manipulation (e.g., rotate the entire scene)
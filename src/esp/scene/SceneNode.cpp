@@ -3,6 +3,11 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "SceneNode.h"
+
+#include <atomic>
+
+#include <Magnum/SceneGraph/AbstractFeature.h>
+
 #include "esp/geo/geo.h"
 
 namespace Mn = Magnum;
@@ -10,13 +15,74 @@ namespace Mn = Magnum;
 namespace esp {
 namespace scene {
 
+namespace {
+// bumped whenever a cumulative bounding box may have changed, starts above
+// the initial generation of the nodes
+std::atomic<uint64_t> cumulativeBBGeneration{1};
+// bumped whenever the set of nodes or their features may have changed
+std::atomic<uint64_t> structureGeneration{1};
+}  // namespace
+
+// Keeps SceneNode::absoluteTransformation_ up to date and invalidates the
+// cumulative bounding boxes when the node moves, the same way gfx::Drawable
+// caches its transformation
+class SceneNodeTransformationCache : public Mn::SceneGraph::AbstractFeature3D {
+ public:
+  explicit SceneNodeTransformationCache(SceneNode& node)
+      : Mn::SceneGraph::AbstractFeature3D{node}, node_(node) {
+    setCachedTransformations(Mn::SceneGraph::CachedTransformation::Absolute);
+  }
+
+ protected:
+  void markDirty() override { SceneNode::invalidateCumulativeBBs(); }
+
+  void clean(const Mn::Matrix4& absoluteTransformationMatrix) override {
+    node_.absoluteTransformation_ = absoluteTransformationMatrix;
+  }
+
+  SceneNode& node_;
+};
+
 SceneNode::SceneNode(SceneNode& parent) {
   setParent(&parent);
   setId(parent.getId());
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
+  new SceneNodeTransformationCache{*this};
+  invalidateCumulativeBBs();
+  invalidateStructure();
 }
 
 SceneNode::SceneNode(MagnumScene& parentNode) {
   setParent(&parentNode);
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
+  new SceneNodeTransformationCache{*this};
+  invalidateCumulativeBBs();
+  invalidateStructure();
+}
+
+SceneNode::~SceneNode() {
+  invalidateCumulativeBBs();
+  invalidateStructure();
+}
+
+void SceneNode::invalidateCumulativeBBs() {
+  ++cumulativeBBGeneration;
+}
+
+uint64_t SceneNode::structureGeneration() {
+  return structureGeneration;
+}
+
+void SceneNode::invalidateStructure() {
+  ++structureGeneration;
+}
+
+const Mn::Matrix4& SceneNode::absoluteTransformation() const {
+  // cleaning is logically const, it only fills caches
+  if (isDirty()) {
+    const_cast<SceneNode*>(this)->setClean();
+  }
+  return absoluteTransformation_;
 }
 
 SceneNode& SceneNode::createChild() {
@@ -28,6 +94,11 @@ SceneNode& SceneNode::createChild() {
 
 //! @brief recursively compute the cumulative bounding box of this node's tree.
 const Mn::Range3D& SceneNode::computeCumulativeBB() {
+  const uint64_t generation = cumulativeBBGeneration;
+  if (cumulativeBBGeneration_ == generation) {
+    return cumulativeBB_;
+  }
+
   // first copy from your precomputed mesh bb
   cumulativeBB_ = Mn::Range3D(meshBB_);
   auto* child = children().first();
@@ -44,6 +115,7 @@ const Mn::Range3D& SceneNode::computeCumulativeBB() {
     }
     child = child->nextSibling();
   }
+  cumulativeBBGeneration_ = generation;
   return cumulativeBB_;
 }
 
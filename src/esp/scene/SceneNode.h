@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <stack>
 
 #include <Corrade/Containers/Containers.h>
@@ -45,9 +46,10 @@ class SceneNode : public MagnumObject {
 
   // Add a feature. Used to avoid naked `new` and makes intent clearer.
   template <class U, class... Args>
-  void addFeature(Args&&... args) {
+  U& addFeature(Args&&... args) {
+    invalidateStructure();
     // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
-    new U{*this, std::forward<Args>(args)...};
+    return *(new U{*this, std::forward<Args>(args)...});
   }
 
   //! Create a new child SceneNode and return it. NOTE: this SceneNode owns and
@@ -61,12 +63,22 @@ class SceneNode : public MagnumObject {
   //! Sets node id
   virtual void setId(int id) { id_ = id; }
 
+  //! absolute transformation, cached until this node or one of its ancestors
+  //! moves, see Magnum::SceneGraph::Object::isDirty()
+  const Magnum::Matrix4& absoluteTransformation() const;
+
+  //! same as absoluteTransformation()
+  const Magnum::Matrix4& absoluteTransformationMatrix() const {
+    return absoluteTransformation();
+  }
+
   Magnum::Vector3 absoluteTranslation() const {
     return this->absoluteTransformation().translation();
   }
 
   //! recursively compute the cumulative bounding box of the full scene graph
-  //! tree for which this node is the root
+  //! tree for which this node is the root. Cached until any node is created,
+  //! destroyed or moved or a mesh bounding box changes.
   const Magnum::Range3D& computeCumulativeBB();
 
   //! return the local bounding box for meshes stored at this node
@@ -82,7 +94,18 @@ class SceneNode : public MagnumObject {
   const Magnum::Range3D& getCumulativeBB() const { return cumulativeBB_; };
 
   //! set local bounding box for meshes stored at this node
-  void setMeshBB(Magnum::Range3D meshBB) { meshBB_ = std::move(meshBB); };
+  void setMeshBB(Magnum::Range3D meshBB) {
+    meshBB_ = std::move(meshBB);
+    invalidateCumulativeBBs();
+  };
+
+  //! global counter bumped whenever a node is created or destroyed or a
+  //! feature is added through addFeature(), see SceneGraph::preOrderNodes()
+  static uint64_t structureGeneration();
+
+  //! bump structureGeneration(). Needed after reparenting a node or removing
+  //! a feature from a node that stays, which the counter can't observe
+  static void invalidateStructure();
 
   //! set the global bounding box for mesh stored in this node
   void setAbsoluteAABB(Magnum::Range3D aabb) { aabb_ = std::move(aabb); };
@@ -98,6 +121,21 @@ class SceneNode : public MagnumObject {
   // it can ONLY be called from SceneGraph class to initialize the scene graph
   friend class SceneGraph;
   SceneNode(MagnumScene& parentNode);
+  ~SceneNode();
+
+  // marks the cumulative bounding boxes of all nodes for recomputation. A
+  // single counter instead of flags up the parent chain, as Magnum only
+  // reports a node moving if it wasn't already dirty, and doesn't report a
+  // dirty node being reparented at all
+  static void invalidateCumulativeBBs();
+  friend class SceneNodeTransformationCache;
+
+  //! the absolute transformation as of the last time the node was cleaned
+  Magnum::Matrix4 absoluteTransformation_;
+
+  //! the value of the global counter cumulativeBB_ was computed at, 0 before
+  //! the first computation
+  uint64_t cumulativeBBGeneration_ = 0;
 
   // the type of the attached object (e.g., sensor, agent etc.)
   SceneNodeType type_ = SceneNodeType::EMPTY;
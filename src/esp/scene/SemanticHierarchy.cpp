@@ -0,0 +1,79 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SemanticHierarchy.h"
+
+#include <new>
+#include <type_traits>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace scene {
+
+namespace {
+// the storage is freed without running destructors
+static_assert(std::is_trivially_destructible<geo::OBB>::value &&
+                  std::is_trivially_destructible<box3f>::value,
+              "elements of the hierarchy must be trivially destructible");
+
+// Lays out arrays one after another in a single block, first measuring with
+// a null base, then constructing them in the allocated block
+class Layout {
+ public:
+  explicit Layout(char* base) : base_{base} {}
+
+  template <typename T>
+  Cr::Containers::ArrayView<T> array(size_t count) {
+    offset_ = (offset_ + alignof(T) - 1) / alignof(T) * alignof(T);
+    T* data = nullptr;
+    if (base_ != nullptr) {
+      data = reinterpret_cast<T*>(base_ + offset_);
+      for (size_t i = 0; i < count; ++i) {
+        new (data + i) T{};
+      }
+    }
+    offset_ += count * sizeof(T);
+    return {data, count};
+  }
+
+  size_t size() const { return offset_; }
+
+ private:
+  char* base_;
+  size_t offset_ = 0;
+};
+}  // namespace
+
+SemanticHierarchy::SemanticHierarchy(size_t levelCount,
+                                     size_t regionCount,
+                                     size_t objectCount,
+                                     size_t levelRegionCount,
+                                     size_t levelObjectCount,
+                                     size_t regionObjectCount) {
+  auto layOut = [&](Layout& layout) {
+    objectRegions_ = layout.array<int>(objectCount);
+    objectObbs_ = layout.array<geo::OBB>(objectCount);
+    regionLevels_ = layout.array<int>(regionCount);
+    regionAabbs_ = layout.array<box3f>(regionCount);
+    regionObjectOffsets_ = layout.array<int>(regionCount + 1);
+    regionObjects_ = layout.array<int>(regionObjectCount);
+    levelAabbs_ = layout.array<box3f>(levelCount);
+    levelRegionOffsets_ = layout.array<int>(levelCount + 1);
+    levelRegions_ = layout.array<int>(levelRegionCount);
+    levelObjectOffsets_ = layout.array<int>(levelCount + 1);
+    levelObjects_ = layout.array<int>(levelObjectCount);
+  };
+  Layout measure{nullptr};
+  layOut(measure);
+  // new[] memory is aligned for every fundamental type and for the
+  // 16-byte quaternions of the OBBs, which the layout relies on
+  storage_ = Cr::Containers::Array<char>{Cr::Containers::NoInit,
+                                         measure.size()};
+  Layout layout{storage_.data()};
+  layOut(layout);
+}
+
+}  // namespace scene
+}  // namespace esp
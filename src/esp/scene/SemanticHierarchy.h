@@ -0,0 +1,102 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+
+#include "esp/core/esp.h"
+#include "esp/geo/OBB.h"
+
+namespace esp {
+namespace scene {
+
+class SemanticScene;
+
+//! Flat copy of the levels, regions and objects of a SemanticScene in one
+//! allocation. Elements refer to each other by their index in
+//! SemanticScene::levels(), regions() and objects(), ID_UNDEFINED where the
+//! scene has no parent, so traversals don't chase shared pointers. Built by
+//! SemanticScene::buildIndices(), the scene classes stay the API.
+class SemanticHierarchy {
+ public:
+  explicit SemanticHierarchy() = default;
+
+  //! number of levels, regions and objects
+  size_t levelCount() const { return levelAabbs_.size(); }
+  size_t regionCount() const { return regionLevels_.size(); }
+  size_t objectCount() const { return objectRegions_.size(); }
+
+  //! region of each object
+  Corrade::Containers::ArrayView<const int> objectRegions() const {
+    return objectRegions_;
+  }
+
+  //! OBB of each object, default for objects the scene doesn't have
+  Corrade::Containers::ArrayView<const geo::OBB> objectObbs() const {
+    return objectObbs_;
+  }
+
+  //! level of each region
+  Corrade::Containers::ArrayView<const int> regionLevels() const {
+    return regionLevels_;
+  }
+
+  //! AABB of each region
+  Corrade::Containers::ArrayView<const box3f> regionAabbs() const {
+    return regionAabbs_;
+  }
+
+  //! AABB of each level
+  Corrade::Containers::ArrayView<const box3f> levelAabbs() const {
+    return levelAabbs_;
+  }
+
+  //! objects of a region
+  Corrade::Containers::ArrayView<const int> regionObjects(int region) const {
+    return regionObjects_.slice(regionObjectOffsets_[region],
+                                regionObjectOffsets_[region + 1]);
+  }
+
+  //! regions of a level
+  Corrade::Containers::ArrayView<const int> levelRegions(int level) const {
+    return levelRegions_.slice(levelRegionOffsets_[level],
+                               levelRegionOffsets_[level + 1]);
+  }
+
+  //! objects of a level
+  Corrade::Containers::ArrayView<const int> levelObjects(int level) const {
+    return levelObjects_.slice(levelObjectOffsets_[level],
+                               levelObjectOffsets_[level + 1]);
+  }
+
+ protected:
+  // children of element i are children[offsets[i]] until
+  // children[offsets[i + 1]]
+  explicit SemanticHierarchy(size_t levelCount,
+                             size_t regionCount,
+                             size_t objectCount,
+                             size_t levelRegionCount,
+                             size_t levelObjectCount,
+                             size_t regionObjectCount);
+
+  Corrade::Containers::Array<char> storage_;
+  Corrade::Containers::ArrayView<int> objectRegions_;
+  Corrade::Containers::ArrayView<geo::OBB> objectObbs_;
+  Corrade::Containers::ArrayView<int> regionLevels_;
+  Corrade::Containers::ArrayView<box3f> regionAabbs_;
+  Corrade::Containers::ArrayView<int> regionObjectOffsets_;
+  Corrade::Containers::ArrayView<int> regionObjects_;
+  Corrade::Containers::ArrayView<box3f> levelAabbs_;
+  Corrade::Containers::ArrayView<int> levelRegionOffsets_;
+  Corrade::Containers::ArrayView<int> levelRegions_;
+  Corrade::Containers::ArrayView<int> levelObjectOffsets_;
+  Corrade::Containers::ArrayView<int> levelObjects_;
+
+  friend SemanticScene;
+};
+
+}  // namespace scene
+}  // namespace esp
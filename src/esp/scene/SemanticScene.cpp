@@ -0,0 +1,262 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SemanticScene.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace esp {
+namespace scene {
+
+namespace {
+// results in the order of the objects or regions, independent of the
+// hierarchy layout
+std::vector<int> sorted(std::vector<int> indices) {
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+template <typename Query>
+std::vector<std::vector<int>> batch(const std::vector<vec3f>& points,
+                                    const Query& query) {
+  std::vector<std::vector<int>> results(points.size());
+#pragma omp parallel for if (points.size() > 64)
+  for (int i = 0; i < int(points.size()); ++i) {
+    results[i] = query(points[i]);
+  }
+  return results;
+}
+}  // namespace
+
+void SemanticScene::buildHierarchy() {
+  // parents are looked up by pointer, so the scene's shared pointers are
+  // followed only once, here
+  std::unordered_map<const SemanticLevel*, int> levelIndices;
+  for (size_t i = 0; i < levels_.size(); ++i) {
+    levelIndices[levels_[i].get()] = i;
+  }
+  std::unordered_map<const SemanticRegion*, int> regionIndices;
+  for (size_t i = 0; i < regions_.size(); ++i) {
+    regionIndices[regions_[i].get()] = i;
+  }
+  auto indexOf = [](const auto& indices, const auto* element) {
+    auto it = indices.find(element);
+    return it == indices.end() ? ID_UNDEFINED : it->second;
+  };
+
+  size_t levelRegionCount = 0;
+  size_t levelObjectCount = 0;
+  for (const auto& level : levels_) {
+    if (level != nullptr) {
+      levelRegionCount += level->regions_.size();
+      levelObjectCount += level->objects_.size();
+    }
+  }
+  size_t regionObjectCount = 0;
+  for (const auto& region : regions_) {
+    if (region != nullptr) {
+      regionObjectCount += region->objects_.size();
+    }
+  }
+  std::unordered_map<const SemanticObject*, int> objectIndices;
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    objectIndices[objects_[i].get()] = i;
+  }
+
+  SemanticHierarchy hierarchy{levels_.size(),   regions_.size(),
+                              objects_.size(),  levelRegionCount,
+                              levelObjectCount, regionObjectCount};
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    hierarchy.objectRegions_[i] = ID_UNDEFINED;
+    if (objects_[i] != nullptr) {
+      hierarchy.objectRegions_[i] =
+          indexOf(regionIndices, objects_[i]->region_.get());
+      hierarchy.objectObbs_[i] = objects_[i]->obb_;
+    }
+  }
+
+  // children of each parent, the first offset is 0 already
+  int next = 0;
+  for (size_t i = 0; i < regions_.size(); ++i) {
+    hierarchy.regionLevels_[i] = ID_UNDEFINED;
+    if (regions_[i] != nullptr) {
+      hierarchy.regionLevels_[i] =
+          indexOf(levelIndices, regions_[i]->level_.get());
+      hierarchy.regionAabbs_[i] = regions_[i]->bbox_;
+      for (const auto& object : regions_[i]->objects_) {
+        hierarchy.regionObjects_[next++] =
+            indexOf(objectIndices, object.get());
+      }
+    }
+    hierarchy.regionObjectOffsets_[i + 1] = next;
+  }
+  int nextRegion = 0;
+  int nextObject = 0;
+  for (size_t i = 0; i < levels_.size(); ++i) {
+    if (levels_[i] != nullptr) {
+      hierarchy.levelAabbs_[i] = levels_[i]->bbox_;
+      for (const auto& region : levels_[i]->regions_) {
+        hierarchy.levelRegions_[nextRegion++] =
+            indexOf(regionIndices, region.get());
+      }
+      for (const auto& object : levels_[i]->objects_) {
+        hierarchy.levelObjects_[nextObject++] =
+            indexOf(objectIndices, object.get());
+      }
+    }
+    hierarchy.levelRegionOffsets_[i + 1] = nextRegion;
+    hierarchy.levelObjectOffsets_[i + 1] = nextObject;
+  }
+
+  hierarchy_ = std::move(hierarchy);
+}
+
+void SemanticScene::buildSpatialIndex() {
+  std::vector<box3f> boxes(objects_.size());
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    if (objects_[i] != nullptr) {
+      boxes[i] = hierarchy_.objectObbs()[i].toAABB();
+    }
+  }
+  objectIndex_ = geo::BVH{boxes};
+
+  boxes.assign(hierarchy_.regionAabbs().begin(),
+               hierarchy_.regionAabbs().end());
+  regionIndex_ = geo::BVH{boxes};
+}
+
+void SemanticScene::buildCategoryIndex(const std::string& mapping) {
+  SemanticCategoryIndex index;
+  std::vector<std::string> objectNames(objects_.size());
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    if (objects_[i] != nullptr && objects_[i]->category_ != nullptr) {
+      objectNames[i] = objects_[i]->category_->name(mapping);
+      index.names.push_back(objectNames[i]);
+    }
+  }
+  std::sort(index.names.begin(), index.names.end());
+  index.names.erase(std::unique(index.names.begin(), index.names.end()),
+                    index.names.end());
+  for (size_t id = 0; id < index.names.size(); ++id) {
+    index.ids[index.names[id]] = id;
+  }
+
+  // counting sort of the objects by category ID
+  index.objectCategoryIds.assign(objects_.size(), ID_UNDEFINED);
+  index.offsets.assign(index.names.size() + 1, 0);
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    if (objects_[i] != nullptr && objects_[i]->category_ != nullptr) {
+      const int id = index.ids.at(objectNames[i]);
+      index.objectCategoryIds[i] = id;
+      ++index.offsets[id + 1];
+    }
+  }
+  for (size_t id = 0; id < index.names.size(); ++id) {
+    index.offsets[id + 1] += index.offsets[id];
+  }
+  index.objectIndices.resize(index.offsets.back());
+  std::vector<int> next(index.offsets.begin(), index.offsets.end() - 1);
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    if (index.objectCategoryIds[i] != ID_UNDEFINED) {
+      index.objectIndices[next[index.objectCategoryIds[i]]++] = i;
+    }
+  }
+
+  index.semanticIdCategories.assign(objects_.size(), ID_UNDEFINED);
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    if (index.objectCategoryIds[i] != ID_UNDEFINED) {
+      index.semanticIdCategories[i] = objects_[i]->category_->index(mapping);
+    }
+  }
+
+  categoryIndices_[mapping] = std::move(index);
+}
+
+void SemanticScene::buildIndices() {
+  buildHierarchy();
+  buildSpatialIndex();
+  buildCategoryIndex();
+}
+
+const SemanticCategoryIndex& SemanticScene::categoryIndex(
+    const std::string& mapping) const {
+  static const SemanticCategoryIndex empty;
+  auto it = categoryIndices_.find(mapping);
+  if (it == categoryIndices_.end()) {
+    LOG(ERROR) << "No category index for mapping " << mapping;
+    return empty;
+  }
+  return it->second;
+}
+
+std::vector<int> SemanticScene::objectsOfCategory(
+    const std::string& name,
+    const std::string& mapping) const {
+  const SemanticCategoryIndex& index = categoryIndex(mapping);
+  auto it = index.ids.find(name);
+  if (it == index.ids.end()) {
+    return {};
+  }
+  return {index.objectIndices.begin() + index.offsets[it->second],
+          index.objectIndices.begin() + index.offsets[it->second + 1]};
+}
+
+void SemanticScene::semanticIdsToCategories(
+    Corrade::Containers::ArrayView<uint32_t> ids,
+    const std::string& mapping) const {
+  const std::vector<int>& lut = categoryIndex(mapping).semanticIdCategories;
+#pragma omp parallel for if (ids.size() > 65536)
+  for (std::ptrdiff_t i = 0; i < std::ptrdiff_t(ids.size()); ++i) {
+    ids[i] = ids[i] < lut.size() ? lut[ids[i]] : ID_UNDEFINED;
+  }
+}
+
+std::vector<int> SemanticScene::objectsContaining(const vec3f& p) const {
+  std::vector<int> indices;
+  objectIndex_.visitContaining(p, [&](uint32_t i) {
+    if (hierarchy_.objectObbs()[i].contains(p)) {
+      indices.push_back(i);
+    }
+  });
+  return sorted(std::move(indices));
+}
+
+std::vector<int> SemanticScene::objectsWithinRadius(const vec3f& p,
+                                                    float radius) const {
+  std::vector<int> indices;
+  objectIndex_.visitWithinRadius(p, radius, [&](uint32_t i) {
+    if (hierarchy_.objectObbs()[i].distance(p) <= radius) {
+      indices.push_back(i);
+    }
+  });
+  return sorted(std::move(indices));
+}
+
+std::vector<int> SemanticScene::regionsContaining(const vec3f& p) const {
+  std::vector<int> indices;
+  regionIndex_.visitContaining(p, [&](uint32_t i) { indices.push_back(i); });
+  return sorted(std::move(indices));
+}
+
+std::vector<std::vector<int>> SemanticScene::objectsContaining(
+    const std::vector<vec3f>& points) const {
+  return batch(points, [this](const vec3f& p) { return objectsContaining(p); });
+}
+
+std::vector<std::vector<int>> SemanticScene::objectsWithinRadius(
+    const std::vector<vec3f>& points,
+    float radius) const {
+  return batch(points, [this, radius](const vec3f& p) {
+    return objectsWithinRadius(p, radius);
+  });
+}
+
+std::vector<std::vector<int>> SemanticScene::regionsContaining(
+    const std::vector<vec3f>& points) const {
+  return batch(points, [this](const vec3f& p) { return regionsContaining(p); });
+}
+
+}  // namespace scene
+}  // namespace esp
@@ -10,8 +10,12 @@
 #include <unordered_map>
 #include <vector>
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "esp/core/esp.h"
+#include "esp/geo/BVH.h"
 #include "esp/geo/OBB.h"
+#include "esp/scene/SemanticHierarchy.h"
 
 namespace esp {
 namespace scene {
@@ -28,6 +32,24 @@ class SemanticCategory {
   ESP_SMART_POINTERS(SemanticCategory);
 };
 
+//! Objects of a SemanticScene grouped by category name under one mapping
+struct SemanticCategoryIndex {
+  //! category names, sorted, the position in this vector is the dense ID
+  std::vector<std::string> names;
+  //! dense ID of each category name
+  std::unordered_map<std::string, int> ids;
+  //! dense category ID of each object, ID_UNDEFINED for objects without
+  //! category
+  std::vector<int> objectCategoryIds;
+  //! object indices ordered by category, the objects of category ID c are
+  //! objectIndices[offsets[c]] until objectIndices[offsets[c + 1]]
+  std::vector<int> objectIndices;
+  std::vector<int> offsets;
+  //! category index under the mapping of each semantic ID the semantic mesh
+  //! renders, which are object indices, ID_UNDEFINED for IDs without category
+  std::vector<int> semanticIdCategories;
+};
+
 // forward declarations
 class SemanticObject;
 class SemanticRegion;
@@ -80,6 +102,62 @@ class SemanticScene {
     }
   }
 
+  //! return indices into objects() of the objects whose OBB contains p
+  std::vector<int> objectsContaining(const vec3f& p) const;
+
+  //! return indices into objects() of the objects whose OBB is within radius
+  //! of p
+  std::vector<int> objectsWithinRadius(const vec3f& p, float radius) const;
+
+  //! return indices into regions() of the regions whose AABB contains p
+  std::vector<int> regionsContaining(const vec3f& p) const;
+
+  //! @ref objectsContaining() for each of the points, in parallel
+  std::vector<std::vector<int>> objectsContaining(
+      const std::vector<vec3f>& points) const;
+
+  //! @ref objectsWithinRadius() for each of the points, in parallel
+  std::vector<std::vector<int>> objectsWithinRadius(
+      const std::vector<vec3f>& points,
+      float radius) const;
+
+  //! @ref regionsContaining() for each of the points, in parallel
+  std::vector<std::vector<int>> regionsContaining(
+      const std::vector<vec3f>& points) const;
+
+  //! return the objects grouped by category under given mapping, empty if
+  //! @ref buildCategoryIndex() wasn't called for it
+  const SemanticCategoryIndex& categoryIndex(
+      const std::string& mapping = "") const;
+
+  //! return indices into objects() of the objects of given category
+  std::vector<int> objectsOfCategory(const std::string& name,
+                                     const std::string& mapping = "") const;
+
+  //! replace semantic IDs, e.g. a semantic sensor observation, in place with
+  //! their category index under given mapping
+  void semanticIdsToCategories(Corrade::Containers::ArrayView<uint32_t> ids,
+                               const std::string& mapping = "") const;
+
+  //! return the flat, index-based copy of the levels, regions and objects
+  const SemanticHierarchy& hierarchy() const { return hierarchy_; }
+
+  //! rebuild the flat hierarchy, needed after levels, regions or objects
+  //! change
+  void buildHierarchy();
+
+  //! rebuild the spatial index the point and radius queries use from the
+  //! flat hierarchy, needed after it changes
+  void buildSpatialIndex();
+
+  //! group the objects by category under given mapping, needed after objects
+  //! change
+  void buildCategoryIndex(const std::string& mapping = "");
+
+  //! build the flat hierarchy, the spatial index and the category index of
+  //! the default mapping, what the load functions do once done
+  void buildIndices();
+
   //! load SemanticScene from a Gibson house format file
   static bool loadGibsonHouse(
       const std::string& filename,
@@ -117,6 +195,12 @@ class SemanticScene {
   std::vector<std::shared_ptr<SemanticObject>> objects_;
   //! map from combined region-segment id to objectIndex for semantic mesh
   std::unordered_map<int, int> segmentToObjectIndex_;
+  SemanticHierarchy hierarchy_;
+  //! hierarchies over the AABBs of objects_ and regions_, nullptr objects
+  //! and regions are left out
+  geo::BVH objectIndex_;
+  geo::BVH regionIndex_;
+  std::map<std::string, SemanticCategoryIndex> categoryIndices_;
 
   ESP_SMART_POINTERS(SemanticScene)
 };
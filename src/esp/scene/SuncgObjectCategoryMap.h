@@ -2,2652 +2,2900 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
-#include <map>
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <string>
-#include <utility>
+
+#include "esp/core/esp.h"
 
 namespace esp {
 namespace scene {
 
-//! map from SUNCG object model id to category set (comma separated)
-// NOTE: This is the model id to category mapping from SUNCG v2.1
-static const std::map<std::string, std::string> kSuncgObjectCategoryMap = {
-    {"100", "hanger"},
-    {"101", "kitchen_cabinet,range_oven"},
-    {"102", "kitchen_appliance,refrigerator"},
-    {"104", "desk"},
-    {"105", "desk"},
-    {"106", "chair,office_chair"},
-    {"107", "desk"},
-    {"108", "desk"},
-    {"109", "table,coffee_table"},
-    {"110", "television"},
-    {"111", "television"},
-    {"112", "television"},
-    {"113", "television"},
-    {"114", "television"},
-    {"115", "tv_stand"},
-    {"116", "tv_stand"},
-    {"117", "tv_stand"},
-    {"118", "hanger"},
-    {"119", "table,coffee_table"},
-    {"120", "computer,laptop"},
-    {"121", "wardrobe_cabinet"},
-    {"122", "door"},
-    {"122_0", "door"},
-    {"122_2", "door"},
-    {"123", "hanger"},
-    {"124", "indoor_lamp,wall_lamp"},
-    {"125", "kitchen_cabinet,kitchen_sink"},
-    {"126", "window"},
-    {"127", "indoor_lamp,wall_lamp"},
-    {"128", "stand,nightstand"},
-    {"129", "dresser"},
-    {"130", "plant"},
-    {"131", "kitchen_appliance,refrigerator"},
-    {"132", "sink"},
-    {"133", "door"},
-    {"133_0", "door"},
-    {"133_2", "door"},
-    {"134", "table_and_chair"},
-    {"135", "shower"},
-    {"136", "toy,fish_tank"},
-    {"137", "kitchen_cabinet,kitchen_sink"},
-    {"138", "kitchen_cabinet,kitchen_sink"},
-    {"139", "shower"},
-    {"140", "dresser"},
-    {"141", "dressing_table"},
-    {"142", "chair,straight_chair"},
-    {"143", "music,piano"},
-    {"144", "mirror"},
-    {"145", "shoes_cabinet"},
-    {"146", "stand,nightstand"},
-    {"147", "stand,nightstand"},
-    {"148", "books,book"},
-    {"149", "kitchenware,cup"},
-    {"150", "toilet,bidet"},
-    {"151", "stairs"},
-    {"152", "stairs"},
-    {"153", "rug"},
-    {"154", "kitchenware,pan"},
-    {"155", "sofa"},
-    {"156", "sofa"},
-    {"157", "sofa"},
-    {"166", "chair,armchair"},
-    {"167", "sofa"},
-    {"168", "sofa"},
-    {"169", "chair,armchair,sofa_chair"},
-    {"170", "sofa"},
-    {"171", "table,coffee_table"},
-    {"172", "table,coffee_table"},
-    {"173", "table,coffee_table"},
-    {"174", "table,coffee_table"},
-    {"175", "indoor_lamp,wall_lamp"},
-    {"176", "indoor_lamp,wall_lamp"},
-    {"178", "indoor_lamp,wall_lamp"},
-    {"179", "indoor_lamp,wall_lamp"},
-    {"180", "indoor_lamp,wall_lamp"},
-    {"181", "sink"},
-    {"182", "wardrobe_cabinet"},
-    {"183", "sink"},
-    {"184", "wardrobe_cabinet"},
-    {"185", "recreation,game_table"},
-    {"186", "sink"},
-    {"187", "wardrobe_cabinet"},
-    {"188", "shelving"},
-    {"189", "computer"},
-    {"190", "bed,baby_bed"},
-    {"191", "shelving,bookshelf"},
-    {"192", "shelving"},
-    {"193", "shelving"},
-    {"194", "wardrobe_cabinet"},
-    {"195", "stand,nightstand"},
-    {"196", "chair,armchair"},
-    {"197", "stand,nightstand"},
-    {"198", "tv_stand"},
-    {"199", "dressing_table"},
-    {"200", "dressing_table"},
-    {"201", "dressing_table"},
-    {"202", "dressing_table"},
-    {"203", "dressing_table"},
-    {"204", "bed,double_bed"},
-    {"205", "bed,double_bed"},
-    {"206", "kitchen_appliance,water_dispenser"},
-    {"207", "shelving,wall_shelf"},
-    {"208", "hanger"},
-    {"209", "window"},
-    {"210", "window"},
-    {"211", "window"},
-    {"212", "window"},
-    {"213", "window"},
-    {"214", "door"},
-    {"214_0", "door"},
-    {"214_2", "door"},
-    {"215", "television"},
-    {"216", "television"},
-    {"217", "hanger"},
-    {"218", "music,stereo_set"},
-    {"219", "kitchen_appliance,dishwasher"},
-    {"220", "kitchen_appliance,food_processor"},
-    {"221", "kitchen_appliance,coffee_machine"},
-    {"222", "kitchen_appliance,microwave"},
-    {"223", "household_appliance,vacuum_cleaner"},
-    {"224", "household_appliance,iron"},
-    {"225", "air_conditioner"},
-    {"226", "fan,pedestal_fan"},
-    {"227", "air_conditioner"},
-    {"228", "television"},
-    {"229", "bathroom_stuff,towel_rack"},
-    {"230", "heater"},
-    {"232", "kitchen_cabinet,kitchen_sink"},
-    {"233", "stand,nightstand"},
-    {"235", "rug"},
-    {"236", "picture_frame"},
-    {"237", "plant"},
-    {"238", "rug"},
-    {"239", "mirror"},
-    {"240", "indoor_lamp,floor_lamp"},
-    {"241", "kitchen_appliance,range_hood"},
-    {"242", "fireplace"},
-    {"243", "kitchenware,bottle,drink"},
-    {"244", "kitchenware,glass"},
-    {"245", "kitchenware,cutting_board,food"},
-    {"246", "door"},
-    {"246_0", "door"},
-    {"246_2", "door"},
-    {"247", "door"},
-    {"247_0", "door"},
-    {"247_2", "door"},
-    {"248", "shelving"},
-    {"249", "chair,straight_chair"},
-    {"250", "hanging_kitchen_cabinet"},
-    {"251", "hanging_kitchen_cabinet"},
-    {"252", "table,dining_table"},
-    {"253", "stairs"},
-    {"254", "stairs"},
-    {"255", "chair,straight_chair"},
-    {"256", "indoor_lamp,table_lamp"},
-    {"257", "picture_frame"},
-    {"258", "vase"},
-    {"259", "sofa"},
-    {"260", "sofa"},
-    {"261", "chair,armchair,sofa_chair"},
-    {"262", "chair,armchair,sofa_chair"},
-    {"263", "household_appliance,ironing_board"},
-    {"264", "kitchen_appliance,range_oven"},
-    {"265", "kitchenware,beer,drink"},
-    {"266", "wardrobe_cabinet"},
-    {"267", "wardrobe_cabinet"},
-    {"268", "shelving"},
-    {"269", "wardrobe_cabinet"},
-    {"270", "bed,bunker_bed"},
-    {"271", "wardrobe_cabinet"},
-    {"272", "wardrobe_cabinet"},
-    {"273", "desk"},
-    {"274", "wardrobe_cabinet"},
-    {"275", "curtain"},
-    {"276", "curtain,blinds"},
-    {"277", "chair,straight_chair"},
-    {"278", "music,loudspeaker"},
-    {"279", "switch"},
-    {"280", "switch"},
-    {"281", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"282", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"283", "kitchen_cabinet,range_oven"},
-    {"284", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"285", "kitchen_cabinet,kitchen_sink"},
-    {"286", "hanging_kitchen_cabinet"},
-    {"287", "hanging_kitchen_cabinet"},
-    {"288", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"289", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"290", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"291", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"292", "shoes_cabinet"},
-    {"293", "shelving"},
-    {"294", "desk"},
-    {"295", "kitchen_cabinet,kitchen_sink"},
-    {"311", "stand,nightstand"},
-    {"312", "stand,nightstand"},
-    {"313", "clock"},
-    {"314", "mirror"},
-    {"315", "stand,nightstand"},
-    {"316", "hanging_kitchen_cabinet"},
-    {"317", "hanging_kitchen_cabinet"},
-    {"318", "stand,nightstand"},
-    {"319", "books"},
-    {"320", "books"},
-    {"321", "sofa"},
-    {"322", "toy"},
-    {"323", "person"},
-    {"324", "person"},
-    {"325", "person"},
-    {"326", "door"},
-    {"327", "door"},
-    {"328", "partition"},
-    {"329", "partition"},
-    {"330", "partition"},
-    {"331", "door"},
-    {"333", "person"},
-    {"334", "fireplace"},
-    {"335", "chair,office_chair"},
-    {"336", "chair"},
-    {"337", "gym_equipment"},
-    {"338", "gym_equipment"},
-    {"339", "gym_equipment"},
-    {"340", "toy,chessboard"},
-    {"341", "toy,fish_tank"},
-    {"342", "toy,fishbowl"},
-    {"343", "kitchenware,kettle"},
-    {"344", "kitchenware,kettle"},
-    {"345", "toy,playstation"},
-    {"346", "person"},
-    {"347", "chair,armchair"},
-    {"348", "chair,armchair"},
-    {"349", "chair,armchair"},
-    {"350", "sofa"},
-    {"351", "chair,armchair"},
-    {"352", "chair,armchair"},
-    {"353", "toy"},
-    {"354", "headstone"},
-    {"355", "coffin"},
-    {"356", "toy"},
-    {"357", "toy"},
-    {"358", "toy"},
-    {"359", "toy"},
-    {"360", "sofa"},
-    {"361", "garage_door"},
-    {"361_0", "garage_door"},
-    {"362", "decoration"},
-    {"363", "vehicle,motorcycle"},
-    {"364", "vehicle,car"},
-    {"365", "column"},
-    {"366", "column"},
-    {"367", "column"},
-    {"368", "fence"},
-    {"369", "fence"},
-    {"370", "fence"},
-    {"371", "fence"},
-    {"372", "fence"},
-    {"373", "fence"},
-    {"374", "fence"},
-    {"375", "fence"},
-    {"376", "fence"},
-    {"377", "outdoor_lamp"},
-    {"378", "outdoor_lamp"},
-    {"379", "fence"},
-    {"380", "sofa"},
-    {"381", "outdoor_lamp"},
-    {"382", "sofa"},
-    {"383", "wardrobe_cabinet"},
-    {"384", "wardrobe_cabinet"},
-    {"385", "wardrobe_cabinet"},
-    {"386", "wardrobe_cabinet"},
-    {"387", "wardrobe_cabinet"},
-    {"388", "wardrobe_cabinet"},
-    {"389", "wardrobe_cabinet"},
-    {"390", "shelving"},
-    {"391", "wardrobe_cabinet"},
-    {"392", "tv_stand"},
-    {"393", "shelving"},
-    {"394", "outdoor_lamp"},
-    {"395", "kitchenware,trash_can"},
-    {"396", "stand,nightstand"},
-    {"397", "dresser"},
-    {"398", "dresser"},
-    {"399", "wardrobe_cabinet"},
-    {"40", "table,dining_table"},
-    {"403", "bed,double_bed"},
-    {"404", "stand,nightstand"},
-    {"405", "kitchen_cabinet,large_kitchen_cabinet"},
-    {"406", "hanging_kitchen_cabinet"},
-    {"407", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"408", "kitchen_cabinet,kitchen_island"},
-    {"409", "chair,stool"},
-    {"41", "table,coffee_table"},
-    {"410", "recreation,basketball_hoop"},
-    {"411", "outdoor_seating,porch_swing"},
-    {"412", "outdoor_seating,swing"},
-    {"413", "grill"},
-    {"414", "chair,lounge_chair"},
-    {"415", "chair,office_chair"},
-    {"416", "wardrobe_cabinet"},
-    {"417", "desk"},
-    {"418", "toilet"},
-    {"419", "indoor_lamp,table_lamp"},
-    {"42", "wardrobe_cabinet"},
-    {"420", "sofa"},
-    {"421", "indoor_lamp,table_lamp"},
-    {"422", "indoor_lamp,table_lamp"},
-    {"423", "indoor_lamp,table_lamp"},
-    {"424", "desk"},
-    {"425", "chair,armchair"},
-    {"426", "chair,armchair"},
-    {"427", "chair,armchair"},
-    {"428", "desk"},
-    {"429", "chair,stool"},
-    {"43", "household_appliance,dryer"},
-    {"430", "desk"},
-    {"431", "dresser"},
-    {"432", "gym_equipment"},
-    {"433", "bench_chair"},
-    {"434", "gym_equipment"},
-    {"435", "gym_equipment"},
-    {"436", "gym_equipment"},
-    {"437", "gym_equipment"},
-    {"438", "gym_equipment"},
-    {"439", "gym_equipment"},
-    {"44", "household_appliance"},
-    {"440", "bench_chair"},
-    {"441", "chair,straight_chair"},
-    {"442", "table,dining_table"},
-    {"443", "toilet,urinal"},
-    {"444", "toilet,urinal"},
-    {"445", "shoes_cabinet"},
-    {"446", "chair,straight_chair"},
-    {"447", "sink"},
-    {"448", "shelving"},
-    {"449", "chair,armchair,sofa_chair"},
-    {"45", "hanging_kitchen_cabinet"},
-    {"450", "chair,straight_chair"},
-    {"451", "tv_stand"},
-    {"452", "table,dining_table"},
-    {"453", "toilet,bidet"},
-    {"454", "tv_stand"},
-    {"455", "desk"},
-    {"456", "shelving"},
-    {"457", "shelving"},
-    {"458", "shelving,wall_shelf"},
-    {"459", "shelving,wall_shelf"},
-    {"46", "hanging_kitchen_cabinet"},
-    {"460", "toy"},
-    {"461", "toy"},
-    {"462", "toy"},
-    {"463", "plant"},
-    {"464", "dresser"},
-    {"465", "bathtub"},
-    {"466", "bench_chair"},
-    {"467", "chair,lounge_chair"},
-    {"468", "table,coffee_table"},
-    {"469", "dresser"},
-    {"470", "table,coffee_table"},
-    {"471", "chair,armchair,sofa_chair"},
-    {"472", "table,coffee_table"},
-    {"473", "sofa"},
-    {"474", "table"},
-    {"475", "bench_chair"},
-    {"476", "bench_chair"},
-    {"477", "desk"},
-    {"478", "bench_chair"},
-    {"479", "shoes_cabinet"},
-    {"480", "dresser"},
-    {"481", "wardrobe_cabinet"},
-    {"482", "shelving,bookshelf"},
-    {"483", "stairs"},
-    {"484", "workplace,double_desk"},
-    {"485", "desk"},
-    {"486", "desk"},
-    {"487", "desk"},
-    {"488", "stand"},
-    {"489", "stand,nightstand"},
-    {"490", "stand,nightstand"},
-    {"491", "chair,armchair"},
-    {"492", "shelving,wall_shelf"},
-    {"493", "shelving,wall_shelf"},
-    {"494", "desk"},
-    {"495", "tv_stand"},
-    {"496", "chair,folding_chair"},
-    {"497", "partition"},
-    {"498", "partition"},
-    {"499", "bathroom_stuff,towel_rack"},
-    {"500", "chair,straight_chair"},
-    {"501", "chair,straight_chair"},
-    {"502", "partition"},
-    {"502_2", "partition"},
-    {"503", "wardrobe_cabinet"},
-    {"504", "table,dining_table"},
-    {"505", "shelving,wall_shelf"},
-    {"506", "desk"},
-    {"507", "chair,armchair_with_ottoman"},
-    {"508", "shelving"},
-    {"509", "dresser"},
-    {"510", "heater"},
-    {"511", "chair,armchair"},
-    {"512", "wardrobe_cabinet"},
-    {"513", "stand,nightstand"},
-    {"514", "desk"},
-    {"515", "indoor_lamp,table_lamp"},
-    {"516", "chair,office_chair"},
-    {"517", "indoor_lamp,floor_lamp"},
-    {"518", "whiteboard"},
-    {"519", "fireplace"},
-    {"520", "indoor_lamp,floor_lamp"},
-    {"521", "indoor_lamp,floor_lamp"},
-    {"522", "music,piano"},
-    {"523", "indoor_lamp,floor_lamp"},
-    {"524", "indoor_lamp,floor_lamp"},
-    {"525", "table,dining_table"},
-    {"526", "hanger"},
-    {"527", "towel_hanger"},
-    {"528", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"529", "vase"},
-    {"530", "kitchenware,plates"},
-    {"531", "candle"},
-    {"532", "chair,office_chair"},
-    {"533", "desk"},
-    {"534", "stand"},
-    {"535", "chair,armchair"},
-    {"536", "kitchenware,utensil_holder"},
-    {"537", "kitchen_appliance,food_processor"},
-    {"538", "kitchenware,knife_rack"},
-    {"539", "kitchenware,coffee_kettle"},
-    {"540", "toy"},
-    {"541", "ottoman"},
-    {"542", "table,coffee_table"},
-    {"543", "table,coffee_table"},
-    {"544", "ottoman"},
-    {"545", "ottoman"},
-    {"546", "table,coffee_table"},
-    {"547", "ottoman"},
-    {"548", "ottoman"},
-    {"549", "table,coffee_table"},
-    {"550", "table,coffee_table"},
-    {"551", "table,coffee_table"},
-    {"552", "table,coffee_table"},
-    {"553", "ottoman"},
-    {"554", "ottoman"},
-    {"555", "table,coffee_table"},
-    {"556", "table,coffee_table"},
-    {"557", "ottoman"},
-    {"558", "ottoman"},
-    {"559", "ottoman"},
-    {"560", "ottoman"},
-    {"561", "table,coffee_table"},
-    {"562", "pool"},
-    {"563", "table,coffee_table"},
-    {"564", "table,coffee_table"},
-    {"565", "table,coffee_table"},
-    {"566", "table,coffee_table"},
-    {"567", "table,coffee_table"},
-    {"568", "table,coffee_table"},
-    {"569", "table,coffee_table"},
-    {"57", "sofa"},
-    {"570", "tv_stand"},
-    {"577", "tv_stand"},
-    {"579", "table,coffee_table"},
-    {"580", "table,coffee_table"},
-    {"586", "table,coffee_table"},
-    {"587", "table,coffee_table"},
-    {"589", "table,coffee_table"},
-    {"590", "tv_stand"},
-    {"591", "table,coffee_table"},
-    {"592", "table,coffee_table"},
-    {"593", "kitchen_cabinet,range_oven_with_hood"},
-    {"594", "kitchen_cabinet,kitchen_sink_with_hanging_kitchen_cabinet"},
-    {"595", "kitchen_cabinet,kitchen_sink_with_hanging_kitchen_cabinet"},
-    {"596", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"597", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"598",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"599",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"60", "bathtub"},
-    {"600",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"601",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"602",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"603",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"604",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"605", "bench_chair"},
-    {"606", "wardrobe_cabinet"},
-    {"607", "shelving"},
-    {"608", "tv_stand"},
-    {"609", "wardrobe_cabinet"},
-    {"610", "wardrobe_cabinet"},
-    {"611", "wardrobe_cabinet"},
-    {"612", "shelving"},
-    {"613", "wardrobe_cabinet"},
-    {"614", "wardrobe_cabinet"},
-    {"615", "dresser"},
-    {"616", "tv_stand"},
-    {"617", "tv_stand"},
-    {"618", "tv_stand"},
-    {"620", "plant"},
-    {"621", "curtain"},
-    {"622", "curtain"},
-    {"623", "plant"},
-    {"624", "plant"},
-    {"625", "curtain"},
-    {"626", "indoor_lamp,chandelier"},
-    {"627", "indoor_lamp,chandelier"},
-    {"628", "indoor_lamp,chandelier"},
-    {"629", "indoor_lamp,chandelier"},
-    {"63", "sofa"},
-    {"630", "indoor_lamp,chandelier"},
-    {"631", "indoor_lamp,chandelier"},
-    {"632", "indoor_lamp,chandelier"},
-    {"633", "indoor_lamp,chandelier"},
-    {"634", "plant"},
-    {"635", "pool"},
-    {"636", "indoor_lamp,chandelier"},
-    {"637", "plant"},
-    {"638", "kitchen_appliance,small_refrigerator"},
-    {"639", "kitchen_appliance,small_refrigerator"},
-    {"64", "sofa"},
-    {"640", "kitchen_appliance,small_refrigerator"},
-    {"641", "ATM"},
-    {"645", "sofa"},
-    {"646", "chair,armchair,sofa_chair"},
-    {"647", "ottoman"},
-    {"648", "toy"},
-    {"649", "indoor_lamp,chandelier"},
-    {"650", "fan,ceiling_fan"},
-    {"651", "toy,xbox"},
-    {"652", "kitchen_cabinet,kitchen_island"},
-    {"653", "kitchen_cabinet,kitchen_island"},
-    {"654", "table,dining_table"},
-    {"655", "table,dining_table"},
-    {"656", "table,dining_table"},
-    {"657", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"658", "kitchen_cabinet,tall_kitchen_cabinet_with_oven"},
-    {"659", "hanging_kitchen_cabinet"},
-    {"660", "hanging_kitchen_cabinet"},
-    {"661", "kitchen_appliance,range_hood"},
-    {"662", "kitchen_cabinet,range_oven"},
-    {"663", "kitchen_cabinet,kitchen_sink"},
-    {"664", "table,dining_table"},
-    {"665", "kitchen_cabinet,tall_kitchen_cabinet_with_oven"},
-    {"666", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"667", "hanging_kitchen_cabinet"},
-    {"668", "hanging_kitchen_cabinet"},
-    {"669", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"67", "chair,armchair,sofa_chair"},
-    {"670", "kitchen_cabinet,kitchen_sink"},
-    {"671", "kitchen_cabinet,range_with_hood"},
-    {"672", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"673", "kitchen_cabinet,kitchen_island_with_range_hood_and_table"},
-    {"674", "shelving"},
-    {"675", "table,dining_table"},
-    {"676", "table,dining_table"},
-    {"677", "chair,office_chair"},
-    {"678", "kitchenware,fruit_bowl,food"},
-    {"679", "picture_frame"},
-    {"680", "picture_frame"},
-    {"681", "picture_frame"},
-    {"682", "bench_chair"},
-    {"683", "indoor_lamp,table_lamp"},
-    {"684", "indoor_lamp,table_lamp"},
-    {"685", "indoor_lamp,table_lamp"},
-    {"686", "recreation,goal_post"},
-    {"687", "pet,cat"},
-    {"688", "pet,cat"},
-    {"689", "pet,cat"},
-    {"69", "chair,armchair,sofa_chair"},
-    {"690", "sofa"},
-    {"691", "outdoor_lamp"},
-    {"692", "sofa"},
-    {"693", "chair,armchair,sofa_chair"},
-    {"694", "workplace,double_desk_with_chairs"},
-    {"695", "workplace,double_desk_with_chairs"},
-    {"696", "table_and_chair"},
-    {"697", "table_and_chair"},
-    {"698", "table_and_chair"},
-    {"699", "table_and_chair"},
-    {"70", "chair,armchair_with_ottoman"},
-    {"700", "sofa"},
-    {"701", "table_and_chair"},
-    {"702", "pool"},
-    {"703", "outdoor_seating"},
-    {"704", "outdoor_seating"},
-    {"705", "table_and_chair"},
-    {"706", "outdoor_seating,porch_swing"},
-    {"707", "outdoor_seating"},
-    {"708", "outdoor_seating,hammock"},
-    {"709", "chair,armchair"},
-    {"71", "table,coffee_table"},
-    {"710", "chair,armchair"},
-    {"711", "chair,folding_chair"},
-    {"712", "chair,folding_chair"},
-    {"713", "table,coffee_table"},
-    {"714", "table,coffee_table"},
-    {"715", "table,coffee_table"},
-    {"716", "table,coffee_table"},
-    {"717", "plant"},
-    {"718", "plant"},
-    {"719", "plant"},
-    {"720", "plant"},
-    {"721", "plant"},
-    {"722", "fence"},
-    {"723", "plant"},
-    {"724", "plant"},
-    {"725", "plant"},
-    {"726", "plant"},
-    {"727", "plant"},
-    {"728", "plant"},
-    {"729", "pool"},
-    {"73", "door"},
-    {"73_0", "door"},
-    {"73_2", "door"},
-    {"730", "pool"},
-    {"731", "plant"},
-    {"732", "plant"},
-    {"733", "plant"},
-    {"734", "plant"},
-    {"735", "plant"},
-    {"736", "plant"},
-    {"737", "plant"},
-    {"738", "plant"},
-    {"739", "plant"},
-    {"74", "sink"},
-    {"740", "plant"},
-    {"741", "plant"},
-    {"742", "plant"},
-    {"743", "outdoor_cover,umbrella"},
-    {"744", "outdoor_cover,umbrella"},
-    {"745", "sofa"},
-    {"746", "outdoor_cover,umbrella"},
-    {"747", "curtain,blinds"},
-    {"748", "curtain,blinds"},
-    {"749", "outdoor_cover,umbrella"},
-    {"75", "bed,double_bed"},
-    {"750", "curtain,blinds"},
-    {"751", "curtain,blinds"},
-    {"752", "window"},
-    {"753", "window"},
-    {"754", "window"},
-    {"755", "window"},
-    {"756", "door"},
-    {"756_0", "door"},
-    {"756_2", "door"},
-    {"757", "door"},
-    {"757_0", "door"},
-    {"757_2", "door"},
-    {"758", "door"},
-    {"758_0", "door"},
-    {"758_2", "door"},
-    {"759", "door"},
-    {"759_0", "door"},
-    {"759_2", "door"},
-    {"760", "door"},
-    {"760_0", "door"},
-    {"760_2", "door"},
-    {"761", "door"},
-    {"761_0", "door"},
-    {"761_2", "door"},
-    {"762", "door"},
-    {"762_0", "door"},
-    {"762_2", "door"},
-    {"763", "door"},
-    {"763_0", "door"},
-    {"763_2", "door"},
-    {"764", "door"},
-    {"764_0", "door"},
-    {"764_2", "door"},
-    {"765", "garage_door"},
-    {"765_0", "garage_door"},
-    {"766", "window"},
-    {"767", "window"},
-    {"768", "door"},
-    {"768_0", "door"},
-    {"768_2", "door"},
-    {"769", "door"},
-    {"769_0", "door"},
-    {"769_2", "door"},
-    {"77", "bed,double_bed"},
-    {"770", "door"},
-    {"770_0", "door"},
-    {"770_2", "door"},
-    {"771", "garage_door"},
-    {"771_0", "garage_door"},
-    {"773", "wardrobe_cabinet"},
-    {"775", "fence"},
-    {"776", "fence"},
-    {"777", "fence"},
-    {"778", "arch"},
-    {"778_0", "arch"},
-    {"779", "arch"},
-    {"779_0", "arch"},
-    {"78", "bed,single_bed"},
-    {"780", "arch"},
-    {"780_0", "arch"},
-    {"781", "picture_frame"},
-    {"782", "stairs"},
-    {"783", "stairs"},
-    {"784", "stairs"},
-    {"785", "stairs"},
-    {"786", "plant"},
-    {"79", "sink"},
-    {"797", "roof"},
-    {"80", "bathtub"},
-    {"81", "bathtub"},
-    {"82", "bathtub"},
-    {"83", "toilet"},
-    {"85", "household_appliance,washer"},
-    {"86", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"87", "sink"},
-    {"88", "chair,stool"},
-    {"89", "chair,straight_chair"},
-    {"90", "chair,straight_chair"},
-    {"91", "chair,armchair"},
-    {"92", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"93", "tv_stand"},
-    {"94", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"95", "shelving"},
-    {"97", "shelving,wall_shelf"},
-    {"98", "dresser"},
-    {"99", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__1000", "stand,nightstand"},
-    {"s__1001", "wardrobe_cabinet"},
-    {"s__1002", "dresser"},
-    {"s__1003", "table,coffee_table"},
-    {"s__1004", "table,coffee_table"},
-    {"s__1005", "table,coffee_table"},
-    {"s__1006", "table,coffee_table"},
-    {"s__1007", "table,coffee_table"},
-    {"s__1008", "table,coffee_table"},
-    {"s__1009", "table,coffee_table"},
-    {"s__1010", "table,coffee_table"},
-    {"s__1011", "table,coffee_table"},
-    {"s__1012", "table,coffee_table"},
-    {"s__1013", "table,coffee_table"},
-    {"s__1014", "table,coffee_table"},
-    {"s__1015", "table,coffee_table"},
-    {"s__1016", "table,coffee_table"},
-    {"s__1017", "chair,straight_chair"},
-    {"s__1018", "table,coffee_table"},
-    {"s__1019", "chair,stool"},
-    {"s__1020", "desk"},
-    {"s__1021", "desk"},
-    {"s__1022", "desk"},
-    {"s__1023", "desk"},
-    {"s__1024", "indoor_lamp,wall_lamp"},
-    {"s__1025", "indoor_lamp,chandelier"},
-    {"s__1026", "indoor_lamp,table_lamp"},
-    {"s__1027", "indoor_lamp,chandelier"},
-    {"s__1028", "indoor_lamp,wall_lamp"},
-    {"s__1029", "kitchen_cabinet,tall_kitchen_cabinet_with_oven"},
-    {"s__1030", "kitchen_cabinet,tall_kitchen_cabinet_with_oven"},
-    {"s__1031", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1032", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1033", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1034", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1035", "kitchen_cabinet,tall_kitchen_cabinet_with_oven"},
-    {"s__1036", "kitchen_cabinet,tall_kitchen_cabinet_with_oven"},
-    {"s__1037", "table,coffee_table"},
-    {"s__1038", "chair,armchair"},
-    {"s__1039", "chair,lounge_chair"},
-    {"s__1040", "chair,lounge_chair"},
-    {"s__1041", "kitchen_set"},
-    {"s__1042", "kitchen_set"},
-    {"s__1043", "kitchen_set"},
-    {"s__1044", "kitchen_set"},
-    {"s__1045", "kitchen_set"},
-    {"s__1046", "kitchen_set"},
-    {"s__1047", "kitchen_set"},
-    {"s__1048", "kitchen_set"},
-    {"s__1049", "kitchen_set"},
-    {"s__1050", "kitchen_set"},
-    {"s__1051", "kitchen_cabinet,kitchen_set"},
-    {"s__1052", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1053", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__1054", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__1055", "kitchen_cabinet,kitchen_cabinet_with_refrigerator"},
-    {"s__1056",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"s__1057",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"s__1058", "kitchen_appliance,range_oven"},
-    {"s__1059", "indoor_lamp,chandelier"},
-    {"s__1060", "kitchen_appliance,range_hood"},
-    {"s__1061", "shelving,wall_shelf"},
-    {"s__1062", "chair,straight_chair"},
-    {"s__1063", "hanging_kitchen_cabinet"},
-    {"s__1064",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"s__1065", "kitchen_set"},
-    {"s__1066", "kitchen_cabinet,kitchen_sink_with_dishwasher"},
-    {"s__1067", "sofa"},
-    {"s__1068", "shelving,bookshelf"},
-    {"s__1069", "indoor_lamp,chandelier"},
-    {"s__1070", "indoor_lamp,chandelier"},
-    {"s__1071", "indoor_lamp,chandelier"},
-    {"s__1072", "indoor_lamp,wall_lamp"},
-    {"s__1073", "table,dining_table"},
-    {"s__1074", "chair,straight_chair"},
-    {"s__1075", "kitchen_cabinet,kitchen_island"},
-    {"s__1076", "hanging_kitchen_cabinet"},
-    {"s__1077", "kitchen_cabinet,kitchen_cabinet_with_refrigerator"},
-    {"s__1078", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1079", "table,dining_table"},
-    {"s__1080", "chair,armchair"},
-    {"s__1081", "indoor_lamp,chandelier"},
-    {"s__1082", "indoor_lamp,chandelier"},
-    {"s__1083", "chair,straight_chair"},
-    {"s__1084", "hanging_kitchen_cabinet,range_hood_with_cabinet"},
-    {"s__1085", "hanging_kitchen_cabinet"},
-    {"s__1086", "hanging_kitchen_cabinet"},
-    {"s__1087", "indoor_lamp,chandelier"},
-    {"s__1088", "kitchen_cabinet,kitchen_set"},
-    {"s__1089", "sofa"},
-    {"s__1090", "rug"},
-    {"s__1091", "candle"},
-    {"s__1092", "ottoman"},
-    {"s__1093", "chair,armchair"},
-    {"s__1094", "ottoman"},
-    {"s__1095", "shelving"},
-    {"s__1096", "table,dining_table"},
-    {"s__1097", "sofa"},
-    {"s__1098", "table,dining_table"},
-    {"s__1099", "table,coffee_table"},
-    {"s__1100", "table,coffee_table"},
-    {"s__1101", "chair,straight_chair"},
-    {"s__1102", "indoor_lamp,floor_lamp"},
-    {"s__1103", "indoor_lamp,wall_lamp"},
-    {"s__1104", "table,coffee_table"},
-    {"s__1105", "wardrobe_cabinet"},
-    {"s__1106", "table,coffee_table"},
-    {"s__1107", "table,coffee_table"},
-    {"s__1108", "indoor_lamp,wall_lamp"},
-    {"s__1109", "indoor_lamp,table_lamp"},
-    {"s__1110", "fireplace"},
-    {"s__1111", "dresser"},
-    {"s__1112", "sofa"},
-    {"s__1113", "chair,armchair,sofa_chair"},
-    {"s__1114", "indoor_lamp,chandelier"},
-    {"s__1115", "indoor_lamp,table_lamp"},
-    {"s__1116", "indoor_lamp,floor_lamp"},
-    {"s__1117", "chair,stool"},
-    {"s__1118", "table,coffee_table"},
-    {"s__1119", "table,dining_table"},
-    {"s__1120", "table,dining_table"},
-    {"s__1121", "chair,straight_chair"},
-    {"s__1122", "table,coffee_table"},
-    {"s__1123", "chair,stool"},
-    {"s__1124", "bench_chair"},
-    {"s__1125", "chair,armchair"},
-    {"s__1126", "sofa"},
-    {"s__1127", "sofa"},
-    {"s__1128", "candle"},
-    {"s__1129", "fan,ceiling_fan"},
-    {"s__1130", "table,coffee_table"},
-    {"s__1131", "bathtub"},
-    {"s__1132", "sink"},
-    {"s__1133", "chair,stool"},
-    {"s__1134", "shelving"},
-    {"s__1135", "table,coffee_table"},
-    {"s__1136", "toilet"},
-    {"s__1137", "toy"},
-    {"s__1138", "toilet,bidet"},
-    {"s__1139", "indoor_lamp,wall_lamp"},
-    {"s__1140", "indoor_lamp,wall_lamp"},
-    {"s__1141", "kitchen_appliance,range_oven_with_hood"},
-    {"s__1142", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__1143", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__1144", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__1145", "kitchen_cabinet,kitchen_island"},
-    {"s__1146", "kitchen_cabinet,dishwasher"},
-    {"s__1147",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"s__1148", "kitchen_cabinet,kitchen_sink"},
-    {"s__1149", "chair,straight_chair"},
-    {"s__1150", "hanging_kitchen_cabinet"},
-    {"s__1151", "hanging_kitchen_cabinet"},
-    {"s__1152", "indoor_lamp,chandelier"},
-    {"s__1153", "indoor_lamp,chandelier"},
-    {"s__1154", "indoor_lamp,chandelier"},
-    {"s__1155", "indoor_lamp,wall_lamp"},
-    {"s__1156",
-     "kitchen_cabinet,short_kitchen_cabinet_with_hanging_kitchen_cabinet"},
-    {"s__1157", "kitchen_cabinet,kitchen_cabinet_with_refrigerator"},
-    {"s__1158", "dresser"},
-    {"s__1159", "table,coffee_table"},
-    {"s__1160", "indoor_lamp,wall_lamp"},
-    {"s__1161", "table,dining_table"},
-    {"s__1162", "dresser"},
-    {"s__1163", "chair"},
-    {"s__1164", "chair,armchair"},
-    {"s__1165", "mirror"},
-    {"s__1166", "chair,armchair"},
-    {"s__1167", "table,coffee_table"},
-    {"s__1168", "mirror"},
-    {"s__1169", "table,coffee_table"},
-    {"s__1170", "table,dining_table"},
-    {"s__1171", "sofa"},
-    {"s__1172", "chair,armchair,sofa_chair"},
-    {"s__1173", "chair"},
-    {"s__1174", "indoor_lamp,floor_lamp"},
-    {"s__1175", "chair"},
-    {"s__1176", "chair,armchair"},
-    {"s__1177", "sofa"},
-    {"s__1178", "indoor_lamp,chandelier"},
-    {"s__1179", "table,dining_table"},
-    {"s__1180", "table,coffee_table"},
-    {"s__1183", "wardrobe_cabinet"},
-    {"s__1184", "wardrobe_cabinet"},
-    {"s__1185", "shelving,bookshelf"},
-    {"s__1186", "wardrobe_cabinet"},
-    {"s__1187", "shelving,bookshelf"},
-    {"s__1188", "wardrobe_cabinet"},
-    {"s__1189", "wardrobe_cabinet"},
-    {"s__1190", "wardrobe_cabinet"},
-    {"s__1192", "wardrobe_cabinet"},
-    {"s__1193", "wardrobe_cabinet"},
-    {"s__1195", "wardrobe_cabinet"},
-    {"s__1196", "wardrobe_cabinet"},
-    {"s__1197", "shelving,bookshelf"},
-    {"s__1198", "wardrobe_cabinet"},
-    {"s__1199", "shelving,bookshelf"},
-    {"s__1200", "shelving,bookshelf"},
-    {"s__1201", "workplace,desk"},
-    {"s__1202", "shelving,bookshelf"},
-    {"s__1203", "shelving,bookshelf"},
-    {"s__1204", "shelving,bookshelf"},
-    {"s__1205", "shelving,bookshelf"},
-    {"s__1206", "wardrobe_cabinet"},
-    {"s__1207", "wardrobe_cabinet"},
-    {"s__1208", "shelving,bookshelf"},
-    {"s__1209", "shelving,bookshelf"},
-    {"s__1210", "shelving,bookshelf"},
-    {"s__1211", "shelving,wall_shelf"},
-    {"s__1212", "shelving,bookshelf"},
-    {"s__1213", "shelving,bookshelf"},
-    {"s__1214", "wardrobe_cabinet"},
-    {"s__1215", "wardrobe_cabinet"},
-    {"s__1216", "wardrobe_cabinet"},
-    {"s__1217", "wardrobe_cabinet"},
-    {"s__1218", "wardrobe_cabinet"},
-    {"s__1219", "wardrobe_cabinet"},
-    {"s__1220", "wardrobe_cabinet"},
-    {"s__1221", "wardrobe_cabinet"},
-    {"s__1222", "desk"},
-    {"s__1223", "shelving,wall_shelf"},
-    {"s__1224", "shelving,wall_shelf"},
-    {"s__1225", "desk"},
-    {"s__1226", "shelving,wall_shelf"},
-    {"s__1227", "shelving,bookshelf"},
-    {"s__1228", "shelving,bookshelf"},
-    {"s__1230", "wardrobe_cabinet"},
-    {"s__1231", "wardrobe_cabinet"},
-    {"s__1232", "wardrobe_cabinet"},
-    {"s__1234", "wardrobe_cabinet"},
-    {"s__1235", "wardrobe_cabinet"},
-    {"s__1237", "wardrobe_cabinet"},
-    {"s__1239", "shelving,bookshelf"},
-    {"s__1240", "shelving,bookshelf"},
-    {"s__1241", "wardrobe_cabinet"},
-    {"s__1242", "stand,nightstand"},
-    {"s__1243", "dressing_table"},
-    {"s__1244", "wardrobe_cabinet"},
-    {"s__1245", "wardrobe_cabinet"},
-    {"s__1246", "bed,double_bed"},
-    {"s__1247", "bed,double_bed"},
-    {"s__1248", "bathtub"},
-    {"s__1249", "sink"},
-    {"s__1250", "toilet"},
-    {"s__1251", "toilet,bidet"},
-    {"s__1252", "shower"},
-    {"s__1253", "wardrobe_cabinet"},
-    {"s__1254", "chair,straight_chair"},
-    {"s__1255", "indoor_lamp,chandelier"},
-    {"s__1256", "indoor_lamp,wall_lamp"},
-    {"s__1257", "indoor_lamp,wall_lamp"},
-    {"s__1258", "workplace,desk_with_shelves"},
-    {"s__1259", "workplace,desk_with_shelves"},
-    {"s__1260", "workplace,desk_with_shelves"},
-    {"s__1261", "workplace,desk_with_shelves"},
-    {"s__1262", "workplace,desk_with_shelves"},
-    {"s__1265", "workplace,desk_with_shelves"},
-    {"s__1268", "indoor_lamp,wall_lamp"},
-    {"s__1269", "mirror"},
-    {"s__1270", "sink"},
-    {"s__1271", "indoor_lamp,wall_lamp"},
-    {"s__1272", "mirror"},
-    {"s__1273", "sink"},
-    {"s__1274", "indoor_lamp,wall_lamp"},
-    {"s__1275", "mirror"},
-    {"s__1276", "mirror"},
-    {"s__1277", "sink"},
-    {"s__1278", "indoor_lamp,wall_lamp"},
-    {"s__1279", "sink"},
-    {"s__1280", "indoor_lamp,wall_lamp"},
-    {"s__1281", "dresser"},
-    {"s__1282", "indoor_lamp,wall_lamp"},
-    {"s__1283", "sink"},
-    {"s__1284", "bathtub"},
-    {"s__1285", "shower"},
-    {"s__1286", "sofa"},
-    {"s__1287", "table,coffee_table"},
-    {"s__1288", "chair,armchair,sofa_chair"},
-    {"s__1289", "ottoman"},
-    {"s__1290", "sofa"},
-    {"s__1291", "vase"},
-    {"s__1292", "indoor_lamp,chandelier"},
-    {"s__1293", "mirror"},
-    {"s__1294", "dresser"},
-    {"s__1295", "table,dining_table"},
-    {"s__1296", "indoor_lamp,floor_lamp"},
-    {"s__1297", "indoor_lamp,table_lamp"},
-    {"s__1298", "table,coffee_table"},
-    {"s__1299", "wardrobe_cabinet"},
-    {"s__1300", "shelving"},
-    {"s__1301", "vase"},
-    {"s__1302", "bed,double_bed"},
-    {"s__1303", "chair,armchair,sofa_chair"},
-    {"s__1304", "desk"},
-    {"s__1305", "chair,straight_chair"},
-    {"s__1306", "indoor_lamp,table_lamp"},
-    {"s__1307", "stand,nightstand"},
-    {"s__1308", "ottoman"},
-    {"s__1309", "fireplace_tools"},
-    {"s__1310", "indoor_lamp,wall_lamp"},
-    {"s__1311", "indoor_lamp,table_lamp"},
-    {"s__1312", "mirror"},
-    {"s__1313", "fireplace"},
-    {"s__1314", "chair,stool"},
-    {"s__1315", "stand"},
-    {"s__1316", "table,coffee_table"},
-    {"s__1317", "table,coffee_table"},
-    {"s__1318", "indoor_lamp,table_lamp"},
-    {"s__1319", "bathtub"},
-    {"s__1320", "sink"},
-    {"s__1321", "bathroom_stuff,toilet_paper"},
-    {"s__1322", "shower"},
-    {"s__1323", "sink"},
-    {"s__1324", "ottoman"},
-    {"s__1325", "indoor_lamp,wall_lamp"},
-    {"s__1326", "bathroom_stuff,towel_hanger"},
-    {"s__1327", "bathroom_stuff,towel_hanger"},
-    {"s__1328", "mirror"},
-    {"s__1329", "indoor_lamp,wall_lamp"},
-    {"s__1330", "sofa"},
-    {"s__1331", "ottoman"},
-    {"s__1332", "table,coffee_table"},
-    {"s__1333", "indoor_lamp,chandelier"},
-    {"s__1334", "chair"},
-    {"s__1335", "plant"},
-    {"s__1336", "tv_stand"},
-    {"s__1337", "chair,armchair"},
-    {"s__1338", "desk"},
-    {"s__1339", "mirror"},
-    {"s__1340", "chair,armchair,sofa_chair"},
-    {"s__1341", "indoor_lamp,table_lamp"},
-    {"s__1342", "indoor_lamp,table_lamp"},
-    {"s__1343", "toy"},
-    {"s__1344", "toy,tricycle"},
-    {"s__1345", "toy"},
-    {"s__1346", "toy"},
-    {"s__1347", "toy"},
-    {"s__1348", "toy"},
-    {"s__1349", "toy"},
-    {"s__1350", "toy"},
-    {"s__1351", "toy"},
-    {"s__1352", "toy"},
-    {"s__1353", "desk"},
-    {"s__1354", "desk"},
-    {"s__1355", "wardrobe_cabinet"},
-    {"s__1356", "wardrobe_cabinet"},
-    {"s__1357", "wardrobe_cabinet"},
-    {"s__1358", "wardrobe_cabinet"},
-    {"s__1359", "wardrobe_cabinet"},
-    {"s__1360", "wardrobe_cabinet"},
-    {"s__1361", "wardrobe_cabinet"},
-    {"s__1362", "shelving"},
-    {"s__1363", "desk"},
-    {"s__1364", "desk"},
-    {"s__1365", "desk"},
-    {"s__1366", "desk"},
-    {"s__1367", "desk"},
-    {"s__1368", "desk"},
-    {"s__1369", "wardrobe_cabinet"},
-    {"s__1370", "stand"},
-    {"s__1371", "wardrobe_cabinet"},
-    {"s__1372", "desk"},
-    {"s__1374", "desk"},
-    {"s__1377", "desk"},
-    {"s__1378", "wardrobe_cabinet"},
-    {"s__1379", "wardrobe_cabinet"},
-    {"s__1382", "wardrobe_cabinet"},
-    {"s__1384", "stand"},
-    {"s__1392", "desk"},
-    {"s__1393", "desk"},
-    {"s__1394", "desk"},
-    {"s__1396", "table"},
-    {"s__1398", "wardrobe_cabinet"},
-    {"s__1399", "wardrobe_cabinet"},
-    {"s__1400", "shelving,bookshelf"},
-    {"s__1401", "shelving,bookshelf"},
-    {"s__1402", "shelving,bookshelf"},
-    {"s__1403", "shelving,bookshelf"},
-    {"s__1404", "wardrobe_cabinet"},
-    {"s__1405", "wardrobe_cabinet"},
-    {"s__1406", "wardrobe_cabinet"},
-    {"s__1407", "wardrobe_cabinet"},
-    {"s__1408", "wardrobe_cabinet"},
-    {"s__1410", "shelving"},
-    {"s__1411", "shelving"},
-    {"s__1412", "shelving"},
-    {"s__1413", "wardrobe_cabinet"},
-    {"s__1414", "wardrobe_cabinet"},
-    {"s__1415", "stand"},
-    {"s__1416", "stand"},
-    {"s__1418", "desk"},
-    {"s__1419", "desk"},
-    {"s__1422", "desk"},
-    {"s__1423", "desk"},
-    {"s__1426", "desk"},
-    {"s__1427", "desk"},
-    {"s__1428", "desk"},
-    {"s__1429", "desk"},
-    {"s__1431", "table"},
-    {"s__1432", "table"},
-    {"s__1433", "table"},
-    {"s__1434", "toy"},
-    {"s__1435", "shelving"},
-    {"s__1438", "table"},
-    {"s__1439", "table"},
-    {"s__1443", "stand"},
-    {"s__1445", "shelving,bookshelf"},
-    {"s__1446", "wardrobe_cabinet"},
-    {"s__1448", "shelving,bookshelf"},
-    {"s__1452", "desk"},
-    {"s__1461", "desk"},
-    {"s__1462", "toy"},
-    {"s__1465", "wardrobe_cabinet"},
-    {"s__1467", "wardrobe_cabinet"},
-    {"s__1473", "desk"},
-    {"s__1474", "desk"},
-    {"s__1476", "desk"},
-    {"s__1486", "stand"},
-    {"s__1487", "desk"},
-    {"s__1490", "mirror"},
-    {"s__1491", "mirror"},
-    {"s__1492", "hanger"},
-    {"s__1493", "stand,nightstand"},
-    {"s__1494", "stand,nightstand"},
-    {"s__1495", "desk"},
-    {"s__1496", "desk"},
-    {"s__1497", "wardrobe_cabinet"},
-    {"s__1498", "wardrobe_cabinet"},
-    {"s__1499", "desk"},
-    {"s__1500", "wood_board"},
-    {"s__1501", "bed,double_bed"},
-    {"s__1502", "bed,double_bed"},
-    {"s__1503", "bed,single_bed"},
-    {"s__1504", "chair,office_chair"},
-    {"s__1505", "chair,straight_chair"},
-    {"s__1506", "chair,straight_chair"},
-    {"s__1507", "chair,office_chair"},
-    {"s__1508", "chair,office_chair"},
-    {"s__1509", "wardrobe_cabinet"},
-    {"s__1510", "desk"},
-    {"s__1511", "wardrobe_cabinet"},
-    {"s__1512", "wardrobe_cabinet"},
-    {"s__1513", "wardrobe_cabinet"},
-    {"s__1514", "shelving,bookshelf"},
-    {"s__1515", "stand"},
-    {"s__1516", "desk"},
-    {"s__1517", "tv_stand"},
-    {"s__1518", "desk"},
-    {"s__1519", "chair,office_chair"},
-    {"s__1520", "chair,office_chair"},
-    {"s__1521", "chair,office_chair"},
-    {"s__1522", "chair,office_chair"},
-    {"s__1523", "chair,office_chair"},
-    {"s__1524", "chair,office_chair"},
-    {"s__1525", "chair,office_chair"},
-    {"s__1526", "chair,office_chair"},
-    {"s__1527", "chair,office_chair"},
-    {"s__1528", "chair,office_chair"},
-    {"s__1529", "chair,office_chair"},
-    {"s__1531", "chair,office_chair"},
-    {"s__1532", "chair,office_chair"},
-    {"s__1533", "chair,office_chair"},
-    {"s__1534", "chair,office_chair"},
-    {"s__1535", "chair,office_chair"},
-    {"s__1536", "chair,office_chair"},
-    {"s__1537", "chair,office_chair"},
-    {"s__1539", "chair,office_chair"},
-    {"s__1540", "toy"},
-    {"s__1541", "plant"},
-    {"s__1542", "outdoor_lamp"},
-    {"s__1543", "plant"},
-    {"s__1544", "mirror"},
-    {"s__1545", "grill"},
-    {"s__1546", "table,coffee_table"},
-    {"s__1547", "bench_chair"},
-    {"s__1548", "kitchen_cabinet,kitchen_sink_with_dishwasher"},
-    {"s__1549", "clock"},
-    {"s__1550", "chair,armchair"},
-    {"s__1551", "stand"},
-    {"s__1552", "sink"},
-    {"s__1553", "bathtub"},
-    {"s__1554", "trash_can"},
-    {"s__1555", "shower"},
-    {"s__1556", "mirror"},
-    {"s__1557", "indoor_lamp,chandelier"},
-    {"s__1558", "indoor_lamp,wall_lamp"},
-    {"s__1559", "mirror"},
-    {"s__1560", "toy"},
-    {"s__1561", "ottoman"},
-    {"s__1562", "bed,double_bed"},
-    {"s__1563", "pet,dog"},
-    {"s__1631", "pet,dog"},
-    {"s__1632", "pet,dog"},
-    {"s__1633", "pet,turtle"},
-    {"s__1634", "pet,bird"},
-    {"s__1635", "pet,cat"},
-    {"s__1636", "pet,dog"},
-    {"s__1637", "pet,pig"},
-    {"s__1638", "pet,cat"},
-    {"s__1639", "toy,fishbowl"},
-    {"s__1640", "pet,bird"},
-    {"s__1641", "clock"},
-    {"s__1642", "clock"},
-    {"s__1643", "clock"},
-    {"s__1644", "toy"},
-    {"s__1645", "household_appliance,gramophone"},
-    {"s__1646", "toy"},
-    {"s__1647", "rug"},
-    {"s__1648", "household_appliance,telephone"},
-    {"s__1649", "household_appliance,rifle_on_wall"},
-    {"s__1650", "pillow"},
-    {"s__1651", "pillow"},
-    {"s__1652", "pillow"},
-    {"s__1653", "pillow"},
-    {"s__1654", "pillow"},
-    {"s__1655", "toy"},
-    {"s__1656", "toy"},
-    {"s__1657", "toy"},
-    {"s__1658", "toy"},
-    {"s__1659", "toy"},
-    {"s__1660", "kitchenware,cup,food"},
-    {"s__1661", "toy"},
-    {"s__1662", "toy"},
-    {"s__1663", "toy"},
-    {"s__1664", "dresser"},
-    {"s__1665", "chair,armchair,sofa_chair"},
-    {"s__1666", "chair,armchair"},
-    {"s__1667", "table,dining_table"},
-    {"s__1668", "chair,armchair"},
-    {"s__1669", "table,coffee_table"},
-    {"s__1670", "fireplace"},
-    {"s__1671", "dresser"},
-    {"s__1672", "sofa"},
-    {"s__1673", "ottoman"},
-    {"s__1674", "sofa"},
-    {"s__1675", "indoor_lamp,floor_lamp"},
-    {"s__1676", "indoor_lamp,chandelier"},
-    {"s__1677", "indoor_lamp,table_lamp"},
-    {"s__1678", "indoor_lamp,table_lamp"},
-    {"s__1679", "chair,armchair"},
-    {"s__1680", "toilet"},
-    {"s__1681", "toilet"},
-    {"s__1682", "toilet"},
-    {"s__1683", "stand"},
-    {"s__1684", "toilet"},
-    {"s__1685", "sink"},
-    {"s__1686", "sink"},
-    {"s__1687", "mirror"},
-    {"s__1688", "mirror"},
-    {"s__1689", "sink"},
-    {"s__1690", "sink"},
-    {"s__1691", "sink"},
-    {"s__1692", "sink"},
-    {"s__1693", "bathtub"},
-    {"s__1694", "bathtub"},
-    {"s__1695", "bathtub"},
-    {"s__1696", "bathtub"},
-    {"s__1697", "bathtub"},
-    {"s__1698", "indoor_lamp,table_lamp"},
-    {"s__1699", "indoor_lamp,chandelier"},
-    {"s__1700", "chair,armchair"},
-    {"s__1701", "chair"},
-    {"s__1702", "table,dining_table"},
-    {"s__1703", "indoor_lamp,chandelier"},
-    {"s__1704", "bed,double_bed"},
-    {"s__1705", "chair,stool"},
-    {"s__1706", "wardrobe_cabinet"},
-    {"s__1707", "indoor_lamp,chandelier"},
-    {"s__1708", "indoor_lamp,chandelier"},
-    {"s__1709", "indoor_lamp,floor_lamp"},
-    {"s__1710", "chair,armchair"},
-    {"s__1711", "chair"},
-    {"s__1712", "chair"},
-    {"s__1713", "dresser"},
-    {"s__1714", "bed,double_bed"},
-    {"s__1715", "chair"},
-    {"s__1716", "table,dining_table"},
-    {"s__1717", "chair"},
-    {"s__1718", "table,dining_table"},
-    {"s__1719", "indoor_lamp,floor_lamp"},
-    {"s__1720", "table,coffee_table"},
-    {"s__1721", "indoor_lamp,table_lamp"},
-    {"s__1722", "vehicle,car"},
-    {"s__1723", "vehicle,car"},
-    {"s__1724", "vehicle,car"},
-    {"s__1725", "vehicle,car"},
-    {"s__1726", "desk"},
-    {"s__1727", "desk"},
-    {"s__1728", "stand"},
-    {"s__1730", "desk"},
-    {"s__1732", "dresser"},
-    {"s__1735", "desk"},
-    {"s__1736", "stand"},
-    {"s__1737", "desk"},
-    {"s__1738", "counter"},
-    {"s__1739", "desk"},
-    {"s__1741", "table,dining_table"},
-    {"s__1742", "desk"},
-    {"s__1743", "wardrobe_cabinet"},
-    {"s__1744", "wardrobe_cabinet"},
-    {"s__1745", "wardrobe_cabinet"},
-    {"s__1746", "chair,office_chair"},
-    {"s__1747", "chair,office_chair"},
-    {"s__1748", "chair,straight_chair"},
-    {"s__1749", "chair,armchair,sofa_chair"},
-    {"s__1750", "sofa"},
-    {"s__1751", "sofa"},
-    {"s__1752", "vehicle,bicycle"},
-    {"s__1753", "vehicle,bicycle"},
-    {"s__1760", "storage_bench"},
-    {"s__1761", "chair,stool"},
-    {"s__1762", "door"},
-    {"s__1762_0", "door"},
-    {"s__1762_2", "door"},
-    {"s__1763", "door"},
-    {"s__1763_0", "door"},
-    {"s__1763_2", "door"},
-    {"s__1764", "door"},
-    {"s__1764_0", "door"},
-    {"s__1764_2", "door"},
-    {"s__1765", "door"},
-    {"s__1765_0", "door"},
-    {"s__1765_2", "door"},
-    {"s__1766", "door"},
-    {"s__1766_0", "door"},
-    {"s__1766_2", "door"},
-    {"s__1767", "door"},
-    {"s__1767_0", "door"},
-    {"s__1767_2", "door"},
-    {"s__1768", "door"},
-    {"s__1768_0", "door"},
-    {"s__1768_2", "door"},
-    {"s__1769", "door"},
-    {"s__1769_0", "door"},
-    {"s__1769_2", "door"},
-    {"s__1770", "door"},
-    {"s__1770_0", "door"},
-    {"s__1770_2", "door"},
-    {"s__1771", "door"},
-    {"s__1771_0", "door"},
-    {"s__1771_2", "door"},
-    {"s__1772", "door"},
-    {"s__1772_0", "door"},
-    {"s__1772_2", "door"},
-    {"s__1773", "door"},
-    {"s__1773_0", "door"},
-    {"s__1773_2", "door"},
-    {"s__1774", "bed,double_bed"},
-    {"s__1775", "bed,double_bed"},
-    {"s__1776", "bed,double_bed"},
-    {"s__1777", "bed,double_bed"},
-    {"s__1778", "wardrobe_cabinet"},
-    {"s__1779", "person"},
-    {"s__1780", "person"},
-    {"s__1781", "person"},
-    {"s__1782", "person"},
-    {"s__1783", "person"},
-    {"s__1784", "person"},
-    {"s__1785", "person"},
-    {"s__1786", "person"},
-    {"s__1787", "person"},
-    {"s__1788", "person"},
-    {"s__1789", "stand"},
-    {"s__1790", "wardrobe_cabinet"},
-    {"s__1791", "bed,double_bed"},
-    {"s__1792", "bed,double_bed"},
-    {"s__1793", "vase"},
-    {"s__1794", "vase"},
-    {"s__1795", "vase"},
-    {"s__1796", "vase"},
-    {"s__1797", "vase"},
-    {"s__1798", "vase"},
-    {"s__1799", "vase"},
-    {"s__1800", "vase"},
-    {"s__1801", "vase"},
-    {"s__1802", "vase"},
-    {"s__1803", "vase"},
-    {"s__1804", "vase"},
-    {"s__1805", "vase"},
-    {"s__1806", "vase"},
-    {"s__1807", "vase"},
-    {"s__1808", "vase"},
-    {"s__1809", "vase"},
-    {"s__1810", "vase"},
-    {"s__1811", "vase"},
-    {"s__1812", "vase"},
-    {"s__1813", "magazines"},
-    {"s__1814", "household_appliance,cellphone"},
-    {"s__1815", "household_appliance,camera"},
-    {"s__1816", "household_appliance,ipad"},
-    {"s__1817", "tripod"},
-    {"s__1818", "toy"},
-    {"s__1819", "household_appliance,telephone"},
-    {"s__1820", "household_appliance,stationary_container"},
-    {"s__1821", "household_appliance,headphones_on_stand"},
-    {"s__1822", "household_appliance,helmet"},
-    {"s__1823", "shoes"},
-    {"s__1824", "kitchenware,cup,drink"},
-    {"s__1825", "kitchenware,food_tray,food,drink"},
-    {"s__1826", "kitchenware,jug,drink"},
-    {"s__1827", "kitchenware,containers"},
-    {"s__1828", "kitchenware,utensil_holder"},
-    {"s__1829", "kitchenware,spoon"},
-    {"s__1830", "kitchenware,knife"},
-    {"s__1831", "kitchenware,fork"},
-    {"s__1832", "kitchenware,teapot"},
-    {"s__1833", "kitchenware,cup"},
-    {"s__1834", "kitchenware,jug"},
-    {"s__1835", "kitchenware,container"},
-    {"s__1836", "kitchenware,fruit_bowl,food"},
-    {"s__1837", "table,coffee_table"},
-    {"s__1838", "indoor_lamp,table_lamp"},
-    {"s__1839", "indoor_lamp,chandelier"},
-    {"s__1840", "indoor_lamp,table_lamp"},
-    {"s__1841", "indoor_lamp,chandelier"},
-    {"s__1842", "bed,double_bed"},
-    {"s__1843", "bed,double_bed"},
-    {"s__1844", "kitchenware,bread,food"},
-    {"s__1845", "trinket"},
-    {"s__1846", "trinket"},
-    {"s__1847", "trinket"},
-    {"s__1848", "trinket"},
-    {"s__1849", "kitchenware,mortar_and_pestle"},
-    {"s__1850", "kitchenware,food"},
-    {"s__1851", "kitchenware,place_setting"},
-    {"s__1852", "trinket"},
-    {"s__1853", "trinket"},
-    {"s__1854", "chair,armchair,sofa_chair"},
-    {"s__1855", "trinket"},
-    {"s__1856", "trinket"},
-    {"s__1857", "trinket"},
-    {"s__1858", "toy"},
-    {"s__1859", "toy"},
-    {"s__1860", "candle"},
-    {"s__1861", "candle"},
-    {"s__1862", "candle"},
-    {"s__1863", "candle"},
-    {"s__1864", "candle"},
-    {"s__1865", "trinket"},
-    {"s__1866", "trinket"},
-    {"s__1867", "toy"},
-    {"s__1868", "toy"},
-    {"s__1869", "toy"},
-    {"s__1870", "toy"},
-    {"s__1871", "table,dining_table"},
-    {"s__1872", "table,coffee_table"},
-    {"s__1873", "bench_chair"},
-    {"s__1874", "table,dining_table"},
-    {"s__1875", "mirror"},
-    {"s__1876", "chair,armchair,sofa_chair"},
-    {"s__1877", "chair,straight_chair"},
-    {"s__1878", "indoor_lamp,floor_lamp"},
-    {"s__1879", "sofa"},
-    {"s__1880", "indoor_lamp,table_lamp"},
-    {"s__1881", "indoor_lamp,chandelier"},
-    {"s__1882", "sofa"},
-    {"s__1883", "indoor_lamp,chandelier"},
-    {"s__1884", "dresser"},
-    {"s__1885", "chair,armchair"},
-    {"s__1886", "chair"},
-    {"s__1887", "ottoman"},
-    {"s__1888", "table,coffee_table"},
-    {"s__1889", "tv_stand"},
-    {"s__1890", "hanger"},
-    {"s__1891", "hanger"},
-    {"s__1892", "table,coffee_table"},
-    {"s__1893", "table,dining_table"},
-    {"s__1894", "table,coffee_table"},
-    {"s__1895", "curtain"},
-    {"s__1895_0", "curtain"},
-    {"s__1896", "curtain"},
-    {"s__1896_0", "curtain"},
-    {"s__1897", "curtain"},
-    {"s__1897_0", "curtain"},
-    {"s__1898", "curtain"},
-    {"s__1898_0", "curtain"},
-    {"s__1899", "curtain"},
-    {"s__1899_0", "curtain"},
-    {"s__1900", "curtain"},
-    {"s__1900_0", "curtain"},
-    {"s__1901", "curtain"},
-    {"s__1902", "curtain"},
-    {"s__1902_0", "curtain"},
-    {"s__1903", "curtain"},
-    {"s__1903_0", "curtain"},
-    {"s__1904", "vehicle,motorcycle"},
-    {"s__1905", "chair,armchair"},
-    {"s__1906", "chair"},
-    {"s__1907", "table"},
-    {"s__1908", "bench_chair"},
-    {"s__1909", "chair"},
-    {"s__1910", "fireplace"},
-    {"s__1911", "outdoor_spring"},
-    {"s__1912", "table"},
-    {"s__1913", "outdoor_lamp"},
-    {"s__1914", "indoor_lamp,chandelier"},
-    {"s__1915", "bench_chair"},
-    {"s__1916", "table,coffee_table"},
-    {"s__1917", "outdoor_lamp"},
-    {"s__1918", "ottoman"},
-    {"s__1919", "table"},
-    {"s__1920", "bench_chair"},
-    {"s__1921", "indoor_lamp,chandelier"},
-    {"s__1922", "partition"},
-    {"s__1923", "wood_board"},
-    {"s__1924", "shelving,wall_shelf"},
-    {"s__1925", "stand"},
-    {"s__1926", "bench_chair"},
-    {"s__1927", "chair,armchair"},
-    {"s__1928", "table,dining_table"},
-    {"s__1929", "table,dining_table"},
-    {"s__1930", "hanger"},
-    {"s__1931", "chair,straight_chair"},
-    {"s__1932", "chair,armchair"},
-    {"s__1933", "candle"},
-    {"s__1934", "kitchen_cabinet,kitchen_sink"},
-    {"s__1935", "indoor_lamp,chandelier"},
-    {"s__1936", "household_appliance,ladder"},
-    {"s__1937", "mirror"},
-    {"s__1938", "ottoman"},
-    {"s__1939", "bathtub"},
-    {"s__1940", "desk"},
-    {"s__1941", "stand"},
-    {"s__1942", "sink"},
-    {"s__1943", "sink"},
-    {"s__1944", "indoor_lamp,wall_lamp"},
-    {"s__1945", "indoor_lamp,wall_lamp"},
-    {"s__1946", "sink"},
-    {"s__1947", "shower,shower_faucet"},
-    {"s__1948", "shower,shower_ceiling"},
-    {"s__1949", "cloth"},
-    {"s__1950", "drinkbar"},
-    {"s__1951", "counter"},
-    {"s__1952", "counter"},
-    {"s__1953", "counter"},
-    {"s__1954", "recreation,game_table"},
-    {"s__1955", "recreation,game_table"},
-    {"s__1956", "household_appliance,slot_machine"},
-    {"s__1957", "person"},
-    {"s__1958", "person"},
-    {"s__1959", "person"},
-    {"s__1960", "person"},
-    {"s__1961", "person"},
-    {"s__1962", "person"},
-    {"s__1963", "toy"},
-    {"s__1964", "toy,poker_chips"},
-    {"s__1965", "household_appliance,slot_machine_and_chair"},
-    {"s__1966", "kitchen_appliance,kettle"},
-    {"s__1967", "kitchen_appliance,cooker"},
-    {"s__1968", "kitchen_appliance,food_processor"},
-    {"s__1969", "kitchen_appliance,toaster"},
-    {"s__1970", "kitchen_appliance,food_processor"},
-    {"s__1971", "kitchen_appliance,coffee_machine"},
-    {"s__1972", "kitchen_appliance,food_processor"},
-    {"s__1973", "kitchen_appliance,refrigerator"},
-    {"s__1974", "fireplace"},
-    {"s__1975", "stand"},
-    {"s__1976", "bed,double_bed"},
-    {"s__1977", "indoor_lamp,chandelier"},
-    {"s__1978", "mirror"},
-    {"s__1979", "ottoman"},
-    {"s__1980", "table,coffee_table"},
-    {"s__1981", "stand"},
-    {"s__1982", "table,coffee_table"},
-    {"s__1983", "indoor_lamp,table_lamp"},
-    {"s__1984", "tv_stand"},
-    {"s__1985", "chair,armchair,sofa_chair"},
-    {"s__1986", "tv_stand"},
-    {"s__1987", "table,dining_table"},
-    {"s__1988", "table,coffee_table"},
-    {"s__1989", "table,coffee_table"},
-    {"s__1990", "chair"},
-    {"s__1991", "sofa"},
-    {"s__1992", "table,coffee_table"},
-    {"s__1993", "sofa"},
-    {"s__1994", "candle"},
-    {"s__1995", "indoor_lamp,chandelier"},
-    {"s__1996", "bed,single_bed"},
-    {"s__1997", "stand,nightstand"},
-    {"s__1998", "ottoman"},
-    {"s__1999", "ottoman"},
-    {"s__2000", "ottoman"},
-    {"s__2001", "bed,single_bed"},
-    {"s__2002", "bed,double_bed"},
-    {"s__2003", "chair,lounge_chair"},
-    {"s__2004", "chair,straight_chair"},
-    {"s__2005", "desk"},
-    {"s__2006", "stand"},
-    {"s__2007", "mirror"},
-    {"s__2008", "indoor_lamp,table_lamp"},
-    {"s__2009", "indoor_lamp,table_lamp"},
-    {"s__2010", "window"},
-    {"s__2011", "window"},
-    {"s__2012", "window"},
-    {"s__2013", "window"},
-    {"s__2014", "window"},
-    {"s__2015", "window"},
-    {"s__2016", "window"},
-    {"s__2017", "window"},
-    {"s__2019", "window"},
-    {"s__2020", "stand,nightstand"},
-    {"s__2021", "dresser"},
-    {"s__2022", "shelving,bookshelf"},
-    {"s__2023", "table,coffee_table"},
-    {"s__2024", "indoor_lamp,wall_lamp"},
-    {"s__2025", "mirror"},
-    {"s__2026", "candle"},
-    {"s__2027", "table,coffee_table"},
-    {"s__2028", "indoor_lamp,table_lamp"},
-    {"s__2029", "picture_frame"},
-    {"s__2030", "chair,armchair"},
-    {"s__2031", "music,drumset"},
-    {"s__2032", "music,guitar"},
-    {"s__2033", "music,amplifier"},
-    {"s__2034", "music,keyboard"},
-    {"s__2035", "music,microphone"},
-    {"s__2036", "music,accordion"},
-    {"s__2037", "music,theremin"},
-    {"s__2038", "bed,double_bed"},
-    {"s__2039", "stand"},
-    {"s__2040", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__2041", "curtain"},
-    {"s__2042", "dresser"},
-    {"s__2043", "wardrobe_cabinet"},
-    {"s__2044", "wardrobe_cabinet"},
-    {"s__2045", "dressing_table"},
-    {"s__2046", "table,dining_table"},
-    {"s__2047", "stand,nightstand"},
-    {"s__2048", "bed,double_bed"},
-    {"s__2049", "chair,straight_chair"},
-    {"s__2050", "hanger"},
-    {"s__2051", "stand,nightstand"},
-    {"s__2052", "wardrobe_cabinet"},
-    {"s__2053", "dresser"},
-    {"s__2054", "wardrobe_cabinet"},
-    {"s__2055", "bed,double_bed"},
-    {"s__2056", "wardrobe_cabinet"},
-    {"s__2057", "wardrobe_cabinet"},
-    {"s__2058", "dresser"},
-    {"s__2059", "chair,armchair,sofa_chair"},
-    {"s__2060", "sofa"},
-    {"s__2061", "chair,armchair,sofa_chair"},
-    {"s__2062", "chair,armchair,sofa_chair"},
-    {"s__2083", "toy"},
-    {"s__2084", "toy"},
-    {"s__2085", "toy"},
-    {"s__2086", "toy"},
-    {"s__2087", "toy"},
-    {"s__2088", "toy"},
-    {"s__2089", "bed,double_bed"},
-    {"s__2090", "dresser"},
-    {"s__2091", "dresser"},
-    {"s__2092", "wardrobe_cabinet"},
-    {"s__2093", "shelving,bookshelf"},
-    {"s__2094", "shelving,bookshelf"},
-    {"s__2095", "tv_stand"},
-    {"s__2096", "tv_stand"},
-    {"s__2097", "stand,nightstand"},
-    {"s__2098", "stand,nightstand"},
-    {"s__2099", "stand,nightstand"},
-    {"s__2100", "stand,nightstand"},
-    {"s__2101", "stand"},
-    {"s__2103", "wardrobe_cabinet"},
-    {"s__2104", "tv_stand"},
-    {"s__2105", "wardrobe_cabinet"},
-    {"s__2106", "tv_stand"},
-    {"s__2107", "tv_stand"},
-    {"s__2108", "shelving,wall_shelf"},
-    {"s__2109", "shelving,wall_shelf"},
-    {"s__2110", "table,coffee_table"},
-    {"s__2111", "stand"},
-    {"s__2112", "tv_stand"},
-    {"s__2113", "desk"},
-    {"s__2114", "workplace,desk"},
-    {"s__2115", "desk"},
-    {"s__2116", "desk"},
-    {"s__2117", "desk"},
-    {"s__2118", "desk"},
-    {"s__2119", "desk"},
-    {"s__2120", "table,coffee_table"},
-    {"s__2121", "table,coffee_table"},
-    {"s__2122", "tv_stand"},
-    {"s__2123", "workplace,desk"},
-    {"s__2124", "tv_stand"},
-    {"s__2125", "workplace,desk_with_shelves"},
-    {"s__2126", "shelving"},
-    {"s__2127", "tv_stand"},
-    {"s__2129", "tv_stand"},
-    {"s__2130", "shelving"},
-    {"s__2131", "shelving"},
-    {"s__2132", "bed,double_bed"},
-    {"s__2133", "workplace,desk"},
-    {"s__2134", "workplace,desk_with_shelves"},
-    {"s__2135", "workplace,desk_with_shelves"},
-    {"s__2136", "workplace,desk_with_shelves"},
-    {"s__2137", "workplace,desk_with_shelves"},
-    {"s__2138", "workplace,desk_with_shelves"},
-    {"s__2139", "workplace,desk"},
-    {"s__2140", "workplace,desk"},
-    {"s__2141", "workplace,desk_with_shelves"},
-    {"s__2142", "shelving"},
-    {"s__2143", "workplace,desk_with_shelves"},
-    {"s__2144", "workplace,desk_with_shelves"},
-    {"s__2145", "desk"},
-    {"s__2146", "shelving"},
-    {"s__2147", "workplace,desk_with_shelves"},
-    {"s__2148", "workplace,desk"},
-    {"s__2149", "workplace,desk_with_shelves"},
-    {"s__2150", "workplace,desk_with_shelves"},
-    {"s__2151", "workplace,desk_with_shelves"},
-    {"s__2153", "desk"},
-    {"s__2154", "desk"},
-    {"s__2155", "desk"},
-    {"s__2156", "sofa"},
-    {"s__2157", "sofa"},
-    {"s__2158", "sofa"},
-    {"s__2159", "sofa"},
-    {"s__2160", "sofa"},
-    {"s__2161", "sofa"},
-    {"s__2162", "sofa"},
-    {"s__2163", "sofa"},
-    {"s__2164", "sofa"},
-    {"s__2165", "sofa"},
-    {"s__2166", "sofa"},
-    {"s__2167", "chair,armchair,sofa_chair"},
-    {"s__2168", "chair,armchair"},
-    {"s__2169", "chair"},
-    {"s__2170", "chair"},
-    {"s__2171", "sofa"},
-    {"s__2172", "chair,armchair,sofa_chair"},
-    {"s__2173", "sofa"},
-    {"s__2174", "chair,armchair"},
-    {"s__2175", "chair,armchair,sofa_chair"},
-    {"s__2176", "sofa"},
-    {"s__2177", "chair"},
-    {"s__2178", "chair,armchair"},
-    {"s__2179", "chair,armchair"},
-    {"s__2180", "chair,armchair"},
-    {"s__2181", "ottoman"},
-    {"s__2182", "ottoman"},
-    {"s__2183", "chair,armchair"},
-    {"s__2184", "ottoman"},
-    {"s__2185", "chair,armchair"},
-    {"s__2186", "ottoman"},
-    {"s__2187", "chair,armchair"},
-    {"s__2188", "chair,straight_chair"},
-    {"s__2189", "chair,straight_chair"},
-    {"s__2190", "chair,armchair"},
-    {"s__2191", "chair"},
-    {"s__2192", "chair,straight_chair"},
-    {"s__2193", "chair,armchair"},
-    {"s__2194", "chair,armchair"},
-    {"s__2195", "chair,lounge_chair"},
-    {"s__2196", "chair,armchair,sofa_chair"},
-    {"s__2197", "chair,armchair"},
-    {"s__2235", "sofa"},
-    {"s__2236", "ottoman"},
-    {"s__2237", "bench_chair"},
-    {"s__2238", "workplace,desk_with_shelves"},
-    {"s__2240", "shelving,bookshelf"},
-    {"s__2241", "shelving,bookshelf"},
-    {"s__2244", "desk"},
-    {"s__2245", "desk"},
-    {"s__2254", "toy"},
-    {"s__2255", "chair,armchair"},
-    {"s__2256", "chair,armchair"},
-    {"s__2257", "chair,stool"},
-    {"s__2258", "bench_chair"},
-    {"s__2259", "chair,lounge_chair"},
-    {"s__2260", "bench_chair"},
-    {"s__2261", "chair,straight_chair"},
-    {"s__2262", "chair,armchair"},
-    {"s__2263", "chair,armchair"},
-    {"s__2264", "chair,lounge_chair"},
-    {"s__2265", "chair,straight_chair"},
-    {"s__2266", "chair,armchair"},
-    {"s__2267", "ottoman"},
-    {"s__2268", "sofa"},
-    {"s__2269", "chair,armchair"},
-    {"s__2270", "ottoman"},
-    {"s__2271", "chair,armchair"},
-    {"s__2272", "chair,straight_chair"},
-    {"s__2273", "fireplace"},
-    {"s__2274", "fireplace"},
-    {"s__2275", "fireplace"},
-    {"s__2276", "fireplace"},
-    {"s__2277", "fireplace"},
-    {"s__2278", "fireplace"},
-    {"s__2279", "fireplace"},
-    {"s__2280", "fireplace"},
-    {"s__2281", "fireplace"},
-    {"s__2282", "fireplace"},
-    {"s__2283", "fireplace"},
-    {"s__2284", "fireplace"},
-    {"s__2285", "fireplace"},
-    {"s__2286", "fireplace_tools"},
-    {"s__2287", "table,coffee_table"},
-    {"s__2288", "table,coffee_table"},
-    {"s__2289", "table,coffee_table"},
-    {"s__2290", "cart"},
-    {"s__2291", "cart"},
-    {"s__2292", "table,coffee_table"},
-    {"s__2293", "table,coffee_table"},
-    {"s__2294", "stand"},
-    {"s__2295", "table,coffee_table"},
-    {"s__2296", "table,coffee_table"},
-    {"s__2297", "table,coffee_table"},
-    {"s__2298", "table,coffee_table"},
-    {"s__2299", "table,coffee_table"},
-    {"s__2300", "table,coffee_table"},
-    {"s__2301", "table,coffee_table"},
-    {"s__2302", "shelving"},
-    {"s__2303", "shelving,wall_shelf"},
-    {"s__2304", "stand"},
-    {"s__2305", "bathroom_stuff,soap_tray"},
-    {"s__2306", "household_appliance,weight_scale"},
-    {"s__2307", "bathroom_stuff,toilet_plunger"},
-    {"s__2308", "bathroom_stuff,soap_dish"},
-    {"s__2309", "bathroom_stuff,trash_can"},
-    {"s__2310", "bathroom_stuff,soap_dispenser"},
-    {"s__2311", "bathroom_stuff,soap_tray"},
-    {"s__2312", "bathroom_stuff,towel_hanger"},
-    {"s__2313", "bathroom_stuff,toiletries"},
-    {"s__2314", "bathroom_stuff,hair_dryer"},
-    {"s__2315", "toy"},
-    {"s__2316", "decoration"},
-    {"s__2317", "toy"},
-    {"s__2318", "kitchenware,drink"},
-    {"s__2319", "kitchenware,cake,food"},
-    {"s__2320", "toy"},
-    {"s__2321", "kitchenware,food"},
-    {"s__2322", "bench_chair"},
-    {"s__2323", "bench_chair"},
-    {"s__2324", "bench_chair"},
-    {"s__2325", "bench_chair"},
-    {"s__2326", "bench_chair"},
-    {"s__2327", "bench_chair"},
-    {"s__2328", "bench_chair"},
-    {"s__2329", "bench_chair"},
-    {"s__2330", "bench_chair"},
-    {"s__2331", "bench_chair"},
-    {"s__2332", "bench_chair"},
-    {"s__2333", "bench_chair"},
-    {"s__2334", "toy"},
-    {"s__2335", "household_appliance,surveillance_camera"},
-    {"s__2336", "household_appliance,lawn_mower"},
-    {"s__2337", "safe"},
-    {"s__2338", "mailbox"},
-    {"s__2339", "kitchen_cabinet,wine_rack"},
-    {"s__2340", "chair,stool"},
-    {"s__2341", "chair,stool"},
-    {"s__2342", "partition"},
-    {"s__2343", "partition"},
-    {"s__2344", "dresser"},
-    {"s__2345", "safe"},
-    {"s__2346", "chair,stool"},
-    {"s__2347", "bed,double_bed"},
-    {"s__2348", "outdoor_spring"},
-    {"s__2349", "outdoor_spring"},
-    {"s__2350", "table,coffee_table"},
-    {"s__2351", "shelving,bookshelf"},
-    {"s__2352", "wardrobe_cabinet"},
-    {"s__2353", "wardrobe_cabinet"},
-    {"s__2354", "wardrobe_cabinet"},
-    {"s__2355", "wardrobe_cabinet"},
-    {"s__2356", "wardrobe_cabinet"},
-    {"s__2357", "clock"},
-    {"s__2358", "fence"},
-    {"s__2359", "outdoor_cover"},
-    {"s__2360", "grill"},
-    {"s__2361", "grill"},
-    {"s__2362", "fence"},
-    {"s__2363", "toy"},
-    {"s__2364", "clock"},
-    {"s__2365", "clock"},
-    {"s__2366", "clock"},
-    {"s__2367", "clock"},
-    {"s__2368", "indoor_lamp,chandelier"},
-    {"s__2369", "indoor_lamp,chandelier"},
-    {"s__2370", "indoor_lamp,chandelier"},
-    {"s__2371", "indoor_lamp,chandelier"},
-    {"s__2372", "indoor_lamp,chandelier"},
-    {"s__2373", "indoor_lamp,table_lamp"},
-    {"s__2374", "indoor_lamp,floor_lamp"},
-    {"s__2375", "cart"},
-    {"s__2376", "cart"},
-    {"s__2377", "cart"},
-    {"s__2378", "cart"},
-    {"s__2379", "cart"},
-    {"s__2380", "cart"},
-    {"s__2381", "cart"},
-    {"s__2382", "cart"},
-    {"s__2383", "cart"},
-    {"s__2384", "cart"},
-    {"s__2385", "cart"},
-    {"s__2386", "cart"},
-    {"s__2387", "cart"},
-    {"s__2388", "shelving"},
-    {"s__2389", "shelving"},
-    {"s__2390", "shelving"},
-    {"s__2391", "shelving"},
-    {"s__2392", "shelving"},
-    {"s__2393", "shelving"},
-    {"s__2394", "shelving"},
-    {"s__2395", "shelving"},
-    {"s__2396", "shelving"},
-    {"s__2397", "shelving"},
-    {"s__2398", "shelving"},
-    {"s__2399", "shelving"},
-    {"s__2400", "shelving"},
-    {"s__2401", "shelving"},
-    {"s__2402", "shelving"},
-    {"s__2403", "shelving"},
-    {"s__2404", "wardrobe_cabinet"},
-    {"s__2405", "shelving"},
-    {"s__2406", "shelving"},
-    {"s__2407", "stand,nightstand"},
-    {"s__2408", "sofa"},
-    {"s__2409", "sofa"},
-    {"s__2410", "sofa"},
-    {"s__2411", "sofa"},
-    {"s__2412", "sofa,chaisse_lounge"},
-    {"s__2413", "chair,armchair"},
-    {"s__2414", "chair,armchair"},
-    {"s__2415", "chair,armchair,sofa_chair"},
-    {"s__2416", "chair,armchair,sofa_chair"},
-    {"s__2417", "ottoman"},
-    {"s__2418", "ottoman"},
-    {"s__2419", "bench_chair"},
-    {"s__2420", "ottoman"},
-    {"s__2421", "ottoman"},
-    {"s__2422", "ottoman"},
-    {"s__2423", "ottoman"},
-    {"s__2424", "chair"},
-    {"s__2425", "sofa,chaisse_lounge"},
-    {"s__2426", "chair,lounge_chair"},
-    {"s__2427", "sofa"},
-    {"s__2428", "storage_bench"},
-    {"s__2429", "chair,armchair"},
-    {"s__2430", "chair,lounge_chair"},
-    {"s__2431", "chair,lounge_chair"},
-    {"s__2432", "chair,lounge_chair"},
-    {"s__2433", "chair,lounge_chair"},
-    {"s__2434", "chair,armchair"},
-    {"s__2435", "chair"},
-    {"s__2436", "chair,armchair,sofa_chair"},
-    {"s__2437", "chair,armchair"},
-    {"s__2438", "ottoman"},
-    {"s__2439", "sofa"},
-    {"s__2440", "sofa"},
-    {"s__2441", "sofa"},
-    {"s__2442", "chair"},
-    {"s__2443", "chair"},
-    {"s__2444", "gym_equipment"},
-    {"s__2445", "wardrobe_cabinet"},
-    {"s__2446", "wardrobe_cabinet"},
-    {"s__2447", "wardrobe_cabinet"},
-    {"s__2448", "wardrobe_cabinet"},
-    {"s__2449", "wardrobe_cabinet"},
-    {"s__2450", "stand"},
-    {"s__2451", "wardrobe_cabinet"},
-    {"s__2452", "wardrobe_cabinet"},
-    {"s__2453", "shelving"},
-    {"s__2617", "wardrobe_cabinet"},
-    {"s__2619", "wardrobe_cabinet"},
-    {"s__2620", "wardrobe_cabinet"},
-    {"s__2622", "wardrobe_cabinet"},
-    {"s__2623", "wardrobe_cabinet"},
-    {"s__361", "sofa"},
-    {"s__362", "sofa"},
-    {"s__363", "sofa"},
-    {"s__364", "sofa"},
-    {"s__365", "sofa"},
-    {"s__366", "sofa_and_table"},
-    {"s__367", "sofa"},
-    {"s__368", "sofa_and_table"},
-    {"s__369", "sofa"},
-    {"s__370", "sofa"},
-    {"s__371", "sofa"},
-    {"s__372", "sofa"},
-    {"s__373", "sofa"},
-    {"s__374", "sofa"},
-    {"s__375", "sofa"},
-    {"s__376", "sofa"},
-    {"s__377", "sofa"},
-    {"s__378", "sofa"},
-    {"s__379", "sofa"},
-    {"s__380", "sofa"},
-    {"s__382", "sofa"},
-    {"s__383", "sofa"},
-    {"s__384", "sofa"},
-    {"s__385", "sofa"},
-    {"s__386", "sofa"},
-    {"s__387", "desk"},
-    {"s__388", "desk,desk_with_shelves"},
-    {"s__389", "dresser"},
-    {"s__390", "desk"},
-    {"s__391", "wardrobe_cabinet"},
-    {"s__392", "desk,desk_with_shelves"},
-    {"s__393", "shelving"},
-    {"s__394", "chair,armchair,sofa_chair"},
-    {"s__395", "chair,armchair,sofa_chair"},
-    {"s__396", "shelving"},
-    {"s__397", "wardrobe_cabinet"},
-    {"s__398", "shelving"},
-    {"s__399", "chair,armchair,sofa_chair"},
-    {"s__400", "bed,single_bed"},
-    {"s__401", "bed,single_bed"},
-    {"s__402", "sink"},
-    {"s__403", "bed,single_bed"},
-    {"s__404", "bed,daybed"},
-    {"s__405", "sink"},
-    {"s__406", "bed,single_bed"},
-    {"s__407", "bed,baby_bed"},
-    {"s__408", "bed,baby_bed"},
-    {"s__409", "sink"},
-    {"s__410", "sink"},
-    {"s__411", "shelving"},
-    {"s__412", "shelving"},
-    {"s__413", "shelving"},
-    {"s__414", "shelving"},
-    {"s__415", "shelving"},
-    {"s__416", "bed,double_bed"},
-    {"s__417", "bed,double_bed"},
-    {"s__418", "bed,double_bed"},
-    {"s__419", "bed,double_bed"},
-    {"s__420", "bed,daybed"},
-    {"s__421", "chair"},
-    {"s__422", "bed,bunker_bed"},
-    {"s__423", "chair,stool"},
-    {"s__424", "chair,straight_chair"},
-    {"s__425", "chair,stool"},
-    {"s__426", "chair,straight_chair"},
-    {"s__427", "chair,straight_chair"},
-    {"s__428", "bed,bunker_bed"},
-    {"s__429", "wardrobe_cabinet"},
-    {"s__430", "dresser"},
-    {"s__431", "wardrobe_cabinet"},
-    {"s__432", "wardrobe_cabinet"},
-    {"s__433", "indoor_lamp,chandelier"},
-    {"s__434", "table,coffee_table"},
-    {"s__435", "table,dining_table"},
-    {"s__436", "indoor_lamp,chandelier"},
-    {"s__437", "tv_stand"},
-    {"s__438", "tv_stand"},
-    {"s__439", "stand,nightstand"},
-    {"s__440", "stand,nightstand"},
-    {"s__441", "stand,nightstand"},
-    {"s__442", "stand,nightstand"},
-    {"s__443", "stand"},
-    {"s__444", "wardrobe_cabinet"},
-    {"s__445", "shelving"},
-    {"s__446", "tv_stand"},
-    {"s__447", "tv_stand"},
-    {"s__448", "tv_stand"},
-    {"s__449", "shelving"},
-    {"s__450", "shelving,bookshelf"},
-    {"s__451", "indoor_lamp,chandelier"},
-    {"s__452", "tv_stand"},
-    {"s__453", "chair,folding_chair"},
-    {"s__454", "dresser"},
-    {"s__455", "dresser"},
-    {"s__456", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__457", "kitchen_cabinet,tall_kitchen_cabinet"},
-    {"s__458", "sofa"},
-    {"s__459", "tv_stand"},
-    {"s__460", "sofa"},
-    {"s__461", "sofa"},
-    {"s__462", "dressing_table"},
-    {"s__463", "shelving"},
-    {"s__464", "shelving"},
-    {"s__465", "tv_stand"},
-    {"s__466", "shoes_cabinet"},
-    {"s__467", "shelving,bookshelf"},
-    {"s__468", "sofa"},
-    {"s__469", "desk"},
-    {"s__470", "desk"},
-    {"s__471", "desk"},
-    {"s__472", "shelving,bookshelf"},
-    {"s__473", "shelving"},
-    {"s__474", "indoor_lamp,chandelier"},
-    {"s__475", "desk"},
-    {"s__476", "desk"},
-    {"s__477", "sofa"},
-    {"s__478", "indoor_lamp,chandelier"},
-    {"s__479", "indoor_lamp,chandelier"},
-    {"s__480", "desk"},
-    {"s__481", "table,coffee_table"},
-    {"s__482", "desk"},
-    {"s__483", "desk"},
-    {"s__484", "desk"},
-    {"s__485", "desk"},
-    {"s__486", "indoor_lamp,chandelier"},
-    {"s__487", "indoor_lamp,chandelier"},
-    {"s__488", "indoor_lamp,chandelier"},
-    {"s__489", "desk,desk_with_shelves"},
-    {"s__490", "shelving"},
-    {"s__491", "wardrobe_cabinet"},
-    {"s__492", "shelving,bookshelf"},
-    {"s__493", "shelving"},
-    {"s__494", "mirror,medicine_cabinet"},
-    {"s__495", "mirror,medicine_cabinet"},
-    {"s__496", "shelving,bookshelf"},
-    {"s__497", "shelving"},
-    {"s__498", "shelving"},
-    {"s__499", "stairs"},
-    {"s__500", "sofa"},
-    {"s__501", "sofa"},
-    {"s__502", "sofa"},
-    {"s__503", "sofa"},
-    {"s__504", "sofa"},
-    {"s__505", "indoor_lamp,floor_lamp"},
-    {"s__506", "indoor_lamp,floor_lamp"},
-    {"s__507", "indoor_lamp,floor_lamp"},
-    {"s__508", "indoor_lamp,floor_lamp"},
-    {"s__509", "indoor_lamp,floor_lamp"},
-    {"s__510", "shelving"},
-    {"s__511", "stand,nightstand"},
-    {"s__512", "desk"},
-    {"s__513", "sofa"},
-    {"s__514", "chair,armchair,sofa_chair"},
-    {"s__515", "sofa"},
-    {"s__516", "tv_stand"},
-    {"s__517", "wardrobe_cabinet"},
-    {"s__518", "sofa"},
-    {"s__519", "wardrobe_cabinet"},
-    {"s__520", "shelving"},
-    {"s__521", "shelving,bookshelf"},
-    {"s__522", "dresser"},
-    {"s__523", "dresser"},
-    {"s__524", "shelving,bookshelf"},
-    {"s__525", "dresser"},
-    {"s__526", "dresser"},
-    {"s__527", "sofa"},
-    {"s__528", "sofa"},
-    {"s__529", "chair,armchair,sofa_chair"},
-    {"s__530", "sofa"},
-    {"s__531", "dresser"},
-    {"s__532", "dresser"},
-    {"s__533", "mirror"},
-    {"s__536", "sink"},
-    {"s__537", "wardrobe_cabinet"},
-    {"s__538", "mirror,medicine_cabinet"},
-    {"s__539", "stand"},
-    {"s__540", "chair"},
-    {"s__541", "sink"},
-    {"s__542", "sink"},
-    {"s__543", "sofa_and_table"},
-    {"s__544", "mirror"},
-    {"s__545", "table,dining_table"},
-    {"s__546", "table,dining_table"},
-    {"s__547", "table,dining_table"},
-    {"s__548", "table,dining_table"},
-    {"s__549", "sofa"},
-    {"s__550", "wardrobe_cabinet"},
-    {"s__551", "table,coffee_table"},
-    {"s__552", "desk"},
-    {"s__553", "tv_stand"},
-    {"s__554", "table,coffee_table"},
-    {"s__555", "table,coffee_table"},
-    {"s__556", "shelving"},
-    {"s__557", "sink"},
-    {"s__558", "sink"},
-    {"s__559", "wardrobe_cabinet"},
-    {"s__560", "sink"},
-    {"s__561", "table,coffee_table"},
-    {"s__562", "wardrobe_cabinet"},
-    {"s__563", "dresser"},
-    {"s__564", "wardrobe_cabinet"},
-    {"s__565", "wardrobe_cabinet"},
-    {"s__566", "wardrobe_cabinet"},
-    {"s__567", "wardrobe_cabinet"},
-    {"s__568", "shelving"},
-    {"s__569", "tv_stand"},
-    {"s__570", "wardrobe_cabinet"},
-    {"s__571", "wardrobe_cabinet"},
-    {"s__572", "wardrobe_cabinet"},
-    {"s__573", "wardrobe_cabinet"},
-    {"s__574", "chair,office_chair"},
-    {"s__575", "chair,straight_chair"},
-    {"s__576", "sink"},
-    {"s__577", "sink"},
-    {"s__578", "mirror,medicine_cabinet"},
-    {"s__579", "vase"},
-    {"s__580", "indoor_lamp,table_lamp"},
-    {"s__581", "wardrobe_cabinet"},
-    {"s__582", "wardrobe_cabinet"},
-    {"s__583", "chair,armchair"},
-    {"s__584", "shoes_cabinet"},
-    {"s__585", "outdoor_seating"},
-    {"s__586", "outdoor_lamp"},
-    {"s__587", "sofa"},
-    {"s__588", "chair,armchair,sofa_chair"},
-    {"s__589", "bed,bunker_bed"},
-    {"s__590", "wardrobe_cabinet"},
-    {"s__591", "wardrobe_cabinet"},
-    {"s__592", "dresser"},
-    {"s__593", "desk,desk_with_shelves"},
-    {"s__594", "stand,nightstand"},
-    {"s__595", "table,coffee_table"},
-    {"s__596", "chair,armchair"},
-    {"s__597", "table,coffee_table"},
-    {"s__598", "sofa"},
-    {"s__599", "table,coffee_table"},
-    {"s__600", "chair,armchair"},
-    {"s__601", "sofa"},
-    {"s__602", "chair,armchair,sofa_chair"},
-    {"s__603", "sofa"},
-    {"s__604", "table,coffee_table"},
-    {"s__605", "outdoor_seating,porch_swing"},
-    {"s__606", "outdoor_seating,porch_swing"},
-    {"s__607", "outdoor_seating,porch_swing"},
-    {"s__608", "outdoor_seating,porch_swing"},
-    {"s__609", "outdoor_seating,porch_swing"},
-    {"s__610", "outdoor_seating,porch_swing"},
-    {"s__611", "chair,armchair,sofa_chair"},
-    {"s__612", "stand,nightstand"},
-    {"s__613", "outdoor_seating,porch_swing"},
-    {"s__614", "outdoor_seating,porch_swing"},
-    {"s__615", "chair,lounge_chair"},
-    {"s__616", "shelving"},
-    {"s__617", "wardrobe_cabinet"},
-    {"s__618", "shelving,bookshelf"},
-    {"s__619", "bed,daybed"},
-    {"s__620", "shelving,bookshelf"},
-    {"s__621", "chair,lounge_chair"},
-    {"s__622", "chair,lounge_chair"},
-    {"s__623", "chair,lounge_chair"},
-    {"s__624", "chair,lounge_chair"},
-    {"s__625", "chair,lounge_chair"},
-    {"s__626", "chair,lounge_chair"},
-    {"s__627", "chair,lounge_chair"},
-    {"s__628", "chair,lounge_chair"},
-    {"s__629", "chair,lounge_chair"},
-    {"s__630", "chair,lounge_chair"},
-    {"s__631", "chair,lounge_chair"},
-    {"s__632", "chair,lounge_chair"},
-    {"s__633", "chair,lounge_chair"},
-    {"s__634", "outdoor_seating"},
-    {"s__635", "table_and_chair"},
-    {"s__636", "table_and_chair"},
-    {"s__637", "table_and_chair"},
-    {"s__638", "sofa_and_table"},
-    {"s__639", "chair,chair_set"},
-    {"s__640", "table_and_chair"},
-    {"s__641", "table_and_chair"},
-    {"s__642", "sofa"},
-    {"s__643", "chair,armchair,sofa_chair"},
-    {"s__644", "sofa"},
-    {"s__645", "chair,armchair,sofa_chair"},
-    {"s__646", "sofa"},
-    {"s__647", "chair,armchair,sofa_chair"},
-    {"s__648", "sofa"},
-    {"s__649", "chair,armchair,sofa_chair"},
-    {"s__650", "sofa"},
-    {"s__651", "chair,armchair,sofa_chair"},
-    {"s__652", "sofa"},
-    {"s__653", "chair,armchair,sofa_chair"},
-    {"s__654", "sofa"},
-    {"s__655", "sofa"},
-    {"s__656", "sofa"},
-    {"s__657", "chair,armchair,sofa_chair"},
-    {"s__658", "sofa"},
-    {"s__659", "shelving"},
-    {"s__660", "sofa"},
-    {"s__661", "sofa"},
-    {"s__662", "stand"},
-    {"s__663", "stand"},
-    {"s__664", "stand"},
-    {"s__665", "stand,nightstand"},
-    {"s__666", "stand"},
-    {"s__667", "chair,office_chair"},
-    {"s__668", "chair,office_chair"},
-    {"s__669", "chair,office_chair"},
-    {"s__670", "chair,office_chair"},
-    {"s__671", "chair,office_chair"},
-    {"s__672", "chair,office_chair"},
-    {"s__673", "tv_stand"},
-    {"s__674", "tv_stand"},
-    {"s__675", "tv_stand"},
-    {"s__676", "tv_stand"},
-    {"s__677", "indoor_lamp,floor_lamp"},
-    {"s__678", "indoor_lamp,floor_lamp"},
-    {"s__679", "indoor_lamp,floor_lamp"},
-    {"s__680", "tv_stand"},
-    {"s__681", "stand"},
-    {"s__682", "stand"},
-    {"s__683", "dresser"},
-    {"s__684", "stand,nightstand"},
-    {"s__685", "stand"},
-    {"s__686", "stand"},
-    {"s__687", "stand,nightstand"},
-    {"s__688", "table,dining_table"},
-    {"s__689", "table,dining_table"},
-    {"s__690", "table,dining_table"},
-    {"s__691", "table,dining_table"},
-    {"s__692", "dresser"},
-    {"s__693", "tv_stand"},
-    {"s__694", "tv_stand"},
-    {"s__695", "tv_stand"},
-    {"s__696", "table,dining_table"},
-    {"s__697", "table,dining_table"},
-    {"s__698", "table,dining_table"},
-    {"s__699", "table,coffee_table"},
-    {"s__700", "tv_stand"},
-    {"s__701", "tv_stand"},
-    {"s__702", "tv_stand"},
-    {"s__703", "tv_stand"},
-    {"s__704", "tv_stand"},
-    {"s__705", "tv_stand"},
-    {"s__706", "tv_stand"},
-    {"s__707", "tv_stand"},
-    {"s__708", "indoor_lamp,floor_lamp"},
-    {"s__709", "indoor_lamp,floor_lamp"},
-    {"s__710", "indoor_lamp,floor_lamp"},
-    {"s__711", "indoor_lamp,floor_lamp"},
-    {"s__712", "indoor_lamp,floor_lamp"},
-    {"s__713", "indoor_lamp,floor_lamp"},
-    {"s__714", "desk"},
-    {"s__715", "table,dining_table"},
-    {"s__716", "table,dining_table"},
-    {"s__717", "table,dining_table"},
-    {"s__718", "stand,nightstand"},
-    {"s__719", "desk"},
-    {"s__720", "table,dining_table"},
-    {"s__721", "desk"},
-    {"s__722", "desk"},
-    {"s__723", "shoes_cabinet"},
-    {"s__724", "chair,stool"},
-    {"s__725", "chair,stool"},
-    {"s__726", "chair,stool"},
-    {"s__727", "chair,stool"},
-    {"s__728", "hanger"},
-    {"s__729", "hanger"},
-    {"s__730", "hanger"},
-    {"s__731", "hanger"},
-    {"s__732", "hanger"},
-    {"s__733", "hanger"},
-    {"s__734", "desk"},
-    {"s__735", "table,dining_table"},
-    {"s__736", "table,dining_table"},
-    {"s__737", "table,dining_table"},
-    {"s__738", "table,dining_table"},
-    {"s__739", "table,dining_table"},
-    {"s__740", "table,dining_table"},
-    {"s__741", "table,dining_table"},
-    {"s__742", "indoor_lamp,table_lamp"},
-    {"s__743", "indoor_lamp,table_lamp"},
-    {"s__744", "indoor_lamp,table_lamp"},
-    {"s__745", "indoor_lamp,table_lamp"},
-    {"s__746", "dresser"},
-    {"s__747", "wardrobe_cabinet"},
-    {"s__748", "dresser"},
-    {"s__749", "shoes_cabinet"},
-    {"s__750", "shoes_cabinet"},
-    {"s__751", "shoes_cabinet"},
-    {"s__752", "shoes_cabinet"},
-    {"s__753", "shoes_cabinet"},
-    {"s__754", "shoes_cabinet"},
-    {"s__755", "shoes_cabinet"},
-    {"s__756", "wardrobe_cabinet"},
-    {"s__757", "shelving,bookshelf"},
-    {"s__758", "shelving,bookshelf"},
-    {"s__759", "indoor_lamp,wall_lamp"},
-    {"s__760", "indoor_lamp,wall_lamp"},
-    {"s__761", "indoor_lamp,wall_lamp"},
-    {"s__762", "indoor_lamp,wall_lamp"},
-    {"s__763", "indoor_lamp,wall_lamp"},
-    {"s__764", "indoor_lamp,table_lamp"},
-    {"s__765", "indoor_lamp,table_lamp"},
-    {"s__766", "indoor_lamp,table_lamp"},
-    {"s__767", "indoor_lamp,table_lamp"},
-    {"s__768", "indoor_lamp,floor_lamp"},
-    {"s__769", "chair,straight_chair"},
-    {"s__770", "chair,straight_chair"},
-    {"s__771", "chair,armchair"},
-    {"s__772", "chair,armchair"},
-    {"s__773", "chair"},
-    {"s__774", "chair,straight_chair"},
-    {"s__775", "shelving,bookshelf"},
-    {"s__776", "shelving,bookshelf"},
-    {"s__777", "wardrobe_cabinet"},
-    {"s__778", "wardrobe_cabinet"},
-    {"s__779", "dresser"},
-    {"s__780", "shelving"},
-    {"s__781", "tv_stand"},
-    {"s__782", "shelving"},
-    {"s__783", "shelving"},
-    {"s__784", "shelving"},
-    {"s__785", "dresser"},
-    {"s__786", "stand,nightstand"},
-    {"s__787", "dresser"},
-    {"s__788", "dresser"},
-    {"s__789", "tv_stand"},
-    {"s__790", "shelving"},
-    {"s__791", "shelving"},
-    {"s__792", "shelving"},
-    {"s__793", "shelving"},
-    {"s__794", "shelving"},
-    {"s__795", "shelving"},
-    {"s__796", "shelving"},
-    {"s__797", "indoor_lamp,table_lamp"},
-    {"s__798", "indoor_lamp,table_lamp"},
-    {"s__799", "indoor_lamp,table_lamp"},
-    {"s__800", "indoor_lamp,table_lamp"},
-    {"s__801", "indoor_lamp,table_lamp"},
-    {"s__802", "chair,straight_chair"},
-    {"s__803", "chair,armchair"},
-    {"s__804", "chair,straight_chair"},
-    {"s__805", "chair"},
-    {"s__806", "desk,desk_with_shelves"},
-    {"s__807", "chair,straight_chair"},
-    {"s__808", "chair,straight_chair"},
-    {"s__809", "chair,straight_chair"},
-    {"s__810", "dresser"},
-    {"s__811", "chair,armchair"},
-    {"s__812", "ottoman"},
-    {"s__813", "chair"},
-    {"s__814", "chair"},
-    {"s__815", "chair,armchair,sofa_chair"},
-    {"s__816", "sofa"},
-    {"s__817", "chair,armchair,sofa_chair"},
-    {"s__818", "chair,armchair"},
-    {"s__819", "chair,armchair"},
-    {"s__820", "chair,armchair"},
-    {"s__821", "chair,armchair"},
-    {"s__822", "chair"},
-    {"s__823", "chair,straight_chair"},
-    {"s__824", "chair,straight_chair"},
-    {"s__825", "chair"},
-    {"s__826", "chair,stool"},
-    {"s__827", "chair,armchair"},
-    {"s__828", "sink"},
-    {"s__829", "sink"},
-    {"s__830", "sink"},
-    {"s__831", "ottoman"},
-    {"s__832", "ottoman"},
-    {"s__833", "ottoman"},
-    {"s__834", "ottoman"},
-    {"s__835", "ottoman"},
-    {"s__836", "ottoman"},
-    {"s__837", "ottoman"},
-    {"s__838", "ottoman"},
-    {"s__839", "ottoman"},
-    {"s__840", "ottoman"},
-    {"s__841", "ottoman"},
-    {"s__842", "ottoman"},
-    {"s__843", "ottoman"},
-    {"s__844", "ottoman"},
-    {"s__845", "ottoman"},
-    {"s__846", "wardrobe_cabinet"},
-    {"s__847", "wardrobe_cabinet"},
-    {"s__848", "wardrobe_cabinet"},
-    {"s__849", "wardrobe_cabinet"},
-    {"s__850", "wardrobe_cabinet"},
-    {"s__851", "wardrobe_cabinet"},
-    {"s__852", "stand"},
-    {"s__853", "wardrobe_cabinet"},
-    {"s__854", "stand"},
-    {"s__855", "wardrobe_cabinet"},
-    {"s__856", "wardrobe_cabinet"},
-    {"s__857", "wardrobe_cabinet"},
-    {"s__858", "stand"},
-    {"s__859", "wardrobe_cabinet"},
-    {"s__860", "wardrobe_cabinet"},
-    {"s__861", "wardrobe_cabinet"},
-    {"s__862", "wardrobe_cabinet"},
-    {"s__863", "stand"},
-    {"s__864", "stand,nightstand"},
-    {"s__865", "wardrobe_cabinet"},
-    {"s__866", "stand,nightstand"},
-    {"s__867", "stand"},
-    {"s__868", "hanging_kitchen_cabinet,range_hood_with_cabinet"},
-    {"s__869", "kitchen_appliance,range_hood"},
-    {"s__870", "hanging_kitchen_cabinet,range_hood_with_cabinet"},
-    {"s__871", "kitchen_appliance,range_hood"},
-    {"s__872", "hanging_kitchen_cabinet,range_hood_with_cabinet"},
-    {"s__873", "kitchen_appliance,range_hood"},
-    {"s__874", "kitchen_appliance,range_hood"},
-    {"s__875", "hanging_kitchen_cabinet,dish_shelf"},
-    {"s__876", "shelving,wall_shelf"},
-    {"s__877", "shelving,wall_shelf"},
-    {"s__878", "cart"},
-    {"s__879", "kitchen_appliance,range_hood"},
-    {"s__880", "kitchen_appliance,range_hood"},
-    {"s__881", "bed,double_bed"},
-    {"s__882", "bed,double_bed"},
-    {"s__883", "bed,double_bed"},
-    {"s__884", "bed,double_bed"},
-    {"s__885", "bed,single_bed"},
-    {"s__886", "bed,single_bed"},
-    {"s__887", "bed,baby_bed"},
-    {"s__888", "bed,baby_bed"},
-    {"s__889", "bed,baby_bed"},
-    {"s__890", "bed,baby_bed"},
-    {"s__891", "bed,baby_bed"},
-    {"s__892", "bed,baby_bed"},
-    {"s__893", "bed,double_bed"},
-    {"s__894", "bed,double_bed"},
-    {"s__895", "tv_stand"},
-    {"s__896", "tv_stand"},
-    {"s__897", "wardrobe_cabinet"},
-    {"s__898", "wardrobe_cabinet"},
-    {"s__899", "wardrobe_cabinet"},
-    {"s__900", "wardrobe_cabinet"},
-    {"s__901", "wardrobe_cabinet"},
-    {"s__902", "wardrobe_cabinet"},
-    {"s__903", "wardrobe_cabinet"},
-    {"s__904", "cart"},
-    {"s__905", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__906", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__907", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__908", "hanging_kitchen_cabinet"},
-    {"s__909", "hanging_kitchen_cabinet"},
-    {"s__910", "kitchen_cabinet,kitchen_sink"},
-    {"s__911", "kitchen_cabinet,kitchen_sink"},
-    {"s__912", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__913", "kitchen_cabinet,short_kitchen_cabinet_with_oven"},
-    {"s__914", "kitchen_cabinet,range_oven"},
-    {"s__915", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__916", "kitchen_cabinet,kitchen_sink"},
-    {"s__917", "stand"},
-    {"s__918", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__919", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__920", "kitchen_cabinet,kitchen_sink"},
-    {"s__921", "kitchen_cabinet,kitchen_sink"},
-    {"s__922", "kitchen_cabinet,kitchen_sink"},
-    {"s__923", "storage_bench"},
-    {"s__924", "cart"},
-    {"s__925", "storage_bench"},
-    {"s__926", "shelving"},
-    {"s__927", "shelving"},
-    {"s__928", "storage_bench"},
-    {"s__929", "shelving"},
-    {"s__930", "shelving"},
-    {"s__931", "shelving"},
-    {"s__932", "shelving"},
-    {"s__933", "shelving"},
-    {"s__934", "wardrobe_cabinet"},
-    {"s__935", "wardrobe_cabinet"},
-    {"s__936", "wardrobe_cabinet"},
-    {"s__937", "wardrobe_cabinet"},
-    {"s__938", "wardrobe_cabinet"},
-    {"s__939", "wardrobe_cabinet"},
-    {"s__940", "wardrobe_cabinet"},
-    {"s__941", "wardrobe_cabinet"},
-    {"s__942", "wardrobe_cabinet"},
-    {"s__943", "wardrobe_cabinet"},
-    {"s__944", "shelving"},
-    {"s__945", "shelving"},
-    {"s__946", "shelving"},
-    {"s__947", "shelving"},
-    {"s__948", "shelving"},
-    {"s__949", "shelving"},
-    {"s__950",
-     "hanging_kitchen_cabinet,hanging_kitchen_cabinet_with_microwave"},
-    {"s__951", "hanging_kitchen_cabinet"},
-    {"s__952", "hanging_kitchen_cabinet"},
-    {"s__953", "hanging_kitchen_cabinet"},
-    {"s__954", "hanging_kitchen_cabinet"},
-    {"s__955", "hanging_kitchen_cabinet"},
-    {"s__956", "hanging_kitchen_cabinet"},
-    {"s__957", "hanging_kitchen_cabinet"},
-    {"s__958", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__959", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__960", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__961", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__962", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__963", "kitchen_cabinet,short_kitchen_cabinet"},
-    {"s__964", "kitchen_cabinet,kitchen_sink"},
-    {"s__965", "chair,lounge_chair"},
-    {"s__966", "chair,stool"},
-    {"s__967", "chair"},
-    {"s__968", "chair,armchair"},
-    {"s__969", "storage_bench"},
-    {"s__970", "shelving"},
-    {"s__971", "kitchen_set"},
-    {"s__972", "kitchen_cabinet,kitchen_island"},
-    {"s__973", "kitchen_set"},
-    {"s__974", "kitchen_set"},
-    {"s__975", "kitchen_set"},
-    {"s__976", "kitchen_set"},
-    {"s__977", "kitchen_set"},
-    {"s__978", "kitchen_set"},
-    {"s__979", "kitchen_set"},
-    {"s__980", "kitchen_set"},
-    {"s__981", "kitchen_set"},
-    {"s__982", "bed,double_bed"},
-    {"s__983", "wardrobe_cabinet"},
-    {"s__984", "wardrobe_cabinet"},
-    {"s__985", "wardrobe_cabinet"},
-    {"s__986", "wardrobe_cabinet"},
-    {"s__987", "wardrobe_cabinet"},
-    {"s__988", "wardrobe_cabinet"},
-    {"s__989", "wardrobe_cabinet"},
-    {"s__990", "wardrobe_cabinet"},
-    {"s__991", "wardrobe_cabinet"},
-    {"s__992", "stand"},
-    {"s__993", "stand"},
-    {"s__994", "stand,nightstand"},
-    {"s__995", "stand,nightstand"},
-    {"s__996", "stand,nightstand"},
-    {"s__997", "stand,nightstand"},
-    {"s__998", "stand,nightstand"},
-    {"s__999", "stand,nightstand"}};
+// NOTE: This is the model id to category mapping from SUNCG v2.1. The tables
+// are constant-initialized, so they cost nothing at static-init time.
+
+//! SUNCG category sets (comma separated), indexed by category ID
+constexpr const char* kSuncgObjectCategories[] = {
+    "ATM",
+    "air_conditioner",
+    "arch",
+    "bathroom_stuff,hair_dryer",
+    "bathroom_stuff,soap_dish",
+    "bathroom_stuff,soap_dispenser",
+    "bathroom_stuff,soap_tray",
+    "bathroom_stuff,toilet_paper",
+    "bathroom_stuff,toilet_plunger",
+    "bathroom_stuff,toiletries",
+    "bathroom_stuff,towel_hanger",
+    "bathroom_stuff,towel_rack",
+    "bathroom_stuff,trash_can",
+    "bathtub",
+    "bed,baby_bed",
+    "bed,bunker_bed",
+    "bed,daybed",
+    "bed,double_bed",
+    "bed,single_bed",
+    "bench_chair",
+    "books",
+    "books,book",
+    "candle",
+    "cart",
+    "chair",
+    "chair,armchair",
+    "chair,armchair,sofa_chair",
+    "chair,armchair_with_ottoman",
+    "chair,chair_set",
+    "chair,folding_chair",
+    "chair,lounge_chair",
+    "chair,office_chair",
+    "chair,stool",
+    "chair,straight_chair",
+    "clock",
+    "cloth",
+    "coffin",
+    "column",
+    "computer",
+    "computer,laptop",
+    "counter",
+    "curtain",
+    "curtain,blinds",
+    "decoration",
+    "desk",
+    "desk,desk_with_shelves",
+    "door",
+    "dresser",
+    "dressing_table",
+    "drinkbar",
+    "fan,ceiling_fan",
+    "fan,pedestal_fan",
+    "fence",
+    "fireplace",
+    "fireplace_tools",
+    "garage_door",
+    "grill",
+    "gym_equipment",
+    "hanger",
+    "hanging_kitchen_cabinet",
+    "hanging_kitchen_cabinet,dish_shelf",
+    "hanging_kitchen_cabinet,range_hood_with_cabinet",
+    "headstone",
+    "heater",
+    "household_appliance",
+    "household_appliance,camera",
+    "household_appliance,cellphone",
+    "household_appliance,dryer",
+    "household_appliance,gramophone",
+    "household_appliance,headphones_on_stand",
+    "household_appliance,helmet",
+    "household_appliance,ipad",
+    "household_appliance,iron",
+    "household_appliance,ironing_board",
+    "household_appliance,ladder",
+    "household_appliance,lawn_mower",
+    "household_appliance,rifle_on_wall",
+    "household_appliance,slot_machine",
+    "household_appliance,slot_machine_and_chair",
+    "household_appliance,stationary_container",
+    "household_appliance,surveillance_camera",
+    "household_appliance,telephone",
+    "household_appliance,vacuum_cleaner",
+    "household_appliance,washer",
+    "household_appliance,weight_scale",
+    "indoor_lamp,chandelier",
+    "indoor_lamp,floor_lamp",
+    "indoor_lamp,table_lamp",
+    "indoor_lamp,wall_lamp",
+    "kitchen_appliance,coffee_machine",
+    "kitchen_appliance,cooker",
+    "kitchen_appliance,dishwasher",
+    "kitchen_appliance,food_processor",
+    "kitchen_appliance,kettle",
+    "kitchen_appliance,microwave",
+    "kitchen_appliance,range_hood",
+    "kitchen_appliance,range_oven",
+    "kitchen_appliance,range_oven_with_hood",
+    "kitchen_appliance,refrigerator",
+    "kitchen_appliance,small_refrigerator",
+    "kitchen_appliance,toaster",
+    "kitchen_appliance,water_dispenser",
+    "kitchen_cabinet,dishwasher",
+    "kitchen_cabinet,kitchen_cabinet_with_refrigerator",
+    "kitchen_cabinet,kitchen_island",
+    "kitchen_cabinet,kitchen_island_with_range_hood_and_table",
+    "kitchen_cabinet,kitchen_set",
+    "kitchen_cabinet,kitchen_sink",
+    "kitchen_cabinet,kitchen_sink_with_dishwasher",
+    "kitchen_cabinet,kitchen_sink_with_hanging_kitchen_cabinet",
+    "kitchen_cabinet,large_kitchen_cabinet",
+    "kitchen_cabinet,range_oven",
+    "kitchen_cabinet,range_oven_with_hood",
+    "kitchen_cabinet,range_with_hood",
+    "kitchen_cabinet,short_kitchen_cabinet",
+    "kitchen_cabinet,short_kitchen_cabinet_with_oven",
+    "kitchen_cabinet,tall_kitchen_cabinet",
+    "kitchen_cabinet,tall_kitchen_cabinet_with_oven",
+    "kitchen_cabinet,wine_rack",
+    "kitchen_set",
+    "kitchenware,beer,drink",
+    "kitchenware,bottle,drink",
+    "kitchenware,bread,food",
+    "kitchenware,cake,food",
+    "kitchenware,coffee_kettle",
+    "kitchenware,container",
+    "kitchenware,containers",
+    "kitchenware,cup",
+    "kitchenware,cup,drink",
+    "kitchenware,cup,food",
+    "kitchenware,cutting_board,food",
+    "kitchenware,drink",
+    "kitchenware,food",
+    "kitchenware,food_tray,food,drink",
+    "kitchenware,fork",
+    "kitchenware,fruit_bowl,food",
+    "kitchenware,glass",
+    "kitchenware,jug",
+    "kitchenware,jug,drink",
+    "kitchenware,kettle",
+    "kitchenware,knife",
+    "kitchenware,knife_rack",
+    "kitchenware,mortar_and_pestle",
+    "kitchenware,pan",
+    "kitchenware,place_setting",
+    "kitchenware,plates",
+    "kitchenware,spoon",
+    "kitchenware,teapot",
+    "kitchenware,trash_can",
+    "kitchenware,utensil_holder",
+    "magazines",
+    "mailbox",
+    "mirror",
+    "mirror,medicine_cabinet",
+    "music,accordion",
+    "music,amplifier",
+    "music,drumset",
+    "music,guitar",
+    "music,keyboard",
+    "music,loudspeaker",
+    "music,microphone",
+    "music,piano",
+    "music,stereo_set",
+    "music,theremin",
+    "ottoman",
+    "outdoor_cover",
+    "outdoor_cover,umbrella",
+    "outdoor_lamp",
+    "outdoor_seating",
+    "outdoor_seating,hammock",
+    "outdoor_seating,porch_swing",
+    "outdoor_seating,swing",
+    "outdoor_spring",
+    "partition",
+    "person",
+    "pet,bird",
+    "pet,cat",
+    "pet,dog",
+    "pet,pig",
+    "pet,turtle",
+    "picture_frame",
+    "pillow",
+    "plant",
+    "pool",
+    "recreation,basketball_hoop",
+    "recreation,game_table",
+    "recreation,goal_post",
+    "roof",
+    "rug",
+    "safe",
+    "shelving",
+    "shelving,bookshelf",
+    "shelving,wall_shelf",
+    "shoes",
+    "shoes_cabinet",
+    "shower",
+    "shower,shower_ceiling",
+    "shower,shower_faucet",
+    "sink",
+    "sofa",
+    "sofa,chaisse_lounge",
+    "sofa_and_table",
+    "stairs",
+    "stand",
+    "stand,nightstand",
+    "storage_bench",
+    "switch",
+    "table",
+    "table,coffee_table",
+    "table,dining_table",
+    "table_and_chair",
+    "television",
+    "toilet",
+    "toilet,bidet",
+    "toilet,urinal",
+    "towel_hanger",
+    "toy",
+    "toy,chessboard",
+    "toy,fish_tank",
+    "toy,fishbowl",
+    "toy,playstation",
+    "toy,poker_chips",
+    "toy,tricycle",
+    "toy,xbox",
+    "trash_can",
+    "trinket",
+    "tripod",
+    "tv_stand",
+    "vase",
+    "vehicle,bicycle",
+    "vehicle,car",
+    "vehicle,motorcycle",
+    "wardrobe_cabinet",
+    "whiteboard",
+    "window",
+    "wood_board",
+    "workplace,desk",
+    "workplace,desk_with_shelves",
+    "workplace,double_desk",
+    "workplace,double_desk_with_chairs",
+};
+
+//! SUNCG object model id and the ID of its category set
+struct SuncgObjectCategoryEntry {
+  const char* modelId;
+  uint16_t categoryId;
+};
+
+//! map from SUNCG object model id to category ID, sorted by model id
+constexpr SuncgObjectCategoryEntry kSuncgObjectCategoryMap[] = {
+    {"100", 58},
+    {"101", 111},
+    {"102", 98},
+    {"104", 44},
+    {"105", 44},
+    {"106", 31},
+    {"107", 44},
+    {"108", 44},
+    {"109", 208},
+    {"110", 211},
+    {"111", 211},
+    {"112", 211},
+    {"113", 211},
+    {"114", 211},
+    {"115", 227},
+    {"116", 227},
+    {"117", 227},
+    {"118", 58},
+    {"119", 208},
+    {"120", 39},
+    {"121", 232},
+    {"122", 46},
+    {"122_0", 46},
+    {"122_2", 46},
+    {"123", 58},
+    {"124", 88},
+    {"125", 107},
+    {"126", 234},
+    {"127", 88},
+    {"128", 204},
+    {"129", 47},
+    {"130", 182},
+    {"131", 98},
+    {"132", 198},
+    {"133", 46},
+    {"133_0", 46},
+    {"133_2", 46},
+    {"134", 210},
+    {"135", 195},
+    {"136", 218},
+    {"137", 107},
+    {"138", 107},
+    {"139", 195},
+    {"140", 47},
+    {"141", 48},
+    {"142", 33},
+    {"143", 161},
+    {"144", 152},
+    {"145", 194},
+    {"146", 204},
+    {"147", 204},
+    {"148", 21},
+    {"149", 127},
+    {"150", 213},
+    {"151", 202},
+    {"152", 202},
+    {"153", 188},
+    {"154", 143},
+    {"155", 199},
+    {"156", 199},
+    {"157", 199},
+    {"166", 25},
+    {"167", 199},
+    {"168", 199},
+    {"169", 26},
+    {"170", 199},
+    {"171", 208},
+    {"172", 208},
+    {"173", 208},
+    {"174", 208},
+    {"175", 88},
+    {"176", 88},
+    {"178", 88},
+    {"179", 88},
+    {"180", 88},
+    {"181", 198},
+    {"182", 232},
+    {"183", 198},
+    {"184", 232},
+    {"185", 185},
+    {"186", 198},
+    {"187", 232},
+    {"188", 190},
+    {"189", 38},
+    {"190", 14},
+    {"191", 191},
+    {"192", 190},
+    {"193", 190},
+    {"194", 232},
+    {"195", 204},
+    {"196", 25},
+    {"197", 204},
+    {"198", 227},
+    {"199", 48},
+    {"200", 48},
+    {"201", 48},
+    {"202", 48},
+    {"203", 48},
+    {"204", 17},
+    {"205", 17},
+    {"206", 101},
+    {"207", 192},
+    {"208", 58},
+    {"209", 234},
+    {"210", 234},
+    {"211", 234},
+    {"212", 234},
+    {"213", 234},
+    {"214", 46},
+    {"214_0", 46},
+    {"214_2", 46},
+    {"215", 211},
+    {"216", 211},
+    {"217", 58},
+    {"218", 162},
+    {"219", 91},
+    {"220", 92},
+    {"221", 89},
+    {"222", 94},
+    {"223", 82},
+    {"224", 72},
+    {"225", 1},
+    {"226", 51},
+    {"227", 1},
+    {"228", 211},
+    {"229", 11},
+    {"230", 63},
+    {"232", 107},
+    {"233", 204},
+    {"235", 188},
+    {"236", 180},
+    {"237", 182},
+    {"238", 188},
+    {"239", 152},
+    {"240", 86},
+    {"241", 95},
+    {"242", 53},
+    {"243", 121},
+    {"244", 136},
+    {"245", 130},
+    {"246", 46},
+    {"246_0", 46},
+    {"246_2", 46},
+    {"247", 46},
+    {"247_0", 46},
+    {"247_2", 46},
+    {"248", 190},
+    {"249", 33},
+    {"250", 59},
+    {"251", 59},
+    {"252", 209},
+    {"253", 202},
+    {"254", 202},
+    {"255", 33},
+    {"256", 87},
+    {"257", 180},
+    {"258", 228},
+    {"259", 199},
+    {"260", 199},
+    {"261", 26},
+    {"262", 26},
+    {"263", 73},
+    {"264", 96},
+    {"265", 120},
+    {"266", 232},
+    {"267", 232},
+    {"268", 190},
+    {"269", 232},
+    {"270", 15},
+    {"271", 232},
+    {"272", 232},
+    {"273", 44},
+    {"274", 232},
+    {"275", 41},
+    {"276", 42},
+    {"277", 33},
+    {"278", 159},
+    {"279", 206},
+    {"280", 206},
+    {"281", 114},
+    {"282", 114},
+    {"283", 111},
+    {"284", 114},
+    {"285", 107},
+    {"286", 59},
+    {"287", 59},
+    {"288", 116},
+    {"289", 116},
+    {"290", 114},
+    {"291", 114},
+    {"292", 194},
+    {"293", 190},
+    {"294", 44},
+    {"295", 107},
+    {"311", 204},
+    {"312", 204},
+    {"313", 34},
+    {"314", 152},
+    {"315", 204},
+    {"316", 59},
+    {"317", 59},
+    {"318", 204},
+    {"319", 20},
+    {"320", 20},
+    {"321", 199},
+    {"322", 216},
+    {"323", 174},
+    {"324", 174},
+    {"325", 174},
+    {"326", 46},
+    {"327", 46},
+    {"328", 173},
+    {"329", 173},
+    {"330", 173},
+    {"331", 46},
+    {"333", 174},
+    {"334", 53},
+    {"335", 31},
+    {"336", 24},
+    {"337", 57},
+    {"338", 57},
+    {"339", 57},
+    {"340", 217},
+    {"341", 218},
+    {"342", 219},
+    {"343", 139},
+    {"344", 139},
+    {"345", 220},
+    {"346", 174},
+    {"347", 25},
+    {"348", 25},
+    {"349", 25},
+    {"350", 199},
+    {"351", 25},
+    {"352", 25},
+    {"353", 216},
+    {"354", 62},
+    {"355", 36},
+    {"356", 216},
+    {"357", 216},
+    {"358", 216},
+    {"359", 216},
+    {"360", 199},
+    {"361", 55},
+    {"361_0", 55},
+    {"362", 43},
+    {"363", 231},
+    {"364", 230},
+    {"365", 37},
+    {"366", 37},
+    {"367", 37},
+    {"368", 52},
+    {"369", 52},
+    {"370", 52},
+    {"371", 52},
+    {"372", 52},
+    {"373", 52},
+    {"374", 52},
+    {"375", 52},
+    {"376", 52},
+    {"377", 167},
+    {"378", 167},
+    {"379", 52},
+    {"380", 199},
+    {"381", 167},
+    {"382", 199},
+    {"383", 232},
+    {"384", 232},
+    {"385", 232},
+    {"386", 232},
+    {"387", 232},
+    {"388", 232},
+    {"389", 232},
+    {"390", 190},
+    {"391", 232},
+    {"392", 227},
+    {"393", 190},
+    {"394", 167},
+    {"395", 148},
+    {"396", 204},
+    {"397", 47},
+    {"398", 47},
+    {"399", 232},
+    {"40", 209},
+    {"403", 17},
+    {"404", 204},
+    {"405", 110},
+    {"406", 59},
+    {"407", 114},
+    {"408", 104},
+    {"409", 32},
+    {"41", 208},
+    {"410", 184},
+    {"411", 170},
+    {"412", 171},
+    {"413", 56},
+    {"414", 30},
+    {"415", 31},
+    {"416", 232},
+    {"417", 44},
+    {"418", 212},
+    {"419", 87},
+    {"42", 232},
+    {"420", 199},
+    {"421", 87},
+    {"422", 87},
+    {"423", 87},
+    {"424", 44},
+    {"425", 25},
+    {"426", 25},
+    {"427", 25},
+    {"428", 44},
+    {"429", 32},
+    {"43", 67},
+    {"430", 44},
+    {"431", 47},
+    {"432", 57},
+    {"433", 19},
+    {"434", 57},
+    {"435", 57},
+    {"436", 57},
+    {"437", 57},
+    {"438", 57},
+    {"439", 57},
+    {"44", 64},
+    {"440", 19},
+    {"441", 33},
+    {"442", 209},
+    {"443", 214},
+    {"444", 214},
+    {"445", 194},
+    {"446", 33},
+    {"447", 198},
+    {"448", 190},
+    {"449", 26},
+    {"45", 59},
+    {"450", 33},
+    {"451", 227},
+    {"452", 209},
+    {"453", 213},
+    {"454", 227},
+    {"455", 44},
+    {"456", 190},
+    {"457", 190},
+    {"458", 192},
+    {"459", 192},
+    {"46", 59},
+    {"460", 216},
+    {"461", 216},
+    {"462", 216},
+    {"463", 182},
+    {"464", 47},
+    {"465", 13},
+    {"466", 19},
+    {"467", 30},
+    {"468", 208},
+    {"469", 47},
+    {"470", 208},
+    {"471", 26},
+    {"472", 208},
+    {"473", 199},
+    {"474", 207},
+    {"475", 19},
+    {"476", 19},
+    {"477", 44},
+    {"478", 19},
+    {"479", 194},
+    {"480", 47},
+    {"481", 232},
+    {"482", 191},
+    {"483", 202},
+    {"484", 238},
+    {"485", 44},
+    {"486", 44},
+    {"487", 44},
+    {"488", 203},
+    {"489", 204},
+    {"490", 204},
+    {"491", 25},
+    {"492", 192},
+    {"493", 192},
+    {"494", 44},
+    {"495", 227},
+    {"496", 29},
+    {"497", 173},
+    {"498", 173},
+    {"499", 11},
+    {"500", 33},
+    {"501", 33},
+    {"502", 173},
+    {"502_2", 173},
+    {"503", 232},
+    {"504", 209},
+    {"505", 192},
+    {"506", 44},
+    {"507", 27},
+    {"508", 190},
+    {"509", 47},
+    {"510", 63},
+    {"511", 25},
+    {"512", 232},
+    {"513", 204},
+    {"514", 44},
+    {"515", 87},
+    {"516", 31},
+    {"517", 86},
+    {"518", 233},
+    {"519", 53},
+    {"520", 86},
+    {"521", 86},
+    {"522", 161},
+    {"523", 86},
+    {"524", 86},
+    {"525", 209},
+    {"526", 58},
+    {"527", 215},
+    {"528", 116},
+    {"529", 228},
+    {"530", 145},
+    {"531", 22},
+    {"532", 31},
+    {"533", 44},
+    {"534", 203},
+    {"535", 25},
+    {"536", 149},
+    {"537", 92},
+    {"538", 141},
+    {"539", 124},
+    {"540", 216},
+    {"541", 164},
+    {"542", 208},
+    {"543", 208},
+    {"544", 164},
+    {"545", 164},
+    {"546", 208},
+    {"547", 164},
+    {"548", 164},
+    {"549", 208},
+    {"550", 208},
+    {"551", 208},
+    {"552", 208},
+    {"553", 164},
+    {"554", 164},
+    {"555", 208},
+    {"556", 208},
+    {"557", 164},
+    {"558", 164},
+    {"559", 164},
+    {"560", 164},
+    {"561", 208},
+    {"562", 183},
+    {"563", 208},
+    {"564", 208},
+    {"565", 208},
+    {"566", 208},
+    {"567", 208},
+    {"568", 208},
+    {"569", 208},
+    {"57", 199},
+    {"570", 227},
+    {"577", 227},
+    {"579", 208},
+    {"580", 208},
+    {"586", 208},
+    {"587", 208},
+    {"589", 208},
+    {"590", 227},
+    {"591", 208},
+    {"592", 208},
+    {"593", 112},
+    {"594", 109},
+    {"595", 109},
+    {"596", 116},
+    {"597", 116},
+    {"60", 13},
+    {"605", 19},
+    {"606", 232},
+    {"607", 190},
+    {"608", 227},
+    {"609", 232},
+    {"610", 232},
+    {"611", 232},
+    {"612", 190},
+    {"613", 232},
+    {"614", 232},
+    {"615", 47},
+    {"616", 227},
+    {"617", 227},
+    {"618", 227},
+    {"620", 182},
+    {"621", 41},
+    {"622", 41},
+    {"623", 182},
+    {"624", 182},
+    {"625", 41},
+    {"626", 85},
+    {"627", 85},
+    {"628", 85},
+    {"629", 85},
+    {"63", 199},
+    {"630", 85},
+    {"631", 85},
+    {"632", 85},
+    {"633", 85},
+    {"634", 182},
+    {"635", 183},
+    {"636", 85},
+    {"637", 182},
+    {"638", 99},
+    {"639", 99},
+    {"64", 199},
+    {"640", 99},
+    {"641", 0},
+    {"645", 199},
+    {"646", 26},
+    {"647", 164},
+    {"648", 216},
+    {"649", 85},
+    {"650", 50},
+    {"651", 223},
+    {"652", 104},
+    {"653", 104},
+    {"654", 209},
+    {"655", 209},
+    {"656", 209},
+    {"657", 114},
+    {"658", 117},
+    {"659", 59},
+    {"660", 59},
+    {"661", 95},
+    {"662", 111},
+    {"663", 107},
+    {"664", 209},
+    {"665", 117},
+    {"666", 116},
+    {"667", 59},
+    {"668", 59},
+    {"669", 114},
+    {"67", 26},
+    {"670", 107},
+    {"671", 113},
+    {"672", 114},
+    {"673", 105},
+    {"674", 190},
+    {"675", 209},
+    {"676", 209},
+    {"677", 31},
+    {"678", 135},
+    {"679", 180},
+    {"680", 180},
+    {"681", 180},
+    {"682", 19},
+    {"683", 87},
+    {"684", 87},
+    {"685", 87},
+    {"686", 186},
+    {"687", 176},
+    {"688", 176},
+    {"689", 176},
+    {"69", 26},
+    {"690", 199},
+    {"691", 167},
+    {"692", 199},
+    {"693", 26},
+    {"694", 239},
+    {"695", 239},
+    {"696", 210},
+    {"697", 210},
+    {"698", 210},
+    {"699", 210},
+    {"70", 27},
+    {"700", 199},
+    {"701", 210},
+    {"702", 183},
+    {"703", 168},
+    {"704", 168},
+    {"705", 210},
+    {"706", 170},
+    {"707", 168},
+    {"708", 169},
+    {"709", 25},
+    {"71", 208},
+    {"710", 25},
+    {"711", 29},
+    {"712", 29},
+    {"713", 208},
+    {"714", 208},
+    {"715", 208},
+    {"716", 208},
+    {"717", 182},
+    {"718", 182},
+    {"719", 182},
+    {"720", 182},
+    {"721", 182},
+    {"722", 52},
+    {"723", 182},
+    {"724", 182},
+    {"725", 182},
+    {"726", 182},
+    {"727", 182},
+    {"728", 182},
+    {"729", 183},
+    {"73", 46},
+    {"730", 183},
+    {"731", 182},
+    {"732", 182},
+    {"733", 182},
+    {"734", 182},
+    {"735", 182},
+    {"736", 182},
+    {"737", 182},
+    {"738", 182},
+    {"739", 182},
+    {"73_0", 46},
+    {"73_2", 46},
+    {"74", 198},
+    {"740", 182},
+    {"741", 182},
+    {"742", 182},
+    {"743", 166},
+    {"744", 166},
+    {"745", 199},
+    {"746", 166},
+    {"747", 42},
+    {"748", 42},
+    {"749", 166},
+    {"75", 17},
+    {"750", 42},
+    {"751", 42},
+    {"752", 234},
+    {"753", 234},
+    {"754", 234},
+    {"755", 234},
+    {"756", 46},
+    {"756_0", 46},
+    {"756_2", 46},
+    {"757", 46},
+    {"757_0", 46},
+    {"757_2", 46},
+    {"758", 46},
+    {"758_0", 46},
+    {"758_2", 46},
+    {"759", 46},
+    {"759_0", 46},
+    {"759_2", 46},
+    {"760", 46},
+    {"760_0", 46},
+    {"760_2", 46},
+    {"761", 46},
+    {"761_0", 46},
+    {"761_2", 46},
+    {"762", 46},
+    {"762_0", 46},
+    {"762_2", 46},
+    {"763", 46},
+    {"763_0", 46},
+    {"763_2", 46},
+    {"764", 46},
+    {"764_0", 46},
+    {"764_2", 46},
+    {"765", 55},
+    {"765_0", 55},
+    {"766", 234},
+    {"767", 234},
+    {"768", 46},
+    {"768_0", 46},
+    {"768_2", 46},
+    {"769", 46},
+    {"769_0", 46},
+    {"769_2", 46},
+    {"77", 17},
+    {"770", 46},
+    {"770_0", 46},
+    {"770_2", 46},
+    {"771", 55},
+    {"771_0", 55},
+    {"773", 232},
+    {"775", 52},
+    {"776", 52},
+    {"777", 52},
+    {"778", 2},
+    {"778_0", 2},
+    {"779", 2},
+    {"779_0", 2},
+    {"78", 18},
+    {"780", 2},
+    {"780_0", 2},
+    {"781", 180},
+    {"782", 202},
+    {"783", 202},
+    {"784", 202},
+    {"785", 202},
+    {"786", 182},
+    {"79", 198},
+    {"797", 187},
+    {"80", 13},
+    {"81", 13},
+    {"82", 13},
+    {"83", 212},
+    {"85", 83},
+    {"86", 114},
+    {"87", 198},
+    {"88", 32},
+    {"89", 33},
+    {"90", 33},
+    {"91", 25},
+    {"92", 114},
+    {"93", 227},
+    {"94", 114},
+    {"95", 190},
+    {"97", 192},
+    {"98", 47},
+    {"99", 114},
+    {"s__1000", 204},
+    {"s__1001", 232},
+    {"s__1002", 47},
+    {"s__1003", 208},
+    {"s__1004", 208},
+    {"s__1005", 208},
+    {"s__1006", 208},
+    {"s__1007", 208},
+    {"s__1008", 208},
+    {"s__1009", 208},
+    {"s__1010", 208},
+    {"s__1011", 208},
+    {"s__1012", 208},
+    {"s__1013", 208},
+    {"s__1014", 208},
+    {"s__1015", 208},
+    {"s__1016", 208},
+    {"s__1017", 33},
+    {"s__1018", 208},
+    {"s__1019", 32},
+    {"s__1020", 44},
+    {"s__1021", 44},
+    {"s__1022", 44},
+    {"s__1023", 44},
+    {"s__1024", 88},
+    {"s__1025", 85},
+    {"s__1026", 87},
+    {"s__1027", 85},
+    {"s__1028", 88},
+    {"s__1029", 117},
+    {"s__1030", 117},
+    {"s__1031", 116},
+    {"s__1032", 116},
+    {"s__1033", 116},
+    {"s__1034", 116},
+    {"s__1035", 117},
+    {"s__1036", 117},
+    {"s__1037", 208},
+    {"s__1038", 25},
+    {"s__1039", 30},
+    {"s__1040", 30},
+    {"s__1041", 119},
+    {"s__1042", 119},
+    {"s__1043", 119},
+    {"s__1044", 119},
+    {"s__1045", 119},
+    {"s__1046", 119},
+    {"s__1047", 119},
+    {"s__1048", 119},
+    {"s__1049", 119},
+    {"s__1050", 119},
+    {"s__1051", 106},
+    {"s__1052", 116},
+    {"s__1053", 114},
+    {"s__1054", 114},
+    {"s__1055", 103},
+    {"s__1058", 96},
+    {"s__1059", 85},
+    {"s__1060", 95},
+    {"s__1061", 192},
+    {"s__1062", 33},
+    {"s__1063", 59},
+    {"s__1065", 119},
+    {"s__1066", 108},
+    {"s__1067", 199},
+    {"s__1068", 191},
+    {"s__1069", 85},
+    {"s__1070", 85},
+    {"s__1071", 85},
+    {"s__1072", 88},
+    {"s__1073", 209},
+    {"s__1074", 33},
+    {"s__1075", 104},
+    {"s__1076", 59},
+    {"s__1077", 103},
+    {"s__1078", 116},
+    {"s__1079", 209},
+    {"s__1080", 25},
+    {"s__1081", 85},
+    {"s__1082", 85},
+    {"s__1083", 33},
+    {"s__1084", 61},
+    {"s__1085", 59},
+    {"s__1086", 59},
+    {"s__1087", 85},
+    {"s__1088", 106},
+    {"s__1089", 199},
+    {"s__1090", 188},
+    {"s__1091", 22},
+    {"s__1092", 164},
+    {"s__1093", 25},
+    {"s__1094", 164},
+    {"s__1095", 190},
+    {"s__1096", 209},
+    {"s__1097", 199},
+    {"s__1098", 209},
+    {"s__1099", 208},
+    {"s__1100", 208},
+    {"s__1101", 33},
+    {"s__1102", 86},
+    {"s__1103", 88},
+    {"s__1104", 208},
+    {"s__1105", 232},
+    {"s__1106", 208},
+    {"s__1107", 208},
+    {"s__1108", 88},
+    {"s__1109", 87},
+    {"s__1110", 53},
+    {"s__1111", 47},
+    {"s__1112", 199},
+    {"s__1113", 26},
+    {"s__1114", 85},
+    {"s__1115", 87},
+    {"s__1116", 86},
+    {"s__1117", 32},
+    {"s__1118", 208},
+    {"s__1119", 209},
+    {"s__1120", 209},
+    {"s__1121", 33},
+    {"s__1122", 208},
+    {"s__1123", 32},
+    {"s__1124", 19},
+    {"s__1125", 25},
+    {"s__1126", 199},
+    {"s__1127", 199},
+    {"s__1128", 22},
+    {"s__1129", 50},
+    {"s__1130", 208},
+    {"s__1131", 13},
+    {"s__1132", 198},
+    {"s__1133", 32},
+    {"s__1134", 190},
+    {"s__1135", 208},
+    {"s__1136", 212},
+    {"s__1137", 216},
+    {"s__1138", 213},
+    {"s__1139", 88},
+    {"s__1140", 88},
+    {"s__1141", 97},
+    {"s__1142", 116},
+    {"s__1143", 114},
+    {"s__1144", 114},
+    {"s__1145", 104},
+    {"s__1146", 102},
+    {"s__1148", 107},
+    {"s__1149", 33},
+    {"s__1150", 59},
+    {"s__1151", 59},
+    {"s__1152", 85},
+    {"s__1153", 85},
+    {"s__1154", 85},
+    {"s__1155", 88},
+    {"s__1157", 103},
+    {"s__1158", 47},
+    {"s__1159", 208},
+    {"s__1160", 88},
+    {"s__1161", 209},
+    {"s__1162", 47},
+    {"s__1163", 24},
+    {"s__1164", 25},
+    {"s__1165", 152},
+    {"s__1166", 25},
+    {"s__1167", 208},
+    {"s__1168", 152},
+    {"s__1169", 208},
+    {"s__1170", 209},
+    {"s__1171", 199},
+    {"s__1172", 26},
+    {"s__1173", 24},
+    {"s__1174", 86},
+    {"s__1175", 24},
+    {"s__1176", 25},
+    {"s__1177", 199},
+    {"s__1178", 85},
+    {"s__1179", 209},
+    {"s__1180", 208},
+    {"s__1183", 232},
+    {"s__1184", 232},
+    {"s__1185", 191},
+    {"s__1186", 232},
+    {"s__1187", 191},
+    {"s__1188", 232},
+    {"s__1189", 232},
+    {"s__1190", 232},
+    {"s__1192", 232},
+    {"s__1193", 232},
+    {"s__1195", 232},
+    {"s__1196", 232},
+    {"s__1197", 191},
+    {"s__1198", 232},
+    {"s__1199", 191},
+    {"s__1200", 191},
+    {"s__1201", 236},
+    {"s__1202", 191},
+    {"s__1203", 191},
+    {"s__1204", 191},
+    {"s__1205", 191},
+    {"s__1206", 232},
+    {"s__1207", 232},
+    {"s__1208", 191},
+    {"s__1209", 191},
+    {"s__1210", 191},
+    {"s__1211", 192},
+    {"s__1212", 191},
+    {"s__1213", 191},
+    {"s__1214", 232},
+    {"s__1215", 232},
+    {"s__1216", 232},
+    {"s__1217", 232},
+    {"s__1218", 232},
+    {"s__1219", 232},
+    {"s__1220", 232},
+    {"s__1221", 232},
+    {"s__1222", 44},
+    {"s__1223", 192},
+    {"s__1224", 192},
+    {"s__1225", 44},
+    {"s__1226", 192},
+    {"s__1227", 191},
+    {"s__1228", 191},
+    {"s__1230", 232},
+    {"s__1231", 232},
+    {"s__1232", 232},
+    {"s__1234", 232},
+    {"s__1235", 232},
+    {"s__1237", 232},
+    {"s__1239", 191},
+    {"s__1240", 191},
+    {"s__1241", 232},
+    {"s__1242", 204},
+    {"s__1243", 48},
+    {"s__1244", 232},
+    {"s__1245", 232},
+    {"s__1246", 17},
+    {"s__1247", 17},
+    {"s__1248", 13},
+    {"s__1249", 198},
+    {"s__1250", 212},
+    {"s__1251", 213},
+    {"s__1252", 195},
+    {"s__1253", 232},
+    {"s__1254", 33},
+    {"s__1255", 85},
+    {"s__1256", 88},
+    {"s__1257", 88},
+    {"s__1258", 237},
+    {"s__1259", 237},
+    {"s__1260", 237},
+    {"s__1261", 237},
+    {"s__1262", 237},
+    {"s__1265", 237},
+    {"s__1268", 88},
+    {"s__1269", 152},
+    {"s__1270", 198},
+    {"s__1271", 88},
+    {"s__1272", 152},
+    {"s__1273", 198},
+    {"s__1274", 88},
+    {"s__1275", 152},
+    {"s__1276", 152},
+    {"s__1277", 198},
+    {"s__1278", 88},
+    {"s__1279", 198},
+    {"s__1280", 88},
+    {"s__1281", 47},
+    {"s__1282", 88},
+    {"s__1283", 198},
+    {"s__1284", 13},
+    {"s__1285", 195},
+    {"s__1286", 199},
+    {"s__1287", 208},
+    {"s__1288", 26},
+    {"s__1289", 164},
+    {"s__1290", 199},
+    {"s__1291", 228},
+    {"s__1292", 85},
+    {"s__1293", 152},
+    {"s__1294", 47},
+    {"s__1295", 209},
+    {"s__1296", 86},
+    {"s__1297", 87},
+    {"s__1298", 208},
+    {"s__1299", 232},
+    {"s__1300", 190},
+    {"s__1301", 228},
+    {"s__1302", 17},
+    {"s__1303", 26},
+    {"s__1304", 44},
+    {"s__1305", 33},
+    {"s__1306", 87},
+    {"s__1307", 204},
+    {"s__1308", 164},
+    {"s__1309", 54},
+    {"s__1310", 88},
+    {"s__1311", 87},
+    {"s__1312", 152},
+    {"s__1313", 53},
+    {"s__1314", 32},
+    {"s__1315", 203},
+    {"s__1316", 208},
+    {"s__1317", 208},
+    {"s__1318", 87},
+    {"s__1319", 13},
+    {"s__1320", 198},
+    {"s__1321", 7},
+    {"s__1322", 195},
+    {"s__1323", 198},
+    {"s__1324", 164},
+    {"s__1325", 88},
+    {"s__1326", 10},
+    {"s__1327", 10},
+    {"s__1328", 152},
+    {"s__1329", 88},
+    {"s__1330", 199},
+    {"s__1331", 164},
+    {"s__1332", 208},
+    {"s__1333", 85},
+    {"s__1334", 24},
+    {"s__1335", 182},
+    {"s__1336", 227},
+    {"s__1337", 25},
+    {"s__1338", 44},
+    {"s__1339", 152},
+    {"s__1340", 26},
+    {"s__1341", 87},
+    {"s__1342", 87},
+    {"s__1343", 216},
+    {"s__1344", 222},
+    {"s__1345", 216},
+    {"s__1346", 216},
+    {"s__1347", 216},
+    {"s__1348", 216},
+    {"s__1349", 216},
+    {"s__1350", 216},
+    {"s__1351", 216},
+    {"s__1352", 216},
+    {"s__1353", 44},
+    {"s__1354", 44},
+    {"s__1355", 232},
+    {"s__1356", 232},
+    {"s__1357", 232},
+    {"s__1358", 232},
+    {"s__1359", 232},
+    {"s__1360", 232},
+    {"s__1361", 232},
+    {"s__1362", 190},
+    {"s__1363", 44},
+    {"s__1364", 44},
+    {"s__1365", 44},
+    {"s__1366", 44},
+    {"s__1367", 44},
+    {"s__1368", 44},
+    {"s__1369", 232},
+    {"s__1370", 203},
+    {"s__1371", 232},
+    {"s__1372", 44},
+    {"s__1374", 44},
+    {"s__1377", 44},
+    {"s__1378", 232},
+    {"s__1379", 232},
+    {"s__1382", 232},
+    {"s__1384", 203},
+    {"s__1392", 44},
+    {"s__1393", 44},
+    {"s__1394", 44},
+    {"s__1396", 207},
+    {"s__1398", 232},
+    {"s__1399", 232},
+    {"s__1400", 191},
+    {"s__1401", 191},
+    {"s__1402", 191},
+    {"s__1403", 191},
+    {"s__1404", 232},
+    {"s__1405", 232},
+    {"s__1406", 232},
+    {"s__1407", 232},
+    {"s__1408", 232},
+    {"s__1410", 190},
+    {"s__1411", 190},
+    {"s__1412", 190},
+    {"s__1413", 232},
+    {"s__1414", 232},
+    {"s__1415", 203},
+    {"s__1416", 203},
+    {"s__1418", 44},
+    {"s__1419", 44},
+    {"s__1422", 44},
+    {"s__1423", 44},
+    {"s__1426", 44},
+    {"s__1427", 44},
+    {"s__1428", 44},
+    {"s__1429", 44},
+    {"s__1431", 207},
+    {"s__1432", 207},
+    {"s__1433", 207},
+    {"s__1434", 216},
+    {"s__1435", 190},
+    {"s__1438", 207},
+    {"s__1439", 207},
+    {"s__1443", 203},
+    {"s__1445", 191},
+    {"s__1446", 232},
+    {"s__1448", 191},
+    {"s__1452", 44},
+    {"s__1461", 44},
+    {"s__1462", 216},
+    {"s__1465", 232},
+    {"s__1467", 232},
+    {"s__1473", 44},
+    {"s__1474", 44},
+    {"s__1476", 44},
+    {"s__1486", 203},
+    {"s__1487", 44},
+    {"s__1490", 152},
+    {"s__1491", 152},
+    {"s__1492", 58},
+    {"s__1493", 204},
+    {"s__1494", 204},
+    {"s__1495", 44},
+    {"s__1496", 44},
+    {"s__1497", 232},
+    {"s__1498", 232},
+    {"s__1499", 44},
+    {"s__1500", 235},
+    {"s__1501", 17},
+    {"s__1502", 17},
+    {"s__1503", 18},
+    {"s__1504", 31},
+    {"s__1505", 33},
+    {"s__1506", 33},
+    {"s__1507", 31},
+    {"s__1508", 31},
+    {"s__1509", 232},
+    {"s__1510", 44},
+    {"s__1511", 232},
+    {"s__1512", 232},
+    {"s__1513", 232},
+    {"s__1514", 191},
+    {"s__1515", 203},
+    {"s__1516", 44},
+    {"s__1517", 227},
+    {"s__1518", 44},
+    {"s__1519", 31},
+    {"s__1520", 31},
+    {"s__1521", 31},
+    {"s__1522", 31},
+    {"s__1523", 31},
+    {"s__1524", 31},
+    {"s__1525", 31},
+    {"s__1526", 31},
+    {"s__1527", 31},
+    {"s__1528", 31},
+    {"s__1529", 31},
+    {"s__1531", 31},
+    {"s__1532", 31},
+    {"s__1533", 31},
+    {"s__1534", 31},
+    {"s__1535", 31},
+    {"s__1536", 31},
+    {"s__1537", 31},
+    {"s__1539", 31},
+    {"s__1540", 216},
+    {"s__1541", 182},
+    {"s__1542", 167},
+    {"s__1543", 182},
+    {"s__1544", 152},
+    {"s__1545", 56},
+    {"s__1546", 208},
+    {"s__1547", 19},
+    {"s__1548", 108},
+    {"s__1549", 34},
+    {"s__1550", 25},
+    {"s__1551", 203},
+    {"s__1552", 198},
+    {"s__1553", 13},
+    {"s__1554", 224},
+    {"s__1555", 195},
+    {"s__1556", 152},
+    {"s__1557", 85},
+    {"s__1558", 88},
+    {"s__1559", 152},
+    {"s__1560", 216},
+    {"s__1561", 164},
+    {"s__1562", 17},
+    {"s__1563", 177},
+    {"s__1631", 177},
+    {"s__1632", 177},
+    {"s__1633", 179},
+    {"s__1634", 175},
+    {"s__1635", 176},
+    {"s__1636", 177},
+    {"s__1637", 178},
+    {"s__1638", 176},
+    {"s__1639", 219},
+    {"s__1640", 175},
+    {"s__1641", 34},
+    {"s__1642", 34},
+    {"s__1643", 34},
+    {"s__1644", 216},
+    {"s__1645", 68},
+    {"s__1646", 216},
+    {"s__1647", 188},
+    {"s__1648", 81},
+    {"s__1649", 76},
+    {"s__1650", 181},
+    {"s__1651", 181},
+    {"s__1652", 181},
+    {"s__1653", 181},
+    {"s__1654", 181},
+    {"s__1655", 216},
+    {"s__1656", 216},
+    {"s__1657", 216},
+    {"s__1658", 216},
+    {"s__1659", 216},
+    {"s__1660", 129},
+    {"s__1661", 216},
+    {"s__1662", 216},
+    {"s__1663", 216},
+    {"s__1664", 47},
+    {"s__1665", 26},
+    {"s__1666", 25},
+    {"s__1667", 209},
+    {"s__1668", 25},
+    {"s__1669", 208},
+    {"s__1670", 53},
+    {"s__1671", 47},
+    {"s__1672", 199},
+    {"s__1673", 164},
+    {"s__1674", 199},
+    {"s__1675", 86},
+    {"s__1676", 85},
+    {"s__1677", 87},
+    {"s__1678", 87},
+    {"s__1679", 25},
+    {"s__1680", 212},
+    {"s__1681", 212},
+    {"s__1682", 212},
+    {"s__1683", 203},
+    {"s__1684", 212},
+    {"s__1685", 198},
+    {"s__1686", 198},
+    {"s__1687", 152},
+    {"s__1688", 152},
+    {"s__1689", 198},
+    {"s__1690", 198},
+    {"s__1691", 198},
+    {"s__1692", 198},
+    {"s__1693", 13},
+    {"s__1694", 13},
+    {"s__1695", 13},
+    {"s__1696", 13},
+    {"s__1697", 13},
+    {"s__1698", 87},
+    {"s__1699", 85},
+    {"s__1700", 25},
+    {"s__1701", 24},
+    {"s__1702", 209},
+    {"s__1703", 85},
+    {"s__1704", 17},
+    {"s__1705", 32},
+    {"s__1706", 232},
+    {"s__1707", 85},
+    {"s__1708", 85},
+    {"s__1709", 86},
+    {"s__1710", 25},
+    {"s__1711", 24},
+    {"s__1712", 24},
+    {"s__1713", 47},
+    {"s__1714", 17},
+    {"s__1715", 24},
+    {"s__1716", 209},
+    {"s__1717", 24},
+    {"s__1718", 209},
+    {"s__1719", 86},
+    {"s__1720", 208},
+    {"s__1721", 87},
+    {"s__1722", 230},
+    {"s__1723", 230},
+    {"s__1724", 230},
+    {"s__1725", 230},
+    {"s__1726", 44},
+    {"s__1727", 44},
+    {"s__1728", 203},
+    {"s__1730", 44},
+    {"s__1732", 47},
+    {"s__1735", 44},
+    {"s__1736", 203},
+    {"s__1737", 44},
+    {"s__1738", 40},
+    {"s__1739", 44},
+    {"s__1741", 209},
+    {"s__1742", 44},
+    {"s__1743", 232},
+    {"s__1744", 232},
+    {"s__1745", 232},
+    {"s__1746", 31},
+    {"s__1747", 31},
+    {"s__1748", 33},
+    {"s__1749", 26},
+    {"s__1750", 199},
+    {"s__1751", 199},
+    {"s__1752", 229},
+    {"s__1753", 229},
+    {"s__1760", 205},
+    {"s__1761", 32},
+    {"s__1762", 46},
+    {"s__1762_0", 46},
+    {"s__1762_2", 46},
+    {"s__1763", 46},
+    {"s__1763_0", 46},
+    {"s__1763_2", 46},
+    {"s__1764", 46},
+    {"s__1764_0", 46},
+    {"s__1764_2", 46},
+    {"s__1765", 46},
+    {"s__1765_0", 46},
+    {"s__1765_2", 46},
+    {"s__1766", 46},
+    {"s__1766_0", 46},
+    {"s__1766_2", 46},
+    {"s__1767", 46},
+    {"s__1767_0", 46},
+    {"s__1767_2", 46},
+    {"s__1768", 46},
+    {"s__1768_0", 46},
+    {"s__1768_2", 46},
+    {"s__1769", 46},
+    {"s__1769_0", 46},
+    {"s__1769_2", 46},
+    {"s__1770", 46},
+    {"s__1770_0", 46},
+    {"s__1770_2", 46},
+    {"s__1771", 46},
+    {"s__1771_0", 46},
+    {"s__1771_2", 46},
+    {"s__1772", 46},
+    {"s__1772_0", 46},
+    {"s__1772_2", 46},
+    {"s__1773", 46},
+    {"s__1773_0", 46},
+    {"s__1773_2", 46},
+    {"s__1774", 17},
+    {"s__1775", 17},
+    {"s__1776", 17},
+    {"s__1777", 17},
+    {"s__1778", 232},
+    {"s__1779", 174},
+    {"s__1780", 174},
+    {"s__1781", 174},
+    {"s__1782", 174},
+    {"s__1783", 174},
+    {"s__1784", 174},
+    {"s__1785", 174},
+    {"s__1786", 174},
+    {"s__1787", 174},
+    {"s__1788", 174},
+    {"s__1789", 203},
+    {"s__1790", 232},
+    {"s__1791", 17},
+    {"s__1792", 17},
+    {"s__1793", 228},
+    {"s__1794", 228},
+    {"s__1795", 228},
+    {"s__1796", 228},
+    {"s__1797", 228},
+    {"s__1798", 228},
+    {"s__1799", 228},
+    {"s__1800", 228},
+    {"s__1801", 228},
+    {"s__1802", 228},
+    {"s__1803", 228},
+    {"s__1804", 228},
+    {"s__1805", 228},
+    {"s__1806", 228},
+    {"s__1807", 228},
+    {"s__1808", 228},
+    {"s__1809", 228},
+    {"s__1810", 228},
+    {"s__1811", 228},
+    {"s__1812", 228},
+    {"s__1813", 150},
+    {"s__1814", 66},
+    {"s__1815", 65},
+    {"s__1816", 71},
+    {"s__1817", 226},
+    {"s__1818", 216},
+    {"s__1819", 81},
+    {"s__1820", 79},
+    {"s__1821", 69},
+    {"s__1822", 70},
+    {"s__1823", 193},
+    {"s__1824", 128},
+    {"s__1825", 133},
+    {"s__1826", 138},
+    {"s__1827", 126},
+    {"s__1828", 149},
+    {"s__1829", 146},
+    {"s__1830", 140},
+    {"s__1831", 134},
+    {"s__1832", 147},
+    {"s__1833", 127},
+    {"s__1834", 137},
+    {"s__1835", 125},
+    {"s__1836", 135},
+    {"s__1837", 208},
+    {"s__1838", 87},
+    {"s__1839", 85},
+    {"s__1840", 87},
+    {"s__1841", 85},
+    {"s__1842", 17},
+    {"s__1843", 17},
+    {"s__1844", 122},
+    {"s__1845", 225},
+    {"s__1846", 225},
+    {"s__1847", 225},
+    {"s__1848", 225},
+    {"s__1849", 142},
+    {"s__1850", 132},
+    {"s__1851", 144},
+    {"s__1852", 225},
+    {"s__1853", 225},
+    {"s__1854", 26},
+    {"s__1855", 225},
+    {"s__1856", 225},
+    {"s__1857", 225},
+    {"s__1858", 216},
+    {"s__1859", 216},
+    {"s__1860", 22},
+    {"s__1861", 22},
+    {"s__1862", 22},
+    {"s__1863", 22},
+    {"s__1864", 22},
+    {"s__1865", 225},
+    {"s__1866", 225},
+    {"s__1867", 216},
+    {"s__1868", 216},
+    {"s__1869", 216},
+    {"s__1870", 216},
+    {"s__1871", 209},
+    {"s__1872", 208},
+    {"s__1873", 19},
+    {"s__1874", 209},
+    {"s__1875", 152},
+    {"s__1876", 26},
+    {"s__1877", 33},
+    {"s__1878", 86},
+    {"s__1879", 199},
+    {"s__1880", 87},
+    {"s__1881", 85},
+    {"s__1882", 199},
+    {"s__1883", 85},
+    {"s__1884", 47},
+    {"s__1885", 25},
+    {"s__1886", 24},
+    {"s__1887", 164},
+    {"s__1888", 208},
+    {"s__1889", 227},
+    {"s__1890", 58},
+    {"s__1891", 58},
+    {"s__1892", 208},
+    {"s__1893", 209},
+    {"s__1894", 208},
+    {"s__1895", 41},
+    {"s__1895_0", 41},
+    {"s__1896", 41},
+    {"s__1896_0", 41},
+    {"s__1897", 41},
+    {"s__1897_0", 41},
+    {"s__1898", 41},
+    {"s__1898_0", 41},
+    {"s__1899", 41},
+    {"s__1899_0", 41},
+    {"s__1900", 41},
+    {"s__1900_0", 41},
+    {"s__1901", 41},
+    {"s__1902", 41},
+    {"s__1902_0", 41},
+    {"s__1903", 41},
+    {"s__1903_0", 41},
+    {"s__1904", 231},
+    {"s__1905", 25},
+    {"s__1906", 24},
+    {"s__1907", 207},
+    {"s__1908", 19},
+    {"s__1909", 24},
+    {"s__1910", 53},
+    {"s__1911", 172},
+    {"s__1912", 207},
+    {"s__1913", 167},
+    {"s__1914", 85},
+    {"s__1915", 19},
+    {"s__1916", 208},
+    {"s__1917", 167},
+    {"s__1918", 164},
+    {"s__1919", 207},
+    {"s__1920", 19},
+    {"s__1921", 85},
+    {"s__1922", 173},
+    {"s__1923", 235},
+    {"s__1924", 192},
+    {"s__1925", 203},
+    {"s__1926", 19},
+    {"s__1927", 25},
+    {"s__1928", 209},
+    {"s__1929", 209},
+    {"s__1930", 58},
+    {"s__1931", 33},
+    {"s__1932", 25},
+    {"s__1933", 22},
+    {"s__1934", 107},
+    {"s__1935", 85},
+    {"s__1936", 74},
+    {"s__1937", 152},
+    {"s__1938", 164},
+    {"s__1939", 13},
+    {"s__1940", 44},
+    {"s__1941", 203},
+    {"s__1942", 198},
+    {"s__1943", 198},
+    {"s__1944", 88},
+    {"s__1945", 88},
+    {"s__1946", 198},
+    {"s__1947", 197},
+    {"s__1948", 196},
+    {"s__1949", 35},
+    {"s__1950", 49},
+    {"s__1951", 40},
+    {"s__1952", 40},
+    {"s__1953", 40},
+    {"s__1954", 185},
+    {"s__1955", 185},
+    {"s__1956", 77},
+    {"s__1957", 174},
+    {"s__1958", 174},
+    {"s__1959", 174},
+    {"s__1960", 174},
+    {"s__1961", 174},
+    {"s__1962", 174},
+    {"s__1963", 216},
+    {"s__1964", 221},
+    {"s__1965", 78},
+    {"s__1966", 93},
+    {"s__1967", 90},
+    {"s__1968", 92},
+    {"s__1969", 100},
+    {"s__1970", 92},
+    {"s__1971", 89},
+    {"s__1972", 92},
+    {"s__1973", 98},
+    {"s__1974", 53},
+    {"s__1975", 203},
+    {"s__1976", 17},
+    {"s__1977", 85},
+    {"s__1978", 152},
+    {"s__1979", 164},
+    {"s__1980", 208},
+    {"s__1981", 203},
+    {"s__1982", 208},
+    {"s__1983", 87},
+    {"s__1984", 227},
+    {"s__1985", 26},
+    {"s__1986", 227},
+    {"s__1987", 209},
+    {"s__1988", 208},
+    {"s__1989", 208},
+    {"s__1990", 24},
+    {"s__1991", 199},
+    {"s__1992", 208},
+    {"s__1993", 199},
+    {"s__1994", 22},
+    {"s__1995", 85},
+    {"s__1996", 18},
+    {"s__1997", 204},
+    {"s__1998", 164},
+    {"s__1999", 164},
+    {"s__2000", 164},
+    {"s__2001", 18},
+    {"s__2002", 17},
+    {"s__2003", 30},
+    {"s__2004", 33},
+    {"s__2005", 44},
+    {"s__2006", 203},
+    {"s__2007", 152},
+    {"s__2008", 87},
+    {"s__2009", 87},
+    {"s__2010", 234},
+    {"s__2011", 234},
+    {"s__2012", 234},
+    {"s__2013", 234},
+    {"s__2014", 234},
+    {"s__2015", 234},
+    {"s__2016", 234},
+    {"s__2017", 234},
+    {"s__2019", 234},
+    {"s__2020", 204},
+    {"s__2021", 47},
+    {"s__2022", 191},
+    {"s__2023", 208},
+    {"s__2024", 88},
+    {"s__2025", 152},
+    {"s__2026", 22},
+    {"s__2027", 208},
+    {"s__2028", 87},
+    {"s__2029", 180},
+    {"s__2030", 25},
+    {"s__2031", 156},
+    {"s__2032", 157},
+    {"s__2033", 155},
+    {"s__2034", 158},
+    {"s__2035", 160},
+    {"s__2036", 154},
+    {"s__2037", 163},
+    {"s__2038", 17},
+    {"s__2039", 203},
+    {"s__2040", 116},
+    {"s__2041", 41},
+    {"s__2042", 47},
+    {"s__2043", 232},
+    {"s__2044", 232},
+    {"s__2045", 48},
+    {"s__2046", 209},
+    {"s__2047", 204},
+    {"s__2048", 17},
+    {"s__2049", 33},
+    {"s__2050", 58},
+    {"s__2051", 204},
+    {"s__2052", 232},
+    {"s__2053", 47},
+    {"s__2054", 232},
+    {"s__2055", 17},
+    {"s__2056", 232},
+    {"s__2057", 232},
+    {"s__2058", 47},
+    {"s__2059", 26},
+    {"s__2060", 199},
+    {"s__2061", 26},
+    {"s__2062", 26},
+    {"s__2083", 216},
+    {"s__2084", 216},
+    {"s__2085", 216},
+    {"s__2086", 216},
+    {"s__2087", 216},
+    {"s__2088", 216},
+    {"s__2089", 17},
+    {"s__2090", 47},
+    {"s__2091", 47},
+    {"s__2092", 232},
+    {"s__2093", 191},
+    {"s__2094", 191},
+    {"s__2095", 227},
+    {"s__2096", 227},
+    {"s__2097", 204},
+    {"s__2098", 204},
+    {"s__2099", 204},
+    {"s__2100", 204},
+    {"s__2101", 203},
+    {"s__2103", 232},
+    {"s__2104", 227},
+    {"s__2105", 232},
+    {"s__2106", 227},
+    {"s__2107", 227},
+    {"s__2108", 192},
+    {"s__2109", 192},
+    {"s__2110", 208},
+    {"s__2111", 203},
+    {"s__2112", 227},
+    {"s__2113", 44},
+    {"s__2114", 236},
+    {"s__2115", 44},
+    {"s__2116", 44},
+    {"s__2117", 44},
+    {"s__2118", 44},
+    {"s__2119", 44},
+    {"s__2120", 208},
+    {"s__2121", 208},
+    {"s__2122", 227},
+    {"s__2123", 236},
+    {"s__2124", 227},
+    {"s__2125", 237},
+    {"s__2126", 190},
+    {"s__2127", 227},
+    {"s__2129", 227},
+    {"s__2130", 190},
+    {"s__2131", 190},
+    {"s__2132", 17},
+    {"s__2133", 236},
+    {"s__2134", 237},
+    {"s__2135", 237},
+    {"s__2136", 237},
+    {"s__2137", 237},
+    {"s__2138", 237},
+    {"s__2139", 236},
+    {"s__2140", 236},
+    {"s__2141", 237},
+    {"s__2142", 190},
+    {"s__2143", 237},
+    {"s__2144", 237},
+    {"s__2145", 44},
+    {"s__2146", 190},
+    {"s__2147", 237},
+    {"s__2148", 236},
+    {"s__2149", 237},
+    {"s__2150", 237},
+    {"s__2151", 237},
+    {"s__2153", 44},
+    {"s__2154", 44},
+    {"s__2155", 44},
+    {"s__2156", 199},
+    {"s__2157", 199},
+    {"s__2158", 199},
+    {"s__2159", 199},
+    {"s__2160", 199},
+    {"s__2161", 199},
+    {"s__2162", 199},
+    {"s__2163", 199},
+    {"s__2164", 199},
+    {"s__2165", 199},
+    {"s__2166", 199},
+    {"s__2167", 26},
+    {"s__2168", 25},
+    {"s__2169", 24},
+    {"s__2170", 24},
+    {"s__2171", 199},
+    {"s__2172", 26},
+    {"s__2173", 199},
+    {"s__2174", 25},
+    {"s__2175", 26},
+    {"s__2176", 199},
+    {"s__2177", 24},
+    {"s__2178", 25},
+    {"s__2179", 25},
+    {"s__2180", 25},
+    {"s__2181", 164},
+    {"s__2182", 164},
+    {"s__2183", 25},
+    {"s__2184", 164},
+    {"s__2185", 25},
+    {"s__2186", 164},
+    {"s__2187", 25},
+    {"s__2188", 33},
+    {"s__2189", 33},
+    {"s__2190", 25},
+    {"s__2191", 24},
+    {"s__2192", 33},
+    {"s__2193", 25},
+    {"s__2194", 25},
+    {"s__2195", 30},
+    {"s__2196", 26},
+    {"s__2197", 25},
+    {"s__2235", 199},
+    {"s__2236", 164},
+    {"s__2237", 19},
+    {"s__2238", 237},
+    {"s__2240", 191},
+    {"s__2241", 191},
+    {"s__2244", 44},
+    {"s__2245", 44},
+    {"s__2254", 216},
+    {"s__2255", 25},
+    {"s__2256", 25},
+    {"s__2257", 32},
+    {"s__2258", 19},
+    {"s__2259", 30},
+    {"s__2260", 19},
+    {"s__2261", 33},
+    {"s__2262", 25},
+    {"s__2263", 25},
+    {"s__2264", 30},
+    {"s__2265", 33},
+    {"s__2266", 25},
+    {"s__2267", 164},
+    {"s__2268", 199},
+    {"s__2269", 25},
+    {"s__2270", 164},
+    {"s__2271", 25},
+    {"s__2272", 33},
+    {"s__2273", 53},
+    {"s__2274", 53},
+    {"s__2275", 53},
+    {"s__2276", 53},
+    {"s__2277", 53},
+    {"s__2278", 53},
+    {"s__2279", 53},
+    {"s__2280", 53},
+    {"s__2281", 53},
+    {"s__2282", 53},
+    {"s__2283", 53},
+    {"s__2284", 53},
+    {"s__2285", 53},
+    {"s__2286", 54},
+    {"s__2287", 208},
+    {"s__2288", 208},
+    {"s__2289", 208},
+    {"s__2290", 23},
+    {"s__2291", 23},
+    {"s__2292", 208},
+    {"s__2293", 208},
+    {"s__2294", 203},
+    {"s__2295", 208},
+    {"s__2296", 208},
+    {"s__2297", 208},
+    {"s__2298", 208},
+    {"s__2299", 208},
+    {"s__2300", 208},
+    {"s__2301", 208},
+    {"s__2302", 190},
+    {"s__2303", 192},
+    {"s__2304", 203},
+    {"s__2305", 6},
+    {"s__2306", 84},
+    {"s__2307", 8},
+    {"s__2308", 4},
+    {"s__2309", 12},
+    {"s__2310", 5},
+    {"s__2311", 6},
+    {"s__2312", 10},
+    {"s__2313", 9},
+    {"s__2314", 3},
+    {"s__2315", 216},
+    {"s__2316", 43},
+    {"s__2317", 216},
+    {"s__2318", 131},
+    {"s__2319", 123},
+    {"s__2320", 216},
+    {"s__2321", 132},
+    {"s__2322", 19},
+    {"s__2323", 19},
+    {"s__2324", 19},
+    {"s__2325", 19},
+    {"s__2326", 19},
+    {"s__2327", 19},
+    {"s__2328", 19},
+    {"s__2329", 19},
+    {"s__2330", 19},
+    {"s__2331", 19},
+    {"s__2332", 19},
+    {"s__2333", 19},
+    {"s__2334", 216},
+    {"s__2335", 80},
+    {"s__2336", 75},
+    {"s__2337", 189},
+    {"s__2338", 151},
+    {"s__2339", 118},
+    {"s__2340", 32},
+    {"s__2341", 32},
+    {"s__2342", 173},
+    {"s__2343", 173},
+    {"s__2344", 47},
+    {"s__2345", 189},
+    {"s__2346", 32},
+    {"s__2347", 17},
+    {"s__2348", 172},
+    {"s__2349", 172},
+    {"s__2350", 208},
+    {"s__2351", 191},
+    {"s__2352", 232},
+    {"s__2353", 232},
+    {"s__2354", 232},
+    {"s__2355", 232},
+    {"s__2356", 232},
+    {"s__2357", 34},
+    {"s__2358", 52},
+    {"s__2359", 165},
+    {"s__2360", 56},
+    {"s__2361", 56},
+    {"s__2362", 52},
+    {"s__2363", 216},
+    {"s__2364", 34},
+    {"s__2365", 34},
+    {"s__2366", 34},
+    {"s__2367", 34},
+    {"s__2368", 85},
+    {"s__2369", 85},
+    {"s__2370", 85},
+    {"s__2371", 85},
+    {"s__2372", 85},
+    {"s__2373", 87},
+    {"s__2374", 86},
+    {"s__2375", 23},
+    {"s__2376", 23},
+    {"s__2377", 23},
+    {"s__2378", 23},
+    {"s__2379", 23},
+    {"s__2380", 23},
+    {"s__2381", 23},
+    {"s__2382", 23},
+    {"s__2383", 23},
+    {"s__2384", 23},
+    {"s__2385", 23},
+    {"s__2386", 23},
+    {"s__2387", 23},
+    {"s__2388", 190},
+    {"s__2389", 190},
+    {"s__2390", 190},
+    {"s__2391", 190},
+    {"s__2392", 190},
+    {"s__2393", 190},
+    {"s__2394", 190},
+    {"s__2395", 190},
+    {"s__2396", 190},
+    {"s__2397", 190},
+    {"s__2398", 190},
+    {"s__2399", 190},
+    {"s__2400", 190},
+    {"s__2401", 190},
+    {"s__2402", 190},
+    {"s__2403", 190},
+    {"s__2404", 232},
+    {"s__2405", 190},
+    {"s__2406", 190},
+    {"s__2407", 204},
+    {"s__2408", 199},
+    {"s__2409", 199},
+    {"s__2410", 199},
+    {"s__2411", 199},
+    {"s__2412", 200},
+    {"s__2413", 25},
+    {"s__2414", 25},
+    {"s__2415", 26},
+    {"s__2416", 26},
+    {"s__2417", 164},
+    {"s__2418", 164},
+    {"s__2419", 19},
+    {"s__2420", 164},
+    {"s__2421", 164},
+    {"s__2422", 164},
+    {"s__2423", 164},
+    {"s__2424", 24},
+    {"s__2425", 200},
+    {"s__2426", 30},
+    {"s__2427", 199},
+    {"s__2428", 205},
+    {"s__2429", 25},
+    {"s__2430", 30},
+    {"s__2431", 30},
+    {"s__2432", 30},
+    {"s__2433", 30},
+    {"s__2434", 25},
+    {"s__2435", 24},
+    {"s__2436", 26},
+    {"s__2437", 25},
+    {"s__2438", 164},
+    {"s__2439", 199},
+    {"s__2440", 199},
+    {"s__2441", 199},
+    {"s__2442", 24},
+    {"s__2443", 24},
+    {"s__2444", 57},
+    {"s__2445", 232},
+    {"s__2446", 232},
+    {"s__2447", 232},
+    {"s__2448", 232},
+    {"s__2449", 232},
+    {"s__2450", 203},
+    {"s__2451", 232},
+    {"s__2452", 232},
+    {"s__2453", 190},
+    {"s__2617", 232},
+    {"s__2619", 232},
+    {"s__2620", 232},
+    {"s__2622", 232},
+    {"s__2623", 232},
+    {"s__361", 199},
+    {"s__362", 199},
+    {"s__363", 199},
+    {"s__364", 199},
+    {"s__365", 199},
+    {"s__366", 201},
+    {"s__367", 199},
+    {"s__368", 201},
+    {"s__369", 199},
+    {"s__370", 199},
+    {"s__371", 199},
+    {"s__372", 199},
+    {"s__373", 199},
+    {"s__374", 199},
+    {"s__375", 199},
+    {"s__376", 199},
+    {"s__377", 199},
+    {"s__378", 199},
+    {"s__379", 199},
+    {"s__380", 199},
+    {"s__382", 199},
+    {"s__383", 199},
+    {"s__384", 199},
+    {"s__385", 199},
+    {"s__386", 199},
+    {"s__387", 44},
+    {"s__388", 45},
+    {"s__389", 47},
+    {"s__390", 44},
+    {"s__391", 232},
+    {"s__392", 45},
+    {"s__393", 190},
+    {"s__394", 26},
+    {"s__395", 26},
+    {"s__396", 190},
+    {"s__397", 232},
+    {"s__398", 190},
+    {"s__399", 26},
+    {"s__400", 18},
+    {"s__401", 18},
+    {"s__402", 198},
+    {"s__403", 18},
+    {"s__404", 16},
+    {"s__405", 198},
+    {"s__406", 18},
+    {"s__407", 14},
+    {"s__408", 14},
+    {"s__409", 198},
+    {"s__410", 198},
+    {"s__411", 190},
+    {"s__412", 190},
+    {"s__413", 190},
+    {"s__414", 190},
+    {"s__415", 190},
+    {"s__416", 17},
+    {"s__417", 17},
+    {"s__418", 17},
+    {"s__419", 17},
+    {"s__420", 16},
+    {"s__421", 24},
+    {"s__422", 15},
+    {"s__423", 32},
+    {"s__424", 33},
+    {"s__425", 32},
+    {"s__426", 33},
+    {"s__427", 33},
+    {"s__428", 15},
+    {"s__429", 232},
+    {"s__430", 47},
+    {"s__431", 232},
+    {"s__432", 232},
+    {"s__433", 85},
+    {"s__434", 208},
+    {"s__435", 209},
+    {"s__436", 85},
+    {"s__437", 227},
+    {"s__438", 227},
+    {"s__439", 204},
+    {"s__440", 204},
+    {"s__441", 204},
+    {"s__442", 204},
+    {"s__443", 203},
+    {"s__444", 232},
+    {"s__445", 190},
+    {"s__446", 227},
+    {"s__447", 227},
+    {"s__448", 227},
+    {"s__449", 190},
+    {"s__450", 191},
+    {"s__451", 85},
+    {"s__452", 227},
+    {"s__453", 29},
+    {"s__454", 47},
+    {"s__455", 47},
+    {"s__456", 114},
+    {"s__457", 116},
+    {"s__458", 199},
+    {"s__459", 227},
+    {"s__460", 199},
+    {"s__461", 199},
+    {"s__462", 48},
+    {"s__463", 190},
+    {"s__464", 190},
+    {"s__465", 227},
+    {"s__466", 194},
+    {"s__467", 191},
+    {"s__468", 199},
+    {"s__469", 44},
+    {"s__470", 44},
+    {"s__471", 44},
+    {"s__472", 191},
+    {"s__473", 190},
+    {"s__474", 85},
+    {"s__475", 44},
+    {"s__476", 44},
+    {"s__477", 199},
+    {"s__478", 85},
+    {"s__479", 85},
+    {"s__480", 44},
+    {"s__481", 208},
+    {"s__482", 44},
+    {"s__483", 44},
+    {"s__484", 44},
+    {"s__485", 44},
+    {"s__486", 85},
+    {"s__487", 85},
+    {"s__488", 85},
+    {"s__489", 45},
+    {"s__490", 190},
+    {"s__491", 232},
+    {"s__492", 191},
+    {"s__493", 190},
+    {"s__494", 153},
+    {"s__495", 153},
+    {"s__496", 191},
+    {"s__497", 190},
+    {"s__498", 190},
+    {"s__499", 202},
+    {"s__500", 199},
+    {"s__501", 199},
+    {"s__502", 199},
+    {"s__503", 199},
+    {"s__504", 199},
+    {"s__505", 86},
+    {"s__506", 86},
+    {"s__507", 86},
+    {"s__508", 86},
+    {"s__509", 86},
+    {"s__510", 190},
+    {"s__511", 204},
+    {"s__512", 44},
+    {"s__513", 199},
+    {"s__514", 26},
+    {"s__515", 199},
+    {"s__516", 227},
+    {"s__517", 232},
+    {"s__518", 199},
+    {"s__519", 232},
+    {"s__520", 190},
+    {"s__521", 191},
+    {"s__522", 47},
+    {"s__523", 47},
+    {"s__524", 191},
+    {"s__525", 47},
+    {"s__526", 47},
+    {"s__527", 199},
+    {"s__528", 199},
+    {"s__529", 26},
+    {"s__530", 199},
+    {"s__531", 47},
+    {"s__532", 47},
+    {"s__533", 152},
+    {"s__536", 198},
+    {"s__537", 232},
+    {"s__538", 153},
+    {"s__539", 203},
+    {"s__540", 24},
+    {"s__541", 198},
+    {"s__542", 198},
+    {"s__543", 201},
+    {"s__544", 152},
+    {"s__545", 209},
+    {"s__546", 209},
+    {"s__547", 209},
+    {"s__548", 209},
+    {"s__549", 199},
+    {"s__550", 232},
+    {"s__551", 208},
+    {"s__552", 44},
+    {"s__553", 227},
+    {"s__554", 208},
+    {"s__555", 208},
+    {"s__556", 190},
+    {"s__557", 198},
+    {"s__558", 198},
+    {"s__559", 232},
+    {"s__560", 198},
+    {"s__561", 208},
+    {"s__562", 232},
+    {"s__563", 47},
+    {"s__564", 232},
+    {"s__565", 232},
+    {"s__566", 232},
+    {"s__567", 232},
+    {"s__568", 190},
+    {"s__569", 227},
+    {"s__570", 232},
+    {"s__571", 232},
+    {"s__572", 232},
+    {"s__573", 232},
+    {"s__574", 31},
+    {"s__575", 33},
+    {"s__576", 198},
+    {"s__577", 198},
+    {"s__578", 153},
+    {"s__579", 228},
+    {"s__580", 87},
+    {"s__581", 232},
+    {"s__582", 232},
+    {"s__583", 25},
+    {"s__584", 194},
+    {"s__585", 168},
+    {"s__586", 167},
+    {"s__587", 199},
+    {"s__588", 26},
+    {"s__589", 15},
+    {"s__590", 232},
+    {"s__591", 232},
+    {"s__592", 47},
+    {"s__593", 45},
+    {"s__594", 204},
+    {"s__595", 208},
+    {"s__596", 25},
+    {"s__597", 208},
+    {"s__598", 199},
+    {"s__599", 208},
+    {"s__600", 25},
+    {"s__601", 199},
+    {"s__602", 26},
+    {"s__603", 199},
+    {"s__604", 208},
+    {"s__605", 170},
+    {"s__606", 170},
+    {"s__607", 170},
+    {"s__608", 170},
+    {"s__609", 170},
+    {"s__610", 170},
+    {"s__611", 26},
+    {"s__612", 204},
+    {"s__613", 170},
+    {"s__614", 170},
+    {"s__615", 30},
+    {"s__616", 190},
+    {"s__617", 232},
+    {"s__618", 191},
+    {"s__619", 16},
+    {"s__620", 191},
+    {"s__621", 30},
+    {"s__622", 30},
+    {"s__623", 30},
+    {"s__624", 30},
+    {"s__625", 30},
+    {"s__626", 30},
+    {"s__627", 30},
+    {"s__628", 30},
+    {"s__629", 30},
+    {"s__630", 30},
+    {"s__631", 30},
+    {"s__632", 30},
+    {"s__633", 30},
+    {"s__634", 168},
+    {"s__635", 210},
+    {"s__636", 210},
+    {"s__637", 210},
+    {"s__638", 201},
+    {"s__639", 28},
+    {"s__640", 210},
+    {"s__641", 210},
+    {"s__642", 199},
+    {"s__643", 26},
+    {"s__644", 199},
+    {"s__645", 26},
+    {"s__646", 199},
+    {"s__647", 26},
+    {"s__648", 199},
+    {"s__649", 26},
+    {"s__650", 199},
+    {"s__651", 26},
+    {"s__652", 199},
+    {"s__653", 26},
+    {"s__654", 199},
+    {"s__655", 199},
+    {"s__656", 199},
+    {"s__657", 26},
+    {"s__658", 199},
+    {"s__659", 190},
+    {"s__660", 199},
+    {"s__661", 199},
+    {"s__662", 203},
+    {"s__663", 203},
+    {"s__664", 203},
+    {"s__665", 204},
+    {"s__666", 203},
+    {"s__667", 31},
+    {"s__668", 31},
+    {"s__669", 31},
+    {"s__670", 31},
+    {"s__671", 31},
+    {"s__672", 31},
+    {"s__673", 227},
+    {"s__674", 227},
+    {"s__675", 227},
+    {"s__676", 227},
+    {"s__677", 86},
+    {"s__678", 86},
+    {"s__679", 86},
+    {"s__680", 227},
+    {"s__681", 203},
+    {"s__682", 203},
+    {"s__683", 47},
+    {"s__684", 204},
+    {"s__685", 203},
+    {"s__686", 203},
+    {"s__687", 204},
+    {"s__688", 209},
+    {"s__689", 209},
+    {"s__690", 209},
+    {"s__691", 209},
+    {"s__692", 47},
+    {"s__693", 227},
+    {"s__694", 227},
+    {"s__695", 227},
+    {"s__696", 209},
+    {"s__697", 209},
+    {"s__698", 209},
+    {"s__699", 208},
+    {"s__700", 227},
+    {"s__701", 227},
+    {"s__702", 227},
+    {"s__703", 227},
+    {"s__704", 227},
+    {"s__705", 227},
+    {"s__706", 227},
+    {"s__707", 227},
+    {"s__708", 86},
+    {"s__709", 86},
+    {"s__710", 86},
+    {"s__711", 86},
+    {"s__712", 86},
+    {"s__713", 86},
+    {"s__714", 44},
+    {"s__715", 209},
+    {"s__716", 209},
+    {"s__717", 209},
+    {"s__718", 204},
+    {"s__719", 44},
+    {"s__720", 209},
+    {"s__721", 44},
+    {"s__722", 44},
+    {"s__723", 194},
+    {"s__724", 32},
+    {"s__725", 32},
+    {"s__726", 32},
+    {"s__727", 32},
+    {"s__728", 58},
+    {"s__729", 58},
+    {"s__730", 58},
+    {"s__731", 58},
+    {"s__732", 58},
+    {"s__733", 58},
+    {"s__734", 44},
+    {"s__735", 209},
+    {"s__736", 209},
+    {"s__737", 209},
+    {"s__738", 209},
+    {"s__739", 209},
+    {"s__740", 209},
+    {"s__741", 209},
+    {"s__742", 87},
+    {"s__743", 87},
+    {"s__744", 87},
+    {"s__745", 87},
+    {"s__746", 47},
+    {"s__747", 232},
+    {"s__748", 47},
+    {"s__749", 194},
+    {"s__750", 194},
+    {"s__751", 194},
+    {"s__752", 194},
+    {"s__753", 194},
+    {"s__754", 194},
+    {"s__755", 194},
+    {"s__756", 232},
+    {"s__757", 191},
+    {"s__758", 191},
+    {"s__759", 88},
+    {"s__760", 88},
+    {"s__761", 88},
+    {"s__762", 88},
+    {"s__763", 88},
+    {"s__764", 87},
+    {"s__765", 87},
+    {"s__766", 87},
+    {"s__767", 87},
+    {"s__768", 86},
+    {"s__769", 33},
+    {"s__770", 33},
+    {"s__771", 25},
+    {"s__772", 25},
+    {"s__773", 24},
+    {"s__774", 33},
+    {"s__775", 191},
+    {"s__776", 191},
+    {"s__777", 232},
+    {"s__778", 232},
+    {"s__779", 47},
+    {"s__780", 190},
+    {"s__781", 227},
+    {"s__782", 190},
+    {"s__783", 190},
+    {"s__784", 190},
+    {"s__785", 47},
+    {"s__786", 204},
+    {"s__787", 47},
+    {"s__788", 47},
+    {"s__789", 227},
+    {"s__790", 190},
+    {"s__791", 190},
+    {"s__792", 190},
+    {"s__793", 190},
+    {"s__794", 190},
+    {"s__795", 190},
+    {"s__796", 190},
+    {"s__797", 87},
+    {"s__798", 87},
+    {"s__799", 87},
+    {"s__800", 87},
+    {"s__801", 87},
+    {"s__802", 33},
+    {"s__803", 25},
+    {"s__804", 33},
+    {"s__805", 24},
+    {"s__806", 45},
+    {"s__807", 33},
+    {"s__808", 33},
+    {"s__809", 33},
+    {"s__810", 47},
+    {"s__811", 25},
+    {"s__812", 164},
+    {"s__813", 24},
+    {"s__814", 24},
+    {"s__815", 26},
+    {"s__816", 199},
+    {"s__817", 26},
+    {"s__818", 25},
+    {"s__819", 25},
+    {"s__820", 25},
+    {"s__821", 25},
+    {"s__822", 24},
+    {"s__823", 33},
+    {"s__824", 33},
+    {"s__825", 24},
+    {"s__826", 32},
+    {"s__827", 25},
+    {"s__828", 198},
+    {"s__829", 198},
+    {"s__830", 198},
+    {"s__831", 164},
+    {"s__832", 164},
+    {"s__833", 164},
+    {"s__834", 164},
+    {"s__835", 164},
+    {"s__836", 164},
+    {"s__837", 164},
+    {"s__838", 164},
+    {"s__839", 164},
+    {"s__840", 164},
+    {"s__841", 164},
+    {"s__842", 164},
+    {"s__843", 164},
+    {"s__844", 164},
+    {"s__845", 164},
+    {"s__846", 232},
+    {"s__847", 232},
+    {"s__848", 232},
+    {"s__849", 232},
+    {"s__850", 232},
+    {"s__851", 232},
+    {"s__852", 203},
+    {"s__853", 232},
+    {"s__854", 203},
+    {"s__855", 232},
+    {"s__856", 232},
+    {"s__857", 232},
+    {"s__858", 203},
+    {"s__859", 232},
+    {"s__860", 232},
+    {"s__861", 232},
+    {"s__862", 232},
+    {"s__863", 203},
+    {"s__864", 204},
+    {"s__865", 232},
+    {"s__866", 204},
+    {"s__867", 203},
+    {"s__868", 61},
+    {"s__869", 95},
+    {"s__870", 61},
+    {"s__871", 95},
+    {"s__872", 61},
+    {"s__873", 95},
+    {"s__874", 95},
+    {"s__875", 60},
+    {"s__876", 192},
+    {"s__877", 192},
+    {"s__878", 23},
+    {"s__879", 95},
+    {"s__880", 95},
+    {"s__881", 17},
+    {"s__882", 17},
+    {"s__883", 17},
+    {"s__884", 17},
+    {"s__885", 18},
+    {"s__886", 18},
+    {"s__887", 14},
+    {"s__888", 14},
+    {"s__889", 14},
+    {"s__890", 14},
+    {"s__891", 14},
+    {"s__892", 14},
+    {"s__893", 17},
+    {"s__894", 17},
+    {"s__895", 227},
+    {"s__896", 227},
+    {"s__897", 232},
+    {"s__898", 232},
+    {"s__899", 232},
+    {"s__900", 232},
+    {"s__901", 232},
+    {"s__902", 232},
+    {"s__903", 232},
+    {"s__904", 23},
+    {"s__905", 114},
+    {"s__906", 114},
+    {"s__907", 114},
+    {"s__908", 59},
+    {"s__909", 59},
+    {"s__910", 107},
+    {"s__911", 107},
+    {"s__912", 114},
+    {"s__913", 115},
+    {"s__914", 111},
+    {"s__915", 114},
+    {"s__916", 107},
+    {"s__917", 203},
+    {"s__918", 114},
+    {"s__919", 114},
+    {"s__920", 107},
+    {"s__921", 107},
+    {"s__922", 107},
+    {"s__923", 205},
+    {"s__924", 23},
+    {"s__925", 205},
+    {"s__926", 190},
+    {"s__927", 190},
+    {"s__928", 205},
+    {"s__929", 190},
+    {"s__930", 190},
+    {"s__931", 190},
+    {"s__932", 190},
+    {"s__933", 190},
+    {"s__934", 232},
+    {"s__935", 232},
+    {"s__936", 232},
+    {"s__937", 232},
+    {"s__938", 232},
+    {"s__939", 232},
+    {"s__940", 232},
+    {"s__941", 232},
+    {"s__942", 232},
+    {"s__943", 232},
+    {"s__944", 190},
+    {"s__945", 190},
+    {"s__946", 190},
+    {"s__947", 190},
+    {"s__948", 190},
+    {"s__949", 190},
+    {"s__951", 59},
+    {"s__952", 59},
+    {"s__953", 59},
+    {"s__954", 59},
+    {"s__955", 59},
+    {"s__956", 59},
+    {"s__957", 59},
+    {"s__958", 114},
+    {"s__959", 114},
+    {"s__960", 114},
+    {"s__961", 114},
+    {"s__962", 114},
+    {"s__963", 114},
+    {"s__964", 107},
+    {"s__965", 30},
+    {"s__966", 32},
+    {"s__967", 24},
+    {"s__968", 25},
+    {"s__969", 205},
+    {"s__970", 190},
+    {"s__971", 119},
+    {"s__972", 104},
+    {"s__973", 119},
+    {"s__974", 119},
+    {"s__975", 119},
+    {"s__976", 119},
+    {"s__977", 119},
+    {"s__978", 119},
+    {"s__979", 119},
+    {"s__980", 119},
+    {"s__981", 119},
+    {"s__982", 17},
+    {"s__983", 232},
+    {"s__984", 232},
+    {"s__985", 232},
+    {"s__986", 232},
+    {"s__987", 232},
+    {"s__988", 232},
+    {"s__989", 232},
+    {"s__990", 232},
+    {"s__991", 232},
+    {"s__992", 203},
+    {"s__993", 203},
+    {"s__994", 204},
+    {"s__995", 204},
+    {"s__996", 204},
+    {"s__997", 204},
+    {"s__998", 204},
+    {"s__999", 204},
+};
+
+//! return category ID of a SUNCG object model id or ID_UNDEFINED if it isn't
+//! a model, e.g. a Wall
+inline int suncgObjectCategoryId(const std::string& modelId) {
+  const auto end = std::end(kSuncgObjectCategoryMap);
+  const auto it = std::lower_bound(
+      std::begin(kSuncgObjectCategoryMap), end, modelId.c_str(),
+      [](const SuncgObjectCategoryEntry& entry, const char* key) {
+        return std::strcmp(entry.modelId, key) < 0;
+      });
+  if (it == end || std::strcmp(it->modelId, modelId.c_str()) != 0) {
+    return ID_UNDEFINED;
+  }
+  return it->categoryId;
+}
 
 }  // namespace scene
 }  // namespace esp
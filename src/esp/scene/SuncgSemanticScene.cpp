@@ -25,7 +25,16 @@ std::string SuncgSemanticRegion::id() const {
   return nodeId_;
 }
 
+SuncgObjectCategory::SuncgObjectCategory(const std::string& nodeId,
+                                         const std::string& modelId)
+    : nodeId_(nodeId),
+      modelId_(modelId),
+      categoryId_(suncgObjectCategoryId(modelId)) {}
+
 int SuncgObjectCategory::index(const std::string& mapping) const {
+  if (mapping == "category" || mapping == "") {
+    return categoryId_;
+  }
   return ID_UNDEFINED;
 }
 
@@ -35,8 +44,8 @@ std::string SuncgObjectCategory::name(const std::string& mapping) const {
   } else if (mapping == "node_id") {
     return nodeId_;
   } else if (mapping == "category" || mapping == "") {
-    if (kSuncgObjectCategoryMap.count(modelId_) > 0) {
-      return kSuncgObjectCategoryMap.at(modelId_);
+    if (categoryId_ != ID_UNDEFINED) {
+      return kSuncgObjectCategories[categoryId_];
     } else {
       // This is a non-model object where modelId stores type (e.g., Wall)
       return modelId_;
@@ -226,6 +235,7 @@ bool SemanticScene::loadSuncgHouse(
 
     iLevel++;
   }  // for level
+  scene.buildIndices();
   return true;
 }
 
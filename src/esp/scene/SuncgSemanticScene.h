@@ -31,8 +31,7 @@ class SuncgSemanticRegion : public SemanticRegion {
 };
 
 struct SuncgObjectCategory : public SemanticCategory {
-  SuncgObjectCategory(const std::string& nodeId, const std::string& modelId)
-      : nodeId_(nodeId), modelId_(modelId) {}
+  SuncgObjectCategory(const std::string& nodeId, const std::string& modelId);
 
   int index(const std::string& mapping) const override;
 
@@ -41,6 +40,8 @@ struct SuncgObjectCategory : public SemanticCategory {
  protected:
   std::string nodeId_;
   std::string modelId_;
+  // looked up once, ID_UNDEFINED for non-model objects
+  int categoryId_;
   friend SemanticScene;
 
   ESP_SMART_POINTERS(SuncgObjectCategory)
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 
@@ -31,11 +33,17 @@ struct ReplicaSceneTest : Cr::TestSuite::Tester {
   void testSemanticSceneOBB();
 
   void testSemanticSceneLoading();
+
+  void testBakedInstanceMesh();
+
+  void testPrimitiveObjectIds();
 };
 
 ReplicaSceneTest::ReplicaSceneTest() {
   addTests({&ReplicaSceneTest::testSemanticSceneOBB,
-            &ReplicaSceneTest::testSemanticSceneLoading});
+            &ReplicaSceneTest::testSemanticSceneLoading,
+            &ReplicaSceneTest::testBakedInstanceMesh,
+            &ReplicaSceneTest::testPrimitiveObjectIds});
 }
 
 void ReplicaSceneTest::testSemanticSceneOBB() {
@@ -117,6 +125,115 @@ void ReplicaSceneTest::testSemanticSceneLoading() {
   CORRADE_COMPARE(scene->objects()[12]->category()->name(), "book");
 }
 
+void ReplicaSceneTest::testBakedInstanceMesh() {
+  if (!Cr::Utility::Directory::exists(replicaRoom0)) {
+    CORRADE_SKIP("Replica dataset not found at '" + replicaRoom0 +
+                 "'\nSkipping test");
+  }
+
+#ifndef MAGNUM_BUILD_STATIC
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+#else
+  // avoid using plugins that might depend on different library versions
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager{
+      "nonexistent"};
+#endif
+
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer;
+  CORRADE_INTERNAL_ASSERT(importer =
+                              manager.loadAndInstantiate("StanfordImporter"));
+
+  const std::string plyFile =
+      Cr::Utility::Directory::join(replicaRoom0, "mesh_semantic.ply");
+  const std::vector<GenericInstanceMeshData::uptr> split =
+      GenericInstanceMeshData::fromPlySplitByObjectId(*importer, plyFile);
+  CORRADE_VERIFY(!split.empty());
+
+  const std::string bakedFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "ReplicaSceneTest.bake");
+  CORRADE_VERIFY(GenericInstanceMeshData::saveBaked(split, bakedFile));
+
+  // split meshes come back exactly as they were saved
+  const std::vector<GenericInstanceMeshData::uptr> bakedSplit =
+      GenericInstanceMeshData::fromBaked(bakedFile, true);
+  CORRADE_COMPARE(bakedSplit.size(), split.size());
+  size_t vertexCount = 0;
+  size_t indexCount = 0;
+  for (size_t i = 0; i < split.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(bakedSplit[i]->getVertexBufferObjectCPU() ==
+                   split[i]->getVertexBufferObjectCPU());
+    CORRADE_VERIFY(bakedSplit[i]->getIndexBufferObjectCPU() ==
+                   split[i]->getIndexBufferObjectCPU());
+    CORRADE_VERIFY(bakedSplit[i]->getObjectIdsBufferObjectCPU() ==
+                   split[i]->getObjectIdsBufferObjectCPU());
+    CORRADE_VERIFY(bakedSplit[i]->getColorBufferObjectCPU() ==
+                   split[i]->getColorBufferObjectCPU());
+    vertexCount += split[i]->getVertexBufferObjectCPU().size();
+    indexCount += split[i]->getIndexBufferObjectCPU().size();
+  }
+
+  // joined, all triangles are there, referencing valid vertices
+  const std::vector<GenericInstanceMeshData::uptr> bakedJoined =
+      GenericInstanceMeshData::fromBaked(bakedFile, false);
+  CORRADE_COMPARE(bakedJoined.size(), 1);
+  const auto& ibo = bakedJoined[0]->getIndexBufferObjectCPU();
+  CORRADE_COMPARE(bakedJoined[0]->getVertexBufferObjectCPU().size(),
+                  vertexCount);
+  CORRADE_COMPARE(ibo.size(), indexCount);
+  CORRADE_VERIFY(*std::max_element(ibo.begin(), ibo.end()) < vertexCount);
+
+  CORRADE_VERIFY(Cr::Utility::Directory::rm(bakedFile));
+}
+
+void ReplicaSceneTest::testPrimitiveObjectIds() {
+  if (!Cr::Utility::Directory::exists(replicaRoom0)) {
+    CORRADE_SKIP("Replica dataset not found at '" + replicaRoom0 +
+                 "'\nSkipping test");
+  }
+
+#ifndef MAGNUM_BUILD_STATIC
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+#else
+  // avoid using plugins that might depend on different library versions
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager{
+      "nonexistent"};
+#endif
+
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer;
+  CORRADE_INTERNAL_ASSERT(importer =
+                              manager.loadAndInstantiate("StanfordImporter"));
+
+  const std::string plyFile =
+      Cr::Utility::Directory::join(replicaRoom0, "mesh_semantic.ply");
+  GenericInstanceMeshData::uptr perVertex =
+      GenericInstanceMeshData::fromPLY(*importer, plyFile);
+  GenericInstanceMeshData::uptr perPrimitive =
+      GenericInstanceMeshData::fromPLY(*importer, plyFile, true);
+  CORRADE_VERIFY(perVertex);
+  CORRADE_VERIFY(perPrimitive);
+
+  // the same triangles, with the IDs their vertices had
+  const auto& ibo = perVertex->getIndexBufferObjectCPU();
+  const auto& vbo = perVertex->getVertexBufferObjectCPU();
+  const auto& objectIds = perVertex->getObjectIdsBufferObjectCPU();
+  const auto& primitiveIbo = perPrimitive->getIndexBufferObjectCPU();
+  const auto& primitiveVbo = perPrimitive->getVertexBufferObjectCPU();
+  const auto& primitiveObjectIds = perPrimitive->getPrimitiveObjectIdsCPU();
+  CORRADE_COMPARE(primitiveIbo.size(), ibo.size());
+  CORRADE_COMPARE(primitiveObjectIds.size(), ibo.size() / 3);
+  CORRADE_VERIFY(perPrimitive->getObjectIdsBufferObjectCPU().empty());
+  for (size_t i = 0; i < ibo.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(primitiveVbo[primitiveIbo[i]] == vbo[ibo[i]]);
+    CORRADE_COMPARE(primitiveObjectIds[i / 3], objectIds[ibo[i]]);
+  }
+
+  // vertices where objects meet aren't duplicated
+  CORRADE_COMPARE_AS(primitiveVbo.size(), vbo.size(),
+                     Cr::TestSuite::Compare::LessOrEqual);
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(ReplicaSceneTest)
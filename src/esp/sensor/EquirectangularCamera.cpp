@@ -0,0 +1,62 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "EquirectangularCamera.h"
+
+#include <algorithm>
+
+#include "esp/gfx/DepthUnprojection.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/sim/Simulator.h"
+
+namespace esp {
+namespace sensor {
+
+EquirectangularCamera::EquirectangularCamera(scene::SceneNode& cameraNode,
+                                             SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec) {
+  auto size = spec_->parameters.find("cubemap_size");
+  cubeMapSize_ = size != spec_->parameters.end()
+                     ? std::atoi(size->second.c_str())
+                     : std::max(framebufferSize().y(), 1);
+  CORRADE_ASSERT(cubeMapSize_ > 0,
+                 "EquirectangularCamera: cubemap_size has to be positive", );
+}
+
+EquirectangularCamera& EquirectangularCamera::setProjectionMatrix(
+    gfx::RenderCamera& targetCamera) {
+  targetCamera.setProjectionMatrix(cubeMapSize_, cubeMapSize_, near_, far_,
+                                   90.0f);
+  return *this;
+}
+
+EquirectangularCamera& EquirectangularCamera::setViewport(
+    gfx::RenderCamera& targetCamera) {
+  targetCamera.setViewport(Magnum::Vector2i{cubeMapSize_});
+  return *this;
+}
+
+Corrade::Containers::Optional<Magnum::Vector2>
+EquirectangularCamera::depthUnprojection() const {
+  const Magnum::Matrix4 projection = Magnum::Matrix4::perspectiveProjection(
+      Magnum::Deg{90.0f}, 1.0f, near_, far_);
+
+  return {gfx::calculateDepthUnprojection(projection)};
+}
+
+void EquirectangularCamera::drawObservation(sim::Simulator& sim) {
+  gfx::Renderer::ptr renderer = sim.getRenderer();
+  if (!cubeMap_) {
+    cubeMap_ = renderer->createCubeMapRenderTarget(cubeMapSize_);
+  }
+  renderer->drawCubeMap(*this, getSceneGraphToDraw(sim), *cubeMap_,
+                        sim.isFrustumCullingEnabled());
+
+  renderTarget().renderEnter();
+  cubeMap_->drawEquirectangular(*depthUnprojection(), framebufferSize());
+  renderTarget().renderExit();
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,69 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/CubeMapRenderTarget.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Panoramic camera covering the full sphere around its node
+ *
+ * Created for specifications with a @ref SensorSpec::sensorSubtype of
+ * @cpp "equirectangular" @ce. The scene is drawn into a cube map, culled once
+ * for all six faces, and resampled on the GPU into the sensor's render
+ * target, with longitude growing along the width and latitude along the
+ * height. The middle of the image looks along -Z, like a pinhole camera.
+ * Depth is the distance along the view ray instead of along the view axis.
+ * The @cpp "hfov" @ce parameter is ignored, the optional
+ * @cpp "cubemap_size" @ce parameter sets the edge length of the faces in
+ * pixels, which defaults to the framebuffer height.
+ */
+class EquirectangularCamera : public PinholeCamera {
+ public:
+  explicit EquirectangularCamera(scene::SceneNode& cameraNode,
+                                 SensorSpec::ptr spec);
+
+  virtual ~EquirectangularCamera() {}
+
+  // set the square 90 degree projection of the cube map faces to the given
+  // render camera
+  virtual EquirectangularCamera& setProjectionMatrix(
+      gfx::RenderCamera& targetCamera) override;
+  // set the view port of the cube map faces to the given render camera
+  virtual EquirectangularCamera& setViewport(
+      gfx::RenderCamera& targetCamera) override;
+
+  /**
+   * @brief Returns the parameters needed to unproject depth of the cube map
+   * faces, which is also used for the panorama itself.
+   * See @ref gfx::calculateDepthUnprojection
+   */
+  virtual Corrade::Containers::Optional<Magnum::Vector2> depthUnprojection()
+      const override;
+
+  /**
+   * @brief Draw the cube map and resample it into the render target
+   * @param[in] sim Instance of Simulator class for which the observation needs
+   *                to be drawn
+   */
+  virtual void drawObservation(sim::Simulator& sim) override;
+
+  /** @brief Edge length of the cube map faces, in pixels */
+  int cubeMapSize() const { return cubeMapSize_; }
+
+ protected:
+  int cubeMapSize_;
+  // created on the first draw, when the renderer is known
+  gfx::CubeMapRenderTarget::uptr cubeMap_ = nullptr;
+
+  ESP_SMART_POINTERS(EquirectangularCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
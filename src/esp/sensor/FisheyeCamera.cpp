@@ -0,0 +1,174 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "FisheyeCamera.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Magnum/Math/Angle.h>
+#include <Magnum/Math/Functions.h>
+
+#include "esp/gfx/Renderer.h"
+#include "esp/sim/Simulator.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sensor {
+
+// static constexpr members require redundant definitions until C++17
+constexpr float FisheyeCamera::MaxFieldAngle;
+constexpr int FisheyeCamera::MaxSourceSize;
+
+namespace {
+// inverts the Kannala-Brandt model with Newton's method, the same way
+// cv::fisheye::undistortPoints() does
+bool undistortAngle(float distorted, const float (&k)[4], float& angle) {
+  float theta = distorted;
+  for (int i = 0; i != 20; ++i) {
+    const float t2 = theta * theta;
+    const float error =
+        theta * (1.0f + t2 * (k[0] + t2 * (k[1] + t2 * (k[2] + t2 * k[3])))) -
+        distorted;
+    if (std::abs(error) < 1.0e-6f) {
+      break;
+    }
+    const float derivative =
+        1.0f + t2 * (3.0f * k[0] +
+                     t2 * (5.0f * k[1] +
+                           t2 * (7.0f * k[2] + t2 * 9.0f * k[3])));
+    theta -= error / derivative;
+  }
+  angle = theta;
+  return std::isfinite(theta) && theta >= 0.0f;
+}
+}  // namespace
+
+FisheyeCamera::FisheyeCamera(scene::SceneNode& cameraNode,
+                             SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec) {
+  auto parameter = [&](const std::string& name, float defaultValue) {
+    auto found = spec_->parameters.find(name);
+    return found != spec_->parameters.end()
+               ? float(std::atof(found->second.c_str()))
+               : defaultValue;
+  };
+
+  auto model = spec_->parameters.find("distortion_model");
+  if (model == spec_->parameters.end() ||
+      model->second == "kannala_brandt") {
+    k_[0] = parameter("k1", 0.0f);
+    k_[1] = parameter("k2", 0.0f);
+    k_[2] = parameter("k3", 0.0f);
+    k_[3] = parameter("k4", 0.0f);
+  } else if (model->second != "equidistant") {
+    LOG(ERROR) << "FisheyeCamera: unknown distortion model " << model->second
+               << ", using equidistant";
+  }
+
+  // equidistant focal length putting hfov_ across the width
+  const float focal =
+      width_ * 0.5f / (float(Mn::Rad{Mn::Deg{hfov_}}) * 0.5f);
+  fx_ = parameter("fx", focal);
+  fy_ = parameter("fy", focal);
+  cx_ = parameter("cx", (width_ - 1) * 0.5f);
+  cy_ = parameter("cy", (height_ - 1) * 0.5f);
+
+  computeLookup();
+}
+
+void FisheyeCamera::computeLookup() {
+  const int supersampling = spec_->supersampling;
+  const Mn::Vector2i size = framebufferSize();
+  const float maxAngle = float(Mn::Rad{Mn::Deg{MaxFieldAngle}});
+
+  // where each pixel looks on the z = 1 plane, with the y axis pointing down
+  // like the image rows, NaN if it can't be rendered
+  std::vector<Mn::Vector2> directions(size.product());
+  Mn::Vector2 extent;
+  for (int y = 0; y != size.y(); ++y) {
+    // the lookup texture has the bottom row first
+    const float v = (size.y() - y - 0.5f) / supersampling - 0.5f;
+    for (int x = 0; x != size.x(); ++x) {
+      const float u = (x + 0.5f) / supersampling - 0.5f;
+      const Mn::Vector2 distorted{(u - cx_) / fx_, (v - cy_) / fy_};
+      const float distortedAngle = distorted.length();
+      float angle;
+      Mn::Vector2& direction = directions[y * size.x() + x];
+      if (!undistortAngle(distortedAngle, k_, angle) || angle >= maxAngle) {
+        direction = Mn::Vector2{Mn::Constants::nan()};
+        continue;
+      }
+      direction = distortedAngle > 0.0f
+                      ? distorted * (std::tan(angle) / distortedAngle)
+                      : Mn::Vector2{};
+      extent = Mn::Math::max(extent, Mn::Math::abs(direction));
+    }
+  }
+
+  // match the density of the distorted image in its center, where the
+  // models are closest to a pinhole
+  float focal = std::max(fx_, fy_) * supersampling;
+  auto sourceSize = [&]() {
+    return Mn::Math::max(
+        Mn::Vector2i{Mn::Math::ceil(2.0f * focal * extent)}, Mn::Vector2i{1});
+  };
+  sourceSize_ = sourceSize();
+  if (sourceSize_.max() > MaxSourceSize) {
+    LOG(WARNING) << "FisheyeCamera: the intermediate view of "
+                 << sourceSize_.x() << "x" << sourceSize_.y()
+                 << " pixels is too large, reducing its resolution";
+    focal *= float(MaxSourceSize) / sourceSize_.max();
+    sourceSize_ = Mn::Math::min(sourceSize(), Mn::Vector2i{MaxSourceSize});
+  }
+  // the rounded up size covers slightly more than the extent
+  const Mn::Vector2 sourceExtent = Mn::Vector2{sourceSize_} / (2.0f * focal);
+  sourceHfov_ = float(Mn::Deg{2.0f * Mn::Rad{std::atan(sourceExtent.x())}});
+
+  lookup_.resize(directions.size());
+  for (size_t i = 0; i != directions.size(); ++i) {
+    const Mn::Vector2& direction = directions[i];
+    // texture coordinates have the y axis pointing up
+    lookup_[i] = std::isnan(direction.x())
+                     ? Mn::Vector2{-1.0f}
+                     : (Mn::Vector2{direction.x(), -direction.y()} /
+                            sourceExtent +
+                        Mn::Vector2{1.0f}) *
+                           0.5f;
+  }
+}
+
+FisheyeCamera& FisheyeCamera::setProjectionMatrix(
+    gfx::RenderCamera& targetCamera) {
+  targetCamera.setProjectionMatrix(sourceSize_.x(), sourceSize_.y(), near_,
+                                   far_, sourceHfov_);
+  return *this;
+}
+
+FisheyeCamera& FisheyeCamera::setViewport(gfx::RenderCamera& targetCamera) {
+  targetCamera.setViewport(sourceSize_);
+  return *this;
+}
+
+void FisheyeCamera::drawObservation(sim::Simulator& sim) {
+  gfx::Renderer::ptr renderer = sim.getRenderer();
+  if (!warp_) {
+    warp_ = renderer->createWarpRenderTarget(sourceSize_, framebufferSize(),
+                                             lookup_);
+    std::vector<Mn::Vector2>{}.swap(lookup_);
+  }
+
+  warp_->renderEnter();
+  renderer->draw(*this, getSceneGraphToDraw(sim),
+                 sim.isFrustumCullingEnabled());
+  warp_->renderExit();
+
+  renderTarget().renderEnter();
+  warp_->drawWarp();
+  renderTarget().renderExit();
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,91 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/WarpRenderTarget.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Camera with a fisheye lens distortion model
+ *
+ * Created for specifications with a @ref SensorSpec::sensorSubtype of
+ * @cpp "fisheye" @ce. The scene is drawn into a pinhole view large enough to
+ * cover the distorted image and warped on the GPU through a lookup texture
+ * computed once from the model, so readback only sees the distorted result.
+ * Depth stays along the optical axis.
+ *
+ * The @cpp "distortion_model" @ce parameter is either
+ * @cpp "kannala_brandt" @ce, the default, with the @cpp "k1" @ce to
+ * @cpp "k4" @ce coefficients of @f$ \theta_d = \theta (1 + k_1 \theta^2 +
+ * k_2 \theta^4 + k_3 \theta^6 + k_4 \theta^8) @f$ as used by OpenCV's
+ * @cpp cv::fisheye @ce, or @cpp "equidistant" @ce, which has no
+ * coefficients. The @cpp "fx" @ce, @cpp "fy" @ce, @cpp "cx" @ce and
+ * @cpp "cy" @ce parameters are the intrinsics in pixels, with the origin on
+ * the center of the top left pixel. The focal lengths default to the
+ * equidistant ones that fit @cpp "hfov" @ce into the width, the principal
+ * point to the image center. Directions more than @ref MaxFieldAngle degrees
+ * off the optical axis can't be seen by the intermediate pinhole view and
+ * stay empty.
+ */
+class FisheyeCamera : public PinholeCamera {
+ public:
+  /** @brief Largest angle from the optical axis that is rendered, degrees */
+  static constexpr float MaxFieldAngle = 80.0f;
+
+  /** @brief Largest size of the intermediate pinhole view */
+  static constexpr int MaxSourceSize = 4096;
+
+  explicit FisheyeCamera(scene::SceneNode& cameraNode, SensorSpec::ptr spec);
+
+  virtual ~FisheyeCamera() {}
+
+  // set the projection matrix of the intermediate pinhole view to the given
+  // render camera
+  virtual FisheyeCamera& setProjectionMatrix(
+      gfx::RenderCamera& targetCamera) override;
+  // set the view port of the intermediate pinhole view to the given render
+  // camera
+  virtual FisheyeCamera& setViewport(gfx::RenderCamera& targetCamera) override;
+
+  /**
+   * @brief Draw the intermediate pinhole view and warp it into the render
+   * target
+   * @param[in] sim Instance of Simulator class for which the observation needs
+   *                to be drawn
+   */
+  virtual void drawObservation(sim::Simulator& sim) override;
+
+  /** @brief Size of the intermediate pinhole view */
+  Magnum::Vector2i sourceSize() const { return sourceSize_; }
+
+  /** @brief Horizontal field of view of the intermediate view, degrees */
+  float sourceHfov() const { return sourceHfov_; }
+
+ protected:
+  // fill lookup_, sourceSize_ and sourceHfov_ from the distortion model
+  void computeLookup();
+
+  // intrinsics and Kannala-Brandt coefficients
+  float fx_, fy_, cx_, cy_;
+  float k_[4] = {};
+
+  Magnum::Vector2i sourceSize_;
+  float sourceHfov_ = 90.0f;
+  // released once uploaded to the warp target
+  std::vector<Magnum::Vector2> lookup_;
+  // created on the first draw, when the renderer is known
+  gfx::WarpRenderTarget::uptr warp_ = nullptr;
+
+  ESP_SMART_POINTERS(FisheyeCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,340 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObservationCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "esp/core/configure.h"
+#include "esp/sensor/Sensor.h"
+
+#ifdef ESP_BUILD_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace esp {
+namespace sensor {
+
+namespace {
+
+constexpr char PacketMagic[4]{'H', 'S', 'O', 'C'};
+constexpr uint8_t PacketVersion = 1;
+constexpr uint32_t MaxDimensions = 3;
+
+enum PacketFlag : uint8_t {
+  Keyframe = 1 << 0,
+  Compressed = 1 << 1,
+};
+
+struct PacketHeader {
+  char magic[4];
+  uint8_t version;
+  uint8_t codec;
+  uint8_t flags;
+  // core::DataType of the decoded observation
+  uint8_t dataType;
+  uint32_t sequence;
+  uint32_t dimensions;
+  uint32_t shape[MaxDimensions];
+  float depthStep;
+  // bytes of the elements before compression
+  uint32_t codedSize;
+};
+
+static_assert(sizeof(PacketHeader) == 36, "unexpected packet header padding");
+
+bool isFloatingPoint(core::DataType dataType) {
+  return dataType == core::DataType::DT_FLOAT ||
+         dataType == core::DataType::DT_DOUBLE ||
+         dataType == core::DataType::DT_FLOAT16;
+}
+
+// replaces data by its difference to reference, or back with inverse.
+// Subtraction wraps around, XOR keeps floats exact when their difference
+// doesn't fit them
+template <class T>
+void delta(uint8_t* data,
+           const uint8_t* reference,
+           size_t count,
+           bool bitwise,
+           bool inverse) {
+  for (size_t i = 0; i != count; ++i) {
+    T value, previous;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    std::memcpy(&previous, reference + i * sizeof(T), sizeof(T));
+    if (bitwise) {
+      value ^= previous;
+    } else if (inverse) {
+      value += previous;
+    } else {
+      value -= previous;
+    }
+    std::memcpy(data + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+void delta(std::vector<uint8_t>& data,
+           const std::vector<uint8_t>& reference,
+           size_t elementSize,
+           bool bitwise,
+           bool inverse) {
+  const size_t count = data.size() / elementSize;
+  switch (elementSize) {
+    case 1:
+      delta<uint8_t>(data.data(), reference.data(), count, bitwise, inverse);
+      break;
+    case 2:
+      delta<uint16_t>(data.data(), reference.data(), count, bitwise, inverse);
+      break;
+    case 4:
+      delta<uint32_t>(data.data(), reference.data(), count, bitwise, inverse);
+      break;
+    case 8:
+      delta<uint64_t>(data.data(), reference.data(), count, bitwise, inverse);
+      break;
+  }
+}
+
+// all first bytes of the elements, then all second bytes and so on
+std::vector<uint8_t> shuffle(const std::vector<uint8_t>& data,
+                             size_t elementSize) {
+  if (elementSize == 1) {
+    return data;
+  }
+  const size_t count = data.size() / elementSize;
+  std::vector<uint8_t> planes(data.size());
+  for (size_t i = 0; i != count; ++i) {
+    for (size_t byte = 0; byte != elementSize; ++byte) {
+      planes[byte * count + i] = data[i * elementSize + byte];
+    }
+  }
+  return planes;
+}
+
+std::vector<uint8_t> unshuffle(const std::vector<uint8_t>& planes,
+                               size_t elementSize) {
+  if (elementSize == 1) {
+    return planes;
+  }
+  const size_t count = planes.size() / elementSize;
+  std::vector<uint8_t> data(planes.size());
+  for (size_t i = 0; i != count; ++i) {
+    for (size_t byte = 0; byte != elementSize; ++byte) {
+      data[i * elementSize + byte] = planes[byte * count + i];
+    }
+  }
+  return data;
+}
+
+}  // namespace
+
+ObservationEncoder::ObservationEncoder(
+    const ObservationEncoderConfiguration& configuration)
+    : configuration_{configuration} {}
+
+std::vector<uint8_t> ObservationEncoder::encode(
+    const Observation& observation) {
+  if (!observation.buffer) {
+    LOG(ERROR) << "ObservationEncoder::encode(): the observation has no CPU "
+                  "buffer";
+    return {};
+  }
+  return encode(*observation.buffer);
+}
+
+std::vector<uint8_t> ObservationEncoder::encode(const core::Buffer& buffer) {
+  const bool quantize =
+      configuration_.codec == ObservationCodec::QuantizedDepth;
+  if (quantize && (buffer.dataType != core::DataType::DT_FLOAT ||
+                   !(configuration_.depthStep > 0.0f))) {
+    LOG(ERROR) << "ObservationEncoder::encode(): quantized depth needs float "
+                  "elements and a positive step";
+    return {};
+  }
+  if (buffer.shape.size() > MaxDimensions ||
+      buffer.dataType == core::DataType::DT_NONE) {
+    LOG(ERROR) << "ObservationEncoder::encode(): can't encode "
+               << buffer.shape.size() << " dimensions of data type "
+               << int(buffer.dataType);
+    return {};
+  }
+  size_t count = 1;
+  for (size_t extent : buffer.shape) {
+    count *= extent;
+  }
+  const size_t inputElementSize = core::getDataTypeByteSize(buffer.dataType);
+  if (count * inputElementSize > buffer.data.size()) {
+    LOG(ERROR) << "ObservationEncoder::encode(): the buffer is smaller than "
+                  "its shape";
+    return {};
+  }
+
+  // the elements as the decoder reconstructs them
+  const size_t elementSize = quantize ? sizeof(uint16_t) : inputElementSize;
+  std::vector<uint8_t> coded(count * elementSize);
+  if (quantize) {
+    const float* depth = reinterpret_cast<const float*>(buffer.data.data());
+    for (size_t i = 0; i != count; ++i) {
+      // no hit and NaN are 0, beyond the range and infinity the last step
+      const float steps = depth[i] / configuration_.depthStep;
+      const uint16_t code =
+          steps > 0.0f ? uint16_t(std::min(steps + 0.5f, 65535.0f)) : 0;
+      std::memcpy(coded.data() + i * elementSize, &code, elementSize);
+    }
+  } else {
+    std::memcpy(coded.data(), buffer.data.data(), coded.size());
+  }
+
+  const bool keyframe = framesSinceKeyframe_ < 0 ||
+                        framesSinceKeyframe_ + 1 >=
+                            std::max(configuration_.keyframeInterval, 1) ||
+                        buffer.dataType != previousDataType_ ||
+                        buffer.shape != previousShape_;
+  std::vector<uint8_t> payload = coded;
+  if (!keyframe) {
+    delta(payload, previous_, elementSize,
+          !quantize && isFloatingPoint(buffer.dataType), false);
+  }
+  payload = shuffle(payload, elementSize);
+
+  PacketHeader header{};
+  std::memcpy(header.magic, PacketMagic, sizeof(PacketMagic));
+  header.version = PacketVersion;
+  header.codec = uint8_t(configuration_.codec);
+  header.flags = keyframe ? Keyframe : 0;
+  header.dataType = uint8_t(buffer.dataType);
+  header.sequence = sequence_;
+  header.dimensions = uint32_t(buffer.shape.size());
+  for (size_t i = 0; i != buffer.shape.size(); ++i) {
+    header.shape[i] = uint32_t(buffer.shape[i]);
+  }
+  header.depthStep = quantize ? configuration_.depthStep : 0.0f;
+  header.codedSize = uint32_t(payload.size());
+
+  std::vector<uint8_t> packet(sizeof(PacketHeader));
+#ifdef ESP_BUILD_WITH_ZLIB
+  if (configuration_.compressionLevel > 0) {
+    uLongf compressedSize = compressBound(uLong(payload.size()));
+    packet.resize(sizeof(PacketHeader) + compressedSize);
+    if (compress2(packet.data() + sizeof(PacketHeader), &compressedSize,
+                  payload.data(), uLong(payload.size()),
+                  std::min(configuration_.compressionLevel, 9)) == Z_OK &&
+        compressedSize < payload.size()) {
+      header.flags |= Compressed;
+      packet.resize(sizeof(PacketHeader) + compressedSize);
+    }
+  }
+#endif
+  if (!(header.flags & Compressed)) {
+    packet.resize(sizeof(PacketHeader));
+    packet.insert(packet.end(), payload.begin(), payload.end());
+  }
+  std::memcpy(packet.data(), &header, sizeof(PacketHeader));
+
+  previous_ = std::move(coded);
+  previousDataType_ = buffer.dataType;
+  previousShape_ = buffer.shape;
+  framesSinceKeyframe_ = keyframe ? 0 : framesSinceKeyframe_ + 1;
+  ++sequence_;
+  return packet;
+}
+
+core::Buffer::ptr ObservationDecoder::decode(const uint8_t* data,
+                                             size_t size) {
+  PacketHeader header;
+  if (size < sizeof(PacketHeader)) {
+    LOG(ERROR) << "ObservationDecoder::decode(): the packet is too short";
+    return nullptr;
+  }
+  std::memcpy(&header, data, sizeof(PacketHeader));
+  const auto dataType = core::DataType(header.dataType);
+  const bool quantize =
+      header.codec == uint8_t(ObservationCodec::QuantizedDepth);
+  if (std::memcmp(header.magic, PacketMagic, sizeof(PacketMagic)) != 0 ||
+      header.version != PacketVersion || header.dimensions > MaxDimensions ||
+      header.codec > uint8_t(ObservationCodec::QuantizedDepth) ||
+      core::getDataTypeByteSize(dataType) == 0 ||
+      (quantize && dataType != core::DataType::DT_FLOAT)) {
+    LOG(ERROR) << "ObservationDecoder::decode(): not an observation packet "
+                  "of a known version";
+    return nullptr;
+  }
+  if (!(header.flags & Keyframe) &&
+      (!hasPrevious_ || header.sequence != previousSequence_ + 1)) {
+    LOG(ERROR) << "ObservationDecoder::decode(): packet " << header.sequence
+               << " is a delta to a frame that wasn't decoded, waiting for a "
+                  "keyframe";
+    return nullptr;
+  }
+
+  std::vector<size_t> shape(header.shape, header.shape + header.dimensions);
+  size_t count = 1;
+  for (size_t extent : shape) {
+    count *= extent;
+  }
+  const size_t elementSize =
+      quantize ? sizeof(uint16_t) : core::getDataTypeByteSize(dataType);
+  if (header.codedSize != count * elementSize) {
+    LOG(ERROR) << "ObservationDecoder::decode(): the packet size doesn't "
+                  "match its shape";
+    return nullptr;
+  }
+
+  std::vector<uint8_t> payload(header.codedSize);
+  const uint8_t* stored = data + sizeof(PacketHeader);
+  const size_t storedSize = size - sizeof(PacketHeader);
+  if (header.flags & Compressed) {
+#ifdef ESP_BUILD_WITH_ZLIB
+    uLongf payloadSize = uLongf(payload.size());
+    if (uncompress(payload.data(), &payloadSize, stored, uLong(storedSize)) !=
+            Z_OK ||
+        payloadSize != payload.size()) {
+      LOG(ERROR) << "ObservationDecoder::decode(): corrupted packet";
+      return nullptr;
+    }
+#else
+    LOG(ERROR) << "ObservationDecoder::decode(): the packet is compressed, "
+                  "but zlib support is not compiled in";
+    return nullptr;
+#endif
+  } else if (storedSize == payload.size()) {
+    std::copy(stored, stored + storedSize, payload.begin());
+  } else {
+    LOG(ERROR) << "ObservationDecoder::decode(): corrupted packet";
+    return nullptr;
+  }
+
+  std::vector<uint8_t> coded = unshuffle(payload, elementSize);
+  if (!(header.flags & Keyframe)) {
+    if (previous_.size() != coded.size()) {
+      LOG(ERROR) << "ObservationDecoder::decode(): the delta doesn't match "
+                    "the previous frame";
+      return nullptr;
+    }
+    delta(coded, previous_, elementSize,
+          !quantize && isFloatingPoint(dataType), true);
+  }
+
+  auto buffer = core::Buffer::create(shape, dataType);
+  if (quantize) {
+    float* depth = reinterpret_cast<float*>(buffer->data.data());
+    for (size_t i = 0; i != count; ++i) {
+      uint16_t code;
+      std::memcpy(&code, coded.data() + i * elementSize, elementSize);
+      depth[i] = code * header.depthStep;
+    }
+  } else {
+    std::copy(coded.begin(), coded.end(), buffer->data.begin());
+  }
+
+  previous_ = std::move(coded);
+  previousSequence_ = header.sequence;
+  hasPrevious_ = true;
+  return buffer;
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,158 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::sensor::ObservationEncoder,
+ *    @ref esp::sensor::ObservationDecoder
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+struct Observation;
+
+/** @brief How @ref ObservationEncoder represents the elements */
+enum class ObservationCodec : uint8_t {
+  /** The elements as they are, decoded bit by bit the same */
+  Lossless = 0,
+
+  /**
+   * Float depth quantized to 16-bit steps of
+   * @ref ObservationEncoderConfiguration::depthStep, saturating at the
+   * largest step. Zero and negative depth, i.e. no hit, stays zero.
+   */
+  QuantizedDepth = 1,
+};
+
+/** @brief Configuration of an @ref ObservationEncoder */
+struct ObservationEncoderConfiguration {
+  ObservationCodec codec = ObservationCodec::Lossless;
+
+  /**
+   * @brief Frames from one keyframe to the next, 1 to encode every frame
+   *    whole
+   *
+   * Frames in between are encoded as their difference to the frame before,
+   * which is mostly zeros for a camera that moved a little and compresses
+   * far better. A decoder that missed a frame has to wait for the next
+   * keyframe, see @ref ObservationEncoder::requestKeyframe().
+   */
+  int keyframeInterval = 30;
+
+  /**
+   * @brief zlib level from 1, fastest, to 9, smallest, 0 to not compress
+   *
+   * Ignored without zlib support.
+   */
+  int compressionLevel = 1;
+
+  /** @brief Meters per step of @ref ObservationCodec::QuantizedDepth */
+  float depthStep = 0.001f;
+};
+
+/**
+@brief Encodes a stream of observations of one sensor into compact packets
+
+Meant for shipping observations over the network, e.g. from a remote
+simulator to rollout workers. Every packet is self-describing, with the
+shape and data type of the observation, and carries a sequence number
+so an @ref ObservationDecoder can tell whether it has the frame a delta
+refers to.
+
+The payload is the observation, or its difference to the previous frame,
+split into byte planes so the bytes of the same significance lie next to
+each other, and compressed with zlib. Integer elements are differenced by
+subtraction, floating-point ones by XOR of their bits, so either way
+decoding gives back the exact elements. The header is in the byte order of
+the host, which is little-endian on every platform the simulator runs on.
+*/
+class ObservationEncoder {
+ public:
+  explicit ObservationEncoder(
+      const ObservationEncoderConfiguration& configuration = {});
+
+  const ObservationEncoderConfiguration& configuration() const {
+    return configuration_;
+  }
+
+  /**
+   * @brief Encode @p buffer into a packet
+   * @return The packet, empty if @p buffer can't be encoded, e.g. with
+   *    @ref ObservationCodec::QuantizedDepth on anything but float elements
+   *    or with more than three dimensions
+   *
+   * A frame of another shape or data type than the previous one is encoded
+   * as a keyframe.
+   */
+  std::vector<uint8_t> encode(const core::Buffer& buffer);
+
+  /** @overload of the CPU buffer of @p observation */
+  std::vector<uint8_t> encode(const Observation& observation);
+
+  /**
+   * @brief Encode the next frame as a keyframe
+   *
+   * For a decoder that lost a packet or just joined the stream.
+   */
+  void requestKeyframe() { framesSinceKeyframe_ = -1; }
+
+  /** @brief Sequence number the next packet gets */
+  uint32_t sequence() const { return sequence_; }
+
+ private:
+  ObservationEncoderConfiguration configuration_;
+  // elements of the previous frame after quantization, deltas refer to it
+  std::vector<uint8_t> previous_;
+  core::DataType previousDataType_ = core::DataType::DT_NONE;
+  std::vector<size_t> previousShape_;
+  int framesSinceKeyframe_ = -1;
+  uint32_t sequence_ = 0;
+
+  ESP_SMART_POINTERS(ObservationEncoder)
+};
+
+/**
+@brief Decodes the packets of an @ref ObservationEncoder
+
+Decode the packets in the order they were encoded. A delta can only be
+decoded right after the frame it refers to, after a lost or corrupted
+packet every delta fails until the next keyframe.
+*/
+class ObservationDecoder {
+ public:
+  /**
+   * @brief Decode a packet
+   * @return The observation, nullptr if the packet is malformed, needs zlib
+   *    support that isn't compiled in or is a delta to a frame this decoder
+   *    didn't decode last
+   */
+  core::Buffer::ptr decode(const uint8_t* data, size_t size);
+
+  /** @overload */
+  core::Buffer::ptr decode(const std::vector<uint8_t>& packet) {
+    return decode(packet.data(), packet.size());
+  }
+
+  /** @brief Forget the previous frame, deltas fail until a keyframe */
+  void reset() { hasPrevious_ = false; }
+
+ private:
+  std::vector<uint8_t> previous_;
+  uint32_t previousSequence_ = 0;
+  bool hasPrevious_ = false;
+
+  ESP_SMART_POINTERS(ObservationDecoder)
+};
+
+}  // namespace sensor
+}  // namespace esp
@@ -2,6 +2,8 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <cstring>
+
 #include <Magnum/ImageView.h>
 #include <Magnum/Math/Algorithms/GramSchmidt.h>
 #include <Magnum/PixelFormat.h>
@@ -9,6 +11,7 @@
 #include "PinholeCamera.h"
 #include "esp/gfx/DepthUnprojection.h"
 #include "esp/gfx/Renderer.h"
+#include "esp/scene/SemanticScene.h"
 #include "esp/sim/Simulator.h"
 
 namespace esp {
@@ -86,6 +89,29 @@ bool PinholeCamera::getObservationSpace(ObservationSpace& space) {
   } else if (spec_->sensorType == SensorType::DEPTH) {
     space.dataType = core::DataType::DT_FLOAT;
   }
+  switch (spec_->observationLayout) {
+    case ObservationLayout::DEFAULT:
+      break;
+    case ObservationLayout::RGB:
+      space.shape[2] = 3;
+      break;
+    case ObservationLayout::GRAYSCALE:
+      space.shape[2] = 1;
+      break;
+    case ObservationLayout::DEPTH_MILLIMETERS:
+      space.dataType = core::DataType::DT_UINT16;
+      break;
+    case ObservationLayout::DEPTH_HALF:
+      space.dataType = core::DataType::DT_FLOAT16;
+      break;
+    case ObservationLayout::POINTS_CAMERA:
+    case ObservationLayout::POINTS_WORLD:
+      space.shape[2] = 3;
+      break;
+    case ObservationLayout::SEMANTIC_HISTOGRAM:
+      space.shape = {static_cast<size_t>(spec_->semanticHistogramBins)};
+      break;
+  }
   return true;
 }
 
@@ -97,55 +123,193 @@ bool PinholeCamera::getObservation(sim::Simulator& sim, Observation& obs) {
     return false;
 
   drawObservation(sim);
-  readObservation(obs);
+  {
+    gfx::RenderProfiler::ScopedPass pass{sim.getRenderer()->profiler(),
+                                         spec_->uuid,
+                                         gfx::RenderProfiler::Pass::Readback};
+    readObservation(obs, renderTarget());
+  }
+  if (obs.buffer != nullptr) {
+    mapSemanticCategories(sim, obs.buffer->data);
+  }
 
   return true;
 }
 
+scene::SceneGraph& PinholeCamera::getSceneGraphToDraw(sim::Simulator& sim) {
+  if (spec_->sensorType == SensorType::SEMANTIC) {
+    // TODO: check sim has semantic scene graph
+    return sim.getActiveSemanticSceneGraph();
+  }
+  // SensorType is DEPTH or any other type
+  return sim.getActiveSceneGraph();
+}
+
 void PinholeCamera::drawObservation(sim::Simulator& sim) {
   renderTarget().renderEnter();
 
   gfx::Renderer::ptr renderer = sim.getRenderer();
+  renderer->draw(*this, getSceneGraphToDraw(sim),
+                 sim.isFrustumCullingEnabled());
+
+  renderTarget().renderExit();
+}
+
+Magnum::PixelFormat PinholeCamera::observationPixelFormat() const {
+  switch (spec_->observationLayout) {
+    case ObservationLayout::DEFAULT:
+      break;
+    case ObservationLayout::RGB:
+      return Magnum::PixelFormat::RGB8Unorm;
+    case ObservationLayout::GRAYSCALE:
+      return Magnum::PixelFormat::R8Unorm;
+    case ObservationLayout::DEPTH_MILLIMETERS:
+      // scaled by RenderTarget::OutputFormat::depthScale to read millimeters
+      return Magnum::PixelFormat::R16Unorm;
+    case ObservationLayout::DEPTH_HALF:
+      return Magnum::PixelFormat::R16F;
+    case ObservationLayout::POINTS_CAMERA:
+    case ObservationLayout::POINTS_WORLD:
+      return Magnum::PixelFormat::RGB32F;
+    case ObservationLayout::SEMANTIC_HISTOGRAM:
+      // counted with additive blending, see readObservation()
+      return Magnum::PixelFormat::R32F;
+  }
+  switch (observationFrameType()) {
+    case gfx::RenderTarget::FrameType::ObjectId:
+      return Magnum::PixelFormat::R32UI;
+    case gfx::RenderTarget::FrameType::Depth:
+      return Magnum::PixelFormat::R32F;
+    default:
+      return Magnum::PixelFormat::RGBA8Unorm;
+  }
+}
+
+gfx::RenderTarget::FrameType PinholeCamera::observationFrameType() const {
   if (spec_->sensorType == SensorType::SEMANTIC) {
-    // TODO: check sim has semantic scene graph
-    renderer->draw(*this, sim.getActiveSemanticSceneGraph(),
-                   sim.isFrustumCullingEnabled());
-  } else {
-    // SensorType is DEPTH or any other type
-    renderer->draw(*this, sim.getActiveSceneGraph(),
-                   sim.isFrustumCullingEnabled());
+    return gfx::RenderTarget::FrameType::ObjectId;
+  } else if (spec_->sensorType == SensorType::DEPTH) {
+    return gfx::RenderTarget::FrameType::Depth;
   }
+  return gfx::RenderTarget::FrameType::Rgba;
+}
 
-  renderTarget().renderExit();
+void PinholeCamera::readObservation(
+    Observation& obs,
+    gfx::RenderTarget& source,
+    Corrade::Containers::Optional<ReadbackMode> mode) {
+#ifdef ESP_BUILD_WITH_CUDA
+  if (spec_->gpu2gpuTransfer) {
+    // stays on the device, the readback mode only applies to CPU reads
+    obs.buffer = nullptr;
+    obs.deviceBuffer = source.readFrameToDevice(observationFrameType());
+    return;
+  }
+#endif
+
+  obs.buffer = acquireObservationBuffer();
+  obs.deviceBuffer = nullptr;
+
+  readObservation(obs.buffer->data, source, mode);
 }
 
-void PinholeCamera::readObservation(Observation& obs) {
+core::Buffer::ptr PinholeCamera::acquireObservationBuffer() {
+  if (observationDestination_) {
+    return observationDestination_;
+  }
+  if (bufferPool_) {
+    return bufferPool_->acquire();
+  }
   // Make sure we have memory
   if (buffer_ == nullptr) {
     // TODO: check if our sensor was resized and resize our buffer if needed
     ObservationSpace space;
     getObservationSpace(space);
-    buffer_ = core::Buffer::create(space.shape, space.dataType);
+    buffer_ = core::Buffer::create(space.shape, space.dataType,
+                                   observationBufferStorage());
   }
-  obs.buffer = buffer_;
+  return buffer_;
+}
+
+void PinholeCamera::readObservation(
+    Corrade::Containers::ArrayView<uint8_t> destination,
+    gfx::RenderTarget& source,
+    Corrade::Containers::Optional<ReadbackMode> mode) {
+  const gfx::RenderTarget::FrameType frameType = observationFrameType();
+  const Magnum::PixelFormat pixelFormat = observationPixelFormat();
+
+  // the target may be shared with sensors of other layouts, see
+  // gfx::Renderer::groupEntriesByView()
+  source.setOutputFormat(outputFormat());
 
   // TODO: have different classes for the different types of sensors
   // TODO: do we need to flip axis?
-  if (spec_->sensorType == SensorType::SEMANTIC) {
-    renderTarget().readFrameObjectId(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32UI, renderTarget().framebufferSize(),
-        obs.buffer->data});
-  } else if (spec_->sensorType == SensorType::DEPTH) {
-    renderTarget().readFrameDepth(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32F, renderTarget().framebufferSize(),
-        obs.buffer->data});
-  } else {
-    renderTarget().readFrameRgba(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::RGBA8Unorm, renderTarget().framebufferSize(),
-        obs.buffer->data});
+  // rows of one- and two-byte layouts aren't padded to four bytes
+  Magnum::MutableImageView2D view{Magnum::PixelStorage{}.setAlignment(1),
+                                  pixelFormat, source.outputSize(frameType),
+                                  destination};
+
+  ReadbackMode readbackMode = mode ? *mode : readbackMode_;
+  // the next sensor drawing into a shared target would overwrite the frame
+  // left in flight, so pipelined reads of shared targets wait instead
+  if (readbackMode == ReadbackMode::PreviousFrame && sharesRenderTarget()) {
+    readbackMode = ReadbackMode::Fenced;
+  }
+  switch (readbackMode) {
+    case ReadbackMode::Synchronous:
+      if (frameType == gfx::RenderTarget::FrameType::ObjectId) {
+        source.readFrameObjectId(view);
+      } else if (frameType == gfx::RenderTarget::FrameType::Depth) {
+        source.readFrameDepth(view);
+      } else {
+        source.readFrameRgba(view);
+      }
+      break;
+    case ReadbackMode::Fenced:
+      source.queueReadFrame(frameType, pixelFormat);
+      source.readQueuedFrame(frameType, view, true);
+      break;
+    case ReadbackMode::PreviousFrame:
+      // keep exactly one read in flight, it is retrieved on the next call
+      source.queueReadFrame(frameType, pixelFormat);
+      if (source.queuedFrameCount(frameType) == 1) {
+        // nothing was in flight yet, wait for this frame and queue it again
+        source.readQueuedFrame(frameType, view, true);
+        source.queueReadFrame(frameType, pixelFormat);
+      } else {
+        while (source.queuedFrameCount(frameType) > 1) {
+          source.readQueuedFrame(frameType, view, true);
+        }
+      }
+      break;
+  }
+
+  // the histogram is read as float counts, convert them in place
+  if (spec_->observationLayout == ObservationLayout::SEMANTIC_HISTOGRAM) {
+    for (uint32_t& count : Corrade::Containers::arrayCast<uint32_t>(
+             destination.prefix(view.data().size()))) {
+      float value;
+      std::memcpy(&value, &count, sizeof(float));
+      count = static_cast<uint32_t>(value);
+    }
   }
 }
 
+void PinholeCamera::mapSemanticCategories(
+    sim::Simulator& sim,
+    Corrade::Containers::ArrayView<uint8_t> data) {
+  if (!spec_->semanticCategoryIds ||
+      spec_->sensorType != SensorType::SEMANTIC) {
+    return;
+  }
+  std::shared_ptr<scene::SemanticScene> semanticScene = sim.getSemanticScene();
+  if (semanticScene == nullptr) {
+    return;
+  }
+  semanticScene->semanticIdsToCategories(
+      Corrade::Containers::arrayCast<uint32_t>(data));
+}
+
 bool PinholeCamera::displayObservation(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
@@ -165,5 +329,24 @@ PinholeCamera::depthUnprojection() const {
   return {gfx::calculateDepthUnprojection(projection)};
 }
 
+gfx::RenderTarget::OutputFormat PinholeCamera::outputFormat() const {
+  gfx::RenderTarget::OutputFormat format = VisualSensor::outputFormat();
+  const ObservationLayout layout = spec_->observationLayout;
+  if (layout != ObservationLayout::POINTS_CAMERA &&
+      layout != ObservationLayout::POINTS_WORLD) {
+    return format;
+  }
+
+  const Magnum::Matrix4 projection = Magnum::Matrix4::perspectiveProjection(
+      Magnum::Deg{hfov_}, static_cast<float>(width_) / height_, near_, far_);
+  format.points = true;
+  format.pointUnprojection = {1.0f / projection[0][0],
+                              1.0f / projection[1][1]};
+  if (layout == ObservationLayout::POINTS_WORLD) {
+    format.pointTransformation = node().absoluteTransformation();
+  }
+  return format;
+}
+
 }  // namespace sensor
 }  // namespace esp
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "VisualSensor.h"
 #include "esp/core/esp.h"
 
@@ -53,29 +55,91 @@ class PinholeCamera : public VisualSensor {
   virtual Corrade::Containers::Optional<Magnum::Vector2> depthUnprojection()
       const override;
 
- protected:
-  // projection parameters
-  int width_ = 640;      // canvas width
-  int height_ = 480;     // canvas height
-  float near_ = 0.001f;  // near clipping plane
-  float far_ = 1000.0f;  // far clipping plane
-  float hfov_ = 35.0f;   // field of vision (in degrees)
+  /**
+   * @brief Processing of the rendering results for the observations, also
+   * unprojecting depth to points for @ref ObservationLayout::POINTS_CAMERA
+   * and @ref ObservationLayout::POINTS_WORLD
+   */
+  virtual gfx::RenderTarget::OutputFormat outputFormat() const override;
 
-  ESP_SMART_POINTERS(PinholeCamera)
+  /**
+   * @brief The scene graph observations of this sensor are drawn from
+   * @param[in] sim Instance of Simulator class owning the scene graphs
+   */
+  scene::SceneGraph& getSceneGraphToDraw(sim::Simulator& sim);
 
   /**
    * @brief Draw an observation using simulator's renderer
    * @param[in] sim Instance of Simulator class for which the observation needs
    *                to be drawn
    */
-  void drawObservation(sim::Simulator& sim);
+  virtual void drawObservation(sim::Simulator& sim);
 
   /**
-   * @brief Read the observation that was rendered by the simulator
+   * @brief Read the observation that was rendered into @p source
+   *
+   * @p source is usually this sensor's own render target, but can be the
+   * target of another sensor that shares this sensor's view, see @ref
+   * gfx::Renderer::groupEntriesByView()
    * @param[in,out] obs Instance of Observation class in which the observation
    *                    will be stored
+   * @param[in] source  Render target the observation was drawn into
+   * @param[in] mode    Readback mode to use instead of @ref readbackMode()
+   */
+  void readObservation(
+      Observation& obs,
+      gfx::RenderTarget& source,
+      Corrade::Containers::Optional<ReadbackMode> mode =
+          Corrade::Containers::NullOpt);
+
+  /**
+   * @brief Read the observation that was rendered into @p source into
+   * caller-provided memory
+   *
+   * Always reads to the CPU, regardless of @ref SensorSpec::gpu2gpuTransfer.
+   * @param[out] destination  At least as large as the observation space
+   * @param[in] source        Render target the observation was drawn into
+   * @param[in] mode          Readback mode to use instead of
+   *                          @ref readbackMode()
+   */
+  virtual void readObservation(
+      Corrade::Containers::ArrayView<uint8_t> destination,
+      gfx::RenderTarget& source,
+      Corrade::Containers::Optional<ReadbackMode> mode =
+          Corrade::Containers::NullOpt);
+
+  /**
+   * @brief Replace the semantic IDs in a read observation with category
+   * indices, if @ref SensorSpec::semanticCategoryIds is enabled
+   * @param[in] sim         Instance of Simulator class owning the semantic
+   *                        scene
+   * @param[in,out] data    Observation as read by @ref readObservation()
    */
-  void readObservation(Observation& obs);
+  void mapSemanticCategories(sim::Simulator& sim,
+                             Corrade::Containers::ArrayView<uint8_t> data);
+
+  /** @brief Kind of rendering result observations are read from */
+  gfx::RenderTarget::FrameType observationFrameType() const;
+
+  /**
+   * @brief Pixel format observations are read as, following
+   * @ref SensorSpec::observationLayout
+   */
+  Magnum::PixelFormat observationPixelFormat() const;
+
+ protected:
+  // the buffer the next CPU observation goes to, the destination, a pooled
+  // one or the sensor's own
+  core::Buffer::ptr acquireObservationBuffer();
+
+  // projection parameters
+  int width_ = 640;      // canvas width
+  int height_ = 480;     // canvas height
+  float near_ = 0.001f;  // near clipping plane
+  float far_ = 1000.0f;  // far clipping plane
+  float hfov_ = 35.0f;   // field of vision (in degrees)
+
+  ESP_SMART_POINTERS(PinholeCamera)
 };
 
 }  // namespace sensor
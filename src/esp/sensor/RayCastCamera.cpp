@@ -0,0 +1,120 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RayCastCamera.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <Magnum/Math/Angle.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/geo/MeshRayCaster.h"
+#include "esp/sim/Simulator.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sensor {
+
+RayCastCamera::RayCastCamera(scene::SceneNode& cameraNode,
+                             SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec) {
+  if (spec_->sensorType != SensorType::DEPTH &&
+      spec_->sensorType != SensorType::SEMANTIC)
+    throw std::runtime_error(
+        "Ray cast sensors support only depth and semantic observations");
+  const ObservationLayout layout = spec_->observationLayout;
+  if (layout != ObservationLayout::DEFAULT &&
+      !(layout == ObservationLayout::DEPTH_MILLIMETERS &&
+        spec_->sensorType == SensorType::DEPTH))
+    throw std::runtime_error(
+        "Ray cast sensors support only the default and millimeter depth "
+        "observation layouts");
+  if (spec_->supersampling != 1)
+    throw std::runtime_error("Ray cast sensors don't support supersampling");
+  if (spec_->gpu2gpuTransfer)
+    throw std::runtime_error(
+        "Ray cast sensors don't support gpu2gpu transfer");
+}
+
+void RayCastCamera::drawObservation(sim::Simulator& sim) {
+  const geo::MeshRayCaster& caster = sim.getMeshRayCaster();
+  const bool semantic = spec_->sensorType == SensorType::SEMANTIC;
+  const bool millimeters =
+      spec_->observationLayout == ObservationLayout::DEPTH_MILLIMETERS;
+  const size_t pixelSize = millimeters ? sizeof(uint16_t) : sizeof(uint32_t);
+  frame_.resize(size_t(width_) * height_ * pixelSize);
+
+  const Mn::Matrix4 transformation = node().absoluteTransformation();
+  const Mn::Vector3 translation = transformation.translation();
+  const vec3f origin{translation.x(), translation.y(), translation.z()};
+  const Mn::Matrix3 rotation = transformation.rotationScaling();
+  // camera space extents of the image plane at unit depth, the same as
+  // the projection of gfx::RenderCamera::setProjectionMatrix()
+  const float right = std::tan(float(Mn::Rad{Mn::Deg{hfov_}}) * 0.5f);
+  const float top = right * height_ / width_;
+  const int width = width_;
+  const int height = height_;
+  const float minDepth = near_;
+  const float maxDepth = far_;
+  uint8_t* const frame = frame_.data();
+
+  // rows are bottom-up, as read from a render target
+#pragma omp parallel for schedule(dynamic, 4)
+  for (int row = 0; row < height; ++row) {
+    const float y = ((row + 0.5f) * 2.0f / height - 1.0f) * top;
+    for (int col = 0; col < width; ++col) {
+      const float x = ((col + 0.5f) * 2.0f / width - 1.0f) * right;
+      // unit depth along the optical axis, so the hit distance is the depth
+      const Mn::Vector3 d = rotation * Mn::Vector3{x, y, -1.0f};
+      const geo::MeshRayCaster::Hit hit = caster.castRay(
+          origin, vec3f{d.x(), d.y(), d.z()}, minDepth, maxDepth);
+      const size_t pixel = size_t(row) * width + col;
+      const bool found = hit.triangle != geo::MeshRayCaster::NoHit;
+      if (semantic) {
+        const uint32_t id = caster.objectId(hit.triangle);
+        std::memcpy(frame + pixel * sizeof(uint32_t), &id, sizeof(uint32_t));
+      } else if (millimeters) {
+        const uint16_t depth = found ? uint16_t(std::min(
+                                           hit.distance * 1000.0f + 0.5f,
+                                           65535.0f))
+                                     : 0;
+        std::memcpy(frame + pixel * sizeof(uint16_t), &depth,
+                    sizeof(uint16_t));
+      } else {
+        const float depth = found ? hit.distance : 0.0f;
+        std::memcpy(frame + pixel * sizeof(float), &depth, sizeof(float));
+      }
+    }
+  }
+}
+
+void RayCastCamera::readObservation(
+    Corrade::Containers::ArrayView<uint8_t> destination) {
+  CORRADE_ASSERT(destination.size() >= frame_.size(),
+                 "RayCastCamera::readObservation(): expected at least"
+                     << frame_.size() << "bytes but got"
+                     << destination.size(), );
+  std::copy(frame_.begin(), frame_.end(), destination.begin());
+}
+
+bool RayCastCamera::getObservation(sim::Simulator& sim, Observation& obs) {
+  drawObservation(sim);
+  obs.buffer = acquireObservationBuffer();
+  obs.deviceBuffer = nullptr;
+  readObservation(obs.buffer->data);
+  mapSemanticCategories(sim, obs.buffer->data);
+  return true;
+}
+
+bool RayCastCamera::displayObservation(sim::Simulator&) {
+  // there is no render target to blit
+  return false;
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,70 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <vector>
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Depth and semantic camera traced on the CPU
+ *
+ * Created for specifications with a @ref SensorSpec::sensorSubtype of
+ * @cpp "raycast" @ce, for nodes without a GPU. Has the projection and the
+ * observations of a @ref PinholeCamera, but casts one ray per pixel through
+ * the center of the pixel against the scene's collision mesh, see
+ * @ref sim::Simulator::getMeshRayCaster(), with the rows distributed over
+ * threads. It never needs a render target, so a simulator whose sensors are
+ * all ray cast ones loads the scene without a renderer, see
+ * @ref sim::SimulatorConfiguration::cpuSceneGeometry.
+ *
+ * Depth is along the optical axis between the near and far planes, 0 where
+ * nothing is hit, like the rendered one. Semantic observations carry the
+ * object IDs of instance meshes, 0 elsewhere. Objects added to the scene
+ * aren't traced. Only @ref ObservationLayout::DEFAULT and, for depth,
+ * @ref ObservationLayout::DEPTH_MILLIMETERS are supported, without
+ * supersampling and gpu2gpu transfer.
+ */
+class RayCastCamera : public PinholeCamera {
+ public:
+  explicit RayCastCamera(scene::SceneNode& cameraNode, SensorSpec::ptr spec);
+
+  virtual ~RayCastCamera() {}
+
+  virtual bool needsRenderTarget() const override { return false; }
+
+  virtual bool getObservation(sim::Simulator& sim, Observation& obs) override;
+
+  virtual bool displayObservation(sim::Simulator& sim) override;
+
+  /**
+   * @brief Trace an observation of the simulator's active scene
+   * @param[in] sim Instance of Simulator class owning the scene
+   */
+  virtual void drawObservation(sim::Simulator& sim) override;
+
+  using PinholeCamera::readObservation;
+
+  /**
+   * @brief Copy the last traced observation into caller-provided memory
+   * @param[out] destination  At least as large as the observation space
+   *
+   * Rows are stored bottom-up, as in rendered observations.
+   */
+  void readObservation(Corrade::Containers::ArrayView<uint8_t> destination);
+
+ protected:
+  // the traced observation, in the observation layout
+  std::vector<uint8_t> frame_;
+
+  ESP_SMART_POINTERS(RayCastCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
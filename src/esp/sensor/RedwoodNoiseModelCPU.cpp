@@ -0,0 +1,134 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RedwoodNoiseModelCPU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <Corrade/Utility/Assert.h>
+
+#include "esp/core/random.h"
+
+namespace esp {
+namespace sensor {
+
+namespace {
+const int MODEL_N_DIMS = 5;
+const int MODEL_N_COLS = 80;
+const int MODEL_N_ROWS = 80;
+
+// Read about the noise model here: http://www.alexteichman.com/octo/clams/
+// Original source code: http://redwood-data.org/indoor/data/simdepth.py
+// Same as the CUDA kernel in RedwoodNoiseModel.cu
+inline float undistort(const int _x,
+                       const int _y,
+                       const float z,
+                       const float* model) {
+  const int i2 = (z + 1) / 2;
+  const int i1 = i2 - 1;
+  const float a = (z - (i1 * 2 + 1)) / 2.0f;
+  const int x = _x / 8;
+  const int y = _y / 6;
+
+  const float* cell = model + (y * MODEL_N_COLS + x) * MODEL_N_DIMS;
+  const float f = (1 - a) * cell[std::min(std::max(i1, 0), 4)] +
+                  a * cell[std::min(i2, 4)];
+
+  if (f <= 1e-5f)
+    return 0;
+  else
+    return z / f;
+}
+}  // namespace
+
+RedwoodNoiseModelCPUImpl::RedwoodNoiseModelCPUImpl(
+    const Eigen::Ref<const Eigen::RowMatrixXf> model,
+    const float noiseMultiplier)
+    : noiseMultiplier_{noiseMultiplier},
+      model_(model.size()),
+      seed_{std::random_device()()} {
+  CORRADE_ASSERT(model.rows() == MODEL_N_ROWS &&
+                     model.cols() == MODEL_N_COLS * MODEL_N_DIMS,
+                 "RedwoodNoiseModelCPUImpl: expected an 80x400 model", );
+  // the reference may be strided, copy row by row
+  Eigen::Map<Eigen::RowMatrixXf>(model_.data(), model.rows(), model.cols()) =
+      model;
+}
+
+Eigen::RowMatrixXf RedwoodNoiseModelCPUImpl::simulateFromCPU(
+    const Eigen::Ref<const Eigen::RowMatrixXf> depth) {
+  const int H = depth.rows();
+  const int W = depth.cols();
+  Eigen::RowMatrixXf noisyDepth(H, W);
+  if (H == 0 || W == 0) {
+    return noisyDepth;
+  }
+
+  const uint64_t frameSeed = seed_++;
+  const float ymax = H - 1;
+  const float xmax = W - 1;
+  // the noise model was originally made for a 640x480 sensor, so re-map our
+  // arbitrarily sized sensor to that size
+  const float xScale = W > 1 ? 639.0f / xmax : 0.0f;
+  const float yScale = H > 1 ? 479.0f / ymax : 0.0f;
+  const float shuffleSigma = 0.25f * noiseMultiplier_;
+  const float quantizationSigma = 0.027778f * noiseMultiplier_;
+  const float* model = model_.data();
+  const float* source = depth.data();
+  // rows of the reference may be strided, e.g. a flipped image
+  const Eigen::Index sourceStride = depth.outerStride();
+  float* target = noisyDepth.data();
+
+#pragma omp parallel if (H * W > 16384)
+  {
+    // three normal samples per pixel: row and column shuffle, quantization
+    std::vector<float> noise(3 * W);
+#pragma omp for schedule(static)
+    for (int j = 0; j < H; ++j) {
+      core::CounterRandom random{frameSeed, uint64_t(j)};
+      random.fill_normal_float_01(noise.data(), noise.size());
+      const float* noiseX = noise.data();
+      const float* noiseY = noiseX + W;
+      const float* noiseQ = noiseY + W;
+      float* row = target + j * W;
+
+      for (int i = 0; i < W; ++i) {
+        // shuffle pixels
+        const int y =
+            std::min(std::max(j + noiseY[i] * shuffleSigma, 0.0f), ymax) +
+            0.5f;
+        const int x =
+            std::min(std::max(i + noiseX[i] * shuffleSigma, 0.0f), xmax) +
+            0.5f;
+
+        // downsample
+        const float d = source[(y - y % 2) * sourceStride + x - x % 2];
+        // if depth is greater than 10m, the sensor will just return a zero
+        if (d >= 10.0f) {
+          row[i] = 0.0f;
+          continue;
+        }
+
+        // distortion
+        const float undistortedD = undistort(x * xScale, y * yScale, d, model);
+
+        // quantization and high freq noise
+        if (undistortedD == 0.0f) {
+          row[i] = 0.0f;
+        } else {
+          const float denom = std::round(35.130f / undistortedD +
+                                         noiseQ[i] * quantizationSigma) *
+                              8.0f;
+          row[i] = denom > 1e-5f ? (35.130f * 8.0f / denom) : 0.0f;
+        }
+      }
+    }
+  }
+  return noisyDepth;
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * Provides a CPU implementation of the Redwood Noise Model for PrimSense
+ * Depth sensors, the same model as @ref RedwoodNoiseModelGPUImpl for machines
+ * without CUDA. Rows are processed in parallel with OpenMP, each with its own
+ * random stream, so the result for a given seed doesn't depend on the thread
+ * count.
+ */
+struct RedwoodNoiseModelCPUImpl {
+  /**
+   * @brief Constructor
+   * @param model             The distortion model from
+   *                          http://redwood-data.org/indoor/data/dist-model.txt
+   *                          The 3rd dimension is assumed to have been
+   *                          flattened into the second
+   * @param noiseMultiplier   Multiplier for the Gaussian random-variables. This
+   *                          can be used to increase or decrease the noise
+   *                          level
+   */
+  RedwoodNoiseModelCPUImpl(const Eigen::Ref<const Eigen::RowMatrixXf> model,
+                           const float noiseMultiplier);
+
+  /**
+   * @brief Simulates noisy depth from clean depth
+   *
+   * @param[in] depth  Clean depth, i.e. depth from habitat's depth shader
+   * @return Simulated noisy depth
+   */
+  Eigen::RowMatrixXf simulateFromCPU(
+      const Eigen::Ref<const Eigen::RowMatrixXf> depth);
+
+  /**
+   * @brief Seed the noise. Each call to @ref simulateFromCPU() advances the
+   * seed, so a sequence of frames is reproducible, not each frame alone.
+   */
+  void seed(uint32_t newSeed) { seed_ = newSeed; }
+
+ private:
+  const float noiseMultiplier_;
+  std::vector<float> model_;
+  uint64_t seed_;
+
+  ESP_SMART_POINTERS(RedwoodNoiseModelCPUImpl)
+};
+
+}  // namespace sensor
+}  // namespace esp
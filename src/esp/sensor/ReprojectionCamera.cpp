@@ -0,0 +1,248 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ReprojectionCamera.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Angle.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+
+#include "esp/core/Metrics.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sensor {
+
+namespace {
+
+float parameter(const SensorSpec& spec,
+                const std::string& name,
+                float defaultValue) {
+  auto found = spec.parameters.find(name);
+  return found == spec.parameters.end() ? defaultValue
+                                        : std::atof(found->second.c_str());
+}
+
+}  // namespace
+
+ReprojectionCamera::ReprojectionCamera(scene::SceneNode& cameraNode,
+                                       SensorSpec::ptr spec)
+    : PinholeCamera(cameraNode, spec),
+      maxTranslation_{
+          parameter(*spec_, "max_reprojection_translation", 0.05f)},
+      maxRotation_{parameter(*spec_, "max_reprojection_rotation", 2.0f)},
+      maxReprojectedFrames_{
+          int(parameter(*spec_, "max_reprojected_frames", 3.0f))},
+      minCoverage_{parameter(*spec_, "min_reprojection_coverage", 0.95f)} {
+  const SensorType type = spec_->sensorType;
+  if (type != SensorType::COLOR && type != SensorType::DEPTH &&
+      type != SensorType::SEMANTIC)
+    throw std::runtime_error(
+        "Reprojection sensors support only color, depth and semantic "
+        "observations");
+  if (spec_->observationLayout != ObservationLayout::DEFAULT)
+    throw std::runtime_error(
+        "Reprojection sensors support only the default observation layout");
+  if (spec_->supersampling != 1)
+    throw std::runtime_error(
+        "Reprojection sensors don't support supersampling");
+  if (spec_->gpu2gpuTransfer)
+    throw std::runtime_error(
+        "Reprojection sensors don't support gpu2gpu transfer");
+  if (spec_->minimalAttachments && type != SensorType::DEPTH)
+    throw std::runtime_error(
+        "Reprojection sensors need the depth attachment of the keyframe");
+}
+
+bool ReprojectionCamera::canReproject(
+    const Mn::Matrix4& transformation) const {
+  if (!hasKeyframe_ || framesSinceKeyframe_ >= maxReprojectedFrames_) {
+    return false;
+  }
+  const float translation =
+      (transformation.translation() - keyframeTransformation_.translation())
+          .length();
+  // angle of the rotation between the two poses
+  const Mn::Matrix3 rotation =
+      keyframeTransformation_.rotation().transposed() *
+      transformation.rotation();
+  const float cosine = Mn::Math::clamp(
+      (rotation[0][0] + rotation[1][1] + rotation[2][2] - 1.0f) * 0.5f, -1.0f,
+      1.0f);
+  const float angle = float(Mn::Deg{Mn::Rad{std::acos(cosine)}});
+  return translation <= maxTranslation_ && angle <= maxRotation_;
+}
+
+void ReprojectionCamera::reproject(const Mn::Matrix4& transformation) {
+  const int width = width_;
+  const int height = height_;
+  const size_t pixelCount = size_t(width) * height;
+  const bool depth = spec_->sensorType == SensorType::DEPTH;
+  // holes are black, without depth and without an object
+  frame_.assign(pixelCount * sizeof(uint32_t), 0);
+  frameDepth_.assign(pixelCount, std::numeric_limits<float>::infinity());
+
+  // keyframe camera space to current camera space
+  const Mn::Matrix4 toCurrent =
+      transformation.inverted() * keyframeTransformation_;
+  // camera space extents of the image plane at unit depth, the same as
+  // the projection of gfx::RenderCamera::setProjectionMatrix()
+  const float right = std::tan(float(Mn::Rad{Mn::Deg{hfov_}}) * 0.5f);
+  const float top = right * height / width;
+
+  // one writer per pixel of the current frame would need atomics, the
+  // splatting is cheap next to a render anyway
+  for (int row = 0; row < height; ++row) {
+    const float y = ((row + 0.5f) * 2.0f / height - 1.0f) * top;
+    for (int col = 0; col < width; ++col) {
+      const size_t pixel = size_t(row) * width + col;
+      const float d = keyframeDepth_[pixel];
+      if (!(d > 0.0f)) {
+        continue;
+      }
+      const float x = ((col + 0.5f) * 2.0f / width - 1.0f) * right;
+      const Mn::Vector3 point =
+          toCurrent.transformPoint(Mn::Vector3{x * d, y * d, -d});
+      const float z = -point.z();
+      if (z < near_ || z > far_) {
+        continue;
+      }
+      const int targetCol =
+          int(std::floor((point.x() / (z * right) + 1.0f) * 0.5f * width));
+      const int targetRow =
+          int(std::floor((point.y() / (z * top) + 1.0f) * 0.5f * height));
+      if (targetCol < 0 || targetCol >= width || targetRow < 0 ||
+          targetRow >= height) {
+        continue;
+      }
+      const size_t target = size_t(targetRow) * width + targetCol;
+      if (z >= frameDepth_[target]) {
+        continue;
+      }
+      frameDepth_[target] = z;
+      if (depth) {
+        std::memcpy(&frame_[target * sizeof(float)], &z, sizeof(float));
+      } else {
+        std::memcpy(&frame_[target * sizeof(uint32_t)],
+                    &keyframe_[pixel * sizeof(uint32_t)], sizeof(uint32_t));
+      }
+    }
+  }
+
+  // moving closer spreads the keyframe pixels apart, fill the cracks they
+  // leave from the farthest splatted neighbor, i.e. the background
+  size_t covered = 0;
+  const std::vector<float> splatted = frameDepth_;
+  const int offsets[4][2]{{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+  for (int row = 0; row < height; ++row) {
+    for (int col = 0; col < width; ++col) {
+      const size_t pixel = size_t(row) * width + col;
+      if (splatted[pixel] != std::numeric_limits<float>::infinity()) {
+        ++covered;
+        continue;
+      }
+      size_t source = pixel;
+      float farthest = 0.0f;
+      int neighbors = 0;
+      for (const auto& offset : offsets) {
+        const int c = col + offset[0];
+        const int r = row + offset[1];
+        if (c < 0 || c >= width || r < 0 || r >= height) {
+          continue;
+        }
+        const size_t neighbor = size_t(r) * width + c;
+        const float z = splatted[neighbor];
+        if (z == std::numeric_limits<float>::infinity()) {
+          continue;
+        }
+        ++neighbors;
+        if (z > farthest) {
+          farthest = z;
+          source = neighbor;
+        }
+      }
+      // a crack has splatted pixels on both sides
+      if (neighbors < 2) {
+        continue;
+      }
+      ++covered;
+      std::memcpy(&frame_[pixel * sizeof(uint32_t)],
+                  &frame_[source * sizeof(uint32_t)], sizeof(uint32_t));
+    }
+  }
+  coverage_ = float(covered) / pixelCount;
+}
+
+void ReprojectionCamera::drawObservation(sim::Simulator& sim) {
+  static core::Metrics::Counter& reprojectedMetric =
+      core::Metrics::counter("sensor.frames_reprojected");
+  const Mn::Matrix4 transformation = node().absoluteTransformation();
+  if (canReproject(transformation)) {
+    reproject(transformation);
+    if (coverage_ >= minCoverage_) {
+      reprojected_ = true;
+      ++framesSinceKeyframe_;
+      ++reprojectedFrames_;
+      reprojectedMetric.add();
+      return;
+    }
+  }
+
+  PinholeCamera::drawObservation(sim);
+  drawnTransformation_ = transformation;
+  reprojected_ = false;
+  coverage_ = 1.0f;
+  ++renderedFrames_;
+}
+
+void ReprojectionCamera::readObservation(
+    Corrade::Containers::ArrayView<uint8_t> destination,
+    gfx::RenderTarget& source,
+    Corrade::Containers::Optional<ReadbackMode> mode) {
+  if (reprojected_) {
+    CORRADE_ASSERT(destination.size() >= frame_.size(),
+                   "ReprojectionCamera::readObservation(): expected at least"
+                       << frame_.size() << "bytes but got"
+                       << destination.size(), );
+    std::copy(frame_.begin(), frame_.end(), destination.begin());
+    return;
+  }
+
+  // the keyframe has to be the frame of drawnTransformation_
+  ReadbackMode readbackMode = mode ? *mode : readbackMode_;
+  if (readbackMode == ReadbackMode::PreviousFrame) {
+    readbackMode = ReadbackMode::Fenced;
+  }
+  PinholeCamera::readObservation(destination, source, readbackMode);
+
+  const size_t pixelCount = size_t(width_) * height_;
+  keyframe_.assign(destination.begin(),
+                   destination.begin() + pixelCount * sizeof(uint32_t));
+  keyframeDepth_.resize(pixelCount);
+  if (spec_->sensorType == SensorType::DEPTH) {
+    std::memcpy(keyframeDepth_.data(), keyframe_.data(),
+                pixelCount * sizeof(float));
+  } else {
+    source.readFrameDepth(Mn::MutableImageView2D{
+        Mn::PixelFormat::R32F,
+        {width_, height_},
+        Corrade::Containers::ArrayView<float>{keyframeDepth_.data(),
+                                              keyframeDepth_.size()}});
+  }
+  keyframeTransformation_ = drawnTransformation_;
+  hasKeyframe_ = true;
+  framesSinceKeyframe_ = 0;
+}
+
+}  // namespace sensor
+}  // namespace esp
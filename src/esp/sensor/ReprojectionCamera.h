@@ -0,0 +1,119 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Magnum/Math/Matrix4.h>
+
+#include "PinholeCamera.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Pinhole camera that reuses its last rendered frame for small motions
+ *
+ * Created for specifications with a @ref SensorSpec::sensorSubtype of
+ * @cpp "reprojection" @ce. A rendered frame is kept as a keyframe together
+ * with its depth. While the sensor stays within
+ * @cpp "max_reprojection_translation" @ce meters (default 0.05) and
+ * @cpp "max_reprojection_rotation" @ce degrees (default 2) of the keyframe
+ * pose, the next @cpp "max_reprojected_frames" @ce observations (default 3)
+ * aren't rendered. Instead the keyframe's pixels are splatted to where
+ * their depth puts them in the current view, nearer ones winning, on the
+ * CPU. One pixel cracks are filled from their farthest neighbor. Regions
+ * disoccluded by the motion stay empty, and a frame covering less than
+ * @cpp "min_reprojection_coverage" @ce of its pixels (default 0.95) is
+ * rendered instead. The parameters are read from
+ * @ref SensorSpec::parameters.
+ *
+ * Approximate: objects that moved since the keyframe appear where they were,
+ * and shading doesn't follow the view. See @ref reprojectionCoverage() for
+ * the quality of the last observation. Only @ref ObservationLayout::DEFAULT
+ * is supported, without supersampling and gpu2gpu transfer. Color and
+ * semantic sensors need all attachments for the keyframe depth.
+ */
+class ReprojectionCamera : public PinholeCamera {
+ public:
+  explicit ReprojectionCamera(scene::SceneNode& cameraNode,
+                              SensorSpec::ptr spec);
+
+  virtual ~ReprojectionCamera() {}
+
+  /**
+   * @brief Draw an observation, or reproject the keyframe if the sensor is
+   * close enough to its pose
+   * @param[in] sim Instance of Simulator class for which the observation needs
+   *                to be drawn
+   */
+  virtual void drawObservation(sim::Simulator& sim) override;
+
+  using PinholeCamera::readObservation;
+
+  /**
+   * @brief Read the observation drawn or reprojected last
+   *
+   * A drawn observation becomes the keyframe, read with
+   * @ref ReadbackMode::Fenced instead of @ref ReadbackMode::PreviousFrame so
+   * that it matches the pose it was drawn from.
+   */
+  virtual void readObservation(
+      Corrade::Containers::ArrayView<uint8_t> destination,
+      gfx::RenderTarget& source,
+      Corrade::Containers::Optional<ReadbackMode> mode =
+          Corrade::Containers::NullOpt) override;
+
+  /**
+   * @brief Fraction of the pixels of the last observation that came from the
+   * keyframe, 1 if it was rendered
+   */
+  float reprojectionCoverage() const { return coverage_; }
+
+  /** @brief Whether the last observation was reprojected */
+  bool lastObservationReprojected() const { return reprojected_; }
+
+  /** @brief Number of observations rendered */
+  int renderedFrameCount() const { return renderedFrames_; }
+
+  /** @brief Number of observations reprojected from a keyframe */
+  int reprojectedFrameCount() const { return reprojectedFrames_; }
+
+ protected:
+  // whether the keyframe can be reprojected to transformation
+  bool canReproject(const Magnum::Matrix4& transformation) const;
+
+  // splats the keyframe into frame_ and sets coverage_
+  void reproject(const Magnum::Matrix4& transformation);
+
+  float maxTranslation_;
+  float maxRotation_;
+  int maxReprojectedFrames_;
+  float minCoverage_;
+
+  // the last rendered observation, its depth along the optical axis and the
+  // absolute transformation it was drawn from, rows bottom-up
+  std::vector<uint8_t> keyframe_;
+  std::vector<float> keyframeDepth_;
+  Magnum::Matrix4 keyframeTransformation_;
+  Magnum::Matrix4 drawnTransformation_;
+  bool hasKeyframe_ = false;
+  int framesSinceKeyframe_ = 0;
+
+  // the reprojected observation and its depth
+  std::vector<uint8_t> frame_;
+  std::vector<float> frameDepth_;
+  bool reprojected_ = false;
+  float coverage_ = 1.0f;
+  int renderedFrames_ = 0;
+  int reprojectedFrames_ = 0;
+
+  ESP_SMART_POINTERS(ReprojectionCamera)
+};
+
+}  // namespace sensor
+}  // namespace esp
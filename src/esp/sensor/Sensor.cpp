@@ -20,6 +20,17 @@ Sensor::Sensor(scene::SceneNode& node, SensorSpec::ptr spec)
   setTransformationFromSpec();
 }
 
+bool Sensor::scheduleObservation() {
+  ++skippedObservations_;
+  const int interval = spec_->updateInterval;
+  if (updateRequested_ || (interval > 0 && skippedObservations_ >= interval)) {
+    updateRequested_ = false;
+    skippedObservations_ = 0;
+    return true;
+  }
+  return false;
+}
+
 void SensorSuite::add(Sensor::ptr sensor) {
   const std::string uuid = sensor->specification()->uuid;
   sensors_[uuid] = sensor;
@@ -53,7 +64,16 @@ bool operator==(const SensorSpec& a, const SensorSpec& b) {
          a.position == b.position && a.orientation == b.orientation &&
          a.resolution == b.resolution && a.channels == b.channels &&
          a.encoding == b.encoding && a.observationSpace == b.observationSpace &&
-         a.noiseModel == b.noiseModel && a.gpu2gpuTransfer == b.gpu2gpuTransfer;
+         a.noiseModel == b.noiseModel &&
+         a.gpu2gpuTransfer == b.gpu2gpuTransfer &&
+         a.semanticCategoryIds == b.semanticCategoryIds &&
+         a.updateInterval == b.updateInterval &&
+         a.supersampling == b.supersampling &&
+         a.minimalAttachments == b.minimalAttachments &&
+         a.msaaSamples == b.msaaSamples &&
+         a.observationLayout == b.observationLayout &&
+         a.semanticHistogramBins == b.semanticHistogramBins &&
+         a.pinnedObservations == b.pinnedObservations;
 }
 bool operator!=(const SensorSpec& a, const SensorSpec& b) {
   return !(a == b);
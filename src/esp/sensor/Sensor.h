@@ -10,6 +10,9 @@
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
+namespace gfx {
+class DeviceBuffer;
+}
 namespace sim {
 class Simulator;
 }
@@ -30,6 +33,29 @@ enum class SensorType {
   TEXT = 9,
 };
 
+// Pixel layout of the observations of visual sensors, converted on the GPU
+// before readback
+enum class ObservationLayout {
+  // RGBA uint8 color, float depth in meters, uint32 semantic IDs
+  DEFAULT = 0,
+  // RGB uint8 color, the alpha channel is not read back
+  RGB = 1,
+  // 8-bit luminance color, one channel
+  GRAYSCALE = 2,
+  // uint16 depth in millimeters, saturating at 65.535 m
+  DEPTH_MILLIMETERS = 3,
+  // float16 depth in meters
+  DEPTH_HALF = 4,
+  // float XYZ point per pixel in the sensor frame, NaN where nothing was hit
+  POINTS_CAMERA = 5,
+  // float XYZ point per pixel in the world frame, NaN where nothing was hit
+  POINTS_WORLD = 6,
+  // uint32 number of pixels showing each object ID, for semantic sensors,
+  // counted on the GPU so that only SensorSpec::semanticHistogramBins values
+  // are read back instead of the frame
+  SEMANTIC_HISTOGRAM = 7,
+};
+
 enum class ObservationSpaceType {
   NONE = 0,
   TENSOR = 1,
@@ -53,6 +79,31 @@ struct SensorSpec {
   std::string observationSpace = "";
   std::string noiseModel = "None";
   bool gpu2gpuTransfer = false;
+  // semantic sensors output the category index of the default mapping
+  // instead of the object ID, see scene::SemanticScene::categoryIndex()
+  bool semanticCategoryIds = false;
+  // render every updateInterval-th observation and return the previous one
+  // in between, 0 renders only when requested, see Sensor::requestUpdate()
+  int updateInterval = 1;
+  // visual sensors render at resolution * supersampling and downsample to
+  // resolution on the GPU, averaging color
+  int supersampling = 1;
+  // visual sensors allocate only the attachment their type reads instead of
+  // color, object IDs and depth, and depth sensors draw depth only with a
+  // trivial shader and color writes off
+  bool minimalAttachments = false;
+  // color sensors draw into multisampled attachments with this many samples
+  // per pixel, 0 or 1 for none
+  int msaaSamples = 0;
+  ObservationLayout observationLayout = ObservationLayout::DEFAULT;
+  // bins of ObservationLayout::SEMANTIC_HISTOGRAM, one per object ID from 0,
+  // pixels of larger IDs aren't counted
+  int semanticHistogramBins = 4096;
+  // observations are read back into page-locked host memory, which CUDA
+  // copies to a device asynchronously by DMA, e.g. to a training GPU other
+  // than the rendering one. Falls back to pageable memory without CUDA, see
+  // core::BufferStorage::Pinned
+  bool pinnedObservations = false;
   ESP_SMART_POINTERS(SensorSpec)
 };
 
@@ -63,6 +114,10 @@ bool operator!=(const SensorSpec& a, const SensorSpec& b);
 struct Observation {
   // TODO: populate this struct with raw data
   core::Buffer::ptr buffer;
+  // observation in CUDA memory, filled instead of buffer by sensors with
+  // SensorSpec::gpu2gpuTransfer enabled. Shared with the pool it came from,
+  // which doesn't reuse it while it is referenced here
+  std::shared_ptr<gfx::DeviceBuffer> deviceBuffer;
   ESP_SMART_POINTERS(Observation)
 };
 
@@ -77,7 +132,7 @@ struct ObservationSpace {
 class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
  public:
   explicit Sensor(scene::SceneNode& node, SensorSpec::ptr spec);
-  virtual ~Sensor() { LOG(INFO) << "Deconstructing Sensor"; }
+  virtual ~Sensor() { VLOG(1) << "Deconstructing Sensor"; }
 
   // Get the scene node being attached to.
   scene::SceneNode& node() { return object(); }
@@ -103,6 +158,33 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
   virtual bool getObservation(sim::Simulator& sim, Observation& obs) = 0;
   virtual bool getObservationSpace(ObservationSpace& space) = 0;
 
+  /**
+   * @brief Render the next observation even if @ref SensorSpec::updateInterval
+   * would skip it
+   *
+   * The first observation of a sensor and the first one after
+   * @ref sim::Simulator::reset() are always rendered.
+   */
+  void requestUpdate() { updateRequested_ = true; }
+
+  /**
+   * @brief Advance the update schedule by one observation
+   * @return Whether the observation has to be rendered. If not, the
+   *      simulator returns @ref lastObservation() instead
+   */
+  bool scheduleObservation();
+
+  /**
+   * @brief The observation the sensor rendered last, empty before the first
+   */
+  const Observation& lastObservation() const { return lastObservation_; }
+
+  /**
+   * @brief Remember @p obs as the observation returned while updates are
+   * skipped
+   */
+  void setLastObservation(const Observation& obs) { lastObservation_ = obs; }
+
   /**
    * @brief Display next observation from Simulator on default frame buffer
    * @param[in] sim Instance of Simulator class for which the observation needs
@@ -115,6 +197,11 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
   SensorSpec::ptr spec_ = nullptr;
   core::Buffer::ptr buffer_ = nullptr;
 
+  // observations skipped since the last rendered one
+  int skippedObservations_ = 0;
+  bool updateRequested_ = true;
+  Observation lastObservation_;
+
   ESP_SMART_POINTERS(Sensor)
 };
 
@@ -125,10 +212,13 @@ class SensorSuite {
  public:
   void add(Sensor::ptr sensor);
   void clear();
-  ~SensorSuite() { LOG(INFO) << "Deconstructing SensorSuite"; }
+  ~SensorSuite() { VLOG(1) << "Deconstructing SensorSuite"; }
 
   Sensor::ptr get(const std::string& uuid) const;
   std::map<std::string, Sensor::ptr>& getSensors() { return sensors_; }
+  const std::map<std::string, Sensor::ptr>& getSensors() const {
+    return sensors_;
+  }
 
  protected:
   std::map<std::string, Sensor::ptr> sensors_;
@@ -4,10 +4,15 @@
 
 #pragma once
 
+#include <vector>
+
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/Optional.h>
 
 #include "esp/core/esp.h"
 
+#include "esp/gfx/CullingBVH.h"
+#include "esp/gfx/OcclusionCuller.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/sensor/Sensor.h"
@@ -15,6 +20,25 @@
 namespace esp {
 namespace sensor {
 
+/**
+ * @brief How a visual sensor reads its rendering results back to the CPU
+ */
+enum class ReadbackMode {
+  /** @brief Read the frame synchronously right after drawing it */
+  Synchronous = 0,
+  /**
+   * @brief Read through a pixel buffer object and wait on its fence. Avoids
+   * the implicit pipeline flush of a synchronous read
+   */
+  Fenced = 1,
+  /**
+   * @brief Return the previous frame's result while the current frame is still
+   * being read back. Observations lag the simulation by one frame; the very
+   * first observation is waited for
+   */
+  PreviousFrame = 2,
+};
+
 // Represents a sensor that provides visual data from the environment to an
 // agent
 class VisualSensor : public Sensor {
@@ -23,10 +47,18 @@ class VisualSensor : public Sensor {
   virtual ~VisualSensor() {}
 
   /**
-   * @brief Return the size of the framebuffer corresponding to the sensor's
-   * resolution as a [W, H] Vector2i
+   * @brief Return the size of the framebuffer the sensor renders into as a
+   * [W, H] Vector2i, the resolution times @ref SensorSpec::supersampling
    */
   Magnum::Vector2i framebufferSize() const {
+    return outputSize() * spec_->supersampling;
+  }
+
+  /**
+   * @brief Return the size of the observations corresponding to the sensor's
+   * resolution as a [W, H] Vector2i
+   */
+  Magnum::Vector2i outputSize() const {
     // NB: The sensor's resolution is in H x W format as that more cleanly
     // corresponds to the practice of treating images as arrays that is used in
     // modern CV and DL. However, graphics frameworks expect W x H format for
@@ -34,6 +66,62 @@ class VisualSensor : public Sensor {
     return {spec_->resolution[1], spec_->resolution[0]};
   }
 
+  /**
+   * @brief Processing of the rendering results for the observations, from
+   * @ref SensorSpec::supersampling and @ref SensorSpec::observationLayout
+   */
+  virtual gfx::RenderTarget::OutputFormat outputFormat() const {
+    gfx::RenderTarget::OutputFormat format;
+    format.supersampling = spec_->supersampling;
+    format.grayscale =
+        spec_->observationLayout == ObservationLayout::GRAYSCALE;
+    if (spec_->observationLayout == ObservationLayout::DEPTH_MILLIMETERS) {
+      // read through a normalized 16-bit format
+      format.depthScale = 1000.0f / 65535.0f;
+    }
+    if (spec_->observationLayout == ObservationLayout::SEMANTIC_HISTOGRAM) {
+      format.objectIdHistogramBins = spec_->semanticHistogramBins;
+    }
+    return format;
+  }
+
+  /**
+   * @brief Attachments of the render target, all of them unless
+   * @ref SensorSpec::minimalAttachments asks for only the one the sensor
+   * type reads
+   */
+  gfx::RenderTarget::Flags renderTargetFlags() const {
+    using Flag = gfx::RenderTarget::Flag;
+    if (!spec_->minimalAttachments)
+      return Flag::RgbaAttachment | Flag::ObjectIdAttachment;
+    switch (spec_->sensorType) {
+      case SensorType::COLOR:
+        return Flag::RgbaAttachment;
+      case SensorType::SEMANTIC:
+        return Flag::ObjectIdAttachment;
+      case SensorType::DEPTH:
+        return {};
+      default:
+        return Flag::RgbaAttachment | Flag::ObjectIdAttachment;
+    }
+  }
+
+  /**
+   * @brief Samples per pixel of the render target, see
+   * @ref SensorSpec::msaaSamples
+   */
+  int renderTargetSamples() const {
+    return spec_->msaaSamples > 1 ? spec_->msaaSamples : 0;
+  }
+
+  /**
+   * @brief Whether the sensor draws only depth, with color writes masked
+   */
+  bool drawsDepthOnly() const {
+    return spec_->minimalAttachments &&
+           spec_->sensorType == SensorType::DEPTH;
+  }
+
   virtual bool isVisualSensor() override { return true; }
 
   // visual sensor should implement and override the following functions
@@ -74,19 +162,212 @@ class VisualSensor : public Sensor {
     return Corrade::Containers::NullOpt;
   };
 
+  /**
+   * @brief How rendering results are read back, see @ref ReadbackMode
+   */
+  ReadbackMode readbackMode() const { return readbackMode_; }
+
+  /**
+   * @brief Set how rendering results are read back
+   * @return Reference to self (for method chaining)
+   *
+   * A shared render target is replaced with one of the sensor's own for
+   * @ref ReadbackMode::PreviousFrame, which keeps reads in flight across
+   * frames.
+   */
+  VisualSensor& setReadbackMode(ReadbackMode mode) {
+    readbackMode_ = mode;
+    if (mode == ReadbackMode::PreviousFrame)
+      unshareRenderTarget();
+    return *this;
+  }
+
+  /**
+   * @brief Whether every observation gets its own buffer from a pool
+   *
+   * By default all observations of a sensor share one buffer, which the next
+   * observation overwrites. With pooling, the buffer of an observation is
+   * only reused once nobody references it anymore, so zero-copy views of
+   * older observations stay valid.
+   */
+  bool observationBufferPooling() const { return bufferPool_ != nullptr; }
+
+  /**
+   * @brief Enable or disable observation buffer pooling
+   * @param enabled   Whether to pool observation buffers
+   * @param capacity  Number of buffers to preallocate. Should cover the
+   *                  observations a consumer holds on to at the same time,
+   *                  the pool grows beyond it only if needed
+   * @param storage   Memory of the buffers, @ref core::BufferStorage::Pinned
+   *                  for observations copied to a CUDA device afterwards.
+   *                  Always pinned with @ref SensorSpec::pinnedObservations
+   * @return Reference to self (for method chaining)
+   */
+  VisualSensor& setObservationBufferPooling(
+      bool enabled,
+      size_t capacity = 2,
+      core::BufferStorage storage = core::BufferStorage::Aligned) {
+    if (spec_->pinnedObservations) {
+      storage = core::BufferStorage::Pinned;
+    }
+    if (!enabled) {
+      bufferPool_ = nullptr;
+    } else if (!bufferPool_ || bufferPool_->storage() != storage) {
+      ObservationSpace space;
+      getObservationSpace(space);
+      bufferPool_ = core::BufferPool::create(space.shape, space.dataType,
+                                             capacity, storage);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Pool observation buffers come from, nullptr if pooling is disabled
+   */
+  core::BufferPool::ptr observationBufferPool() const { return bufferPool_; }
+
+  /**
+   * @brief Read observations into a caller's buffer instead of own ones
+   * @param destination  Buffer of the shape and type of the observation
+   *                     space, usually wrapping one row of a tensor that
+   *                     stacks the observations of many simulators, see
+   *                     @ref core::Buffer::wrap(). nullptr goes back to the
+   *                     sensor's own buffers
+   * @return Reference to self (for method chaining)
+   *
+   * Takes precedence over @ref setObservationBufferPooling(), each
+   * observation overwrites the previous one in place, rows bottom-up as
+   * always. Observations with @ref SensorSpec::gpu2gpuTransfer stay on the
+   * device and don't use it.
+   */
+  VisualSensor& setObservationDestination(core::Buffer::ptr destination) {
+    if (destination) {
+      ObservationSpace space;
+      getObservationSpace(space);
+      if (destination->shape != space.shape ||
+          destination->dataType != space.dataType)
+        throw std::runtime_error(
+            "observation destination doesn't match the observation space");
+    }
+    observationDestination_ = std::move(destination);
+    return *this;
+  }
+
+  /**
+   * @brief Buffer observations are read into, nullptr if the sensor's own
+   */
+  core::Buffer::ptr observationDestination() const {
+    return observationDestination_;
+  }
+
+  /**
+   * @brief Memory observation buffers are allocated in, see
+   * @ref SensorSpec::pinnedObservations
+   */
+  core::BufferStorage observationBufferStorage() const {
+    return spec_->pinnedObservations ? core::BufferStorage::Pinned
+                                     : core::BufferStorage::Aligned;
+  }
+
+  /**
+   * @brief Apply the Redwood depth noise model as part of rendering
+   * @param model            The distortion model, see
+   *                         @ref RedwoodNoiseModelCPUImpl. An empty model
+   *                         disables the noise
+   * @param noiseMultiplier  Multiplier for the Gaussian random-variables
+   * @return Reference to self (for method chaining)
+   *
+   * Unlike applying a noise model to the observation, the noise is computed
+   * while the render target unprojects depth, so one readback gives the noisy
+   * result. Kept across @ref bindRenderTarget(). Only for depth sensors. A
+   * shared render target is replaced with one of the sensor's own, as the
+   * noise model is part of the target.
+   */
+  VisualSensor& setDepthNoiseModel(std::vector<float> model,
+                                   float noiseMultiplier) {
+    if (!model.empty() && spec_->sensorType != SensorType::DEPTH)
+      throw std::runtime_error("Depth noise requires a depth sensor");
+    if (!model.empty())
+      unshareRenderTarget();
+    depthNoiseModel_ = std::move(model);
+    depthNoiseMultiplier_ = noiseMultiplier;
+    if (tgt_)
+      tgt_->setDepthNoiseModel(depthNoiseModel_, depthNoiseMultiplier_);
+    return *this;
+  }
+
+  /** @brief Whether depth noise is applied, see @ref setDepthNoiseModel() */
+  bool hasDepthNoiseModel() const { return !depthNoiseModel_.empty(); }
+
   /**
    * @brief Checks to see if this sensor has a RenderTarget bound or not
    */
   bool hasRenderTarget() const { return tgt_ != nullptr; }
 
   /**
-   * @brief Binds the given given RenderTarget to the sensor.  The sensor takes
-   * ownership of the RenderTarget
+   * @brief Whether the sensor draws through a render target, false for
+   * sensors that produce observations on the CPU, see
+   * @ref RayCastCamera
    */
-  void bindRenderTarget(gfx::RenderTarget::uptr&& tgt) {
+  virtual bool needsRenderTarget() const { return true; }
+
+  /**
+   * @brief Binds the given given RenderTarget to the sensor
+   * @param tgt     The render target
+   * @param shared  Whether other sensors draw into the same target, see
+   *                @ref gfx::Renderer::setRenderTargetSharing()
+   *
+   * A shared target only holds the results of the sensor between its draw
+   * and its readback and can't take a noise model, see
+   * @ref canShareRenderTarget().
+   */
+  void bindRenderTarget(gfx::RenderTarget::ptr tgt, bool shared = false) {
     if (tgt->framebufferSize() != framebufferSize())
       throw std::runtime_error("RenderTarget is not the correct size");
+    if (shared && !canShareRenderTarget())
+      throw std::runtime_error("Sensor can't share its RenderTarget");
+    checkObservationLayout();
     tgt_ = std::move(tgt);
+    renderTargetShared_ = shared;
+    if (!depthNoiseModel_.empty())
+      tgt_->setDepthNoiseModel(depthNoiseModel_, depthNoiseMultiplier_);
+  }
+
+  /**
+   * @brief Whether the bound render target is shared with other sensors
+   */
+  bool sharesRenderTarget() const { return renderTargetShared_; }
+
+  /**
+   * @brief Whether the sensor can draw into a render target shared with
+   * other sensors
+   *
+   * Not with a depth noise model, see @ref setDepthNoiseModel(), and not
+   * with @ref ReadbackMode::PreviousFrame.
+   */
+  bool canShareRenderTarget() const {
+    return depthNoiseModel_.empty() &&
+           readbackMode_ != ReadbackMode::PreviousFrame;
+  }
+
+  /**
+   * @brief Occlusion culling state of the sensor's view, see
+   * @ref gfx::Renderer::setOcclusionCulling()
+   */
+  gfx::OcclusionCuller& occlusionCuller() {
+    if (!occlusionCuller_)
+      occlusionCuller_ = gfx::OcclusionCuller::create_unique();
+    return *occlusionCuller_;
+  }
+
+  /**
+   * @brief Frustum culling results of the sensor's view, see
+   * @ref gfx::Renderer::cullAhead()
+   */
+  gfx::CullingResults& cullingResults() {
+    if (!cullingResults_)
+      cullingResults_ = gfx::CullingResults::create_unique();
+    return *cullingResults_;
   }
 
   /**
@@ -99,7 +380,68 @@ class VisualSensor : public Sensor {
   }
 
  protected:
-  gfx::RenderTarget::uptr tgt_ = nullptr;
+  // throws if the spec asks for an output the sensor can't produce
+  void checkObservationLayout() const {
+    if (spec_->supersampling < 1)
+      throw std::runtime_error("Supersampling has to be at least 1");
+    const ObservationLayout layout = spec_->observationLayout;
+    const bool colorLayout =
+        layout == ObservationLayout::RGB ||
+        layout == ObservationLayout::GRAYSCALE;
+    const bool depthLayout =
+        layout == ObservationLayout::DEPTH_MILLIMETERS ||
+        layout == ObservationLayout::DEPTH_HALF;
+    const bool pointsLayout = layout == ObservationLayout::POINTS_CAMERA ||
+                              layout == ObservationLayout::POINTS_WORLD;
+    const bool histogramLayout =
+        layout == ObservationLayout::SEMANTIC_HISTOGRAM;
+    if ((colorLayout && spec_->sensorType != SensorType::COLOR) ||
+        ((depthLayout || pointsLayout) &&
+         spec_->sensorType != SensorType::DEPTH) ||
+        (histogramLayout && spec_->sensorType != SensorType::SEMANTIC))
+      throw std::runtime_error(
+          "Observation layout doesn't match the sensor type");
+    // one pixel per bin, the minimum maximum renderbuffer size of desktop GL
+    if (histogramLayout && (spec_->semanticHistogramBins < 1 ||
+                            spec_->semanticHistogramBins > 16384))
+      throw std::runtime_error(
+          "Semantic histograms need between 1 and 16384 bins");
+    // the counts are per object, not per category
+    if (histogramLayout && spec_->semanticCategoryIds)
+      throw std::runtime_error(
+          "Semantic histograms don't support category IDs");
+    // warped projections don't map pixels to rays through a single matrix
+    if (pointsLayout && spec_->sensorSubtype != "pinhole")
+      throw std::runtime_error(
+          "Point observations are supported only by pinhole sensors");
+    if (spec_->msaaSamples < 0)
+      throw std::runtime_error("MSAA samples can't be negative");
+    // depth and object IDs would resolve to an arbitrary sample
+    if (spec_->msaaSamples > 1 && spec_->sensorType != SensorType::COLOR)
+      throw std::runtime_error("MSAA is supported only by color sensors");
+    if (spec_->gpu2gpuTransfer &&
+        (spec_->supersampling != 1 || layout != ObservationLayout::DEFAULT))
+      throw std::runtime_error(
+          "gpu2gpu transfer supports only the default observation layout");
+  }
+
+  // replaces a shared render target with an empty one of the same kind
+  void unshareRenderTarget() {
+    if (renderTargetShared_) {
+      tgt_ = tgt_->createCompatible();
+      renderTargetShared_ = false;
+    }
+  }
+
+  gfx::RenderTarget::ptr tgt_ = nullptr;
+  bool renderTargetShared_ = false;
+  ReadbackMode readbackMode_ = ReadbackMode::Synchronous;
+  core::BufferPool::ptr bufferPool_ = nullptr;
+  core::Buffer::ptr observationDestination_ = nullptr;
+  std::vector<float> depthNoiseModel_;
+  float depthNoiseMultiplier_ = 1.0f;
+  gfx::OcclusionCuller::uptr occlusionCuller_ = nullptr;
+  gfx::CullingResults::uptr cullingResults_ = nullptr;
 
   ESP_SMART_POINTERS(VisualSensor)
 };
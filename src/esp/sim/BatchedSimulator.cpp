@@ -0,0 +1,187 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BatchedSimulator.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include <Corrade/Utility/Assert.h>
+
+#include "esp/core/Profiler.h"
+#include "esp/sensor/PinholeCamera.h"
+
+namespace esp {
+namespace sim {
+
+BatchedSimulator::BatchedSimulator(
+    const std::vector<SimulatorConfiguration>& configs)
+    : configs_{configs} {
+  CORRADE_ASSERT(!configs_.empty(),
+                 "BatchedSimulator: expected at least one configuration", );
+  for (SimulatorConfiguration& cfg : configs_) {
+    CORRADE_ASSERT(cfg.gpuDeviceId == configs_.front().gpuDeviceId,
+                   "BatchedSimulator: all simulators have to use the same "
+                   "GPU device", );
+    cfg.contextPool = true;
+  }
+  simulators_.reserve(configs_.size());
+  for (const SimulatorConfiguration& cfg : configs_) {
+    simulators_.push_back(Simulator::create(cfg));
+  }
+  agentObservations_.resize(simulators_.size());
+}
+
+BatchedSimulator::~BatchedSimulator() {
+  LOG(INFO) << "Deconstructing BatchedSimulator";
+  unbindObservations();
+}
+
+void BatchedSimulator::reconfigure(size_t index,
+                                   const SimulatorConfiguration& cfg) {
+  CORRADE_ASSERT(index < simulators_.size(),
+                 "BatchedSimulator::reconfigure(): index" << index
+                     << "out of range for" << simulators_.size()
+                     << "simulators", );
+  configs_[index] = cfg;
+  configs_[index].gpuDeviceId = configs_.front().gpuDeviceId;
+  configs_[index].contextPool = true;
+  simulators_[index]->reconfigure(configs_[index]);
+}
+
+const BatchObservations& BatchedSimulator::step(
+    const std::vector<std::string>& actions,
+    double dt /* = 1.0 / 60.0 */) {
+  ESP_PROFILE_SCOPE("BatchedSimulator::step");
+  CORRADE_ASSERT(actions.size() == simulators_.size(),
+                 "BatchedSimulator::step(): expected" << simulators_.size()
+                     << "actions but got" << actions.size(),
+                 observations_);
+  const int count = simulators_.size();
+  // acting and physics don't touch the shared context; the implicit barrier
+  // at the end of the loop keeps the simulators in lockstep
+#pragma omp parallel for schedule(dynamic, 1)
+  for (int i = 0; i < count; ++i) {
+    simulators_[i]->stepAgents({{configs_[i].defaultAgentId, actions[i]}},
+                               dt);
+  }
+  return getObservations();
+}
+
+const BatchObservations& BatchedSimulator::getObservations() {
+  ESP_PROFILE_SCOPE("BatchedSimulator::getObservations");
+  bindObservations();
+  for (size_t i = 0; i != simulators_.size(); ++i) {
+    simulators_[i]->getAgentObservations(configs_[i].defaultAgentId,
+                                         agentObservations_[i]);
+  }
+  return observations_;
+}
+
+std::vector<BatchedSimulator::Binding> BatchedSimulator::stackableCameras()
+    const {
+  std::vector<Binding> cameras;
+  std::map<sensor::SensorType, sensor::ObservationSpace> spaces;
+  for (size_t i = 0; i != simulators_.size(); ++i) {
+    agent::Agent::ptr ag =
+        simulators_[i]->getAgent(configs_[i].defaultAgentId);
+    if (ag == nullptr) {
+      continue;
+    }
+    for (const auto& s : ag->getSensorSuite().getSensors()) {
+      auto camera = dynamic_cast<sensor::PinholeCamera*>(s.second.get());
+      if (camera == nullptr || !camera->hasRenderTarget() ||
+          camera->specification()->gpu2gpuTransfer) {
+        continue;
+      }
+      sensor::ObservationSpace space;
+      camera->getObservationSpace(space);
+      const sensor::SensorType type = camera->specification()->sensorType;
+      auto found = spaces.find(type);
+      if (found == spaces.end()) {
+        spaces.emplace(type, space);
+      } else if (found->second.shape != space.shape ||
+                 found->second.dataType != space.dataType) {
+        LOG(ERROR) << "BatchedSimulator: sensor " << s.first
+                   << " of simulator " << i
+                   << " doesn't match the shape of other sensors of its type, "
+                      "skipping";
+        continue;
+      }
+      cameras.push_back({i, s.second, std::move(space)});
+    }
+  }
+  return cameras;
+}
+
+void BatchedSimulator::bindObservations() {
+  std::vector<Binding> cameras = stackableCameras();
+  const bool unchanged =
+      cameras.size() == bindings_.size() &&
+      std::equal(cameras.begin(), cameras.end(), bindings_.begin(),
+                 [](const Binding& a, const Binding& b) {
+                   return a.sensor == b.sensor &&
+                          a.space.shape == b.space.shape &&
+                          a.space.dataType == b.space.dataType;
+                 });
+  if (unchanged) {
+    return;
+  }
+
+  unbindObservations();
+  observations_.tensors.clear();
+  bindings_ = std::move(cameras);
+
+  // rows of each type, pinned if any of its sensors wants pinned memory
+  std::map<sensor::SensorType, const sensor::ObservationSpace*> spaces;
+  std::set<sensor::SensorType> pinnedTypes;
+  for (const Binding& binding : bindings_) {
+    const sensor::SensorSpec& spec = *binding.sensor->specification();
+    BatchObservations::Tensor& tensor =
+        observations_.tensors[spec.sensorType];
+    tensor.sensors.emplace_back(int(binding.simulator), spec.uuid);
+    spaces.emplace(spec.sensorType, &binding.space);
+    if (spec.pinnedObservations) {
+      pinnedTypes.insert(spec.sensorType);
+    }
+  }
+  for (auto& tensor : observations_.tensors) {
+    const sensor::ObservationSpace& space = *spaces.at(tensor.first);
+    std::vector<size_t> shape{tensor.second.sensors.size()};
+    shape.insert(shape.end(), space.shape.begin(), space.shape.end());
+    tensor.second.storage = pinnedTypes.count(tensor.first)
+                                ? core::BufferStorage::Pinned
+                                : core::BufferStorage::Aligned;
+    tensor.second.buffer =
+        core::Buffer::create(shape, space.dataType, tensor.second.storage);
+  }
+
+  // the rows are handed out in binding order, which lists each type in the
+  // order of its tensor's sensors
+  std::map<sensor::SensorType, size_t> nextRows;
+  for (const Binding& binding : bindings_) {
+    const sensor::SensorType type =
+        binding.sensor->specification()->sensorType;
+    BatchObservations::Tensor& tensor = observations_.tensors.at(type);
+    Corrade::Containers::ArrayView<uint8_t> data = tensor.buffer->data;
+    const size_t rowSize = data.size() / tensor.sensors.size();
+    const size_t row = nextRows[type]++;
+    static_cast<sensor::VisualSensor&>(*binding.sensor)
+        .setObservationDestination(core::Buffer::wrap(
+            data.data() + row * rowSize, binding.space.shape,
+            binding.space.dataType));
+  }
+}
+
+void BatchedSimulator::unbindObservations() {
+  for (const Binding& binding : bindings_) {
+    static_cast<sensor::VisualSensor&>(*binding.sensor)
+        .setObservationDestination(nullptr);
+  }
+  bindings_.clear();
+}
+
+}  // namespace sim
+}  // namespace esp
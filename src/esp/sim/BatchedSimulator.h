@@ -0,0 +1,117 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::sim::BatchedSimulator
+ */
+
+#include <string>
+#include <vector>
+
+#include "esp/core/esp.h"
+#include "esp/sim/Simulator.h"
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief Simulators stepped in lockstep, with their observations stacked
+ *
+ * Replaces a vector of environments in separate processes, which pays for
+ * inter-process communication and pickling on every step. All simulators
+ * share the @ref gfx::ContextPool context of one device, so they are created,
+ * stepped and destroyed on the thread that creates the batch.
+ *
+ * A @ref step() acts for the default agent of every simulator and steps its
+ * physics on worker threads, every simulator finishing before any is drawn.
+ * The simulators are then drawn one after another through the shared
+ * context and their pinhole cameras read back straight into one tensor per
+ * sensor type, through @ref sensor::VisualSensor::setObservationDestination().
+ * Agents and sensors are set up through @ref simulator(), the tensors follow
+ * them on the next step.
+ */
+class BatchedSimulator {
+ public:
+  /**
+   * @brief Constructor
+   * @param configs   Configuration of each simulator. All have to use the
+   *    same GPU device, @ref SimulatorConfiguration::contextPool is
+   *    enabled for all of them.
+   */
+  explicit BatchedSimulator(const std::vector<SimulatorConfiguration>& configs);
+
+  ~BatchedSimulator();
+
+  BatchedSimulator(const BatchedSimulator&) = delete;
+  BatchedSimulator& operator=(const BatchedSimulator&) = delete;
+
+  /** @brief Number of simulators */
+  size_t size() const { return simulators_.size(); }
+
+  /** @brief Simulator at given index */
+  Simulator::ptr simulator(size_t index) const {
+    return simulators_.at(index);
+  }
+
+  /**
+   * @brief Reconfigure the simulator at given index
+   *
+   * @ref SimulatorConfiguration::contextPool is enabled and the GPU device
+   * of the batch used, whatever @p cfg says.
+   */
+  void reconfigure(size_t index, const SimulatorConfiguration& cfg);
+
+  /**
+   * @brief Act, step physics and observe all simulators
+   * @param actions   Action of the default agent of each simulator, ignored
+   *    if it has no such action
+   * @param dt        Time to advance each physical world by
+   * @return One tensor per sensor type, stacking the pinhole cameras of the
+   *    default agents. Row @p i belongs to the simulator and sensor uuid of
+   *    @ref BatchObservations::Tensor::sensors[i]. The storage belongs to
+   *    the batch and is overwritten by the next step.
+   *
+   * Sensors of one type must have the same resolution and channel count to
+   * be stacked; mismatching ones, sensors without a render target and
+   * sensors with @ref sensor::SensorSpec::gpu2gpuTransfer are skipped.
+   */
+  const BatchObservations& step(const std::vector<std::string>& actions,
+                                double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Observe all simulators without acting, see @ref step()
+   */
+  const BatchObservations& getObservations();
+
+ private:
+  // a camera reading into a row of observations_
+  struct Binding {
+    size_t simulator;
+    sensor::Sensor::ptr sensor;
+    sensor::ObservationSpace space;
+  };
+
+  // cameras of the default agents that can be stacked, in row order
+  std::vector<Binding> stackableCameras() const;
+
+  // (re)allocates the tensors and points the cameras at their rows if the
+  // cameras changed since the last call
+  void bindObservations();
+
+  // points the bound cameras back at their own buffers
+  void unbindObservations();
+
+  std::vector<SimulatorConfiguration> configs_;
+  std::vector<Simulator::ptr> simulators_;
+  std::vector<AgentObservations> agentObservations_;
+  std::vector<Binding> bindings_;
+  BatchObservations observations_;
+
+  ESP_SMART_POINTERS(BatchedSimulator)
+};
+
+}  // namespace sim
+}  // namespace esp
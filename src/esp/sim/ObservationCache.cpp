@@ -0,0 +1,99 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObservationCache.h"
+
+#include <Corrade/Utility/Algorithms.h>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sim {
+
+void ObservationCache::setMaxByteSize(size_t maxByteSize) {
+  maxByteSize_ = maxByteSize;
+  while (byteSize_ > maxByteSize_) {
+    erase(entries_.find(lru_.back()));
+    ++stats_.evictions;
+  }
+}
+
+const std::vector<sensor::Observation>* ObservationCache::find(uint64_t key) {
+  auto found = entries_.find(key);
+  if (found == entries_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  ++stats_.hits;
+  lru_.splice(lru_.begin(), lru_, found->second.lruPosition);
+  return &found->second.observations;
+}
+
+void ObservationCache::insert(
+    uint64_t key,
+    const std::vector<sensor::Observation>& observations) {
+  size_t byteSize = 0;
+  for (const sensor::Observation& obs : observations) {
+    if (obs.buffer != nullptr) {
+      byteSize += obs.buffer->data.size();
+    }
+  }
+  auto found = entries_.find(key);
+  if (found != entries_.end()) {
+    erase(found);
+  }
+  if (byteSize > maxByteSize_) {
+    return;
+  }
+  while (byteSize_ + byteSize > maxByteSize_) {
+    erase(entries_.find(lru_.back()));
+    ++stats_.evictions;
+  }
+
+  // copies, the sensors reuse their buffers for the next observation
+  Entry entry;
+  entry.byteSize = byteSize;
+  for (const sensor::Observation& obs : observations) {
+    sensor::Observation copy;
+    if (obs.buffer != nullptr) {
+      copy.buffer =
+          core::Buffer::create(obs.buffer->shape, obs.buffer->dataType);
+      Cr::Utility::copy(obs.buffer->data, copy.buffer->data);
+    }
+    entry.observations.push_back(std::move(copy));
+  }
+  lru_.push_front(key);
+  entry.lruPosition = lru_.begin();
+  entries_.emplace(key, std::move(entry));
+  byteSize_ += byteSize;
+}
+
+void ObservationCache::erase(
+    std::unordered_map<uint64_t, Entry>::iterator it) {
+  byteSize_ -= it->second.byteSize;
+  lru_.erase(it->second.lruPosition);
+  entries_.erase(it);
+}
+
+void ObservationCache::clear() {
+  entries_.clear();
+  lru_.clear();
+  byteSize_ = 0;
+}
+
+void ObservationCache::resetStats() {
+  stats_.hits = 0;
+  stats_.misses = 0;
+  stats_.evictions = 0;
+}
+
+ObservationCache::Stats ObservationCache::stats() const {
+  Stats stats = stats_;
+  stats.entries = entries_.size();
+  stats.byteSize = byteSize_;
+  return stats;
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,116 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::sim::ObservationCache
+ */
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "esp/core/esp.h"
+#include "esp/sensor/Sensor.h"
+
+namespace esp {
+namespace sim {
+
+/**
+@brief Least recently used cache of rendered observations, capped in bytes
+
+Maps a 64-bit key, e.g. a hash of the sensor poses and the scene state, to
+copies of the observations of all sensors of an agent, see
+@ref Simulator::setObservationCache(). Only host buffers are cached.
+*/
+class ObservationCache {
+ public:
+  /** @brief Statistics of the cache */
+  struct Stats {
+    //! Lookups that found cached observations
+    size_t hits = 0;
+    //! Lookups that found nothing
+    size_t misses = 0;
+    //! Entries evicted to stay within the byte size cap
+    size_t evictions = 0;
+    //! Entries currently cached
+    size_t entries = 0;
+    //! Bytes of the cached buffers
+    size_t byteSize = 0;
+
+    //! Fraction of lookups that hit, 0 before the first
+    double hitRate() const {
+      return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses);
+    }
+  };
+
+  /**
+   * @brief Constructor
+   * @param maxByteSize   Bytes of buffers cached at most, 0 caches nothing
+   */
+  explicit ObservationCache(size_t maxByteSize = 0)
+      : maxByteSize_{maxByteSize} {}
+
+  /** @brief Bytes of buffers cached at most */
+  size_t maxByteSize() const { return maxByteSize_; }
+
+  /**
+   * @brief Set the bytes of buffers cached at most
+   *
+   * Evicts the least recently used entries until the cache fits.
+   */
+  void setMaxByteSize(size_t maxByteSize);
+
+  /**
+   * @brief Find the observations cached for @p key
+   * @return The observations, nullptr if there are none. Valid until the
+   *      next @ref insert() or @ref clear()
+   *
+   * Marks the entry as most recently used and counts a hit or a miss.
+   */
+  const std::vector<sensor::Observation>* find(uint64_t key);
+
+  /**
+   * @brief Cache copies of @p observations under @p key
+   *
+   * Replaces what was cached under @p key and evicts the least recently
+   * used entries to make room. Observations without a host buffer are
+   * cached empty; nothing is cached if the buffers alone exceed
+   * @ref maxByteSize().
+   */
+  void insert(uint64_t key,
+              const std::vector<sensor::Observation>& observations);
+
+  /** @brief Drop all entries, keeping the statistics */
+  void clear();
+
+  /** @brief Reset the hit, miss and eviction counts */
+  void resetStats();
+
+  /** @brief Statistics */
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::vector<sensor::Observation> observations;
+    size_t byteSize;
+    std::list<uint64_t>::iterator lruPosition;
+  };
+
+  void erase(std::unordered_map<uint64_t, Entry>::iterator it);
+
+  size_t maxByteSize_;
+  size_t byteSize_ = 0;
+  // most recently used first
+  std::list<uint64_t> lru_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  Stats stats_;
+
+  ESP_SMART_POINTERS(ObservationCache)
+};
+
+}  // namespace sim
+}  // namespace esp
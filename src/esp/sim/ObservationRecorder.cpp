@@ -0,0 +1,356 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObservationRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/sim/Simulator.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sim {
+
+namespace {
+
+// bytes of a .npy header, large enough for any frame count and shape
+constexpr size_t NpyHeaderSize = 256;
+
+bool isVideo(const core::Buffer& buffer) {
+  return buffer.dataType == core::DataType::DT_UINT8 &&
+         buffer.shape.size() == 3 &&
+         (buffer.shape[2] == 3 || buffer.shape[2] == 4);
+}
+
+// numpy's type string of the little-endian data
+const char* npyDescr(core::DataType dataType) {
+  switch (dataType) {
+    case core::DataType::DT_INT8:
+      return "|i1";
+    case core::DataType::DT_UINT8:
+      return "|u1";
+    case core::DataType::DT_INT16:
+      return "<i2";
+    case core::DataType::DT_UINT16:
+      return "<u2";
+    case core::DataType::DT_INT32:
+      return "<i4";
+    case core::DataType::DT_UINT32:
+      return "<u4";
+    case core::DataType::DT_INT64:
+      return "<i8";
+    case core::DataType::DT_UINT64:
+      return "<u8";
+    case core::DataType::DT_FLOAT:
+      return "<f4";
+    case core::DataType::DT_DOUBLE:
+      return "<f8";
+    case core::DataType::DT_FLOAT16:
+      return "<f2";
+    default:
+      return nullptr;
+  }
+}
+
+// version 1.0 header of frameCount frames of given shape, padded to
+// NpyHeaderSize so that it can be rewritten in place once the count is known
+std::string npyHeader(core::DataType dataType,
+                      const std::vector<size_t>& shape,
+                      size_t frameCount) {
+  std::ostringstream dict;
+  dict << "{'descr': '" << npyDescr(dataType)
+       << "', 'fortran_order': False, 'shape': (" << frameCount << ",";
+  for (size_t i = 0; i != shape.size(); ++i) {
+    dict << (i ? ", " : " ") << shape[i];
+  }
+  dict << "), }";
+  std::string header{"\x93NUMPY\x01\x00", 8};
+  const size_t length = NpyHeaderSize - 10;
+  header += char(length & 0xff);
+  header += char(length >> 8);
+  header += dict.str();
+  header.resize(NpyHeaderSize - 1, ' ');
+  header += '\n';
+  return header;
+}
+
+uint8_t clampByte(int value) {
+  return uint8_t(std::min(value, 255));
+}
+
+}  // namespace
+
+struct ObservationRecorder::Stream {
+  std::ofstream file;
+  bool video = false;
+  std::vector<size_t> shape;
+  core::DataType dataType = core::DataType::DT_NONE;
+  size_t frameCount = 0;
+  // Y, Cb and Cr planes of the frame being written
+  std::vector<uint8_t> planes;
+};
+
+ObservationRecorder::ObservationRecorder(const std::string& directory,
+                                         int fps,
+                                         size_t maxQueuedFrames,
+                                         bool dropWhenFull)
+    : directory_{directory},
+      fps_{fps},
+      maxQueuedFrames_{std::max(maxQueuedFrames, size_t{1})},
+      dropWhenFull_{dropWhenFull} {
+  thread_ = std::thread{[this]() { run(); }};
+}
+
+ObservationRecorder::~ObservationRecorder() {
+  close();
+}
+
+void ObservationRecorder::beginEpisode(const std::string& name) {
+  CORRADE_ASSERT(!name.empty(),
+                 "ObservationRecorder::beginEpisode(): empty episode name", );
+  endEpisode();
+  episode_ = name;
+}
+
+void ObservationRecorder::endEpisode() {
+  if (episode_.empty()) {
+    return;
+  }
+  push({episode_, {}, nullptr});
+  episode_.clear();
+}
+
+bool ObservationRecorder::record(const std::string& uuid,
+                                 const core::Buffer& observation,
+                                 bool topRowFirst /* = false */) {
+  if (episode_.empty()) {
+    return false;
+  }
+  core::Buffer::ptr copy =
+      core::Buffer::create(observation.shape, observation.dataType);
+  CORRADE_ASSERT(copy->data.size() == observation.data.size(),
+                 "ObservationRecorder::record(): buffer of sensor"
+                     << uuid << "doesn't match its shape",
+                 false);
+  // images are flipped while copying, one-dimensional data like histograms
+  // has no rows
+  if (topRowFirst || observation.shape.size() < 2) {
+    std::memcpy(copy->data.data(), observation.data.data(),
+                copy->data.size());
+  } else {
+    const size_t rows = observation.shape[0];
+    const size_t rowSize = rows ? copy->data.size() / rows : 0;
+    for (size_t row = 0; row != rows; ++row) {
+      std::memcpy(copy->data.data() + row * rowSize,
+                  observation.data.data() + (rows - 1 - row) * rowSize,
+                  rowSize);
+    }
+  }
+  return push({episode_, uuid, std::move(copy)});
+}
+
+size_t ObservationRecorder::record(const AgentObservations& observations) {
+  size_t count = 0;
+  for (size_t i = 0; i != observations.observations.size(); ++i) {
+    const core::Buffer::ptr& buffer = observations.observations[i].buffer;
+    if (buffer && record(observations.sensorUuids[i], *buffer)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+bool ObservationRecorder::push(Task task) {
+  const bool frame = task.buffer != nullptr;
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (frame && queuedFrames_ >= maxQueuedFrames_) {
+      if (dropWhenFull_) {
+        ++droppedFrames_;
+        return false;
+      }
+      written_.wait(lock, [this]() {
+        return stopping_ || queuedFrames_ < maxQueuedFrames_;
+      });
+    }
+    if (stopping_) {
+      return false;
+    }
+    tasks_.push_back(std::move(task));
+    if (frame) {
+      ++queuedFrames_;
+    }
+  }
+  wake_.notify_one();
+  return true;
+}
+
+void ObservationRecorder::flush() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  written_.wait(lock, [this]() { return tasks_.empty() && !busy_; });
+}
+
+void ObservationRecorder::close() {
+  endEpisode();
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  written_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+size_t ObservationRecorder::queuedFrames() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return queuedFrames_;
+}
+
+size_t ObservationRecorder::writtenFrames() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return writtenFrames_;
+}
+
+size_t ObservationRecorder::droppedFrames() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return droppedFrames_;
+}
+
+void ObservationRecorder::run() {
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      wake_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      // whatever was queued before stopping is still written
+      if (tasks_.empty()) {
+        break;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      busy_ = true;
+    }
+    const bool written = write(task);
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      busy_ = false;
+      if (task.buffer) {
+        --queuedFrames_;
+        ++(written ? writtenFrames_ : droppedFrames_);
+      }
+    }
+    written_.notify_all();
+  }
+  closeStreams();
+}
+
+bool ObservationRecorder::write(const Task& task) {
+  if (task.episode != writtenEpisode_) {
+    closeStreams();
+    writtenEpisode_ = task.episode;
+  }
+  if (!task.buffer) {
+    closeStreams();
+    writtenEpisode_.clear();
+    return true;
+  }
+  const core::Buffer& buffer = *task.buffer;
+
+  auto found = streams_.find(task.uuid);
+  if (found == streams_.end()) {
+    auto stream = std::make_unique<Stream>();
+    stream->video = isVideo(buffer);
+    stream->shape = buffer.shape;
+    stream->dataType = buffer.dataType;
+    const std::string episodeDirectory =
+        Cr::Utility::Directory::join(directory_, task.episode);
+    const std::string filename = Cr::Utility::Directory::join(
+        episodeDirectory, task.uuid + (stream->video ? ".y4m" : ".npy"));
+    if (!stream->video && !npyDescr(buffer.dataType)) {
+      LOG(ERROR) << "ObservationRecorder: sensor " << task.uuid
+                 << " has no data type, not recording it";
+    } else if (!Cr::Utility::Directory::mkpath(episodeDirectory)) {
+      LOG(ERROR) << "ObservationRecorder: can't create " << episodeDirectory;
+    } else {
+      stream->file.open(filename, std::ios::binary | std::ios::trunc);
+      if (!stream->file) {
+        LOG(ERROR) << "ObservationRecorder: can't open " << filename;
+      }
+    }
+    if (stream->video) {
+      stream->file << "YUV4MPEG2 W" << buffer.shape[1] << " H"
+                   << buffer.shape[0] << " F" << fps_
+                   << ":1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+    } else if (npyDescr(buffer.dataType)) {
+      stream->file << npyHeader(buffer.dataType, buffer.shape, 0);
+    }
+    // a stream that failed to open stays in the map and drops its frames
+    found = streams_.emplace(task.uuid, std::move(stream)).first;
+  }
+  Stream& stream = *found->second;
+  if (!stream.file.is_open() || !stream.file) {
+    return false;
+  }
+  if (buffer.shape != stream.shape || buffer.dataType != stream.dataType) {
+    LOG(ERROR) << "ObservationRecorder: frame of sensor " << task.uuid
+               << " doesn't match the shape of its first frame, dropping";
+    return false;
+  }
+
+  if (stream.video) {
+    // full-range BT.601 in 8-bit fixed point, the chroma offset by 128
+    // beforehand to keep the shifts unsigned
+    const size_t pixelCount = buffer.shape[0] * buffer.shape[1];
+    const size_t channels = buffer.shape[2];
+    stream.planes.resize(3 * pixelCount);
+    uint8_t* y = stream.planes.data();
+    uint8_t* cb = y + pixelCount;
+    uint8_t* cr = cb + pixelCount;
+    const uint8_t* pixel = buffer.data.data();
+    for (size_t i = 0; i != pixelCount; ++i, pixel += channels) {
+      const int r = pixel[0], g = pixel[1], b = pixel[2];
+      y[i] = clampByte((77 * r + 150 * g + 29 * b + 128) >> 8);
+      cb[i] = clampByte((-43 * r - 85 * g + 128 * b + 32896) >> 8);
+      cr[i] = clampByte((128 * r - 107 * g - 21 * b + 32896) >> 8);
+    }
+    stream.file << "FRAME\n";
+    stream.file.write(reinterpret_cast<const char*>(stream.planes.data()),
+                      stream.planes.size());
+  } else {
+    stream.file.write(reinterpret_cast<const char*>(buffer.data.data()),
+                      buffer.data.size());
+  }
+  if (!stream.file) {
+    LOG(ERROR) << "ObservationRecorder: writing a frame of sensor "
+               << task.uuid << " failed";
+    return false;
+  }
+  ++stream.frameCount;
+  return true;
+}
+
+void ObservationRecorder::closeStreams() {
+  for (auto& entry : streams_) {
+    Stream& stream = *entry.second;
+    if (stream.file.is_open() && !stream.video) {
+      stream.file.seekp(0);
+      stream.file << npyHeader(stream.dataType, stream.shape,
+                               stream.frameCount);
+    }
+  }
+  streams_.clear();
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,183 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Class @ref esp::sim::ObservationRecorder
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sim {
+
+struct AgentObservations;
+
+/**
+@brief Records sensor streams to disk on a writer thread
+
+Meant for recording datasets of many episodes without encoding an image per
+frame on the simulation thread. @ref record() only copies the observation
+into pooled memory and queues it, the writer thread converts and writes it.
+
+Every episode gets a directory of its own, with one file per sensor uuid:
+
+-   RGB and RGBA observations (3 or 4 channels of @ref core::DataType::DT_UINT8)
+    go to a `<uuid>.y4m` YUV4MPEG2 stream of full-range 4:4:4 frames. That is
+    what video encoders take as raw input, e.g.
+    `ffmpeg -i rgba.y4m -c:v h264_nvenc rgba.mp4` or `-c:v hevc_vaapi`, so
+    compressing a stream with a hardware encoder is one call per episode
+    outside of the simulation loop. The alpha channel is dropped.
+-   Everything else, e.g. depth and semantic observations, goes losslessly to
+    a `<uuid>.npy` array stacking the frames along a new first dimension,
+    readable with `numpy.load()` once the episode ended.
+
+The sensors of an episode have to keep their shape, frames of another shape
+than the first one of their sensor are dropped with an error.
+*/
+class ObservationRecorder {
+ public:
+  /**
+   * @brief Constructor
+   * @param directory       Directory the episode directories are created in
+   * @param fps             Frame rate written to the video streams
+   * @param maxQueuedFrames Frames queued for the writer at most
+   * @param dropWhenFull    Whether @ref record() drops a frame when the
+   *    queue is full instead of waiting for the writer
+   */
+  explicit ObservationRecorder(const std::string& directory,
+                               int fps = 30,
+                               size_t maxQueuedFrames = 64,
+                               bool dropWhenFull = false);
+
+  /** @brief Calls @ref close() */
+  ~ObservationRecorder();
+
+  ObservationRecorder(const ObservationRecorder&) = delete;
+  ObservationRecorder& operator=(const ObservationRecorder&) = delete;
+
+  /** @brief Directory the episode directories are created in */
+  const std::string& directory() const { return directory_; }
+
+  /**
+   * @brief Start recording into the directory @p name
+   *
+   * Ends the current episode, if any. The files of an episode that is
+   * recorded again are overwritten.
+   */
+  void beginEpisode(const std::string& name);
+
+  /**
+   * @brief End the current episode
+   *
+   * Returns right away, the files are complete once the writer got to it,
+   * see @ref flush().
+   */
+  void endEpisode();
+
+  /** @brief Whether an episode is being recorded */
+  bool isRecording() const { return !episode_.empty(); }
+
+  /**
+   * @brief Queue a frame of the sensor @p uuid
+   * @param uuid        Sensor the frame belongs to
+   * @param observation Frame to record
+   * @param topRowFirst Whether the rows start at the top, like the arrays
+   *    of the Python API, instead of at the bottom like observations read
+   *    back by the sensors
+   * @return Whether the frame was queued, false if it was dropped because
+   *    the queue was full or there is no episode
+   *
+   * Copies @p observation, which can be reused right after. Frames are
+   * written top row first whatever @p topRowFirst is.
+   */
+  bool record(const std::string& uuid,
+              const core::Buffer& observation,
+              bool topRowFirst = false);
+
+  /**
+   * @brief Queue a frame of every sensor with a host buffer
+   * @return Number of frames queued
+   */
+  size_t record(const AgentObservations& observations);
+
+  /** @brief Wait until the writer wrote everything queued */
+  void flush();
+
+  /**
+   * @brief End the current episode, write everything queued and stop the
+   *    writer
+   *
+   * Nothing can be recorded afterwards.
+   */
+  void close();
+
+  /** @brief Frames not written yet */
+  size_t queuedFrames() const;
+
+  /** @brief Frames written since construction */
+  size_t writtenFrames() const;
+
+  /**
+   * @brief Frames dropped since construction, because the queue was full or
+   *    writing them failed
+   */
+  size_t droppedFrames() const;
+
+ private:
+  // a frame, or the end of an episode if buffer is null
+  struct Task {
+    std::string episode;
+    std::string uuid;
+    core::Buffer::ptr buffer;
+  };
+
+  // an open file of the episode being written
+  struct Stream;
+
+  // false if the frame was dropped
+  bool push(Task task);
+  void run();
+  bool write(const Task& task);
+  void closeStreams();
+
+  const std::string directory_;
+  const int fps_;
+  const size_t maxQueuedFrames_;
+  const bool dropWhenFull_;
+  // the episode record() queues frames for, empty if none
+  std::string episode_;
+
+  mutable std::mutex mutex_;
+  // wakes the writer once there is a task or it has to stop
+  std::condition_variable wake_;
+  // wakes waiting producers once there is room or everything is written
+  std::condition_variable written_;
+  std::deque<Task> tasks_;
+  size_t queuedFrames_ = 0;
+  size_t writtenFrames_ = 0;
+  size_t droppedFrames_ = 0;
+  bool busy_ = false;
+  bool stopping_ = false;
+  std::thread thread_;
+
+  // owned by the writer thread
+  std::string writtenEpisode_;
+  std::map<std::string, std::unique_ptr<Stream>> streams_;
+
+  ESP_SMART_POINTERS(ObservationRecorder)
+};
+
+}  // namespace sim
+}  // namespace esp
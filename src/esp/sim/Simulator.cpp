@@ -4,15 +4,35 @@
 
 #include "Simulator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
 
 #include "esp/assets/Attributes.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/SharedMemoryRing.h"
+#include "esp/core/TaskScheduler.h"
+#include "esp/core/Topology.h"
 #include "esp/core/esp.h"
+#include "esp/gfx/CachedShaderProgram.h"
+#include "esp/gfx/ContextPool.h"
 #include "esp/gfx/Drawable.h"
+#include "esp/gfx/ImageWriter.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/io/io.h"
@@ -21,8 +41,10 @@
 #include "esp/scene/ObjectControls.h"
 #include "esp/scene/SemanticScene.h"
 #include "esp/sensor/PinholeCamera.h"
+#include "esp/sim/SimulatorCheckpoint.h"
 
 namespace Cr = Corrade;
+namespace Mn = Magnum;
 
 namespace esp {
 namespace sim {
@@ -38,51 +60,418 @@ Simulator::~Simulator() {
   LOG(INFO) << "Deconstructing Simulator";
 }
 
+namespace {
+// whether switching between the two configurations needs the scene, its
+// drawables or the renderer to be rebuilt. The remaining fields are only
+// read on demand.
+bool requiresSceneReload(const SimulatorConfiguration& a,
+                         const SimulatorConfiguration& b) {
+  return a.scene != b.scene || a.gpuDeviceId != b.gpuDeviceId ||
+         a.contextPool != b.contextPool ||
+         a.shareContext != b.shareContext ||
+         a.compressTextures != b.compressTextures ||
+         a.optimizeMeshes != b.optimizeMeshes ||
+         a.compactMeshLayout != b.compactMeshLayout ||
+         a.primitiveObjectIds != b.primitiveObjectIds ||
+         a.ptexVertexPulling != b.ptexVertexPulling ||
+         a.meshLodLevels != b.meshLodLevels ||
+         a.maxTextureSize != b.maxTextureSize ||
+         a.textureAtlases != b.textureAtlases ||
+         a.createRenderer != b.createRenderer ||
+         a.cpuSceneGeometry != b.cpuSceneGeometry ||
+         a.frustumCulling != b.frustumCulling ||
+         a.instancedObjectDrawing != b.instancedObjectDrawing ||
+         a.multiDrawStaticMeshes != b.multiDrawStaticMeshes ||
+         a.semanticIdsOnRenderMesh != b.semanticIdsOnRenderMesh ||
+         a.enablePhysics != b.enablePhysics ||
+         a.physicsConfigFile != b.physicsConfigFile ||
+         a.sceneLightSetup != b.sceneLightSetup;
+}
+
+std::string sceneMeshFilename(const scene::SceneConfiguration& scene) {
+  if (scene.filepaths.count("mesh")) {
+    return scene.filepaths.at("mesh");
+  }
+  return scene.id;
+}
+
+std::string sceneNavmeshFilename(const scene::SceneConfiguration& scene) {
+  if (scene.filepaths.count("navmesh")) {
+    return scene.filepaths.at("navmesh");
+  }
+  return io::changeExtension(sceneMeshFilename(scene), ".navmesh");
+}
+
+std::string sceneHouseFilename(const scene::SceneConfiguration& scene) {
+  const std::string sceneFilename = sceneMeshFilename(scene);
+  std::string houseFilename = io::changeExtension(sceneFilename, ".house");
+  if (!io::exists(houseFilename)) {
+    houseFilename = io::changeExtension(sceneFilename, ".scn");
+  }
+  if (scene.filepaths.count("house")) {
+    houseFilename = scene.filepaths.at("house");
+  }
+
+  if (!io::exists(houseFilename)) {
+    houseFilename = io::changeExtension(sceneFilename, ".scn");
+  }
+  return houseFilename;
+}
+
+// the semantic annotations only depend on the files they come from
+std::string semanticSceneKey(assets::AssetType type,
+                             const std::string& sceneFilename,
+                             const std::string& houseFilename) {
+  return std::to_string(int(type)) + ":" + sceneFilename + ":" +
+         houseFilename;
+}
+
+scene::SemanticScene::ptr loadSemanticScene(assets::AssetType type,
+                                            const std::string& sceneFilename,
+                                            std::string houseFilename) {
+  scene::SemanticScene::ptr semanticScene = scene::SemanticScene::create();
+  switch (type) {
+    case assets::AssetType::INSTANCE_MESH:
+      houseFilename = Cr::Utility::Directory::join(
+          Cr::Utility::Directory::path(houseFilename), "info_semantic.json");
+      if (io::exists(houseFilename)) {
+        scene::SemanticScene::loadReplicaHouse(houseFilename, *semanticScene);
+      }
+      break;
+    case assets::AssetType::MP3D_MESH:
+      // TODO(msb) Fix AssetType determination logic.
+      if (io::exists(houseFilename)) {
+        using Corrade::Utility::String::endsWith;
+        if (endsWith(houseFilename, ".house")) {
+          scene::SemanticScene::loadMp3dHouse(houseFilename, *semanticScene);
+        } else if (endsWith(houseFilename, ".scn")) {
+          scene::SemanticScene::loadGibsonHouse(houseFilename, *semanticScene);
+        }
+      }
+      break;
+    case assets::AssetType::SUNCG_SCENE:
+      scene::SemanticScene::loadSuncgHouse(sceneFilename, *semanticScene);
+      break;
+    default:
+      break;
+  }
+  return semanticScene;
+}
+
+// navmeshes and semantic scenes loaded by Simulator::preload(), each taken by
+// the first simulator of the process loading the same files
+struct PreloadedSceneData {
+  static PreloadedSceneData& instance() {
+    static PreloadedSceneData data;
+    return data;
+  }
+
+  template <class T>
+  std::shared_ptr<T> take(std::map<std::string, std::shared_ptr<T>>& map,
+                          const std::string& key) {
+    std::lock_guard<std::mutex> lock{mutex};
+    auto found = map.find(key);
+    if (found == map.end()) {
+      return nullptr;
+    }
+    std::shared_ptr<T> value = std::move(found->second);
+    map.erase(found);
+    return value;
+  }
+
+  std::mutex mutex;
+  // keyed by the navmesh filename
+  std::map<std::string, nav::PathFinder::ptr> pathfinders;
+  // keyed by semanticSceneKey()
+  std::map<std::string, scene::SemanticScene::ptr> semanticScenes;
+};
+
+// Pinhole camera of an agent and where writeObservations() puts it
+struct RingEntry {
+  std::string uuid;
+  sensor::PinholeCamera* camera;
+  sensor::ObservationSpace space;
+  size_t offset;
+  size_t byteSize;
+};
+
+// Observations of an agent packed one after another, 64-byte aligned
+std::vector<RingEntry> ringEntries(agent::Agent& agent, size_t& byteSize) {
+  std::vector<RingEntry> entries;
+  byteSize = 0;
+  for (const auto& s : agent.getSensorSuite().getSensors()) {
+    auto camera = dynamic_cast<sensor::PinholeCamera*>(s.second.get());
+    if (camera == nullptr || !camera->hasRenderTarget() ||
+        camera->specification()->gpu2gpuTransfer) {
+      continue;
+    }
+    RingEntry entry{s.first, camera, {}, byteSize, 0};
+    camera->getObservationSpace(entry.space);
+    entry.byteSize = core::getDataTypeByteSize(entry.space.dataType);
+    for (size_t dim : entry.space.shape) {
+      entry.byteSize *= dim;
+    }
+    byteSize = (byteSize + entry.byteSize + 63) / 64 * 64;
+    entries.push_back(std::move(entry));
+  }
+  return entries;
+}
+
+const char* numpyTypeName(core::DataType dataType) {
+  switch (dataType) {
+    case core::DataType::DT_INT8:
+      return "int8";
+    case core::DataType::DT_UINT8:
+      return "uint8";
+    case core::DataType::DT_INT16:
+      return "int16";
+    case core::DataType::DT_UINT16:
+      return "uint16";
+    case core::DataType::DT_INT32:
+      return "int32";
+    case core::DataType::DT_UINT32:
+      return "uint32";
+    case core::DataType::DT_INT64:
+      return "int64";
+    case core::DataType::DT_UINT64:
+      return "uint64";
+    case core::DataType::DT_FLOAT:
+      return "float32";
+    case core::DataType::DT_DOUBLE:
+      return "float64";
+    case core::DataType::DT_FLOAT16:
+      return "float16";
+    case core::DataType::DT_NONE:
+      break;
+  }
+  return "void";
+}
+
+std::string ringLayout(const std::vector<RingEntry>& entries) {
+  std::string layout = "[";
+  for (const RingEntry& entry : entries) {
+    if (layout.size() > 1) {
+      layout += ", ";
+    }
+    // uuids are identifiers, they need no escaping
+    layout += "{\"uuid\": \"" + entry.uuid + "\", \"offset\": " +
+              std::to_string(entry.offset) + ", \"shape\": [";
+    for (size_t i = 0; i < entry.space.shape.size(); ++i) {
+      layout += (i ? ", " : "") + std::to_string(entry.space.shape[i]);
+    }
+    layout += "], \"dtype\": \"";
+    layout += numpyTypeName(entry.space.dataType);
+    layout += "\"}";
+  }
+  return layout + "]";
+}
+
+// FNV-1a over position or orientation components rounded to resolution, so
+// values within the resolution of each other mostly hash the same
+void hashQuantized(uint64_t& hash, float value, float resolution) {
+  const int64_t quantized = std::llround(double(value) / resolution);
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&quantized);
+  for (size_t i = 0; i != sizeof(quantized); ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+}
+
+void hashQuantizedPose(uint64_t& hash,
+                       const Magnum::Matrix4& transformation,
+                       float positionResolution,
+                       float rotationResolution) {
+  for (int i = 0; i != 3; ++i) {
+    hashQuantized(hash, transformation.translation()[i], positionResolution);
+  }
+  // the axes instead of a quaternion, which has two signs per orientation
+  for (int i = 0; i != 3; ++i) {
+    for (int j = 0; j != 3; ++j) {
+      hashQuantized(hash, transformation[i][j], rotationResolution);
+    }
+  }
+}
+
+void updateSensorUuids(
+    const std::map<std::string, sensor::Sensor::ptr>& sensors,
+    std::vector<std::string>& uuids) {
+  // only touch the uuids when the sensors changed, so that a steady state
+  // step doesn't allocate
+  bool sensorsChanged = uuids.size() != sensors.size();
+  if (!sensorsChanged) {
+    size_t i = 0;
+    for (const auto& s : sensors) {
+      if (uuids[i++] != s.first) {
+        sensorsChanged = true;
+        break;
+      }
+    }
+  }
+  if (sensorsChanged) {
+    uuids.clear();
+    for (const auto& s : sensors) {
+      uuids.push_back(s.first);
+    }
+  }
+}
+
+// spreads the low 10 bits of v two zero bits apart, for a 3D Morton code
+uint32_t spreadBits(uint32_t v) {
+  v &= 0x3ff;
+  v = (v | (v << 16)) & 0x030000ff;
+  v = (v | (v << 8)) & 0x0300f00f;
+  v = (v | (v << 4)) & 0x030c30c3;
+  v = (v | (v << 2)) & 0x09249249;
+  return v;
+}
+
+// order of the poses along a Morton curve over 1 m cells, within a cell by
+// heading in eighths of a turn, so consecutive draws see mostly the same
+// drawables
+std::vector<size_t> coherentPoseOrder(
+    Cr::Containers::ArrayView<const float> positions,
+    const std::vector<Mn::Quaternion>& rotations) {
+  const size_t count = rotations.size();
+  Mn::Vector3 min{std::numeric_limits<float>::max()};
+  for (size_t i = 0; i != count; ++i) {
+    min = Mn::Math::min(min, Mn::Vector3::from(&positions[3 * i]));
+  }
+  std::vector<uint64_t> keys(count);
+  for (size_t i = 0; i != count; ++i) {
+    const Mn::Vector3 cell =
+        Mn::Math::clamp(Mn::Math::floor(Mn::Vector3::from(&positions[3 * i]) -
+                                        min),
+                        0.0f, 1023.0f);
+    const uint64_t morton = spreadBits(uint32_t(cell.x())) |
+                            spreadBits(uint32_t(cell.y())) << 1 |
+                            spreadBits(uint32_t(cell.z())) << 2;
+    const Mn::Vector3 forward =
+        rotations[i].transformVectorNormalized(-Mn::Vector3::zAxis());
+    const float turn =
+        (std::atan2(forward.x(), -forward.z()) + Mn::Constants::pi()) /
+        (2.0f * Mn::Constants::pi());
+    keys[i] = morton << 3 | std::min(uint64_t(turn * 8.0f), uint64_t{7});
+  }
+  std::vector<size_t> order(count);
+  for (size_t i = 0; i != count; ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+  return order;
+}
+
+// before the context is created, so that the threads of the driver inherit
+// the affinity and memory policy as well
+void pinNextToGpu(int gpuDevice) {
+  const core::DeviceLocality locality =
+      gfx::WindowlessContext::deviceLocality(gpuDevice);
+  if (locality.cpus.empty()) {
+    LOG(WARNING) << "Simulator: can't tell the CPUs next to GPU " << gpuDevice
+                 << ", leaving the threads unpinned";
+    return;
+  }
+  if (!core::pinCurrentThread(locality.cpus)) {
+    LOG(WARNING) << "Simulator: can't pin to the CPUs of GPU " << gpuDevice;
+    return;
+  }
+  if (locality.numaNode >= 0 && !core::preferMemoryNode(locality.numaNode)) {
+    LOG(WARNING) << "Simulator: can't allocate from NUMA node "
+                 << locality.numaNode;
+  }
+
+  // one worker per local CPU instead of one per CPU of the machine
+  core::TaskSchedulerConfiguration scheduler;
+  scheduler.threadCount = locality.cpus.size();
+  scheduler.cpuAffinity = locality.cpus;
+  if (!core::TaskScheduler::setGlobalConfiguration(scheduler)) {
+    LOG(WARNING) << "Simulator: the task scheduler already runs, its workers "
+                    "stay where they are";
+  }
+  LOG(INFO) << "Simulator: pinned to the " << locality.cpus.size()
+            << " CPUs of NUMA node " << locality.numaNode << " next to GPU "
+            << gpuDevice;
+}
+}  // namespace
+
 void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
-  // if configuration is unchanged, just reset and return
-  if (cfg == config_) {
+  ESP_PROFILE_SCOPE("Simulator::reconfigure");
+  // if the scene is unchanged or resident, keep it and only take over the
+  // rest of the configuration
+  if (!sceneID_.empty() &&
+      (!requiresSceneReload(cfg, config_) || switchToResidentScene(cfg))) {
+    config_ = cfg;
+    resourceManager_.setSceneAssetCacheBudget(cfg.sceneAssetCacheBudget);
+    resourceManager_.setGpuMemoryBudget(cfg.gpuMemoryBudget);
+    resourceManager_.lazyObjectTemplates(cfg.lazyObjectTemplates);
+    resourceManager_.incrementalMeshUpload(cfg.meshUploadBudget > 0);
+    resourceManager_.releaseUploadData(cfg.releaseMeshUploadData);
+    setLevelOfDetailPixelError(cfg.meshLodPixelError);
+    configureRenderer();
+    evictResidentScenes();
+    if (physicsManager_) {
+      physicsManager_->setObjectPooling(cfg.objectPooling);
+    }
     reset();
     return;
   }
   // otherwise set current configuration and initialize
-  // TODO can optimize to do partial re-initialization instead of from-scratch
+  storeActiveScene();
+  const int previousSceneID = activeResidentScene() ? activeSceneID_ : -1;
   config_ = cfg;
+  resourceManager_.resetSceneLoadStatistics();
+  assets::SceneLoadStatistics& loadStatistics =
+      resourceManager_.sceneLoadStatistics();
 
   // load scene
-  std::string sceneFilename = cfg.scene.id;
-  if (cfg.scene.filepaths.count("mesh")) {
-    sceneFilename = cfg.scene.filepaths.at("mesh");
-  }
-
-  // create pathfinder and load navmesh if available
-  pathfinder_ = nav::PathFinder::create();
-  std::string navmeshFilename = io::changeExtension(sceneFilename, ".navmesh");
-  if (cfg.scene.filepaths.count("navmesh")) {
-    navmeshFilename = cfg.scene.filepaths.at("navmesh");
-  }
-  if (io::exists(navmeshFilename)) {
+  const std::string sceneFilename = sceneMeshFilename(cfg.scene);
+
+  // create pathfinder and load navmesh if available, unless it's the one
+  // already loaded or prefetched
+  const std::string navmeshFilename = sceneNavmeshFilename(cfg.scene);
+  if (pathfinder_ && pathfinder_->isLoaded() &&
+      navmeshFilename == loadedNavmeshFilename_) {
+    LOG(INFO) << "Reusing navmesh " << navmeshFilename;
+  } else if (prefetchedPathfinder_.valid() &&
+             navmeshFilename == prefetchedNavmeshFilename_) {
+    LOG(INFO) << "Using prefetched navmesh " << navmeshFilename;
+    pathfinder_ = prefetchedPathfinder_.get();
+    loadedNavmeshFilename_ = navmeshFilename;
+    prefetchedNavmeshFilename_.clear();
+  } else if (nav::PathFinder::ptr preloaded =
+                 PreloadedSceneData::instance().take(
+                     PreloadedSceneData::instance().pathfinders,
+                     navmeshFilename)) {
+    LOG(INFO) << "Using preloaded navmesh " << navmeshFilename;
+    pathfinder_ = std::move(preloaded);
+    loadedNavmeshFilename_ = navmeshFilename;
+  } else if (io::exists(navmeshFilename)) {
+    assets::ScopedLoadTimer timer{loadStatistics,
+                                  assets::SceneLoadStatistics::Stage::NavMesh};
+    pathfinder_ = nav::PathFinder::create();
+    loadedNavmeshFilename_ = navmeshFilename;
     LOG(INFO) << "Loading navmesh from " << navmeshFilename;
     pathfinder_->loadNavMesh(navmeshFilename);
     LOG(INFO) << "Loaded.";
   } else {
+    pathfinder_ = nav::PathFinder::create();
+    loadedNavmeshFilename_.clear();
     LOG(WARNING) << "Navmesh file not found, checked at " << navmeshFilename;
   }
 
-  std::string houseFilename = io::changeExtension(sceneFilename, ".house");
-  if (!io::exists(houseFilename)) {
-    houseFilename = io::changeExtension(sceneFilename, ".scn");
-  }
-  if (cfg.scene.filepaths.count("house")) {
-    houseFilename = cfg.scene.filepaths.at("house");
-  }
-
-  if (!io::exists(houseFilename)) {
-    houseFilename = io::changeExtension(sceneFilename, ".scn");
-  }
+  const std::string houseFilename = sceneHouseFilename(cfg.scene);
 
   assets::AssetInfo sceneInfo = assets::AssetInfo::fromPath(sceneFilename);
   sceneInfo.requiresLighting =
       cfg.sceneLightSetup != assets::ResourceManager::NO_LIGHT_KEY;
+  // TODO: remove hardcoded filename change and use SceneConfiguration
+  const std::string semanticMeshFilename =
+      io::removeExtension(houseFilename) + "_semantic.ply";
+  // PTex and instance meshes have no vertices to put the IDs on
+  if (cfg.createRenderer && cfg.semanticIdsOnRenderMesh &&
+      sceneInfo.type == assets::AssetType::MP3D_MESH &&
+      io::exists(houseFilename) && io::exists(semanticMeshFilename)) {
+    sceneInfo.semanticMeshFilepath = semanticMeshFilename;
+  }
 
   // initalize scene graph
   // CAREFUL!
@@ -95,21 +484,51 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
   // LOG(INFO) << "Active scene graph ID = " << activeSceneID_;
   sceneID_.push_back(activeSceneID_);
 
+  resourceManager_.cpuOnly(!cfg.createRenderer);
+  resourceManager_.setCollisionCacheDirectory(cfg.collisionCacheDirectory);
   if (cfg.createRenderer) {
+    // before any shader is compiled for the new context or renderer
+    gfx::CachedShaderProgram::setCacheDirectory(cfg.shaderCacheDirectory);
     if (!context_) {
-      context_ = gfx::WindowlessContext::create_unique(config_.gpuDeviceId);
+      if (config_.gpuLocalAffinity) {
+        pinNextToGpu(config_.gpuDeviceId);
+      }
+      if (config_.contextPool) {
+        context_ = gfx::ContextPool::instance().acquire(config_.gpuDeviceId);
+      } else if (config_.shareContext) {
+        context_ =
+            gfx::ContextPool::instance().createShared(config_.gpuDeviceId);
+      } else {
+        context_ = gfx::WindowlessContext::create(config_.gpuDeviceId);
+      }
     }
 
     // reinitalize members
     if (!renderer_) {
       renderer_ = gfx::Renderer::create();
     }
+    configureRenderer();
 
     auto& sceneGraph = sceneManager_.getSceneGraph(activeSceneID_);
 
     auto& rootNode = sceneGraph.getRootNode();
     auto& drawables = sceneGraph.getDrawables();
     resourceManager_.compressTextures(cfg.compressTextures);
+    resourceManager_.optimizeMeshes(cfg.optimizeMeshes);
+    resourceManager_.lazyObjectTemplates(cfg.lazyObjectTemplates);
+    resourceManager_.compactMeshLayout(cfg.compactMeshLayout);
+    resourceManager_.primitiveObjectIds(cfg.primitiveObjectIds);
+    resourceManager_.ptexVertexPulling(cfg.ptexVertexPulling);
+    resourceManager_.setMeshLodLevels(cfg.meshLodLevels);
+    resourceManager_.setMaxTextureSize(cfg.maxTextureSize);
+    resourceManager_.setTextureCacheDirectory(cfg.textureCacheDirectory);
+    resourceManager_.textureAtlases(cfg.textureAtlases);
+    resourceManager_.instancedObjectDrawing(cfg.instancedObjectDrawing);
+    resourceManager_.multiDrawStaticMeshes(cfg.multiDrawStaticMeshes);
+    resourceManager_.setSceneAssetCacheBudget(cfg.sceneAssetCacheBudget);
+    resourceManager_.setGpuMemoryBudget(cfg.gpuMemoryBudget);
+    resourceManager_.incrementalMeshUpload(cfg.meshUploadBudget > 0);
+    resourceManager_.releaseUploadData(cfg.releaseMeshUploadData);
 
     bool loadSuccess = false;
     if (config_.enablePhysics) {
@@ -130,11 +549,11 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
 
     if (io::exists(houseFilename)) {
       LOG(INFO) << "Loading house from " << houseFilename;
-      // if semantic mesh exists, load it as well
-      // TODO: remove hardcoded filename change and use SceneConfiguration
-      const std::string semanticMeshFilename =
-          io::removeExtension(houseFilename) + "_semantic.ply";
-      if (io::exists(semanticMeshFilename)) {
+      // if semantic mesh exists, load it as well, unless its IDs are on the
+      // scene mesh already
+      if (!sceneInfo.semanticMeshFilepath.empty()) {
+        activeSemanticSceneID_ = activeSceneID_;
+      } else if (io::exists(semanticMeshFilename)) {
         LOG(INFO) << "Loading semantic mesh " << semanticMeshFilename;
         activeSemanticSceneID_ = sceneManager_.initSceneGraph();
         sceneID_.push_back(activeSemanticSceneID_);
@@ -162,40 +581,334 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
                         "annotations. \n---";
       }
     }
+
+    // everything the new scene needs is loaded, make room for the next one
+    resourceManager_.trimSceneAssetCache();
+  } else if (cfg.enablePhysics) {
+    // physics and navigation only, the collision geometry is imported on the
+    // CPU and nothing needs a GL context
+    auto& rootNode = sceneManager_.getSceneGraph(activeSceneID_).getRootNode();
+    resourceManager_.setSceneAssetCacheBudget(cfg.sceneAssetCacheBudget);
+    if (!resourceManager_.loadScene(
+            sceneInfo, physicsManager_, &rootNode, nullptr,
+            assets::ResourceManager::NO_LIGHT_KEY, cfg.physicsConfigFile)) {
+      LOG(ERROR) << "cannot load " << sceneFilename;
+      throw std::invalid_argument("Cannot load: " + sceneFilename);
+    }
+    resourceManager_.trimSceneAssetCache();
+  } else if (cfg.cpuSceneGeometry) {
+    // the same without physics, for sensors tracing the collision geometry
+    resourceManager_.setSceneAssetCacheBudget(cfg.sceneAssetCacheBudget);
+    if (!resourceManager_.loadScene(sceneInfo, nullptr, nullptr,
+                                    assets::ResourceManager::NO_LIGHT_KEY)) {
+      LOG(ERROR) << "cannot load " << sceneFilename;
+      throw std::invalid_argument("Cannot load: " + sceneFilename);
+    }
+    resourceManager_.trimSceneAssetCache();
+  }
+  if (physicsManager_) {
+    physicsManager_->setObjectPooling(cfg.objectPooling);
   }
 
-  semanticScene_ = nullptr;
-  semanticScene_ = scene::SemanticScene::create();
-  switch (sceneInfo.type) {
-    case assets::AssetType::INSTANCE_MESH:
-      houseFilename = Cr::Utility::Directory::join(
-          Cr::Utility::Directory::path(houseFilename), "info_semantic.json");
-      if (io::exists(houseFilename)) {
-        scene::SemanticScene::loadReplicaHouse(houseFilename, *semanticScene_);
+  // the semantic annotations only depend on the files they come from, so
+  // keep them if those didn't change
+  const std::string semanticKey =
+      semanticSceneKey(sceneInfo.type, sceneFilename, houseFilename);
+  if (semanticScene_ == nullptr || semanticKey != loadedSemanticSceneKey_) {
+    loadedSemanticSceneKey_ = semanticKey;
+    assets::ScopedLoadTimer timer{
+        loadStatistics, assets::SceneLoadStatistics::Stage::SemanticScene};
+
+    semanticScene_ = PreloadedSceneData::instance().take(
+        PreloadedSceneData::instance().semanticScenes, semanticKey);
+    if (!semanticScene_) {
+      semanticScene_ =
+          loadSemanticScene(sceneInfo.type, sceneFilename, houseFilename);
+    }
+  }
+
+  loadStatistics.totalTime =
+      assets::SceneLoadStatistics::now() - loadStatistics.startTime;
+
+  if (cfg.maxResidentScenes > 1) {
+    ResidentScene resident;
+    resident.config = cfg;
+    resident.sceneID = activeSceneID_;
+    // without a renderer no semantic scene graph was set up
+    resident.semanticSceneID =
+        cfg.createRenderer ? activeSemanticSceneID_ : activeSceneID_;
+    for (int id : {resident.sceneID, resident.semanticSceneID}) {
+      auto& rootNode = sceneManager_.getSceneGraph(id).getRootNode();
+      for (auto* child = rootNode.children().first(); child != nullptr;
+           child = child->nextSibling()) {
+        resident.sceneNodes.push_back(static_cast<scene::SceneNode*>(child));
       }
-      break;
-    case assets::AssetType::MP3D_MESH:
-      // TODO(msb) Fix AssetType determination logic.
-      if (io::exists(houseFilename)) {
-        using Corrade::Utility::String::endsWith;
-        if (endsWith(houseFilename, ".house")) {
-          scene::SemanticScene::loadMp3dHouse(houseFilename, *semanticScene_);
-        } else if (endsWith(houseFilename, ".scn")) {
-          scene::SemanticScene::loadGibsonHouse(houseFilename, *semanticScene_);
-        }
+    }
+    for (const std::string& filename : {sceneFilename, semanticMeshFilename}) {
+      if (resourceManager_.isSceneAssetLoaded(filename)) {
+        resident.assetFilenames.push_back(filename);
       }
-      break;
-    case assets::AssetType::SUNCG_SCENE:
-      scene::SemanticScene::loadSuncgHouse(sceneFilename, *semanticScene_);
-      break;
-    default:
-      break;
+    }
+    residentScenes_.push_front(std::move(resident));
+    storeActiveScene();
+  }
+  // agents and other nodes added to the previous scene come along, if it
+  // stays resident and may be unloaded later
+  for (const ResidentScene& scene : residentScenes_) {
+    if (scene.sceneID == previousSceneID) {
+      moveRuntimeNodes(scene, activeSceneID_);
+    }
   }
 
+  setLevelOfDetailPixelError(cfg.meshLodPixelError);
+  evictResidentScenes();
   reset();
 }
 
+void Simulator::setLevelOfDetailPixelError(float pixels) {
+  for (int sceneID : sceneID_) {
+    sceneManager_.getSceneGraph(sceneID)
+        .getDefaultRenderCamera()
+        .setLevelOfDetailPixelError(pixels);
+  }
+}
+
+bool Simulator::prefetchScene(const SimulatorConfiguration& cfg) {
+  bool prefetching = false;
+
+  const std::string navmeshFilename = sceneNavmeshFilename(cfg.scene);
+  if (navmeshFilename == prefetchedNavmeshFilename_) {
+    prefetching = true;
+  } else if (navmeshFilename != loadedNavmeshFilename_ &&
+             io::exists(navmeshFilename)) {
+    LOG(INFO) << "Prefetching navmesh " << navmeshFilename;
+    prefetchedNavmeshFilename_ = navmeshFilename;
+    prefetchedPathfinder_ =
+        std::async(std::launch::async, [navmeshFilename]() {
+          nav::PathFinder::ptr pathfinder = nav::PathFinder::create();
+          pathfinder->loadNavMesh(navmeshFilename);
+          return pathfinder;
+        });
+    prefetching = true;
+  }
+
+  // the Basis transcoding target depends on the GL context
+  if (cfg.createRenderer && context_) {
+    const std::string sceneFilename = sceneMeshFilename(cfg.scene);
+    if (resourceManager_.prefetchScene(
+            assets::AssetInfo::fromPath(sceneFilename)) ||
+        resourceManager_.isScenePrefetched(sceneFilename)) {
+      prefetching = true;
+    }
+  }
+  return prefetching;
+}
+
+bool Simulator::preload(const SimulatorConfiguration& cfg) {
+  PreloadedSceneData& data = PreloadedSceneData::instance();
+  bool preloaded = false;
+
+  const std::string navmeshFilename = sceneNavmeshFilename(cfg.scene);
+  bool navmeshPreloaded;
+  {
+    std::lock_guard<std::mutex> lock{data.mutex};
+    navmeshPreloaded = data.pathfinders.count(navmeshFilename) > 0;
+  }
+  if (navmeshPreloaded) {
+    preloaded = true;
+  } else if (io::exists(navmeshFilename)) {
+    LOG(INFO) << "Preloading navmesh " << navmeshFilename;
+    nav::PathFinder::ptr pathfinder = nav::PathFinder::create();
+    if (pathfinder->loadNavMesh(navmeshFilename)) {
+      std::lock_guard<std::mutex> lock{data.mutex};
+      data.pathfinders.emplace(navmeshFilename, std::move(pathfinder));
+      preloaded = true;
+    }
+  }
+
+  const std::string sceneFilename = sceneMeshFilename(cfg.scene);
+  const assets::AssetInfo sceneInfo =
+      assets::AssetInfo::fromPath(sceneFilename);
+  const std::string houseFilename = sceneHouseFilename(cfg.scene);
+  const std::string semanticKey =
+      semanticSceneKey(sceneInfo.type, sceneFilename, houseFilename);
+  bool semanticScenePreloaded;
+  {
+    std::lock_guard<std::mutex> lock{data.mutex};
+    semanticScenePreloaded = data.semanticScenes.count(semanticKey) > 0;
+  }
+  if (!semanticScenePreloaded) {
+    scene::SemanticScene::ptr semanticScene =
+        loadSemanticScene(sceneInfo.type, sceneFilename, houseFilename);
+    std::lock_guard<std::mutex> lock{data.mutex};
+    data.semanticScenes.emplace(semanticKey, std::move(semanticScene));
+  }
+
+  if (cfg.createRenderer &&
+      (sceneInfo.type == assets::AssetType::MP3D_MESH ||
+       sceneInfo.type == assets::AssetType::UNKNOWN) &&
+      assets::ResourceManager::preloadScene(sceneInfo)) {
+    preloaded = true;
+  }
+  return preloaded;
+}
+
+void Simulator::clearPreloaded() {
+  PreloadedSceneData& data = PreloadedSceneData::instance();
+  {
+    std::lock_guard<std::mutex> lock{data.mutex};
+    data.pathfinders.clear();
+    data.semanticScenes.clear();
+  }
+  assets::ResourceManager::clearPreloadedScenes();
+}
+
+size_t Simulator::preloadedCount() {
+  PreloadedSceneData& data = PreloadedSceneData::instance();
+  size_t count;
+  {
+    std::lock_guard<std::mutex> lock{data.mutex};
+    count = data.pathfinders.size() + data.semanticScenes.size();
+  }
+  return count + assets::ResourceManager::preloadedSceneCount();
+}
+
+std::vector<std::string> Simulator::getResidentScenes() const {
+  std::vector<std::string> sceneIds;
+  for (const ResidentScene& scene : residentScenes_) {
+    sceneIds.push_back(scene.config.scene.id);
+  }
+  return sceneIds;
+}
+
+bool Simulator::setActiveScene(const std::string& sceneId) {
+  evictResidentScenes();
+  for (auto it = residentScenes_.begin(); it != residentScenes_.end(); ++it) {
+    if (it->config.scene.id == sceneId) {
+      activateResidentScene(it);
+      config_ = it->config;
+      configureRenderer();
+      clearReplayObservationCache();
+      const Magnum::Range3D& sceneBB =
+          getActiveSceneGraph().getRootNode().computeCumulativeBB();
+      resourceManager_.setLightSetup(gfx::getLightsAtBoxCorners(sceneBB));
+      return true;
+    }
+  }
+  return false;
+}
+
+Simulator::ResidentScene* Simulator::activeResidentScene() {
+  if (residentScenes_.empty() ||
+      residentScenes_.front().sceneID != activeSceneID_) {
+    return nullptr;
+  }
+  return &residentScenes_.front();
+}
+
+void Simulator::storeActiveScene() {
+  ResidentScene* scene = activeResidentScene();
+  if (scene == nullptr) {
+    return;
+  }
+  scene->pathfinder = pathfinder_;
+  scene->navmeshFilename = loadedNavmeshFilename_;
+  scene->semanticScene = semanticScene_;
+  scene->semanticSceneKey = loadedSemanticSceneKey_;
+  scene->potentiallyVisibleSet = potentiallyVisibleSet_;
+  scene->pvsFilename = loadedPvsFilename_;
+  scene->physicsManager = physicsManager_;
+}
+
+void Simulator::moveRuntimeNodes(const ResidentScene& scene, int sceneID) {
+  auto& targetRootNode = sceneManager_.getSceneGraph(sceneID).getRootNode();
+  for (int id : {scene.sceneID, scene.semanticSceneID}) {
+    if (id == sceneID) {
+      continue;
+    }
+    auto& rootNode = sceneManager_.getSceneGraph(id).getRootNode();
+    for (auto* child = rootNode.children().first(); child != nullptr;) {
+      auto* next = child->nextSibling();
+      if (std::find(scene.sceneNodes.begin(), scene.sceneNodes.end(),
+                    child) == scene.sceneNodes.end()) {
+        child->setParent(&targetRootNode);
+      }
+      child = next;
+    }
+  }
+  // reparenting isn't observed by the structure generation
+  scene::SceneNode::invalidateStructure();
+}
+
+bool Simulator::switchToResidentScene(const SimulatorConfiguration& cfg) {
+  if (cfg.maxResidentScenes <= 1) {
+    return false;
+  }
+  evictResidentScenes();
+  for (auto it = residentScenes_.begin(); it != residentScenes_.end(); ++it) {
+    if (!requiresSceneReload(cfg, it->config)) {
+      LOG(INFO) << "Switching to resident scene " << cfg.scene.id;
+      activateResidentScene(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void Simulator::activateResidentScene(
+    std::list<ResidentScene>::iterator scene) {
+  storeActiveScene();
+  if (const ResidentScene* active = activeResidentScene()) {
+    moveRuntimeNodes(*active, scene->sceneID);
+  }
+  residentScenes_.splice(residentScenes_.begin(), residentScenes_, scene);
+  activeSceneID_ = scene->sceneID;
+  activeSemanticSceneID_ = scene->semanticSceneID;
+  pathfinder_ = scene->pathfinder;
+  loadedNavmeshFilename_ = scene->navmeshFilename;
+  semanticScene_ = scene->semanticScene;
+  loadedSemanticSceneKey_ = scene->semanticSceneKey;
+  potentiallyVisibleSet_ = scene->potentiallyVisibleSet;
+  loadedPvsFilename_ = scene->pvsFilename;
+  physicsManager_ = scene->physicsManager;
+  for (const std::string& filename : scene->assetFilenames) {
+    resourceManager_.touchSceneAsset(filename);
+  }
+}
+
+void Simulator::evictResidentScenes() {
+  // the active scene stays, its assets are in use
+  const size_t maxScenes = std::max(config_.maxResidentScenes, 1);
+  size_t index = 0;
+  for (auto it = residentScenes_.begin(); it != residentScenes_.end();) {
+    const bool active = it->sceneID == activeSceneID_;
+    bool evicted = false;
+    for (const std::string& filename : it->assetFilenames) {
+      evicted = evicted || !resourceManager_.isSceneAssetLoaded(filename);
+    }
+    if (active || (index < maxScenes && !evicted)) {
+      ++it;
+      ++index;
+      continue;
+    }
+    LOG(INFO) << "Unloading resident scene " << it->config.scene.id;
+    // the physics objects are features of the scene graph nodes, so they
+    // go first
+    it->physicsManager = nullptr;
+    for (int id : {it->sceneID, it->semanticSceneID}) {
+      auto found = std::find(sceneID_.begin(), sceneID_.end(), id);
+      if (found != sceneID_.end()) {
+        sceneManager_.deleteSceneGraph(id);
+        sceneID_.erase(found);
+      }
+    }
+    it = residentScenes_.erase(it);
+  }
+}
+
 void Simulator::reset() {
+  observationCache_.clear();
+  clearReplayObservationCache();
   if (physicsManager_ != nullptr) {
     // Note: only resets time to 0 by default.
     physicsManager_->reset();
@@ -203,6 +916,10 @@ void Simulator::reset() {
 
   for (auto& agent : agents_) {
     agent->reset();
+    // a new episode starts with fresh observations from every sensor
+    for (auto& sensor : agent->getSensorSuite().getSensors()) {
+      sensor.second->requestUpdate();
+    }
   }
   const Magnum::Range3D& sceneBB =
       getActiveSceneGraph().getRootNode().computeCumulativeBB();
@@ -210,6 +927,7 @@ void Simulator::reset() {
 }
 
 void Simulator::seed(uint32_t newSeed) {
+  seed_ = newSeed;
   random_.seed(newSeed);
   pathfinder_->seed(newSeed);
 }
@@ -228,24 +946,69 @@ std::shared_ptr<scene::SemanticScene> Simulator::getSemanticScene() {
 
 scene::SceneGraph& Simulator::getActiveSceneGraph() {
   CHECK_GE(activeSceneID_, 0);
-  CHECK_LT(activeSceneID_, sceneID_.size());
   return sceneManager_.getSceneGraph(activeSceneID_);
 }
 
 //! return the semantic scene's SceneGraph for rendering
 scene::SceneGraph& Simulator::getActiveSemanticSceneGraph() {
   CHECK_GE(activeSemanticSceneID_, 0);
-  CHECK_LT(activeSemanticSceneID_, sceneID_.size());
   return sceneManager_.getSceneGraph(activeSemanticSceneID_);
 }
 
+bool Simulator::saveFrame(const std::string& filename) {
+  sensor::Observation observation;
+  if (!getAgentObservation(config_.defaultAgentId, config_.defaultCameraUuid,
+                           observation) ||
+      observation.buffer == nullptr) {
+    return false;
+  }
+  return getImageWriter()->write(filename, *observation.buffer);
+}
+
+std::shared_ptr<gfx::ImageWriter> Simulator::getImageWriter() {
+  if (imageWriter_ == nullptr) {
+    imageWriter_ = gfx::ImageWriter::create();
+  }
+  return imageWriter_;
+}
+
 bool operator==(const SimulatorConfiguration& a,
                 const SimulatorConfiguration& b) {
   return a.scene == b.scene && a.defaultAgentId == b.defaultAgentId &&
          a.defaultCameraUuid == b.defaultCameraUuid &&
          a.compressTextures == b.compressTextures &&
+         a.optimizeMeshes == b.optimizeMeshes &&
+         a.lazyObjectTemplates == b.lazyObjectTemplates &&
+         a.compactMeshLayout == b.compactMeshLayout &&
+         a.primitiveObjectIds == b.primitiveObjectIds &&
+         a.ptexVertexPulling == b.ptexVertexPulling &&
+         a.meshLodLevels == b.meshLodLevels &&
+         a.meshLodPixelError == b.meshLodPixelError &&
+         a.maxTextureSize == b.maxTextureSize &&
+         a.textureSizeFromSensors == b.textureSizeFromSensors &&
+         a.textureCacheDirectory == b.textureCacheDirectory &&
+         a.collisionCacheDirectory == b.collisionCacheDirectory &&
+         a.textureAtlases == b.textureAtlases &&
+         a.shaderCacheDirectory == b.shaderCacheDirectory &&
+         a.contextPool == b.contextPool &&
+         a.shareContext == b.shareContext &&
+         a.instancedObjectDrawing == b.instancedObjectDrawing &&
+         a.multiDrawStaticMeshes == b.multiDrawStaticMeshes &&
+         a.semanticIdsOnRenderMesh == b.semanticIdsOnRenderMesh &&
+         a.shareRenderTargets == b.shareRenderTargets &&
+         a.multiViewRendering == b.multiViewRendering &&
+         a.parallelCulling == b.parallelCulling &&
+         a.occlusionCulling == b.occlusionCulling &&
+         a.potentiallyVisibleSets == b.potentiallyVisibleSets &&
+         a.sceneAssetCacheBudget == b.sceneAssetCacheBudget &&
+         a.gpuMemoryBudget == b.gpuMemoryBudget &&
+         a.meshUploadBudget == b.meshUploadBudget &&
+         a.releaseMeshUploadData == b.releaseMeshUploadData &&
+         a.maxResidentScenes == b.maxResidentScenes &&
          a.createRenderer == b.createRenderer &&
+         a.cpuSceneGeometry == b.cpuSceneGeometry &&
          a.enablePhysics == b.enablePhysics &&
+         a.objectPooling == b.objectPooling &&
          a.physicsConfigFile.compare(b.physicsConfigFile) == 0;
 }
 
@@ -254,6 +1017,32 @@ bool operator!=(const SimulatorConfiguration& a,
   return !(a == b);
 }
 
+int maxTextureSizeForSensors(
+    const std::vector<sensor::SensorSpec::ptr>& sensorSpecs) {
+  float texels = 0.0f;
+  for (const sensor::SensorSpec::ptr& spec : sensorSpecs) {
+    // only color sensors sample textures
+    if (!spec || spec->sensorType != sensor::SensorType::COLOR) {
+      continue;
+    }
+    float hfov = 90.0f;
+    auto found = spec->parameters.find("hfov");
+    if (found != spec->parameters.end()) {
+      hfov = std::stof(found->second);
+    }
+    const float resolution = spec->resolution.maxCoeff();
+    texels = std::max(texels, resolution * 90.0f / std::max(hfov, 1.0f));
+  }
+  if (texels == 0.0f) {
+    return 0;
+  }
+  int size = 1;
+  while (size < texels) {
+    size *= 2;
+  }
+  return size;
+}
+
 // === Physics Simulator Functions ===
 
 int Simulator::addObject(int objectLibIndex,
@@ -283,14 +1072,8 @@ assets::PhysicsObjectAttributes::ptr Simulator::getObjectTemplate(
 }
 
 std::vector<int> Simulator::loadObjectConfigs(const std::string& path) {
-  std::vector<int> templateIndices;
-  std::vector<std::string> validConfigPaths =
-      resourceManager_.getObjectConfigPaths(path);
-  for (auto& validPath : validConfigPaths) {
-    templateIndices.push_back(
-        resourceManager_.parseAndLoadPhysObjTemplate(validPath));
-  }
-  return templateIndices;
+  return resourceManager_.parseAndLoadPhysObjTemplates(
+      resourceManager_.getObjectConfigPaths(path));
 }
 
 int Simulator::loadObjectTemplate(
@@ -304,6 +1087,10 @@ int Simulator::loadObjectTemplate(
   return resourceManager_.loadObjectTemplate(objTmplPtr, objectTemplateHandle);
 }
 
+bool Simulator::prefetchObjectTemplate(int templateId) {
+  return resourceManager_.prefetchObjectTemplate(templateId);
+}
+
 // return a list of existing objected IDs in a physical scene
 std::vector<int> Simulator::getExistingObjectIDs(const int sceneID) {
   if (sceneHasPhysics(sceneID)) {
@@ -339,6 +1126,22 @@ bool Simulator::setObjectMotionType(const esp::physics::MotionType& motionType,
   return false;
 }
 
+void Simulator::setObjectKinematicCollisions(bool enabled,
+                                             const int objectID,
+                                             const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setObjectKinematicCollisions(objectID, enabled);
+  }
+}
+
+bool Simulator::getObjectKinematicCollisions(const int objectID,
+                                             const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->getObjectKinematicCollisions(objectID);
+  }
+  return false;
+}
+
 physics::VelocityControl::ptr Simulator::getObjectVelocityControl(
     const int objectID,
     const int sceneID) const {
@@ -451,31 +1254,276 @@ Magnum::Vector3 Simulator::getAngularVelocity(const int objectID,
   return Magnum::Vector3();
 }
 
-bool Simulator::contactTest(const int objectID, const int sceneID) {
+void Simulator::getTranslations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> translations,
+    const int sceneID) {
   if (sceneHasPhysics(sceneID)) {
-    return physicsManager_->contactTest(objectID);
+    physicsManager_->getTranslations(objectIDs, translations);
+  } else {
+    std::fill(translations.begin(), translations.end(), Magnum::Vector3{});
   }
-  return false;
 }
 
-double Simulator::stepWorld(const double dt) {
-  if (physicsManager_ != nullptr) {
-    physicsManager_->stepPhysics(dt);
+void Simulator::getRotations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Quaternion> rotations,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->getRotations(objectIDs, rotations);
+  } else {
+    std::fill(rotations.begin(), rotations.end(), Magnum::Quaternion{});
   }
-  return getWorldTime();
 }
 
-// get the simulated world time (0 if no physics enabled)
-double Simulator::getWorldTime() {
-  if (physicsManager_ != nullptr) {
-    return physicsManager_->getWorldTime();
+void Simulator::getLinearVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> linVels,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->getLinearVelocities(objectIDs, linVels);
+  } else {
+    std::fill(linVels.begin(), linVels.end(), Magnum::Vector3{});
   }
-  return NO_TIME;
 }
 
-void Simulator::setGravity(const Magnum::Vector3& gravity, const int sceneID) {
+void Simulator::getAngularVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<Magnum::Vector3> angVels,
+    const int sceneID) {
   if (sceneHasPhysics(sceneID)) {
-    physicsManager_->setGravity(gravity);
+    physicsManager_->getAngularVelocities(objectIDs, angVels);
+  } else {
+    std::fill(angVels.begin(), angVels.end(), Magnum::Vector3{});
+  }
+}
+
+void Simulator::setTranslations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> translations,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setTranslations(objectIDs, translations);
+  }
+}
+
+void Simulator::setRotations(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Quaternion> rotations,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setRotations(objectIDs, rotations);
+  }
+}
+
+void Simulator::setLinearVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> linVels,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setLinearVelocities(objectIDs, linVels);
+  }
+}
+
+void Simulator::setAngularVelocities(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> angVels,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setAngularVelocities(objectIDs, angVels);
+  }
+}
+
+bool Simulator::contactTest(const int objectID, const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->contactTest(objectID);
+  }
+  return false;
+}
+
+void Simulator::contactTests(
+    Corrade::Containers::ArrayView<const int> objectIDs,
+    Corrade::Containers::ArrayView<bool> results,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->contactTests(objectIDs, results);
+  } else {
+    std::fill(results.begin(), results.end(), false);
+  }
+}
+
+void Simulator::castRays(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    float maxDistance,
+    Corrade::Containers::ArrayView<physics::RayHit> hits,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->castRays(origins, directions, maxDistance, hits);
+  } else {
+    std::fill(hits.begin(), hits.end(), physics::RayHit{});
+  }
+}
+
+double Simulator::stepWorld(const double dt) {
+  ESP_PROFILE_SCOPE("Simulator::stepWorld");
+  if (physicsManager_ != nullptr) {
+    physicsManager_->stepPhysics(dt);
+  }
+  return getWorldTime();
+}
+
+double Simulator::stepWorldSubSteps(int numSubSteps) {
+  ESP_PROFILE_SCOPE("Simulator::stepWorldSubSteps");
+  if (physicsManager_ != nullptr) {
+    physicsManager_->stepPhysicsSubSteps(numSubSteps);
+  }
+  return getWorldTime();
+}
+
+void Simulator::setPhysicsTimestep(double dt, const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setTimestep(dt);
+  }
+}
+
+double Simulator::getPhysicsTimestep(const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->getTimestep();
+  }
+  return 0.0;
+}
+
+void Simulator::setPhysicsMaxSubSteps(int maxSubSteps, const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setMaxSubSteps(maxSubSteps);
+  }
+}
+
+int Simulator::getPhysicsMaxSubSteps(const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->getMaxSubSteps();
+  }
+  return 0;
+}
+
+void Simulator::stepWorlds(const std::vector<Simulator*>& simulators,
+                           const double dt) {
+  ESP_PROFILE_SCOPE("Simulator::stepWorlds");
+  std::vector<physics::PhysicsManager*> worlds;
+  worlds.reserve(simulators.size());
+  for (Simulator* simulator : simulators) {
+    if (simulator && simulator->physicsManager_) {
+      worlds.push_back(simulator->physicsManager_.get());
+    }
+  }
+  physics::PhysicsManager::stepWorlds(worlds, dt);
+}
+
+physics::PhysicsState Simulator::savePhysicsState(const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->saveState();
+  }
+  return physics::PhysicsState();
+}
+
+physics::StepStatistics Simulator::getPhysicsStepStatistics(
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->getStepStatistics();
+  }
+  return physics::StepStatistics();
+}
+
+int Simulator::getNumPooledObjects(const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->getNumPooledObjects();
+  }
+  return 0;
+}
+
+bool Simulator::restorePhysicsState(const physics::PhysicsState& state,
+                                    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->restoreState(state);
+  }
+  return false;
+}
+
+SimulatorCheckpoint Simulator::checkpoint() {
+  ESP_PROFILE_SCOPE("Simulator::checkpoint");
+  SimulatorCheckpoint checkpoint;
+  checkpoint.sceneId = config_.scene.id;
+  checkpoint.agents.reserve(agents_.size());
+  for (size_t i = 0; i < agents_.size(); ++i) {
+    const agent::Agent& agent = *agents_[i];
+    Trajectory::AgentPose pose{
+        int(i), {agent.node().translation(), agent.node().rotation()}, {}};
+    for (const auto& s : agent.getSensorSuite().getSensors()) {
+      const scene::SceneNode& node = s.second->node();
+      pose.sensors.push_back({node.translation(), node.rotation()});
+    }
+    checkpoint.agents.push_back(std::move(pose));
+  }
+  if (physicsManager_ != nullptr) {
+    checkpoint.hasPhysics = true;
+    checkpoint.physics = physicsManager_->saveState();
+  }
+  checkpoint.random = random_;
+  checkpoint.pathfinderRandom = pathfinder_->randomState();
+  return checkpoint;
+}
+
+bool Simulator::restore(const SimulatorCheckpoint& checkpoint) {
+  ESP_PROFILE_SCOPE("Simulator::restore");
+  bool matches = checkpoint.sceneId == config_.scene.id &&
+                 checkpoint.agents.size() == agents_.size() &&
+                 checkpoint.hasPhysics == (physicsManager_ != nullptr);
+  for (size_t i = 0; matches && i < agents_.size(); ++i) {
+    matches = checkpoint.agents[i].sensors.size() ==
+              agents_[i]->getSensorSuite().getSensors().size();
+  }
+  if (!matches) {
+    LOG(ERROR) << "Simulator::restore(): the checkpoint is of another scene "
+                  "or other agents";
+    return false;
+  }
+
+  if (physicsManager_ != nullptr &&
+      !physicsManager_->restoreState(
+          checkpoint.physics,
+          &sceneManager_.getSceneGraph(activeSceneID_).getDrawables())) {
+    LOG(ERROR) << "Simulator::restore(): cannot restore the objects";
+    return false;
+  }
+  for (const Trajectory::AgentPose& pose : checkpoint.agents) {
+    agent::Agent& agent = *agents_[pose.agentId];
+    agent.setPose(pose.body.translation, pose.body.rotation,
+                  /*resetSensors=*/false);
+    size_t i = 0;
+    for (const auto& s : agent.getSensorSuite().getSensors()) {
+      scene::SceneNode& node = s.second->node();
+      node.setTranslation(pose.sensors[i].translation);
+      node.setRotation(pose.sensors[i].rotation);
+      ++i;
+    }
+  }
+  random_ = checkpoint.random;
+  pathfinder_->setRandomState(checkpoint.pathfinderRandom);
+  return true;
+}
+
+// get the simulated world time (0 if no physics enabled)
+double Simulator::getWorldTime() {
+  if (physicsManager_ != nullptr) {
+    return physicsManager_->getWorldTime();
+  }
+  return NO_TIME;
+}
+
+void Simulator::setGravity(const Magnum::Vector3& gravity, const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setGravity(gravity);
   }
 }
 
@@ -486,58 +1534,256 @@ Magnum::Vector3 Simulator::getGravity(const int sceneID) const {
   return Magnum::Vector3();
 }
 
+std::vector<ObjectViewpoints> Simulator::computeObjectViewpoints(
+    const ViewpointSettings& settings) {
+  CORRADE_ASSERT(settings.spacing > 0.0f,
+                 "Simulator::computeObjectViewpoints(): expected a positive "
+                 "spacing",
+                 {});
+  if (semanticScene_ == nullptr || !pathfinder_->isLoaded()) {
+    LOG(WARNING) << "Simulator::computeObjectViewpoints(): needs a semantic "
+                    "scene and a navmesh";
+    return {};
+  }
+  if (!sceneHasPhysics(activeSceneID_)) {
+    LOG(WARNING) << "Simulator::computeObjectViewpoints(): physics is not "
+                    "enabled, nothing occludes the objects";
+  }
+  const auto& objects = semanticScene_->objects();
+
+  // candidates on a grid over each OBB footprint grown by maxDistance,
+  // starting at the bottom of the object
+  std::vector<vec3f> candidates;
+  std::vector<int> candidateObjects;
+  for (int i = 0; i < int(objects.size()); ++i) {
+    if (objects[i] == nullptr)
+      continue;
+    const geo::OBB obb = objects[i]->obb();
+    const box3f aabb = obb.toAABB();
+    const float bottom = aabb.min()[1];
+    const float minX = aabb.min()[0] - settings.maxDistance;
+    const float minZ = aabb.min()[2] - settings.maxDistance;
+    const int columns =
+        int((aabb.sizes()[0] + 2 * settings.maxDistance) / settings.spacing) +
+        1;
+    const int rows =
+        int((aabb.sizes()[2] + 2 * settings.maxDistance) / settings.spacing) +
+        1;
+    for (int h = 0; h < rows; ++h) {
+      for (int w = 0; w < columns; ++w) {
+        const vec3f point{minX + w * settings.spacing, obb.center()[1],
+                          minZ + h * settings.spacing};
+        // the horizontal distance, at the height of the center
+        if (obb.distance(point) > settings.maxDistance)
+          continue;
+        candidates.emplace_back(point[0], bottom, point[2]);
+        candidateObjects.push_back(i);
+      }
+    }
+  }
+
+  // both batched queries run in parallel, navigable candidates are moved
+  // down or up onto the navmesh
+  Corrade::Containers::Array<bool> navigable{Corrade::Containers::ValueInit,
+                                             candidates.size()};
+  pathfinder_->areNavigable(candidates, navigable, settings.maxYDelta);
+  std::vector<vec3f> viewpoints;
+  std::vector<int> viewpointObjects;
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    if (navigable[i]) {
+      viewpoints.push_back(candidates[i]);
+      viewpointObjects.push_back(candidateObjects[i]);
+    }
+  }
+  pathfinder_->snapPoints(viewpoints, viewpoints);
+
+  // rays from the eye to the center and the half-way corners of the OBB
+  constexpr int RaysPerViewpoint = 9;
+  std::vector<Magnum::Vector3> origins;
+  std::vector<Magnum::Vector3> directions;
+  std::vector<float> lengths;
+  origins.reserve(viewpoints.size() * RaysPerViewpoint);
+  directions.reserve(viewpoints.size() * RaysPerViewpoint);
+  lengths.reserve(viewpoints.size() * RaysPerViewpoint);
+  float maxLength = 0.0f;
+  for (std::size_t i = 0; i < viewpoints.size(); ++i) {
+    const geo::OBB obb = objects[viewpointObjects[i]]->obb();
+    const vec3f eye = viewpoints[i] + vec3f{0.0f, settings.sensorHeight, 0.0f};
+    for (int r = 0; r < RaysPerViewpoint; ++r) {
+      vec3f target = obb.center();
+      if (r > 0) {
+        const vec3f corner{r & 1 ? 0.5f : -0.5f, r & 2 ? 0.5f : -0.5f,
+                           r & 4 ? 0.5f : -0.5f};
+        target = obb.localToWorld() * corner;
+      }
+      const vec3f direction = target - eye;
+      origins.emplace_back(eye);
+      directions.emplace_back(direction);
+      lengths.push_back(direction.norm());
+      maxLength = std::max(maxLength, lengths.back());
+    }
+  }
+  std::vector<physics::RayHit> hits(origins.size());
+  castRays(origins, directions, maxLength, hits, activeSceneID_);
+
+  std::vector<ObjectViewpoints> result;
+  for (std::size_t i = 0; i < viewpoints.size(); ++i) {
+    const geo::OBB obb = objects[viewpointObjects[i]]->obb();
+    int reached = 0;
+    for (int r = 0; r < RaysPerViewpoint; ++r) {
+      const std::size_t ray = i * RaysPerViewpoint + r;
+      reached += hits[ray].distance >= lengths[ray] ||
+                 obb.contains(Magnum::EigenIntegration::cast<vec3f>(
+                                  hits[ray].point),
+                              0.05f);
+    }
+    const float fraction = float(reached) / RaysPerViewpoint;
+    if (fraction < settings.minVisibleFraction)
+      continue;
+    if (result.empty() ||
+        result.back().objectIndex != viewpointObjects[i]) {
+      result.emplace_back();
+      result.back().objectIndex = viewpointObjects[i];
+    }
+    result.back().viewpoints.push_back(viewpoints[i]);
+    result.back().visibleFractions.push_back(fraction);
+  }
+  return result;
+}
+
+const geo::OccupancyGrid& Simulator::getOccupancyGrid(float voxelSize) {
+  static const geo::OccupancyGrid empty;
+  CORRADE_ASSERT(config_.createRenderer || config_.enablePhysics ||
+                     config_.cpuSceneGeometry,
+                 "Simulator::getOccupancyGrid(): no scene geometry is loaded "
+                 "without a renderer, physics or CPU scene geometry",
+                 empty);
+  return resourceManager_.getOccupancyGrid(config_.scene.id, voxelSize);
+}
+
+const geo::MeshRayCaster& Simulator::getMeshRayCaster() {
+  static const geo::MeshRayCaster empty;
+  CORRADE_ASSERT(config_.createRenderer || config_.enablePhysics ||
+                     config_.cpuSceneGeometry,
+                 "Simulator::getMeshRayCaster(): no scene geometry is loaded "
+                 "without a renderer, physics or CPU scene geometry",
+                 empty);
+  return resourceManager_.getMeshRayCaster(config_.scene.id);
+}
+
 bool Simulator::recomputeNavMesh(nav::PathFinder& pathfinder,
                                  const nav::NavMeshSettings& navMeshSettings,
                                  bool includeStaticObjects) {
+  if (&pathfinder == pathfinder_.get()) {
+    // no longer what's in the navmesh file
+    loadedNavmeshFilename_.clear();
+  }
   CORRADE_ASSERT(
-      config_.createRenderer,
-      "Simulator::recomputeNavMesh: SimulatorConfiguration::createRenderer is "
-      "false. Scene geometry is required to recompute navmesh. No geometry is "
-      "loaded without renderer initialization.",
+      config_.createRenderer || config_.enablePhysics ||
+          config_.cpuSceneGeometry,
+      "Simulator::recomputeNavMesh: SimulatorConfiguration::createRenderer, "
+      "enablePhysics and cpuSceneGeometry are false. Scene geometry is "
+      "required to recompute navmesh. No geometry is loaded without a "
+      "renderer, physics or CPU scene geometry.",
       false);
 
-  assets::MeshData::uptr joinedMesh =
-      resourceManager_.createJoinedCollisionMesh(config_.scene.id);
-
-  // add STATIC collision objects
+  // the joined scene mesh is cached by the resource manager, only the
+  // objects are transformed on every call
+  const assets::MeshData& sceneMesh =
+      resourceManager_.getJoinedCollisionMesh(config_.scene.id);
+  constexpr float inf = std::numeric_limits<float>::infinity();
+
+  // collect STATIC collision objects
+  std::vector<NavMeshObject> navMeshObjects;
+  std::vector<const assets::MeshData*> objectMeshes;
+  std::vector<Magnum::Matrix4> objectTransformations;
+  size_t vertexCount = sceneMesh.vbo.size();
+  size_t indexCount = sceneMesh.ibo.size();
   if (includeStaticObjects) {
     for (auto objectID : physicsManager_->getExistingObjectIDs()) {
       if (physicsManager_->getObjectMotionType(objectID) ==
           physics::MotionType::STATIC) {
-        auto objectTransform = Magnum::EigenIntegration::cast<
-            Eigen::Transform<float, 3, Eigen::Affine> >(
+        const Magnum::Matrix4 absoluteTransformation =
             physicsManager_->getObjectVisualSceneNode(objectID)
-                .absoluteTransformationMatrix());
+                .absoluteTransformationMatrix();
         const assets::PhysicsObjectAttributes::ptr initializationTemplate =
             physicsManager_->getInitializationAttributes(objectID);
-        objectTransform.scale(Magnum::EigenIntegration::cast<vec3f>(
-            initializationTemplate->getScale()));
         std::string meshHandle =
             initializationTemplate->getCollisionMeshHandle();
         if (meshHandle.empty()) {
           meshHandle = initializationTemplate->getRenderMeshHandle();
         }
-        assets::MeshData::uptr joinedObjectMesh =
-            resourceManager_.createJoinedCollisionMesh(meshHandle);
-        int prevNumIndices = joinedMesh->ibo.size();
-        int prevNumVerts = joinedMesh->vbo.size();
-        joinedMesh->ibo.resize(prevNumIndices + joinedObjectMesh->ibo.size());
-        for (size_t ix = 0; ix < joinedObjectMesh->ibo.size(); ++ix) {
-          joinedMesh->ibo[ix + prevNumIndices] =
-              joinedObjectMesh->ibo[ix] + prevNumVerts;
-        }
-        joinedMesh->vbo.reserve(joinedObjectMesh->vbo.size() + prevNumVerts);
-        for (auto& vert : joinedObjectMesh->vbo) {
-          joinedMesh->vbo.push_back(objectTransform * vert);
-        }
+        navMeshObjects.push_back(
+            {objectID,
+             meshHandle,
+             absoluteTransformation,
+             initializationTemplate->getScale(),
+             {vec3f::Constant(inf), vec3f::Constant(-inf)}});
+        objectMeshes.push_back(
+            &resourceManager_.getJoinedCollisionMesh(meshHandle));
+        objectTransformations.push_back(
+            absoluteTransformation *
+            Magnum::Matrix4::scaling(initializationTemplate->getScale()));
+        vertexCount += objectMeshes.back()->vbo.size();
+        indexCount += objectMeshes.back()->ibo.size();
       }
     }
   }
 
-  if (!pathfinder.build(navMeshSettings, *joinedMesh)) {
+  // join the scene and the objects, allocating everything once
+  assets::MeshData::uptr joinedMesh = assets::MeshData::create_unique();
+  joinedMesh->vbo.reserve(vertexCount);
+  joinedMesh->ibo.reserve(indexCount);
+  joinedMesh->vbo.insert(joinedMesh->vbo.end(), sceneMesh.vbo.begin(),
+                         sceneMesh.vbo.end());
+  joinedMesh->ibo.insert(joinedMesh->ibo.end(), sceneMesh.ibo.begin(),
+                         sceneMesh.ibo.end());
+  for (size_t iObject = 0; iObject < objectMeshes.size(); ++iObject) {
+    const assets::MeshData& objectMesh = *objectMeshes[iObject];
+    const auto objectTransform = Magnum::EigenIntegration::cast<
+        Eigen::Transform<float, 3, Eigen::Affine> >(
+        objectTransformations[iObject]);
+    NavMeshObject& navMeshObject = navMeshObjects[iObject];
+    const uint32_t prevNumVerts = joinedMesh->vbo.size();
+    for (uint32_t index : objectMesh.ibo) {
+      joinedMesh->ibo.push_back(index + prevNumVerts);
+    }
+    for (auto& vert : objectMesh.vbo) {
+      joinedMesh->vbo.push_back(objectTransform * vert);
+      navMeshObject.bounds.first =
+          navMeshObject.bounds.first.cwiseMin(joinedMesh->vbo.back());
+      navMeshObject.bounds.second =
+          navMeshObject.bounds.second.cwiseMax(joinedMesh->vbo.back());
+    }
+  }
+
+  // if the objects were baked into a tiled navmesh before, only the tiles
+  // around objects that were added, removed or moved since need rebuilding
+  bool rebuilt = false;
+  if (&pathfinder == navMeshObjectsPathfinder_ && navMeshSettings.tileSize) {
+    std::vector<std::pair<vec3f, vec3f>> regions;
+    const auto changed = [](const std::vector<NavMeshObject>& objects,
+                            const std::vector<NavMeshObject>& other,
+                            std::vector<std::pair<vec3f, vec3f>>& regions) {
+      for (const NavMeshObject& object : objects) {
+        if (std::find(other.begin(), other.end(), object) == other.end()) {
+          regions.push_back(object.bounds);
+        }
+      }
+    };
+    changed(navMeshObjects_, navMeshObjects, regions);
+    changed(navMeshObjects, navMeshObjects_, regions);
+    rebuilt = pathfinder.rebuildTiles(navMeshSettings, *joinedMesh, regions);
+  }
+
+  if (!rebuilt && !pathfinder.build(navMeshSettings, *joinedMesh)) {
     LOG(ERROR) << "Failed to build navmesh";
+    navMeshObjectsPathfinder_ = nullptr;
+    navMeshObjects_.clear();
     return false;
   }
+  navMeshObjectsPathfinder_ = &pathfinder;
+  navMeshObjects_ = std::move(navMeshObjects);
 
   LOG(INFO) << "reconstruct navmesh successful";
   return true;
@@ -556,6 +1802,40 @@ void Simulator::sampleRandomAgentState(agent::AgentState& agentState) {
   }
 }
 
+void Simulator::configureRenderer() {
+  if (!renderer_) {
+    return;
+  }
+  renderer_->setOcclusionCulling(config_.occlusionCulling);
+  renderer_->setRenderTargetSharing(config_.shareRenderTargets);
+  // the sensors of the previous configuration that are still alive keep
+  // theirs, so they are recycled by the sensors bound next
+  renderer_->releaseUnusedRenderTargets();
+
+  const std::string pvsFilename =
+      config_.potentiallyVisibleSets
+          ? io::changeExtension(sceneMeshFilename(config_.scene), ".pvs")
+          : "";
+  if (pvsFilename != loadedPvsFilename_) {
+    potentiallyVisibleSet_ = nullptr;
+    loadedPvsFilename_ = pvsFilename;
+    if (!pvsFilename.empty() && io::exists(pvsFilename)) {
+      LOG(INFO) << "Loading potentially visible set from " << pvsFilename;
+      potentiallyVisibleSet_ = gfx::PotentiallyVisibleSet::create();
+      if (!potentiallyVisibleSet_->load(pvsFilename)) {
+        potentiallyVisibleSet_ = nullptr;
+      }
+    } else if (!pvsFilename.empty()) {
+      LOG(WARNING) << "Potentially visible set not found, checked at "
+                   << pvsFilename;
+    }
+  }
+  // every sensor draws with the default camera of the scene graph
+  sceneManager_.getSceneGraph(activeSceneID_)
+      .getDefaultRenderCamera()
+      .setPotentiallyVisibleSet(potentiallyVisibleSet_.get());
+}
+
 agent::Agent::ptr Simulator::addAgent(
     const agent::AgentConfiguration& agentConfig,
     scene::SceneNode& agentParentNode) {
@@ -576,7 +1856,9 @@ agent::Agent::ptr Simulator::addAgent(
   for (auto& it : ag->getSensorSuite().getSensors()) {
     if (it.second->isVisualSensor()) {
       auto sensor = static_cast<sensor::VisualSensor*>(it.second.get());
-      renderer_->bindRenderTarget(*sensor);
+      if (renderer_ && sensor->needsRenderTarget()) {
+        renderer_->bindRenderTarget(*sensor);
+      }
     }
   }
 
@@ -602,10 +1884,236 @@ agent::Agent::ptr Simulator::getAgent(int agentId) {
   return agents_[agentId];
 }
 
+bool Simulator::getAgentStates(const std::vector<int>& agentIds,
+                               Cr::Containers::ArrayView<float> positions,
+                               Cr::Containers::ArrayView<float> rotations) {
+  CORRADE_ASSERT(positions.size() == 3 * agentIds.size() &&
+                     rotations.size() == 4 * agentIds.size(),
+                 "Simulator::getAgentStates(): expected 3 position and 4 "
+                 "rotation floats per agent",
+                 false);
+  for (size_t i = 0; i < agentIds.size(); ++i) {
+    const int agentId = agentIds[i];
+    if (agentId < 0 || agentId >= int(agents_.size())) {
+      LOG(ERROR) << "Simulator::getAgentStates(): no agent " << agentId;
+      return false;
+    }
+    const scene::SceneNode& node = agents_[agentId]->node();
+    const Magnum::Vector3 position =
+        node.absoluteTransformation().translation();
+    const Magnum::Quaternion rotation = node.rotation();
+    std::copy(position.data(), position.data() + 3, &positions[3 * i]);
+    std::copy(rotation.vector().data(), rotation.vector().data() + 3,
+              &rotations[4 * i]);
+    rotations[4 * i + 3] = rotation.scalar();
+  }
+  return true;
+}
+
+bool Simulator::setAgentStates(
+    const std::vector<int>& agentIds,
+    Cr::Containers::ArrayView<const float> positions,
+    Cr::Containers::ArrayView<const float> rotations,
+    bool resetSensors /* = true */) {
+  CORRADE_ASSERT(positions.size() == 3 * agentIds.size() &&
+                     rotations.size() == 4 * agentIds.size(),
+                 "Simulator::setAgentStates(): expected 3 position and 4 "
+                 "rotation floats per agent",
+                 false);
+  bool success = true;
+  for (size_t i = 0; i < agentIds.size(); ++i) {
+    const int agentId = agentIds[i];
+    if (agentId < 0 || agentId >= int(agents_.size())) {
+      LOG(ERROR) << "Simulator::setAgentStates(): no agent " << agentId;
+      success = false;
+      continue;
+    }
+    const float* r = &rotations[4 * i];
+    const Magnum::Quaternion rotation{{r[0], r[1], r[2]}, r[3]};
+    if (std::abs(rotation.length() - 1.0f) > 1.0e-3f) {
+      LOG(ERROR) << "Simulator::setAgentStates(): rotation of agent "
+                 << agentId << " is not normalized";
+      success = false;
+      continue;
+    }
+    agents_[agentId]->setPose(Magnum::Vector3::from(&positions[3 * i]),
+                              rotation.normalized(), resetSensors);
+  }
+  return success;
+}
+
+bool Simulator::renderAgentPoses(
+    int agentId,
+    Cr::Containers::ArrayView<const float> positions,
+    Cr::Containers::ArrayView<const float> rotations,
+    const std::vector<std::string>& sensorIds,
+    const std::vector<Cr::Containers::ArrayView<uint8_t>>& outputs,
+    bool sortPoses /* = true */) {
+  ESP_PROFILE_SCOPE("Simulator::renderAgentPoses");
+  const size_t count = positions.size() / 3;
+  CORRADE_ASSERT(positions.size() == 3 * count &&
+                     rotations.size() == 4 * count,
+                 "Simulator::renderAgentPoses(): expected 3 position and 4 "
+                 "rotation floats per pose",
+                 false);
+  CORRADE_ASSERT(sensorIds.size() == outputs.size(),
+                 "Simulator::renderAgentPoses(): expected an output for each "
+                 "of the" << sensorIds.size() << "sensors",
+                 false);
+  agent::Agent::ptr ag = getAgent(agentId);
+  if (ag == nullptr) {
+    LOG(ERROR) << "Simulator::renderAgentPoses(): no agent " << agentId;
+    return false;
+  }
+
+  std::vector<Mn::Quaternion> poseRotations;
+  poseRotations.reserve(count);
+  for (size_t i = 0; i != count; ++i) {
+    const float* r = &rotations[4 * i];
+    const Mn::Quaternion rotation{{r[0], r[1], r[2]}, r[3]};
+    if (std::abs(rotation.length() - 1.0f) > 1.0e-3f) {
+      LOG(ERROR) << "Simulator::renderAgentPoses(): rotation " << i
+                 << " is not normalized";
+      return false;
+    }
+    poseRotations.push_back(rotation.normalized());
+  }
+
+  // a sensor and the rows of its output
+  struct Target {
+    sensor::PinholeCamera* camera;
+    Cr::Containers::ArrayView<uint8_t> output;
+    size_t rowSize;
+    gfx::RenderTarget::FrameType frameType;
+    Mn::PixelFormat pixelFormat;
+    // whether reads are queued and retrieved after the next pose is drawn
+    bool pipelined;
+  };
+  std::vector<Target> targets;
+  for (size_t i = 0; i != sensorIds.size(); ++i) {
+    auto camera = dynamic_cast<sensor::PinholeCamera*>(
+        ag->getSensorSuite().get(sensorIds[i]).get());
+    if (camera == nullptr || !camera->hasRenderTarget()) {
+      LOG(ERROR) << "Simulator::renderAgentPoses(): " << sensorIds[i]
+                 << " is not a pinhole sensor with a render target";
+      return false;
+    }
+    sensor::ObservationSpace space;
+    camera->getObservationSpace(space);
+    size_t rowSize = core::getDataTypeByteSize(space.dataType);
+    for (size_t extent : space.shape) {
+      rowSize *= extent;
+    }
+    if (outputs[i].size() != rowSize * count) {
+      LOG(ERROR) << "Simulator::renderAgentPoses(): expected "
+                 << rowSize * count << " bytes of output for "
+                 << sensorIds[i] << " but got " << outputs[i].size();
+      return false;
+    }
+    const bool pipelined =
+        !camera->sharesRenderTarget() &&
+        camera->renderTarget().readbackBufferCount() >= 2 &&
+        camera->specification()->observationLayout !=
+            sensor::ObservationLayout::SEMANTIC_HISTOGRAM;
+    targets.push_back({camera, outputs[i], rowSize,
+                       camera->observationFrameType(),
+                       camera->observationPixelFormat(), pipelined});
+  }
+  if (count == 0) {
+    return true;
+  }
+
+  const auto rowView = [](const Target& target, size_t row) {
+    return Mn::MutableImageView2D{
+        Mn::PixelStorage{}.setAlignment(1), target.pixelFormat,
+        target.camera->renderTarget().outputSize(target.frameType),
+        target.output.slice(row * target.rowSize, (row + 1) * target.rowSize)};
+  };
+  const auto retrieve = [&](size_t row) {
+    for (const Target& target : targets) {
+      if (target.pipelined) {
+        target.camera->renderTarget().readQueuedFrame(
+            target.frameType, rowView(target, row), true);
+        target.camera->mapSemanticCategories(
+            *this, target.output.slice(row * target.rowSize,
+                                       (row + 1) * target.rowSize));
+      }
+    }
+  };
+
+  // reads left in flight by pipelined stepping would be retrieved in place
+  // of ours, they go into a row that is overwritten later
+  for (const Target& target : targets) {
+    gfx::RenderTarget& renderTarget = target.camera->renderTarget();
+    renderTarget.setOutputFormat(target.camera->outputFormat());
+    while (target.pipelined &&
+           renderTarget.queuedFrameCount(target.frameType) > 0) {
+      renderTarget.readQueuedFrame(target.frameType, rowView(target, 0), true);
+    }
+  }
+
+  uploadPendingMeshes();
+  const Mn::Vector3 position = ag->node().translation();
+  const Mn::Quaternion rotation = ag->node().rotation();
+  std::vector<size_t> order;
+  if (sortPoses) {
+    order = coherentPoseOrder(positions, poseRotations);
+  } else {
+    order.resize(count);
+    for (size_t i = 0; i != count; ++i) {
+      order[i] = i;
+    }
+  }
+
+  Cr::Containers::Optional<size_t> inFlight;
+  for (size_t i : order) {
+    ag->setPose(Mn::Vector3::from(&positions[3 * i]), poseRotations[i],
+                false);
+    for (const Target& target : targets) {
+      target.camera->drawObservation(*this);
+      gfx::RenderTarget& renderTarget = target.camera->renderTarget();
+      renderTarget.setOutputFormat(target.camera->outputFormat());
+      if (target.pipelined) {
+        renderTarget.queueReadFrame(target.frameType, target.pixelFormat);
+      } else {
+        target.camera->readObservation(
+            target.output.slice(i * target.rowSize,
+                                (i + 1) * target.rowSize),
+            renderTarget, sensor::ReadbackMode::Synchronous);
+        target.camera->mapSemanticCategories(
+            *this,
+            target.output.slice(i * target.rowSize, (i + 1) * target.rowSize));
+      }
+    }
+    // the previous pose was read while this one was drawn
+    if (inFlight) {
+      retrieve(*inFlight);
+    }
+    inFlight = i;
+  }
+  retrieve(*inFlight);
+
+  ag->setPose(position, rotation, false);
+  return true;
+}
+
 nav::PathFinder::ptr Simulator::getPathFinder() {
   return pathfinder_;
 }
 
+bool Simulator::loadNavMesh(const std::string& navmeshFilename) {
+  auto pathfinder = nav::PathFinder::create();
+  if (!pathfinder->loadNavMesh(navmeshFilename)) {
+    LOG(ERROR) << "Simulator::loadNavMesh(): cannot load " << navmeshFilename;
+    return false;
+  }
+  pathfinder->seed(seed_);
+  pathfinder_ = std::move(pathfinder);
+  loadedNavmeshFilename_ = navmeshFilename;
+  storeActiveScene();
+  return true;
+}
+
 bool Simulator::displayObservation(int agentId, const std::string& sensorId) {
   agent::Agent::ptr ag = getAgent(agentId);
 
@@ -625,7 +2133,13 @@ bool Simulator::getAgentObservation(int agentId,
   if (ag != nullptr) {
     sensor::Sensor::ptr sensor = ag->getSensorSuite().get(sensorId);
     if (sensor != nullptr) {
-      return sensor->getObservation(*this, observation);
+      // an explicit request always renders, sensors updated only on demand
+      // return it from then on
+      if (!sensor->getObservation(*this, observation)) {
+        return false;
+      }
+      sensor->setLastObservation(observation);
+      return true;
     }
   }
   return false;
@@ -635,18 +2149,541 @@ int Simulator::getAgentObservations(
     int agentId,
     std::map<std::string, sensor::Observation>& observations) {
   observations.clear();
+  AgentObservations agentObservations;
+  getAgentObservations(agentId, agentObservations);
+  for (size_t i = 0; i < agentObservations.observations.size(); ++i) {
+    const sensor::Observation& obs = agentObservations.observations[i];
+    if (obs.buffer != nullptr || obs.deviceBuffer != nullptr) {
+      observations[agentObservations.sensorUuids[i]] = obs;
+    }
+  }
+  return observations.size();
+}
+
+std::vector<bool> Simulator::drawMultiView(
+    const std::vector<sensor::VisualSensor*>& sensors) {
+  std::vector<bool> drawn(sensors.size(), false);
+  if (!renderer_) {
+    return drawn;
+  }
+  std::vector<gfx::Renderer::BatchEntry> entries;
+  for (sensor::VisualSensor* sensor : sensors) {
+    auto camera = dynamic_cast<sensor::PinholeCamera*>(sensor);
+    if (camera != nullptr && camera->hasRenderTarget()) {
+      entries.push_back({camera, &camera->getSceneGraphToDraw(*this)});
+    }
+  }
+  for (const auto& group : gfx::Renderer::groupEntriesForMultiView(entries)) {
+    if (group.size() < 2) {
+      continue;
+    }
+    renderer_->drawMultiView(group, frustumCulling_);
+    for (const gfx::Renderer::BatchEntry& entry : group) {
+      drawn[std::find(sensors.begin(), sensors.end(), entry.sensor) -
+            sensors.begin()] = true;
+    }
+  }
+  return drawn;
+}
+
+std::vector<bool> Simulator::drawMultiViewGroups(
+    const std::vector<std::vector<gfx::Renderer::BatchEntry>>& groups) {
+  // the occlusion culler of each sensor only sees its own draws
+  if (!config_.multiViewRendering || !renderer_ ||
+      renderer_->occlusionCulling()) {
+    return std::vector<bool>(groups.size(), false);
+  }
+  std::vector<sensor::VisualSensor*> firsts;
+  for (const auto& group : groups) {
+    firsts.push_back(group.front().sensor);
+  }
+  return drawMultiView(firsts);
+}
+
+void Simulator::cullAhead(const std::vector<sensor::VisualSensor*>& sensors) {
+  if (!renderer_ || !frustumCulling_) {
+    return;
+  }
+  std::vector<gfx::Renderer::BatchEntry> entries;
+  for (sensor::VisualSensor* sensor : sensors) {
+    auto camera = dynamic_cast<sensor::PinholeCamera*>(sensor);
+    if (camera != nullptr && camera->hasRenderTarget()) {
+      entries.push_back({camera, &camera->getSceneGraphToDraw(*this)});
+    }
+  }
+  renderer_->cullAhead(entries);
+}
+
+size_t Simulator::uploadPendingMeshes() {
+  if (!resourceManager_.hasPendingMeshUploads()) {
+    return 0;
+  }
+  const size_t budget = config_.meshUploadBudget;
+  return resourceManager_.uploadPendingMeshes(budget > 0 ? budget
+                                                         : ~size_t{});
+}
+
+void Simulator::cullAheadGroups(
+    const std::vector<std::vector<gfx::Renderer::BatchEntry>>& groups,
+    const std::vector<bool>& drawn) {
+  if (!config_.parallelCulling) {
+    return;
+  }
+  std::vector<sensor::VisualSensor*> firsts;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    if (!drawn[g]) {
+      firsts.push_back(groups[g].front().sensor);
+    }
+  }
+  cullAhead(firsts);
+}
+
+void Simulator::getAgentObservations(int agentId,
+                                     AgentObservations& observations) {
+  agent::Agent::ptr ag = getAgent(agentId);
+  const uint64_t key = observationCache_.maxByteSize() != 0 && ag != nullptr
+                           ? observationCacheKey(agentId, *ag)
+                           : 0;
+  if (key == 0) {
+    readAgentObservations(agentId, observations, Corrade::Containers::NullOpt);
+    return;
+  }
+  if (const std::vector<sensor::Observation>* cached =
+          observationCache_.find(key)) {
+    updateSensorUuids(ag->getSensorSuite().getSensors(),
+                      observations.sensorUuids);
+    observations.observations = *cached;
+    // sensors reading into a caller's buffer get cache hits there too
+    size_t i = 0;
+    for (const auto& s : ag->getSensorSuite().getSensors()) {
+      sensor::Observation& obs = observations.observations[i++];
+      if (!s.second->isVisualSensor() || obs.buffer == nullptr) {
+        continue;
+      }
+      core::Buffer::ptr destination =
+          static_cast<sensor::VisualSensor&>(*s.second)
+              .observationDestination();
+      if (destination != nullptr) {
+        std::copy(obs.buffer->data.begin(), obs.buffer->data.end(),
+                  destination->data.begin());
+        obs.buffer = std::move(destination);
+      }
+    }
+    return;
+  }
+  readAgentObservations(agentId, observations, Corrade::Containers::NullOpt);
+  observationCache_.insert(key, observations.observations);
+}
+
+uint64_t Simulator::observationCacheKey(int agentId,
+                                        const agent::Agent& agent) {
+  const float positionResolution = observationCachePositionResolution_;
+  const float rotationResolution = observationCacheRotationResolution_;
+  uint64_t hash = 14695981039346656037ull;
+  hashQuantized(hash, float(agentId), 1.0f);
+  for (const auto& s : agent.getSensorSuite().getSensors()) {
+    const sensor::SensorSpec& spec = *s.second->specification();
+    if (spec.updateInterval != 1 || spec.gpu2gpuTransfer) {
+      return 0;
+    }
+    hashQuantizedPose(hash, s.second->node().absoluteTransformation(),
+                      positionResolution, rotationResolution);
+  }
+
+  // the scene state: nodes added or removed, where the other agents and the
+  // objects are
+  const uint64_t generation = scene::SceneNode::structureGeneration();
+  hash = (hash ^ generation) * 1099511628211ull;
+  for (size_t i = 0; i < agents_.size(); ++i) {
+    if (int(i) != agentId) {
+      hashQuantizedPose(hash, agents_[i]->node().absoluteTransformation(),
+                        positionResolution, rotationResolution);
+    }
+  }
+  if (physicsManager_ != nullptr) {
+    const std::vector<int> objectIds = physicsManager_->getExistingObjectIDs();
+    std::vector<Magnum::Vector3> translations(objectIds.size());
+    std::vector<Magnum::Quaternion> rotations(objectIds.size());
+    physicsManager_->getTranslations(objectIds, translations);
+    physicsManager_->getRotations(objectIds, rotations);
+    for (size_t i = 0; i < objectIds.size(); ++i) {
+      hashQuantized(hash, float(objectIds[i]), 1.0f);
+      for (int j = 0; j != 3; ++j) {
+        hashQuantized(hash, translations[i][j], positionResolution);
+        hashQuantized(hash, rotations[i].vector()[j], rotationResolution);
+      }
+      hashQuantized(hash, rotations[i].scalar(), rotationResolution);
+    }
+  }
+  // 0 means not cacheable
+  return hash == 0 ? 1 : hash;
+}
+
+void Simulator::setObservationCache(size_t maxByteSize,
+                                    float positionResolution,
+                                    float rotationResolution) {
+  CORRADE_ASSERT(positionResolution > 0.0f && rotationResolution > 0.0f,
+                 "Simulator::setObservationCache(): expected positive "
+                 "resolutions", );
+  // entries keyed at another resolution would never hit again
+  if (positionResolution != observationCachePositionResolution_ ||
+      rotationResolution != observationCacheRotationResolution_) {
+    observationCache_.clear();
+  }
+  observationCachePositionResolution_ = positionResolution;
+  observationCacheRotationResolution_ = rotationResolution;
+  observationCache_.setMaxByteSize(maxByteSize);
+}
+
+void Simulator::readAgentObservations(
+    int agentId,
+    AgentObservations& observations,
+    Corrade::Containers::Optional<sensor::ReadbackMode> readbackMode) {
+  ESP_PROFILE_SCOPE("Simulator::readAgentObservations");
+  agent::Agent::ptr ag = getAgent(agentId);
+  if (ag == nullptr) {
+    observations.sensorUuids.clear();
+    observations.observations.clear();
+    return;
+  }
+  const std::map<std::string, sensor::Sensor::ptr>& sensors =
+      ag->getSensorSuite().getSensors();
+
+  updateSensorUuids(sensors, observations.sensorUuids);
+  observations.observations.resize(sensors.size());
+
+  // pinhole cameras that share a view are drawn once, see
+  // gfx::Renderer::groupEntriesByView()
+  std::vector<gfx::Renderer::BatchEntry> entries;
+  // observation slot of each entry
+  std::vector<sensor::Observation*> entryObservations;
+  size_t index = 0;
+  for (const auto& s : sensors) {
+    sensor::Observation& obs = observations.observations[index++];
+    // sensors with an update interval return their last observation between
+    // updates, without drawing or reading anything
+    if (!s.second->scheduleObservation()) {
+      obs = s.second->lastObservation();
+      continue;
+    }
+    auto camera = dynamic_cast<sensor::PinholeCamera*>(s.second.get());
+    if (camera != nullptr && camera->hasRenderTarget()) {
+      entries.push_back({camera, &camera->getSceneGraphToDraw(*this)});
+      entryObservations.push_back(&obs);
+      continue;
+    }
+    if (!s.second->getObservation(*this, obs)) {
+      obs = sensor::Observation{};
+    }
+    s.second->setLastObservation(obs);
+  }
+
+  auto entryObservation = [&](const sensor::VisualSensor* sensor) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i].sensor == sensor) {
+        return entryObservations[i];
+      }
+    }
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+  };
+  uploadPendingMeshes();
+  const auto groups = gfx::Renderer::groupEntriesByView(entries);
+  const std::vector<bool> drawn = drawMultiViewGroups(groups);
+  cullAheadGroups(groups, drawn);
+  for (size_t g = 0; g < groups.size(); ++g) {
+    const auto& group = groups[g];
+    auto& first = static_cast<sensor::PinholeCamera&>(*group[0].sensor);
+    if (!drawn[g]) {
+      first.drawObservation(*this);
+    }
+    for (const gfx::Renderer::BatchEntry& entry : group) {
+      auto camera = static_cast<sensor::PinholeCamera*>(entry.sensor);
+      sensor::Observation& obs = *entryObservation(entry.sensor);
+      {
+        gfx::RenderProfiler::ScopedPass pass{
+            renderer_->profiler(), camera->specification()->uuid,
+            gfx::RenderProfiler::Pass::Readback};
+        camera->readObservation(obs, first.renderTarget(), readbackMode);
+      }
+      if (obs.buffer != nullptr) {
+        camera->mapSemanticCategories(*this, obs.buffer->data);
+      }
+      camera->setLastObservation(obs);
+    }
+  }
+}
+
+const AgentObservations& Simulator::step(int agentId,
+                                         const std::string& actionName,
+                                         double dt /* = 1.0 / 60.0 */) {
+  ESP_PROFILE_SCOPE("Simulator::step");
   agent::Agent::ptr ag = getAgent(agentId);
   if (ag != nullptr) {
-    const std::map<std::string, sensor::Sensor::ptr>& sensors =
-        ag->getSensorSuite().getSensors();
-    for (std::pair<std::string, sensor::Sensor::ptr> s : sensors) {
-      sensor::Observation obs;
-      if (s.second->getObservation(*this, obs)) {
-        observations[s.first] = obs;
+    ag->act(actionName);
+  }
+  stepWorld(dt);
+  if (recording_) {
+    recordFrame({{agentId, actionName}});
+  }
+
+  if (agentObservations_.size() <= agentId) {
+    agentObservations_.resize(agentId + 1);
+  }
+  AgentObservations& observations = agentObservations_[agentId];
+  readAgentObservations(agentId, observations, stepReadbackMode());
+  return observations;
+}
+
+const BatchObservations& Simulator::step(
+    const std::vector<std::pair<int, std::string>>& actions,
+    double dt /* = 1.0 / 60.0 */) {
+  ESP_PROFILE_SCOPE("Simulator::step(batch)");
+  stepAgents(actions, dt);
+  std::vector<int> agentIds;
+  for (const auto& action : actions) {
+    if (std::find(agentIds.begin(), agentIds.end(), action.first) ==
+        agentIds.end()) {
+      agentIds.push_back(action.first);
+    }
+  }
+
+  // the rows of skipped sensors keep their previous content, which is only
+  // valid while the tensor and its sensors stay the same
+  std::map<sensor::SensorType, std::vector<std::pair<int, std::string>>>
+      previousSensors;
+  for (auto& tensor : batchObservations_.tensors) {
+    previousSensors[tensor.first] = std::move(tensor.second.sensors);
+    tensor.second.sensors.clear();
+  }
+
+  // assign every camera a row in the tensor of its type
+  struct Row {
+    BatchObservations::Tensor* tensor;
+    size_t index;
+  };
+  std::vector<gfx::Renderer::BatchEntry> entries;
+  std::vector<Row> rows;
+  // whether each entry is due according to its update interval
+  std::vector<bool> due;
+  std::map<sensor::SensorType, sensor::ObservationSpace> spaces;
+  std::set<sensor::SensorType> pinnedTypes;
+  for (int agentId : agentIds) {
+    agent::Agent::ptr ag = getAgent(agentId);
+    if (ag == nullptr) {
+      continue;
+    }
+    for (const auto& s : ag->getSensorSuite().getSensors()) {
+      auto camera = dynamic_cast<sensor::PinholeCamera*>(s.second.get());
+      if (camera == nullptr || !camera->hasRenderTarget() ||
+          camera->specification()->gpu2gpuTransfer) {
+        continue;
+      }
+      const sensor::SensorType type = camera->specification()->sensorType;
+      sensor::ObservationSpace space;
+      camera->getObservationSpace(space);
+      auto found = spaces.find(type);
+      if (found == spaces.end()) {
+        spaces.emplace(type, space);
+      } else if (found->second.shape != space.shape ||
+                 found->second.dataType != space.dataType) {
+        LOG(ERROR) << "Simulator::step(): sensor " << s.first << " of agent "
+                   << agentId
+                   << " doesn't match the shape of other sensors of its type, "
+                      "skipping";
+        continue;
+      }
+      BatchObservations::Tensor& tensor = batchObservations_.tensors[type];
+      rows.push_back({&tensor, tensor.sensors.size()});
+      tensor.sensors.emplace_back(agentId, s.first);
+      if (camera->specification()->pinnedObservations) {
+        pinnedTypes.insert(type);
       }
+      entries.push_back({camera, &camera->getSceneGraphToDraw(*this)});
+      due.push_back(camera->scheduleObservation());
     }
   }
-  return observations.size();
+
+  // drop types nobody observes anymore, (re)allocate the others
+  std::set<const BatchObservations::Tensor*> staleTensors;
+  for (auto it = batchObservations_.tensors.begin();
+       it != batchObservations_.tensors.end();) {
+    BatchObservations::Tensor& tensor = it->second;
+    if (tensor.sensors.empty()) {
+      it = batchObservations_.tensors.erase(it);
+      continue;
+    }
+    const sensor::ObservationSpace& space = spaces.at(it->first);
+    std::vector<size_t> shape{tensor.sensors.size()};
+    shape.insert(shape.end(), space.shape.begin(), space.shape.end());
+    const core::BufferStorage storage = pinnedTypes.count(it->first)
+                                            ? core::BufferStorage::Pinned
+                                            : core::BufferStorage::Aligned;
+    if (tensor.buffer == nullptr || tensor.buffer->shape != shape ||
+        tensor.buffer->dataType != space.dataType ||
+        tensor.storage != storage) {
+      tensor.buffer = core::Buffer::create(shape, space.dataType, storage);
+      tensor.storage = storage;
+      staleTensors.insert(&tensor);
+    } else if (tensor.sensors != previousSensors[it->first]) {
+      staleTensors.insert(&tensor);
+    }
+    ++it;
+  }
+
+  // draw only the sensors that are due or whose row has no valid content
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (due[i] || staleTensors.count(rows[i].tensor)) {
+        entries[kept] = entries[i];
+        rows[kept] = rows[i];
+        ++kept;
+      }
+    }
+    entries.resize(kept);
+    rows.resize(kept);
+  }
+
+  auto entryRow = [&](const sensor::VisualSensor* sensor) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i].sensor == sensor) {
+        return rows[i];
+      }
+    }
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+  };
+  uploadPendingMeshes();
+  const auto groups = gfx::Renderer::groupEntriesByView(entries);
+  const std::vector<bool> drawn = drawMultiViewGroups(groups);
+  cullAheadGroups(groups, drawn);
+  for (size_t g = 0; g < groups.size(); ++g) {
+    const auto& group = groups[g];
+    auto& first = static_cast<sensor::PinholeCamera&>(*group[0].sensor);
+    if (!drawn[g]) {
+      first.drawObservation(*this);
+    }
+    for (const gfx::Renderer::BatchEntry& entry : group) {
+      const Row row = entryRow(entry.sensor);
+      Corrade::Containers::ArrayView<uint8_t> data = row.tensor->buffer->data;
+      const size_t rowSize = data.size() / row.tensor->sensors.size();
+      Corrade::Containers::ArrayView<uint8_t> slice =
+          data.slice(row.index * rowSize, (row.index + 1) * rowSize);
+      auto camera = static_cast<sensor::PinholeCamera*>(entry.sensor);
+      {
+        gfx::RenderProfiler::ScopedPass pass{
+            renderer_->profiler(), camera->specification()->uuid,
+            gfx::RenderProfiler::Pass::Readback};
+        camera->readObservation(slice, first.renderTarget(),
+                                stepReadbackMode());
+      }
+      camera->mapSemanticCategories(*this, slice);
+    }
+  }
+  return batchObservations_;
+}
+
+void Simulator::stepAgents(
+    const std::vector<std::pair<int, std::string>>& actions,
+    double dt /* = 1.0 / 60.0 */) {
+  ESP_PROFILE_SCOPE("Simulator::stepAgents");
+  // the navmesh filters the moves of all agents in one parallel pass
+  // instead of one step query per agent
+  const bool batchFilter = pathfinder_->isLoaded();
+  for (const auto& action : actions) {
+    agent::Agent::ptr ag = getAgent(action.first);
+    if (ag != nullptr) {
+      if (batchFilter) {
+        ag->getControls()->setFilterBatch(&moveBatch_);
+      }
+      ag->act(action.second);
+      ag->getControls()->setFilterBatch(nullptr);
+    }
+  }
+  moveBatch_.apply([&](Cr::Containers::ArrayView<const vec3f> starts,
+                       Cr::Containers::ArrayView<const vec3f> ends,
+                       Cr::Containers::ArrayView<vec3f> results) {
+    pathfinder_->trySteps(starts, ends, results);
+  });
+  stepWorld(dt);
+  if (recording_) {
+    recordFrame(actions);
+  }
+}
+
+size_t Simulator::getObservationsByteSize(int agentId) {
+  agent::Agent::ptr ag = getAgent(agentId);
+  size_t byteSize = 0;
+  if (ag != nullptr) {
+    ringEntries(*ag, byteSize);
+  }
+  return byteSize;
+}
+
+uint64_t Simulator::writeObservations(int agentId,
+                                      core::SharedMemoryRing& ring) {
+  ESP_PROFILE_SCOPE("Simulator::writeObservations");
+  agent::Agent::ptr ag = getAgent(agentId);
+  if (ag == nullptr) {
+    return 0;
+  }
+  size_t byteSize = 0;
+  const std::vector<RingEntry> cameras = ringEntries(*ag, byteSize);
+  if (byteSize > ring.slotByteSize()) {
+    LOG(ERROR) << "Simulator::writeObservations(): agent " << agentId
+               << " needs " << byteSize << " bytes but the ring slots have "
+               << ring.slotByteSize();
+    return 0;
+  }
+  const std::string layout = ringLayout(cameras);
+  if (layout.size() > core::SharedMemoryRing::LayoutCapacity) {
+    LOG(ERROR) << "Simulator::writeObservations(): the layout of agent "
+               << agentId << " is too long for the ring";
+    return 0;
+  }
+  Cr::Containers::ArrayView<uint8_t> slot = ring.beginWrite();
+  if (slot.empty()) {
+    return 0;
+  }
+
+  std::vector<gfx::Renderer::BatchEntry> entries;
+  for (const RingEntry& entry : cameras) {
+    entries.push_back(
+        {entry.camera, &entry.camera->getSceneGraphToDraw(*this)});
+  }
+  auto entryData = [&](const sensor::VisualSensor* sensor) {
+    for (const RingEntry& entry : cameras) {
+      if (entry.camera == sensor) {
+        return slot.slice(entry.offset, entry.offset + entry.byteSize);
+      }
+    }
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+  };
+  uploadPendingMeshes();
+  const auto groups = gfx::Renderer::groupEntriesByView(entries);
+  const std::vector<bool> drawn = drawMultiViewGroups(groups);
+  cullAheadGroups(groups, drawn);
+  for (size_t g = 0; g < groups.size(); ++g) {
+    const auto& group = groups[g];
+    auto& first = static_cast<sensor::PinholeCamera&>(*group[0].sensor);
+    if (!drawn[g]) {
+      first.drawObservation(*this);
+    }
+    for (const gfx::Renderer::BatchEntry& entry : group) {
+      auto camera = static_cast<sensor::PinholeCamera*>(entry.sensor);
+      Cr::Containers::ArrayView<uint8_t> data = entryData(entry.sensor);
+      {
+        gfx::RenderProfiler::ScopedPass pass{
+            renderer_->profiler(), camera->specification()->uuid,
+            gfx::RenderProfiler::Pass::Readback};
+        // the slot is handed over right after, so nothing can be pipelined,
+        // and a synchronous read lands in the slot without a staging copy
+        camera->readObservation(data, first.renderTarget(),
+                                sensor::ReadbackMode::Synchronous);
+      }
+      camera->mapSemanticCategories(*this, data);
+    }
+  }
+  return ring.endWrite(byteSize, layout);
 }
 
 bool Simulator::getAgentObservationSpace(int agentId,
@@ -684,6 +2721,176 @@ void Simulator::setLightSetup(gfx::LightSetup setup, const std::string& key) {
   resourceManager_.setLightSetup(std::move(setup), key);
 }
 
+void Simulator::startRecording() {
+  recordedTrajectory_ = Trajectory{};
+  recording_ = true;
+}
+
+Trajectory Simulator::stopRecording() {
+  recording_ = false;
+  return std::move(recordedTrajectory_);
+}
+
+void Simulator::recordFrame(
+    const std::vector<std::pair<int, std::string>>& actions) {
+  if (!recording_) {
+    return;
+  }
+  recordedTrajectory_.frames.emplace_back();
+  Trajectory::Frame& frame = recordedTrajectory_.frames.back();
+  frame.worldTime = getWorldTime();
+  for (const auto& action : actions) {
+    frame.actions.push_back(
+        {action.first, recordedTrajectory_.actionIndex(action.second)});
+  }
+  for (size_t i = 0; i < agents_.size(); ++i) {
+    const agent::Agent& agent = *agents_[i];
+    Trajectory::AgentPose pose{
+        int(i), {agent.node().translation(), agent.node().rotation()}, {}};
+    for (const auto& s : agent.getSensorSuite().getSensors()) {
+      const scene::SceneNode& node = s.second->node();
+      pose.sensors.push_back({node.translation(), node.rotation()});
+    }
+    frame.agents.push_back(std::move(pose));
+  }
+  if (physicsManager_ != nullptr) {
+    const std::vector<int> objectIds = physicsManager_->getExistingObjectIDs();
+    std::vector<Magnum::Vector3> translations(objectIds.size());
+    std::vector<Magnum::Quaternion> rotations(objectIds.size());
+    physicsManager_->getTranslations(objectIds, translations);
+    physicsManager_->getRotations(objectIds, rotations);
+    for (size_t i = 0; i < objectIds.size(); ++i) {
+      frame.objects.push_back({objectIds[i], {translations[i], rotations[i]}});
+    }
+  }
+}
+
+bool Simulator::setReplayFrame(const Trajectory& trajectory, size_t index) {
+  if (index >= trajectory.frames.size()) {
+    LOG(ERROR) << "Simulator::setReplayFrame(): frame " << index
+               << " out of range for " << trajectory.frames.size()
+               << " frames";
+    return false;
+  }
+  const Trajectory::Frame& frame = trajectory.frames[index];
+  bool complete = true;
+  for (const Trajectory::AgentPose& pose : frame.agents) {
+    if (pose.agentId < 0 || pose.agentId >= int(agents_.size())) {
+      complete = false;
+      continue;
+    }
+    agent::Agent& agent = *agents_[pose.agentId];
+    agent.setPose(pose.body.translation, pose.body.rotation,
+                  /*resetSensors=*/false);
+    const auto& sensors = agent.getSensorSuite().getSensors();
+    if (sensors.size() != pose.sensors.size()) {
+      complete = false;
+      continue;
+    }
+    size_t i = 0;
+    for (const auto& s : sensors) {
+      scene::SceneNode& node = s.second->node();
+      node.setTranslation(pose.sensors[i].translation);
+      node.setRotation(pose.sensors[i].rotation);
+      ++i;
+    }
+  }
+  if (!frame.objects.empty()) {
+    if (physicsManager_ == nullptr) {
+      complete = false;
+    } else {
+      std::vector<int> existingIds = physicsManager_->getExistingObjectIDs();
+      std::sort(existingIds.begin(), existingIds.end());
+      std::vector<int> objectIds;
+      std::vector<Magnum::Vector3> translations;
+      std::vector<Magnum::Quaternion> rotations;
+      for (const Trajectory::ObjectPose& object : frame.objects) {
+        if (!std::binary_search(existingIds.begin(), existingIds.end(),
+                                object.objectId)) {
+          complete = false;
+          continue;
+        }
+        objectIds.push_back(object.objectId);
+        translations.push_back(object.pose.translation);
+        rotations.push_back(object.pose.rotation);
+      }
+      physicsManager_->setTranslations(objectIds, translations);
+      physicsManager_->setRotations(objectIds, rotations);
+    }
+  }
+  if (!complete) {
+    LOG(WARNING) << "Simulator::setReplayFrame(): frame " << index
+                 << " has agents, sensors or objects missing here, skipped";
+  }
+  replayFrame_.agents = frame.agents;
+  replayFrame_.objects = frame.objects;
+  replayPoseHash_ = Trajectory::poseHash(frame);
+  return complete;
+}
+
+void Simulator::setReplayObservationCacheCapacity(size_t capacity) {
+  replayCacheCapacity_ = capacity;
+  while (replayCacheOrder_.size() > capacity) {
+    replayCache_.erase(replayCacheOrder_.front());
+    replayCacheOrder_.pop_front();
+  }
+}
+
+const AgentObservations& Simulator::getReplayObservations(int agentId) {
+  ESP_PROFILE_SCOPE("Simulator::getReplayObservations");
+  if (replayCacheCapacity_ == 0) {
+    readAgentObservations(agentId, replayObservations_,
+                          Cr::Containers::NullOpt);
+    return replayObservations_;
+  }
+
+  const uint64_t key = (replayPoseHash_ ^ uint64_t(agentId)) * 1099511628211ull;
+  auto found = replayCache_.find(key);
+  const bool occupied = found != replayCache_.end();
+  if (occupied) {
+    const ReplayCacheEntry& entry = found->second;
+    if (entry.agentId == agentId && entry.sceneId == config_.scene.id &&
+        Trajectory::samePoses(entry.poses, replayFrame_)) {
+      return entry.observations;
+    }
+  }
+
+  readAgentObservations(agentId, replayObservations_, Cr::Containers::NullOpt);
+  if (occupied) {
+    // a hash collision, the new state takes over the entry and its place
+    found->second.observations.observations.clear();
+  } else if (replayCacheOrder_.size() >= replayCacheCapacity_) {
+    replayCache_.erase(replayCacheOrder_.front());
+    replayCacheOrder_.pop_front();
+  }
+  ReplayCacheEntry& entry = replayCache_[key];
+  entry.agentId = agentId;
+  entry.sceneId = config_.scene.id;
+  entry.poses = replayFrame_;
+  // copies, the sensors reuse their buffers for the next observation
+  AgentObservations& cached = entry.observations;
+  cached.sensorUuids = replayObservations_.sensorUuids;
+  for (const sensor::Observation& obs : replayObservations_.observations) {
+    sensor::Observation copy;
+    copy.deviceBuffer = obs.deviceBuffer;
+    if (obs.buffer != nullptr) {
+      copy.buffer =
+          core::Buffer::create(obs.buffer->shape, obs.buffer->dataType);
+      Cr::Utility::copy(obs.buffer->data, copy.buffer->data);
+    }
+    cached.observations.push_back(std::move(copy));
+  }
+  if (!occupied) {
+    replayCacheOrder_.push_back(key);
+  }
+  return cached;
+}
+
+void Simulator::clearReplayObservationCache() {
+  replayCache_.clear();
+  replayCacheOrder_.clear();
+}
+
 gfx::LightSetup Simulator::getLightSetup(const std::string& key) {
   return *resourceManager_.getLightSetup(key);
 }
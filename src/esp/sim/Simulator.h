@@ -4,10 +4,20 @@
 
 #pragma once
 
+#include <deque>
+#include <future>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Optional.h>
+
 #include "esp/agent/Agent.h"
 #include "esp/assets/ResourceManager.h"
 #include "esp/core/esp.h"
 #include "esp/core/random.h"
+#include "esp/gfx/PotentiallyVisibleSet.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/nav/PathFinder.h"
@@ -15,8 +25,14 @@
 #include "esp/scene/SceneConfiguration.h"
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
+#include "esp/sensor/VisualSensor.h"
+#include "esp/sim/ObservationCache.h"
+#include "esp/sim/Trajectory.h"
 
 namespace esp {
+namespace core {
+class SharedMemoryRing;
+}  // namespace core
 namespace nav {
 class PathFinder;
 class NavMeshSettings;
@@ -26,25 +42,143 @@ namespace scene {
 class SemanticScene;
 }  // namespace scene
 namespace gfx {
+class ImageWriter;
 class Renderer;
 }  // namespace gfx
+namespace physics {
+struct PhysicsState;
+struct RayHit;
+struct StepStatistics;
+}  // namespace physics
 }  // namespace esp
 
 namespace esp {
 namespace sim {
 
+struct SimulatorCheckpoint;
+
 struct SimulatorConfiguration {
   scene::SceneConfiguration scene;
   int defaultAgentId = 0;
   int gpuDeviceId = 0;
+  // share the process-wide context of gpuDeviceId instead of creating one,
+  // see gfx::ContextPool
+  bool contextPool = false;
+  // create an own context on gpuDeviceId sharing meshes and textures with
+  // the other simulators that set it, see gfx::ContextPool::createShared().
+  // Ignored if contextPool is set.
+  bool shareContext = false;
+  // pin the calling thread, the threads it starts from then on and the
+  // workers of core::TaskScheduler::global() to the CPUs next to
+  // gpuDeviceId and allocate their memory on its NUMA node, see
+  // gfx::WindowlessContext::deviceLocality(). Applied when the context is
+  // created, for processes dedicated to one GPU
+  bool gpuLocalAffinity = false;
   std::string defaultCameraUuid = "rgba_camera";
   bool compressTextures = false;
+  // reorder loaded meshes for rendering, see
+  // assets::ResourceManager::optimizeMeshes()
+  bool optimizeMeshes = false;
+  // register object templates without loading their meshes until the first
+  // object is added, see assets::ResourceManager::lazyObjectTemplates()
+  bool lazyObjectTemplates = false;
+  // upload instance meshes with quantized positions and 16-bit indices, see
+  // assets::ResourceManager::compactMeshLayout()
+  bool compactMeshLayout = false;
+  // keep the object IDs of instance meshes not split by object per triangle
+  // instead of duplicating vertices where objects meet, see
+  // assets::ResourceManager::primitiveObjectIds()
+  bool primitiveObjectIds = false;
+  // draw PTex meshes with vertex pulling instead of a geometry shader, see
+  // assets::ResourceManager::ptexVertexPulling()
+  bool ptexVertexPulling = false;
+  // simplified levels of detail generated per instance submesh, see
+  // assets::ResourceManager::setMeshLodLevels()
+  int meshLodLevels = 0;
+  // largest on-screen error of the levels of detail drawn, in pixels, see
+  // gfx::RenderCamera::setLevelOfDetailPixelError()
+  float meshLodPixelError = 1.0f;
+  // maximum width and height of loaded textures, 0 for no limit, see
+  // assets::ResourceManager::setMaxTextureSize()
+  int maxTextureSize = 0;
+  // derive maxTextureSize from the sensors of all agents, see
+  // maxTextureSizeForSensors(). Applied by the Python simulator.
+  bool textureSizeFromSensors = false;
+  // directory textures compressed on load are cached in, empty for none, see
+  // assets::ResourceManager::setTextureCacheDirectory()
+  std::string textureCacheDirectory;
+  // directory the collision BVHs of static scene meshes are cached in, empty
+  // for none, see assets::ResourceManager::setCollisionCacheDirectory()
+  std::string collisionCacheDirectory;
+  // pack equally sized textures of an asset into atlases so their materials
+  // share bindings and batches, see assets::ResourceManager::textureAtlases()
+  bool textureAtlases = false;
+  // directory linked shader program binaries are cached in, empty for none,
+  // see gfx::CachedShaderProgram::setCacheDirectory()
+  std::string shaderCacheDirectory;
   bool createRenderer = true;
+  // import the collision geometry of the scene on the CPU even without a
+  // renderer or physics, for sensor::RayCastCamera, navmesh recomputation
+  // and occupancy grids. Set by the Python simulator when all sensors are
+  // ray cast ones
+  bool cpuSceneGeometry = false;
   // Whether or not the agent can slide on collisions
   bool allowSliding = true;
   // enable or disable the frustum culling
   bool frustumCulling = true;
+  // skip drawables hidden behind what each sensor saw in its previous frame,
+  // see gfx::Renderer::setOcclusionCulling()
+  bool occlusionCulling = false;
+  // skip drawables the potentially visible set next to the scene mesh, with
+  // a .pvs extension, excludes for the camera's position, see
+  // gfx::RenderCamera::setPotentiallyVisibleSet(). Computed by the
+  // datatool compute_pvs task.
+  bool potentiallyVisibleSets = false;
+  // draw copies of the same object template with a single instanced draw
+  bool instancedObjectDrawing = false;
+  // pack the meshes of static scenes into shared buffers drawn by one
+  // multi-draw call per material, see
+  // assets::ResourceManager::multiDrawStaticMeshes()
+  bool multiDrawStaticMeshes = false;
+  // put the object IDs of the _semantic.ply next to a glTF scene on the
+  // vertices of its render mesh instead of loading the instance mesh as a
+  // scene of its own, so semantic sensors draw the scene graph of the color
+  // sensors, see assets::ResourceManager::transferSemanticIds()
+  bool semanticIdsOnRenderMesh = false;
+  // sensors of the same size and depth unprojection borrow their render
+  // targets from a pool, see gfx::Renderer::setRenderTargetSharing()
+  bool shareRenderTargets = false;
+  // draw pinhole sensors of an agent that only differ in their position,
+  // e.g. stereo pairs, with one pass over the drawables, see
+  // gfx::Renderer::drawMultiView(). Not with occlusion culling
+  bool multiViewRendering = false;
+  // frustum cull the static drawables for all sensors of a step at once,
+  // distributed over threads, before any of them is drawn, see
+  // gfx::Renderer::cullAhead()
+  bool parallelCulling = false;
+  // memory budget in bytes for keeping assets of previous scenes loaded, 0
+  // for no limit, see assets::ResourceManager::setSceneAssetCacheBudget()
+  size_t sceneAssetCacheBudget = 0;
+  // GPU memory budget in bytes for loaded assets, 0 for no limit, see
+  // assets::ResourceManager::setGpuMemoryBudget()
+  size_t gpuMemoryBudget = 0;
+  // bytes of scene mesh data uploaded per frame, 0 to upload meshes while the
+  // scene loads. Meshes are invisible until complete, see
+  // Simulator::uploadPendingMeshes()
+  size_t meshUploadBudget = 0;
+  // free the CPU copies of scene mesh data that only the upload needs, see
+  // assets::ResourceManager::releaseUploadData()
+  bool releaseMeshUploadData = false;
+  // scenes kept loaded with their scene graphs, navmesh, semantic scene and
+  // physics, so that reconfigure() back to one of them switches instead of
+  // loading, see Simulator::setActiveScene(). The least recently active are
+  // unloaded beyond this count or once the asset cache or GPU memory budget
+  // evicts their assets. 1 keeps none but the active scene
+  int maxResidentScenes = 1;
   bool enablePhysics = false;
+  // keep removed objects for reuse by the next addObject() of their
+  // template, see physics::PhysicsManager::setObjectPooling()
+  bool objectPooling = false;
   std::string physicsConfigFile =
       "./data/default.phys_scene_config.json";  // should we instead link a
                                                 // PhysicsManagerConfiguration
@@ -59,6 +193,106 @@ bool operator==(const SimulatorConfiguration& a,
 bool operator!=(const SimulatorConfiguration& a,
                 const SimulatorConfiguration& b);
 
+/**
+ * @brief Texture size limit matching the resolution of @p sensorSpecs
+ *
+ * A texture spanning a 90 degree field of view at the largest sensor
+ * resolution is sampled at about one texel per pixel, narrower fields of
+ * view magnify it accordingly. The result is rounded up to a power of two,
+ * 0 (no limit) if there are no color sensors.
+ */
+int maxTextureSizeForSensors(
+    const std::vector<sensor::SensorSpec::ptr>& sensorSpecs);
+
+/**
+ * @brief Observations of all sensors of an agent, indexed by sensor
+ *
+ * Sensors are in the order of the agent's @ref sensor::SensorSuite, which is
+ * sorted by uuid. Observations of sensors that produced none have neither a
+ * host nor a device buffer.
+ */
+struct AgentObservations {
+  std::vector<std::string> sensorUuids;
+  std::vector<sensor::Observation> observations;
+
+  ESP_SMART_POINTERS(AgentObservations)
+};
+
+/**
+ * @brief Observations of many agents, one contiguous tensor per sensor type
+ */
+struct BatchObservations {
+  struct Tensor {
+    /**
+     * @brief Observations stacked along a new first dimension, row @p i
+     * belongs to @ref sensors[i]
+     */
+    core::Buffer::ptr buffer;
+    /** @brief Agent id and sensor uuid of each row */
+    std::vector<std::pair<int, std::string>> sensors;
+    /**
+     * @brief Memory requested for @ref buffer, pinned if any of the sensors
+     * wants pinned observations
+     */
+    core::BufferStorage storage = core::BufferStorage::Aligned;
+  };
+
+  std::map<sensor::SensorType, Tensor> tensors;
+
+  ESP_SMART_POINTERS(BatchObservations)
+};
+
+/**
+ * @brief Sampling and visibility parameters of
+ * @ref Simulator::computeObjectViewpoints()
+ */
+struct ViewpointSettings {
+  /** @brief Spacing of the candidate grid around each object, in meters */
+  float spacing = 0.1f;
+  /**
+   * @brief Greatest horizontal distance of a viewpoint from the object's
+   * OBB, in meters
+   */
+  float maxDistance = 1.0f;
+  /**
+   * @brief Greatest height by which the navmesh under a viewpoint may differ
+   * from the bottom of the object, so objects on furniture find viewpoints
+   * on the floor
+   */
+  float maxYDelta = 1.5f;
+  /** @brief Height above the navmesh the visibility rays start at */
+  float sensorHeight = 1.25f;
+  /**
+   * @brief Fraction of the rays to the object that have to reach it for a
+   * viewpoint to count as seeing it
+   */
+  float minVisibleFraction = 0.1f;
+
+  ESP_SMART_POINTERS(ViewpointSettings)
+};
+
+/**
+ * @brief Viewpoints of one object of the semantic scene
+ */
+struct ObjectViewpoints {
+  /** @brief Index into @ref scene::SemanticScene::objects() */
+  int objectIndex = ID_UNDEFINED;
+  /** @brief Navmesh points the object is visible from */
+  std::vector<vec3f> viewpoints;
+  /** @brief Fraction of the rays that reached the object, per viewpoint */
+  std::vector<float> visibleFractions;
+
+  ESP_SMART_POINTERS(ObjectViewpoints)
+};
+
+/**
+ * @brief Simulator owning scenes, agents, physics and rendering
+ *
+ * Simulators share no mutable global state, so each can be driven from its
+ * own thread; the Python bindings release the GIL around rendering, physics
+ * stepping and navmesh queries to allow that. A single instance is not
+ * thread-safe and its GL context has to be current on the calling thread.
+ */
 class Simulator {
  public:
   explicit Simulator(const SimulatorConfiguration& cfg);
@@ -66,10 +300,80 @@ class Simulator {
 
   virtual void reconfigure(const SimulatorConfiguration& cfg);
 
+  /**
+   * @brief Start loading the scene of @p cfg in the background
+   *
+   * Loads the navmesh and parses the scene meshes and textures on worker
+   * threads, see @ref assets::ResourceManager::prefetchScene(). A later @ref
+   * reconfigure() to the same scene then only has to upload the meshes and
+   * textures, waiting for the workers if they aren't done yet. One navmesh is
+   * prefetched at a time; scene meshes can only be prefetched once the
+   * renderer exists.
+   * @return Whether anything is being prefetched
+   */
+  bool prefetchScene(const SimulatorConfiguration& cfg);
+
+  /**
+   * @brief Load the scene of @p cfg for all simulators of the process
+   *
+   * Loads the navmesh and the semantic scene and parses the scene meshes
+   * into process-wide storage, see @ref
+   * assets::ResourceManager::preloadScene(). Needs no GL context, so a
+   * parent process can preload the scenes once before forking the workers,
+   * which then inherit them copy-on-write. The first @ref reconfigure() to
+   * the same scene in each process takes the preloaded data instead of
+   * loading the files again. The process must not have any GL context when
+   * forking, see @ref gfx::WindowlessContext::liveCount().
+   * @return Whether the navmesh or scene meshes are preloaded
+   */
+  static bool preload(const SimulatorConfiguration& cfg);
+
+  /** @brief Drop everything loaded by @ref preload() */
+  static void clearPreloaded();
+
+  /**
+   * @brief Number of navmeshes, semantic scenes and scene assets loaded by
+   *    @ref preload() and not taken by a simulator of this process yet
+   */
+  static size_t preloadedCount();
+
+  /**
+   * @brief IDs of the scenes kept loaded, most recently active first
+   *
+   * The active scene comes first if it's resident, see
+   * @ref SimulatorConfiguration::maxResidentScenes.
+   */
+  std::vector<std::string> getResidentScenes() const;
+
+  /**
+   * @brief Make a resident scene the active one
+   * @return False if no scene with the ID @p sceneId is resident
+   *
+   * Swaps the scene graphs, navmesh, semantic scene, potentially visible set
+   * and physics of the active scene for those of @p sceneId in constant time.
+   * Agents and other nodes added to the scene graphs after loading move
+   * along with their poses and nothing is reset; the configuration becomes
+   * the one the scene was loaded with. A @ref reconfigure() to a resident
+   * scene does this followed by @ref reset().
+   */
+  bool setActiveScene(const std::string& sceneId);
+
   virtual void reset();
 
   virtual void seed(uint32_t newSeed);
 
+  /**
+   * @brief Independent random stream number @p stream of the current seed
+   *
+   * For sampling that has to be reproducible however it is parallelized,
+   * e.g. a stream per episode, split per thread with
+   * @ref core::CounterRandom::split(). Streams of the same seed and number
+   * are equal, @ref seed() changes all of them.
+   */
+  core::CounterRandom randomStream(uint64_t stream) const {
+    return core::CounterRandom{seed_, stream};
+  }
+
   std::shared_ptr<gfx::Renderer> getRenderer();
   std::shared_ptr<physics::PhysicsManager> getPhysicsManager();
   std::shared_ptr<scene::SemanticScene> getSemanticScene();
@@ -77,7 +381,34 @@ class Simulator {
   scene::SceneGraph& getActiveSceneGraph();
   scene::SceneGraph& getActiveSemanticSceneGraph();
 
-  void saveFrame(const std::string& filename);
+  /**
+   * @brief Save the observation of the default camera as an image
+   * @return Whether the default agent has a
+   *    @ref SimulatorConfiguration::defaultCameraUuid sensor with an image
+   *    observation
+   *
+   * Renders and copies the observation on the calling thread, encoding and
+   * writing are queued on @ref getImageWriter(). The format follows the
+   * extension of @p filename, see @ref gfx::ImageWriter.
+   */
+  bool saveFrame(const std::string& filename);
+
+  /**
+   * @brief Writer of @ref saveFrame(), a single-threaded one with default
+   *    settings unless set with @ref setImageWriter()
+   */
+  std::shared_ptr<gfx::ImageWriter> getImageWriter();
+
+  /**
+   * @brief Set the writer of @ref saveFrame()
+   *
+   * E.g. one with more threads or another JPEG quality, or one shared by
+   * many simulators. The previous writer finishes what it has queued once
+   * nobody references it anymore.
+   */
+  void setImageWriter(std::shared_ptr<gfx::ImageWriter> writer) {
+    imageWriter_ = std::move(writer);
+  }
 
   /**
    * @brief The ID of the CUDA device of the OpenGL context owned by the
@@ -151,6 +482,17 @@ class Simulator {
   int loadObjectTemplate(assets::PhysicsObjectAttributes::ptr objTmplPtr,
                          const std::string& objectTemplateHandle);
 
+  /**
+   * @brief Start loading the meshes of an object template in the background,
+   * see @ref assets::ResourceManager::prefetchObjectTemplate()
+   *
+   * Useful with @ref SimulatorConfiguration::lazyObjectTemplates, to hide the
+   * load of the templates an episode is about to add.
+   * @param templateId The index of the template.
+   * @return Whether any mesh is being prefetched.
+   */
+  bool prefetchObjectTemplate(int templateId);
+
   /**
    * @brief Remove an instanced object by ID. See @ref
    * esp::physics::PhysicsManager::removeObject().
@@ -201,6 +543,33 @@ class Simulator {
                            const int objectID,
                            const int sceneID = 0);
 
+  /**
+   * @brief Set whether an object takes part in collision detection while it
+   * is @ref esp::physics::MotionType::KINEMATIC. See @ref
+   * esp::physics::PhysicsManager::setObjectKinematicCollisions.
+   * @param enabled Whether kinematic collisions are enabled.
+   * @param objectID The ID of the object identifying it in @ref
+   * esp::physics::PhysicsManager::existingObjects_.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the object.
+   */
+  void setObjectKinematicCollisions(bool enabled,
+                                    const int objectID,
+                                    const int sceneID = 0);
+
+  /**
+   * @brief Get whether an object collides while it is @ref
+   * esp::physics::MotionType::KINEMATIC. See @ref
+   * esp::physics::PhysicsManager::getObjectKinematicCollisions.
+   * @param objectID The ID of the object identifying it in @ref
+   * esp::physics::PhysicsManager::existingObjects_.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the object.
+   * @return Whether kinematic collisions are enabled, false if no @ref
+   * esp::physics::PhysicsManager is initialized.
+   */
+  bool getObjectKinematicCollisions(const int objectID, const int sceneID = 0);
+
   /**@brief Retrieves a shared pointer to the VelocityControl struct for this
    * object.
    */
@@ -357,6 +726,89 @@ class Simulator {
    */
   Magnum::Vector3 getAngularVelocity(const int objectID, const int sceneID);
 
+  /**
+   * @brief Get the translations of several objects at once.
+   * See @ref esp::physics::PhysicsManager::getTranslations.
+   * @param objectIDs The object IDs, or empty for all objects in the order of
+   * @ref getExistingObjectIDs.
+   * @param[out] translations One translation per object, zero if no @ref
+   * esp::physics::PhysicsManager is initialized.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the objects.
+   */
+  void getTranslations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> translations,
+      const int sceneID = 0);
+
+  /**
+   * @brief Get the orientations of several objects at once.
+   * See @ref getTranslations.
+   */
+  void getRotations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Quaternion> rotations,
+      const int sceneID = 0);
+
+  /**
+   * @brief Get the linear velocities of several objects at once.
+   * See @ref getTranslations.
+   */
+  void getLinearVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> linVels,
+      const int sceneID = 0);
+
+  /**
+   * @brief Get the angular velocities of several objects at once.
+   * See @ref getTranslations.
+   */
+  void getAngularVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<Magnum::Vector3> angVels,
+      const int sceneID = 0);
+
+  /**
+   * @brief Set the translations of several objects at once.
+   * See @ref esp::physics::PhysicsManager::setTranslations.
+   * @param objectIDs The object IDs, or empty for all objects in the order of
+   * @ref getExistingObjectIDs.
+   * @param translations One translation per object.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the objects.
+   */
+  void setTranslations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> translations,
+      const int sceneID = 0);
+
+  /**
+   * @brief Set the orientations of several objects at once.
+   * See @ref setTranslations.
+   */
+  void setRotations(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Quaternion> rotations,
+      const int sceneID = 0);
+
+  /**
+   * @brief Set the linear velocities of several objects at once.
+   * See @ref setTranslations.
+   */
+  void setLinearVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> linVels,
+      const int sceneID = 0);
+
+  /**
+   * @brief Set the angular velocities of several objects at once.
+   * See @ref setTranslations.
+   */
+  void setAngularVelocities(
+      Corrade::Containers::ArrayView<const int> objectIDs,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> angVels,
+      const int sceneID = 0);
+
   /**
    * @brief Discrete collision check for contact between an object and the
    * collision world.
@@ -369,6 +821,39 @@ class Simulator {
    */
   bool contactTest(const int objectID, const int sceneID = 0);
 
+  /**
+   * @brief Discrete collision check for several objects at once. See @ref
+   * esp::physics::PhysicsManager::contactTests.
+   * @param objectIDs The object IDs, or empty for all objects in the order of
+   * @ref getExistingObjectIDs.
+   * @param[out] results Whether each object is in contact with any other
+   * collision enabled objects, false if no @ref esp::physics::PhysicsManager
+   * is initialized.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the objects.
+   */
+  void contactTests(Corrade::Containers::ArrayView<const int> objectIDs,
+                    Corrade::Containers::ArrayView<bool> results,
+                    const int sceneID = 0);
+
+  /**
+   * @brief Cast several rays against the collision world. See @ref
+   * esp::physics::PhysicsManager::castRays.
+   * @param origins Start points of the rays.
+   * @param directions Directions of the rays.
+   * @param maxDistance Length of the rays.
+   * @param[out] hits The closest hit of each ray, nothing is hit if no @ref
+   * esp::physics::PhysicsManager is initialized.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * query.
+   */
+  void castRays(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      float maxDistance,
+      Corrade::Containers::ArrayView<physics::RayHit> hits,
+      const int sceneID = 0);
+
   /**
    * @brief the physical world has a notion of time which passes during
    * animation/simulation/action/etc... Step the physical world forward in time
@@ -382,6 +867,116 @@ class Simulator {
    */
   double stepWorld(const double dt = 1.0 / 60.0);
 
+  /**
+   * @brief Step the physical world forward by exactly @p numSubSteps fixed
+   * timesteps. See @ref esp::physics::PhysicsManager::stepPhysicsSubSteps.
+   * @param numSubSteps The number of fixed timesteps to take.
+   * @return The new world time after stepping.
+   */
+  double stepWorldSubSteps(int numSubSteps);
+
+  /**
+   * @brief Set the fixed timestep of a physical scene. See @ref
+   * esp::physics::PhysicsManager::setTimestep.
+   */
+  void setPhysicsTimestep(double dt, const int sceneID = 0);
+
+  /**
+   * @brief Get the fixed timestep of a physical scene, 0 if no @ref
+   * esp::physics::PhysicsManager is initialized.
+   */
+  double getPhysicsTimestep(const int sceneID = 0);
+
+  /**
+   * @brief Set the maximum number of fixed timesteps taken by one @ref
+   * stepWorld call. See @ref esp::physics::PhysicsManager::setMaxSubSteps.
+   */
+  void setPhysicsMaxSubSteps(int maxSubSteps, const int sceneID = 0);
+
+  /**
+   * @brief Get the maximum number of fixed timesteps taken by one @ref
+   * stepWorld call, 0 if no @ref esp::physics::PhysicsManager is initialized.
+   */
+  int getPhysicsMaxSubSteps(const int sceneID = 0);
+
+  /**
+   * @brief Step the physical worlds of several simulators concurrently
+   *
+   * Equivalent to calling @ref stepWorld() on each of @p simulators, with
+   * the worlds distributed over worker threads by
+   * @ref esp::physics::PhysicsManager::stepWorlds(). Simulators without
+   * physics are skipped.
+   * @param simulators Distinct simulators, none of them may be used from
+   * other threads until this function returns.
+   * @param dt The desired amount of time to advance each physical world.
+   */
+  static void stepWorlds(const std::vector<Simulator*>& simulators,
+                         const double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Capture the state of all objects in a physical scene. See @ref
+   * esp::physics::PhysicsManager::saveState.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * query.
+   * @return The snapshot, empty if no @ref esp::physics::PhysicsManager is
+   * initialized.
+   */
+  physics::PhysicsState savePhysicsState(const int sceneID = 0);
+
+  /**
+   * @brief Return a physical scene to a snapshot made by @ref
+   * savePhysicsState. See @ref esp::physics::PhysicsManager::restoreState.
+   * @param state The snapshot.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * modify.
+   * @return Whether the snapshot was applied.
+   */
+  bool restorePhysicsState(const physics::PhysicsState& state,
+                           const int sceneID = 0);
+
+  /**
+   * @brief Snapshot the current state in memory
+   *
+   * Captures the poses of all agents and their sensors, the physical world
+   * including its set of objects, see @ref physics::PhysicsManager::saveState,
+   * and the state of the random generators. Restoring it with @ref restore()
+   * loads no assets, so planners can branch off it cheaply.
+   */
+  SimulatorCheckpoint checkpoint();
+
+  /**
+   * @brief Return to a snapshot made by @ref checkpoint()
+   * @return False if it's from another scene or another set of agents and
+   *      sensors, in which case nothing changed, or if its objects can't be
+   *      recreated, see @ref physics::PhysicsManager::restoreState(const
+   *      physics::PhysicsState&, DrawableGroup*)
+   *
+   * Objects added since the snapshot are removed and objects removed since
+   * are added again, under their old IDs. Enabling
+   * @ref SimulatorConfiguration::objectPooling makes that cheap.
+   */
+  bool restore(const SimulatorCheckpoint& checkpoint);
+
+  /**
+   * @brief Get the object counts of the last physics step. See @ref
+   * esp::physics::PhysicsManager::getStepStatistics.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * query.
+   * @return The counts, all zero if no @ref esp::physics::PhysicsManager is
+   * initialized.
+   */
+  physics::StepStatistics getPhysicsStepStatistics(const int sceneID = 0);
+
+  /**
+   * @brief Get the number of removed objects waiting for reuse. See @ref
+   * esp::physics::PhysicsManager::setObjectPooling.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * query.
+   * @return The count, 0 if no @ref esp::physics::PhysicsManager is
+   * initialized.
+   */
+  int getNumPooledObjects(const int sceneID = 0);
+
   /**
    * @brief Get the current time in the simulated world. This is always 0 if no
    * @ref esp::physics::PhysicsManager is initialized. See @ref stepWorld. See
@@ -401,6 +996,41 @@ class Simulator {
    */
   Magnum::Vector3 getGravity(const int sceneID = 0) const;
 
+  /**
+   * @brief Find the navigable viewpoints each object of the semantic scene
+   * is visible from
+   *
+   * Candidates on a grid around each object's OBB are snapped to the
+   * navmesh and kept if snapping moves them only vertically. From each
+   * candidate, rays at @ref ViewpointSettings::sensorHeight go to the
+   * center and the half-way corners of the OBB, batched into one
+   * @ref castRays() for all objects. A ray reaches the object if it hits
+   * nothing before the target or hits inside the OBB. Without physics
+   * nothing occludes. Objects without viewpoints are left out of the
+   * result, which is in the order of @ref scene::SemanticScene::objects().
+   */
+  std::vector<ObjectViewpoints> computeObjectViewpoints(
+      const ViewpointSettings& settings = {});
+
+  /**
+   * @brief Occupancy of the active scene's collision mesh in voxels of
+   * @p voxelSize meters, without objects
+   *
+   * Voxelized on first use and cached for the scene and voxel size, see
+   * @ref assets::ResourceManager::getOccupancyGrid().
+   */
+  const geo::OccupancyGrid& getOccupancyGrid(float voxelSize);
+
+  /**
+   * @brief Ray caster over the active scene's collision mesh, without
+   * objects, carrying the instance mesh object IDs if the scene has them
+   *
+   * Built on first use and cached for the scene, see
+   * @ref assets::ResourceManager::getMeshRayCaster(). Used by
+   * @ref sensor::RayCastCamera.
+   */
+  const geo::MeshRayCaster& getMeshRayCaster();
+
   /**
    * @brief Compute the navmesh for the simulator's current active scene and
    * assign it to the referenced @ref nav::PathFinder.
@@ -408,7 +1038,13 @@ class Simulator {
    * will be assigned.
    * @param navMeshSettings The @ref nav::NavMeshSettings instance to
    * parameterize the navmesh construction.
+   * @param includeStaticObjects Whether to bake STATIC objects into the
+   * navmesh.
    * @return Whether or not the navmesh recomputation succeeded.
+   *
+   * With @ref nav::NavMeshSettings::tileSize set, repeated calls for the same
+   * @p pathfinder and settings only rebuild the tiles around STATIC objects
+   * that were added, removed or moved since the previous call.
    */
   bool recomputeNavMesh(nav::PathFinder& pathfinder,
                         const nav::NavMeshSettings& navMeshSettings,
@@ -416,10 +1052,80 @@ class Simulator {
 
   agent::Agent::ptr getAgent(int agentId);
 
+  /** @brief Number of agents, IDs of @ref getAgent() go from 0 below it */
+  int getNumAgents() const { return int(agents_.size()); }
+
   agent::Agent::ptr addAgent(const agent::AgentConfiguration& agentConfig,
                              scene::SceneNode& agentParentNode);
   agent::Agent::ptr addAgent(const agent::AgentConfiguration& agentConfig);
 
+  /**
+   * @brief Read the poses of many agents in one call
+   * @param agentIds   Agents to read
+   * @param positions  Filled with three floats per agent, the absolute
+   *      position
+   * @param rotations  Filled with four floats per agent, the rotation as
+   *      quaternion coefficients x, y, z, w like @ref agent::AgentState
+   * @return False, leaving the poses of the remaining agents unset, if an id
+   *      doesn't exist
+   */
+  bool getAgentStates(const std::vector<int>& agentIds,
+                      Corrade::Containers::ArrayView<float> positions,
+                      Corrade::Containers::ArrayView<float> rotations);
+
+  /**
+   * @brief Move many agents in one call
+   * @param agentIds      Agents to move
+   * @param positions     Three floats per agent
+   * @param rotations     Four floats per agent, quaternion coefficients x, y,
+   *      z, w like @ref agent::AgentState
+   * @param resetSensors  Whether the sensors go back to their specified
+   *      poses, lazily once they are next used, see
+   *      @ref agent::Agent::setState()
+   * @return False if an id doesn't exist or a rotation isn't normalized
+   *      within @cpp 1e-3 @ce, those agents are skipped
+   *
+   * Rotations within the tolerance are renormalized.
+   */
+  bool setAgentStates(const std::vector<int>& agentIds,
+                      Corrade::Containers::ArrayView<const float> positions,
+                      Corrade::Containers::ArrayView<const float> rotations,
+                      bool resetSensors = true);
+
+  /**
+   * @brief Render sensors of an agent from many agent poses into
+   *    preallocated tensors
+   * @param agentId     Agent to move
+   * @param positions   Three floats per pose
+   * @param rotations   Four floats per pose, quaternion coefficients x, y,
+   *      z, w like @ref agent::AgentState
+   * @param sensorIds   Pinhole sensors of the agent to render
+   * @param outputs     One per sensor, as many observations of the sensor
+   *      as there are poses, row @p i seen from pose @p i
+   * @param sortPoses   Whether to draw the poses in an order that keeps
+   *      consecutive draws close in space and heading, so they see mostly
+   *      the same drawables
+   * @return False, rendering nothing, if a sensor isn't a pinhole sensor
+   *      with a render target, an output doesn't fit its poses or the
+   *      rotations aren't normalized within @cpp 1e-3 @ce
+   *
+   * Equivalent to @ref setAgentStates() and @ref getAgentObservations() for
+   * every pose, without returning to the caller in between. The sensors keep
+   * their pose relative to the agent. The read of a pose is queued and only
+   * retrieved once the next pose is drawn, so reading back overlaps drawing;
+   * sensors sharing a render target and @ref
+   * sensor::ObservationLayout::SEMANTIC_HISTOGRAM sensors are read right
+   * away. Sensor noise models aren't applied. The agent goes back to its
+   * pose afterwards.
+   */
+  bool renderAgentPoses(
+      int agentId,
+      Corrade::Containers::ArrayView<const float> positions,
+      Corrade::Containers::ArrayView<const float> rotations,
+      const std::vector<std::string>& sensorIds,
+      const std::vector<Corrade::Containers::ArrayView<uint8_t>>& outputs,
+      bool sortPoses = true);
+
   /**
    * @brief Displays observations on default frame buffer for a
    * particular sensor of an agent
@@ -436,6 +1142,134 @@ class Simulator {
       int agentId,
       std::map<std::string, sensor::Observation>& observations);
 
+  /**
+   * @brief Render and read back the observations of all sensors of an agent
+   *
+   * Like @ref getAgentObservations(), but fills @p observations in place so
+   * that its storage is reused from the previous call.
+   */
+  void getAgentObservations(int agentId, AgentObservations& observations);
+
+  /**
+   * @brief Draw the sensors that can share a pass over the drawables
+   * @param sensors   Sensors to draw
+   * @return Whether each sensor in @p sensors was drawn
+   *
+   * Pinhole sensors that see the same scene graph with the same resolution
+   * and projection are drawn together into their render targets, ready to
+   * be read back, see @ref gfx::Renderer::drawMultiView(). Sensors that
+   * can't be drawn with another one are left to their own
+   * @ref sensor::PinholeCamera::drawObservation().
+   * Used by @ref getAgentObservations(), @ref step() and
+   * @ref writeObservations() with
+   * @ref SimulatorConfiguration::multiViewRendering.
+   */
+  std::vector<bool> drawMultiView(
+      const std::vector<sensor::VisualSensor*>& sensors);
+
+  /**
+   * @brief Frustum cull the static drawables for the next draw of each
+   * sensor, distributed over threads
+   *
+   * See @ref gfx::Renderer::cullAhead(). Does nothing without frustum
+   * culling. Used by @ref getAgentObservations(), @ref step() and
+   * @ref writeObservations() with
+   * @ref SimulatorConfiguration::parallelCulling.
+   */
+  void cullAhead(const std::vector<sensor::VisualSensor*>& sensors);
+
+  /**
+   * @brief Upload the next part of the scene meshes loaded with
+   * @ref SimulatorConfiguration::meshUploadBudget
+   * @return Number of bytes uploaded
+   *
+   * Uploads up to @ref SimulatorConfiguration::meshUploadBudget bytes, or
+   * everything left if it's 0, see
+   * @ref assets::ResourceManager::uploadPendingMeshes(). Called before every
+   * frame by @ref getAgentObservations(), @ref step() and
+   * @ref writeObservations(), so a scene switch spreads its uploads over the
+   * first frames of the new scene.
+   */
+  size_t uploadPendingMeshes();
+
+  /** @brief Whether scene meshes are left for @ref uploadPendingMeshes() */
+  bool hasPendingMeshUploads() const {
+    return resourceManager_.hasPendingMeshUploads();
+  }
+
+  /**
+   * @brief Act, step physics and observe in one call
+   * @param agentId     Id of the agent taking the action
+   * @param actionName  Action from the agent's action space, ignored if it
+   *                    has no such action
+   * @param dt          Time to advance the physical world by, see
+   *                    @ref stepWorld()
+   * @return Observations of all sensors of the agent. The storage belongs to
+   *      the simulator and is overwritten by the next step of the same agent.
+   *
+   * Equivalent to @ref agent::Agent::act(), @ref stepWorld() and @ref
+   * getAgentObservations() but without the per-step string-keyed map. With
+   * @ref isPipelinedStepping() the observations are those of the previous
+   * step.
+   */
+  const AgentObservations& step(int agentId,
+                                const std::string& actionName,
+                                double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Act for many agents, step physics once and observe all of them
+   * @param actions   Agent id and action name pairs, see @ref step()
+   * @param dt        Time to advance the physical world by
+   * @return One tensor per sensor type, stacking the observations of all
+   *      pinhole cameras of the acting agents. The storage belongs to the
+   *      simulator and is overwritten by the next batched step.
+   *
+   * Moves of all agents are filtered through the navmesh in one batched
+   * @ref nav::PathFinder::trySteps() call. Sensors of all agents are drawn
+   * back to back, and sensors sharing a view are drawn once. Sensors of one
+   * type must have the same resolution and channel count to be stacked;
+   * mismatching ones, sensors without a render target and sensors with
+   * @ref sensor::SensorSpec::gpu2gpuTransfer are skipped. With
+   * @ref isPipelinedStepping() the observations are those of the previous
+   * step.
+   */
+  const BatchObservations& step(
+      const std::vector<std::pair<int, std::string>>& actions,
+      double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Act for many agents and step physics once, without observing
+   *
+   * The first half of @ref step(const std::vector<std::pair<int,
+   * std::string>>&, double). Doesn't touch the GL context, so simulators
+   * sharing one can do this concurrently, see @ref BatchedSimulator.
+   */
+  void stepAgents(const std::vector<std::pair<int, std::string>>& actions,
+                  double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Bytes a slot of @ref core::SharedMemoryRing needs for the
+   * observations of an agent, see @ref writeObservations()
+   */
+  size_t getObservationsByteSize(int agentId);
+
+  /**
+   * @brief Draw the pinhole cameras of an agent straight into the next slot
+   * of a shared-memory ring
+   * @return Sequence number of the slot, 0 if the ring is full, its slots
+   *      are too small or the agent doesn't exist
+   *
+   * For handing observations to a trainer in another process: the cameras
+   * read back into the shared memory, so neither process copies a frame. The
+   * observations are placed in the order of the sensor uuids, each aligned
+   * to 64 bytes, and the slot layout is a JSON list of
+   * @cpp {"uuid": ..., "offset": ..., "shape": [...], "dtype": ...} @ce
+   * objects, the data type named like in numpy. Sensors without a render
+   * target and sensors with @ref sensor::SensorSpec::gpu2gpuTransfer are
+   * skipped. All cameras are drawn regardless of their update interval.
+   */
+  uint64_t writeObservations(int agentId, core::SharedMemoryRing& ring);
+
   bool getAgentObservationSpace(int agentId,
                                 const std::string& sensorId,
                                 sensor::ObservationSpace& space);
@@ -444,6 +1278,17 @@ class Simulator {
       std::map<std::string, sensor::ObservationSpace>& spaces);
 
   nav::PathFinder::ptr getPathFinder();
+
+  /**
+   * @brief Load a navmesh ahead of its scene
+   *
+   * Agents added afterwards navigate on it and the active scene keeps it, so
+   * navigation works while the scene mesh is still being downloaded, as in
+   * the streaming web viewer. A later @ref reconfigure() to the scene of
+   * @p navmeshFilename reuses it instead of loading it again.
+   * @return Whether the navmesh was loaded
+   */
+  bool loadNavMesh(const std::string& navmeshFilename);
   /**
    * @brief Enable or disable frustum culling (enabled by default)
    * @param val, true = enable, false = disable
@@ -456,6 +1301,157 @@ class Simulator {
    */
   bool isFrustumCullingEnabled() { return frustumCulling_; }
 
+  /**
+   * @brief Set the largest on-screen error of mesh levels of detail on the
+   * render cameras of all loaded scenes
+   * @param pixels Error in pixels, 0 always draws the full meshes. See @ref
+   * SimulatorConfiguration::meshLodPixelError.
+   */
+  void setLevelOfDetailPixelError(float pixels);
+
+  /**
+   * @brief Hit, miss and eviction statistics of the scene asset cache, see
+   * @ref SimulatorConfiguration::sceneAssetCacheBudget
+   */
+  assets::ResourceManager::SceneAssetCacheStats getSceneAssetCacheStats()
+      const {
+    return resourceManager_.sceneAssetCacheStats();
+  }
+
+  /**
+   * @brief Time spent in each stage of the last scene load, see
+   * @ref reconfigure()
+   */
+  const assets::SceneLoadStatistics& getSceneLoadStatistics() const {
+    return resourceManager_.sceneLoadStatistics();
+  }
+
+  /**
+   * @brief GPU memory used by the loaded assets, see
+   * @ref SimulatorConfiguration::gpuMemoryBudget
+   */
+  assets::ResourceManager::GpuMemoryUsage getGpuMemoryUsage() const {
+    return resourceManager_.gpuMemoryUsage();
+  }
+
+  /**
+   * @brief Enable or disable pipelined stepping (disabled by default)
+   *
+   * In pipelined mode, @ref step() queues the readback of the frame it just
+   * drew and returns the observations of the previous step, which are ready
+   * by then. The GPU draws and reads back step N while the CPU applies the
+   * actions and steps physics of step N+1, instead of each waiting for the
+   * other. The first pipelined step waits for its own frame. Only
+   * @ref step() is affected, @ref getAgentObservations() always returns the
+   * current frame.
+   */
+  void setPipelinedStepping(bool enabled) { pipelinedStepping_ = enabled; }
+
+  /**
+   * @brief Whether @ref step() returns observations one step late
+   */
+  bool isPipelinedStepping() const { return pipelinedStepping_; }
+
+  /**
+   * @brief Start recording a @ref Trajectory
+   *
+   * Every @ref step() from now on appends a frame with its actions and the
+   * poses of all agents, their sensors and all physics objects after the
+   * step. A previous recording is discarded.
+   */
+  void startRecording();
+
+  /** @brief Stop recording and return what was recorded */
+  Trajectory stopRecording();
+
+  /** @brief Whether @ref step() records frames */
+  bool isRecording() const { return recording_; }
+
+  /**
+   * @brief Append the current world to the recording
+   * @param actions   Agent id and action name pairs taken since the last
+   *      frame
+   *
+   * Called by @ref step(), for stepping done elsewhere. Does nothing if not
+   * recording.
+   */
+  void recordFrame(const std::vector<std::pair<int, std::string>>& actions);
+
+  /**
+   * @brief Put the world in frame @p index of @p trajectory
+   * @return False if there's no such frame or it has agents, sensors or
+   *      objects this simulator doesn't have, which are skipped
+   *
+   * Sets the recorded poses, without acting or stepping physics, so
+   * re-evaluating a recorded run costs only the rendering, or nothing with
+   * @ref setReplayObservationCacheCapacity().
+   */
+  bool setReplayFrame(const Trajectory& trajectory, size_t index);
+
+  /**
+   * @brief Keep the observations of replayed frames
+   * @param capacity  Observations kept at most, the oldest are evicted
+   *      first. 0, the default, disables and clears the cache.
+   *
+   * Observations are keyed by the @ref Trajectory::poseHash() of the frame
+   * and the agent, so a world state is rendered once however often and from
+   * whichever trajectory it's replayed. A hit also has to have the same
+   * poses and active scene. Cached observations are copies, so they cost
+   * host memory. The cache is cleared by @ref reset(), @ref reconfigure(),
+   * @ref setActiveScene() and @ref invalidateObservationCache().
+   */
+  void setReplayObservationCacheCapacity(size_t capacity);
+
+  /**
+   * @brief Observations of an agent in the frame of @ref setReplayFrame()
+   *
+   * Served from the replay observation cache if enabled, rendered
+   * otherwise. The storage belongs to the simulator and is valid until the
+   * next call.
+   */
+  const AgentObservations& getReplayObservations(int agentId);
+
+  /**
+   * @brief Cache the observations of @ref getAgentObservations() by pose
+   * @param maxByteSize         Bytes of observations kept at most, the least
+   *      recently used are evicted first. 0, the default, disables and
+   *      clears the cache.
+   * @param positionResolution  Sensor positions within this many meters of
+   *      each other hit the same entry
+   * @param rotationResolution  Sensor orientations whose axes differ by less
+   *      than this, roughly in radians, hit the same entry
+   *
+   * Observations are keyed by the agent, the quantized absolute poses of its
+   * sensors and the scene state: the scene graph structure, the poses of
+   * the other agents and of all physics objects. A hit returns the cached
+   * buffers without rendering, so agents that revisit poses, like
+   * discrete-action agents on a grid, skip a share of their renders. The
+   * cache is cleared by @ref reset() and @ref reconfigure(); call
+   * @ref invalidateObservationCache() after changing the scene in other
+   * ways, e.g. lights. Agents with sensors that skip updates or transfer to
+   * the GPU are never cached.
+   */
+  void setObservationCache(size_t maxByteSize,
+                           float positionResolution = 0.001f,
+                           float rotationResolution = 0.001f);
+
+  /**
+   * @brief Hit, miss and eviction statistics of the observation cache, see
+   * @ref setObservationCache()
+   */
+  ObservationCache::Stats getObservationCacheStats() const {
+    return observationCache_.stats();
+  }
+
+  /**
+   * @brief Drop all observations cached by @ref setObservationCache() and
+   *    @ref setReplayObservationCacheCapacity()
+   */
+  void invalidateObservationCache() {
+    observationCache_.clear();
+    clearReplayObservationCache();
+  }
+
   /**
    * @brief Get a named @ref LightSetup
    */
@@ -494,6 +1490,88 @@ class Simulator {
   //! sample a random valid AgentState in passed agentState
   void sampleRandomAgentState(agent::AgentState& agentState);
 
+  //! apply SimulatorConfiguration::shareRenderTargets,
+  //! SimulatorConfiguration::occlusionCulling and
+  //! SimulatorConfiguration::potentiallyVisibleSets to the renderer and the
+  //! active scene graph
+  void configureRenderer();
+
+  // everything reconfigure() loaded for a scene kept by
+  // SimulatorConfiguration::maxResidentScenes
+  struct ResidentScene {
+    SimulatorConfiguration config;
+    int sceneID;
+    int semanticSceneID;
+    // children of the root nodes created by loading, any other node is
+    // moved along to the next active scene
+    std::vector<scene::SceneNode*> sceneNodes;
+    // scene assets the graphs draw, the scene is unloaded once one of them
+    // was evicted
+    std::vector<std::string> assetFilenames;
+    nav::PathFinder::ptr pathfinder;
+    std::string navmeshFilename;
+    std::shared_ptr<scene::SemanticScene> semanticScene;
+    std::string semanticSceneKey;
+    gfx::PotentiallyVisibleSet::ptr potentiallyVisibleSet;
+    std::string pvsFilename;
+    std::shared_ptr<physics::PhysicsManager> physicsManager;
+  };
+
+  //! the entry of the active scene in residentScenes_, nullptr if it isn't
+  //! resident
+  ResidentScene* activeResidentScene();
+
+  //! keep the active scene's navmesh, semantics and physics in its entry
+  void storeActiveScene();
+
+  //! move the nodes added to the scene graphs of @p scene since they were
+  //! loaded to the root of @p sceneID
+  void moveRuntimeNodes(const ResidentScene& scene, int sceneID);
+
+  //! switch to the resident scene @p cfg describes, false if there's none
+  bool switchToResidentScene(const SimulatorConfiguration& cfg);
+
+  //! make *scene the active scene and the most recently active entry
+  void activateResidentScene(std::list<ResidentScene>::iterator scene);
+
+  //! unload the least recently active scenes beyond maxResidentScenes and
+  //! those whose assets were evicted
+  void evictResidentScenes();
+
+  //! drop the observations of replayed frames, keeping the capacity
+  void clearReplayObservationCache();
+
+  //! key of the observations of an agent in observationCache_, 0 if its
+  //! observations can't be cached
+  uint64_t observationCacheKey(int agentId, const agent::Agent& agent);
+
+  //! getAgentObservations(), overriding the readback mode of the sensors
+  void readAgentObservations(
+      int agentId,
+      AgentObservations& observations,
+      Corrade::Containers::Optional<sensor::ReadbackMode> readbackMode);
+
+  //! with SimulatorConfiguration::multiViewRendering, draw the first
+  //! sensors of the groups of gfx::Renderer::groupEntriesByView() that can
+  //! share a pass, see drawMultiView(). Whether each group was drawn
+  std::vector<bool> drawMultiViewGroups(
+      const std::vector<std::vector<gfx::Renderer::BatchEntry>>& groups);
+
+  //! with SimulatorConfiguration::parallelCulling, cull ahead for the first
+  //! sensors of the groups that weren't @p drawn, see cullAhead()
+  void cullAheadGroups(
+      const std::vector<std::vector<gfx::Renderer::BatchEntry>>& groups,
+      const std::vector<bool>& drawn);
+
+  //! readback mode of step(), NullOpt if the sensors' own modes are used
+  Corrade::Containers::Optional<sensor::ReadbackMode> stepReadbackMode()
+      const {
+    if (pipelinedStepping_) {
+      return sensor::ReadbackMode::PreviousFrame;
+    }
+    return Corrade::Containers::NullOpt;
+  }
+
   bool isValidScene(int sceneID) const {
     return sceneID >= 0 && sceneID < sceneID_.size();
   }
@@ -502,7 +1580,9 @@ class Simulator {
     return isValidScene(sceneID) && physicsManager_ != nullptr;
   }
 
-  gfx::WindowlessContext::uptr context_ = nullptr;
+  // shared with the other simulators of the device if config_.contextPool,
+  // in a share group with them if config_.shareContext
+  gfx::WindowlessContext::ptr context_ = nullptr;
   std::shared_ptr<gfx::Renderer> renderer_ = nullptr;
   // CANNOT make the specification of resourceManager_ above the context_!
   // Because when deconstructing the resourceManager_, it needs
@@ -516,16 +1596,80 @@ class Simulator {
   int activeSceneID_ = ID_UNDEFINED;
   int activeSemanticSceneID_ = ID_UNDEFINED;
   std::vector<int> sceneID_;
+  // most recently active first, see SimulatorConfiguration::maxResidentScenes
+  std::list<ResidentScene> residentScenes_;
 
   std::shared_ptr<scene::SemanticScene> semanticScene_ = nullptr;
 
   std::shared_ptr<physics::PhysicsManager> physicsManager_ = nullptr;
 
   core::Random random_;
+  // seed of the random streams, a random one until seed() is called
+  uint32_t seed_ = std::random_device{}();
   SimulatorConfiguration config_;
 
   std::vector<agent::Agent::ptr> agents_;
+  // reused by step(), indexed by agent id
+  std::vector<AgentObservations> agentObservations_;
+  // reused by the batched step()
+  BatchObservations batchObservations_;
+  // filtered agent moves of the batched step(), storage reused
+  scene::FilteredMoveBatch moveBatch_;
+  bool pipelinedStepping_ = false;
+  bool recording_ = false;
+  Trajectory recordedTrajectory_;
+  // replay observation cache, keyed by pose hash and agent, oldest first.
+  // Entries keep the poses and scene they were rendered from, a hit has to
+  // match them and not only the hash
+  struct ReplayCacheEntry {
+    int agentId;
+    std::string sceneId;
+    Trajectory::Frame poses;
+    AgentObservations observations;
+  };
+  Trajectory::Frame replayFrame_;
+  uint64_t replayPoseHash_ = 0;
+  size_t replayCacheCapacity_ = 0;
+  std::unordered_map<uint64_t, ReplayCacheEntry> replayCache_;
+  std::deque<uint64_t> replayCacheOrder_;
+  AgentObservations replayObservations_;
+  // observation cache of getAgentObservations(), keyed by
+  // observationCacheKey()
+  ObservationCache observationCache_;
+
+  // encodes the images of saveFrame(), created on first use
+  std::shared_ptr<gfx::ImageWriter> imageWriter_;
+  float observationCachePositionResolution_ = 0.001f;
+  float observationCacheRotationResolution_ = 0.001f;
   nav::PathFinder::ptr pathfinder_;
+  // what pathfinder_ and semanticScene_ were loaded from, so reconfigure()
+  // doesn't load them again for the same files
+  std::string loadedNavmeshFilename_;
+  // potentially visible set of the active scene, if enabled and found, and
+  // the file it was loaded from
+  gfx::PotentiallyVisibleSet::ptr potentiallyVisibleSet_;
+  std::string loadedPvsFilename_;
+  // navmesh being loaded by prefetchScene()
+  std::string prefetchedNavmeshFilename_;
+  std::future<nav::PathFinder::ptr> prefetchedPathfinder_;
+  // static objects baked into the navmesh of navMeshObjectsPathfinder_ by
+  // the last recomputeNavMesh(), so the next one can rebuild only the tiles
+  // around objects that changed
+  struct NavMeshObject {
+    int objectID;
+    std::string meshHandle;
+    Magnum::Matrix4 transformation;
+    Magnum::Vector3 scale;
+    std::pair<vec3f, vec3f> bounds;
+
+    bool operator==(const NavMeshObject& other) const {
+      return objectID == other.objectID && meshHandle == other.meshHandle &&
+             transformation == other.transformation && scale == other.scale;
+    }
+  };
+  const nav::PathFinder* navMeshObjectsPathfinder_ = nullptr;
+  std::vector<NavMeshObject> navMeshObjects_;
+  std::string loadedSemanticSceneKey_;
   // state indicating frustum culling is enabled or not
   //
   // TODO:
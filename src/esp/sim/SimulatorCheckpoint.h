@@ -0,0 +1,48 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Struct @ref esp::sim::SimulatorCheckpoint
+ */
+
+#include <string>
+#include <vector>
+
+#include "esp/core/esp.h"
+#include "esp/core/random.h"
+#include "esp/physics/PhysicsManager.h"
+#include "esp/sim/Trajectory.h"
+
+namespace esp {
+namespace sim {
+
+/**
+@brief In-memory snapshot of the state a step changes
+
+Made by @ref Simulator::checkpoint() and applied with
+@ref Simulator::restore(), as many times as needed, so search-based planners
+can branch off a state instead of replaying the actions leading to it. Holds
+plain data only and no assets, copying it is a few allocations.
+*/
+struct SimulatorCheckpoint {
+  /** @brief ID of the scene the snapshot was taken in */
+  std::string sceneId;
+  /** @brief Poses of all agents and their sensors, by agent ID */
+  std::vector<Trajectory::AgentPose> agents;
+  /** @brief Whether there was a physical world */
+  bool hasPhysics = false;
+  /** @brief Objects and their simulated state, if @ref hasPhysics */
+  physics::PhysicsState physics;
+  /** @brief Generator of the simulator, e.g. for random agent states */
+  core::Random random{0};
+  /** @brief Generator of the pathfinder, for random navigable points */
+  core::Random pathfinderRandom{0};
+
+  ESP_SMART_POINTERS(SimulatorCheckpoint)
+};
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,264 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/core/logging.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sim {
+
+namespace {
+
+// "ESPTRAJ" and a version, bumped whenever the layout below changes. All
+// values are stored in native byte order.
+constexpr char Magic[8] = {'E', 'S', 'P', 'T', 'R', 'A', 'J', '\0'};
+constexpr uint32_t Version = 1;
+
+struct Writer {
+  std::string out;
+
+  template <class T>
+  void write(const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void write(const Trajectory::Pose& pose) {
+    write(pose.translation);
+    write(pose.rotation.vector());
+    write(pose.rotation.scalar());
+  }
+};
+
+struct Reader {
+  const char* data;
+  std::size_t size;
+  std::size_t offset = 0;
+  bool failed = false;
+
+  template <class T>
+  T read() {
+    T value{};
+    if (size - offset < sizeof(T)) {
+      failed = true;
+      offset = size;
+      return value;
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+  }
+
+  Trajectory::Pose readPose() {
+    Trajectory::Pose pose;
+    pose.translation = read<Magnum::Vector3>();
+    const Magnum::Vector3 vector = read<Magnum::Vector3>();
+    pose.rotation = Magnum::Quaternion{vector, read<float>()};
+    return pose;
+  }
+
+  // a count of items of at least itemSize bytes each, checked against the
+  // remaining data so a corrupt file can't make us allocate gigabytes
+  uint32_t readCount(std::size_t itemSize) {
+    const uint32_t count = read<uint32_t>();
+    if (uint64_t(count) * itemSize > size - offset) {
+      failed = true;
+      offset = size;
+      return 0;
+    }
+    return count;
+  }
+};
+
+// FNV-1a
+void hashBytes(uint64_t& hash, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+}
+
+void hashPose(uint64_t& hash, const Trajectory::Pose& pose) {
+  hashBytes(hash, pose.translation.data(), sizeof(Magnum::Vector3));
+  hashBytes(hash, pose.rotation.vector().data(), sizeof(Magnum::Vector3));
+  const float scalar = pose.rotation.scalar();
+  hashBytes(hash, &scalar, sizeof(float));
+}
+
+bool samePose(const Trajectory::Pose& a, const Trajectory::Pose& b) {
+  const float scalarA = a.rotation.scalar();
+  const float scalarB = b.rotation.scalar();
+  return std::memcmp(a.translation.data(), b.translation.data(),
+                     sizeof(Magnum::Vector3)) == 0 &&
+         std::memcmp(a.rotation.vector().data(), b.rotation.vector().data(),
+                     sizeof(Magnum::Vector3)) == 0 &&
+         std::memcmp(&scalarA, &scalarB, sizeof(float)) == 0;
+}
+
+}  // namespace
+
+uint32_t Trajectory::actionIndex(const std::string& actionName) {
+  auto found = std::find(actionNames.begin(), actionNames.end(), actionName);
+  if (found != actionNames.end()) {
+    return uint32_t(found - actionNames.begin());
+  }
+  actionNames.push_back(actionName);
+  return uint32_t(actionNames.size() - 1);
+}
+
+bool Trajectory::save(const std::string& filename) const {
+  Writer writer;
+  writer.out.append(Magic, sizeof(Magic));
+  writer.write(Version);
+  writer.write(uint32_t(actionNames.size()));
+  for (const std::string& name : actionNames) {
+    writer.write(uint32_t(name.size()));
+    writer.out += name;
+  }
+  writer.write(uint32_t(frames.size()));
+  for (const Frame& frame : frames) {
+    writer.write(frame.worldTime);
+    writer.write(uint32_t(frame.actions.size()));
+    for (const Action& action : frame.actions) {
+      writer.write(int32_t(action.agentId));
+      writer.write(action.name);
+    }
+    writer.write(uint32_t(frame.agents.size()));
+    for (const AgentPose& agent : frame.agents) {
+      writer.write(int32_t(agent.agentId));
+      writer.write(agent.body);
+      writer.write(uint32_t(agent.sensors.size()));
+      for (const Pose& sensor : agent.sensors) {
+        writer.write(sensor);
+      }
+    }
+    writer.write(uint32_t(frame.objects.size()));
+    for (const ObjectPose& object : frame.objects) {
+      writer.write(int32_t(object.objectId));
+      writer.write(object.pose);
+    }
+  }
+
+  if (!Cr::Utility::Directory::write(
+          filename, Cr::Containers::arrayView(writer.out.data(),
+                                              writer.out.size()))) {
+    LOG(ERROR) << "Trajectory::save(): cannot write " << filename;
+    return false;
+  }
+  return true;
+}
+
+Cr::Containers::Optional<Trajectory> Trajectory::load(
+    const std::string& filename) {
+  const Cr::Containers::Array<char> data =
+      Cr::Utility::Directory::read(filename);
+  if (data.size() < sizeof(Magic) + sizeof(uint32_t) ||
+      std::memcmp(data.data(), Magic, sizeof(Magic)) != 0) {
+    LOG(ERROR) << "Trajectory::load(): " << filename
+               << " is not a trajectory";
+    return Cr::Containers::NullOpt;
+  }
+  Reader reader{data.data(), data.size(), sizeof(Magic)};
+  if (reader.read<uint32_t>() != Version) {
+    LOG(ERROR) << "Trajectory::load(): " << filename
+               << " has an unsupported version";
+    return Cr::Containers::NullOpt;
+  }
+
+  constexpr std::size_t PoseSize = 7 * sizeof(float);
+  Trajectory trajectory;
+  trajectory.actionNames.resize(reader.readCount(sizeof(uint32_t)));
+  for (std::string& name : trajectory.actionNames) {
+    name.resize(reader.readCount(1));
+    std::copy(data.data() + reader.offset,
+              data.data() + reader.offset + name.size(), &name[0]);
+    reader.offset += name.size();
+  }
+  trajectory.frames.resize(reader.readCount(sizeof(double)));
+  for (Frame& frame : trajectory.frames) {
+    frame.worldTime = reader.read<double>();
+    frame.actions.resize(reader.readCount(2 * sizeof(uint32_t)));
+    for (Action& action : frame.actions) {
+      action.agentId = reader.read<int32_t>();
+      action.name = reader.read<uint32_t>();
+      if (action.name >= trajectory.actionNames.size()) {
+        reader.failed = true;
+      }
+    }
+    frame.agents.resize(reader.readCount(sizeof(int32_t) + PoseSize));
+    for (AgentPose& agent : frame.agents) {
+      agent.agentId = reader.read<int32_t>();
+      agent.body = reader.readPose();
+      agent.sensors.resize(reader.readCount(PoseSize));
+      for (Pose& sensor : agent.sensors) {
+        sensor = reader.readPose();
+      }
+    }
+    frame.objects.resize(reader.readCount(sizeof(int32_t) + PoseSize));
+    for (ObjectPose& object : frame.objects) {
+      object.objectId = reader.read<int32_t>();
+      object.pose = reader.readPose();
+    }
+  }
+  if (reader.failed) {
+    LOG(ERROR) << "Trajectory::load(): " << filename << " is corrupt";
+    return Cr::Containers::NullOpt;
+  }
+  return std::move(trajectory);
+}
+
+uint64_t Trajectory::poseHash(const Frame& frame) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const AgentPose& agent : frame.agents) {
+    hashBytes(hash, &agent.agentId, sizeof(int));
+    hashPose(hash, agent.body);
+    for (const Pose& sensor : agent.sensors) {
+      hashPose(hash, sensor);
+    }
+  }
+  for (const ObjectPose& object : frame.objects) {
+    hashBytes(hash, &object.objectId, sizeof(int));
+    hashPose(hash, object.pose);
+  }
+  return hash;
+}
+
+bool Trajectory::samePoses(const Frame& a, const Frame& b) {
+  if (a.agents.size() != b.agents.size() ||
+      a.objects.size() != b.objects.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i != a.agents.size(); ++i) {
+    const AgentPose& agentA = a.agents[i];
+    const AgentPose& agentB = b.agents[i];
+    if (agentA.agentId != agentB.agentId ||
+        !samePose(agentA.body, agentB.body) ||
+        agentA.sensors.size() != agentB.sensors.size()) {
+      return false;
+    }
+    for (std::size_t j = 0; j != agentA.sensors.size(); ++j) {
+      if (!samePose(agentA.sensors[j], agentB.sensors[j])) {
+        return false;
+      }
+    }
+  }
+  for (std::size_t i = 0; i != a.objects.size(); ++i) {
+    if (a.objects[i].objectId != b.objects[i].objectId ||
+        !samePose(a.objects[i].pose, b.objects[i].pose)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,115 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+/** @file
+ * @brief Struct @ref esp::sim::Trajectory
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sim {
+
+/**
+@brief Actions, agent poses and object poses of a recorded run
+
+Recorded by @ref Simulator::startRecording() one frame per step and put back
+frame by frame with @ref Simulator::setReplayFrame(). Action names are
+stored once in @ref actionNames and referenced by index, and the file
+written by @ref save() is the plain binary data, so long runs stay small and
+load without parsing.
+*/
+struct Trajectory {
+  /** @brief Translation and rotation of a node relative to its parent */
+  struct Pose {
+    Magnum::Vector3 translation;
+    Magnum::Quaternion rotation;
+  };
+
+  /** @brief An action of one agent */
+  struct Action {
+    int agentId;
+    /** @brief Index into @ref actionNames */
+    uint32_t name;
+  };
+
+  /** @brief State of one agent */
+  struct AgentPose {
+    int agentId;
+    Pose body;
+    /** @brief Poses of the sensors, in the order of their uuids */
+    std::vector<Pose> sensors;
+  };
+
+  /** @brief State of one physics object */
+  struct ObjectPose {
+    int objectId;
+    Pose pose;
+  };
+
+  /** @brief The world after one step */
+  struct Frame {
+    /** @brief World time after the step, @ref NO_TIME without physics */
+    double worldTime = 0.0;
+    /** @brief Actions taken in the step */
+    std::vector<Action> actions;
+    std::vector<AgentPose> agents;
+    std::vector<ObjectPose> objects;
+  };
+
+  /** @brief Names of the actions referenced by @ref Action::name */
+  std::vector<std::string> actionNames;
+  std::vector<Frame> frames;
+
+  /**
+   * @brief Index of @p actionName in @ref actionNames, added if new
+   */
+  uint32_t actionIndex(const std::string& actionName);
+
+  /**
+   * @brief Write the trajectory to a binary file
+   * @return Whether the file was written
+   */
+  bool save(const std::string& filename) const;
+
+  /**
+   * @brief Read a trajectory written by @ref save()
+   * @return The trajectory, @ref Corrade::Containers::NullOpt if the file
+   *      can't be read or isn't a trajectory of this version
+   */
+  static Corrade::Containers::Optional<Trajectory> load(
+      const std::string& filename);
+
+  /**
+   * @brief Hash of the agent and object poses of @p frame
+   *
+   * Equal for frames that put the world in the same state, whichever
+   * trajectory they come from, so it can key cached observations.
+   */
+  static uint64_t poseHash(const Frame& frame);
+
+  /**
+   * @brief Whether @p a and @p b have bit-exactly the same agent and object
+   *    poses
+   *
+   * The equality @ref poseHash() hashes, to tell frames with colliding
+   * hashes apart.
+   */
+  static bool samePoses(const Frame& a, const Frame& b);
+
+  ESP_SMART_POINTERS(Trajectory)
+};
+
+}  // namespace sim
+}  // namespace esp
@@ -1,25 +1,135 @@
 #ifdef UNPROJECT_EXISTING_DEPTH
 uniform highp sampler2D depthTexture;
 uniform highp vec2 depthUnprojection;
+/* Multiplies the unprojected depth, e.g. to write millimeters */
+uniform highp float depthScale;
 
 in highp vec2 textureCoordinates;
 #else
 in highp float depth;
 #endif
 
+#ifdef REDWOOD_NOISE
+/* The distortion model, 80 rows of 80 cells with 5 depth bins each */
+uniform highp sampler2D noiseModel;
+uniform highp float noiseMultiplier;
+uniform highp uint noiseSeed;
+#endif
+
+#ifdef POINTS
+/* Camera-space X and Y at unit depth in the viewport corner, the viewport
+   origin and size, and the transformation of the camera-space points */
+uniform highp vec2 pointUnprojection;
+uniform highp vec4 pointViewport;
+uniform highp mat4 pointTransformation;
+
+out highp vec4 point;
+#else
 out highp float originalDepth;
+#endif
 
-void main() {
-  #ifdef UNPROJECT_EXISTING_DEPTH
-  highp float depth = texture(depthTexture, textureCoordinates).r;
-  originalDepth =
+#ifdef UNPROJECT_EXISTING_DEPTH
+highp float unprojectedDepth(highp float depth) {
+  return
     #ifndef NO_FAR_PLANE_PATCHING
     /* We can afford using == for comparison as 1.0f has an exact
        representation and the depth is cleared to exactly this value. */
     depth == 1.0 ? 0.0 :
     #endif
     depthUnprojection[1] / (depth + depthUnprojection[0]);
+}
+#endif
+
+#ifdef REDWOOD_NOISE
+highp uint hash(highp uint x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+/* Two normally distributed samples, Box-Muller on two hashed uniforms */
+highp vec2 normal2(highp uint key) {
+  highp uint a = hash(key);
+  highp uint b = hash(a);
+  highp float u1 = (float(a >> 8) + 1.0)/16777216.0;
+  highp float u2 = float(b >> 8)/16777216.0;
+  return sqrt(-2.0*log(u1))*vec2(cos(6.2831853*u2), sin(6.2831853*u2));
+}
+
+/* Same as undistort() in RedwoodNoiseModel.cu */
+highp float undistort(int px, int py, highp float z) {
+  int i2 = int((z + 1.0)/2.0);
+  int i1 = i2 - 1;
+  highp float a = (z - float(i1*2 + 1))/2.0;
+  int x = px/8;
+  int y = py/6;
+  highp float f =
+    (1.0 - a)*texelFetch(noiseModel, ivec2(x*5 + clamp(i1, 0, 4), y), 0).r +
+    a*texelFetch(noiseModel, ivec2(x*5 + min(i2, 4), y), 0).r;
+  return f <= 1e-5 ? 0.0 : z/f;
+}
+
+/* The Redwood model of RedwoodNoiseModelCPUImpl, in image coordinates with
+   row 0 at the top */
+highp float noisyDepth() {
+  ivec2 size = textureSize(depthTexture, 0);
+  ivec2 fragment = ivec2(gl_FragCoord.xy);
+  int i = fragment.x;
+  int j = size.y - 1 - fragment.y;
+  highp uint key = (uint(fragment.y)*uint(size.x) + uint(fragment.x))*2u +
+                   noiseSeed*0x9e3779b9u;
+  highp vec4 noise = vec4(normal2(key), normal2(key ^ 0x55555555u));
+
+  /* Shuffle pixels */
+  highp float xmax = float(size.x - 1);
+  highp float ymax = float(size.y - 1);
+  int y = int(clamp(float(j) + noise.x*0.25*noiseMultiplier, 0.0, ymax) + 0.5);
+  int x = int(clamp(float(i) + noise.y*0.25*noiseMultiplier, 0.0, xmax) + 0.5);
+
+  /* Downsample */
+  highp float d = unprojectedDepth(
+    texelFetch(depthTexture, ivec2(x - x%2, size.y - 1 - (y - y%2)), 0).r);
+  /* If depth is greater than 10m, the sensor will just return a zero */
+  if(d >= 10.0) return 0.0;
+
+  /* Distortion, re-mapped to the 640x480 sensor the model was made for */
+  highp float xScale = size.x > 1 ? 639.0/xmax : 0.0;
+  highp float yScale = size.y > 1 ? 479.0/ymax : 0.0;
+  highp float undistorted =
+    undistort(int(float(x)*xScale), int(float(y)*yScale), d);
+  if(undistorted == 0.0) return 0.0;
+
+  /* Quantization and high frequency noise */
+  highp float denom =
+    round(35.130/undistorted + noise.z*0.027778*noiseMultiplier)*8.0;
+  return denom > 1e-5 ? 35.130*8.0/denom : 0.0;
+}
+#endif
+
+void main() {
+  #ifdef REDWOOD_NOISE
+  highp float d = noisyDepth();
+  #elif defined(UNPROJECT_EXISTING_DEPTH)
+  highp float d = unprojectedDepth(texture(depthTexture, textureCoordinates).r);
+  #else
+  highp float d = depth;
+  #endif
+
+  #ifdef POINTS
+  /* No depth, either nothing was drawn or the noise dropped the pixel */
+  if(d == 0.0) {
+    point = vec4(uintBitsToFloat(0x7fc00000u));
+    return;
+  }
+  highp vec2 ndc =
+    (gl_FragCoord.xy - pointViewport.xy)/pointViewport.zw*2.0 - vec2(1.0);
+  point = pointTransformation*vec4(ndc*pointUnprojection*d, -d, 1.0);
+  #elif defined(UNPROJECT_EXISTING_DEPTH)
+  originalDepth = d*depthScale;
   #else
-  originalDepth = depth;
+  originalDepth = d;
   #endif
 }
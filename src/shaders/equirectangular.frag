@@ -0,0 +1,38 @@
+uniform highp samplerCube colorTexture;
+uniform highp usamplerCube objectIdTexture;
+uniform highp samplerCube depthTexture;
+uniform highp vec2 depthUnprojection;
+uniform highp vec2 viewportSize;
+
+layout(location = 0) out lowp vec4 color;
+layout(location = 1) out highp uint objectId;
+
+void main() {
+  /* Longitude grows to the right, latitude upwards, the middle of the image
+     looks along -Z like a pinhole camera does */
+  highp vec2 position = gl_FragCoord.xy/viewportSize - vec2(0.5);
+  highp float longitude = position.x*6.2831853;
+  highp float latitude = position.y*3.1415927;
+  highp vec3 direction = vec3(sin(longitude)*cos(latitude),
+                              sin(latitude),
+                              -cos(longitude)*cos(latitude));
+
+  color = texture(colorTexture, direction);
+  objectId = texture(objectIdTexture, direction).r;
+
+  /* Nothing was drawn there, keep the cleared value */
+  highp float depth = texture(depthTexture, direction).r;
+  if(depth == 1.0) {
+    gl_FragDepth = 1.0;
+    return;
+  }
+
+  /* The face depth is along the face axis, which is the largest component of
+     the direction. Write the distance along the ray instead, projected back
+     with the same near and far planes so the render target unprojects it
+     like any other depth. */
+  highp float z = depthUnprojection[1]/(depth + depthUnprojection[0]);
+  highp vec3 axis = abs(direction);
+  highp float distance = z/max(axis.x, max(axis.y, axis.z));
+  gl_FragDepth = depthUnprojection[1]/distance - depthUnprojection[0];
+}
@@ -0,0 +1,6 @@
+/* Summed up by additive blending */
+out highp float count;
+
+void main() {
+  count = 1.0;
+}
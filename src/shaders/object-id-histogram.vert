@@ -0,0 +1,22 @@
+uniform highp usampler2D objectIdTexture;
+uniform highp ivec2 viewportOrigin;
+uniform highp int outputWidth;
+uniform highp int supersampling;
+uniform highp int binCount;
+
+void main() {
+  /* One point per output pixel, reading the sample a nearest downsampling of
+     the object IDs picks */
+  ivec2 pixel = ivec2(gl_VertexID % outputWidth, gl_VertexID / outputWidth);
+  highp uint objectId = texelFetch(objectIdTexture,
+      viewportOrigin + pixel*supersampling + supersampling/2, 0).r;
+
+  /* The point lands in the center of the bin of its ID, IDs without a bin
+     outside of the clip volume */
+  highp float x = objectId < uint(binCount) ?
+      (float(objectId) + 0.5)*2.0/float(binCount) - 1.0 : 2.0;
+  gl_Position = vec4(x, 0.0, 0.0, 1.0);
+  #ifdef GL_ES
+  gl_PointSize = 1.0;
+  #endif
+}
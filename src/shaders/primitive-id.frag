@@ -0,0 +1,12 @@
+/* One object ID per triangle, in the order of the index buffer */
+uniform highp usamplerBuffer primitiveObjectIds;
+
+in lowp vec3 interpolatedColor;
+
+layout(location = 0) out lowp vec4 color;
+layout(location = 1) out highp uint objectId;
+
+void main() {
+  color = vec4(interpolatedColor, 1.0);
+  objectId = texelFetch(primitiveObjectIds, gl_PrimitiveID).r;
+}
@@ -0,0 +1,12 @@
+uniform highp mat4 transformationProjectionMatrix;
+
+/* Bound to the generic attribute locations by PrimitiveIdShader */
+in highp vec4 position;
+in lowp vec3 color;
+
+out lowp vec3 interpolatedColor;
+
+void main() {
+  gl_Position = transformationProjectionMatrix*position;
+  interpolatedColor = color;
+}
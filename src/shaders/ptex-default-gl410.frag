@@ -178,9 +178,18 @@ uniform float gamma;
 uniform float saturation;
 
 in vec2 uv;
+#ifdef VERTEX_PULLING
+// the quads are two triangles each, so gl_PrimitiveID isn't the face
+flat in int faceID;
+#endif
 
 void main() {
-  vec4 c = textureAtlas(atlasTex, gl_PrimitiveID, uv * tileSize) * exposure;
+#ifdef VERTEX_PULLING
+  int face = faceID;
+#else
+  int face = gl_PrimitiveID;
+#endif
+  vec4 c = textureAtlas(atlasTex, face, uv * tileSize) * exposure;
 	applySaturation(c, saturation);
 	c.rgb = pow(c.rgb, vec3(gamma));
 	FragColor = vec4(c.rgb, 1.0f);
@@ -0,0 +1,24 @@
+// Draws the quads as triangles without a geometry shader: the mesh has no
+// attributes, every quad is six vertices and each of them fetches its own
+// position through the index buffer.
+uniform mat4 MVP;
+uniform samplerBuffer meshVertices;
+uniform usamplerBuffer meshIndices;
+
+out vec2 uv;
+flat out int faceID;
+
+// the same triangles (3, 0, 2) and (2, 0, 1), both CCW, and texture
+// coordinates the geometry shader of the default path emits
+const int QUAD_CORNERS[6] = int[](3, 0, 2, 2, 0, 1);
+const vec2 CORNER_UVS[4] =
+    vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+  faceID = gl_VertexID / 6;
+  int corner = QUAD_CORNERS[gl_VertexID - faceID * 6];
+  int index = int(texelFetch(meshIndices, faceID * 4 + corner).r);
+
+  uv = CORNER_UVS[corner];
+  gl_Position = MVP * vec4(texelFetch(meshVertices, index).xyz, 1.0);
+}
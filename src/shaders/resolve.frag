@@ -0,0 +1,25 @@
+uniform highp sampler2D colorTexture;
+uniform highp int supersampling;
+
+#ifdef GRAYSCALE
+out lowp float color;
+#else
+out lowp vec4 color;
+#endif
+
+void main() {
+  /* Average of the supersampling x supersampling texels under the fragment */
+  ivec2 origin = ivec2(gl_FragCoord.xy)*supersampling;
+  highp vec4 sum = vec4(0.0);
+  for(int y = 0; y < supersampling; ++y)
+    for(int x = 0; x < supersampling; ++x)
+      sum += texelFetch(colorTexture, origin + ivec2(x, y), 0);
+  highp vec4 average = sum/float(supersampling*supersampling);
+
+  #ifdef GRAYSCALE
+  /* Rec. 601 luma, the same weights as OpenCV and PIL use */
+  color = dot(average.rgb, vec3(0.299, 0.587, 0.114));
+  #else
+  color = average;
+  #endif
+}
@@ -0,0 +1,26 @@
+uniform highp sampler2D lookupTexture;
+uniform highp sampler2D colorTexture;
+uniform highp usampler2D objectIdTexture;
+uniform highp sampler2D depthTexture;
+
+layout(location = 0) out lowp vec4 color;
+layout(location = 1) out highp uint objectId;
+
+void main() {
+  /* Where the fragment is in the source textures, negative if the distortion
+     model maps it outside of them */
+  highp vec2 coordinates =
+    texelFetch(lookupTexture, ivec2(gl_FragCoord.xy), 0).xy;
+  if(coordinates.x < 0.0) {
+    color = vec4(0.0, 0.0, 0.0, 1.0);
+    objectId = 0u;
+    gl_FragDepth = 1.0;
+    return;
+  }
+
+  color = texture(colorTexture, coordinates);
+  objectId = texture(objectIdTexture, coordinates).r;
+  /* The source shares the optical axis and the clip planes, so its depth
+     stays valid as is */
+  gl_FragDepth = texture(depthTexture, coordinates).r;
+}
@@ -0,0 +1,130 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "esp/agent/Agent.h"
+#include "esp/scene/SceneGraph.h"
+
+using esp::agent::ActionSpec;
+using esp::agent::ActuationMap;
+using esp::agent::Agent;
+using esp::agent::AgentConfiguration;
+using esp::scene::SceneGraph;
+
+class AgentTest : public ::testing::Test {
+ protected:
+  AgentConfiguration configuration() {
+    AgentConfiguration cfg;
+    // no sensors, so no GL context is needed
+    cfg.sensorSpecifications.clear();
+    return cfg;
+  }
+
+  SceneGraph g;
+};
+
+TEST_F(AgentTest, ActionTable) {
+  AgentConfiguration cfg = configuration();
+  cfg.actionSpace["noAmount"] =
+      ActionSpec::create("moveForward", ActuationMap{});
+  cfg.actionSpace["unknown"] =
+      ActionSpec::create("jump", ActuationMap{{"amount", 1.0f}});
+  Agent agent{g.getRootNode().createChild(), cfg};
+
+  // indexed in the order of the action space
+  ASSERT_EQ(agent.getActionCount(), int(cfg.actionSpace.size()));
+  int index = 0;
+  for (const auto& action : cfg.actionSpace) {
+    EXPECT_TRUE(agent.hasAction(action.first));
+    EXPECT_EQ(agent.getActionIndex(action.first), index++);
+  }
+  EXPECT_FALSE(agent.hasAction("fly"));
+  EXPECT_EQ(agent.getActionIndex("fly"), -1);
+
+  EXPECT_FALSE(agent.act("fly"));
+  EXPECT_FALSE(agent.act(-1));
+  EXPECT_FALSE(agent.act(agent.getActionCount()));
+  EXPECT_FALSE(agent.act("noAmount"));
+  // in the action space but without a control, consumed like before
+  EXPECT_TRUE(agent.act("unknown"));
+}
+
+TEST_F(AgentTest, ActByIndex) {
+  Agent byName{g.getRootNode().createChild(), configuration()};
+  Agent byIndex{g.getRootNode().createChild(), configuration()};
+  const int forward = byIndex.getActionIndex("moveForward");
+  const int left = byIndex.getActionIndex("turnLeft");
+  ASSERT_NE(forward, -1);
+  ASSERT_NE(left, -1);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(byName.act("moveForward"));
+    EXPECT_TRUE(byName.act("turnLeft"));
+    EXPECT_TRUE(byIndex.act(forward));
+    EXPECT_TRUE(byIndex.act(left));
+  }
+  EXPECT_EQ(byIndex.node().transformation(), byName.node().transformation());
+  EXPECT_NE(byIndex.node().transformation(), Magnum::Matrix4{});
+}
+
+TEST_F(AgentTest, CompileActions) {
+  Agent agent{g.getRootNode().createChild(), configuration()};
+  EXPECT_FALSE(agent.hasAction("strafe"));
+
+  // the table follows the configuration only once recompiled
+  agent.getConfig().actionSpace["strafe"] =
+      ActionSpec::create("moveRight", ActuationMap{{"amount", 0.5f}});
+  EXPECT_FALSE(agent.hasAction("strafe"));
+  agent.compileActions();
+  ASSERT_TRUE(agent.act("strafe"));
+  EXPECT_EQ(agent.node().translation(), (Magnum::Vector3{0.5f, 0.0f, 0.0f}));
+}
+
+TEST_F(AgentTest, FilterBatch) {
+  Agent immediate{g.getRootNode().createChild(), configuration()};
+  Agent first{g.getRootNode().createChild(), configuration()};
+  Agent second{g.getRootNode().createChild(), configuration()};
+  // a wall at z = -0.3
+  auto wall = [](const esp::vec3f& start, const esp::vec3f& end) {
+    esp::vec3f filtered = end;
+    filtered[2] = std::max(filtered[2], -0.3f);
+    return filtered;
+  };
+  immediate.getControls()->setMoveFilterFunction(wall);
+
+  esp::scene::FilteredMoveBatch batch;
+  int filterCalls = 0;
+  for (Agent* agent : {&first, &second}) {
+    agent->getControls()->setFilterBatch(&batch);
+    EXPECT_TRUE(agent->act("moveForward"));
+    agent->getControls()->setFilterBatch(nullptr);
+  }
+  // a second move of the same agent extends its first
+  first.getControls()->setFilterBatch(&batch);
+  EXPECT_TRUE(first.act("moveForward"));
+  first.getControls()->setFilterBatch(nullptr);
+  EXPECT_EQ(batch.size(), 2u);
+  // unfiltered until the batch is applied
+  EXPECT_EQ(first.node().translation(), (Magnum::Vector3{0.0f, 0.0f, -0.5f}));
+
+  batch.apply([&](Corrade::Containers::ArrayView<const esp::vec3f> starts,
+                  Corrade::Containers::ArrayView<const esp::vec3f> ends,
+                  Corrade::Containers::ArrayView<esp::vec3f> results) {
+    ++filterCalls;
+    for (size_t i = 0; i < starts.size(); ++i) {
+      results[i] = wall(starts[i], ends[i]);
+    }
+  });
+  EXPECT_EQ(filterCalls, 1);
+  EXPECT_EQ(batch.size(), 0u);
+
+  EXPECT_TRUE(immediate.act("moveForward"));
+  EXPECT_TRUE(immediate.act("moveForward"));
+  EXPECT_EQ(first.node().translation(), immediate.node().translation());
+  EXPECT_EQ(second.node().translation(),
+            (Magnum::Vector3{0.0f, 0.0f, -0.25f}));
+}
@@ -0,0 +1,255 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Directory.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esp/bindings_c/habitat_sim.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+
+namespace {
+
+const std::string vangogh =
+    Cr::Utility::Directory::join(SCENE_DATASETS,
+                                 "habitat-test-scenes/van-gogh-room.glb");
+
+struct CApiTest : Cr::TestSuite::Tester {
+  explicit CApiTest();
+
+  void configDefaults();
+  void invalidArguments();
+  void agentState();
+  void observations();
+  void pathFinder();
+};
+
+CApiTest::CApiTest() {
+  addTests({&CApiTest::configDefaults, &CApiTest::invalidArguments,
+            &CApiTest::agentState, &CApiTest::observations,
+            &CApiTest::pathFinder});
+}
+
+struct SimulatorDeleter {
+  void operator()(hsim_simulator* simulator) {
+    hsim_simulator_destroy(simulator);
+  }
+};
+using SimulatorPtr = std::unique_ptr<hsim_simulator, SimulatorDeleter>;
+
+// the van Gogh room with one agent of an RGBA and a depth sensor
+SimulatorPtr createSimulator(int& agentId) {
+  hsim_simulator_config config;
+  hsim_simulator_config_init(&config);
+  config.scene_id = vangogh.c_str();
+  hsim_simulator* simulator = nullptr;
+  if (hsim_simulator_create(&config, &simulator) != HSIM_OK) {
+    return nullptr;
+  }
+
+  hsim_sensor_config sensors[2];
+  hsim_sensor_config_init(&sensors[0]);
+  sensors[0].width = 32;
+  sensors[0].height = 24;
+  hsim_sensor_config_init(&sensors[1]);
+  sensors[1].uuid = "depth";
+  sensors[1].type = HSIM_SENSOR_DEPTH;
+  sensors[1].width = 32;
+  sensors[1].height = 24;
+  hsim_agent_config agent;
+  hsim_agent_config_init(&agent);
+  agent.sensors = sensors;
+  agent.sensor_count = 2;
+  if (hsim_simulator_add_agent(simulator, &agent, &agentId) != HSIM_OK) {
+    hsim_simulator_destroy(simulator);
+    return nullptr;
+  }
+  return SimulatorPtr{simulator};
+}
+
+void CApiTest::configDefaults() {
+  CORRADE_COMPARE(hsim_api_version(), HSIM_API_VERSION);
+
+  hsim_simulator_config config;
+  hsim_simulator_config_init(&config);
+  CORRADE_COMPARE(config.struct_size, sizeof(hsim_simulator_config));
+  CORRADE_VERIFY(!config.scene_id);
+  CORRADE_COMPARE(config.allow_sliding, 1);
+
+  hsim_sensor_config sensor;
+  hsim_sensor_config_init(&sensor);
+  CORRADE_COMPARE(sensor.type, HSIM_SENSOR_COLOR);
+  CORRADE_COMPARE(sensor.width, 84);
+  CORRADE_COMPARE(sensor.height, 84);
+  CORRADE_COMPARE(sensor.position[1], 1.5f);
+}
+
+void CApiTest::invalidArguments() {
+  hsim_simulator* simulator = nullptr;
+  CORRADE_COMPARE(hsim_simulator_create(nullptr, &simulator),
+                  HSIM_ERROR_INVALID_ARGUMENT);
+  CORRADE_VERIFY(!simulator);
+  CORRADE_COMPARE(std::string{hsim_last_error()}.find("hsim_simulator_create"),
+                  0);
+
+  // a struct of a size the library doesn't know
+  hsim_simulator_config config;
+  hsim_simulator_config_init(&config);
+  config.scene_id = vangogh.c_str();
+  config.struct_size = sizeof(size_t);
+  CORRADE_COMPARE(hsim_simulator_create(&config, &simulator),
+                  HSIM_ERROR_INVALID_ARGUMENT);
+
+  // null handles fail instead of crashing
+  CORRADE_COMPARE(hsim_simulator_reset(nullptr), HSIM_ERROR_INVALID_ARGUMENT);
+  CORRADE_COMPARE(hsim_pathfinder_is_loaded(nullptr), 0);
+  hsim_simulator_destroy(nullptr);
+}
+
+void CApiTest::agentState() {
+  int agentId = -1;
+  SimulatorPtr simulator = createSimulator(agentId);
+  CORRADE_VERIFY(simulator);
+  CORRADE_COMPARE(agentId, 0);
+
+  const float position[3]{1.0f, 0.5f, -2.0f};
+  // 90 degrees around Y
+  const float rotation[4]{0.0f, std::sqrt(0.5f), 0.0f, std::sqrt(0.5f)};
+  CORRADE_COMPARE(
+      hsim_agent_set_state(simulator.get(), agentId, position, rotation),
+      HSIM_OK);
+  CORRADE_COMPARE(std::string{hsim_last_error()}, "");
+  float gotPosition[3], gotRotation[4];
+  CORRADE_COMPARE(hsim_agent_get_state(simulator.get(), agentId, gotPosition,
+                                       gotRotation),
+                  HSIM_OK);
+  for (int i = 0; i != 3; ++i) {
+    CORRADE_COMPARE(gotPosition[i], position[i]);
+  }
+  for (int i = 0; i != 4; ++i) {
+    CORRADE_COMPARE(gotRotation[i], rotation[i]);
+  }
+
+  // an unnormalized rotation is an error, not an abort
+  const float scaled[4]{0.0f, 0.0f, 0.0f, 2.0f};
+  CORRADE_COMPARE(
+      hsim_agent_set_state(simulator.get(), agentId, position, scaled),
+      HSIM_ERROR_INVALID_ARGUMENT);
+  CORRADE_COMPARE(
+      hsim_agent_get_state(simulator.get(), 7, gotPosition, gotRotation),
+      HSIM_ERROR_NOT_FOUND);
+
+  // turning keeps the position, unknown actions fail
+  CORRADE_COMPARE(hsim_agent_act(simulator.get(), agentId, "turnLeft"),
+                  HSIM_OK);
+  CORRADE_COMPARE(hsim_agent_get_state(simulator.get(), agentId, gotPosition,
+                                       gotRotation),
+                  HSIM_OK);
+  CORRADE_COMPARE(gotPosition[0], position[0]);
+  CORRADE_VERIFY(gotRotation[1] != rotation[1]);
+  CORRADE_COMPARE(hsim_agent_act(simulator.get(), agentId, "jump"),
+                  HSIM_ERROR_NOT_FOUND);
+}
+
+void CApiTest::observations() {
+  int agentId = -1;
+  SimulatorPtr simulator = createSimulator(agentId);
+  CORRADE_VERIFY(simulator);
+
+  hsim_observation_info info;
+  info.struct_size = sizeof(info);
+  CORRADE_COMPARE(
+      hsim_sensor_get_info(simulator.get(), agentId, "rgba_camera", &info),
+      HSIM_OK);
+  CORRADE_COMPARE(info.data_type, HSIM_DATA_TYPE_UINT8);
+  CORRADE_COMPARE(info.dimensions, 3);
+  CORRADE_COMPARE(info.shape[0], 24);
+  CORRADE_COMPARE(info.shape[1], 32);
+  CORRADE_COMPARE(info.shape[2], 4);
+  CORRADE_COMPARE(info.byte_size, 24 * 32 * 4);
+
+  // rendered straight into the caller's memory
+  std::vector<uint8_t> color(info.byte_size, 0);
+  CORRADE_COMPARE(hsim_sensor_get_observation(simulator.get(), agentId,
+                                              "rgba_camera", color.data(),
+                                              color.size()),
+                  HSIM_OK);
+  CORRADE_VERIFY(std::any_of(color.begin(), color.end(),
+                             [](uint8_t value) { return value != 0; }));
+  CORRADE_COMPARE(hsim_sensor_get_observation(simulator.get(), agentId,
+                                              "rgba_camera", color.data(),
+                                              color.size() - 1),
+                  HSIM_ERROR_BUFFER_TOO_SMALL);
+
+  CORRADE_COMPARE(
+      hsim_sensor_get_info(simulator.get(), agentId, "depth", &info),
+      HSIM_OK);
+  CORRADE_COMPARE(info.data_type, HSIM_DATA_TYPE_FLOAT);
+  std::vector<float> depth(info.byte_size / sizeof(float), 0.0f);
+  CORRADE_COMPARE(
+      hsim_sensor_get_observation(simulator.get(), agentId, "depth",
+                                  depth.data(), info.byte_size),
+      HSIM_OK);
+  CORRADE_VERIFY(*std::max_element(depth.begin(), depth.end()) > 0.0f);
+
+  CORRADE_COMPARE(
+      hsim_sensor_get_info(simulator.get(), agentId, "nonexistent", &info),
+      HSIM_ERROR_NOT_FOUND);
+}
+
+void CApiTest::pathFinder() {
+  int agentId = -1;
+  SimulatorPtr simulator = createSimulator(agentId);
+  CORRADE_VERIFY(simulator);
+  // the navmesh next to the scene is loaded with it
+  CORRADE_VERIFY(hsim_pathfinder_is_loaded(simulator.get()));
+  CORRADE_COMPARE(hsim_simulator_seed(simulator.get(), 5), HSIM_OK);
+
+  float start[3], end[3];
+  CORRADE_COMPARE(
+      hsim_pathfinder_random_navigable_point(simulator.get(), start), HSIM_OK);
+  CORRADE_COMPARE(
+      hsim_pathfinder_random_navigable_point(simulator.get(), end), HSIM_OK);
+  int navigable = 0;
+  CORRADE_COMPARE(
+      hsim_pathfinder_is_navigable(simulator.get(), start, &navigable),
+      HSIM_OK);
+  CORRADE_COMPARE(navigable, 1);
+
+  float distance = 0.0f;
+  size_t pointCount = 0;
+  // too small an output still reports the size
+  CORRADE_COMPARE(hsim_pathfinder_find_path(simulator.get(), start, end,
+                                            &distance, nullptr, 0,
+                                            &pointCount),
+                  HSIM_ERROR_BUFFER_TOO_SMALL);
+  CORRADE_VERIFY(pointCount >= 2);
+  std::vector<float> points(3 * pointCount);
+  CORRADE_COMPARE(hsim_pathfinder_find_path(simulator.get(), start, end,
+                                            &distance, points.data(),
+                                            pointCount, &pointCount),
+                  HSIM_OK);
+  CORRADE_VERIFY(std::isfinite(distance));
+  CORRADE_VERIFY(std::abs(points[points.size() - 3] - end[0]) < 1.0e-3f);
+
+  float snapped[3];
+  CORRADE_COMPARE(hsim_pathfinder_snap_point(simulator.get(), end, snapped),
+                  HSIM_OK);
+  CORRADE_VERIFY(std::abs(snapped[0] - end[0]) < 1.0e-3f);
+  float stepped[3];
+  CORRADE_COMPARE(
+      hsim_pathfinder_try_step(simulator.get(), start, end, stepped), HSIM_OK);
+  CORRADE_VERIFY(std::isfinite(stepped[0]));
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(CApiTest)
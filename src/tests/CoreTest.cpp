@@ -4,8 +4,33 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "esp/core/Buffer.h"
 #include "esp/core/Configuration.h"
+#include "esp/core/MathInterop.h"
+#include "esp/core/Metrics.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/SharedMemoryRing.h"
+#include "esp/core/SlotMap.h"
+#include "esp/core/TaskScheduler.h"
+#include "esp/core/Topology.h"
 #include "esp/core/esp.h"
+#include "esp/core/logging.h"
+#include "esp/core/random.h"
 #include "esp/io/json.h"
 
 using namespace esp::core;
@@ -28,3 +53,445 @@ TEST(CoreTest, JsonTest) {
   EXPECT_EQ(t[1], 2);
   EXPECT_EQ(esp::io::jsonToString(json), "{\"test\":[1,2,3,4]}");
 }
+
+TEST(CoreTest, BufferPoolTest) {
+  BufferPool pool{{4, 3, 1}, DataType::DT_FLOAT, 2};
+  EXPECT_EQ(pool.size(), 2);
+  EXPECT_EQ(pool.allocationCount(), 2);
+
+  Buffer::ptr first = pool.acquire();
+  EXPECT_EQ(first->data.size(), 4 * 3 * sizeof(float));
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first->data.data()) %
+                Buffer::Alignment,
+            0);
+
+  // still referenced, so the other preallocated buffer is handed out
+  Buffer::ptr second = pool.acquire();
+  EXPECT_NE(first, second);
+  EXPECT_EQ(pool.allocationCount(), 2);
+
+  // steady state, buffers released each step get recycled
+  for (int i = 0; i != 10; ++i) {
+    pool.release(first);
+    first = pool.acquire();
+    std::swap(first, second);
+  }
+  EXPECT_EQ(pool.allocationCount(), 2);
+
+  // all in use, the ring grows
+  Buffer::ptr third = pool.acquire();
+  EXPECT_NE(third, first);
+  EXPECT_NE(third, second);
+  EXPECT_EQ(pool.allocationCount(), 3);
+
+  // only the buffers still in use survive
+  pool.release(third);
+  pool.clear();
+  EXPECT_EQ(pool.size(), 2);
+}
+
+TEST(CoreTest, BufferMemoryPoolTest) {
+  Buffer::releasePooledMemory();
+  EXPECT_EQ(Buffer::pooledBytes(), 0u);
+
+  uint8_t* memory = nullptr;
+  {
+    Buffer buffer{{1000}, DataType::DT_FLOAT};
+    memory = buffer.data.data();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % Buffer::Alignment,
+              0u);
+  }
+  // 4000 bytes are in the 4096 byte class
+  EXPECT_EQ(Buffer::pooledBytes(), 4096u);
+
+  // a buffer of the same class gets the freed memory
+  {
+    Buffer buffer{{4090}, DataType::DT_UINT8};
+    EXPECT_EQ(buffer.data.data(), memory);
+    EXPECT_EQ(buffer.data.size(), 4090u);
+    EXPECT_EQ(Buffer::pooledBytes(), 0u);
+  }
+
+  // pinned memory needs CUDA, the buffer falls back to pageable otherwise
+  Buffer pinned{{16}, DataType::DT_FLOAT, BufferStorage::Pinned};
+#ifndef ESP_BUILD_WITH_CUDA
+  EXPECT_EQ(pinned.storage, BufferStorage::Aligned);
+#endif
+  EXPECT_EQ(pinned.data.size(), 16 * sizeof(float));
+
+  Buffer::releasePooledMemory();
+  EXPECT_EQ(Buffer::pooledBytes(), 0u);
+}
+
+TEST(CoreTest, MathInteropTest) {
+  // the views alias the same floats in both directions
+  esp::vec3f position{1.0f, 2.0f, 3.0f};
+  Magnum::Vector3& magnumPosition = asMagnum(position);
+  EXPECT_EQ(static_cast<void*>(magnumPosition.data()),
+            static_cast<void*>(position.data()));
+  magnumPosition.y() = 5.0f;
+  EXPECT_EQ(position[1], 5.0f);
+  Magnum::Vector3 translation{4.0f, 5.0f, 6.0f};
+  asEigen(translation)[2] = 7.0f;
+  EXPECT_EQ(translation.z(), 7.0f);
+
+  // x, y, z, w in all of quatf, vec4f coefficients and Magnum
+  const esp::quatf rotation{Eigen::AngleAxisf(0.5f, esp::vec3f::UnitY())};
+  const Magnum::Quaternion expected = Magnum::Quaternion::rotation(
+      Magnum::Rad(0.5f), Magnum::Vector3::yAxis());
+  const Magnum::Quaternion& magnumRotation = asMagnum(rotation);
+  for (int i = 0; i != 4; ++i) {
+    EXPECT_NEAR(magnumRotation.data()[i], expected.data()[i], 1.0e-6f);
+  }
+  esp::vec4f coeffs = rotation.coeffs();
+  asMagnumQuaternion(coeffs) = Magnum::Quaternion{};
+  EXPECT_EQ(coeffs, esp::vec4f(0.0f, 0.0f, 0.0f, 1.0f));
+  EXPECT_TRUE(asEigen(expected).isApprox(rotation));
+}
+
+TEST(CoreTest, ProfilerTest) {
+  Profiler::clear();
+  { ESP_PROFILE_SCOPE("disabled"); }
+  EXPECT_EQ(esp::io::parseJsonString(Profiler::chromeTrace())["traceEvents"]
+                .Size(),
+            0u);
+
+  Profiler::setEnabled(true);
+  {
+    ESP_PROFILE_SCOPE("outer");
+    ESP_PROFILE_SCOPE("inner");
+  }
+  std::thread thread{[] { ESP_PROFILE_SCOPE("other thread"); }};
+  thread.join();
+  Profiler::addEvent("GPU", "draw", Profiler::now(), 1.0);
+  Profiler::setEnabled(false);
+  { ESP_PROFILE_SCOPE("disabled"); }
+
+  const auto& json = esp::io::parseJsonString(Profiler::chromeTrace());
+  std::map<std::string, int> names;
+  std::set<int> tids;
+  for (const auto& event : json["traceEvents"].GetArray()) {
+    if (std::string{event["ph"].GetString()} == "X") {
+      ++names[event["name"].GetString()];
+      tids.insert(event["tid"].GetInt());
+    }
+  }
+  EXPECT_EQ(names, (std::map<std::string, int>{
+                       {"outer", 1}, {"inner", 1}, {"other thread", 1},
+                       {"draw", 1}}));
+  // two threads and the GPU track
+  EXPECT_EQ(tids.size(), 3u);
+  EXPECT_EQ(Profiler::droppedEventCount(), 0u);
+  Profiler::clear();
+}
+
+TEST(CoreTest, MetricsTest) {
+  Metrics::Counter& calls = Metrics::counter("test.calls");
+  Metrics::Counter& level = Metrics::counter("test.level");
+  Metrics::Histogram& times = Metrics::histogram("test.time_us");
+  // the same metric for the same name
+  EXPECT_EQ(&Metrics::counter("test.calls"), &calls);
+  Metrics::reset();
+
+  std::thread thread{[&calls] {
+    for (int i = 0; i != 1000; ++i) {
+      calls.add();
+    }
+  }};
+  for (int i = 0; i != 1000; ++i) {
+    calls.add(2);
+  }
+  thread.join();
+  level.set(7);
+  for (double time : {1.0, 2.0, 3.0, 100.0}) {
+    times.record(time);
+  }
+
+  std::map<std::string, double> values = Metrics::snapshot(true);
+  EXPECT_EQ(values.at("test.calls"), 3000.0);
+  EXPECT_EQ(values.at("test.level"), 7.0);
+  EXPECT_EQ(values.at("test.time_us.count"), 4.0);
+  EXPECT_EQ(values.at("test.time_us.sum"), 106.0);
+  // upper bounds of the power-of-two buckets
+  EXPECT_EQ(values.at("test.time_us.p50"), 4.0);
+  EXPECT_EQ(values.at("test.time_us.p99"), 128.0);
+
+  // reset, except the level
+  values = Metrics::snapshot();
+  EXPECT_EQ(values.at("test.calls"), 0.0);
+  EXPECT_EQ(values.at("test.level"), 7.0);
+  EXPECT_EQ(values.count("test.time_us.count"), 0u);
+  EXPECT_EQ(times.percentile(0.5), 0.0);
+}
+
+TEST(CoreTest, LogVerbosityTest) {
+  int evaluated = 0;
+  // neither the condition nor the message are evaluated when disabled
+  VLOG(1) << ++evaluated;
+  LOG_IF(INFO, ++evaluated > 0) << ++evaluated;
+  EXPECT_EQ(evaluated, ESP_LOG_ON_INFO ? 2 : 0);
+
+  evaluated = 0;
+  setLogVerbosity("CoreTest", 1);
+  VLOG(1) << ++evaluated;
+  VLOG(2) << ++evaluated;
+  setLogVerbosity("CoreTest", 0);
+  EXPECT_EQ(evaluated, ESP_LOG_ON_INFO ? 1 : 0);
+}
+
+TEST(CoreTest, CounterRandomTest) {
+  // known answers of Philox4x32-10
+  uint32_t block[4];
+  CounterRandom::block(0, 0, 0, 0, 0, 0, block);
+  EXPECT_EQ(std::vector<uint32_t>(block, block + 4),
+            (std::vector<uint32_t>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                   0x9b00dbd8}));
+  CounterRandom::block(~0u, ~0u, ~0u, ~0u, ~0u, ~0u, block);
+  EXPECT_EQ(std::vector<uint32_t>(block, block + 4),
+            (std::vector<uint32_t>{0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                                   0x6d5451fd}));
+
+  // fills give the same numbers as single draws, from any position
+  CounterRandom a{7, 3};
+  CounterRandom b{7, 3};
+  a.uniform_uint();
+  b.uniform_uint();
+  std::vector<uint32_t> filled(1001);
+  a.fill_uniform_uint(filled.data(), filled.size());
+  for (uint32_t value : filled) {
+    EXPECT_EQ(value, b.uniform_uint());
+  }
+  EXPECT_EQ(a.position(), 1002u);
+
+  // streams and sub-streams differ
+  EXPECT_NE(CounterRandom{7, 3}.uniform_uint(),
+            CounterRandom{7, 4}.uniform_uint());
+  EXPECT_NE(CounterRandom{7, 3}.split(0).uniform_uint(),
+            CounterRandom{7, 3}.split(1).uniform_uint());
+  EXPECT_EQ(CounterRandom{7, 3}.split(5).uniform_uint(),
+            CounterRandom{7, 3}.split(5).uniform_uint());
+
+  std::vector<float> normal(10001);
+  CounterRandom{1}.fill_normal_float_01(normal.data(), normal.size());
+  double sum = 0.0;
+  double squares = 0.0;
+  for (float value : normal) {
+    sum += value;
+    squares += value * value;
+  }
+  EXPECT_NEAR(sum / normal.size(), 0.0, 0.05);
+  EXPECT_NEAR(squares / normal.size(), 1.0, 0.05);
+}
+
+TEST(CoreTest, SharedMemoryRingTest) {
+  const std::string name = "/esp-core-test-" + std::to_string(getpid());
+  SharedMemoryRing::ptr writer = SharedMemoryRing::create(name, 2, 100);
+  ASSERT_NE(writer, nullptr);
+  EXPECT_TRUE(writer->isOwner());
+  // names are exclusive
+  EXPECT_EQ(SharedMemoryRing::create(name, 2, 100), nullptr);
+
+  SharedMemoryRing::ptr reader = SharedMemoryRing::open(name);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_FALSE(reader->isOwner());
+  EXPECT_EQ(reader->slotCount(), 2u);
+  EXPECT_EQ(reader->slotByteSize(), 100u);
+  EXPECT_TRUE(reader->beginRead().empty());
+
+  // the writer stops once all slots wait for the reader
+  for (uint64_t i = 1; i <= 2; ++i) {
+    Corrade::Containers::ArrayView<uint8_t> slot = writer->beginWrite();
+    ASSERT_EQ(slot.size(), 100u);
+    std::memset(slot.data(), int(i), 10);
+    EXPECT_EQ(writer->endWrite(10, "layout " + std::to_string(i)), i);
+  }
+  EXPECT_TRUE(writer->beginWrite().empty());
+  EXPECT_EQ(reader->pendingCount(), 2u);
+
+  // the reader sees the memory the writer wrote, in order
+  Corrade::Containers::ArrayView<const uint8_t> slot = reader->beginRead();
+  ASSERT_EQ(slot.size(), 10u);
+  EXPECT_EQ(slot[9], 1);
+  EXPECT_EQ(reader->readSequence(), 1u);
+  EXPECT_EQ(reader->readLayout(), "layout 1");
+  reader->endRead();
+
+  // and the released slot is reused
+  ASSERT_FALSE(writer->beginWrite().empty());
+  EXPECT_EQ(writer->endWrite(0), 3u);
+  EXPECT_EQ(reader->beginRead()[0], 2);
+  EXPECT_EQ(reader->readSequence(), 2u);
+  reader->endRead();
+  EXPECT_EQ(reader->readSequence(), 3u);
+  EXPECT_EQ(reader->readLayout(), "");
+  reader->endRead();
+  EXPECT_EQ(reader->pendingCount(), 0u);
+
+  // the name goes away with the writer, mappings stay
+  writer = nullptr;
+  EXPECT_EQ(SharedMemoryRing::open(name), nullptr);
+  EXPECT_EQ(reader->slotCount(), 2u);
+}
+
+TEST(CoreTest, SlotMapTest) {
+  SlotMap<std::string> map;
+  EXPECT_TRUE(map.emplace(0, "a").second);
+  EXPECT_TRUE(map.emplace(2, "c").second);
+  EXPECT_TRUE(map.emplace(1, "b").second);
+  EXPECT_FALSE(map.emplace(1, "x").second);
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(map.at(1), "b");
+  EXPECT_EQ(map.count(3), 0);
+  EXPECT_EQ(map.count(-1), 0);
+  EXPECT_EQ(map.find(5), map.end());
+
+  // iterated in ID order even if inserted out of it
+  std::vector<int> ids;
+  for (const auto& value : map) {
+    ids.push_back(value.first);
+  }
+  EXPECT_EQ(ids, (std::vector<int>{0, 1, 2}));
+
+  const std::uint32_t generation = map.generation(1);
+  EXPECT_TRUE(map.contains(1, generation));
+  EXPECT_EQ(map.erase(1), 1);
+  EXPECT_EQ(map.erase(1), 0);
+  EXPECT_EQ(map.at(2), "c");
+  EXPECT_EQ(map.find(2)->second, "c");
+
+  // a reused ID is told apart from the erased value by its generation
+  map.emplace(1, "d");
+  EXPECT_TRUE(map.contains(1));
+  EXPECT_FALSE(map.contains(1, generation));
+  EXPECT_TRUE(map.contains(1, map.generation(1)));
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(0));
+  EXPECT_EQ(map.generation(0), 1);
+}
+
+TEST(CoreTest, TaskSchedulerTest) {
+  TaskSchedulerConfiguration configuration;
+  configuration.threadCount = 4;
+  TaskScheduler scheduler{configuration};
+  EXPECT_EQ(scheduler.threadCount(), 4);
+  EXPECT_EQ(scheduler.currentWorker(), -1);
+
+  // every element visited exactly once, across uneven chunks
+  std::vector<std::atomic<int>> visits(1000);
+  scheduler.parallelFor(0, visits.size(),
+                        [&](size_t begin, size_t end) {
+                          for (size_t i = begin; i != end; ++i) {
+                            ++visits[i];
+                          }
+                        },
+                        7);
+  for (const std::atomic<int>& count : visits) {
+    EXPECT_EQ(count.load(), 1);
+  }
+
+  // tasks spawning tasks into the worker deques, waited for from inside
+  std::atomic<int> leaves{0};
+  TaskGroup group;
+  for (int i = 0; i != 16; ++i) {
+    scheduler.submit(
+        [&]() {
+          TaskGroup nested;
+          for (int j = 0; j != 16; ++j) {
+            scheduler.submit([&]() { ++leaves; }, TaskPriority::Low,
+                             &nested);
+          }
+          nested.wait();
+          // nested loops don't deadlock either
+          scheduler.parallelFor(0, 64, [&](size_t, size_t) {});
+        },
+        TaskPriority::Normal, &group);
+  }
+  group.wait();
+  EXPECT_EQ(group.pendingTasks(), 0);
+  EXPECT_EQ(leaves.load(), 16 * 16);
+
+  // results and exceptions come back through the future
+  std::future<int> answer = scheduler.async([]() { return 42; });
+  std::future<void> failure = scheduler.async(
+      []() { throw std::runtime_error{"expected"}; }, TaskPriority::High);
+  EXPECT_EQ(answer.get(), 42);
+  EXPECT_THROW(failure.get(), std::runtime_error);
+
+  std::atomic<int> detached{0};
+  for (int i = 0; i != 100; ++i) {
+    scheduler.submit([&]() { ++detached; });
+  }
+  scheduler.waitIdle();
+  EXPECT_EQ(detached.load(), 100);
+}
+
+TEST(CoreTest, TaskSchedulerPriorityTest) {
+  TaskSchedulerConfiguration configuration;
+  configuration.threadCount = 1;
+  TaskScheduler scheduler{configuration};
+
+  // hold the only worker so everything below queues up behind it
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<bool> blocked{false};
+  scheduler.submit([&blocked, released]() {
+    blocked = true;
+    released.wait();
+  });
+  while (!blocked) {
+    std::this_thread::yield();
+  }
+
+  std::mutex mutex;
+  std::vector<int> order;
+  TaskGroup group;
+  for (TaskPriority priority :
+       {TaskPriority::Low, TaskPriority::Normal, TaskPriority::High}) {
+    scheduler.submit(
+        [&, priority]() {
+          std::lock_guard<std::mutex> lock{mutex};
+          order.push_back(int(priority));
+        },
+        priority, &group);
+  }
+  release.set_value();
+  // not group.wait(), which would take tasks on this thread as well
+  scheduler.waitIdle();
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+
+  // the process-wide scheduler can only be configured before it exists
+  TaskScheduler::global();
+  EXPECT_FALSE(TaskScheduler::setGlobalConfiguration(configuration));
+}
+
+TEST(CoreTest, TopologyTest) {
+  EXPECT_EQ(parseCpuList("0-3,8,10-11\n"),
+            (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_TRUE(parseCpuList("").empty());
+
+  // a device directory laid out like sysfs
+  char directory[] = "/tmp/esp_topology_XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+  const std::string device = directory;
+  std::ofstream{device + "/numa_node"} << "1\n";
+  std::ofstream{device + "/local_cpulist"} << "4-5\n";
+  const DeviceLocality locality = deviceLocality(device);
+  EXPECT_EQ(locality.numaNode, 1);
+  EXPECT_EQ(locality.cpus, (std::vector<int>{4, 5}));
+
+  // single-node systems report -1
+  std::ofstream{device + "/numa_node"} << "-1\n";
+  EXPECT_EQ(deviceLocality(device).numaNode, -1);
+  std::remove((device + "/numa_node").c_str());
+  std::remove((device + "/local_cpulist").c_str());
+  rmdir(directory);
+
+  EXPECT_EQ(deviceLocality(device).numaNode, -1);
+  EXPECT_TRUE(deviceLocality(device).cpus.empty());
+  EXPECT_TRUE(pciDeviceLocality("ffff:ff:1f.7").cpus.empty());
+  EXPECT_TRUE(drmDeviceLocality("/dev/dri/nonexistent").cpus.empty());
+  EXPECT_FALSE(pinCurrentThread({}));
+  EXPECT_FALSE(preferMemoryNode(-1));
+}
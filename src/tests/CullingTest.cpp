@@ -7,14 +7,24 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/GL/SampleQuery.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <string>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/CullingBVH.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/OcclusionCuller.h"
+#include "esp/gfx/PotentiallyVisibleSet.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
@@ -37,12 +47,18 @@ struct CullingTest : Cr::TestSuite::Tester {
   // tests
   void computeAbsoluteAABB();
   void frustumCulling();
+  void cullingBVH();
+  void occlusionCulling();
+  void potentiallyVisibleSet();
 };
 
 CullingTest::CullingTest() {
   // clang-format off
   addTests({&CullingTest::computeAbsoluteAABB,
-            &CullingTest::frustumCulling});
+            &CullingTest::frustumCulling,
+            &CullingTest::cullingBVH,
+            &CullingTest::occlusionCulling,
+            &CullingTest::potentiallyVisibleSet});
   // clang-format on
 }
 
@@ -259,7 +275,253 @@ void CullingTest::frustumCulling() {
       renderCamera.draw(drawables, true /* enable frustum culling */);
   target->renderExit();
   CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
+
+  // ============== Test 4 ==================
+  // state sorting draws the same drawables and never needs more shader
+  // changes than the scene graph order
+  renderCamera.resetDrawStatistics();
+  target->renderEnter();
+  renderCamera.draw(drawables, true);
+  target->renderExit();
+  {
+    const auto& statistics = renderCamera.drawStatistics();
+    CORRADE_COMPARE(statistics.drawables, numVisibleObjects);
+    CORRADE_VERIFY(statistics.stateChanges.shader >= 1);
+    CORRADE_VERIFY(statistics.stateChangesSaved.shader >= 0);
+    CORRADE_VERIFY(statistics.stateChanges.mesh <= statistics.drawables);
+  }
+
+  renderCamera.setStateSortingEnabled(false).resetDrawStatistics();
+  target->renderEnter();
+  CORRADE_COMPARE(renderCamera.draw(drawables, true), numVisibleObjects);
+  target->renderExit();
+  CORRADE_COMPARE(renderCamera.drawStatistics().stateChangesSaved.shader, 0);
+}
+
+void CullingTest::cullingBVH() {
+  // a grid of unit boxes, enough for several levels of the hierarchy
+  std::vector<Mn::Range3D> boxes;
+  for (int x = -10; x < 10; ++x) {
+    for (int z = -10; z < 10; ++z) {
+      const Mn::Vector3 min{x * 2.0f, (x + z) % 3 * 1.0f, z * 2.0f};
+      boxes.emplace_back(min, min + Mn::Vector3{1.0f});
+    }
+  }
+  esp::gfx::CullingBVH bvh;
+  bvh.build(boxes);
+  CORRADE_COMPARE(bvh.size(), boxes.size());
+
+  const Mn::Matrix4 projection = Mn::Matrix4::perspectiveProjection(
+      Mn::Deg{60.0f}, 4.0f / 3.0f, 0.1f, 15.0f);
+  const Mn::Matrix4 camera = Mn::Matrix4::lookAt(
+      {-3.0f, 2.0f, -3.0f}, {5.0f, 0.0f, 6.0f}, Mn::Vector3::yAxis());
+  const Mn::Frustum frustum =
+      Mn::Frustum::fromMatrix(projection * camera.inverted());
+
+  // run twice to exercise the cached culling planes as well
+  std::vector<int> planeIndices;
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    CORRADE_ITERATION(iteration);
+    std::vector<bool> visible(boxes.size(), false);
+    bvh.cull(frustum, [&](int index) {
+      CORRADE_VERIFY(!visible[index]);
+      visible[index] = true;
+    });
+    // the same with the planes kept outside of the hierarchy
+    std::vector<bool> visibleConst(boxes.size(), false);
+    static_cast<const esp::gfx::CullingBVH&>(bvh).cull(
+        frustum, [&](int index) { visibleConst[index] = true; },
+        planeIndices);
+    CORRADE_VERIFY(visibleConst == visible);
+
+    size_t numVisible = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      int planeIndex = 0;
+      const bool expected =
+          esp::gfx::testRangeFrustum(boxes[i], frustum, planeIndex) !=
+          esp::gfx::FrustumTestResult::Outside;
+      CORRADE_COMPARE(visible[i], expected);
+      numVisible += expected;
+    }
+    // make sure the test actually culls something
+    CORRADE_VERIFY(numVisible > 0);
+    CORRADE_VERIFY(numVisible < boxes.size());
+  }
+
+  // a single leaf with unused lanes, one box in front of the camera and
+  // two behind it
+  const std::vector<Mn::Range3D> leaf{
+      {{-1.0f, 1.0f, -6.0f}, {0.0f, 2.0f, -5.0f}},
+      {{1.0f, 3.0f, -7.0f}, {1.5f, 3.5f, -6.5f}},
+      {{2.0f, 2.0f, 1.0f}, {3.0f, 3.0f, 2.0f}}};
+  bvh.build(leaf);
+  CORRADE_COMPARE(bvh.size(), leaf.size());
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    CORRADE_ITERATION(iteration);
+    std::vector<int> visible;
+    bvh.cull(frustum, [&](int index) { visible.push_back(index); });
+    std::vector<int> expected;
+    for (int i = 0; i < int(leaf.size()); ++i) {
+      int planeIndex = 0;
+      if (esp::gfx::testRangeFrustum(leaf[i], frustum, planeIndex) !=
+          esp::gfx::FrustumTestResult::Outside) {
+        expected.push_back(i);
+      }
+    }
+    std::sort(visible.begin(), visible.end());
+    CORRADE_VERIFY(visible == expected);
+  }
 }
+
+void CullingTest::occlusionCulling() {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  // must declare these in this order due to avoid deallocation errors
+  ResourceManager resourceManager;
+  SceneManager sceneManager;
+
+  std::string sceneFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/5boxes.glb");
+
+  int sceneID = sceneManager.initSceneGraph();
+  auto& sceneGraph = sceneManager.getSceneGraph(sceneID);
+  esp::scene::SceneNode& sceneRootNode = sceneGraph.getRootNode();
+  auto& drawables = sceneGraph.getDrawables();
+  const esp::assets::AssetInfo info =
+      esp::assets::AssetInfo::fromPath(sceneFile);
+  CORRADE_VERIFY(resourceManager.loadScene(info, &sceneRootNode, &drawables));
+
+  // looking down at box 0, which hides box 1 right below it, see the ground
+  // truth in computeAbsoluteAABB()
+  const Mn::Vector2i size{320, 240};
+  esp::gfx::RenderCamera& renderCamera = sceneGraph.getDefaultRenderCamera();
+  renderCamera.setProjectionMatrix(size.x(), size.y(), 0.01f, 100.0f, 90.0f);
+  renderCamera.node().setTransformation(Mn::Matrix4::lookAt(
+      {0.0f, 10.0f, 0.0f}, {}, -Mn::Vector3::zAxis()));
+  esp::gfx::RenderTarget::uptr target = esp::gfx::RenderTarget::create_unique(
+      size,
+      esp::gfx::calculateDepthUnprojection(renderCamera.projectionMatrix()));
+
+  auto render = [&]() {
+    renderCamera.resetDrawStatistics();
+    target->renderEnter();
+    renderCamera.draw(drawables, true);
+    target->renderExit();
+    Mn::Image2D image{Mn::PixelFormat::RGBA8Unorm, size,
+                      Cr::Containers::Array<char>{
+                          std::size_t(size.product() * 4)}};
+    target->readFrameRgba(image);
+    return image;
+  };
+
+  const Mn::Image2D reference = render();
+  CORRADE_COMPARE(renderCamera.drawStatistics().drawables, 5);
+
+  esp::gfx::OcclusionCuller culler;
+  renderCamera.setOcclusionCuller(&culler);
+  for (int frame = 0; frame < 3; ++frame) {
+    CORRADE_ITERATION(frame);
+    const Mn::Image2D image = render();
+    // the culled drawables don't change the image
+    CORRADE_VERIFY(std::equal(image.data().begin(), image.data().end(),
+                              reference.data().begin()));
+    // the first frame has no visibility to go by, the later ones skip box 1
+    // once the queries of the previous one finished
+    const auto& statistics = renderCamera.drawStatistics();
+    CORRADE_COMPARE(statistics.drawables, frame == 0 ? 5 : 4);
+    CORRADE_COMPARE(statistics.occluded, frame == 0 ? 0 : 1);
+    Mn::GL::Renderer::finish();
+  }
+  renderCamera.setOcclusionCuller(nullptr);
+}
+
+void CullingTest::potentiallyVisibleSet() {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  // must declare these in this order due to avoid deallocation errors
+  ResourceManager resourceManager;
+  SceneManager sceneManager;
+
+  std::string sceneFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/5boxes.glb");
+
+  int sceneID = sceneManager.initSceneGraph();
+  auto& sceneGraph = sceneManager.getSceneGraph(sceneID);
+  esp::scene::SceneNode& sceneRootNode = sceneGraph.getRootNode();
+  auto& drawables = sceneGraph.getDrawables();
+  const esp::assets::AssetInfo info =
+      esp::assets::AssetInfo::fromPath(sceneFile);
+  CORRADE_VERIFY(resourceManager.loadScene(info, &sceneRootNode, &drawables));
+  esp::gfx::RenderCamera& renderCamera = sceneGraph.getDefaultRenderCamera();
+
+  // standing on top of box 0, which hides box 1 right below it, see the
+  // ground truth in computeAbsoluteAABB()
+  esp::gfx::PotentiallyVisibleSet::Settings settings;
+  settings.faceSize = 64;
+  esp::gfx::PotentiallyVisibleSet computed =
+      esp::gfx::PotentiallyVisibleSet::compute(
+          drawables, renderCamera,
+          {{-0.5f, 1.0f, -0.5f}, {0.5f, 1.0f, 0.5f}}, settings);
+  CORRADE_COMPARE(computed.cellCount(), std::size_t(1));
+  CORRADE_COMPARE(computed.drawableCount(), std::size_t(5));
+
+  const std::string filename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "CullingTestPotentiallyVisible.pvs");
+  CORRADE_VERIFY(computed.save(filename));
+  esp::gfx::PotentiallyVisibleSet pvs;
+  CORRADE_VERIFY(pvs.load(filename));
+  CORRADE_COMPARE(pvs.cellCount(), std::size_t(1));
+  CORRADE_COMPARE(pvs.drawableCount(), std::size_t(5));
+
+  const Mn::Vector3 eye{0.0f, 2.5f, 0.0f};
+  const std::vector<bool>* visible = pvs.visibleDrawables(drawables, eye);
+  CORRADE_VERIFY(visible);
+  CORRADE_VERIFY(*visible == *computed.visibleDrawables(drawables, eye));
+  const auto& bounded = drawables.boundedDrawables();
+  for (std::size_t i = 0; i != bounded.size(); ++i) {
+    const Mn::Range3D aabb = *bounded[i].get().getSceneNode().getAbsoluteAABB();
+    CORRADE_ITERATION(aabb);
+    const bool isBox1 = aabb.center().y() < -2.0f && aabb.center().z() < 2.0f;
+    CORRADE_COMPARE((*visible)[i], !isBox1);
+  }
+  // outside of the cell, and above its eye heights
+  CORRADE_VERIFY(!pvs.visibleDrawables(drawables, {4.0f, 2.5f, 0.0f}));
+  CORRADE_VERIFY(!pvs.visibleDrawables(drawables, {0.0f, 10.0f, 0.0f}));
+
+  // looking down from the cell, box 1 is in the frustum but not drawn
+  const Mn::Vector2i size{320, 240};
+  renderCamera.setProjectionMatrix(size.x(), size.y(), 0.01f, 100.0f, 90.0f);
+  renderCamera.node().setTransformation(
+      Mn::Matrix4::lookAt(eye, {}, -Mn::Vector3::zAxis()));
+  esp::gfx::RenderTarget::uptr target = esp::gfx::RenderTarget::create_unique(
+      size,
+      esp::gfx::calculateDepthUnprojection(renderCamera.projectionMatrix()));
+  auto render = [&]() {
+    renderCamera.resetDrawStatistics();
+    target->renderEnter();
+    renderCamera.draw(drawables, true);
+    target->renderExit();
+    Mn::Image2D image{Mn::PixelFormat::RGBA8Unorm, size,
+                      Cr::Containers::Array<char>{
+                          std::size_t(size.product() * 4)}};
+    target->readFrameRgba(image);
+    return image;
+  };
+
+  const Mn::Image2D reference = render();
+  const int referenceDrawables = renderCamera.drawStatistics().drawables;
+  renderCamera.setPotentiallyVisibleSet(&pvs);
+  const Mn::Image2D image = render();
+  CORRADE_VERIFY(std::equal(image.data().begin(), image.data().end(),
+                            reference.data().begin()));
+  CORRADE_COMPARE(renderCamera.drawStatistics().notPotentiallyVisible, 1);
+  CORRADE_COMPARE(renderCamera.drawStatistics().drawables,
+                  referenceDrawables - 1);
+  renderCamera.setPotentiallyVisibleSet(nullptr);
+}
+
 }  // namespace
 }  // namespace Test
 
@@ -2,14 +2,20 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+#include <tuple>
+
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Math/FunctionsBatch.h>
 #include "esp/core/Utility.h"
+#include "esp/geo/BVH.h"
 #include "esp/geo/CoordinateFrame.h"
+#include "esp/geo/MeshRayCaster.h"
 #include "esp/geo/OBB.h"
+#include "esp/geo/OccupancyGrid.h"
 #include "esp/geo/geo.h"
 
 namespace Cr = Corrade;
@@ -46,6 +52,10 @@ struct GeoTest : Cr::TestSuite::Tester {
   void aabb();
   void obbConstruction();
   void obbFunctions();
+  void bvhQueries();
+  void obbBatchQueries();
+  void voxelizeMesh();
+  void meshRayCaster();
   void coordinateFrame();
   // benchmarks
   void getTransformedBB_standard();
@@ -65,6 +75,10 @@ GeoTest::GeoTest() {
   addTests({&GeoTest::aabb,
             &GeoTest::obbConstruction,
             &GeoTest::obbFunctions,
+            &GeoTest::bvhQueries,
+            &GeoTest::obbBatchQueries,
+            &GeoTest::voxelizeMesh,
+            &GeoTest::meshRayCaster,
             &GeoTest::coordinateFrame});
   addBenchmarks({&GeoTest::getTransformedBB_standard,
                  &GeoTest::getTransformedBB}, 10);
@@ -159,6 +173,200 @@ void GeoTest::obbFunctions() {
   CORRADE_COMPARE_AS(obb2.distance(vec3f(-10, -5, 2)), 1, float);
 }
 
+void GeoTest::bvhQueries() {
+  // random boxes in a 100^3 cube, with an empty one that's never visited
+  std::vector<box3f> boxes;
+  for (int i = 0; i < 1000; ++i) {
+    const vec3f min{float(rand() % 100), float(rand() % 100),
+                    float(rand() % 100)};
+    const vec3f size{float(rand() % 5), float(rand() % 5), float(rand() % 5)};
+    boxes.emplace_back(min, min + size);
+  }
+  boxes.emplace_back();
+  const BVH bvh{boxes};
+  CORRADE_COMPARE(bvh.size(), boxes.size() - 1);
+
+  // same results as a linear scan
+  for (int i = 0; i < 100; ++i) {
+    const vec3f p{float(rand() % 100), float(rand() % 100),
+                  float(rand() % 100)};
+    std::vector<uint32_t> containing, withinRadius;
+    bvh.visitContaining(p, [&](uint32_t j) { containing.push_back(j); });
+    bvh.visitWithinRadius(p, 5.0f,
+                          [&](uint32_t j) { withinRadius.push_back(j); });
+    std::sort(containing.begin(), containing.end());
+    std::sort(withinRadius.begin(), withinRadius.end());
+
+    std::vector<uint32_t> expectedContaining, expectedWithinRadius;
+    for (uint32_t j = 0; j < boxes.size() - 1; ++j) {
+      if (boxes[j].contains(p)) {
+        expectedContaining.push_back(j);
+      }
+      if (boxes[j].squaredExteriorDistance(p) <= 25.0f) {
+        expectedWithinRadius.push_back(j);
+      }
+    }
+    CORRADE_VERIFY(containing == expectedContaining);
+    CORRADE_VERIFY(withinRadius == expectedWithinRadius);
+  }
+}
+
+void GeoTest::obbBatchQueries() {
+  std::vector<OBB> boxes;
+  for (int j = 0; j < 10; ++j) {
+    const vec3f center{float(rand() % 20), float(rand() % 20),
+                       float(rand() % 20)};
+    const vec3f dimensions{1.0f + rand() % 5, 1.0f + rand() % 5,
+                           1.0f + rand() % 5};
+    const Mn::Quaternion rotation = esp::core::randomRotation();
+    boxes.emplace_back(center, dimensions,
+                       Eigen::Map<const quatf>(rotation.data()));
+  }
+  SoAPoints points;
+  for (int i = 0; i < 500; ++i) {
+    points.push_back(vec3f{(rand() % 2000) / 100.0f, (rand() % 2000) / 100.0f,
+                           (rand() % 2000) / 100.0f});
+  }
+
+  // same results as the point-by-point functions
+  const std::vector<uint8_t> contains = batchContains(boxes, points);
+  const std::vector<float> distances = batchDistance(boxes, points);
+  for (size_t j = 0; j < boxes.size(); ++j) {
+    const SoAPoints closest = batchClosestPoint(boxes[j], points);
+    for (size_t i = 0; i < points.size(); ++i) {
+      const vec3f p{points.x[i], points.y[i], points.z[i]};
+      CORRADE_COMPARE(bool(contains[j * points.size() + i]),
+                      boxes[j].contains(p));
+      CORRADE_COMPARE_WITH(distances[j * points.size() + i],
+                           boxes[j].distance(p),
+                           Cr::TestSuite::Compare::around(1.0e-4f));
+      const vec3f expected = boxes[j].closestPoint(p);
+      CORRADE_VERIFY(
+          (vec3f{closest.x[i], closest.y[i], closest.z[i]} - expected).norm() <
+          1.0e-4f);
+    }
+  }
+}
+
+void GeoTest::voxelizeMesh() {
+  // a right triangle on the floor covers the voxels with x + z <= 4
+  {
+    const OccupancyGrid grid = esp::geo::voxelizeMesh(
+        {{1, 2, 3}, {5, 2, 3}, {1, 2, 7}}, {0, 1, 2}, 1.0f);
+    CORRADE_VERIFY(grid.origin.isApprox(vec3f{1, 2, 3}));
+    CORRADE_VERIFY(grid.dimensions == vec3i(5, 1, 5));
+    CORRADE_COMPARE(grid.voxels.rows(), 15);
+    for (int x = 0; x < 5; ++x) {
+      for (int z = 0; z < 5; ++z) {
+        CORRADE_COMPARE(grid.isOccupied({x, 0, z}), x + z <= 4);
+      }
+    }
+    CORRADE_VERIFY(!grid.isOccupied({0, 1, 0}));
+    CORRADE_VERIFY(!grid.isOccupied({-1, 0, 0}));
+    CORRADE_VERIFY(grid.toVoxel({2.5f, 2.1f, 6.9f}) == vec3i(1, 0, 3));
+
+    const std::vector<uint8_t> dense = grid.toDense();
+    CORRADE_COMPARE(dense.size(), 25);
+    CORRADE_COMPARE(std::count(dense.begin(), dense.end(), 1), 15);
+    CORRADE_VERIFY(dense[4] && !dense[4 + 5]);
+  }
+
+  // a slanted triangle leaves out the voxels of its bounds the plane misses
+  {
+    const OccupancyGrid grid = esp::geo::voxelizeMesh(
+        {{3, 0, 0}, {0, 3, 0}, {0, 0, 3}}, {0, 1, 2}, 1.0f);
+    CORRADE_VERIFY(grid.isOccupied({0, 0, 0}));
+    CORRADE_VERIFY(grid.isOccupied({1, 1, 1}));
+    CORRADE_VERIFY(grid.isOccupied({0, 0, 2}));
+    CORRADE_VERIFY(!grid.isOccupied({2, 2, 0}));
+    CORRADE_VERIFY(!grid.isOccupied({2, 2, 2}));
+    // sorted by Z, then Y, then X
+    for (long i = 1; i < grid.voxels.rows(); ++i) {
+      const vec3i a = grid.voxels.row(i - 1).transpose();
+      const vec3i b = grid.voxels.row(i).transpose();
+      CORRADE_VERIFY(std::make_tuple(a.z(), a.y(), a.x()) <
+                     std::make_tuple(b.z(), b.y(), b.x()));
+    }
+  }
+}
+
+void GeoTest::meshRayCaster() {
+  // a floor of 10x10 unit quads at y = 0 with the ID of each quad, enough
+  // triangles for a few levels of the hierarchy, and a wall at z = -3
+  std::vector<vec3f> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> objectIds;
+  for (int z = 0; z < 10; ++z) {
+    for (int x = 0; x < 10; ++x) {
+      const uint32_t first = vertices.size();
+      vertices.push_back({float(x), 0, float(z)});
+      vertices.push_back({float(x + 1), 0, float(z)});
+      vertices.push_back({float(x + 1), 0, float(z + 1)});
+      vertices.push_back({float(x), 0, float(z + 1)});
+      for (uint32_t i : {0, 1, 2, 0, 2, 3}) {
+        indices.push_back(first + i);
+      }
+      objectIds.insert(objectIds.end(), 2, uint32_t(10 * z + x));
+    }
+  }
+  const uint32_t wall = vertices.size();
+  vertices.push_back({-5, -5, -3});
+  vertices.push_back({15, -5, -3});
+  vertices.push_back({5, 15, -3});
+  indices.insert(indices.end(), {wall, wall + 1, wall + 2});
+  objectIds.push_back(1000);
+
+  const MeshRayCaster caster{vertices, indices, objectIds};
+  CORRADE_COMPARE(caster.triangleCount(), 201);
+
+  // straight down onto every quad, the distance scales with the direction
+  for (int z = 0; z < 10; ++z) {
+    for (int x = 0; x < 10; ++x) {
+      const MeshRayCaster::Hit hit = caster.castRay(
+          {x + 0.3f, 5.0f, z + 0.6f}, {0, -2.0f, 0}, 0.0f, 100.0f);
+      CORRADE_COMPARE(hit.distance, 2.5f);
+      CORRADE_COMPARE(caster.objectId(hit.triangle), 10 * z + x);
+    }
+  }
+
+  // the closest of the floor and the wall behind it
+  {
+    const MeshRayCaster::Hit hit =
+        caster.castRay({5.5f, 1.0f, 5.0f}, {0, -0.5f, -1.0f}, 0.0f, 100.0f);
+    CORRADE_COMPARE(hit.distance, 2.0f);
+    CORRADE_COMPARE(caster.objectId(hit.triangle), 35);
+  }
+  {
+    const MeshRayCaster::Hit hit =
+        caster.castRay({5.5f, 1.0f, 5.0f}, {0, 0, -1.0f}, 0.0f, 100.0f);
+    CORRADE_COMPARE(hit.distance, 8.0f);
+    CORRADE_COMPARE(caster.objectId(hit.triangle), 1000);
+  }
+
+  // hits outside of the distance range and misses
+  {
+    const MeshRayCaster::Hit hit =
+        caster.castRay({5.5f, 1.0f, 5.0f}, {0, -1.0f, 0}, 1.5f, 100.0f);
+    CORRADE_COMPARE(hit.triangle, MeshRayCaster::NoHit);
+    CORRADE_COMPARE(caster.objectId(hit.triangle), 0);
+  }
+  {
+    const MeshRayCaster::Hit hit =
+        caster.castRay({5.5f, 1.0f, 5.0f}, {0, 0, -1.0f}, 0.0f, 7.0f);
+    CORRADE_COMPARE(hit.triangle, MeshRayCaster::NoHit);
+  }
+  {
+    const MeshRayCaster::Hit hit =
+        caster.castRay({5.5f, 1.0f, 5.0f}, {0, 1.0f, 0}, 0.0f, 100.0f);
+    CORRADE_COMPARE(hit.triangle, MeshRayCaster::NoHit);
+  }
+
+  // an empty mesh never hits
+  CORRADE_COMPARE(
+      MeshRayCaster{}.castRay({0, 0, 0}, {0, 0, -1.0f}, 0.0f, 1.0f).triangle,
+      MeshRayCaster::NoHit);
+}
+
 void GeoTest::coordinateFrame() {
   const vec3f origin(1, -2, 3);
   const vec3f up(0, 0, 1);
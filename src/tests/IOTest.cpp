@@ -3,6 +3,11 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <gtest/gtest.h>
+#include <Corrade/Utility/Directory.h>
+#include <thread>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 #include "esp/core/esp.h"
 #include "esp/io/io.h"
 
@@ -94,3 +99,60 @@ TEST(IOTest, tokenizeTest) {
   const auto& t3 = tokenize(file, ",|", 0, true);
   EXPECT_EQ((std::vector<std::string>{"", "a", "bb", "c"}), t3);
 }
+
+TEST(IOTest, writeFileAtomicallyTest) {
+  namespace Directory = Corrade::Utility::Directory;
+  const std::string directory =
+      Directory::join(Directory::tmp(), "IOTest/writeFileAtomically");
+  const std::string filename = Directory::join(directory, "file.bin");
+  Directory::rm(filename);
+
+  // writers of the same file at the same time, every one with contents of
+  // its own, don't clobber each other
+  constexpr int WriterCount = 8;
+  constexpr size_t Size = 1 << 20;
+  std::vector<std::thread> writers;
+  for (int i = 0; i != WriterCount; ++i) {
+    writers.emplace_back([&, i]() {
+      const std::vector<char> data(Size, char('a' + i));
+      EXPECT_TRUE(writeFileAtomically(filename, [&](std::FILE* fp) {
+        return std::fwrite(data.data(), 1, data.size(), fp) == data.size();
+      }));
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  const std::string contents = Directory::readString(filename);
+  ASSERT_EQ(contents.size(), Size);
+  EXPECT_EQ(contents, std::string(Size, contents[0]));
+  // no temporary files left behind
+  EXPECT_EQ(Directory::list(directory, Directory::Flag::SkipDotAndDotDot),
+            std::vector<std::string>{"file.bin"});
+
+  // an aborted write leaves the previous file
+  EXPECT_FALSE(writeFileAtomically(filename, [](std::FILE* fp) {
+    std::fputs("partial", fp);
+    return false;
+  }));
+  EXPECT_EQ(Directory::readString(filename), contents);
+  EXPECT_EQ(Directory::list(directory, Directory::Flag::SkipDotAndDotDot),
+            std::vector<std::string>{"file.bin"});
+
+#ifndef _WIN32
+  // a replaced file keeps its permissions, a new one gets the umask ones
+  const auto write = [](std::FILE* fp) { return std::fputs("x", fp) >= 0; };
+  struct stat status;
+  ASSERT_EQ(chmod(filename.c_str(), 0640), 0);
+  ASSERT_TRUE(writeFileAtomically(filename, write));
+  ASSERT_EQ(stat(filename.c_str(), &status), 0);
+  EXPECT_EQ(status.st_mode & 0777, 0640u);
+
+  const mode_t mask = umask(0);
+  umask(mask);
+  Directory::rm(filename);
+  ASSERT_TRUE(writeFileAtomically(filename, write));
+  ASSERT_EQ(stat(filename.c_str(), &status), 0);
+  EXPECT_EQ(status.st_mode & 0777, 0666u & ~mask);
+#endif
+}
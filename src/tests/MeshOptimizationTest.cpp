@@ -0,0 +1,151 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/TestSuite/Tester.h>
+
+#include "esp/assets/MeshOptimization.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using namespace esp::assets;
+
+namespace Test {
+
+struct MeshOptimizationTest : Cr::TestSuite::Tester {
+  explicit MeshOptimizationTest();
+
+  void vertexCache();
+  void overdraw();
+  void vertexFetch();
+  void clusterVertices();
+
+  // grid of GridSize x GridSize quads, triangles in random order
+  static constexpr int GridSize = 32;
+  std::vector<Mn::Vector3> positions_;
+  std::vector<Mn::UnsignedInt> indices_;
+};
+
+MeshOptimizationTest::MeshOptimizationTest() {
+  addTests({&MeshOptimizationTest::vertexCache,
+            &MeshOptimizationTest::overdraw,
+            &MeshOptimizationTest::vertexFetch,
+            &MeshOptimizationTest::clusterVertices});
+
+  for (int y = 0; y <= GridSize; ++y) {
+    for (int x = 0; x <= GridSize; ++x) {
+      positions_.emplace_back(float(x), float(y), 0.0f);
+    }
+  }
+  std::vector<std::array<Mn::UnsignedInt, 3>> triangles;
+  for (Mn::UnsignedInt y = 0; y != GridSize; ++y) {
+    for (Mn::UnsignedInt x = 0; x != GridSize; ++x) {
+      const Mn::UnsignedInt v = y * (GridSize + 1) + x;
+      triangles.push_back({v, v + 1, v + GridSize + 2});
+      triangles.push_back({v, v + GridSize + 2, v + GridSize + 1});
+    }
+  }
+  std::shuffle(triangles.begin(), triangles.end(), std::mt19937{42});
+  for (const auto& triangle : triangles) {
+    indices_.insert(indices_.end(), triangle.begin(), triangle.end());
+  }
+}
+
+// triangles in a canonical order, to check none got lost or changed
+std::vector<std::array<Mn::UnsignedInt, 3>> sortedTriangles(
+    const std::vector<Mn::UnsignedInt>& indices) {
+  std::vector<std::array<Mn::UnsignedInt, 3>> triangles;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    triangles.push_back({indices[i], indices[i + 1], indices[i + 2]});
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+void MeshOptimizationTest::vertexCache() {
+  std::vector<Mn::UnsignedInt> indices = indices_;
+  const float before = averageCacheMissRatio(indices, positions_.size());
+  optimizeVertexCache(indices, positions_.size());
+  const float after = averageCacheMissRatio(indices, positions_.size());
+
+  CORRADE_COMPARE_AS(before, 2.5f, Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE_AS(after, 1.0f, Cr::TestSuite::Compare::Less);
+  CORRADE_VERIFY(sortedTriangles(indices) == sortedTriangles(indices_));
+}
+
+void MeshOptimizationTest::overdraw() {
+  std::vector<Mn::UnsignedInt> indices = indices_;
+  optimizeVertexCache(indices, positions_.size());
+  const float cached = averageCacheMissRatio(indices, positions_.size());
+  optimizeOverdraw(indices, Cr::Containers::arrayView(positions_));
+
+  // only whole clusters move, which costs no cache hits
+  CORRADE_COMPARE_AS(averageCacheMissRatio(indices, positions_.size()),
+                     cached + 0.01f, Cr::TestSuite::Compare::Less);
+  CORRADE_VERIFY(sortedTriangles(indices) == sortedTriangles(indices_));
+}
+
+void MeshOptimizationTest::vertexFetch() {
+  // an extra vertex nothing references
+  std::vector<Mn::Vector3> positions = positions_;
+  positions.emplace_back(-1.0f, -1.0f, 0.0f);
+  std::vector<Mn::UnsignedInt> indices = indices_;
+  const Cr::Containers::Array<Mn::UnsignedInt> remap =
+      optimizeVertexFetch(indices, positions.size());
+
+  // vertices are first used in order
+  Mn::UnsignedInt next = 0;
+  for (Mn::UnsignedInt index : indices) {
+    CORRADE_COMPARE_AS(index, next + 1, Cr::TestSuite::Compare::Less);
+    next = std::max(next, index + 1);
+  }
+  CORRADE_COMPARE(remap[positions.size() - 1], positions.size() - 1);
+
+  // the remapped mesh has the same triangles in the same order
+  const std::vector<Mn::Vector3> original = positions;
+  remapVertices(remap, positions);
+  for (size_t i = 0; i != indices.size(); ++i) {
+    CORRADE_COMPARE(positions[indices[i]], original[indices_[i]]);
+  }
+}
+
+void MeshOptimizationTest::clusterVertices() {
+  // left and right half of the grid belong to different objects
+  std::vector<Mn::UnsignedShort> groups;
+  for (const Mn::Vector3& position : positions_) {
+    groups.push_back(position.x() < GridSize / 2 ? 0 : 1);
+  }
+  const VertexClusters clusters = esp::assets::clusterVertices(
+      indices_, Cr::Containers::arrayView(positions_), 4.0f, groups);
+
+  // cells of 4x4 quads, split where the groups meet
+  CORRADE_COMPARE_AS(clusters.clusterCount, positions_.size() / 8,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_COMPARE_AS(clusters.indices.size(), indices_.size() / 8,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_VERIFY(!clusters.indices.empty());
+  std::vector<int> clusterGroups(clusters.clusterCount, -1);
+  for (size_t v = 0; v != positions_.size(); ++v) {
+    int& group = clusterGroups[clusters.vertexClusters[v]];
+    if (group == -1) {
+      group = groups[v];
+    }
+    CORRADE_COMPARE(group, groups[v]);
+  }
+  for (Mn::UnsignedInt index : clusters.indices) {
+    CORRADE_COMPARE_AS(index, clusters.clusterCount,
+                       Cr::TestSuite::Compare::Less);
+  }
+}
+
+}  // namespace Test
+
+CORRADE_TEST_MAIN(Test::MeshOptimizationTest)
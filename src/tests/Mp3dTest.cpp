@@ -2,9 +2,13 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <cstring>
+#include <fstream>
+
 #include <Corrade/Utility/Directory.h>
 #include <gtest/gtest.h>
 
+#include "esp/assets/Mp3dInstanceMeshData.h"
 #include "esp/scene/SemanticScene.h"
 
 #include "configure.h"
@@ -49,3 +53,69 @@ TEST(Mp3dTest, Load) {
     }
   }
 }
+
+TEST(Mp3dTest, LoadSegmentationPly) {
+  const std::string plyFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "Mp3dTestSegmentation.ply");
+  {
+    // two triangles sharing an edge, laid out as in MP3D house segmentations
+    std::ofstream f(plyFile, std::ios::out | std::ios::binary);
+    f << "ply\n"
+      << "format binary_little_endian 1.0\n"
+      << "element vertex 4\n"
+      << "property float x\nproperty float y\nproperty float z\n"
+      << "property float nx\nproperty float ny\nproperty float nz\n"
+      << "property float tx\nproperty float ty\n"
+      << "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+      << "element face 2\n"
+      << "property list uchar int vertex_indices\n"
+      << "property int material_id\n"
+      << "property int segment_id\n"
+      << "property int category_id\n"
+      << "end_header\n";
+    for (int i = 0; i < 4; ++i) {
+      const float position[]{float(i), float(2 * i), float(3 * i)};
+      const float normalTexCoords[5]{};
+      const uint8_t rgb[]{uint8_t(i), uint8_t(i + 10), uint8_t(i + 20)};
+      f.write(reinterpret_cast<const char*>(position), sizeof(position));
+      f.write(reinterpret_cast<const char*>(normalTexCoords),
+              sizeof(normalTexCoords));
+      f.write(reinterpret_cast<const char*>(rgb), sizeof(rgb));
+    }
+    const int32_t faces[2][6]{{0, 1, 2, 7, 8, 9}, {2, 1, 3, -1, 5, 6}};
+    for (const auto& face : faces) {
+      f.put(3);
+      f.write(reinterpret_cast<const char*>(face), sizeof(face));
+    }
+  }
+
+  assets::Mp3dInstanceMeshData mesh;
+  ASSERT_TRUE(mesh.loadMp3dPLY(plyFile));
+  const auto& vbo = mesh.getVertexBufferObjectCPU();
+  const auto& cbo = mesh.getColorBufferObjectCPU();
+  ASSERT_EQ(vbo.size(), 4);
+  ASSERT_EQ(cbo.size(), 4);
+  EXPECT_EQ(vbo[3], vec3f(3.0f, 6.0f, 9.0f));
+  EXPECT_EQ(cbo[3], vec3uc(3, 13, 23));
+  const auto& indices = mesh.getCollisionMeshData().indices;
+  ASSERT_EQ(indices.size(), 6);
+  EXPECT_EQ(indices[3], 2);
+  EXPECT_EQ(indices[5], 3);
+
+  // the material ID is the segment ID, faces without one have no object
+  const std::string semMeshFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "Mp3dTestSemantic.ply");
+  EXPECT_FALSE(mesh.saveSemMeshPLY(semMeshFile, {}));
+  ASSERT_TRUE(mesh.saveSemMeshPLY(semMeshFile, {{7, 42}}));
+  const std::string semMesh = Cr::Utility::Directory::readString(semMeshFile);
+  const size_t body = semMesh.find("end_header\n") + 11;
+  ASSERT_EQ(semMesh.size(), body + 4 * 15 + 2 * 17);
+  int32_t objectId;
+  std::memcpy(&objectId, semMesh.data() + body + 4 * 15 + 13, 4);
+  EXPECT_EQ(objectId, 42);
+  std::memcpy(&objectId, semMesh.data() + body + 4 * 15 + 17 + 13, 4);
+  EXPECT_EQ(objectId, ID_UNDEFINED);
+
+  Cr::Utility::Directory::rm(plyFile);
+  Cr::Utility::Directory::rm(semMeshFile);
+}
@@ -2,13 +2,18 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <gtest/gtest.h>
+#include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "esp/sim/Simulator.h"
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/InstancedDrawable.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/scene/SceneManager.h"
 
@@ -129,6 +134,16 @@ TEST_F(PhysicsManagerTest, JoinCompound) {
       if (i == 1) {
         // when collision meshes are joined, objects should be stable
         ASSERT_EQ(numActiveObjects, 0);
+
+        // and further steps only advance time
+        const double worldTime = physicsManager_->getWorldTime();
+        physicsManager_->stepPhysics(0.1);
+        const esp::physics::StepStatistics& stats =
+            physicsManager_->getStepStatistics();
+        ASSERT_TRUE(stats.skipped);
+        ASSERT_EQ(stats.sleepingObjects, num_objects);
+        ASSERT_EQ(stats.syncedObjects, 0);
+        ASSERT_GT(physicsManager_->getWorldTime(), worldTime);
       }
 
       for (int o : objectIds) {
@@ -317,6 +332,224 @@ TEST_F(PhysicsManagerTest, BulletCompoundShapeMargins) {
     ASSERT_EQ(AabbOb2, objectGroundTruth);
   }
 }
+
+TEST_F(PhysicsManagerTest, BulletSharedCollisionShapes) {
+  // instances of a template share their hulls, changing the margin of one
+  // doesn't affect the others
+  LOG(INFO) << "Starting physics test: BulletSharedCollisionShapes";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+
+  initScene(objectFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    physicsObjectAttributes->setRenderMeshHandle(objectFile);
+    physicsObjectAttributes->setMargin(0.1);
+    physicsObjectAttributes->setJoinCollisionMeshes(false);
+    resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+    esp::assets::PhysicsObjectAttributes::ptr objectTemplate =
+        resourceManager_.getPhysicsObjectAttributes(objectFile);
+
+    auto* drawables = &sceneManager_.getSceneGraph(sceneID_).getDrawables();
+    esp::physics::BulletPhysicsManager* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+
+    std::vector<int> objectIds;
+    for (int i = 0; i < 3; ++i) {
+      objectIds.push_back(physicsManager_->addObject(objectFile, drawables));
+    }
+    ASSERT_EQ(bPhysManager->getCollisionShapeCacheSize(), 1);
+
+    Magnum::Range3D objectGroundTruth({-1.1, -1.1, -1.1}, {1.1, 1.1, 1.1});
+    for (int objectId : objectIds) {
+      ASSERT_EQ(bPhysManager->getCollisionShapeAabb(objectId),
+                objectGroundTruth);
+    }
+
+    bPhysManager->setMargin(objectIds[0], 0.2);
+    ASSERT_EQ(bPhysManager->getCollisionShapeAabb(objectIds[1]),
+              objectGroundTruth);
+    ASSERT_NE(bPhysManager->getCollisionShapeAabb(objectIds[0]),
+              objectGroundTruth);
+
+    // a different scale gets its own shapes
+    objectTemplate->setScale({2.0, 2.0, 2.0});
+    int scaledId = physicsManager_->addObject(objectFile, drawables);
+    ASSERT_EQ(bPhysManager->getCollisionShapeCacheSize(), 2);
+    ASSERT_EQ(bPhysManager->getCollisionShapeAabb(scaledId),
+              Magnum::Range3D({-2.1, -2.1, -2.1}, {2.1, 2.1, 2.1}));
+  }
+}
+
+TEST_F(PhysicsManagerTest, BulletBatchedQueries) {
+  // batched ray casts report the hit object and contact tests match the
+  // single-object version
+  LOG(INFO) << "Starting physics test: BulletBatchedQueries";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+
+  initScene("NONE");
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    physicsObjectAttributes->setRenderMeshHandle(objectFile);
+    resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+
+    auto* drawables = &sceneManager_.getSceneGraph(sceneID_).getDrawables();
+    int objectId = physicsManager_->addObject(objectFile, drawables);
+    int otherId = physicsManager_->addObject(objectFile, drawables);
+    physicsManager_->setTranslation(otherId, {10.0, 0.0, 0.0});
+
+    std::vector<Magnum::Vector3> origins{{0.0, 5.0, 0.0}, {10.0, 5.0, 0.0},
+                                         {5.0, 5.0, 0.0}};
+    std::vector<Magnum::Vector3> directions(3, Magnum::Vector3{0.0, -1.0, 0.0});
+    std::vector<esp::physics::RayHit> hits(3);
+    physicsManager_->castRays(origins, directions, 100.0, hits);
+    ASSERT_EQ(hits[0].objectID, objectId);
+    ASSERT_EQ(hits[1].objectID, otherId);
+    ASSERT_LT(hits[0].distance, 5.0);
+    ASSERT_GT(hits[0].normal.y(), 0.9);
+    ASSERT_EQ(hits[2].objectID, esp::ID_UNDEFINED);
+    ASSERT_EQ(hits[2].distance, std::numeric_limits<float>::infinity());
+
+    std::vector<int> ids{objectId, otherId};
+    bool contacts[2]{true, true};
+    physicsManager_->contactTests(ids, contacts);
+    ASSERT_FALSE(contacts[0]);
+    ASSERT_FALSE(contacts[1]);
+
+    physicsManager_->setTranslation(otherId, {0.5, 0.0, 0.0});
+    physicsManager_->contactTests(ids, contacts);
+    ASSERT_TRUE(contacts[0]);
+    ASSERT_EQ(contacts[1], physicsManager_->contactTest(otherId));
+  }
+}
+
+TEST_F(PhysicsManagerTest, BulletCollisionHullCache) {
+  // hulls stored on first load give the same collision shape when loaded
+  LOG(INFO) << "Starting physics test: BulletCollisionHullCache";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/nested_box.glb");
+  std::string hullCacheFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "PhysicsTest_nested_box.hulls");
+  Cr::Utility::Directory::rm(hullCacheFile);
+
+  Magnum::Range3D aabbs[2];
+  for (int i = 0; i < 2; ++i) {
+    initScene("NONE");
+    if (physicsManager_->getPhysicsSimulationLibrary() !=
+        PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+      return;
+    }
+    esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    physicsObjectAttributes->setRenderMeshHandle(objectFile);
+    physicsObjectAttributes->setJoinCollisionMeshes(false);
+    physicsObjectAttributes->setCollisionHullCache(hullCacheFile);
+    resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+
+    auto* drawables = &sceneManager_.getSceneGraph(sceneID_).getDrawables();
+    int objectId = physicsManager_->addObject(objectFile, drawables);
+    ASSERT_TRUE(Cr::Utility::Directory::exists(hullCacheFile));
+    aabbs[i] = static_cast<esp::physics::BulletPhysicsManager*>(
+                   physicsManager_.get())
+                   ->getCollisionShapeAabb(objectId);
+  }
+  ASSERT_EQ(aabbs[0], aabbs[1]);
+  Cr::Utility::Directory::rm(hullCacheFile);
+}
+
+TEST_F(PhysicsManagerTest, BulletCollisionFiltering) {
+  // props in a group excluded by their own mask don't collide with each
+  // other, but still with default objects
+  LOG(INFO) << "Starting physics test: BulletCollisionFiltering";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+  std::string propFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/nested_box.glb");
+
+  initScene("NONE");
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    esp::assets::PhysicsObjectAttributes::ptr objectAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    objectAttributes->setRenderMeshHandle(objectFile);
+    resourceManager_.loadObjectTemplate(objectAttributes, objectFile);
+
+    esp::assets::PhysicsObjectAttributes::ptr propAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    propAttributes->setRenderMeshHandle(propFile);
+    propAttributes->setCollisionGroup(4);
+    propAttributes->setCollisionMask(1 | 2);
+    resourceManager_.loadObjectTemplate(propAttributes, propFile);
+
+    auto* drawables = &sceneManager_.getSceneGraph(sceneID_).getDrawables();
+    int propId = physicsManager_->addObject(propFile, drawables);
+    int otherPropId = physicsManager_->addObject(propFile, drawables);
+    ASSERT_FALSE(physicsManager_->contactTest(propId));
+    ASSERT_FALSE(physicsManager_->contactTest(otherPropId));
+
+    physicsManager_->addObject(objectFile, drawables);
+    ASSERT_TRUE(physicsManager_->contactTest(propId));
+    ASSERT_TRUE(physicsManager_->contactTest(otherPropId));
+  }
+}
+
+TEST_F(PhysicsManagerTest, BulletKinematicCollisions) {
+  // kinematic objects without collisions leave the Bullet world, but can
+  // still test their own contacts
+  LOG(INFO) << "Starting physics test: BulletKinematicCollisions";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+
+  initScene("NONE");
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    physicsObjectAttributes->setRenderMeshHandle(objectFile);
+    resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+
+    auto* drawables = &sceneManager_.getSceneGraph(sceneID_).getDrawables();
+    int propId = physicsManager_->addObject(objectFile, drawables);
+    int otherId = physicsManager_->addObject(objectFile, drawables);
+    physicsManager_->setObjectMotionType(propId,
+                                         esp::physics::MotionType::KINEMATIC);
+    physicsManager_->setObjectMotionType(otherId,
+                                         esp::physics::MotionType::KINEMATIC);
+    physicsManager_->setObjectKinematicCollisions(propId, false);
+    ASSERT_FALSE(physicsManager_->getObjectKinematicCollisions(propId));
+
+    // moved purely through its node, the pose is synced on demand
+    physicsManager_->setTranslation(propId, {-0.5, 0.0, 0.0});
+    physicsManager_->setTranslation(otherId, {0.5, 0.0, 0.0});
+    ASSERT_FALSE(physicsManager_->contactTest(otherId));
+    ASSERT_TRUE(physicsManager_->contactTest(propId));
+
+    std::vector<Magnum::Vector3> origins{{-1.3, 5.0, 0.0}};
+    std::vector<Magnum::Vector3> directions{{0.0, -1.0, 0.0}};
+    std::vector<esp::physics::RayHit> hits(1);
+    physicsManager_->castRays(origins, directions, 100.0, hits);
+    ASSERT_EQ(hits[0].objectID, esp::ID_UNDEFINED);
+
+    physicsManager_->setObjectKinematicCollisions(propId, true);
+    ASSERT_TRUE(physicsManager_->contactTest(otherId));
+    physicsManager_->castRays(origins, directions, 100.0, hits);
+    ASSERT_EQ(hits[0].objectID, propId);
+  }
+}
 #endif
 
 TEST_F(PhysicsManagerTest, ConfigurableScaling) {
@@ -652,3 +885,292 @@ TEST_F(PhysicsManagerTest, TestMotionTypes) {
     }
   }
 }
+
+TEST_F(PhysicsManagerTest, InstancedObjectDrawing) {
+  // copies of an object template should share instanced drawables
+  LOG(INFO) << "Starting physics test: InstancedObjectDrawing";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+
+  initScene("NONE");
+  resourceManager_.instancedObjectDrawing(true);
+
+  esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+      esp::assets::PhysicsObjectAttributes::create();
+  physicsObjectAttributes->setRenderMeshHandle(objectFile);
+  resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+
+  auto& drawables = sceneManager_.getSceneGraph(sceneID_).getDrawables();
+  auto countInstances = [&]() {
+    size_t instances = 0;
+    for (size_t i = 0; i < drawables.size(); ++i) {
+      auto instanced =
+          dynamic_cast<esp::gfx::InstancedDrawable*>(&drawables[i]);
+      ASSERT(instanced != nullptr);
+      instances += instanced->instanceCount();
+    }
+    return instances;
+  };
+
+  std::vector<int> objectIds;
+  objectIds.push_back(physicsManager_->addObject(objectFile, &drawables));
+  const size_t drawableCount = drawables.size();
+  const size_t instancesPerObject = countInstances();
+  ASSERT_GT(drawableCount, 0);
+  ASSERT_EQ(instancesPerObject, drawableCount);
+
+  // further copies only add instances, not drawables
+  for (int i = 0; i < 4; ++i) {
+    objectIds.push_back(physicsManager_->addObject(objectFile, &drawables));
+  }
+  ASSERT_EQ(drawables.size(), drawableCount);
+  ASSERT_EQ(countInstances(), 5 * instancesPerObject);
+
+  // removing a copy removes its instances
+  physicsManager_->removeObject(objectIds.back());
+  ASSERT_EQ(drawables.size(), drawableCount);
+  ASSERT_EQ(countInstances(), 4 * instancesPerObject);
+}
+
+TEST_F(PhysicsManagerTest, ConcurrentWorldStepping) {
+  // independent worlds stepped together end up where stepping them one by
+  // one gets them
+  LOG(INFO) << "Starting physics test: ConcurrentWorldStepping";
+
+  std::string sceneFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/scenes/plane.glb");
+  std::string objectFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/objects/sphere.glb");
+
+  struct World {
+    ResourceManager resourceManager;
+    SceneManager sceneManager;
+    PhysicsManager::ptr physicsManager;
+    int objectId;
+  };
+  auto makeWorld = [&](float height) {
+    auto world = std::make_unique<World>();
+    const int sceneID = world->sceneManager.initSceneGraph();
+    auto& sceneGraph = world->sceneManager.getSceneGraph(sceneID);
+    world->resourceManager.loadScene(
+        esp::assets::AssetInfo::fromPath(sceneFile), world->physicsManager,
+        &sceneGraph.getRootNode().createChild(), &sceneGraph.getDrawables(),
+        physicsConfigFile);
+
+    esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+        esp::assets::PhysicsObjectAttributes::create();
+    physicsObjectAttributes->setRenderMeshHandle(objectFile);
+    world->resourceManager.loadObjectTemplate(physicsObjectAttributes,
+                                              objectFile);
+    world->objectId = world->physicsManager->addObject(
+        objectFile, &sceneGraph.getDrawables());
+    world->physicsManager->setTranslation(world->objectId,
+                                          Magnum::Vector3{0.0, height, 0.0});
+    return world;
+  };
+
+  std::vector<std::unique_ptr<World>> serial, concurrent;
+  std::vector<PhysicsManager*> concurrentWorlds;
+  for (int i = 0; i < 4; ++i) {
+    serial.push_back(makeWorld(0.5f + i));
+    concurrent.push_back(makeWorld(0.5f + i));
+    concurrentWorlds.push_back(concurrent.back()->physicsManager.get());
+  }
+  // null entries are skipped
+  concurrentWorlds.push_back(nullptr);
+
+  for (int step = 0; step < 10; ++step) {
+    for (auto& world : serial) {
+      world->physicsManager->stepPhysics(0.1);
+    }
+    PhysicsManager::stepWorlds(concurrentWorlds, 0.1);
+  }
+
+  for (size_t i = 0; i < serial.size(); ++i) {
+    ASSERT_EQ(concurrent[i]->physicsManager->getWorldTime(),
+              serial[i]->physicsManager->getWorldTime());
+    ASSERT_EQ(
+        concurrent[i]->physicsManager->getTranslation(concurrent[i]->objectId),
+        serial[i]->physicsManager->getTranslation(serial[i]->objectId));
+  }
+}
+
+TEST_F(PhysicsManagerTest, SaveRestoreState) {
+  LOG(INFO) << "Starting physics test: SaveRestoreState";
+
+  std::string sceneFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/scenes/plane.glb");
+  std::string objectFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/objects/sphere.glb");
+
+  initScene(sceneFile);
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::NONE) {
+    // nothing moves without a dynamics implementation
+    return;
+  }
+
+  esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+      esp::assets::PhysicsObjectAttributes::create();
+  physicsObjectAttributes->setRenderMeshHandle(objectFile);
+  resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+
+  auto& drawables = sceneManager_.getSceneGraph(sceneID_).getDrawables();
+  const int objectId = physicsManager_->addObject(objectFile, &drawables);
+  physicsManager_->setTranslation(objectId, Magnum::Vector3{0.0, 10.0, 0.0});
+  physicsManager_->stepPhysics(0.1);
+
+  const esp::physics::PhysicsState state = physicsManager_->saveState();
+  ASSERT_EQ(state.objects.size(), 1);
+  ASSERT_EQ(state.worldTime, physicsManager_->getWorldTime());
+  const Magnum::Vector3 savedPosition =
+      physicsManager_->getTranslation(objectId);
+
+  // the object is still falling, so it ends up in the same place when
+  // simulated again from the snapshot
+  physicsManager_->stepPhysics(0.5);
+  const Magnum::Vector3 position = physicsManager_->getTranslation(objectId);
+  ASSERT_NE(position, savedPosition);
+
+  ASSERT_TRUE(physicsManager_->restoreState(state));
+  ASSERT_EQ(physicsManager_->getWorldTime(), state.worldTime);
+  ASSERT_EQ(physicsManager_->getTranslation(objectId), savedPosition);
+  ASSERT_EQ(physicsManager_->getLinearVelocity(objectId),
+            state.objects[0].linearVelocity);
+
+  physicsManager_->stepPhysics(0.5);
+  ASSERT_LE((physicsManager_->getTranslation(objectId) - position).length(),
+            1.0e-4);
+
+  // a snapshot of different objects is rejected
+  const int otherObjectId = physicsManager_->addObject(objectFile, &drawables);
+  ASSERT_FALSE(physicsManager_->restoreState(state));
+  physicsManager_->removeObject(otherObjectId);
+  ASSERT_TRUE(physicsManager_->restoreState(state));
+
+  // and so is one of an object whose ID got recycled by another template
+  std::string boxFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/nested_box.glb");
+  esp::assets::PhysicsObjectAttributes::ptr boxAttributes =
+      esp::assets::PhysicsObjectAttributes::create();
+  boxAttributes->setRenderMeshHandle(boxFile);
+  resourceManager_.loadObjectTemplate(boxAttributes, boxFile);
+  physicsManager_->removeObject(objectId);
+  ASSERT_EQ(physicsManager_->addObject(boxFile, &drawables), objectId);
+  ASSERT_FALSE(physicsManager_->restoreState(state));
+
+  // restoring the set of objects too replaces it by the old one
+  ASSERT_TRUE(physicsManager_->restoreState(state, &drawables));
+  ASSERT_EQ(physicsManager_->getNumRigidObjects(), 1);
+  ASSERT_EQ(physicsManager_->getTranslation(objectId), savedPosition);
+  ASSERT_TRUE(physicsManager_->restoreState(state));
+}
+
+TEST_F(PhysicsManagerTest, ExactSubSteps) {
+  LOG(INFO) << "Starting physics test: ExactSubSteps";
+
+  std::string sceneFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/scenes/plane.glb");
+  std::string objectFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/objects/sphere.glb");
+
+  initScene(sceneFile);
+
+  esp::assets::PhysicsObjectAttributes::ptr physicsObjectAttributes =
+      esp::assets::PhysicsObjectAttributes::create();
+  physicsObjectAttributes->setRenderMeshHandle(objectFile);
+  resourceManager_.loadObjectTemplate(physicsObjectAttributes, objectFile);
+
+  auto& drawables = sceneManager_.getSceneGraph(sceneID_).getDrawables();
+  const int objectId = physicsManager_->addObject(objectFile, &drawables);
+  physicsManager_->setTranslation(objectId, Magnum::Vector3{0.0, 10.0, 0.0});
+
+  const double timestep = physicsManager_->getTimestep();
+  const esp::physics::PhysicsState state = physicsManager_->saveState();
+
+  // exactly the requested number of fixed steps, regardless of the limit
+  physicsManager_->setMaxSubSteps(2);
+  physicsManager_->stepPhysicsSubSteps(7);
+  ASSERT_EQ(physicsManager_->getStepStatistics().subSteps, 7);
+  ASSERT_DOUBLE_EQ(physicsManager_->getWorldTime(), 7 * timestep);
+  const Magnum::Vector3 position = physicsManager_->getTranslation(objectId);
+
+  // and the same steps again from the same state end up in the same place
+  ASSERT_TRUE(physicsManager_->restoreState(state));
+  physicsManager_->stepPhysicsSubSteps(7);
+  ASSERT_EQ(physicsManager_->getTranslation(objectId), position);
+
+  // variable Bullet steps are still clamped to the maximum number of substeps
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    physicsManager_->stepPhysics(10 * timestep);
+    ASSERT_LE(physicsManager_->getStepStatistics().subSteps, 2);
+  }
+}
+
+TEST_F(PhysicsManagerTest, BatchedVelocityControl) {
+  LOG(INFO) << "Starting physics test: BatchedVelocityControl";
+
+  std::vector<esp::physics::VelocityControl> controls(3);
+  controls[0].controllingLinVel = true;
+  controls[0].linVel = Magnum::Vector3{1.0, 2.0, 3.0};
+  controls[1].controllingAngVel = true;
+  controls[1].angVelIsLocal = true;
+  controls[1].angVel = Magnum::Vector3{0.0, 1.0, 0.0};
+  controls[2].controllingLinVel = true;
+  controls[2].linVelIsLocal = true;
+  controls[2].linVel = Magnum::Vector3{0.0, 0.0, -1.0};
+  controls[2].controllingAngVel = true;
+  controls[2].angVel = Magnum::Vector3{1.0, 0.0, 0.0};
+
+  const Magnum::Matrix4 start =
+      Magnum::Matrix4::translation({1.0, 0.0, -2.0}) *
+      Magnum::Matrix4::rotationZ(Magnum::Deg{30.0});
+  std::vector<Magnum::Matrix4> transforms(3, start);
+
+  // the batched integration matches integrating each control on its own
+  esp::physics::VelocityControl::integrateTransforms(0.1, controls,
+                                                     transforms);
+  for (std::size_t i = 0; i != controls.size(); ++i) {
+    ASSERT_EQ(transforms[i], controls[i].integrateTransform(0.1, start));
+  }
+}
+
+TEST_F(PhysicsManagerTest, LazyObjectTemplates) {
+  LOG(INFO) << "Starting physics test: LazyObjectTemplates";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+  std::string missingFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/missing.glb");
+
+  initScene("NONE");
+  resourceManager_.lazyObjectTemplates(true);
+
+  // registered without touching the meshes, even a missing one
+  auto objectTemplate = esp::assets::PhysicsObjectAttributes::create();
+  objectTemplate->setRenderMeshHandle(objectFile);
+  const int templateId =
+      resourceManager_.loadObjectTemplate(objectTemplate, objectFile);
+  ASSERT_NE(templateId, esp::ID_UNDEFINED);
+  ASSERT_FALSE(resourceManager_.isSceneAssetLoaded(objectFile));
+  auto missingTemplate = esp::assets::PhysicsObjectAttributes::create();
+  missingTemplate->setRenderMeshHandle(missingFile);
+  const int missingId =
+      resourceManager_.loadObjectTemplate(missingTemplate, missingFile);
+  ASSERT_NE(missingId, esp::ID_UNDEFINED);
+
+  // the meshes are loaded with the first object, after a prefetch
+  ASSERT_TRUE(resourceManager_.prefetchObjectTemplate(templateId));
+  auto& drawables = sceneManager_.getSceneGraph(sceneID_).getDrawables();
+  const int objectId = physicsManager_->addObject(templateId, &drawables);
+  ASSERT_NE(objectId, esp::ID_UNDEFINED);
+  ASSERT_EQ(resourceManager_.getCollisionMesh(templateId).size(), 6);
+  ASSERT_FALSE(resourceManager_.prefetchObjectTemplate(templateId));
+  ASSERT_NE(physicsManager_->addObject(templateId, &drawables),
+            esp::ID_UNDEFINED);
+
+  ASSERT_EQ(physicsManager_->addObject(missingId, &drawables),
+            esp::ID_UNDEFINED);
+}
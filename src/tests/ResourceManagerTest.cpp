@@ -76,4 +76,221 @@ TEST(ResourceManagerTest, createJoinedCollisionMesh) {
     // indexGroundTruth[iix];
     ASSERT_EQ(indexGroundTruth[iix], joinedBox->ibo[iix]);
   }
+
+  // the joined mesh is kept for later navmesh recomputations
+  const esp::assets::MeshData& cachedBox =
+      resourceManager.getJoinedCollisionMesh(boxFile);
+  EXPECT_EQ(&cachedBox, &resourceManager.getJoinedCollisionMesh(boxFile));
+  EXPECT_EQ(cachedBox.vbo, joinedBox->vbo);
+  EXPECT_EQ(cachedBox.ibo, joinedBox->ibo);
+}
+
+TEST(ResourceManagerTest, sceneAssetCache) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  // must declare these in this order due to avoid deallocation errors
+  ResourceManager resourceManager;
+  SceneManager sceneManager_;
+
+  const esp::assets::AssetInfo plane = esp::assets::AssetInfo::fromPath(
+      Cr::Utility::Directory::join(TEST_ASSETS, "scenes/plane.glb"));
+  const esp::assets::AssetInfo room = esp::assets::AssetInfo::fromPath(
+      Cr::Utility::Directory::join(TEST_ASSETS, "scenes/simple_room.glb"));
+
+  // any loaded scene exceeds the budget
+  resourceManager.setSceneAssetCacheBudget(1);
+
+  auto& planeGraph = sceneManager_.getSceneGraph(sceneManager_.initSceneGraph());
+  resourceManager.loadScene(plane, &planeGraph.getRootNode(), nullptr);
+  resourceManager.trimSceneAssetCache();
+  // the scene in use is kept regardless of the budget
+  ResourceManager::SceneAssetCacheStats stats =
+      resourceManager.sceneAssetCacheStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.entries, 1);
+  EXPECT_EQ(stats.evictions, 0);
+  EXPECT_GT(stats.byteSize, 0);
+
+  auto& roomGraph = sceneManager_.getSceneGraph(sceneManager_.initSceneGraph());
+  resourceManager.loadScene(room, &roomGraph.getRootNode(), nullptr);
+  resourceManager.trimSceneAssetCache();
+  stats = resourceManager.sceneAssetCacheStats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.entries, 1);
+  EXPECT_EQ(stats.evictions, 1);
+
+  // still loaded, so no parsing this time
+  resourceManager.loadScene(room, &roomGraph.getRootNode(), nullptr);
+  stats = resourceManager.sceneAssetCacheStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+}
+
+TEST(ResourceManagerTest, gpuMemoryBudget) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  // must declare these in this order due to avoid deallocation errors
+  ResourceManager resourceManager;
+  SceneManager sceneManager_;
+
+  const esp::assets::AssetInfo plane = esp::assets::AssetInfo::fromPath(
+      Cr::Utility::Directory::join(TEST_ASSETS, "scenes/plane.glb"));
+  const esp::assets::AssetInfo room = esp::assets::AssetInfo::fromPath(
+      Cr::Utility::Directory::join(TEST_ASSETS, "scenes/simple_room.glb"));
+
+  auto& planeGraph = sceneManager_.getSceneGraph(sceneManager_.initSceneGraph());
+  resourceManager.loadScene(plane, &planeGraph.getRootNode(), nullptr);
+  const ResourceManager::GpuMemoryUsage planeUsage =
+      resourceManager.gpuMemoryUsage(plane.filepath);
+  EXPECT_GT(planeUsage.vertexBytes, 0);
+  EXPECT_GT(planeUsage.indexBytes, 0);
+  EXPECT_EQ(resourceManager.gpuMemoryUsage().totalBytes(),
+            planeUsage.totalBytes());
+
+  // the plane isn't used by the next scene and has to make room for it
+  resourceManager.setGpuMemoryBudget(planeUsage.totalBytes());
+  resourceManager.trimSceneAssetCache();
+  auto& roomGraph = sceneManager_.getSceneGraph(sceneManager_.initSceneGraph());
+  resourceManager.loadScene(room, &roomGraph.getRootNode(), nullptr);
+  EXPECT_EQ(resourceManager.sceneAssetCacheStats().evictions, 1);
+  EXPECT_EQ(resourceManager.gpuMemoryUsage(plane.filepath).totalBytes(), 0);
+  EXPECT_GT(resourceManager.gpuMemoryUsage(room.filepath).totalBytes(), 0);
+}
+
+TEST(ResourceManagerTest, sharedGpuAssets) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  esp::assets::GpuAssetRegistry& registry =
+      esp::assets::GpuAssetRegistry::instance();
+  const size_t registered = registry.size();
+  const esp::assets::AssetInfo box = esp::assets::AssetInfo::fromPath(
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/transform_box.glb"));
+
+  {
+    // must declare these in this order due to avoid deallocation errors
+    ResourceManager resourceManager;
+    ResourceManager otherResourceManager;
+    SceneManager sceneManager_;
+    auto& sceneGraph =
+        sceneManager_.getSceneGraph(sceneManager_.initSceneGraph());
+
+    resourceManager.loadScene(box, &sceneGraph.getRootNode(), nullptr);
+    EXPECT_EQ(registry.size(), registered + 1);
+
+    // the second instance draws from the same GPU data
+    otherResourceManager.loadScene(box, &sceneGraph.getRootNode(), nullptr);
+    EXPECT_EQ(registry.size(), registered + 1);
+    EXPECT_EQ(otherResourceManager.createJoinedCollisionMesh(box.filepath)
+                  ->vbo.size(),
+              24);
+  }
+
+  // freed together with the last instance using it
+  EXPECT_EQ(registry.size(), registered);
+}
+
+TEST(ResourceManagerTest, prefetchScene) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  // must declare these in this order due to avoid deallocation errors
+  ResourceManager resourceManager;
+  SceneManager sceneManager_;
+
+  std::string boxFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/transform_box.glb");
+  const esp::assets::AssetInfo info = esp::assets::AssetInfo::fromPath(boxFile);
+
+  ASSERT_TRUE(resourceManager.prefetchScene(info));
+  EXPECT_TRUE(resourceManager.isScenePrefetched(boxFile));
+  // already in flight
+  EXPECT_FALSE(resourceManager.prefetchScene(info));
+
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneManager_.initSceneGraph());
+  ASSERT_TRUE(resourceManager.loadScene(info, &sceneGraph.getRootNode(),
+                                        &sceneGraph.getDrawables()));
+  EXPECT_FALSE(resourceManager.isScenePrefetched(boxFile));
+  // already loaded
+  EXPECT_FALSE(resourceManager.prefetchScene(info));
+
+  // the prefetched meshes end up the same as loaded ones
+  esp::assets::MeshData::uptr joinedBox =
+      resourceManager.createJoinedCollisionMesh(boxFile);
+  EXPECT_EQ(joinedBox->vbo.size(), 24);
+  EXPECT_EQ(joinedBox->ibo.size(), 36);
+}
+
+TEST(ResourceManagerTest, parsePhysObjTemplate) {
+  const std::string configFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "parse_test.phys_properties.json");
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(configFile, R"({
+    "render mesh": "box.glb",
+    "mass": 2.5,
+    "COM": [0.1, 0.2, 0.3],
+    "scale": [1, "two", 3],
+    "collision group": 4,
+    "join collision meshes": false,
+    "requires lighting": "yes",
+    "user data": {"mass": 7, "COM": [1, 1, 1]}
+  })"));
+
+  esp::assets::PhysicsObjectAttributes::ptr attributes =
+      ResourceManager::parsePhysObjTemplate(configFile);
+  ASSERT_NE(attributes, nullptr);
+  EXPECT_EQ(attributes->getRenderMeshHandle(),
+            Cr::Utility::Directory::join(Cr::Utility::Directory::tmp(),
+                                         "box.glb"));
+  EXPECT_EQ(attributes->getCollisionMeshHandle(), "");
+  // nested members are skipped
+  EXPECT_EQ(attributes->getMass(), 2.5);
+  EXPECT_EQ(attributes->getCOM(), Mn::Vector3(0.1f, 0.2f, 0.3f));
+  EXPECT_TRUE(attributes->getBool("COM_provided"));
+  // an invalid element ends the vector
+  EXPECT_EQ(attributes->getScale(), Mn::Vector3(1.0f, 0.0f, 0.0f));
+  EXPECT_EQ(attributes->getCollisionGroup(), 4);
+  EXPECT_FALSE(attributes->getJoinCollisionMeshes());
+  // invalid values keep the default
+  EXPECT_TRUE(attributes->getRequiresLighting());
+
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(configFile, "{\"mass\": "));
+  EXPECT_EQ(ResourceManager::parsePhysObjTemplate(configFile), nullptr);
+  EXPECT_EQ(ResourceManager::parsePhysObjTemplate(configFile + ".none"),
+            nullptr);
+  Cr::Utility::Directory::rm(configFile);
+}
+
+TEST(ResourceManagerTest, parseAndLoadPhysObjTemplates) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  ResourceManager resourceManager;
+  std::vector<std::string> configFiles = resourceManager.getObjectConfigPaths(
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects"));
+  ASSERT_EQ(configFiles.size(), 2);
+  // listed twice and missing, in the middle
+  configFiles.insert(configFiles.begin() + 1, configFiles[0]);
+  configFiles.insert(configFiles.begin() + 2, "missing.phys_properties.json");
+
+  const std::vector<int> ids =
+      resourceManager.parseAndLoadPhysObjTemplates(configFiles);
+  ASSERT_EQ(ids.size(), 4);
+  EXPECT_EQ(ids[0], 0);
+  EXPECT_EQ(ids[1], 0);
+  EXPECT_EQ(ids[2], esp::ID_UNDEFINED);
+  EXPECT_EQ(ids[3], 1);
+  EXPECT_EQ(resourceManager.getNumLibraryObjects(), 2);
+  EXPECT_EQ(resourceManager.parseAndLoadPhysObjTemplate(configFiles[3]), 1);
 }
@@ -4,6 +4,8 @@
 
 #include <gtest/gtest.h>
 
+#include <Magnum/SceneGraph/AbstractFeature.h>
+
 #include "esp/scene/SceneGraph.h"
 
 using esp::gfx::DrawableGroup;
@@ -38,3 +40,75 @@ TEST_F(SceneGraphTest, DeleteDrawableGroup) {
   EXPECT_EQ(g.getDrawableGroups().size(), numInitialGroups);
   ASSERT_EQ(g.getDrawableGroup(groupName), nullptr);
 }
+
+TEST_F(SceneGraphTest, CachedTransformations) {
+  esp::scene::SceneNode& parent = g.getRootNode().createChild();
+  esp::scene::SceneNode& child = parent.createChild();
+  child.setMeshBB({{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}});
+  child.translate({1.0f, 0.0f, 0.0f});
+
+  EXPECT_EQ(child.absoluteTranslation(), (Magnum::Vector3{1.0f, 0.0f, 0.0f}));
+  EXPECT_EQ(parent.computeCumulativeBB().max(),
+            (Magnum::Vector3{2.0f, 1.0f, 1.0f}));
+
+  // moving the parent updates the child, moving the child the parent's box
+  parent.translate({0.0f, 2.0f, 0.0f});
+  EXPECT_EQ(child.absoluteTranslation(), (Magnum::Vector3{1.0f, 2.0f, 0.0f}));
+  child.translate({1.0f, 0.0f, 0.0f});
+  EXPECT_EQ(parent.computeCumulativeBB().max(),
+            (Magnum::Vector3{3.0f, 1.0f, 1.0f}));
+
+  // so does removing the child
+  delete &child;
+  EXPECT_EQ(parent.computeCumulativeBB().max(), (Magnum::Vector3{}));
+}
+
+TEST_F(SceneGraphTest, PreOrderNodes) {
+  esp::scene::SceneNode& root = g.getRootNode();
+  const size_t initialCount = g.preOrderNodes().size();
+  esp::scene::SceneNode& a = root.createChild();
+  esp::scene::SceneNode& b = a.createChild();
+  esp::scene::SceneNode& c = root.createChild();
+
+  const std::vector<esp::scene::SceneNode*>& nodes = g.preOrderNodes();
+  const std::vector<int>& parents = g.preOrderParents();
+  ASSERT_EQ(nodes.size(), initialCount + 3);
+  ASSERT_EQ(parents.size(), nodes.size());
+  EXPECT_EQ(nodes[0], &root);
+  EXPECT_EQ(parents[0], -1);
+  // the default render camera node comes first, then the new ones in order
+  const size_t ia = nodes.size() - 3;
+  EXPECT_EQ(nodes[ia], &a);
+  EXPECT_EQ(nodes[ia + 1], &b);
+  EXPECT_EQ(nodes[ia + 2], &c);
+  EXPECT_EQ(parents[ia], 0);
+  EXPECT_EQ(parents[ia + 1], static_cast<int>(ia));
+  EXPECT_EQ(parents[ia + 2], 0);
+
+  // rebuilt after the hierarchy changes
+  delete &a;
+  EXPECT_EQ(g.preOrderNodes().size(), initialCount + 1);
+  EXPECT_EQ(g.preOrderNodes().back(), &c);
+}
+
+namespace {
+struct TestFeature : Magnum::SceneGraph::AbstractFeature3D {
+  explicit TestFeature(esp::scene::SceneNode& node)
+      : Magnum::SceneGraph::AbstractFeature3D{node} {}
+};
+}  // namespace
+
+TEST_F(SceneGraphTest, FeatureLists) {
+  EXPECT_TRUE(g.features<TestFeature>().empty());
+  esp::scene::SceneNode& a = g.getRootNode().createChild();
+  TestFeature& first = a.addFeature<TestFeature>();
+  TestFeature& second = a.createChild().addFeature<TestFeature>();
+
+  const std::vector<TestFeature*>& features = g.features<TestFeature>();
+  ASSERT_EQ(features.size(), 2);
+  EXPECT_EQ(features[0], &first);
+  EXPECT_EQ(features[1], &second);
+
+  delete &a;
+  EXPECT_TRUE(g.features<TestFeature>().empty());
+}
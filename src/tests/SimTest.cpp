@@ -2,7 +2,9 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/DebugTools/CompareImage.h>
@@ -10,11 +12,17 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/PixelFormat.h>
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "esp/assets/ResourceManager.h"
 #include "esp/physics/RigidObject.h"
+#include "esp/sensor/VisualSensor.h"
+#include "esp/sim/BatchedSimulator.h"
+#include "esp/sim/ObservationRecorder.h"
 #include "esp/sim/Simulator.h"
+#include "esp/sim/SimulatorCheckpoint.h"
 
 #include "configure.h"
 
@@ -35,8 +43,13 @@ using esp::sensor::ObservationSpace;
 using esp::sensor::ObservationSpaceType;
 using esp::sensor::SensorSpec;
 using esp::sensor::SensorType;
+using esp::sim::BatchedSimulator;
+using esp::sim::ObservationCache;
+using esp::sim::ObservationRecorder;
 using esp::sim::Simulator;
+using esp::sim::SimulatorCheckpoint;
 using esp::sim::SimulatorConfiguration;
+using esp::sim::Trajectory;
 
 namespace {
 
@@ -83,6 +96,15 @@ struct SimTest : Cr::TestSuite::Tester {
   void basic();
   void reconfigure();
   void reset();
+  void residentScenes();
+  void agentStates();
+  void trajectory();
+  void checkpoint();
+  void observationCache();
+  void observationDestination();
+  void renderAgentPoses();
+  void batchedSimulator();
+  void observationRecorder();
   void getSceneRGBAObservation();
   void getSceneWithLightingRGBAObservation();
   void getDefaultLightingRGBAObservation();
@@ -91,7 +113,9 @@ struct SimTest : Cr::TestSuite::Tester {
   void updateObjectLightSetupRGBAObservation();
   void multipleLightingSetupsRGBAObservation();
   void recomputeNavmeshWithStaticObjects();
+  void recomputeTiledNavmeshWithStaticObjects();
   void loadingObjectTemplates();
+  void maxTextureSizeForSensors();
 
   // TODO: remove outlier pixels from image and lower maxThreshold
   const Magnum::Float maxThreshold = 255.f;
@@ -107,6 +131,15 @@ SimTest::SimTest() {
   addTests({&SimTest::basic,
             &SimTest::reconfigure,
             &SimTest::reset,
+            &SimTest::residentScenes,
+            &SimTest::agentStates,
+            &SimTest::trajectory,
+            &SimTest::checkpoint,
+            &SimTest::observationCache,
+            &SimTest::observationDestination,
+            &SimTest::renderAgentPoses,
+            &SimTest::batchedSimulator,
+            &SimTest::observationRecorder,
             &SimTest::getSceneRGBAObservation,
             &SimTest::getSceneWithLightingRGBAObservation,
             &SimTest::getDefaultLightingRGBAObservation,
@@ -115,7 +148,9 @@ SimTest::SimTest() {
             &SimTest::updateObjectLightSetupRGBAObservation,
             &SimTest::multipleLightingSetupsRGBAObservation,
             &SimTest::recomputeNavmeshWithStaticObjects,
-            &SimTest::loadingObjectTemplates});
+            &SimTest::recomputeTiledNavmeshWithStaticObjects,
+            &SimTest::loadingObjectTemplates,
+            &SimTest::maxTextureSizeForSensors});
   // clang-format on
 }
 
@@ -167,6 +202,386 @@ void SimTest::reset() {
   CORRADE_VERIFY(pathfinder == simulator.getPathFinder());
 }
 
+void SimTest::residentScenes() {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  cfg.maxResidentScenes = 2;
+  Simulator simulator(cfg);
+  const esp::scene::SceneGraph* vangoghGraph = &simulator.getActiveSceneGraph();
+  PathFinder::ptr vangoghPathfinder = simulator.getPathFinder();
+  Agent::ptr agent = simulator.addAgent(AgentConfiguration{});
+
+  cfg.scene.id = skokloster;
+  simulator.reconfigure(cfg);
+  CORRADE_COMPARE(simulator.getResidentScenes(),
+                  (std::vector<std::string>{skokloster, vangogh}));
+  CORRADE_VERIFY(&simulator.getActiveSceneGraph() != vangoghGraph);
+  // the agent moved along to the new scene
+  CORRADE_VERIFY(agent->node().parent() ==
+                 &simulator.getActiveSceneGraph().getRootNode());
+
+  // switching back doesn't load anything
+  cfg.scene.id = vangogh;
+  simulator.reconfigure(cfg);
+  CORRADE_VERIFY(&simulator.getActiveSceneGraph() == vangoghGraph);
+  CORRADE_VERIFY(simulator.getPathFinder() == vangoghPathfinder);
+  CORRADE_VERIFY(agent->node().parent() == &vangoghGraph->getRootNode());
+  CORRADE_COMPARE(simulator.getResidentScenes(),
+                  (std::vector<std::string>{vangogh, skokloster}));
+  CORRADE_VERIFY(simulator.setActiveScene(skokloster));
+  CORRADE_VERIFY(simulator.getPathFinder() != vangoghPathfinder);
+  CORRADE_VERIFY(!simulator.setActiveScene(planeScene));
+
+  // a third scene unloads the least recently active one
+  cfg.scene.id = planeScene;
+  simulator.reconfigure(cfg);
+  CORRADE_COMPARE(simulator.getResidentScenes(),
+                  (std::vector<std::string>{planeScene, skokloster}));
+  CORRADE_VERIFY(!simulator.setActiveScene(vangogh));
+  CORRADE_VERIFY(agent->node().parent() ==
+                 &simulator.getActiveSceneGraph().getRootNode());
+}
+
+void SimTest::agentStates() {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  Simulator simulator(cfg);
+
+  auto pinholeCameraSpec = SensorSpec::create();
+  pinholeCameraSpec->position = {0.0f, 1.5f, 0.0f};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  simulator.addAgent(agentConfig);
+  Agent::ptr second = simulator.addAgent(agentConfig);
+
+  const Mn::Quaternion rotation =
+      Mn::Quaternion::rotation(Mn::Deg(90.0f), Mn::Vector3::yAxis());
+  const std::vector<float> positions{1.0f, 0.0f, 2.0f, -1.0f, 0.5f, 3.0f};
+  const std::vector<float> rotations{
+      0.0f, 0.0f, 0.0f, 1.0f, rotation.vector().x(), rotation.vector().y(),
+      rotation.vector().z(), rotation.scalar()};
+  // move a sensor, the reset puts it back once the sensors are accessed
+  second->getSensorSuite().get(pinholeCameraSpec->uuid)->node().translate(
+      {0.0f, 1.0f, 0.0f});
+  CORRADE_VERIFY(simulator.setAgentStates({0, 1}, positions, rotations));
+
+  auto state = AgentState::create();
+  second->getState(state);
+  CORRADE_COMPARE(Mn::Vector3{state->position},
+                  (Mn::Vector3{-1.0f, 0.5f, 3.0f}));
+  CORRADE_COMPARE(second->getSensorSuite()
+                      .get(pinholeCameraSpec->uuid)
+                      ->node()
+                      .translation(),
+                  (Mn::Vector3{0.0f, 1.5f, 0.0f}));
+
+  std::vector<float> readPositions(6);
+  std::vector<float> readRotations(8);
+  CORRADE_VERIFY(
+      simulator.getAgentStates({0, 1}, readPositions, readRotations));
+  for (size_t i = 0; i < positions.size(); ++i) {
+    CORRADE_COMPARE(readPositions[i], positions[i]);
+  }
+  for (size_t i = 0; i < rotations.size(); ++i) {
+    CORRADE_COMPARE(readRotations[i], rotations[i]);
+  }
+
+  // invalid agents and rotations are skipped, the others still move
+  const std::vector<float> invalidRotations{0.0f, 0.0f, 0.0f, 2.0f,
+                                            0.0f, 0.0f, 0.0f, 1.0f};
+  CORRADE_VERIFY(
+      !simulator.setAgentStates({0, 1}, positions, invalidRotations));
+  second->getState(state);
+  CORRADE_COMPARE(Mn::Vector4{state->rotation},
+                  (Mn::Vector4{0.0f, 0.0f, 0.0f, 1.0f}));
+  CORRADE_VERIFY(!simulator.getAgentStates({2}, {readPositions.data(), 3},
+                                           {readRotations.data(), 4}));
+}
+
+void SimTest::trajectory() {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  Simulator simulator(cfg);
+
+  auto pinholeCameraSpec = SensorSpec::create();
+  pinholeCameraSpec->position = {0.0f, 1.5f, 0.0f};
+  pinholeCameraSpec->resolution = {32, 32};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator.addAgent(agentConfig);
+
+  simulator.startRecording();
+  CORRADE_VERIFY(simulator.isRecording());
+  simulator.step(0, "move_forward");
+  simulator.step(0, "turn_left");
+  simulator.step(0, "move_forward");
+  Trajectory recorded = simulator.stopRecording();
+  CORRADE_VERIFY(!simulator.isRecording());
+  CORRADE_COMPARE(recorded.frames.size(), 3);
+  CORRADE_COMPARE(recorded.actionNames.size(), 2);
+  CORRADE_COMPARE(recorded.frames[2].actions.size(), 1);
+  CORRADE_COMPARE(recorded.actionNames[recorded.frames[2].actions[0].name],
+                  "move_forward");
+  const Mn::Vector3 finalPosition = agent->node().translation();
+
+  const std::string filename = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "SimTestTrajectory.bin");
+  CORRADE_VERIFY(recorded.save(filename));
+  Cr::Containers::Optional<Trajectory> loaded = Trajectory::load(filename);
+  CORRADE_VERIFY(loaded);
+  CORRADE_COMPARE(loaded->frames.size(), recorded.frames.size());
+  CORRADE_COMPARE(Trajectory::poseHash(loaded->frames[1]),
+                  Trajectory::poseHash(recorded.frames[1]));
+  CORRADE_VERIFY(Trajectory::poseHash(loaded->frames[0]) !=
+                 Trajectory::poseHash(loaded->frames[1]));
+  CORRADE_VERIFY(
+      Trajectory::samePoses(loaded->frames[1], recorded.frames[1]));
+  CORRADE_VERIFY(!Trajectory::samePoses(loaded->frames[0], loaded->frames[1]));
+
+  // replaying puts the agent back without acting
+  CORRADE_VERIFY(simulator.setReplayFrame(*loaded, 0));
+  CORRADE_COMPARE(agent->node().translation(),
+                  recorded.frames[0].agents[0].body.translation);
+  CORRADE_VERIFY(simulator.setReplayFrame(*loaded, 2));
+  CORRADE_COMPARE(agent->node().translation(), finalPosition);
+  CORRADE_VERIFY(!simulator.setReplayFrame(*loaded, 3));
+
+  // a cached frame is served without rendering, from a copy
+  simulator.setReplayObservationCacheCapacity(2);
+  const esp::sim::AgentObservations* first =
+      &simulator.getReplayObservations(0);
+  CORRADE_COMPARE(first->observations.size(), 1);
+  CORRADE_VERIFY(&simulator.getReplayObservations(0) == first);
+  CORRADE_VERIFY(simulator.setReplayFrame(*loaded, 1));
+  CORRADE_VERIFY(&simulator.getReplayObservations(0) != first);
+  CORRADE_VERIFY(simulator.setReplayFrame(recorded, 2));
+  CORRADE_VERIFY(&simulator.getReplayObservations(0) == first);
+
+  Cr::Utility::Directory::rm(filename);
+}
+
+void SimTest::checkpoint() {
+  auto simulator = getSimulator(vangogh);
+  auto pinholeCameraSpec = SensorSpec::create();
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  const int objectID = simulator->addObject(0);
+  const int removedID = simulator->addObject(0);
+  CORRADE_VERIFY(removedID != esp::ID_UNDEFINED);
+  simulator->setTranslation({1.0f, 0.5f, -0.5f}, objectID);
+
+  const SimulatorCheckpoint checkpoint = simulator->checkpoint();
+  const Mn::Vector3 agentPosition = agent->node().translation();
+  const Mn::Vector3 objectPosition = simulator->getTranslation(objectID);
+  const esp::vec3f randomPoint =
+      simulator->getPathFinder()->getRandomNavigablePoint();
+
+  simulator->step(0, "move_forward");
+  simulator->removeObject(removedID);
+  simulator->addObject(0);
+  simulator->stepWorld(0.5);
+  CORRADE_VERIFY(agent->node().translation() != agentPosition);
+  CORRADE_VERIFY(simulator->getTranslation(objectID) != objectPosition);
+
+  // a branch off the checkpoint starts from the same state every time
+  int addedID = esp::ID_UNDEFINED;
+  for (int branch = 0; branch != 2; ++branch) {
+    CORRADE_ITERATION(branch);
+    CORRADE_VERIFY(simulator->restore(checkpoint));
+    CORRADE_COMPARE(agent->node().translation(), agentPosition);
+    CORRADE_COMPARE(simulator->getTranslation(objectID), objectPosition);
+    CORRADE_COMPARE_AS(simulator->getExistingObjectIDs(),
+                       (std::vector<int>{objectID, removedID}),
+                       Cr::TestSuite::Compare::Container);
+    CORRADE_VERIFY(simulator->getPathFinder()->getRandomNavigablePoint() ==
+                   randomPoint);
+    // and hands out the same object IDs
+    const int id = simulator->addObject(0);
+    if (branch == 0) {
+      addedID = id;
+    }
+    CORRADE_COMPARE(id, addedID);
+  }
+
+  // other agents don't match
+  simulator->addAgent(agentConfig);
+  CORRADE_VERIFY(!simulator->restore(checkpoint));
+}
+
+void SimTest::observationCache() {
+  // least recently used entries go first once the bytes exceed the cap
+  auto observation = [](size_t size) {
+    Observation obs;
+    obs.buffer = esp::core::Buffer::create(std::vector<size_t>{size},
+                                           esp::core::DataType::DT_UINT8);
+    return obs;
+  };
+  ObservationCache cache{100};
+  cache.insert(1, {observation(40)});
+  cache.insert(2, {observation(40)});
+  CORRADE_VERIFY(cache.find(1));
+  cache.insert(3, {observation(40)});
+  CORRADE_VERIFY(cache.find(1));
+  CORRADE_VERIFY(!cache.find(2));
+  CORRADE_VERIFY(cache.find(3));
+  cache.insert(4, {observation(200)});
+  CORRADE_VERIFY(!cache.find(4));
+  CORRADE_COMPARE(cache.stats().hits, 3);
+  CORRADE_COMPARE(cache.stats().misses, 2);
+  CORRADE_COMPARE(cache.stats().evictions, 1);
+  CORRADE_COMPARE(cache.stats().entries, 2);
+  CORRADE_COMPARE(cache.stats().byteSize, 80);
+  CORRADE_COMPARE(cache.stats().hitRate(), 0.6);
+
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  Simulator simulator(cfg);
+  auto pinholeCameraSpec = SensorSpec::create();
+  pinholeCameraSpec->resolution = {32, 32};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator.addAgent(agentConfig);
+  simulator.setObservationCache(1 << 20);
+
+  esp::sim::AgentObservations first;
+  simulator.getAgentObservations(0, first);
+  CORRADE_COMPARE(simulator.getObservationCacheStats().misses, 1);
+  CORRADE_COMPARE(first.observations.size(), 1);
+  // the sensor renders the next observation into the same buffer
+  const Cr::Containers::ArrayView<const uint8_t> firstView =
+      first.observations[0].buffer->data;
+  const std::vector<uint8_t> firstData(firstView.begin(), firstView.end());
+
+  // moving away renders, coming back within the resolution doesn't
+  const Mn::Vector3 start = agent->node().translation();
+  esp::sim::AgentObservations observations;
+  agent->node().translate({0.25f, 0.0f, 0.0f});
+  simulator.getAgentObservations(0, observations);
+  CORRADE_COMPARE(simulator.getObservationCacheStats().misses, 2);
+  agent->node().setTranslation(start + Mn::Vector3{0.0001f});
+  simulator.getAgentObservations(0, observations);
+  CORRADE_COMPARE(simulator.getObservationCacheStats().hits, 1);
+  CORRADE_COMPARE(observations.sensorUuids, first.sensorUuids);
+  const Cr::Containers::ArrayView<const uint8_t> cachedView =
+      observations.observations[0].buffer->data;
+  CORRADE_COMPARE_AS(
+      std::vector<uint8_t>(cachedView.begin(), cachedView.end()), firstData,
+      Cr::TestSuite::Compare::Container);
+
+  simulator.invalidateObservationCache();
+  simulator.getAgentObservations(0, observations);
+  CORRADE_COMPARE(simulator.getObservationCacheStats().misses, 3);
+}
+
+void SimTest::observationDestination() {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  Simulator simulator(cfg);
+  auto pinholeCameraSpec = SensorSpec::create();
+  pinholeCameraSpec->resolution = {32, 32};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator.addAgent(agentConfig);
+
+  Observation reference;
+  CORRADE_VERIFY(
+      simulator.getAgentObservation(0, pinholeCameraSpec->uuid, reference));
+  const std::vector<uint8_t> referenceData(reference.buffer->data.begin(),
+                                           reference.buffer->data.end());
+
+  // the second row of a batch of two
+  std::vector<uint8_t> batch(2 * referenceData.size(), 0);
+  auto& camera = static_cast<esp::sensor::VisualSensor&>(
+      *agent->getSensorSuite().get(pinholeCameraSpec->uuid));
+  camera.setObservationDestination(esp::core::Buffer::wrap(
+      batch.data() + referenceData.size(), reference.buffer->shape,
+      reference.buffer->dataType));
+
+  Observation observation;
+  CORRADE_VERIFY(
+      simulator.getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  CORRADE_COMPARE(static_cast<void*>(observation.buffer->data.data()),
+                  static_cast<void*>(batch.data() + referenceData.size()));
+  CORRADE_COMPARE_AS(
+      std::vector<uint8_t>(batch.begin() + referenceData.size(), batch.end()),
+      referenceData, Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(size_t(std::count(
+                      batch.begin(), batch.begin() + referenceData.size(), 0)),
+                  referenceData.size());
+
+  camera.setObservationDestination(nullptr);
+  CORRADE_VERIFY(
+      simulator.getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  CORRADE_VERIFY(static_cast<void*>(observation.buffer->data.data()) !=
+                 static_cast<void*>(batch.data() + referenceData.size()));
+}
+
+void SimTest::renderAgentPoses() {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  Simulator simulator(cfg);
+  auto pinholeCameraSpec = SensorSpec::create();
+  pinholeCameraSpec->resolution = {32, 32};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator.addAgent(agentConfig);
+  const Mn::Vector3 start = agent->node().translation();
+
+  // three poses, the first and last close so that sorting reorders them
+  const Mn::Quaternion turned =
+      Mn::Quaternion::rotation(Mn::Deg(90.0f), Mn::Vector3::yAxis());
+  std::vector<float> positions, rotations;
+  const auto addPose = [&](const Mn::Vector3& position,
+                           const Mn::Quaternion& rotation) {
+    positions.insert(positions.end(), position.data(), position.data() + 3);
+    rotations.insert(rotations.end(), rotation.data(), rotation.data() + 4);
+  };
+  addPose(start, Mn::Quaternion{});
+  addPose(start + Mn::Vector3{3.0f, 0.0f, 0.0f}, turned);
+  addPose(start + Mn::Vector3{0.1f, 0.0f, 0.0f}, Mn::Quaternion{});
+
+  // one observation at every pose, the slow way
+  std::vector<std::vector<uint8_t>> expected;
+  for (size_t i = 0; i != 3; ++i) {
+    agent->setPose(Mn::Vector3::from(&positions[3 * i]),
+                   Mn::Quaternion{Mn::Vector3::from(&rotations[4 * i]),
+                                  rotations[4 * i + 3]});
+    Observation observation;
+    CORRADE_VERIFY(simulator.getAgentObservation(0, pinholeCameraSpec->uuid,
+                                                 observation));
+    expected.emplace_back(observation.buffer->data.begin(),
+                          observation.buffer->data.end());
+  }
+  agent->setPose(start, Mn::Quaternion{});
+  const size_t rowSize = expected[0].size();
+
+  std::vector<uint8_t> output(3 * rowSize, 0);
+  CORRADE_VERIFY(simulator.renderAgentPoses(
+      0, positions, rotations, {pinholeCameraSpec->uuid},
+      {Cr::Containers::arrayView(output)}));
+  for (size_t i = 0; i != 3; ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE_AS(
+        std::vector<uint8_t>(output.begin() + i * rowSize,
+                             output.begin() + (i + 1) * rowSize),
+        expected[i], Cr::TestSuite::Compare::Container);
+  }
+  CORRADE_VERIFY(expected[0] != expected[1]);
+  // the agent is back where it was
+  CORRADE_COMPARE(agent->node().translation(), start);
+  CORRADE_COMPARE(agent->node().rotation(), Mn::Quaternion{});
+
+  // an output that doesn't fit the poses renders nothing
+  std::vector<uint8_t> small(rowSize, 0);
+  CORRADE_VERIFY(!simulator.renderAgentPoses(
+      0, positions, rotations, {pinholeCameraSpec->uuid},
+      {Cr::Containers::arrayView(small)}));
+  CORRADE_VERIFY(!simulator.renderAgentPoses(
+      0, positions, rotations, {"nonexistent"},
+      {Cr::Containers::arrayView(output)}));
+}
+
 void SimTest::checkPinholeCameraRGBAObservation(
     Simulator& simulator,
     const std::string& groundTruthImageFile,
@@ -210,6 +625,106 @@ void SimTest::checkPinholeCameraRGBAObservation(
       (Mn::DebugTools::CompareImageToFile{maxThreshold, meanThreshold}));
 }
 
+void SimTest::batchedSimulator() {
+  SimulatorConfiguration cfg;
+  cfg.scene.id = vangogh;
+  BatchedSimulator batch{std::vector<SimulatorConfiguration>{cfg, cfg}};
+  CORRADE_COMPARE(batch.size(), 2);
+  auto pinholeCameraSpec = SensorSpec::create();
+  pinholeCameraSpec->resolution = {32, 32};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  for (size_t i = 0; i != batch.size(); ++i) {
+    batch.simulator(i)->addAgent(agentConfig);
+  }
+
+  const esp::sim::BatchObservations& observations =
+      batch.step({"move_forward", "turn_left"});
+  CORRADE_COMPARE(observations.tensors.size(), 1);
+  const auto& tensor = observations.tensors.at(SensorType::COLOR);
+  CORRADE_COMPARE_AS(tensor.buffer->shape,
+                     (std::vector<size_t>{2, 32, 32, 4}),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(tensor.sensors.size(), 2);
+  CORRADE_COMPARE(tensor.sensors[1].first, 1);
+  CORRADE_COMPARE(tensor.sensors[1].second, pinholeCameraSpec->uuid);
+
+  // the cameras read straight into their rows
+  const size_t rowSize = tensor.buffer->data.size() / 2;
+  Observation observation;
+  CORRADE_VERIFY(batch.simulator(1)->getAgentObservation(
+      0, pinholeCameraSpec->uuid, observation));
+  CORRADE_COMPARE(static_cast<void*>(observation.buffer->data.data()),
+                  static_cast<void*>(tensor.buffer->data.data() + rowSize));
+
+  // the agents took different actions, so they see different things
+  const Cr::Containers::ArrayView<const uint8_t> data = tensor.buffer->data;
+  CORRADE_VERIFY(!std::equal(data.begin(), data.begin() + rowSize,
+                             data.begin() + rowSize));
+}
+
+void SimTest::observationRecorder() {
+  const std::string directory = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "habitat_sim_observation_recorder");
+  auto rgba = esp::core::Buffer::create(std::vector<size_t>{2, 2, 4},
+                                        esp::core::DataType::DT_UINT8);
+  auto depth = esp::core::Buffer::create(std::vector<size_t>{2, 2},
+                                         esp::core::DataType::DT_FLOAT);
+  // pure red
+  for (size_t i = 0; i != rgba->data.size(); ++i) {
+    rgba->data[i] = i % 4 == 0 || i % 4 == 3 ? 255 : 0;
+  }
+  {
+    ObservationRecorder recorder{directory, 10};
+    CORRADE_VERIFY(!recorder.record("rgba", *rgba));
+    recorder.beginEpisode("episode");
+    for (int frame = 0; frame != 3; ++frame) {
+      // the bottom row, read back first, is frame * 10, the top one + 1
+      auto depthData = Cr::Containers::arrayCast<float>(depth->data);
+      for (size_t i = 0; i != depthData.size(); ++i) {
+        depthData[i] = frame * 10.0f + i / 2;
+      }
+      CORRADE_VERIFY(recorder.record("rgba", *rgba));
+      CORRADE_VERIFY(recorder.record("depth", *depth));
+    }
+    // the writer drops frames of another shape
+    CORRADE_VERIFY(recorder.record(
+        "depth", *esp::core::Buffer::create(std::vector<size_t>{3, 3},
+                                            esp::core::DataType::DT_FLOAT)));
+    recorder.endEpisode();
+    recorder.flush();
+    CORRADE_COMPARE(recorder.queuedFrames(), 0);
+    CORRADE_COMPARE(recorder.writtenFrames(), 6);
+    CORRADE_COMPARE(recorder.droppedFrames(), 1);
+  }
+
+  // full-range 4:4:4 frames after the stream header
+  const std::string video = Cr::Utility::Directory::readString(
+      Cr::Utility::Directory::join(directory, "episode/rgba.y4m"));
+  const std::string header =
+      "YUV4MPEG2 W2 H2 F10:1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+  CORRADE_COMPARE(video.substr(0, header.size()), header);
+  const size_t frameSize = 6 + 3 * 4;
+  CORRADE_COMPARE(video.size(), header.size() + 3 * frameSize);
+  const std::string frame = video.substr(header.size(), frameSize);
+  CORRADE_COMPARE(frame.substr(0, 6), "FRAME\n");
+  CORRADE_COMPARE(uint8_t(frame[6]), 77);
+  CORRADE_COMPARE(uint8_t(frame[6 + 4]), 85);
+  CORRADE_COMPARE(uint8_t(frame[6 + 8]), 255);
+
+  // the depth frames stacked losslessly top row first, the count filled in
+  // at the end
+  const std::string array = Cr::Utility::Directory::readString(
+      Cr::Utility::Directory::join(directory, "episode/depth.npy"));
+  CORRADE_COMPARE(array.size(), 256 + 3 * 4 * sizeof(float));
+  CORRADE_VERIFY(array.find("'shape': (3, 2, 2)") != std::string::npos);
+  float lastFrame[4];
+  std::memcpy(lastFrame, array.data() + array.size() - sizeof(lastFrame),
+              sizeof(lastFrame));
+  CORRADE_COMPARE(lastFrame[0], 21.0f);
+  CORRADE_COMPARE(lastFrame[3], 20.0f);
+}
+
 void SimTest::getSceneRGBAObservation() {
   setTestCaseName(CORRADE_FUNCTION);
   auto simulator = getSimulator(vangogh);
@@ -379,6 +894,59 @@ void SimTest::recomputeNavmeshWithStaticObjects() {
       simulator->getPathFinder()->isNavigable(randomNavPoint + offset, 0.2));
 }
 
+void SimTest::recomputeTiledNavmeshWithStaticObjects() {
+  auto simulator = getSimulator(skokloster);
+  esp::nav::PathFinder& pathFinder = *simulator->getPathFinder();
+
+  esp::nav::NavMeshSettings navMeshSettings;
+  navMeshSettings.setDefaults();
+  navMeshSettings.tileSize = 64;
+  CORRADE_VERIFY(simulator->recomputeNavMesh(pathFinder, navMeshSettings));
+
+  esp::vec3f randomNavPoint = pathFinder.getRandomNavigablePoint();
+  while (pathFinder.distanceToClosestObstacle(randomNavPoint) < 1.0 ||
+         randomNavPoint[1] > 1.0) {
+    randomNavPoint = pathFinder.getRandomNavigablePoint();
+  }
+  // points far from the object, whose tiles aren't rebuilt
+  std::vector<esp::vec3f> farPoints;
+  while (farPoints.size() < 20) {
+    const esp::vec3f point = pathFinder.getRandomNavigablePoint();
+    if ((point - randomNavPoint).norm() > 6.0f) {
+      farPoints.push_back(point);
+    }
+  }
+
+  int objectID = simulator->addObject(0);
+  simulator->setTranslation(Magnum::Vector3{randomNavPoint}, objectID);
+  simulator->setObjectMotionType(esp::physics::MotionType::STATIC, objectID);
+  CORRADE_VERIFY(pathFinder.isNavigable(randomNavPoint, 0.1));
+
+  // only the tiles around the object get rebuilt
+  CORRADE_VERIFY(
+      simulator->recomputeNavMesh(pathFinder, navMeshSettings, true));
+  CORRADE_VERIFY(!pathFinder.isNavigable(randomNavPoint, 0.1));
+  for (const esp::vec3f& point : farPoints) {
+    CORRADE_VERIFY(pathFinder.isNavigable(point, 0.1));
+  }
+
+  simulator->removeObject(objectID);
+  CORRADE_VERIFY(
+      simulator->recomputeNavMesh(pathFinder, navMeshSettings, true));
+  CORRADE_VERIFY(pathFinder.isNavigable(randomNavPoint, 0.1));
+
+  // the same as building everything from scratch
+  esp::nav::PathFinder fullPathFinder;
+  CORRADE_VERIFY(
+      simulator->recomputeNavMesh(fullPathFinder, navMeshSettings, true));
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    const esp::vec3f point = fullPathFinder.getRandomNavigablePoint();
+    CORRADE_COMPARE(pathFinder.isNavigable(point, 0.1),
+                    fullPathFinder.isNavigable(point, 0.1));
+  }
+}
+
 void SimTest::loadingObjectTemplates() {
   auto simulator = getSimulator(planeScene);
 
@@ -411,4 +979,25 @@ void SimTest::loadingObjectTemplates() {
 
 }  // namespace
 
+void SimTest::maxTextureSizeForSensors() {
+  // no color sensors, no limit
+  std::vector<esp::sensor::SensorSpec::ptr> specs;
+  CORRADE_COMPARE(esp::sim::maxTextureSizeForSensors(specs), 0);
+  auto depthSpec = esp::sensor::SensorSpec::create();
+  depthSpec->sensorType = esp::sensor::SensorType::DEPTH;
+  depthSpec->resolution = {1024, 1024};
+  specs.push_back(depthSpec);
+  CORRADE_COMPARE(esp::sim::maxTextureSizeForSensors(specs), 0);
+
+  // the largest color sensor decides, rounded up to a power of two
+  auto colorSpec = esp::sensor::SensorSpec::create();
+  colorSpec->resolution = {128, 100};
+  specs.push_back(colorSpec);
+  CORRADE_COMPARE(esp::sim::maxTextureSizeForSensors(specs), 128);
+
+  // a narrower field of view magnifies textures
+  colorSpec->parameters["hfov"] = "45";
+  CORRADE_COMPARE(esp::sim::maxTextureSizeForSensors(specs), 256);
+}
+
 CORRADE_TEST_MAIN(SimTest)
@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 
 #include "esp/scene/SemanticScene.h"
+#include "esp/scene/SuncgObjectCategoryMap.h"
+#include "esp/scene/SuncgSemanticScene.h"
 
 #include "configure.h"
 
@@ -37,3 +39,18 @@ TEST(SuncgTest, Load) {
     }
   }
 }
+
+TEST(SuncgTest, CategoryMap) {
+  // the binary search relies on the table being sorted
+  for (auto it = std::begin(kSuncgObjectCategoryMap) + 1;
+       it != std::end(kSuncgObjectCategoryMap); ++it) {
+    EXPECT_LT(std::strcmp((it - 1)->modelId, it->modelId), 0);
+  }
+
+  SuncgObjectCategory office("0_1", "106");
+  EXPECT_EQ(office.name(""), "chair,office_chair");
+  EXPECT_EQ(office.index(""), suncgObjectCategoryId("106"));
+  SuncgObjectCategory wall("0_2", "Wall");
+  EXPECT_EQ(wall.name(""), "Wall");
+  EXPECT_EQ(wall.index(""), ID_UNDEFINED);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BenchmarkResults.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <numeric>
+
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/core/esp.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace benchmark {
+
+double now() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double cpuNow() {
+  return 1000.0 * std::clock() / CLOCKS_PER_SEC;
+}
+
+double mean(const std::vector<double>& values) {
+  return values.empty() ? 0.0
+                        : std::accumulate(values.begin(), values.end(), 0.0) /
+                              values.size();
+}
+
+double percentile(std::vector<double> values, double fraction) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1,
+                         std::size_t(fraction * values.size()))];
+}
+
+double stddev(const std::vector<double>& values) {
+  if (values.size() < 2) {
+    return 0.0;
+  }
+  const double m = mean(values);
+  double sum = 0.0;
+  for (double value : values) {
+    sum += (value - m) * (value - m);
+  }
+  return std::sqrt(sum / (values.size() - 1));
+}
+
+void beginBenchmark(JsonWriter& writer,
+                    const std::string& name,
+                    const Samples& samples) {
+  const std::vector<double>& times = samples.realTimes;
+  writer.StartObject();
+  writer.Key("name");
+  writer.String(name);
+  writer.Key("iterations");
+  writer.Uint64(times.size());
+  writer.Key("real_time");
+  writer.Double(mean(times));
+  writer.Key("cpu_time");
+  writer.Double(mean(samples.cpuTimes));
+  writer.Key("time_unit");
+  writer.String("ms");
+  writer.Key("median_time");
+  writer.Double(percentile(times, 0.5));
+  writer.Key("p90_time");
+  writer.Double(percentile(times, 0.9));
+  writer.Key("min_time");
+  writer.Double(times.empty() ? 0.0
+                              : *std::min_element(times.begin(), times.end()));
+  writer.Key("max_time");
+  writer.Double(times.empty() ? 0.0
+                              : *std::max_element(times.begin(), times.end()));
+  writer.Key("stddev_time");
+  writer.Double(stddev(times));
+  writer.Key("items_per_second");
+  writer.Double(mean(times) > 0.0 ? 1000.0 / mean(times) : 0.0);
+}
+
+bool writeResults(const rapidjson::StringBuffer& buffer,
+                  const std::string& filename) {
+  if (filename.empty()) {
+    std::printf("%s\n", buffer.GetString());
+    return true;
+  }
+  if (!Cr::Utility::Directory::writeString(filename, buffer.GetString())) {
+    LOG(ERROR) << "Cannot write " << filename;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace benchmark
+}  // namespace esp
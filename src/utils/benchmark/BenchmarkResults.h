@@ -0,0 +1,80 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+namespace esp {
+namespace benchmark {
+
+typedef rapidjson::PrettyWriter<rapidjson::StringBuffer> JsonWriter;
+
+/** @brief Wall clock time in milliseconds, with an arbitrary epoch */
+double now();
+
+/** @brief Processor time of the process in milliseconds */
+double cpuNow();
+
+/** @brief Wall and processor times of every iteration, in milliseconds */
+struct Samples {
+  std::vector<double> realTimes;
+  std::vector<double> cpuTimes;
+};
+
+/**
+ * @brief Time @p iterations calls of @p f after @p warmup untimed ones
+ *
+ * @p f gets the index of the call, counting the warmup ones.
+ */
+template <class F>
+Samples measure(int warmup, int iterations, F&& f) {
+  for (int i = 0; i != warmup; ++i) {
+    f(i);
+  }
+  Samples samples;
+  samples.realTimes.reserve(iterations);
+  samples.cpuTimes.reserve(iterations);
+  for (int i = 0; i != iterations; ++i) {
+    const double cpuStart = cpuNow();
+    const double start = now();
+    f(warmup + i);
+    samples.realTimes.push_back(now() - start);
+    samples.cpuTimes.push_back(cpuNow() - cpuStart);
+  }
+  return samples;
+}
+
+double mean(const std::vector<double>& values);
+
+/** @brief Value below which @p fraction of @p values are */
+double percentile(std::vector<double> values, double fraction);
+
+double stddev(const std::vector<double>& values);
+
+/**
+ * @brief Begin an entry of the "benchmarks" array
+ *
+ * Writes the fields of Google Benchmark's --benchmark_format=json, so tools
+ * tracking those results can consume the output. real_time and cpu_time are
+ * means, the other statistics are of the wall time. The caller adds its own
+ * fields and ends the object.
+ */
+void beginBenchmark(JsonWriter& writer,
+                    const std::string& name,
+                    const Samples& samples);
+
+/**
+ * @brief Write the results to @p filename, or the standard output if empty
+ * @return Whether the file was written
+ */
+bool writeResults(const rapidjson::StringBuffer& buffer,
+                  const std::string& filename);
+
+}  // namespace benchmark
+}  // namespace esp
@@ -0,0 +1,282 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/Context.h>
+
+#include "BenchmarkResults.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/RenderProfiler.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/nav/PathFinder.h"
+#include "esp/sim/Simulator.h"
+
+#include "esp/gfx/configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::benchmark::JsonWriter;
+using esp::benchmark::measure;
+using esp::benchmark::Samples;
+using esp::gfx::RenderProfiler;
+using esp::sensor::SensorSpec;
+using esp::sensor::SensorType;
+using esp::sim::Simulator;
+using esp::sim::SimulatorConfiguration;
+
+namespace {
+
+// An entry named name/scene[/WxH], with the scene and resolution as fields
+void writeBenchmark(JsonWriter& writer,
+                    const std::string& name,
+                    const std::string& scene,
+                    const Mn::Vector2i& resolution,
+                    const Samples& samples,
+                    const std::vector<double>& gpuTimes = {}) {
+  esp::benchmark::beginBenchmark(
+      writer,
+      resolution.isZero()
+          ? Cr::Utility::formatString("{}/{}", name, scene)
+          : Cr::Utility::formatString("{}/{}/{}x{}", name, scene,
+                                      resolution.x(), resolution.y()),
+      samples);
+  writer.Key("benchmark");
+  writer.String(name);
+  writer.Key("scene");
+  writer.String(scene);
+  if (!resolution.isZero()) {
+    writer.Key("resolution");
+    writer.StartArray();
+    writer.Int(resolution.x());
+    writer.Int(resolution.y());
+    writer.EndArray();
+  }
+  if (!gpuTimes.empty()) {
+    writer.Key("gpu_time");
+    writer.Double(esp::benchmark::mean(gpuTimes));
+  }
+  writer.EndObject();
+}
+
+std::vector<SensorSpec::ptr> makeSensorSpecs(const Mn::Vector2i& resolution,
+                                             bool semantic) {
+  std::vector<std::pair<std::string, SensorType>> sensors{
+      {"rgba", SensorType::COLOR}, {"depth", SensorType::DEPTH}};
+  if (semantic) {
+    sensors.emplace_back("semantic", SensorType::SEMANTIC);
+  }
+  std::vector<SensorSpec::ptr> specs;
+  for (const auto& sensor : sensors) {
+    auto spec = SensorSpec::create();
+    spec->uuid = sensor.first;
+    spec->sensorType = sensor.second;
+    spec->resolution = {resolution.y(), resolution.x()};
+    specs.push_back(spec);
+  }
+  return specs;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Cr::Utility::Arguments args;
+  args.addArrayArgument("scene")
+      .setHelp("scene", "scene files to benchmark")
+      .addOption("resolutions", "128x128,256x256,512x512")
+      .setHelp("resolutions", "comma-separated sensor resolutions, WxH")
+      .addOption("iterations", "200")
+      .setHelp("iterations", "timed iterations of every benchmark")
+      .addOption("warmup", "20")
+      .setHelp("warmup", "untimed iterations before the timed ones")
+      .addOption("gpu-device", "0")
+      .setHelp("gpu-device", "CUDA id of the GPU to render on")
+      .addBooleanOption("semantic")
+      .setHelp("semantic", "add a semantic sensor to the color and depth one")
+      .addBooleanOption("enable-physics")
+      .setHelp("enable-physics", "benchmark physics steps")
+      .addOption("physics-config", ESP_DEFAULT_PHYS_SCENE_CONFIG)
+      .setHelp("physics-config", "physics scene config file")
+      .addOption("physics-objects", "20")
+      .setHelp("physics-objects", "objects dropped into the scene")
+      .addOption("output")
+      .setHelp("output", "JSON file to write, standard output if empty")
+      .addSkippedPrefix("magnum", "engine-specific options")
+      .setGlobalHelp(
+          "Measures the throughput of simulator steps, sensor draws and "
+          "readbacks, navigation queries and physics steps natively, without "
+          "Python bindings in the way.")
+      .parse(argc, argv);
+
+  const int iterations = args.value<int>("iterations");
+  const int warmup = args.value<int>("warmup");
+  const bool enablePhysics = args.isSet("enable-physics");
+
+  std::vector<Mn::Vector2i> resolutions;
+  for (const std::string& resolution :
+       Cr::Utility::String::splitWithoutEmptyParts(args.value("resolutions"),
+                                                   ',')) {
+    const std::vector<std::string> size =
+        Cr::Utility::String::splitWithoutEmptyParts(resolution, 'x');
+    if (size.size() != 2) {
+      LOG(ERROR) << "Invalid resolution " << resolution;
+      return 1;
+    }
+    resolutions.emplace_back(std::stoi(size[0]), std::stoi(size[1]));
+  }
+
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer{buffer};
+  writer.StartObject();
+  writer.Key("benchmarks");
+  writer.StartArray();
+
+  std::string glRenderer;
+  std::string glVersion;
+  for (std::size_t s = 0; s != args.arrayValueCount("scene"); ++s) {
+    const std::string scene = args.arrayValue("scene", s);
+    const std::string sceneName = Cr::Utility::Directory::splitExtension(
+                                      Cr::Utility::Directory::filename(scene))
+                                      .first;
+
+    SimulatorConfiguration simConfig;
+    simConfig.scene.id = scene;
+    simConfig.gpuDeviceId = args.value<int>("gpu-device");
+    simConfig.enablePhysics = enablePhysics;
+    simConfig.physicsConfigFile = args.value("physics-config");
+    auto sim = Simulator::create_unique(simConfig);
+    if (glRenderer.empty()) {
+      glRenderer = Mn::GL::Context::current().rendererString();
+      glVersion = Mn::GL::Context::current().versionString();
+    }
+
+    const esp::agent::AgentConfiguration defaultAgentConfig;
+    std::vector<std::string> actions;
+    for (const auto& action : defaultAgentConfig.actionSpace) {
+      actions.push_back(action.first);
+    }
+
+    // the scene stays loaded across resolutions, every resolution gets an
+    // agent of its own, with the id of the resolution
+    for (std::size_t r = 0; r != resolutions.size(); ++r) {
+      const Mn::Vector2i& resolution = resolutions[r];
+      const int agentId = r;
+      esp::agent::AgentConfiguration agentConfig;
+      agentConfig.sensorSpecifications =
+          makeSensorSpecs(resolution, args.isSet("semantic"));
+      sim->addAgent(agentConfig);
+
+      // act, step physics and observe, as one step of an environment
+      writeBenchmark(writer, "step", sceneName, resolution,
+                     measure(warmup, iterations, [&](int i) {
+                       sim->step(agentId, actions[i % actions.size()]);
+                     }));
+
+      // the passes of every sensor, GPU times come from timer queries. Only
+      // the newest RenderProfiler::MaxRecords passes are kept.
+      esp::sim::AgentObservations observations;
+      sim->getRenderer()->setProfiling(true);
+      for (int i = 0; i != warmup; ++i) {
+        sim->getAgentObservations(agentId, observations);
+      }
+      sim->getRenderer()->profiler()->takeRecords(true);
+      writeBenchmark(writer, "observe", sceneName, resolution,
+                     measure(0, iterations, [&](int) {
+                       sim->getAgentObservations(agentId, observations);
+                     }));
+      std::map<std::pair<std::string, RenderProfiler::Pass>,
+               std::pair<Samples, std::vector<double>>>
+          passes;
+      for (const RenderProfiler::Record& record :
+           sim->getRenderer()->profiler()->takeRecords(true)) {
+        auto& pass = passes[{record.sensor, record.pass}];
+        pass.first.realTimes.push_back(record.cpuTime);
+        pass.first.cpuTimes.push_back(record.cpuTime);
+        if (record.gpuTime >= 0.0) {
+          pass.second.push_back(record.gpuTime);
+        }
+      }
+      sim->getRenderer()->setProfiling(false);
+      for (const auto& pass : passes) {
+        const bool draw = pass.first.second == RenderProfiler::Pass::Draw;
+        writeBenchmark(writer,
+                       Cr::Utility::formatString(
+                           "{}/{}", draw ? "draw" : "readback",
+                           pass.first.first),
+                       sceneName, resolution, pass.second.first,
+                       pass.second.second);
+      }
+    }
+
+    // navigation and physics don't depend on the sensor resolution
+    esp::nav::PathFinder::ptr pathfinder = sim->getPathFinder();
+    if (pathfinder->isLoaded()) {
+      pathfinder->seed(0);
+      std::vector<esp::nav::ShortestPath> paths(warmup + iterations);
+      for (esp::nav::ShortestPath& path : paths) {
+        path.requestedStart = pathfinder->getRandomNavigablePoint();
+        path.requestedEnd = pathfinder->getRandomNavigablePoint();
+      }
+      writeBenchmark(writer, "find_path", sceneName, {},
+                     measure(warmup, iterations, [&](int i) {
+                       pathfinder->findPath(paths[i]);
+                     }));
+      writeBenchmark(writer, "try_step", sceneName, {},
+                     measure(warmup, iterations, [&](int i) {
+                       const esp::vec3f& start = paths[i].requestedStart;
+                       const esp::vec3f offset =
+                           (paths[i].requestedEnd - start).normalized() *
+                           0.25f;
+                       pathfinder->tryStep(start, esp::vec3f{start + offset});
+                     }));
+    } else {
+      LOG(WARNING) << "No navmesh for " << scene
+                   << ", skipping navigation benchmarks";
+    }
+
+    if (enablePhysics && sim->getPhysicsObjectLibrarySize() > 0) {
+      const int objectCount = args.value<int>("physics-objects");
+      for (int i = 0; i != objectCount; ++i) {
+        const int objectId =
+            sim->addObject(i % sim->getPhysicsObjectLibrarySize());
+        Mn::Vector3 position{1.0f, 0.0f, 1.0f};
+        if (pathfinder->isLoaded()) {
+          position = Mn::Vector3{pathfinder->getRandomNavigablePoint()};
+        }
+        position.y() += 1.0f + 0.5f * (i % 4);
+        sim->setTranslation(position, objectId);
+      }
+      writeBenchmark(writer, "physics_step", sceneName, {},
+                     measure(warmup, iterations,
+                             [&](int) { sim->stepWorld(1.0 / 60.0); }));
+    }
+  }
+
+  writer.EndArray();
+  writer.Key("context");
+  writer.StartObject();
+  writer.Key("executable");
+  writer.String(argv[0]);
+  writer.Key("gl_renderer");
+  writer.String(glRenderer);
+  writer.Key("gl_version");
+  writer.String(glVersion);
+  writer.Key("iterations");
+  writer.Int(iterations);
+  writer.Key("warmup");
+  writer.Int(warmup);
+  writer.EndObject();
+  writer.EndObject();
+
+  return esp::benchmark::writeResults(buffer, args.value("output")) ? 0 : 1;
+}
@@ -0,0 +1,273 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Renderer.h>
+
+#include "BenchmarkResults.h"
+#include "esp/assets/ResourceManager.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/scene/SceneManager.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::assets::AssetInfo;
+using esp::assets::AssetType;
+using esp::assets::ResourceManager;
+using esp::assets::SceneLoadStatistics;
+using esp::benchmark::JsonWriter;
+using esp::benchmark::Samples;
+
+namespace {
+
+const char* assetTypeName(AssetType type) {
+  switch (type) {
+    case AssetType::SUNCG_OBJECT:
+      return "suncg_object";
+    case AssetType::SUNCG_SCENE:
+      return "suncg_scene";
+    case AssetType::MP3D_MESH:
+      return "mp3d_mesh";
+    case AssetType::INSTANCE_MESH:
+      return "instance_mesh";
+    case AssetType::FRL_PTEX_MESH:
+      return "frl_ptex_mesh";
+    case AssetType::NAVMESH:
+      return "navmesh";
+    case AssetType::UNKNOWN:
+    case AssetType::UNKNOWN2:
+      break;
+  }
+  return "generic";
+}
+
+constexpr struct {
+  SceneLoadStatistics::Stage stage;
+  const char* name;
+} Stages[]{
+    {SceneLoadStatistics::Stage::ImporterOpen, "importer_open"},
+    {SceneLoadStatistics::Stage::Textures, "textures"},
+    {SceneLoadStatistics::Stage::Meshes, "meshes"},
+    {SceneLoadStatistics::Stage::MeshHierarchy, "mesh_hierarchy"},
+    {SceneLoadStatistics::Stage::Materials, "materials"},
+    {SceneLoadStatistics::Stage::GpuUpload, "gpu_upload"},
+    {SceneLoadStatistics::Stage::AbsoluteAABBs, "absolute_aabbs"},
+    {SceneLoadStatistics::Stage::Shaders, "shaders"},
+};
+
+// Field of /proc/self/status in bytes, 0 if not available
+std::size_t processStatus(const char* field) {
+  FILE* fp = std::fopen("/proc/self/status", "r");
+  if (!fp) {
+    return 0;
+  }
+  const std::size_t fieldLength = std::strlen(field);
+  std::size_t kilobytes = 0;
+  char line[256];
+  while (std::fgets(line, sizeof(line), fp)) {
+    if (std::strncmp(line, field, fieldLength) == 0 &&
+        line[fieldLength] == ':') {
+      std::sscanf(line + fieldLength + 1, "%zu", &kilobytes);
+      break;
+    }
+  }
+  std::fclose(fp);
+  return kilobytes * 1024;
+}
+
+// Restarts the peak RSS of the process, so VmHWM afterwards is the peak of
+// what follows. Needs Linux 4.0, false if the peak couldn't be reset.
+bool resetPeakRss() {
+  FILE* fp = std::fopen("/proc/self/clear_refs", "w");
+  if (!fp) {
+    return false;
+  }
+  const bool written = std::fputs("5", fp) >= 0;
+  return std::fclose(fp) == 0 && written;
+}
+
+// Measurements of one load
+struct Load {
+  double totalTime;
+  double cpuTime;
+  std::map<SceneLoadStatistics::Stage, double> stageTimes;
+  std::size_t rssBefore;
+  std::size_t rssAfter;
+  std::size_t peakRss;
+  ResourceManager::GpuMemoryUsage gpuMemory;
+};
+
+Load loadScene(const AssetInfo& info) {
+  Load load{};
+  // in this order, the scene graph holds drawables referencing the meshes
+  ResourceManager resourceManager;
+  esp::scene::SceneManager sceneManager;
+  esp::scene::SceneGraph& sceneGraph =
+      sceneManager.getSceneGraph(sceneManager.initSceneGraph());
+
+  load.rssBefore = processStatus("VmRSS");
+  const bool peakReset = resetPeakRss();
+  const double cpuStart = esp::benchmark::cpuNow();
+  resourceManager.resetSceneLoadStatistics();
+  const double start = esp::benchmark::now();
+  if (!resourceManager.loadScene(info, &sceneGraph.getRootNode().createChild(),
+                                 &sceneGraph.getDrawables())) {
+    LOG(ERROR) << "Cannot load " << info.filepath;
+  }
+  // the load ends once the GPU has the data
+  Mn::GL::Renderer::finish();
+  load.totalTime = esp::benchmark::now() - start;
+  load.cpuTime = esp::benchmark::cpuNow() - cpuStart;
+  load.rssAfter = processStatus("VmRSS");
+  load.peakRss = peakReset ? processStatus("VmHWM") : 0;
+
+  for (const auto& stage : Stages) {
+    load.stageTimes[stage.stage] =
+        resourceManager.sceneLoadStatistics().stageTime(stage.stage);
+  }
+  load.gpuMemory = resourceManager.gpuMemoryUsage();
+  return load;
+}
+
+void writeBytes(JsonWriter& writer, const char* key, std::size_t bytes) {
+  writer.Key(key);
+  writer.Uint64(bytes);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Cr::Utility::Arguments args;
+  args.addArrayArgument("scene")
+      .setHelp("scene",
+               "scene files to load, the asset type is detected from the path")
+      .addOption("iterations", "3")
+      .setHelp("iterations", "loads of every scene")
+      .addOption("gpu-device", "0")
+      .setHelp("gpu-device", "CUDA id of the GPU to load on")
+      .addOption("output")
+      .setHelp("output", "JSON file to write, standard output if empty")
+      .addSkippedPrefix("magnum", "engine-specific options")
+      .setGlobalHelp(
+          "Measures ResourceManager::loadScene() for each scene: wall time "
+          "and GPU bytes per load stage and peak resident memory. Every load "
+          "starts from a new resource manager, so nothing is cached in the "
+          "process; the first load of a scene may also read the files from "
+          "disk instead of the page cache.")
+      .parse(argc, argv);
+
+  const int iterations = args.value<int>("iterations");
+  esp::gfx::WindowlessContext context{args.value<int>("gpu-device")};
+
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer{buffer};
+  writer.StartObject();
+  writer.Key("benchmarks");
+  writer.StartArray();
+
+  for (std::size_t s = 0; s != args.arrayValueCount("scene"); ++s) {
+    const AssetInfo info = AssetInfo::fromPath(args.arrayValue("scene", s));
+    const std::string type = assetTypeName(info.type);
+    const std::string sceneName =
+        Cr::Utility::Directory::splitExtension(
+            Cr::Utility::Directory::filename(info.filepath))
+            .first;
+
+    std::vector<Load> loads;
+    for (int i = 0; i != iterations; ++i) {
+      loads.push_back(loadScene(info));
+    }
+    if (loads.empty()) {
+      continue;
+    }
+    // memory doesn't depend on the iteration except for the peak, which is
+    // the largest of all loads, and the growth of the first, cold load
+    const Load& last = loads.back();
+    std::size_t peakRss = 0;
+    for (const Load& load : loads) {
+      peakRss = std::max(peakRss, load.peakRss);
+    }
+
+    Samples total;
+    for (const Load& load : loads) {
+      total.realTimes.push_back(load.totalTime);
+      total.cpuTimes.push_back(load.cpuTime);
+    }
+    esp::benchmark::beginBenchmark(
+        writer, Cr::Utility::formatString("load/{}/{}", type, sceneName),
+        total);
+    writer.Key("scene");
+    writer.String(info.filepath);
+    writer.Key("asset_type");
+    writer.String(type);
+    writer.Key("stage");
+    writer.String("total");
+    writeBytes(writer, "peak_rss_bytes", peakRss);
+    writeBytes(writer, "rss_growth_bytes",
+               loads.front().rssAfter > loads.front().rssBefore
+                   ? loads.front().rssAfter - loads.front().rssBefore
+                   : 0);
+    writeBytes(writer, "gpu_bytes", last.gpuMemory.totalBytes());
+    writeBytes(writer, "gpu_vertex_bytes", last.gpuMemory.vertexBytes);
+    writeBytes(writer, "gpu_index_bytes", last.gpuMemory.indexBytes);
+    writeBytes(writer, "gpu_texture_bytes", last.gpuMemory.textureBytes);
+    writer.EndObject();
+
+    for (const auto& stage : Stages) {
+      Samples samples;
+      for (const Load& load : loads) {
+        // stages are timed on the CPU only
+        samples.realTimes.push_back(load.stageTimes.at(stage.stage));
+        samples.cpuTimes.push_back(load.stageTimes.at(stage.stage));
+      }
+      esp::benchmark::beginBenchmark(
+          writer,
+          Cr::Utility::formatString("load/{}/{}/{}", type, sceneName,
+                                    stage.name),
+          samples);
+      writer.Key("scene");
+      writer.String(info.filepath);
+      writer.Key("asset_type");
+      writer.String(type);
+      writer.Key("stage");
+      writer.String(stage.name);
+      // the stages creating GPU resources get their bytes
+      if (stage.stage == SceneLoadStatistics::Stage::Textures) {
+        writeBytes(writer, "gpu_bytes", last.gpuMemory.textureBytes);
+      } else if (stage.stage == SceneLoadStatistics::Stage::GpuUpload) {
+        writeBytes(writer, "gpu_bytes",
+                   last.gpuMemory.vertexBytes + last.gpuMemory.indexBytes);
+      }
+      writer.EndObject();
+    }
+  }
+
+  writer.EndArray();
+  writer.Key("context");
+  writer.StartObject();
+  writer.Key("executable");
+  writer.String(argv[0]);
+  writer.Key("gl_renderer");
+  writer.String(Mn::GL::Context::current().rendererString());
+  writer.Key("gl_version");
+  writer.String(Mn::GL::Context::current().versionString());
+  writer.Key("iterations");
+  writer.Int(iterations);
+  writer.EndObject();
+  writer.EndObject();
+
+  return esp::benchmark::writeResults(buffer, args.value("output")) ? 0 : 1;
+}
@@ -0,0 +1,449 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "NavMeshBatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "SceneLoader.h"
+#include "esp/core/esp.h"
+#include "esp/io/io.h"
+#include "esp/io/json.h"
+#include "esp/nav/PathFinder.h"
+
+namespace Cr = Corrade;
+
+using esp::nav::NavMeshSettings;
+using esp::nav::PathFinder;
+
+namespace {
+
+// bumped whenever the navmesh built from the same input changes, so the
+// hashes of older builds don't match anymore
+constexpr uint64_t BuildVersion = 1;
+
+// loading and voxelizing a mesh peaks at roughly this many times the size
+// of its file
+constexpr std::size_t MemoryPerFileByte = 8;
+
+struct Job {
+  std::string scene;
+  std::string navmesh;
+  NavMeshSettings settings;
+};
+
+struct Result {
+  enum class Status { Built, Skipped, Failed } status = Status::Failed;
+  std::string error;
+  uint64_t inputHash = 0;
+  double hashSeconds = 0.0;
+  double loadSeconds = 0.0;
+  double buildSeconds = 0.0;
+  double saveSeconds = 0.0;
+  std::size_t inputVertices = 0;
+  std::size_t inputTriangles = 0;
+  std::size_t navmeshVertices = 0;
+  std::size_t navmeshTriangles = 0;
+};
+
+void readSettings(const esp::io::JsonGenericValue& json,
+                  NavMeshSettings& settings) {
+  if (!json.IsObject()) {
+    return;
+  }
+  const std::pair<const char*, float*> floats[]{
+      {"cell_size", &settings.cellSize},
+      {"cell_height", &settings.cellHeight},
+      {"agent_height", &settings.agentHeight},
+      {"agent_radius", &settings.agentRadius},
+      {"agent_max_climb", &settings.agentMaxClimb},
+      {"agent_max_slope", &settings.agentMaxSlope},
+      {"region_min_size", &settings.regionMinSize},
+      {"region_merge_size", &settings.regionMergeSize},
+      {"edge_max_len", &settings.edgeMaxLen},
+      {"edge_max_error", &settings.edgeMaxError},
+      {"verts_per_poly", &settings.vertsPerPoly},
+      {"detail_sample_dist", &settings.detailSampleDist},
+      {"detail_sample_max_error", &settings.detailSampleMaxError}};
+  for (const auto& field : floats) {
+    if (json.HasMember(field.first) && json[field.first].IsNumber()) {
+      *field.second = json[field.first].GetFloat();
+    }
+  }
+  const std::pair<const char*, bool*> bools[]{
+      {"filter_low_hanging_obstacles", &settings.filterLowHangingObstacles},
+      {"filter_ledge_spans", &settings.filterLedgeSpans},
+      {"filter_walkable_low_height_spans",
+       &settings.filterWalkableLowHeightSpans}};
+  for (const auto& field : bools) {
+    if (json.HasMember(field.first) && json[field.first].IsBool()) {
+      *field.second = json[field.first].GetBool();
+    }
+  }
+  if (json.HasMember("tile_size") && json["tile_size"].IsInt()) {
+    settings.tileSize = json["tile_size"].GetInt();
+  }
+}
+
+// FNV-1a
+void hashBytes(uint64_t& hash, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+}
+
+// field by field, the bounds are left uninitialized by setDefaults() and
+// not used by the build
+void hashSettings(uint64_t& hash, const NavMeshSettings& settings) {
+  const float floats[]{settings.cellSize,
+                       settings.cellHeight,
+                       settings.agentHeight,
+                       settings.agentRadius,
+                       settings.agentMaxClimb,
+                       settings.agentMaxSlope,
+                       settings.regionMinSize,
+                       settings.regionMergeSize,
+                       settings.edgeMaxLen,
+                       settings.edgeMaxError,
+                       settings.vertsPerPoly,
+                       settings.detailSampleDist,
+                       settings.detailSampleMaxError};
+  hashBytes(hash, floats, sizeof(floats));
+  const int ints[]{settings.filterLowHangingObstacles,
+                   settings.filterLedgeSpans,
+                   settings.filterWalkableLowHeightSpans, settings.tileSize};
+  hashBytes(hash, ints, sizeof(ints));
+}
+
+std::string hashString(uint64_t hash) {
+  char string[17];
+  std::snprintf(string, sizeof(string), "%016llx",
+                static_cast<unsigned long long>(hash));
+  return string;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+// admits jobs while their estimated memory fits the budget, or one at a time
+// if it doesn't
+class MemoryGate {
+ public:
+  explicit MemoryGate(std::size_t budget) : budget_{budget} {}
+
+  void acquire(std::size_t bytes) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    available_.wait(lock, [&]() {
+      return budget_ == 0 || used_ == 0 || used_ + bytes <= budget_;
+    });
+    used_ += bytes;
+  }
+
+  void release(std::size_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      used_ -= bytes;
+    }
+    available_.notify_all();
+  }
+
+ private:
+  std::size_t budget_;
+  std::size_t used_ = 0;
+  std::mutex mutex_;
+  std::condition_variable available_;
+};
+
+// Builds the navmeshes of jobs of the same scene, which is loaded and
+// voxelized once for all of them
+std::vector<Result> buildNavMeshes(const std::vector<const Job*>& jobs,
+                                   MemoryGate& gate) {
+  std::vector<Result> results(jobs.size());
+  const std::string& scene = jobs.front()->scene;
+  auto start = std::chrono::steady_clock::now();
+  std::size_t fileSize;
+  {
+    const Cr::Containers::Array<char> data =
+        Cr::Utility::Directory::read(scene);
+    if (data.empty()) {
+      for (Result& result : results) {
+        result.error = "cannot read " + scene;
+      }
+      return results;
+    }
+    fileSize = data.size();
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+      uint64_t hash = 14695981039346656037ull;
+      hashBytes(hash, &BuildVersion, sizeof(BuildVersion));
+      hashSettings(hash, jobs[i]->settings);
+      hashBytes(hash, data.data(), data.size());
+      results[i].inputHash = hash;
+    }
+  }
+  const double hashSeconds = secondsSince(start);
+
+  std::vector<std::size_t> pending;
+  std::vector<NavMeshSettings> variants;
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    results[i].hashSeconds = hashSeconds;
+    if (esp::io::exists(jobs[i]->navmesh) &&
+        Cr::Utility::Directory::readString(jobs[i]->navmesh + ".inputhash") ==
+            hashString(results[i].inputHash)) {
+      results[i].status = Result::Status::Skipped;
+    } else {
+      pending.push_back(i);
+      variants.push_back(jobs[i]->settings);
+    }
+  }
+  if (pending.empty()) {
+    return results;
+  }
+
+  const std::size_t memory = fileSize * MemoryPerFileByte;
+  gate.acquire(memory);
+  start = std::chrono::steady_clock::now();
+  esp::assets::MeshData mesh;
+  {
+    esp::assets::SceneLoader loader;
+    mesh = loader.load(esp::assets::AssetInfo::fromPath(scene));
+  }
+  const double loadSeconds = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  const std::vector<PathFinder::ptr> pathfinders =
+      PathFinder::buildVariants(variants, mesh);
+  const double buildSeconds = secondsSince(start);
+  for (std::size_t i : pending) {
+    results[i].loadSeconds = loadSeconds;
+    results[i].buildSeconds = buildSeconds;
+    results[i].inputVertices = mesh.vbo.size();
+    results[i].inputTriangles = mesh.ibo.size() / 3;
+  }
+  // the input mesh isn't needed anymore
+  mesh = esp::assets::MeshData{};
+  gate.release(memory);
+
+  for (std::size_t v = 0; v < pending.size(); ++v) {
+    const Job& job = *jobs[pending[v]];
+    Result& result = results[pending[v]];
+    if (!pathfinders[v]) {
+      result.error = "failed to build the navmesh";
+      continue;
+    }
+    const std::shared_ptr<esp::assets::MeshData> navmesh =
+        pathfinders[v]->getNavMeshData();
+    if (navmesh != nullptr) {
+      result.navmeshVertices = navmesh->vbo.size();
+      result.navmeshTriangles = navmesh->ibo.size() / 3;
+    }
+
+    start = std::chrono::steady_clock::now();
+    if (!pathfinders[v]->saveNavMesh(job.navmesh) ||
+        !Cr::Utility::Directory::writeString(job.navmesh + ".inputhash",
+                                             hashString(result.inputHash))) {
+      result.error = "failed to save " + job.navmesh;
+      continue;
+    }
+    result.saveSeconds = secondsSince(start);
+    result.status = Result::Status::Built;
+  }
+  return results;
+}
+
+bool writeReport(const std::string& reportFile,
+                 const std::vector<Job>& jobs,
+                 const std::vector<Result>& results,
+                 double totalSeconds) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer{buffer};
+  std::size_t counts[3]{};
+  writer.StartObject();
+  writer.Key("scenes");
+  writer.StartArray();
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    const Result& result = results[i];
+    ++counts[int(result.status)];
+    writer.StartObject();
+    writer.Key("scene");
+    writer.String(jobs[i].scene.c_str());
+    writer.Key("navmesh");
+    writer.String(jobs[i].navmesh.c_str());
+    writer.Key("status");
+    writer.String(result.status == Result::Status::Built     ? "built"
+                  : result.status == Result::Status::Skipped ? "skipped"
+                                                             : "failed");
+    if (!result.error.empty()) {
+      writer.Key("error");
+      writer.String(result.error.c_str());
+    }
+    writer.Key("input_hash");
+    writer.String(hashString(result.inputHash).c_str());
+    const std::pair<const char*, double> seconds[]{
+        {"hash_seconds", result.hashSeconds},
+        {"load_seconds", result.loadSeconds},
+        {"build_seconds", result.buildSeconds},
+        {"save_seconds", result.saveSeconds}};
+    for (const auto& field : seconds) {
+      writer.Key(field.first);
+      writer.Double(field.second);
+    }
+    const std::pair<const char*, std::size_t> sizes[]{
+        {"input_vertices", result.inputVertices},
+        {"input_triangles", result.inputTriangles},
+        {"navmesh_vertices", result.navmeshVertices},
+        {"navmesh_triangles", result.navmeshTriangles}};
+    for (const auto& field : sizes) {
+      writer.Key(field.first);
+      writer.Uint64(field.second);
+    }
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.Key("built");
+  writer.Uint64(counts[int(Result::Status::Built)]);
+  writer.Key("skipped");
+  writer.Uint64(counts[int(Result::Status::Skipped)]);
+  writer.Key("failed");
+  writer.Uint64(counts[int(Result::Status::Failed)]);
+  writer.Key("total_seconds");
+  writer.Double(totalSeconds);
+  writer.EndObject();
+  return Cr::Utility::Directory::writeString(reportFile, buffer.GetString());
+}
+
+}  // namespace
+
+int createNavMeshBatch(const std::string& manifestFile,
+                       const std::string& reportFile,
+                       int jobCount,
+                       std::size_t memoryBudget) {
+  const auto start = std::chrono::steady_clock::now();
+  if (!esp::io::exists(manifestFile)) {
+    LOG(ERROR) << "Cannot find manifest " << manifestFile;
+    return 1;
+  }
+  const esp::io::JsonDocument manifest = esp::io::parseJsonFile(manifestFile);
+  if (!manifest.IsObject() || !manifest.HasMember("scenes") ||
+      !manifest["scenes"].IsArray()) {
+    LOG(ERROR) << "Manifest " << manifestFile << " has no scenes array";
+    return 1;
+  }
+
+  NavMeshSettings defaults;
+  defaults.setDefaults();
+  if (manifest.HasMember("settings")) {
+    readSettings(manifest["settings"], defaults);
+  }
+  const std::string baseDirectory = Cr::Utility::Directory::path(manifestFile);
+  std::vector<Job> jobs;
+  // indices of the jobs of each entry, built together
+  std::vector<std::vector<std::size_t>> groups;
+  for (const auto& entry : manifest["scenes"].GetArray()) {
+    if (!entry.IsObject() || !entry.HasMember("scene") ||
+        !entry["scene"].IsString()) {
+      LOG(ERROR) << "Skipping a manifest entry without a scene";
+      continue;
+    }
+    Job job;
+    job.scene = Cr::Utility::Directory::join(baseDirectory,
+                                             entry["scene"].GetString());
+    job.navmesh =
+        entry.HasMember("navmesh") && entry["navmesh"].IsString()
+            ? Cr::Utility::Directory::join(baseDirectory,
+                                           entry["navmesh"].GetString())
+            : esp::io::changeExtension(job.scene, ".navmesh");
+    job.settings = defaults;
+    if (entry.HasMember("settings")) {
+      readSettings(entry["settings"], job.settings);
+    }
+
+    groups.emplace_back();
+    if (!entry.HasMember("variants") || !entry["variants"].IsArray()) {
+      groups.back().push_back(jobs.size());
+      jobs.push_back(std::move(job));
+      continue;
+    }
+    for (const auto& variant : entry["variants"].GetArray()) {
+      if (!variant.IsObject() || !variant.HasMember("navmesh") ||
+          !variant["navmesh"].IsString()) {
+        LOG(ERROR) << "Skipping a variant of " << job.scene
+                   << " without a navmesh";
+        continue;
+      }
+      Job variantJob = job;
+      variantJob.navmesh = Cr::Utility::Directory::join(
+          baseDirectory, variant["navmesh"].GetString());
+      if (variant.HasMember("settings")) {
+        readSettings(variant["settings"], variantJob.settings);
+      }
+      groups.back().push_back(jobs.size());
+      jobs.push_back(std::move(variantJob));
+    }
+    if (groups.back().empty()) {
+      groups.pop_back();
+    }
+  }
+
+  if (jobCount <= 0) {
+    jobCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  jobCount = std::min<int>(jobCount, groups.size());
+  LOG(INFO) << "Building " << jobs.size() << " navmeshes of " << groups.size()
+            << " scenes with " << jobCount << " jobs";
+
+  std::vector<Result> results(jobs.size());
+  MemoryGate gate{memoryBudget};
+  std::atomic<std::size_t> next{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < jobCount; ++i) {
+    threads.emplace_back([&]() {
+      for (std::size_t index = next++; index < groups.size();
+           index = next++) {
+        std::vector<const Job*> groupJobs;
+        for (std::size_t job : groups[index]) {
+          groupJobs.push_back(&jobs[job]);
+        }
+        const std::vector<Result> groupResults =
+            buildNavMeshes(groupJobs, gate);
+        for (std::size_t j = 0; j < groupJobs.size(); ++j) {
+          const std::size_t job = groups[index][j];
+          results[job] = groupResults[j];
+          if (results[job].status == Result::Status::Failed) {
+            LOG(ERROR) << jobs[job].navmesh << ": " << results[job].error;
+          }
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const bool failed =
+      std::any_of(results.begin(), results.end(), [](const Result& result) {
+        return result.status == Result::Status::Failed;
+      });
+  if (!writeReport(reportFile, jobs, results, secondsSince(start))) {
+    LOG(ERROR) << "Cannot write report " << reportFile;
+    return 1;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Build the navmeshes of all scenes listed in a manifest
+ * @param manifestFile  JSON file of the form
+ *      @code{.json}
+ *      {
+ *        "settings": {"agent_radius": 0.2, "tile_size": 128},
+ *        "scenes": [
+ *          {"scene": "a.glb", "navmesh": "a.navmesh"},
+ *          {"scene": "b.glb", "navmesh": "b_r0.3.navmesh",
+ *           "settings": {"agent_radius": 0.3}},
+ *          {"scene": "c.glb", "variants": [
+ *            {"navmesh": "c_r0.1.navmesh", "settings": {"agent_radius": 0.1}},
+ *            {"navmesh": "c_r0.3.navmesh", "settings": {"agent_radius": 0.3}}
+ *          ]}
+ *        ]
+ *      }
+ *      @endcode
+ *      Settings use the names of the Python NavMeshSettings. Scene settings
+ *      override the top-level ones, which override the defaults, and
+ *      variant settings override the scene ones. The variants of a scene
+ *      are built together with @ref esp::nav::PathFinder::buildVariants(),
+ *      loading and voxelizing the scene once. Relative paths are relative to
+ *      the manifest.
+ * @param reportFile    JSON file the per-scene status, timings and mesh
+ *      statistics are written to
+ * @param jobs          Scenes built concurrently, 0 for one per hardware
+ *      thread
+ * @param memoryBudget  Estimated bytes the scenes being built may take at
+ *      most, 0 for no limit. A scene larger than the budget is built alone
+ * @return 0 if every scene was built or skipped, 1 otherwise
+ *
+ * A hash of the scene file and the settings is written next to each
+ * navmesh with an ``.inputhash`` extension, and scenes whose navmesh exists
+ * with the same hash are skipped.
+ */
+int createNavMeshBatch(const std::string& manifestFile,
+                       const std::string& reportFile,
+                       int jobs,
+                       std::size_t memoryBudget);
@@ -2,30 +2,50 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <unordered_map>
 
+#include "NavMeshBatch.h"
 #include "SceneLoader.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "esp/assets/GenericInstanceMeshData.h"
 #include "esp/assets/Mp3dInstanceMeshData.h"
+#include "esp/assets/ResourceManager.h"
 #include "esp/core/esp.h"
+#include "esp/gfx/PotentiallyVisibleSet.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/io/io.h"
 #include "esp/nav/PathFinder.h"
+#include "esp/scene/SceneManager.h"
 #include "esp/scene/SemanticScene.h"
 
 using namespace esp::assets;
 using namespace esp::scene;
 using namespace esp::nav;
 
-int createNavMesh(const std::string& meshFile, const std::string& navmeshFile) {
+int createNavMesh(const std::string& meshFile,
+                  const std::string& navmeshFile,
+                  int tileSize) {
   SceneLoader loader;
   const AssetInfo info = AssetInfo::fromPath(meshFile);
   const MeshData mesh = loader.load(info);
   NavMeshSettings bs;
   bs.setDefaults();
+  bs.tileSize = tileSize;
   PathFinder pf;
   if (!pf.build(bs, mesh)) {
     LOG(ERROR) << "Failed to build navmesh";
@@ -150,6 +170,209 @@ int createMp3dSemanticMesh(const std::string& plyFile,
   return 0;
 }
 
+int bakeInstanceMesh(const std::string& plyFile,
+                     const std::string& bakedFile) {
+  Corrade::PluginManager::Manager<Magnum::Trade::AbstractImporter> manager;
+  Corrade::Containers::Pointer<Magnum::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("StanfordImporter");
+  if (!importer) {
+    LOG(ERROR) << "Failed to load StanfordImporter";
+    return 1;
+  }
+
+  const std::vector<GenericInstanceMeshData::uptr> meshes =
+      GenericInstanceMeshData::fromPlySplitByObjectId(*importer, plyFile);
+  if (meshes.empty()) {
+    LOG(ERROR) << "Failed loading instance mesh PLY " << plyFile;
+    return 1;
+  }
+  if (!GenericInstanceMeshData::saveBaked(meshes, bakedFile)) {
+    LOG(ERROR) << "Failed saving baked instance mesh " << bakedFile;
+    return 1;
+  }
+  return 0;
+}
+
+int computePotentiallyVisibleSet(
+    const std::string& sceneFile,
+    const std::string& navmeshFile,
+    const std::string& pvsFile,
+    float cellSize,
+    const std::string& textureCacheDirectory = "") {
+  PathFinder pf;
+  if (!pf.loadNavMesh(navmeshFile)) {
+    LOG(ERROR) << "Failed loading navmesh " << navmeshFile;
+    return 1;
+  }
+
+  // views from points spread over the navmesh triangles, at most this far
+  // apart along their edges
+  const float spacing = 0.5f;
+  const std::shared_ptr<MeshData> navmesh = pf.getNavMeshData();
+  std::vector<Magnum::Vector3> points;
+  for (size_t i = 0; i + 2 < navmesh->ibo.size(); i += 3) {
+    const Magnum::Vector3 a{navmesh->vbo[navmesh->ibo[i]]};
+    const Magnum::Vector3 b{navmesh->vbo[navmesh->ibo[i + 1]]};
+    const Magnum::Vector3 c{navmesh->vbo[navmesh->ibo[i + 2]]};
+    const float longest =
+        std::max({(b - a).length(), (c - b).length(), (a - c).length()});
+    const int steps = std::max(1, int(std::ceil(longest / spacing)));
+    for (int u = 0; u <= steps; ++u) {
+      for (int v = 0; u + v <= steps; ++v) {
+        points.push_back(a + (b - a) * (float(u) / steps) +
+                         (c - a) * (float(v) / steps));
+      }
+    }
+  }
+  if (points.empty()) {
+    LOG(ERROR) << "Navmesh " << navmeshFile << " has no triangles";
+    return 1;
+  }
+
+  // must be created before and destroyed after the GL resources
+  esp::gfx::WindowlessContext::uptr context =
+      esp::gfx::WindowlessContext::create_unique(0);
+  ResourceManager resourceManager;
+  // the scene load fills the texture cache as a side effect
+  if (!textureCacheDirectory.empty()) {
+    resourceManager.compressTextures(true);
+    resourceManager.setTextureCacheDirectory(textureCacheDirectory);
+  }
+  SceneManager sceneManager;
+  SceneGraph& sceneGraph =
+      sceneManager.getSceneGraph(sceneManager.initSceneGraph());
+  if (!resourceManager.loadScene(AssetInfo::fromPath(sceneFile),
+                                 &sceneGraph.getRootNode(),
+                                 &sceneGraph.getDrawables())) {
+    LOG(ERROR) << "Failed loading scene " << sceneFile;
+    return 1;
+  }
+
+  esp::gfx::PotentiallyVisibleSet::Settings settings;
+  if (cellSize > 0.0f) {
+    settings.cellSize = cellSize;
+  }
+  LOG(INFO) << "Computing visibility from " << points.size() << " points";
+  const esp::gfx::PotentiallyVisibleSet pvs =
+      esp::gfx::PotentiallyVisibleSet::compute(
+          sceneGraph.getDrawables(), sceneGraph.getDefaultRenderCamera(),
+          points, settings);
+  LOG(INFO) << "Computed " << pvs.cellCount() << " cells of "
+            << pvs.drawableCount() << " drawables";
+  if (!pvs.save(pvsFile)) {
+    LOG(ERROR) << "Failed saving potentially visible set " << pvsFile;
+    return 1;
+  }
+  return 0;
+}
+
+// Writes every file the simulator memory-maps or reads instead of processing
+// the scene on load, next to the scene where it looks for them, and lists
+// them in packageFile so they can be shipped together
+int bakeScene(const std::string& sceneFile,
+              const std::string& packageFile,
+              const std::string& textureCacheDirectory) {
+  struct Artifact {
+    const char* kind;
+    std::string file;
+    bool baked;
+  };
+  std::vector<Artifact> artifacts;
+
+  // same lookup as the simulator does for the semantic mesh
+  std::string houseFile = esp::io::changeExtension(sceneFile, ".house");
+  if (!esp::io::exists(houseFile)) {
+    houseFile = esp::io::changeExtension(sceneFile, ".scn");
+  }
+  const std::string semanticMeshFile =
+      esp::io::removeExtension(houseFile) + "_semantic.ply";
+  if (esp::io::exists(semanticMeshFile)) {
+    LOG(INFO) << "Baking instance mesh " << semanticMeshFile;
+    const std::string bakedFile =
+        GenericInstanceMeshData::bakedFilename(semanticMeshFile);
+    if (bakeInstanceMesh(semanticMeshFile, bakedFile) != 0) {
+      return 1;
+    }
+    artifacts.push_back({"instance_mesh", bakedFile, true});
+  }
+
+  // navmeshes shipped with the dataset may have been built with other
+  // settings, so an existing one is kept
+  const std::string navmeshFile =
+      esp::io::changeExtension(sceneFile, ".navmesh");
+  const bool bakeNavmesh = !esp::io::exists(navmeshFile);
+  if (bakeNavmesh) {
+    LOG(INFO) << "Building navmesh " << navmeshFile;
+    if (createNavMesh(sceneFile, navmeshFile, 0) != 0) {
+      return 1;
+    }
+  }
+  artifacts.push_back({"navmesh", navmeshFile, bakeNavmesh});
+
+  // loading the scene for the visible set also writes the PTex submesh
+  // cache and the compressed textures
+  const std::string pvsFile = esp::io::changeExtension(sceneFile, ".pvs");
+  LOG(INFO) << "Computing potentially visible set " << pvsFile;
+  if (computePotentiallyVisibleSet(sceneFile, navmeshFile, pvsFile, 0.0f,
+                                   textureCacheDirectory) != 0) {
+    return 1;
+  }
+  artifacts.push_back({"pvs", pvsFile, true});
+  if (AssetInfo::fromPath(sceneFile).type == AssetType::FRL_PTEX_MESH) {
+    artifacts.push_back({"ptex_submeshes", sceneFile + ".cache", true});
+  }
+  if (!textureCacheDirectory.empty()) {
+    for (const std::string& file : Corrade::Utility::Directory::list(
+             textureCacheDirectory,
+             Corrade::Utility::Directory::Flag::SkipDirectories |
+                 Corrade::Utility::Directory::Flag::SkipDotAndDotDot)) {
+      artifacts.push_back(
+          {"texture",
+           Corrade::Utility::Directory::join(textureCacheDirectory, file),
+           true});
+    }
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer{buffer};
+  size_t totalSize = 0;
+  writer.StartObject();
+  writer.Key("scene");
+  writer.String(sceneFile.c_str());
+  writer.Key("files");
+  writer.StartArray();
+  for (const Artifact& artifact : artifacts) {
+    if (!esp::io::exists(artifact.file)) {
+      LOG(WARNING) << "Expected " << artifact.file << " to be written";
+      continue;
+    }
+    const size_t size = esp::io::fileSize(artifact.file);
+    totalSize += size;
+    writer.StartObject();
+    writer.Key("kind");
+    writer.String(artifact.kind);
+    writer.Key("file");
+    writer.String(artifact.file.c_str());
+    writer.Key("bytes");
+    writer.Uint64(size);
+    writer.Key("baked");
+    writer.Bool(artifact.baked);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.Key("bytes");
+  writer.Uint64(totalSize);
+  writer.EndObject();
+  if (!Corrade::Utility::Directory::writeString(packageFile,
+                                                buffer.GetString())) {
+    LOG(ERROR) << "Failed writing package list " << packageFile;
+    return 1;
+  }
+  LOG(INFO) << "Baked " << artifacts.size() << " files, " << totalSize
+            << " bytes";
+  return 0;
+}
+
 int main(int argc, char** argv) {
   if (argc < 4) {
     std::cout << "Usage: datatool task input_file output_file" << std::endl;
@@ -157,7 +380,14 @@ int main(int argc, char** argv) {
   }
   const std::string task = argv[1];
   if (task == "create_navmesh") {
-    createNavMesh(argv[2], argv[3]);
+    // optional tile size in cells, builds the tiles in parallel
+    createNavMesh(argv[2], argv[3], argc > 4 ? std::stoi(argv[4]) : 0);
+  } else if (task == "create_navmesh_batch") {
+    // optional number of jobs and estimated memory budget in megabytes,
+    // scenes whose scene file and settings are unchanged are skipped
+    return createNavMeshBatch(
+        argv[2], argv[3], argc > 4 ? std::stoi(argv[4]) : 0,
+        argc > 5 ? std::stoull(argv[5]) * 1024 * 1024 : 0);
   } else if (task == "create_mp3d_semantic_mesh") {
     if (argc < 5) {
       std::cout << "Usage: datatool create_mp3d_semantic_mesh input_ply "
@@ -174,6 +404,25 @@ int main(int argc, char** argv) {
       return 64;
     }
     createGibsonSemanticMesh(argv[2], argv[3], argv[4]);
+  } else if (task == "bake_instance_mesh") {
+    // the simulator picks the baked file up if it's next to the PLY
+    return bakeInstanceMesh(argv[2], argv[3]);
+  } else if (task == "compute_pvs") {
+    if (argc < 5) {
+      std::cout << "Usage: datatool compute_pvs input_scene input_navmesh "
+                   "output_pvs [cell_size]"
+                << std::endl;
+      return 64;
+    }
+    // the simulator picks the set up if it's next to the scene mesh with a
+    // .pvs extension
+    return computePotentiallyVisibleSet(argv[2], argv[3], argv[4],
+                                        argc > 5 ? std::stof(argv[5]) : 0.0f);
+  } else if (task == "bake_scene") {
+    // optional directory to cache compressed textures in, one per scene as
+    // all of its files are listed. Use it as
+    // SimulatorConfiguration::textureCacheDirectory with compressTextures
+    return bakeScene(argv[2], argv[3], argc > 4 ? argv[4] : "");
   } else {
     LOG(ERROR) << "Unrecognized task " << task;
     return 1;
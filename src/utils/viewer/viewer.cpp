@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <stdlib.h>
+#include <map>
 
 #include <Magnum/configure.h>
 #include <Magnum/ImGuiIntegration/Context.hpp>
@@ -16,6 +17,7 @@
 
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderProfiler.h"
 #include "esp/nav/PathFinder.h"
 #include "esp/physics/PhysicsManager.h"
 #include "esp/physics/RigidObject.h"
@@ -88,6 +90,10 @@ class Viewer : public Mn::Platform::Application {
 
   void toggleNavMeshVisualization();
 
+  // start or stop timing the passes shown by drawPerformanceHud()
+  void togglePerformanceHud();
+  void drawPerformanceHud(const esp::gfx::RenderCamera::DrawStatistics& stats);
+
   Mn::Vector3 positionOnSphere(Mn::SceneGraph::Camera3D& camera,
                                const Mn::Vector2i& position);
 
@@ -144,6 +150,13 @@ class Viewer : public Mn::Platform::Application {
   Mn::ImGuiIntegration::Context imgui_{Mn::NoCreate};
   bool showFPS_ = true;
   bool frustumCullingEnabled_ = true;
+
+  // frame breakdown, times in milliseconds averaged over the last frames
+  esp::gfx::RenderProfiler::uptr renderProfiler_;
+  double cpuFrameTime_ = 0.0;
+  double physicsStepTime_ = 0.0;
+  std::map<std::string, double> passCpuTimes_;
+  std::map<std::string, double> passGpuTimes_;
 };
 
 Viewer::Viewer(const Arguments& arguments)
@@ -451,6 +464,62 @@ void Viewer::toggleNavMeshVisualization() {
   }
 }
 
+void Viewer::togglePerformanceHud() {
+  if (renderProfiler_) {
+    renderProfiler_ = nullptr;
+  } else {
+    renderProfiler_ = esp::gfx::RenderProfiler::create_unique();
+    passCpuTimes_.clear();
+    passGpuTimes_.clear();
+  }
+}
+
+// exponential moving average, so the numbers don't flicker every frame
+void average(double& value, double sample) {
+  value = value == 0.0 ? sample : value + 0.05 * (sample - value);
+}
+
+void Viewer::drawPerformanceHud(
+    const esp::gfx::RenderCamera::DrawStatistics& stats) {
+  // GPU times arrive a frame or two late, whenever the queries are done
+  for (const esp::gfx::RenderProfiler::Record& record :
+       renderProfiler_->takeRecords()) {
+    average(passCpuTimes_[record.sensor], record.cpuTime);
+    if (record.gpuTime >= 0.0) {
+      average(passGpuTimes_[record.sensor], record.gpuTime);
+    }
+  }
+
+  ImGui::SetNextWindowPos(ImVec2(10, 120));
+  ImGui::Begin("performance", NULL,
+               ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground |
+                   ImGuiWindowFlags_AlwaysAutoResize);
+  ImGui::SetWindowFontScale(1.5);
+  ImGui::Text("CPU frame %.2f ms", cpuFrameTime_);
+  if (!renderProfiler_->isGpuTimingSupported()) {
+    ImGui::Text("  no GPU timer queries");
+  }
+  for (const auto& pass : passCpuTimes_) {
+    auto gpuTime = passGpuTimes_.find(pass.first);
+    if (gpuTime != passGpuTimes_.end()) {
+      ImGui::Text("  %s: CPU %.2f ms, GPU %.2f ms", pass.first.c_str(),
+                  pass.second, gpuTime->second);
+    } else {
+      ImGui::Text("  %s: CPU %.2f ms", pass.first.c_str(), pass.second);
+    }
+  }
+  ImGui::Text("%d drawn, %d culled, %d occluded", stats.drawables,
+              stats.culled, stats.occluded);
+  ImGui::Text("%zu triangles", stats.triangles);
+  if (physicsManager_ != nullptr) {
+    const esp::physics::StepStatistics& physics =
+        physicsManager_->getStepStatistics();
+    ImGui::Text("physics %.2f ms, %d active, %d asleep", physicsStepTime_,
+                physics.activeObjects, physics.sleepingObjects);
+  }
+  ImGui::End();
+}
+
 Mn::Vector3 Viewer::positionOnSphere(Mn::SceneGraph::Camera3D& camera,
                                      const Mn::Vector2i& position) {
   // Convert from window to frame coordinates.
@@ -467,27 +536,39 @@ Mn::Vector3 Viewer::positionOnSphere(Mn::SceneGraph::Camera3D& camera,
 }
 
 void Viewer::drawEvent() {
+  const double frameStart = esp::assets::SceneLoadStatistics::now();
   Mn::GL::defaultFramebuffer.clear(Mn::GL::FramebufferClear::Color |
                                    Mn::GL::FramebufferClear::Depth);
   if (sceneID_.size() <= 0)
     return;
 
-  if (physicsManager_ != nullptr)
+  if (physicsManager_ != nullptr) {
     physicsManager_->stepPhysics(timeline_.previousFrameDuration());
+    average(physicsStepTime_, physicsManager_->getStepStatistics().totalTime);
+  }
 
   int DEFAULT_SCENE = 0;
   int sceneID = sceneID_[DEFAULT_SCENE];
   auto& sceneGraph = sceneManager_.getSceneGraph(sceneID);
   uint32_t visibles = 0;
 
-  for (auto& it : sceneGraph.getDrawableGroups()) {
-    // TODO: remove || true
-    if (it.second.prepareForDraw(*renderCamera_) || true) {
-      visibles += renderCamera_->draw(it.second, frustumCullingEnabled_);
+  renderCamera_->resetDrawStatistics();
+  {
+    esp::gfx::RenderProfiler::ScopedPass pass{
+        renderProfiler_.get(), "scene", esp::gfx::RenderProfiler::Pass::Draw};
+    for (auto& it : sceneGraph.getDrawableGroups()) {
+      // TODO: remove || true
+      if (it.second.prepareForDraw(*renderCamera_) || true) {
+        visibles += renderCamera_->draw(it.second, frustumCullingEnabled_);
+      }
     }
+    pass.setDrawStatistics(renderCamera_->drawStatistics());
   }
 
   if (debugBullet_) {
+    esp::gfx::RenderProfiler::ScopedPass pass{
+        renderProfiler_.get(), "bullet debug",
+        esp::gfx::RenderProfiler::Pass::Draw};
     Mn::Matrix4 camM(renderCamera_->cameraMatrix());
     Mn::Matrix4 projM(renderCamera_->projectionMatrix());
 
@@ -508,6 +589,9 @@ void Viewer::drawEvent() {
     ImGui::Text("%u culled", total - visibles);
     ImGui::End();
   }
+  if (renderProfiler_) {
+    drawPerformanceHud(renderCamera_->drawStatistics());
+  }
 
   /* Set appropriate states. If you only draw ImGui, it is sufficient to
      just enable blending and scissor test in the constructor. */
@@ -516,7 +600,11 @@ void Viewer::drawEvent() {
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::FaceCulling);
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
 
-  imgui_.drawFrame();
+  {
+    esp::gfx::RenderProfiler::ScopedPass pass{
+        renderProfiler_.get(), "imgui", esp::gfx::RenderProfiler::Pass::Draw};
+    imgui_.drawFrame();
+  }
 
   /* Reset state. Only needed if you want to draw something else with
      different state after. */
@@ -525,6 +613,8 @@ void Viewer::drawEvent() {
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::ScissorTest);
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::Blending);
 
+  // without the wait for vsync in swapBuffers()
+  average(cpuFrameTime_, esp::assets::SceneLoadStatistics::now() - frameStart);
   swapBuffers();
   timeline_.nextFrame();
   redraw();
@@ -649,6 +739,9 @@ void Viewer::keyPressEvent(KeyEvent& event) {
     case KeyEvent::Key::C:
       showFPS_ = !showFPS_;
       break;
+    case KeyEvent::Key::H:
+      togglePerformanceHud();
+      break;
     case KeyEvent::Key::O:
       addTemplateObject();
       break;
@@ -90,3 +90,11 @@ def test_physics_object_attributes():
     # test that inheritance is correctly configured
     physics_object_template.set("test_key", "test_string")
     assert physics_object_template.get_string("test_key") == "test_string"
+
+    # the typed getters see values written through the string interface
+    physics_object_template.set("mass", 2.5)
+    assert physics_object_template.get_mass() == 2.5
+    physics_object_template.set("renderMeshHandle", "other_mesh")
+    assert physics_object_template.get_render_mesh_handle() == "other_mesh"
+    physics_object_template.remove_value("mass")
+    assert physics_object_template.get_mass() == 0.0
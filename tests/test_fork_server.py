@@ -0,0 +1,61 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import multiprocessing
+import os.path as osp
+
+import pytest
+
+import habitat_sim
+from examples.settings import make_cfg
+from habitat_sim.fork_server import (
+    ForkServer,
+    live_gl_context_count,
+    preloaded_count,
+)
+
+
+def _count_preloaded(cfg, queue):
+    inherited = preloaded_count()
+    sim = habitat_sim.Simulator(cfg)
+    queue.put(
+        (
+            inherited,
+            preloaded_count(),
+            sim.pathfinder.is_loaded,
+            live_gl_context_count() > 0,
+        )
+    )
+    sim.close()
+
+
+@pytest.mark.gfxtest
+def test_spawn_with_preloaded_scene(make_cfg_settings):
+    if not osp.exists(make_cfg_settings["scene"]):
+        pytest.skip("Skipping {}".format(make_cfg_settings["scene"]))
+    if live_gl_context_count() > 0:
+        pytest.skip("This process already has a GL context")
+
+    cfg = make_cfg(make_cfg_settings)
+    server = ForkServer([cfg.sim_cfg])
+    preloaded = preloaded_count()
+    assert preloaded > 0
+    queue = multiprocessing.get_context("fork").Queue()
+    workers = [server.spawn(_count_preloaded, cfg, queue) for _ in range(2)]
+    results = [queue.get(timeout=120) for _ in workers]
+    for worker in workers:
+        worker.join()
+        assert worker.exitcode == 0
+    # taking the preloaded data in a worker leaves the parent's copy alone
+    assert preloaded_count() == preloaded
+    server.close()
+    assert preloaded_count() == 0
+
+    for inherited, left, has_navmesh, has_context in results:
+        # the worker's simulator used the preloaded data instead of the files
+        assert inherited == preloaded
+        assert left < inherited
+        assert has_navmesh and has_context
+    # the parent never created a context
+    assert live_gl_context_count() == 0
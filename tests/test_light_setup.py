@@ -1,9 +1,18 @@
+import os.path as osp
+
+import numpy as np
+import pytest
+
+import examples.settings
 from habitat_sim.gfx import (
     DEFAULT_LIGHTING_KEY,
     NO_LIGHT_KEY,
     LightInfo,
     LightPositionModel,
 )
+from habitat_sim.utils.common import quat_rotate_vector
+
+_test_scene = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
 
 
 def test_get_no_light_setup(sim):
@@ -35,3 +44,39 @@ def test_set_custom_light_setup(sim):
 
     sim.set_light_setup(light_setup, custom_setup_key)
     assert sim.get_light_setup(custom_setup_key) == light_setup
+
+
+@pytest.mark.gfxtest
+@pytest.mark.skipif(
+    not osp.exists(_test_scene) or not osp.exists("data/objects/"),
+    reason="Requires the habitat-test-scenes and habitat test objects",
+)
+def test_light_range(sim):
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = _test_scene
+    cfg_settings["enable_physics"] = True
+    sim.reconfigure(examples.settings.make_cfg(cfg_settings))
+
+    # an object lit by the default light setup in front of the camera
+    object_id = sim.add_object(0)
+    sensor_state = sim.get_agent(0).get_state().sensor_states["color_sensor"]
+    forward = quat_rotate_vector(sensor_state.rotation, np.array([0.0, 0.0, -1.0]))
+    sim.set_translation(sensor_state.position + 1.5 * forward, object_id)
+
+    def render(light_setup):
+        sim.set_light_setup(light_setup)
+        return np.copy(sim.get_sensor_observations()["color_sensor"])
+
+    far = sensor_state.position + np.array([100.0, 100.0, 100.0])
+    unreachable = [
+        LightInfo(position=far, range=1.0),
+        LightInfo(position=-far, range=1.0),
+    ]
+    camera_light = LightInfo(position=[0.0, 0.0, 0.0], model=LightPositionModel.CAMERA)
+
+    unlit = render([])
+    lit = render([camera_light])
+    assert not np.array_equal(lit, unlit)
+    # lights out of range are left out of the shading
+    assert np.array_equal(render(unreachable), unlit)
+    assert np.array_equal(render([camera_light] + unreachable), lit)
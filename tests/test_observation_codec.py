@@ -0,0 +1,101 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import os.path as osp
+
+import numpy as np
+import pytest
+
+from examples.settings import make_cfg
+from habitat_sim.observation_codec import (
+    ObservationCodec,
+    ObservationDecoder,
+    ObservationEncoder,
+    ObservationEncoderConfiguration,
+    create_encoders,
+    decode_observations,
+    encode_observations,
+)
+
+
+@pytest.mark.parametrize("dtype", [np.uint8, np.uint16, np.int32, np.float32])
+def test_lossless_round_trip(dtype):
+    config = ObservationEncoderConfiguration()
+    config.keyframe_interval = 4
+    encoder = ObservationEncoder(config)
+    decoder = ObservationDecoder()
+
+    rng = np.random.default_rng(3)
+    frame = (rng.random((24, 32, 4)) * 200).astype(dtype)
+    for step in range(6):
+        # a few pixels change from one frame to the next
+        frame[rng.integers(24, size=8), rng.integers(32, size=8)] += dtype(1)
+        packet = encoder.encode(frame)
+        assert encoder.sequence == step + 1
+        decoded = np.asarray(decoder.decode(packet))
+        assert decoded.dtype == frame.dtype
+        assert np.array_equal(decoded, frame)
+        if step % 4:
+            # deltas are mostly zeros
+            assert len(packet) < frame.nbytes / 4
+
+
+def test_quantized_depth():
+    config = ObservationEncoderConfiguration()
+    config.codec = ObservationCodec.QUANTIZED_DEPTH
+    config.depth_step = 0.01
+    encoder = ObservationEncoder(config)
+    decoder = ObservationDecoder()
+
+    depth = np.linspace(0.5, 5.0, 64 * 48, dtype=np.float32).reshape(48, 64)
+    depth[0, :4] = [0.0, np.nan, np.inf, 1000.0]
+    decoded = np.asarray(decoder.decode(encoder.encode(depth)))
+    assert decoded.dtype == np.float32
+    assert np.allclose(decoded[1:], depth[1:], atol=0.005 + 1e-6)
+    assert np.allclose(decoded[0, :4], [0.0, 0.0, 655.35, 655.35])
+
+    # only float depth can be quantized
+    assert encoder.encode(depth.astype(np.uint16)) is None
+
+
+def test_lost_packet():
+    encoder = ObservationEncoder()
+    decoder = ObservationDecoder()
+    frame = np.zeros((8, 8), dtype=np.uint8)
+    assert decoder.decode(encoder.encode(frame)) is not None
+    encoder.encode(frame)
+    # a delta to the frame that got lost
+    assert decoder.decode(encoder.encode(frame)) is None
+    encoder.request_keyframe()
+    assert decoder.decode(encoder.encode(frame)) is not None
+    assert decoder.decode(b"not a packet") is None
+
+
+@pytest.mark.gfxtest
+def test_encode_sensor_observations(sim, make_cfg_settings):
+    if not osp.exists(make_cfg_settings["scene"]):
+        pytest.skip("Skipping {}".format(make_cfg_settings["scene"]))
+    sim.reconfigure(make_cfg(make_cfg_settings))
+
+    encoders = create_encoders(sim)
+    assert (
+        encoders["depth_sensor"].configuration.codec
+        == ObservationCodec.QUANTIZED_DEPTH
+    )
+    assert encoders["color_sensor"].configuration.codec == ObservationCodec.LOSSLESS
+
+    decoders = {}
+    for _ in range(2):
+        expected = sim.get_sensor_observations()
+        packets = encode_observations(encoders, expected)
+        observations = decode_observations(decoders, packets)
+        assert set(observations.keys()) == set(expected.keys())
+        assert np.array_equal(observations["color_sensor"], expected["color_sensor"])
+        assert np.array_equal(
+            observations["semantic_sensor"], expected["semantic_sensor"]
+        )
+        assert np.allclose(
+            observations["depth_sensor"], expected["depth_sensor"], atol=0.0006
+        )
+        sim.step("move_forward")
@@ -1,3 +1,4 @@
+import json
 import math
 import os.path as osp
 import random
@@ -300,3 +301,247 @@ def test_velocity_control(sim):
         assert angle_error < mn.Rad(0.05)
 
         sim.remove_object(object_id)
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb")
+    or not osp.exists("data/objects/"),
+    reason="Requires the habitat-test-scenes and habitat test objects",
+)
+def test_batched_object_state(sim):
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings[
+        "scene"
+    ] = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    sim.reconfigure(hab_cfg)
+
+    object_ids = [sim.add_object(0) for _ in range(5)]
+    for object_id in object_ids:
+        sim.set_object_motion_type(habitat_sim.physics.MotionType.KINEMATIC, object_id)
+
+    translations = np.random.rand(5, 3).astype(np.float32)
+    sim.set_translations(translations, object_ids)
+    for i, object_id in enumerate(object_ids):
+        assert np.allclose(sim.get_translation(object_id), translations[i])
+    assert np.allclose(sim.get_translations(object_ids), translations)
+    # all objects, in the order of get_existing_object_ids()
+    assert np.allclose(
+        sim.get_translations(),
+        [sim.get_translation(i) for i in sim.get_existing_object_ids()],
+    )
+
+    Q = quat_from_angle_axis(np.pi / 2, np.array([0, 1.0, 0]))
+    rotations = np.array([[Q.x, Q.y, Q.z, Q.w]] * 2, dtype=np.float32)
+    sim.set_rotations(rotations, object_ids[1:3])
+    assert np.allclose(quat_from_magnum(sim.get_rotation(object_ids[2])), Q)
+    assert np.allclose(sim.get_rotations(object_ids[1:3]), rotations)
+
+    with pytest.raises(ValueError):
+        sim.set_translations(translations[:2], object_ids)
+
+    for object_id in object_ids:
+        sim.remove_object(object_id)
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb")
+    or not osp.exists("data/objects/"),
+    reason="Requires the habitat-test-scenes and habitat test objects",
+)
+def test_physics_step_profile(sim, tmp_path):
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings[
+        "scene"
+    ] = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    sim.reconfigure(hab_cfg)
+
+    object_id = sim.add_object(0)
+    sim.set_translation(np.array([-0.569043, 2.04804, 13.6156]), object_id)
+
+    step_statistics = []
+    for _ in range(10):
+        sim.step_physics(1.0 / 60.0)
+        step_statistics.append(sim.get_physics_step_statistics())
+    assert all(stats.total_time >= 0.0 for stats in step_statistics)
+    assert step_statistics[0].active_objects == 1
+
+    trace_file = str(tmp_path / "physics_trace.json")
+    habitat_sim.physics.write_chrome_trace(step_statistics, trace_file)
+    with open(trace_file) as f:
+        events = json.load(f)["traceEvents"]
+    assert len(events) == 10 * 6
+    assert events[0]["name"] == "stepPhysics"
+
+    sim.remove_object(object_id)
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb")
+    or not osp.exists("data/objects/"),
+    reason="Requires the habitat-test-scenes and habitat test objects",
+)
+def test_physics_without_renderer():
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings[
+        "scene"
+    ] = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+    cfg_settings["enable_physics"] = True
+    # a blind agent, so no renderer and no GL context are created
+    cfg_settings["color_sensor"] = False
+    cfg_settings["depth_sensor"] = False
+    cfg_settings["semantic_sensor"] = False
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+
+    sim = habitat_sim.Simulator(hab_cfg)
+    assert not hab_cfg.sim_cfg.create_renderer
+    assert sim._sim.renderer is None
+
+    # the scene collides with objects dropped on it
+    object_id = sim.add_object(0)
+    start = np.array([-0.569043, 2.04804, 13.6156])
+    sim.set_translation(start, object_id)
+    if sim.get_object_motion_type(object_id) == habitat_sim.physics.MotionType.DYNAMIC:
+        for _ in range(120):
+            sim.step_physics(1.0 / 60.0)
+        translation = sim.get_translation(object_id)
+        assert translation[1] <= start[1]
+        # resting on the table instead of falling through the scene
+        assert translation[1] > start[1] - 2.0
+
+    # the CPU geometry is enough to recompute the navmesh
+    navmesh_settings = habitat_sim.NavMeshSettings()
+    navmesh_settings.set_defaults()
+    assert sim.recompute_navmesh(sim.pathfinder, navmesh_settings)
+    assert sim.pathfinder.is_loaded
+
+    sim.close()
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"),
+    reason="Requires the habitat-test-scenes",
+)
+def test_collision_bvh_cache(tmp_path):
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings[
+        "scene"
+    ] = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+    cfg_settings["enable_physics"] = True
+    cfg_settings["color_sensor"] = False
+    cfg_settings["depth_sensor"] = False
+    cfg_settings["semantic_sensor"] = False
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    hab_cfg.sim_cfg.collision_cache_directory = str(tmp_path)
+
+    origins = np.array(
+        [[-0.5, 3.0, 13.6], [1.0, 3.0, 10.0], [-2.0, 3.0, 8.0]], dtype=np.float32
+    )
+    directions = np.tile(np.array([0.0, -1.0, 0.0], dtype=np.float32), (3, 1))
+
+    # the first load builds and saves the BVHs, the second loads them
+    distances = []
+    for _ in range(2):
+        sim = habitat_sim.Simulator(hab_cfg)
+        distances.append(sim.cast_rays(origins, directions)[1])
+        sim.close()
+
+    if np.isfinite(distances[0]).any():
+        assert len(list(tmp_path.glob("*.bvhcache"))) > 0
+    assert np.allclose(distances[0], distances[1])
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"),
+    reason="Requires the habitat-test-scenes",
+)
+def test_merged_scene_collision(tmp_path):
+    with open("data/default.phys_scene_config.json") as f:
+        physics_config = json.load(f)
+    # the object paths are relative to the config
+    physics_config.pop("rigid object paths", None)
+
+    origins = np.array(
+        [[-0.5, 3.0, 13.6], [1.0, 3.0, 10.0], [-2.0, 3.0, 8.0]], dtype=np.float32
+    )
+    directions = np.tile(np.array([0.0, -1.0, 0.0], dtype=np.float32), (3, 1))
+
+    distances = []
+    for i, merge_settings in enumerate(
+        [
+            {"merge scene collision meshes": False},
+            {"merge scene collision meshes": True},
+            {"merge scene collision meshes": True, "scene collision chunk size": 4.0},
+        ]
+    ):
+        config_file = tmp_path / "physics_config_{}.json".format(i)
+        with open(config_file, "w") as f:
+            json.dump({**physics_config, **merge_settings}, f)
+
+        cfg_settings = examples.settings.default_sim_settings.copy()
+        cfg_settings[
+            "scene"
+        ] = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+        cfg_settings["enable_physics"] = True
+        cfg_settings["physics_config_file"] = str(config_file)
+        cfg_settings["color_sensor"] = False
+        cfg_settings["depth_sensor"] = False
+        cfg_settings["semantic_sensor"] = False
+        sim = habitat_sim.Simulator(examples.settings.make_cfg(cfg_settings))
+        distances.append(sim.cast_rays(origins, directions)[1])
+        sim.close()
+
+    # welding moves the vertices by about a millimeter
+    for merged in distances[1:]:
+        assert np.array_equal(np.isfinite(distances[0]), np.isfinite(merged))
+        finite = np.isfinite(merged)
+        assert np.allclose(distances[0][finite], merged[finite], atol=0.01)
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb")
+    or not osp.exists("data/objects/"),
+    reason="Requires the habitat-test-scenes and habitat test objects",
+)
+def test_object_pooling(sim):
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings[
+        "scene"
+    ] = "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    hab_cfg.sim_cfg.object_pooling = True
+    sim.reconfigure(hab_cfg)
+
+    object_id = sim.add_object(0)
+    start = np.array([-0.569043, 2.04804, 13.6156])
+    sim.set_translation(start, object_id)
+    sim.set_object_motion_type(habitat_sim.physics.MotionType.KINEMATIC, object_id)
+    sim.remove_object(object_id)
+    assert sim.get_num_pooled_objects() == 1
+    assert len(sim.get_existing_object_ids()) == 0
+
+    # objects on their own node are reused, the others aren't pooled
+    reused_id = sim.add_object(0)
+    assert sim.get_num_pooled_objects() == 0
+    assert reused_id == object_id
+    assert np.allclose(sim.get_translation(reused_id), np.zeros(3))
+    agent_node = sim.get_agent(0).scene_node.create_child()
+    attached_id = sim.add_object(0, agent_node)
+    sim.remove_object(attached_id)
+    assert sim.get_num_pooled_objects() == 0
+
+    # reset like a new object: dynamic and falling under gravity
+    if sim.get_object_motion_type(reused_id) == habitat_sim.physics.MotionType.DYNAMIC:
+        sim.set_translation(start, reused_id)
+        sim.step_physics(0.5)
+        assert sim.get_translation(reused_id)[1] < start[1]
+
+    sim.remove_object(reused_id)
+    assert sim.get_num_pooled_objects() == 1
+    hab_cfg.sim_cfg.object_pooling = False
+    sim.reconfigure(hab_cfg)
+    assert sim.get_num_pooled_objects() == 0
@@ -0,0 +1,66 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import json
+import os.path as osp
+
+import pytest
+
+import habitat_sim
+from habitat_sim.profiling import Metrics, Profiler
+
+_navmesh = "data/scene_datasets/habitat-test-scenes/skokloster-castle.navmesh"
+
+
+@pytest.mark.skipif(not osp.exists(_navmesh), reason="Requires the test navmesh")
+def test_chrome_trace(tmpdir):
+    pf = habitat_sim.PathFinder()
+    pf.load_nav_mesh(_navmesh)
+    start = pf.get_random_navigable_point()
+    end = pf.get_random_navigable_point()
+
+    # nothing is recorded while disabled
+    Profiler.clear()
+    pf.try_step(start, end)
+    assert json.loads(Profiler.chrome_trace())["traceEvents"] == []
+
+    filename = str(tmpdir.join("trace.json"))
+    with habitat_sim.profiling.trace(filename):
+        for _ in range(10):
+            path = habitat_sim.ShortestPath()
+            path.requested_start = start
+            path.requested_end = end
+            pf.find_path(path)
+    assert not Profiler.is_enabled()
+
+    with open(filename) as f:
+        events = json.load(f)["traceEvents"]
+    complete = [e for e in events if e["ph"] == "X"]
+    assert len([e for e in complete if e["name"] == "PathFinder::findPath"]) == 10
+    assert all(e["dur"] >= 0 for e in complete)
+    # every thread with events is named
+    assert {e["tid"] for e in complete} <= {
+        e["tid"] for e in events if e["ph"] == "M"
+    }
+
+
+@pytest.mark.skipif(not osp.exists(_navmesh), reason="Requires the test navmesh")
+def test_metrics():
+    pf = habitat_sim.PathFinder()
+    pf.load_nav_mesh(_navmesh)
+    pf.seed(0)
+
+    Metrics.reset()
+    for _ in range(10):
+        path = habitat_sim.ShortestPath()
+        path.requested_start = pf.get_random_navigable_point()
+        path.requested_end = pf.get_random_navigable_point()
+        pf.find_path(path)
+
+    metrics = Metrics.snapshot(reset=True)
+    assert isinstance(metrics, dict)
+    assert 0 < metrics["nav.astar_expanded_nodes.count"] <= 10
+    assert metrics["nav.astar_expanded_nodes.sum"] > 0
+    # the snapshot reset them
+    assert "nav.astar_expanded_nodes.count" not in Metrics.snapshot()
@@ -0,0 +1,26 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import numpy as np
+
+from habitat_sim.bindings import CounterRandom
+
+
+def test_counter_random_streams():
+    # the same seed and stream give the same numbers, in bulk or one by one
+    bulk = CounterRandom(42, 7).uniform_floats(100)
+    single = CounterRandom(42, 7)
+    assert np.array_equal(bulk, [single.uniform_float_01() for _ in range(100)])
+    assert single.position == 100
+    assert np.all((bulk >= 0.0) & (bulk < 1.0))
+
+    assert not np.array_equal(bulk, CounterRandom(42, 8).uniform_floats(100))
+    parent = CounterRandom(42, 7)
+    assert not np.array_equal(
+        parent.split(0).uniform_floats(100), parent.split(1).uniform_floats(100)
+    )
+
+    normal = CounterRandom(1).normal_floats(10000)
+    assert abs(normal.mean()) < 0.05
+    assert abs(normal.std() - 1.0) < 0.05
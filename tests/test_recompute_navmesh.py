@@ -105,3 +105,80 @@ def test_recompute_navmesh(test_scene, sim):
             some_diff = True
 
     assert some_diff
+
+
+@pytest.mark.parametrize("test_scene", test_scenes)
+def test_recompute_tiled_navmesh(test_scene, sim):
+    if not osp.exists(test_scene):
+        pytest.skip(f"{test_scene} not found")
+
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = test_scene
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    sim.reconfigure(hab_cfg)
+
+    navmesh_settings = habitat_sim.NavMeshSettings()
+    navmesh_settings.set_defaults()
+    assert sim.recompute_navmesh(sim.pathfinder, navmesh_settings)
+    assert sim.pathfinder.is_loaded
+
+    num_samples = 100
+    samples = []
+    for _ in range(num_samples):
+        samples.append(
+            (
+                sim.pathfinder.get_random_navigable_point(),
+                sim.pathfinder.get_random_navigable_point(),
+            )
+        )
+    single_tile_results = get_shortest_path(sim, samples)
+
+    navmesh_settings.tile_size = 128
+    assert sim.recompute_navmesh(sim.pathfinder, navmesh_settings)
+    assert sim.pathfinder.is_loaded
+    tiled_results = get_shortest_path(sim, samples)
+
+    # tile borders change the tessellation slightly, but not the connectivity
+    num_same = 0
+    for single_tile, tiled in zip(single_tile_results, tiled_results):
+        if single_tile[0] != tiled[0]:
+            continue
+        num_same += 1
+        if single_tile[0]:
+            assert tiled[1] == pytest.approx(single_tile[1], rel=0.1, abs=0.2)
+
+    assert num_same >= 0.95 * num_samples
+
+
+@pytest.mark.parametrize("test_scene", test_scenes)
+def test_occupancy_grid(test_scene, sim):
+    if not osp.exists(test_scene):
+        pytest.skip(f"{test_scene} not found")
+
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = test_scene
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    sim.reconfigure(hab_cfg)
+
+    grid = sim.get_occupancy_grid(0.1)
+    voxels = np.asarray(grid.voxels)
+    assert voxels.ndim == 2 and voxels.shape[1] == 3 and len(voxels) > 0
+    assert np.all(voxels >= 0) and np.all(voxels < np.asarray(grid.dimensions))
+    dense = grid.to_dense()
+    assert dense.shape == tuple(reversed(grid.dimensions))
+    assert dense.sum() == len(voxels)
+    assert np.all(dense[voxels[:, 2], voxels[:, 1], voxels[:, 0]] == 1)
+
+    # cached, the same voxels again
+    assert np.array_equal(np.asarray(sim.get_occupancy_grid(0.1).voxels), voxels)
+
+    # the floor is occupied just below navigable points
+    num_samples = 100
+    num_on_floor = 0
+    for _ in range(num_samples):
+        voxel = grid.to_voxel(sim.pathfinder.get_random_navigable_point())
+        if any(
+            grid.is_occupied(voxel - np.array([0, dy, 0])) for dy in range(-1, 4)
+        ):
+            num_on_floor += 1
+    assert num_on_floor >= 0.95 * num_samples
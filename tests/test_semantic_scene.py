@@ -59,3 +59,60 @@ def test_semantic_scene(scene, make_cfg_settings):
 
     for level in scene.levels:
         level.id
+
+    index = scene.category_index()
+    for name in index.names:
+        expected = [
+            i
+            for i, obj in enumerate(scene.objects)
+            if obj is not None and obj.category.name() == name
+        ]
+        assert scene.objects_of_category(name) == expected
+    assert index.offsets[-1] == len(index.object_indices)
+
+    ids = np.arange(len(scene.objects) + 1, dtype=np.uint32)
+    scene.semantic_ids_to_categories(ids)
+    categories = ids.view(np.int32)
+    for i, obj in enumerate(scene.objects):
+        if obj is not None and obj.category is not None:
+            assert categories[i] == obj.category.index()
+    assert categories[-1] == -1
+
+    hierarchy = scene.hierarchy
+    for i, region in enumerate(scene.regions):
+        assert list(hierarchy.region_objects(i)) == [
+            scene.objects.index(obj) for obj in region.objects
+        ]
+
+
+@pytest.mark.parametrize("scene", _test_scenes)
+def test_object_viewpoints(scene, make_cfg_settings):
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["enable_physics"] = True
+    cfg = make_cfg(make_cfg_settings)
+    cfg.agents[0].sensor_specifications = []
+    sim = habitat_sim.Simulator(cfg)
+
+    settings = habitat_sim.ViewpointSettings()
+    settings.spacing = 0.25
+    objects = sim.semantic_scene.objects
+    results = sim.compute_object_viewpoints(settings)
+    assert len(results) > 0
+    indices = [result.object_index for result in results]
+    assert indices == sorted(set(indices))
+    for result in results[:20]:
+        obb = objects[result.object_index].obb
+        assert len(result.viewpoints) == len(result.visible_fractions)
+        for point, fraction in zip(result.viewpoints, result.visible_fractions):
+            assert sim.pathfinder.is_navigable(point)
+            assert settings.min_visible_fraction <= fraction <= 1.0
+            # within reach of the object, up to the diagonal of a grid cell
+            assert obb.distance(
+                np.array([point[0], obb.center[1], point[2]])
+            ) <= settings.max_distance + settings.spacing
+    sim.close()
@@ -0,0 +1,93 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+import multiprocessing
+import os
+import os.path as osp
+
+import numpy as np
+import pytest
+
+from examples.settings import make_cfg
+from habitat_sim.shared_memory import (
+    SharedMemoryRing,
+    create_observation_ring,
+    parse_observations,
+    read_observations,
+)
+
+
+def _read_in_child(name, queue):
+    ring = SharedMemoryRing.open(name)
+    sums = []
+    while len(sums) != 3:
+        data = ring.begin_read()
+        if data is None:
+            continue
+        sums.append((ring.read_sequence, int(data.sum()), ring.read_layout))
+        ring.end_read()
+    queue.put(sums)
+
+
+def test_ring_across_processes():
+    name = "/habitat-test-ring-{}".format(os.getpid())
+    ring = SharedMemoryRing.create(name, 2, 64)
+    assert ring is not None and ring.is_owner
+    assert SharedMemoryRing.create(name, 2, 64) is None
+
+    context = multiprocessing.get_context("spawn")
+    queue = context.Queue()
+    child = context.Process(target=_read_in_child, args=(name, queue))
+    child.start()
+    for i in range(3):
+        slot = ring.begin_write()
+        while slot is None:
+            slot = ring.begin_write()
+        slot[:] = i
+        assert ring.end_write(slot.size, f'[{{"uuid": "{i}"}}]') == i + 1
+    sums = queue.get(timeout=60)
+    child.join()
+
+    assert sums == [(i + 1, 64 * i, f'[{{"uuid": "{i}"}}]') for i in range(3)]
+    assert ring.pending_count == 0
+
+
+def test_parse_observations():
+    data = np.zeros(128, dtype=np.uint8)
+    data[64:72] = np.arange(2, dtype=np.float32).view(np.uint8)
+    observations = parse_observations(
+        data,
+        '[{"uuid": "a", "offset": 0, "shape": [2, 3], "dtype": "uint8"}, '
+        '{"uuid": "b", "offset": 64, "shape": [2, 1], "dtype": "float32"}]',
+    )
+    assert observations["a"].shape == (2, 3)
+    assert np.array_equal(observations["b"], [[0.0], [1.0]])
+    # views, not copies
+    assert observations["b"].base is not None
+
+
+@pytest.mark.gfxtest
+def test_write_observations(sim, make_cfg_settings):
+    if not osp.exists(make_cfg_settings["scene"]):
+        pytest.skip("Skipping {}".format(make_cfg_settings["scene"]))
+    sim.reconfigure(make_cfg(make_cfg_settings))
+
+    name = "/habitat-test-observations-{}".format(os.getpid())
+    ring = create_observation_ring(sim, name, slot_count=1)
+    sequence = sim.write_observations(ring)
+    assert sequence == 1
+    # all slots wait for the reader
+    assert sim.write_observations(ring) == 0
+
+    expected = sim.get_sensor_observations()
+    with read_observations(ring) as observations:
+        assert set(observations.keys()) == set(expected.keys())
+        for uuid, observation in observations.items():
+            # the Python sensors drop trailing single channels
+            assert np.array_equal(
+                observation.reshape(expected[uuid].shape), expected[uuid]
+            )
+    with read_observations(ring) as observations:
+        assert observations is None
+    assert sim.write_observations(ring) == 2
@@ -1,3 +1,4 @@
+import json
 import multiprocessing
 import os.path as osp
 import random
@@ -162,3 +163,74 @@ def test_object_template_editing(sim):
     # test adding a new object
     object_id = sim.add_object(template_ids[0])
     assert object_id != -1
+
+
+def test_scene_load_statistics(sim, tmp_path):
+    statistics = sim.scene_load_statistics
+    assert statistics.total_time > 0.0
+    assert len(statistics.events) > 0
+    stage_sum = sum(
+        statistics.stage_time(stage)
+        for stage in habitat_sim.sim.SceneLoadStatistics.Stage.__members__.values()
+    )
+    assert stage_sum <= statistics.total_time
+    # the shader variants of the materials are compiled before the drawables
+    shaders = habitat_sim.sim.SceneLoadStatistics.Stage.SHADERS
+    assert any(event.stage == shaders for event in statistics.events)
+
+    trace_file = str(tmp_path / "load_trace.json")
+    habitat_sim.sim.write_scene_load_trace(statistics, trace_file)
+    with open(trace_file) as f:
+        events = json.load(f)["traceEvents"]
+    assert len(events) == len(statistics.events) + 1
+    assert events[0]["name"] == "loadScene"
+
+
+@pytest.mark.gfxtest
+def test_mesh_upload_budget(sim, make_cfg_settings):
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["depth_sensor"] = True
+    hab_cfg = examples.settings.make_cfg(make_cfg_settings)
+    sim.reconfigure(hab_cfg)
+    expected = {k: np.copy(v) for k, v in sim.get_sensor_observations().items()}
+
+    # a simulator of its own, as the scene asset is already on the GPU here
+    hab_cfg.sim_cfg.mesh_upload_budget = 1 << 20
+    budget_sim = habitat_sim.Simulator(hab_cfg)
+    assert budget_sim._sim.has_pending_mesh_uploads
+    frames = 0
+    while budget_sim._sim.has_pending_mesh_uploads:
+        budget_sim.get_sensor_observations()
+        frames += 1
+    assert frames > 1
+
+    # the meshes complete with the last upload are drawn as usual
+    obs = budget_sim.get_sensor_observations()
+    for uuid, observation in expected.items():
+        assert np.array_equal(obs[uuid], observation), uuid
+    budget_sim.close()
+
+
+@pytest.mark.gfxtest
+def test_release_mesh_upload_data(sim, make_cfg_settings):
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["depth_sensor"] = True
+    hab_cfg = examples.settings.make_cfg(make_cfg_settings)
+    sim.reconfigure(hab_cfg)
+    expected = {k: np.copy(v) for k, v in sim.get_sensor_observations().items()}
+
+    # a simulator of its own, as the scene asset is already loaded here
+    hab_cfg.sim_cfg.release_mesh_upload_data = True
+    release_sim = habitat_sim.Simulator(hab_cfg)
+    obs = release_sim.get_sensor_observations()
+    for uuid, observation in expected.items():
+        assert np.array_equal(obs[uuid], observation), uuid
+
+    # the collision mesh stays for navmesh recomputation
+    navmesh_settings = habitat_sim.NavMeshSettings()
+    navmesh_settings.set_defaults()
+    assert release_sim.recompute_navmesh(release_sim.pathfinder, navmesh_settings)
+    assert release_sim.pathfinder.is_loaded
+    release_sim.close()
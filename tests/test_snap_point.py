@@ -32,3 +32,29 @@ def test_snap_point(nudge, test_data):
     hypothesis.assume(not math.isnan(proj_pt[0]))
 
     assert pf.is_navigable(proj_pt), "{} -> {} not navigable!".format(pt, proj_pt)
+
+
+def test_batched_queries(test_data):
+    pf, start_pt = test_data
+
+    rng = np.random.RandomState(0)
+    starts = np.stack([pf.get_random_navigable_point() for _ in range(100)])
+    ends = starts + rng.uniform(-0.5, 0.5, size=starts.shape).astype(np.float32)
+
+    steps = pf.try_steps(starts, ends)
+    steps_no_sliding = pf.try_steps_no_sliding(starts, ends)
+    snapped = pf.snap_points(ends)
+    navigable = pf.are_navigable(ends)
+    assert steps.shape == starts.shape
+    assert navigable.shape == (len(starts),)
+
+    for i in range(len(starts)):
+        assert np.array_equal(steps[i], pf.try_step(starts[i], ends[i]))
+        assert np.array_equal(
+            steps_no_sliding[i], pf.try_step_no_sliding(starts[i], ends[i])
+        )
+        assert np.array_equal(snapped[i], pf.snap_point(ends[i]), equal_nan=True)
+        assert navigable[i] == pf.is_navigable(ends[i])
+
+    with pytest.raises(ValueError):
+        pf.try_steps(starts, ends[:-1])